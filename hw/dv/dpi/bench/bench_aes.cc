@@ -0,0 +1,53 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+//
+// Benchmarks for the AES model (hw/ip/aes/dv/aes_model_dpi)
+
+#include <memory>
+#include <string>
+
+#include "aes_model_dpi.h"
+#include "dpi_bench.h"
+#include "svdpi_shim.h"
+
+int main(int argc, char **argv) {
+  DpiBench bench;
+
+  // 256-bit key in CBC mode, using the OpenSSL/BoringSSL implementation
+  const unsigned char impl = 1, op = 0;
+  const svBitVecVal mode = 1 << 1, key_len = 1 << 2;
+  svBitVecVal iv[4] = {0x03020100, 0x07060504, 0x0b0a0908, 0x0f0e0d0c};
+  svBitVecVal key[8];
+  for (int i = 0; i < 8; ++i) {
+    key[i] = 0x01010101 * i;
+  }
+
+  void *ctx = c_dpi_aes_ctx_new();
+
+  std::vector<std::unique_ptr<ShimArray>> arrays;
+  for (size_t len : kDpiBenchMessageSizes) {
+    for (size_t stride : {1, 4}) {
+      arrays.emplace_back(new ShimArray(len, stride));
+      ShimArray *in = arrays.back().get();
+      arrays.emplace_back(new ShimArray(len, stride));
+      ShimArray *out = arrays.back().get();
+      in->Fill(1);
+      std::string suffix =
+          "/" + std::to_string(len) + "/stride" + std::to_string(stride);
+
+      bench.Register("crypt_message" + suffix, len, [=, &iv, &key]() {
+        c_dpi_aes_crypt_message(impl, op, &mode, iv, &key_len, key,
+                                in->handle(), out->handle());
+      });
+      bench.Register("ctx_crypt_message" + suffix, len, [=, &iv, &key]() {
+        c_dpi_aes_ctx_crypt_message(ctx, impl, op, &mode, iv, &key_len, key,
+                                    in->handle(), out->handle());
+      });
+    }
+  }
+
+  int ret = bench.Main(argc, argv);
+  c_dpi_aes_ctx_free(ctx);
+  return ret;
+}
@@ -0,0 +1,85 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+//
+// Benchmarks for the Ascon model (hw/ip/prim/dv/prim_ascon/ascon_model_dpi)
+
+#include <memory>
+#include <string>
+
+#include "ascon_model_dpi.h"
+#include "dpi_bench.h"
+#include "svdpi_shim.h"
+
+static const unsigned int kBatchSize = 16;
+static const size_t kAdLen = 16;
+
+int main(int argc, char **argv) {
+  DpiBench bench;
+
+  // The ascon model accesses its byte arrays in place, so these use a stride
+  // of 1.
+  ShimArray nonce(16 * kBatchSize, 1), key(16 * kBatchSize, 1);
+  nonce.Fill(1);
+  key.Fill(2);
+  ShimArray ad(kAdLen * kBatchSize, 1);
+  ad.Fill(3);
+  ShimArray ad_lens(kBatchSize, 4);
+  for (unsigned int i = 0; i < kBatchSize; ++i) {
+    ad_lens.Set(i, kAdLen);
+  }
+
+  std::vector<std::unique_ptr<ShimArray>> arrays;
+  for (size_t len : kDpiBenchMessageSizes) {
+    arrays.emplace_back(new ShimArray(len * kBatchSize, 1));
+    ShimArray *msg = arrays.back().get();
+    arrays.emplace_back(new ShimArray((len + 16) * kBatchSize, 1));
+    ShimArray *ct = arrays.back().get();
+    arrays.emplace_back(new ShimArray(kBatchSize, 4));
+    ShimArray *msg_lens = arrays.back().get();
+    msg->Fill(4);
+    for (unsigned int i = 0; i < kBatchSize; ++i) {
+      msg_lens->Set(i, len);
+    }
+
+    bench.Register("aead_encrypt/" + std::to_string(len), len, [=, &ad, &nonce,
+                                                                 &key]() {
+      c_dpi_aead_encrypt(ct->handle(), msg->handle(), len, ad.handle(), kAdLen,
+                         nonce.handle(), key.handle());
+    });
+    bench.Register(
+        "aead_encrypt_batch/" + std::to_string(len) + "x" +
+            std::to_string(kBatchSize),
+        len * kBatchSize, [=, &ad, &ad_lens, &nonce, &key]() {
+          c_dpi_aead_encrypt_batch(ct->handle(), msg->handle(),
+                                   msg_lens->handle(), ad.handle(),
+                                   ad_lens.handle(), nonce.handle(),
+                                   key.handle(), kBatchSize);
+        });
+  }
+
+  // The 12 rounds of the initialization permutation
+  svBitVecVal state[10] = {0};
+  const uint8_t rcon[12] = {0xf0, 0xe1, 0xd2, 0xc3, 0xb4, 0xa5,
+                            0x96, 0x87, 0x78, 0x69, 0x5a, 0x4b};
+  bench.Register("p12/per_round", 0, [&]() {
+    for (int i = 0; i < 12; ++i) {
+      svBit round = rcon[i];
+      c_dpi_ascon_round(state, &round, state);
+    }
+  });
+  ShimArray rcon_arr(12, 1);
+  for (int i = 0; i < 12; ++i) {
+    rcon_arr.Set(i, rcon[i]);
+  }
+  void *ctx = c_dpi_ascon_ctx_new();
+  bench.Register("p12/ctx", 0, [&]() {
+    c_dpi_ascon_ctx_set_state(ctx, state);
+    c_dpi_ascon_ctx_rounds(ctx, rcon_arr.handle(), 12);
+    c_dpi_ascon_ctx_get_state(ctx, state);
+  });
+
+  int ret = bench.Main(argc, argv);
+  c_dpi_ascon_ctx_free(ctx);
+  return ret;
+}
@@ -0,0 +1,79 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+//
+// Benchmarks for the cryptoc SHA-2/HMAC model (hw/ip/hmac/dv/cryptoc_dpi)
+
+#include <memory>
+#include <string>
+
+#include "dpi_bench.h"
+#include "svdpi_shim.h"
+
+extern "C" {
+void c_dpi_SHA256_hash(const svOpenArrayHandle msg, uint64_t len,
+                       uint32_t hash[8]);
+void c_dpi_SHA512_hash(const svOpenArrayHandle msg, uint64_t len,
+                       uint32_t hash[16]);
+void c_dpi_HMAC_SHA256(const svOpenArrayHandle key, uint64_t key_len,
+                       const svOpenArrayHandle msg, uint64_t msg_len,
+                       uint32_t hmac[8]);
+void *c_dpi_hash_ctx_new(unsigned int hash_alg);
+void c_dpi_hash_ctx_update(void *ctx, const svOpenArrayHandle msg,
+                           uint64_t len);
+void c_dpi_hash_ctx_final(const void *ctx, uint32_t digest[16]);
+void c_dpi_hash_ctx_free(void *ctx);
+}
+
+// cryptoc_hash_e::CryptocHashSha256 in cryptoc_dpi_pkg.sv
+static const unsigned int kHashSha256 = 1;
+
+int main(int argc, char **argv) {
+  DpiBench bench;
+
+  // cryptoc_dpi reads the svBitVecVal layout, with four bytes per element
+  const size_t stride = 4;
+  ShimArray key(32, stride);
+  key.Fill(1);
+  uint32_t digest[16];
+
+  std::vector<std::unique_ptr<ShimArray>> msgs;
+  for (size_t len : kDpiBenchMessageSizes) {
+    msgs.emplace_back(new ShimArray(len, stride));
+    ShimArray *msg = msgs.back().get();
+    msg->Fill(2);
+    std::string suffix = "/" + std::to_string(len);
+
+    bench.Register("sha256" + suffix, len, [=, &digest]() {
+      c_dpi_SHA256_hash(msg->handle(), len, digest);
+    });
+    bench.Register("sha512" + suffix, len, [=, &digest]() {
+      c_dpi_SHA512_hash(msg->handle(), len, digest);
+    });
+    bench.Register("hmac_sha256" + suffix, len, [=, &key, &digest]() {
+      c_dpi_HMAC_SHA256(key.handle(), 32, msg->handle(), len, digest);
+    });
+  }
+
+  // Checking the digest after every 64-byte block of a 4 KiB message, first
+  // by rehashing the whole prefix each time and then incrementally
+  ShimArray long_msg(4096, stride);
+  long_msg.Fill(3);
+  ShimArray block(64, stride);
+  block.Fill(4);
+  bench.Register("sha256_prefixes/rehash/4096", 4096, [&]() {
+    for (uint64_t len = 64; len <= 4096; len += 64) {
+      c_dpi_SHA256_hash(long_msg.handle(), len, digest);
+    }
+  });
+  bench.Register("sha256_prefixes/ctx/4096", 4096, [&]() {
+    void *ctx = c_dpi_hash_ctx_new(kHashSha256);
+    for (int i = 0; i < 4096 / 64; ++i) {
+      c_dpi_hash_ctx_update(ctx, block.handle(), 64);
+      c_dpi_hash_ctx_final(ctx, digest);
+    }
+    c_dpi_hash_ctx_free(ctx);
+  });
+
+  return bench.Main(argc, argv);
+}
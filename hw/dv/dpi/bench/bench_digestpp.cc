@@ -0,0 +1,75 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+//
+// Benchmarks for the digestpp SHA-3/KMAC model (hw/ip/kmac/dv/dpi)
+
+#include <memory>
+#include <string>
+
+#include "dpi_bench.h"
+#include "svdpi_shim.h"
+
+extern "C" {
+void c_dpi_sha3_256(const svOpenArrayHandle msg, uint64_t msg_len,
+                    svOpenArrayHandle digest);
+void c_dpi_kmac256(const svOpenArrayHandle msg, uint64_t msg_len,
+                   const svOpenArrayHandle key, uint64_t key_len,
+                   const char *customization_str, uint64_t output_len,
+                   svBitVecVal *digest);
+void *c_dpi_digestpp_create(int mode, uint32_t strength, uint64_t output_len,
+                            const char *function_name,
+                            const char *customization_str,
+                            const svOpenArrayHandle key, uint64_t key_len);
+void c_dpi_digestpp_absorb_chunk(void *ctx, const svOpenArrayHandle msg,
+                                 uint64_t msg_len);
+void c_dpi_digestpp_squeeze(void *ctx, uint64_t output_len,
+                            svOpenArrayHandle digest);
+void c_dpi_digestpp_free(void *ctx);
+}
+
+// DigestMode::kDigestSha3 in digestpp_dpi.cc
+static const int kModeSha3 = 0;
+
+int main(int argc, char **argv) {
+  DpiBench bench;
+
+  ShimArray key(32, 1);
+  key.Fill(1);
+  ShimArray digest(32, 1);
+  svBitVecVal kmac_digest[8];
+
+  std::vector<std::unique_ptr<ShimArray>> msgs;
+  for (size_t len : kDpiBenchMessageSizes) {
+    for (size_t stride : {1, 4}) {
+      msgs.emplace_back(new ShimArray(len, stride));
+      ShimArray *msg = msgs.back().get();
+      msg->Fill(2);
+      std::string suffix =
+          "/" + std::to_string(len) + "/stride" + std::to_string(stride);
+
+      bench.Register("sha3_256" + suffix, len, [=, &digest]() {
+        c_dpi_sha3_256(msg->handle(), len, digest.handle());
+      });
+      bench.Register("kmac256" + suffix, len, [=, &key, &kmac_digest]() {
+        c_dpi_kmac256(msg->handle(), len, key.handle(), 32, "", 32,
+                      kmac_digest);
+      });
+    }
+  }
+
+  // Absorbing a long message in scoreboard-sized chunks
+  ShimArray chunk(64, 1);
+  chunk.Fill(3);
+  bench.Register("sha3_256_stream/4096/chunk64", 4096, [&]() {
+    void *ctx = c_dpi_digestpp_create(kModeSha3, 256, 32, "", "",
+                                      key.handle(), 0);
+    for (int i = 0; i < 4096 / 64; ++i) {
+      c_dpi_digestpp_absorb_chunk(ctx, chunk.handle(), 64);
+    }
+    c_dpi_digestpp_squeeze(ctx, 32, digest.handle());
+    c_dpi_digestpp_free(ctx);
+  });
+
+  return bench.Main(argc, argv);
+}
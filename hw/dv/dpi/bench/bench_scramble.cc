@@ -0,0 +1,48 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+//
+// Benchmarks for the memory scrambling model (hw/ip/prim/dv/prim_ram_scr)
+
+#include <vector>
+
+#include "dpi_bench.h"
+#include "scramble_model.h"
+
+int main(int argc, char **argv) {
+  DpiBench bench;
+
+  // A 39-bit word (32 data bits and 7 ECC bits) in a 64k-word memory, with
+  // the nonce width used by the main SRAM
+  const uint32_t data_width = 39, addr_width = 16, nonce_width = 64;
+  std::vector<uint8_t> key(kPrinceWidthByte * 2), nonce(nonce_width / 8);
+  for (size_t i = 0; i < key.size(); ++i) {
+    key[i] = 0x11 * i;
+  }
+  for (size_t i = 0; i < nonce.size(); ++i) {
+    nonce[i] = 0x5a ^ i;
+  }
+  std::vector<uint8_t> data = {0x78, 0x56, 0x34, 0x12, 0x5f};
+  std::vector<uint8_t> addr = {0x34, 0x12};
+  uint32_t word_addr = 0x1234;
+
+  bench.Register("encrypt_data/vector/5", data.size(), [&]() {
+    data = scramble_encrypt_data(data, data_width, 8, addr, addr_width, nonce,
+                                 key, false, false);
+  });
+  bench.Register("scramble_addr/vector", 0, [&]() {
+    addr = scramble_addr(addr, addr_width, nonce, nonce_width);
+  });
+
+  ScrambleKeySchedule ks(key, nonce, nonce_width);
+  uint64_t word = 0x5f12345678ULL;
+  bench.Register("encrypt_data/fixed/5", data.size(), [&]() {
+    scramble_encrypt_data(&word, &word, data_width, word_addr, addr_width, ks,
+                          false);
+  });
+  bench.Register("scramble_addr/fixed", 0, [&]() {
+    word_addr = scramble_addr(word_addr, addr_width, ks);
+  });
+
+  return bench.Main(argc, argv);
+}
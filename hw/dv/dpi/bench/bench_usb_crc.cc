@@ -0,0 +1,38 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+//
+// Benchmarks for the USB CRCs used by usbdpi (hw/dv/dpi/usbdpi/usb_crc.c)
+
+#include <string>
+#include <vector>
+
+#include "dpi_bench.h"
+
+extern "C" {
+uint32_t CRC5(uint32_t dwInput, int iBitcnt);
+uint32_t CRC16(const uint8_t *data, int bytes);
+}
+
+int main(int argc, char **argv) {
+  DpiBench bench;
+
+  volatile uint32_t sink = 0;
+  uint32_t token = 0;
+  bench.Register("crc5/token", 0, [&]() {
+    sink = CRC5(token, 11);
+    token = (token + 1) & 0x7ff;
+  });
+
+  std::vector<uint8_t> data(1023);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = (uint8_t)(i * 7 + 3);
+  }
+  // Data field sizes: small control transfers up to full-speed maximum
+  for (int len : {8, 64, 1023}) {
+    bench.Register("crc16/" + std::to_string(len), len,
+                   [&, len]() { sink = CRC16(data.data(), len); });
+  }
+
+  return bench.Main(argc, argv);
+}
@@ -0,0 +1,69 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "dpi_bench.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+const std::vector<size_t> kDpiBenchMessageSizes = {16, 64, 256, 4096};
+
+void DpiBench::Register(const std::string &name, size_t bytes_per_call,
+                        std::function<void()> fn) {
+  benchmarks_.push_back({name, bytes_per_call, std::move(fn)});
+}
+
+int DpiBench::Main(int argc, char **argv) {
+  std::string filter;
+  double min_time = 0.5;
+
+  for (int i = 1; i < argc; ++i) {
+    if (!strncmp(argv[i], "--filter=", 9)) {
+      filter = argv[i] + 9;
+    } else if (!strncmp(argv[i], "--min-time=", 11)) {
+      min_time = atof(argv[i] + 11);
+    } else {
+      fprintf(stderr, "Usage: %s [--filter=SUBSTR] [--min-time=SECS]\n",
+              argv[0]);
+      return 1;
+    }
+  }
+
+  printf("%-40s %14s %12s %10s %10s\n", "Benchmark", "calls/s", "ns/call",
+         "ns/byte", "MB/s");
+  for (const Benchmark &bench : benchmarks_) {
+    if (bench.name.find(filter) != std::string::npos)
+      Run(bench, min_time);
+  }
+  return 0;
+}
+
+void DpiBench::Run(const Benchmark &bench, double min_time) const {
+  typedef std::chrono::steady_clock clock;
+
+  // Warm up (filling caches and any lazily built tables), then run batches of
+  // calls, doubling the batch size until the total time is long enough.
+  bench.fn();
+
+  uint64_t calls = 0;
+  double secs = 0;
+  for (uint64_t batch = 1; secs < min_time; batch *= 2) {
+    clock::time_point start = clock::now();
+    for (uint64_t i = 0; i < batch; ++i) {
+      bench.fn();
+    }
+    secs += std::chrono::duration<double>(clock::now() - start).count();
+    calls += batch;
+  }
+
+  double ns_per_call = secs * 1e9 / calls;
+  printf("%-40s %14.0f %12.1f", bench.name.c_str(), calls / secs, ns_per_call);
+  if (bench.bytes_per_call) {
+    printf(" %10.2f %10.1f", ns_per_call / bench.bytes_per_call,
+           bench.bytes_per_call * 1e3 / ns_per_call);
+  }
+  printf("\n");
+}
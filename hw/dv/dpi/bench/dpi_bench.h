@@ -0,0 +1,52 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+#ifndef OPENTITAN_HW_DV_DPI_BENCH_DPI_BENCH_H_
+#define OPENTITAN_HW_DV_DPI_BENCH_DPI_BENCH_H_
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * A minimal benchmark runner for the DPI reference models
+ *
+ * Each benchmark is a function that performs one call into a model, handling
+ * bytes_per_call bytes of data. The runner repeats the call until it has run
+ * for at least the minimum time, then prints a line with the number of calls
+ * per second, the time per call and, if bytes_per_call is nonzero, the time
+ * per byte and throughput.
+ *
+ * This follows the style of Google benchmark (which the DV models don't
+ * depend on): a benchmark binary registers its benchmarks and then calls
+ * Main(), which understands these flags:
+ *
+ *   --filter=SUBSTR  Only run benchmarks whose name contains SUBSTR
+ *   --min-time=SECS  Minimum time to run each benchmark (default 0.5)
+ */
+class DpiBench {
+ public:
+  void Register(const std::string &name, size_t bytes_per_call,
+                std::function<void()> fn);
+
+  // Parse the flags above and run the benchmarks, returning an exit code.
+  int Main(int argc, char **argv);
+
+ private:
+  struct Benchmark {
+    std::string name;
+    size_t bytes_per_call;
+    std::function<void()> fn;
+  };
+
+  void Run(const Benchmark &bench, double min_time) const;
+
+  std::vector<Benchmark> benchmarks_;
+};
+
+// Message sizes used by the benchmarks, in bytes: a single block, a typical
+// bus-sized burst and a long message.
+extern const std::vector<size_t> kDpiBenchMessageSizes;
+
+#endif  // OPENTITAN_HW_DV_DPI_BENCH_DPI_BENCH_H_
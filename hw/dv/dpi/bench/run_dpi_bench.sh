@@ -0,0 +1,134 @@
+#!/bin/bash
+# Copyright lowRISC contributors (OpenTitan project).
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+
+# Build and run the DPI reference model benchmarks.
+#
+# Usage: run_dpi_bench.sh [BENCH...] [-- FLAGS...]
+#
+# Each BENCH is one of the names below (default: all of them). FLAGS are
+# passed to each benchmark binary (see dpi_bench.h), for example
+# "-- --filter=4096 --min-time=1".
+#
+# The benchmarks need an svdpi.h, which is taken from $SVDPI_INCLUDE (by
+# default, the vltstd directory of the Verilator found on the path). The AES
+# and cryptoc benchmarks also need OpenSSL's libcrypto. Binaries are built in
+# $BENCH_OUT (default: build/dpi_bench under the repository root).
+
+set -e
+
+bench_dir="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+repo_top="$(cd "$bench_dir/../../../.." && pwd)"
+out_dir="${BENCH_OUT:-$repo_top/build/dpi_bench}"
+
+if [ -z "$SVDPI_INCLUDE" ]; then
+  if ! command -v verilator > /dev/null; then
+    echo >&2 "Cannot find Verilator. Set SVDPI_INCLUDE to a directory with svdpi.h."
+    exit 1
+  fi
+  SVDPI_INCLUDE="$(verilator --getenv VERILATOR_ROOT)/include/vltstd"
+fi
+
+CC="${CC:-gcc}"
+CXX="${CXX:-g++}"
+CFLAGS="-O2 -g -I$SVDPI_INCLUDE"
+CXXFLAGS="$CFLAGS -std=c++14"
+
+ip="$repo_top/hw/ip"
+aes_dpi="$ip/aes/dv/aes_model_dpi"
+ascon_dpi="$ip/prim/dv/prim_ascon/ascon_model_dpi"
+ascon_ref="$ascon_dpi/vendor/ascon_ascon-c/ascon128"
+cryptoc="$ip/hmac/dv/cryptoc_dpi"
+present_dpi="$ip/prim/dv/prim_present/crypto_dpi_present"
+prince_dpi="$ip/prim/dv/prim_prince/crypto_dpi_prince"
+scramble="$ip/prim/dv/prim_ram_scr/cpp"
+usbdpi="$repo_top/hw/dv/dpi/usbdpi"
+
+all_benches="aes ascon cryptoc digestpp present scramble usb_crc"
+
+# build BENCH CFLAGS C_SOURCES... : CXX_SOURCES... : LIBS...
+#
+# Compiles the C sources with $CC and then links them with the benchmark
+# runner, the svdpi shim and the C++ sources.
+build() {
+  local name="$1" flags="$2"
+  shift 2
+  local objs=() cxx_srcs=() libs=()
+  local obj_dir="$out_dir/obj_$name"
+  mkdir -p "$obj_dir"
+
+  while [ "$#" -gt 0 ] && [ "$1" != ":" ]; do
+    local obj="$obj_dir/$(basename "$1" .c).o"
+    $CC $CFLAGS $flags -c "$1" -o "$obj"
+    objs+=("$obj")
+    shift
+  done
+  shift
+  while [ "$#" -gt 0 ] && [ "$1" != ":" ]; do
+    cxx_srcs+=("$1")
+    shift
+  done
+  [ "$#" -gt 0 ] && shift
+  libs=("$@")
+
+  $CXX $CXXFLAGS $flags -I"$bench_dir" -o "$out_dir/bench_$name" \
+    "$bench_dir/bench_$name.cc" "$bench_dir/dpi_bench.cc" \
+    "$bench_dir/svdpi_shim.cc" "${cxx_srcs[@]}" "${objs[@]}" "${libs[@]}"
+}
+
+build_bench() {
+  case "$1" in
+    aes)
+      build aes "-I$aes_dpi -I$ip/aes/model" \
+        "$aes_dpi/aes_model_dpi.c" "$ip/aes/model/aes.c" \
+        "$ip/aes/model/crypto.c" : : -lcrypto
+      ;;
+    ascon)
+      build ascon "-I$ascon_dpi" \
+        "$ascon_dpi/ascon_model_dpi.c" "$ascon_ref/aead.c" \
+        "$ascon_ref/printstate.c" : :
+      ;;
+    cryptoc)
+      build cryptoc "-I$cryptoc" \
+        "$cryptoc/cryptoc_dpi.c" "$cryptoc/util.c" "$cryptoc/sha.c" \
+        "$cryptoc/sha256.c" "$cryptoc/sha384.c" "$cryptoc/sha512.c" \
+        "$cryptoc/hmac.c" "$cryptoc/hmac_wrap.c" "$cryptoc/sha2_openssl.c" : : \
+        -lcrypto
+      ;;
+    digestpp)
+      build digestpp "" : "$ip/kmac/dv/dpi/digestpp_dpi.cc" :
+      ;;
+    present)
+      build present "" : "$present_dpi/crypto_dpi_present.cc" :
+      ;;
+    scramble)
+      build scramble "-I$scramble -I$prince_dpi" : \
+        "$scramble/scramble_model.cc" :
+      ;;
+    usb_crc)
+      build usb_crc "-I$usbdpi" "$usbdpi/usb_crc.c" : :
+      ;;
+    *)
+      echo >&2 "Unknown benchmark: $1. Known benchmarks: $all_benches."
+      exit 1
+      ;;
+  esac
+}
+
+benches=()
+while [ "$#" -gt 0 ] && [ "$1" != "--" ]; do
+  benches+=("$1")
+  shift
+done
+[ "$#" -gt 0 ] && shift
+[ "${#benches[@]}" -eq 0 ] && benches=($all_benches)
+
+mkdir -p "$out_dir"
+for bench in "${benches[@]}"; do
+  build_bench "$bench"
+done
+for bench in "${benches[@]}"; do
+  echo "== $bench"
+  "$out_dir/bench_$bench" "$@"
+done
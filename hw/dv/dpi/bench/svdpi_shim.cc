@@ -0,0 +1,92 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "svdpi_shim.h"
+
+#include <cassert>
+#include <cstring>
+
+void ShimArray::Set(size_t i, uint32_t val) {
+  assert(i < num_elems_);
+  uint8_t *elem = &storage_[i * elem_bytes_];
+  memset(elem, 0, elem_bytes_);
+  memcpy(elem, &val, elem_bytes_ < sizeof(val) ? elem_bytes_ : sizeof(val));
+}
+
+void ShimArray::Fill(uint32_t seed) {
+  uint32_t x = seed | 1;
+  for (size_t i = 0; i < num_elems_; ++i) {
+    // xorshift32
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    Set(i, elem_bytes_ == 1 ? (x & 0xff) : x);
+  }
+}
+
+static ShimArray *Arr(const svOpenArrayHandle h) {
+  assert(h);
+  return static_cast<ShimArray *>(h);
+}
+
+// The arrays are declared in SV as "name[]", so they are ascending with a
+// left (and low) bound of zero.
+extern "C" {
+
+int svDimensions(const svOpenArrayHandle h) {
+  (void)h;
+  return 1;
+}
+
+int svLeft(const svOpenArrayHandle h, int d) {
+  (void)h;
+  assert(d == 1);
+  return 0;
+}
+
+int svRight(const svOpenArrayHandle h, int d) {
+  assert(d == 1);
+  return (int)Arr(h)->num_elems() - 1;
+}
+
+int svLow(const svOpenArrayHandle h, int d) { return svLeft(h, d); }
+
+int svHigh(const svOpenArrayHandle h, int d) { return svRight(h, d); }
+
+int svIncrement(const svOpenArrayHandle h, int d) {
+  (void)h;
+  assert(d == 1);
+  return -1;
+}
+
+int svSize(const svOpenArrayHandle h, int d) {
+  assert(d == 1);
+  return (int)Arr(h)->num_elems();
+}
+
+int svSizeOfArray(const svOpenArrayHandle h) {
+  return (int)(Arr(h)->num_elems() * Arr(h)->elem_bytes());
+}
+
+void *svGetArrayPtr(const svOpenArrayHandle h) { return Arr(h)->data(); }
+
+void *svGetArrElemPtr1(const svOpenArrayHandle h, int indx1) {
+  ShimArray *arr = Arr(h);
+  assert(0 <= indx1 && (size_t)indx1 < arr->num_elems());
+  return arr->data() + indx1 * arr->elem_bytes();
+}
+
+void svGetBitArrElem1VecVal(svBitVecVal *d, const svOpenArrayHandle s,
+                            int indx1) {
+  ShimArray *arr = Arr(s);
+  size_t words = (arr->elem_bytes() + 3) / 4;
+  memset(d, 0, words * sizeof(svBitVecVal));
+  memcpy(d, svGetArrElemPtr1(s, indx1), arr->elem_bytes());
+}
+
+void svPutBitArrElem1VecVal(const svOpenArrayHandle d, const svBitVecVal *s,
+                            int indx1) {
+  memcpy(svGetArrElemPtr1(d, indx1), s, Arr(d)->elem_bytes());
+}
+}
@@ -0,0 +1,49 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+#ifndef OPENTITAN_HW_DV_DPI_BENCH_SVDPI_SHIM_H_
+#define OPENTITAN_HW_DV_DPI_BENCH_SVDPI_SHIM_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "svdpi.h"
+
+/**
+ * A one-dimensional open array, as a simulator would pass to a DPI function
+ *
+ * The svdpi_shim.cc file implements the open array accessors from svdpi.h
+ * (svGetArrayPtr, svSize, svGetBitArrElem1VecVal and so on) for handles
+ * returned by handle(), so the DPI models can be run outside a simulator.
+ *
+ * Elements are stored contiguously, elem_bytes apart. A stride of 1 matches
+ * simulators that store byte arrays one byte per element; a stride of 4
+ * matches the canonical svBitVecVal layout that other simulators use.
+ */
+class ShimArray {
+ public:
+  ShimArray(size_t num_elems, size_t elem_bytes)
+      : num_elems_(num_elems),
+        elem_bytes_(elem_bytes),
+        storage_(num_elems * elem_bytes) {}
+
+  svOpenArrayHandle handle() { return this; }
+
+  size_t num_elems() const { return num_elems_; }
+  size_t elem_bytes() const { return elem_bytes_; }
+  uint8_t *data() { return storage_.data(); }
+
+  // Set element i to the low bytes of val
+  void Set(size_t i, uint32_t val);
+
+  // Fill the array with a deterministic pseudo-random pattern
+  void Fill(uint32_t seed);
+
+ private:
+  size_t num_elems_;
+  size_t elem_bytes_;
+  std::vector<uint8_t> storage_;
+};
+
+#endif  // OPENTITAN_HW_DV_DPI_BENCH_SVDPI_SHIM_H_
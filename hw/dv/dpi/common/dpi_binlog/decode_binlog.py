@@ -0,0 +1,185 @@
+#!/usr/bin/env python3
+# Copyright lowRISC contributors (OpenTitan project).
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+r"""Decode a binary log written by a DPI monitor (see dpi_binlog.h) to text.
+"""
+import argparse
+import struct
+import sys
+from typing import BinaryIO, Iterator, Tuple
+
+MAGIC = b'OTBINLOG'
+VERSION = 1
+
+SOURCE_SPI = 1
+SOURCE_USB = 2
+
+FILE_HEADER = struct.Struct('<8sII')
+# time, aux, header, len, type, flags, pad
+RECORD = struct.Struct('<QIIIBBH')
+FLAG_TRUNCATED = 0x80
+
+# Record types and flags from spidpi.h
+SPI_XFER = 1
+SPI_FLAG_SDI_TSU = 0x01
+SPI_FLAG_SDO_TSU = 0x02
+
+# Record types and flags from usb_monitor.h
+USB_PACKET = 1
+USB_IDLE = 2
+USB_BUS_CLASH = 3
+USB_BITSTUFF = 4
+USB_BAD_PID = 5
+USB_FLAG_DEVICE = 0x01
+
+USB_PID_NAMES = [
+    'Rsvd', 'OUT', 'ACK', 'DATA0', 'PING', 'SOF', 'NYET', 'DATA2', 'SPLIT',
+    'IN', 'NAK', 'DATA1', 'PRE/ERR', 'SETUP', 'STALL', 'MDATA'
+]
+USB_TOKEN_PIDS = {0xe1, 0x69, 0x2d, 0xa5}
+
+Record = Tuple[int, int, int, int, int, bytes]
+
+
+def read_records(f: BinaryIO) -> Iterator[Record]:
+    '''Yield (time, aux, header, type, flags, payload) for each record'''
+    while True:
+        raw = f.read(RECORD.size)
+        if len(raw) < RECORD.size:
+            return
+        time, aux, header, length, rtype, flags, _ = RECORD.unpack(raw)
+        padded = (length + 7) & ~7
+        data = f.read(padded)
+        if len(data) < padded:
+            return
+        yield (time, aux, header, rtype, flags, data[:length])
+
+
+def hex_bytes(data: bytes) -> str:
+    return ' '.join('{:02x}'.format(b) for b in data)
+
+
+def decode_spi(rec: Record) -> str:
+    time, aux, nbytes, rtype, flags, payload = rec
+    if rtype != SPI_XFER:
+        return '{:8d} SPI: unknown record type {}'.format(time, rtype)
+    notes = ''
+    if flags & SPI_FLAG_SDI_TSU:
+        notes += ' Check SDI tSU'
+    if flags & SPI_FLAG_SDO_TSU:
+        notes += ' Check SDO tSU'
+    return '{:8d} -- {:8d} SPI: H>D: {} D>H: {}{}'.format(
+        aux, time, hex_bytes(payload[:nbytes]), hex_bytes(payload[nbytes:]),
+        notes)
+
+
+def usb_pid_name(pid: int) -> str:
+    if ((pid ^ 0xf0) >> 4) ^ (pid & 0xf):
+        return '???'
+    return USB_PID_NAMES[pid & 0xf]
+
+
+def usb_crc5(value: int, bits: int) -> int:
+    crc = 0x1f
+    for i in range(bits):
+        if ((value >> i) ^ (crc >> 4)) & 1:
+            crc = ((crc << 1) ^ 0x05) & 0x1f
+        else:
+            crc = (crc << 1) & 0x1f
+    return crc ^ 0x1f
+
+
+def usb_crc16(data: bytes) -> int:
+    crc = 0xffff
+    for b in data:
+        for i in range(8):
+            if ((b >> i) ^ crc) & 1:
+                crc = (crc >> 1) ^ 0xa001
+            else:
+                crc >>= 1
+    return crc ^ 0xffff
+
+
+def decode_usb_packet(pid: int, payload: bytes) -> str:
+    name = usb_pid_name(pid)
+    if pid in USB_TOKEN_PIDS and len(payload) == 2:
+        field = payload[0] | (payload[1] & 7) << 8
+        crc = payload[1] >> 3
+        ok = 'OK' if usb_crc5(field, 11) == crc else 'BAD'
+        if pid == 0xa5:
+            return 'SOF {:03x} (CRC5 {:02x} {})'.format(field, crc, ok)
+        return '{} {}.{} (CRC5 {:02x} {})'.format(name, field & 0x7f,
+                                                  field >> 7, crc, ok)
+    if len(payload) >= 2 and (pid & 0xf) in (0x3, 0xb, 0x7, 0xf):
+        data = payload[:-2]
+        pkt_crc = payload[-2] | payload[-1] << 8
+        ok = 'OK' if usb_crc16(data) == pkt_crc else 'BAD'
+        return '{} [{}] (CRC16 {:04x} {})'.format(name, hex_bytes(data),
+                                                 pkt_crc, ok)
+    if payload:
+        return '{} {}'.format(name, hex_bytes(payload))
+    return name
+
+
+def decode_usb(rec: Record) -> str:
+    time, aux, header, rtype, flags, payload = rec
+    who = 'D' if flags & USB_FLAG_DEVICE else 'H'
+    if rtype == USB_PACKET:
+        return 'mon: {:8d} -- {:8d}: ({}) SOP, PID {}, EOP'.format(
+            aux, time, who, decode_usb_packet(header, payload))
+    if rtype == USB_IDLE:
+        if header:
+            return 'mon: {:8d}: Idle, FS resistor (d2p 0x{:x})'.format(
+                time, aux)
+        return 'mon: {:8d}: Idle, SE0'.format(time)
+    if rtype == USB_BUS_CLASH:
+        return 'mon: {:8d}: Bus clash'.format(time)
+    if rtype == USB_BITSTUFF:
+        return 'mon: {:8d}: ({}) Bitstuff error, got 1 after 0x{:x}'.format(
+            time, who, header)
+    if rtype == USB_BAD_PID:
+        return 'mon: {:8d}: ({}) BAD PID 0x{:x}'.format(time, who, header)
+    return 'mon: {:8d}: unknown record type {}'.format(time, rtype)
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('log', type=argparse.FileType('rb'),
+                        help='Binary log to decode')
+    parser.add_argument('--start', type=int, default=0,
+                        help='Skip records before this time')
+    parser.add_argument('--end', type=int,
+                        help='Stop after records at this time')
+    args = parser.parse_args()
+
+    hdr = args.log.read(FILE_HEADER.size)
+    if len(hdr) < FILE_HEADER.size:
+        print('Log is too short for a header', file=sys.stderr)
+        return 1
+    magic, version, source = FILE_HEADER.unpack(hdr)
+    if magic != MAGIC or version != VERSION:
+        print('Not a version {} binary log'.format(VERSION), file=sys.stderr)
+        return 1
+
+    decoders = {SOURCE_SPI: decode_spi, SOURCE_USB: decode_usb}
+    if source not in decoders:
+        print('Unknown log source {}'.format(source), file=sys.stderr)
+        return 1
+    decode = decoders[source]
+
+    for rec in read_records(args.log):
+        time = rec[0]
+        if time < args.start:
+            continue
+        if args.end is not None and time > args.end:
+            break
+        line = decode(rec)
+        if rec[4] & FLAG_TRUNCATED:
+            line += ' (truncated)'
+        print(line)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,194 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "dpi_binlog.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Size of the ring buffer. A power of two, and a multiple of 8 so records
+// (which are padded to 8 bytes) never straddle its end.
+#define RING_SIZE (1u << 20)
+#define RECORD_SIZE ((uint32_t)sizeof(struct dpi_binlog_record))
+// How long the writer thread sleeps when there is nothing to write
+#define IDLE_SLEEP_NS 200000
+
+struct dpi_binlog {
+  FILE *file;
+  pthread_t thread;
+  // Bytes queued and consumed since the log was opened. head is only written
+  // by the producer and tail only by the writer thread.
+  uint64_t head;
+  uint64_t tail;
+  bool closing;
+  // Number of times the producer found the ring full
+  uint64_t stalls;
+  uint8_t *ring;
+};
+
+static uint32_t padded_len(uint32_t len) { return (len + 7u) & ~7u; }
+
+// Write out the records in [tail, head) and return the new tail
+static uint64_t write_records(struct dpi_binlog *log, uint64_t tail,
+                              uint64_t head) {
+  while (tail != head) {
+    uint32_t pos = (uint32_t)(tail % RING_SIZE);
+    uint32_t remain = RING_SIZE - pos;
+    if (remain < RECORD_SIZE) {
+      // Too little space for a record at the end of the ring: the producer
+      // skipped it.
+      tail += remain;
+      continue;
+    }
+    const struct dpi_binlog_record *rec =
+        (const struct dpi_binlog_record *)&log->ring[pos];
+    if (rec->pad) {
+      tail += remain;
+      continue;
+    }
+    size_t size = RECORD_SIZE + padded_len(rec->len);
+    size_t written = fwrite(rec, 1, size, log->file);
+    assert(written == size);
+    tail += size;
+  }
+  return tail;
+}
+
+static void *writer_thread(void *ctx_void) {
+  struct dpi_binlog *log = (struct dpi_binlog *)ctx_void;
+  uint64_t tail = log->tail;
+  bool dirty = false;
+  while (true) {
+    uint64_t head = __atomic_load_n(&log->head, __ATOMIC_ACQUIRE);
+    if (head != tail) {
+      tail = write_records(log, tail, head);
+      __atomic_store_n(&log->tail, tail, __ATOMIC_RELEASE);
+      dirty = true;
+      continue;
+    }
+    // Check for closing only once the ring is empty, so every record queued
+    // before dpi_binlog_close() is written.
+    if (__atomic_load_n(&log->closing, __ATOMIC_ACQUIRE) &&
+        __atomic_load_n(&log->head, __ATOMIC_ACQUIRE) == tail) {
+      break;
+    }
+    if (dirty) {
+      fflush(log->file);
+      dirty = false;
+    }
+    struct timespec ts = {0, IDLE_SLEEP_NS};
+    nanosleep(&ts, NULL);
+  }
+  return NULL;
+}
+
+struct dpi_binlog *dpi_binlog_open(const char *path, uint32_t source) {
+  struct dpi_binlog *log = (struct dpi_binlog *)calloc(1, sizeof(*log));
+  assert(log);
+  log->ring = (uint8_t *)calloc(1, RING_SIZE);
+  assert(log->ring);
+
+  log->file = fopen(path, "wb");
+  if (!log->file) {
+    fprintf(stderr, "BINLOG: Unable to open file at %s: %s\n", path,
+            strerror(errno));
+    free(log->ring);
+    free(log);
+    return NULL;
+  }
+
+  struct dpi_binlog_file_header hdr;
+  memset(&hdr, 0, sizeof(hdr));
+  memcpy(hdr.magic, DPI_BINLOG_MAGIC, sizeof(hdr.magic));
+  hdr.version = DPI_BINLOG_VERSION;
+  hdr.source = source;
+  size_t written = fwrite(&hdr, 1, sizeof(hdr), log->file);
+  assert(written == sizeof(hdr));
+
+  int rv = pthread_create(&log->thread, NULL, writer_thread, log);
+  assert(rv == 0);
+  (void)rv;
+  return log;
+}
+
+// Wait until there are at least size free bytes in the ring
+static void wait_for_space(struct dpi_binlog *log, uint64_t head,
+                           uint32_t size) {
+  if (head + size - __atomic_load_n(&log->tail, __ATOMIC_ACQUIRE) <=
+      RING_SIZE) {
+    return;
+  }
+  log->stalls++;
+  while (head + size - __atomic_load_n(&log->tail, __ATOMIC_ACQUIRE) >
+         RING_SIZE) {
+    sched_yield();
+  }
+}
+
+void dpi_binlog_write(struct dpi_binlog *log, uint64_t time, uint8_t type,
+                      uint8_t flags, uint32_t header, uint32_t aux,
+                      const void *payload, uint32_t len) {
+  assert(log);
+  if (len > DPI_BINLOG_MAX_PAYLOAD) {
+    len = DPI_BINLOG_MAX_PAYLOAD;
+    flags |= DPI_BINLOG_FLAG_TRUNCATED;
+  }
+  uint32_t size = RECORD_SIZE + padded_len(len);
+
+  uint64_t head = log->head;
+  uint32_t pos = (uint32_t)(head % RING_SIZE);
+  uint32_t remain = RING_SIZE - pos;
+  if (remain < size) {
+    // Skip to the start of the ring, marking the skipped space if there is
+    // room for a record header.
+    wait_for_space(log, head, remain + size);
+    if (remain >= RECORD_SIZE) {
+      struct dpi_binlog_record *pad =
+          (struct dpi_binlog_record *)&log->ring[pos];
+      memset(pad, 0, RECORD_SIZE);
+      pad->pad = 1;
+    }
+    head += remain;
+    pos = 0;
+  } else {
+    wait_for_space(log, head, size);
+  }
+
+  struct dpi_binlog_record *rec = (struct dpi_binlog_record *)&log->ring[pos];
+  rec->time = time;
+  rec->aux = aux;
+  rec->header = header;
+  rec->len = len;
+  rec->type = type;
+  rec->flags = flags;
+  rec->pad = 0;
+  uint8_t *data = &log->ring[pos + RECORD_SIZE];
+  if (len) {
+    memcpy(data, payload, len);
+  }
+  memset(data + len, 0, padded_len(len) - len);
+
+  __atomic_store_n(&log->head, head + size, __ATOMIC_RELEASE);
+}
+
+void dpi_binlog_close(struct dpi_binlog *log) {
+  if (!log) {
+    return;
+  }
+  __atomic_store_n(&log->closing, true, __ATOMIC_RELEASE);
+  pthread_join(log->thread, NULL);
+  if (log->stalls) {
+    fprintf(stderr, "BINLOG: Simulation waited for the writer %llu times\n",
+            (unsigned long long)log->stalls);
+  }
+  fclose(log->file);
+  free(log->ring);
+  free(log);
+}
@@ -0,0 +1,106 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef OPENTITAN_HW_DV_DPI_COMMON_DPI_BINLOG_DPI_BINLOG_H_
+#define OPENTITAN_HW_DV_DPI_COMMON_DPI_BINLOG_DPI_BINLOG_H_
+
+/**
+ * Binary event logs for DPI monitors
+ *
+ * A monitor that decodes bus traffic can write each decoded event as a
+ * fixed-size binary record instead of formatting a line of text. Records are
+ * copied into a lock-free single-producer, single-consumer ring buffer on the
+ * simulation thread and written to the file by a background thread, so
+ * logging costs the simulation a memcpy per event. Use decode_binlog.py in
+ * this directory to turn a log back into text.
+ *
+ * A log file starts with a struct dpi_binlog_file_header, followed by records.
+ * Each record is a struct dpi_binlog_record, followed by len bytes of payload
+ * padded with zeros to a multiple of 8 bytes. All fields are little-endian.
+ *
+ * Each log has a single producer: all calls to dpi_binlog_write() for a log
+ * must come from the same thread.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define DPI_BINLOG_MAGIC "OTBINLOG"
+#define DPI_BINLOG_VERSION 1
+
+// Sources of records. The meaning of the type, flags, header and aux fields of
+// a record depends on its source.
+#define DPI_BINLOG_SOURCE_SPI 1
+#define DPI_BINLOG_SOURCE_USB 2
+
+// Largest payload of a record. Longer payloads are truncated, and the record
+// gets DPI_BINLOG_FLAG_TRUNCATED.
+#define DPI_BINLOG_MAX_PAYLOAD 4096
+#define DPI_BINLOG_FLAG_TRUNCATED 0x80
+
+struct dpi_binlog_file_header {
+  char magic[8];
+  uint32_t version;
+  uint32_t source;
+};
+
+struct dpi_binlog_record {
+  // Simulation time of the event, in the source's units
+  uint64_t time;
+  // Source-specific extra information, such as the start time of a packet
+  uint32_t aux;
+  // Decoded header of the event, such as a PID or a byte count
+  uint32_t header;
+  // Length of the payload following the record, before padding
+  uint32_t len;
+  // Event type and flags, defined by the source
+  uint8_t type;
+  uint8_t flags;
+  // Always 0 in the file; marks padding at the end of the ring buffer
+  uint16_t pad;
+};
+
+struct dpi_binlog;
+
+/**
+ * Create a log file and start its writer thread
+ *
+ * @param path name of the file to create
+ * @param source the DPI_BINLOG_SOURCE_* value recorded in the file header
+ * @return the log, or NULL if the file could not be created
+ */
+struct dpi_binlog *dpi_binlog_open(const char *path, uint32_t source);
+
+/**
+ * Queue a record
+ *
+ * Waits for the writer thread if the ring buffer is full, so no records are
+ * lost.
+ *
+ * @param log the log
+ * @param time simulation time of the event
+ * @param type event type
+ * @param flags event flags
+ * @param header decoded header of the event
+ * @param aux extra information
+ * @param payload payload bytes (may be NULL if len is 0)
+ * @param len length of payload
+ */
+void dpi_binlog_write(struct dpi_binlog *log, uint64_t time, uint8_t type,
+                      uint8_t flags, uint32_t header, uint32_t aux,
+                      const void *payload, uint32_t len);
+
+/**
+ * Write out all queued records, stop the writer thread and close the file
+ */
+void dpi_binlog_close(struct dpi_binlog *log);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+#endif  // OPENTITAN_HW_DV_DPI_COMMON_DPI_BINLOG_DPI_BINLOG_H_
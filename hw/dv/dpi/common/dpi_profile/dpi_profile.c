@@ -0,0 +1,55 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "dpi_profile.h"
+
+#include <time.h>
+
+volatile bool dpi_profile_enabled = false;
+
+static struct dpi_profile_counter *counter_list = NULL;
+
+void dpi_profile_set_enabled(bool enabled) { dpi_profile_enabled = enabled; }
+
+uint64_t dpi_profile_now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  // Never return 0, which dpi_profile_begin() uses to mean "disabled"
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec + 1;
+}
+
+static void register_counter(struct dpi_profile_counter *counter) {
+  int expected = 0;
+  if (!__atomic_compare_exchange_n(&counter->registered, &expected, 1, false,
+                                   __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+    return;
+  }
+
+  struct dpi_profile_counter *head =
+      __atomic_load_n(&counter_list, __ATOMIC_ACQUIRE);
+  do {
+    counter->next = head;
+  } while (!__atomic_compare_exchange_n(&counter_list, &head, counter, true,
+                                        __ATOMIC_RELEASE, __ATOMIC_ACQUIRE));
+}
+
+void dpi_profile_record(struct dpi_profile_counter *counter, uint64_t start) {
+  uint64_t ns = dpi_profile_now_ns() - start;
+
+  if (!__atomic_load_n(&counter->registered, __ATOMIC_ACQUIRE)) {
+    register_counter(counter);
+  }
+
+  __atomic_fetch_add(&counter->calls, 1, __ATOMIC_RELAXED);
+  __atomic_fetch_add(&counter->total_ns, ns, __ATOMIC_RELAXED);
+  uint64_t max = __atomic_load_n(&counter->max_ns, __ATOMIC_RELAXED);
+  while (ns > max &&
+         !__atomic_compare_exchange_n(&counter->max_ns, &max, ns, true,
+                                      __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+  }
+}
+
+struct dpi_profile_counter *dpi_profile_counters(void) {
+  return __atomic_load_n(&counter_list, __ATOMIC_ACQUIRE);
+}
@@ -0,0 +1,93 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef OPENTITAN_HW_DV_DPI_COMMON_DPI_PROFILE_DPI_PROFILE_H_
+#define OPENTITAN_HW_DV_DPI_COMMON_DPI_PROFILE_DPI_PROFILE_H_
+
+/**
+ * Call counters for DPI modules
+ *
+ * A DPI module defines a counter for each function it wants to profile and
+ * brackets the body of the function with dpi_profile_begin() and
+ * dpi_profile_end():
+ *
+ *   static struct dpi_profile_counter tick_prof =
+ *       DPI_PROFILE_COUNTER_INIT("jtagdpi.tick");
+ *
+ *   void jtagdpi_tick(...) {
+ *     uint64_t prof_start = dpi_profile_begin();
+ *     ...
+ *     dpi_profile_end(&tick_prof, prof_start);
+ *   }
+ *
+ * Profiling is off until the simulation enables it with
+ * dpi_profile_set_enabled(), and while it is off the two calls only check a
+ * flag. Counters are added to a global list the first time they are updated,
+ * and may be updated from any thread.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+struct dpi_profile_counter {
+  const char *name;
+  uint64_t calls;
+  uint64_t total_ns;
+  uint64_t max_ns;
+  // Set once the counter has been added to the global list
+  int registered;
+  struct dpi_profile_counter *next;
+};
+
+#define DPI_PROFILE_COUNTER_INIT(name_) \
+  { (name_), 0, 0, 0, 0, NULL }
+
+extern volatile bool dpi_profile_enabled;
+
+/**
+ * Enable or disable profiling for all counters
+ */
+void dpi_profile_set_enabled(bool enabled);
+
+/**
+ * Get a monotonic timestamp in ns
+ */
+uint64_t dpi_profile_now_ns(void);
+
+/**
+ * Start timing a call
+ *
+ * @return a timestamp to pass to dpi_profile_end(), or 0 if profiling is
+ *         disabled
+ */
+static inline uint64_t dpi_profile_begin(void) {
+  return dpi_profile_enabled ? dpi_profile_now_ns() : 0;
+}
+
+/**
+ * Record a call that started at start (as returned by dpi_profile_begin())
+ */
+void dpi_profile_record(struct dpi_profile_counter *counter, uint64_t start);
+
+static inline void dpi_profile_end(struct dpi_profile_counter *counter,
+                                   uint64_t start) {
+  if (start) {
+    dpi_profile_record(counter, start);
+  }
+}
+
+/**
+ * Get the first counter that has been updated. The rest follow through the
+ * next pointers, most recently registered first.
+ */
+struct dpi_profile_counter *dpi_profile_counters(void);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+#endif  // OPENTITAN_HW_DV_DPI_COMMON_DPI_PROFILE_DPI_PROFILE_H_
@@ -15,78 +15,234 @@
 #include <netinet/in.h>
 #include <netinet/tcp.h>
 #include <pthread.h>
+#include <stdatomic.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
 #include <sys/socket.h>
-#include <sys/time.h>
 #include <sys/types.h>
 #include <unistd.h>
 
 /**
- * Simple buffer for passing data between TCP sockets and DPI modules
+ * Ring buffer for passing data between TCP sockets and DPI modules
+ *
+ * Each buffer has exactly one producer and one consumer, which run on
+ * different threads (the server thread and whichever simulation thread calls
+ * into the DPI module). The read and write indices are free-running counters,
+ * each written by only one side: the producer publishes data by storing wptr
+ * with release ordering once the bytes are in place, and the consumer frees
+ * space the same way through rptr. This needs no locks.
+ *
+ * The buffer size must be a power of two. It can be overridden at compile
+ * time by defining TCP_SERVER_BUFSIZE_BYTE.
  */
-#define BUFSIZE_BYTE 256
+#ifndef TCP_SERVER_BUFSIZE_BYTE
+#define TCP_SERVER_BUFSIZE_BYTE 4096
+#endif
+
+_Static_assert(TCP_SERVER_BUFSIZE_BYTE > 0 &&
+                   (TCP_SERVER_BUFSIZE_BYTE & (TCP_SERVER_BUFSIZE_BYTE - 1)) ==
+                       0,
+               "TCP_SERVER_BUFSIZE_BYTE must be a power of two");
 
 struct tcp_buf {
-  unsigned int rptr;
-  unsigned int wptr;
-  char buf[BUFSIZE_BYTE];
+  atomic_size_t rptr;
+  atomic_size_t wptr;
+  size_t size;
+  char buf[];
+};
+
+/**
+ * Tag attached to each fd registered with epoll, telling the I/O thread what
+ * the fd is. A tag with a null ctx marks the wakeup eventfd.
+ */
+struct epoll_tag {
+  struct tcp_server_ctx *ctx;
+  bool is_listen;
 };
 
 /**
- * TCP Server thread context structure
+ * TCP Server context structure
  */
 struct tcp_server_ctx {
   // Writeable by the host thread
   char *display_name;
   uint16_t listen_port;
-  volatile bool socket_run;
-  // Writeable by the server thread
+  volatile bool client_close_req;
+  // Set by the I/O thread when it stops watching the client socket because
+  // buf_in is full, or has sent everything in buf_out. The host thread clears
+  // the flag and wakes the I/O thread when it changes the buffer.
+  atomic_bool in_wait;
+  atomic_bool out_wait;
+  // Protected by the I/O loop lock
+  bool remove_req;
+  bool removed;
+  struct tcp_server_ctx *next;
+  // Writeable by the I/O thread
   struct tcp_buf *buf_in;
   struct tcp_buf *buf_out;
   int sfd;  // socket fd
   int cfd;  // client fd
-  pthread_t sock_thread;
+  bool cfd_registered;
+  uint32_t cfd_events;  // epoll events currently requested for cfd
+  struct epoll_tag sfd_tag;
+  struct epoll_tag cfd_tag;
+};
+
+/**
+ * I/O loop shared by all TCP servers
+ *
+ * A single thread services the sockets of every server. It sleeps in
+ * epoll_wait() until a socket is ready or a DPI module changes one of the
+ * buffers that the thread is waiting on, which is signalled through an
+ * eventfd.
+ */
+struct tcp_server_loop {
+  // Serialises starting and stopping the loop with server creation/removal
+  pthread_mutex_t lifecycle_lock;
+  // Protects the server list, taken by the I/O thread while it works
+  pthread_mutex_t lock;
+  pthread_cond_t removed_cond;
+  struct tcp_server_ctx *ctxs;
+  bool running;
+  bool stop;
+  int epfd;
+  int evfd;
+  struct epoll_tag evfd_tag;
+  pthread_t thread;
+};
+
+static struct tcp_server_loop loop = {
+    .lifecycle_lock = PTHREAD_MUTEX_INITIALIZER,
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .removed_cond = PTHREAD_COND_INITIALIZER,
 };
 
+#define MAX_EPOLL_EVENTS 16
+
+static bool tcp_buffer_is_empty(struct tcp_buf *buf) {
+  return atomic_load_explicit(&buf->wptr, memory_order_acquire) ==
+         atomic_load_explicit(&buf->rptr, memory_order_relaxed);
+}
+
+/**
+ * Get the largest contiguous free region of a buffer (producer only)
+ *
+ * @param buf buffer
+ * @param region set to the start of the region
+ * @return number of bytes available at region
+ */
+static size_t tcp_buffer_write_region(struct tcp_buf *buf, char **region) {
+  size_t wptr = atomic_load_explicit(&buf->wptr, memory_order_relaxed);
+  size_t rptr = atomic_load_explicit(&buf->rptr, memory_order_acquire);
+  size_t offset = wptr & (buf->size - 1);
+  size_t space = buf->size - (wptr - rptr);
+  size_t to_end = buf->size - offset;
+
+  *region = buf->buf + offset;
+  return space < to_end ? space : to_end;
+}
+
+/**
+ * Publish len bytes written to a region from tcp_buffer_write_region()
+ */
+static void tcp_buffer_commit_write(struct tcp_buf *buf, size_t len) {
+  size_t wptr = atomic_load_explicit(&buf->wptr, memory_order_relaxed);
+  atomic_store_explicit(&buf->wptr, wptr + len, memory_order_release);
+}
+
 static bool tcp_buffer_is_full(struct tcp_buf *buf) {
-  if (buf->wptr >= buf->rptr) {
-    return (buf->wptr - buf->rptr) == (BUFSIZE_BYTE - 1);
-  } else {
-    return (buf->rptr - buf->wptr) == 1;
-  }
+  return atomic_load_explicit(&buf->wptr, memory_order_relaxed) -
+             atomic_load_explicit(&buf->rptr, memory_order_acquire) ==
+         buf->size;
 }
 
-static bool tcp_buffer_is_empty(struct tcp_buf *buf) {
-  return (buf->wptr == buf->rptr);
+/**
+ * Get the largest contiguous filled region of a buffer (consumer only)
+ *
+ * @param buf buffer
+ * @param region set to the start of the region
+ * @return number of bytes available at region
+ */
+static size_t tcp_buffer_read_region(struct tcp_buf *buf,
+                                     const char **region) {
+  size_t rptr = atomic_load_explicit(&buf->rptr, memory_order_relaxed);
+  size_t wptr = atomic_load_explicit(&buf->wptr, memory_order_acquire);
+  size_t offset = rptr & (buf->size - 1);
+  size_t avail = wptr - rptr;
+  size_t to_end = buf->size - offset;
+
+  *region = buf->buf + offset;
+  return avail < to_end ? avail : to_end;
 }
 
-static void tcp_buffer_put_byte(struct tcp_buf *buf, char dat) {
-  bool done = false;
-  while (!done) {
-    if (!tcp_buffer_is_full(buf)) {
-      buf->buf[buf->wptr++] = dat;
-      buf->wptr %= BUFSIZE_BYTE;
-      done = true;
+/**
+ * Release len bytes read from a region from tcp_buffer_read_region()
+ */
+static void tcp_buffer_commit_read(struct tcp_buf *buf, size_t len) {
+  size_t rptr = atomic_load_explicit(&buf->rptr, memory_order_relaxed);
+  atomic_store_explicit(&buf->rptr, rptr + len, memory_order_release);
+}
+
+/**
+ * Copy up to len bytes into a buffer without blocking (producer only)
+ *
+ * @return number of bytes copied
+ */
+static size_t tcp_buffer_put(struct tcp_buf *buf, const char *src,
+                             size_t len) {
+  size_t done = 0;
+  // At most two iterations: up to the end of the buffer, then from the start.
+  while (done < len) {
+    char *region;
+    size_t n = tcp_buffer_write_region(buf, &region);
+    if (n == 0) {
+      break;
+    }
+    if (n > len - done) {
+      n = len - done;
     }
+    memcpy(region, src + done, n);
+    tcp_buffer_commit_write(buf, n);
+    done += n;
   }
+  return done;
 }
 
-static bool tcp_buffer_get_byte(struct tcp_buf *buf, char *dat) {
-  if (tcp_buffer_is_empty(buf)) {
-    return false;
+/**
+ * Copy up to len bytes out of a buffer without blocking (consumer only)
+ *
+ * @return number of bytes copied
+ */
+static size_t tcp_buffer_get(struct tcp_buf *buf, char *dst, size_t len) {
+  size_t done = 0;
+  while (done < len) {
+    const char *region;
+    size_t n = tcp_buffer_read_region(buf, &region);
+    if (n == 0) {
+      break;
+    }
+    if (n > len - done) {
+      n = len - done;
+    }
+    memcpy(dst + done, region, n);
+    tcp_buffer_commit_read(buf, n);
+    done += n;
   }
-  *dat = buf->buf[buf->rptr++];
-  buf->rptr %= BUFSIZE_BYTE;
-  return true;
+  return done;
 }
 
-static struct tcp_buf *tcp_buffer_new(void) {
+static struct tcp_buf *tcp_buffer_new(size_t size) {
   struct tcp_buf *buf_new;
-  buf_new = (struct tcp_buf *)malloc(sizeof(struct tcp_buf));
-  buf_new->rptr = 0;
-  buf_new->wptr = 0;
+  buf_new = (struct tcp_buf *)malloc(sizeof(struct tcp_buf) + size);
+  if (!buf_new) {
+    return NULL;
+  }
+  atomic_init(&buf_new->rptr, 0);
+  atomic_init(&buf_new->wptr, 0);
+  buf_new->size = size;
   return buf_new;
 }
 
@@ -95,6 +251,49 @@ static void tcp_buffer_free(struct tcp_buf **buf) {
   *buf = NULL;
 }
 
+/**
+ * Wake the I/O thread
+ */
+static void loop_wake(void) {
+  uint64_t one = 1;
+  ssize_t rv = write(loop.evfd, &one, sizeof(one));
+  (void)rv;  // A full counter means a wakeup is already pending.
+}
+
+/**
+ * Wake the I/O thread if it's waiting for a change to a buffer
+ *
+ * Called by the host thread after changing the buffer. Together with
+ * arm_wait() this forms a Dekker-style handshake: with the fences, either the
+ * I/O thread sees the change when it rechecks the buffer, or we see the flag.
+ */
+static void notify_if_waiting(atomic_bool *wait_flag) {
+  atomic_thread_fence(memory_order_seq_cst);
+  if (atomic_load_explicit(wait_flag, memory_order_relaxed) &&
+      atomic_exchange(wait_flag, false)) {
+    loop_wake();
+  }
+}
+
+/**
+ * Arm a wait flag, then recheck the condition that we want to wait for
+ *
+ * Called by the I/O thread. Returns true if it may go to sleep (the condition
+ * still holds), or false (with the flag cleared) if the host thread changed
+ * the buffer in the meantime.
+ */
+static bool arm_wait(atomic_bool *wait_flag,
+                     bool (*still_waiting)(struct tcp_buf *),
+                     struct tcp_buf *buf) {
+  atomic_store_explicit(wait_flag, true, memory_order_relaxed);
+  atomic_thread_fence(memory_order_seq_cst);
+  if (still_waiting(buf)) {
+    return true;
+  }
+  atomic_store_explicit(wait_flag, false, memory_order_relaxed);
+  return false;
+}
+
 /**
  * Start a TCP server
  *
@@ -219,6 +418,28 @@ static int client_tryaccept(struct tcp_server_ctx *ctx) {
   return 0;
 }
 
+/**
+ * Close the connection to the client (if any)
+ *
+ * Must only be called from the server thread.
+ *
+ * @param ctx context object
+ */
+static void client_close(struct tcp_server_ctx *ctx) {
+  assert(ctx);
+
+  if (!ctx->cfd) {
+    return;
+  }
+
+  if (ctx->cfd_registered) {
+    epoll_ctl(loop.epfd, EPOLL_CTL_DEL, ctx->cfd, NULL);
+    ctx->cfd_registered = false;
+  }
+  close(ctx->cfd);
+  ctx->cfd = 0;
+}
+
 /**
  * Stop the TCP server
  *
@@ -229,58 +450,86 @@ static void stop(struct tcp_server_ctx *ctx) {
   if (!ctx->sfd) {
     return;
   }
+  epoll_ctl(loop.epfd, EPOLL_CTL_DEL, ctx->sfd, NULL);
   close(ctx->sfd);
   ctx->sfd = 0;
 }
 
 /**
- * Receive a byte from a connected client
+ * Move data from a connected client into the input buffer
+ *
+ * Reads directly into the free space of the buffer until either the buffer is
+ * full or there is no more data waiting on the socket.
  *
  * @param ctx context object
- * @param cmd byte received
- * @return true if a byte was read
  */
-static bool get_byte(struct tcp_server_ctx *ctx, char *cmd) {
+static void client_recv(struct tcp_server_ctx *ctx) {
   assert(ctx);
 
-  ssize_t num_read = read(ctx->cfd, cmd, 1);
+  while (ctx->cfd) {
+    char *region;
+    size_t space = tcp_buffer_write_region(ctx->buf_in, &region);
+    if (space == 0) {
+      return;
+    }
 
-  if (num_read == 0) {
-    return false;
-  }
-  if (num_read == -1) {
-    if (errno == EAGAIN || errno == EWOULDBLOCK) {
-      return false;
-    } else if (errno == EBADF) {
-      // Possibly client went away? Accept a new connection.
-      fprintf(stderr, "%s: Client disappeared.\n", ctx->display_name);
-      tcp_server_client_close(ctx);
-      return false;
-    } else {
-      fprintf(stderr, "%s: Error while reading from client: %s (%d)\n",
-              ctx->display_name, strerror(errno), errno);
-      assert(0 && "Error reading from client");
+    ssize_t num_read = read(ctx->cfd, region, space);
+
+    if (num_read == 0) {
+      // The client closed the connection. Anything it sent before that is
+      // still in the buffer.
+      printf("%s: Client disconnected.\n", ctx->display_name);
+      client_close(ctx);
+      return;
+    }
+    if (num_read == -1) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        return;
+      } else if (errno == EBADF) {
+        // Possibly client went away? Accept a new connection.
+        fprintf(stderr, "%s: Client disappeared.\n", ctx->display_name);
+        client_close(ctx);
+        return;
+      } else {
+        fprintf(stderr, "%s: Error while reading from client: %s (%d)\n",
+                ctx->display_name, strerror(errno), errno);
+        assert(0 && "Error reading from client");
+      }
+    }
+
+    tcp_buffer_commit_write(ctx->buf_in, (size_t)num_read);
+    if ((size_t)num_read < space) {
+      return;
     }
   }
-  assert(num_read == 1);
-  return true;
 }
 
 /**
- * Send a byte to a connected client
+ * Send data from the output buffer to a connected client
+ *
+ * Sends as much as the socket accepts without blocking; anything left over
+ * stays in the buffer for the next iteration of the server loop. If the
+ * client has gone away, pending output is discarded.
  *
  * @param ctx context object
- * @param cmd byte to send
  */
-static void put_byte(struct tcp_server_ctx *ctx, char cmd) {
-  while (1) {
-    ssize_t num_written = send(ctx->cfd, &cmd, sizeof(cmd), MSG_NOSIGNAL);
+static void client_send(struct tcp_server_ctx *ctx) {
+  assert(ctx);
+
+  while (ctx->cfd) {
+    const char *region;
+    size_t avail = tcp_buffer_read_region(ctx->buf_out, &region);
+    if (avail == 0) {
+      return;
+    }
+
+    ssize_t num_written = send(ctx->cfd, region, avail, MSG_NOSIGNAL);
     if (num_written == -1) {
       if (errno == EAGAIN || errno == EWOULDBLOCK) {
-        continue;
+        return;
       } else if (errno == EPIPE) {
         printf("%s: Remote disconnected.\n", ctx->display_name);
-        tcp_server_client_close(ctx);
+        client_close(ctx);
         break;
       } else {
         fprintf(stderr, "%s: Error while writing to client: %s (%d)\n",
@@ -288,9 +537,15 @@ static void put_byte(struct tcp_server_ctx *ctx, char cmd) {
         assert(0 && "Error writing to client.");
       }
     }
-    if (num_written >= 1) {
-      break;
-    }
+
+    tcp_buffer_commit_read(ctx->buf_out, (size_t)num_written);
+  }
+
+  // No client to send to: drop whatever is left.
+  const char *region;
+  size_t avail;
+  while ((avail = tcp_buffer_read_region(ctx->buf_out, &region)) != 0) {
+    tcp_buffer_commit_read(ctx->buf_out, avail);
   }
 }
 
@@ -311,86 +566,227 @@ static void ctx_free(struct tcp_server_ctx *ctx) {
 }
 
 /**
- * Thread function to create a new server instance
+ * Update the events that the I/O thread waits for on a server's sockets
  *
- * @param ctx_void context object
- * @return Always returns NULL
+ * We wait for data from the client only while there is space to store it, and
+ * for the client socket to become writable only while there is data to send.
+ * If we stop waiting for a socket, we arm the corresponding wait flag so that
+ * the host thread wakes us when it changes the buffer.
+ *
+ * @param ctx context object
  */
-static void *server_create(void *ctx_void) {
-  // Cast to a server struct
-  struct tcp_server_ctx *ctx = (struct tcp_server_ctx *)ctx_void;
-  struct timeval timeout;
+static void update_events(struct tcp_server_ctx *ctx) {
+  if (!ctx->cfd) {
+    // Nobody to send any output to: keep discarding it until we can wait.
+    while (!arm_wait(&ctx->out_wait, tcp_buffer_is_empty, ctx->buf_out)) {
+      client_send(ctx);
+    }
+    return;
+  }
 
-  // Start the server
-  int rv = start(ctx);
-  if (rv != 0) {
-    fprintf(stderr, "%s: Unable to create TCP server on port %d\n",
-            ctx->display_name, ctx->listen_port);
-    goto err_cleanup_return;
+  uint32_t events = 0;
+  if (!arm_wait(&ctx->in_wait, tcp_buffer_is_full, ctx->buf_in)) {
+    events |= EPOLLIN;
+  }
+  if (!arm_wait(&ctx->out_wait, tcp_buffer_is_empty, ctx->buf_out)) {
+    events |= EPOLLOUT;
   }
 
-  // Initialise fd_set
+  if (ctx->cfd_registered && events == ctx->cfd_events) {
+    return;
+  }
 
-  // Start waiting for connection / data
-  char xfer_data;
-  while (ctx->socket_run) {
-    // Initialise structure of fds
-    fd_set read_fds;
-    FD_ZERO(&read_fds);
-    if (ctx->sfd) {
-      FD_SET(ctx->sfd, &read_fds);
-    }
-    if (ctx->cfd) {
-      FD_SET(ctx->cfd, &read_fds);
-    }
-    // max fd num
-    int mfd = (ctx->cfd > ctx->sfd) ? ctx->cfd : ctx->sfd;
+  struct epoll_event ev;
+  memset(&ev, 0, sizeof(ev));
+  ev.events = events;
+  ev.data.ptr = &ctx->cfd_tag;
+  int op = ctx->cfd_registered ? EPOLL_CTL_MOD : EPOLL_CTL_ADD;
+  if (epoll_ctl(loop.epfd, op, ctx->cfd, &ev) != 0) {
+    fprintf(stderr, "%s: Unable to watch client socket: %s (%d)\n",
+            ctx->display_name, strerror(errno), errno);
+    client_close(ctx);
+    return;
+  }
+  ctx->cfd_registered = true;
+  ctx->cfd_events = events;
+}
+
+/**
+ * Handle an event reported by epoll
+ *
+ * @param tag tag of the fd that is ready
+ * @param events epoll events for the fd
+ * @return true if this was a wakeup from the host thread
+ */
+static bool handle_event(struct epoll_tag *tag, uint32_t events) {
+  if (!tag->ctx) {
+    uint64_t count;
+    ssize_t rv = read(loop.evfd, &count, sizeof(count));
+    (void)rv;
+    return true;
+  }
 
-    // Set timeout - 50us gives good performance; do it every time
-    // since select can trash it.
-    timeout.tv_sec = 0;
-    timeout.tv_usec = 50;
+  struct tcp_server_ctx *ctx = tag->ctx;
+  if (tag->is_listen) {
+    client_tryaccept(ctx);
+    return false;
+  }
 
-    // Wait for socket activity or timeout
-    rv = select(mfd + 1, &read_fds, NULL, NULL, &timeout);
+  if (events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+    client_recv(ctx);
+  }
+  if (events & EPOLLOUT) {
+    client_send(ctx);
+  }
+  return false;
+}
 
-    if (rv < 0) {
+/**
+ * Thread function of the I/O loop
+ *
+ * @param unused unused argument
+ * @return Always returns NULL
+ */
+static void *loop_run(void *unused) {
+  (void)unused;
+  struct epoll_event events[MAX_EPOLL_EVENTS];
+
+  while (1) {
+    int num_events = epoll_wait(loop.epfd, events, MAX_EPOLL_EVENTS, -1);
+    if (num_events < 0) {
       if (errno == EINTR) {
         // On interrupt we want to retry
         continue;
       }
+      fprintf(stderr, "TCP server: epoll_wait failed: %s (%d)\n",
+              strerror(errno), errno);
+      assert(0 && "epoll_wait failed");
+    }
 
-      printf("%s: Socket read failed, port: %d\n", ctx->display_name,
-             ctx->listen_port);
-      tcp_server_client_close(ctx);
+    pthread_mutex_lock(&loop.lock);
+    if (loop.stop) {
+      pthread_mutex_unlock(&loop.lock);
+      break;
     }
 
-    // New connection
-    if (FD_ISSET(ctx->sfd, &read_fds)) {
-      client_tryaccept(ctx);
+    bool woken = false;
+    for (int i = 0; i < num_events; ++i) {
+      woken |= handle_event((struct epoll_tag *)events[i].data.ptr,
+                            events[i].events);
     }
 
-    // New client data
-    if (FD_ISSET(ctx->cfd, &read_fds)) {
-      while (!tcp_buffer_is_full(ctx->buf_in) && get_byte(ctx, &xfer_data)) {
-        tcp_buffer_put_byte(ctx->buf_in, xfer_data);
+    bool any_removed = false;
+    struct tcp_server_ctx **link = &loop.ctxs;
+    while (*link) {
+      struct tcp_server_ctx *ctx = *link;
+
+      if (woken) {
+        // The host thread may have freed space in buf_in or queued data in
+        // buf_out.
+        if (ctx->cfd && !(ctx->cfd_events & EPOLLIN)) {
+          client_recv(ctx);
+        }
+        client_send(ctx);
       }
-    }
 
-    if (ctx->cfd != 0) {
-      while (tcp_buffer_get_byte(ctx->buf_out, &xfer_data)) {
-        put_byte(ctx, xfer_data);
+      // Disconnect requested by the DPI module, once pending output is sent
+      if (ctx->client_close_req &&
+          (!ctx->cfd || tcp_buffer_is_empty(ctx->buf_out))) {
+        client_close(ctx);
+        ctx->client_close_req = false;
       }
+
+      if (ctx->remove_req) {
+        client_close(ctx);
+        stop(ctx);
+        *link = ctx->next;
+        ctx->removed = true;
+        any_removed = true;
+        continue;
+      }
+
+      update_events(ctx);
+      link = &ctx->next;
     }
+
+    if (any_removed) {
+      pthread_cond_broadcast(&loop.removed_cond);
+    }
+    pthread_mutex_unlock(&loop.lock);
   }
 
-err_cleanup_return:
+  return NULL;
+}
 
-  // Simulation done - clean up
-  tcp_server_client_close(ctx);
-  stop(ctx);
+/**
+ * Start the I/O loop if it isn't running yet
+ *
+ * Must be called with the lifecycle lock held.
+ *
+ * @return 0 on success, -1 in case of an error
+ */
+static int loop_start(void) {
+  if (loop.running) {
+    return 0;
+  }
 
-  return NULL;
+  loop.epfd = epoll_create1(EPOLL_CLOEXEC);
+  if (loop.epfd == -1) {
+    fprintf(stderr, "TCP server: Unable to create epoll instance: %s (%d)\n",
+            strerror(errno), errno);
+    return -1;
+  }
+
+  loop.evfd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (loop.evfd == -1) {
+    fprintf(stderr, "TCP server: Unable to create eventfd: %s (%d)\n",
+            strerror(errno), errno);
+    close(loop.epfd);
+    return -1;
+  }
+
+  struct epoll_event ev;
+  memset(&ev, 0, sizeof(ev));
+  ev.events = EPOLLIN;
+  loop.evfd_tag.ctx = NULL;
+  ev.data.ptr = &loop.evfd_tag;
+  if (epoll_ctl(loop.epfd, EPOLL_CTL_ADD, loop.evfd, &ev) != 0) {
+    fprintf(stderr, "TCP server: Unable to watch eventfd: %s (%d)\n",
+            strerror(errno), errno);
+    close(loop.evfd);
+    close(loop.epfd);
+    return -1;
+  }
+
+  loop.stop = false;
+  if (pthread_create(&loop.thread, NULL, loop_run, NULL) != 0) {
+    fprintf(stderr, "TCP server: Unable to create I/O thread\n");
+    close(loop.evfd);
+    close(loop.epfd);
+    return -1;
+  }
+
+  loop.running = true;
+  return 0;
+}
+
+/**
+ * Stop the I/O loop
+ *
+ * Must be called with the lifecycle lock held, once all servers are removed.
+ */
+static void loop_stop(void) {
+  assert(loop.running && !loop.ctxs);
+
+  pthread_mutex_lock(&loop.lock);
+  loop.stop = true;
+  pthread_mutex_unlock(&loop.lock);
+  loop_wake();
+  pthread_join(loop.thread, NULL);
+
+  close(loop.evfd);
+  close(loop.epfd);
+  loop.running = false;
 }
 
 // Abstract interface functions
@@ -401,54 +797,117 @@ struct tcp_server_ctx *tcp_server_create(const char *display_name,
   assert(ctx);
 
   // Create the buffers
-  struct tcp_buf *buf_in = tcp_buffer_new();
-  struct tcp_buf *buf_out = tcp_buffer_new();
+  struct tcp_buf *buf_in = tcp_buffer_new(TCP_SERVER_BUFSIZE_BYTE);
+  struct tcp_buf *buf_out = tcp_buffer_new(TCP_SERVER_BUFSIZE_BYTE);
   assert(buf_in);
   assert(buf_out);
 
   // Populate the struct with buffer pointers
   ctx->buf_in = buf_in;
   ctx->buf_out = buf_out;
+  // buf_out starts off empty, so the I/O thread needs waking for the first
+  // write.
+  atomic_init(&ctx->in_wait, false);
+  atomic_init(&ctx->out_wait, true);
+  ctx->sfd_tag.ctx = ctx;
+  ctx->sfd_tag.is_listen = true;
+  ctx->cfd_tag.ctx = ctx;
+  ctx->cfd_tag.is_listen = false;
 
   // Set up socket details
-  ctx->socket_run = true;
   ctx->listen_port = listen_port;
   ctx->display_name = strdup(display_name);
   assert(ctx->display_name);
 
-  if (pthread_create(&ctx->sock_thread, NULL, server_create, (void *)ctx) !=
-      0) {
-    fprintf(stderr, "%s: Unable to create TCP socket thread\n",
-            ctx->display_name);
+  pthread_mutex_lock(&loop.lifecycle_lock);
+  if (loop_start() != 0) {
+    pthread_mutex_unlock(&loop.lifecycle_lock);
     ctx_free(ctx);
-    free(ctx);
     return NULL;
   }
+
+  // Start the server. On failure, we still return a context (which never gets
+  // a client) so that the simulation can carry on.
+  if (start(ctx) != 0) {
+    fprintf(stderr, "%s: Unable to create TCP server on port %d\n",
+            ctx->display_name, ctx->listen_port);
+  }
+
+  pthread_mutex_lock(&loop.lock);
+  if (ctx->sfd) {
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.ptr = &ctx->sfd_tag;
+    if (epoll_ctl(loop.epfd, EPOLL_CTL_ADD, ctx->sfd, &ev) != 0) {
+      fprintf(stderr, "%s: Unable to watch server socket: %s (%d)\n",
+              ctx->display_name, strerror(errno), errno);
+    }
+  }
+  ctx->next = loop.ctxs;
+  loop.ctxs = ctx;
+  pthread_mutex_unlock(&loop.lock);
+  pthread_mutex_unlock(&loop.lifecycle_lock);
+
   return ctx;
 }
 
 bool tcp_server_read(struct tcp_server_ctx *ctx, char *dat) {
-  return tcp_buffer_get_byte(ctx->buf_in, dat);
+  return tcp_server_read_buf(ctx, dat, 1) == 1;
+}
+
+size_t tcp_server_read_buf(struct tcp_server_ctx *ctx, char *dat,
+                           size_t len) {
+  size_t num_read = tcp_buffer_get(ctx->buf_in, dat, len);
+  if (num_read) {
+    notify_if_waiting(&ctx->in_wait);
+  }
+  return num_read;
 }
 
 void tcp_server_write(struct tcp_server_ctx *ctx, char dat) {
-  tcp_buffer_put_byte(ctx->buf_out, dat);
+  tcp_server_write_buf(ctx, &dat, 1);
+}
+
+void tcp_server_write_buf(struct tcp_server_ctx *ctx, const char *dat,
+                          size_t len) {
+  // Wait for the I/O thread to make space if the buffer is full
+  size_t done = 0;
+  while (done < len) {
+    size_t num_written = tcp_buffer_put(ctx->buf_out, dat + done, len - done);
+    if (num_written) {
+      notify_if_waiting(&ctx->out_wait);
+      done += num_written;
+    }
+  }
 }
 
 void tcp_server_close(struct tcp_server_ctx *ctx) {
-  // Shut down the socket thread
-  ctx->socket_run = false;
-  pthread_join(ctx->sock_thread, NULL);
+  pthread_mutex_lock(&loop.lifecycle_lock);
+
+  // Ask the I/O thread to close the sockets and forget about the server. It
+  // might be using ctx right now, so we can't do it ourselves.
+  pthread_mutex_lock(&loop.lock);
+  ctx->remove_req = true;
+  loop_wake();
+  while (!ctx->removed) {
+    pthread_cond_wait(&loop.removed_cond, &loop.lock);
+  }
+  bool last = !loop.ctxs;
+  pthread_mutex_unlock(&loop.lock);
+
+  if (last) {
+    loop_stop();
+  }
+  pthread_mutex_unlock(&loop.lifecycle_lock);
+
   ctx_free(ctx);
 }
 
 void tcp_server_client_close(struct tcp_server_ctx *ctx) {
   assert(ctx);
 
-  if (!ctx->cfd) {
-    return;
-  }
-
-  close(ctx->cfd);
-  ctx->cfd = 0;
+  // The client fd is owned by the I/O thread, which does the actual close.
+  ctx->client_close_req = true;
+  loop_wake();
 }
@@ -10,6 +10,9 @@
  *
  * This is intended to be used by simulation add-on DPI modules to provide
  * basic TCP socket communication between a host and simulated peripherals.
+ *
+ * The sockets of all servers are serviced by a single background thread,
+ * which sleeps until there is socket activity or data to send.
  */
 
 #ifdef __cplusplus
@@ -17,6 +20,7 @@ extern "C" {
 #endif
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 struct tcp_server_ctx;
@@ -30,6 +34,16 @@ struct tcp_server_ctx;
  */
 bool tcp_server_read(struct tcp_server_ctx *ctx, char *dat);
 
+/**
+ * Non-blocking read of up to len bytes from a connected client
+ *
+ * @param ctx tcp server context object
+ * @param dat buffer for the bytes received
+ * @param len maximum number of bytes to read
+ * @return number of bytes read
+ */
+size_t tcp_server_read_buf(struct tcp_server_ctx *ctx, char *dat, size_t len);
+
 /**
  * Write a byte to a connected client
  *
@@ -41,6 +55,19 @@ bool tcp_server_read(struct tcp_server_ctx *ctx, char *dat);
  */
 void tcp_server_write(struct tcp_server_ctx *ctx, char dat);
 
+/**
+ * Write len bytes to a connected client
+ *
+ * Like tcp_server_write(), but for a block of data. Blocks until all the data
+ * has been buffered.
+ *
+ * @param ctx tcp server context object
+ * @param dat bytes to send
+ * @param len number of bytes to send
+ */
+void tcp_server_write_buf(struct tcp_server_ctx *ctx, const char *dat,
+                          size_t len);
+
 /**
  * Create a new TCP server instance
  *
@@ -61,6 +88,9 @@ void tcp_server_close(struct tcp_server_ctx *ctx);
 /**
  * Instruct the server to disconnect a client
  *
+ * The disconnect happens asynchronously on the server thread, after any data
+ * already passed to tcp_server_write() has been sent.
+ *
  * @param ctx tcp server context object
  */
 void tcp_server_client_close(struct tcp_server_ctx *ctx);
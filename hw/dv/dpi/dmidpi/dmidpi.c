@@ -82,12 +82,195 @@ struct dmi_sig_values {
   uint8_t dmi_rst_n;
 };
 
+#define CMD_BUF_SIZE 64
+
+// Native DMI protocol (see README.md). Requests are 6 bytes: a header byte
+// (NATIVE_HDR | op), the address and 32 bits of data (little-endian).
+// Responses are 5 bytes: a header byte (NATIVE_HDR | resp) and 32 bits of
+// data. remote_bitbang commands are all ASCII, so a byte with the top bit set
+// at a command boundary always starts a native request.
+#define NATIVE_HDR 0x80
+#define NATIVE_REQ_SIZE 6
+#define NATIVE_RSP_SIZE 5
+#define NATIVE_QUEUE_SIZE 16
+#define NATIVE_RSP_BUF_SIZE (NATIVE_QUEUE_SIZE * NATIVE_RSP_SIZE)
+
+enum dmi_op_t { DmiOpNop = 0, DmiOpRead = 1, DmiOpWrite = 2 };
+
+struct dmi_native_req {
+  uint32_t addr;
+  uint32_t op;
+  uint32_t data;
+};
+
+struct native_ctx {
+  // Request frame being received
+  uint8_t frame[NATIVE_REQ_SIZE];
+  size_t frame_len;
+  // Requests that have been received but not yet sent to the design
+  struct dmi_native_req queue[NATIVE_QUEUE_SIZE];
+  size_t queue_head;
+  size_t queue_len;
+  // Requests sent to the design that haven't had a response yet
+  unsigned int inflight;
+  // Responses that haven't been sent to the client yet
+  char rsp_buf[NATIVE_RSP_BUF_SIZE];
+  size_t rsp_len;
+};
+
 struct dmidpi_ctx {
   struct tcp_server_ctx *sock;
   struct jtag_ctx jtag;
   struct dmi_sig_values sig;
+  struct native_ctx native;
+  // Command bytes received from the server but not yet processed
+  char cmd_buf[CMD_BUF_SIZE];
+  size_t cmd_pos;
+  size_t cmd_len;
 };
 
+/**
+ * Look at the next command byte from the client without consuming it
+ *
+ * Commands are fetched from the server in blocks and buffered in the context.
+ *
+ * @param ctx dmidpi context object
+ * @param cmd command byte
+ * @return true if a command byte was available
+ */
+static bool peek_cmd(struct dmidpi_ctx *ctx, char *cmd) {
+  if (ctx->cmd_pos == ctx->cmd_len) {
+    ctx->cmd_pos = 0;
+    ctx->cmd_len = tcp_server_read_buf(ctx->sock, ctx->cmd_buf, CMD_BUF_SIZE);
+    if (ctx->cmd_len == 0) {
+      return false;
+    }
+  }
+  *cmd = ctx->cmd_buf[ctx->cmd_pos];
+  return true;
+}
+
+/**
+ * Are native DMI requests waiting to be sent or waiting for a response?
+ *
+ * @param ctx dmidpi context object
+ */
+static bool native_busy(const struct dmidpi_ctx *ctx) {
+  return ctx->native.frame_len || ctx->native.queue_len ||
+         ctx->native.inflight;
+}
+
+/**
+ * Send all queued native DMI responses to the client
+ *
+ * @param ctx dmidpi context object
+ */
+static void native_flush(struct dmidpi_ctx *ctx) {
+  if (ctx->native.rsp_len) {
+    tcp_server_write_buf(ctx->sock, ctx->native.rsp_buf, ctx->native.rsp_len);
+    ctx->native.rsp_len = 0;
+  }
+}
+
+/**
+ * Queue the DMI response currently on the interface for the client
+ *
+ * @param ctx dmidpi context object
+ */
+static void native_queue_rsp(struct dmidpi_ctx *ctx) {
+  struct native_ctx *native = &ctx->native;
+
+  assert(native->inflight);
+  --native->inflight;
+
+  if (native->rsp_len + NATIVE_RSP_SIZE > NATIVE_RSP_BUF_SIZE) {
+    native_flush(ctx);
+  }
+
+  char *rsp = native->rsp_buf + native->rsp_len;
+  uint32_t data = ctx->sig.dmi_rsp_data;
+  rsp[0] = (char)(NATIVE_HDR | (ctx->sig.dmi_rsp_resp & 0x3));
+  for (int i = 0; i < 4; ++i) {
+    rsp[1 + i] = (char)(data >> (8 * i));
+  }
+  native->rsp_len += NATIVE_RSP_SIZE;
+}
+
+/**
+ * Consume one byte of a native DMI request frame
+ *
+ * A completed frame is added to the request queue. The first byte of a frame
+ * is only consumed if there is space in the queue.
+ *
+ * @param ctx dmidpi context object
+ * @param byte next byte from the client
+ * @return true if the byte was consumed
+ */
+static bool native_receive(struct dmidpi_ctx *ctx, char byte) {
+  struct native_ctx *native = &ctx->native;
+
+  if (native->frame_len == 0 && native->queue_len == NATIVE_QUEUE_SIZE) {
+    return false;
+  }
+
+  native->frame[native->frame_len++] = (uint8_t)byte;
+  if (native->frame_len < NATIVE_REQ_SIZE) {
+    return true;
+  }
+  native->frame_len = 0;
+
+  uint32_t op = native->frame[0] & ~NATIVE_HDR;
+  if (op != DmiOpRead && op != DmiOpWrite) {
+    fprintf(stderr,
+            "DMI DPI: Protocol violation detected: unsupported native request "
+            "header 0x%02x\n",
+            native->frame[0]);
+    exit(1);
+  }
+
+  size_t idx = (native->queue_head + native->queue_len) % NATIVE_QUEUE_SIZE;
+  struct dmi_native_req *req = &native->queue[idx];
+  req->op = op;
+  req->addr = native->frame[1] & 0x7F;
+  req->data = 0;
+  for (int i = 0; i < 4; ++i) {
+    req->data |= (uint32_t)native->frame[2 + i] << (8 * i);
+  }
+  ++native->queue_len;
+
+  // The native protocol has no notion of the JTAG TAP, so take the debug
+  // module interface out of reset.
+  ctx->sig.dmi_rst_n = 1;
+  return true;
+}
+
+/**
+ * Drive the next queued native DMI request, if the interface is free
+ *
+ * Unlike requests through the emulated JTAG DTM, these don't wait for the
+ * response to the previous request.
+ *
+ * @param ctx dmidpi context object
+ */
+static void native_issue_req(struct dmidpi_ctx *ctx) {
+  struct native_ctx *native = &ctx->native;
+
+  if (!native->queue_len || ctx->sig.dmi_req_valid ||
+      ctx->jtag.dmi_outstanding) {
+    return;
+  }
+
+  struct dmi_native_req *req = &native->queue[native->queue_head];
+  ctx->sig.dmi_req_valid = 1;
+  ctx->sig.dmi_req_addr = req->addr;
+  ctx->sig.dmi_req_op = req->op;
+  ctx->sig.dmi_req_data = req->data;
+
+  native->queue_head = (native->queue_head + 1) % NATIVE_QUEUE_SIZE;
+  --native->queue_len;
+  ++native->inflight;
+}
+
 /**
  * Setup the correct shift register data
  *
@@ -338,6 +521,13 @@ static void process_dmi_inputs(struct dmidpi_ctx *ctx) {
   // Always ready for a resp
   ctx->sig.dmi_rsp_ready = 1;
   if (ctx->sig.dmi_rsp_valid) {
+    // Responses come back in request order, so the native requests (which
+    // are never issued while a JTAG request is outstanding, or vice versa)
+    // get the first ones.
+    if (ctx->native.inflight) {
+      native_queue_rsp(ctx);
+      return;
+    }
     ctx->jtag.dr_captured = (uint64_t)ctx->sig.dmi_rsp_data << 2;
     ctx->jtag.dr_captured |= (uint64_t)ctx->sig.dmi_rsp_resp & 0x3;
     // Clear req outstanding flag
@@ -356,22 +546,43 @@ static void update_dmi_state(struct dmidpi_ctx *ctx) {
   // read input from design
   process_dmi_inputs(ctx);
 
-  // If we are waiting for a previous transaction to complete, do not attempt
-  // a new one
-  if (ctx->jtag.dmi_outstanding) {
-    return;
-  }
-
-  char done = 0;
+  // If we are waiting for a previous JTAG transaction to complete, do not
+  // attempt a new one
+  char done = ctx->jtag.dmi_outstanding;
   while (!done) {
-    // read a command byte
+    // look at the next command byte
     char cmd;
-    if (!tcp_server_read(ctx->sock, &cmd)) {
-      return;
+    if (!peek_cmd(ctx, &cmd)) {
+      break;
+    }
+
+    if (ctx->native.frame_len || (cmd & NATIVE_HDR)) {
+      // Native requests are queued, so we can keep going
+      if (!native_receive(ctx, cmd)) {
+        break;
+      }
+      ++ctx->cmd_pos;
+      continue;
     }
+
+    // JTAG commands wait for all native requests to complete, so that the two
+    // don't get each other's responses.
+    if (native_busy(ctx)) {
+      break;
+    }
+
     // Process command bytes until a command completes
+    ++ctx->cmd_pos;
     done = process_cmd_byte(ctx, cmd);
   }
+
+  native_issue_req(ctx);
+
+  // Send responses together, once there's nothing else that could come back
+  // straight away.
+  if (!native_busy(ctx)) {
+    native_flush(ctx);
+  }
 }
 
 void *dmidpi_create(const char *display_name, int listen_port) {
@@ -389,7 +600,8 @@ void *dmidpi_create(const char *display_name, int listen_port) {
       "OpenOCD and the following configuration to connect:\n"
       "  interface remote_bitbang\n"
       "  remote_bitbang_host localhost\n"
-      "  remote_bitbang_port %d\n",
+      "  remote_bitbang_port %d\n"
+      "or connect directly with the native DMI protocol (see dmidpi README).\n",
       display_name, listen_port, listen_port);
 
   return (void *)ctx;
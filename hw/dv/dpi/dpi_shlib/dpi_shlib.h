@@ -0,0 +1,74 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef OPENTITAN_HW_DV_DPI_DPI_SHLIB_DPI_SHLIB_H_
+#define OPENTITAN_HW_DV_DPI_DPI_SHLIB_DPI_SHLIB_H_
+
+/**
+ * DPI modules in a shared library
+ *
+ * Normally the C side of the DPI modules is linked into the simulator
+ * binary, so any change to a module means relinking the (large) simulation.
+ * Instead, the modules can be built into a shared library (see the Makefile
+ * in this directory), and the simulation linked against dpi_shlib_shim.cc.
+ * The shim defines every function listed in dpi_shlib_funcs.def, forwarding
+ * each call to the function of the same name in a library loaded at startup
+ * with dlopen().
+ *
+ * The library must be built from the same list: it holds a
+ * dpi_shlib_abi_version() function returning the DPI_SHLIB_ABI_VERSION it
+ * was built with, which the loader checks. The simulation binary must be
+ * linked with -rdynamic, so that the library can resolve the svdpi functions
+ * (and any other symbols the modules use, such as the dpi_profile counters)
+ * against it.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Increment whenever dpi_shlib_funcs.def changes.
+#define DPI_SHLIB_ABI_VERSION 2
+
+// The default name of the library, which is looked up with the usual dlopen()
+// search rules
+#define DPI_SHLIB_DEFAULT_NAME "libopentitan_dpi.so.1"
+
+/**
+ * Get the DPI_SHLIB_ABI_VERSION that a library was built with
+ *
+ * This is defined in the shared library.
+ */
+unsigned dpi_shlib_abi_version(void);
+
+#ifdef __cplusplus
+}  // extern "C"
+
+#include <string>
+
+/**
+ * Load the DPI library at path
+ *
+ * This must be called before the model is first evaluated, since initial
+ * blocks call the DPI modules. Calls into the shim before a library has been
+ * loaded abort the simulation.
+ *
+ * @return true on success. On failure, prints an error message.
+ */
+bool DpiShlibLoad(const std::string &path);
+
+/**
+ * Load the DPI library named by the command line
+ *
+ * The library is given with --dpi-lib=PATH. Otherwise, it's taken from the
+ * OPENTITAN_DPI_LIB environment variable, and otherwise it's
+ * DPI_SHLIB_DEFAULT_NAME. The argument is left in argv, where other parsers
+ * ignore it.
+ *
+ * @return true on success
+ */
+bool DpiShlibLoadFromArgs(int argc, char **argv);
+#endif
+
+#endif  // OPENTITAN_HW_DV_DPI_DPI_SHLIB_DPI_SHLIB_H_
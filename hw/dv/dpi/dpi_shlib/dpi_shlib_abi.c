@@ -0,0 +1,10 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+// Built into the DPI shared library, to be checked by the loader in
+// dpi_shlib_shim.cc
+
+#include "dpi_shlib.h"
+
+unsigned dpi_shlib_abi_version(void) { return DPI_SHLIB_ABI_VERSION; }
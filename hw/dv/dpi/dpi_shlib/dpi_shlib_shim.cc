@@ -0,0 +1,112 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dlfcn.h>
+#include <iostream>
+#include <svdpi.h>
+
+#include "dpi_shlib.h"
+
+namespace {
+// A pointer to each function in the loaded library
+struct DpiShlibFuncs {
+#define DPI_SHLIB_FUNC(ret, name, params, args) ret(*name) params;
+#include "dpi_shlib_funcs.def"
+#undef DPI_SHLIB_FUNC
+};
+
+DpiShlibFuncs funcs;
+bool loaded = false;
+
+[[noreturn]] void NotLoaded(const char *name) {
+  fprintf(stderr,
+          "ERROR: DPI function %s called before the DPI library was loaded "
+          "(see DpiShlibLoad()).\n",
+          name);
+  abort();
+}
+}  // namespace
+
+// The shim for each function, with the symbol that the simulation calls
+extern "C" {
+#define DPI_SHLIB_FUNC(ret, name, params, args) \
+  ret name params {                             \
+    if (!loaded) {                              \
+      NotLoaded(#name);                         \
+    }                                           \
+    return funcs.name args;                     \
+  }
+#include "dpi_shlib_funcs.def"
+#undef DPI_SHLIB_FUNC
+}
+
+bool DpiShlibLoad(const std::string &path) {
+  if (loaded) {
+    std::cerr << "ERROR: A DPI library has already been loaded." << std::endl;
+    return false;
+  }
+
+  // Bind everything now, so that a library which doesn't match the simulation
+  // fails here rather than part way through a run. RTLD_DEEPBIND isn't used:
+  // the library must see the simulation's svdpi functions.
+  void *handle = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+  if (!handle) {
+    std::cerr << "ERROR: Unable to load DPI library " << path << ": "
+              << dlerror() << std::endl;
+    return false;
+  }
+
+  auto abi_version = reinterpret_cast<unsigned (*)(void)>(
+      dlsym(handle, "dpi_shlib_abi_version"));
+  if (!abi_version) {
+    std::cerr << "ERROR: " << path << " is not a DPI library." << std::endl;
+    dlclose(handle);
+    return false;
+  }
+  if (abi_version() != DPI_SHLIB_ABI_VERSION) {
+    std::cerr << "ERROR: DPI library " << path << " has ABI version "
+              << abi_version() << ", but the simulation expects version "
+              << DPI_SHLIB_ABI_VERSION << ". Rebuild one of them."
+              << std::endl;
+    dlclose(handle);
+    return false;
+  }
+
+  bool good = true;
+#define DPI_SHLIB_FUNC(ret, name, params, args)                       \
+  funcs.name = reinterpret_cast<ret(*) params>(dlsym(handle, #name)); \
+  if (!funcs.name) {                                                  \
+    std::cerr << "ERROR: DPI library " << path                        \
+              << " has no function " #name "." << std::endl;          \
+    good = false;                                                     \
+  }
+#include "dpi_shlib_funcs.def"
+#undef DPI_SHLIB_FUNC
+
+  if (!good) {
+    dlclose(handle);
+    return false;
+  }
+
+  std::cout << "Loaded DPI library " << path << std::endl;
+  loaded = true;
+  return true;
+}
+
+bool DpiShlibLoadFromArgs(int argc, char **argv) {
+  static const char kArg[] = "--dpi-lib=";
+
+  const char *path = getenv("OPENTITAN_DPI_LIB");
+  for (int i = 1; i < argc; ++i) {
+    if (strncmp(argv[i], kArg, sizeof(kArg) - 1) == 0) {
+      path = argv[i] + sizeof(kArg) - 1;
+    }
+  }
+
+  return DpiShlibLoad(path ? path : DPI_SHLIB_DEFAULT_NAME);
+}
@@ -15,6 +15,8 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <limits.h>
+#include <poll.h>
+#include <pthread.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -23,8 +25,8 @@
 #include <sys/types.h>
 #include <unistd.h>
 
-// The number of ticks of host_to_device_tick between making syscalls.
-#define TICKS_PER_SYSCALL 2048
+// Size of the buffer for commands from the host
+#define CMD_BUF_SIZE 256
 
 // This module currently is capable of implementing 32 GPIOs.
 #define NUM_GPIO 32
@@ -35,6 +37,17 @@
 #define SET_BIT(word, bit_idx) ((word) |= (1 << (bit_idx)))
 #define CLR_BIT(word, bit_idx) ((word) &= ~(1 << (bit_idx)))
 
+// Formats for the pin values written to the device-to-host FIFO
+enum gpiodpi_format {
+  // One character per pin ('0', '1' or 'X'), MSB first, then a newline
+  kFormatText,
+  // As kFormatText, but preceded by the cycle count in decimal and a space
+  kFormatTimestamp,
+  // Binary records: 64-bit cycle count, 32-bit data and 32-bit output enable,
+  // all little-endian
+  kFormatBinary,
+};
+
 struct gpiodpi_ctx {
   // The number of pins we're driving.
   int n_bits;
@@ -43,9 +56,15 @@ struct gpiodpi_ctx {
   uint32_t driven_pin_values;
   // Whether or not the pin is being driven weakly or strongly.
   uint32_t weak_pins;
-  // A counter of calls into the host_to_device_tick function; used to
-  // avoid excessive `read` syscalls to the pipe fd.
-  uint32_t counter;
+  // A counter of calls into the host_to_device_tick function (which is called
+  // once per clock cycle out of reset); used for timestamps.
+  uint64_t cycles;
+
+  // How to write out pin values, and the values that were last written
+  enum gpiodpi_format format;
+  bool reported;
+  uint32_t reported_data;
+  uint32_t reported_oe;
 
   // File descriptors and paths for the device-to-host and host-to-device
   // FIFOs.
@@ -53,6 +72,17 @@ struct gpiodpi_ctx {
   char dev_to_host_path[PATH_MAX];
   int host_to_dev_fifo;
   char host_to_dev_path[PATH_MAX];
+
+  // Commands from the host are read by a thread that sleeps until there is
+  // something to read, so the simulation doesn't have to poll the FIFO. The
+  // thread appends to cmd_buf (under cmd_lock) and sets has_cmd.
+  pthread_t reader;
+  bool reader_running;
+  int stop_pipe[2];
+  pthread_mutex_t cmd_lock;
+  char cmd_buf[CMD_BUF_SIZE];
+  size_t cmd_len;
+  bool has_cmd;
 };
 
 /**
@@ -105,11 +135,81 @@ static void print_usage(char *rfifo, char *wfifo, int n_bits) {
          wfifo);
   printf("$ echo 'wh10' > %s  # Pull pin 10 high through a weak pull-up.\n",
          wfifo);
+  printf(
+      "GPIO: Pass +gpiodpi_format=timestamp (or binary) to timestamp the pin "
+      "values.\n");
 }
 
-void *gpiodpi_create(const char *name, int n_bits) {
+/**
+ * Thread function reading commands from the host-to-device FIFO
+ *
+ * @param ctx_void the gpiodpi context
+ * @return Always returns NULL
+ */
+static void *reader_run(void *ctx_void) {
+  struct gpiodpi_ctx *ctx = (struct gpiodpi_ctx *)ctx_void;
+
+  while (true) {
+    struct pollfd fds[2];
+    fds[0].fd = ctx->host_to_dev_fifo;
+    fds[0].events = POLLIN;
+    fds[1].fd = ctx->stop_pipe[0];
+    fds[1].events = POLLIN;
+
+    if (poll(fds, 2, -1) < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      fprintf(stderr, "GPIO: poll on FIFO failed: %s\n", strerror(errno));
+      return NULL;
+    }
+    if (fds[1].revents) {
+      return NULL;
+    }
+    if (!(fds[0].revents & POLLIN)) {
+      continue;
+    }
+
+    pthread_mutex_lock(&ctx->cmd_lock);
+    size_t space = CMD_BUF_SIZE - 1 - ctx->cmd_len;
+    ssize_t read_len = 0;
+    if (space > 0) {
+      read_len =
+          read(ctx->host_to_dev_fifo, ctx->cmd_buf + ctx->cmd_len, space);
+    }
+    if (read_len > 0) {
+      ctx->cmd_len += (size_t)read_len;
+      __atomic_store_n(&ctx->has_cmd, true, __ATOMIC_RELEASE);
+    }
+    pthread_mutex_unlock(&ctx->cmd_lock);
+
+    if (space == 0) {
+      // The simulation hasn't caught up with the last commands yet.
+      usleep(1000);
+    }
+  }
+}
+
+/**
+ * Parse an output format name, as passed to gpiodpi_create().
+ */
+static enum gpiodpi_format parse_format(const char *name) {
+  if (name == NULL || name[0] == '\0' || strcmp(name, "text") == 0) {
+    return kFormatText;
+  }
+  if (strcmp(name, "timestamp") == 0) {
+    return kFormatTimestamp;
+  }
+  if (strcmp(name, "binary") == 0) {
+    return kFormatBinary;
+  }
+  fprintf(stderr, "GPIO: Unknown output format `%s'; using `text'.\n", name);
+  return kFormatText;
+}
+
+void *gpiodpi_create(const char *name, int n_bits, const char *format) {
   struct gpiodpi_ctx *ctx =
-      (struct gpiodpi_ctx *)malloc(sizeof(struct gpiodpi_ctx));
+      (struct gpiodpi_ctx *)calloc(1, sizeof(struct gpiodpi_ctx));
   assert(ctx);
 
   // n_bits > 32 requires more sophisticated handling of svBitVecVal which we
@@ -119,7 +219,8 @@ void *gpiodpi_create(const char *name, int n_bits) {
 
   ctx->driven_pin_values = 0;
   ctx->weak_pins = 0;
-  ctx->counter = 0;
+  ctx->cycles = 0;
+  ctx->format = parse_format(format);
 
   char cwd_buf[PATH_MAX];
   char *cwd = getcwd(cwd_buf, sizeof(cwd_buf));
@@ -145,6 +246,14 @@ void *gpiodpi_create(const char *name, int n_bits) {
   int flags = fcntl(ctx->host_to_dev_fifo, F_GETFL, 0);
   fcntl(ctx->host_to_dev_fifo, F_SETFL, flags | O_NONBLOCK);
 
+  pthread_mutex_init(&ctx->cmd_lock, NULL);
+  if (pipe(ctx->stop_pipe) != 0 ||
+      pthread_create(&ctx->reader, NULL, reader_run, ctx) != 0) {
+    fprintf(stderr, "GPIO: Unable to start FIFO reader thread\n");
+    return NULL;
+  }
+  ctx->reader_running = true;
+
   print_usage(ctx->dev_to_host_path, ctx->host_to_dev_path, ctx->n_bits);
 
   return (void *)ctx;
@@ -155,24 +264,58 @@ void gpiodpi_device_to_host(void *ctx_void, svBitVecVal *gpio_data,
   struct gpiodpi_ctx *ctx = (struct gpiodpi_ctx *)ctx_void;
   assert(ctx);
 
+  // Only report a change in what the host can see: the values of pins that
+  // aren't enabled don't matter.
+  uint32_t mask =
+      ctx->n_bits == 32 ? UINT32_MAX : (((uint32_t)1 << ctx->n_bits) - 1);
+  uint32_t oe = gpio_oe[0] & mask;
+  uint32_t data = gpio_data[0] & oe;
+  if (ctx->reported && data == ctx->reported_data && oe == ctx->reported_oe) {
+    return;
+  }
+  ctx->reported = true;
+  ctx->reported_data = data;
+  ctx->reported_oe = oe;
+
+  if (ctx->format == kFormatBinary) {
+    uint8_t record[16];
+    for (int i = 0; i < 8; ++i) {
+      record[i] = (uint8_t)(ctx->cycles >> (8 * i));
+    }
+    for (int i = 0; i < 4; ++i) {
+      record[8 + i] = (uint8_t)(data >> (8 * i));
+      record[12 + i] = (uint8_t)(oe >> (8 * i));
+    }
+    ssize_t written = write(ctx->dev_to_host_fifo, record, sizeof(record));
+    assert(written == sizeof(record));
+    (void)written;
+    return;
+  }
+
   // Write 0, 1, or X (when oe is not set) for each GPIO pin, in big endian
   // order (i.e., pin 0 is the last character written). Finish it with a
-  // newline.
-  char gpio_str[32 + 1];
+  // newline. In timestamp format, this is preceded by the cycle count.
+  char gpio_str[20 + 1 + 32 + 1];
   char *pin_char = gpio_str;
+  if (ctx->format == kFormatTimestamp) {
+    pin_char += snprintf(gpio_str, 20 + 2, "%llu ",
+                         (unsigned long long)ctx->cycles);
+  }
   for (int i = ctx->n_bits - 1; i >= 0; --i, ++pin_char) {
-    if (!GET_BIT(gpio_oe[0], i)) {
+    if (!GET_BIT(oe, i)) {
       *pin_char = 'X';
-    } else if (GET_BIT(gpio_data[0], i)) {
+    } else if (GET_BIT(data, i)) {
       *pin_char = '1';
     } else {
       *pin_char = '0';
     }
   }
-  *pin_char = '\n';
+  *pin_char++ = '\n';
 
-  ssize_t written = write(ctx->dev_to_host_fifo, gpio_str, ctx->n_bits + 1);
-  assert(written == ctx->n_bits + 1);
+  ssize_t len = pin_char - gpio_str;
+  ssize_t written = write(ctx->dev_to_host_fifo, gpio_str, len);
+  assert(written == len);
+  (void)written;
 }
 
 /**
@@ -217,10 +360,16 @@ uint32_t gpiodpi_host_to_device_tick(void *ctx_void, svBitVecVal *gpio_oe,
   struct gpiodpi_ctx *ctx = (struct gpiodpi_ctx *)ctx_void;
   assert(ctx);
 
-  if (ctx->counter % TICKS_PER_SYSCALL == 0) {
-    char gpio_str[256];
-    ssize_t read_len =
-        read(ctx->host_to_dev_fifo, gpio_str, sizeof(gpio_str) - 1);
+  // Only take the lock if the reader thread has new commands for us
+  if (__atomic_load_n(&ctx->has_cmd, __ATOMIC_ACQUIRE)) {
+    char gpio_str[CMD_BUF_SIZE];
+    pthread_mutex_lock(&ctx->cmd_lock);
+    size_t read_len = ctx->cmd_len;
+    memcpy(gpio_str, ctx->cmd_buf, read_len);
+    ctx->cmd_len = 0;
+    __atomic_store_n(&ctx->has_cmd, false, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&ctx->cmd_lock);
+
     if (read_len > 0) {
       gpio_str[read_len] = '\0';
 
@@ -283,7 +432,7 @@ uint32_t gpiodpi_host_to_device_tick(void *ctx_void, svBitVecVal *gpio_oe,
   }
 
 parse_loop_end:
-  ctx->counter += 1;
+  ctx->cycles += 1;
   // The verilated module simulates logic, but the weak/strong inputs result
   // from the properties of the IO pads and the selection of external pull
   // resistors. Since the verilated model doesn't model the analog properties
@@ -305,6 +454,16 @@ void gpiodpi_close(void *ctx_void) {
     return;
   }
 
+  if (ctx->reader_running) {
+    char stop = 0;
+    ssize_t rv = write(ctx->stop_pipe[1], &stop, 1);
+    (void)rv;
+    pthread_join(ctx->reader, NULL);
+    close(ctx->stop_pipe[0]);
+    close(ctx->stop_pipe[1]);
+  }
+  pthread_mutex_destroy(&ctx->cmd_lock);
+
   if (close(ctx->dev_to_host_fifo) != 0) {
     printf("GPIO: Failed to close FIFO file at %s: %s\n", ctx->dev_to_host_path,
            strerror(errno));
@@ -17,12 +17,20 @@ extern "C" {
  * @param name a name to use when creating the inner FIFO.
  * @param n_bits number of bits to write in each direction; this must be at
  *        most 32 bits.
+ * @param format format of the pin values written for the host: "text" (or
+ *        empty) for one character per pin and a newline, "timestamp" for the
+ *        same preceded by the cycle count, or "binary" for 16-byte records of
+ *        cycle count (64 bits), data and output enable (32 bits each), all
+ *        little-endian.
  */
-void *gpiodpi_create(const char *name, int n_bits);
+void *gpiodpi_create(const char *name, int n_bits, const char *format);
 
 /**
  * Attempt to post the current GPIO state to the outside world.
  *
+ * Nothing is written if the state the host can see (the output enables, and
+ * the values of enabled pins) hasn't changed since the last call.
+ *
  * Intended to be called from SystemVerilog.
  */
 void gpiodpi_device_to_host(void *ctx_void, svBitVecVal *gpio_data,
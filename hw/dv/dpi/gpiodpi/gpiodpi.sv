@@ -18,7 +18,8 @@ module gpiodpi
   input  logic [N_GPIO-1:0] gpio_pull_sel
 );
    import "DPI-C" function
-     chandle gpiodpi_create(input string name, input int n_bits);
+     chandle gpiodpi_create(input string name, input int n_bits,
+                            input string format);
 
    import "DPI-C" function
      void gpiodpi_device_to_host(input chandle ctx, input logic [N_GPIO-1:0] gpio_d2p,
@@ -36,8 +37,12 @@ module gpiodpi
    chandle ctx;
 
    function automatic void initialize();
+     // The output format can be chosen at runtime (see gpiodpi.h)
+     string format = "text";
+     void'($value$plusargs("gpiodpi_format=%s", format));
+
      $display($time, "GPIO: creating gpiodpi");
-     ctx = gpiodpi_create(NAME, N_GPIO);
+     ctx = gpiodpi_create(NAME, N_GPIO, format);
    endfunction
 
    // Allow being activated past initial time.
@@ -55,10 +60,11 @@ module gpiodpi
 
    logic eff_clk = clk_i && active;
 
-   logic [N_GPIO-1:0] gpio_d2p_r;
+   logic [N_GPIO-1:0] gpio_d2p_r, gpio_en_d2p_r;
    always_ff @(posedge eff_clk) begin
      gpio_d2p_r <= gpio_d2p;
-     if (gpio_d2p_r != gpio_d2p) begin
+     gpio_en_d2p_r <= gpio_en_d2p;
+     if (gpio_d2p_r != gpio_d2p || gpio_en_d2p_r != gpio_en_d2p) begin
        gpiodpi_device_to_host(ctx, gpio_d2p, gpio_en_d2p);
      end
    end
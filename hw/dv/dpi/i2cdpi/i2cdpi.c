@@ -0,0 +1,470 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "i2cdpi.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "tcp_server.h"
+
+// Size of the register file of the target, which is addressed by an 8-bit
+// pointer like a small EEPROM.
+#define MEM_SIZE 256
+// Maximum length of a command line from the host
+#define CMD_BUF_SIZE 1024
+// Maximum number of data bytes in a controller transfer
+#define MAX_XFER_LEN 256
+
+enum target_state {
+  // Not addressed: waiting for a start condition
+  TARGET_IDLE,
+  // Receiving the address byte
+  TARGET_ADDR,
+  // Addressed for a write: receiving the pointer and data
+  TARGET_WRITE,
+  // Addressed for a read: sending data
+  TARGET_READ,
+};
+
+enum ctrl_state {
+  CTRL_IDLE,
+  // SDA pulled low with SCL high
+  CTRL_START,
+  // SCL low, SDA set up for the next bit halfway through
+  CTRL_BIT_LOW,
+  // SCL released, waiting for it to go high (clock stretching) and the end
+  // of the high phase
+  CTRL_BIT_HIGH,
+  // SCL low, SDA pulled low halfway through
+  CTRL_STOP_LOW,
+  // SCL released, SDA low
+  CTRL_STOP_HIGH,
+  // Both released, bus free time before the next transfer
+  CTRL_STOP_DONE,
+};
+
+struct i2cdpi_ctx {
+  // Server context
+  struct tcp_server_ctx *sock;
+  bool controller;
+  // Bus levels on the previous tick, to detect edges and start/stop
+  uint8_t prev_scl;
+  uint8_t prev_sda;
+  // Levels driven by the model
+  uint8_t scl_o;
+  uint8_t sda_o;
+  // Command line being received from the host
+  char cmd_buf[CMD_BUF_SIZE];
+  size_t cmd_len;
+
+  // Target
+  uint8_t target_addr;
+  uint8_t mem[MEM_SIZE];
+  enum target_state tstate;
+  // Bit within the current byte, 8 for the acknowledge bit
+  unsigned t_bit;
+  // Whether SCL has risen during the current bit
+  bool t_clocked;
+  uint8_t t_shift;
+  bool t_read;
+  bool t_have_ptr;
+  uint8_t t_ptr;
+  uint8_t t_tx;
+  bool t_acked;
+
+  // Controller
+  unsigned half_period;
+  enum ctrl_state cstate;
+  unsigned c_count;
+  // Bytes of the transfer, starting with the address byte
+  uint8_t c_bytes[1 + MAX_XFER_LEN];
+  size_t c_len;
+  bool c_read;
+  size_t c_byte;
+  unsigned c_bit;
+  uint8_t c_shift;
+  bool c_nack;
+};
+
+static void send_str(struct i2cdpi_ctx *ctx, const char *str) {
+  tcp_server_write_buf(ctx->sock, str, strlen(str));
+}
+
+/**
+ * Send bytes to the host as a line of space-separated hex values
+ */
+static void send_bytes(struct i2cdpi_ctx *ctx, const uint8_t *bytes,
+                       size_t len) {
+  char line[3 * MAX_XFER_LEN + 2];
+  size_t pos = 0;
+  for (size_t i = 0; i < len; ++i) {
+    pos += snprintf(line + pos, sizeof(line) - pos, i ? " %02x" : "%02x",
+                    bytes[i]);
+  }
+  line[pos++] = '\n';
+  tcp_server_write_buf(ctx->sock, line, pos);
+}
+
+/**
+ * Parse up to max_vals hex values from a command line
+ *
+ * @return the number of values parsed, or -1 if the line is malformed
+ */
+static int parse_hex(char *args, unsigned *vals, int max_vals) {
+  int n = 0;
+  char *save;
+  for (char *tok = strtok_r(args, " \t\r", &save); tok;
+       tok = strtok_r(NULL, " \t\r", &save)) {
+    char *end;
+    unsigned long val = strtoul(tok, &end, 16);
+    if (*end != '\0' || val > 0xff || n == max_vals) {
+      return -1;
+    }
+    vals[n++] = val;
+  }
+  return n;
+}
+
+/**
+ * Start a controller transfer
+ */
+static void ctrl_begin(struct i2cdpi_ctx *ctx, bool read, unsigned addr,
+                       const unsigned *data, size_t len) {
+  ctx->c_read = read;
+  ctx->c_bytes[0] = (uint8_t)(addr << 1) | (read ? 1 : 0);
+  for (size_t i = 0; i < len; ++i) {
+    ctx->c_bytes[1 + i] = read ? 0 : data[i];
+  }
+  ctx->c_len = 1 + len;
+  ctx->c_byte = 0;
+  ctx->c_bit = 0;
+  ctx->c_nack = false;
+  // The transfer starts once the bus is free.
+  ctx->cstate = CTRL_START;
+  ctx->c_count = 0;
+}
+
+static void process_cmd(struct i2cdpi_ctx *ctx, char *line) {
+  char cmd = line[0];
+  unsigned vals[1 + MAX_XFER_LEN];
+  int n = line[0] ? parse_hex(line + 1, vals, 1 + MAX_XFER_LEN) : 0;
+  if (n < 0) {
+    send_str(ctx, "ERR malformed command\n");
+    return;
+  }
+
+  if (!ctx->controller) {
+    if (cmd == 'a' && n == 1 && vals[0] < 0x80) {
+      // Set the target address
+      ctx->target_addr = vals[0];
+      send_str(ctx, "OK\n");
+    } else if (cmd == 'w' && n >= 1) {
+      // Write the register file
+      for (int i = 1; i < n; ++i) {
+        ctx->mem[(vals[0] + i - 1) % MEM_SIZE] = vals[i];
+      }
+      send_str(ctx, "OK\n");
+    } else if (cmd == 'r' && n == 2) {
+      // Read the register file
+      uint8_t bytes[MEM_SIZE];
+      for (unsigned i = 0; i < vals[1]; ++i) {
+        bytes[i] = ctx->mem[(vals[0] + i) % MEM_SIZE];
+      }
+      send_bytes(ctx, bytes, vals[1]);
+    } else {
+      send_str(ctx, "ERR unsupported target command\n");
+    }
+    return;
+  }
+
+  if (cmd == 'W' && n >= 1 && vals[0] < 0x80) {
+    ctrl_begin(ctx, false, vals[0], &vals[1], n - 1);
+  } else if (cmd == 'R' && n == 2 && vals[0] < 0x80 && vals[1] > 0) {
+    ctrl_begin(ctx, true, vals[0], NULL, vals[1]);
+  } else {
+    send_str(ctx, "ERR unsupported controller command\n");
+  }
+}
+
+/**
+ * Fetch and process the next command from the host, if any
+ */
+static void poll_cmd(struct i2cdpi_ctx *ctx) {
+  char c;
+  while (tcp_server_read(ctx->sock, &c)) {
+    if (c != '\n') {
+      if (ctx->cmd_len < CMD_BUF_SIZE - 1) {
+        ctx->cmd_buf[ctx->cmd_len++] = c;
+      }
+      continue;
+    }
+    ctx->cmd_buf[ctx->cmd_len] = '\0';
+    ctx->cmd_len = 0;
+    process_cmd(ctx, ctx->cmd_buf);
+    // A controller command occupies the bus until it has completed.
+    if (ctx->cstate != CTRL_IDLE) {
+      return;
+    }
+  }
+}
+
+static void target_tick(struct i2cdpi_ctx *ctx, uint8_t scl, uint8_t sda) {
+  if (scl && ctx->prev_scl && sda != ctx->prev_sda) {
+    // SDA changing while SCL is high is a (repeated) start or a stop.
+    ctx->tstate = sda ? TARGET_IDLE : TARGET_ADDR;
+    ctx->t_bit = 0;
+    ctx->t_clocked = false;
+    ctx->t_shift = 0;
+    ctx->sda_o = 1;
+    return;
+  }
+  if (ctx->tstate == TARGET_IDLE) {
+    return;
+  }
+
+  if (scl && !ctx->prev_scl) {
+    // Sample on the rising edge of SCL.
+    ctx->t_clocked = true;
+    if (ctx->t_bit < 8) {
+      ctx->t_shift = (uint8_t)(ctx->t_shift << 1) | sda;
+    } else if (ctx->tstate == TARGET_READ) {
+      ctx->t_acked = !sda;
+    }
+  } else if (!scl && ctx->prev_scl && ctx->t_clocked) {
+    // Drive on the falling edge of SCL. The falling edge that ends a start
+    // condition doesn't end a bit.
+    ctx->t_clocked = false;
+    if (ctx->t_bit < 8) {
+      if (++ctx->t_bit < 8) {
+        if (ctx->tstate == TARGET_READ) {
+          ctx->sda_o = (ctx->t_tx >> (7 - ctx->t_bit)) & 1;
+        }
+        return;
+      }
+      // The byte is complete: acknowledge it or let the controller do so.
+      switch (ctx->tstate) {
+        case TARGET_ADDR:
+          if ((ctx->t_shift >> 1) != ctx->target_addr) {
+            ctx->tstate = TARGET_IDLE;
+            return;
+          }
+          ctx->t_read = ctx->t_shift & 1;
+          ctx->sda_o = 0;
+          break;
+        case TARGET_WRITE:
+          if (ctx->t_have_ptr) {
+            ctx->mem[ctx->t_ptr++] = ctx->t_shift;
+          } else {
+            ctx->t_ptr = ctx->t_shift;
+            ctx->t_have_ptr = true;
+          }
+          ctx->sda_o = 0;
+          break;
+        default:
+          ctx->sda_o = 1;
+          break;
+      }
+      return;
+    }
+
+    // The acknowledge bit is over.
+    ctx->t_bit = 0;
+    ctx->t_shift = 0;
+    ctx->sda_o = 1;
+    if (ctx->tstate == TARGET_ADDR) {
+      if (ctx->t_read) {
+        ctx->tstate = TARGET_READ;
+        ctx->t_acked = true;
+      } else {
+        ctx->tstate = TARGET_WRITE;
+        ctx->t_have_ptr = false;
+      }
+    }
+    if (ctx->tstate == TARGET_READ) {
+      if (!ctx->t_acked) {
+        // The controller is done reading; it sends a stop or start next.
+        ctx->tstate = TARGET_IDLE;
+        return;
+      }
+      ctx->t_tx = ctx->mem[ctx->t_ptr++];
+      ctx->sda_o = ctx->t_tx >> 7;
+    }
+  }
+}
+
+/**
+ * Level of SDA for the current bit of a controller transfer
+ */
+static uint8_t ctrl_sda(const struct i2cdpi_ctx *ctx) {
+  bool rx = ctx->c_read && ctx->c_byte > 0;
+  if (ctx->c_bit < 8) {
+    return rx ? 1 : (ctx->c_bytes[ctx->c_byte] >> (7 - ctx->c_bit)) & 1;
+  }
+  // Acknowledge all but the last byte read.
+  return rx ? ctx->c_byte == ctx->c_len - 1 : 1;
+}
+
+/**
+ * Sample SDA at the end of the high phase of a bit
+ *
+ * @return true if the transfer goes on with another bit
+ */
+static bool ctrl_sample(struct i2cdpi_ctx *ctx, uint8_t sda) {
+  bool rx = ctx->c_read && ctx->c_byte > 0;
+  if (ctx->c_bit < 8) {
+    ctx->c_shift = (uint8_t)(ctx->c_shift << 1) | sda;
+    ++ctx->c_bit;
+    return true;
+  }
+  if (rx) {
+    ctx->c_bytes[ctx->c_byte] = ctx->c_shift;
+  } else if (sda) {
+    ctx->c_nack = true;
+    return false;
+  }
+  ctx->c_bit = 0;
+  ctx->c_shift = 0;
+  return ++ctx->c_byte < ctx->c_len;
+}
+
+static void ctrl_done(struct i2cdpi_ctx *ctx) {
+  if (ctx->c_nack) {
+    send_str(ctx, "NACK\n");
+  } else if (ctx->c_read) {
+    send_bytes(ctx, &ctx->c_bytes[1], ctx->c_len - 1);
+  } else {
+    send_str(ctx, "ACK\n");
+  }
+}
+
+static void ctrl_tick(struct i2cdpi_ctx *ctx, uint8_t scl, uint8_t sda) {
+  if (ctx->c_count > 0) {
+    // Clock stretching: the high phase only starts once SCL is high.
+    if (ctx->cstate != CTRL_BIT_HIGH && ctx->cstate != CTRL_STOP_HIGH) {
+      --ctx->c_count;
+    } else if (scl) {
+      --ctx->c_count;
+    }
+    if (ctx->c_count == ctx->half_period / 2) {
+      if (ctx->cstate == CTRL_BIT_LOW) {
+        ctx->sda_o = ctrl_sda(ctx);
+      } else if (ctx->cstate == CTRL_STOP_LOW) {
+        ctx->sda_o = 0;
+      }
+    }
+    return;
+  }
+
+  switch (ctx->cstate) {
+    case CTRL_IDLE:
+      break;
+    case CTRL_START:
+      if (ctx->sda_o) {
+        // Wait for the bus to be free before pulling SDA low.
+        if (scl && sda) {
+          ctx->sda_o = 0;
+          ctx->c_count = ctx->half_period;
+        }
+        break;
+      }
+      ctx->scl_o = 0;
+      ctx->cstate = CTRL_BIT_LOW;
+      ctx->c_count = ctx->half_period;
+      break;
+    case CTRL_BIT_LOW:
+      ctx->scl_o = 1;
+      ctx->cstate = CTRL_BIT_HIGH;
+      ctx->c_count = ctx->half_period;
+      break;
+    case CTRL_BIT_HIGH:
+      ctx->scl_o = 0;
+      ctx->cstate = ctrl_sample(ctx, sda) ? CTRL_BIT_LOW : CTRL_STOP_LOW;
+      ctx->c_count = ctx->half_period;
+      break;
+    case CTRL_STOP_LOW:
+      ctx->scl_o = 1;
+      ctx->cstate = CTRL_STOP_HIGH;
+      ctx->c_count = ctx->half_period;
+      break;
+    case CTRL_STOP_HIGH:
+      ctx->sda_o = 1;
+      ctx->cstate = CTRL_STOP_DONE;
+      ctx->c_count = ctx->half_period;
+      break;
+    case CTRL_STOP_DONE:
+      ctx->cstate = CTRL_IDLE;
+      ctrl_done(ctx);
+      break;
+  }
+}
+
+void *i2cdpi_create(const char *display_name, int listen_port, int controller,
+                    int target_addr, int half_period) {
+  struct i2cdpi_ctx *ctx =
+      (struct i2cdpi_ctx *)calloc(1, sizeof(struct i2cdpi_ctx));
+  assert(ctx);
+
+  ctx->controller = controller != 0;
+  ctx->target_addr = target_addr & 0x7f;
+  ctx->half_period = half_period > 1 ? half_period : 2;
+  ctx->scl_o = 1;
+  ctx->sda_o = 1;
+  ctx->prev_scl = 1;
+  ctx->prev_sda = 1;
+  ctx->tstate = TARGET_IDLE;
+  ctx->cstate = CTRL_IDLE;
+
+  ctx->sock = tcp_server_create(display_name, listen_port);
+
+  if (ctx->controller) {
+    printf(
+        "\n"
+        "I2C: Virtual I2C controller %s is listening on port %d.\n",
+        display_name, listen_port);
+  } else {
+    printf(
+        "\n"
+        "I2C: Virtual I2C target %s at address 0x%02x is listening on port "
+        "%d.\n",
+        display_name, ctx->target_addr, listen_port);
+  }
+
+  return (void *)ctx;
+}
+
+void i2cdpi_close(void *ctx_void) {
+  struct i2cdpi_ctx *ctx = (struct i2cdpi_ctx *)ctx_void;
+  if (!ctx) {
+    return;
+  }
+  tcp_server_close(ctx->sock);
+  free(ctx);
+}
+
+void i2cdpi_tick(void *ctx_void, const svBit scl, const svBit sda,
+                 svBit *scl_o, svBit *sda_o) {
+  struct i2cdpi_ctx *ctx = (struct i2cdpi_ctx *)ctx_void;
+  if (!ctx) {
+    return;
+  }
+
+  if (ctx->cstate == CTRL_IDLE) {
+    poll_cmd(ctx);
+  }
+  if (ctx->controller) {
+    ctrl_tick(ctx, scl, sda);
+  } else {
+    target_tick(ctx, scl, sda);
+  }
+  ctx->prev_scl = scl;
+  ctx->prev_sda = sda;
+
+  *scl_o = ctx->scl_o;
+  *sda_o = ctx->sda_o;
+}
@@ -0,0 +1,57 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef OPENTITAN_HW_DV_DPI_I2CDPI_I2CDPI_H_
+#define OPENTITAN_HW_DV_DPI_I2CDPI_I2CDPI_H_
+
+#include <svdpi.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Constructor: Create and initialize an I2C DPI context
+ *
+ * The context listens on a TCP socket for commands from the host, see
+ * README.md for the protocol.
+ *
+ * @param display_name Name of the I2C interface (for display only)
+ * @param listen_port Port to listen on
+ * @param controller Non-zero to act as a controller, zero to act as a target
+ * @param target_addr 7-bit address the target responds to
+ * @param half_period Half of the SCL period the controller generates, in
+ *        clock cycles
+ * @return an initialized I2C DPI context, or NULL on error
+ */
+void *i2cdpi_create(const char *display_name, int listen_port, int controller,
+                    int target_addr, int half_period);
+
+/**
+ * Destructor: Close all connections and free all resources
+ *
+ * @param ctx_void an I2C DPI context
+ */
+void i2cdpi_close(void *ctx_void);
+
+/**
+ * Update the bus from the model, once per clock cycle
+ *
+ * The bus is open drain: the model can only pull the lines low, and the caller
+ * is expected to combine its outputs with those of the other bus agents and a
+ * pull-up.
+ *
+ * @param ctx_void an I2C DPI context
+ * @param scl current level of the SCL line
+ * @param sda current level of the SDA line
+ * @param scl_o level the model drives SCL to (1 to release the line)
+ * @param sda_o level the model drives SDA to (1 to release the line)
+ */
+void i2cdpi_tick(void *ctx_void, const svBit scl, const svBit sda,
+                 svBit *scl_o, svBit *sda_o);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+#endif  // OPENTITAN_HW_DV_DPI_I2CDPI_I2CDPI_H_
@@ -0,0 +1,81 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+// I2C bus agent, controlled over TCP. See README.md for the protocol.
+//
+// The bus is open drain: `scl_o` and `sda_o` are the levels this model drives (1 when it releases
+// the line), which the instantiating testbench combines with the other agents and a pull-up into
+// the bus levels `scl_i` and `sda_i`.
+module i2cdpi #(
+  parameter string Name = "i2c0",   // name of the I2C interface (display only)
+  parameter int ListenPort = 44860, // TCP port to listen on
+  parameter bit Controller = 1'b0,  // act as a controller rather than a target
+  parameter int TargetAddr = 'h50,  // 7-bit address of the target
+  parameter int HalfPeriod = 50     // half of the controller's SCL period in clock cycles
+)(
+  input  logic clk_i,
+  input  logic rst_ni,
+  input  bit   active,
+
+  input  logic scl_i,
+  input  logic sda_i,
+  output logic scl_o,
+  output logic sda_o
+);
+
+  import "DPI-C"
+  function chandle i2cdpi_create(input string name, input int listen_port,
+                                 input int controller, input int target_addr,
+                                 input int half_period);
+
+  import "DPI-C"
+  function void i2cdpi_tick(input chandle ctx, input bit scl, input bit sda,
+                            output bit scl_o, output bit sda_o);
+
+  import "DPI-C"
+  function void i2cdpi_close(input chandle ctx);
+
+  chandle ctx;
+
+  function automatic void initialize();
+    int port, controller, target_addr, half_period;
+
+    assert (ctx == null);
+
+    // All settings can be customized at runtime
+    port = ListenPort;
+    void'($value$plusargs("i2cdpi_port=%0d", port));
+    controller = Controller;
+    void'($value$plusargs("i2cdpi_controller=%0d", controller));
+    target_addr = TargetAddr;
+    void'($value$plusargs("i2cdpi_target_addr=%0h", target_addr));
+    half_period = HalfPeriod;
+    void'($value$plusargs("i2cdpi_half_period=%0d", half_period));
+
+    ctx = i2cdpi_create(Name, port, controller, target_addr, half_period);
+  endfunction
+
+  initial begin
+    if (active) initialize();
+  end
+
+  always @(posedge active) begin
+    if (ctx == null) initialize();
+  end
+
+  final begin
+    i2cdpi_close(ctx);
+    ctx = null;
+  end
+
+  always_ff @(posedge clk_i, negedge rst_ni) begin
+    if (!rst_ni) begin
+      scl_o <= 1'b1;
+      sda_o <= 1'b1;
+    end else if (active) begin
+      i2cdpi_tick(ctx, scl_i, sda_i, scl_o, sda_o);
+    end
+  end
+
+endmodule
@@ -10,8 +10,15 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "dpi_profile.h"
 #include "tcp_server.h"
 
+// Sizes of the command and response buffers. OpenOCD sends commands in bursts
+// (a long scan is a few bytes per bit), which we fetch from the server in
+// blocks of up to CMD_BUF_SIZE bytes.
+#define CMD_BUF_SIZE 256
+#define TDO_BUF_SIZE 256
+
 struct jtagdpi_ctx {
   // Server context
   struct tcp_server_ctx *sock;
@@ -22,35 +29,61 @@ struct jtagdpi_ctx {
   uint8_t tdo;
   uint8_t trst_n;
   uint8_t srst_n;
-  // Lookahead buffer - non-zero if valid
-  char cmd;
+  // Commands received from the client but not yet processed
+  char cmd_buf[CMD_BUF_SIZE];
+  size_t cmd_pos;
+  size_t cmd_len;
+  // TDO responses that haven't been sent to the client yet
+  char tdo_buf[TDO_BUF_SIZE];
+  size_t tdo_len;
 };
 
-static bool lookahead(struct jtagdpi_ctx *ctx) {
-  // Look at the next command if available. Return true if it's an
-  // 'R', otherwise buffer it to return via get_cmd().
-  char cmd;
-  if (!tcp_server_read(ctx->sock, &cmd)) {
-    return false;
+/**
+ * Look at the next command without consuming it
+ *
+ * If no command is buffered, this fetches the next block of commands from the
+ * server.
+ *
+ * @return true if a command was available
+ */
+static bool peek_cmd(struct jtagdpi_ctx *ctx, char *cmd) {
+  if (ctx->cmd_pos == ctx->cmd_len) {
+    ctx->cmd_pos = 0;
+    ctx->cmd_len = tcp_server_read_buf(ctx->sock, ctx->cmd_buf, CMD_BUF_SIZE);
+    if (ctx->cmd_len == 0) {
+      return false;
+    }
   }
-  if (cmd == 'R') {
-    return true;
-  } else {
-    ctx->cmd = cmd;
+  *cmd = ctx->cmd_buf[ctx->cmd_pos];
+  return true;
+}
+
+static bool get_cmd(struct jtagdpi_ctx *ctx, char *cmd) {
+  if (!peek_cmd(ctx, cmd)) {
     return false;
   }
+  ++ctx->cmd_pos;
+  return true;
 }
 
-static bool get_cmd(struct jtagdpi_ctx *ctx, char *cmd) {
-  // Return a buffered command if available, or try to pull one from
-  // the socket.
-  if (ctx->cmd) {
-    *cmd = ctx->cmd;
-    ctx->cmd = 0;
-    return true;
-  } else {
-    return tcp_server_read(ctx->sock, cmd);
+/**
+ * Send all queued TDO responses to the client
+ */
+static void flush_tdo(struct jtagdpi_ctx *ctx) {
+  if (ctx->tdo_len) {
+    tcp_server_write_buf(ctx->sock, ctx->tdo_buf, ctx->tdo_len);
+    ctx->tdo_len = 0;
+  }
+}
+
+/**
+ * Queue the current TDO value as a response to an 'R' command
+ */
+static void queue_tdo(struct jtagdpi_ctx *ctx) {
+  if (ctx->tdo_len == TDO_BUF_SIZE) {
+    flush_tdo(ctx);
   }
+  ctx->tdo_buf[ctx->tdo_len++] = ctx->tdo + '0';
 }
 
 /**
@@ -83,61 +116,61 @@ static void update_jtag_signals(struct jtagdpi_ctx *ctx) {
    * https://repo.or.cz/openocd.git/blob/HEAD:/doc/manual/jtag/drivers/remote_bitbang.txt
    */
 
-  // read a command byte
+  // Process commands until one changes the JTAG signals (which takes effect
+  // for this tick) or there are no more. Reads and blink commands don't
+  // change the signals, so any number of them can be handled in one tick.
   char cmd;
-  if (!get_cmd(ctx, &cmd)) {
-    return;
-  }
-
-  bool act_send_resp = false;
-  bool act_quit = false;
-
-  // parse received command byte
-  if (cmd >= '0' && cmd <= '7') {
-    // JTAG write
-    uint8_t tck = ctx->tck;
-    char cmd_bit = cmd - '0';
-    ctx->tdi = (cmd_bit >> 0) & 0x1;
-    ctx->tms = (cmd_bit >> 1) & 0x1;
-    ctx->tck = (cmd_bit >> 2) & 0x1;
-    // On a rising edge of TCK, we can process a following 'R' command
-    // to sense the current TDO without waiting for the next DPI
-    // callback. Since TDO changes on the falling edge of TCK, it is
-    // already stable and valid.
-    if (!tck && ctx->tck && lookahead(ctx)) {
-      act_send_resp = true;
+  while (get_cmd(ctx, &cmd)) {
+    if (cmd == 'R') {
+      // JTAG read
+      queue_tdo(ctx);
+    } else if (cmd == 'B') {
+      // printf("BLINK ON!\n");
+    } else if (cmd == 'b') {
+      // printf("BLINK OFF!\n");
+    } else if (cmd >= '0' && cmd <= '7') {
+      // JTAG write
+      uint8_t tck = ctx->tck;
+      char cmd_bit = cmd - '0';
+      ctx->tdi = (cmd_bit >> 0) & 0x1;
+      ctx->tms = (cmd_bit >> 1) & 0x1;
+      ctx->tck = (cmd_bit >> 2) & 0x1;
+      // On a rising edge of TCK, we can process a following 'R' command
+      // to sense the current TDO without waiting for the next DPI
+      // callback. Since TDO changes on the falling edge of TCK, it is
+      // already stable and valid.
+      char next;
+      if (!tck && ctx->tck && peek_cmd(ctx, &next) && next == 'R') {
+        ++ctx->cmd_pos;
+        queue_tdo(ctx);
+      }
+      break;
+    } else if (cmd >= 'r' && cmd <= 'u') {
+      // JTAG reset (active high from OpenOCD)
+      char cmd_bit = cmd - 'r';
+      ctx->srst_n = !((cmd_bit >> 0) & 0x1);
+      ctx->trst_n = !((cmd_bit >> 1) & 0x1);
+      break;
+    } else if (cmd == 'Q') {
+      // quit (client disconnect)
+      flush_tdo(ctx);
+      printf("JTAG DPI: Remote disconnected.\n");
+      tcp_server_client_close(ctx->sock);
+      // Anything after the quit came from a client that has gone away
+      ctx->cmd_pos = ctx->cmd_len;
+      break;
+    } else {
+      fprintf(stderr,
+              "JTAG DPI Protocol violation detected: unsupported command %c\n",
+              cmd);
+      exit(1);
     }
-  } else if (cmd >= 'r' && cmd <= 'u') {
-    // JTAG reset (active high from OpenOCD)
-    char cmd_bit = cmd - 'r';
-    ctx->srst_n = !((cmd_bit >> 0) & 0x1);
-    ctx->trst_n = !((cmd_bit >> 1) & 0x1);
-  } else if (cmd == 'R') {
-    // JTAG read
-    act_send_resp = true;
-  } else if (cmd == 'B') {
-    // printf("BLINK ON!\n");
-  } else if (cmd == 'b') {
-    // printf("BLINK OFF!\n");
-  } else if (cmd == 'Q') {
-    // quit (client disconnect)
-    act_quit = true;
-  } else {
-    fprintf(stderr,
-            "JTAG DPI Protocol violation detected: unsupported command %c\n",
-            cmd);
-    exit(1);
   }
 
-  // send tdo as response
-  if (act_send_resp) {
-    char tdo_ascii = ctx->tdo + '0';
-    tcp_server_write(ctx->sock, tdo_ascii);
-  }
-
-  if (act_quit) {
-    printf("JTAG DPI: Remote disconnected.\n");
-    tcp_server_client_close(ctx->sock);
+  // Once we've worked through the commands we've been sent, the client may be
+  // waiting for the responses: send all of them together.
+  if (ctx->cmd_pos == ctx->cmd_len) {
+    flush_tdo(ctx);
   }
 }
 
@@ -173,6 +206,9 @@ void jtagdpi_close(void *ctx_void) {
   free(ctx);
 }
 
+static struct dpi_profile_counter tick_prof =
+    DPI_PROFILE_COUNTER_INIT("jtagdpi.tick");
+
 void jtagdpi_tick(void *ctx_void, svBit *tck, svBit *tms, svBit *tdi,
                   svBit *trst_n, svBit *srst_n, const svBit tdo) {
   struct jtagdpi_ctx *ctx = (struct jtagdpi_ctx *)ctx_void;
@@ -180,6 +216,7 @@ void jtagdpi_tick(void *ctx_void, svBit *tck, svBit *tms, svBit *tdi,
     return;
   }
 
+  uint64_t prof_start = dpi_profile_begin();
   ctx->tdo = tdo;
   update_jtag_signals(ctx);
   *tdi = ctx->tdi;
@@ -187,4 +224,5 @@ void jtagdpi_tick(void *ctx_void, svBit *tck, svBit *tms, svBit *tdi,
   *tck = ctx->tck;
   *srst_n = ctx->srst_n;
   *trst_n = ctx->trst_n;
+  dpi_profile_end(&tick_prof, prof_start);
 }
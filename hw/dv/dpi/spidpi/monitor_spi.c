@@ -6,7 +6,9 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
+#include "dpi_binlog.h"
 #include "spidpi.h"
 
 #define MON_BUFLEN 65
@@ -19,6 +21,11 @@ struct mon_ctx {
   uint32_t prev_d2p;
   int bpos;
   int poff;
+  // Binary log for transactions (NULL to log text)
+  struct dpi_binlog *binlog;
+  int start_tick;
+  // SPIDPI_BINLOG_FLAG_* bits for the current transaction
+  uint8_t flags;
 
   unsigned char mobuf[MON_BUFLEN];
   unsigned char sobuf[MON_BUFLEN];
@@ -41,6 +48,12 @@ void *monitor_spi_init(int mode) {
   return (void *)mon;
 }
 
+void monitor_spi_set_binlog(void *mon_void, struct dpi_binlog *binlog) {
+  struct mon_ctx *mon = (struct mon_ctx *)mon_void;
+  assert(mon);
+  mon->binlog = binlog;
+}
+
 /*
  * Simple drawing of a waveform vertically (line by line)
  *
@@ -127,6 +140,15 @@ static void log_packet(struct mon_ctx *mon, FILE *mon_file) {
   fprintf(mon_file, "\n");
 }
 
+static void log_packet_binary(struct mon_ctx *mon, int tick) {
+  unsigned char payload[2 * MON_BUFLEN];
+  memcpy(payload, mon->mobuf, mon->poff);
+  memcpy(payload + mon->poff, mon->sobuf, mon->poff);
+  dpi_binlog_write(mon->binlog, tick, SPIDPI_BINLOG_XFER, mon->flags,
+                   mon->poff, mon->start_tick, payload, 2 * mon->poff);
+}
+
+// mon_file is NULL when logging to the binary log
 static void capture_bit(struct mon_ctx *mon, FILE *mon_file, int p2d, int d2p) {
   if (((mon->cpol == mon->cpha) && (p2d & P2D_SCK)) ||
       ((mon->cpol != mon->cpha) && !(p2d & P2D_SCK))) {
@@ -134,10 +156,16 @@ static void capture_bit(struct mon_ctx *mon, FILE *mon_file, int p2d, int d2p) {
     uint32_t new_sobit = (d2p & D2P_SDO) ? mon->bpos : 0;
     // check for setup time
     if ((p2d & P2D_SDI) != (mon->prev_p2d & P2D_SDI)) {
-      fprintf(mon_file, "Check SDI tSU ");
+      if (mon_file) {
+        fprintf(mon_file, "Check SDI tSU ");
+      }
+      mon->flags |= SPIDPI_BINLOG_FLAG_SDI_TSU;
     }
     if ((d2p & D2P_SDO) != (mon->prev_d2p & D2P_SDO)) {
-      fprintf(mon_file, "Check SDO tSU ");
+      if (mon_file) {
+        fprintf(mon_file, "Check SDO tSU ");
+      }
+      mon->flags |= SPIDPI_BINLOG_FLAG_SDO_TSU;
     }
     mon->mobuf[mon->poff] |= new_mobit;
     mon->sobuf[mon->poff] |= new_sobit;
@@ -157,7 +185,8 @@ static void capture_bit(struct mon_ctx *mon, FILE *mon_file, int p2d, int d2p) {
  * SPI device monitor
  *
  * @param mon_void - monitor context structure
- * @param mon_file - FILE * for output to be written
+ * @param mon_file - FILE * for output to be written (unused if a binary log
+ *                   has been set with monitor_spi_set_binlog())
  * @param loglevel - details to log
  * @param tick - simulation time
  * @param p2d - bits of signals from pins to device
@@ -168,8 +197,10 @@ void monitor_spi(void *mon_void, FILE *mon_file, int loglevel, int tick,
                  int p2d, int d2p) {
   struct mon_ctx *mon = (struct mon_ctx *)mon_void;
   assert(mon);
-  int logbits = (loglevel & 0x1);
-  int logpkts = (loglevel & 0x8);
+  // The binary log only records whole transactions
+  int binary = (mon->binlog != NULL);
+  int logbits = binary ? 0 : (loglevel & 0x1);
+  int logpkts = binary || (loglevel & 0x8);
 
   if ((tick == 1) && logbits) {
     fprintf(mon_file, "              CSB SCK MO  MI\n");
@@ -190,7 +221,11 @@ void monitor_spi(void *mon_void, FILE *mon_file, int loglevel, int tick,
   }
   if ((p2d & P2D_CSB) && !(mon->prev_p2d & P2D_CSB)) {
     // end of packet
-    log_packet(mon, mon_file);
+    if (binary) {
+      log_packet_binary(mon, tick);
+    } else {
+      log_packet(mon, mon_file);
+    }
     mon->poff = 0;
   } else {
     if (!(p2d & P2D_CSB) && (mon->prev_p2d & P2D_CSB)) {
@@ -200,11 +235,13 @@ void monitor_spi(void *mon_void, FILE *mon_file, int loglevel, int tick,
       mon->mobuf[0] = 0;
       mon->sobuf[0] = 0;
       mon->bpos = (mon->msbfirst) ? 0x80 : 0x1;
+      mon->start_tick = tick;
+      mon->flags = 0;
     } else if (!(p2d & P2D_CSB) && !(mon->prev_p2d & P2D_CSB)) {
       // inside packet
       if ((p2d & P2D_SCK) != (mon->prev_p2d & P2D_SCK)) {
         // found a clock edge, check if it is one to capture on
-        capture_bit(mon, mon_file, p2d, d2p);
+        capture_bit(mon, binary ? NULL : mon_file, p2d, d2p);
       }
     }
     if (logbits) {
@@ -26,8 +26,17 @@
 #include "verilator_sim_ctrl.h"
 #endif
 
-// This holds the necessary SPI state.
+// Length of a transaction in interactive mode
 #define MAX_TRANSACTION 4
+// Longest transaction in framed mode, and sizes of the buffers for frames
+// from the host and responses to it
+#define MAX_FRAMED_TRANSACTION 1024
+#define IN_BUF_SIZE 4096
+#define OUT_BUF_SIZE 4096
+// Ticks to wait after a read from the host that returned nothing
+#define IDLE_READ_TICKS 256
+
+// This holds the necessary SPI state.
 struct spidpi_ctx {
   int loglevel;
   char ptyname[64];
@@ -36,6 +45,7 @@ struct spidpi_ctx {
   FILE *mon_file;
   char mon_pathname[PATH_MAX];
   void *mon;
+  struct dpi_binlog *binlog;
   int tick;
   int cpol;
   int cpha;
@@ -48,7 +58,27 @@ struct spidpi_ctx {
   int nmax;
   char driving;
   int state;
-  char buf[MAX_TRANSACTION];
+  char buf[MAX_FRAMED_TRANSACTION];
+
+  // Framed mode: frames are read from in_fd (the pty or a script file) and
+  // responses written to out_fd. See spidpi.h for the frame format.
+  int framed;
+  int in_fd;
+  int out_fd;
+  int in_eof;
+  int idle_ticks;
+  char in_buf[IN_BUF_SIZE];
+  int in_pos;
+  int in_len;
+  char out_buf[OUT_BUF_SIZE];
+  int out_len;
+  // Whether to send back the bytes read in the current transaction
+  int keep_rsp;
+  // Status poll in progress, and the last byte read
+  int polling;
+  unsigned char poll_mask;
+  unsigned char poll_value;
+  unsigned char last_din;
 };
 
 // SPI Host States
@@ -63,7 +93,187 @@ struct spidpi_ctx {
 // and resume at the first SPI packet
 // #define CONTROL_TRACE
 
-void *spidpi_create(const char *name, int mode, int loglevel) {
+/**
+ * Start a transaction of the first n bytes of ctx->buf
+ */
+static void start_transaction(struct spidpi_ctx *ctx, int n) {
+  ctx->nmax = n;
+  ctx->nout = 0;
+  ctx->nin = 0;
+  ctx->bout = ctx->msbfirst ? 0x80 : 0x01;
+  ctx->bin = ctx->msbfirst ? 0x80 : 0x01;
+  ctx->din = 0;
+  ctx->state = SP_CSFALL;
+#ifdef VERILATOR
+#ifdef CONTROL_TRACE
+  VerilatorSimCtrl::GetInstance().TraceOn();
+#endif
+#endif
+}
+
+/**
+ * Write as much of the response buffer to out_fd as possible
+ *
+ * @return true if the buffer is now empty
+ */
+static int flush_out(struct spidpi_ctx *ctx) {
+  int done = 0;
+  while (done < ctx->out_len) {
+    int rv = write(ctx->out_fd, ctx->out_buf + done, ctx->out_len - done);
+    if (rv < 0) {
+      if (errno != EAGAIN && errno != EINTR) {
+        fprintf(stderr, "SPI: write() failed: %s\n", strerror(errno));
+        done = ctx->out_len;
+      }
+      if (errno != EINTR) {
+        break;
+      }
+    } else {
+      done += rv;
+    }
+  }
+  memmove(ctx->out_buf, ctx->out_buf + done, ctx->out_len - done);
+  ctx->out_len -= done;
+  return ctx->out_len == 0;
+}
+
+/**
+ * Queue a byte to be sent back to the host
+ */
+static void queue_out(struct spidpi_ctx *ctx, char c) {
+  if (ctx->out_len == OUT_BUF_SIZE && !flush_out(ctx)) {
+    fprintf(stderr, "SPI: Response buffer overflow; dropping data\n");
+    return;
+  }
+  ctx->out_buf[ctx->out_len++] = c;
+}
+
+/**
+ * Read more data from the host into ctx->in_buf
+ *
+ * Reads are skipped for IDLE_READ_TICKS ticks after one that returned
+ * nothing, so an idle host doesn't cost a syscall every clock cycle.
+ */
+static void fill_in(struct spidpi_ctx *ctx) {
+  if (ctx->in_eof) {
+    return;
+  }
+  if (ctx->idle_ticks > 0) {
+    --ctx->idle_ticks;
+    return;
+  }
+  if (ctx->in_pos > 0) {
+    memmove(ctx->in_buf, ctx->in_buf + ctx->in_pos, ctx->in_len - ctx->in_pos);
+    ctx->in_len -= ctx->in_pos;
+    ctx->in_pos = 0;
+  }
+  int n = read(ctx->in_fd, ctx->in_buf + ctx->in_len,
+               IN_BUF_SIZE - ctx->in_len);
+  if (n > 0) {
+    ctx->in_len += n;
+    return;
+  }
+  if (n == 0 && ctx->in_fd != ctx->host) {
+    // End of a script file
+    ctx->in_eof = 1;
+  } else if (n == -1 && errno != EAGAIN) {
+    fprintf(stderr, "Read on SPI FIFO gave %s\n", strerror(errno));
+  }
+  ctx->idle_ticks = IDLE_READ_TICKS;
+}
+
+/**
+ * Start the transaction for the next complete frame in ctx->in_buf
+ *
+ * @return true if a transaction was started
+ */
+static int start_frame(struct spidpi_ctx *ctx) {
+  const unsigned char *frame =
+      (const unsigned char *)ctx->in_buf + ctx->in_pos;
+  int avail = ctx->in_len - ctx->in_pos;
+  if (avail < 1) {
+    return 0;
+  }
+
+  switch (frame[0]) {
+    case SPIDPI_FRAME_XFER:
+    case SPIDPI_FRAME_WRITE: {
+      if (avail < 3) {
+        return 0;
+      }
+      int n = frame[1] | (frame[2] << 8);
+      if (n == 0 || n > MAX_FRAMED_TRANSACTION) {
+        fprintf(stderr, "SPI: Invalid transaction length %d in frame\n", n);
+        exit(1);
+      }
+      if (avail < 3 + n) {
+        return 0;
+      }
+      ctx->keep_rsp = frame[0] == SPIDPI_FRAME_XFER;
+      // Make sure there will be space for the response
+      if (ctx->keep_rsp && ctx->out_len + n > OUT_BUF_SIZE &&
+          !flush_out(ctx)) {
+        return 0;
+      }
+      memcpy(ctx->buf, frame + 3, n);
+      ctx->in_pos += 3 + n;
+      start_transaction(ctx, n);
+      return 1;
+    }
+    case SPIDPI_FRAME_POLL:
+      if (avail < 4) {
+        return 0;
+      }
+      ctx->buf[0] = frame[1];
+      ctx->buf[1] = 0;
+      ctx->poll_mask = frame[2];
+      ctx->poll_value = frame[3];
+      ctx->polling = 1;
+      ctx->keep_rsp = 0;
+      ctx->in_pos += 4;
+      start_transaction(ctx, 2);
+      return 1;
+    default:
+      fprintf(stderr, "SPI: Protocol violation: unknown frame type 0x%02x\n",
+              frame[0]);
+      exit(1);
+  }
+}
+
+/**
+ * Choose what to do next in framed mode, once the bus is idle
+ */
+static void framed_idle(struct spidpi_ctx *ctx) {
+  if (ctx->polling) {
+    if ((ctx->last_din & ctx->poll_mask) == ctx->poll_value) {
+      // The poll is complete: report the final status
+      ctx->polling = 0;
+      queue_out(ctx, ctx->last_din);
+    } else {
+      // Read the status register again
+      start_transaction(ctx, 2);
+      return;
+    }
+  }
+
+  if (start_frame(ctx)) {
+    return;
+  }
+  fill_in(ctx);
+  if (start_frame(ctx)) {
+    return;
+  }
+
+  // We've run out of work: the host may be waiting for our responses
+  flush_out(ctx);
+  if (ctx->in_eof == 1 && ctx->out_len == 0) {
+    printf("SPI: Finished running script\n");
+    ctx->in_eof = 2;
+  }
+}
+
+void *spidpi_create(const char *name, int mode, int loglevel,
+                    const char *script, int framed) {
   int i;
   struct spidpi_ctx *ctx =
       (struct spidpi_ctx *)calloc(1, sizeof(struct spidpi_ctx));
@@ -106,12 +316,41 @@ void *spidpi_create(const char *name, int mode, int loglevel) {
   int new_flags = fcntl(ctx->host, F_SETFL, cur_flags | O_NONBLOCK);
   assert(new_flags != -1 && "Unable to set FD flags");
 
-  printf(
-      "\n"
-      "SPI: Created %s for %s. Connect to it with any terminal program, e.g.\n"
-      "$ screen %s\n"
-      "NOTE: a SPI transaction is run for every 4 characters entered.\n",
-      ctx->ptyname, name, ctx->ptyname);
+  ctx->in_fd = ctx->host;
+  ctx->out_fd = ctx->host;
+  if (script != NULL && script[0] != '\0') {
+    char out_pathname[PATH_MAX];
+    rv = snprintf(out_pathname, PATH_MAX, "%s/%s-script.out", cwd, name);
+    assert(rv <= PATH_MAX && rv > 0);
+
+    ctx->in_fd = open(script, O_RDONLY);
+    ctx->out_fd = open(out_pathname, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (ctx->in_fd < 0 || ctx->out_fd < 0) {
+      fprintf(stderr, "SPI: Unable to open script %s or output %s: %s\n",
+              script, out_pathname, strerror(errno));
+      return NULL;
+    }
+    ctx->framed = 1;
+    printf(
+        "\n"
+        "SPI: Running SPI frames from %s for %s. Responses are written to\n"
+        "%s\n",
+        script, name, out_pathname);
+  } else if (framed) {
+    ctx->framed = 1;
+    printf(
+        "\n"
+        "SPI: Created %s for %s, taking SPI frames (see spidpi.h).\n",
+        ctx->ptyname, name);
+  } else {
+    printf(
+        "\n"
+        "SPI: Created %s for %s. Connect to it with any terminal program, "
+        "e.g.\n"
+        "$ screen %s\n"
+        "NOTE: a SPI transaction is run for every 4 characters entered.\n",
+        ctx->ptyname, name, ctx->ptyname);
+  }
 
   rv = snprintf(ctx->mon_pathname, PATH_MAX, "%s/%s.log", cwd, name);
   assert(rv <= PATH_MAX && rv > 0);
@@ -128,6 +367,21 @@ void *spidpi_create(const char *name, int mode, int loglevel) {
       "$ tail -f %s\n",
       ctx->mon_pathname, ctx->mon_pathname);
 
+  if (loglevel & SPIDPI_LOG_BINARY) {
+    char bin_pathname[PATH_MAX];
+    rv = snprintf(bin_pathname, PATH_MAX, "%s/%s.bin", cwd, name);
+    assert(rv <= PATH_MAX && rv > 0);
+    ctx->binlog = dpi_binlog_open(bin_pathname, DPI_BINLOG_SOURCE_SPI);
+    if (ctx->binlog == NULL) {
+      return NULL;
+    }
+    monitor_spi_set_binlog(ctx->mon, ctx->binlog);
+    printf(
+        "SPI: Transactions are logged to %s. Decode with\n"
+        "$ hw/dv/dpi/common/dpi_binlog/decode_binlog.py %s\n",
+        bin_pathname, bin_pathname);
+  }
+
   return (void *)ctx;
 }
 
@@ -151,25 +405,21 @@ char spidpi_tick(void *ctx_void, const svLogicVecVal *d2p_data) {
               d2p);
 
   if (ctx->state == SP_IDLE) {
-    int n = read(ctx->host, &(ctx->buf[ctx->nin]), ctx->nmax - ctx->nin);
-    if (n == -1) {
-      if (errno != EAGAIN) {
-        fprintf(stderr, "Read on SPI FIFO gave %s\n", strerror(errno));
-      }
+    if (ctx->framed) {
+      framed_idle(ctx);
     } else {
-      ctx->nin += n;
-      if (ctx->nin == ctx->nmax) {
-        ctx->nout = 0;
-        ctx->nin = 0;
-        ctx->bout = ctx->msbfirst ? 0x80 : 0x01;
-        ctx->bin = ctx->msbfirst ? 0x80 : 0x01;
-        ctx->din = 0;
-        ctx->state = SP_CSFALL;
-#ifdef VERILATOR
-#ifdef CONTROL_TRACE
-        VerilatorSimCtrl::GetInstance().TraceOn();
-#endif
-#endif
+      int n =
+          read(ctx->host, &(ctx->buf[ctx->nin]), MAX_TRANSACTION - ctx->nin);
+      if (n == -1) {
+        if (errno != EAGAIN) {
+          fprintf(stderr, "Read on SPI FIFO gave %s\n", strerror(errno));
+        }
+      } else {
+        ctx->nin += n;
+        if (ctx->nin == MAX_TRANSACTION) {
+          ctx->keep_rsp = 1;
+          start_transaction(ctx, MAX_TRANSACTION);
+        }
       }
     }
   }
@@ -218,8 +468,10 @@ char spidpi_tick(void *ctx_void, const svLogicVecVal *d2p_data) {
         ctx->din = ctx->din | ((d2p & D2P_SDO) ? ctx->bin : 0);
         ctx->bin = (ctx->msbfirst) ? ctx->bin >> 1 : ctx->bin << 1;
         if (ctx->bin == 0) {
-          int rv = write(ctx->host, &(ctx->din), 1);
-          assert(rv == 1 && "write() failed.");
+          ctx->last_din = ctx->din;
+          if (ctx->keep_rsp) {
+            queue_out(ctx, ctx->din);
+          }
           ctx->bin = (ctx->msbfirst) ? 0x80 : 0x01;
           ctx->din = 0;
         }
@@ -235,6 +487,9 @@ char spidpi_tick(void *ctx_void, const svLogicVecVal *d2p_data) {
         // CSB high, clock stopped
         ctx->driving = P2D_CSB;
         ctx->state = SP_IDLE;
+        if (!ctx->framed) {
+          flush_out(ctx);
+        }
         break;
       case SP_FINISH:
 #ifdef VERILATOR
@@ -254,6 +509,12 @@ void spidpi_close(void *ctx_void) {
   if (!ctx) {
     return;
   }
+  flush_out(ctx);
+  if (ctx->in_fd != ctx->host) {
+    close(ctx->in_fd);
+    close(ctx->out_fd);
+  }
   fclose(ctx->mon_file);
+  dpi_binlog_close(ctx->binlog);
   free(ctx);
 }
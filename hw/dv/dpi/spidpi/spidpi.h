@@ -7,6 +7,8 @@
 
 #include <svdpi.h>
 
+#include "dpi_binlog.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -20,7 +22,54 @@ extern "C" {
 #define P2D_CSB 0x2
 #define P2D_SDI 0x4
 
-void *spidpi_create(const char *name, int mode, int loglevel);
+// Frame types for framed mode
+//
+// In framed mode, the host sends a stream of frames, each of which is run as
+// a SPI transaction with CSB held low throughout. Transactions run back to
+// back, and responses are sent back in batches once there are no more complete
+// frames to run. All multi-byte fields are little-endian.
+//
+// SPIDPI_FRAME_XFER:  type, 16-bit length n, n bytes to send. The response is
+//                     the n bytes read during the transaction.
+// SPIDPI_FRAME_WRITE: as SPIDPI_FRAME_XFER, but there is no response (for
+//                     commands like page program, where only the bytes sent
+//                     matter).
+// SPIDPI_FRAME_POLL:  type, opcode, mask, value. Repeats the two-byte
+//                     transaction {opcode, 0} until the second byte read
+//                     (a status register, for example) satisfies
+//                     (status & mask) == value. The response is the final
+//                     status byte.
+#define SPIDPI_FRAME_XFER 0x01
+#define SPIDPI_FRAME_WRITE 0x02
+#define SPIDPI_FRAME_POLL 0x03
+
+// Bit in loglevel that sends the monitor's output to a binary log,
+// <name>.bin (see dpi_binlog.h), instead of the text log. Each SPI
+// transaction is a SPIDPI_BINLOG_XFER record:
+//
+// time:    tick at which CSB was deasserted
+// aux:     tick at which CSB was asserted
+// header:  number of bytes n transferred
+// flags:   SPIDPI_BINLOG_FLAG_* setup time warnings
+// payload: the n bytes sent to the device, then the n bytes received
+#define SPIDPI_LOG_BINARY 0x10
+#define SPIDPI_BINLOG_XFER 1
+#define SPIDPI_BINLOG_FLAG_SDI_TSU 0x01
+#define SPIDPI_BINLOG_FLAG_SDO_TSU 0x02
+
+/**
+ * Create a SPI host
+ *
+ * @param name a name for the host, used for the monitor log and output files
+ * @param mode the SPI mode (CPOL << 1 | CPHA)
+ * @param loglevel what the monitor logs (see spidpi.sv)
+ * @param script if not empty, a file of frames to run. Responses are written
+ *        to <name>-script.out in the current directory.
+ * @param framed if true (and there is no script), the pty takes frames instead
+ *        of running a 4-byte transaction for every 4 characters.
+ */
+void *spidpi_create(const char *name, int mode, int loglevel,
+                    const char *script, int framed);
 char spidpi_tick(void *ctx_void, const svLogicVecVal *d2p_data);
 void spidpi_close(void *ctx_void);
 
@@ -28,6 +77,8 @@ void spidpi_close(void *ctx_void);
 void monitor_spi(void *mon_void, FILE *mon_file, int loglevel, int tick,
                  int p2d, int d2p);
 void *monitor_spi_init(int mode);
+// Log transactions to binlog instead of text
+void monitor_spi_set_binlog(void *mon_void, struct dpi_binlog *binlog);
 
 #ifdef __cplusplus
 }  // extern "C"
@@ -7,6 +7,12 @@
 // Bits in LOG_LEVEL sets what is output on info socket
 // 0x01 -- monitor packets
 // 0x08 -- bit level
+// 0x10 -- binary transaction log in <NAME>.bin instead of text (see spidpi.h)
+//
+// Plusargs:
+// +spidpi_framed        -- the pty takes SPI frames (see spidpi.h)
+// +spidpi_script=<file> -- run the SPI frames in <file>
+// +spidpi_binlog        -- add 0x10 to LOG_LEVEL
 
 module spidpi
   #(
@@ -24,7 +30,8 @@ module spidpi
 
 );
   import "DPI-C" function
-    chandle spidpi_create(input string name, input int mode, input int loglevel);
+    chandle spidpi_create(input string name, input int mode, input int loglevel,
+                          input string script, input int framed);
 
   import "DPI-C" function
     void spidpi_close(input chandle ctx);
@@ -35,7 +42,15 @@ module spidpi
   chandle ctx;
 
   initial begin
-    ctx = spidpi_create(NAME, MODE, LOG_LEVEL);
+    string script = "";
+    int framed;
+    int loglevel = LOG_LEVEL;
+    void'($value$plusargs("spidpi_script=%s", script));
+    framed = $test$plusargs("spidpi_framed");
+    if ($test$plusargs("spidpi_binlog")) begin
+      loglevel |= 'h10;
+    end
+    ctx = spidpi_create(NAME, MODE, loglevel, script, framed);
   end
 
   final begin
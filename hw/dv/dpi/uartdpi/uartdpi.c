@@ -19,18 +19,66 @@
 #include <string.h>
 #include <unistd.h>
 
+#include "dpi_profile.h"
+
+// Size of the buffers for data to and from the pseudo-terminal
+#define BUF_SIZE 256
+
+// While there is no input, only poll the pseudo-terminal every
+// TICKS_PER_READ calls of uartdpi_can_read().
+#define TICKS_PER_READ 1024
+
+// Output is written out on a newline, when the buffer fills up, or
+// TICKS_PER_FLUSH calls of uartdpi_can_read() after the oldest buffered
+// character was written.
+#define TICKS_PER_FLUSH 4096
+
 // This keeps the necessary uart state.
 struct uartdpi_ctx {
   char ptyname[64];
   int host;
   int device;
-  char tmp_read;
   FILE *log_file;
+  // Input read from the pseudo-terminal but not yet passed to the simulation
+  char rx_buf[BUF_SIZE];
+  size_t rx_pos;
+  size_t rx_len;
+  unsigned int rx_ticks;
+  // Output from the simulation not yet written out
+  char tx_buf[BUF_SIZE];
+  size_t tx_len;
+  unsigned int tx_ticks;
 };
 
+/**
+ * Write all buffered output to the pseudo-terminal and the log file
+ */
+static void flush_tx(struct uartdpi_ctx *ctx) {
+  if (!ctx->tx_len) {
+    return;
+  }
+
+  // The pseudo-terminal is non-blocking. If nobody is reading from it and its
+  // buffer is full, the output is dropped (as it would be on a real UART).
+  ssize_t rv = write(ctx->host, ctx->tx_buf, ctx->tx_len);
+  assert((rv >= 0 || errno == EAGAIN || errno == EWOULDBLOCK) &&
+         "Write to pseudo-terminal failed.");
+  (void)rv;
+
+  if (ctx->log_file) {
+    size_t written = fwrite(ctx->tx_buf, sizeof(char), ctx->tx_len,
+                            ctx->log_file);
+    assert(written == ctx->tx_len && "Write to log file failed.");
+    (void)written;
+  }
+
+  ctx->tx_len = 0;
+  ctx->tx_ticks = 0;
+}
+
 void *uartdpi_create(const char *name, const char *log_file_path) {
   struct uartdpi_ctx *ctx =
-      (struct uartdpi_ctx *)malloc(sizeof(struct uartdpi_ctx));
+      (struct uartdpi_ctx *)calloc(1, sizeof(struct uartdpi_ctx));
   assert(ctx);
 
   int rv;
@@ -93,6 +141,8 @@ void uartdpi_close(void *ctx_void) {
     return;
   }
 
+  flush_tx(ctx);
+
   close(ctx->host);
   close(ctx->device);
 
@@ -108,33 +158,67 @@ void uartdpi_close(void *ctx_void) {
   free(ctx);
 }
 
+static struct dpi_profile_counter can_read_prof =
+    DPI_PROFILE_COUNTER_INIT("uartdpi.can_read");
+static struct dpi_profile_counter write_prof =
+    DPI_PROFILE_COUNTER_INIT("uartdpi.write");
+
+static int can_read(struct uartdpi_ctx *ctx) {
+  // This is called on every idle cycle of the transmitter, so it doubles as
+  // the timer for flushing output.
+  if (ctx->tx_len && ++ctx->tx_ticks >= TICKS_PER_FLUSH) {
+    flush_tx(ctx);
+  }
+
+  if (ctx->rx_pos < ctx->rx_len) {
+    return 1;
+  }
+
+  // Nothing buffered: read whatever is waiting, but don't make a syscall on
+  // every tick while the input is idle.
+  if (ctx->rx_ticks++ % TICKS_PER_READ != 0) {
+    return 0;
+  }
+  ssize_t rv = read(ctx->host, ctx->rx_buf, BUF_SIZE);
+  if (rv <= 0) {
+    return 0;
+  }
+  ctx->rx_pos = 0;
+  ctx->rx_len = (size_t)rv;
+  // Keep polling straight away after this data, in case there's more.
+  ctx->rx_ticks = 0;
+  return 1;
+}
+
 int uartdpi_can_read(void *ctx_void) {
   struct uartdpi_ctx *ctx = (struct uartdpi_ctx *)ctx_void;
   if (ctx == NULL) {
     return 0;
   }
-  int rv = read(ctx->host, &ctx->tmp_read, 1);
-  return (rv == 1);
+
+  uint64_t prof_start = dpi_profile_begin();
+  int ret = can_read(ctx);
+  dpi_profile_end(&can_read_prof, prof_start);
+  return ret;
 }
 
 char uartdpi_read(void *ctx_void) {
   struct uartdpi_ctx *ctx = (struct uartdpi_ctx *)ctx_void;
 
-  return ctx->tmp_read;
+  assert(ctx->rx_pos < ctx->rx_len && "uartdpi_read without data.");
+  return ctx->rx_buf[ctx->rx_pos++];
 }
 
 void uartdpi_write(void *ctx_void, char c) {
-  int rv;
   struct uartdpi_ctx *ctx = (struct uartdpi_ctx *)ctx_void;
   if (ctx == NULL) {
     return;
   }
 
-  rv = write(ctx->host, &c, 1);
-  assert(rv == 1 && "Write to pseudo-terminal failed.");
-
-  if (ctx->log_file) {
-    rv = fwrite(&c, sizeof(char), 1, ctx->log_file);
-    assert(rv == 1 && "Write to log file failed.");
+  uint64_t prof_start = dpi_profile_begin();
+  ctx->tx_buf[ctx->tx_len++] = c;
+  if (c == '\n' || ctx->tx_len == BUF_SIZE) {
+    flush_tx(ctx);
   }
+  dpi_profile_end(&write_prof, prof_start);
 }
@@ -56,6 +56,13 @@ module uartdpi #(
     ctx = null;
   end
 
+  // Pass a character straight to the host side, as if it had been received on
+  // rx_i. Testbenches that see console output some other way (e.g. from writes
+  // to the UART's TX FIFO) can use this to skip bit-level serialization.
+  function automatic void write_char(byte c);
+    if (ctx != null) uartdpi_write(ctx, c);
+  endfunction
+
   // TX
   reg txactive;
   int  txcount;
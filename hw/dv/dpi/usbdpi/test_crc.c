@@ -4,15 +4,92 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <time.h>
 
 #define TESTING_CRC
 #include "usb_crc.c"
 
 unsigned char buf[1024];
 
+// The original bit-serial implementations, used as a reference for the
+// table-driven versions in usb_crc.c
+static uint32_t CRC5_bitwise(uint32_t dwInput, int iBitcnt) {
+  uint32_t crc5 = 0x1f;
+  uint32_t udata = dwInput;
+  while (iBitcnt--) {
+    crc5 = ((udata ^ crc5) & 0x01) ? (crc5 >> 1) ^ 0x14 : crc5 >> 1;
+    udata >>= 1;
+  }
+  return crc5 ^ 0x1f;
+}
+
+static uint32_t CRC16_bitwise(const uint8_t *data, int bytes) {
+  uint32_t crc16 = 0xffff;
+  for (int i = 0; i < bytes; i++) {
+    uint32_t udata = data[i];
+    for (int bit = 0; bit < 8; bit++) {
+      crc16 = ((udata ^ crc16) & 0x01) ? (crc16 >> 1) ^ 0xA001 : crc16 >> 1;
+      udata >>= 1;
+    }
+  }
+  return crc16 ^ 0xffff;
+}
+
+static double now_secs(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Check the table-driven CRCs against the bit-serial ones, then compare their
+// throughput on maximum-sized (1023 byte) data fields.
+static int check_and_bench(void) {
+  int errors = 0;
+  for (uint32_t val = 0; val < (1u << 11); val++) {
+    if (CRC5(val, 11) != CRC5_bitwise(val, 11)) {
+      printf("CRC5 mismatch for 0x%x\n", val);
+      errors++;
+    }
+  }
+  srand(1);
+  for (int len = 0; len <= 1023; len++) {
+    for (int i = 0; i < len; i++) {
+      buf[i] = rand();
+    }
+    if (CRC16(buf, len) != CRC16_bitwise(buf, len)) {
+      printf("CRC16 mismatch for length %d\n", len);
+      errors++;
+    }
+  }
+  printf("%s\n", errors ? "FAILED" : "CRC5 and CRC16 match the bitwise versions");
+
+  const int iters = 20000;
+  volatile uint32_t sink = 0;
+  double t0 = now_secs();
+  for (int i = 0; i < iters; i++) {
+    sink ^= CRC16_bitwise(buf, 1023);
+  }
+  double t1 = now_secs();
+  for (int i = 0; i < iters; i++) {
+    sink ^= CRC16(buf, 1023);
+  }
+  double t2 = now_secs();
+  double mb = iters * 1023.0 / 1e6;
+  printf("CRC16 bitwise: %8.1f MB/s\n", mb / (t1 - t0));
+  printf("CRC16 table:   %8.1f MB/s\n", mb / (t2 - t1));
+  return errors ? 1 : 0;
+}
+
 int main(int argc, char *argv[]) {
   int i;
   int base;
+  if (argc < 2) {
+    printf("Usage: %s <value> | -x <hex bytes> | - <bytes> | -b\n", argv[0]);
+    exit(1);
+  }
+  if (argv[1][0] == '-' && argv[1][1] == 'b') {
+    return check_and_bench();
+  }
   if (argv[1][0] != '-') {
     int val = strtol(argv[1], NULL, 0);
     int crc = CRC5(val, 11);
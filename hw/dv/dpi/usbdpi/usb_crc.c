@@ -59,25 +59,68 @@ uint32_t CRC5_MSBfirst(uint32_t dwInput, int iBitcnt) {
  * value and get back 5 bits to OR in to the top to construct 16 bits
  *
  * Adapted by mdhayter
+ *
+ * CRC5 and CRC16 below are table driven, consuming a byte per lookup (or eight
+ * bytes per group of lookups for CRC16, "slicing-by-8"). They give the same
+ * results as the bit-serial versions from the white paper; test_crc.c checks
+ * this and can compare their throughput.
  */
 
+static const uint32_t crc5_poly = 0x14;
+static const uint32_t crc16_poly = 0xA001;
+
+// crc5_table[i] is the effect of eight bit-serial steps on the CRC5 register
+// after the data byte has been XORed into its bottom bits.
+static uint8_t crc5_table[256];
+
+// crc16_table[0][i] is the same for CRC16. crc16_table[k][i] is the effect of
+// a byte followed by k zero bytes, used to process eight bytes at a time.
+static uint16_t crc16_table[8][256];
+
+static int crc_tables_ready = 0;
+
+static void crc_init_tables(void) {
+  for (uint32_t i = 0; i < 256; ++i) {
+    uint32_t crc5 = i;
+    uint32_t crc16 = i;
+    for (int bit = 0; bit < 8; ++bit) {
+      crc5 = (crc5 & 1) ? (crc5 >> 1) ^ crc5_poly : crc5 >> 1;
+      crc16 = (crc16 & 1) ? (crc16 >> 1) ^ crc16_poly : crc16 >> 1;
+    }
+    crc5_table[i] = (uint8_t)crc5;
+    crc16_table[0][i] = (uint16_t)crc16;
+  }
+  for (int k = 1; k < 8; ++k) {
+    for (uint32_t i = 0; i < 256; ++i) {
+      uint16_t prev = crc16_table[k - 1][i];
+      crc16_table[k][i] = (prev >> 8) ^ crc16_table[0][prev & 0xff];
+    }
+  }
+  crc_tables_ready = 1;
+}
+
 uint32_t CRC5(uint32_t dwInput, int iBitcnt) {
-  const uint32_t poly5 = 0x14;
   uint32_t crc5 = 0x1f;
   uint32_t udata = dwInput;
 
   if ((iBitcnt < 1) || (iBitcnt > INT_SIZE)) {  // Validate iBitcnt
     return 0xffffffff;
   }
+  if (!crc_tables_ready) {
+    crc_init_tables();
+  }
 
+  for (; iBitcnt >= 8; iBitcnt -= 8) {
+    crc5 = crc5_table[(crc5 ^ udata) & 0xff];
+    udata >>= 8;
+  }
   while (iBitcnt--) {
     if ((udata ^ crc5) & 0x01) {
       crc5 >>= 1;
-      crc5 ^= poly5;
+      crc5 ^= crc5_poly;
     } else {
       crc5 >>= 1;
     }
-
     udata >>= 1;
   }
 
@@ -89,25 +132,25 @@ uint32_t CRC5(uint32_t dwInput, int iBitcnt) {
 
 // Added mdhayter
 uint32_t CRC16(const uint8_t *data, int bytes) {
-  const uint32_t poly16 = 0xA001;
   uint32_t crc16 = 0xffff;
-  int i;
-
-  for (i = 0; i < bytes; i++) {
-    uint32_t udata = data[i];
-    int bit = 8;
+  int i = 0;
 
-    while (bit--) {
-      if ((udata ^ crc16) & 0x01) {
-        crc16 >>= 1;
-        crc16 ^= poly16;
-      } else {
-        crc16 >>= 1;
-      }
+  if (!crc_tables_ready) {
+    crc_init_tables();
+  }
 
-      udata >>= 1;
-    }
+  for (; i + 8 <= bytes; i += 8) {
+    const uint8_t *d = &data[i];
+    uint32_t lo = crc16 ^ (d[0] | ((uint32_t)d[1] << 8));
+    crc16 = crc16_table[7][lo & 0xff] ^ crc16_table[6][lo >> 8] ^
+            crc16_table[5][d[2]] ^ crc16_table[4][d[3]] ^
+            crc16_table[3][d[4]] ^ crc16_table[2][d[5]] ^
+            crc16_table[1][d[6]] ^ crc16_table[0][d[7]];
   }
+  for (; i < bytes; i++) {
+    crc16 = (crc16 >> 8) ^ crc16_table[0][(crc16 ^ data[i]) & 0xff];
+  }
+
   // Invert contents to generate crc field
   crc16 ^= 0xffff;
 
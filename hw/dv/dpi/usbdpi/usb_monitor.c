@@ -8,6 +8,7 @@
 #include <stdio.h>
 #include <string.h>
 
+#include "dpi_binlog.h"
 #include "usb_utils.h"
 #include "usbdpi.h"
 
@@ -34,6 +35,10 @@ struct usb_monitor_ctx {
    * Log file
    */
   FILE *file;
+  /**
+   * Binary log, or NULL to log text to file
+   */
+  struct dpi_binlog *binlog;
   /**
    * Monitor state, reflecting the current state of the USB
    */
@@ -120,6 +125,24 @@ void usb_monitor_fin(usb_monitor_ctx_t *mon) {
   free(mon);
 }
 
+/**
+ * Log decoded events to a binary log instead of the log file
+ */
+void usb_monitor_set_binlog(usb_monitor_ctx_t *mon,
+                            struct dpi_binlog *binlog) {
+  mon->binlog = binlog;
+}
+
+// Write an event to the binary log, if there is one
+static inline void binlog_event(usb_monitor_ctx_t *mon, uint32_t tick_bits,
+                                uint8_t type, uint32_t header, uint32_t aux) {
+  if (mon->binlog) {
+    dpi_binlog_write(mon->binlog, tick_bits, type,
+                     mon->driver == M_DEVICE ? USBDPI_BINLOG_FLAG_DEVICE : 0,
+                     header, aux, NULL, 0);
+  }
+}
+
 /**
  * Append a formatted message to the USB monitor log file
  */
@@ -134,8 +157,9 @@ void usb_monitor_log(usb_monitor_ctx_t *ctx, const char *fmt, ...) {
 }
 
 #define DR_SIZE 128
-static char dr[DR_SIZE];
-char *pid_2data(int pid, unsigned char d0, unsigned char d1) {
+// The caller provides the output buffer so that monitors evaluated on
+// different simulation threads do not share it.
+static char *pid_2data(char *dr, int pid, unsigned char d0, unsigned char d1) {
   int comp_crc = CRC5((d1 & 7) << 8 | d0, 11);
   const char *crcok = (comp_crc == d1 >> 3) ? "OK" : "BAD";
 
@@ -177,8 +201,10 @@ char *pid_2data(int pid, unsigned char d0, unsigned char d1) {
  */
 void usb_monitor(usb_monitor_ctx_t *mon, int loglevel, uint32_t tick_bits,
                  bool hdrive, uint32_t p2d, uint32_t d2p, uint8_t *lastpid) {
-  bool log = ((loglevel & 0x2) != 0);
-  bool compact = ((loglevel & 0x1) != 0);
+  // The binary log replaces the text output of the monitor
+  bool binary = (mon->binlog != NULL);
+  bool log = !binary && ((loglevel & 0x2) != 0);
+  bool compact = !binary && ((loglevel & 0x1) != 0);
 
   assert(mon);
 
@@ -188,7 +214,11 @@ void usb_monitor(usb_monitor_ctx_t *mon, int loglevel, uint32_t tick_bits,
   int dp, dn;
   if ((d2p & D2P_DP_EN) || (d2p & D2P_DN_EN) || (d2p & D2P_D_EN)) {
     if (hdrive) {
-      fprintf(mon->file, "mon: %8d: Bus clash\n", tick_bits);
+      if (binary) {
+        binlog_event(mon, tick_bits, USBDPI_BINLOG_BUS_CLASH, 0, d2p);
+      } else {
+        fprintf(mon->file, "mon: %8d: Bus clash\n", tick_bits);
+      }
     }
     if (d2p & D2P_TX_USE_D_SE0) {
       // Single-ended mode uses D and SE0
@@ -231,6 +261,8 @@ void usb_monitor(usb_monitor_ctx_t *mon, int loglevel, uint32_t tick_bits,
         }
       }
       mon->driver = M_NONE;
+      binlog_event(mon, tick_bits, USBDPI_BINLOG_IDLE,
+                   (d2p & D2P_PU) ? 1 : 0, d2p);
       mon->pu = (d2p & D2P_PU);
     }
     mon->line = 0;
@@ -263,13 +295,20 @@ void usb_monitor(usb_monitor_ctx_t *mon, int loglevel, uint32_t tick_bits,
 
   // EOP detection, calculate and check the CRC16 on any data field
   if ((mon->line & 0x3f) == ((SE0 << 4) | (SE0 << 2) | (DJ << 0))) {
+    if (binary) {
+      size_t len = (mon->state == MS_GET_BYTES) ? mon->byte : 0;
+      dpi_binlog_write(mon->binlog, tick_bits, USBDPI_BINLOG_PACKET,
+                       mon->driver == M_DEVICE ? USBDPI_BINLOG_FLAG_DEVICE : 0,
+                       mon->lastpid, mon->sopAt, mon->bytes, len);
+    }
     if ((log || compact) && (mon->state == MS_GET_BYTES) && (mon->byte > 0)) {
       uint32_t pkt_crc16, comp_crc16;
 
       if (compact && mon->byte == 2) {
+        char dr[DR_SIZE];
         fprintf(mon->file, "mon: %8d -- %8d: (%c) SOP, PID %s, EOP\n",
                 mon->sopAt, tick_bits, mon->driver == M_HOST ? 'H' : 'D',
-                pid_2data(mon->lastpid, mon->bytes[0], mon->bytes[1]));
+                pid_2data(dr, mon->lastpid, mon->bytes[0], mon->bytes[1]));
       } else if (compact && mon->byte == 1) {
         fprintf(mon->file, "mon: %8d -- %8d: (%c) SOP, PID %s %02x EOP\n",
                 mon->sopAt, tick_bits, mon->driver == M_HOST ? 'H' : 'D',
@@ -319,8 +358,13 @@ void usb_monitor(usb_monitor_ctx_t *mon, int loglevel, uint32_t tick_bits,
   mon->rawbits = (mon->rawbits << 1) | newbit;
   if ((mon->rawbits & 0x7e) == 0x7e) {
     if (newbit == 1) {
-      fprintf(mon->file, "mon: %8d: (%c) Bitstuff error, got 1 after 0x%x\n",
-              tick_bits, mon->driver == M_HOST ? 'H' : 'D', mon->rawbits);
+      if (binary) {
+        binlog_event(mon, tick_bits, USBDPI_BINLOG_BITSTUFF, mon->rawbits, 0);
+      } else {
+        fprintf(mon->file,
+                "mon: %8d: (%c) Bitstuff error, got 1 after 0x%x\n",
+                tick_bits, mon->driver == M_HOST ? 'H' : 'D', mon->rawbits);
+      }
     }
     /* Ignore bit stuff bit */
     return;
@@ -338,6 +382,7 @@ void usb_monitor(usb_monitor_ctx_t *mon, int loglevel, uint32_t tick_bits,
       // of the lower nibble is invalid
       uint8_t pid = (uint8_t)mon->bits;
       if (((pid ^ 0xf0) >> 4) ^ (pid & 0x0f)) {
+        binlog_event(mon, tick_bits, USBDPI_BINLOG_BAD_PID, pid, 0);
         if (log) {
           fprintf(mon->file, "mon: %8d: (%c) BAD PID 0x%x\n", tick_bits,
                   mon->driver == M_HOST ? 'H' : 'D', pid);
@@ -7,6 +7,8 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+#include "dpi_binlog.h"
+
 /**
  * USB monitor context
  */
@@ -20,6 +22,25 @@ typedef enum {
   UsbMon_DataType_EOP
 } usbmon_data_type_t;
 
+// Binary log records (see dpi_binlog.h). Times are in USB bit intervals, and
+// flags has USBDPI_BINLOG_FLAG_DEVICE set if the device was driving the bus.
+//
+// USBDPI_BINLOG_PACKET:    a packet ended. header is the PID, aux the time of
+//                          the SOP and the payload the bytes after the PID,
+//                          including any CRC.
+// USBDPI_BINLOG_IDLE:      the bus became idle. header is 1 if the pull-up is
+//                          enabled, and aux holds the d2p signals.
+// USBDPI_BINLOG_BUS_CLASH: the host and device drove the bus together. aux
+//                          holds the d2p signals.
+// USBDPI_BINLOG_BITSTUFF:  bit stuffing error. header holds the raw bits.
+// USBDPI_BINLOG_BAD_PID:   invalid PID. header holds the PID byte.
+#define USBDPI_BINLOG_PACKET 1
+#define USBDPI_BINLOG_IDLE 2
+#define USBDPI_BINLOG_BUS_CLASH 3
+#define USBDPI_BINLOG_BITSTUFF 4
+#define USBDPI_BINLOG_BAD_PID 5
+#define USBDPI_BINLOG_FLAG_DEVICE 0x01
+
 /**
  * Callback function for USB data
  */
@@ -45,6 +66,16 @@ usb_monitor_ctx_t *usb_monitor_init(const char *filename,
  */
 void usb_monitor_fin(usb_monitor_ctx_t *mon);
 
+/**
+ * Log decoded events to a binary log instead of the log file
+ *
+ * The log is not closed by usb_monitor_fin().
+ *
+ * @param mon        USB monitor context
+ * @param binlog     Binary log
+ */
+void usb_monitor_set_binlog(usb_monitor_ctx_t *mon, struct dpi_binlog *binlog);
+
 /**
  * Append a formatted message to the USB monitor log file
  *
@@ -16,6 +16,7 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include "dpi_profile.h"
 #include "usb_utils.h"
 #include "usbdpi_test.h"
 
@@ -105,7 +106,7 @@ static void usbdpi_data_callback(void *ctx_v, usbmon_data_type_t type,
 /**
  * Create a USB DPI instance, returning a 'chandle' for later use
  */
-void *usbdpi_create(const char *name, int loglevel) {
+void *usbdpi_create(const char *name, int loglevel, int packet_level) {
   // Use calloc for zero-initialisation
   usbdpi_ctx_t *ctx = (usbdpi_ctx_t *)calloc(1, sizeof(usbdpi_ctx_t));
   assert(ctx);
@@ -122,6 +123,7 @@ void *usbdpi_create(const char *name, int loglevel) {
   bus_reset(ctx);
 
   ctx->loglevel = loglevel;
+  ctx->packet_level = (packet_level != 0);
 
   char cwd[FILENAME_MAX];
   char *cwd_rv;
@@ -134,16 +136,32 @@ void *usbdpi_create(const char *name, int loglevel) {
 
   ctx->mon = usb_monitor_init(ctx->mon_pathname, usbdpi_data_callback, ctx);
 
+  if (loglevel & LOG_BINARY) {
+    char bin_pathname[FILENAME_MAX];
+    rv = snprintf(bin_pathname, FILENAME_MAX, "%s/%s.bin", cwd, name);
+    assert(rv <= FILENAME_MAX && rv > 0);
+    ctx->binlog = dpi_binlog_open(bin_pathname, DPI_BINLOG_SOURCE_USB);
+    if (ctx->binlog && ctx->mon) {
+      usb_monitor_set_binlog(ctx->mon, ctx->binlog);
+      printf(
+          "USBDPI: Monitor events are logged to %s. Decode with\n"
+          "$ hw/dv/dpi/common/dpi_binlog/decode_binlog.py %s\n",
+          bin_pathname, bin_pathname);
+    }
+  }
+
   // Prepare the transfer descriptors for use
   usb_transfer_setup(ctx);
 
   return (void *)ctx;
 }
 
-void usbdpi_device_to_host(void *ctx_void, const svBitVecVal *usb_d2p) {
-  usbdpi_ctx_t *ctx = (usbdpi_ctx_t *)ctx_void;
-  assert(ctx);
+static struct dpi_profile_counter device_to_host_prof =
+    DPI_PROFILE_COUNTER_INIT("usbdpi.device_to_host");
+static struct dpi_profile_counter host_to_device_prof =
+    DPI_PROFILE_COUNTER_INIT("usbdpi.host_to_device");
 
+static void device_to_host(usbdpi_ctx_t *ctx, const svBitVecVal *usb_d2p) {
   // Ascertain the state of the D+/D- signals from the device
   // TODO - migrate to a simple function
   uint32_t d2p = usb_d2p[0];
@@ -302,6 +320,15 @@ void usbdpi_device_to_host(void *ctx_void, const svBitVecVal *usb_d2p) {
   }
 }
 
+void usbdpi_device_to_host(void *ctx_void, const svBitVecVal *usb_d2p) {
+  usbdpi_ctx_t *ctx = (usbdpi_ctx_t *)ctx_void;
+  assert(ctx);
+
+  uint64_t prof_start = dpi_profile_begin();
+  device_to_host(ctx, usb_d2p);
+  dpi_profile_end(&device_to_host_prof, prof_start);
+}
+
 // Callback for USB data detection
 // - the DPI host model presently does not duplicate the bit-level decoding and
 //   packet construction of the usb_monitor, so we piggyback on its decoding and
@@ -1112,9 +1139,7 @@ uint32_t inv_driving(usbdpi_ctx_t *ctx, uint32_t d2p) {
   return ctx->driving ^ (P2D_DP | P2D_DN | P2D_D);
 }
 
-uint8_t usbdpi_host_to_device(void *ctx_void, const svBitVecVal *usb_d2p) {
-  usbdpi_ctx_t *ctx = (usbdpi_ctx_t *)ctx_void;
-  assert(ctx);
+static uint8_t host_to_device(usbdpi_ctx_t *ctx, const svBitVecVal *usb_d2p) {
   int d2p = usb_d2p[0];
   uint32_t last_driving = ctx->driving;
   int force_stat = 0;
@@ -1131,10 +1156,13 @@ uint8_t usbdpi_host_to_device(void *ctx_void, const svBitVecVal *usb_d2p) {
     return ctx->driving;
   }
 
-  // Monitor, analyse and record USB bus activity
-  usb_monitor(ctx->mon, ctx->loglevel, ctx->tick_bits,
-              (ctx->state != ST_IDLE) && (ctx->state != ST_GET), ctx->driving,
-              d2p, &(ctx->lastrxpid));
+  // Monitor, analyse and record USB bus activity; at packet level, the host
+  // already knows what it is sending so only the device is monitored.
+  bool hdrive = (ctx->state != ST_IDLE) && (ctx->state != ST_GET);
+  if (!ctx->packet_level || !hdrive) {
+    usb_monitor(ctx->mon, ctx->loglevel, ctx->tick_bits, hdrive, ctx->driving,
+                d2p, &(ctx->lastrxpid));
+  }
 
   if (ctx->tick_bits == SENSE_AT) {
     ctx->driving |= P2D_SENSE;
@@ -1369,6 +1397,10 @@ uint8_t usbdpi_host_to_device(void *ctx_void, const svBitVecVal *usb_d2p) {
         ctx->bit = 1;
         ctx->linebits = 1;  // The KK at end of SYNC counts for bit stuffing!
         ctx->state = ST_SEND;
+        if (ctx->packet_level) {
+          // Record the PID as the monitor would have done
+          ctx->lastrxpid = ctx->sending->data[ctx->byte];
+        }
       }
       break;
 
@@ -1450,6 +1482,16 @@ uint8_t usbdpi_host_to_device(void *ctx_void, const svBitVecVal *usb_d2p) {
   return ctx->driving;
 }
 
+uint8_t usbdpi_host_to_device(void *ctx_void, const svBitVecVal *usb_d2p) {
+  usbdpi_ctx_t *ctx = (usbdpi_ctx_t *)ctx_void;
+  assert(ctx);
+
+  uint64_t prof_start = dpi_profile_begin();
+  uint8_t driving = host_to_device(ctx, usb_d2p);
+  dpi_profile_end(&host_to_device_prof, prof_start);
+  return driving;
+}
+
 // Export some internal diagnostic state for visibility in waveforms
 void usbdpi_diags(void *ctx_void, svBitVecVal *diags) {
   usbdpi_ctx_t *ctx = (usbdpi_ctx_t *)ctx_void;
@@ -1474,5 +1516,6 @@ void usbdpi_close(void *ctx_void) {
     return;
   }
   usb_monitor_fin(ctx->mon);
+  dpi_binlog_close(ctx->binlog);
   free(ctx);
 }
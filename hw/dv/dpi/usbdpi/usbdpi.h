@@ -47,8 +47,9 @@ typedef uint32_t svBitVecVal;
 #define SENSE_AT 20 * 8
 
 // Logging level (parameter to module)
-#define LOG_MON 0x01  // USB monitor logging (packet level)
-#define LOG_BIT 0x08  // bit level
+#define LOG_MON 0x01     // USB monitor logging (packet level)
+#define LOG_BIT 0x08     // bit level
+#define LOG_BINARY 0x10  // binary monitor log instead of text
 
 // Error insertion
 #define INSERT_ERR_CRC 0
@@ -306,11 +307,22 @@ struct usbdpi_ctx {
   // Diagnostic logging and bus monitoring
   int loglevel;
   char mon_pathname[FILENAME_MAX];
+  /**
+   * Packet-level host operation: the host does not pass its own transmissions
+   * through the bit-level decoding of the USB monitor, but records the PIDs
+   * that it sends directly. Device transmissions are still decoded (and
+   * logged according to loglevel).
+   */
+  bool packet_level;
 
   /**
    * USB monitor instance
    */
   usb_monitor_ctx_t *mon;
+  /**
+   * Binary log for the USB monitor, or NULL
+   */
+  struct dpi_binlog *binlog;
 
   /**
    * Host controller state
@@ -397,8 +409,11 @@ struct usbdpi_ctx {
 
 /**
  * Create a USB DPI instance, returning a 'chandle' for later use
+ *
+ * If packet_level is non-zero, the monitor does not decode or log the packets
+ * sent by the host (see usbdpi_ctx::packet_level).
  */
-void *usbdpi_create(const char *name, int loglevel);
+void *usbdpi_create(const char *name, int loglevel, int packet_level);
 /**
  * Close a USB DPI instance
  */
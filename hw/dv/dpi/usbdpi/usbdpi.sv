@@ -8,6 +8,12 @@
 // 0x01 -- monitor_usb (packet level)
 // 0x02 -- more verbose monitor
 // 0x08 -- bit level
+// 0x10 -- binary packet log in <NAME>.bin instead of monitor text (see
+//         usb_monitor.h)
+//
+// Plusargs:
+// +usbdpi_packet_level -- don't decode or log the packets sent by the host
+// +usbdpi_binlog       -- add 0x10 to LOG_LEVEL
 
 module usbdpi #(
   parameter string NAME = "usb0",
@@ -37,7 +43,8 @@ module usbdpi #(
   input  logic pullupdn_d2p
 );
   import "DPI-C" function
-    chandle usbdpi_create(input string name, input int loglevel);
+    chandle usbdpi_create(input string name, input int loglevel,
+                          input int packet_level);
 
   import "DPI-C" function
     void usbdpi_device_to_host(input chandle ctx, input bit [10:0] d2p);
@@ -54,7 +61,11 @@ module usbdpi #(
   chandle ctx;
 
   initial begin
-    ctx = usbdpi_create(NAME, LOG_LEVEL);
+    int loglevel = LOG_LEVEL;
+    if ($test$plusargs("usbdpi_binlog")) begin
+      loglevel |= 'h10;
+    end
+    ctx = usbdpi_create(NAME, loglevel, $test$plusargs("usbdpi_packet_level"));
   end
 
   final begin
@@ -22,6 +22,9 @@
       (uint8_t)((lfsr) << 1) ^ \
       ((((lfsr) >> 1) ^ ((lfsr) >> 2) ^ ((lfsr) >> 3) ^ ((lfsr) >> 7)) & 1U))
 
+// Length of the precomputed LFSR sequences; any data field fits in one
+#define LFSR_BLOCK_LEN USBDEV_MAX_PACKET_SIZE
+
 // Stream signature words
 #define STREAM_SIGNATURE_HEAD 0x579EA01AU
 #define STREAM_SIGNATURE_TAIL 0x160AE975U
@@ -36,6 +39,26 @@ static const bool verbose = false;
 // Single letter prefix indicating the transfer type
 static const char xfr_sym[] = {'C', 'X', 'B', 'I'};
 
+// Precomputed LFSR sequences: lfsr_blocks[s][i] is the LFSR state after i
+// steps from state s, which is also the i-th byte of the sequence from s.
+// This lets whole packets be generated and checked with block operations.
+static uint8_t lfsr_blocks[0x100U][LFSR_BLOCK_LEN + 1U];
+static bool lfsr_blocks_valid = false;
+
+// Initialize the precomputed LFSR sequences
+static void lfsr_blocks_init(void);
+
+// Generate the next len bytes of the LFSR sequence, advancing the LFSR
+static void lfsr_fill(uint8_t *lfsr, uint8_t *dp, unsigned len);
+
+// Check whether len bytes match the LFSR sequence, advancing the LFSR only if
+// they do
+static bool lfsr_match(uint8_t *lfsr, const uint8_t *sp, unsigned len);
+
+// XOR len bytes with the LFSR sequence, advancing the LFSR
+static void lfsr_xor(uint8_t *lfsr, uint8_t *dp, const uint8_t *sp,
+                     unsigned len);
+
 // Determine the next stream for which IN data packets shall be requested
 static inline unsigned in_stream_next(usbdpi_ctx_t *ctx);
 
@@ -62,6 +85,59 @@ static usbdpi_transfer_t *stream_data_process(usbdpi_ctx_t *ctx,
 static bool stream_sig_check(usbdpi_ctx_t *ctx, usbdpi_stream_t *s,
                              usbdpi_transfer_t *rx);
 
+void lfsr_blocks_init(void) {
+  if (lfsr_blocks_valid) {
+    return;
+  }
+  for (unsigned s = 0U; s < 0x100U; s++) {
+    uint8_t lfsr = (uint8_t)s;
+    for (unsigned idx = 0U; idx <= LFSR_BLOCK_LEN; idx++) {
+      lfsr_blocks[s][idx] = lfsr;
+      lfsr = LFSR_ADVANCE(lfsr);
+    }
+  }
+  lfsr_blocks_valid = true;
+}
+
+void lfsr_fill(uint8_t *lfsr, uint8_t *dp, unsigned len) {
+  while (len > 0U) {
+    unsigned n = (len < LFSR_BLOCK_LEN) ? len : LFSR_BLOCK_LEN;
+    memcpy(dp, lfsr_blocks[*lfsr], n);
+    *lfsr = lfsr_blocks[*lfsr][n];
+    dp += n;
+    len -= n;
+  }
+}
+
+bool lfsr_match(uint8_t *lfsr, const uint8_t *sp, unsigned len) {
+  uint8_t next = *lfsr;
+  while (len > 0U) {
+    unsigned n = (len < LFSR_BLOCK_LEN) ? len : LFSR_BLOCK_LEN;
+    if (memcmp(sp, lfsr_blocks[next], n)) {
+      return false;
+    }
+    next = lfsr_blocks[next][n];
+    sp += n;
+    len -= n;
+  }
+  *lfsr = next;
+  return true;
+}
+
+void lfsr_xor(uint8_t *lfsr, uint8_t *dp, const uint8_t *sp, unsigned len) {
+  while (len > 0U) {
+    unsigned n = (len < LFSR_BLOCK_LEN) ? len : LFSR_BLOCK_LEN;
+    const uint8_t *block = lfsr_blocks[*lfsr];
+    for (unsigned idx = 0U; idx < n; idx++) {
+      dp[idx] = sp[idx] ^ block[idx];
+    }
+    *lfsr = block[n];
+    dp += n;
+    sp += n;
+    len -= n;
+  }
+}
+
 // Determine the next stream for which IN data packets shall be requested
 inline unsigned in_stream_next(usbdpi_ctx_t *ctx) {
   uint8_t id = ctx->stream_in;
@@ -100,6 +176,9 @@ bool streams_init(usbdpi_ctx_t *ctx, unsigned nstreams,
            send ? 'Y' : 'N');
   }
 
+  // Precompute the LFSR sequences used to generate and check stream data
+  lfsr_blocks_init();
+
   // Remember the number of streams and initialize the arbitration of
   // IN and OUT traffic
   ctx->nstreams = nstreams;
@@ -197,17 +276,21 @@ bool stream_data_check(usbdpi_ctx_t *ctx, usbdpi_stream_t *s,
         // Note: use a local copy of the LFSR so that we can check the data
         //       field even on those packets that we choose to reject
         uint8_t tst_lfsr = s->tst_lfsr;
-        while (num_bytes-- > 0U) {
-          uint8_t recvd = *sp++;
-          if (recvd != tst_lfsr) {
-            printf(
-                "[usbdpi] %c%u: Mismatched data from device 0x%02x, "
-                "expected 0x%02x\n",
-                xfr_sym[s->xfr_type], s->id, recvd, tst_lfsr);
-            ok = false;
+        // Common case: the whole data field is as expected
+        if (!lfsr_match(&tst_lfsr, sp, num_bytes)) {
+          // Report each of the mismatched bytes
+          while (num_bytes-- > 0U) {
+            uint8_t recvd = *sp++;
+            if (recvd != tst_lfsr) {
+              printf(
+                  "[usbdpi] %c%u: Mismatched data from device 0x%02x, "
+                  "expected 0x%02x\n",
+                  xfr_sym[s->xfr_type], s->id, recvd, tst_lfsr);
+              ok = false;
+            }
+            // Advance our local LFSR
+            tst_lfsr = LFSR_ADVANCE(tst_lfsr);
           }
-          // Advance our local LFSR
-          tst_lfsr = LFSR_ADVANCE(tst_lfsr);
         }
 
         // Update the LFSR only if we've accepted valid data and will not
@@ -236,10 +319,7 @@ usbdpi_transfer_t *stream_data_gen(usbdpi_ctx_t *ctx, usbdpi_stream_t *s,
     ctx->ep_in[s->ep_in].next_data = DATA_TOGGLE_ADVANCE(data);
     // ...and that the data is as expected
     uint8_t *dp = transfer_data_start(tr, data, len);
-    for (unsigned idx = 0U; idx < len; idx++) {
-      dp[idx] = s->tst_lfsr;
-      s->tst_lfsr = LFSR_ADVANCE(s->tst_lfsr);
-    }
+    lfsr_fill(&s->tst_lfsr, dp, len);
     transfer_data_end(tr, dp + len);
   }
   return tr;
@@ -301,18 +381,16 @@ usbdpi_transfer_t *stream_data_process(usbdpi_ctx_t *ctx, usbdpi_stream_t *s,
   // failure
   s->dpi_rewind_lfsr = s->dpi_lfsr;
 
-  while (num_bytes-- > 0U) {
-    uint8_t recvd = *sp++;
-
-    // Simply XOR the two LFSR-generated streams together
-    *dp++ = recvd ^ s->dpi_lfsr;
-    if (verbose) {
-      printf("[usbdpi] 0x%02x <- 0x%02x ^ 0x%02x\n", *(dp - 1), recvd,
-             s->dpi_lfsr);
+  // Simply XOR the two LFSR-generated streams together
+  lfsr_xor(&s->dpi_lfsr, dp, sp, num_bytes);
+  if (verbose) {
+    uint8_t lfsr = s->dpi_rewind_lfsr;
+    for (unsigned idx = 0U; idx < num_bytes; idx++) {
+      printf("[usbdpi] 0x%02x <- 0x%02x ^ 0x%02x\n", dp[idx], sp[idx], lfsr);
+      lfsr = LFSR_ADVANCE(lfsr);
     }
-    // Advance our local copy of the LFSR
-    s->dpi_lfsr = LFSR_ADVANCE(s->dpi_lfsr);
   }
+  dp += num_bytes;
 
   transfer_data_end(reply, dp);
 
@@ -575,6 +575,17 @@ class mem_bkdr_util extends uvm_object;
     #0;
 
     // Recompute ECC if indicated (this allows to load an image that does not have ECC present).
+    // When each row holds a single ECC word, the whole image is encoded in one DPI call and
+    // loaded again with $readmemh, which is much faster than rewriting it word by word.
+    if (recompute_ecc && ecc_vmem_supported()) begin
+      string ecc_file = $sformatf("mem_bkdr_util_%0d_ecc.vmem", get_inst_id());
+      if (mem_bkdr_util_dpi_ecc_vmem(file, ecc_file, err_detection_scheme) >= 0) begin
+        this.file = ecc_file;
+        ->readmemh_event;
+        #0;
+        recompute_ecc = 0;
+      end
+    end
     if (recompute_ecc) begin
       case (err_detection_scheme)
         Ecc_22_16, EccHamming_22_16, EccInv_22_16, EccInvHamming_22_16: begin
@@ -598,6 +609,21 @@ class mem_bkdr_util extends uvm_object;
     end
   endtask
 
+  // Returns true if mem_bkdr_util_dpi_ecc_vmem can add the ECC for this memory: the scheme must
+  // be a Hsiao code and each row must hold exactly one ECC word.
+  protected function bit ecc_vmem_supported();
+    prim_secded_pkg::prim_secded_e secded_eds;
+    if (!`HAS_ECC) return 0;
+    if (err_detection_scheme inside {EccHamming_22_16, EccHamming_39_32, EccHamming_72_64,
+                                     EccHamming_76_68, EccInvHamming_22_16, EccInvHamming_39_32,
+                                     EccInvHamming_72_64, EccInvHamming_76_68}) begin
+      return 0;
+    end
+    secded_eds = prim_secded_pkg::prim_secded_e'(err_detection_scheme);
+    return width == prim_secded_pkg::get_ecc_data_width(secded_eds) +
+                    prim_secded_pkg::get_ecc_parity_width(secded_eds);
+  endfunction
+
   // save mem contents to file
   virtual function void write_mem_to_file(string file);
     check_file(file, "w");
@@ -0,0 +1,291 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+// Bulk backends for mem_bkdr_util.
+//
+// Adding ECC or scrambling a whole memory one word at a time from
+// SystemVerilog is slow: each word is taken apart bit by bit and written with
+// its own uvm_hdl_deposit. The functions here instead transform a whole vmem
+// file in one call, writing a new vmem file with explicit addresses that the
+// caller then loads with a single $readmemh (see MEM_BKDR_UTIL_FILE_OP).
+//
+// Each function returns the number of words written, or -1 if the request is
+// not supported (in which case the caller should use its SystemVerilog
+// implementation) or a file could not be read or written.
+
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "scramble_model.h"
+#include "secded_enc.h"
+#include "svdpi.h"
+
+namespace {
+
+// Must match prim_secded_pkg::prim_secded_e
+enum SecdedScheme {
+  kSecded_22_16 = 1,
+  kSecded_28_22 = 2,
+  kSecded_39_32 = 3,
+  kSecded_64_57 = 4,
+  kSecded_72_64 = 5,
+  kSecdedInv_22_16 = 10,
+  kSecdedInv_28_22 = 11,
+  kSecdedInv_39_32 = 12,
+  kSecdedInv_64_57 = 13,
+  kSecdedInv_72_64 = 14,
+};
+
+typedef uint8_t (*EncFn)(const uint8_t *bytes);
+
+struct SecdedInfo {
+  uint32_t data_width;
+  uint32_t parity_width;
+  EncFn enc;
+};
+
+// Find the encoder for scheme. Returns false for schemes that secded_enc does
+// not implement (the Hamming codes).
+bool GetSecdedInfo(int scheme, SecdedInfo *info) {
+  switch (scheme) {
+    case kSecded_22_16:
+      *info = {16, 6, enc_secded_22_16};
+      return true;
+    case kSecded_28_22:
+      *info = {22, 6, enc_secded_28_22};
+      return true;
+    case kSecded_39_32:
+      *info = {32, 7, enc_secded_39_32};
+      return true;
+    case kSecded_64_57:
+      *info = {57, 7, enc_secded_64_57};
+      return true;
+    case kSecded_72_64:
+      *info = {64, 8, enc_secded_72_64};
+      return true;
+    case kSecdedInv_22_16:
+      *info = {16, 6, enc_secded_inv_22_16};
+      return true;
+    case kSecdedInv_28_22:
+      *info = {22, 6, enc_secded_inv_28_22};
+      return true;
+    case kSecdedInv_39_32:
+      *info = {32, 7, enc_secded_inv_39_32};
+      return true;
+    case kSecdedInv_64_57:
+      *info = {57, 7, enc_secded_inv_64_57};
+      return true;
+    case kSecdedInv_72_64:
+      *info = {64, 8, enc_secded_inv_72_64};
+      return true;
+    default:
+      return false;
+  }
+}
+
+uint64_t Mask(uint32_t width) {
+  return width >= 64 ? ~UINT64_C(0) : (UINT64_C(1) << width) - 1;
+}
+
+// Compute the parity bits for the low info.data_width bits of data
+uint8_t Encode(const SecdedInfo &info, uint64_t data) {
+  uint8_t bytes[8];
+  for (int i = 0; i < 8; ++i) {
+    bytes[i] = (uint8_t)(data >> (8 * i));
+  }
+  return info.enc(bytes);
+}
+
+struct VmemWord {
+  uint32_t addr;
+  uint64_t data;
+};
+
+// Read the words of a vmem file in the format accepted by $readmemh: hex
+// words separated by whitespace, with optional "@addr" directives and // or
+// /* */ comments. Only the low 64 bits of each word are kept. Returns false
+// if the file can't be read or contains a word that isn't plain hex (such as
+// one with X or Z digits).
+bool ReadVmem(const char *path, std::vector<VmemWord> *words) {
+  std::ifstream in(path);
+  if (!in) {
+    std::cerr << "ERROR: mem_bkdr_util_dpi: cannot open " << path << "\n";
+    return false;
+  }
+  std::stringstream buf;
+  buf << in.rdbuf();
+  const std::string text = buf.str();
+
+  uint32_t addr = 0;
+  size_t i = 0;
+  while (i < text.size()) {
+    char c = text[i];
+    if (isspace((unsigned char)c)) {
+      ++i;
+      continue;
+    }
+    if (text.compare(i, 2, "//") == 0) {
+      i = text.find('\n', i);
+      if (i == std::string::npos) {
+        break;
+      }
+      continue;
+    }
+    if (text.compare(i, 2, "/*") == 0) {
+      i = text.find("*/", i + 2);
+      if (i == std::string::npos) {
+        break;
+      }
+      i += 2;
+      continue;
+    }
+
+    bool is_addr = c == '@';
+    if (is_addr) {
+      ++i;
+    }
+    uint64_t value = 0;
+    size_t start = i;
+    for (; i < text.size() && !isspace((unsigned char)text[i]); ++i) {
+      char d = text[i];
+      if (d == '_') {
+        continue;
+      }
+      if (!isxdigit((unsigned char)d)) {
+        std::cerr << "ERROR: mem_bkdr_util_dpi: unsupported character '" << d
+                  << "' in " << path << "\n";
+        return false;
+      }
+      uint64_t digit = isdigit((unsigned char)d) ? d - '0'
+                                                 : tolower((unsigned char)d) -
+                                                       'a' + 10;
+      value = (value << 4) | digit;
+    }
+    if (i == start) {
+      return false;
+    }
+
+    if (is_addr) {
+      addr = (uint32_t)value;
+    } else {
+      words->push_back({addr++, value});
+    }
+  }
+  return true;
+}
+
+// Write a word of width bits (at most 64 + 8) with an address directive
+void WriteWord(FILE *out, uint32_t addr, uint64_t lo, uint8_t hi,
+               uint32_t width) {
+  if (width > 64) {
+    fprintf(out, "@%x %x%016llx\n", addr, hi, (unsigned long long)lo);
+  } else {
+    fprintf(out, "@%x %llx\n", addr, (unsigned long long)lo);
+  }
+}
+
+// Get the bytes of a packed SV vector of width bits, least significant first
+std::vector<uint8_t> VecBytes(const svBitVecVal *vec, uint32_t width) {
+  std::vector<uint8_t> bytes(width / 8);
+  for (size_t i = 0; i < bytes.size(); ++i) {
+    bytes[i] = (uint8_t)(vec[i / 4] >> (8 * (i % 4)));
+  }
+  return bytes;
+}
+
+}  // namespace
+
+extern "C" {
+
+// Add ECC to every word of the vmem file at in_path, writing the encoded words
+// to out_path. The words in in_path hold data only; anything above the data
+// width of err_detection_scheme is discarded.
+int mem_bkdr_util_dpi_ecc_vmem(const char *in_path, const char *out_path,
+                               int err_detection_scheme) {
+  SecdedInfo info;
+  if (!GetSecdedInfo(err_detection_scheme, &info)) {
+    return -1;
+  }
+
+  std::vector<VmemWord> words;
+  if (!ReadVmem(in_path, &words)) {
+    return -1;
+  }
+
+  FILE *out = fopen(out_path, "w");
+  if (!out) {
+    std::cerr << "ERROR: mem_bkdr_util_dpi: cannot write " << out_path << "\n";
+    return -1;
+  }
+  uint32_t width = info.data_width + info.parity_width;
+  for (const VmemWord &word : words) {
+    uint64_t data = word.data & Mask(info.data_width);
+    uint64_t ecc = Encode(info, data);
+    if (width > 64) {
+      WriteWord(out, word.addr, data, (uint8_t)ecc, width);
+    } else {
+      WriteWord(out, word.addr, data | (ecc << info.data_width), 0, width);
+    }
+  }
+  fclose(out);
+  return (int)words.size();
+}
+
+// Prepare the vmem file at in_path for a scrambled SRAM, as
+// sram_ctrl_bkdr_util::bkdr_load_from_file does word by word: the image is
+// read as num_words words (missing words are zero), then each word gets its
+// inverted 39/32 integrity bits, is encrypted for its logical word address
+// (addr_offset_words plus its index) and is written at the scrambled address.
+//
+// key and nonce are the 128-bit key and 64-bit nonce given to the SRAM, and
+// addr_width is the width of a word address.
+int mem_bkdr_util_dpi_sram_scramble_vmem(const char *in_path,
+                                         const char *out_path, int num_words,
+                                         int addr_offset_words, int addr_width,
+                                         const svBitVecVal *key,
+                                         const svBitVecVal *nonce) {
+  if (num_words < 0 || addr_width <= 0 || addr_width > 32) {
+    return -1;
+  }
+
+  std::vector<VmemWord> words;
+  if (!ReadVmem(in_path, &words)) {
+    return -1;
+  }
+
+  std::vector<uint64_t> image(num_words, 0);
+  for (const VmemWord &word : words) {
+    if (word.addr < image.size()) {
+      image[word.addr] = word.data;
+    }
+  }
+
+  ScrambleKeySchedule ks(VecBytes(key, 128), VecBytes(nonce, 64), 64);
+
+  FILE *out = fopen(out_path, "w");
+  if (!out) {
+    std::cerr << "ERROR: mem_bkdr_util_dpi: cannot write " << out_path << "\n";
+    return -1;
+  }
+  const SecdedInfo info = {32, 7, enc_secded_inv_39_32};
+  for (uint32_t i = 0; i < image.size(); ++i) {
+    uint32_t addr = (uint32_t)((i + addr_offset_words) & Mask(addr_width));
+    uint64_t data = image[i] & Mask(32);
+    uint64_t integ = data | ((uint64_t)Encode(info, data) << 32);
+    uint64_t scrambled;
+    scramble_encrypt_data(&integ, &scrambled, 39, addr, addr_width, ks,
+                          /*repeat_keystream=*/false);
+    WriteWord(out, scramble_addr(addr, addr_width, ks), scrambled, 0, 39);
+  }
+  fclose(out);
+  return num_words;
+}
+
+}  // extern "C"
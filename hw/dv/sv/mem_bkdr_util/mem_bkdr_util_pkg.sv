@@ -35,6 +35,19 @@ package mem_bkdr_util_pkg;
     ParityOdd
   } err_detection_e;
 
+  // Bulk ECC encoding of a vmem file (see mem_bkdr_util_dpi.cc)
+  import "DPI-C" function int mem_bkdr_util_dpi_ecc_vmem(string in_path, string out_path,
+                                                         int err_detection_scheme);
+
+  // Bulk integrity encoding and scrambling of a vmem file for an SRAM (see mem_bkdr_util_dpi.cc)
+  import "DPI-C" function int mem_bkdr_util_dpi_sram_scramble_vmem(string in_path,
+                                                                   string out_path,
+                                                                   int num_words,
+                                                                   int addr_offset_words,
+                                                                   int addr_width,
+                                                                   bit [127:0] key,
+                                                                   bit [63:0] nonce);
+
   // macro includes
   `include "uvm_macros.svh"
   `include "dv_macros.svh"
@@ -0,0 +1,348 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+// Log database and formatter for sw_logger_if.
+//
+// The databases are the <sw>.logs.txt and <sw>.rodata.txt files generated by
+// util/device_sw_utils/extract_sw_logs.py. Each holds records of
+// "field: value" lines, each record starting with an "addr" field. Log
+// entries are looked up by the address the software writes to the logger and
+// rodata strings by the address passed as a string argument.
+//
+// Format strings have already been converted to SystemVerilog style by the
+// extraction script and are expanded here the way $sformatf would expand them
+// for 32-bit unsigned arguments.
+
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "svdpi.h"
+
+namespace {
+
+struct SwLog {
+  std::string name;
+  int severity;
+  std::string file;
+  int line;
+  int nargs;
+  uint32_t str_arg_idx;
+  std::string format;
+};
+
+struct SwLoggerDb {
+  std::vector<SwLog> logs;
+  // Indices into logs for each log address. There is one entry for each SW
+  // image that has a log at that address.
+  std::unordered_map<uint32_t, std::vector<int>> logs_by_addr;
+  // Rodata strings for each SW image, by address
+  std::unordered_map<std::string, std::map<uint32_t, std::string>> rodata;
+  // Backing store for strings returned to SystemVerilog
+  std::string ret;
+};
+
+typedef std::map<std::string, std::string> Record;
+
+// Read the next record from a database file. Returns false at end of file.
+//
+// Trailing newlines are stripped from each value and any remaining carriage
+// returns (which the extraction script uses to stand in for newlines in
+// strings) are replaced with newlines.
+//
+// pending_addr carries the address of the next record, which is only known
+// once the "addr" line that ends the current record has been read.
+bool ReadRecord(std::istream &in, std::string *pending_addr, Record *record) {
+  record->clear();
+  bool have_addr = !pending_addr->empty();
+  if (have_addr) {
+    (*record)["addr"] = *pending_addr;
+    pending_addr->clear();
+  }
+
+  std::string line;
+  while (std::getline(in, line)) {
+    while (!line.empty() && (line.back() == '\n' || line.back() == '\r')) {
+      line.pop_back();
+    }
+    size_t sep = line.find(": ");
+    if (sep == std::string::npos) {
+      continue;
+    }
+    std::string field = line.substr(0, sep);
+    std::string value = line.substr(sep + 2);
+    if (field == "addr") {
+      if (have_addr) {
+        *pending_addr = value;
+        break;
+      }
+      (*record)["addr"] = value;
+      have_addr = true;
+      continue;
+    }
+    if (!have_addr) {
+      continue;
+    }
+    for (char &c : value) {
+      if (c == '\r') {
+        c = '\n';
+      }
+    }
+    (*record)[field] = value;
+  }
+  return have_addr;
+}
+
+uint32_t ParseStrArgIdx(const std::string &list) {
+  std::istringstream ss(list);
+  uint32_t indices = 0;
+  int idx;
+  while (ss >> idx) {
+    if (idx >= 0 && idx < 32) {
+      indices |= 1u << idx;
+    }
+  }
+  return indices;
+}
+
+// Find the string at addr for sw. The address may point into the middle of a
+// string. Returns the address in hex if there is no string there.
+std::string GetStrAtAddr(const SwLoggerDb &db, const std::string &sw,
+                         uint32_t addr) {
+  auto it = db.rodata.find(sw);
+  if (it != db.rodata.end() && !it->second.empty()) {
+    const std::map<uint32_t, std::string> &strs = it->second;
+    auto str = strs.upper_bound(addr);
+    if (str != strs.begin()) {
+      --str;
+      uint64_t offset = addr - str->first;
+      if (offset < str->second.size()) {
+        return str->second.substr(offset);
+      }
+    }
+  }
+  char buf[16];
+  snprintf(buf, sizeof(buf), "%x", addr);
+  return buf;
+}
+
+// Pad s to width, on the right if left_justify and otherwise on the left
+void AppendPadded(std::string *out, const std::string &s, size_t width,
+                  bool left_justify, char pad) {
+  size_t n = s.size() < width ? width - s.size() : 0;
+  if (!left_justify) {
+    out->append(n, pad);
+  }
+  out->append(s);
+  if (left_justify) {
+    out->append(n, ' ');
+  }
+}
+
+std::string ToBase(uint32_t value, int shift, const char *digits) {
+  std::string s;
+  uint32_t mask = (1u << shift) - 1;
+  do {
+    s.insert(s.begin(), digits[value & mask]);
+    value >>= shift;
+  } while (value);
+  return s;
+}
+
+// Expand the format of log with args as $sformatf would. String arguments are
+// looked up in the rodata of the log's SW image.
+std::string Format(const SwLoggerDb &db, const SwLog &log,
+                   const uint32_t *args, int nargs) {
+  const std::string &fmt = log.format;
+  std::string out;
+  out.reserve(fmt.size() + 16);
+  int arg = 0;
+  for (size_t i = 0; i < fmt.size(); ++i) {
+    if (fmt[i] != '%' || i + 1 == fmt.size()) {
+      out.push_back(fmt[i]);
+      continue;
+    }
+    size_t start = i++;
+    if (fmt[i] == '%') {
+      out.push_back('%');
+      continue;
+    }
+    bool left_justify = fmt[i] == '-';
+    if (left_justify) {
+      ++i;
+    }
+    bool has_width = false;
+    size_t width = 0;
+    while (i < fmt.size() && isdigit((unsigned char)fmt[i])) {
+      has_width = true;
+      width = width * 10 + (fmt[i++] - '0');
+    }
+    if (i == fmt.size()) {
+      out.append(fmt, start, std::string::npos);
+      break;
+    }
+
+    char spec = tolower((unsigned char)fmt[i]);
+    if (!strchr("bcdhos", spec)) {
+      // Not something the extraction script produces; leave it alone.
+      out.append(fmt, start, i + 1 - start);
+      continue;
+    }
+    uint32_t value = arg < nargs ? args[arg] : 0;
+    ++arg;
+    switch (spec) {
+      case 's':
+        // The extraction script marks every %s argument in str_arg_idx, so
+        // the argument is always the address of a string.
+        AppendPadded(&out, GetStrAtAddr(db, log.name, value), width,
+                     left_justify, ' ');
+        break;
+      case 'c':
+        AppendPadded(&out, std::string(1, (char)value), width, left_justify,
+                     ' ');
+        break;
+      case 'd':
+        AppendPadded(&out, std::to_string(value), width, left_justify, ' ');
+        break;
+      case 'h':
+        // Without an explicit width, $sformatf would pad to the width of the
+        // argument. The extraction script always gives one.
+        AppendPadded(&out, ToBase(value, 4, "0123456789abcdef"),
+                     has_width ? width : 8, left_justify, '0');
+        break;
+      case 'o':
+        AppendPadded(&out, ToBase(value, 3, "01234567"), has_width ? width : 11,
+                     left_justify, '0');
+        break;
+      case 'b':
+        AppendPadded(&out, ToBase(value, 1, "01"), has_width ? width : 32,
+                     left_justify, '0');
+        break;
+    }
+  }
+  return out;
+}
+
+}  // namespace
+
+extern "C" {
+
+void *sw_logger_dpi_create() { return new SwLoggerDb(); }
+
+void sw_logger_dpi_free(void *ctx) { delete static_cast<SwLoggerDb *>(ctx); }
+
+// Load the log and rodata databases of the SW image sw_name. Returns the
+// number of log entries loaded, or -1 if the log database can't be read. A
+// missing rodata database is not an error.
+int sw_logger_dpi_load_db(void *ctx, const char *sw_name,
+                          const char *logs_path, const char *rodata_path) {
+  SwLoggerDb *db = static_cast<SwLoggerDb *>(ctx);
+  std::ifstream logs(logs_path);
+  if (!logs) {
+    return -1;
+  }
+
+  std::string pending;
+  Record rec;
+  int count = 0;
+  while (ReadRecord(logs, &pending, &rec)) {
+    SwLog log;
+    log.name = sw_name;
+    log.severity = atoi(rec["severity"].c_str());
+    log.file = rec["file"];
+    log.line = atoi(rec["line"].c_str());
+    log.nargs = atoi(rec["nargs"].c_str());
+    log.str_arg_idx = ParseStrArgIdx(rec["str_arg_idx"]);
+    log.format = rec["format"];
+    uint32_t addr = (uint32_t)strtoul(rec["addr"].c_str(), nullptr, 16);
+
+    std::vector<int> &entries = db->logs_by_addr[addr];
+    bool replaced = false;
+    for (int idx : entries) {
+      if (db->logs[idx].name == log.name) {
+        std::cerr << "WARNING: sw_logger_dpi: " << sw_name
+                  << ": log entry for addr " << std::hex << addr << std::dec
+                  << " already exists, replacing it\n";
+        db->logs[idx] = log;
+        replaced = true;
+      }
+    }
+    if (!replaced) {
+      entries.push_back((int)db->logs.size());
+      db->logs.push_back(log);
+    }
+    ++count;
+  }
+
+  std::ifstream rodata(rodata_path);
+  if (rodata) {
+    std::map<uint32_t, std::string> &strs = db->rodata[sw_name];
+    pending.clear();
+    while (ReadRecord(rodata, &pending, &rec)) {
+      uint32_t addr = (uint32_t)strtoul(rec["addr"].c_str(), nullptr, 16);
+      strs[addr] = rec["string"];
+    }
+  }
+  return count;
+}
+
+// Get the n'th log entry (counting from 0) written to addr. Returns a handle
+// for the entry, or -1 if there is no such entry.
+int sw_logger_dpi_find(void *ctx, uint32_t addr, int n) {
+  SwLoggerDb *db = static_cast<SwLoggerDb *>(ctx);
+  auto it = db->logs_by_addr.find(addr);
+  if (it == db->logs_by_addr.end() || n < 0 ||
+      n >= (int)it->second.size()) {
+    return -1;
+  }
+  return it->second[n];
+}
+
+// Get the fields of the log entry id
+void sw_logger_dpi_get_log(void *ctx, int id, const char **name, int *severity,
+                           const char **file, int *line, int *nargs,
+                           uint32_t *str_arg_idx, const char **format) {
+  const SwLog &log = static_cast<SwLoggerDb *>(ctx)->logs.at(id);
+  *name = log.name.c_str();
+  *severity = log.severity;
+  *file = log.file.c_str();
+  *line = log.line;
+  *nargs = log.nargs;
+  *str_arg_idx = log.str_arg_idx;
+  *format = log.format.c_str();
+}
+
+// Get the string at addr in the rodata of the SW image of log entry id
+const char *sw_logger_dpi_get_str(void *ctx, int id, uint32_t addr) {
+  SwLoggerDb *db = static_cast<SwLoggerDb *>(ctx);
+  db->ret = GetStrAtAddr(*db, db->logs.at(id).name, addr);
+  return db->ret.c_str();
+}
+
+// Format log entry id with the arguments in args (an open array of int
+// unsigned). The result is valid until the next call into this file.
+const char *sw_logger_dpi_format(void *ctx, int id,
+                                 const svOpenArrayHandle args) {
+  SwLoggerDb *db = static_cast<SwLoggerDb *>(ctx);
+  int nargs = svSize(args, 1);
+  std::vector<uint32_t> words(nargs);
+  for (int i = 0; i < nargs; ++i) {
+    words[i] = *static_cast<const uint32_t *>(
+        svGetArrElemPtr1(args, svLow(args, 1) + i));
+  }
+  db->ret = Format(*db, db->logs.at(id), words.data(), nargs);
+  return db->ret.c_str();
+}
+
+}  // extern "C"
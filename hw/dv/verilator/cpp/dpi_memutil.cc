@@ -4,13 +4,18 @@
 
 #include "dpi_memutil.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cstring>
+#include <exception>
 #include <fcntl.h>
+#include <functional>
 #include <iostream>
 #include <libelf.h>
 #include <sstream>
 #include <sys/stat.h>
+#include <thread>
 #include <unistd.h>
 #include <vector>
 
@@ -37,8 +42,11 @@ class ElfFile {
  public:
   ElfFile(const std::string &path) : path_(path) {
     (void)elf_errno();
-    if (elf_version(EV_CURRENT) == EV_NONE) {
-      throw std::runtime_error(elf_errmsg(-1));
+    // Files might be opened from several threads at once (see
+    // DpiMemUtil::LoadImages), so only set the libelf version once.
+    static const bool version_ok = elf_version(EV_CURRENT) != EV_NONE;
+    if (!version_ok) {
+      throw std::runtime_error("Unsupported libelf version.");
     }
 
     fd_ = open(path.c_str(), O_RDONLY, 0);
@@ -46,7 +54,10 @@ class ElfFile {
       throw ElfError(path, "could not open file.");
     }
 
-    ptr_ = elf_begin(fd_, ELF_C_READ, NULL);
+    // Ask libelf to map the file, rather than reading it into a buffer. The
+    // segment data returned by elf_rawfile then points straight into the
+    // mapping.
+    ptr_ = elf_begin(fd_, ELF_C_READ_MMAP, NULL);
     if (!ptr_) {
       close(fd_);
       throw ElfError(path, elf_errmsg(-1));
@@ -185,7 +196,10 @@ static std::vector<uint8_t> FlattenElfFile(const std::string &filepath) {
   const char *file_data = elf_rawfile(elf.ptr_, &file_size);
   assert(file_data);
 
-  StagedMem ret;
+  // Copy each segment straight from the file into its place in the result.
+  // Where segments overlap, later ones overwrite earlier ones (as they would
+  // if they were merged in a StagedMem).
+  std::vector<uint8_t> ret((size_t)1 + (high - low), 0);
 
   for (size_t i = 0; i < phnum; i++) {
     const Elf32_Phdr &phdr = phdrs[i];
@@ -207,12 +221,46 @@ static std::vector<uint8_t> FlattenElfFile(const std::string &filepath) {
       continue;
 
     uint32_t off = phdr.p_paddr - low;
-    std::vector<uint8_t> seg(phdr.p_filesz, 0);
-    memcpy(&seg[0], file_data + phdr.p_offset, phdr.p_filesz);
-    ret.AddSegment(off, std::move(seg));
+    memcpy(&ret[off], file_data + phdr.p_offset, phdr.p_filesz);
   }
 
-  return ret.GetFlat();
+  return ret;
+}
+
+// Run fn(i) for each i in [0, n), using up to max_threads threads (including
+// the calling thread). Any exception thrown by fn is re-thrown on the calling
+// thread once all workers have finished. If several calls throw, the exception
+// thrown for the smallest i wins.
+static void ParallelForEach(size_t n, unsigned max_threads,
+                            const std::function<void(size_t)> &fn) {
+  unsigned hw_threads = std::max(1u, std::thread::hardware_concurrency());
+  size_t num_threads = std::min({(size_t)max_threads, (size_t)hw_threads, n});
+
+  std::vector<std::exception_ptr> errors(n);
+  std::atomic<size_t> next_idx(0);
+  auto worker = [&]() {
+    for (size_t i = next_idx++; i < n; i = next_idx++) {
+      try {
+        fn(i);
+      } catch (...) {
+        errors[i] = std::current_exception();
+      }
+    }
+  };
+
+  std::vector<std::thread> workers;
+  for (size_t t = 1; t < num_threads; ++t) {
+    workers.emplace_back(worker);
+  }
+  worker();
+  for (std::thread &thread : workers) {
+    thread.join();
+  }
+
+  for (const std::exception_ptr &error : errors) {
+    if (error)
+      std::rethrow_exception(error);
+  }
 }
 
 // Merge seg0 and seg1, overwriting any overlapping data in seg0 with
@@ -382,39 +430,14 @@ void DpiMemUtil::LoadFileToNamedMem(bool verbose, const std::string &name,
   assert(type != kMemImageUnknown);
 
   // Search for corresponding registered memory based on the name
-  auto it = name_to_mem_.find(name);
-  if (it == name_to_mem_.end()) {
-    std::ostringstream oss;
-    oss << "`" << name
-        << ("' is not the name of a known memory region. "
-            "Run with --meminit=list to get a list.");
-    throw std::runtime_error(oss.str());
-  }
+  size_t mem_area_idx = GetRegionByName(name);
 
   if (verbose) {
     std::cout << "Loading data from file `" << filepath << "' into memory `"
               << name << "'." << std::endl;
   }
 
-  const MemArea &m = *mem_areas_[it->second];
-
-  try {
-    switch (type) {
-      case kMemImageElf:
-        m.Write(0, FlattenElfFile(filepath));
-        break;
-      case kMemImageVmem:
-        m.LoadVmem(filepath);
-        break;
-      default:
-        assert(0);
-    }
-  } catch (const SVScoped::Error &err) {
-    std::ostringstream oss;
-    oss << "No memory found at `" << err.scope_name_
-        << "' (the scope associated with region `" << name << "').";
-    throw std::runtime_error(oss.str());
-  }
+  LoadFileToMem(mem_area_idx, filepath, type);
 }
 
 void DpiMemUtil::LoadElfToMemories(bool verbose, const std::string &filepath) {
@@ -422,32 +445,84 @@ void DpiMemUtil::LoadElfToMemories(bool verbose, const std::string &filepath) {
   StageElf(verbose, filepath);
 
   for (const auto &pr : staging_area_) {
-    const std::string &mem_name = pr.first;
-    const StagedMem &staged_mem = pr.second;
-
-    auto mem_area_it = name_to_mem_.find(mem_name);
+    auto mem_area_it = name_to_mem_.find(pr.first);
     assert(mem_area_it != name_to_mem_.end());
 
-    const MemArea &mem_area = *mem_areas_[mem_area_it->second];
+    WriteStagedMem(mem_area_it->second, pr.second);
+  }
+}
 
-    for (const auto &seg_pr : staged_mem.GetSegs()) {
-      const AddrRange<uint32_t> &seg_rng = seg_pr.first;
-      const std::vector<uint8_t> &seg_data = seg_pr.second;
+void DpiMemUtil::LoadImages(bool verbose,
+                            const std::vector<MemImageLoad> &loads) {
+  const unsigned kMaxLoadThreads = 8;
+
+  // A load to a single memory area: either a file of the given type (if
+  // staged is null) or the part of an ELF file that was staged for the area.
+  struct AreaLoad {
+    const std::string *filepath;
+    MemImageType type;
+    const StagedMem *staged;
+  };
+
+  // The loads for each memory area, in order. ELF files that are loaded by LMA
+  // are staged here, on the calling thread, because StageElf calls the
+  // OnElfLoaded hook. Each staging area is kept in staged_elfs until the
+  // writes are done.
+  std::vector<std::vector<AreaLoad>> area_loads(mem_areas_.size());
+  std::vector<std::map<std::string, StagedMem>> staged_elfs;
+  staged_elfs.reserve(loads.size());
+
+  for (const MemImageLoad &load : loads) {
+    if (!load.name.empty()) {
+      MemImageType type = load.type;
+      if (type == kMemImageUnknown) {
+        type = DetectMemImageType(load.filepath);
+      }
+      size_t mem_area_idx = GetRegionByName(load.name);
 
-      assert(seg_rng.lo % mem_area.GetWidthByte() == 0);
-      uint32_t lo_word = seg_rng.lo / mem_area.GetWidthByte();
+      if (verbose) {
+        std::cout << "Loading data from file `" << load.filepath
+                  << "' into memory `" << load.name << "'." << std::endl;
+      }
 
-      try {
-        mem_area.Write(lo_word, seg_data);
-      } catch (const SVScoped::Error &err) {
-        std::ostringstream oss;
-        oss << "No memory found at `" << err.scope_name_
-            << "' (the scope associated with region `" << mem_name
-            << "', used by a segment that starts at LMA 0x" << std::hex
-            << base_addrs_[mem_area_it->second] + seg_rng.lo << ").";
-        throw std::runtime_error(oss.str());
+      area_loads[mem_area_idx].push_back({&load.filepath, type, nullptr});
+      continue;
+    }
+
+    assert(load.type == kMemImageElf);
+    StageElf(verbose, load.filepath);
+    staged_elfs.push_back(std::move(staging_area_));
+    staging_area_.clear();
+
+    for (const auto &pr : staged_elfs.back()) {
+      area_loads[GetRegionByName(pr.first)].push_back(
+          {&load.filepath, kMemImageElf, &pr.second});
+    }
+  }
+
+  std::vector<size_t> used_areas;
+  for (size_t i = 0; i < area_loads.size(); ++i) {
+    if (!area_loads[i].empty())
+      used_areas.push_back(i);
+  }
+
+  auto load_area = [&](size_t mem_area_idx) {
+    for (const AreaLoad &area_load : area_loads[mem_area_idx]) {
+      if (area_load.staged) {
+        WriteStagedMem(mem_area_idx, *area_load.staged);
+      } else {
+        LoadFileToMem(mem_area_idx, *area_load.filepath, area_load.type);
       }
     }
+  };
+
+  ParallelForEach(used_areas.size(), kMaxLoadThreads,
+                  [&](size_t i) { load_area(used_areas[i]); });
+
+  // Leave the staging area as LoadElfToMemories would have done for the last
+  // ELF file that was loaded by LMA.
+  if (!staged_elfs.empty()) {
+    staging_area_ = std::move(staged_elfs.back());
   }
 }
 
@@ -455,6 +530,11 @@ void DpiMemUtil::StageElf(bool verbose, const std::string &path) {
   // Clear out anything that was in the staging area before
   staging_area_.clear();
 
+  // Memories are normally all registered before the first load, so compact
+  // the address map for the segment lookups below. This is undone if another
+  // memory gets registered later.
+  addr_to_mem_.Freeze();
+
   ElfFile elf(path);
 
   // Allow subclasses to get at the loaded ELF data if they need it
@@ -516,9 +596,10 @@ void DpiMemUtil::StageElf(bool verbose, const std::string &path) {
     // there isn't one, make a new empty one.
     StagedMem &staged_mem = staging_area_[name];
 
-    const char *seg_data = file_data + phdr.p_offset;
-    std::vector<uint8_t> vec(phdr.p_filesz, 0);
-    memcpy(&vec[0], seg_data, phdr.p_filesz);
+    // Copy the segment directly from the mapped file
+    const uint8_t *seg_data =
+        reinterpret_cast<const uint8_t *>(file_data) + phdr.p_offset;
+    std::vector<uint8_t> vec(seg_data, seg_data + phdr.p_filesz);
 
     staged_mem.AddSegment(local_base, std::move(vec));
   }
@@ -571,3 +652,84 @@ size_t DpiMemUtil::GetRegionForSegment(const std::string &path, int seg_idx,
 
   return mem_area_it->second;
 }
+
+size_t DpiMemUtil::GetRegionByName(const std::string &name) const {
+  auto it = name_to_mem_.find(name);
+  if (it == name_to_mem_.end()) {
+    std::ostringstream oss;
+    oss << "`" << name
+        << ("' is not the name of a known memory region. "
+            "Run with --meminit=list to get a list.");
+    throw std::runtime_error(oss.str());
+  }
+  return it->second;
+}
+
+void DpiMemUtil::SetImageCacheDir(const std::string &dir) {
+  image_cache_.reset(dir.empty() ? nullptr : new MemImageCache(dir));
+}
+
+void DpiMemUtil::WriteToMem(size_t mem_area_idx, uint32_t word_offset,
+                            const std::vector<uint8_t> &data) const {
+  const MemArea &mem_area = *mem_areas_[mem_area_idx];
+
+  if (!image_cache_) {
+    mem_area.Write(word_offset, data);
+    return;
+  }
+
+  MemArea::PhysBlock block;
+  image_cache_->EncodeWrite(mem_area, word_offset, data, &block);
+  mem_area.WritePhysBlock(block);
+}
+
+void DpiMemUtil::WriteStagedMem(size_t mem_area_idx,
+                                const StagedMem &staged_mem) const {
+  const MemArea &mem_area = *mem_areas_[mem_area_idx];
+
+  for (const auto &seg_pr : staged_mem.GetSegs()) {
+    const AddrRange<uint32_t> &seg_rng = seg_pr.first;
+    const std::vector<uint8_t> &seg_data = seg_pr.second;
+
+    assert(seg_rng.lo % mem_area.GetWidthByte() == 0);
+    uint32_t lo_word = seg_rng.lo / mem_area.GetWidthByte();
+
+    try {
+      WriteToMem(mem_area_idx, lo_word, seg_data);
+    } catch (const SVScoped::Error &err) {
+      std::ostringstream oss;
+      oss << "No memory found at `" << err.scope_name_
+          << "' (the scope associated with region `" << names_[mem_area_idx]
+          << "', used by a segment that starts at LMA 0x" << std::hex
+          << base_addrs_[mem_area_idx] + seg_rng.lo << ").";
+      throw std::runtime_error(oss.str());
+    }
+  }
+}
+
+void DpiMemUtil::LoadFileToMem(size_t mem_area_idx,
+                               const std::string &filepath,
+                               MemImageType type) const {
+  assert(type != kMemImageUnknown);
+
+  const MemArea &m = *mem_areas_[mem_area_idx];
+
+  try {
+    switch (type) {
+      case kMemImageElf:
+        WriteToMem(mem_area_idx, 0, FlattenElfFile(filepath));
+        break;
+      case kMemImageVmem:
+        m.LoadVmem(filepath);
+        break;
+      default:
+        assert(0);
+    }
+  } catch (const SVScoped::Error &err) {
+    std::ostringstream oss;
+    oss << "No memory found at `" << err.scope_name_
+        << "' (the scope associated with region `" << names_[mem_area_idx]
+        << "').";
+    throw std::runtime_error(oss.str());
+  }
+}
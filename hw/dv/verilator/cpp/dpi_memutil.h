@@ -11,6 +11,7 @@
 #include <vector>
 
 #include "mem_area.h"
+#include "mem_image_cache.h"
 #include "ranged_map.h"
 
 // Forward declaration for the Elf type from libelf.
@@ -22,6 +23,16 @@ enum MemImageType {
   kMemImageVmem,
 };
 
+// An instruction to load the file at filepath into the memory called name
+// (see DpiMemUtil::LoadImages). If name is the empty string then type must be
+// kMemImageElf and this is an instruction to load an ELF file, picking
+// memories by LMA.
+struct MemImageLoad {
+  std::string name;
+  std::string filepath;
+  MemImageType type;
+};
+
 // Staged data for a given memory area.
 //
 // This is represented as an ordered list of disjoint segments (as loaded from
@@ -56,8 +67,9 @@ class StagedMem {
  * Provide various memory loading utilities for verilog simulations
  *
  * These utilities require the corresponding DPI functions:
- * simutil_memload()
  * simutil_set_mem()
+ * simutil_fill_mem()
+ * simutil_get_mem()
  * to be defined somewhere as SystemVerilog functions.
  */
 class DpiMemUtil {
@@ -119,6 +131,31 @@ class DpiMemUtil {
    */
   void LoadElfToMemories(bool verbose, const std::string &filepath);
 
+  /**
+   * Perform a list of loads, as if by calling LoadFileToNamedMem or
+   * LoadElfToMemories for each in turn.
+   *
+   * This is meant for loading images before the simulation starts. Loads that
+   * target different memory areas are independent, so this reads files and
+   * writes each memory area from a small pool of worker threads (writes to
+   * any one memory area still happen in the order given).
+   *
+   * The worker threads access the design over DPI, so this must not be called
+   * while the simulator might be evaluating the design on another thread.
+   *
+   * If a load fails, raises a std::exception with information about what
+   * happened. Loads to other memory areas might have happened anyway.
+   */
+  void LoadImages(bool verbose, const std::vector<MemImageLoad> &loads);
+
+  /**
+   * Use a cache of encoded memory images in the directory dir for future ELF
+   * loads (see MemImageCache). If dir is empty, stop using a cache.
+   *
+   * If the directory can't be created, raises a std::runtime_error.
+   */
+  void SetImageCacheDir(const std::string &dir);
+
   /**
    * Load an ELF file into a staging area in this object, which can then be
    * accessed with GetMemoryData().
@@ -159,12 +196,39 @@ class DpiMemUtil {
   std::map<std::string, StagedMem> staging_area_;
   const StagedMem empty_;
 
+  // If not null, a cache of encoded images (see SetImageCacheDir)
+  std::unique_ptr<MemImageCache> image_cache_;
+
   /**
    * Find the index of a memory area containing the given segment's addresses.
    * Raises a std::exception if none is found.
    */
   size_t GetRegionForSegment(const std::string &path, int seg_idx, uint32_t lma,
                              uint32_t mem_sz) const;
+
+  /**
+   * Find the index of the memory area called name. Raises a std::exception if
+   * there isn't one.
+   */
+  size_t GetRegionByName(const std::string &name) const;
+
+  /**
+   * Write data to the memory area at mem_area_idx, starting at word_offset.
+   * This goes through image_cache_ if there is one.
+   */
+  void WriteToMem(size_t mem_area_idx, uint32_t word_offset,
+                  const std::vector<uint8_t> &data) const;
+
+  /**
+   * Write the segments in staged_mem to the memory area at mem_area_idx.
+   */
+  void WriteStagedMem(size_t mem_area_idx, const StagedMem &staged_mem) const;
+
+  /**
+   * Load the file at filepath into the memory area at mem_area_idx
+   */
+  void LoadFileToMem(size_t mem_area_idx, const std::string &filepath,
+                     MemImageType type) const;
 };
 
 #endif  // OPENTITAN_HW_DV_VERILATOR_CPP_DPI_MEMUTIL_H_
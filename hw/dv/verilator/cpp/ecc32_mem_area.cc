@@ -25,54 +25,90 @@ Ecc32MemArea::Ecc32MemArea(const std::string &scope, uint32_t size,
   assert(phy_width_bits <= SV_MEM_WIDTH_BITS);
 }
 
-void Ecc32MemArea::LoadVmem(const std::string &path) const {
-  throw std::runtime_error(
-      "vmem files are not supported for memories with ECC bits");
+std::vector<uint8_t> Ecc32MemArea::GetEncodingTag() const {
+  static const char tag[] = "ecc32";
+  return std::vector<uint8_t>(tag, tag + sizeof(tag) - 1);
 }
 
 Ecc32MemArea::EccWords Ecc32MemArea::ReadWithIntegrity(
     uint32_t word_offset, uint32_t num_words) const {
   assert(word_offset + num_words <= num_words_);
 
-  // See MemArea::Write for an explanation for this buffer.
-  uint8_t minibuf[SV_MEM_WIDTH_BYTES];
-  memset(minibuf, 0, sizeof minibuf);
-  assert(width_byte_ <= sizeof minibuf);
+  std::vector<uint32_t> phys_addrs(num_words);
+  for (uint32_t i = 0; i < num_words; ++i) {
+    phys_addrs[i] = ToPhysAddr(word_offset + i);
+  }
+
+  // See MemArea::EncodeWrite for an explanation of the layout of this buffer.
+  std::vector<uint8_t> phys_bufs;
+  ReadPhysWords(phys_bufs, phys_addrs);
 
   EccWords ret;
   ret.reserve(num_words);
 
   for (uint32_t i = 0; i < num_words; ++i) {
-    uint32_t src_word = word_offset + i;
-    uint32_t phys_addr = ToPhysAddr(src_word);
-
-    ReadToMinibuf(minibuf, phys_addr);
-    ReadBufferWithIntegrity(ret, minibuf, src_word);
+    ReadBufferWithIntegrity(ret, &phys_bufs[(size_t)i * SV_MEM_WIDTH_BYTES],
+                            word_offset + i);
   }
 
   return ret;
 }
 
+void Ecc32MemArea::EncodeWrite(uint32_t word_offset,
+                               const std::vector<uint8_t> &data,
+                               PhysBlock *block) const {
+  assert(block);
+  uint32_t width_32 = width_byte_ / 4;
+  uint32_t data_words = (data.size() + width_byte_ - 1) / width_byte_;
+  assert(word_offset + data_words <= num_words_);
+
+  // Zero-extend a partial last word, so that every word can be encoded from
+  // src directly.
+  const std::vector<uint8_t> *src = &data;
+  std::vector<uint8_t> padded;
+  if (data.size() % width_byte_) {
+    padded = data;
+    padded.resize((size_t)data_words * width_byte_, 0);
+    src = &padded;
+  }
+
+  std::vector<uint8_t> check_bits((size_t)data_words * width_32);
+  enc_secded_inv_39_32_buf(src->data(), check_bits.size(), check_bits.data());
+
+  // See MemArea::EncodeWrite for an explanation of the layout of this buffer.
+  block->word_offset = word_offset;
+  block->phys_bufs.assign((size_t)data_words * SV_MEM_WIDTH_BYTES, 0);
+  block->phys_addrs.resize(data_words);
+
+  for (uint32_t i = 0; i < data_words; ++i) {
+    block->phys_addrs[i] = ToPhysAddr(word_offset + i);
+    InsertWords(&block->phys_bufs[(size_t)i * SV_MEM_WIDTH_BYTES],
+                &(*src)[(size_t)i * width_byte_],
+                &check_bits[(size_t)i * width_32]);
+  }
+}
+
 void Ecc32MemArea::WriteWithIntegrity(uint32_t word_offset,
                                       const EccWords &data) const {
-  // See MemArea::Write for an explanation for this buffer.
-  uint8_t minibuf[SV_MEM_WIDTH_BYTES];
-  memset(minibuf, 0, sizeof minibuf);
-  assert(width_byte_ <= sizeof minibuf);
-
   uint32_t width_32 = width_byte_ / 4;
   uint32_t to_write = data.size() / width_32;
 
   assert((data.size() % width_32) == 0);
   assert(word_offset + to_write <= num_words_);
 
+  // See MemArea::EncodeWrite for an explanation of the layout of this buffer.
+  std::vector<uint8_t> phys_bufs((size_t)to_write * SV_MEM_WIDTH_BYTES, 0);
+  std::vector<uint32_t> phys_addrs(to_write);
+
   for (uint32_t i = 0; i < to_write; ++i) {
     uint32_t dst_word = word_offset + i;
-    uint32_t phys_addr = ToPhysAddr(dst_word);
+    phys_addrs[i] = ToPhysAddr(dst_word);
 
-    WriteBufferWithIntegrity(minibuf, data, i * width_32, dst_word);
-    WriteFromMinibuf(phys_addr, minibuf, dst_word);
+    WriteBufferWithIntegrity(&phys_bufs[(size_t)i * SV_MEM_WIDTH_BYTES], data,
+                             i * width_32, dst_word);
   }
+
+  WritePhysWords(phys_addrs, phys_bufs, word_offset);
 }
 
 // Zero enough of the buffer to fill it with a word using insert_bits
@@ -157,10 +193,17 @@ static uint8_t extract_bits(const uint8_t *buf, unsigned bit_idx,
 void Ecc32MemArea::WriteBuffer(uint8_t buf[SV_MEM_WIDTH_BYTES],
                                const std::vector<uint8_t> &data,
                                size_t start_idx, uint32_t dst_word) const {
+  uint8_t check_bits[SV_MEM_WIDTH_BITS / 39];
+  enc_secded_inv_39_32_buf(&data[start_idx], width_byte_ / 4, check_bits);
+  InsertWords(buf, &data[start_idx], check_bits);
+}
+
+void Ecc32MemArea::InsertWords(uint8_t buf[SV_MEM_WIDTH_BYTES],
+                               const uint8_t *src,
+                               const uint8_t *check_bits) const {
   zero_buffer(buf, width_byte_);
   for (uint32_t i = 0; i < width_byte_ / 4; ++i) {
-    const uint8_t *src_data = &data[start_idx + 4 * i];
-    insert_word(buf, 39 * i, src_data, enc_secded_inv_39_32(src_data));
+    insert_word(buf, 39 * i, src + 4 * i, check_bits[i]);
   }
 }
 
@@ -22,7 +22,15 @@ class Ecc32MemArea : public MemArea {
    */
   Ecc32MemArea(const std::string &scope, uint32_t size, uint32_t width_32);
 
-  void LoadVmem(const std::string &path) const override;
+  uint32_t GetPhysWidth() const override { return 39 * (width_byte_ / 4); }
+
+  std::vector<uint8_t> GetEncodingTag() const override;
+
+  /** As MemArea::EncodeWrite, but computing the check bits for the whole of
+   * data in one go.
+   */
+  void EncodeWrite(uint32_t word_offset, const std::vector<uint8_t> &data,
+                   PhysBlock *block) const override;
 
   typedef std::pair<bool, uint32_t> EccWord;
   typedef std::vector<EccWord> EccWords;
@@ -38,7 +46,8 @@ class Ecc32MemArea : public MemArea {
    *
    * @param num_words   The number of words to read.
    */
-  EccWords ReadWithIntegrity(uint32_t word_offset, uint32_t num_words) const;
+  virtual EccWords ReadWithIntegrity(uint32_t word_offset,
+                                     uint32_t num_words) const;
 
   /** Write data with validity bits, starting at the given offset
    *
@@ -51,7 +60,8 @@ class Ecc32MemArea : public MemArea {
    *
    * @param data        The data that should be written.
    */
-  void WriteWithIntegrity(uint32_t word_offset, const EccWords &data) const;
+  virtual void WriteWithIntegrity(uint32_t word_offset,
+                                  const EccWords &data) const;
 
  protected:
   void WriteBuffer(uint8_t buf[SV_MEM_WIDTH_BYTES],
@@ -62,6 +72,18 @@ class Ecc32MemArea : public MemArea {
                   const uint8_t buf[SV_MEM_WIDTH_BYTES],
                   uint32_t src_word) const override;
 
+  /** Insert a memory word into buf from its 32-bit words, with check bits
+   * that have already been computed.
+   *
+   * @param buf        Destination buffer (physical memory bits)
+   *
+   * @param src        The width_byte_ bytes of logical data for the word
+   *
+   * @param check_bits The check bits for each 32-bit word in src
+   */
+  void InsertWords(uint8_t buf[SV_MEM_WIDTH_BYTES], const uint8_t *src,
+                   const uint8_t *check_bits) const;
+
   /** Extract the logical words corresponding to the physical memory contents
    * in \p buf, together with validity bits. Append them to \p data.
    *
@@ -0,0 +1,84 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "elf_symbol_memutil.h"
+
+#include <cassert>
+#include <cstring>
+#include <gelf.h>
+#include <libelf.h>
+#include <sstream>
+
+bool ElfSymbolMemUtil::GetSymbolAtOrBelow(uint32_t addr, std::string *name,
+                                          uint32_t *offset) const {
+  auto it = symbols_.upper_bound(addr);
+  if (it == symbols_.begin())
+    return false;
+
+  --it;
+  *name = it->second.first;
+  *offset = addr - it->first;
+  return true;
+}
+
+std::string ElfSymbolMemUtil::FormatAddr(uint32_t addr) const {
+  std::string name;
+  uint32_t offset;
+  std::ostringstream oss;
+  if (!GetSymbolAtOrBelow(addr, &name, &offset)) {
+    oss << "0x" << std::hex << addr;
+    return oss.str();
+  }
+
+  oss << name;
+  if (offset) {
+    oss << "+0x" << std::hex << offset;
+  }
+  return oss.str();
+}
+
+void ElfSymbolMemUtil::OnElfLoaded(Elf *elf_file) {
+  assert(elf_file);
+
+  Elf_Scn *scn = nullptr;
+  while ((scn = elf_nextscn(elf_file, scn))) {
+    Elf32_Shdr *shdr = elf32_getshdr(scn);
+    assert(shdr);
+    if (shdr->sh_type != SHT_SYMTAB)
+      continue;
+
+    Elf_Data *sec_data = elf_getdata(scn, nullptr);
+    assert(sec_data);
+
+    int num_syms = shdr->sh_size / shdr->sh_entsize;
+    for (int i = 0; i < num_syms; ++i) {
+      GElf_Sym sym;
+      gelf_getsym(sec_data, i, &sym);
+
+      int sym_type = GELF_ST_TYPE(sym.st_info);
+      if ((sym_type != STT_FUNC && sym_type != STT_NOTYPE) ||
+          sym.st_shndx == SHN_UNDEF || sym.st_shndx >= SHN_LORESERVE)
+        continue;
+
+      // Skip compiler-generated local labels and mapping symbols
+      const char *sym_name = elf_strptr(elf_file, shdr->sh_link, sym.st_name);
+      if (!sym_name || !sym_name[0] || sym_name[0] == '$' ||
+          strncmp(sym_name, ".L", 2) == 0)
+        continue;
+
+      Elf_Scn *sym_scn = elf_getscn(elf_file, sym.st_shndx);
+      Elf32_Shdr *sym_shdr = sym_scn ? elf32_getshdr(sym_scn) : nullptr;
+      if (!sym_shdr || !(sym_shdr->sh_flags & SHF_EXECINSTR))
+        continue;
+
+      bool is_func = sym_type == STT_FUNC;
+      auto ins =
+          symbols_.emplace(sym.st_value, std::make_pair(sym_name, is_func));
+      if (!ins.second && is_func && !ins.first->second.second) {
+        ins.first->second = std::make_pair(sym_name, is_func);
+      }
+    }
+    break;
+  }
+}
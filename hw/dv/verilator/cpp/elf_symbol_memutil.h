@@ -0,0 +1,38 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+#ifndef OPENTITAN_HW_DV_VERILATOR_CPP_ELF_SYMBOL_MEMUTIL_H_
+#define OPENTITAN_HW_DV_VERILATOR_CPP_ELF_SYMBOL_MEMUTIL_H_
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+
+#include "dpi_memutil.h"
+
+// A DpiMemUtil that also collects the code symbols of every ELF file it
+// loads, so that addresses can be turned back into function names. Symbols
+// from all loaded files (e.g. the ROM and a flash image) are kept together.
+class ElfSymbolMemUtil : public DpiMemUtil {
+ public:
+  // Find the code symbol with the largest address that is at most addr.
+  // Writes its name and the offset of addr from it and returns true, or
+  // returns false if there is no such symbol.
+  bool GetSymbolAtOrBelow(uint32_t addr, std::string *name,
+                          uint32_t *offset) const;
+
+  // Format addr as "symbol+0xoffset" (or just "symbol" at offset 0), falling
+  // back to the hex address if there is no symbol at or below it.
+  std::string FormatAddr(uint32_t addr) const;
+
+ protected:
+  void OnElfLoaded(Elf *elf_file) override;
+
+ private:
+  // Code symbols by address. The flag is true for STT_FUNC symbols, which are
+  // preferred over untyped labels at the same address.
+  std::map<uint32_t, std::pair<std::string, bool>> symbols_;
+};
+
+#endif  // OPENTITAN_HW_DV_VERILATOR_CPP_ELF_SYMBOL_MEMUTIL_H_
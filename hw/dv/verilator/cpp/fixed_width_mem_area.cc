@@ -0,0 +1,36 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "fixed_width_mem_area.h"
+
+std::unique_ptr<MemArea> MakeMemArea(const std::string &scope,
+                                     uint32_t num_words, uint32_t width_byte) {
+  switch (width_byte) {
+    case 4:
+      return std::unique_ptr<MemArea>(
+          new FixedWidthMemArea<32>(scope, num_words));
+    case 8:
+      return std::unique_ptr<MemArea>(
+          new FixedWidthMemArea<64>(scope, num_words));
+    default:
+      return std::unique_ptr<MemArea>(
+          new MemArea(scope, num_words, width_byte));
+  }
+}
+
+std::unique_ptr<Ecc32MemArea> MakeEcc32MemArea(const std::string &scope,
+                                               uint32_t num_words,
+                                               uint32_t width_32) {
+  switch (width_32) {
+    case 1:
+      return std::unique_ptr<Ecc32MemArea>(
+          new FixedWidthMemArea<32, true>(scope, num_words));
+    case 2:
+      return std::unique_ptr<Ecc32MemArea>(
+          new FixedWidthMemArea<64, true>(scope, num_words));
+    default:
+      return std::unique_ptr<Ecc32MemArea>(
+          new Ecc32MemArea(scope, num_words, width_32));
+  }
+}
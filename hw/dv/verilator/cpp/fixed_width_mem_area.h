@@ -0,0 +1,328 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef OPENTITAN_HW_DV_VERILATOR_CPP_FIXED_WIDTH_MEM_AREA_H_
+#define OPENTITAN_HW_DV_VERILATOR_CPP_FIXED_WIDTH_MEM_AREA_H_
+
+#include <cassert>
+#include <cstring>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+
+#include "ecc32_mem_area.h"
+#include "mem_area.h"
+#include "secded_enc.h"
+#include "sv_scoped.h"
+
+// DPI exports, defined in prim_util_memload.svh
+extern "C" {
+int simutil_set_mem(int index, const svBitVecVal *val);
+int simutil_get_mem(int index, svBitVecVal *val);
+}
+
+/**
+ * The physical encoding of a memory word whose width is known at compile time
+ *
+ * A word is WidthBits bits of logical data. Without ECC, it is stored as is.
+ * With ECC, each 32-bit chunk is stored as 39 bits (as for Ecc32MemArea).
+ */
+template <uint32_t WidthBits, bool Ecc>
+struct FixedWidthCodec {
+  static_assert(WidthBits > 0 && WidthBits % (Ecc ? 32 : 8) == 0,
+                "Memory width must be a whole number of bytes (or 32-bit "
+                "words, with ECC)");
+
+  static const uint32_t kWidthByte = WidthBits / 8;
+  static const uint32_t kPhysBits = Ecc ? 39 * (WidthBits / 32) : WidthBits;
+  static const uint32_t kPhysBytes = (kPhysBits + 7) / 8;
+
+  static_assert(kPhysBits <= SV_MEM_WIDTH_BITS,
+                "Memory is too wide for prim_util_memload.svh");
+
+  /** Fill the first kPhysBytes of phys with the encoding of kWidthByte bytes
+   * from src. */
+  static void Encode(uint8_t *phys, const uint8_t *src) {
+    if (!Ecc) {
+      memcpy(phys, src, kWidthByte);
+      return;
+    }
+    uint8_t check_bits[WidthBits / 32];
+    enc_secded_inv_39_32_buf(src, WidthBits / 32, check_bits);
+    memset(phys, 0, kPhysBytes);
+    for (uint32_t i = 0; i < WidthBits / 32; ++i) {
+      uint64_t word = 0;
+      memcpy(&word, src + 4 * i, 4);
+      PutWord39(phys, 39 * i, word | (uint64_t)check_bits[i] << 32);
+    }
+  }
+
+  /** As Encode(), but taking 32-bit words with validity bits (ECC only). The
+   * check bits of a word that isn't valid are inverted. */
+  static void EncodeWithIntegrity(uint8_t *phys,
+                                  const Ecc32MemArea::EccWord *src) {
+    memset(phys, 0, kPhysBytes);
+    for (uint32_t i = 0; i < WidthBits / 32; ++i) {
+      uint8_t bytes[4];
+      memcpy(bytes, &src[i].second, 4);
+      uint8_t check_bits = enc_secded_inv_39_32(bytes);
+      if (!src[i].first)
+        check_bits ^= 0x7f;
+      PutWord39(phys, 39 * i, src[i].second | (uint64_t)check_bits << 32);
+    }
+  }
+
+  /** Extract kWidthByte bytes of logical data from phys into dst. */
+  static void Decode(uint8_t *dst, const uint8_t *phys) {
+    if (!Ecc) {
+      memcpy(dst, phys, kWidthByte);
+      return;
+    }
+    for (uint32_t i = 0; i < WidthBits / 32; ++i) {
+      uint32_t data = (uint32_t)GetWord39(phys, 39 * i);
+      memcpy(dst + 4 * i, &data, 4);
+    }
+  }
+
+  /** Extract the 32-bit words in phys, with their validity (ECC only). */
+  static void DecodeWithIntegrity(Ecc32MemArea::EccWord *dst,
+                                  const uint8_t *phys) {
+    for (uint32_t i = 0; i < WidthBits / 32; ++i) {
+      uint64_t word = GetWord39(phys, 39 * i);
+      uint8_t bytes[4];
+      memcpy(bytes, &word, 4);
+      bool good = (word >> 32) == enc_secded_inv_39_32(bytes);
+      dst[i] = std::make_pair(good, (uint32_t)word);
+    }
+  }
+
+ private:
+  // The 39-bit chunks are packed little-endian, so chunk i occupies bits
+  // [39 * i, 39 * i + 39) of phys. These assume a little-endian host, as does
+  // the rest of the memory utility code.
+  static void PutWord39(uint8_t *phys, uint32_t bit_idx, uint64_t word) {
+    uint64_t shifted = word << (bit_idx % 8);
+    uint32_t num_bytes = (bit_idx % 8 + 39 + 7) / 8;
+    for (uint32_t j = 0; j < num_bytes; ++j) {
+      phys[bit_idx / 8 + j] |= (uint8_t)(shifted >> (8 * j));
+    }
+  }
+
+  static uint64_t GetWord39(const uint8_t *phys, uint32_t bit_idx) {
+    uint32_t num_bytes = (bit_idx % 8 + 39 + 7) / 8;
+    uint64_t bits = 0;
+    for (uint32_t j = 0; j < num_bytes; ++j) {
+      bits |= (uint64_t)phys[bit_idx / 8 + j] << (8 * j);
+    }
+    return (bits >> (bit_idx % 8)) & ((UINT64_C(1) << 39) - 1);
+  }
+};
+
+/**
+ * The word loops shared by the FixedWidthMemArea specialisations
+ *
+ * Base is MemArea or Ecc32MemArea. Logical and physical addresses are the
+ * same, so a block of words is a contiguous run of physical words and is
+ * accessed with one scope switch and one DPI call per word. The physical words
+ * pass through a single stack buffer instead of SV_MEM_WIDTH_BYTES per word of
+ * heap, and Codec is inlined into the loops rather than called virtually for
+ * each word.
+ */
+template <typename Base, typename Codec>
+class FixedWidthMemAreaImpl : public Base {
+ public:
+  FixedWidthMemAreaImpl(const std::string &scope, uint32_t num_words,
+                        uint32_t base_width)
+      : Base(scope, num_words, base_width) {}
+
+  void Write(uint32_t word_offset,
+             const std::vector<uint8_t> &data) const override {
+    uint32_t data_words = (data.size() + Codec::kWidthByte - 1) /
+                          Codec::kWidthByte;
+    assert(word_offset + data_words <= this->num_words_);
+    WriteWords(word_offset, data_words, [&](uint32_t i, uint8_t *phys) {
+      EncodeDataWord(phys, data, i);
+    });
+  }
+
+  void EncodeWrite(uint32_t word_offset, const std::vector<uint8_t> &data,
+                   MemArea::PhysBlock *block) const override {
+    assert(block);
+    uint32_t data_words = (data.size() + Codec::kWidthByte - 1) /
+                          Codec::kWidthByte;
+    assert(word_offset + data_words <= this->num_words_);
+
+    block->word_offset = word_offset;
+    block->phys_bufs.assign((size_t)data_words * SV_MEM_WIDTH_BYTES, 0);
+    block->phys_addrs.resize(data_words);
+    for (uint32_t i = 0; i < data_words; ++i) {
+      block->phys_addrs[i] = word_offset + i;
+      EncodeDataWord(&block->phys_bufs[(size_t)i * SV_MEM_WIDTH_BYTES], data,
+                     i);
+    }
+  }
+
+  std::vector<uint8_t> Read(uint32_t word_offset,
+                            uint32_t num_words) const override {
+    assert(word_offset + num_words <= this->num_words_);
+    std::vector<uint8_t> ret((size_t)num_words * Codec::kWidthByte);
+    ReadWords(word_offset, num_words, [&](uint32_t i, const uint8_t *phys) {
+      Codec::Decode(&ret[(size_t)i * Codec::kWidthByte], phys);
+    });
+    return ret;
+  }
+
+ protected:
+  void WriteBuffer(uint8_t buf[SV_MEM_WIDTH_BYTES],
+                   const std::vector<uint8_t> &data, size_t start_idx,
+                   uint32_t dst_word) const override {
+    EncodeDataWord(buf, data, start_idx / Codec::kWidthByte);
+  }
+
+  void ReadBuffer(std::vector<uint8_t> &data,
+                  const uint8_t buf[SV_MEM_WIDTH_BYTES],
+                  uint32_t src_word) const override {
+    size_t pos = data.size();
+    data.resize(pos + Codec::kWidthByte);
+    Codec::Decode(&data[pos], buf);
+  }
+
+  // Encode word i of data into phys, zero-extending a partial last word
+  static void EncodeDataWord(uint8_t *phys, const std::vector<uint8_t> &data,
+                             uint32_t i) {
+    size_t start = (size_t)i * Codec::kWidthByte;
+    if (start + Codec::kWidthByte <= data.size()) {
+      Codec::Encode(phys, &data[start]);
+      return;
+    }
+    uint8_t word[Codec::kWidthByte] = {0};
+    memcpy(word, &data[start], data.size() - start);
+    Codec::Encode(phys, word);
+  }
+
+  // Call fn(i, phys) with the physical contents of each of the num_words
+  // words starting at first_word.
+  template <typename Fn>
+  void ReadWords(uint32_t first_word, uint32_t num_words, Fn fn) const {
+    if (!num_words)
+      return;
+    // simutil_get_mem writes a whole SV_MEM_WIDTH_BITS vector
+    svBitVecVal minibuf[SV_MEM_WIDTH_BYTES / 4] = {0};
+    SVScoped scoped(this->GetSvScope());
+    for (uint32_t i = 0; i < num_words; ++i) {
+      if (!simutil_get_mem(first_word + i, minibuf)) {
+        std::ostringstream oss;
+        oss << "Could not read memory word at physical index 0x" << std::hex
+            << first_word + i << ".";
+        throw std::runtime_error(oss.str());
+      }
+      fn(i, (const uint8_t *)minibuf);
+    }
+  }
+
+  // Write each of the num_words words starting at first_word, after calling
+  // fn(i, phys) to fill in the first Codec::kPhysBytes of its physical
+  // contents.
+  template <typename Fn>
+  void WriteWords(uint32_t first_word, uint32_t num_words, Fn fn) const {
+    if (!num_words)
+      return;
+    // simutil_set_mem may read a whole SV_MEM_WIDTH_BITS vector, so the bits
+    // above the word must be allocated (and are kept zero).
+    svBitVecVal minibuf[SV_MEM_WIDTH_BYTES / 4] = {0};
+    SVScoped scoped(this->GetSvScope());
+    for (uint32_t i = 0; i < num_words; ++i) {
+      fn(i, (uint8_t *)minibuf);
+      if (!simutil_set_mem(first_word + i, minibuf)) {
+        std::ostringstream oss;
+        oss << "Could not set memory at byte offset 0x" << std::hex
+            << (first_word + i) * Codec::kWidthByte << ".";
+        throw std::runtime_error(oss.str());
+      }
+    }
+  }
+};
+
+/**
+ * A memory whose width (and whether it uses 32-bit ECC) is known at compile
+ * time
+ *
+ * This behaves like MemArea (or Ecc32MemArea if Ecc is true) with a width of
+ * WidthBits, but encodes and decodes words with inlined code and right-sized
+ * buffers, which makes repeated small backdoor accesses (such as polling a
+ * status word) much cheaper. It can be used wherever a MemArea is expected.
+ * Scrambled memories are not supported: their cost is dominated by the
+ * scrambling itself (see ScrambledEcc32MemArea).
+ */
+template <uint32_t WidthBits, bool Ecc = false>
+class FixedWidthMemArea final
+    : public FixedWidthMemAreaImpl<MemArea, FixedWidthCodec<WidthBits, false>> {
+ public:
+  typedef FixedWidthCodec<WidthBits, false> Codec;
+
+  /** Create a memory at scope, num_words words long */
+  FixedWidthMemArea(const std::string &scope, uint32_t num_words)
+      : FixedWidthMemAreaImpl<MemArea, Codec>(scope, num_words,
+                                              Codec::kWidthByte) {}
+};
+
+template <uint32_t WidthBits>
+class FixedWidthMemArea<WidthBits, true> final
+    : public FixedWidthMemAreaImpl<Ecc32MemArea,
+                                   FixedWidthCodec<WidthBits, true>> {
+ public:
+  typedef FixedWidthCodec<WidthBits, true> Codec;
+
+  /** Create a memory at scope, num_words words long */
+  FixedWidthMemArea(const std::string &scope, uint32_t num_words)
+      : FixedWidthMemAreaImpl<Ecc32MemArea, Codec>(scope, num_words,
+                                                   WidthBits / 32) {}
+
+  Ecc32MemArea::EccWords ReadWithIntegrity(
+      uint32_t word_offset, uint32_t num_words) const override {
+    assert(word_offset + num_words <= this->num_words_);
+    Ecc32MemArea::EccWords ret((size_t)num_words * (WidthBits / 32));
+    this->ReadWords(word_offset, num_words,
+                    [&](uint32_t i, const uint8_t *phys) {
+                      Codec::DecodeWithIntegrity(
+                          &ret[(size_t)i * (WidthBits / 32)], phys);
+                    });
+    return ret;
+  }
+
+  void WriteWithIntegrity(uint32_t word_offset,
+                          const Ecc32MemArea::EccWords &data) const override {
+    const uint32_t width_32 = WidthBits / 32;
+    assert((data.size() % width_32) == 0);
+    uint32_t to_write = data.size() / width_32;
+    assert(word_offset + to_write <= this->num_words_);
+
+    this->WriteWords(word_offset, to_write, [&](uint32_t i, uint8_t *phys) {
+      Codec::EncodeWithIntegrity(phys, &data[(size_t)i * width_32]);
+    });
+  }
+};
+
+/**
+ * Create a MemArea for a memory at scope that is num_words words long, each
+ * width_byte bytes wide.
+ *
+ * Widths of 32 and 64 bits get a FixedWidthMemArea. Other widths get a
+ * MemArea, which has the same behaviour.
+ */
+std::unique_ptr<MemArea> MakeMemArea(const std::string &scope,
+                                     uint32_t num_words, uint32_t width_byte);
+
+/**
+ * Create an Ecc32MemArea for a memory at scope that is num_words words long,
+ * each with width_32 32-bit chunks.
+ *
+ * Widths of one and two chunks get a FixedWidthMemArea. Other widths get an
+ * Ecc32MemArea, which has the same behaviour.
+ */
+std::unique_ptr<Ecc32MemArea> MakeEcc32MemArea(const std::string &scope,
+                                               uint32_t num_words,
+                                               uint32_t width_32);
+
+#endif  // OPENTITAN_HW_DV_VERILATOR_CPP_FIXED_WIDTH_MEM_AREA_H_
@@ -10,46 +10,92 @@
 #include <sstream>
 
 #include "sv_scoped.h"
+#include "vmem_reader.h"
 
 // DPI exports, defined in prim_util_memload.svh
 extern "C" {
-void simutil_memload(const char *file);
 int simutil_set_mem(int index, const svBitVecVal *val);
+int simutil_fill_mem(int index, int count, const svBitVecVal *val);
 int simutil_get_mem(int index, svBitVecVal *val);
 }
 
 MemArea::MemArea(const std::string &scope, uint32_t num_words,
                  uint32_t width_byte)
-    : scope_(scope), num_words_(num_words), width_byte_(width_byte) {
+    : scope_(scope),
+      num_words_(num_words),
+      width_byte_(width_byte),
+      sv_scope_(nullptr) {
   assert(0 < num_words);
   assert(width_byte <= SV_MEM_WIDTH_BYTES);
 }
 
 void MemArea::Write(uint32_t word_offset,
                     const std::vector<uint8_t> &data) const {
-  // This "mini buffer" is used to transfer each write to SystemVerilog.
-  // `simutil_set_mem` takes a fixed SV_MEM_WIDTH_BITS-bit vector but it will
-  // only use the bits required for the RAM width. As an example, for a 32-bit
-  // wide RAM only elements 3:0 of `minibuf` will be written to memory. Since
-  // the simulator may still read bits from minibuf it does not use, we must
-  // use a fixed allocation of the full bit vector size to avoid an out of
-  // bounds access.
-  uint8_t minibuf[SV_MEM_WIDTH_BYTES];
-  memset(minibuf, 0, sizeof minibuf);
-  assert(width_byte_ <= sizeof minibuf);
+  PhysBlock block;
+  EncodeWrite(word_offset, data, &block);
+  WritePhysBlock(block);
+}
+
+void MemArea::Fill(uint32_t word_offset, uint32_t num_words,
+                   uint8_t value) const {
+  assert(word_offset + num_words <= num_words_);
+  if (num_words == 0)
+    return;
+
+  // Encode a single word. The physical address is the logical one, since this
+  // is only used for memories whose encoding doesn't depend on the address.
+  uint8_t minibuf[SV_MEM_WIDTH_BYTES] = {0};
+  std::vector<uint8_t> word(width_byte_, value);
+  WriteBuffer(minibuf, word, 0, word_offset);
+
+  SVScoped scoped(GetSvScope());
+  if (!simutil_fill_mem(word_offset, num_words,
+                        (const svBitVecVal *)minibuf)) {
+    std::ostringstream oss;
+    oss << "Could not fill memory at byte offset 0x" << std::hex
+        << word_offset * width_byte_ << " (0x" << num_words * width_byte_
+        << " bytes).";
+    throw std::runtime_error(oss.str());
+  }
+}
 
+void MemArea::EncodeWrite(uint32_t word_offset,
+                          const std::vector<uint8_t> &data,
+                          PhysBlock *block) const {
+  assert(block);
   uint32_t data_words = (data.size() + width_byte_ - 1) / width_byte_;
   assert(word_offset + data_words <= num_words_);
 
+  // Build the physical contents of every word before touching the design.
+  // Each word gets its own SV_MEM_WIDTH_BYTES "mini buffer" in phys_bufs:
+  // `simutil_set_mem` takes a fixed SV_MEM_WIDTH_BITS-bit vector but it will
+  // only use the bits required for the RAM width. As an example, for a 32-bit
+  // wide RAM only elements 3:0 of each mini buffer will be written to memory.
+  // Since the simulator may still read bits it does not use, we must use a
+  // fixed allocation of the full bit vector size to avoid an out of bounds
+  // access.
+  block->word_offset = word_offset;
+  block->phys_bufs.assign((size_t)data_words * SV_MEM_WIDTH_BYTES, 0);
+  block->phys_addrs.resize(data_words);
+
   for (uint32_t i = 0; i < data_words; ++i) {
     uint32_t dst_word = word_offset + i;
-    uint32_t phys_addr = ToPhysAddr(dst_word);
+    block->phys_addrs[i] = ToPhysAddr(dst_word);
 
-    WriteBuffer(minibuf, data, i * width_byte_, dst_word);
-    WriteFromMinibuf(phys_addr, minibuf, dst_word);
+    WriteBuffer(&block->phys_bufs[(size_t)i * SV_MEM_WIDTH_BYTES], data,
+                i * width_byte_, dst_word);
   }
 }
 
+void MemArea::WritePhysBlock(const PhysBlock &block) const {
+  WritePhysWords(block.phys_addrs, block.phys_bufs, block.word_offset);
+}
+
+std::vector<uint8_t> MemArea::GetEncodingTag() const {
+  static const char tag[] = "raw";
+  return std::vector<uint8_t>(tag, tag + sizeof(tag) - 1);
+}
+
 std::vector<uint8_t> MemArea::Read(uint32_t word_offset,
                                    uint32_t num_words) const {
   assert(word_offset + num_words <= num_words_);
@@ -57,29 +103,55 @@ std::vector<uint8_t> MemArea::Read(uint32_t word_offset,
   uint32_t num_bytes = width_byte_ * num_words;
   assert(num_words <= num_bytes);
 
-  // See Write for an explanation for this buffer.
-  uint8_t minibuf[SV_MEM_WIDTH_BYTES];
-  memset(minibuf, 0, sizeof minibuf);
-  assert(width_byte_ <= sizeof minibuf);
+  std::vector<uint32_t> phys_addrs(num_words);
+  for (uint32_t i = 0; i < num_words; ++i) {
+    phys_addrs[i] = ToPhysAddr(word_offset + i);
+  }
+
+  // See Write for an explanation of the layout of this buffer.
+  std::vector<uint8_t> phys_bufs;
+  ReadPhysWords(phys_bufs, phys_addrs);
 
   std::vector<uint8_t> ret;
   ret.reserve(num_bytes);
 
   for (uint32_t i = 0; i < num_words; ++i) {
-    uint32_t src_word = word_offset + i;
-    uint32_t phys_addr = ToPhysAddr(src_word);
-
-    ReadToMinibuf(minibuf, phys_addr);
-    ReadBuffer(ret, minibuf, src_word);
+    ReadBuffer(ret, &phys_bufs[(size_t)i * SV_MEM_WIDTH_BYTES],
+               word_offset + i);
   }
 
   return ret;
 }
 
 void MemArea::LoadVmem(const std::string &path) const {
-  SVScoped scoped(scope_.c_str());
-  // TODO: Add error handling.
-  simutil_memload(path.c_str());
+  // Write the words in chunks, so that large files don't need a buffer for
+  // the whole memory.
+  const size_t kChunkWords = 1 << 16;
+
+  std::vector<uint32_t> phys_addrs;
+  std::vector<uint8_t> phys_bufs;
+  phys_addrs.reserve(std::min((size_t)num_words_, kChunkWords));
+
+  size_t word_bytes = (GetPhysWidth() + 7) / 8;
+  assert(word_bytes <= SV_MEM_WIDTH_BYTES);
+
+  auto flush = [&]() {
+    if (phys_addrs.empty())
+      return;
+    WritePhysWords(phys_addrs, phys_bufs, phys_addrs[0]);
+    phys_addrs.clear();
+    phys_bufs.clear();
+  };
+
+  ReadVmemFile(path, GetPhysWidth(), num_words_,
+               [&](uint32_t addr, const uint8_t *word) {
+                 phys_addrs.push_back(addr);
+                 phys_bufs.insert(phys_bufs.end(), word, word + word_bytes);
+                 phys_bufs.resize(phys_addrs.size() * SV_MEM_WIDTH_BYTES, 0);
+                 if (phys_addrs.size() == kChunkWords)
+                   flush();
+               });
+  flush();
 }
 
 void MemArea::WriteBuffer(uint8_t buf[SV_MEM_WIDTH_BYTES],
@@ -101,8 +173,12 @@ void MemArea::ReadBuffer(std::vector<uint8_t> &data,
               std::back_inserter(data));
 }
 
+svScope MemArea::GetSvScope() const {
+  return SVScoped::Resolve(scope_, &sv_scope_);
+}
+
 void MemArea::ReadToMinibuf(uint8_t *minibuf, uint32_t phys_addr) const {
-  SVScoped scoped(scope_);
+  SVScoped scoped(GetSvScope());
   if (!simutil_get_mem(phys_addr, (svBitVecVal *)minibuf)) {
     std::ostringstream oss;
     oss << "Could not read memory word at physical index 0x" << std::hex
@@ -113,7 +189,7 @@ void MemArea::ReadToMinibuf(uint8_t *minibuf, uint32_t phys_addr) const {
 
 void MemArea::WriteFromMinibuf(uint32_t phys_addr, const uint8_t *minibuf,
                                uint32_t dst_word) const {
-  SVScoped scoped(scope_);
+  SVScoped scoped(GetSvScope());
   if (!simutil_set_mem(phys_addr, (const svBitVecVal *)minibuf)) {
     std::ostringstream oss;
     oss << "Could not set memory at byte offset 0x" << std::hex
@@ -121,3 +197,43 @@ void MemArea::WriteFromMinibuf(uint32_t phys_addr, const uint8_t *minibuf,
     throw std::runtime_error(oss.str());
   }
 }
+
+void MemArea::ReadPhysWords(std::vector<uint8_t> &phys_bufs,
+                            const std::vector<uint32_t> &phys_addrs) const {
+  phys_bufs.assign(phys_addrs.size() * SV_MEM_WIDTH_BYTES, 0);
+  if (phys_addrs.empty())
+    return;
+
+  // Switch scope once for the whole block, rather than once per word.
+  SVScoped scoped(GetSvScope());
+  for (size_t i = 0; i < phys_addrs.size(); ++i) {
+    svBitVecVal *minibuf = (svBitVecVal *)&phys_bufs[i * SV_MEM_WIDTH_BYTES];
+    if (!simutil_get_mem(phys_addrs[i], minibuf)) {
+      std::ostringstream oss;
+      oss << "Could not read memory word at physical index 0x" << std::hex
+          << phys_addrs[i] << ".";
+      throw std::runtime_error(oss.str());
+    }
+  }
+}
+
+void MemArea::WritePhysWords(const std::vector<uint32_t> &phys_addrs,
+                             const std::vector<uint8_t> &phys_bufs,
+                             uint32_t first_dst_word) const {
+  assert(phys_bufs.size() == phys_addrs.size() * SV_MEM_WIDTH_BYTES);
+  if (phys_addrs.empty())
+    return;
+
+  // Switch scope once for the whole block, rather than once per word.
+  SVScoped scoped(GetSvScope());
+  for (size_t i = 0; i < phys_addrs.size(); ++i) {
+    const svBitVecVal *minibuf =
+        (const svBitVecVal *)&phys_bufs[i * SV_MEM_WIDTH_BYTES];
+    if (!simutil_set_mem(phys_addrs[i], minibuf)) {
+      std::ostringstream oss;
+      oss << "Could not set memory at byte offset 0x" << std::hex
+          << (first_dst_word + i) * width_byte_ << ".";
+      throw std::runtime_error(oss.str());
+    }
+  }
+}
@@ -7,6 +7,7 @@
 
 #include <cstdint>
 #include <string>
+#include <svdpi.h>
 #include <vector>
 
 // This is the maximum width of a memory that's supported by the code in
@@ -27,8 +28,7 @@ class MemArea {
    *
    * @param scope  The SystemVerilog scope where the instantiated memory can be
    *               found. This needs to support the DPI-C interfaces \c
-   *               simutil_memload and \c simutil_set_mem (used for vmem and
-   *               ELF files, respectively).
+   *               simutil_set_mem and \c simutil_get_mem.
    *
    * @param size   The size of the memory in bytes (must be positive and a
    *               multiple of \p width_byte)
@@ -39,6 +39,15 @@ class MemArea {
 
   virtual ~MemArea() {}
 
+  /** The physical contents of a block of memory words, as computed by
+   * EncodeWrite().
+   */
+  struct PhysBlock {
+    uint32_t word_offset;              ///< Logical address of the first word
+    std::vector<uint32_t> phys_addrs;  ///< Physical address of each word
+    std::vector<uint8_t> phys_bufs;    ///< SV_MEM_WIDTH_BYTES bytes per word
+  };
+
   /** Write data to this memory area at the given word offset
    *
    * This assumes that the result will fit in the memory. If the scope cannot
@@ -55,6 +64,50 @@ class MemArea {
   virtual void Write(uint32_t word_offset,
                      const std::vector<uint8_t> &data) const;
 
+  /** Set num_words words, starting at word_offset, to a repeated byte value
+   *
+   * This behaves like Write() with a vector of num_words * width_byte copies
+   * of value. If the physical encoding of a word doesn't depend on its address
+   * (as is the case for MemArea and Ecc32MemArea), the whole range is written
+   * with a single call to \c simutil_fill_mem, which is much faster than
+   * writing the words one by one. Memories with address-dependent encodings
+   * override this to fall back to Write().
+   *
+   * If the scope cannot be set, this throws an SVScoped::Error. If the call to
+   * \c simutil_fill_mem fails, this throws a \c std::runtime_error.
+   */
+  virtual void Fill(uint32_t word_offset, uint32_t num_words,
+                    uint8_t value) const;
+
+  /** Compute the physical words that Write() would write, without writing
+   * them
+   *
+   * Arguments are as for Write(). This fills in \p block, which can then be
+   * passed to WritePhysBlock(). Doing the two steps separately allows the
+   * encoded block to be cached. Some memories need to read from the design to
+   * encode their contents (to get a scrambling key, for example), so this
+   * can throw the same exceptions as Write().
+   */
+  virtual void EncodeWrite(uint32_t word_offset,
+                           const std::vector<uint8_t> &data,
+                           PhysBlock *block) const;
+
+  /** Write a block of words that was computed by EncodeWrite()
+   *
+   * If the scope cannot be set, this throws an SVScoped::Error. If a call to
+   * \c simutil_set_mem fails, this throws a \c std::runtime_error.
+   */
+  void WritePhysBlock(const PhysBlock &block) const;
+
+  /** Return a description of the encoding used by EncodeWrite()
+   *
+   * Together with the memory's width and the data and offset of a write, this
+   * determines the result of EncodeWrite(), so it can be used to key a cache
+   * of encoded blocks. Memories whose encoding depends on state in the design
+   * (such as a scrambling key) include that state.
+   */
+  virtual std::vector<uint8_t> GetEncodingTag() const;
+
   /** Read data from this memory area, starting at the given offset.
    *
    * This assumes that there are <tt>word_offset + num_words</tt> words in the
@@ -71,7 +124,14 @@ class MemArea {
   virtual std::vector<uint8_t> Read(uint32_t word_offset,
                                     uint32_t num_words) const;
 
-  /** Use \c simutil_memload to load a vmem file into the memory */
+  /** Load a vmem file into the memory
+   *
+   * The file holds physical memory words (see ReadVmemFile() in
+   * vmem_reader.h), which are written to the design with \c simutil_set_mem.
+   * Words that don't appear in the file are left unchanged. Throws a \c
+   * VmemError if the file can't be parsed, as well as the exceptions that
+   * Write() can throw.
+   */
   virtual void LoadVmem(const std::string &path) const;
 
   const std::string &GetScope() const { return scope_; }
@@ -80,11 +140,17 @@ class MemArea {
   uint32_t GetWidthByte() const { return width_byte_; }
   uint32_t GetWidth() const { return 8 * width_byte_; }
 
+  /** The width of each word in the physical memory, in bits */
+  virtual uint32_t GetPhysWidth() const { return GetWidth(); }
+
  protected:
   std::string scope_;    ///< Design scope (used for accesses over DPI)
   uint32_t num_words_;   ///< Size of the memory area in words
   uint32_t width_byte_;  ///< Size of each word in bytes
 
+  /** The resolved handle for scope_ (set on first use) */
+  svScope GetSvScope() const;
+
   /** Write to buf with the data that should be copied to the physical memory
    * for a single memory word.
    *
@@ -134,17 +200,41 @@ class MemArea {
   /** Read the memory word at phys_addr into minibuf
    *
    * minibuf should be at least SV_MEM_WIDTH_BYTES in size. See the
-   * implementation of MemArea::Write() for the details.
+   * implementation of MemArea::EncodeWrite() for the details.
    */
   void ReadToMinibuf(uint8_t *minibuf, uint32_t phys_addr) const;
 
   /** Write from minibuf to the memory word at phys_addr
    *
    * minibuf should be at least SV_MEM_WIDTH_BYTES in size. See the
-   * implementation of MemArea::Write() for the details.
+   * implementation of MemArea::EncodeWrite() for the details.
    */
   void WriteFromMinibuf(uint32_t phys_addr, const uint8_t *minibuf,
                         uint32_t dst_word) const;
+
+  /** Read a block of memory words, given by their physical addresses
+   *
+   * This resizes \p phys_bufs to hold SV_MEM_WIDTH_BYTES bytes per entry of
+   * \p phys_addrs and fills entry i with the contents of the word at
+   * physical address <tt>phys_addrs[i]</tt>. The SystemVerilog scope is only
+   * set once for the whole block.
+   */
+  void ReadPhysWords(std::vector<uint8_t> &phys_bufs,
+                     const std::vector<uint32_t> &phys_addrs) const;
+
+  /** Write a block of memory words, given by their physical addresses
+   *
+   * \p phys_bufs must contain SV_MEM_WIDTH_BYTES bytes per entry of \p
+   * phys_addrs, laid out as for ReadPhysWords(). \p first_dst_word is the
+   * logical address of the first word and is only used for error messages.
+   * The SystemVerilog scope is only set once for the whole block.
+   */
+  void WritePhysWords(const std::vector<uint32_t> &phys_addrs,
+                      const std::vector<uint8_t> &phys_bufs,
+                      uint32_t first_dst_word) const;
+
+ private:
+  mutable svScope sv_scope_;  ///< Cached handle for scope_, or null
 };
 
 #endif  // OPENTITAN_HW_DV_VERILATOR_CPP_MEM_AREA_H_
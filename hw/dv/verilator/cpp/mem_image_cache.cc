@@ -0,0 +1,247 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "mem_image_cache.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+// Cache files start with this magic string. Change the version number at the
+// end if the format changes or if an encoding changes in a way that isn't
+// reflected in the encoding tag.
+static const char kMagic[8] = {'M', 'E', 'M', 'I', 'M', 'G', '0', '1'};
+
+static void AppendU32(std::vector<uint8_t> &vec, uint32_t val) {
+  for (int i = 0; i < 4; ++i) {
+    vec.push_back((val >> (8 * i)) & 0xff);
+  }
+}
+
+static uint32_t ReadU32(const uint8_t *buf) {
+  return (uint32_t)buf[0] | ((uint32_t)buf[1] << 8) |
+         ((uint32_t)buf[2] << 16) | ((uint32_t)buf[3] << 24);
+}
+
+// A 128-bit hash of the bytes in a and then b, computed as two independent
+// 64-bit hashes. This isn't cryptographic, but it is wide enough that
+// accidental collisions between the images in a cache aren't a concern.
+static std::pair<uint64_t, uint64_t> Hash128(const std::vector<uint8_t> &a,
+                                             const std::vector<uint8_t> &b) {
+  // FNV-1a for the first half
+  uint64_t h0 = 0xcbf29ce484222325ULL;
+  // A multiply-xorshift hash over 64-bit chunks for the second
+  uint64_t h1 = 0x9e3779b97f4a7c15ULL;
+
+  for (const std::vector<uint8_t> *vec : {&a, &b}) {
+    const uint8_t *p = vec->data();
+    size_t len = vec->size();
+
+    for (size_t i = 0; i < len; ++i) {
+      h0 = (h0 ^ p[i]) * 0x100000001b3ULL;
+    }
+
+    size_t i = 0;
+    for (; i + 8 <= len; i += 8) {
+      uint64_t chunk;
+      memcpy(&chunk, p + i, 8);
+      h1 = (h1 ^ chunk) * 0xff51afd7ed558ccdULL;
+      h1 ^= h1 >> 33;
+    }
+    uint64_t tail = 0;
+    if (i < len)
+      memcpy(&tail, p + i, len - i);
+    h1 = (h1 ^ tail ^ ((uint64_t)len << 56)) * 0xc4ceb9fe1a85ec53ULL;
+    h1 ^= h1 >> 29;
+  }
+
+  return std::make_pair(h0, h1);
+}
+
+// Create dir and any missing parents. Throws a std::runtime_error on failure.
+static void MakeDirs(const std::string &dir) {
+  for (size_t pos = 1; pos <= dir.size(); ++pos) {
+    if (pos != dir.size() && dir[pos] != '/')
+      continue;
+
+    std::string prefix = dir.substr(0, pos);
+    if (mkdir(prefix.c_str(), 0777) != 0 && errno != EEXIST) {
+      std::ostringstream oss;
+      oss << "Cannot create memory image cache directory `" << prefix
+          << "': " << strerror(errno) << ".";
+      throw std::runtime_error(oss.str());
+    }
+  }
+}
+
+MemImageCache::MemImageCache(const std::string &dir) : dir_(dir) {
+  assert(!dir.empty());
+  MakeDirs(dir);
+}
+
+void MemImageCache::EncodeWrite(const MemArea &mem_area, uint32_t word_offset,
+                                const std::vector<uint8_t> &data,
+                                MemArea::PhysBlock *block) const {
+  assert(block);
+
+  uint32_t width_byte = mem_area.GetWidthByte();
+  uint32_t num_words = (data.size() + width_byte - 1) / width_byte;
+  assert(word_offset + num_words <= mem_area.GetSizeWords());
+
+  // The key holds everything other than data that the encoding depends on.
+  // It is stored in the cache file and checked on a hit.
+  std::vector<uint8_t> key(kMagic, kMagic + sizeof(kMagic));
+  AppendU32(key, width_byte);
+  AppendU32(key, mem_area.GetSizeWords());
+  AppendU32(key, word_offset);
+  AppendU32(key, data.size());
+  std::vector<uint8_t> tag = mem_area.GetEncodingTag();
+  AppendU32(key, tag.size());
+  key.insert(key.end(), tag.begin(), tag.end());
+
+  std::string path = PathForKey(key, data);
+  if (Lookup(path, key, num_words, block)) {
+    block->word_offset = word_offset;
+    return;
+  }
+
+  mem_area.EncodeWrite(word_offset, data, block);
+  Store(path, key, *block);
+}
+
+std::string MemImageCache::PathForKey(const std::vector<uint8_t> &key,
+                                      const std::vector<uint8_t> &data) const {
+  std::pair<uint64_t, uint64_t> hash = Hash128(key, data);
+
+  std::ostringstream oss;
+  oss << dir_ << "/" << std::hex << std::setfill('0') << std::setw(16)
+      << hash.first << std::setw(16) << hash.second << ".memimg";
+  return oss.str();
+}
+
+// A cache file consists of:
+//
+//   - The key, as constructed in EncodeWrite (starting with kMagic)
+//   - The number of words (u32)
+//   - The number of bytes stored for each word (u32): trailing bytes of each
+//     word's SV_MEM_WIDTH_BYTES buffer that are zero for every word are
+//     dropped
+//   - The physical address of each word (u32 each)
+//   - The stored bytes of each word
+//
+// All integers are little-endian.
+bool MemImageCache::Lookup(const std::string &path,
+                           const std::vector<uint8_t> &key, uint32_t num_words,
+                           MemArea::PhysBlock *block) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    return false;
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || (size_t)st.st_size < key.size() + 8) {
+    close(fd);
+    return false;
+  }
+
+  size_t file_size = st.st_size;
+  void *mapping = mmap(NULL, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED)
+    return false;
+
+  const uint8_t *buf = static_cast<const uint8_t *>(mapping);
+  bool good = false;
+
+  if (memcmp(buf, key.data(), key.size()) == 0 &&
+      ReadU32(buf + key.size()) == num_words) {
+    uint32_t stored_bytes = ReadU32(buf + key.size() + 4);
+    const uint8_t *addrs = buf + key.size() + 8;
+    const uint8_t *words = addrs + 4 * (size_t)num_words;
+
+    if (stored_bytes <= SV_MEM_WIDTH_BYTES &&
+        file_size == (size_t)(words - buf) + (size_t)num_words * stored_bytes) {
+      block->phys_addrs.resize(num_words);
+      block->phys_bufs.assign((size_t)num_words * SV_MEM_WIDTH_BYTES, 0);
+
+      for (uint32_t i = 0; i < num_words; ++i) {
+        block->phys_addrs[i] = ReadU32(addrs + 4 * i);
+      }
+      if (stored_bytes == SV_MEM_WIDTH_BYTES && num_words) {
+        memcpy(&block->phys_bufs[0], words, block->phys_bufs.size());
+      } else {
+        for (uint32_t i = 0; i < num_words; ++i) {
+          memcpy(&block->phys_bufs[(size_t)i * SV_MEM_WIDTH_BYTES],
+                 words + (size_t)i * stored_bytes, stored_bytes);
+        }
+      }
+      good = true;
+    }
+  }
+
+  munmap(mapping, file_size);
+  return good;
+}
+
+void MemImageCache::Store(const std::string &path,
+                          const std::vector<uint8_t> &key,
+                          const MemArea::PhysBlock &block) {
+  uint32_t num_words = block.phys_addrs.size();
+  assert(block.phys_bufs.size() == (size_t)num_words * SV_MEM_WIDTH_BYTES);
+
+  // Find how many bytes of each word's buffer we need to store
+  uint32_t stored_bytes = 0;
+  for (uint32_t i = 0; i < num_words; ++i) {
+    const uint8_t *word = &block.phys_bufs[(size_t)i * SV_MEM_WIDTH_BYTES];
+    for (uint32_t j = SV_MEM_WIDTH_BYTES; j > stored_bytes; --j) {
+      if (word[j - 1]) {
+        stored_bytes = j;
+        break;
+      }
+    }
+  }
+
+  std::vector<uint8_t> contents = key;
+  AppendU32(contents, num_words);
+  AppendU32(contents, stored_bytes);
+  for (uint32_t addr : block.phys_addrs) {
+    AppendU32(contents, addr);
+  }
+  contents.reserve(contents.size() + (size_t)num_words * stored_bytes);
+  for (uint32_t i = 0; i < num_words; ++i) {
+    const uint8_t *word = &block.phys_bufs[(size_t)i * SV_MEM_WIDTH_BYTES];
+    contents.insert(contents.end(), word, word + stored_bytes);
+  }
+
+  // Write to a temporary file and then rename it into place, so that other
+  // simulations never see a partial file.
+  std::ostringstream tmp_oss;
+  tmp_oss << path << ".tmp." << getpid() << "."
+          << std::hash<std::thread::id>()(std::this_thread::get_id());
+  std::string tmp_path = tmp_oss.str();
+
+  FILE *file = fopen(tmp_path.c_str(), "wb");
+  bool good = file && fwrite(contents.data(), 1, contents.size(), file) ==
+                          contents.size();
+  if (file)
+    good &= fclose(file) == 0;
+  good = good && rename(tmp_path.c_str(), path.c_str()) == 0;
+
+  if (!good) {
+    std::cerr << "WARNING: Failed to write memory image cache file `" << path
+              << "': " << strerror(errno) << "." << std::endl;
+    unlink(tmp_path.c_str());
+  }
+}
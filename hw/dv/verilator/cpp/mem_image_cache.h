@@ -0,0 +1,67 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+#ifndef OPENTITAN_HW_DV_VERILATOR_CPP_MEM_IMAGE_CACHE_H_
+#define OPENTITAN_HW_DV_VERILATOR_CPP_MEM_IMAGE_CACHE_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "mem_area.h"
+
+/**
+ * An on-disk cache of encoded memory images
+ *
+ * Computing the physical contents of a memory (with ECC bits and possibly
+ * scrambling) can take much longer than writing them into the design, and
+ * simulations often load the same images with the same keys. This cache
+ * stores the result of MemArea::EncodeWrite() in a directory, with one file
+ * per block. The file name is a hash of everything that the encoding depends
+ * on: the data, the word offset, the memory's geometry and its encoding tag
+ * (see MemArea::GetEncodingTag()), which includes any scrambling key and
+ * nonce.
+ *
+ * The directory can be shared between simulations that run at the same time:
+ * files are written under a temporary name and then renamed into place.
+ */
+class MemImageCache {
+ public:
+  /** Constructor
+   *
+   * @param dir The directory holding cached images. This is created if it
+   *            doesn't exist.
+   */
+  explicit MemImageCache(const std::string &dir);
+
+  /** Encode data to be written to mem_area at word_offset
+   *
+   * This behaves like MemArea::EncodeWrite, but uses a cached copy of the
+   * encoded block if there is one. If not, it encodes the block and tries to
+   * add it to the cache. Failing to read or write a cache file isn't an error
+   * (the block is just encoded from scratch), but exceptions from
+   * MemArea::EncodeWrite are passed through.
+   */
+  void EncodeWrite(const MemArea &mem_area, uint32_t word_offset,
+                   const std::vector<uint8_t> &data,
+                   MemArea::PhysBlock *block) const;
+
+ private:
+  // The path to the cache file for a block with the given key
+  std::string PathForKey(const std::vector<uint8_t> &key,
+                         const std::vector<uint8_t> &data) const;
+
+  // Try to read a block from path, checking that its header matches key.
+  // Returns true on success.
+  static bool Lookup(const std::string &path, const std::vector<uint8_t> &key,
+                     uint32_t num_words, MemArea::PhysBlock *block);
+
+  // Try to write block to path, with a header containing key. Prints a
+  // warning if something goes wrong.
+  static void Store(const std::string &path, const std::vector<uint8_t> &key,
+                    const MemArea::PhysBlock &block);
+
+  std::string dir_;
+};
+
+#endif  // OPENTITAN_HW_DV_VERILATOR_CPP_MEM_IMAGE_CACHE_H_
@@ -7,7 +7,9 @@
 // Utility class representing disjoint segments of memory
 
 #include <cassert>
+#include <cstddef>
 #include <map>
+#include <vector>
 
 // The type used to represent address ranges. This is essentially a std::pair,
 // but we need a operator< custom for the internal map.
@@ -32,11 +34,34 @@ class RangedMap {
   typedef val_t (*MergeFun)(const rng_t &rng0, val_t &&val0, const rng_t &rng1,
                             val_t &&val1);
 
+  RangedMap() : frozen_(false) {}
+
+  // Copying a frozen map gives a frozen map. The flat index holds iterators
+  // into map_, so it must be rebuilt rather than copied. Moving a std::map
+  // doesn't invalidate iterators, so the index can be moved with it.
+  RangedMap(const RangedMap &other) : map_(other.map_), frozen_(false) {
+    if (other.frozen_)
+      Freeze();
+  }
+  RangedMap(RangedMap &&other) = default;
+
+  RangedMap &operator=(const RangedMap &other) {
+    if (this != &other) {
+      map_ = other.map_;
+      Thaw();
+      if (other.frozen_)
+        Freeze();
+    }
+    return *this;
+  }
+  RangedMap &operator=(RangedMap &&other) = default;
+
   // Insert an entry that covers the address range [min_addr, max_addr]
   // (inclusive) with value val.
   void Emplace(addr_t min_addr, addr_t max_addr, val_t &&new_val,
                MergeFun merge) {
     assert(min_addr <= max_addr);
+    Thaw();
 
     // Construct hit_lo / hit_hi, a pair of iterators that bound the
     // segments that touch the new value.
@@ -107,6 +132,7 @@ class RangedMap {
   // returned. Otherwise, returns nullptr.
   const val_t *EmplaceDisjoint(addr_t min_addr, addr_t max_addr, val_t &&val) {
     assert(min_addr <= max_addr);
+    Thaw();
     rng_t rng = {.lo = min_addr, .hi = max_addr};
 
     if (!map_.empty()) {
@@ -153,9 +179,33 @@ class RangedMap {
   const_iterator end() const { return const_iterator(map_.end()); }
   size_t size() const { return map_.size(); }
 
+  // Build a flat copy of the ranges in contiguous, sorted arrays. Until the
+  // map is next modified, find() searches these instead of walking the tree,
+  // which is much friendlier to the cache for maps that are built once and
+  // then queried many times. Calling Freeze() on a frozen map does nothing.
+  void Freeze() {
+    if (frozen_)
+      return;
+
+    flat_rngs_.clear();
+    flat_its_.clear();
+    flat_rngs_.reserve(map_.size());
+    flat_its_.reserve(map_.size());
+    for (auto it = map_.begin(); it != map_.end(); ++it) {
+      flat_rngs_.push_back(it->first);
+      flat_its_.push_back(it);
+    }
+    frozen_ = true;
+  }
+
+  bool frozen() const { return frozen_; }
+
   // Try to find an entry hitting the given address. Returns end() if there is
   // none.
   const_iterator find(addr_t addr) const {
+    if (frozen_)
+      return FindFlat(addr);
+
     // To find the entry containing addr, use upper_bound to find the first
     // region strictly after it, and then std::prev to step backwards. This
     // fails if either the map is empty (obviously!) or if ub_it is already the
@@ -177,7 +227,42 @@ class RangedMap {
   }
 
  private:
+  // Drop the flat index (called before modifying map_)
+  void Thaw() {
+    if (!frozen_)
+      return;
+    flat_rngs_.clear();
+    flat_its_.clear();
+    frozen_ = false;
+  }
+
+  // The frozen version of find(). This is a binary search for the last
+  // range with lo <= addr. The loop has a fixed trip count for a given size
+  // and the comparison only picks which base to keep, so the compiler can
+  // turn it into a conditional move rather than a branch.
+  const_iterator FindFlat(addr_t addr) const {
+    size_t n = flat_rngs_.size();
+    if (n == 0 || addr < flat_rngs_[0].lo)
+      return end();
+
+    const rng_t *base = &flat_rngs_[0];
+    while (n > 1) {
+      size_t half = n / 2;
+      base = (base[half].lo <= addr) ? base + half : base;
+      n -= half;
+    }
+
+    size_t idx = base - &flat_rngs_[0];
+    return (addr <= base->hi) ? flat_its_[idx] : end();
+  }
+
   std::map<rng_t, val_t> map_;
+
+  // The flat index, which is only valid if frozen_ is true. flat_rngs_[i] is
+  // the key of flat_its_[i].
+  bool frozen_;
+  std::vector<rng_t> flat_rngs_;
+  std::vector<const_iterator> flat_its_;
 };
 
 #endif  // OPENTITAN_HW_DV_VERILATOR_CPP_RANGED_MAP_H_
@@ -6,10 +6,15 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstring>
+#include <exception>
+#include <functional>
 #include <iostream>
 #include <sstream>
+#include <thread>
 
 #include "scramble_model.h"
+#include "secded_enc.h"
 #include "sv_scoped.h"
 
 // This is the maximum width of a nonce that's supported by the code in
@@ -17,32 +22,27 @@
 static const uint32_t kScrMaxNonceWidth = 320;
 static const uint32_t kScrMaxNonceWidthByte = (kScrMaxNonceWidth + 7) / 8;
 
-// Functions to convert from integer address to/from a little-endian vector of
-// bytes, addr_width is given in bits
-static std::vector<uint8_t> AddrIntToBytes(uint32_t addr, uint32_t addr_width) {
-  uint32_t addr_width_bytes = (addr_width + 7) / 8;
-  std::vector<uint8_t> addr_bytes(addr_width_bytes);
-
-  for (uint32_t i = 0; i < addr_width_bytes; ++i) {
-    addr_bytes[i] = addr & 0xff;
-    addr >>= 8;
+// The number of 64-bit words needed to hold the widest physical memory word
+static const uint32_t kPhysWords64 = (SV_MEM_WIDTH_BYTES + 7) / 8;
+
+// Functions to convert between a little-endian buffer of bytes and an array
+// of 64-bit words (least significant word first), as used by the fixed-width
+// scrambling model. Bits above num_bytes are zero in the words array.
+static void BytesToWords64(uint64_t words[kPhysWords64], const uint8_t *bytes,
+                           uint32_t num_bytes) {
+  assert(num_bytes <= 8 * kPhysWords64);
+  std::fill(words, words + kPhysWords64, 0);
+  for (uint32_t i = 0; i < num_bytes; ++i) {
+    words[i / 8] |= (uint64_t)bytes[i] << (8 * (i % 8));
   }
-
-  return addr_bytes;
 }
 
-static uint32_t AddrBytesToInt(const std::vector<uint8_t> &addr) {
-  assert(addr.size() <= 4);
-
-  uint32_t addr_out = 0;
-  int cur_shift = 0;
-
-  for (uint8_t byte : addr) {
-    addr_out |= ((uint32_t)byte << cur_shift);
-    cur_shift += 8;
+static void Words64ToBytes(uint8_t *bytes, const uint64_t words[kPhysWords64],
+                           uint32_t num_bytes) {
+  assert(num_bytes <= 8 * kPhysWords64);
+  for (uint32_t i = 0; i < num_bytes; ++i) {
+    bytes[i] = (words[i / 8] >> (8 * (i % 8))) & 0xff;
   }
-
-  return addr_out;
 }
 
 // Converts svBitVecVal (bit[m:n] SV type) into a byte vector
@@ -81,37 +81,103 @@ static uint32_t vbits(uint32_t size) {
   return width;
 }
 
+// Run fn(begin, end) over the index range [0, n), splitting it between worker
+// threads. Small ranges are handled on the calling thread, since starting the
+// threads would cost more than it saves. Any exception thrown by fn is
+// re-thrown on the calling thread once all workers have finished.
+static void ParallelFor(uint32_t n,
+                        const std::function<void(uint32_t, uint32_t)> &fn) {
+  const uint32_t kMinWordsPerThread = 1024;
+
+  uint32_t max_threads = std::max(1u, std::thread::hardware_concurrency());
+  uint32_t num_threads = std::min(
+      max_threads, (n + kMinWordsPerThread - 1) / kMinWordsPerThread);
+
+  if (num_threads <= 1) {
+    fn(0, n);
+    return;
+  }
+
+  uint32_t chunk = (n + num_threads - 1) / num_threads;
+  std::vector<std::thread> workers;
+  std::vector<std::exception_ptr> errors(num_threads);
+
+  for (uint32_t t = 0; t < num_threads; ++t) {
+    uint32_t begin = t * chunk;
+    uint32_t end = std::min(n, begin + chunk);
+    workers.emplace_back([&fn, &errors, t, begin, end]() {
+      try {
+        fn(begin, end);
+      } catch (...) {
+        errors[t] = std::current_exception();
+      }
+    });
+  }
+
+  for (std::thread &worker : workers) {
+    worker.join();
+  }
+
+  for (const std::exception_ptr &error : errors) {
+    if (error)
+      std::rethrow_exception(error);
+  }
+}
+
 extern "C" {
 int simutil_get_scramble_key(svBitVecVal *key);
 int simutil_get_scramble_nonce(svBitVecVal *nonce);
 }
 
-std::vector<uint8_t> ScrambledEcc32MemArea::GetScrambleKey() const {
-  SVScoped scoped(scr_scope_);
-  svBitVecVal key_minibuf[((kPrinceWidthByte * 2) + 3) / 4];
+void ScrambledEcc32MemArea::ReadScrambleParams(
+    svBitVecVal key[kScrKeyWords32],
+    svBitVecVal nonce[kScrNonceWords32]) const {
+  static_assert(kScrKeyWords32 * 4 == kPrinceWidthByte * 2,
+                "Unexpected scrambling key width");
+  static_assert(kScrNonceWords32 * 32 == kScrMaxNonceWidth,
+                "Unexpected scrambling nonce width");
+  assert(GetNonceWidthByte() <= kScrMaxNonceWidthByte);
+
+  SVScoped scoped(SVScoped::Resolve(scr_scope_, &scr_sv_scope_));
 
-  if (!simutil_get_scramble_key(key_minibuf)) {
+  if (!simutil_get_scramble_key(key)) {
     std::ostringstream oss;
     oss << "Could not read key at scope " << scr_scope_;
     throw std::runtime_error(oss.str());
   }
 
-  return ByteVecFromSV(key_minibuf, kPrinceWidthByte * 2);
-}
-
-std::vector<uint8_t> ScrambledEcc32MemArea::GetScrambleNonce() const {
-  assert(GetNonceWidthByte() <= kScrMaxNonceWidthByte);
-
-  SVScoped scoped(scr_scope_);
-  svBitVecVal nonce_minibuf[(kScrMaxNonceWidthByte + 3) / 4];
-
-  if (!simutil_get_scramble_nonce((svBitVecVal *)nonce_minibuf)) {
+  if (!simutil_get_scramble_nonce(nonce)) {
     std::ostringstream oss;
     oss << "Could not read nonce at scope " << scr_scope_;
     throw std::runtime_error(oss.str());
   }
+}
+
+const ScrambleKeySchedule &ScrambledEcc32MemArea::GetKeySchedule() const {
+  svBitVecVal key[kScrKeyWords32];
+  svBitVecVal nonce[kScrNonceWords32] = {0};
+  ReadScrambleParams(key, nonce);
 
-  return ByteVecFromSV(nonce_minibuf, GetNonceWidthByte());
+  // The nonce is only defined up to its width, so only compare that much.
+  uint32_t nonce_words = (GetNonceWidthByte() + 3) / 4;
+  if (cached_ks_ && std::equal(key, key + kScrKeyWords32, cached_key_) &&
+      std::equal(nonce, nonce + nonce_words, cached_nonce_)) {
+    return *cached_ks_;
+  }
+
+  ScrambleKeySchedule ks(ByteVecFromSV(key, kPrinceWidthByte * 2),
+                         ByteVecFromSV(nonce, GetNonceWidthByte()),
+                         GetNonceWidth());
+  // Update the cached schedule in place, so that references returned by
+  // earlier calls stay valid.
+  if (cached_ks_) {
+    *cached_ks_ = ks;
+  } else {
+    cached_ks_.reset(new ScrambleKeySchedule(ks));
+  }
+  std::copy(key, key + kScrKeyWords32, cached_key_);
+  std::copy(nonce, nonce + nonce_words, cached_nonce_);
+  return *cached_ks_;
 }
 
 ScrambledEcc32MemArea::ScrambledEcc32MemArea(const std::string &scope,
@@ -121,15 +187,14 @@ ScrambledEcc32MemArea::ScrambledEcc32MemArea(const std::string &scope,
                                             "u_prim_ram_1p_adv.gen_ram_inst[0]."
                                             "u_mem.gen_generic.u_impl_generic"),
                    size, width_32),
-      scr_scope_(scope) {
+      scr_scope_(scope),
+      scr_sv_scope_(nullptr),
+      cached_key_{},
+      cached_nonce_{} {
   addr_width_ = vbits(size);
   repeat_keystream_ = repeat_keystream;
 }
 
-uint32_t ScrambledEcc32MemArea::GetPhysWidth() const {
-  return (GetWidthByte() / 4) * 39;
-}
-
 uint32_t ScrambledEcc32MemArea::GetPhysWidthByte() const {
   return (GetPhysWidth() + 7) / 8;
 }
@@ -150,63 +215,234 @@ uint32_t ScrambledEcc32MemArea::GetNonceWidthByte() const {
   return GetPrinceReplications() * 8;
 }
 
+void ScrambledEcc32MemArea::EncodeWrite(uint32_t word_offset,
+                                        const std::vector<uint8_t> &data,
+                                        PhysBlock *block) const {
+  assert(block);
+  uint32_t data_words = (data.size() + width_byte_ - 1) / width_byte_;
+  assert(word_offset + data_words <= num_words_);
+
+  // Only the integrity computation below can read past the end of data (if
+  // the last word is partial), so pad a copy in that case.
+  const std::vector<uint8_t> *src = &data;
+  std::vector<uint8_t> padded;
+  if (data.size() % width_byte_) {
+    padded = data;
+    padded.resize((size_t)data_words * width_byte_, 0);
+    src = &padded;
+  }
+
+  const ScrambleKeySchedule &ks = GetKeySchedule();
+
+  // See MemArea::EncodeWrite for an explanation of the layout of this buffer.
+  block->word_offset = word_offset;
+  block->phys_bufs.assign((size_t)data_words * SV_MEM_WIDTH_BYTES, 0);
+  block->phys_addrs.resize(data_words);
+
+  uint32_t width_32 = width_byte_ / 4;
+  ParallelFor(data_words, [&](uint32_t begin, uint32_t end) {
+    // Compute the check bits for the whole range in one go
+    std::vector<uint8_t> check_bits((size_t)(end - begin) * width_32);
+    enc_secded_inv_39_32_buf(src->data() + (size_t)begin * width_byte_,
+                             check_bits.size(), check_bits.data());
+
+    for (uint32_t i = begin; i < end; ++i) {
+      uint32_t dst_word = word_offset + i;
+      uint8_t *buf = &block->phys_bufs[(size_t)i * SV_MEM_WIDTH_BYTES];
+
+      block->phys_addrs[i] = ToPhysAddr(dst_word, ks);
+      InsertWords(buf, &(*src)[(size_t)i * width_byte_],
+                  &check_bits[(size_t)(i - begin) * width_32]);
+      ScrambleBuffer(buf, dst_word, ks);
+    }
+  });
+}
+
+void ScrambledEcc32MemArea::Fill(uint32_t word_offset, uint32_t num_words,
+                                 uint8_t value) const {
+  Write(word_offset,
+        std::vector<uint8_t>((size_t)num_words * width_byte_, value));
+}
+
+std::vector<uint8_t> ScrambledEcc32MemArea::GetEncodingTag() const {
+  static const char tag[] = "scrambled_ecc32";
+  std::vector<uint8_t> ret(tag, tag + sizeof(tag) - 1);
+  ret.push_back(repeat_keystream_);
+  ret.push_back(addr_width_);
+
+  svBitVecVal key_minibuf[kScrKeyWords32];
+  svBitVecVal nonce_minibuf[kScrNonceWords32];
+  ReadScrambleParams(key_minibuf, nonce_minibuf);
+  std::vector<uint8_t> key = ByteVecFromSV(key_minibuf, kPrinceWidthByte * 2);
+  std::vector<uint8_t> nonce =
+      ByteVecFromSV(nonce_minibuf, GetNonceWidthByte());
+  ret.insert(ret.end(), key.begin(), key.end());
+  ret.insert(ret.end(), nonce.begin(), nonce.end());
+  return ret;
+}
+
+std::vector<uint8_t> ScrambledEcc32MemArea::Read(uint32_t word_offset,
+                                                 uint32_t num_words) const {
+  assert(word_offset + num_words <= num_words_);
+
+  const ScrambleKeySchedule &ks = GetKeySchedule();
+
+  std::vector<uint32_t> phys_addrs(num_words);
+  ParallelFor(num_words, [&](uint32_t begin, uint32_t end) {
+    for (uint32_t i = begin; i < end; ++i) {
+      phys_addrs[i] = ToPhysAddr(word_offset + i, ks);
+    }
+  });
+
+  std::vector<uint8_t> phys_bufs;
+  ReadPhysWords(phys_bufs, phys_addrs);
+
+  std::vector<uint8_t> ret((size_t)num_words * width_byte_);
+  ParallelFor(num_words, [&](uint32_t begin, uint32_t end) {
+    uint8_t unscrambled[SV_MEM_WIDTH_BYTES];
+    std::vector<uint8_t> word_data;
+    word_data.reserve(width_byte_);
+    for (uint32_t i = begin; i < end; ++i) {
+      uint32_t src_word = word_offset + i;
+      ReadUnscrambled(unscrambled, &phys_bufs[(size_t)i * SV_MEM_WIDTH_BYTES],
+                      src_word, ks);
+
+      word_data.clear();
+      Ecc32MemArea::ReadBuffer(word_data, unscrambled, src_word);
+      std::copy(word_data.begin(), word_data.end(),
+                ret.begin() + (size_t)i * width_byte_);
+    }
+  });
+
+  return ret;
+}
+
+Ecc32MemArea::EccWords ScrambledEcc32MemArea::ReadWithIntegrity(
+    uint32_t word_offset, uint32_t num_words) const {
+  assert(word_offset + num_words <= num_words_);
+
+  const ScrambleKeySchedule &ks = GetKeySchedule();
+  uint32_t width_32 = width_byte_ / 4;
+
+  std::vector<uint32_t> phys_addrs(num_words);
+  ParallelFor(num_words, [&](uint32_t begin, uint32_t end) {
+    for (uint32_t i = begin; i < end; ++i) {
+      phys_addrs[i] = ToPhysAddr(word_offset + i, ks);
+    }
+  });
+
+  std::vector<uint8_t> phys_bufs;
+  ReadPhysWords(phys_bufs, phys_addrs);
+
+  EccWords ret((size_t)num_words * width_32);
+  ParallelFor(num_words, [&](uint32_t begin, uint32_t end) {
+    uint8_t unscrambled[SV_MEM_WIDTH_BYTES];
+    EccWords word_data;
+    word_data.reserve(width_32);
+    for (uint32_t i = begin; i < end; ++i) {
+      uint32_t src_word = word_offset + i;
+      ReadUnscrambled(unscrambled, &phys_bufs[(size_t)i * SV_MEM_WIDTH_BYTES],
+                      src_word, ks);
+
+      word_data.clear();
+      Ecc32MemArea::ReadBufferWithIntegrity(word_data, unscrambled, src_word);
+      std::copy(word_data.begin(), word_data.end(),
+                ret.begin() + (size_t)i * width_32);
+    }
+  });
+
+  return ret;
+}
+
+void ScrambledEcc32MemArea::WriteWithIntegrity(uint32_t word_offset,
+                                               const EccWords &data) const {
+  uint32_t width_32 = width_byte_ / 4;
+  uint32_t to_write = data.size() / width_32;
+
+  assert((data.size() % width_32) == 0);
+  assert(word_offset + to_write <= num_words_);
+
+  const ScrambleKeySchedule &ks = GetKeySchedule();
+
+  // See MemArea::EncodeWrite for an explanation of the layout of this buffer.
+  std::vector<uint8_t> phys_bufs((size_t)to_write * SV_MEM_WIDTH_BYTES, 0);
+  std::vector<uint32_t> phys_addrs(to_write);
+
+  ParallelFor(to_write, [&](uint32_t begin, uint32_t end) {
+    for (uint32_t i = begin; i < end; ++i) {
+      uint32_t dst_word = word_offset + i;
+      uint8_t *buf = &phys_bufs[(size_t)i * SV_MEM_WIDTH_BYTES];
+
+      phys_addrs[i] = ToPhysAddr(dst_word, ks);
+      Ecc32MemArea::WriteBufferWithIntegrity(buf, data, i * width_32,
+                                             dst_word);
+      ScrambleBuffer(buf, dst_word, ks);
+    }
+  });
+
+  WritePhysWords(phys_addrs, phys_bufs, word_offset);
+}
+
 void ScrambledEcc32MemArea::WriteBuffer(uint8_t buf[SV_MEM_WIDTH_BYTES],
                                         const std::vector<uint8_t> &data,
                                         size_t start_idx,
                                         uint32_t dst_word) const {
   // Compute integrity
   Ecc32MemArea::WriteBuffer(buf, data, start_idx, dst_word);
-  ScrambleBuffer(buf, dst_word);
+  ScrambleBuffer(buf, dst_word, GetKeySchedule());
 }
 
-std::vector<uint8_t> ScrambledEcc32MemArea::ReadUnscrambled(
-    const uint8_t buf[SV_MEM_WIDTH_BYTES], uint32_t src_word) const {
-  std::vector<uint8_t> scrambled_data(buf, buf + GetPhysWidthByte());
-  return scramble_decrypt_data(scrambled_data, GetPhysWidth(), 39,
-                               AddrIntToBytes(src_word, addr_width_),
-                               addr_width_, GetScrambleNonce(),
-                               GetScrambleKey(), repeat_keystream_, false);
+void ScrambledEcc32MemArea::ReadUnscrambled(
+    uint8_t dst[SV_MEM_WIDTH_BYTES], const uint8_t buf[SV_MEM_WIDTH_BYTES],
+    uint32_t src_word, const ScrambleKeySchedule &ks) const {
+  uint64_t words[kPhysWords64];
+  BytesToWords64(words, buf, GetPhysWidthByte());
+  scramble_decrypt_data(words, words, GetPhysWidth(), src_word, addr_width_, ks,
+                        repeat_keystream_);
+  Words64ToBytes(dst, words, GetPhysWidthByte());
 }
 
 void ScrambledEcc32MemArea::ReadBuffer(std::vector<uint8_t> &data,
                                        const uint8_t buf[SV_MEM_WIDTH_BYTES],
                                        uint32_t src_word) const {
-  std::vector<uint8_t> unscrambled_data = ReadUnscrambled(buf, src_word);
+  uint8_t unscrambled_data[SV_MEM_WIDTH_BYTES];
+  ReadUnscrambled(unscrambled_data, buf, src_word, GetKeySchedule());
   // Strip integrity to give final result
-  Ecc32MemArea::ReadBuffer(data, &unscrambled_data[0], src_word);
+  Ecc32MemArea::ReadBuffer(data, unscrambled_data, src_word);
 }
 
 void ScrambledEcc32MemArea::ReadBufferWithIntegrity(
     EccWords &data, const uint8_t buf[SV_MEM_WIDTH_BYTES],
     uint32_t src_word) const {
-  std::vector<uint8_t> unscrambled_data = ReadUnscrambled(buf, src_word);
-  Ecc32MemArea::ReadBufferWithIntegrity(data, &unscrambled_data[0], src_word);
+  uint8_t unscrambled_data[SV_MEM_WIDTH_BYTES];
+  ReadUnscrambled(unscrambled_data, buf, src_word, GetKeySchedule());
+  Ecc32MemArea::ReadBufferWithIntegrity(data, unscrambled_data, src_word);
 }
 
 void ScrambledEcc32MemArea::WriteBufferWithIntegrity(
     uint8_t buf[SV_MEM_WIDTH_BYTES], const EccWords &data, size_t start_idx,
     uint32_t dst_word) const {
   Ecc32MemArea::WriteBufferWithIntegrity(buf, data, start_idx, dst_word);
-  ScrambleBuffer(buf, dst_word);
+  ScrambleBuffer(buf, dst_word, GetKeySchedule());
 }
 
-void ScrambledEcc32MemArea::ScrambleBuffer(uint8_t buf[SV_MEM_WIDTH_BYTES],
-                                           uint32_t dst_word) const {
-  std::vector<uint8_t> scramble_buf(buf, buf + GetPhysWidthByte());
-
+void ScrambledEcc32MemArea::ScrambleBuffer(
+    uint8_t buf[SV_MEM_WIDTH_BYTES], uint32_t dst_word,
+    const ScrambleKeySchedule &ks) const {
   // Scramble data with integrity
-  scramble_buf = scramble_encrypt_data(
-      scramble_buf, GetPhysWidth(), 39, AddrIntToBytes(dst_word, addr_width_),
-      addr_width_, GetScrambleNonce(), GetScrambleKey(), repeat_keystream_,
-      false);
-
-  // Copy scrambled data to write buffer
-  std::copy(scramble_buf.begin(), scramble_buf.end(), &buf[0]);
+  uint64_t words[kPhysWords64];
+  BytesToWords64(words, buf, GetPhysWidthByte());
+  scramble_encrypt_data(words, words, GetPhysWidth(), dst_word, addr_width_, ks,
+                        repeat_keystream_);
+  Words64ToBytes(buf, words, GetPhysWidthByte());
 }
 
 uint32_t ScrambledEcc32MemArea::ToPhysAddr(uint32_t logical_addr) const {
+  return ToPhysAddr(logical_addr, GetKeySchedule());
+}
+
+uint32_t ScrambledEcc32MemArea::ToPhysAddr(
+    uint32_t logical_addr, const ScrambleKeySchedule &ks) const {
   // Scramble logical address to get physical address
-  return AddrBytesToInt(scramble_addr(AddrIntToBytes(logical_addr, addr_width_),
-                                      addr_width_, GetScrambleNonce(),
-                                      GetNonceWidth()));
+  return scramble_addr(logical_addr, addr_width_, ks);
 }
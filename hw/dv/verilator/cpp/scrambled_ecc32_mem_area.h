@@ -5,9 +5,11 @@
 #ifndef OPENTITAN_HW_DV_VERILATOR_CPP_SCRAMBLED_ECC32_MEM_AREA_H_
 #define OPENTITAN_HW_DV_VERILATOR_CPP_SCRAMBLED_ECC32_MEM_AREA_H_
 
+#include <memory>
 #include <vector>
 
 #include "ecc32_mem_area.h"
+#include "scramble_model.h"
 
 /**
  * A memory that implements scrambling over a 32-bit ECC integrity protection
@@ -32,13 +34,43 @@ class ScrambledEcc32MemArea : public Ecc32MemArea {
   ScrambledEcc32MemArea(const std::string &scope, uint32_t size,
                         uint32_t width_32, bool repeat_keystream = true);
 
+  /** Encode data to be written to this memory area at the given word offset
+   *
+   * This behaves like MemArea::EncodeWrite, but reads the scrambling key and
+   * nonce from the design just once and then encodes the words in parallel.
+   */
+  void EncodeWrite(uint32_t word_offset, const std::vector<uint8_t> &data,
+                   PhysBlock *block) const override;
+
+  /** Scrambling depends on the address, so this falls back to Write() */
+  void Fill(uint32_t word_offset, uint32_t num_words,
+            uint8_t value) const override;
+
+  /** The encoding tag includes the current scrambling key and nonce */
+  std::vector<uint8_t> GetEncodingTag() const override;
+
+  /** Read data from this memory area, starting at the given offset.
+   *
+   * This behaves like MemArea::Read, but reads the scrambling key and nonce
+   * from the design just once and then decodes the words in parallel.
+   */
+  std::vector<uint8_t> Read(uint32_t word_offset,
+                            uint32_t num_words) const override;
+
+  EccWords ReadWithIntegrity(uint32_t word_offset,
+                             uint32_t num_words) const override;
+
+  void WriteWithIntegrity(uint32_t word_offset,
+                          const EccWords &data) const override;
+
  private:
   void WriteBuffer(uint8_t buf[SV_MEM_WIDTH_BYTES],
                    const std::vector<uint8_t> &data, size_t start_idx,
                    uint32_t dst_word) const override;
 
-  std::vector<uint8_t> ReadUnscrambled(const uint8_t buf[SV_MEM_WIDTH_BYTES],
-                                       uint32_t src_word) const;
+  void ReadUnscrambled(uint8_t dst[SV_MEM_WIDTH_BYTES],
+                       const uint8_t buf[SV_MEM_WIDTH_BYTES], uint32_t src_word,
+                       const ScrambleKeySchedule &ks) const;
 
   void ReadBuffer(std::vector<uint8_t> &data,
                   const uint8_t buf[SV_MEM_WIDTH_BYTES],
@@ -52,20 +84,42 @@ class ScrambledEcc32MemArea : public Ecc32MemArea {
                                 const EccWords &data, size_t start_idx,
                                 uint32_t dst_word) const override;
 
-  void ScrambleBuffer(uint8_t buf[SV_MEM_WIDTH_BYTES], uint32_t dst_word) const;
+  void ScrambleBuffer(uint8_t buf[SV_MEM_WIDTH_BYTES], uint32_t dst_word,
+                      const ScrambleKeySchedule &ks) const;
 
   uint32_t ToPhysAddr(uint32_t logical_addr) const override;
+  uint32_t ToPhysAddr(uint32_t logical_addr,
+                      const ScrambleKeySchedule &ks) const;
 
-  uint32_t GetPhysWidth() const;
   uint32_t GetPhysWidthByte() const;
   uint32_t GetPrinceReplications() const;
   uint32_t GetNonceWidth() const;
   uint32_t GetNonceWidthByte() const;
 
-  std::vector<uint8_t> GetScrambleKey() const;
-  std::vector<uint8_t> GetScrambleNonce() const;
+  // The number of 32-bit words used to pass the key and nonce over DPI (see
+  // prim_util_get_scramble_params.svh)
+  static const uint32_t kScrKeyWords32 = 128 / 32;
+  static const uint32_t kScrNonceWords32 = 320 / 32;
+
+  // Read the raw scrambling key and nonce from the design
+  void ReadScrambleParams(svBitVecVal key[kScrKeyWords32],
+                          svBitVecVal nonce[kScrNonceWords32]) const;
+
+  // Get the key schedule for the design's current scrambling key and nonce.
+  // This is done once per block access, rather than once per word. The key
+  // and nonce are still read from the design each time (they change whenever
+  // the memory is re-keyed), but the schedule is cached and only rebuilt
+  // when they differ from the last call.
+  const ScrambleKeySchedule &GetKeySchedule() const;
 
   std::string scr_scope_;
+  mutable svScope scr_sv_scope_;  ///< Cached handle for scr_scope_, or null
+
+  // The key schedule most recently returned by GetKeySchedule() and the raw
+  // key and nonce it was built from
+  mutable std::unique_ptr<ScrambleKeySchedule> cached_ks_;
+  mutable svBitVecVal cached_key_[kScrKeyWords32];
+  mutable svBitVecVal cached_nonce_[kScrNonceWords32];
   uint32_t addr_width_;
   bool repeat_keystream_;
 };
@@ -6,30 +6,38 @@
 
 #include <cassert>
 #include <sstream>
+#include <unordered_map>
 
-// Set scope by name, returning the old scope. If the name doesn't describe a
-// valid scope, throw an SVScoped::Error.
-static svScope SetAbsScope(const std::string &name) {
-  svScope new_scope = svGetScopeFromName(name.c_str());
-  if (!new_scope)
+// Look up a scope by its absolute name. Scopes live as long as the
+// simulation, so successful lookups are memoized. If the name doesn't
+// describe a valid scope, throw an SVScoped::Error.
+static svScope GetAbsScope(const std::string &name) {
+  static std::unordered_map<std::string, svScope> known_scopes;
+
+  auto it = known_scopes.find(name);
+  if (it != known_scopes.end())
+    return it->second;
+
+  svScope scope = svGetScopeFromName(name.c_str());
+  if (!scope)
     throw SVScoped::Error(name);
-  return svSetScope(new_scope);
+  known_scopes.emplace(name, scope);
+  return scope;
 }
 
 // Resolve name to a scope, using the rules described in the comment above the
-// class in sv_scoped.h, and then set it. Returns the old scope.
-static svScope SetRelScope(const std::string &name) {
+// class in sv_scoped.h.
+static svScope GetRelScope(const std::string &name) {
   // Absolute (or empty) names resolve to themselves
   if (name[0] != '.') {
-    return SetAbsScope(name);
+    return GetAbsScope(name);
   }
 
-  svScope prev_scope = svGetScope();
+  svScope cur_scope = svGetScope();
 
-  // Special case: If name is ".", it means to use the current scope. Rather
-  // than changing scope, we can just return where we are going to stay.
+  // Special case: If name is ".", it means to use the current scope.
   if (name == ".")
-    return prev_scope;
+    return cur_scope;
 
   // For anything else, count how many dots appear after the first one (so
   // ..foo gives an up_count of 1; ...bar gives an up_count of 2).
@@ -43,7 +51,7 @@ static svScope SetRelScope(const std::string &name) {
   size_t up_count = first_not_dot - 1;
 
   // Get the name of the current scope, so that we can perform surgery.
-  std::string scope_name = svGetNameFromScope(prev_scope);
+  std::string scope_name = svGetNameFromScope(cur_scope);
 
   // scope_name will look something like "TOP.foo.bar". Search up_count
   // dots from the end, setting last_dot to point at the last dot that should
@@ -82,10 +90,22 @@ static svScope SetRelScope(const std::string &name) {
     scope_name.append(name, first_not_dot - 1, std::string::npos);
   }
 
-  return SetAbsScope(scope_name);
+  return GetAbsScope(scope_name);
 }
 
-SVScoped::SVScoped(const std::string &name) : prev_scope_(SetRelScope(name)) {}
+svScope SVScoped::Resolve(const std::string &name, svScope *cache) {
+  if (cache && *cache)
+    return *cache;
+
+  svScope scope = GetRelScope(name);
+
+  // A relative name resolves differently depending on the current scope, so
+  // only absolute names can be cached.
+  if (cache && name[0] != '.')
+    *cache = scope;
+
+  return scope;
+}
 
 SVScoped::Error::Error(const std::string &scope_name)
     : scope_name_(scope_name) {
@@ -27,13 +27,36 @@
  * resolves to the scope with name "TOP.foo.baz". The string "qux" resolves to
  * the scope with name "qux".
  *
+ * Resolving a name costs a string lookup in the simulator (and, for relative
+ * names, some string surgery), so code that switches to the same scope on a
+ * hot path should resolve it once with Resolve() and then construct the guard
+ * from the resulting handle.
+ *
  * This guard restores the previous scope at destruction.
  */
 class SVScoped {
  public:
-  SVScoped(const std::string &name);
+  SVScoped(const std::string &name) : SVScoped(Resolve(name)) {}
+
+  /** Switch to a scope that has already been resolved */
+  explicit SVScoped(svScope scope) : prev_scope_(svSetScope(scope)) {
+    assert(scope);
+  }
+
   ~SVScoped() { svSetScope(prev_scope_); }
 
+  /**
+   * Resolve name to a scope handle without changing the current scope.
+   *
+   * Relative names are resolved against the current scope. Lookups of
+   * absolute names are memoized. If cache is not null and name is absolute,
+   * the handle is also stored in *cache and a later call with the same cache
+   * returns it without any lookup.
+   *
+   * Throws an SVScoped::Error if the scope doesn't exist.
+   */
+  static svScope Resolve(const std::string &name, svScope *cache = nullptr);
+
   class Error : public std::exception {
    public:
     Error(const std::string &scope_name);
@@ -13,20 +13,9 @@
 #include <string>
 #include <vector>
 
-namespace {
-// An instruction to load the file at filepath to the memory called name. If
-// name is the empty string then type must be kMemImageElf and this is an
-// instruction to load an ELF file, picking memories by LMA.
-struct LoadArg {
-  std::string name;
-  std::string filepath;
-  MemImageType type;
-};
-}  // namespace
-
 // Parse a meminit command-line argument. This should be of the form
 // mem_area,file[,type]. Throw a std::runtime_error if something looks wrong.
-static LoadArg ParseMemArg(std::string mem_argument) {
+static MemImageLoad ParseMemArg(std::string mem_argument) {
   std::array<std::string, 3> args;
   size_t pos = 0;
   size_t end_pos = 0;
@@ -80,6 +69,9 @@ static void PrintHelp() {
                "  Print registered memory regions\n\n"
                "--verbose-mem-load\n"
                "  Print a message for each memory load\n\n"
+               "--mem-image-cache=DIR\n"
+               "  Cache encoded memory images (with ECC and scrambling) in\n"
+               "  DIR and reuse them in later simulations\n\n"
                "-h|--help\n"
                "  Show help\n\n";
 }
@@ -101,12 +93,14 @@ bool VerilatorMemUtil::ParseCLIArguments(int argc, char **argv,
       {"otpinit", required_argument, nullptr, 'o'},
       {"meminit", required_argument, nullptr, 'l'},
       {"verbose-mem-load", no_argument, nullptr, 'V'},
+      {"mem-image-cache", required_argument, nullptr, 'C'},
       {"load-elf", required_argument, nullptr, 'E'},
       {"help", no_argument, nullptr, 'h'},
       {nullptr, no_argument, nullptr, 0}};
 
-  std::vector<LoadArg> load_args;
+  std::vector<MemImageLoad> load_args;
   bool verbose = false;
+  const char *image_cache_dir = nullptr;
 
   // Reset the command parsing index in-case other utils have already parsed
   // some arguments
@@ -158,6 +152,9 @@ bool VerilatorMemUtil::ParseCLIArguments(int argc, char **argv,
       case 'V':
         verbose = true;
         break;
+      case 'C':
+        image_cache_dir = optarg;
+        break;
       case 'E':
         load_args.push_back(
             {.name = "", .filepath = optarg, .type = kMemImageElf});
@@ -175,19 +172,16 @@ bool VerilatorMemUtil::ParseCLIArguments(int argc, char **argv,
     }
   }
 
-  for (const LoadArg &arg : load_args) {
-    try {
-      if (!arg.name.empty()) {
-        mem_util_->LoadFileToNamedMem(verbose, arg.name, arg.filepath,
-                                      arg.type);
-      } else {
-        assert(arg.type == kMemImageElf);
-        mem_util_->LoadElfToMemories(verbose, arg.filepath);
-      }
-    } catch (const std::exception &err) {
-      std::cerr << "ERROR: " << err.what() << std::endl;
-      return false;
+  // Do all the loads together, so that independent memories can be loaded in
+  // parallel.
+  try {
+    if (image_cache_dir) {
+      mem_util_->SetImageCacheDir(image_cache_dir);
     }
+    mem_util_->LoadImages(verbose, load_args);
+  } catch (const std::exception &err) {
+    std::cerr << "ERROR: " << err.what() << std::endl;
+    return false;
   }
 
   return true;
@@ -8,6 +8,7 @@
 // A wrapper class that converts a DpiMemutil into a SimCtrlExtension
 //
 
+#include <climits>
 #include <memory>
 
 #include "dpi_memutil.h"
@@ -23,6 +24,11 @@ class VerilatorMemUtil : public SimCtrlExtension {
   // Declared in SimCtrlExtension
   bool ParseCLIArguments(int argc, char **argv, bool &exit_app) override;
 
+  // Memory loading is done up front, so this never needs to see a clock edge
+  unsigned long QuiescentUntil(unsigned long cycle) override {
+    return ULONG_MAX;
+  }
+
   // Get underlying DpiMemUtil object
   DpiMemUtil *GetUnderlying() { return mem_util_; }
 
@@ -0,0 +1,258 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "verilator_pc_profile.h"
+
+#include <cassert>
+#include <cstring>
+#include <fstream>
+#include <getopt.h>
+#include <iostream>
+#include <svdpi.h>
+
+// Calls nested deeper than this (e.g. through unbounded recursion, or because
+// returns are not recognised) are charged to the deepest frame.
+static const size_t kMaxStackDepth = 256;
+
+static const uint32_t kInsnMret = 0x30200073;
+
+// x1 (ra) and x5 (t0) are the link registers of the RISC-V calling convention
+static bool IsLinkReg(uint32_t reg) { return reg == 1 || reg == 5; }
+
+enum ControlFlow { kControlFlowOther, kControlFlowCall, kControlFlowReturn };
+
+// Classify an instruction as a call, a return or anything else, following the
+// return address stack hints in the RISC-V unprivileged spec. For compressed
+// instructions, insn holds the 16-bit encoding.
+static ControlFlow DecodeControlFlow(uint32_t insn) {
+  if ((insn & 3) == 3) {
+    uint32_t opcode = insn & 0x7f;
+    uint32_t rd = (insn >> 7) & 0x1f;
+    uint32_t rs1 = (insn >> 15) & 0x1f;
+    if (opcode == 0x6f) {  // jal
+      return IsLinkReg(rd) ? kControlFlowCall : kControlFlowOther;
+    }
+    if (opcode == 0x67) {  // jalr
+      if (IsLinkReg(rd))
+        return kControlFlowCall;
+      if (rd == 0 && IsLinkReg(rs1))
+        return kControlFlowReturn;
+      return kControlFlowOther;
+    }
+    return insn == kInsnMret ? kControlFlowReturn : kControlFlowOther;
+  }
+
+  uint32_t op = insn & 3;
+  uint32_t funct3 = (insn >> 13) & 7;
+  if (op == 1 && funct3 == 1) {  // c.jal
+    return kControlFlowCall;
+  }
+  uint32_t rs1 = (insn >> 7) & 0x1f;
+  uint32_t rs2 = (insn >> 2) & 0x1f;
+  if (op == 2 && funct3 == 4 && rs1 != 0 && rs2 == 0) {
+    if (insn & (1 << 12))  // c.jalr
+      return kControlFlowCall;
+    if (IsLinkReg(rs1))  // c.jr
+      return kControlFlowReturn;
+  }
+  return kControlFlowOther;
+}
+
+// Print a usage message to stdout
+static void PrintHelp() {
+  std::cout << "Instruction profile:\n\n"
+               "--pc-profile=FILE\n"
+               "  Write a per-PC profile of the Ibex core to FILE, in folded\n"
+               "  stack format\n\n"
+               "--pc-profile-metric=cycles|stalls|instrs\n"
+               "  Count cycles (default), stall cycles or retired\n"
+               "  instructions\n\n";
+}
+
+VerilatorPcProfile *VerilatorPcProfile::active_ = nullptr;
+
+VerilatorPcProfile::VerilatorPcProfile(const ElfSymbolMemUtil *symbols)
+    : symbols_(symbols),
+      metric_(kMetricCycles),
+      root_{0, {}, {}},
+      overflow_(0),
+      next_pc_(0),
+      instrs_(0),
+      cycles_(0) {
+  assert(symbols);
+}
+
+VerilatorPcProfile::~VerilatorPcProfile() {
+  if (active_ == this) {
+    active_ = nullptr;
+  }
+}
+
+bool VerilatorPcProfile::ParseCLIArguments(int argc, char **argv,
+                                           bool &exit_app) {
+  const struct option long_options[] = {
+      {"pc-profile", required_argument, nullptr, 'p'},
+      {"pc-profile-metric", required_argument, nullptr, 'M'},
+      {"help", no_argument, nullptr, 'h'},
+      {nullptr, no_argument, nullptr, 0}};
+
+  // Reset the command parsing index in-case other utils have already parsed
+  // some arguments
+  optind = 1;
+  while (1) {
+    int c = getopt_long(argc, argv, "-:h", long_options, nullptr);
+    if (c == -1) {
+      break;
+    }
+
+    // Disable error reporting by getopt
+    opterr = 0;
+
+    switch (c) {
+      case 'p':
+        path_ = optarg;
+        break;
+      case 'M':
+        if (strcmp(optarg, "cycles") == 0) {
+          metric_ = kMetricCycles;
+        } else if (strcmp(optarg, "stalls") == 0) {
+          metric_ = kMetricStalls;
+        } else if (strcmp(optarg, "instrs") == 0) {
+          metric_ = kMetricInstrs;
+        } else {
+          std::cerr << "ERROR: Unknown profile metric: " << optarg
+                    << std::endl;
+          return false;
+        }
+        break;
+      case 'h':
+        PrintHelp();
+        return true;
+      default:;
+        // Ignore unrecognized options since they might be consumed by
+        // other utils
+    }
+  }
+
+  if (!path_.empty()) {
+    active_ = this;
+  }
+  return true;
+}
+
+void VerilatorPcProfile::PostExec() {
+  if (path_.empty()) {
+    return;
+  }
+  active_ = nullptr;
+
+  std::ofstream os(path_);
+  if (!os) {
+    std::cerr << "ERROR: Cannot open `" << path_ << "' for writing."
+              << std::endl;
+    return;
+  }
+  Write(os);
+  std::cout << std::endl
+            << "PC profile of " << instrs_ << " instructions in " << cycles_
+            << " cycles written to " << path_ << std::endl;
+}
+
+void VerilatorPcProfile::OnRetire(uint32_t pc, uint32_t next_pc, uint32_t insn,
+                                  bool intr, uint32_t cycles) {
+  // A trap handler runs on top of whatever was interrupted, and normally
+  // returns to where the core would have continued.
+  if (intr) {
+    Push(pc, next_pc_);
+  }
+
+  Node *node = stack_.empty() ? &root_ : stack_.back().node;
+  PcCounts &counts = node->pcs[pc];
+  ++counts.instrs;
+  counts.cycles += cycles;
+  ++instrs_;
+  cycles_ += cycles;
+
+  switch (DecodeControlFlow(insn)) {
+    case kControlFlowCall:
+      Push(next_pc, pc + ((insn & 3) == 3 ? 4 : 2));
+      break;
+    case kControlFlowReturn:
+      Pop(next_pc);
+      break;
+    default:
+      break;
+  }
+  next_pc_ = next_pc;
+}
+
+void VerilatorPcProfile::Push(uint32_t entry, uint32_t return_addr) {
+  if (stack_.size() >= kMaxStackDepth) {
+    ++overflow_;
+    return;
+  }
+
+  Node *parent = stack_.empty() ? &root_ : stack_.back().node;
+  std::unique_ptr<Node> &child = parent->children[entry];
+  if (!child) {
+    child.reset(new Node{entry, {}, {}});
+  }
+  stack_.push_back({child.get(), return_addr});
+}
+
+void VerilatorPcProfile::Pop(uint32_t target) {
+  if (overflow_) {
+    --overflow_;
+    return;
+  }
+
+  // Unwind to the frame that returns to target, which also drops frames that
+  // were left without returning (e.g. by a tail call or a longjmp). If no
+  // frame matches, assume that the innermost one returned.
+  for (size_t depth = stack_.size(); depth > 0; --depth) {
+    if (stack_[depth - 1].return_addr == target) {
+      stack_.resize(depth - 1);
+      return;
+    }
+  }
+  if (!stack_.empty()) {
+    stack_.pop_back();
+  }
+}
+
+void VerilatorPcProfile::Write(std::ostream &os) const {
+  WriteNode(os, root_, "");
+}
+
+void VerilatorPcProfile::WriteNode(std::ostream &os, const Node &node,
+                                   const std::string &prefix) const {
+  // Sort by PC so that the output doesn't depend on hashing
+  std::map<uint32_t, PcCounts> pcs(node.pcs.begin(), node.pcs.end());
+  for (const auto &pr : pcs) {
+    uint64_t value = pr.second.cycles;
+    if (metric_ == kMetricStalls) {
+      value -= pr.second.instrs;
+    } else if (metric_ == kMetricInstrs) {
+      value = pr.second.instrs;
+    }
+    if (value) {
+      os << prefix << symbols_->FormatAddr(pr.first) << " " << value << "\n";
+    }
+  }
+
+  for (const auto &pr : node.children) {
+    WriteNode(os, *pr.second, prefix + symbols_->FormatAddr(pr.first) + ";");
+  }
+}
+
+extern "C" {
+svBit pc_profile_enabled() { return VerilatorPcProfile::Active() != nullptr; }
+
+void pc_profile_retire(int pc, int next_pc, int insn, svBit intr, int cycles) {
+  VerilatorPcProfile *profile = VerilatorPcProfile::Active();
+  if (profile) {
+    profile->OnRetire(pc, next_pc, insn, intr, cycles);
+  }
+}
+}
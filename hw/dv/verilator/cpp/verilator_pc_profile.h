@@ -0,0 +1,110 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+#ifndef OPENTITAN_HW_DV_VERILATOR_CPP_VERILATOR_PC_PROFILE_H_
+#define OPENTITAN_HW_DV_VERILATOR_CPP_VERILATOR_PC_PROFILE_H_
+
+//
+// A per-PC instruction profile of the Ibex core, as a SimCtrlExtension
+//
+
+#include <climits>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "elf_symbol_memutil.h"
+#include "sim_ctrl_extension.h"
+
+// The testbench reports each instruction retired by the core (as seen on the
+// RISC-V Formal Interface) through the pc_profile_retire DPI function, with
+// the number of core clock cycles since the previous instruction retired.
+// Those cycles are charged to the instruction: one for issuing it and the
+// rest as stall cycles (e.g. waiting for a fetch, a load or the multiplier).
+//
+// Calls and returns are followed with a shadow call stack, so each PC is
+// counted under the chain of functions that led to it. With --pc-profile=FILE
+// the profile is written to FILE at the end of the simulation in the folded
+// stack format understood by flamegraph.pl, speedscope and pprof's importers:
+// one line per stack and PC, such as
+//
+//   rom_main;hmac_sha256;hmac_sha256+0x1c 120
+//
+// The last frame is the PC itself. Addresses are resolved against the symbols
+// of the ELF files that the ElfSymbolMemUtil loaded.
+class VerilatorPcProfile : public SimCtrlExtension {
+ public:
+  // Does not take ownership of symbols
+  explicit VerilatorPcProfile(const ElfSymbolMemUtil *symbols);
+  ~VerilatorPcProfile() override;
+
+  // Declared in SimCtrlExtension
+  bool ParseCLIArguments(int argc, char **argv, bool &exit_app) override;
+  void PostExec() override;
+
+  // Retirements are reported by the model, so this never needs a clock edge
+  unsigned long QuiescentUntil(unsigned long cycle) override {
+    return ULONG_MAX;
+  }
+
+  // Called (through DPI) for each retired instruction. next_pc is the address
+  // of the next instruction, intr is set for the first instruction of a trap
+  // handler and cycles is at least 1.
+  void OnRetire(uint32_t pc, uint32_t next_pc, uint32_t insn, bool intr,
+                uint32_t cycles);
+
+  // Write the profile in folded stack format
+  void Write(std::ostream &os) const;
+
+  // The profile that the DPI functions report to, or null if profiling is
+  // disabled.
+  static VerilatorPcProfile *Active() { return active_; }
+
+ private:
+  enum Metric { kMetricCycles, kMetricStalls, kMetricInstrs };
+
+  struct PcCounts {
+    uint64_t instrs;
+    uint64_t cycles;
+  };
+
+  // A node of the call tree, for a call to the function at entry
+  struct Node {
+    uint32_t entry;
+    std::map<uint32_t, std::unique_ptr<Node>> children;
+    std::unordered_map<uint32_t, PcCounts> pcs;
+  };
+
+  // An entry of the shadow call stack: the callee's node and the address the
+  // call returns to.
+  struct Frame {
+    Node *node;
+    uint32_t return_addr;
+  };
+
+  void Push(uint32_t entry, uint32_t return_addr);
+  void Pop(uint32_t target);
+  void WriteNode(std::ostream &os, const Node &node,
+                 const std::string &prefix) const;
+
+  static VerilatorPcProfile *active_;
+
+  const ElfSymbolMemUtil *symbols_;
+  std::string path_;
+  Metric metric_;
+  Node root_;
+  std::vector<Frame> stack_;
+  // Calls deeper than the stack limit, which are counted in the caller
+  unsigned overflow_;
+  // The PC the core would have run next, had it not taken a trap
+  uint32_t next_pc_;
+  uint64_t instrs_;
+  uint64_t cycles_;
+};
+
+#endif  // OPENTITAN_HW_DV_VERILATOR_CPP_VERILATOR_PC_PROFILE_H_
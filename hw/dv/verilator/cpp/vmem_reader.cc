@@ -0,0 +1,240 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "vmem_reader.h"
+
+#include <cassert>
+#include <cstring>
+#include <fcntl.h>
+#include <sstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+static std::string VmemErrorMsg(const std::string &path, unsigned line,
+                                const std::string &msg) {
+  std::ostringstream oss;
+  oss << "Failed to load VMEM file at `" << path << "'";
+  if (line)
+    oss << ", line " << line;
+  oss << ": " << msg;
+  return oss.str();
+}
+
+VmemError::VmemError(const std::string &path, unsigned line,
+                     const std::string &msg)
+    : std::runtime_error(VmemErrorMsg(path, line, msg)) {}
+
+namespace {
+// A read-only mapping of a whole file
+class MappedFile {
+ public:
+  explicit MappedFile(const std::string &path) : data_(nullptr), size_(0) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+      throw VmemError(path, 0, "could not open file.");
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+      close(fd);
+      throw VmemError(path, 0, "could not get file size.");
+    }
+
+    size_ = st.st_size;
+    if (size_) {
+      void *mapping = mmap(NULL, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (mapping == MAP_FAILED) {
+        close(fd);
+        throw VmemError(path, 0, "could not map file.");
+      }
+      data_ = static_cast<const char *>(mapping);
+    }
+    close(fd);
+  }
+
+  ~MappedFile() {
+    if (data_)
+      munmap(const_cast<char *>(data_), size_);
+  }
+
+  const char *data() const { return data_; }
+  size_t size() const { return size_; }
+
+ private:
+  const char *data_;
+  size_t size_;
+};
+
+// Return the value of c as a hex digit, or -1 if it isn't one.
+int HexDigit(char c) {
+  if ('0' <= c && c <= '9')
+    return c - '0';
+  if ('a' <= c && c <= 'f')
+    return 10 + c - 'a';
+  if ('A' <= c && c <= 'F')
+    return 10 + c - 'A';
+  return -1;
+}
+
+bool IsSpace(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' ||
+         c == '\v';
+}
+
+// A tokenizer for VMEM files. Tracks line numbers for error messages.
+class VmemScanner {
+ public:
+  VmemScanner(const std::string &path, const char *data, size_t size)
+      : path_(path), pos_(data), end_(data + size), line_(1) {}
+
+  // Skip whitespace and comments. Returns false at the end of the file.
+  bool SkipToToken() {
+    while (pos_ < end_) {
+      char c = *pos_;
+      if (c == '\n') {
+        ++line_;
+        ++pos_;
+      } else if (IsSpace(c)) {
+        ++pos_;
+      } else if (c == '/' && pos_ + 1 < end_ && pos_[1] == '/') {
+        const char *eol =
+            static_cast<const char *>(memchr(pos_, '\n', end_ - pos_));
+        pos_ = eol ? eol : end_;
+      } else if (c == '/' && pos_ + 1 < end_ && pos_[1] == '*') {
+        unsigned start_line = line_;
+        pos_ += 2;
+        for (;;) {
+          if (pos_ + 1 >= end_)
+            throw VmemError(path_, start_line, "unterminated comment.");
+          if (pos_[0] == '*' && pos_[1] == '/')
+            break;
+          if (*pos_ == '\n')
+            ++line_;
+          ++pos_;
+        }
+        pos_ += 2;
+      } else {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Read a token, which is everything up to the next whitespace or comment
+  // (or the end of the file). The scanner must be at the start of a token.
+  std::pair<const char *, const char *> ReadToken() {
+    const char *start = pos_;
+    while (pos_ < end_ && !IsSpace(*pos_) && *pos_ != '/') {
+      ++pos_;
+    }
+    return std::make_pair(start, pos_);
+  }
+
+  char Peek() const {
+    assert(pos_ < end_);
+    return *pos_;
+  }
+  void Advance() { ++pos_; }
+
+  [[noreturn]] void Fail(const std::string &msg) const {
+    throw VmemError(path_, line_, msg);
+  }
+
+ private:
+  const std::string &path_;
+  const char *pos_;
+  const char *end_;
+  unsigned line_;
+};
+}  // namespace
+
+// Parse the hex number in [start, end) into nbytes little-endian bytes at dst.
+// If it doesn't fit in width bits, or has invalid characters, fails with a
+// message from scanner.
+static void ParseHex(const VmemScanner &scanner, const char *start,
+                     const char *end, uint32_t width, uint8_t *dst,
+                     size_t nbytes, const char *what) {
+  memset(dst, 0, nbytes);
+
+  bool any_digits = false;
+  uint32_t bit = 0;
+  for (const char *p = end; p != start; --p) {
+    char c = p[-1];
+    if (c == '_')
+      continue;
+
+    int digit = HexDigit(c);
+    if (digit < 0) {
+      std::ostringstream oss;
+      if (c == 'x' || c == 'X' || c == 'z' || c == 'Z' || c == '?') {
+        oss << "unknown digits (x or z) in " << what << " `"
+            << std::string(start, end) << "' are not supported.";
+      } else {
+        oss << "invalid character `" << c << "' in " << what << " `"
+            << std::string(start, end) << "'.";
+      }
+      scanner.Fail(oss.str());
+    }
+    any_digits = true;
+
+    if (digit) {
+      // The top set bit of this digit must be inside the word
+      uint32_t top_bit = bit + (digit >= 8 ? 3 : digit >= 4 ? 2 : digit >= 2);
+      if (top_bit >= width) {
+        std::ostringstream oss;
+        oss << what << " `" << std::string(start, end)
+            << "' doesn't fit in " << width << " bits.";
+        scanner.Fail(oss.str());
+      }
+      dst[bit / 8] |= digit << (bit % 8);
+    }
+    bit += 4;
+  }
+
+  if (!any_digits) {
+    std::ostringstream oss;
+    oss << "empty " << what << ".";
+    scanner.Fail(oss.str());
+  }
+}
+
+void ReadVmemFile(const std::string &path, uint32_t width, uint32_t depth,
+                  const std::function<void(uint32_t, const uint8_t *)> &fn) {
+  assert(width > 0);
+
+  MappedFile file(path);
+  VmemScanner scanner(path, file.data(), file.size());
+
+  size_t nbytes = (width + 7) / 8;
+  std::vector<uint8_t> word(nbytes);
+  uint8_t addr_bytes[4];
+
+  // addr is 64 bits wide so that incrementing past the last word can't wrap
+  uint64_t addr = 0;
+  while (scanner.SkipToToken()) {
+    if (scanner.Peek() == '@') {
+      scanner.Advance();
+      auto tok = scanner.ReadToken();
+      ParseHex(scanner, tok.first, tok.second, 32, addr_bytes, 4, "address");
+      addr = (uint32_t)addr_bytes[0] | ((uint32_t)addr_bytes[1] << 8) |
+             ((uint32_t)addr_bytes[2] << 16) | ((uint32_t)addr_bytes[3] << 24);
+      continue;
+    }
+
+    auto tok = scanner.ReadToken();
+    ParseHex(scanner, tok.first, tok.second, width, &word[0], nbytes, "word");
+
+    if (addr >= depth) {
+      std::ostringstream oss;
+      oss << "word at address 0x" << std::hex << addr
+          << " is past the end of the memory, which has 0x" << depth
+          << " words.";
+      scanner.Fail(oss.str());
+    }
+
+    fn(addr, &word[0]);
+    ++addr;
+  }
+}
@@ -0,0 +1,47 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+#ifndef OPENTITAN_HW_DV_VERILATOR_CPP_VMEM_READER_H_
+#define OPENTITAN_HW_DV_VERILATOR_CPP_VMEM_READER_H_
+
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <string>
+
+/**
+ * An error when reading a VMEM file, with the path and line number where it
+ * happened.
+ */
+class VmemError : public std::runtime_error {
+ public:
+  VmemError(const std::string &path, unsigned line, const std::string &msg);
+};
+
+/**
+ * Read the VMEM file at path, calling fn once for each word
+ *
+ * The format is the one accepted by $readmemh: a sequence of hexadecimal words
+ * separated by whitespace, optionally with underscores between digits. A
+ * token of the form @ADDR (with ADDR in hexadecimal) sets the word address of
+ * the next word. Addresses otherwise increment by one with each word. Comments
+ * run from // to the end of the line or are C-style block comments.
+ *
+ * Words hold raw memory contents, so for memories with ECC bits (such as the
+ * 39-bit ROM words) or scrambling (.scr.vmem files), the file has the encoded
+ * values and addresses. Unknown digits (x or z) aren't supported.
+ *
+ * @param path        The file to read
+ * @param width       The width of each word in bits
+ * @param depth       The number of words in the memory. Addresses must be
+ *                    less than this.
+ * @param fn          Called as fn(addr, word) for each word, where word points
+ *                    at the (width + 7) / 8 bytes of the word, least
+ *                    significant byte first.
+ *
+ * If the file can't be read or doesn't parse, throws a VmemError.
+ */
+void ReadVmemFile(const std::string &path, uint32_t width, uint32_t depth,
+                  const std::function<void(uint32_t, const uint8_t *)> &fn);
+
+#endif  // OPENTITAN_HW_DV_VERILATOR_CPP_VMEM_READER_H_
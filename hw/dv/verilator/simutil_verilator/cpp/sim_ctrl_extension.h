@@ -5,6 +5,10 @@
 #ifndef OPENTITAN_HW_DV_VERILATOR_SIMUTIL_VERILATOR_CPP_SIM_CTRL_EXTENSION_H_
 #define OPENTITAN_HW_DV_VERILATOR_SIMUTIL_VERILATOR_CPP_SIM_CTRL_EXTENSION_H_
 
+// Defined by Verilator's verilated_save.h (only used for checkpointing)
+class VerilatedSerialize;
+class VerilatedDeserialize;
+
 class SimCtrlExtension {
  public:
   virtual ~SimCtrlExtension() = default;
@@ -39,6 +43,40 @@ class SimCtrlExtension {
    */
   virtual void OnClock(unsigned long sim_time) {}
 
+  /**
+   * Report how long this extension can run without OnClock() being called
+   *
+   * This is only used if fast-forwarding has been enabled in the simulation
+   * controller. Return the first clock cycle at which OnClock() must be called
+   * again. If every extension is quiescent until some future cycle, the
+   * simulation controller may skip calling OnClock() and tracing until then.
+   *
+   * The default implementation returns 0, meaning that the extension needs to
+   * see every clock edge. An extension that never needs OnClock() can return
+   * ULONG_MAX.
+   *
+   * @param cycle The next clock cycle that would be simulated
+   */
+  virtual unsigned long QuiescentUntil(unsigned long cycle) { return 0; }
+
+  /**
+   * Save extension state as part of a simulation checkpoint
+   *
+   * This is called after the model state has been written. Extensions that
+   * keep state which affects the simulation (rather than just setting it up)
+   * should write it to os, and read it back in the same order in
+   * RestoreState().
+   */
+  virtual void SaveState(VerilatedSerialize &os) {}
+
+  /**
+   * Restore extension state from a simulation checkpoint
+   *
+   * This is called after the model state has been restored and before the
+   * simulation starts running.
+   */
+  virtual void RestoreState(VerilatedDeserialize &is) {}
+
   /**
    * Function to be called after executing the simulation
    */
@@ -0,0 +1,222 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "sim_profiler.h"
+
+#include <algorithm>
+#include <cxxabi.h>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <typeinfo>
+
+// The name of an extension's class, used to label its counter
+static std::string ExtensionName(const SimCtrlExtension *ext) {
+  const char *mangled = typeid(*ext).name();
+  int status;
+  char *demangled = abi::__cxa_demangle(mangled, nullptr, nullptr, &status);
+  std::string name = (status == 0 && demangled) ? demangled : mangled;
+  free(demangled);
+  return name;
+}
+
+// Write str as a JSON string. Counter names are identifiers, but escape
+// anything unusual anyway.
+static void WriteJsonString(std::ostream &os, const std::string &str) {
+  os << '"';
+  for (char c : str) {
+    if (c == '"' || c == '\\') {
+      os << '\\' << c;
+    } else if ((unsigned char)c < 0x20) {
+      os << "\\u" << std::hex << std::setw(4) << std::setfill('0') << (int)c
+         << std::dec << std::setfill(' ');
+    } else {
+      os << c;
+    }
+  }
+  os << '"';
+}
+
+SimProfiler::SimProfiler()
+    : enabled_(false),
+      sample_interval_(0),
+      next_sample_cycle_(0),
+      start_ns_(0),
+      sample_ns_(0),
+      sample_cycle_(0),
+      stop_ns_(0),
+      eval_{"eval", 0, 0, 0, 0},
+      trace_{"trace", 0, 0, 0, 0} {}
+
+void SimProfiler::Enable() {
+  enabled_ = true;
+  dpi_profile_set_enabled(true);
+}
+
+void SimProfiler::SetSampleInterval(unsigned long interval,
+                                    const std::string &path) {
+  sample_interval_ = interval;
+  sample_path_ = path;
+}
+
+void SimProfiler::Start(const std::vector<SimCtrlExtension *> &extensions) {
+  if (!enabled_) {
+    return;
+  }
+
+  extensions_.clear();
+  for (const SimCtrlExtension *ext : extensions) {
+    extensions_.push_back({ExtensionName(ext), 0, 0, 0, 0});
+  }
+
+  if (sample_interval_) {
+    sample_file_.open(sample_path_);
+    if (!sample_file_) {
+      std::cerr << "ERROR: Unable to open profile sample file " << sample_path_
+                << " for writing. Disabling sampling." << std::endl;
+      sample_interval_ = 0;
+    }
+  }
+
+  start_ns_ = sample_ns_ = dpi_profile_now_ns();
+  sample_cycle_ = 0;
+  next_sample_cycle_ = sample_interval_;
+}
+
+void SimProfiler::Stop(unsigned long cycle) {
+  if (!enabled_) {
+    return;
+  }
+  if (sample_interval_ && cycle > sample_cycle_) {
+    WriteSample(cycle);
+  }
+  next_sample_cycle_ = 0;
+  stop_ns_ = dpi_profile_now_ns();
+  sample_file_.close();
+}
+
+// Write a counter's activity since the previous sample as "name":{...}, and
+// start a new sample period for it.
+static void WriteSampleCounter(std::ostream &os, const std::string &name,
+                               uint64_t calls, uint64_t total_ns,
+                               uint64_t *sample_calls, uint64_t *sample_ns) {
+  WriteJsonString(os, name);
+  os << ":{\"calls\":" << calls - *sample_calls
+     << ",\"ns\":" << total_ns - *sample_ns << "}";
+  *sample_calls = calls;
+  *sample_ns = total_ns;
+}
+
+void SimProfiler::WriteSample(unsigned long cycle) {
+  uint64_t now_ns = dpi_profile_now_ns();
+  double elapsed_s = (now_ns - sample_ns_) / 1e9;
+  double cycles_per_s =
+      elapsed_s > 0 ? (cycle - sample_cycle_) / elapsed_s : 0.0;
+
+  std::ostream &os = sample_file_;
+  os << "{\"cycle\":" << cycle
+     << ",\"wall_s\":" << (now_ns - start_ns_) / 1e9
+     << ",\"cycles_per_s\":" << cycles_per_s << ",";
+  WriteSampleCounter(os, eval_.name, eval_.calls, eval_.total_ns,
+                     &eval_.sample_calls, &eval_.sample_ns);
+  os << ",";
+  WriteSampleCounter(os, trace_.name, trace_.calls, trace_.total_ns,
+                     &trace_.sample_calls, &trace_.sample_ns);
+
+  os << ",\"extensions\":{";
+  for (size_t i = 0; i < extensions_.size(); ++i) {
+    Counter &ext = extensions_[i];
+    os << (i ? "," : "");
+    WriteSampleCounter(os, ext.name, ext.calls, ext.total_ns,
+                       &ext.sample_calls, &ext.sample_ns);
+  }
+
+  os << "},\"dpi\":{";
+  bool first = true;
+  for (const dpi_profile_counter *dpi = dpi_profile_counters(); dpi;
+       dpi = dpi->next) {
+    std::pair<uint64_t, uint64_t> &prev = dpi_samples_[dpi];
+    os << (first ? "" : ",");
+    WriteSampleCounter(os, dpi->name, dpi->calls, dpi->total_ns, &prev.first,
+                       &prev.second);
+    first = false;
+  }
+  os << "}}" << std::endl;
+
+  sample_ns_ = now_ns;
+  sample_cycle_ = cycle;
+  next_sample_cycle_ = cycle + sample_interval_;
+}
+
+// Print one row of the profile table
+static void PrintRow(std::ostream &os, const std::string &name,
+                     uint64_t calls, uint64_t total_ns, uint64_t wall_ns,
+                     const uint64_t *max_ns = nullptr) {
+  os << "  " << std::left << std::setw(36) << name << std::right
+     << std::setw(12) << calls << std::fixed << std::setprecision(3)
+     << std::setw(11) << total_ns / 1e9 << std::setprecision(1)
+     << std::setw(7) << (wall_ns ? 100.0 * total_ns / wall_ns : 0.0)
+     << std::setw(11) << (calls ? (double)total_ns / calls : 0.0);
+  if (max_ns) {
+    os << std::setw(11) << *max_ns;
+  }
+  os << std::endl;
+  os.unsetf(std::ios_base::floatfield);
+  os << std::setprecision(6);
+}
+
+void SimProfiler::PrintTable(std::ostream &os, unsigned long cycles) const {
+  if (!enabled_) {
+    return;
+  }
+
+  uint64_t wall_ns = (stop_ns_ ? stop_ns_ : dpi_profile_now_ns()) - start_ns_;
+  uint64_t dpi_ns = 0;
+  for (const dpi_profile_counter *dpi = dpi_profile_counters(); dpi;
+       dpi = dpi->next) {
+    dpi_ns += dpi->total_ns;
+  }
+  uint64_t loop_ns = eval_.total_ns + trace_.total_ns;
+  for (const Counter &ext : extensions_) {
+    loop_ns += ext.total_ns;
+  }
+
+  os << std::endl
+     << "Simulation profile" << std::endl
+     << "==================" << std::endl
+     << "  " << std::left << std::setw(36) << "Counter" << std::right
+     << std::setw(12) << "Calls" << std::setw(11) << "Time (s)"
+     << std::setw(7) << "%" << std::setw(11) << "ns/call" << std::setw(11)
+     << "max ns" << std::endl;
+
+  PrintRow(os, "eval (including DPI)", eval_.calls, eval_.total_ns, wall_ns);
+  PrintRow(os, "  eval excluding DPI", eval_.calls,
+           eval_.total_ns - std::min(dpi_ns, eval_.total_ns), wall_ns);
+  PrintRow(os, "trace dump", trace_.calls, trace_.total_ns, wall_ns);
+  for (const Counter &ext : extensions_) {
+    PrintRow(os, ext.name + "::OnClock", ext.calls, ext.total_ns, wall_ns);
+  }
+  PrintRow(os, "other", 0, wall_ns - std::min(loop_ns, wall_ns), wall_ns);
+
+  std::vector<const dpi_profile_counter *> dpis;
+  for (const dpi_profile_counter *dpi = dpi_profile_counters(); dpi;
+       dpi = dpi->next) {
+    dpis.push_back(dpi);
+  }
+  std::sort(dpis.begin(), dpis.end(),
+            [](const dpi_profile_counter *a, const dpi_profile_counter *b) {
+              return a->total_ns > b->total_ns;
+            });
+  if (!dpis.empty()) {
+    os << "DPI calls:" << std::endl;
+  }
+  for (const dpi_profile_counter *dpi : dpis) {
+    PrintRow(os, dpi->name, dpi->calls, dpi->total_ns, wall_ns,
+             &dpi->max_ns);
+  }
+
+  double wall_s = wall_ns / 1e9;
+  os << "Profiled " << cycles << " cycles in " << wall_s << " s ("
+     << (wall_s > 0 ? cycles / wall_s : 0.0) << " cycles/s)" << std::endl;
+}
@@ -0,0 +1,124 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef OPENTITAN_HW_DV_VERILATOR_SIMUTIL_VERILATOR_CPP_SIM_PROFILER_H_
+#define OPENTITAN_HW_DV_VERILATOR_SIMUTIL_VERILATOR_CPP_SIM_PROFILER_H_
+
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "dpi_profile.h"
+#include "sim_ctrl_extension.h"
+
+/**
+ * Performance counters for the simulation main loop
+ *
+ * This accumulates the wall time spent evaluating the model, in each
+ * extension's OnClock() and in dumping traces, together with the DPI call
+ * counters that DPI modules record through dpi_profile.h. DPI calls happen
+ * inside the model evaluation, so their time is also part of the evaluation
+ * time.
+ *
+ * The counters can be written out as a JSON object per line every so many
+ * cycles (see SetSampleInterval()), and printed as a table at the end of the
+ * simulation.
+ *
+ * Timing calls follow the pattern of dpi_profile.h: Begin() returns 0 when
+ * profiling is disabled, and the End*() functions then do nothing.
+ */
+class SimProfiler {
+ public:
+  SimProfiler();
+
+  /**
+   * Enable profiling, including the DPI call counters
+   */
+  void Enable();
+
+  bool Enabled() const { return enabled_; }
+
+  /**
+   * Write a sample every interval cycles to path
+   *
+   * Each sample is a JSON object on its own line, with the counters since the
+   * previous sample. An interval of 0 disables sampling.
+   */
+  void SetSampleInterval(unsigned long interval, const std::string &path);
+
+  /**
+   * Set up one counter for each extension, in registration order
+   *
+   * This must be called before the simulation starts.
+   */
+  void Start(const std::vector<SimCtrlExtension *> &extensions);
+
+  uint64_t Begin() const { return enabled_ ? dpi_profile_now_ns() : 0; }
+
+  void EndEval(uint64_t start) { End(&eval_, start); }
+  void EndTrace(uint64_t start) { End(&trace_, start); }
+  void EndExtension(size_t idx, uint64_t start) {
+    End(&extensions_[idx], start);
+  }
+
+  /**
+   * Called once per clock cycle by the main loop; writes a sample if one is
+   * due
+   */
+  void OnCycle(unsigned long cycle) {
+    if (next_sample_cycle_ && cycle >= next_sample_cycle_) {
+      WriteSample(cycle);
+    }
+  }
+
+  /**
+   * Stop profiling, writing a final sample if sampling is enabled
+   */
+  void Stop(unsigned long cycle);
+
+  /**
+   * Print a table of all counters to os
+   */
+  void PrintTable(std::ostream &os, unsigned long cycles) const;
+
+ private:
+  struct Counter {
+    std::string name;
+    uint64_t calls;
+    uint64_t total_ns;
+    // Values at the previous sample
+    uint64_t sample_calls;
+    uint64_t sample_ns;
+  };
+
+  void End(Counter *counter, uint64_t start) {
+    if (start) {
+      ++counter->calls;
+      counter->total_ns += dpi_profile_now_ns() - start;
+    }
+  }
+
+  void WriteSample(unsigned long cycle);
+
+  bool enabled_;
+  unsigned long sample_interval_;
+  unsigned long next_sample_cycle_;
+  std::string sample_path_;
+  std::ofstream sample_file_;
+  uint64_t start_ns_;
+  uint64_t sample_ns_;
+  unsigned long sample_cycle_;
+  uint64_t stop_ns_;
+  Counter eval_;
+  Counter trace_;
+  std::vector<Counter> extensions_;
+  // DPI call counts and times at the previous sample
+  std::map<const dpi_profile_counter *, std::pair<uint64_t, uint64_t>>
+      dpi_samples_;
+};
+
+#endif  // OPENTITAN_HW_DV_VERILATOR_SIMUTIL_VERILATOR_CPP_SIM_PROFILER_H_
@@ -90,6 +90,19 @@ class VerilatedTracer {
 };
 #endif  // VM_TRACE == 1
 
+// VM_SAVABLE must be set by the user when calling Verilator with --savable.
+// It enables saving and restoring checkpoints of the model state.
+#ifndef VM_SAVABLE
+#define VM_SAVABLE 0
+#endif
+
+#if VM_SAVABLE == 1
+#include "verilated_save.h"
+#else
+class VerilatedSerialize;
+class VerilatedDeserialize;
+#endif
+
 // Forward-declare for use in VerilatedToplevel
 class TOPLEVEL_NAME;
 
@@ -123,6 +136,15 @@ class VerilatedToplevel {
   virtual const char *name() const = 0;
   virtual void trace(VerilatedTracer &tfp, int levels, int options) = 0;
 
+  /**
+   * Save or restore the complete model state
+   *
+   * This is only supported if the model was built with --savable (and
+   * VM_SAVABLE is defined).
+   */
+  virtual void save(VerilatedSerialize &os) = 0;
+  virtual void restore(VerilatedDeserialize &is) = 0;
+
   /**
    * Get the Verilator-generated device under test
    *
@@ -139,6 +161,10 @@ class TOPLEVEL_NAME : public VERILATED_TOPLEVEL_NAME, public VerilatedToplevel {
  public:
   TOPLEVEL_NAME(const char *name = "TOP")
       : VERILATED_TOPLEVEL_NAME(name), VerilatedToplevel() {}
+  // Construct the model within its own context, e.g. to run several
+  // independent instances at once (see VerilatorMultiSim).
+  TOPLEVEL_NAME(VerilatedContext *context, const char *name = "TOP")
+      : VERILATED_TOPLEVEL_NAME(context, name), VerilatedToplevel() {}
   const char *name() const { return STR_AND_EXPAND(TOPLEVEL_NAME); }
   void eval() { VERILATED_TOPLEVEL_NAME::eval(); }
   void final() { VERILATED_TOPLEVEL_NAME::final(); }
@@ -148,6 +174,20 @@ class TOPLEVEL_NAME : public VERILATED_TOPLEVEL_NAME, public VerilatedToplevel {
                                    levels, options);
 #else
     assert(0 && "Tracing not enabled.");
+#endif
+  }
+  void save(VerilatedSerialize &os) {
+#if VM_SAVABLE == 1
+    os << *static_cast<VERILATED_TOPLEVEL_NAME *>(this);
+#else
+    assert(0 && "Checkpointing not enabled.");
+#endif
+  }
+  void restore(VerilatedDeserialize &is) {
+#if VM_SAVABLE == 1
+    is >> *static_cast<VERILATED_TOPLEVEL_NAME *>(this);
+#else
+    assert(0 && "Checkpointing not enabled.");
 #endif
   }
 };
@@ -0,0 +1,194 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "verilator_multi_sim.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <getopt.h>
+#include <iostream>
+#include <thread>
+
+// Reset timing, matching VerilatorSimCtrl's defaults.
+static const unsigned long kResetStartCycle = 2;
+static const unsigned long kResetEndCycle = 4;
+
+/**
+ * Parse a numeric command line argument
+ */
+static bool parse_ul(const char *arg_name, const char *arg_text,
+                     unsigned long *value) {
+  char *end;
+  errno = 0;
+  *value = strtoul(arg_text, &end, 0);
+  if (arg_text[0] < '0' || arg_text[0] > '9' || *end || errno) {
+    std::cerr << "ERROR: Bad argument for " << arg_name << ": " << arg_text
+              << std::endl;
+    return false;
+  }
+  return true;
+}
+
+VerilatorMultiSim::VerilatorMultiSim(ModelFactory factory,
+                                     VerilatorSimCtrlFlags flags)
+    : factory_(factory), flags_(flags), term_after_cycles_(0) {}
+
+std::pair<int, bool> VerilatorMultiSim::Exec(int argc, char **argv) {
+  const struct option long_options[] = {
+      {"instances", required_argument, nullptr, 'n'},
+      {"seed", required_argument, nullptr, 's'},
+      {"jobs", required_argument, nullptr, 'j'},
+      {"term-after-cycles", required_argument, nullptr, 'c'},
+      {nullptr, no_argument, nullptr, 0}};
+
+  unsigned long instances = 0;
+  unsigned long seed = 1;
+  unsigned long jobs = std::max(1u, std::thread::hardware_concurrency());
+  bool good = true;
+
+  // Disable error reporting by getopt: the remaining arguments are meant for
+  // VerilatorSimCtrl or Verilator.
+  opterr = 0;
+  while (good) {
+    int c = getopt_long(argc, argv, "-:c:j:", long_options, nullptr);
+    if (c == -1) {
+      break;
+    }
+    switch (c) {
+      case 'n':
+        good = parse_ul("instances", optarg, &instances);
+        break;
+      case 's':
+        good = parse_ul("seed", optarg, &seed);
+        break;
+      case 'j':
+        good = parse_ul("jobs", optarg, &jobs);
+        break;
+      case 'c':
+        good = parse_ul("term-after-cycles", optarg, &term_after_cycles_);
+        break;
+      default:
+        break;
+    }
+  }
+  // Let the next parser start from the beginning again.
+  optind = 0;
+
+  if (!good) {
+    return std::make_pair(1, true);
+  }
+  if (instances == 0) {
+    return std::make_pair(0, false);
+  }
+  args_.assign(argv, argv + argc);
+  bool passed = Run(instances, seed, std::max(jobs, 1ul));
+  return std::make_pair(passed ? 0 : 1, true);
+}
+
+bool VerilatorMultiSim::Run(unsigned instances, unsigned seed, unsigned jobs) {
+  std::cout << "Running " << instances << " instances with seeds " << seed
+            << " to " << seed + instances - 1 << ", " << jobs << " at a time."
+            << std::endl;
+
+  results_.assign(instances, Result());
+  std::chrono::steady_clock::time_point begin =
+      std::chrono::steady_clock::now();
+
+  // The random number generator state of the Verilator runtime is per thread,
+  // and is reseeded from the thread's context only when some context's seed
+  // changes. Give each instance a fresh thread, and seed each batch of
+  // contexts before any of its threads starts.
+  for (unsigned first = 0; first < instances; first += jobs) {
+    unsigned count = std::min(jobs, instances - first);
+    std::vector<std::unique_ptr<VerilatedContext>> contexts;
+    for (unsigned i = 0; i < count; ++i) {
+      contexts.emplace_back(new VerilatedContext);
+      contexts[i]->commandArgs(static_cast<int>(args_.size()), args_.data());
+      contexts[i]->randSeed(static_cast<int>(seed + first + i));
+      results_[first + i].seed = seed + first + i;
+    }
+
+    std::vector<std::thread> threads;
+    for (unsigned i = 0; i < count; ++i) {
+      threads.emplace_back(&VerilatorMultiSim::RunInstance, this,
+                           contexts[i].get(), &results_[first + i]);
+    }
+    for (auto it = threads.begin(); it != threads.end(); ++it) {
+      it->join();
+    }
+  }
+
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - begin;
+  PrintResults(elapsed.count());
+
+  return std::all_of(results_.begin(), results_.end(),
+                     [](const Result &result) { return result.passed; });
+}
+
+void VerilatorMultiSim::RunInstance(VerilatedContext *context,
+                                    Result *result) const {
+  Model model = factory_(context);
+  const CData rst_active = (flags_ & ResetPolarityNegative) ? 0 : 1;
+
+  unsigned long time = 0;
+  *model.sig_clk = 0;
+  *model.sig_rst = !rst_active;
+  result->passed = false;
+  while (1) {
+    unsigned long cycle = time / 2;
+    if (cycle == kResetStartCycle) {
+      *model.sig_rst = rst_active;
+    } else if (cycle == kResetEndCycle) {
+      *model.sig_rst = !rst_active;
+    }
+
+    *model.sig_clk = !*model.sig_clk;
+    context->time(time);
+    model.top->eval();
+    time++;
+
+    if (*model.sig_clk && cycle > kResetEndCycle && *model.sig_done) {
+      result->passed = *model.sig_passed;
+      result->reason = result->passed ? "passed" : "failed";
+      break;
+    }
+    if (context->gotFinish()) {
+      result->reason = "$finish() without a result";
+      break;
+    }
+    if (term_after_cycles_ && time / 2 >= term_after_cycles_) {
+      result->reason = "timeout";
+      break;
+    }
+  }
+  model.top->final();
+  result->cycles = time / 2;
+}
+
+void VerilatorMultiSim::PrintResults(double seconds) const {
+  unsigned passed = 0;
+  unsigned long cycles = 0;
+  for (auto it = results_.begin(); it != results_.end(); ++it) {
+    cycles += it->cycles;
+    if (it->passed) {
+      ++passed;
+    } else {
+      std::cout << "Seed " << it->seed << ": " << it->reason << " after "
+                << it->cycles << " cycles" << std::endl;
+    }
+  }
+
+  std::cout << std::endl
+            << "Simulation statistics" << std::endl
+            << "=====================" << std::endl
+            << "Passed instances: " << passed << " of " << results_.size()
+            << std::endl
+            << "Executed cycles:  " << cycles << std::endl
+            << "Wallclock time:   " << seconds << " s" << std::endl
+            << "Simulation speed: " << cycles / seconds / 1000.0 << " kHz"
+            << std::endl;
+}
@@ -0,0 +1,111 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef OPENTITAN_HW_DV_VERILATOR_SIMUTIL_VERILATOR_CPP_VERILATOR_MULTI_SIM_H_
+#define OPENTITAN_HW_DV_VERILATOR_SIMUTIL_VERILATOR_CPP_VERILATOR_MULTI_SIM_H_
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "verilated_toplevel.h"
+#include "verilator_sim_ctrl.h"
+
+/**
+ * Run independent instances of a self-checking testbench in parallel
+ *
+ * VerilatorSimCtrl drives a single model with a single seed. Small testbenches
+ * which signal the end and result of a test through output ports (such as the
+ * pre_dv testbenches) are often run many times with different seeds instead.
+ * VerilatorMultiSim constructs one model per instance, each in its own
+ * VerilatedContext seeded with its own value, runs the instances in parallel
+ * threads and aggregates their results.
+ *
+ * The model must be built with --threads (e.g. --threads 1) so that the
+ * Verilator runtime is thread-safe. Instance i is seeded with seed + i; a
+ * failing instance can be reproduced with the single-instance simulation and
+ * +verilator+seed+<seed>.
+ *
+ * Instances are only clocked and reset: extensions, tracing and the other
+ * VerilatorSimCtrl features are not available, and $time is not
+ * meaningful within an instance.
+ */
+class VerilatorMultiSim {
+ public:
+  /**
+   * A model and the ports driven and observed by the harness
+   */
+  struct Model {
+    std::unique_ptr<VerilatedToplevel> top;
+    CData *sig_clk;
+    CData *sig_rst;
+    CData *sig_done;
+    CData *sig_passed;
+  };
+
+  /**
+   * Construct the model of an instance within the given context
+   */
+  typedef Model (*ModelFactory)(VerilatedContext *context);
+
+  /**
+   * Constructor
+   *
+   * @param factory Function constructing a model
+   * @param flags   Reset polarity, as for VerilatorSimCtrl::SetTop()
+   */
+  VerilatorMultiSim(ModelFactory factory,
+                    VerilatorSimCtrlFlags flags = Defaults);
+
+  /**
+   * Run the instances requested on the command line
+   *
+   * Recognizes --instances, --seed, --jobs and --term-after-cycles and ignores
+   * all other arguments, which are passed to each instance's context (for
+   * plusargs). Does nothing unless --instances is given, so that a testbench
+   * can fall back to VerilatorSimCtrl.
+   *
+   * @return a pair with main()-compatible process exit code (0 if all
+   *         instances passed) and a boolean flag telling the calling function
+   *         whether the instances ran.
+   */
+  std::pair<int, bool> Exec(int argc, char **argv);
+
+  /**
+   * Run instances with consecutive seeds
+   *
+   * @param instances Number of instances
+   * @param seed      Seed of the first instance
+   * @param jobs      Maximum number of instances running at once
+   * @return true if all instances passed
+   */
+  bool Run(unsigned instances, unsigned seed, unsigned jobs);
+
+ private:
+  struct Result {
+    unsigned seed;
+    bool passed;
+    unsigned long cycles;
+    std::string reason;
+  };
+
+  /**
+   * Simulate one instance to completion
+   */
+  void RunInstance(VerilatedContext *context, Result *result) const;
+
+  /**
+   * Print a summary of the results
+   */
+  void PrintResults(double seconds) const;
+
+  ModelFactory factory_;
+  VerilatorSimCtrlFlags flags_;
+  unsigned long term_after_cycles_;
+  std::vector<const char *> args_;
+  std::vector<Result> results_;
+};
+
+#endif  // OPENTITAN_HW_DV_VERILATOR_SIMUTIL_VERILATOR_CPP_VERILATOR_MULTI_SIM_H_
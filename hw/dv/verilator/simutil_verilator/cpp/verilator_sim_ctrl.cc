@@ -4,12 +4,19 @@
 
 #include "verilator_sim_ctrl.h"
 
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <dirent.h>
 #include <getopt.h>
 #include <iostream>
+#include <sched.h>
 #include <signal.h>
 #include <sys/stat.h>
 #include <verilated.h>
 
+#include "verilator_sim_server.h"
+
 // This is defined by Verilator and passed through the command line
 #ifndef VM_TRACE
 #define VM_TRACE 0
@@ -34,6 +41,17 @@ void vl_stop(const char *filename, int linenum, const char *hier) VL_MT_UNSAFE {
 }
 #endif
 
+/**
+ * Raise a named event from the design
+ *
+ * Turns on tracing if the name matches the --trace-on-event argument. Import in
+ * SystemVerilog with
+ *   import "DPI-C" function void simctrl_trace_event(input string name);
+ */
+extern "C" void simctrl_trace_event(const char *name) {
+  VerilatorSimCtrl::GetInstance().TraceEvent(name);
+}
+
 VerilatorSimCtrl &VerilatorSimCtrl::GetInstance() {
   static VerilatorSimCtrl instance;
   return instance;
@@ -47,7 +65,44 @@ void VerilatorSimCtrl::SetTop(VerilatedToplevel *top, CData *sig_clk,
   flags_ = flags;
 }
 
+/**
+ * Take the server mode arguments out of a command line
+ *
+ * Removes --server=SOCKET, --server-jobs=N and --server-dir=DIR from args.
+ *
+ * @return false if an argument is malformed
+ */
+static bool take_server_args(std::vector<std::string> *args,
+                             std::string *socket_path, unsigned long *jobs,
+                             std::string *run_dir);
+
 std::pair<int, bool> VerilatorSimCtrl::Exec(int argc, char **argv) {
+  // In server mode, the command line a test runs with is the server's one
+  // (without the server arguments), followed by the test's arguments.
+  std::vector<std::string> args(argv, argv + argc);
+  std::string socket_path;
+  unsigned long jobs = 1;
+  std::string run_dir = "sim_server";
+  if (!take_server_args(&args, &socket_path, &jobs, &run_dir)) {
+    return std::make_pair(1, false);
+  }
+  std::vector<char *> test_argv;
+  if (!socket_path.empty()) {
+    VerilatorSimServer server(socket_path, jobs, run_dir);
+    std::vector<std::string> test_args;
+    int retcode;
+    if (!server.Serve(&test_args, &retcode)) {
+      return std::make_pair(retcode, false);
+    }
+    args.insert(args.end(), test_args.begin(), test_args.end());
+    for (std::string &arg : args) {
+      test_argv.push_back(&arg[0]);
+    }
+    test_argv.push_back(nullptr);
+    argc = args.size();
+    argv = test_argv.data();
+  }
+
   bool exit_app = false;
   bool good_cmdline = ParseCommandArgs(argc, argv, exit_app);
   if (exit_app) {
@@ -107,10 +162,91 @@ static bool read_ul_arg(unsigned long *arg_val, const char *arg_name,
   return true;
 }
 
+static bool take_server_args(std::vector<std::string> *args,
+                             std::string *socket_path, unsigned long *jobs,
+                             std::string *run_dir) {
+  const std::string socket_opt = "--server=";
+  const std::string jobs_opt = "--server-jobs=";
+  const std::string dir_opt = "--server-dir=";
+
+  for (auto it = args->begin(); it != args->end();) {
+    if (it->compare(0, socket_opt.size(), socket_opt) == 0) {
+      *socket_path = it->substr(socket_opt.size());
+    } else if (it->compare(0, jobs_opt.size(), jobs_opt) == 0) {
+      std::string jobs_str = it->substr(jobs_opt.size());
+      if (!read_ul_arg(jobs, "server-jobs", jobs_str.c_str())) {
+        return false;
+      }
+    } else if (it->compare(0, dir_opt.size(), dir_opt) == 0) {
+      *run_dir = it->substr(dir_opt.size());
+    } else {
+      ++it;
+      continue;
+    }
+    it = args->erase(it);
+  }
+  return true;
+}
+
+/**
+ * Parse a CPU list such as "0-3,8" into a cpu_set_t
+ *
+ * @return true if the list is well-formed and non-empty
+ */
+static bool parse_cpu_list(const std::string &cpu_list, cpu_set_t *cpus) {
+  CPU_ZERO(cpus);
+
+  size_t pos = 0;
+  while (pos < cpu_list.size()) {
+    size_t end = cpu_list.find(',', pos);
+    if (end == std::string::npos) {
+      end = cpu_list.size();
+    }
+    std::string range = cpu_list.substr(pos, end - pos);
+    size_t dash = range.find('-');
+
+    unsigned long first, last;
+    std::string first_str = range.substr(0, dash);
+    if (!read_ul_arg(&first, "cpu-affinity", first_str.c_str())) {
+      return false;
+    }
+    last = first;
+    if (dash != std::string::npos) {
+      std::string last_str = range.substr(dash + 1);
+      if (!read_ul_arg(&last, "cpu-affinity", last_str.c_str())) {
+        return false;
+      }
+    }
+    if (last < first || last >= CPU_SETSIZE) {
+      std::cerr << "ERROR: Bad CPU range `" << range << "' in cpu-affinity "
+                << "argument." << std::endl;
+      return false;
+    }
+    for (unsigned long cpu = first; cpu <= last; ++cpu) {
+      CPU_SET(cpu, cpus);
+    }
+    pos = end + 1;
+  }
+
+  return CPU_COUNT(cpus) > 0;
+}
+
 bool VerilatorSimCtrl::ParseCommandArgs(int argc, char **argv, bool &exit_app) {
   const struct option long_options[] = {
       {"term-after-cycles", required_argument, nullptr, 'c'},
       {"trace", optional_argument, nullptr, 't'},
+      {"fast-forward", no_argument, nullptr, 'F'},
+      {"cpu-affinity", required_argument, nullptr, 'A'},
+      {"trace-start-cycle", required_argument, nullptr, 'B'},
+      {"trace-stop-cycle", required_argument, nullptr, 'E'},
+      {"trace-ring-cycles", required_argument, nullptr, 'G'},
+      {"trace-on-event", required_argument, nullptr, 'V'},
+      {"checkpoint-at", required_argument, nullptr, 'S'},
+      {"checkpoint-file", required_argument, nullptr, 'P'},
+      {"restore", required_argument, nullptr, 'R'},
+      {"profile", no_argument, nullptr, 'O'},
+      {"profile-interval", required_argument, nullptr, 'I'},
+      {"profile-file", required_argument, nullptr, 'J'},
       {"help", no_argument, nullptr, 'h'},
       {nullptr, no_argument, nullptr, 0}};
 
@@ -145,6 +281,81 @@ bool VerilatorSimCtrl::ParseCommandArgs(int argc, char **argv, bool &exit_app) {
           return false;
         }
         break;
+      case 'B':
+      case 'E':
+      case 'G':
+      case 'V': {
+        if (!tracing_possible_) {
+          std::cerr << "ERROR: Tracing has not been enabled at compile time."
+                    << std::endl;
+          exit_app = true;
+          return false;
+        }
+        bool good_arg = true;
+        if (c == 'B') {
+          good_arg = read_ul_arg(&trace_start_cycle_, "trace-start-cycle",
+                                 optarg);
+        } else if (c == 'E') {
+          good_arg =
+              read_ul_arg(&trace_stop_cycle_, "trace-stop-cycle", optarg);
+        } else if (c == 'G') {
+          good_arg =
+              read_ul_arg(&trace_ring_cycles_, "trace-ring-cycles", optarg);
+        } else {
+          trace_event_.assign(optarg);
+        }
+        if (!good_arg) {
+          exit_app = true;
+          return false;
+        }
+        break;
+      }
+      case 'F':
+        fast_forward_ = true;
+        break;
+      case 'O':
+        profile_ = true;
+        break;
+      case 'I':
+        if (!read_ul_arg(&profile_interval_, "profile-interval", optarg)) {
+          exit_app = true;
+          return false;
+        }
+        profile_ = true;
+        break;
+      case 'J':
+        profile_path_.assign(optarg);
+        break;
+      case 'A': {
+        cpu_set_t cpus;
+        if (!parse_cpu_list(optarg, &cpus)) {
+          exit_app = true;
+          return false;
+        }
+        cpu_affinity_.assign(optarg);
+        break;
+      }
+      case 'S':
+      case 'P':
+      case 'R':
+        if (!checkpoint_possible_) {
+          std::cerr << "ERROR: Checkpointing has not been enabled at compile "
+                       "time."
+                    << std::endl;
+          exit_app = true;
+          return false;
+        }
+        if (c == 'S') {
+          if (!read_ul_arg(&checkpoint_cycle_, "checkpoint-at", optarg)) {
+            exit_app = true;
+            return false;
+          }
+        } else if (c == 'P') {
+          checkpoint_path_.assign(optarg);
+        } else {
+          restore_path_.assign(optarg);
+        }
+        break;
       case 'h':
         PrintHelp();
         exit_app = true;
@@ -179,6 +390,12 @@ bool VerilatorSimCtrl::ParseCommandArgs(int argc, char **argv, bool &exit_app) {
 void VerilatorSimCtrl::RunSimulation() {
   RegisterSignalHandler();
 
+  // Verilator's worker threads have been created together with the model, so
+  // the affinity can be applied to all of them now.
+  if (!cpu_affinity_.empty() && !SetCpuAffinity(cpu_affinity_)) {
+    return;
+  }
+
   // Print helper message for tracing
   if (TracingPossible()) {
     std::cout << "Tracing can be toggled by sending SIGUSR1 to this process:"
@@ -202,6 +419,38 @@ void VerilatorSimCtrl::RunSimulation() {
     std::cout << std::endl
               << "You can view the simulation traces by calling" << std::endl
               << "$ gtkwave " << GetTraceFileName() << std::endl;
+    if (trace_ring_cycles_ && trace_segment_ > 0) {
+      std::cout << "The preceding cycles are in "
+                << GetTraceSegmentFileName(trace_segment_ - 1) << std::endl;
+    }
+  }
+}
+
+void VerilatorSimCtrl::SetTraceWindow(unsigned long start,
+                                      unsigned long stop) {
+  trace_start_cycle_ = start;
+  trace_stop_cycle_ = stop;
+}
+
+void VerilatorSimCtrl::EnableProfiling(unsigned long sample_interval,
+                                       const std::string &sample_path) {
+  profile_ = true;
+  profile_interval_ = sample_interval;
+  profile_path_ = sample_path;
+}
+
+void VerilatorSimCtrl::TraceEvent(const std::string &name) {
+  if (!trace_event_.empty() && name == trace_event_ && !TracingEnabled()) {
+    TraceOn();
+  }
+}
+
+void VerilatorSimCtrl::UpdateTraceWindow() {
+  if (trace_start_cycle_ && time_ == 2 * trace_start_cycle_) {
+    TraceOn();
+  }
+  if (trace_stop_cycle_ && time_ == 2 * trace_stop_cycle_) {
+    TraceOff();
   }
 }
 
@@ -222,6 +471,11 @@ void VerilatorSimCtrl::RequestStop(bool simulation_success) {
   simulation_success_ &= simulation_success;
 }
 
+void VerilatorSimCtrl::RequestReset() {
+  start_reset_cycle_ = time_ / 2 + 1;
+  end_reset_cycle_ = start_reset_cycle_ + reset_duration_cycles_;
+}
+
 void VerilatorSimCtrl::RegisterExtension(SimCtrlExtension *ext) {
   extension_array_.push_back(ext);
 }
@@ -238,12 +492,26 @@ VerilatorSimCtrl::VerilatorSimCtrl()
       tracing_enabled_changed_(false),
       tracing_ever_enabled_(false),
       tracing_possible_(VM_TRACE),
+      checkpoint_possible_(VM_SAVABLE),
+      checkpoint_cycle_(0),
+      checkpoint_path_("sim.ckpt"),
       initial_reset_delay_cycles_(2),
       reset_duration_cycles_(2),
+      start_reset_cycle_(0),
+      end_reset_cycle_(0),
       request_stop_(false),
       simulation_success_(true),
       tracer_(VerilatedTracer()),
-      term_after_cycles_(0) {
+      term_after_cycles_(0),
+      fast_forward_(false),
+      trace_start_cycle_(0),
+      trace_stop_cycle_(0),
+      trace_ring_cycles_(0),
+      trace_segment_start_(0),
+      trace_segment_(0),
+      profile_(false),
+      profile_interval_(0),
+      profile_path_("sim_profile.jsonl") {
 }
 
 void VerilatorSimCtrl::RegisterSignalHandler() {
@@ -282,7 +550,51 @@ void VerilatorSimCtrl::PrintHelp() const {
                  "  Write a trace file from the start\n\n";
   }
   std::cout << "-c|--term-after-cycles=N\n"
-               "  Terminate simulation after N cycles. 0 means no timeout.\n\n"
+               "  Terminate simulation after N cycles. 0 means no timeout.\n\n";
+  if (checkpoint_possible_) {
+    std::cout << "--checkpoint-at=N\n"
+                 "  Save a checkpoint of the simulation state at cycle N\n\n"
+                 "--checkpoint-file=FILE\n"
+                 "  Write checkpoints to FILE (default: sim.ckpt)\n\n"
+                 "--restore=FILE\n"
+                 "  Start the simulation from the checkpoint in FILE\n\n";
+  }
+  if (tracing_possible_) {
+    std::cout << "--trace-start-cycle=N\n"
+                 "--trace-stop-cycle=N\n"
+                 "  Only trace from cycle N (inclusive) to cycle N "
+                 "(exclusive)\n\n"
+                 "--trace-on-event=NAME\n"
+                 "  Start tracing when the design raises the event NAME\n"
+                 "  through simctrl_trace_event()\n\n"
+                 "--trace-ring-cycles=N\n"
+                 "  Only keep (at least) the last N traced cycles, in two\n"
+                 "  alternating trace files\n\n";
+  }
+  std::cout << "--cpu-affinity=LIST\n"
+               "  Pin all simulation threads to the CPUs in LIST, e.g. "
+               "0-3,8\n\n"
+               "--profile\n"
+               "  Time the model evaluation, extensions, trace dumping and\n"
+               "  DPI calls, and print a table at the end of the simulation\n\n"
+               "--profile-interval=N\n"
+               "  Profile, also writing the counters every N cycles as a line\n"
+               "  of JSON\n\n"
+               "--profile-file=FILE\n"
+               "  Write profile samples to FILE (default:\n"
+               "  sim_profile.jsonl)\n\n"
+               "--fast-forward\n"
+               "  Skip calling extensions while they are all quiescent. This\n"
+               "  has no effect while tracing is enabled.\n\n"
+               "--server=SOCKET\n"
+               "  Construct the model once, then run tests sent to the Unix\n"
+               "  domain socket SOCKET, each in a process forked from this\n"
+               "  one (see verilator_sim_server.h)\n\n"
+               "--server-jobs=N\n"
+               "  Run up to N tests at a time in server mode (default: 1)\n\n"
+               "--server-dir=DIR\n"
+               "  Run each test in server mode in a directory under DIR\n"
+               "  (default: sim_server)\n\n"
                "-h|--help\n"
                "  Show help\n\n"
                "All arguments are passed to the design and can be used "
@@ -322,6 +634,8 @@ void VerilatorSimCtrl::PrintStatistics() const {
             << "Simulation speed: " << speed_hz << " cycles/s "
             << "(" << speed_khz << " kHz)" << std::endl;
 
+  profiler_.PrintTable(std::cout, time_ / 2);
+
   int trace_size_byte;
   if (tracing_enabled_ && FileSize(GetTraceFileName(), trace_size_byte)) {
     std::cout << "Trace file size:  " << trace_size_byte << " B" << std::endl;
@@ -329,7 +643,25 @@ void VerilatorSimCtrl::PrintStatistics() const {
 }
 
 std::string VerilatorSimCtrl::GetTraceFileName() const {
-  return trace_file_path_;
+  if (!trace_ring_cycles_) {
+    return trace_file_path_;
+  }
+  return GetTraceSegmentFileName(trace_segment_);
+}
+
+std::string VerilatorSimCtrl::GetTraceSegmentFileName(
+    unsigned int segment) const {
+  // Segments alternate between two files, named by inserting the segment
+  // parity before the extension, e.g. sim.0.fst and sim.1.fst.
+  std::string index = "." + std::to_string(segment % 2);
+  size_t dot = trace_file_path_.rfind('.');
+  size_t slash = trace_file_path_.rfind('/');
+  if (dot == std::string::npos ||
+      (slash != std::string::npos && dot < slash)) {
+    return trace_file_path_ + index;
+  }
+  std::string path = trace_file_path_;
+  return path.insert(dot, index);
 }
 
 void VerilatorSimCtrl::Run() {
@@ -344,19 +676,43 @@ void VerilatorSimCtrl::Run() {
   // Evaluate all initial blocks, including the DPI setup routines
   top_->eval();
 
+  // The restored model state replaces what the initial blocks set up (apart
+  // from any host resources opened by DPI models), including the reset.
+  bool restored = false;
+  if (!restore_path_.empty()) {
+    if (!RestoreCheckpoint(restore_path_)) {
+      return;
+    }
+    restored = true;
+  }
+
   std::cout << std::endl
             << "Simulation running, end by pressing CTRL-c." << std::endl;
 
+  if (profile_) {
+    profiler_.SetSampleInterval(profile_interval_, profile_path_);
+    profiler_.Enable();
+    profiler_.Start(extension_array_);
+  }
+
   time_begin_ = std::chrono::steady_clock::now();
-  UnsetReset();
+  if (!restored) {
+    UnsetReset();
+  }
   Trace();
 
-  unsigned long start_reset_cycle_ = initial_reset_delay_cycles_;
-  unsigned long end_reset_cycle_ = start_reset_cycle_ + reset_duration_cycles_;
+  start_reset_cycle_ = initial_reset_delay_cycles_;
+  end_reset_cycle_ = start_reset_cycle_ + reset_duration_cycles_;
 
   while (1) {
     unsigned long cycle_ = time_ / 2;
 
+    UpdateTraceWindow();
+
+    if (checkpoint_cycle_ && time_ == 2 * checkpoint_cycle_) {
+      SaveCheckpoint(checkpoint_path_);
+    }
+
     if (cycle_ == start_reset_cycle_) {
       SetReset();
     } else if (cycle_ == end_reset_cycle_) {
@@ -367,42 +723,212 @@ void VerilatorSimCtrl::Run() {
 
     // Call all extension on-clock methods
     if (*sig_clk_) {
-      for (auto it = extension_array_.begin(); it != extension_array_.end();
-           ++it) {
-        (*it)->OnClock(time_);
+      for (size_t i = 0; i < extension_array_.size(); ++i) {
+        uint64_t prof_start = profiler_.Begin();
+        extension_array_[i]->OnClock(time_);
+        profiler_.EndExtension(i, prof_start);
       }
+      profiler_.OnCycle(cycle_);
     }
 
+    uint64_t prof_start = profiler_.Begin();
     top_->eval();
+    profiler_.EndEval(prof_start);
     time_++;
 
+    prof_start = profiler_.Begin();
     Trace();
+    profiler_.EndTrace(prof_start);
 
-    if (request_stop_) {
-      std::cout << "Received stop request, shutting down simulation."
-                << std::endl;
-      break;
-    }
-    if (Verilated::gotFinish()) {
-      std::cout << "Received $finish() from Verilog, shutting down simulation."
-                << std::endl;
+    if (ShouldStop()) {
       break;
     }
-    if (term_after_cycles_ && (time_ / 2 >= term_after_cycles_)) {
-      std::cout << "Simulation timeout of " << term_after_cycles_
-                << " cycles reached, shutting down simulation." << std::endl;
-      break;
+
+    // Once every extension has seen this clock edge, skip over any following
+    // cycles where none of them need to run.
+    if (fast_forward_ && *sig_clk_ && !TracingEnabled()) {
+      FastForward(GetFastForwardTarget(cycle_ + 1, start_reset_cycle_,
+                                       end_reset_cycle_));
+      if (ShouldStop()) {
+        break;
+      }
     }
   }
 
   top_->final();
   time_end_ = std::chrono::steady_clock::now();
+  profiler_.Stop(time_ / 2);
 
   if (TracingEverEnabled()) {
     tracer_.close();
   }
 }
 
+bool VerilatorSimCtrl::ShouldStop() const {
+  if (request_stop_) {
+    std::cout << "Received stop request, shutting down simulation."
+              << std::endl;
+    return true;
+  }
+  if (Verilated::gotFinish()) {
+    std::cout << "Received $finish() from Verilog, shutting down simulation."
+              << std::endl;
+    return true;
+  }
+  if (term_after_cycles_ && (time_ / 2 >= term_after_cycles_)) {
+    std::cout << "Simulation timeout of " << term_after_cycles_
+              << " cycles reached, shutting down simulation." << std::endl;
+    return true;
+  }
+  return false;
+}
+
+unsigned long VerilatorSimCtrl::GetFastForwardTarget(
+    unsigned long next_cycle, unsigned long reset_start,
+    unsigned long reset_end) const {
+  unsigned long target = ULONG_MAX;
+  for (auto it = extension_array_.begin(); it != extension_array_.end(); ++it) {
+    target = std::min(target, (*it)->QuiescentUntil(next_cycle));
+    if (target <= next_cycle) {
+      return next_cycle;
+    }
+  }
+
+  // Don't skip over the reset edges, the timeout, the checkpoint or the start
+  // of the trace window: they are handled by the main loop.
+  if (reset_start >= next_cycle) {
+    target = std::min(target, reset_start);
+  }
+  if (reset_end >= next_cycle) {
+    target = std::min(target, reset_end);
+  }
+  if (term_after_cycles_) {
+    target = std::min(target, term_after_cycles_);
+  }
+  if (checkpoint_cycle_ >= next_cycle) {
+    target = std::min(target, checkpoint_cycle_);
+  }
+  if (trace_start_cycle_ >= next_cycle) {
+    target = std::min(target, trace_start_cycle_);
+  }
+
+  return std::max(target, next_cycle);
+}
+
+void VerilatorSimCtrl::FastForward(unsigned long until_cycle) {
+  while (time_ / 2 < until_cycle) {
+    if (request_stop_ || Verilated::gotFinish()) {
+      return;
+    }
+    // A reset requested by the design (see RequestReset()) is handled by the
+    // main loop.
+    if (start_reset_cycle_ > time_ / 2 && start_reset_cycle_ < until_cycle) {
+      until_cycle = start_reset_cycle_;
+      continue;
+    }
+
+    *sig_clk_ = !*sig_clk_;
+    uint64_t prof_start = profiler_.Begin();
+    top_->eval();
+    profiler_.EndEval(prof_start);
+    time_++;
+    if (*sig_clk_) {
+      profiler_.OnCycle(time_ / 2);
+    }
+  }
+}
+
+bool VerilatorSimCtrl::SetCpuAffinity(const std::string &cpu_list) {
+  cpu_set_t cpus;
+  if (!parse_cpu_list(cpu_list, &cpus)) {
+    return false;
+  }
+
+  // sched_setaffinity() only applies to a single thread, so walk over all
+  // threads of this process.
+  DIR *tasks = opendir("/proc/self/task");
+  if (!tasks) {
+    std::cerr << "ERROR: Unable to list simulation threads." << std::endl;
+    return false;
+  }
+  bool success = true;
+  struct dirent *task;
+  while ((task = readdir(tasks)) != nullptr) {
+    if (task->d_name[0] == '.') {
+      continue;
+    }
+    pid_t tid = static_cast<pid_t>(strtol(task->d_name, nullptr, 10));
+    if (sched_setaffinity(tid, sizeof(cpus), &cpus) != 0) {
+      std::cerr << "ERROR: Unable to set CPU affinity of thread " << tid
+                << ": " << strerror(errno) << std::endl;
+      success = false;
+    }
+  }
+  closedir(tasks);
+
+  if (success) {
+    std::cout << "Simulation threads pinned to CPUs " << cpu_list << std::endl;
+  }
+  return success;
+}
+
+bool VerilatorSimCtrl::SaveCheckpoint(const std::string &path) {
+#if VM_SAVABLE == 1
+  VerilatedSave os;
+  os.open(path.c_str());
+  if (!os.isOpen()) {
+    std::cerr << "ERROR: Unable to open checkpoint file " << path
+              << " for writing." << std::endl;
+    return false;
+  }
+
+  vluint64_t time = time_;
+  os << time;
+  top_->save(os);
+  for (auto it = extension_array_.begin(); it != extension_array_.end(); ++it) {
+    (*it)->SaveState(os);
+  }
+  os.close();
+
+  std::cout << "Saved checkpoint at cycle " << time_ / 2 << " to " << path
+            << std::endl;
+  return true;
+#else
+  std::cerr << "ERROR: Checkpointing has not been enabled at compile time."
+            << std::endl;
+  return false;
+#endif
+}
+
+bool VerilatorSimCtrl::RestoreCheckpoint(const std::string &path) {
+#if VM_SAVABLE == 1
+  VerilatedRestore is;
+  is.open(path.c_str());
+  if (!is.isOpen()) {
+    std::cerr << "ERROR: Unable to open checkpoint file " << path
+              << " for reading." << std::endl;
+    return false;
+  }
+
+  vluint64_t time;
+  is >> time;
+  time_ = time;
+  top_->restore(is);
+  for (auto it = extension_array_.begin(); it != extension_array_.end(); ++it) {
+    (*it)->RestoreState(is);
+  }
+  is.close();
+
+  std::cout << "Restored checkpoint at cycle " << time_ / 2 << " from "
+            << path << std::endl;
+  return true;
+#else
+  std::cerr << "ERROR: Checkpointing has not been enabled at compile time."
+            << std::endl;
+  return false;
+#endif
+}
+
 std::string VerilatorSimCtrl::GetName() const {
   if (top_) {
     return top_->name();
@@ -460,7 +986,16 @@ void VerilatorSimCtrl::Trace() {
     return;
   }
 
+  // In ring mode, start a new segment (overwriting the one before the last)
+  // once the current one holds enough cycles.
+  if (trace_ring_cycles_ && tracer_.isOpen() &&
+      GetTime() - trace_segment_start_ >= 2 * trace_ring_cycles_) {
+    tracer_.close();
+    ++trace_segment_;
+  }
+
   if (!tracer_.isOpen()) {
+    trace_segment_start_ = GetTime();
     tracer_.open(GetTraceFileName().c_str());
     std::cout << "Writing simulation traces to " << GetTraceFileName()
               << std::endl;
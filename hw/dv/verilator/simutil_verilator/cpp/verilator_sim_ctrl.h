@@ -10,6 +10,7 @@
 #include <vector>
 
 #include "sim_ctrl_extension.h"
+#include "sim_profiler.h"
 #include "verilated_toplevel.h"
 
 enum VerilatorSimCtrlFlags {
@@ -106,11 +107,110 @@ class VerilatorSimCtrl {
    */
   void SetTimeout(unsigned int cycles);
 
+  /**
+   * Enable or disable fast-forwarding
+   *
+   * When enabled, the main loop skips calling extensions (and tracing) for
+   * cycles where all registered extensions report that they are quiescent
+   * (see SimCtrlExtension::QuiescentUntil()). Fast-forwarding is disabled
+   * while tracing is enabled. This can also be enabled with the --fast-forward
+   * command-line argument.
+   */
+  void SetFastForward(bool enable) { fast_forward_ = enable; }
+
+  /**
+   * Pin all simulation threads to a set of CPUs
+   *
+   * This applies to every thread of the process which exists at the time of
+   * the call (the main thread, Verilator's worker threads and threads started
+   * by DPI models) and, through inheritance, to threads created afterwards.
+   * Can also be set through the --cpu-affinity command-line argument.
+   *
+   * @param cpu_list comma-separated list of CPUs or CPU ranges, e.g. "0-3,8"
+   * @return true on success
+   */
+  bool SetCpuAffinity(const std::string &cpu_list);
+
+  /**
+   * Trace only within a window of clock cycles
+   *
+   * Tracing is switched on at cycle start and off at cycle stop. A stop cycle
+   * of zero keeps tracing until the end of the simulation. Can also be set
+   * through the --trace-start-cycle and --trace-stop-cycle command-line
+   * arguments.
+   */
+  void SetTraceWindow(unsigned long start, unsigned long stop);
+
+  /**
+   * Keep only the most recent cycles of the trace
+   *
+   * With a non-zero number of cycles, the trace is written in segments of that
+   * many cycles, alternating between two files. At the end of the simulation
+   * the two files together hold (at least) the last cycles cycles. Can also be
+   * set through the --trace-ring-cycles command-line argument.
+   */
+  void SetTraceRing(unsigned long cycles) { trace_ring_cycles_ = cycles; }
+
+  /**
+   * Enable profiling of the simulation main loop
+   *
+   * This times the model evaluation, each extension's OnClock() and trace
+   * dumping, and enables the DPI call counters of dpi_profile.h. A table of
+   * the results is printed at the end of the simulation. With a non-zero
+   * sample interval, the counters are also written every sample_interval
+   * cycles to sample_path, as one JSON object per line. Can also be enabled
+   * with the --profile, --profile-interval and --profile-file command-line
+   * arguments.
+   */
+  void EnableProfiling(unsigned long sample_interval = 0,
+                       const std::string &sample_path = "sim_profile.jsonl");
+
+  /**
+   * Notify the simulation controller of a named event
+   *
+   * Tracing is turned on if the name matches the one given with the
+   * --trace-on-event command-line argument. Designs can raise events through
+   * the simctrl_trace_event() DPI function.
+   */
+  void TraceEvent(const std::string &name);
+
+  /**
+   * Save a checkpoint of the simulation state to a file
+   *
+   * This writes the current time, the complete model state and the state of
+   * every registered extension (see SimCtrlExtension::SaveState()). It is only
+   * possible if the model was built with --savable.
+   *
+   * @return true on success
+   */
+  bool SaveCheckpoint(const std::string &path);
+
+  /**
+   * Restore the simulation state from a checkpoint file
+   *
+   * This must be called before the simulation starts running. Host-side
+   * resources owned by DPI models (such as sockets or PTYs) are not part of
+   * the checkpoint.
+   *
+   * @return true on success
+   */
+  bool RestoreCheckpoint(const std::string &path);
+
   /**
    * Request the simulation to stop
    */
   void RequestStop(bool simulation_success);
 
+  /**
+   * Request a reset of the design
+   *
+   * The reset signal is asserted from the next clock cycle, for the number of
+   * cycles set by SetResetDuration(). This can be used to run several tests
+   * one after the other in a single simulation. It can be called from an
+   * extension's OnClock() or from a DPI function.
+   */
+  void RequestReset();
+
   /**
    * Register an extension to be called automatically
    */
@@ -132,14 +232,32 @@ class VerilatorSimCtrl {
   bool tracing_enabled_changed_;
   bool tracing_ever_enabled_;
   bool tracing_possible_;
+  bool checkpoint_possible_;
+  unsigned long checkpoint_cycle_;
+  std::string checkpoint_path_;
+  std::string restore_path_;
   unsigned int initial_reset_delay_cycles_;
   unsigned int reset_duration_cycles_;
+  unsigned long start_reset_cycle_;
+  unsigned long end_reset_cycle_;
   volatile unsigned int request_stop_;
   volatile bool simulation_success_;
   std::chrono::steady_clock::time_point time_begin_;
   std::chrono::steady_clock::time_point time_end_;
   VerilatedTracer tracer_;
   unsigned long term_after_cycles_;
+  bool fast_forward_;
+  std::string cpu_affinity_;
+  unsigned long trace_start_cycle_;
+  unsigned long trace_stop_cycle_;
+  unsigned long trace_ring_cycles_;
+  unsigned long trace_segment_start_;
+  unsigned int trace_segment_;
+  std::string trace_event_;
+  bool profile_;
+  unsigned long profile_interval_;
+  std::string profile_path_;
+  SimProfiler profiler_;
   std::vector<SimCtrlExtension *> extension_array_;
 
   /**
@@ -200,6 +318,11 @@ class VerilatorSimCtrl {
    */
   bool TracingPossible() const { return tracing_possible_; }
 
+  /**
+   * Switch tracing on or off at the edges of the trace window
+   */
+  void UpdateTraceWindow();
+
   /**
    * Print statistics about the simulation run
    */
@@ -210,6 +333,13 @@ class VerilatorSimCtrl {
    */
   std::string GetTraceFileName() const;
 
+  /**
+   * Get the file name of a trace segment in ring mode
+   *
+   * @see SetTraceRing()
+   */
+  std::string GetTraceSegmentFileName(unsigned int segment) const;
+
   /**
    * Run the main loop of the simulation
    *
@@ -217,6 +347,34 @@ class VerilatorSimCtrl {
    */
   void Run();
 
+  /**
+   * Check whether the main loop should stop
+   *
+   * Prints a message explaining why if so.
+   */
+  bool ShouldStop() const;
+
+  /**
+   * Get the clock cycle up to which the main loop can fast-forward
+   *
+   * This is the earliest cycle at which some extension needs to be called
+   * again, capped so that we never skip a reset edge or the timeout.
+   *
+   * @param next_cycle  The next cycle to be simulated
+   * @param reset_start Cycle at which the reset is asserted
+   * @param reset_end   Cycle at which the reset is deasserted
+   */
+  unsigned long GetFastForwardTarget(unsigned long next_cycle,
+                                     unsigned long reset_start,
+                                     unsigned long reset_end) const;
+
+  /**
+   * Toggle the clock and evaluate the model, without calling extensions or
+   * tracing, until the start of the given clock cycle (or until the
+   * simulation is asked to stop).
+   */
+  void FastForward(unsigned long until_cycle);
+
   /**
    * Get a name for this simulation
    *
@@ -0,0 +1,306 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "verilator_sim_server.h"
+
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <iostream>
+#include <poll.h>
+#include <sstream>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// Count the threads of this process
+static int CountThreads() {
+  DIR *tasks = opendir("/proc/self/task");
+  if (!tasks) {
+    return -1;
+  }
+  int count = 0;
+  struct dirent *task;
+  while ((task = readdir(tasks)) != nullptr) {
+    if (task->d_name[0] != '.') {
+      ++count;
+    }
+  }
+  closedir(tasks);
+  return count;
+}
+
+// A test name becomes a directory name, so must be a single path component
+static bool IsValidTestName(const std::string &name) {
+  if (name.empty() || name == "." || name == "..") {
+    return false;
+  }
+  return name.find('/') == std::string::npos;
+}
+
+VerilatorSimServer::VerilatorSimServer(const std::string &socket_path,
+                                       unsigned jobs,
+                                       const std::string &run_dir)
+    : socket_path_(socket_path),
+      jobs_(jobs ? jobs : 1),
+      run_dir_(run_dir),
+      listen_fd_(-1),
+      quit_(false) {}
+
+bool VerilatorSimServer::Serve(std::vector<std::string> *test_args,
+                               int *retcode) {
+  *retcode = 1;
+
+  int threads = CountThreads();
+  if (threads != 1) {
+    std::cerr << "ERROR: Server mode needs a simulation without threads, but "
+              << "this process has " << threads << ". Build the model "
+              << "without --threads." << std::endl;
+    return false;
+  }
+
+  if (mkdir(run_dir_.c_str(), 0777) != 0 && errno != EEXIST) {
+    std::cerr << "ERROR: Unable to create run directory " << run_dir_ << ": "
+              << strerror(errno) << std::endl;
+    return false;
+  }
+
+  struct sockaddr_un addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  if (socket_path_.size() >= sizeof(addr.sun_path)) {
+    std::cerr << "ERROR: Socket path " << socket_path_ << " is too long."
+              << std::endl;
+    return false;
+  }
+  strncpy(addr.sun_path, socket_path_.c_str(), sizeof(addr.sun_path) - 1);
+
+  listen_fd_ = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  unlink(socket_path_.c_str());
+  if (listen_fd_ < 0 ||
+      bind(listen_fd_, (struct sockaddr *)&addr, sizeof(addr)) != 0 ||
+      listen(listen_fd_, 16) != 0) {
+    std::cerr << "ERROR: Unable to listen on " << socket_path_ << ": "
+              << strerror(errno) << std::endl;
+    if (listen_fd_ >= 0) {
+      close(listen_fd_);
+    }
+    return false;
+  }
+
+  // Writing to a client that has gone away shouldn't kill the server.
+  signal(SIGPIPE, SIG_IGN);
+
+  std::cout << "Simulation server listening on " << socket_path_
+            << ", running up to " << jobs_ << " tests at a time in "
+            << run_dir_ << std::endl;
+
+  while (!quit_ || !running_.empty() || !queue_.empty()) {
+    while (!queue_.empty() && running_.size() < jobs_) {
+      Test test = queue_.front();
+      queue_.pop_front();
+      if (StartTest(test, test_args)) {
+        return true;
+      }
+    }
+
+    std::vector<struct pollfd> fds;
+    if (!quit_) {
+      fds.push_back({listen_fd_, POLLIN, 0});
+    }
+    for (const auto &client : clients_) {
+      fds.push_back({client.first, POLLIN, 0});
+    }
+
+    // Wake up regularly to reap children, rather than handling SIGCHLD.
+    if (poll(fds.data(), fds.size(), 50) < 0 && errno != EINTR) {
+      std::cerr << "ERROR: poll failed: " << strerror(errno) << std::endl;
+      break;
+    }
+
+    for (const struct pollfd &pfd : fds) {
+      if (!(pfd.revents & (POLLIN | POLLHUP | POLLERR))) {
+        continue;
+      }
+      if (pfd.fd == listen_fd_) {
+        int client_fd = accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+        if (client_fd >= 0) {
+          clients_[client_fd] = Client();
+        }
+        continue;
+      }
+
+      char buf[4096];
+      ssize_t len = read(pfd.fd, buf, sizeof(buf));
+      if (len <= 0) {
+        CloseClient(pfd.fd);
+        continue;
+      }
+      std::string &rx_buf = clients_[pfd.fd].rx_buf;
+      rx_buf.append(buf, len);
+      size_t eol;
+      while (clients_.count(pfd.fd) &&
+             (eol = rx_buf.find('\n')) != std::string::npos) {
+        std::string line = rx_buf.substr(0, eol);
+        rx_buf.erase(0, eol + 1);
+        HandleLine(pfd.fd, line);
+      }
+    }
+
+    ReapChildren();
+  }
+
+  for (auto it = clients_.begin(); it != clients_.end();) {
+    close((it++)->first);
+  }
+  close(listen_fd_);
+  unlink(socket_path_.c_str());
+  *retcode = 0;
+  return false;
+}
+
+void VerilatorSimServer::HandleLine(int client_fd, const std::string &line) {
+  std::istringstream iss(line);
+  std::string cmd;
+  iss >> cmd;
+
+  if (cmd == "QUIT") {
+    quit_ = true;
+    return;
+  }
+
+  if (cmd != "RUN") {
+    if (!cmd.empty()) {
+      Send(client_fd, "ERROR - unknown command " + cmd);
+    }
+    return;
+  }
+
+  Test test;
+  test.client_fd = client_fd;
+  iss >> test.name;
+  if (!IsValidTestName(test.name)) {
+    Send(client_fd, "ERROR - bad test name `" + test.name + "'");
+    return;
+  }
+  if (quit_) {
+    Send(client_fd, "ERROR " + test.name + " server is shutting down");
+    return;
+  }
+  std::string arg;
+  while (iss >> arg) {
+    test.args.push_back(arg);
+  }
+  queue_.push_back(test);
+}
+
+bool VerilatorSimServer::StartTest(const Test &test,
+                                   std::vector<std::string> *test_args) {
+  std::string test_dir = run_dir_ + "/" + test.name;
+  if (mkdir(test_dir.c_str(), 0777) != 0 && errno != EEXIST) {
+    Send(test.client_fd, "ERROR " + test.name + " cannot create " +
+                             test_dir + ": " + strerror(errno));
+    return false;
+  }
+
+  // Flush before forking, so that buffered output isn't written twice.
+  std::cout.flush();
+  std::cerr.flush();
+  fflush(nullptr);
+
+  pid_t pid = fork();
+  if (pid < 0) {
+    Send(test.client_fd,
+         "ERROR " + test.name + " fork failed: " + strerror(errno));
+    return false;
+  }
+
+  if (pid == 0) {
+    // In the child: drop the server's file descriptors and run the test in
+    // its own directory, logging to sim.log there.
+    for (const auto &client : clients_) {
+      close(client.first);
+    }
+    close(listen_fd_);
+    signal(SIGPIPE, SIG_DFL);
+
+    int log_fd = -1;
+    if (chdir(test_dir.c_str()) == 0) {
+      log_fd = open("sim.log", O_WRONLY | O_CREAT | O_TRUNC, 0666);
+    }
+    if (log_fd < 0) {
+      _exit(127);
+    }
+    dup2(log_fd, STDOUT_FILENO);
+    dup2(log_fd, STDERR_FILENO);
+    close(log_fd);
+
+    *test_args = test.args;
+    return true;
+  }
+
+  running_[pid] = test;
+  Send(test.client_fd,
+       "STARTED " + test.name + " " + std::to_string((long)pid));
+  return false;
+}
+
+void VerilatorSimServer::ReapChildren() {
+  int status;
+  pid_t pid;
+  while ((pid = waitpid(-1, &status, WNOHANG)) > 0) {
+    auto it = running_.find(pid);
+    if (it == running_.end()) {
+      continue;
+    }
+    int code = WIFEXITED(status) ? WEXITSTATUS(status)
+                                 : 128 + (WIFSIGNALED(status) ? WTERMSIG(status)
+                                                              : 0);
+    const Test &test = it->second;
+    Send(test.client_fd, "DONE " + test.name + " " + std::to_string(code) +
+                             " " + run_dir_ + "/" + test.name);
+    running_.erase(it);
+  }
+}
+
+void VerilatorSimServer::Send(int client_fd, const std::string &msg) {
+  if (!clients_.count(client_fd)) {
+    return;
+  }
+  std::string line = msg + "\n";
+  const char *p = line.data();
+  size_t left = line.size();
+  while (left) {
+    ssize_t len = write(client_fd, p, left);
+    if (len < 0 && errno == EINTR) {
+      continue;
+    }
+    if (len <= 0) {
+      CloseClient(client_fd);
+      return;
+    }
+    p += len;
+    left -= len;
+  }
+}
+
+void VerilatorSimServer::CloseClient(int client_fd) {
+  close(client_fd);
+  clients_.erase(client_fd);
+  // Tests that the client submitted still run, but nobody hears about them.
+  for (auto &test : running_) {
+    if (test.second.client_fd == client_fd) {
+      test.second.client_fd = -1;
+    }
+  }
+  for (auto &test : queue_) {
+    if (test.client_fd == client_fd) {
+      test.client_fd = -1;
+    }
+  }
+}
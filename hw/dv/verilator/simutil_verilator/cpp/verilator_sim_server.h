@@ -0,0 +1,107 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef OPENTITAN_HW_DV_VERILATOR_SIMUTIL_VERILATOR_CPP_VERILATOR_SIM_SERVER_H_
+#define OPENTITAN_HW_DV_VERILATOR_SIMUTIL_VERILATOR_CPP_VERILATOR_SIM_SERVER_H_
+
+#include <deque>
+#include <map>
+#include <string>
+#include <sys/types.h>
+#include <vector>
+
+/**
+ * A server running simulations of an already constructed model
+ *
+ * Constructing a large verilated model (and starting the process) takes a
+ * while, and regressions run many short tests on the same model. In server
+ * mode, the simulation constructs its model once and then waits for tests on
+ * a Unix domain socket. Each test is run in a child process forked from the
+ * server, so starts from the freshly constructed model (sharing its memory
+ * copy-on-write) and parses its own command line arguments, from which the
+ * memory images are loaded. Up to a given number of tests run in parallel.
+ *
+ * The protocol is line based. A client sends
+ *
+ *   RUN <name> <arg>...
+ *
+ * to run a test called name (which must be unique within a server's run
+ * directory), with the given extra command line arguments, separated by
+ * whitespace. The server answers with
+ *
+ *   STARTED <name> <pid>
+ *
+ * when the test starts, and
+ *
+ *   DONE <name> <exit code> <run directory>
+ *
+ * when it has finished (with an exit code of 128 + the signal number if it was
+ * killed by a signal). A test runs in its own directory under the server's run
+ * directory, so any relative paths in its arguments must be relative to that;
+ * its output is written to sim.log there. On an error, the server sends
+ * "ERROR <name> <message>".
+ *
+ * A client sending "QUIT" makes the server stop accepting tests, and exit once
+ * the running ones have finished.
+ *
+ * The model must not have any threads when the server starts, because only
+ * the forking thread exists in a child process: build it without --threads
+ * (or with --threads 1).
+ */
+class VerilatorSimServer {
+ public:
+  /**
+   * Constructor
+   *
+   * @param socket_path Path of the Unix domain socket to listen on
+   * @param jobs        Maximum number of tests to run at once
+   * @param run_dir     Directory holding one directory for each test
+   */
+  VerilatorSimServer(const std::string &socket_path, unsigned jobs,
+                     const std::string &run_dir);
+
+  /**
+   * Serve tests until a client sends QUIT
+   *
+   * This returns in the child process of each test, with the test's extra
+   * arguments in test_args, and set up so that the simulation can continue as
+   * if it hadn't been a server. In the server itself, it returns once all tests
+   * have finished.
+   *
+   * @param test_args Set to the arguments of the test (in a child process)
+   * @param retcode   Set to the exit code of the server (in the server)
+   * @return true in a child process, false in the server
+   */
+  bool Serve(std::vector<std::string> *test_args, int *retcode);
+
+ private:
+  struct Test {
+    std::string name;
+    std::vector<std::string> args;
+    int client_fd;
+  };
+
+  struct Client {
+    std::string rx_buf;
+  };
+
+  // Returns true in the child process.
+  bool StartTest(const Test &test, std::vector<std::string> *test_args);
+  void HandleLine(int client_fd, const std::string &line);
+  void ReapChildren();
+  void Send(int client_fd, const std::string &msg);
+  void CloseClient(int client_fd);
+
+  std::string socket_path_;
+  unsigned jobs_;
+  std::string run_dir_;
+  int listen_fd_;
+  bool quit_;
+  std::map<int, Client> clients_;
+  std::deque<Test> queue_;
+  // The running tests, by pid
+  std::map<pid_t, Test> running_;
+};
+
+#endif  // OPENTITAN_HW_DV_VERILATOR_SIMUTIL_VERILATOR_CPP_VERILATOR_SIM_SERVER_H_
@@ -118,19 +118,25 @@ void c_dpi_aes_crypt_block(const unsigned char impl_i, const unsigned char op_i,
   return;
 }
 
-void c_dpi_aes_crypt_message(unsigned char impl_i, unsigned char op_i,
-                             const svBitVecVal *mode_i, const svBitVecVal *iv_i,
-                             const svBitVecVal *key_len_i,
-                             const svBitVecVal *key_i,
-                             const svOpenArrayHandle data_i,
-                             svOpenArrayHandle data_o) {
+/**
+ * Shared implementation of c_dpi_aes_crypt_message() and
+ * c_dpi_aes_ctx_crypt_message(). If ctx is NULL, uses the context shared by
+ * crypto_encrypt() and crypto_decrypt().
+ */
+static void aes_crypt_message(crypto_ctx_t *ctx, const char *fn_name,
+                              unsigned char impl_i, unsigned char op_i,
+                              const svBitVecVal *mode_i,
+                              const svBitVecVal *iv_i,
+                              const svBitVecVal *key_len_i,
+                              const svBitVecVal *key_i,
+                              const svOpenArrayHandle data_i,
+                              svOpenArrayHandle data_o) {
   // Mask out unused bits as their value is undetermined.
   const unsigned char impl = impl_i & impl_mask;
   const unsigned char op = op_i & op_mask;
   const crypto_mode_t mode = (crypto_mode_t)(*mode_i & mode_mask);
   if (mode == kCryptoAesNone) {
-    printf(
-        "ERROR: Mode kCryptoAesNone not supported by c_dpi_aes_crypt_message");
+    printf("ERROR: Mode kCryptoAesNone not supported by %s", fn_name);
     return;
   }
 
@@ -146,23 +152,35 @@ void c_dpi_aes_crypt_message(unsigned char impl_i, unsigned char op_i,
 
   if (impl == 0) {
     // The C model is currently not supported.
+    printf("ERROR: %s currently supports OpenSSL/BoringSSL only\n", fn_name);
+    return;
+  }
+
+  // Get message length.
+  int data_len = svSize(data_i, 1);
+  if (data_len % 16) {
     printf(
-        "ERROR: c_dpi_aes_crypt_message() currently supports OpenSSL/BoringSSL "
-        "only\n");
+        "ERROR: Message length must be a multiple of 16 bytes (the block "
+        "size).\n");
     return;
   }
 
-  // Get key from simulator.
-  unsigned char *key = aes_key_get(key_i);
+  // Get key from simulator. key_i is a 1D array of words (8x32bit).
+  unsigned char key[32];
+  for (int i = 0; i < 8; ++i) {
+    svBitVecVal value = key_i[i];
+    key[4 * i + 0] = (unsigned char)(value >> 0);
+    key[4 * i + 1] = (unsigned char)(value >> 8);
+    key[4 * i + 2] = (unsigned char)(value >> 16);
+    key[4 * i + 3] = (unsigned char)(value >> 24);
+  }
 
   // Modes other than ECB require an IV from the simulator.
-  unsigned char *iv = (unsigned char *)malloc(16 * sizeof(unsigned char));
-  assert(iv);
+  unsigned char iv[16];
   if (mode != kCryptoAesEcb) {
     // iv_i is a 1D array of words (4x32bit), but we need 16 bytes.
-    svBitVecVal value;
     for (int i = 0; i < 4; ++i) {
-      value = iv_i[i];
+      svBitVecVal value = iv_i[i];
       iv[4 * i + 0] = (unsigned char)(value >> 0);
       iv[4 * i + 1] = (unsigned char)(value >> 8);
       iv[4 * i + 2] = (unsigned char)(value >> 16);
@@ -172,44 +190,71 @@ void c_dpi_aes_crypt_message(unsigned char impl_i, unsigned char op_i,
     memset(iv, 0, 16);
   }
 
-  // Get message length.
-  int data_len = svSize(data_i, 1);
-
-  // Get input data from simulator.
-  unsigned char *ref_in = aes_data_unpacked_get(data_i);
-
-  // Allocate output buffer.
-  unsigned char *ref_out =
-      (unsigned char *)malloc(data_len * sizeof(unsigned char));
-  assert(ref_out);
+  // Allocate one buffer for input and output data, and get the input from
+  // the simulator.
+  unsigned char *ref_in =
+      (unsigned char *)malloc(2 * data_len * sizeof(unsigned char) + 1);
+  assert(ref_in);
+  unsigned char *ref_out = ref_in + data_len;
+  aes_data_unpacked_read(data_i, ref_in, data_len);
 
   // OpenSSL/BoringSSL
-  if ((int)data_len % 16) {
-    printf(
-        "ERROR: Message length must be a multiple of 16 bytes (the block "
-        "size).\n");
-    return;
-  }
-
-  if (impl == 0) {
-    // The C model is currently not supported.
-    printf(
-        "ERROR: c_dpi_aes_crypt_message() currently supports OpenSSL/BoringSSL "
-        "only\n");
-  } else {  // OpenSSL/BoringSSL
-    if (!op) {
+  if (!op) {
+    if (ctx) {
+      crypto_ctx_encrypt(ctx, ref_out, iv, ref_in, data_len, key, key_len,
+                         mode);
+    } else {
       crypto_encrypt(ref_out, iv, ref_in, data_len, key, key_len, mode);
+    }
+  } else {
+    if (ctx) {
+      crypto_ctx_decrypt(ctx, ref_out, iv, ref_in, data_len, key, key_len,
+                         mode);
     } else {
       crypto_decrypt(ref_out, iv, ref_in, data_len, key, key_len, mode);
     }
   }
 
-  // Write output data back to simulator, free ref_out.
-  aes_data_unpacked_put(data_o, ref_out);
+  // Write output data back to simulator.
+  int out_len = svSize(data_o, 1);
+  aes_data_unpacked_write(data_o, ref_out,
+                          out_len < data_len ? out_len : data_len);
 
   // Free memory.
-  free(iv);
-  free(key);
+  free(ref_in);
+}
+
+void c_dpi_aes_crypt_message(unsigned char impl_i, unsigned char op_i,
+                             const svBitVecVal *mode_i, const svBitVecVal *iv_i,
+                             const svBitVecVal *key_len_i,
+                             const svBitVecVal *key_i,
+                             const svOpenArrayHandle data_i,
+                             svOpenArrayHandle data_o) {
+  aes_crypt_message(NULL, "c_dpi_aes_crypt_message()", impl_i, op_i, mode_i,
+                    iv_i, key_len_i, key_i, data_i, data_o);
+}
+
+void *c_dpi_aes_ctx_new(void) {
+  crypto_ctx_t *ctx = crypto_ctx_new();
+  if (!ctx) {
+    printf("ERROR: Creation of cipher context failed\n");
+  }
+  return ctx;
+}
+
+void c_dpi_aes_ctx_free(void *ctx) { crypto_ctx_free((crypto_ctx_t *)ctx); }
+
+void c_dpi_aes_ctx_crypt_message(void *ctx, unsigned char impl_i,
+                                 unsigned char op_i, const svBitVecVal *mode_i,
+                                 const svBitVecVal *iv_i,
+                                 const svBitVecVal *key_len_i,
+                                 const svBitVecVal *key_i,
+                                 const svOpenArrayHandle data_i,
+                                 svOpenArrayHandle data_o) {
+  assert(ctx);
+  aes_crypt_message((crypto_ctx_t *)ctx, "c_dpi_aes_ctx_crypt_message()",
+                    impl_i, op_i, mode_i, iv_i, key_len_i, key_i, data_i,
+                    data_o);
 }
 
 void c_dpi_aes_sub_bytes(const unsigned char op_i, const svBitVecVal *data_i,
@@ -342,10 +387,77 @@ void aes_data_put(svBitVecVal *data_o, unsigned char *data) {
   return;
 }
 
+/**
+ * Return the distance in bytes between the elements of an unpacked byte array
+ * in the memory returned by svGetArrayPtr(), or 0 if the simulator doesn't
+ * give direct access to the array.
+ *
+ * Simulators either store each bit [7:0] element in a single byte or use the
+ * canonical representation (one svBitVecVal per element). Either way, the
+ * value of the element is in its first byte on a little-endian host. Arrays
+ * that aren't indexed from 0 upwards use the per-element functions.
+ */
+static size_t aes_data_unpacked_stride(const svOpenArrayHandle arr) {
+  int num_elts = svSize(arr, 1);
+  if (num_elts <= 0 || !svGetArrayPtr(arr) || svLeft(arr, 1) != 0 ||
+      svLow(arr, 1) != 0) {
+    return 0;
+  }
+
+  int num_bytes = svSizeOfArray(arr);
+  if (num_bytes == num_elts) {
+    return 1;
+  }
+  if (num_bytes == num_elts * (int)sizeof(svBitVecVal)) {
+    return sizeof(svBitVecVal);
+  }
+  return 0;
+}
+
+void aes_data_unpacked_read(const svOpenArrayHandle data_i,
+                            unsigned char *data, int len) {
+  size_t stride = aes_data_unpacked_stride(data_i);
+  const unsigned char *ptr = (const unsigned char *)svGetArrayPtr(data_i);
+
+  if (stride == 1) {
+    memcpy(data, ptr, len);
+  } else if (stride) {
+    for (int i = 0; i < len; i++) {
+      data[i] = ptr[i * stride];
+    }
+  } else {
+    svBitVecVal value;
+    for (int i = 0; i < len; i++) {
+      svGetBitArrElem1VecVal(&value, data_i, i);
+      data[i] = (unsigned char)value;
+    }
+  }
+}
+
+void aes_data_unpacked_write(const svOpenArrayHandle data_o,
+                             const unsigned char *data, int len) {
+  size_t stride = aes_data_unpacked_stride(data_o);
+  unsigned char *ptr = (unsigned char *)svGetArrayPtr(data_o);
+
+  if (stride == 1) {
+    memcpy(ptr, data, len);
+  } else if (stride) {
+    memset(ptr, 0, len * stride);
+    for (int i = 0; i < len; i++) {
+      ptr[i * stride] = data[i];
+    }
+  } else {
+    svBitVecVal value;
+    for (int i = 0; i < len; i++) {
+      value = (svBitVecVal)data[i];
+      svPutBitArrElem1VecVal(data_o, &value, i);
+    }
+  }
+}
+
 unsigned char *aes_data_unpacked_get(const svOpenArrayHandle data_i) {
   unsigned char *data;
   int len;
-  svBitVecVal value;
 
   // alloc data buffer
   len = svSize(data_i, 1);
@@ -353,27 +465,15 @@ unsigned char *aes_data_unpacked_get(const svOpenArrayHandle data_i) {
   assert(data);
 
   // get data from simulator
-  for (int i = 0; i < len; i++) {
-    svGetBitArrElem1VecVal(&value, data_i, i);
-    data[i] = (unsigned char)value;
-  }
+  aes_data_unpacked_read(data_i, data, len);
 
   return data;
 }
 
 void aes_data_unpacked_put(const svOpenArrayHandle data_o,
                            unsigned char *data) {
-  int len;
-  svBitVecVal value;
-
-  // get size of data buffer
-  len = svSize(data_o, 1);
-
   // write output data to simulation
-  for (int i = 0; i < len; i++) {
-    value = (svBitVecVal)data[i];
-    svPutBitArrElem1VecVal(data_o, &value, i);
-  }
+  aes_data_unpacked_write(data_o, data, svSize(data_o, 1));
 
   // free data
   free(data);
@@ -62,6 +62,40 @@ void c_dpi_aes_crypt_message(unsigned char impl_i, unsigned char op_i,
                              const svOpenArrayHandle data_i,
                              svOpenArrayHandle data_o);
 
+/**
+ * Create a cipher context for c_dpi_aes_ctx_crypt_message().
+ *
+ * A context keeps the OpenSSL/BoringSSL cipher state and expanded key between
+ * messages, so a stream of messages with the same key, key length, mode and
+ * operation only needs the IV to be reloaded for each one.
+ *
+ * @return Context handle, NULL in case of an error
+ */
+void *c_dpi_aes_ctx_new(void);
+
+/**
+ * Free a context created by c_dpi_aes_ctx_new().
+ *
+ * @param  ctx       Context handle
+ */
+void c_dpi_aes_ctx_free(void *ctx);
+
+/**
+ * Perform encryption/decryption of an entire message using OpenSSL/BoringSSL,
+ * using a context created by c_dpi_aes_ctx_new().
+ *
+ * The other arguments are as for c_dpi_aes_crypt_message().
+ *
+ * @param  ctx       Context handle
+ */
+void c_dpi_aes_ctx_crypt_message(void *ctx, unsigned char impl_i,
+                                 unsigned char op_i, const svBitVecVal *mode_i,
+                                 const svBitVecVal *iv_i,
+                                 const svBitVecVal *key_len_i,
+                                 const svBitVecVal *key_i,
+                                 const svOpenArrayHandle data_i,
+                                 svOpenArrayHandle data_o);
+
 /**
  * Perform sub bytes operation for forward/inverse cipher operation.
  *
@@ -131,6 +165,31 @@ void aes_data_put(svBitVecVal *data_o, unsigned char *data);
  */
 unsigned char *aes_data_unpacked_get(const svOpenArrayHandle data_i);
 
+/**
+ * Copy len elements of unpacked data from simulation into data.
+ *
+ * This accesses the simulator's memory directly if possible.
+ *
+ * @param  data_i Input data from simulation
+ * @param  data   Destination buffer, at least len bytes long
+ * @param  len    Number of elements to copy
+ */
+void aes_data_unpacked_read(const svOpenArrayHandle data_i,
+                            unsigned char *data, int len);
+
+/**
+ * Copy len bytes of data into the first len elements of unpacked data in
+ * simulation.
+ *
+ * This accesses the simulator's memory directly if possible.
+ *
+ * @param  data_o Output data for simulation
+ * @param  data   Data to be copied to simulation
+ * @param  len    Number of elements to copy
+ */
+void aes_data_unpacked_write(const svOpenArrayHandle data_o,
+                             const unsigned char *data, int len);
+
 /**
  * Write unpacked data to simulation and free the source buffer
  * afterwards.
@@ -30,6 +30,28 @@ package aes_model_dpi_pkg;
     output bit        [7:0] data_o[]
   );
 
+  // Handle-based version of c_dpi_aes_crypt_message. A context keeps the cipher state and the
+  // expanded key between messages, so consecutive messages with the same key, key length, mode and
+  // operation only reload the IV.
+  import "DPI-C" context function chandle c_dpi_aes_ctx_new();
+
+  import "DPI-C" context function void c_dpi_aes_ctx_free(
+    input  chandle          ctx
+  );
+
+  import "DPI-C" context function void c_dpi_aes_ctx_crypt_message(
+    input  chandle          ctx,
+    input  bit              impl_i,    // 0 = C model, 1 = OpenSSL/BoringSSL
+    input  bit              op_i,      // 0 = encrypt, 1 = decrypt
+    input  bit        [5:0] mode_i,    // 6'b00_0001 = ECB, 6'00_b0010 = CBC, 6'b00_0100 = CFB,
+                                       // 6'b00_1000 = OFB, 6'b01_0000 = CTR, 6'b10_0000 = NONE
+    input  bit  [3:0][31:0] iv_i,
+    input  bit        [2:0] key_len_i, // 3'b001 = 128b, 3'b010 = 192b, 3'b100 = 256b
+    input  bit  [7:0][31:0] key_i,
+    input  bit        [7:0] data_i[],
+    output bit        [7:0] data_o[]
+  );
+
   import "DPI-C" context function void c_dpi_aes_sub_bytes(
     input  bit                op_i, // 0 = encrypt, 1 = decrypt
     input  bit[3:0][3:0][7:0] data_i,
@@ -35,9 +35,12 @@ class aes_scoreboard extends cip_base_scoreboard #(
   mailbox      #(aes_message_item)  msg_fifo;
   // once an operation is started the item is put here to wait for the resuting output
   aes_seq_item                      rcv_item_q[$];
+  // reference model context, which keeps the expanded key between messages
+  chandle                           ref_model_ctx;
 
   function void build_phase(uvm_phase phase);
     super.build_phase(phase);
+    ref_model_ctx    = c_dpi_aes_ctx_new();
     msg_fifo         = new();
     item_fifo        = new();
     key_manager_fifo = new("keymgr_analysis_fifo");
@@ -586,9 +589,10 @@ class aes_scoreboard extends cip_base_scoreboard #(
         //ref-model     / opration     / chipher mode /    IV   / key_len   / key /data i /data o //
         operation = msg.aes_operation == AES_ENC ? 1'b0 :
                     msg.aes_operation == AES_DEC ? 1'b1 : 1'b0;
-        c_dpi_aes_crypt_message(cfg.ref_model, operation, msg.aes_mode, msg.aes_iv,
-                                msg.aes_keylen, msg.aes_key[0] ^ msg.aes_key[1],
-                                msg.input_msg, msg.predicted_msg);
+        c_dpi_aes_ctx_crypt_message(ref_model_ctx, cfg.ref_model, operation, msg.aes_mode,
+                                    msg.aes_iv, msg.aes_keylen,
+                                    msg.aes_key[0] ^ msg.aes_key[1],
+                                    msg.input_msg, msg.predicted_msg);
 
         `uvm_info(`gfn, $sformatf("\n\t ----| printing MESSAGE %s", msg.convert2string()),
                   UVM_MEDIUM)
@@ -748,4 +752,11 @@ class aes_scoreboard extends cip_base_scoreboard #(
     `uvm_info(`gfn, $sformatf("%s", txt), UVM_MEDIUM)
 
   endfunction // report_phase
+
+
+  function void final_phase(uvm_phase phase);
+    super.final_phase(phase);
+    c_dpi_aes_ctx_free(ref_model_ctx);
+    ref_model_ctx = null;
+  endfunction
 endclass
@@ -6,6 +6,9 @@
 
 #include <openssl/conf.h>
 #include <openssl/evp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 /**
  * Get EVP_CIPHER type pointer defined by key_len and mode.
@@ -64,101 +67,156 @@ static const EVP_CIPHER *crypto_get_EVP_cipher(int key_len,
   return cipher;
 }
 
-int crypto_encrypt(unsigned char *output, const unsigned char *iv,
-                   const unsigned char *input, int input_len,
-                   const unsigned char *key, int key_len, crypto_mode_t mode) {
-  EVP_CIPHER_CTX *ctx;
-  int ret;
-  int len, output_len;
+struct crypto_ctx {
+  EVP_CIPHER_CTX *evp;
+  // Set if evp holds an expanded key for the parameters below
+  int valid;
+  int enc;
+  crypto_mode_t mode;
+  int key_len;
+  unsigned char key[32];
+};
+
+crypto_ctx_t *crypto_ctx_new(void) {
+  crypto_ctx_t *ctx = (crypto_ctx_t *)calloc(1, sizeof(crypto_ctx_t));
+  if (!ctx) {
+    return NULL;
+  }
 
-  // Create new cipher context
-  ctx = EVP_CIPHER_CTX_new();
+  ctx->evp = EVP_CIPHER_CTX_new();
+  if (!ctx->evp) {
+    free(ctx);
+    return NULL;
+  }
+
+  return ctx;
+}
+
+void crypto_ctx_free(crypto_ctx_t *ctx) {
   if (!ctx) {
-    printf("ERROR: Creation of cipher context failed\n");
-    return -1;
+    return;
   }
 
-  // Get cipher
-  const EVP_CIPHER *cipher = crypto_get_EVP_cipher(key_len, mode);
+  EVP_CIPHER_CTX_free(ctx->evp);
+  free(ctx);
+}
 
-  // Init encryption context
-  ret = EVP_EncryptInit_ex(ctx, cipher, NULL, key, iv);
+/**
+ * Run one message through a cipher context.
+ *
+ * If the key, key length, mode and direction match the previous call on ctx,
+ * only the IV is reloaded and the existing key schedule is reused. Otherwise
+ * the context is initialized from scratch.
+ *
+ * @param  enc       1 to encrypt, 0 to decrypt
+ * @return Length of the output in bytes, -1 in case of error
+ */
+static int crypto_ctx_crypt(crypto_ctx_t *ctx, int enc, unsigned char *output,
+                            const unsigned char *iv,
+                            const unsigned char *input, int input_len,
+                            const unsigned char *key, int key_len,
+                            crypto_mode_t mode) {
+  const char *op_name = enc ? "Encryption" : "Decryption";
+  int ret;
+  int len, output_len;
+
+  if (ctx->valid && ctx->enc == enc && ctx->mode == mode &&
+      ctx->key_len == key_len && !memcmp(ctx->key, key, key_len)) {
+    // Same key: just reset the state and load the new IV
+    ret = EVP_CipherInit_ex(ctx->evp, NULL, NULL, NULL, iv, enc);
+  } else {
+    ctx->valid = 0;
+    ret = EVP_CipherInit_ex(ctx->evp, crypto_get_EVP_cipher(key_len, mode),
+                            NULL, key, iv, enc);
+    if (ret == 1) {
+      ctx->valid = 1;
+      ctx->enc = enc;
+      ctx->mode = mode;
+      ctx->key_len = key_len;
+      memcpy(ctx->key, key, key_len);
+    }
+  }
 
   if (ret != 1) {
-    printf("ERROR: Initialization of encryption context failed\n");
+    ctx->valid = 0;
+    printf("ERROR: Initialization of %s context failed\n",
+           enc ? "encryption" : "decryption");
     return -1;
   }
 
   // Disable padding - It is safe to do so here because we only ever encrypt
-  // multiples of 16 bytes (the block size).
-  EVP_CIPHER_CTX_set_padding(ctx, 0);
+  // or decrypt multiples of 16 bytes (the block size).
+  EVP_CIPHER_CTX_set_padding(ctx->evp, 0);
 
-  // Provide encryption input, get first output bytes
-  ret = EVP_EncryptUpdate(ctx, output, &output_len, input, input_len);
+  // Provide input, get first output bytes
+  ret = EVP_CipherUpdate(ctx->evp, output, &output_len, input, input_len);
   if (ret != 1) {
-    printf("ERROR: Encryption operation failed\n");
+    ctx->valid = 0;
+    printf("ERROR: %s operation failed\n", op_name);
     return -1;
   }
 
-  // Finalize encryption, further bytes might be written
-  ret = EVP_EncryptFinal_ex(ctx, output + output_len, &len);
+  // Finalize, further bytes might be written
+  ret = EVP_CipherFinal_ex(ctx->evp, output + output_len, &len);
   if (ret != 1) {
-    printf("ERROR: Encryption finalizing failed\n");
+    ctx->valid = 0;
+    printf("ERROR: %s finalizing failed\n", op_name);
     return -1;
   }
   output_len += len;
 
-  // Free
-  EVP_CIPHER_CTX_free(ctx);
-
   return output_len;
 }
 
-int crypto_decrypt(unsigned char *output, const unsigned char *iv,
-                   const unsigned char *input, int input_len,
-                   const unsigned char *key, int key_len, crypto_mode_t mode) {
-  EVP_CIPHER_CTX *ctx;
-  int ret;
-  int len, output_len;
-
-  // Create new cipher context
-  ctx = EVP_CIPHER_CTX_new();
-  if (!ctx) {
-    printf("ERROR: Creation of cipher context failed\n");
-    return -1;
-  }
+int crypto_ctx_encrypt(crypto_ctx_t *ctx, unsigned char *output,
+                       const unsigned char *iv, const unsigned char *input,
+                       int input_len, const unsigned char *key, int key_len,
+                       crypto_mode_t mode) {
+  return crypto_ctx_crypt(ctx, 1, output, iv, input, input_len, key, key_len,
+                          mode);
+}
 
-  // Get cipher
-  const EVP_CIPHER *cipher = crypto_get_EVP_cipher(key_len, mode);
+int crypto_ctx_decrypt(crypto_ctx_t *ctx, unsigned char *output,
+                       const unsigned char *iv, const unsigned char *input,
+                       int input_len, const unsigned char *key, int key_len,
+                       crypto_mode_t mode) {
+  return crypto_ctx_crypt(ctx, 0, output, iv, input, input_len, key, key_len,
+                          mode);
+}
 
-  // Init decryption context
-  ret = EVP_DecryptInit_ex(ctx, cipher, NULL, key, iv);
-  if (ret != 1) {
-    printf("ERROR: Initialization of decryption context failed\n");
-    return -1;
+/**
+ * Get the context used by crypto_encrypt() and crypto_decrypt(), creating it
+ * on first use. It is never freed.
+ */
+static crypto_ctx_t *crypto_default_ctx(void) {
+  static crypto_ctx_t *ctx = NULL;
+  if (!ctx) {
+    ctx = crypto_ctx_new();
+    if (!ctx) {
+      printf("ERROR: Creation of cipher context failed\n");
+    }
   }
+  return ctx;
+}
 
-  // Disable padding - It is safe to do so here because we only ever decrypt
-  // multiples of 16 bytes (the block size).
-  EVP_CIPHER_CTX_set_padding(ctx, 0);
-
-  // Provide decryption input, get first output bytes
-  ret = EVP_DecryptUpdate(ctx, output, &output_len, input, input_len);
-  if (ret != 1) {
-    printf("ERROR: Decryption operation failed\n");
+int crypto_encrypt(unsigned char *output, const unsigned char *iv,
+                   const unsigned char *input, int input_len,
+                   const unsigned char *key, int key_len, crypto_mode_t mode) {
+  crypto_ctx_t *ctx = crypto_default_ctx();
+  if (!ctx) {
     return -1;
   }
+  return crypto_ctx_encrypt(ctx, output, iv, input, input_len, key, key_len,
+                            mode);
+}
 
-  // Finalize decryption, further bytes might be written
-  ret = EVP_DecryptFinal_ex(ctx, output + output_len, &len);
-  if (ret != 1) {
-    printf("ERROR: Decryption finalizing failed\n");
+int crypto_decrypt(unsigned char *output, const unsigned char *iv,
+                   const unsigned char *input, int input_len,
+                   const unsigned char *key, int key_len, crypto_mode_t mode) {
+  crypto_ctx_t *ctx = crypto_default_ctx();
+  if (!ctx) {
     return -1;
   }
-  output_len += len;
-
-  // Free
-  EVP_CIPHER_CTX_free(ctx);
-
-  return output_len;
+  return crypto_ctx_decrypt(ctx, output, iv, input, input_len, key, key_len,
+                            mode);
 }
@@ -17,9 +17,53 @@ typedef enum crypto_mode {
   kCryptoAesNone = 1 << 5
 } crypto_mode_t;
 
+/**
+ * A reusable BoringSSL/OpenSSL cipher context
+ *
+ * Setting up a cipher context and expanding the key is a large part of the
+ * cost of encrypting a short message. A crypto_ctx_t keeps both between calls,
+ * so consecutive messages with the same key, key length, mode and direction
+ * only need the IV to be reloaded.
+ */
+typedef struct crypto_ctx crypto_ctx_t;
+
+/**
+ * Create a cipher context
+ *
+ * @return New context, NULL in case of error. Free with crypto_ctx_free().
+ */
+crypto_ctx_t *crypto_ctx_new(void);
+
+/**
+ * Free a cipher context created by crypto_ctx_new(). Does nothing if ctx is
+ * NULL.
+ */
+void crypto_ctx_free(crypto_ctx_t *ctx);
+
+/**
+ * Encrypt using a cipher context. The arguments and return value are as for
+ * crypto_encrypt().
+ */
+int crypto_ctx_encrypt(crypto_ctx_t *ctx, unsigned char *output,
+                       const unsigned char *iv, const unsigned char *input,
+                       int input_len, const unsigned char *key, int key_len,
+                       crypto_mode_t mode);
+
+/**
+ * Decrypt using a cipher context. The arguments and return value are as for
+ * crypto_decrypt().
+ */
+int crypto_ctx_decrypt(crypto_ctx_t *ctx, unsigned char *output,
+                       const unsigned char *iv, const unsigned char *input,
+                       int input_len, const unsigned char *key, int key_len,
+                       crypto_mode_t mode);
+
 /**
  * Encrypt using BoringSSL/OpenSSL
  *
+ * This uses a context shared by all calls to crypto_encrypt() and
+ * crypto_decrypt(), so it is not thread-safe.
+ *
  * @param  output    Output cipher text, must be a multiple of 16 bytes
  * @param  iv        16-byte initialization vector
  * @param  input     Input plain text to encode, must be a multiple of 16 bytes
@@ -37,6 +81,8 @@ int crypto_encrypt(unsigned char *output, const unsigned char *iv,
 /**
  * Decrypt using BoringSSL/OpenSSL
  *
+ * This shares a context with crypto_encrypt(), so it is not thread-safe.
+ *
  * @param  output    Output plain text, must be a multiple of 16 bytes
  * @param  iv        16-byte initialization vector
  * @param  input     Input cipher text to decode, must be a multiple of 16 bytes
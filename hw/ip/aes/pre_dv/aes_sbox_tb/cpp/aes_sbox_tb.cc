@@ -9,6 +9,7 @@
 #include "Vaes_sbox_tb.h"
 #include "sim_ctrl_extension.h"
 #include "verilated_toplevel.h"
+#include "verilator_multi_sim.h"
 #include "verilator_sim_ctrl.h"
 
 class AESSBoxTB : public SimCtrlExtension {
@@ -34,9 +35,24 @@ void AESSBoxTB::OnClock(unsigned long sim_time) {
   }
 }
 
+// Construct a model for VerilatorMultiSim
+static VerilatorMultiSim::Model NewModel(VerilatedContext *context) {
+  aes_sbox_tb *top = new aes_sbox_tb(context);
+  return {std::unique_ptr<VerilatedToplevel>(top), &top->clk_i, &top->rst_ni,
+          &top->test_done_o, &top->test_passed_o};
+}
+
 int main(int argc, char **argv) {
   int ret_code;
 
+  // Run several instances with different seeds if requested (--instances).
+  VerilatorMultiSim multisim(NewModel,
+                             VerilatorSimCtrlFlags::ResetPolarityNegative);
+  std::pair<int, bool> multisim_ret = multisim.Exec(argc, argv);
+  if (multisim_ret.second) {
+    return multisim_ret.first;
+  }
+
   // Init verilog instance
   aes_sbox_tb top;
 
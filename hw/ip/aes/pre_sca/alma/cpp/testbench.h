@@ -6,14 +6,206 @@
 #ifndef OPENTITAN_HW_IP_AES_PRE_SCA_ALMA_CPP_TESTBENCH_H_
 #define OPENTITAN_HW_IP_AES_PRE_SCA_ALMA_CPP_TESTBENCH_H_
 
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
 #include "verilated.h"
 #include "verilated_vcd_c.h"
 
+/**
+ * VCD output file that only keeps selected signals.
+ *
+ * The VCD written by Verilator is filtered line by line: variables whose
+ * hierarchical name is not selected are dropped from the header together with
+ * their value changes, as are scopes and timestamps that end up empty. The
+ * result is still a regular VCD that the Alma flow can read.
+ *
+ * A signal is selected if its hierarchical name (without the leading `TOP`
+ * scope) equals one of the given names or lies below one of them, e.g.
+ * `aes_sbox.u_reg` selects all signals inside that instance.
+ */
+class VcdSignalFilter : public VerilatedVcdFile {
+ public:
+  explicit VcdSignalFilter(const std::vector<std::string> &signals)
+      : m_signals(signals) {}
+
+  bool open(const std::string &name) override {
+    m_file = fopen(name.c_str(), "w");
+    return m_file != NULL;
+  }
+
+  void close() override {
+    if (m_file) {
+      fclose(m_file);
+      m_file = NULL;
+    }
+  }
+
+  ssize_t write(const char *bufp, ssize_t len) override {
+    for (ssize_t i = 0; i < len; ++i) {
+      if (bufp[i] == '\n') {
+        line(m_line);
+        m_line.clear();
+      } else {
+        m_line += bufp[i];
+      }
+    }
+    return len;
+  }
+
+ private:
+  bool selected(const std::string &name) const {
+    for (const std::string &signal : m_signals) {
+      if (name.compare(0, signal.size(), signal) == 0 &&
+          (name.size() == signal.size() || name[signal.size()] == '.')) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void emit(const std::string &line) {
+    fputs(line.c_str(), m_file);
+    fputc('\n', m_file);
+  }
+
+  void header(const std::string &line) {
+    std::istringstream tokens(line);
+    std::string keyword;
+    tokens >> keyword;
+    if (keyword == "$scope") {
+      std::string type, name;
+      tokens >> type >> name;
+      m_scopes.push_back({line, name, false});
+    } else if (keyword == "$upscope") {
+      if (!m_scopes.empty()) {
+        if (m_scopes.back().emitted) {
+          emit(line);
+        }
+        m_scopes.pop_back();
+      }
+    } else if (keyword == "$var") {
+      std::string type, width, code, name;
+      tokens >> type >> width >> code >> name;
+      std::string path;
+      for (size_t i = 0; i < m_scopes.size(); ++i) {
+        if (i == 0 && m_scopes[i].name == "TOP") {
+          continue;
+        }
+        path += m_scopes[i].name + ".";
+      }
+      if (!selected(path + name)) {
+        return;
+      }
+      for (Scope &scope : m_scopes) {
+        if (!scope.emitted) {
+          emit(scope.line);
+          scope.emitted = true;
+        }
+      }
+      m_codes.insert(code);
+      emit(line);
+    } else {
+      if (keyword == "$enddefinitions") {
+        m_body = true;
+      }
+      emit(line);
+    }
+  }
+
+  void line(const std::string &line) {
+    if (!m_body) {
+      header(line);
+      return;
+    }
+    std::string code;
+    switch (line.empty() ? '\0' : line[0]) {
+      case '#':
+        // Only written once a value changes at this time.
+        m_time = line;
+        return;
+      case 'b':
+      case 'B':
+      case 'r':
+      case 'R':
+        code = line.substr(line.find(' ') + 1);
+        break;
+      case '0':
+      case '1':
+      case 'x':
+      case 'X':
+      case 'z':
+      case 'Z':
+        code = line.substr(1);
+        break;
+      default:
+        emit(line);
+        return;
+    }
+    if (m_codes.count(code)) {
+      if (!m_time.empty()) {
+        emit(m_time);
+        m_time.clear();
+      }
+      emit(line);
+    }
+  }
+
+  struct Scope {
+    std::string line;
+    std::string name;
+    bool emitted;
+  };
+
+  std::vector<std::string> m_signals;
+  FILE *m_file = NULL;
+  std::string m_line;
+  std::vector<Scope> m_scopes;
+  std::unordered_set<std::string> m_codes;
+  std::string m_time;
+  bool m_body = false;
+};
+
+/**
+ * Reads a signal list for `VcdSignalFilter`.
+ *
+ * The file holds one hierarchical name per line. Empty lines and everything
+ * following a `#` are ignored.
+ */
+inline std::vector<std::string> read_signal_list(const char *filename) {
+  std::vector<std::string> signals;
+  std::ifstream file(filename);
+  if (!file) {
+    fprintf(stderr, "Cannot read signal list %s\n", filename);
+    exit(1);
+  }
+  std::string line;
+  while (std::getline(file, line)) {
+    std::istringstream tokens(line.substr(0, line.find('#')));
+    std::string signal;
+    if (tokens >> signal) {
+      signals.push_back(signal);
+    }
+  }
+  return signals;
+}
+
 template <class Module>
 struct Testbench {
   unsigned long m_tickcount;
   Module m_core;
   VerilatedVcdC *m_trace = NULL;
+  VcdSignalFilter *m_filter = NULL;
 
   Testbench() {
     Verilated::traceEverOn(true);
@@ -22,9 +214,19 @@ struct Testbench {
 
   ~Testbench() { closetrace(); }
 
-  void opentrace(const char *vcdname) {
+  /**
+   * Opens a VCD trace.
+   *
+   * If `signals` is not empty, only the listed signals are traced (see
+   * `VcdSignalFilter`).
+   */
+  void opentrace(const char *vcdname,
+                 const std::vector<std::string> &signals = {}) {
     if (!m_trace) {
-      m_trace = new VerilatedVcdC;
+      if (!signals.empty()) {
+        m_filter = new VcdSignalFilter(signals);
+      }
+      m_trace = new VerilatedVcdC(m_filter);
       m_core.trace(m_trace, 99);
       m_trace->open(vcdname);
     }
@@ -36,6 +238,8 @@ struct Testbench {
       delete m_trace;
       m_trace = NULL;
     }
+    delete m_filter;
+    m_filter = NULL;
   }
 
   void reset() {
@@ -70,4 +274,97 @@ struct Testbench {
   bool done() { return Verilated::gotFinish(); }
 };
 
+/**
+ * Returns the value of an unsigned integer environment variable.
+ */
+inline unsigned long env_ulong(const char *name, unsigned long dflt) {
+  const char *value = getenv(name);
+  return value && *value ? strtoul(value, NULL, 0) : dflt;
+}
+
+/**
+ * Runs a testbench stimulus according to the ALMA_TRACE_* environment
+ * variables. These are used rather than plusargs as Alma's `trace.py` runs the
+ * testbench without arguments.
+ *
+ * By default, `stimulus` is applied once with fixed data (`rng` is NULL) and
+ * all signals are traced to `tmp.vcd`, as expected by `verify.py`.
+ *
+ * - ALMA_TRACE_SIGNALS: Path of a signal list (see `read_signal_list()`). Only
+ *   the listed signals are traced.
+ * - ALMA_TRACE_BATCHES: Number of batches to run. Each batch simulates its own
+ *   model instance with random data, seeded with ALMA_TRACE_SEED plus the
+ *   batch index, and writes `tmp_<batch>.vcd`. The batch traces can be
+ *   combined with `merge_vcd.py`.
+ * - ALMA_TRACE_ITERATIONS: Number of times `stimulus` is applied per batch.
+ * - ALMA_TRACE_JOBS: Number of batches simulated in parallel. Defaults to the
+ *   number of CPUs. Each batch runs in its own process, so models and traces
+ *   don't share any state.
+ *
+ * @return The exit status for `main()`.
+ */
+template <class Module>
+int run_testbench(void (*stimulus)(Testbench<Module> &tb,
+                                   std::mt19937_64 *rng)) {
+  std::vector<std::string> signals;
+  const char *signal_list = getenv("ALMA_TRACE_SIGNALS");
+  if (signal_list && *signal_list) {
+    signals = read_signal_list(signal_list);
+  }
+
+  unsigned long batches = env_ulong("ALMA_TRACE_BATCHES", 0);
+  if (batches == 0) {
+    Testbench<Module> tb;
+    tb.opentrace("tmp.vcd", signals);
+    stimulus(tb, NULL);
+    tb.closetrace();
+    return 0;
+  }
+
+  unsigned long iterations = env_ulong("ALMA_TRACE_ITERATIONS", 1);
+  unsigned long seed = env_ulong("ALMA_TRACE_SEED", 0);
+  long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+  unsigned long jobs = env_ulong("ALMA_TRACE_JOBS", cpus > 0 ? cpus : 1);
+  if (jobs == 0) {
+    jobs = 1;
+  }
+
+  int status = 0;
+  unsigned long running = 0;
+  for (unsigned long batch = 0; batch < batches || running > 0;) {
+    if (batch < batches && running < jobs) {
+      pid_t pid = fork();
+      if (pid < 0) {
+        perror("fork");
+        return 1;
+      }
+      if (pid == 0) {
+        std::mt19937_64 rng(seed + batch);
+        char vcdname[32];
+        snprintf(vcdname, sizeof(vcdname), "tmp_%lu.vcd", batch);
+        Testbench<Module> tb;
+        tb.opentrace(vcdname, signals);
+        for (unsigned long i = 0; i < iterations; ++i) {
+          stimulus(tb, &rng);
+        }
+        tb.closetrace();
+        _exit(0);
+      }
+      ++batch;
+      ++running;
+    } else {
+      int child;
+      if (wait(&child) < 0) {
+        perror("wait");
+        return 1;
+      }
+      if (!WIFEXITED(child) || WEXITSTATUS(child) != 0) {
+        status = 1;
+      }
+      --running;
+    }
+  }
+  return status;
+}
+
 #endif  // OPENTITAN_HW_IP_AES_PRE_SCA_ALMA_CPP_TESTBENCH_H_
@@ -0,0 +1,91 @@
+#!/usr/bin/env python3
+# Copyright lowRISC contributors (OpenTitan project).
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+"""Concatenates the batch traces written by the Alma testbenches.
+
+With ALMA_TRACE_BATCHES set, the testbenches in `cpp` write one VCD per batch
+(`tmp_<batch>.vcd`). All batches trace the same netlist with the same signal
+selection and thus share the same header. This script writes a single VCD that
+holds the batches one after the other in time, such that tools consuming one
+VCD can process all of them.
+"""
+
+import argparse
+import sys
+from pathlib import Path
+from typing import List, TextIO, Tuple
+
+
+def split_vcd(path: Path) -> Tuple[List[str], List[str]]:
+    """Return the header and body lines of a VCD.
+
+    The `$date` section is dropped from the header, as it differs between
+    batches.
+    """
+    header = []
+    lines = path.read_text().splitlines()
+    in_date = False
+    for idx, line in enumerate(lines):
+        if line.lstrip().startswith('$date'):
+            in_date = True
+        if not in_date:
+            header.append(line)
+        elif line.rstrip().endswith('$end'):
+            in_date = False
+        if line.lstrip().startswith('$enddefinitions'):
+            return header, lines[idx + 1:]
+    raise ValueError(f'{path}: no $enddefinitions')
+
+
+def merge(paths: List[Path], gap: int, out: TextIO) -> None:
+    header = None
+    offset = 0
+    for path in paths:
+        this_header, body = split_vcd(path)
+        if header is None:
+            header = this_header
+            out.write('\n'.join(header) + '\n')
+        elif this_header != header:
+            raise ValueError(f'{path}: header differs from {paths[0]}')
+
+        end = offset
+        for line in body:
+            if line.startswith('#'):
+                end = offset + int(line[1:])
+                out.write(f'#{end}\n')
+            elif line:
+                out.write(line + '\n')
+        offset = end + gap
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('inputs',
+                        nargs='+',
+                        type=Path,
+                        help='Batch traces, in order')
+    parser.add_argument('--output',
+                        '-o',
+                        required=True,
+                        type=Path,
+                        help='Merged trace')
+    parser.add_argument('--gap',
+                        type=int,
+                        default=10,
+                        help='Time between the end of a batch and the start '
+                        'of the next one (default: %(default)s, i.e., half a '
+                        'clock cycle of the testbenches)')
+    args = parser.parse_args()
+
+    try:
+        with open(args.output, 'w') as out:
+            merge(args.inputs, args.gap, out)
+    except ValueError as err:
+        print(f'error: {err}', file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
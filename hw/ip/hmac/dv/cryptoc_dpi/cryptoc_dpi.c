@@ -6,11 +6,13 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "hmac.h"
 #include "hmac_wrap.h"
 #include "sha.h"
 #include "sha256.h"
+#include "sha2_openssl.h"
 #include "sha384.h"
 #include "sha512.h"
 
@@ -75,12 +77,16 @@ extern void c_dpi_SHA256_hash(const svOpenArrayHandle msg, uint64_t len,
     assert(arr);
 
     // compute SHA256 hash
-    SHA256_hash(arr, len, (uint8_t *)hash);
+    if (!sha2_openssl_hash(kCryptocHashSha256, arr, len, (uint8_t *)hash)) {
+      SHA256_hash(arr, len, (uint8_t *)hash);
+    }
 
     free(arr);
   } else {
     // compute SHA256 hash when msg is empty
-    SHA256_hash(NULL, 0u, (uint8_t *)hash);
+    if (!sha2_openssl_hash(kCryptocHashSha256, NULL, 0u, (uint8_t *)hash)) {
+      SHA256_hash(NULL, 0u, (uint8_t *)hash);
+    }
   }
 }
 
@@ -91,12 +97,16 @@ extern void c_dpi_SHA384_hash(const svOpenArrayHandle msg, uint64_t len,
     assert(arr);
 
     // compute SHA384 hash
-    SHA384_hash(arr, len, (uint8_t *)hash);
+    if (!sha2_openssl_hash(kCryptocHashSha384, arr, len, (uint8_t *)hash)) {
+      SHA384_hash(arr, len, (uint8_t *)hash);
+    }
 
     free(arr);
   } else {
     // compute SHA384 hash when msg is empty
-    SHA384_hash(NULL, 0u, (uint8_t *)hash);
+    if (!sha2_openssl_hash(kCryptocHashSha384, NULL, 0u, (uint8_t *)hash)) {
+      SHA384_hash(NULL, 0u, (uint8_t *)hash);
+    }
   }
 }
 
@@ -107,12 +117,16 @@ extern void c_dpi_SHA512_hash(const svOpenArrayHandle msg, uint64_t len,
     assert(arr);
 
     // compute SHA512 hash
-    SHA512_hash(arr, len, (uint8_t *)hash);
+    if (!sha2_openssl_hash(kCryptocHashSha512, arr, len, (uint8_t *)hash)) {
+      SHA512_hash(arr, len, (uint8_t *)hash);
+    }
 
     free(arr);
   } else {
     // compute SHA512 hash when msg is empty
-    SHA512_hash(NULL, 0u, (uint8_t *)hash);
+    if (!sha2_openssl_hash(kCryptocHashSha512, NULL, 0u, (uint8_t *)hash)) {
+      SHA512_hash(NULL, 0u, (uint8_t *)hash);
+    }
   }
 }
 
@@ -145,12 +159,18 @@ extern void c_dpi_HMAC_SHA256(const svOpenArrayHandle key, uint64_t key_len,
     assert(msg_arr);
 
     // compute SHA256 hash
-    HMAC_SHA256(key_arr, key_len, msg_arr, msg_len, (uint8_t *)hmac);
+    if (!sha2_openssl_hmac(kCryptocHashSha256, key_arr, key_len, msg_arr,
+                           msg_len, (uint8_t *)hmac)) {
+      HMAC_SHA256(key_arr, key_len, msg_arr, msg_len, (uint8_t *)hmac);
+    }
 
     free(msg_arr);
   } else {
     // compute SHA256 hash when msg is empty
-    HMAC_SHA256(key_arr, key_len, NULL, 0u, (uint8_t *)hmac);
+    if (!sha2_openssl_hmac(kCryptocHashSha256, key_arr, key_len, NULL, 0u,
+                           (uint8_t *)hmac)) {
+      HMAC_SHA256(key_arr, key_len, NULL, 0u, (uint8_t *)hmac);
+    }
   }
 
   free(key_arr);
@@ -166,12 +186,18 @@ extern void c_dpi_HMAC_SHA384(const svOpenArrayHandle key, uint64_t key_len,
     assert(msg_arr);
 
     // compute SHA384 hash
-    HMAC_SHA384(key_arr, key_len, msg_arr, msg_len, (uint8_t *)hmac);
+    if (!sha2_openssl_hmac(kCryptocHashSha384, key_arr, key_len, msg_arr,
+                           msg_len, (uint8_t *)hmac)) {
+      HMAC_SHA384(key_arr, key_len, msg_arr, msg_len, (uint8_t *)hmac);
+    }
 
     free(msg_arr);
   } else {
     // compute SHA384 hash when msg is empty
-    HMAC_SHA384(key_arr, key_len, NULL, 0u, (uint8_t *)hmac);
+    if (!sha2_openssl_hmac(kCryptocHashSha384, key_arr, key_len, NULL, 0u,
+                           (uint8_t *)hmac)) {
+      HMAC_SHA384(key_arr, key_len, NULL, 0u, (uint8_t *)hmac);
+    }
   }
 
   free(key_arr);
@@ -188,13 +214,157 @@ extern void c_dpi_HMAC_SHA512(const svOpenArrayHandle key, uint64_t key_len,
     assert(msg_arr);
 
     // compute SHA512 hash
-    HMAC_SHA512(key_arr, key_len, msg_arr, msg_len, (uint8_t *)hmac);
+    if (!sha2_openssl_hmac(kCryptocHashSha512, key_arr, key_len, msg_arr,
+                           msg_len, (uint8_t *)hmac)) {
+      HMAC_SHA512(key_arr, key_len, msg_arr, msg_len, (uint8_t *)hmac);
+    }
 
     free(msg_arr);
   } else {
     // compute SHA512 hash when msg is empty
-    HMAC_SHA512(key_arr, key_len, NULL, 0u, (uint8_t *)hmac);
+    if (!sha2_openssl_hmac(kCryptocHashSha512, key_arr, key_len, NULL, 0u,
+                           (uint8_t *)hmac)) {
+      HMAC_SHA512(key_arr, key_len, NULL, 0u, (uint8_t *)hmac);
+    }
   }
 
   free(key_arr);
 }
+
+// Incremental hashing
+//
+// A cryptoc_dpi_ctx_t holds a SHA or HMAC computation that has absorbed some
+// prefix of a message. More data can be added with c_dpi_hash_ctx_update, and
+// the digest of the message so far can be read with c_dpi_hash_ctx_final
+// without disturbing the context. This lets a testbench check intermediate
+// digests without rehashing the whole message each time.
+
+typedef struct cryptoc_dpi_ctx {
+  unsigned int hash_alg;
+  int is_hmac;
+  // Each member starts with a HASH_CTX, so u.hash can be used for updates
+  // whichever one is in use.
+  union {
+    HASH_CTX hash;
+    LITE_HMAC_CTX lite_hmac;
+    HMAC_CTX hmac;
+  } u;
+} cryptoc_dpi_ctx_t;
+
+static void init_hash(cryptoc_dpi_ctx_t *ctx) {
+  switch (ctx->hash_alg) {
+    case kCryptocHashSha:
+      SHA_init(&ctx->u.hash);
+      break;
+    case kCryptocHashSha256:
+      SHA256_init(&ctx->u.hash);
+      break;
+    case kCryptocHashSha384:
+      SHA384_init(&ctx->u.hash);
+      break;
+    case kCryptocHashSha512:
+      SHA512_init(&ctx->u.hash);
+      break;
+    default:
+      assert(0);
+  }
+}
+
+static void init_hmac(cryptoc_dpi_ctx_t *ctx, const uint8_t *key,
+                      unsigned int key_len) {
+  switch (ctx->hash_alg) {
+    case kCryptocHashSha:
+      HMAC_SHA_init(&ctx->u.lite_hmac, key, key_len);
+      break;
+    case kCryptocHashSha256:
+      HMAC_SHA256_init(&ctx->u.lite_hmac, key, key_len);
+      break;
+    case kCryptocHashSha384:
+      HMAC_SHA384_init(&ctx->u.hmac, key, key_len);
+      break;
+    case kCryptocHashSha512:
+      HMAC_SHA512_init(&ctx->u.hmac, key, key_len);
+      break;
+    default:
+      assert(0);
+  }
+}
+
+static cryptoc_dpi_ctx_t *alloc_ctx(unsigned int hash_alg, int is_hmac) {
+  if (hash_alg > kCryptocHashSha512) {
+    fprintf(stderr, "ERROR: Unknown cryptoc hash algorithm %u.\n", hash_alg);
+    return NULL;
+  }
+
+  cryptoc_dpi_ctx_t *ctx = (cryptoc_dpi_ctx_t *)malloc(sizeof(*ctx));
+  assert(ctx);
+  ctx->hash_alg = hash_alg;
+  ctx->is_hmac = is_hmac;
+  return ctx;
+}
+
+extern void *c_dpi_hash_ctx_new(unsigned int hash_alg) {
+  cryptoc_dpi_ctx_t *ctx = alloc_ctx(hash_alg, 0);
+  if (ctx) {
+    init_hash(ctx);
+  }
+  return ctx;
+}
+
+extern void *c_dpi_hmac_ctx_new(unsigned int hash_alg,
+                                const svOpenArrayHandle key, uint64_t key_len) {
+  cryptoc_dpi_ctx_t *ctx = alloc_ctx(hash_alg, 1);
+  if (ctx) {
+    uint8_t *key_arr = key_len > 0u ? collect_bytes(key, key_len) : NULL;
+    assert(key_arr || key_len == 0u);
+
+    init_hmac(ctx, key_arr, key_len);
+
+    free(key_arr);
+  }
+  return ctx;
+}
+
+extern void c_dpi_hash_ctx_update(void *ctx, const svOpenArrayHandle msg,
+                                  uint64_t len) {
+  assert(ctx);
+  if (len > 0u) {
+    uint8_t *arr = collect_bytes(msg, len);
+    assert(arr);
+
+    HASH_update(&((cryptoc_dpi_ctx_t *)ctx)->u.hash, arr, len);
+
+    free(arr);
+  }
+}
+
+extern void *c_dpi_hash_ctx_clone(const void *ctx) {
+  assert(ctx);
+  cryptoc_dpi_ctx_t *copy = (cryptoc_dpi_ctx_t *)malloc(sizeof(*copy));
+  assert(copy);
+  memcpy(copy, ctx, sizeof(*copy));
+  return copy;
+}
+
+extern void c_dpi_hash_ctx_final(const void *ctx, uint32_t digest[16]) {
+  assert(ctx);
+
+  // Finalising a cryptoc context consumes it, so work on a copy
+  cryptoc_dpi_ctx_t tmp;
+  memcpy(&tmp, ctx, sizeof(tmp));
+
+  const uint8_t *result;
+  if (!tmp.is_hmac) {
+    result = HASH_final(&tmp.u.hash);
+  } else if (tmp.hash_alg == kCryptocHashSha ||
+             tmp.hash_alg == kCryptocHashSha256) {
+    result = HMAC_final_LITE(&tmp.u.lite_hmac);
+  } else {
+    result = HMAC_final(&tmp.u.hmac);
+  }
+
+  memset(digest, 0, 16 * sizeof(uint32_t));
+  memcpy(digest, result, HASH_size(&tmp.u.hash));
+}
+
+extern void c_dpi_hash_ctx_free(void *ctx) { free(ctx); }
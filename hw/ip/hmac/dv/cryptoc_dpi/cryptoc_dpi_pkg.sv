@@ -9,6 +9,15 @@ package cryptoc_dpi_pkg;
   // macro includes
   `include "uvm_macros.svh"
 
+  // Hash algorithms for the incremental context functions below. These values must match the
+  // enum in cryptoc_dpi.c.
+  typedef enum int unsigned {
+    CryptocHashSha    = 0,
+    CryptocHashSha256 = 1,
+    CryptocHashSha384 = 2,
+    CryptocHashSha512 = 3
+  } cryptoc_hash_e;
+
   // DPI-C imports
   //
   // Note: alas we must supply the array lengths as additional parameters to appease xcelium
@@ -54,6 +63,31 @@ package cryptoc_dpi_pkg;
                                                          input longint unsigned msg_len,
                                                          output int unsigned hmac[16]);
 
+  // Incremental hashing
+  //
+  // A context holds the state of a SHA or HMAC computation that has absorbed a prefix of the
+  // message. c_dpi_hash_ctx_update adds more of the message and c_dpi_hash_ctx_final returns the
+  // digest of the data so far (the first 5, 8, 12 or 16 words of digest, depending on the
+  // algorithm), leaving the context unchanged. c_dpi_hash_ctx_clone makes an independent copy,
+  // which can be used to model a save and restore of the hardware's context. Each context must be
+  // released with c_dpi_hash_ctx_free.
+  import "DPI-C" context function chandle c_dpi_hash_ctx_new(input cryptoc_hash_e hash_alg);
+
+  import "DPI-C" context function chandle c_dpi_hmac_ctx_new(input cryptoc_hash_e hash_alg,
+                                                             input bit[7:0] key[],
+                                                             input longint unsigned key_len);
+
+  import "DPI-C" context function void c_dpi_hash_ctx_update(input chandle ctx,
+                                                             input bit[7:0] msg[],
+                                                             input longint unsigned len);
+
+  import "DPI-C" context function chandle c_dpi_hash_ctx_clone(input chandle ctx);
+
+  import "DPI-C" context function void c_dpi_hash_ctx_final(input chandle ctx,
+                                                            output int unsigned digest[16]);
+
+  import "DPI-C" context function void c_dpi_hash_ctx_free(input chandle ctx);
+
   // sv wrapper functions
   function automatic void sv_dpi_get_sha_digest(input bit[7:0] msg[],
                                                 output int unsigned hash[8]);
@@ -115,4 +149,18 @@ package cryptoc_dpi_pkg;
     c_dpi_HMAC_SHA512(ckey, ckey.size(), msg, msg.size(), hmac);
   endfunction
 
+  function automatic chandle sv_dpi_hmac_ctx_new(input cryptoc_hash_e hash_alg,
+                                                 input bit[31:0] key[]);
+    bit [7:0] ckey[];
+    int ckey_size_bytes = $bits(key) / 8;
+    ckey = new[ckey_size_bytes];
+    {>>{ckey}} = key;
+    return c_dpi_hmac_ctx_new(hash_alg, ckey, ckey.size());
+  endfunction
+
+  function automatic void sv_dpi_hash_ctx_update(input chandle ctx,
+                                                 input bit[7:0] msg[]);
+    c_dpi_hash_ctx_update(ctx, msg, msg.size());
+  endfunction
+
 endpackage
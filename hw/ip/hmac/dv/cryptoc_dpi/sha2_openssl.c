@@ -0,0 +1,60 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "sha2_openssl.h"
+
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+#include <stdlib.h>
+
+// Returns the OpenSSL digest for hash_alg, or NULL if it isn't SHA-2
+static const EVP_MD *get_md(unsigned int hash_alg) {
+  switch (hash_alg) {
+    case kCryptocHashSha256:
+      return EVP_sha256();
+    case kCryptocHashSha384:
+      return EVP_sha384();
+    case kCryptocHashSha512:
+      return EVP_sha512();
+    default:
+      return NULL;
+  }
+}
+
+int sha2_openssl_enabled(void) {
+  // -1 until the first call decides
+  static int enabled = -1;
+  if (enabled < 0) {
+    enabled = getenv("CRYPTOC_DPI_NO_OPENSSL") == NULL &&
+              EVP_get_digestbyname("SHA256") != NULL &&
+              EVP_get_digestbyname("SHA384") != NULL &&
+              EVP_get_digestbyname("SHA512") != NULL;
+  }
+  return enabled;
+}
+
+int sha2_openssl_hash(unsigned int hash_alg, const uint8_t *msg, size_t len,
+                      uint8_t *digest) {
+  const EVP_MD *md = get_md(hash_alg);
+  if (!md || !sha2_openssl_enabled()) {
+    return 0;
+  }
+  unsigned int digest_len;
+  return EVP_Digest(msg, len, digest, &digest_len, md, NULL) == 1;
+}
+
+int sha2_openssl_hmac(unsigned int hash_alg, const uint8_t *key,
+                      size_t key_len, const uint8_t *msg, size_t msg_len,
+                      uint8_t *digest) {
+  const EVP_MD *md = get_md(hash_alg);
+  if (!md || !sha2_openssl_enabled()) {
+    return 0;
+  }
+  // HMAC() treats a NULL key as "reuse the previous key", so an empty key must
+  // still be a valid pointer.
+  static const uint8_t empty_key[1];
+  unsigned int digest_len;
+  return HMAC(md, key ? key : empty_key, (int)key_len, msg, msg_len, digest,
+              &digest_len) != NULL;
+}
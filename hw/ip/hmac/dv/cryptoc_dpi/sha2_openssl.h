@@ -0,0 +1,56 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef OPENTITAN_HW_IP_HMAC_DV_CRYPTOC_DPI_SHA2_OPENSSL_H_
+#define OPENTITAN_HW_IP_HMAC_DV_CRYPTOC_DPI_SHA2_OPENSSL_H_
+
+// One-shot SHA-2 and HMAC-SHA-2 using OpenSSL's libcrypto.
+//
+// OpenSSL picks the fastest implementation the host supports (SHA-NI, AVX2 and
+// so on), which is many times faster than the portable cryptoc code for long
+// messages. The DPI wrappers in cryptoc_dpi.c try these functions first and
+// fall back to cryptoc if they return 0.
+//
+// This file doesn't include cryptoc's headers, whose HMAC_CTX and HMAC_*
+// names clash with OpenSSL's.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// The hash algorithm; these values match cryptoc_hash_e in cryptoc_dpi_pkg.
+enum {
+  kCryptocHashSha = 0,
+  kCryptocHashSha256 = 1,
+  kCryptocHashSha384 = 2,
+  kCryptocHashSha512 = 3
+};
+
+// Returns nonzero if OpenSSL is used for SHA-2.
+//
+// This is decided once, on the first call: OpenSSL is used unless the
+// CRYPTOC_DPI_NO_OPENSSL environment variable is set or libcrypto can't
+// provide the SHA-2 digests.
+int sha2_openssl_enabled(void);
+
+// Computes the SHA-256, SHA-384 or SHA-512 digest of msg into digest. Returns
+// 0, without touching digest, if OpenSSL is disabled or hash_alg is not a
+// SHA-2 algorithm.
+int sha2_openssl_hash(unsigned int hash_alg, const uint8_t *msg, size_t len,
+                      uint8_t *digest);
+
+// Computes the HMAC of msg with key into digest, as sha2_openssl_hash does for
+// a plain digest.
+int sha2_openssl_hmac(unsigned int hash_alg, const uint8_t *key,
+                      size_t key_len, const uint8_t *msg, size_t msg_len,
+                      uint8_t *digest);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // OPENTITAN_HW_IP_HMAC_DV_CRYPTOC_DPI_SHA2_OPENSSL_H_
@@ -2,46 +2,295 @@
 // Licensed under the Apache License, Version 2.0, see LICENSE for details.
 // SPDX-License-Identifier: Apache-2.0
 
+#include <algorithm>
+#include <cassert>
 #include <cstdint>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
-#include <list>
+#include <memory>
+#include <vector>
 
 #include "svdpi.h"
 #include "vendor/kerukuro_digestpp/algorithm/kmac.hpp"
 #include "vendor/kerukuro_digestpp/algorithm/sha3.hpp"
 #include "vendor/kerukuro_digestpp/algorithm/shake.hpp"
 
-extern "C" {
-
 //////////////////////
 // HELPER FUNCTIONS //
 //////////////////////
 
+/**
+ * Return the distance in bytes between elements of a byte array passed from
+ * SV, if the simulator gives direct access to it through svGetArrayPtr, or 0
+ * otherwise.
+ *
+ * Simulators either store each bit[7:0] element in a single byte or use the
+ * canonical representation (one svBitVecVal per element). Either way, the
+ * value of the element is in its first byte on a little-endian host. Arrays
+ * that aren't indexed from 0 upwards are left to the slow path.
+ */
+static size_t get_arr_stride(const svOpenArrayHandle arr, uint64_t len) {
+  if (len == 0 || !svGetArrayPtr(arr) || svLeft(arr, 1) != 0 ||
+      svLow(arr, 1) != 0 || (uint64_t)svSize(arr, 1) < len)
+    return 0;
+
+  int num_elts = svSize(arr, 1);
+  int num_bytes = svSizeOfArray(arr);
+  if (num_bytes == num_elts)
+    return 1;
+  if (num_bytes == num_elts * (int)sizeof(svBitVecVal))
+    return sizeof(svBitVecVal);
+  return 0;
+}
+
+/**
+ * Call fn(data, len) on successive chunks of the first array_len bytes of an
+ * unsized array in SV memory. If the simulator stores one byte per element,
+ * the array is passed in one chunk with no copying.
+ */
+template <typename F>
+static void for_each_arr_chunk(const svOpenArrayHandle arr, uint64_t array_len,
+                               F fn) {
+  size_t stride = get_arr_stride(arr, array_len);
+  const uint8_t *ptr = (const uint8_t *)svGetArrayPtr(arr);
+
+  if (stride == 1) {
+    fn(ptr, array_len);
+    return;
+  }
+
+  uint8_t buf[4096];
+  for (uint64_t i = 0; i < array_len; i += sizeof(buf)) {
+    uint64_t chunk_len = std::min<uint64_t>(sizeof(buf), array_len - i);
+    for (uint64_t j = 0; j < chunk_len; j++) {
+      if (stride) {
+        buf[j] = ptr[(i + j) * stride];
+      } else {
+        svBitVecVal val;
+        svGetBitArrElem1VecVal(&val, arr, i + j);
+        buf[j] = (uint8_t)val;
+      }
+    }
+    fn(buf, chunk_len);
+  }
+}
+
 /**
  * Generic function to load an unsized array from SV memory into C memory.
  */
 static void load_arr_from_simulator(const svOpenArrayHandle arr,
                                     uint8_t *array_out, uint64_t array_len) {
-  for (uint64_t i = 0; i < array_len; i++) {
-    svBitVecVal val;
-    svGetBitArrElem1VecVal(&val, arr, i);
-    array_out[i] = (uint8_t)val;
-  }
+  for_each_arr_chunk(arr, array_len, [&](const uint8_t *data, uint64_t len) {
+    memcpy(array_out, data, len);
+    array_out += len;
+  });
 }
 
 /**
  * Generic function to write an unsized array from C memory into SV memory.
  */
 static void write_array_to_simulator(const svOpenArrayHandle arr,
-                                     uint8_t *data) {
+                                     const uint8_t *data) {
   uint64_t arr_len = svSize(arr, 1);
+  size_t stride = get_arr_stride(arr, arr_len);
+  uint8_t *ptr = (uint8_t *)svGetArrayPtr(arr);
+
+  if (stride == 1) {
+    memcpy(ptr, data, arr_len);
+  } else if (stride) {
+    memset(ptr, 0, arr_len * stride);
+    for (uint64_t i = 0; i < arr_len; ++i) {
+      ptr[i * stride] = data[i];
+    }
+  } else {
+    for (uint64_t i = 0; i < arr_len; ++i) {
+      svBitVecVal data_val = (svBitVecVal)data[i];
+      svPutBitArrElem1VecVal(arr, &data_val, i);
+    }
+  }
+}
+
+/**
+ * A hash computation in progress. This wraps one of the digestpp hashers so
+ * that the one-shot functions and the streaming (handle-based) interface below
+ * can share code.
+ */
+class DigestCtx {
+ public:
+  virtual ~DigestCtx() {}
+
+  virtual void absorb(const uint8_t *data, size_t len) = 0;
 
-  for (uint64_t i = 0; i < arr_len; ++i) {
-    svBitVecVal data_val = (svBitVecVal)data[i];
-    svPutBitArrElem1VecVal(arr, &data_val, i);
+  // For an XOF, squeeze the next len bytes of output. Otherwise write the
+  // digest of everything absorbed so far, which must be len bytes long.
+  virtual void squeeze(uint8_t *out, size_t len) = 0;
+};
+
+template <typename H>
+class XofCtx : public DigestCtx {
+ public:
+  H hasher;
+
+  void absorb(const uint8_t *data, size_t len) override {
+    hasher.absorb(data, len);
   }
+  void squeeze(uint8_t *out, size_t len) override { hasher.squeeze(out, len); }
+};
+
+template <typename H>
+class FixedCtx : public DigestCtx {
+ public:
+  explicit FixedCtx(size_t output_bits) : hasher(output_bits) {}
+
+  H hasher;
+
+  void absorb(const uint8_t *data, size_t len) override {
+    hasher.absorb(data, len);
+  }
+  void squeeze(uint8_t *out, size_t len) override { hasher.digest(out, len); }
+};
+
+// Hash modes for c_dpi_digestpp_create. These must match digestpp_mode_e in
+// digestpp_dpi_pkg.sv.
+enum DigestMode {
+  kDigestSha3 = 0,
+  kDigestShake = 1,
+  kDigestCShake = 2,
+  kDigestKmac = 3,
+  kDigestKmacXof = 4
+};
+
+/**
+ * Construct a DigestCtx. Returns nullptr (after printing a message) if mode
+ * and strength don't name a supported hash.
+ *
+ * output_len is the digest length in bytes for KMAC (and is ignored for
+ * other modes). function_name is only used for cSHAKE and customization_str
+ * for cSHAKE and KMAC. key points at key_len bytes, which are only used for
+ * KMAC.
+ */
+static DigestCtx *make_digest_ctx(int mode, uint32_t strength,
+                                  uint64_t output_len,
+                                  const char *function_name,
+                                  const char *customization_str,
+                                  const uint8_t *key, uint64_t key_len) {
+  switch (mode) {
+    case kDigestSha3:
+      if (strength == 224 || strength == 256 || strength == 384 ||
+          strength == 512)
+        return new FixedCtx<digestpp::sha3>(strength);
+      break;
+
+    case kDigestShake:
+      if (strength == 128)
+        return new XofCtx<digestpp::shake128>();
+      if (strength == 256)
+        return new XofCtx<digestpp::shake256>();
+      break;
+
+    case kDigestCShake:
+      if (strength == 128) {
+        auto *ctx = new XofCtx<digestpp::cshake128>();
+        ctx->hasher.set_function_name(function_name, strlen(function_name));
+        ctx->hasher.set_customization(customization_str,
+                                      strlen(customization_str));
+        return ctx;
+      }
+      if (strength == 256) {
+        auto *ctx = new XofCtx<digestpp::cshake256>();
+        ctx->hasher.set_function_name(function_name, strlen(function_name));
+        ctx->hasher.set_customization(customization_str,
+                                      strlen(customization_str));
+        return ctx;
+      }
+      break;
+
+    case kDigestKmac:
+      if (strength == 128) {
+        auto *ctx = new FixedCtx<digestpp::kmac128>(output_len * 8);
+        ctx->hasher.set_customization(customization_str,
+                                      strlen(customization_str));
+        ctx->hasher.set_key(key, key_len);
+        return ctx;
+      }
+      if (strength == 256) {
+        auto *ctx = new FixedCtx<digestpp::kmac256>(output_len * 8);
+        ctx->hasher.set_customization(customization_str,
+                                      strlen(customization_str));
+        ctx->hasher.set_key(key, key_len);
+        return ctx;
+      }
+      break;
+
+    case kDigestKmacXof:
+      if (strength == 128) {
+        auto *ctx = new XofCtx<digestpp::kmac128_xof>();
+        ctx->hasher.set_customization(customization_str,
+                                      strlen(customization_str));
+        ctx->hasher.set_key(key, key_len);
+        return ctx;
+      }
+      if (strength == 256) {
+        auto *ctx = new XofCtx<digestpp::kmac256_xof>();
+        ctx->hasher.set_customization(customization_str,
+                                      strlen(customization_str));
+        ctx->hasher.set_key(key, key_len);
+        return ctx;
+      }
+      break;
+
+    default:
+      break;
+  }
+
+  fprintf(stderr, "ERROR: Unsupported digestpp mode %d with strength %u.\n",
+          mode, strength);
+  return nullptr;
+}
+
+/**
+ * Absorb msg_len bytes from an SV array into ctx.
+ */
+static void absorb_from_simulator(DigestCtx &ctx, const svOpenArrayHandle msg,
+                                  uint64_t msg_len) {
+  for_each_arr_chunk(msg, msg_len, [&](const uint8_t *data, uint64_t len) {
+    ctx.absorb(data, len);
+  });
+}
+
+/**
+ * Squeeze output_len bytes from ctx into an SV array.
+ */
+static void squeeze_to_simulator(DigestCtx &ctx, uint64_t output_len,
+                                 svOpenArrayHandle digest) {
+  std::vector<uint8_t> digest_arr(output_len);
+  ctx.squeeze(digest_arr.data(), output_len);
+  write_array_to_simulator(digest, digest_arr.data());
+}
+
+/**
+ * Compute a digest in one go for the fixed-function wrappers below (which
+ * predate the streaming interface). key_len bytes of key are loaded from SV
+ * memory if key_len is nonzero.
+ */
+static void one_shot_digest(int mode, uint32_t strength,
+                            const svOpenArrayHandle msg, uint64_t msg_len,
+                            const svOpenArrayHandle key, uint64_t key_len,
+                            const char *function_name,
+                            const char *customization_str,
+                            uint64_t output_len, svOpenArrayHandle digest) {
+  std::vector<uint8_t> key_arr(key_len);
+  if (key_len)
+    load_arr_from_simulator(key, key_arr.data(), key_len);
+
+  std::unique_ptr<DigestCtx> ctx(
+      make_digest_ctx(mode, strength, output_len, function_name,
+                      customization_str, key_arr.data(), key_len));
+  assert(ctx);
+
+  absorb_from_simulator(*ctx, msg, msg_len);
+  squeeze_to_simulator(*ctx, output_len, digest);
 }
 
 /**
@@ -53,26 +302,44 @@ static void write_array_to_simulator(const svOpenArrayHandle arr,
  */
 static void get_sha3_digest(uint64_t sha_len, const svOpenArrayHandle msg,
                             uint64_t msg_len, svOpenArrayHandle digest) {
-  // Number of bytes in result digest
-  uint64_t digest_len = sha_len / 8;
+  one_shot_digest(kDigestSha3, sha_len, msg, msg_len, nullptr, 0, "", "",
+                  sha_len / 8, digest);
+}
 
-  uint8_t digest_arr[digest_len];
+extern "C" {
 
-  // Load message from SV memory
-  uint8_t *msg_arr = (uint8_t *)malloc(msg_len * sizeof(uint8_t));
-  load_arr_from_simulator(msg, msg_arr, msg_len);
+/////////////////////////
+// STREAMING INTERFACE //
+/////////////////////////
+
+extern void *c_dpi_digestpp_create(int mode, uint32_t strength,
+                                   uint64_t output_len,
+                                   const char *function_name,
+                                   const char *customization_str,
+                                   const svOpenArrayHandle key,
+                                   uint64_t key_len) {
+  std::vector<uint8_t> key_arr(key_len);
+  if (key_len)
+    load_arr_from_simulator(key, key_arr.data(), key_len);
+
+  return make_digest_ctx(mode, strength, output_len, function_name,
+                         customization_str, key_arr.data(), key_len);
+}
 
-  // Compute the digest
-  digestpp::sha3 sha3(sha_len);
-  sha3.absorb(msg_arr, msg_len);
-  sha3.digest(digest_arr, sizeof(digest_arr));
+extern void c_dpi_digestpp_absorb_chunk(void *ctx, const svOpenArrayHandle msg,
+                                        uint64_t msg_len) {
+  assert(ctx);
+  absorb_from_simulator(*static_cast<DigestCtx *>(ctx), msg, msg_len);
+}
 
-  if (msg_arr != nullptr) {
-    free(msg_arr);
-  }
+extern void c_dpi_digestpp_squeeze(void *ctx, uint64_t output_len,
+                                   svOpenArrayHandle digest) {
+  assert(ctx);
+  squeeze_to_simulator(*static_cast<DigestCtx *>(ctx), output_len, digest);
+}
 
-  // Return the digest array so that SV can access it
-  write_array_to_simulator(digest, digest_arr);
+extern void c_dpi_digestpp_free(void *ctx) {
+  delete static_cast<DigestCtx *>(ctx);
 }
 
 //////////////
@@ -112,23 +379,8 @@ extern void c_dpi_sha3_512(const svOpenArrayHandle msg, uint64_t msg_len,
 //////////////
 extern void c_dpi_shake128(const svOpenArrayHandle msg, uint64_t msg_len,
                            uint64_t output_len, svOpenArrayHandle digest) {
-  // Load message from SV memory
-  uint8_t *msg_arr = (uint8_t *)malloc(msg_len * sizeof(uint8_t));
-  load_arr_from_simulator(msg, msg_arr, msg_len);
-
-  uint8_t digest_arr[output_len];
-
-  // Compute the digest
-  digestpp::shake128 shake;
-  shake.absorb(msg_arr, msg_len);
-  shake.squeeze(digest_arr, output_len);
-
-  if (msg_arr != nullptr) {
-    free(msg_arr);
-  }
-
-  // Return the digest array to SV code
-  write_array_to_simulator(digest, digest_arr);
+  one_shot_digest(kDigestShake, 128, msg, msg_len, nullptr, 0, "", "",
+                  output_len, digest);
 }
 
 //////////////
@@ -136,23 +388,8 @@ extern void c_dpi_shake128(const svOpenArrayHandle msg, uint64_t msg_len,
 //////////////
 extern void c_dpi_shake256(const svOpenArrayHandle msg, uint64_t msg_len,
                            uint64_t output_len, svOpenArrayHandle digest) {
-  // Load message from SV memory
-  uint8_t *msg_arr = (uint8_t *)malloc(msg_len * sizeof(uint8_t));
-  load_arr_from_simulator(msg, msg_arr, msg_len);
-
-  uint8_t digest_arr[output_len];
-
-  // Compute the digest
-  digestpp::shake256 shake;
-  shake.absorb(msg_arr, msg_len);
-  shake.squeeze(digest_arr, output_len);
-
-  if (msg_arr != nullptr) {
-    free(msg_arr);
-  }
-
-  // Return the digest array to SV code
-  write_array_to_simulator(digest, digest_arr);
+  one_shot_digest(kDigestShake, 256, msg, msg_len, nullptr, 0, "", "",
+                  output_len, digest);
 }
 
 ///////////////
@@ -162,25 +399,8 @@ extern void c_dpi_cshake128(const svOpenArrayHandle msg,
                             const char *function_name,
                             const char *customization_str, uint64_t msg_len,
                             uint64_t output_len, svOpenArrayHandle digest) {
-  // Load message from SV memory
-  uint8_t *msg_arr = (uint8_t *)malloc(msg_len * sizeof(uint8_t));
-  load_arr_from_simulator(msg, msg_arr, msg_len);
-
-  uint8_t digest_arr[output_len];
-
-  // Compute the digest
-  digestpp::cshake128 shake;
-  shake.set_function_name(function_name, strlen(function_name));
-  shake.set_customization(customization_str, strlen(customization_str));
-  shake.absorb(msg_arr, msg_len);
-  shake.squeeze(digest_arr, output_len);
-
-  if (msg_arr != nullptr) {
-    free(msg_arr);
-  }
-
-  // Return the digest array to SV code
-  write_array_to_simulator(digest, digest_arr);
+  one_shot_digest(kDigestCShake, 128, msg, msg_len, nullptr, 0, function_name,
+                  customization_str, output_len, digest);
 }
 
 ///////////////
@@ -190,25 +410,8 @@ extern void c_dpi_cshake256(const svOpenArrayHandle msg,
                             const char *function_name,
                             const char *customization_str, uint64_t msg_len,
                             uint64_t output_len, svOpenArrayHandle digest) {
-  // Load message from SV memory
-  uint8_t *msg_arr = (uint8_t *)malloc(msg_len * sizeof(uint8_t));
-  load_arr_from_simulator(msg, msg_arr, msg_len);
-
-  uint8_t digest_arr[output_len];
-
-  // Compute the digest
-  digestpp::cshake256 shake;
-  shake.set_function_name(function_name, strlen(function_name));
-  shake.set_customization(customization_str, strlen(customization_str));
-  shake.absorb(msg_arr, msg_len);
-  shake.squeeze(digest_arr, output_len);
-
-  if (msg_arr != nullptr) {
-    free(msg_arr);
-  }
-
-  // Return the digest array to SV code
-  write_array_to_simulator(digest, digest_arr);
+  one_shot_digest(kDigestCShake, 256, msg, msg_len, nullptr, 0, function_name,
+                  customization_str, output_len, digest);
 }
 
 /////////////
@@ -218,35 +421,8 @@ extern void c_dpi_kmac128(const svOpenArrayHandle msg, uint64_t msg_len,
                           const svOpenArrayHandle key, uint64_t key_len,
                           const char *customization_str, uint64_t output_len,
                           svBitVecVal *digest) {
-  uint64_t output_len_bits = output_len * 8;
-
-  // Load message from SV memory
-  uint8_t *msg_arr = (uint8_t *)malloc(msg_len * sizeof(uint8_t));
-  load_arr_from_simulator(msg, msg_arr, msg_len);
-
-  // Load key from SV memory
-  uint8_t *key_arr = (uint8_t *)malloc(key_len * sizeof(uint8_t));
-  load_arr_from_simulator(key, key_arr, key_len);
-
-  uint8_t digest_arr[output_len];
-
-  // Compute the digest
-  digestpp::kmac128 kmac(output_len_bits);
-  kmac.set_customization(customization_str, strlen(customization_str));
-  kmac.set_key(key_arr, key_len);
-  kmac.absorb(msg_arr, msg_len);
-  kmac.digest(digest_arr, sizeof(digest_arr));
-
-  if (msg_arr != nullptr) {
-    free(msg_arr);
-  }
-
-  if (key_arr != nullptr) {
-    free(key_arr);
-  }
-
-  // Return the digest array to SV code
-  write_array_to_simulator(digest, digest_arr);
+  one_shot_digest(kDigestKmac, 128, msg, msg_len, key, key_len, "",
+                  customization_str, output_len, digest);
 }
 
 /////////////////
@@ -256,33 +432,8 @@ extern void c_dpi_kmac128_xof(const svOpenArrayHandle msg, uint64_t msg_len,
                               const svOpenArrayHandle key, uint64_t key_len,
                               const char *customization_str,
                               uint64_t output_len, svBitVecVal *digest) {
-  // Load message from SV memory
-  uint8_t *msg_arr = (uint8_t *)malloc(msg_len * sizeof(uint8_t));
-  load_arr_from_simulator(msg, msg_arr, msg_len);
-
-  // Load key from SV memory
-  uint8_t *key_arr = (uint8_t *)malloc(key_len * sizeof(uint8_t));
-  load_arr_from_simulator(key, key_arr, key_len);
-
-  uint8_t digest_arr[output_len];
-
-  // Compute the digest
-  digestpp::kmac128_xof kmac;
-  kmac.set_customization(customization_str, strlen(customization_str));
-  kmac.set_key(key_arr, key_len);
-  kmac.absorb(msg_arr, msg_len);
-  kmac.squeeze(digest_arr, sizeof(digest_arr));
-
-  if (msg_arr != nullptr) {
-    free(msg_arr);
-  }
-
-  if (key_arr != nullptr) {
-    free(key_arr);
-  }
-
-  // Return the digest array to SV code
-  write_array_to_simulator(digest, digest_arr);
+  one_shot_digest(kDigestKmacXof, 128, msg, msg_len, key, key_len, "",
+                  customization_str, output_len, digest);
 }
 
 /////////////
@@ -292,35 +443,8 @@ extern void c_dpi_kmac256(const svOpenArrayHandle msg, uint64_t msg_len,
                           const svOpenArrayHandle key, uint64_t key_len,
                           const char *customization_str, uint64_t output_len,
                           svBitVecVal *digest) {
-  uint64_t output_len_bits = output_len * 8;
-
-  // Load message from SV memory
-  uint8_t *msg_arr = (uint8_t *)malloc(msg_len * sizeof(uint8_t));
-  load_arr_from_simulator(msg, msg_arr, msg_len);
-
-  // Load key from SV memory
-  uint8_t *key_arr = (uint8_t *)malloc(key_len * sizeof(uint8_t));
-  load_arr_from_simulator(key, key_arr, key_len);
-
-  uint8_t digest_arr[output_len];
-
-  // Compute the digest
-  digestpp::kmac256 kmac(output_len_bits);
-  kmac.set_customization(customization_str, strlen(customization_str));
-  kmac.set_key(key_arr, key_len);
-  kmac.absorb(msg_arr, msg_len);
-  kmac.digest(digest_arr, sizeof(digest_arr));
-
-  if (msg_arr != nullptr) {
-    free(msg_arr);
-  }
-
-  if (key_arr != nullptr) {
-    free(key_arr);
-  }
-
-  // Return the digest array to SV code
-  write_array_to_simulator(digest, digest_arr);
+  one_shot_digest(kDigestKmac, 256, msg, msg_len, key, key_len, "",
+                  customization_str, output_len, digest);
 }
 
 /////////////////
@@ -330,32 +454,7 @@ extern void c_dpi_kmac256_xof(const svOpenArrayHandle msg, uint64_t msg_len,
                               const svOpenArrayHandle key, uint64_t key_len,
                               const char *customization_str,
                               uint64_t output_len, svBitVecVal *digest) {
-  // Load message from SV memory
-  uint8_t *msg_arr = (uint8_t *)malloc(msg_len * sizeof(uint8_t));
-  load_arr_from_simulator(msg, msg_arr, msg_len);
-
-  // Load key from SV memory
-  uint8_t *key_arr = (uint8_t *)malloc(key_len * sizeof(uint8_t));
-  load_arr_from_simulator(key, key_arr, key_len);
-
-  uint8_t digest_arr[output_len];
-
-  // Compute the digest
-  digestpp::kmac256_xof kmac;
-  kmac.set_customization(customization_str, strlen(customization_str));
-  kmac.set_key(key_arr, key_len);
-  kmac.absorb(msg_arr, msg_len);
-  kmac.squeeze(digest_arr, sizeof(digest_arr));
-
-  if (msg_arr != nullptr) {
-    free(msg_arr);
-  }
-
-  if (key_arr != nullptr) {
-    free(key_arr);
-  }
-
-  // Return the digest array to SV code
-  write_array_to_simulator(digest, digest_arr);
+  one_shot_digest(kDigestKmacXof, 256, msg, msg_len, key, key_len, "",
+                  customization_str, output_len, digest);
 }
 }
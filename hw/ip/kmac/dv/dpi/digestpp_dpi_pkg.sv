@@ -10,7 +10,54 @@ package digestpp_dpi_pkg;
 
   // parameters
 
+  // Hash modes for c_dpi_digestpp_create. These must match DigestMode in digestpp_dpi.cc.
+  typedef enum int {
+    DigestppSha3    = 0,
+    DigestppShake   = 1,
+    DigestppCShake  = 2,
+    DigestppKmac    = 3,
+    DigestppKmacXof = 4
+  } digestpp_mode_e;
+
   // DPI-C imports
+
+  // Streaming interface. c_dpi_digestpp_create returns a handle for a new hash computation (or
+  // null if mode and strength don't name a supported hash). Message bytes can then be passed in
+  // any number of calls to c_dpi_digestpp_absorb_chunk before reading the result with
+  // c_dpi_digestpp_squeeze. For the XOF modes, each squeeze returns the next output_len bytes. For
+  // SHA3 and KMAC, it returns the digest, which is output_len bytes long. Release the handle with
+  // c_dpi_digestpp_free.
+  //
+  // strength is the security strength (128 or 256) or, for SHA3, the digest length in bits.
+  // output_len is only used for KMAC, function_name for cSHAKE and customization_str for cSHAKE and
+  // KMAC. The key is only used for KMAC.
+  import "DPI-C" context function chandle c_dpi_digestpp_create(
+    input int               mode,
+    input int unsigned      strength,
+    input longint unsigned  output_len,
+    input string            function_name,
+    input string            customization_str,
+    input bit[7:0]          key[],
+    input longint unsigned  key_len
+  );
+
+  import "DPI-C" context function void c_dpi_digestpp_absorb_chunk(
+    input chandle           ctx,
+    input bit[7:0]          msg[],
+    input longint unsigned  msg_len
+  );
+
+  import "DPI-C" context function void c_dpi_digestpp_squeeze(
+    input chandle           ctx,
+    input longint unsigned  output_len,
+    output bit[7:0]         digest[]
+  );
+
+  import "DPI-C" function void c_dpi_digestpp_free(
+    input chandle           ctx
+  );
+
+  // One-shot interface
   import "DPI-C" context function void c_dpi_sha3_224(
     input bit[7:0]          msg[],
     input longint unsigned  msg_len,
@@ -9,6 +9,7 @@
 #include "Vkmac_reduced_tb.h"
 #include "sim_ctrl_extension.h"
 #include "verilated_toplevel.h"
+#include "verilator_multi_sim.h"
 #include "verilator_sim_ctrl.h"
 
 class KMACReducedTB : public SimCtrlExtension {
@@ -35,9 +36,24 @@ void KMACReducedTB::OnClock(unsigned long sim_time) {
   }
 }
 
+// Construct a model for VerilatorMultiSim
+static VerilatorMultiSim::Model NewModel(VerilatedContext *context) {
+  kmac_reduced_tb *top = new kmac_reduced_tb(context);
+  return {std::unique_ptr<VerilatedToplevel>(top), &top->clk_i, &top->rst_ni,
+          &top->test_done_o, &top->test_passed_o};
+}
+
 int main(int argc, char **argv) {
   int ret_code;
 
+  // Run several instances with different seeds if requested (--instances).
+  VerilatorMultiSim multisim(NewModel,
+                             VerilatorSimCtrlFlags::ResetPolarityNegative);
+  std::pair<int, bool> multisim_ret = multisim.Exec(argc, argv);
+  if (multisim_ret.second) {
+    return multisim_ret.first;
+  }
+
   // Init verilog instance
   kmac_reduced_tb top;
 
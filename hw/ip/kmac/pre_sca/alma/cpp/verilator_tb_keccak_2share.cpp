@@ -8,23 +8,20 @@
 #include "Vcircuit.h"
 #include "testbench.h"
 
-int main(int argc, char **argv) {
-  Verilated::commandArgs(argc, argv);
-  Testbench<Vcircuit> tb;
-  tb.opentrace("tmp.vcd");
-
+static void stimulus(Testbench<Vcircuit> &tb, std::mt19937_64 *rng) {
   tb.reset();
 
   // Data signals - we don't really care about the data fed to the module.
-  // The whole tracing is really just about control signals.
-  tb.m_core.rand_i = 0x0123456789ABCDEF;
+  // The whole tracing is really just about control signals. Random data is
+  // only used for the batches traced for simulation-based analyses.
+  tb.m_core.rand_i = rng ? (*rng)() : 0x0123456789ABCDEF;
   tb.m_core.rand_aux_i = 0x0;
   // With WIDTH = 50, we should drive 100 = 3 * 32 + 4 bits. Driving more bits
   // sometimes leads to encoding issues in the VCD.
-  tb.m_core.s_i[0] = 0x01234567;
-  tb.m_core.s_i[1] = 0x89ABCDEF;
-  tb.m_core.s_i[2] = 0x01234567;
-  tb.m_core.s_i[3] = 0xF;
+  tb.m_core.s_i[0] = rng ? (uint32_t)(*rng)() : 0x01234567;
+  tb.m_core.s_i[1] = rng ? (uint32_t)(*rng)() : 0x89ABCDEF;
+  tb.m_core.s_i[2] = rng ? (uint32_t)(*rng)() : 0x01234567;
+  tb.m_core.s_i[3] = rng ? (*rng)() & 0xF : 0xF;
 
   // Control signals
   tb.m_core.rnd_i = 0;  // Round, just defines which round constant is added
@@ -58,6 +55,9 @@ int main(int argc, char **argv) {
   tb.m_core.phase_sel_i = 0xA;
   tb.m_core.cycle_i = 0x3;
   tb.tick();
+}
 
-  tb.closetrace();
+int main(int argc, char **argv) {
+  Verilated::commandArgs(argc, argv);
+  return run_testbench<Vcircuit>(stimulus);
 }
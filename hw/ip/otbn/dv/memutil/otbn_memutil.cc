@@ -4,6 +4,7 @@
 
 #include "otbn_memutil.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include <gelf.h>
@@ -35,9 +36,39 @@ const StagedMem::SegMap &OtbnMemUtil::GetSegs(bool is_imem) const {
 }
 
 uint32_t OtbnMemUtil::GetLoopWarp(uint32_t addr, uint32_t from_cnt) const {
-  auto key = std::make_pair(addr, from_cnt);
-  auto it = loop_warp_.find(key);
-  return (it == loop_warp_.end()) ? from_cnt : it->second;
+  if (loop_warp_index_.empty())
+    return from_cnt;
+
+  auto it = loop_warp_index_.find(((uint64_t)addr << 32) | from_cnt);
+  return (it == loop_warp_index_.end()) ? from_cnt : it->second;
+}
+
+bool OtbnMemUtil::GetSymbolValue(const std::string &name,
+                                 uint32_t *value) const {
+  assert(value);
+  auto it = symbols_by_name_.find(name);
+  if (it == symbols_by_name_.end())
+    return false;
+
+  *value = it->second.first;
+  return true;
+}
+
+bool OtbnMemUtil::GetSymbolAtOrBelow(uint32_t addr, std::string *name,
+                                     uint32_t *value) const {
+  assert(name && value);
+  auto it = std::upper_bound(
+      symbols_by_value_.begin(), symbols_by_value_.end(), addr,
+      [](uint32_t a, const std::pair<uint32_t, std::string> &sym) {
+        return a < sym.first;
+      });
+  if (it == symbols_by_value_.begin())
+    return false;
+
+  --it;
+  *value = it->first;
+  *name = it->second;
+  return true;
 }
 
 void OtbnMemUtil::OnElfLoaded(Elf *elf_file) {
@@ -45,9 +76,14 @@ void OtbnMemUtil::OnElfLoaded(Elf *elf_file) {
 
   expected_end_addr_ = -1;
   loop_warp_.clear();
+  loop_warp_index_.clear();
+  imem_symbols_.clear();
+  imem_symbol_is_global_.clear();
+  symbols_by_name_.clear();
+  symbols_by_value_.clear();
 
   // Look through the symbol table of elf_file for an expected end
-  // address and any loop warping symbols.
+  // address, any loop warping symbols and the code symbols.
   Elf_Scn *scn = nullptr;
   while ((scn = elf_nextscn(elf_file, scn))) {
     Elf32_Shdr *shdr = elf32_getshdr(scn);
@@ -67,13 +103,44 @@ void OtbnMemUtil::OnElfLoaded(Elf *elf_file) {
       if (!sym_name)
         continue;
 
-      OnSymbol(sym_name, sym.st_value);
+      bool is_global = GELF_ST_BIND(sym.st_info) == STB_GLOBAL;
+      OnSymbol(sym_name, sym.st_value, is_global);
+
+      int sym_type = GELF_ST_TYPE(sym.st_info);
+      if ((sym_type != STT_FUNC && sym_type != STT_NOTYPE) ||
+          sym.st_shndx == SHN_UNDEF || sym.st_shndx >= SHN_LORESERVE)
+        continue;
+
+      Elf_Scn *sym_scn = elf_getscn(elf_file, sym.st_shndx);
+      Elf32_Shdr *sym_shdr = sym_scn ? elf32_getshdr(sym_scn) : nullptr;
+      if (!sym_shdr || !(sym_shdr->sh_flags & SHF_EXECINSTR))
+        continue;
+
+      OnCodeSymbol(sym_name, sym.st_value, is_global);
     }
     break;
   }
+
+  // Build the sorted view of the symbols used by GetSymbolAtOrBelow
+  symbols_by_value_.reserve(symbols_by_name_.size());
+  for (const auto &pr : symbols_by_name_) {
+    symbols_by_value_.emplace_back(pr.second.first, pr.first);
+  }
+  std::sort(symbols_by_value_.begin(), symbols_by_value_.end());
 }
 
-void OtbnMemUtil::OnSymbol(const std::string &name, uint32_t value) {
+void OtbnMemUtil::OnSymbol(const std::string &name, uint32_t value,
+                           bool is_global) {
+  if (name.empty())
+    return;
+
+  // Index the symbol by name. If a name is used more than once, keep the first
+  // global symbol or, failing that, the first local one.
+  auto ins = symbols_by_name_.emplace(name, std::make_pair(value, is_global));
+  if (!ins.second && is_global && !ins.first->second.second) {
+    ins.first->second = std::make_pair(value, is_global);
+  }
+
   // Expected end address
   if (name == "_expected_end_addr") {
     expected_end_addr_ = value;
@@ -82,8 +149,12 @@ void OtbnMemUtil::OnSymbol(const std::string &name, uint32_t value) {
   // Loop warping. These symbols are of the form "_loop_warp_FROM_TO_*" where
   // FROM and TO are decimal loop counts and the value of the symbol is the
   // address where it should apply. Trailing junk is allowed (to ensure
-  // uniqueness).
-  std::regex lw_re("_loop_warp_([0-9]+)_([0-9]+).*");
+  // uniqueness). Most symbols aren't loop warps, so check the prefix before
+  // running the regex (which is only compiled once).
+  if (name.compare(0, 11, "_loop_warp_") != 0)
+    return;
+
+  static const std::regex lw_re("_loop_warp_([0-9]+)_([0-9]+).*");
   std::smatch lw_match;
   if (std::regex_match(name, lw_match, lw_re)) {
     assert(lw_match.size() == 3);
@@ -111,6 +182,21 @@ void OtbnMemUtil::OnSymbol(const std::string &name, uint32_t value) {
   }
 }
 
+void OtbnMemUtil::OnCodeSymbol(const std::string &name, uint32_t value,
+                               bool is_global) {
+  if (name.empty() || name.compare(0, 2, ".L") == 0 ||
+      name.compare(0, 11, "_loop_warp_") == 0)
+    return;
+
+  auto it = imem_symbols_.find(value);
+  if (it != imem_symbols_.end() &&
+      (imem_symbol_is_global_[value] || !is_global))
+    return;
+
+  imem_symbols_[value] = name;
+  imem_symbol_is_global_[value] = is_global;
+}
+
 void OtbnMemUtil::AddLoopWarp(uint32_t addr, uint32_t from_cnt,
                               uint32_t to_cnt) {
   auto key = std::make_pair(addr, from_cnt);
@@ -125,6 +211,7 @@ void OtbnMemUtil::AddLoopWarp(uint32_t addr, uint32_t from_cnt,
         << " and initial count " << std::dec << from_cnt << ".";
     throw std::runtime_error(oss.str());
   }
+  loop_warp_index_[((uint64_t)addr << 32) | from_cnt] = to_cnt;
 }
 
 extern "C" OtbnMemUtil *OtbnMemUtilMake(const char *top_scope) {
@@ -320,3 +407,58 @@ void OtbnMemUtilGetLoopWarpByIndex(
   set_sv_u32(from_cnt, from32);
   set_sv_u32(to_cnt, to32);
 }
+
+int OtbnMemUtilGetLoopWarps(OtbnMemUtil *mem_util,
+                            /* output bit [31:0] */ svOpenArrayHandle addrs,
+                            /* output bit [31:0] */ svOpenArrayHandle from_cnts,
+                            /* output bit [31:0] */ svOpenArrayHandle to_cnts) {
+  assert(mem_util);
+
+  int count = std::min({svSize(addrs, 1), svSize(from_cnts, 1),
+                        svSize(to_cnts, 1)});
+  auto it = mem_util->GetLoopWarps().begin();
+  int idx = 0;
+  for (; idx < count && it != mem_util->GetLoopWarps().end(); ++idx, ++it) {
+    set_sv_u32(static_cast<svBitVecVal *>(
+                   svGetArrElemPtr1(addrs, svLow(addrs, 1) + idx)),
+               it->first.first);
+    set_sv_u32(static_cast<svBitVecVal *>(
+                   svGetArrElemPtr1(from_cnts, svLow(from_cnts, 1) + idx)),
+               it->first.second);
+    set_sv_u32(static_cast<svBitVecVal *>(
+                   svGetArrElemPtr1(to_cnts, svLow(to_cnts, 1) + idx)),
+               it->second);
+  }
+  return idx;
+}
+
+int OtbnMemUtilGetSymbolValues(OtbnMemUtil *mem_util,
+                               /* string */ const svOpenArrayHandle names,
+                               /* output bit [31:0] */ svOpenArrayHandle values,
+                               /* output bit */ svOpenArrayHandle found) {
+  assert(mem_util);
+
+  int count = svSize(names, 1);
+  assert(svSize(values, 1) == count && svSize(found, 1) == count);
+
+  int num_found = 0;
+  for (int i = 0; i < count; ++i) {
+    const char *name = *static_cast<const char **>(
+        svGetArrElemPtr1(names, svLow(names, 1) + i));
+    svBit *found_i =
+        static_cast<svBit *>(svGetArrElemPtr1(found, svLow(found, 1) + i));
+
+    uint32_t value;
+    if (!name || !mem_util->GetSymbolValue(name, &value)) {
+      *found_i = sv_0;
+      continue;
+    }
+
+    set_sv_u32(static_cast<svBitVecVal *>(
+                   svGetArrElemPtr1(values, svLow(values, 1) + i)),
+               value);
+    *found_i = sv_1;
+    ++num_found;
+  }
+  return num_found;
+}
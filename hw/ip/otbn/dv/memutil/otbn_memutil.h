@@ -5,7 +5,10 @@
 #define OPENTITAN_HW_IP_OTBN_DV_MEMUTIL_OTBN_MEMUTIL_H_
 
 #include <map>
+#include <string>
 #include <svdpi.h>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "dpi_memutil.h"
@@ -14,6 +17,7 @@
 class OtbnMemUtil : public DpiMemUtil {
  public:
   typedef std::map<std::pair<uint32_t, uint32_t>, uint32_t> LoopWarps;
+  typedef std::map<uint32_t, std::string> Symbols;
 
   // Constructor. top_scope is the SV scope that contains IMEM and
   // DMEM memories as u_imem and u_dmem, respectively.
@@ -43,11 +47,31 @@ class OtbnMemUtil : public DpiMemUtil {
   // Read-only access to the table of loop warps
   const LoopWarps &GetLoopWarps() const { return loop_warp_; }
 
+  // Look up the value of the symbol called name in the ELF file. If there are
+  // several symbols with that name, a global one is preferred. Returns false
+  // (leaving value untouched) if there is no such symbol.
+  bool GetSymbolValue(const std::string &name, uint32_t *value) const;
+
+  // Find the symbol with the largest value that is at most addr. Writes its
+  // name and value and returns true, or returns false if there is no such
+  // symbol.
+  bool GetSymbolAtOrBelow(uint32_t addr, std::string *name,
+                          uint32_t *value) const;
+
+  // Code symbols from the ELF file, keyed by IMEM address. These are the
+  // function and label symbols in executable sections, without assembler
+  // local labels or loop warp markers. If there are several symbols at an
+  // address, a global one is preferred.
+  const Symbols &GetImemSymbols() const { return imem_symbols_; }
+
  private:
   void OnElfLoaded(Elf *elf_file) override;
 
   // Called by OnElfLoaded for each symbol in the symbol table
-  void OnSymbol(const std::string &name, uint32_t value);
+  void OnSymbol(const std::string &name, uint32_t value, bool is_global);
+
+  // Called by OnElfLoaded for each symbol in an executable section
+  void OnCodeSymbol(const std::string &name, uint32_t value, bool is_global);
 
   // Add an entry to loop_warp_
   void AddLoopWarp(uint32_t addr, uint32_t from_cnt, uint32_t to_cnt);
@@ -55,6 +79,18 @@ class OtbnMemUtil : public DpiMemUtil {
   ScrambledEcc32MemArea imem_, dmem_;
   int expected_end_addr_;
   LoopWarps loop_warp_;
+  Symbols imem_symbols_;
+  std::map<uint32_t, bool> imem_symbol_is_global_;
+
+  // The same loop warps as loop_warp_, keyed by (addr << 32) | from_cnt.
+  // GetLoopWarp is called for every cycle spent in a loop, so this avoids a
+  // tree walk each time.
+  std::unordered_map<uint64_t, uint32_t> loop_warp_index_;
+
+  // All named symbols, by name (with a flag that is true for global symbols)
+  // and sorted by value.
+  std::unordered_map<std::string, std::pair<uint32_t, bool>> symbols_by_name_;
+  std::vector<std::pair<uint32_t, std::string>> symbols_by_value_;
 };
 
 // DPI-accessible wrappers
@@ -125,6 +161,26 @@ void OtbnMemUtilGetLoopWarpByIndex(
     /* output bit [31:0] */ svBitVecVal *addr,
     /* output bit [31:0] */ svBitVecVal *from_cnt,
     /* output bit [31:0] */ svBitVecVal *to_cnt);
+
+// Get all the loop warps in one call. addrs, from_cnts and to_cnts are open
+// arrays of bit [31:0], which should have OtbnMemUtilGetNumLoopWarps entries.
+// If they are shorter, only that many loop warps are written. Returns the
+// number of loop warps written.
+int OtbnMemUtilGetLoopWarps(OtbnMemUtil *mem_util,
+                            /* output bit [31:0] */ svOpenArrayHandle addrs,
+                            /* output bit [31:0] */ svOpenArrayHandle from_cnts,
+                            /* output bit [31:0] */ svOpenArrayHandle to_cnts);
+
+// Look up the values of several symbols in the ELF file in one call. names is
+// an open array of strings and values (an open array of bit [31:0]) and found
+// (an open array of bit) should have the same number of entries. For each
+// name, the symbol's value is written to the matching entry of values and the
+// entry of found is set to 1'b1, or to 1'b0 (leaving the value untouched) if
+// there is no such symbol. Returns the number of symbols that were found.
+int OtbnMemUtilGetSymbolValues(OtbnMemUtil *mem_util,
+                               /* string */ const svOpenArrayHandle names,
+                               /* output bit [31:0] */ svOpenArrayHandle values,
+                               /* output bit */ svOpenArrayHandle found);
 }
 
 #endif  // OPENTITAN_HW_IP_OTBN_DV_MEMUTIL_OTBN_MEMUTIL_H_
@@ -38,5 +38,15 @@ package otbn_memutil_pkg;
                                                              output bit [31:0] addr,
                                                              output bit [31:0] from_cnt,
                                                              output bit [31:0] to_cnt);
+
+  import "DPI-C" function int OtbnMemUtilGetLoopWarps(chandle           mem_util,
+                                                      output bit [31:0] addrs[],
+                                                      output bit [31:0] from_cnts[],
+                                                      output bit [31:0] to_cnts[]);
+
+  import "DPI-C" function int OtbnMemUtilGetSymbolValues(chandle           mem_util,
+                                                         string            names[],
+                                                         output bit [31:0] values[],
+                                                         output bit        found[]);
 endpackage
 `endif // SYNTHESIS
@@ -5,6 +5,7 @@
 #include "iss_wrapper.h"
 
 #include <cassert>
+#include <cctype>
 #include <cstring>
 #include <fcntl.h>
 #include <ftw.h>
@@ -14,9 +15,9 @@
 #include <libproc.h>
 #endif
 #include <memory>
-#include <regex>
 #include <signal.h>
 #include <sstream>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/wait.h>
 
@@ -202,71 +203,104 @@ static std::string find_otbn_model() {
   return std::string(abs_path.get());
 }
 
-// Read 8 hex characters from str as a uint32_t.
+// Read the 8 lower-case hex characters at str as a uint32_t. The characters
+// must already have been checked (see match_hex_tail()).
 static uint32_t read_hex_32(const char *str) {
-  char buf[9];
-  memcpy(buf, str, 8);
-  buf[8] = '\0';
-  return strtoul(buf, nullptr, 16);
+  uint32_t value = 0;
+  for (int i = 0; i < 8; ++i) {
+    char c = str[i];
+    value = (value << 4) | (uint32_t)(c <= '9' ? c - '0' : c - 'a' + 10);
+  }
+  return value;
 }
 
-// Read through trace output (in the lines argument) to pick up any write to
-// the named CSR register, updating *dest.
-static void read_ext_reg(const std::string &reg_name,
-                         const std::vector<std::string> &lines,
-                         uint32_t *dest) {
-  assert(dest);
+// Return the position of the first non-whitespace character in line at or
+// after pos.
+static size_t skip_space(const std::string &line, size_t pos) {
+  while (pos < line.size() && isspace((unsigned char)line[pos]))
+    ++pos;
+  return pos;
+}
 
-  // We're interested in lines that show an update to the external register
-  // called reg_name. These look something like this:
-  //
-  //   ! otbn.$REG_NAME: 0x00000000
-  std::regex re("! otbn\\." + reg_name + ": 0x([0-9a-f]{8})");
-  std::smatch match;
-
-  for (const auto &line : lines) {
-    if (std::regex_match(line, match, re)) {
-      // Ahah! We have a match. We have captured exactly 8 hex digits, so know
-      // that we can safely parse them to a uint32_t without risking a parse
-      // failure or overflow.
-      assert(match.size() == 2);
-      *dest = (uint32_t)strtoul(match[1].str().c_str(), nullptr, 16);
-    }
+// Check that line continues at pos with "0x" followed by one or more
+// lower-case hex digits, up to the end of the line. On success, return true
+// and set *digits_pos to the position of the first digit.
+static bool match_hex_tail(const std::string &line, size_t pos,
+                           size_t *digits_pos) {
+  if (line.compare(pos, 2, "0x") != 0)
+    return false;
+  pos += 2;
+  if (pos == line.size())
+    return false;
+
+  *digits_pos = pos;
+  for (; pos < line.size(); ++pos) {
+    char c = line[pos];
+    if (!(('0' <= c && c <= '9') || ('a' <= c && c <= 'f')))
+      return false;
   }
+  return true;
 }
 
-// A specialized version of read_ext_reg that updates a boolean flag
-// (assuming that the ISS will always signal the register as having
-// value 0 or 1). Prints a message to stderr and returns false on
-// error.
-static bool read_ext_flag(const std::string &reg_name,
-                          const std::vector<std::string> &lines, bool *dest) {
-  assert(dest);
+// Parse a line of print_regs output, which looks like
+//
+//  x3  = 0x12345678
+//
+// On success, return true and fill in the register name (as the position and
+// length of e.g. "x3" in line) and the position of the first hex digit of the
+// value (which runs to the end of the line). This doesn't allocate.
+static bool parse_reg_line(const std::string &line, size_t *name_pos,
+                           size_t *name_len, size_t *value_pos) {
+  size_t pos = skip_space(line, 0);
+  if (pos == line.size() || (line[pos] != 'w' && line[pos] != 'x'))
+    return false;
+  *name_pos = pos++;
+
+  size_t num_digits = 0;
+  while (pos < line.size() && isdigit((unsigned char)line[pos])) {
+    ++pos;
+    ++num_digits;
+  }
+  if (num_digits < 1 || num_digits > 2)
+    return false;
+  *name_len = pos - *name_pos;
+
+  pos = skip_space(line, pos);
+  if (pos == line.size() || line[pos] != '=')
+    return false;
+  pos = skip_space(line, pos + 1);
 
-  uint32_t dest32 = *dest ? 1 : 0;
-  read_ext_reg(reg_name, lines, &dest32);
+  return match_hex_tail(line, pos, value_pos);
+}
+
+// Read a little-endian uint32_t from buf
+static uint32_t read_le_32(const uint8_t *buf) {
+  return (uint32_t)buf[0] | ((uint32_t)buf[1] << 8) |
+         ((uint32_t)buf[2] << 16) | ((uint32_t)buf[3] << 24);
+}
+
+// Check that an external register that the ISS signals as a boolean flag has
+// value 0 or 1 and update *dest. Prints a message to stderr and returns false
+// on error.
+static bool read_ext_flag(const char *reg_name, uint32_t value, bool *dest) {
+  assert(dest);
 
-  if (dest32 > 1) {
+  if (value > 1) {
     std::cerr << "ERROR: Unexpected update to " << reg_name << " with value 0x"
-              << std::hex << dest32 << std::dec
+              << std::hex << value << std::dec
               << " when we expected a boolean flag.";
     return false;
   }
 
-  *dest = dest32 != 0;
+  *dest = value != 0;
   return true;
 }
 
-void MirroredRegs::reset() {
-  status = 0x04;
-  insn_cnt = 0;
-  err_bits = 0;
-  stop_pc = 0;
-  rnd_req = false;
-  wipe_start = false;
-}
-
-ISSWrapper::ISSWrapper() : tmpdir(new TmpDir()) {
+ISSWrapper::ISSWrapper()
+    : tmpdir(new TmpDir()),
+      shared_fd(-1),
+      shared_buf(nullptr),
+      shared_size(0) {
   std::string model_path(find_otbn_model());
 
   // We want two pipes: one for writing to the child process, and the other for
@@ -349,6 +383,65 @@ ISSWrapper::~ISSWrapper() {
   // Close the child file handles.
   fclose(child_write_file);
   fclose(child_read_file);
+
+  // Drop the shared buffer (its file is deleted along with tmpdir)
+  if (shared_buf)
+    munmap(shared_buf, shared_size);
+  if (shared_fd >= 0)
+    close(shared_fd);
+}
+
+ISSWrapperPool &ISSWrapperPool::get() {
+  static ISSWrapperPool pool;
+  return pool;
+}
+
+void ISSWrapperPool::set_size(size_t size) {
+  size_ = size;
+  if (idle_.size() > size_)
+    idle_.resize(size_);
+  fill();
+}
+
+std::unique_ptr<ISSWrapper> ISSWrapperPool::acquire() {
+  std::unique_ptr<ISSWrapper> ret;
+  if (idle_.empty()) {
+    ret.reset(new ISSWrapper());
+  } else {
+    ret = std::move(idle_.back());
+    idle_.pop_back();
+  }
+
+  // Start a replacement now. Its child process will get through Python's
+  // startup while we carry on with the simulation.
+  fill();
+  return ret;
+}
+
+void ISSWrapperPool::release(std::unique_ptr<ISSWrapper> iss) {
+  if (!iss || idle_.size() >= size_)
+    return;
+
+  try {
+    iss->reset(false);
+  } catch (const std::runtime_error &err) {
+    std::cerr << "Dropping ISS process that failed to reset: " << err.what()
+              << "\n";
+    return;
+  }
+  idle_.push_back(std::move(iss));
+}
+
+void ISSWrapperPool::fill() {
+  while (idle_.size() < size_) {
+    try {
+      idle_.emplace_back(new ISSWrapper());
+    } catch (const std::runtime_error &err) {
+      std::cerr << "Failed to start ISS process for pool: " << err.what()
+                << "\n";
+      return;
+    }
+  }
 }
 
 void ISSWrapper::load_d(const std::string &path) {
@@ -381,6 +474,101 @@ void ISSWrapper::dump_d(const std::string &path) const {
   run_command(oss.str(), nullptr);
 }
 
+uint8_t *ISSWrapper::get_shared_buf(size_t num_bytes) {
+  if (num_bytes <= shared_size)
+    return shared_buf;
+
+  std::string path(make_tmp_path("shared_mem"));
+  if (shared_fd < 0) {
+    shared_fd = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (shared_fd < 0) {
+      std::ostringstream oss;
+      oss << "Cannot create shared memory file at '" << path
+          << "': " << strerror(errno);
+      throw std::runtime_error(oss.str());
+    }
+  }
+
+  if (shared_buf) {
+    munmap(shared_buf, shared_size);
+    shared_buf = nullptr;
+    shared_size = 0;
+  }
+
+  if (ftruncate(shared_fd, num_bytes) != 0) {
+    std::ostringstream oss;
+    oss << "Cannot resize shared memory file to " << num_bytes
+        << " bytes: " << strerror(errno);
+    throw std::runtime_error(oss.str());
+  }
+
+  void *buf = mmap(nullptr, num_bytes, PROT_READ | PROT_WRITE, MAP_SHARED,
+                   shared_fd, 0);
+  if (buf == MAP_FAILED) {
+    std::ostringstream oss;
+    oss << "Cannot map shared memory file: " << strerror(errno);
+    throw std::runtime_error(oss.str());
+  }
+  shared_buf = static_cast<uint8_t *>(buf);
+  shared_size = num_bytes;
+
+  // Tell the ISS to map the (resized) file too
+  std::ostringstream oss;
+  oss << "map_mem " << path << " " << num_bytes << "\n";
+  run_command(oss.str(), nullptr);
+
+  return shared_buf;
+}
+
+void ISSWrapper::load_d_shared(size_t num_bytes) {
+  assert(num_bytes <= shared_size);
+  std::ostringstream oss;
+  oss << "load_d_mapped " << num_bytes << "\n";
+  run_command(oss.str(), nullptr);
+}
+
+void ISSWrapper::load_i_shared(size_t num_bytes) {
+  assert(num_bytes <= shared_size);
+  std::ostringstream oss;
+  oss << "load_i_mapped " << num_bytes << "\n";
+  run_command(oss.str(), nullptr);
+}
+
+void ISSWrapper::dump_d_shared() const {
+  assert(shared_buf);
+  run_command("dump_d_mapped\n", nullptr);
+}
+
+std::vector<std::pair<uint32_t, uint32_t>> ISSWrapper::dump_d_dirty_shared()
+    const {
+  assert(shared_buf);
+
+  std::vector<std::string> lines;
+  run_command("dump_d_dirty_mapped\n", &lines);
+
+  // Lines look like
+  //
+  //  DIRTY 12 3
+  //
+  // giving the first word index and the length of each run of dirty words.
+  std::vector<std::pair<uint32_t, uint32_t>> ret;
+  for (const std::string &line : lines) {
+    if (line == "DUMP_D_DIRTY_MAPPED")
+      continue;
+
+    unsigned start, count;
+    if (sscanf(line.c_str(), "DIRTY %u %u", &start, &count) != 2 ||
+        (size_t)start + count > shared_size / 5) {
+      std::ostringstream oss;
+      oss << "Invalid line in ISS dump_d_dirty_mapped output (`" << line
+          << "').";
+      throw std::runtime_error(oss.str());
+    }
+    ret.push_back(std::make_pair(start, count));
+  }
+  return ret;
+}
+
 void ISSWrapper::start_operation(command_t command) {
   std::ostringstream cmd_stream;
 
@@ -432,6 +620,31 @@ void ISSWrapper::edn_urnd_step(uint32_t edn_urnd_data) {
   run_command(oss.str(), nullptr);
 }
 
+// Write a 256b value as a single hex number (most significant word first)
+static void write_u256(std::ostream &os, const OtbnIss::u256_t &value) {
+  os << "0x" << std::hex << std::setfill('0');
+  for (int i = 0; i < 8; ++i) {
+    os << std::setw(8) << value.words[7 - i];
+  }
+}
+
+void ISSWrapper::edn_rnd_step256(const u256_t &edn_rnd_data,
+                                 uint8_t fips_errs) {
+  std::ostringstream oss;
+  oss << "edn_rnd_step256 ";
+  write_u256(oss, edn_rnd_data);
+  oss << " 0x" << std::setw(2) << (int)fips_errs << "\n";
+  run_command(oss.str(), nullptr);
+}
+
+void ISSWrapper::edn_urnd_step256(const u256_t &edn_urnd_data) {
+  std::ostringstream oss;
+  oss << "edn_urnd_step256 ";
+  write_u256(oss, edn_urnd_data);
+  oss << "\n";
+  run_command(oss.str(), nullptr);
+}
+
 void ISSWrapper::set_keymgr_value(const std::array<uint32_t, 12> &key0_arr,
                                   const std::array<uint32_t, 12> &key1_arr,
                                   bool valid) {
@@ -452,32 +665,65 @@ void ISSWrapper::set_keymgr_value(const std::array<uint32_t, 12> &key0_arr,
 
 int ISSWrapper::step(bool gen_trace) {
   std::vector<std::string> lines;
+  Response resp;
+
+  run_command("step\n", &lines, &resp);
+  if (gen_trace && lines.size()) {
+    if (!OtbnTraceChecker::get().OnIssTrace(lines)) {
+      return -1;
+    }
+  }
+
+  return update_mirrored(resp);
+}
+
+int ISSWrapper::run(uint32_t max_cycles, bool gen_trace,
+                    uint32_t *cycles_run) {
+  std::vector<std::string> lines;
+  Response resp;
+
+  std::ostringstream oss;
+  oss << "run " << max_cycles << "\n";
+  run_command(oss.str(), &lines, &resp);
+
+  if (cycles_run)
+    *cycles_run = resp.cycles;
 
-  run_command("step\n", &lines);
   if (gen_trace && lines.size()) {
     if (!OtbnTraceChecker::get().OnIssTrace(lines)) {
       return -1;
     }
   }
 
-  // Try to read STATUS, which is written when execution ends. Execution has
-  // finished if status_ is either 0 (IDLE) or 0xff (LOCKED)
+  return update_mirrored(resp);
+}
+
+int ISSWrapper::update_mirrored(const Response &resp) {
+  // STATUS is written when execution ends. Execution has finished if status_
+  // is either 0 (IDLE) or 0xff (LOCKED)
   bool was_stopped = mirrored_.stopped();
-  read_ext_reg("STATUS", lines, &mirrored_.status);
+  if (resp.written(ExtStatus))
+    mirrored_.status = resp.ext_values[ExtStatus];
   bool is_stopped = mirrored_.stopped();
   bool done = is_stopped && !was_stopped;
 
-  // Also try to read INSN_CNT, ERR_BITS and STOP_PC plus some associated
-  // flags. Some of these flags only get updated around the end of an operation
-  // but the precise timing is slightly fiddly, so it's easiest to just allow
+  // Also pick up INSN_CNT, ERR_BITS and STOP_PC plus some associated flags.
+  // Some of these flags only get updated around the end of an operation but
+  // the precise timing is slightly fiddly, so it's easiest to just allow
   // updates whenever they arrive.
-  read_ext_reg("INSN_CNT", lines, &mirrored_.insn_cnt);
-  read_ext_reg("ERR_BITS", lines, &mirrored_.err_bits);
-  read_ext_reg("STOP_PC", lines, &mirrored_.stop_pc);
-
-  if (!read_ext_flag("RND_REQ", lines, &mirrored_.rnd_req))
+  if (resp.written(ExtInsnCnt))
+    mirrored_.insn_cnt = resp.ext_values[ExtInsnCnt];
+  if (resp.written(ExtErrBits))
+    mirrored_.err_bits = resp.ext_values[ExtErrBits];
+  if (resp.written(ExtStopPc))
+    mirrored_.stop_pc = resp.ext_values[ExtStopPc];
+
+  if (resp.written(ExtRndReq) &&
+      !read_ext_flag("RND_REQ", resp.ext_values[ExtRndReq], &mirrored_.rnd_req))
     return -1;
-  if (!read_ext_flag("WIPE_START", lines, &mirrored_.wipe_start))
+  if (resp.written(ExtWipeStart) &&
+      !read_ext_flag("WIPE_START", resp.ext_values[ExtWipeStart],
+                     &mirrored_.wipe_start))
     return -1;
 
   return done ? 1 : 0;
@@ -505,7 +751,7 @@ void ISSWrapper::initial_secure_wipe() {
 
 uint32_t ISSWrapper::step_crc(const std::array<uint8_t, 6> &item,
                               uint32_t state) const {
-  std::vector<std::string> lines;
+  Response resp;
 
   std::ostringstream oss;
   oss << std::hex << "step_crc 0x" << std::setfill('0');
@@ -513,9 +759,34 @@ uint32_t ISSWrapper::step_crc(const std::array<uint8_t, 6> &item,
     oss << std::setw(2) << (int)item[5 - i];
   }
   oss << " 0x" << std::setw(8) << state << "\n";
-  run_command(oss.str(), &lines);
+  run_command(oss.str(), nullptr, &resp);
 
-  read_ext_reg("LOAD_CHECKSUM", lines, &state);
+  if (resp.written(ExtLoadChecksum))
+    state = resp.ext_values[ExtLoadChecksum];
+  return state;
+}
+
+uint32_t ISSWrapper::step_crc_block(
+    const std::vector<std::array<uint8_t, 6>> &items, uint32_t state) const {
+  if (items.empty())
+    return state;
+
+  Response resp;
+
+  std::ostringstream oss;
+  oss << std::hex << std::setfill('0') << "step_crc_block 0x" << std::setw(8)
+      << state;
+  for (const auto &item : items) {
+    oss << " 0x";
+    for (size_t i = 0; i < item.size(); ++i) {
+      oss << std::setw(2) << (int)item[5 - i];
+    }
+  }
+  oss << "\n";
+  run_command(oss.str(), nullptr, &resp);
+
+  if (resp.written(ExtLoadChecksum))
+    state = resp.ext_values[ExtLoadChecksum];
   return state;
 }
 
@@ -557,57 +828,56 @@ void ISSWrapper::get_regs(std::array<uint32_t, 32> *gprs,
   //
   //  x3  = 0x12345678
   //  w10 = 0x0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef
-
-  std::regex re("\\s*([wx][0-9]{1,2})\\s*=\\s*0x([0-9a-f]+)");
-  std::smatch match;
-
+  //
+  // This is called at the end of every operation, so the lines are parsed in
+  // place (without std::regex or any temporary strings).
   for (const std::string &line : lines) {
     if (line == "PRINT_REGS")
       continue;
 
-    if (!std::regex_match(line, match, re)) {
+    size_t name_pos, name_len, value_pos;
+    if (!parse_reg_line(line, &name_pos, &name_len, &value_pos)) {
       std::ostringstream oss;
       oss << "Invalid line in ISS print_register output (`" << line << "').";
       throw std::runtime_error(oss.str());
     }
 
-    assert(match.size() == 3);
-
-    std::string reg_name = match[1].str();
-    std::string str_value = match[2].str();
-
-    assert(reg_name.size() <= 3);
-    assert(reg_name[0] == 'w' || reg_name[0] == 'x');
-    bool is_wide = reg_name[0] == 'w';
-    int reg_idx = atoi(reg_name.c_str() + 1);
+    bool is_wide = line[name_pos] == 'w';
+    int reg_idx = 0;
+    for (size_t i = 1; i < name_len; ++i) {
+      reg_idx = 10 * reg_idx + (line[name_pos + i] - '0');
+    }
 
-    assert(reg_idx >= 0);
     if (reg_idx >= 32) {
       std::ostringstream oss;
-      oss << "Invalid register name in ISS output (`" << reg_name
-          << "'). Line was `" << line << "'.";
+      oss << "Invalid register name in ISS output (`"
+          << line.substr(name_pos, name_len) << "'). Line was `" << line
+          << "'.";
       throw std::runtime_error(oss.str());
     }
 
     unsigned idx_seen = reg_idx + (is_wide ? 32 : 0);
     if ((seen_mask >> idx_seen) & 1) {
       std::ostringstream oss;
-      oss << "Duplicate lines writing register " << reg_name << ".";
+      oss << "Duplicate lines writing register "
+          << line.substr(name_pos, name_len) << ".";
       throw std::runtime_error(oss.str());
     }
 
     unsigned num_u32s = is_wide ? 8 : 1;
-    unsigned expected_value_len = 8 * num_u32s;
-    if (str_value.size() != expected_value_len) {
+    size_t expected_value_len = 8 * num_u32s;
+    size_t value_len = line.size() - value_pos;
+    if (value_len != expected_value_len) {
       std::ostringstream oss;
-      oss << "Value for register " << reg_name << " has " << str_value.size()
-          << " hex characters, but we expected " << expected_value_len << ".";
+      oss << "Value for register " << line.substr(name_pos, name_len)
+          << " has " << value_len << " hex characters, but we expected "
+          << expected_value_len << ".";
       throw std::runtime_error(oss.str());
     }
 
     uint32_t *dst = is_wide ? &(*wdrs)[reg_idx].words[7] : &(*gprs)[reg_idx];
     for (unsigned i = 0; i < num_u32s; ++i) {
-      *dst = read_hex_32(&str_value[8 * i]);
+      *dst = read_hex_32(&line[value_pos + 8 * i]);
       --dst;
     }
 
@@ -627,32 +897,30 @@ std::vector<uint32_t> ISSWrapper::get_call_stack() {
   std::vector<std::string> lines;
   run_command("print_call_stack\n", &lines);
 
-  std::regex re("\\s*0x([0-9a-f]+)");
-  std::smatch match;
   std::vector<uint32_t> call_stack;
+  call_stack.reserve(lines.size());
 
+  // Lines look like "0x12345678"
   for (const std::string &line : lines) {
     if (line == "PRINT_CALL_STACK")
       continue;
 
-    if (!std::regex_match(line, match, re)) {
+    size_t value_pos;
+    if (!match_hex_tail(line, skip_space(line, 0), &value_pos)) {
       std::ostringstream oss;
       oss << "Invalid line in ISS print_call_stack output (`" << line << "').";
       throw std::runtime_error(oss.str());
     }
 
-    assert(match.size() == 2);
-
-    std::string str_value = match[1];
-
-    if (str_value.size() != 8) {
+    size_t value_len = line.size() - value_pos;
+    if (value_len != 8) {
       std::ostringstream oss;
-      oss << "Value from call stack " << str_value << " has "
-          << str_value.size() << " hex characters, but we expected 8.";
+      oss << "Value from call stack " << line.substr(value_pos) << " has "
+          << value_len << " hex characters, but we expected 8.";
       throw std::runtime_error(oss.str());
     }
 
-    uint32_t call_stack_entry = read_hex_32(str_value.c_str());
+    uint32_t call_stack_entry = read_hex_32(&line[value_pos]);
 
     call_stack.push_back(call_stack_entry);
   }
@@ -664,63 +932,57 @@ std::string ISSWrapper::make_tmp_path(const std::string &relative) const {
   return tmpdir->path + "/" + relative;
 }
 
-bool ISSWrapper::read_child_response(std::vector<std::string> *dst) const {
-  char buf[256];
-  bool continuation = false;
-
-  for (;;) {
-    // fgets reads a line, or fills buf, whichever happens first. It always
-    // writes the terminating null, so setting the second last position to \0
-    // beforehand can detect whether we filled buf without needing a call to
-    // strlen: buf is full if and only if this gets written with something
-    // other than a null.
-    buf[sizeof buf - 2] = '\0';
-
-    if (!fgets(buf, sizeof buf, child_read_file)) {
-      // Failed to read from child, or EOF
-      return false;
-    }
+bool ISSWrapper::read_child_response(std::vector<std::string> *dst,
+                                     Response *resp) const {
+  // Each response is a frame with a header of little-endian 32-bit words
+  // (text length, ext_written, the external register values and a cycle
+  // count), followed by the text. See stepped.py for the format.
+  constexpr size_t hdr_words = 3 + NumExtRegs;
+  uint8_t hdr[4 * hdr_words];
+  if (fread(hdr, sizeof hdr, 1, child_read_file) != 1) {
+    // Failed to read from child, or EOF
+    return false;
+  }
 
-    // If buf is ".\n", and we're not continuing another line, we're done.
-    if (!continuation && (0 == strcmp(buf, ".\n"))) {
-      return true;
+  uint32_t text_len = read_le_32(hdr);
+  if (resp) {
+    resp->ext_written = read_le_32(hdr + 4);
+    for (int i = 0; i < NumExtRegs; ++i) {
+      resp->ext_values[i] = read_le_32(hdr + 8 + 4 * i);
     }
+    resp->cycles = read_le_32(hdr + 8 + 4 * NumExtRegs);
+  }
 
-    // Have we read an entire line? If not, fgets will have written something
-    // other than \0 or \n to the second last entry in buf.
-    char canary = buf[sizeof buf - 2];
-    bool next_continuation = !(canary == '\0' || canary == '\n');
-
-    // We have some informative response from the child. Take a copy if dst is
-    // not null, stripping any trailing newline.
-    if (dst) {
-      if (continuation) {
-        assert(dst->size());
-        dst->back() += buf;
-      } else {
-        dst->push_back(std::string(buf));
-      }
+  std::string text(text_len, '\0');
+  if (text_len && fread(&text[0], text_len, 1, child_read_file) != 1) {
+    return false;
+  }
 
-      // If !next_continuation then we read an entire line. If we didn't get to
-      // EOF, the last character of dst->back() is a newline. Drop it.
-      if (!next_continuation && dst->back().back() == '\n') {
-        dst->back().pop_back();
+  // Split the text into lines, dropping the newline characters.
+  if (dst) {
+    size_t pos = 0;
+    while (pos < text.size()) {
+      size_t end = text.find('\n', pos);
+      if (end == std::string::npos) {
+        end = text.size();
       }
+      dst->push_back(text.substr(pos, end - pos));
+      pos = end + 1;
     }
-
-    // Set the continuation flag if we filled buf without a newline.
-    continuation = next_continuation;
   }
+
+  return true;
 }
 
 void ISSWrapper::run_command(const std::string &cmd,
-                             std::vector<std::string> *dst) const {
+                             std::vector<std::string> *dst,
+                             Response *resp) const {
   assert(cmd.size() > 0);
   assert(cmd.back() == '\n');
 
   fputs(cmd.c_str(), child_write_file);
   fflush(child_write_file);
-  if (!read_child_response(dst)) {
+  if (!read_child_response(dst, resp)) {
     std::ostringstream oss;
     std::string cmd_line = cmd.substr(0, cmd.size() - 1);
     oss << "Failed to run command '" << cmd_line << "': EOF from ISS.";
@@ -10,94 +10,92 @@
 #include <memory>
 #include <string>
 #include <unistd.h>
+#include <utility>
 #include <vector>
 
+#include "otbn_iss.h"
+
 // Forward declaration (the implementation is private in iss_wrapper.cc)
 struct TmpDir;
 
-// OTBN has some externally visible CSRs that can be updated by hardware
-// (without explicit writes from software). The ISSWrapper mirrors the ISS's
-// versions of these registers in this structure.
-class MirroredRegs {
- public:
-  MirroredRegs() { reset(); }
-
-  uint32_t status;
-  uint32_t insn_cnt;
-  uint32_t err_bits;
-
-  // The final PC from the most recent run
-  uint32_t stop_pc;
-
-  // We are issuing an EDN request for RND
-  bool rnd_req;
-
-  // This goes high for a single cycle when we start the internal secure wipe
-  // (and can be used as a trigger to check internal state before it gets
-  // trashed)
-  bool wipe_start;
-
-  // Reset the mirrored registers.
-  void reset();
-
-  // Execution is stopped if status is either 0 (IDLE) or 0xff (LOCKED)
-  bool stopped() const { return status == 0 || status == 0xff; }
-};
-
 // An object wrapping the ISS subprocess.
-struct ISSWrapper {
-  // A 256-bit unsigned integer value, stored in "LSB order". Thus, words[0]
-  // contains the LSB and words[7] contains the MSB.
-  struct u256_t {
-    uint32_t words[256 / 32];
-  };
-
-  enum command_t { Execute, DmemWipe, ImemWipe };
-
+struct ISSWrapper : public OtbnIss {
   ISSWrapper();
-  ~ISSWrapper();
+  ~ISSWrapper() override;
 
   // Load new contents of DMEM / IMEM
   void load_d(const std::string &path);
   void load_i(const std::string &path);
 
   // Add a loop warp instruction to the simulation
-  void add_loop_warp(uint32_t addr, uint32_t from_cnt, uint32_t to_cnt);
+  void add_loop_warp(uint32_t addr, uint32_t from_cnt,
+                     uint32_t to_cnt) override;
 
   // Clear any loop warp instructions from the simulation
-  void clear_loop_warps();
+  void clear_loop_warps() override;
 
   // Dump the contents of DMEM to a file
   void dump_d(const std::string &path) const;
 
+  // Return a buffer of at least num_bytes bytes that is mapped by both this
+  // process and the ISS. This invalidates any buffer previously returned if it
+  // was smaller than num_bytes.
+  //
+  // The buffer holds memory contents in the same format as the files passed
+  // to load_d, load_i and dump_d, so that loads and dumps can be exchanged
+  // without going through the filesystem.
+  uint8_t *get_shared_buf(size_t num_bytes) override;
+
+  // Load new contents of DMEM / IMEM from the first num_bytes bytes of the
+  // shared buffer (see get_shared_buf).
+  void load_d_shared(size_t num_bytes) override;
+  void load_i_shared(size_t num_bytes) override;
+
+  // Dump the contents of DMEM to the shared buffer, which must be large enough
+  // to hold them.
+  void dump_d_shared() const override;
+
+  // Like dump_d_shared, but only write the words of DMEM that the ISS has
+  // written since DMEM was last loaded. The rest of the shared buffer is left
+  // unchanged. Returns the runs of words that were written as pairs of (first
+  // word index, word count).
+  std::vector<std::pair<uint32_t, uint32_t>> dump_d_dirty_shared()
+      const override;
+
   // Start an operation (execute, dmem wipe or imem wipe)
-  void start_operation(command_t command);
+  void start_operation(command_t command) override;
 
   // Flush EDN related content in model because of edn_rst_n
-  void edn_flush();
+  void edn_flush() override;
 
   // Provide data for RND. ISS will stall when RND is read and RND data isn't
   // available. RND data is available only when 8 32b packages are sent and
   // also RTL signals CDC is done.
-  void edn_rnd_step(uint32_t edn_rnd_data, bool fips_err);
+  void edn_rnd_step(uint32_t edn_rnd_data, bool fips_err) override;
 
   // Provide data for URND seed. ISS will stall until reseeding of URND is
   // complete. URND seed data is available only when 8 32b packages are sent and
   // also RTL signals CDC is done.
-  void edn_urnd_step(uint32_t edn_urnd_data);
+  void edn_urnd_step(uint32_t edn_urnd_data) override;
+
+  // Provide a whole 256b RND value or URND seed (see OtbnIss). These send a
+  // single command to the ISS, rather than one for each 32b package.
+  void edn_rnd_step256(const u256_t &edn_rnd_data, uint8_t fips_errs) override;
+  void edn_urnd_step256(const u256_t &edn_urnd_data) override;
 
   // Provide keymgr values to model
   void set_keymgr_value(const std::array<uint32_t, 12> &key0_arr,
-                        const std::array<uint32_t, 12> &key1_arr, bool valid);
+                        const std::array<uint32_t, 12> &key1_arr,
+                        bool valid) override;
 
   // Signals that the received OTP key is valid in the RTL.
-  void otp_key_cdc_done();
+  void otp_key_cdc_done() override;
 
   // Signals 256b EDN random number for RND is valid in the RTL.
-  void edn_rnd_cdc_done();
+  void edn_rnd_cdc_done() override;
 
   // Signals 256b EDN random number for URND seed is valid in the RTL.
-  void edn_urnd_cdc_done();
+  void edn_urnd_cdc_done() override;
 
   // Run simulation for a single cycle.
   //
@@ -112,42 +110,60 @@ struct ISSWrapper {
   // Updates mirrored versions of STATUS and INSN_CNT registers. If execution
   // finishes (so we return 1), also updates mirrored versions of ERR_BITS and
   // the final PC (see get_stop_pc()).
-  int step(bool gen_trace);
+  int step(bool gen_trace) override;
+
+  // Run simulation for up to max_cycles cycles in a single exchange with the
+  // ISS.
+  //
+  // This stops early if the operation finishes or the ISS requests RND data
+  // (which has to be supplied with edn_rnd_step). It is meant for running the
+  // model without RTL to compare against cycle by cycle: mirrored registers are
+  // only updated with their final values, so single-cycle pulses (such as
+  // wipe_start) can be missed. If cycles_run is not null, it is set to the
+  // number of cycles that were actually run.
+  //
+  // The return code and gen_trace argument are as for step().
+  int run(uint32_t max_cycles, bool gen_trace, uint32_t *cycles_run);
 
   // Mark all of IMEM as invalid so that any fetch causes an integrity error.
-  void invalidate_imem();
+  void invalidate_imem() override;
 
   // Mark all of DMEM as invalid so that any load causes an integrity error.
-  void invalidate_dmem();
+  void invalidate_dmem() override;
 
   // Set software_errs_fatal bit in ISS model.
-  void set_software_errs_fatal(bool new_val);
+  void set_software_errs_fatal(bool new_val) override;
 
-  void initial_secure_wipe();
+  void initial_secure_wipe() override;
 
   // Step a CRC calculation with 48 bits of data
-  uint32_t step_crc(const std::array<uint8_t, 6> &item, uint32_t state) const;
+  uint32_t step_crc(const std::array<uint8_t, 6> &item,
+                    uint32_t state) const override;
+
+  // Step a CRC calculation with each of items in turn, in a single command
+  uint32_t step_crc_block(const std::vector<std::array<uint8_t, 6>> &items,
+                          uint32_t state) const override;
 
   // Reset simulation
   //
   // This doesn't actually send anything to the ISS, but instead tells the
   // OtbnTraceChecker to clear out any partial instructions. It also resets
   // mirrored registers to their initial states.
-  void reset(bool gen_trace);
+  void reset(bool gen_trace) override;
 
   // Send an error escalation
-  void send_err_escalation(uint32_t err_val, bool lock_immediately);
+  void send_err_escalation(uint32_t err_val,
+                           bool lock_immediately) override;
 
   // Set the RMA request input
-  void set_rma_req(uint8_t rma_req);
-
-  const MirroredRegs &get_mirrored() const { return mirrored_; }
+  void set_rma_req(uint8_t rma_req) override;
 
   // Read contents of the register file
-  void get_regs(std::array<uint32_t, 32> *gprs, std::array<u256_t, 32> *wdrs);
+  void get_regs(std::array<uint32_t, 32> *gprs,
+                std::array<u256_t, 32> *wdrs) override;
 
   // Read the contents of the call stack
-  std::vector<uint32_t> get_call_stack();
+  std::vector<uint32_t> get_call_stack() override;
 
   // Resolve a path relative to the convenience temporary directory.
   // relative should be a relative path (it is just appended to the
@@ -155,14 +171,44 @@ struct ISSWrapper {
   std::string make_tmp_path(const std::string &relative) const;
 
  private:
-  // Read line by line from the child process until we get ".\n".
-  // Return true if we got the ".\n" terminator, false if EOF. If dst
-  // is not null, append to it each line that was read.
-  bool read_child_response(std::vector<std::string> *dst) const;
+  // External registers whose final values are reported in the header of each
+  // response from the ISS. This order must match EXT_REG_NAMES in stepped.py.
+  enum ext_reg_t {
+    ExtStatus,
+    ExtInsnCnt,
+    ExtErrBits,
+    ExtStopPc,
+    ExtRndReq,
+    ExtWipeStart,
+    ExtLoadChecksum,
+    NumExtRegs
+  };
+
+  // The fixed-size part of a response from the ISS
+  struct Response {
+    // Bit i is set if external register i was written by the command
+    uint32_t ext_written;
+    uint32_t ext_values[NumExtRegs];
+    // Number of cycles stepped by the command
+    uint32_t cycles;
+
+    bool written(ext_reg_t reg) const { return (ext_written >> reg) & 1; }
+  };
+
+  // Read a response frame from the child process. Return true on success,
+  // false on EOF. If dst is not null, append to it each line of text in the
+  // response. If resp is not null, fill it in from the frame header.
+  bool read_child_response(std::vector<std::string> *dst,
+                           Response *resp) const;
 
   // Send a command to the child and wait for its response. If no
   // response, raise a runtime_error.
-  void run_command(const std::string &cmd, std::vector<std::string> *dst) const;
+  void run_command(const std::string &cmd, std::vector<std::string> *dst,
+                   Response *resp = nullptr) const;
+
+  // Update mirrored registers from a step or run response. Returns 1 if
+  // execution just stopped, 0 if not and -1 on error (see step()).
+  int update_mirrored(const Response &resp);
 
   pid_t child_pid;
   FILE *child_write_file;
@@ -171,8 +217,52 @@ struct ISSWrapper {
   // A temporary directory for communicating with the child process
   std::unique_ptr<TmpDir> tmpdir;
 
-  // Mirrored copies of registers
-  MirroredRegs mirrored_;
+  // A file in tmpdir that is mapped by both this process and the child, for
+  // exchanging memory contents (see get_shared_buf)
+  int shared_fd;
+  uint8_t *shared_buf;
+  size_t shared_size;
+};
+
+// A simulator-wide pool of idle ISS processes.
+//
+// Starting an ISS is slow (it has to start a Python interpreter and import the
+// simulator), so OtbnModel gets its ISSWrapper from here and gives it back
+// when it is done with it. The pool keeps up to size() idle wrappers whose
+// child processes have already been started and reset, and starts a
+// replacement in the background whenever one is handed out. With a size of
+// zero (the default), acquire() just constructs a new ISSWrapper and release()
+// destroys it.
+class ISSWrapperPool {
+ public:
+  // Get the singleton pool
+  static ISSWrapperPool &get();
+
+  // Set the number of idle ISS processes to keep. If this is larger than the
+  // number currently idle, starts new ones immediately.
+  void set_size(size_t size);
+
+  size_t size() const { return size_; }
+
+  // Return an ISSWrapper in its reset state, taken from the pool if possible.
+  // Throws a std::runtime_error if a new wrapper is needed and can't be
+  // constructed.
+  std::unique_ptr<ISSWrapper> acquire();
+
+  // Give back a wrapper that was returned by acquire(). If the pool isn't
+  // full, it is reset and kept for the next call to acquire(); otherwise (or
+  // if the reset fails) it is destroyed.
+  void release(std::unique_ptr<ISSWrapper> iss);
+
+ private:
+  ISSWrapperPool() : size_(0) {}
+
+  // Start new ISS processes until there are size_ idle ones. Prints a message
+  // and gives up if something goes wrong.
+  void fill();
+
+  size_t size_;
+  std::vector<std::unique_ptr<ISSWrapper>> idle_;
 };
 
 #endif  // OPENTITAN_HW_IP_OTBN_DV_MODEL_ISS_WRAPPER_H_
@@ -64,8 +64,27 @@ module otbn_core_model
   // Create and destroy an object through which we can talk to the ISS.
   chandle model_handle;
   initial begin
+    int full_dmem_check_interval;
+    int iss_pool_size;
+    // Use +otbn_iss_pool_size=N to keep N ISS processes started and ready for models that are
+    // created later (this setting is shared by all instances).
+    if ($value$plusargs("otbn_iss_pool_size=%d", iss_pool_size)) begin
+      otbn_model_set_iss_pool_size(iss_pool_size);
+    end
     model_handle = otbn_model_init(MemScope, DesignScope);
     assert(model_handle != null);
+    // By default, all of DMEM is checked at the end of every operation. Use
+    // +otbn_full_dmem_check_interval=N to only do this every N operations, checking just the words
+    // written by the model in between. N=0 never checks the whole of DMEM, so a stray write by the
+    // RTL to a word that the model didn't write will go unnoticed.
+    if ($value$plusargs("otbn_full_dmem_check_interval=%d", full_dmem_check_interval)) begin
+      assert(otbn_set_full_dmem_check_interval(model_handle, full_dmem_check_interval) == 0);
+    end
+    // Use +otbn_native_iss to run the model with the in-process C++ ISS instead of the Python one.
+    // This is much faster, but there is no cycle-by-cycle trace comparison with the RTL.
+    if ($test$plusargs("otbn_native_iss")) begin
+      assert(otbn_model_use_native_iss(model_handle) == 0);
+    end
   end
   final begin
     otbn_model_destroy(model_handle);
@@ -258,19 +277,53 @@ module otbn_core_model
   end
 
   // EDN Stepping is done with the EDN clock for also asserting the CDC measures in the design.
+  //
+  // EDN delivers each 256-bit RND value or URND seed as 8 32-bit words (the packer in prim_edn_req
+  // is only cleared by reset). Rather than passing each word to the model as it arrives, which
+  // costs a round trip to the ISS per word, we collect the words here and pass the whole value
+  // when the last one arrives. The model doesn't use the value until the RTL signals that the CDC
+  // is done, which is later still, so it sees the same thing.
   logic failed_edn_flush, failed_rnd_step, failed_urnd_step;
+  logic [255:0] rnd_data_q, rnd_data_d, urnd_data_q, urnd_data_d;
+  logic [7:0]   rnd_fips_errs_q, rnd_fips_errs_d;
+  logic [2:0]   rnd_word_q, urnd_word_q;
+
+  always_comb begin
+    rnd_data_d = rnd_data_q;
+    rnd_data_d[32 * rnd_word_q +: 32] = edn_rnd_i.edn_bus;
+    rnd_fips_errs_d = rnd_fips_errs_q;
+    rnd_fips_errs_d[rnd_word_q] = ~edn_rnd_i.edn_fips;
+
+    urnd_data_d = urnd_data_q;
+    urnd_data_d[32 * urnd_word_q +: 32] = edn_urnd_i.edn_bus;
+  end
+
   always_ff @(posedge clk_edn_i or negedge rst_edn_ni) begin
     if (!rst_edn_ni) begin
       failed_rnd_step <= 0;
       failed_urnd_step <= 0;
+      rnd_data_q <= '0;
+      rnd_fips_errs_q <= '0;
+      rnd_word_q <= '0;
+      urnd_data_q <= '0;
+      urnd_word_q <= '0;
       failed_edn_flush <= (otbn_model_edn_flush(model_handle) != 0);
     end else begin
       if (edn_rnd_i.edn_ack) begin
-        failed_rnd_step <= (otbn_model_edn_rnd_step(model_handle, edn_rnd_i.edn_bus,
-                                                    ~edn_rnd_i.edn_fips) != 0);
+        rnd_data_q <= rnd_data_d;
+        rnd_fips_errs_q <= rnd_fips_errs_d;
+        rnd_word_q <= rnd_word_q + 3'd1;
+        if (rnd_word_q == 3'd7) begin
+          failed_rnd_step <= (otbn_model_edn_rnd_step256(model_handle, rnd_data_d,
+                                                         rnd_fips_errs_d) != 0);
+        end
       end
       if (edn_urnd_i.edn_ack) begin
-        failed_urnd_step <= (otbn_model_edn_urnd_step(model_handle, edn_urnd_i.edn_bus) != 0);
+        urnd_data_q <= urnd_data_d;
+        urnd_word_q <= urnd_word_q + 3'd1;
+        if (urnd_word_q == 3'd7) begin
+          failed_urnd_step <= (otbn_model_edn_urnd_step256(model_handle, urnd_data_d) != 0);
+        end
       end
     end
   end
@@ -0,0 +1,202 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+#ifndef OPENTITAN_HW_IP_OTBN_DV_MODEL_OTBN_ISS_H_
+#define OPENTITAN_HW_IP_OTBN_DV_MODEL_OTBN_ISS_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// OTBN has some externally visible CSRs that can be updated by hardware
+// (without explicit writes from software). An ISS mirrors its versions of
+// these registers in this structure.
+class MirroredRegs {
+ public:
+  MirroredRegs() { reset(); }
+
+  uint32_t status;
+  uint32_t insn_cnt;
+  uint32_t err_bits;
+
+  // The final PC from the most recent run
+  uint32_t stop_pc;
+
+  // We are issuing an EDN request for RND
+  bool rnd_req;
+
+  // This goes high for a single cycle when we start the internal secure wipe
+  // (and can be used as a trigger to check internal state before it gets
+  // trashed)
+  bool wipe_start;
+
+  // Reset the mirrored registers.
+  void reset() {
+    status = 0x04;
+    insn_cnt = 0;
+    err_bits = 0;
+    stop_pc = 0;
+    rnd_req = false;
+    wipe_start = false;
+  }
+
+  // Execution is stopped if status is either 0 (IDLE) or 0xff (LOCKED)
+  bool stopped() const { return status == 0 || status == 0xff; }
+};
+
+// The interface that OtbnModel uses to drive an instruction set simulator.
+//
+// There are two implementations. ISSWrapper (in iss_wrapper.h) runs the Python
+// ISS in a child process, which is the reference model and can generate a
+// trace to check against the RTL cycle by cycle. OtbnNativeIss (in
+// otbn_native_iss.h) runs in-process and is much faster, but doesn't generate
+// a trace.
+//
+// Methods throw a std::runtime_error if something goes wrong.
+class OtbnIss {
+ public:
+  // A 256-bit unsigned integer value, stored in "LSB order". Thus, words[0]
+  // contains the LSB and words[7] contains the MSB.
+  struct u256_t {
+    uint32_t words[256 / 32];
+  };
+
+  enum command_t { Execute, DmemWipe, ImemWipe };
+
+  virtual ~OtbnIss() {}
+
+  // Add a loop warp instruction to the simulation
+  virtual void add_loop_warp(uint32_t addr, uint32_t from_cnt,
+                             uint32_t to_cnt) = 0;
+
+  // Clear any loop warp instructions from the simulation
+  virtual void clear_loop_warps() = 0;
+
+  // Return a buffer of at least num_bytes bytes that is used to exchange
+  // memory contents with the ISS. This invalidates any buffer previously
+  // returned if it was smaller than num_bytes.
+  //
+  // Each word in the buffer is a validity byte (0 or 1) followed by the
+  // little-endian 32-bit word.
+  virtual uint8_t *get_shared_buf(size_t num_bytes) = 0;
+
+  // Load new contents of DMEM / IMEM from the first num_bytes bytes of the
+  // shared buffer (see get_shared_buf).
+  virtual void load_d_shared(size_t num_bytes) = 0;
+  virtual void load_i_shared(size_t num_bytes) = 0;
+
+  // Dump the contents of DMEM to the shared buffer, which must be large enough
+  // to hold them.
+  virtual void dump_d_shared() const = 0;
+
+  // Like dump_d_shared, but only write the words of DMEM that the ISS has
+  // written since DMEM was last loaded. The rest of the shared buffer is left
+  // unchanged. Returns the runs of words that were written as pairs of (first
+  // word index, word count).
+  virtual std::vector<std::pair<uint32_t, uint32_t>> dump_d_dirty_shared()
+      const = 0;
+
+  // Start an operation (execute, dmem wipe or imem wipe)
+  virtual void start_operation(command_t command) = 0;
+
+  // Flush EDN related content in model because of edn_rst_n
+  virtual void edn_flush() = 0;
+
+  // Provide data for RND. ISS will stall when RND is read and RND data isn't
+  // available. RND data is available only when 8 32b packages are sent and
+  // also RTL signals CDC is done.
+  virtual void edn_rnd_step(uint32_t edn_rnd_data, bool fips_err) = 0;
+
+  // Provide data for URND seed. ISS will stall until reseeding of URND is
+  // complete. URND seed data is available only when 8 32b packages are sent and
+  // also RTL signals CDC is done.
+  virtual void edn_urnd_step(uint32_t edn_urnd_data) = 0;
+
+  // Like edn_rnd_step, but provide all 8 32b packages of a 256b RND value at
+  // once, starting with words[0]. Bit i of fips_errs is the FIPS error flag of
+  // words[i].
+  virtual void edn_rnd_step256(const u256_t &edn_rnd_data,
+                               uint8_t fips_errs) = 0;
+
+  // Like edn_urnd_step, but provide all 8 32b packages of a 256b URND seed at
+  // once, starting with words[0].
+  virtual void edn_urnd_step256(const u256_t &edn_urnd_data) = 0;
+
+  // Provide keymgr values to model
+  virtual void set_keymgr_value(const std::array<uint32_t, 12> &key0_arr,
+                                const std::array<uint32_t, 12> &key1_arr,
+                                bool valid) = 0;
+
+  // Signals that the received OTP key is valid in the RTL.
+  virtual void otp_key_cdc_done() = 0;
+
+  // Signals 256b EDN random number for RND is valid in the RTL.
+  virtual void edn_rnd_cdc_done() = 0;
+
+  // Signals 256b EDN random number for URND seed is valid in the RTL.
+  virtual void edn_urnd_cdc_done() = 0;
+
+  // Run simulation for a single cycle.
+  //
+  // If gen_trace is true and the ISS supports it, pass trace data to the
+  // (singleton) OtbnTraceChecker object.
+  //
+  // The return code describes the state of the simulation. It is 1 if the
+  // simulation just stopped (on ECALL or an architectural error); it is 0 if
+  // the simulation is still running. It is -1 if something went wrong (such as
+  // a trace mismatch).
+  //
+  // Updates mirrored versions of STATUS and INSN_CNT registers. If execution
+  // finishes (so we return 1), also updates mirrored versions of ERR_BITS and
+  // the final PC.
+  virtual int step(bool gen_trace) = 0;
+
+  // Mark all of IMEM as invalid so that any fetch causes an integrity error.
+  virtual void invalidate_imem() = 0;
+
+  // Mark all of DMEM as invalid so that any load causes an integrity error.
+  virtual void invalidate_dmem() = 0;
+
+  // Set software_errs_fatal bit in ISS model.
+  virtual void set_software_errs_fatal(bool new_val) = 0;
+
+  virtual void initial_secure_wipe() = 0;
+
+  // Step a CRC calculation with 48 bits of data
+  virtual uint32_t step_crc(const std::array<uint8_t, 6> &item,
+                            uint32_t state) const = 0;
+
+  // Step a CRC calculation with each of items in turn
+  virtual uint32_t step_crc_block(
+      const std::vector<std::array<uint8_t, 6>> &items,
+      uint32_t state) const = 0;
+
+  // Reset simulation and the mirrored registers. If gen_trace is true, also
+  // tell the OtbnTraceChecker to clear out any partial instructions.
+  virtual void reset(bool gen_trace) = 0;
+
+  // Send an error escalation
+  virtual void send_err_escalation(uint32_t err_val,
+                                   bool lock_immediately) = 0;
+
+  // Set the RMA request input
+  virtual void set_rma_req(uint8_t rma_req) = 0;
+
+  const MirroredRegs &get_mirrored() const { return mirrored_; }
+
+  // Read contents of the register file
+  virtual void get_regs(std::array<uint32_t, 32> *gprs,
+                        std::array<u256_t, 32> *wdrs) = 0;
+
+  // Read the contents of the call stack (the first element is the bottom of
+  // the stack)
+  virtual std::vector<uint32_t> get_call_stack() = 0;
+
+ protected:
+  // Mirrored copies of registers
+  MirroredRegs mirrored_;
+};
+
+#endif  // OPENTITAN_HW_IP_OTBN_DV_MODEL_OTBN_ISS_H_
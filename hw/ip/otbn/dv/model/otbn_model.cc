@@ -7,13 +7,14 @@
 #include <algorithm>
 #include <cassert>
 #include <cstring>
-#include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <sstream>
 
+#include "dpi_profile.h"
 #include "iss_wrapper.h"
 #include "otbn_model_dpi.h"
+#include "otbn_native_iss.h"
 #include "otbn_trace_checker.h"
 #include "sv_scoped.h"
 #include "sv_utils.h"
@@ -40,45 +41,32 @@ int otbn_stack_element_peek(int index, svBitVecVal *val);
 #define STATUS_BUSY_SEC_WIPE_INT 0x04
 #define STATUS_LOCKED 0xFF
 
-// Read (the start of) the contents of a file at path as a vector of bytes.
-// Expects num_bytes bytes of data. On failure, throws a std::runtime_error.
-static Ecc32MemArea::EccWords read_words_from_file(const std::string &path,
-                                                   size_t num_words) {
-  std::filebuf fb;
-  if (!fb.open(path.c_str(), std::ios::in | std::ios::binary)) {
-    std::ostringstream oss;
-    oss << "Cannot open the file '" << path << "'.";
-    throw std::runtime_error(oss.str());
-  }
+// Each word exchanged with the ISS is a validity byte (either 0 or 1),
+// followed by 4 bytes with a little-endian 32-bit word.
+static const size_t kIssWordBytes = 5;
 
+// Read num_words words from a buffer shared with the ISS. On failure, throws a
+// std::runtime_error.
+static Ecc32MemArea::EccWords read_words_from_buf(const uint8_t *buf,
+                                                  size_t num_words) {
   Ecc32MemArea::EccWords ret;
   ret.reserve(num_words);
 
-  char minibuf[5];
   for (size_t i = 0; i < num_words; ++i) {
-    std::streamsize chars_in = fb.sgetn(minibuf, 5);
-    if (chars_in != 5) {
-      std::ostringstream oss;
-      oss << "Cannot read word " << i << " from " << path
-          << " (expected 5 bytes, but actually got " << chars_in << ").";
-      throw std::runtime_error(oss.str());
-    }
+    const uint8_t *minibuf = buf + kIssWordBytes * i;
 
-    // The layout should be a validity byte (either 0 or 1), followed
-    // by 4 bytes with a little-endian 32-bit word.
     uint8_t vld_byte = minibuf[0];
     if (vld_byte > 2) {
       std::ostringstream oss;
-      oss << "Word " << i << " at " << path
-          << " had a validity byte with value " << (int)vld_byte
-          << "; not 0 or 1.";
+      oss << "Word " << i << " from the ISS had a validity byte with value "
+          << (int)vld_byte << "; not 0 or 1.";
       throw std::runtime_error(oss.str());
     }
     bool valid = vld_byte == 1;
 
     uint32_t word = 0;
     for (int j = 0; j < 4; ++j) {
-      word |= (uint32_t)(uint8_t)minibuf[j + 1] << 8 * j;
+      word |= (uint32_t)minibuf[j + 1] << 8 * j;
     }
 
     ret.push_back(std::make_pair(valid, word));
@@ -87,35 +75,19 @@ static Ecc32MemArea::EccWords read_words_from_file(const std::string &path,
   return ret;
 }
 
-// Write some words to a new file at path. On failure, throws a
-// std::runtime_error.
-static void write_words_to_file(const std::string &path,
-                                const Ecc32MemArea::EccWords &words) {
-  std::filebuf fb;
-  if (!fb.open(path.c_str(), std::ios::out | std::ios::binary)) {
-    std::ostringstream oss;
-    oss << "Cannot open the file '" << path << "'.";
-    throw std::runtime_error(oss.str());
-  }
-
+// Write some words to a buffer shared with the ISS, which must have space for
+// kIssWordBytes bytes per word.
+static void write_words_to_buf(uint8_t *buf,
+                               const Ecc32MemArea::EccWords &words) {
   for (const Ecc32MemArea::EccWord &word : words) {
-    uint8_t bytes[5];
-
     bool valid = word.first;
     uint32_t w32 = word.second;
 
-    bytes[0] = valid ? 1 : 0;
+    buf[0] = valid ? 1 : 0;
     for (int j = 0; j < 4; ++j) {
-      bytes[j + 1] = (w32 >> (8 * j)) & 0xff;
-    }
-
-    std::streamsize chars_out =
-        fb.sputn(reinterpret_cast<const char *>(&bytes), 5);
-    if (chars_out != 5) {
-      std::ostringstream oss;
-      oss << "Failed to write to " << path << ".";
-      throw std::runtime_error(oss.str());
+      buf[j + 1] = (w32 >> (8 * j)) & 0xff;
     }
+    buf += kIssWordBytes;
   }
 }
 
@@ -195,10 +167,10 @@ OtbnModel::OtbnModel(const std::string &mem_scope,
   assert(mem_scope.size() && design_scope.size());
 }
 
-OtbnModel::~OtbnModel() {}
+OtbnModel::~OtbnModel() { ISSWrapperPool::get().release(std::move(iss_)); }
 
 int OtbnModel::take_loop_warps(const OtbnMemUtil &memutil) {
-  ISSWrapper *iss = ensure_wrapper();
+  OtbnIss *iss = ensure_wrapper();
   if (!iss)
     return -1;
 
@@ -227,36 +199,40 @@ int OtbnModel::take_loop_warps(const OtbnMemUtil &memutil) {
 }
 
 int OtbnModel::start_operation(command_t command) {
-  ISSWrapper *iss = ensure_wrapper();
+  OtbnIss *iss = ensure_wrapper();
   if (!iss)
     return -1;
 
   const char *cmd_desc = "unknown";
-  ISSWrapper::command_t iss_command;
+  OtbnIss::command_t iss_command;
   try {
     switch (command) {
       case Execute: {
         cmd_desc = "execute";
-        iss_command = ISSWrapper::Execute;
-
-        std::string dfname(iss->make_tmp_path("dmem"));
-        std::string ifname(iss->make_tmp_path("imem"));
-
-        write_words_to_file(dfname, get_sim_memory(false));
-        write_words_to_file(ifname, get_sim_memory(true));
-
-        iss->load_d(dfname);
-        iss->load_i(ifname);
+        iss_command = OtbnIss::Execute;
+
+        Ecc32MemArea::EccWords dwords = get_sim_memory(false);
+        Ecc32MemArea::EccWords iwords = get_sim_memory(true);
+        size_t dbytes = kIssWordBytes * dwords.size();
+        size_t ibytes = kIssWordBytes * iwords.size();
+
+        // The ISS reads each memory out of the shared buffer when told to
+        // load it, so the buffer can be reused for the second one.
+        uint8_t *buf = iss->get_shared_buf(std::max(dbytes, ibytes));
+        write_words_to_buf(buf, dwords);
+        iss->load_d_shared(dbytes);
+        write_words_to_buf(buf, iwords);
+        iss->load_i_shared(ibytes);
       } break;
 
       case DmemWipe:
         cmd_desc = "DMEM wipe";
-        iss_command = ISSWrapper::DmemWipe;
+        iss_command = OtbnIss::DmemWipe;
         break;
 
       case ImemWipe:
         cmd_desc = "IMEM wipe";
-        iss_command = ISSWrapper::ImemWipe;
+        iss_command = OtbnIss::ImemWipe;
         break;
 
       default:
@@ -274,7 +250,7 @@ int OtbnModel::start_operation(command_t command) {
 }
 
 int OtbnModel::edn_flush() {
-  ISSWrapper *iss = ensure_wrapper();
+  OtbnIss *iss = ensure_wrapper();
   if (!iss)
     return -1;
 
@@ -290,7 +266,7 @@ int OtbnModel::edn_flush() {
 
 int OtbnModel::edn_rnd_step(svLogicVecVal *edn_rnd_data /* logic [31:0] */,
                             unsigned char fips_err) {
-  ISSWrapper *iss = ensure_wrapper();
+  OtbnIss *iss = ensure_wrapper();
   if (!iss)
     return -1;
 
@@ -306,7 +282,7 @@ int OtbnModel::edn_rnd_step(svLogicVecVal *edn_rnd_data /* logic [31:0] */,
 }
 
 int OtbnModel::edn_urnd_step(svLogicVecVal *edn_urnd_data /* logic [31:0] */) {
-  ISSWrapper *iss = ensure_wrapper();
+  OtbnIss *iss = ensure_wrapper();
   if (!iss)
     return -1;
 
@@ -320,8 +296,50 @@ int OtbnModel::edn_urnd_step(svLogicVecVal *edn_urnd_data /* logic [31:0] */) {
   return 0;
 }
 
+// Read a logic [255:0] value passed from SystemVerilog (ignoring any X or Z
+// bits, as the single-word versions do)
+static OtbnIss::u256_t read_u256(const svLogicVecVal *value) {
+  OtbnIss::u256_t ret;
+  for (int i = 0; i < 8; ++i) {
+    ret.words[i] = value[i].aval;
+  }
+  return ret;
+}
+
+int OtbnModel::edn_rnd_step256(svLogicVecVal *edn_rnd_data /* logic [255:0] */,
+                               const svBitVecVal *fips_errs /* bit [7:0] */) {
+  OtbnIss *iss = ensure_wrapper();
+  if (!iss)
+    return -1;
+
+  try {
+    iss->edn_rnd_step256(read_u256(edn_rnd_data), fips_errs[0] & 0xff);
+  } catch (const std::runtime_error &err) {
+    std::cerr << "Error when stepping EDN for RND: " << err.what() << "\n";
+    return -1;
+  }
+
+  return 0;
+}
+
+int OtbnModel::edn_urnd_step256(
+    svLogicVecVal *edn_urnd_data /* logic [255:0] */) {
+  OtbnIss *iss = ensure_wrapper();
+  if (!iss)
+    return -1;
+
+  try {
+    iss->edn_urnd_step256(read_u256(edn_urnd_data));
+  } catch (const std::runtime_error &err) {
+    std::cerr << "Error when stepping EDN for URND: " << err.what() << "\n";
+    return -1;
+  }
+
+  return 0;
+}
+
 int OtbnModel::edn_rnd_cdc_done() {
-  ISSWrapper *iss = ensure_wrapper();
+  OtbnIss *iss = ensure_wrapper();
   if (!iss)
     return -1;
 
@@ -337,7 +355,7 @@ int OtbnModel::edn_rnd_cdc_done() {
 }
 
 int OtbnModel::edn_urnd_cdc_done() {
-  ISSWrapper *iss = ensure_wrapper();
+  OtbnIss *iss = ensure_wrapper();
   if (!iss)
     return -1;
 
@@ -353,7 +371,7 @@ int OtbnModel::edn_urnd_cdc_done() {
 }
 
 int OtbnModel::otp_key_cdc_done() {
-  ISSWrapper *iss = ensure_wrapper();
+  OtbnIss *iss = ensure_wrapper();
   if (!iss)
     return -1;
 
@@ -371,7 +389,7 @@ int OtbnModel::otp_key_cdc_done() {
 int OtbnModel::set_keymgr_value(svLogicVecVal *key0 /* logic [383:0] */,
                                 svLogicVecVal *key1 /* logic [383:0] */,
                                 unsigned char valid) {
-  ISSWrapper *iss = ensure_wrapper();
+  OtbnIss *iss = ensure_wrapper();
 
   std::array<uint32_t, 12> key0_arr;
   std::array<uint32_t, 12> key1_arr;
@@ -398,7 +416,7 @@ int OtbnModel::step(svBitVecVal *status /* bit [7:0] */,
                     svBitVecVal *stop_pc /* bit [31:0] */) {
   assert(insn_cnt && err_bits && stop_pc);
 
-  ISSWrapper *iss = ensure_wrapper();
+  OtbnIss *iss = ensure_wrapper();
   if (!iss)
     return -1;
 
@@ -452,7 +470,7 @@ int OtbnModel::check() const {
   if (!has_rtl())
     return 1;
 
-  ISSWrapper *iss = iss_.get();
+  OtbnIss *iss = this->iss();
   if (!iss) {
     std::cerr << "Cannot check OTBN model: ISS has not started.\n";
     return -1;
@@ -460,7 +478,10 @@ int OtbnModel::check() const {
 
   bool good = true;
 
-  good &= OtbnTraceChecker::get().Finish();
+  // The native ISS doesn't generate a trace, so there's nothing to compare
+  // with the RTL's.
+  if (!use_native_iss_)
+    good &= OtbnTraceChecker::get().Finish();
 
   // Check DMEM only when we are about to start Secure Wipe because otherwise
   // we would not have a valid scrambling key anymore. That would result with
@@ -494,7 +515,7 @@ int OtbnModel::check() const {
 }
 
 int OtbnModel::load_dmem() {
-  ISSWrapper *iss = iss_.get();
+  OtbnIss *iss = this->iss();
   if (!iss) {
     std::cerr << "Cannot load dmem from OTBN model: ISS has not started.\n";
     return -1;
@@ -502,12 +523,12 @@ int OtbnModel::load_dmem() {
 
   const MemArea &dmem = mem_util_.GetMemArea(false);
 
-  std::string dfname(iss->make_tmp_path("dmem_out"));
+  size_t num_words = dmem.GetSizeBytes() / 4;
   try {
     // Read DMEM from the ISS
-    iss->dump_d(dfname);
-    set_sim_memory(false,
-                   read_words_from_file(dfname, dmem.GetSizeBytes() / 4));
+    const uint8_t *buf = iss->get_shared_buf(kIssWordBytes * num_words);
+    iss->dump_d_shared();
+    set_sim_memory(false, read_words_from_buf(buf, num_words));
   } catch (const std::exception &err) {
     std::cerr << "Error when loading dmem from ISS: " << err.what() << "\n";
     return -1;
@@ -516,7 +537,7 @@ int OtbnModel::load_dmem() {
 }
 
 int OtbnModel::invalidate_imem() {
-  ISSWrapper *iss = ensure_wrapper();
+  OtbnIss *iss = ensure_wrapper();
   if (!iss)
     return -1;
 
@@ -531,7 +552,7 @@ int OtbnModel::invalidate_imem() {
 }
 
 int OtbnModel::invalidate_dmem() {
-  ISSWrapper *iss = ensure_wrapper();
+  OtbnIss *iss = ensure_wrapper();
   if (!iss)
     return -1;
 
@@ -546,7 +567,7 @@ int OtbnModel::invalidate_dmem() {
 }
 
 int OtbnModel::set_software_errs_fatal(unsigned char new_val) {
-  ISSWrapper *iss = ensure_wrapper();
+  OtbnIss *iss = ensure_wrapper();
   if (!iss)
     return -1;
 
@@ -571,9 +592,15 @@ int OtbnModel::disable_stack_check() {
   return 0;
 }
 
+int OtbnModel::set_full_dmem_check_interval(uint32_t interval) {
+  full_dmem_check_interval_ = interval;
+  dmem_checks_since_full_ = 0;
+  return 0;
+}
+
 int OtbnModel::step_crc(const svBitVecVal *item /* bit [47:0] */,
                         svBitVecVal *state /* bit [31:0] */) {
-  ISSWrapper *iss = ensure_wrapper();
+  OtbnIss *iss = ensure_wrapper();
   if (!iss)
     return -1;
 
@@ -596,12 +623,38 @@ int OtbnModel::step_crc(const svBitVecVal *item /* bit [47:0] */,
   return 0;
 }
 
+int OtbnModel::step_crc_block(const svOpenArrayHandle items,
+                              svBitVecVal *state /* bit [31:0] */) {
+  OtbnIss *iss = ensure_wrapper();
+  if (!iss)
+    return -1;
+
+  int num_items = svSize(items, 1);
+  std::vector<std::array<uint8_t, 6>> item_arrs(num_items);
+  for (int j = 0; j < num_items; ++j) {
+    const svBitVecVal *item = static_cast<const svBitVecVal *>(
+        svGetArrElemPtr1(items, svLow(items, 1) + j));
+    for (size_t i = 0; i < item_arrs[j].size(); ++i) {
+      item_arrs[j][i] = item[i / 4] >> 8 * (i % 4);
+    }
+  }
+
+  try {
+    state[0] = iss->step_crc_block(item_arrs, state[0]);
+  } catch (const std::exception &err) {
+    std::cerr << "Error when stepping CRC in ISS: " << err.what() << "\n";
+    return -1;
+  }
+
+  return 0;
+}
+
 int OtbnModel::reset(svBitVecVal *status /* bit [7:0] */,
                      svBitVecVal *insn_cnt /* bit [31:0] */,
                      svBitVecVal *rnd_req /* bit [0:0] */,
                      svBitVecVal *err_bits /* bit [31:0] */,
                      svBitVecVal *stop_pc /* bit [31:0] */) {
-  ISSWrapper *iss = iss_.get();
+  OtbnIss *iss = this->iss();
   if (!iss)
     return 0;
 
@@ -623,7 +676,7 @@ int OtbnModel::reset(svBitVecVal *status /* bit [7:0] */,
 
 int OtbnModel::send_err_escalation(svBitVecVal *err_val /* bit [31:0] */,
                                    svBit lock_immediately) {
-  ISSWrapper *iss = ensure_wrapper();
+  OtbnIss *iss = ensure_wrapper();
   if (!iss)
     return -1;
 
@@ -639,7 +692,7 @@ int OtbnModel::send_err_escalation(svBitVecVal *err_val /* bit [31:0] */,
 }
 
 int OtbnModel::set_rma_req(svBitVecVal *rma_req /* bit [3:0] */) {
-  ISSWrapper *iss = ensure_wrapper();
+  OtbnIss *iss = ensure_wrapper();
   if (!iss)
     return -1;
 
@@ -654,14 +707,55 @@ int OtbnModel::set_rma_req(svBitVecVal *rma_req /* bit [3:0] */) {
 }
 
 bool OtbnModel::is_at_start_of_wipe() const {
-  ISSWrapper *iss = iss_.get();
+  OtbnIss *iss = this->iss();
   return iss && iss->get_mirrored().wipe_start;
 }
 
-ISSWrapper *OtbnModel::ensure_wrapper() {
+int OtbnModel::use_native_iss() {
+  if (iss()) {
+    std::cerr << "Cannot switch OTBN model to the native ISS: an ISS has "
+                 "already started.\n";
+    return -1;
+  }
+
+  use_native_iss_ = true;
+  return 0;
+}
+
+int OtbnModel::use_auto_loop_warps() {
+  if (!use_native_iss_) {
+    std::cerr << "Cannot enable automatic loop warps for the OTBN model: "
+                 "they need the native ISS.\n";
+    return -1;
+  }
+
+  auto_loop_warps_ = true;
+  if (native_iss_)
+    native_iss_->set_auto_loop_warps(true);
+  return 0;
+}
+
+bool OtbnModel::get_auto_loop_warp(uint32_t addr, uint32_t from_cnt,
+                                   uint32_t *to_cnt) const {
+  if (!auto_loop_warps_ || !native_iss_)
+    return false;
+  return native_iss_->get_auto_loop_warp(addr, from_cnt, to_cnt);
+}
+
+OtbnIss *OtbnModel::ensure_wrapper() {
+  if (use_native_iss_) {
+    if (!native_iss_) {
+      uint32_t imem_bytes = mem_util_.GetMemArea(true).GetSizeBytes();
+      uint32_t dmem_bytes = mem_util_.GetMemArea(false).GetSizeBytes();
+      native_iss_.reset(new OtbnNativeIss(imem_bytes, dmem_bytes));
+      native_iss_->set_auto_loop_warps(auto_loop_warps_);
+    }
+    return native_iss_.get();
+  }
+
   if (!iss_) {
     try {
-      iss_.reset(new ISSWrapper());
+      iss_ = ISSWrapperPool::get().acquire();
     } catch (const std::runtime_error &err) {
       std::cerr << "Error when constructing ISS wrapper: " << err.what()
                 << "\n";
@@ -672,6 +766,12 @@ ISSWrapper *OtbnModel::ensure_wrapper() {
   return iss_.get();
 }
 
+OtbnIss *OtbnModel::iss() const {
+  if (native_iss_)
+    return native_iss_.get();
+  return iss_.get();
+}
+
 Ecc32MemArea::EccWords OtbnModel::get_sim_memory(bool is_imem) const {
   auto &mem_area = mem_util_.GetMemArea(is_imem);
   return mem_area.ReadWithIntegrity(0, mem_area.GetSizeWords());
@@ -682,29 +782,58 @@ void OtbnModel::set_sim_memory(bool is_imem,
   mem_util_.GetMemArea(is_imem).WriteWithIntegrity(0, words);
 }
 
-bool OtbnModel::check_dmem(ISSWrapper &iss) const {
+bool OtbnModel::check_dmem(OtbnIss &iss) const {
   const MemArea &dmem = mem_util_.GetMemArea(false);
   uint32_t dmem_bytes = dmem.GetSizeBytes();
 
-  std::string dfname(iss.make_tmp_path("dmem_out"));
-
-  iss.dump_d(dfname);
-  Ecc32MemArea::EccWords iss_words =
-      read_words_from_file(dfname, dmem_bytes / 4);
-  assert(iss_words.size() == dmem_bytes / 4);
+  const uint8_t *buf = iss.get_shared_buf(kIssWordBytes * (dmem_bytes / 4));
+
+  // The ISS's DMEM was loaded from the RTL's at the start of the operation, so
+  // we normally only need to compare the words that the ISS has written since
+  // then. A write by the RTL to any other word is only spotted by a full check,
+  // which compares everything.
+  std::vector<std::pair<uint32_t, uint32_t>> ranges;
+  ++dmem_checks_since_full_;
+  if (full_dmem_check_interval_ &&
+      dmem_checks_since_full_ >= full_dmem_check_interval_) {
+    dmem_checks_since_full_ = 0;
+    iss.dump_d_shared();
+    ranges.push_back(std::make_pair(0, dmem_bytes / 4));
+  } else {
+    ranges = iss.dump_d_dirty_shared();
+  }
 
-  Ecc32MemArea::EccWords rtl_words = get_sim_memory(false);
-  assert(rtl_words.size() == dmem_bytes / 4);
+  const auto &mem_area = mem_util_.GetMemArea(false);
 
   std::ios old_state(nullptr);
   old_state.copyfmt(std::cerr);
 
   int bad_count = 0;
-  for (size_t i = 0; i < dmem_bytes / 4; ++i) {
-    bool iss_valid = iss_words[i].first;
-    bool rtl_valid = rtl_words[i].first;
-    uint32_t iss_w32 = iss_words[i].second;
-    uint32_t rtl_w32 = rtl_words[i].second;
+  for (const auto &range : ranges) {
+    if (!check_dmem_range(buf, mem_area, range.first, range.second,
+                          &bad_count))
+      break;
+  }
+  std::cerr.copyfmt(old_state);
+  return bad_count == 0;
+}
+
+bool OtbnModel::check_dmem_range(const uint8_t *buf,
+                                 const Ecc32MemArea &mem_area, uint32_t start,
+                                 uint32_t count, int *bad_count) {
+  Ecc32MemArea::EccWords iss_words =
+      read_words_from_buf(buf + kIssWordBytes * start, count);
+  assert(iss_words.size() == count);
+
+  Ecc32MemArea::EccWords rtl_words = mem_area.ReadWithIntegrity(start, count);
+  assert(rtl_words.size() == count);
+
+  for (size_t j = 0; j < count; ++j) {
+    size_t i = start + j;
+    bool iss_valid = iss_words[j].first;
+    bool rtl_valid = rtl_words[j].first;
+    uint32_t iss_w32 = iss_words[j].second;
+    uint32_t rtl_w32 = rtl_words[j].second;
 
     // If neither word has valid checksum bits, all is well.
     if (!iss_valid && !rtl_valid)
@@ -724,7 +853,7 @@ bool OtbnModel::check_dmem(ISSWrapper &iss) const {
 
     // Otherwise, something has gone wrong. Print out a banner if this is the
     // first mismatch.
-    if (bad_count == 0) {
+    if (*bad_count == 0) {
       std::cerr << "ERROR: Mismatches in dmem data:\n"
                 << std::hex << std::setfill('0');
     }
@@ -738,17 +867,16 @@ bool OtbnModel::check_dmem(ISSWrapper &iss) const {
       std::cerr << "rtl has 0x" << std::setw(8) << rtl_w32 << "; iss has 0x"
                 << std::setw(8) << iss_w32 << "\n";
     }
-    ++bad_count;
-    if (bad_count == 10) {
+    ++*bad_count;
+    if (*bad_count == 10) {
       std::cerr << " (skipping further errors...)\n";
-      break;
+      return false;
     }
   }
-  std::cerr.copyfmt(old_state);
-  return bad_count == 0;
+  return true;
 }
 
-bool OtbnModel::check_regs(ISSWrapper &iss) const {
+bool OtbnModel::check_regs(OtbnIss &iss) const {
   std::string base_scope =
       design_scope_ +
       ".u_otbn_rf_base.gen_rf_base_ff.u_otbn_rf_base_inner.u_snooper";
@@ -757,10 +885,10 @@ bool OtbnModel::check_regs(ISSWrapper &iss) const {
       ".u_otbn_rf_bignum.gen_rf_bignum_ff.u_otbn_rf_bignum_inner.u_snooper";
 
   auto rtl_gprs = get_rtl_regs<uint32_t>(base_scope);
-  auto rtl_wdrs = get_rtl_regs<ISSWrapper::u256_t>(wide_scope);
+  auto rtl_wdrs = get_rtl_regs<OtbnIss::u256_t>(wide_scope);
 
   std::array<uint32_t, 32> iss_gprs;
-  std::array<ISSWrapper::u256_t, 32> iss_wdrs;
+  std::array<OtbnIss::u256_t, 32> iss_wdrs;
   iss.get_regs(&iss_gprs, &iss_wdrs);
 
   bool good = true;
@@ -807,7 +935,7 @@ bool OtbnModel::check_regs(ISSWrapper &iss) const {
   return good;
 }
 
-bool OtbnModel::check_call_stack(ISSWrapper &iss) const {
+bool OtbnModel::check_call_stack(OtbnIss &iss) const {
   std::string call_stack_snooper_scope =
       design_scope_ + ".u_otbn_rf_base.u_call_stack_snooper";
 
@@ -844,7 +972,7 @@ bool OtbnModel::check_call_stack(ISSWrapper &iss) const {
 }
 
 int OtbnModel::initial_secure_wipe() {
-  ISSWrapper *iss = ensure_wrapper();
+  OtbnIss *iss = ensure_wrapper();
   if (!iss)
     return -1;
 
@@ -860,6 +988,11 @@ OtbnModel *otbn_model_init(const char *mem_scope, const char *design_scope) {
 
 void otbn_model_destroy(OtbnModel *model) { delete model; }
 
+void otbn_model_set_iss_pool_size(int size) {
+  assert(size >= 0);
+  ISSWrapperPool::get().set_size(size);
+}
+
 void otbn_take_loop_warps(OtbnModel *model, OtbnMemUtil *memutil) {
   assert(model && memutil);
   model->take_loop_warps(*memutil);
@@ -888,6 +1021,19 @@ int otbn_model_edn_urnd_step(OtbnModel *model,
   return model->edn_urnd_step(edn_urnd_data);
 }
 
+int otbn_model_edn_rnd_step256(OtbnModel *model,
+                               svLogicVecVal *edn_rnd_data /* logic [255:0] */,
+                               svBitVecVal *fips_errs /* bit [7:0] */) {
+  assert(model && edn_rnd_data && fips_errs);
+  return model->edn_rnd_step256(edn_rnd_data, fips_errs);
+}
+
+int otbn_model_edn_urnd_step256(
+    OtbnModel *model, svLogicVecVal *edn_urnd_data /* logic [255:0] */) {
+  assert(model && edn_urnd_data);
+  return model->edn_urnd_step256(edn_urnd_data);
+}
+
 int otbn_model_rnd_cdc_done(OtbnModel *model) {
   assert(model);
   return model->edn_rnd_cdc_done();
@@ -909,6 +1055,9 @@ int otbn_model_set_keymgr_value(OtbnModel *model, svLogicVecVal *key0,
   return model->set_keymgr_value(key0, key1, valid);
 }
 
+static dpi_profile_counter step_prof =
+    DPI_PROFILE_COUNTER_INIT("otbn_model.step");
+
 unsigned otbn_model_step(OtbnModel *model, unsigned model_state,
                          svBitVecVal *cmd /* bit [7:0] */,
                          svBitVecVal *status /* bit [7:0] */,
@@ -958,7 +1107,10 @@ unsigned otbn_model_step(OtbnModel *model, unsigned model_state,
   }
 
   // Step the model once
-  switch (model->step(status, insn_cnt, rnd_req, err_bits, stop_pc)) {
+  uint64_t prof_start = dpi_profile_begin();
+  int step_result = model->step(status, insn_cnt, rnd_req, err_bits, stop_pc);
+  dpi_profile_end(&step_prof, prof_start);
+  switch (step_result) {
     case 0:
       // Still running: no change
       break;
@@ -1039,12 +1191,28 @@ int otbn_disable_stack_check(OtbnModel *model) {
   return model->disable_stack_check();
 }
 
+int otbn_set_full_dmem_check_interval(OtbnModel *model, int interval) {
+  assert(model && interval >= 0);
+  return model->set_full_dmem_check_interval(interval);
+}
+
+int otbn_model_use_native_iss(OtbnModel *model) {
+  assert(model);
+  return model->use_native_iss();
+}
+
 int otbn_model_step_crc(OtbnModel *model, svBitVecVal *item /* bit [47:0] */,
                         svBitVecVal *state /* inout bit [31:0] */) {
   assert(model && item && state);
   return model->step_crc(item, state);
 }
 
+int otbn_model_step_crc_block(OtbnModel *model, const svOpenArrayHandle items,
+                              svBitVecVal *state /* inout bit [31:0] */) {
+  assert(model && items && state);
+  return model->step_crc_block(items, state);
+}
+
 int otbn_model_reset(OtbnModel *model, svBitVecVal *status /* bit [7:0] */,
                      svBitVecVal *insn_cnt /* bit [31:0] */,
                      svBitVecVal *rnd_req /* bit [0:0] */,
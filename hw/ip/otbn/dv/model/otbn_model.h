@@ -12,6 +12,8 @@
 
 #include "otbn_memutil.h"
 
+class OtbnIss;
+class OtbnNativeIss;
 struct ISSWrapper;
 
 class OtbnModel {
@@ -45,6 +47,16 @@ class OtbnModel {
   // Send ISS some URND data from EDN. Returns 0 on success or -1 on error.
   int edn_urnd_step(svLogicVecVal *edn_urnd_data /* logic [31:0] */);
 
+  // Send ISS a whole 256-bit RND value from EDN, as if by 8 calls to
+  // edn_rnd_step starting with the least significant word. Bit i of fips_errs
+  // is the FIPS error flag for word i. Returns 0 on success or -1 on error.
+  int edn_rnd_step256(svLogicVecVal *edn_rnd_data /* logic [255:0] */,
+                      const svBitVecVal *fips_errs /* bit [7:0] */);
+
+  // Send ISS a whole 256-bit URND seed from EDN, as if by 8 calls to
+  // edn_urnd_step. Returns 0 on success or -1 on error.
+  int edn_urnd_step256(svLogicVecVal *edn_urnd_data /* logic [255:0] */);
+
   // Signal that RTL is finished processing RND data from EDN. Returns 0 on
   // success or -1 on error.
   int edn_rnd_cdc_done();
@@ -105,6 +117,11 @@ class OtbnModel {
   int step_crc(const svBitVecVal *item /* bit [47:0] */,
                svBitVecVal *state /* bit [31:0] */);
 
+  // Step CRC by consuming each item of an open array of bit [47:0] in turn,
+  // with a single call to the ISS. Returns 0 on success; -1 on failure.
+  int step_crc_block(const svOpenArrayHandle items,
+                     svBitVecVal *state /* bit [31:0] */);
+
   // Flush any information in the model. Returns 0 on success or -1 on error.
   int reset(svBitVecVal *status /* bit [7:0] */,
             svBitVecVal *insn_cnt /* bit [31:0] */,
@@ -129,12 +146,41 @@ class OtbnModel {
   // Disable stack integrity checks
   int disable_stack_check();
 
+  // Set how often check_dmem compares all of DMEM. Other checks only compare
+  // the words that the ISS wrote during the operation, so they don't see a
+  // stray write by the RTL to any other word. The default is one, where every
+  // check is a full check. If interval is zero, there are no full checks.
+  int set_full_dmem_check_interval(uint32_t interval);
+
+  // Use an in-process OtbnNativeIss instead of the Python ISS. This is
+  // much faster, but the native ISS doesn't generate a trace, so there is no
+  // cycle-by-cycle comparison with the RTL (the checks at the end of an
+  // operation still run). Must be called before the model first needs an
+  // ISS. Returns 0 on success; -1 on failure.
+  int use_native_iss();
+
+  // Let the native ISS skip loop iterations that it finds can't change any
+  // state (see OtbnNativeIss::set_auto_loop_warps). This changes the timing of
+  // an operation, so whatever drives the RTL must apply the same warps, using
+  // get_auto_loop_warp. Must be called after use_native_iss(). Returns 0 on
+  // success; -1 on failure.
+  int use_auto_loop_warps();
+
+  // If automatic loop warps are enabled and the ISS has found one for the
+  // instruction at addr with innermost loop count from_cnt, write the new
+  // count to *to_cnt and return true. Otherwise, return false.
+  bool get_auto_loop_warp(uint32_t addr, uint32_t from_cnt,
+                          uint32_t *to_cnt) const;
+
  private:
   // Constructs an ISS wrapper if necessary. If something goes wrong, this
   // function prints a message and then returns null. If ensure is true, it
   // will never return null without printing a message, so error handling at
   // the callsite can silently return a failure code.
-  ISSWrapper *ensure_wrapper();
+  OtbnIss *ensure_wrapper();
+
+  // The ISS that is currently in use, or null if we haven't started one.
+  OtbnIss *iss() const;
 
   // Read the contents of the ISS's memory
   Ecc32MemArea::EccWords get_sim_memory(bool is_imem) const;
@@ -145,28 +191,53 @@ class OtbnModel {
   // Grab contents of dmem from the model and compare them with the RTL. Prints
   // messages to stderr on failure or mismatch. Returns true on success; false
   // on mismatch. Throws a std::runtime_error on failure.
-  bool check_dmem(ISSWrapper &iss) const;
+  //
+  // Unless this is a full check (see set_full_dmem_check_interval), only the
+  // words written by the ISS since DMEM was loaded are compared.
+  bool check_dmem(OtbnIss &iss) const;
+
+  // Compare count words of dmem, starting at word start, between buf (which
+  // holds the ISS's view in the format used by the ISS's memory dumps) and
+  // mem_area. Increments *bad_count and prints a message for each mismatch.
+  // Returns false if we've printed enough errors and should stop.
+  static bool check_dmem_range(const uint8_t *buf,
+                               const Ecc32MemArea &mem_area, uint32_t start,
+                               uint32_t count, int *bad_count);
 
   // Compare contents of ISS registers with those from the design. Prints
   // messages to stderr on failure or mismatch. Returns true on success; false
   // on mismatch. Throws a std::runtime_error on failure.
-  bool check_regs(ISSWrapper &iss) const;
+  bool check_regs(OtbnIss &iss) const;
 
   // Compare contents of ISS call stack with those from the design. Prints
   // messages to stderr on failure or mismatch. Returns true on success; false
   // on mismatch. Throws a std::runtime_error on failure.
-  bool check_call_stack(ISSWrapper &iss) const;
+  bool check_call_stack(OtbnIss &iss) const;
 
   // We want to create the model in an initial block in the SystemVerilog
   // simulation, but might not actually want to spawn the ISS. To handle that
   // in a non-racy way, the most convenient thing is to spawn the ISS the first
-  // time it's actually needed. Use ensure_wrapper() to create as needed.
+  // time it's actually needed. Use ensure_wrapper() to create as needed. The
+  // wrapper comes from ISSWrapperPool and is returned there on destruction.
   std::unique_ptr<ISSWrapper> iss_;
 
+  // If use_native_iss_ is true, ensure_wrapper() constructs native_iss_
+  // instead of taking a wrapper from the pool (see use_native_iss()).
+  bool use_native_iss_ = false;
+  std::unique_ptr<OtbnNativeIss> native_iss_;
+
+  // Passed to native_iss_ when it is constructed
+  bool auto_loop_warps_ = false;
+
   OtbnMemUtil mem_util_;
   std::string design_scope_;
 
   bool stack_check_enabled_ = true;
+
+  // See set_full_dmem_check_interval. The count is of DMEM checks since the
+  // last full check.
+  uint32_t full_dmem_check_interval_ = 1;
+  mutable uint32_t dmem_checks_since_full_ = 0;
 };
 
 #endif  // OPENTITAN_HW_IP_OTBN_DV_MODEL_OTBN_MODEL_H_
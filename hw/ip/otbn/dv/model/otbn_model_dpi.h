@@ -21,6 +21,11 @@ OtbnModel *otbn_model_init(const char *mem_scope, const char *design_scope);
 // Delete an OtbnModel
 void otbn_model_destroy(OtbnModel *model);
 
+// Set the number of idle ISS processes that are kept running, ready to be used
+// by the next OtbnModel that needs one (see ISSWrapperPool). This is shared by
+// all OtbnModel objects.
+void otbn_model_set_iss_pool_size(int size);
+
 // Take loop warps from an OtbnMemUtil
 void otbn_take_loop_warps(OtbnModel *model, OtbnMemUtil *memutil);
 
@@ -40,6 +45,17 @@ int otbn_model_edn_rnd_step(OtbnModel *model,
 int otbn_model_edn_urnd_step(OtbnModel *model,
                              svLogicVecVal *edn_urnd_data /* logic [31:0] */);
 
+// Call edn_rnd_step256 function of OtbnModel to pass a whole 256-bit RND
+// value. Returns 0 on success; -1 on error.
+int otbn_model_edn_rnd_step256(OtbnModel *model,
+                               svLogicVecVal *edn_rnd_data /* logic [255:0] */,
+                               svBitVecVal *fips_errs /* bit [7:0] */);
+
+// Call edn_urnd_step256 function of OtbnModel to pass a whole 256-bit URND
+// seed. Returns 0 on success; -1 on error.
+int otbn_model_edn_urnd_step256(
+    OtbnModel *model, svLogicVecVal *edn_urnd_data /* logic [255:0] */);
+
 // Signal RTL is finished processing RND data to Model. Returns 0 on success;
 // -1 on error.
 int otbn_model_rnd_cdc_done(OtbnModel *model);
@@ -119,6 +135,17 @@ int otbn_set_no_sec_wipe_chk(OtbnModel *model);
 // Disable stack integrity checks
 int otbn_disable_stack_check(OtbnModel *model);
 
+// Set how often the model compares all of DMEM with the RTL at the end of an
+// operation, rather than just the words that it wrote. The default is one (a
+// full check every time). Zero means never, which misses RTL writes to words
+// that the model didn't write.
+int otbn_set_full_dmem_check_interval(OtbnModel *model, int interval);
+
+// Use the in-process native ISS rather than the Python one. This must be
+// called before the model starts an ISS. Returns 0 on success or -1 on
+// failure.
+int otbn_model_use_native_iss(OtbnModel *model);
+
 // Step the CRC calculation for item
 //
 // state is an inout parameter and should be updated in-place. This is
@@ -127,6 +154,12 @@ int otbn_disable_stack_check(OtbnModel *model);
 int otbn_model_step_crc(OtbnModel *model, svBitVecVal *item /* bit [47:0] */,
                         svBitVecVal *state /* inout bit [31:0] */);
 
+// Step the CRC calculation for each item of items (an open array of
+// bit [47:0]) in turn. Like otbn_model_step_crc, but with a single call to the
+// ISS. Returns 0 on success or -1 on failure.
+int otbn_model_step_crc_block(OtbnModel *model, const svOpenArrayHandle items,
+                              svBitVecVal *state /* inout bit [31:0] */);
+
 // Flush any information in the model. Returns 0 on success; -1 on error.
 int otbn_model_reset(OtbnModel *model, svBitVecVal *status /* bit [7:0] */,
                      svBitVecVal *insn_cnt /* bit [31:0] */,
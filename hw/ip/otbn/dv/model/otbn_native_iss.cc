@@ -0,0 +1,2896 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "otbn_native_iss.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+
+// This file is a port of the Python ISS in hw/ip/otbn/dv/otbnsim/sim. The
+// structure follows that of sim.py (stepping the processor FSM) and state.py
+// (the architectural state), so that a change to one can be mirrored in the
+// other. Where a Python instruction is a generator that yields for a stall
+// cycle, the C++ version keeps a phase counter: phase 0 is the code before the
+// first yield, phase 1 the code after it, and so on.
+
+namespace {
+
+// Bits in the ERR_BITS register (ErrBits in otbnsim/sim/constants.py)
+const uint32_t kErrBadDataAddr = 1 << 0;
+const uint32_t kErrBadInsnAddr = 1 << 1;
+const uint32_t kErrCallStack = 1 << 2;
+const uint32_t kErrIllegalInsn = 1 << 3;
+const uint32_t kErrLoop = 1 << 4;
+const uint32_t kErrKeyInvalid = 1 << 5;
+const uint32_t kErrRndRepChkFail = 1 << 6;
+const uint32_t kErrRndFipsChkFail = 1 << 7;
+const uint32_t kErrImemIntgViolation = 1 << 16;
+const uint32_t kErrDmemIntgViolation = 1 << 17;
+
+// Values of the STATUS register
+const uint32_t kStatusIdle = 0x00;
+const uint32_t kStatusBusyExecute = 0x01;
+const uint32_t kStatusBusySecWipeDmem = 0x02;
+const uint32_t kStatusBusySecWipeImem = 0x03;
+const uint32_t kStatusBusySecWipeInt = 0x04;
+const uint32_t kStatusLocked = 0xff;
+
+// The number of cycles that a round of the internal secure wipe takes
+const int kWipeCycles = 68;
+
+// The maximum number of cycles between an EDN client getting all its data and
+// the CDC completing (MAX_CDC_WAIT in otbnsim/sim/edn_client.py)
+const int kMaxCdcWait = 5;
+
+enum FsmState {
+  kFsmPreWipe,
+  kFsmWiping,
+  kFsmIdle,
+  kFsmPreExec,
+  kFsmExec,
+  kFsmMemSecWipe,
+  kFsmLocked
+};
+
+enum InitSecWipeState {
+  kInitSecWipeNotDone,
+  kInitSecWipeInProgress,
+  kInitSecWipeDone
+};
+
+// An interpretation of a multi-bit lc_tx_t signal
+enum LcTx { kLcTxInvalid, kLcTxOn, kLcTxOff };
+
+// A 256-bit unsigned integer as four 64-bit limbs, LSB first
+struct U256 {
+  uint64_t w[4];
+};
+
+U256 u256_zero() {
+  U256 ret = {{0, 0, 0, 0}};
+  return ret;
+}
+
+bool u256_is_zero(const U256 &a) {
+  return (a.w[0] | a.w[1] | a.w[2] | a.w[3]) == 0;
+}
+
+bool u256_eq(const U256 &a, const U256 &b) {
+  return a.w[0] == b.w[0] && a.w[1] == b.w[1] && a.w[2] == b.w[2] &&
+         a.w[3] == b.w[3];
+}
+
+bool u256_bit(const U256 &a, unsigned idx) {
+  return (a.w[idx / 64] >> (idx % 64)) & 1;
+}
+
+uint32_t u256_word(const U256 &a, unsigned idx) {
+  return (uint32_t)(a.w[idx / 2] >> (32 * (idx % 2)));
+}
+
+void u256_set_word(U256 *a, unsigned idx, uint32_t value) {
+  unsigned shift = 32 * (idx % 2);
+  a->w[idx / 2] = (a->w[idx / 2] & ~((uint64_t)0xffffffff << shift)) |
+                  ((uint64_t)value << shift);
+}
+
+bool u256_ge(const U256 &a, const U256 &b) {
+  for (int i = 3; i >= 0; --i) {
+    if (a.w[i] != b.w[i])
+      return a.w[i] > b.w[i];
+  }
+  return true;
+}
+
+U256 u256_and(const U256 &a, const U256 &b) {
+  U256 ret;
+  for (int i = 0; i < 4; ++i)
+    ret.w[i] = a.w[i] & b.w[i];
+  return ret;
+}
+
+U256 u256_or(const U256 &a, const U256 &b) {
+  U256 ret;
+  for (int i = 0; i < 4; ++i)
+    ret.w[i] = a.w[i] | b.w[i];
+  return ret;
+}
+
+U256 u256_xor(const U256 &a, const U256 &b) {
+  U256 ret;
+  for (int i = 0; i < 4; ++i)
+    ret.w[i] = a.w[i] ^ b.w[i];
+  return ret;
+}
+
+U256 u256_not(const U256 &a) {
+  U256 ret;
+  for (int i = 0; i < 4; ++i)
+    ret.w[i] = ~a.w[i];
+  return ret;
+}
+
+// Set *res = a + b + carry_in (truncated to 256 bits), returning bit 256 of
+// the full result.
+bool u256_add(const U256 &a, const U256 &b, bool carry_in, U256 *res) {
+  unsigned __int128 acc = carry_in;
+  for (int i = 0; i < 4; ++i) {
+    acc += (unsigned __int128)a.w[i] + b.w[i];
+    res->w[i] = (uint64_t)acc;
+    acc >>= 64;
+  }
+  return acc != 0;
+}
+
+// Set *res = a - b - borrow_in (truncated to 256 bits), returning bit 256 of
+// the full (two's complement) result.
+bool u256_sub(const U256 &a, const U256 &b, bool borrow_in, U256 *res) {
+  uint64_t borrow = borrow_in;
+  for (int i = 0; i < 4; ++i) {
+    uint64_t diff = a.w[i] - b.w[i];
+    bool next_borrow = (a.w[i] < b.w[i]) || (diff < borrow);
+    res->w[i] = diff - borrow;
+    borrow = next_borrow;
+  }
+  return borrow != 0;
+}
+
+// Shift the 512-bit value {hi, lo} right by shift bits (0 <= shift < 512) and
+// return the bottom 256 bits.
+U256 u512_shr(const U256 &hi, const U256 &lo, unsigned shift) {
+  uint64_t limbs[8];
+  for (int i = 0; i < 4; ++i) {
+    limbs[i] = lo.w[i];
+    limbs[4 + i] = hi.w[i];
+  }
+  unsigned limb_shift = shift / 64, bit_shift = shift % 64;
+  U256 ret;
+  for (unsigned i = 0; i < 4; ++i) {
+    unsigned src = i + limb_shift;
+    uint64_t low = src < 8 ? limbs[src] : 0;
+    uint64_t high = src + 1 < 8 ? limbs[src + 1] : 0;
+    ret.w[i] = bit_shift ? (low >> bit_shift) | (high << (64 - bit_shift))
+                         : low;
+  }
+  return ret;
+}
+
+U256 u256_shr(const U256 &a, unsigned shift) {
+  return u512_shr(u256_zero(), a, shift);
+}
+
+U256 u256_shl(const U256 &a, unsigned shift) {
+  if (shift == 0)
+    return a;
+  return u512_shr(a, u256_zero(), 256 - shift);
+}
+
+// A port of logical_byte_shift in otbnsim/sim/insn.py. shift_type is 0 for a
+// left shift and 1 for a right shift.
+U256 logical_byte_shift(const U256 &value, unsigned shift_type,
+                        unsigned shift_bytes) {
+  unsigned shift = 8 * shift_bytes;
+  return shift_type ? u256_shr(value, shift) : u256_shl(value, shift);
+}
+
+U256 u256_from_words(const uint32_t *words) {
+  U256 ret;
+  for (int i = 0; i < 4; ++i)
+    ret.w[i] = words[2 * i] | ((uint64_t)words[2 * i + 1] << 32);
+  return ret;
+}
+
+// Flags are stored as a nibble, in the same layout as FlagReg in
+// otbnsim/sim/flags.py
+const uint8_t kFlagC = 1 << 0;
+const uint8_t kFlagM = 1 << 1;
+const uint8_t kFlagL = 1 << 2;
+const uint8_t kFlagZ = 1 << 3;
+
+uint8_t mlz_for_result(bool carry, const U256 &result) {
+  return (carry ? kFlagC : 0) | (u256_bit(result, 255) ? kFlagM : 0) |
+         (u256_bit(result, 0) ? kFlagL : 0) |
+         (u256_is_zero(result) ? kFlagZ : 0);
+}
+
+// A register that is visible to the host (OTBNExtRegs in
+// otbnsim/sim/ext_regs.py), tracking the change that the ISS would report to
+// OtbnModel.
+//
+// A double-flopped register reports a write one cycle after it happens.
+struct ExtReg {
+  ExtReg(uint32_t mask, uint32_t reset_val, bool double_flopped)
+      : mask(mask),
+        value(reset_val),
+        next(reset_val),
+        double_flopped(double_flopped),
+        changed(false),
+        change(0),
+        next_changed(false),
+        next_change(0) {}
+
+  uint32_t read() const { return value; }
+
+  void write(uint32_t new_val, bool immediately = false) {
+    next = new_val & mask;
+    if (double_flopped && !immediately) {
+      next_changed = true;
+      next_change = next;
+    } else {
+      changed = true;
+      change = next;
+    }
+  }
+
+  void commit() {
+    value = next;
+    changed = next_changed;
+    change = next_change;
+    next_changed = false;
+  }
+
+  void abort() {
+    next = value;
+    changed = false;
+    next_changed = false;
+  }
+
+  uint32_t mask;
+  uint32_t value;
+  uint32_t next;
+  bool double_flopped;
+
+  // The change to report for this cycle and (for a double-flopped register)
+  // the next one.
+  bool changed;
+  uint32_t change;
+  bool next_changed;
+  uint32_t next_change;
+};
+
+// The result of an EdnClient::cdc_complete() call
+struct EdnResult {
+  bool has_data;
+  U256 data;
+  bool retry;
+  bool fips_err;
+  bool rep_err;
+};
+
+// A port of EdnClient in otbnsim/sim/edn_client.py
+class EdnClient {
+ public:
+  EdnClient() { edn_reset(); }
+
+  void request() {
+    if (!active_) {
+      active_ = true;
+      acc_.clear();
+    } else if (poisoned_) {
+      retry_ = true;
+    }
+  }
+
+  void poison() {
+    if (active_) {
+      poisoned_ = true;
+      retry_ = false;
+      fips_err_ = false;
+      rep_err_ = false;
+    }
+  }
+
+  void forget() { retry_ = false; }
+
+  void edn_reset() {
+    active_ = false;
+    acc_.clear();
+    cdc_counter_ = -1;
+    poisoned_ = false;
+    retry_ = false;
+    fips_err_ = false;
+    rep_err_ = false;
+    has_last_word_ = false;
+    last_word_ = 0;
+  }
+
+  void take_word(uint32_t word, bool fips_err) {
+    if (!active_)
+      return;
+
+    if (acc_.size() >= 8 || cdc_counter_ >= 0)
+      throw std::runtime_error("EDN client got too many words.");
+
+    fips_err_ |= fips_err;
+    rep_err_ |= has_last_word_ && last_word_ == word;
+    acc_.push_back(word);
+    has_last_word_ = true;
+    last_word_ = word;
+
+    if (acc_.size() == 8)
+      cdc_counter_ = 0;
+  }
+
+  void step() {
+    if (cdc_counter_ >= 0) {
+      ++cdc_counter_;
+      if (cdc_counter_ > kMaxCdcWait)
+        throw std::runtime_error("EDN CDC took too long to complete.");
+    }
+  }
+
+  EdnResult cdc_complete() {
+    if (!active_ || acc_.size() != 8 || cdc_counter_ < 0)
+      throw std::runtime_error("EDN CDC completed with no data.");
+
+    EdnResult ret;
+    ret.has_data = !poisoned_;
+    ret.data = u256_from_words(acc_.data());
+    ret.retry = retry_;
+    ret.fips_err = fips_err_;
+    ret.rep_err = rep_err_;
+
+    active_ = false;
+    acc_.clear();
+    cdc_counter_ = -1;
+    poisoned_ = false;
+    retry_ = false;
+    fips_err_ = false;
+    rep_err_ = false;
+
+    if (ret.retry)
+      request();
+
+    return ret;
+  }
+
+ private:
+  bool active_;
+  std::vector<uint32_t> acc_;
+  int cdc_counter_;
+  bool poisoned_;
+  bool retry_;
+  bool fips_err_;
+  bool rep_err_;
+  bool has_last_word_;
+  uint32_t last_word_;
+};
+
+enum Op {
+  kOpIllegal,
+  kOpEmpty,
+  kOpAdd,
+  kOpAddi,
+  kOpLui,
+  kOpSub,
+  kOpSll,
+  kOpSlli,
+  kOpSrl,
+  kOpSrli,
+  kOpSra,
+  kOpSrai,
+  kOpAnd,
+  kOpAndi,
+  kOpOr,
+  kOpOri,
+  kOpXor,
+  kOpXori,
+  kOpLw,
+  kOpSw,
+  kOpBeq,
+  kOpBne,
+  kOpJal,
+  kOpJalr,
+  kOpCsrrs,
+  kOpCsrrw,
+  kOpEcall,
+  kOpLoop,
+  kOpLoopi,
+  kOpBnAdd,
+  kOpBnAddc,
+  kOpBnAddi,
+  kOpBnAddm,
+  kOpBnMulqacc,
+  kOpBnMulqaccWo,
+  kOpBnMulqaccSo,
+  kOpBnSub,
+  kOpBnSubb,
+  kOpBnSubi,
+  kOpBnSubm,
+  kOpBnAnd,
+  kOpBnOr,
+  kOpBnNot,
+  kOpBnXor,
+  kOpBnRshi,
+  kOpBnSel,
+  kOpBnCmp,
+  kOpBnCmpb,
+  kOpBnLid,
+  kOpBnSid,
+  kOpBnMov,
+  kOpBnMovr,
+  kOpBnWsrr,
+  kOpBnWsrw
+};
+
+// A decoded instruction. The meaning of the fields depends on op: rd, rs1 and
+// rs2 are the register operands (GPRs or WDRs) in the order they appear in the
+// assembly syntax. imm holds the immediate, CSR/WSR index or bodysize, already
+// sign-extended where appropriate. Branch and jump targets are stored as
+// absolute addresses.
+struct Insn {
+  Op op;
+  uint8_t rd, rs1, rs2;
+  uint8_t fg;
+  uint8_t shift_type, shift_bytes;
+  // For bn.mulqacc*: the quarter-word selectors, shift (in 64-bit units),
+  // zero_acc flag and (for .so) half-word select. For bn.sel: the flag index.
+  uint8_t qs1, qs2, acc_shift, zero_acc, sel;
+  // Increment flags for bn.lid, bn.sid and bn.movr: inc1 is the increment on
+  // the address (or source) register; inc2 the one on the other register.
+  bool inc1, inc2;
+  uint32_t imm;
+  // The iteration count of a loopi
+  uint32_t iterations;
+};
+
+bool affects_control(Op op) {
+  return op == kOpBeq || op == kOpBne || op == kOpJal || op == kOpJalr ||
+         op == kOpLoop || op == kOpLoopi;
+}
+
+bool has_fetch_stall(Op op) {
+  return op == kOpBeq || op == kOpBne || op == kOpJal || op == kOpJalr;
+}
+
+uint32_t bits(uint32_t word, unsigned msb, unsigned lsb) {
+  return (word >> lsb) & ((2u << (msb - lsb)) - 1);
+}
+
+uint32_t sign_extend(uint32_t value, unsigned width) {
+  uint32_t sign = 1u << (width - 1);
+  return (value ^ sign) - sign;
+}
+
+struct Encoding {
+  uint32_t mask, match;
+  Op op;
+};
+
+// The masks and match values of each encoding in data/insns.yml
+const Encoding kEncodings[] = {
+    {0xfe00707f, 0x00000033, kOpAdd},
+    {0xfe00707f, 0x40000033, kOpSub},
+    {0xfe00707f, 0x00001033, kOpSll},
+    {0xfe00707f, 0x00005033, kOpSrl},
+    {0xfe00707f, 0x40005033, kOpSra},
+    {0xfe00707f, 0x00007033, kOpAnd},
+    {0xfe00707f, 0x00006033, kOpOr},
+    {0xfe00707f, 0x00004033, kOpXor},
+    {0xfe00707f, 0x00001013, kOpSlli},
+    {0xfe00707f, 0x00005013, kOpSrli},
+    {0xfe00707f, 0x40005013, kOpSrai},
+    {0x0000707f, 0x00000013, kOpAddi},
+    {0x0000707f, 0x00007013, kOpAndi},
+    {0x0000707f, 0x00006013, kOpOri},
+    {0x0000707f, 0x00004013, kOpXori},
+    {0x0000707f, 0x00002003, kOpLw},
+    {0x0000707f, 0x00002023, kOpSw},
+    {0x0000707f, 0x00000063, kOpBeq},
+    {0x0000707f, 0x00001063, kOpBne},
+    {0x0000707f, 0x00000067, kOpJalr},
+    {0x0000707f, 0x00002073, kOpCsrrs},
+    {0x0000707f, 0x00001073, kOpCsrrw},
+    {0x0000707f, 0x0000007b, kOpLoop},
+    {0x0000707f, 0x0000107b, kOpLoopi},
+    {0x0000007f, 0x00000037, kOpLui},
+    {0x0000007f, 0x0000006f, kOpJal},
+    {0xffffffff, 0x00000073, kOpEcall},
+    {0x0000707f, 0x0000002b, kOpBnAdd},
+    {0x0000707f, 0x0000202b, kOpBnAddc},
+    {0x0000707f, 0x0000102b, kOpBnSub},
+    {0x0000707f, 0x0000302b, kOpBnSubb},
+    {0x4000707f, 0x0000402b, kOpBnAddi},
+    {0x4000707f, 0x4000402b, kOpBnSubi},
+    {0x4000707f, 0x0000502b, kOpBnAddm},
+    {0x4000707f, 0x4000502b, kOpBnSubm},
+    {0x0000707f, 0x0000207b, kOpBnAnd},
+    {0x0000707f, 0x0000407b, kOpBnOr},
+    {0x0000707f, 0x0000607b, kOpBnXor},
+    {0x0000707f, 0x0000507b, kOpBnNot},
+    {0x0000307f, 0x0000307b, kOpBnRshi},
+    {0x6000007f, 0x0000003b, kOpBnMulqacc},
+    {0x6000007f, 0x2000003b, kOpBnMulqaccWo},
+    {0x4000007f, 0x4000003b, kOpBnMulqaccSo},
+    {0x0000707f, 0x0000000b, kOpBnSel},
+    {0x0000707f, 0x0000100b, kOpBnCmp},
+    {0x0000707f, 0x0000300b, kOpBnCmpb},
+    {0x0000707f, 0x0000400b, kOpBnLid},
+    {0x0000707f, 0x0000500b, kOpBnSid},
+    {0x8000707f, 0x0000600b, kOpBnMov},
+    {0x8000707f, 0x8000600b, kOpBnMovr},
+    {0x8000707f, 0x0000700b, kOpBnWsrr},
+    {0x8000707f, 0x8000700b, kOpBnWsrw},
+};
+
+// Decode the instruction word at pc (a port of _decode_word in
+// otbnsim/sim/decode.py)
+Insn decode(uint32_t pc, uint32_t word) {
+  Insn insn;
+  memset(&insn, 0, sizeof(insn));
+  insn.op = kOpIllegal;
+  for (const Encoding &enc : kEncodings) {
+    if ((word & enc.mask) == enc.match) {
+      insn.op = enc.op;
+      break;
+    }
+  }
+
+  uint32_t f_11_7 = bits(word, 11, 7);
+  uint32_t f_19_15 = bits(word, 19, 15);
+  uint32_t f_24_20 = bits(word, 24, 20);
+  uint32_t i_imm = sign_extend(bits(word, 31, 20), 12);
+
+  switch (insn.op) {
+    case kOpIllegal:
+    case kOpEmpty:
+    case kOpEcall:
+      break;
+
+    case kOpAdd:
+    case kOpSub:
+    case kOpSll:
+    case kOpSrl:
+    case kOpSra:
+    case kOpAnd:
+    case kOpOr:
+    case kOpXor:
+      insn.rd = f_11_7;
+      insn.rs1 = f_19_15;
+      insn.rs2 = f_24_20;
+      break;
+
+    case kOpSlli:
+    case kOpSrli:
+    case kOpSrai:
+      insn.rd = f_11_7;
+      insn.rs1 = f_19_15;
+      insn.imm = f_24_20;
+      break;
+
+    case kOpAddi:
+    case kOpAndi:
+    case kOpOri:
+    case kOpXori:
+    case kOpLw:
+    case kOpJalr:
+      insn.rd = f_11_7;
+      insn.rs1 = f_19_15;
+      insn.imm = i_imm;
+      break;
+
+    case kOpLui:
+      insn.rd = f_11_7;
+      insn.imm = word & 0xfffff000;
+      break;
+
+    case kOpSw:
+      insn.rs1 = f_19_15;
+      insn.rs2 = f_24_20;
+      insn.imm = sign_extend((bits(word, 31, 25) << 5) | f_11_7, 12);
+      break;
+
+    case kOpBeq:
+    case kOpBne:
+      insn.rs1 = f_19_15;
+      insn.rs2 = f_24_20;
+      insn.imm = pc + (sign_extend((bits(word, 31, 31) << 11) |
+                                       (bits(word, 7, 7) << 10) |
+                                       (bits(word, 30, 25) << 4) |
+                                       bits(word, 11, 8),
+                                   12)
+                       << 1);
+      break;
+
+    case kOpJal:
+      insn.rd = f_11_7;
+      insn.imm = pc + (sign_extend((bits(word, 31, 31) << 19) |
+                                       (bits(word, 19, 12) << 11) |
+                                       (bits(word, 20, 20) << 10) |
+                                       bits(word, 30, 21),
+                                   20)
+                       << 1);
+      break;
+
+    case kOpCsrrs:
+    case kOpCsrrw:
+      insn.rd = f_11_7;
+      insn.rs1 = f_19_15;
+      insn.imm = bits(word, 31, 20);
+      break;
+
+    case kOpLoop:
+      insn.rs1 = f_19_15;
+      insn.imm = bits(word, 31, 20) + 1;
+      break;
+
+    case kOpLoopi:
+      insn.iterations = (f_19_15 << 5) | f_11_7;
+      insn.imm = bits(word, 31, 20) + 1;
+      break;
+
+    case kOpBnAdd:
+    case kOpBnAddc:
+    case kOpBnSub:
+    case kOpBnSubb:
+    case kOpBnAnd:
+    case kOpBnOr:
+    case kOpBnXor:
+      insn.rd = f_11_7;
+      insn.rs1 = f_19_15;
+      insn.rs2 = f_24_20;
+      insn.shift_type = bits(word, 30, 30);
+      insn.shift_bytes = bits(word, 29, 25);
+      insn.fg = bits(word, 31, 31);
+      break;
+
+    case kOpBnNot:
+      insn.rd = f_11_7;
+      insn.rs1 = f_24_20;
+      insn.shift_type = bits(word, 30, 30);
+      insn.shift_bytes = bits(word, 29, 25);
+      insn.fg = bits(word, 31, 31);
+      break;
+
+    case kOpBnAddi:
+    case kOpBnSubi:
+      insn.rd = f_11_7;
+      insn.rs1 = f_19_15;
+      insn.imm = bits(word, 29, 20);
+      insn.fg = bits(word, 31, 31);
+      break;
+
+    case kOpBnAddm:
+    case kOpBnSubm:
+      insn.rd = f_11_7;
+      insn.rs1 = f_19_15;
+      insn.rs2 = f_24_20;
+      break;
+
+    case kOpBnRshi:
+      insn.rd = f_11_7;
+      insn.rs1 = f_19_15;
+      insn.rs2 = f_24_20;
+      insn.imm = (bits(word, 31, 25) << 1) | bits(word, 14, 14);
+      break;
+
+    case kOpBnMulqacc:
+    case kOpBnMulqaccWo:
+    case kOpBnMulqaccSo:
+      insn.rd = f_11_7;
+      insn.rs1 = f_19_15;
+      insn.rs2 = f_24_20;
+      insn.qs1 = bits(word, 26, 25);
+      insn.qs2 = bits(word, 28, 27);
+      insn.acc_shift = bits(word, 14, 13);
+      insn.zero_acc = bits(word, 12, 12);
+      insn.sel = bits(word, 29, 29);
+      insn.fg = bits(word, 31, 31);
+      break;
+
+    case kOpBnSel:
+      insn.rd = f_11_7;
+      insn.rs1 = f_19_15;
+      insn.rs2 = f_24_20;
+      insn.sel = bits(word, 26, 25);
+      insn.fg = bits(word, 31, 31);
+      break;
+
+    case kOpBnCmp:
+    case kOpBnCmpb:
+      insn.rs1 = f_19_15;
+      insn.rs2 = f_24_20;
+      insn.shift_type = bits(word, 30, 30);
+      insn.shift_bytes = bits(word, 29, 25);
+      insn.fg = bits(word, 31, 31);
+      break;
+
+    case kOpBnLid:
+    case kOpBnSid:
+      // For bn.lid, rd is grd. For bn.sid, rs2 is grs2. The other field is
+      // zero either way.
+      if (insn.op == kOpBnLid)
+        insn.rd = f_24_20;
+      else
+        insn.rs2 = f_24_20;
+      insn.rs1 = f_19_15;
+      insn.imm =
+          sign_extend((bits(word, 11, 9) << 7) | bits(word, 31, 25), 10) << 5;
+      insn.inc1 = bits(word, 8, 8);
+      insn.inc2 = bits(word, 7, 7);
+      break;
+
+    case kOpBnMov:
+      insn.rd = f_11_7;
+      insn.rs1 = f_19_15;
+      break;
+
+    case kOpBnMovr:
+      insn.rd = f_24_20;
+      insn.rs1 = f_19_15;
+      insn.inc1 = bits(word, 9, 9);
+      insn.inc2 = bits(word, 7, 7);
+      break;
+
+    case kOpBnWsrr:
+      insn.rd = f_11_7;
+      insn.imm = bits(word, 27, 20);
+      break;
+
+    case kOpBnWsrw:
+      insn.rs1 = f_19_15;
+      insn.imm = bits(word, 27, 20);
+      break;
+  }
+  return insn;
+}
+
+// Read a 32-bit little-endian word
+uint32_t read_le32(const uint8_t *src) {
+  return src[0] | ((uint32_t)src[1] << 8) | ((uint32_t)src[2] << 16) |
+         ((uint32_t)src[3] << 24);
+}
+
+// Write a word in the 5-byte format used for the shared buffer
+void write_5byte_word(uint8_t *dst, bool vld, uint32_t value) {
+  dst[0] = vld;
+  for (int i = 0; i < 4; ++i)
+    dst[1 + i] = vld ? (uint8_t)(value >> (8 * i)) : 0;
+}
+
+// Rotate n left by d bits (0 < d < 64)
+uint64_t rol64(uint64_t n, unsigned d) { return (n << d) | (n >> (64 - d)); }
+
+struct LoopLevel {
+  uint32_t loop_count;
+  uint32_t restarts_left;
+  uint32_t start_addr;
+  uint32_t last_addr;
+  // The value of NativeSim::state_version when the current iteration started
+  uint64_t iter_start_version;
+  // True if we have found an automatic warp for this loop
+  bool auto_warped;
+};
+
+}  // namespace
+
+// The state of the simulated processor, together with the code that steps
+// it. This corresponds to both OTBNSim and OTBNState in the Python ISS.
+struct NativeSim {
+  NativeSim(uint32_t imem_bytes, uint32_t dmem_bytes);
+
+  // Called at the start of an operation
+  void start();
+  void start_mem_wipe(bool is_imem);
+  void start_init_sec_wipe();
+
+  // Run a single cycle
+  void step();
+
+  void load_program(const uint8_t *buf, size_t num_bytes);
+  void load_data(const uint8_t *buf, size_t num_bytes);
+
+  // Dump DMEM (in the 5-byte format) to the given buffer
+  void dump_data(uint8_t *dst) const;
+  std::vector<std::pair<uint32_t, uint32_t>> dump_dirty_data(
+      uint8_t *dst) const;
+
+  void invalidate_dmem();
+
+  void edn_flush();
+  void rnd_completed();
+  void urnd_completed();
+  void on_otp_cdc_done();
+  void lock_now();
+
+  // Fetch the instruction at pc
+  Insn fetch(uint32_t addr) const;
+
+  // --- Steppers for each FSM state (see OTBNSim in sim.py)
+  void step_idle();
+  void step_ext_wipe();
+  void step_pre_exec();
+  void step_exec();
+  void step_pre_wipe();
+  void step_wiping();
+  void delayed_insn_cnt_zero(int delay_if_locking);
+  void on_stall(bool fetch_next);
+  void on_retire(const Insn &insn);
+
+  // Execute one cycle of insn, returning true if the instruction needs more
+  // cycles (the equivalent of a yield in the Python ISS).
+  bool exec_insn(const Insn &insn);
+
+  // --- State management (see OTBNState in state.py)
+  void set_fsm_state(FsmState new_state);
+  void stop_at_end_of_cycle(uint32_t err_bits);
+  bool stop_if_pending_halt();
+  void stop();
+  void take_injected_err_bits();
+  void abort();
+  void commit(bool sim_stalled);
+  void changes();
+  void pre_insn(bool insn_affects_control);
+  void post_insn();
+  void wipe();
+  bool is_pc_valid(uint32_t pc) const;
+  void set_next_pc(uint32_t next_pc);
+  bool init_sec_wipe_is_running() const {
+    return init_sec_wipe_state == kInitSecWipeInProgress;
+  }
+
+  // --- GPRs
+  uint32_t read_gpr(unsigned idx);
+  void write_gpr(unsigned idx, uint32_t value);
+
+  // --- WDRs
+  void write_wdr(unsigned idx, const U256 &value);
+
+  // --- Flags
+  uint8_t read_flags() const { return flags[0] | (flags[1] << 4); }
+  void write_flags(uint8_t value);
+  void set_flags(unsigned fg, uint8_t value);
+
+  // --- CSRs and WSRs
+  bool csr_valid(uint32_t idx) const;
+  uint32_t read_csr(uint32_t idx);
+  void write_csr(uint32_t idx, uint32_t value);
+  bool rnd_request_value();
+  U256 rnd_read();
+  U256 read_key(unsigned idx) const;
+  void urnd_set_seed(const uint64_t seed[4]);
+  void urnd_step();
+
+  // --- DMEM
+  bool valid_32b_addr(uint32_t addr) const;
+  bool valid_256b_addr(uint32_t addr) const;
+  bool load_u32(uint32_t addr, uint32_t *value) const;
+  bool load_u256(uint32_t addr, U256 *value) const;
+  void store_u32(uint32_t addr, uint32_t value);
+
+  // --- Loop stack
+  void loop_start(uint32_t iterations, uint32_t bodysize);
+  void loop_step();
+  void loop_iter_done();
+
+  // --- External registers
+  void increment_insn_cnt();
+  void rnd_request();
+  void rnd_forget();
+
+  uint32_t imem_size;
+
+  std::vector<Insn> program;
+  std::map<uint32_t, std::map<uint32_t, uint32_t>> loop_warps;
+
+  // The instruction to run next, if any, and the phase of the currently
+  // executing multi-cycle instruction (in_flight is true if it has yielded).
+  bool has_next_insn;
+  Insn next_insn;
+  bool in_flight;
+  int phase;
+
+  // Values computed before a yield that are needed afterwards
+  bool pend_valid;
+  uint32_t pend_u32;
+  uint32_t pend_addr;
+  U256 pend_u256;
+  unsigned pend_idx, pend_idx2;
+
+  uint32_t pc;
+  bool has_pc_next_override;
+  uint32_t pc_next_override;
+
+  // GPRs (x0 and x1 are special; gprs[1] is unused) and pending writes
+  uint32_t gprs[32];
+  uint32_t gpr_written;
+  uint32_t gpr_next[32];
+  std::vector<uint32_t> call_stack;
+  bool x1_saw_read;
+  bool call_stack_err;
+
+  U256 wdrs[32];
+  uint32_t wdr_written;
+  U256 wdr_next[32];
+
+  uint8_t flags[2];
+  bool flags_dirty;
+  uint8_t flags_next[2];
+
+  U256 mod, mod_next;
+  bool has_mod_next;
+  U256 acc, acc_next;
+  bool has_acc_next;
+
+  // The RND WSR
+  bool has_rnd, has_rnd_next;
+  U256 rnd, rnd_next;
+  bool rnd_pending, rnd_next_pending;
+  bool rnd_fips_err, rnd_fips_err_escalate;
+  bool rnd_rep_err, rnd_rep_err_escalate;
+
+  // The URND WSR
+  uint64_t urnd_state[4][4];
+  U256 urnd_value, urnd_next_value;
+  bool urnd_running;
+
+  // Sideloaded keys
+  bool keys_valid;
+  std::array<uint32_t, 12> keys[2];
+
+  // DMEM. Stores are applied to dmem_pending by one commit and then to
+  // dmem_data by the next, like Dmem in dmem.py.
+  std::vector<uint32_t> dmem_data;
+  std::vector<uint8_t> dmem_valid;
+  std::vector<uint8_t> dmem_dirty;
+  std::vector<std::pair<uint32_t, uint32_t>> dmem_stores;
+  std::map<uint32_t, uint32_t> dmem_pending;
+
+  std::vector<LoopLevel> loop_stack;
+  bool loop_err;
+  bool loop_pop_on_commit;
+
+  // Automatic loop warps (see OtbnNativeIss::set_auto_loop_warps). If
+  // auto_loop_warps is true, state_version is incremented whenever an
+  // instruction changes the architectural state (or reads a value that might
+  // differ next time, like RND). loop_restart_on_commit is set when an
+  // iteration of the innermost loop finishes and it will run again.
+  // auto_warps maps the address of the last instruction of a loop body to the
+  // (from, to) counts of the automatic warp found for it.
+  bool auto_loop_warps;
+  uint64_t state_version;
+  bool loop_restart_on_commit;
+  std::map<uint32_t, std::pair<uint32_t, uint32_t>> auto_warps;
+
+  // External registers
+  ExtReg status, insn_cnt, ext_err_bits, stop_pc, rnd_req, wipe_start;
+  EdnClient rnd_client;
+  EdnClient urnd_client;
+
+  // The external register changes seen on the last step. Bit i of
+  // changed_mask is set if register i (in the order above) was written.
+  uint32_t changed_mask;
+  uint32_t changed_values[6];
+
+  FsmState fsm_state, next_fsm_state;
+  InitSecWipeState init_sec_wipe_state;
+  int wipe_rounds_to_do, wipe_rounds_done;
+  int wipe_cycles;
+  bool lock_after_wipe;
+  uint32_t err_bits;
+  bool pending_halt;
+  int time_to_imem_invalidation;
+  bool invalidated_imem;
+  uint32_t injected_err_bits;
+  bool lock_immediately;
+  int time_to_insn_cnt_zero;
+  bool software_errs_fatal;
+  int cycles_in_this_state;
+  LcTx rma_req;
+  bool has_state_to_wipe;
+  bool delayed_lock;
+  bool edn_seen_running;
+};
+
+NativeSim::NativeSim(uint32_t imem_bytes, uint32_t dmem_bytes)
+    : imem_size(imem_bytes),
+      has_next_insn(false),
+      in_flight(false),
+      phase(0),
+      pend_valid(false),
+      pend_u32(0),
+      pend_addr(0),
+      pend_u256(u256_zero()),
+      pend_idx(0),
+      pend_idx2(0),
+      pc(0),
+      has_pc_next_override(false),
+      pc_next_override(0),
+      gpr_written(0),
+      x1_saw_read(false),
+      call_stack_err(false),
+      wdr_written(0),
+      flags_dirty(false),
+      mod(u256_zero()),
+      mod_next(u256_zero()),
+      has_mod_next(false),
+      acc(u256_zero()),
+      acc_next(u256_zero()),
+      has_acc_next(false),
+      has_rnd(false),
+      has_rnd_next(false),
+      rnd(u256_zero()),
+      rnd_next(u256_zero()),
+      rnd_pending(false),
+      rnd_next_pending(false),
+      rnd_fips_err(false),
+      rnd_fips_err_escalate(false),
+      rnd_rep_err(false),
+      rnd_rep_err_escalate(false),
+      urnd_value(u256_zero()),
+      urnd_next_value(u256_zero()),
+      urnd_running(false),
+      keys_valid(false),
+      dmem_data(dmem_bytes / 4, 0),
+      dmem_valid(dmem_bytes / 4, 0),
+      dmem_dirty(dmem_bytes / 4, 0),
+      loop_err(false),
+      loop_pop_on_commit(false),
+      auto_loop_warps(false),
+      state_version(0),
+      loop_restart_on_commit(false),
+      status(0xff, kStatusBusySecWipeInt, true),
+      insn_cnt(0xffffffff, 0, false),
+      ext_err_bits(0xffffffff, 0, false),
+      stop_pc(0xffffffff, 0, true),
+      rnd_req(0xffffffff, 0, false),
+      wipe_start(0xffffffff, 0, false),
+      changed_mask(0),
+      fsm_state(kFsmPreWipe),
+      next_fsm_state(kFsmPreWipe),
+      init_sec_wipe_state(kInitSecWipeNotDone),
+      wipe_rounds_to_do(2),
+      wipe_rounds_done(0),
+      wipe_cycles(-1),
+      lock_after_wipe(false),
+      err_bits(0),
+      pending_halt(false),
+      time_to_imem_invalidation(-1),
+      invalidated_imem(false),
+      injected_err_bits(0),
+      lock_immediately(false),
+      time_to_insn_cnt_zero(-1),
+      software_errs_fatal(false),
+      cycles_in_this_state(0),
+      rma_req(kLcTxOff),
+      has_state_to_wipe(false),
+      delayed_lock(false),
+      edn_seen_running(false) {
+  memset(&next_insn, 0, sizeof(next_insn));
+  memset(gprs, 0, sizeof(gprs));
+  memset(gpr_next, 0, sizeof(gpr_next));
+  for (int i = 0; i < 32; ++i) {
+    wdrs[i] = u256_zero();
+    wdr_next[i] = u256_zero();
+  }
+  flags[0] = flags[1] = 0;
+  flags_next[0] = flags_next[1] = 0;
+  memset(changed_values, 0, sizeof(changed_values));
+  keys[0].fill(0);
+  keys[1].fill(0);
+
+  static const uint64_t seed[4] = {0x84ddfadaf7e1134d, 0x70aa1c59de6197ff,
+                                   0x25a4fe335d095f1e, 0x2cba89acbe4a07e9};
+  memset(urnd_state, 0, sizeof(urnd_state));
+  memcpy(urnd_state[0], seed, sizeof(seed));
+}
+
+void NativeSim::start() {
+  status.write(kStatusBusyExecute);
+  pending_halt = false;
+  err_bits = 0;
+  fsm_state = next_fsm_state = kFsmPreExec;
+  has_state_to_wipe = true;
+  pc = 0;
+
+  flags[0] = flags[1] = 0;
+  flags_dirty = false;
+
+  mod = u256_zero();
+  has_mod_next = false;
+  has_rnd_next = false;
+  rnd_next_pending = false;
+  rnd_fips_err_escalate = false;
+  rnd_rep_err_escalate = false;
+  urnd_running = false;
+  acc = u256_zero();
+  has_acc_next = false;
+
+  loop_stack.clear();
+  loop_err = false;
+  loop_pop_on_commit = false;
+  loop_restart_on_commit = false;
+  auto_warps.clear();
+
+  call_stack.clear();
+  x1_saw_read = false;
+
+  rnd_client.poison();
+  urnd_client.request();
+
+  has_next_insn = false;
+  in_flight = false;
+}
+
+void NativeSim::start_mem_wipe(bool is_imem) {
+  if (fsm_state != kFsmIdle)
+    return;
+  set_fsm_state(kFsmMemSecWipe);
+  status.write(is_imem ? kStatusBusySecWipeImem : kStatusBusySecWipeDmem);
+}
+
+void NativeSim::start_init_sec_wipe() {
+  init_sec_wipe_state = kInitSecWipeInProgress;
+  urnd_client.request();
+}
+
+void NativeSim::step() {
+  changed_mask = 0;
+
+  FsmState cur_state = fsm_state;
+
+  // Only the EXEC stepper handles injected errors itself (so that they can be
+  // applied after the instruction runs)
+  if (cur_state != kFsmExec)
+    take_injected_err_bits();
+  rnd_client.step();
+  urnd_client.step();
+
+  switch (cur_state) {
+    case kFsmMemSecWipe:
+      step_ext_wipe();
+      break;
+    case kFsmIdle:
+    case kFsmLocked:
+      step_idle();
+      break;
+    case kFsmPreExec:
+      step_pre_exec();
+      break;
+    case kFsmExec:
+      step_exec();
+      break;
+    case kFsmPreWipe:
+      step_pre_wipe();
+      break;
+    case kFsmWiping:
+      step_wiping();
+      break;
+  }
+}
+
+void NativeSim::load_program(const uint8_t *buf, size_t num_bytes) {
+  if (num_bytes % 5) {
+    std::ostringstream oss;
+    oss << "Trying to load " << num_bytes
+        << " bytes of instruction data, which is not a multiple of 5.";
+    throw std::runtime_error(oss.str());
+  }
+
+  program.clear();
+  program.reserve(num_bytes / 5);
+  for (size_t i = 0; i < num_bytes / 5; ++i) {
+    uint8_t vld = buf[5 * i];
+    if (vld > 1) {
+      std::ostringstream oss;
+      oss << "The validity byte for 32-bit word " << i
+          << " of instruction data is " << (int)vld << ", not 0 or 1.";
+      throw std::runtime_error(oss.str());
+    }
+    if (vld) {
+      program.push_back(decode(4 * i, read_le32(buf + 5 * i + 1)));
+    } else {
+      Insn empty;
+      memset(&empty, 0, sizeof(empty));
+      empty.op = kOpEmpty;
+      program.push_back(empty);
+    }
+  }
+
+  time_to_imem_invalidation = -1;
+  invalidated_imem = false;
+}
+
+void NativeSim::load_data(const uint8_t *buf, size_t num_bytes) {
+  if (num_bytes % 5) {
+    std::ostringstream oss;
+    oss << "Trying to load " << num_bytes
+        << " bytes of data, which is not a multiple of 5.";
+    throw std::runtime_error(oss.str());
+  }
+  size_t num_words = num_bytes / 5;
+  if (num_words > dmem_data.size()) {
+    std::ostringstream oss;
+    oss << "Trying to load " << 4 * num_words << " bytes of data, but DMEM "
+        << "is only " << 4 * dmem_data.size() << " bytes long.";
+    throw std::runtime_error(oss.str());
+  }
+
+  for (size_t i = 0; i < num_words; ++i) {
+    uint8_t vld = buf[5 * i];
+    if (vld > 1) {
+      std::ostringstream oss;
+      oss << "The validity byte for 32-bit word " << i
+          << " in the input data is " << (int)vld << ", not 0 or 1.";
+      throw std::runtime_error(oss.str());
+    }
+    dmem_valid[i] = vld;
+    dmem_data[i] = vld ? read_le32(buf + 5 * i + 1) : 0;
+  }
+  std::fill(dmem_dirty.begin(), dmem_dirty.end(), 0);
+}
+
+void NativeSim::dump_data(uint8_t *dst) const {
+  for (uint32_t i = 0; i < dmem_data.size(); ++i) {
+    auto it = dmem_pending.find(i);
+    if (it != dmem_pending.end())
+      write_5byte_word(dst + 5 * i, true, it->second);
+    else
+      write_5byte_word(dst + 5 * i, dmem_valid[i], dmem_data[i]);
+  }
+}
+
+std::vector<std::pair<uint32_t, uint32_t>> NativeSim::dump_dirty_data(
+    uint8_t *dst) const {
+  std::vector<std::pair<uint32_t, uint32_t>> runs;
+  for (uint32_t i = 0; i < dmem_data.size(); ++i) {
+    if (!dmem_dirty[i])
+      continue;
+
+    auto it = dmem_pending.find(i);
+    if (it != dmem_pending.end())
+      write_5byte_word(dst + 5 * i, true, it->second);
+    else
+      write_5byte_word(dst + 5 * i, dmem_valid[i], dmem_data[i]);
+
+    if (!runs.empty() && runs.back().first + runs.back().second == i)
+      ++runs.back().second;
+    else
+      runs.push_back(std::make_pair(i, 1));
+  }
+  return runs;
+}
+
+void NativeSim::invalidate_dmem() {
+  std::fill(dmem_valid.begin(), dmem_valid.end(), 0);
+  std::fill(dmem_dirty.begin(), dmem_dirty.end(), 1);
+}
+
+void NativeSim::edn_flush() {
+  rnd_client.edn_reset();
+  urnd_client.edn_reset();
+  // If the initial secure wipe is running, OTBN will directly request a new
+  // URND seed.
+  if (init_sec_wipe_is_running())
+    urnd_client.request();
+}
+
+void NativeSim::rnd_completed() {
+  EdnResult res = rnd_client.cdc_complete();
+  if (!res.retry)
+    rnd_req.write(0);
+
+  // This will be committed at the end of the next step on the main clock.
+  if (res.has_data) {
+    rnd_fips_err = res.fips_err;
+    rnd_rep_err = res.rep_err;
+    rnd_fips_err_escalate = false;
+    rnd_rep_err_escalate = false;
+    has_rnd_next = true;
+    rnd_next = res.data;
+    rnd_next_pending = false;
+  }
+}
+
+void NativeSim::urnd_completed() {
+  EdnResult res = urnd_client.cdc_complete();
+  // The URND client should never be poisoned
+  if (!res.has_data || res.retry)
+    throw std::runtime_error("URND request completed with no data.");
+
+  edn_seen_running = true;
+  urnd_set_seed(res.data.w);
+
+  // If we aren't in a state where we expect to have made a URND request, we
+  // should immediately jump to the locked state.
+  if (fsm_state != kFsmPreExec && fsm_state != kFsmPreWipe)
+    lock_now();
+}
+
+void NativeSim::on_otp_cdc_done() {
+  switch (fsm_state) {
+    case kFsmMemSecWipe:
+      status.write(kStatusIdle);
+      set_fsm_state(kFsmIdle);
+      break;
+    case kFsmPreWipe:
+    case kFsmWiping:
+    case kFsmLocked:
+      break;
+    default:
+      throw std::runtime_error("OTP key CDC completed in an unexpected state.");
+  }
+}
+
+void NativeSim::lock_now() {
+  set_fsm_state(kFsmLocked);
+  status.write(kStatusLocked, true);
+}
+
+Insn NativeSim::fetch(uint32_t addr) const {
+  uint32_t word_pc = addr >> 2;
+  if (word_pc >= program.size()) {
+    std::ostringstream oss;
+    oss << "Trying to execute instruction at address 0x" << std::hex << addr
+        << ", but the program is only 0x" << 4 * program.size()
+        << " bytes long.";
+    throw std::runtime_error(oss.str());
+  }
+
+  if (invalidated_imem) {
+    Insn empty;
+    memset(&empty, 0, sizeof(empty));
+    empty.op = kOpEmpty;
+    return empty;
+  }
+
+  return program[word_pc];
+}
+
+void NativeSim::step_idle() {
+  stop_if_pending_halt();
+
+  bool is_locked = fsm_state == kFsmLocked;
+
+  // Zero INSN_CNT once if we're locked (or an RMA has been requested), but
+  // not on every cycle.
+  bool should_zero = is_locked || rma_req == kLcTxOn;
+  bool new_zero = cycles_in_this_state == 0 || insn_cnt.read() != 0;
+  if (should_zero && new_zero)
+    insn_cnt.write(0);
+
+  if (delayed_lock) {
+    set_fsm_state(kFsmLocked);
+    status.write(kStatusLocked);
+    is_locked = true;
+  }
+
+  if (rma_req == kLcTxOn && !is_locked) {
+    status.write(kStatusLocked);
+    set_fsm_state(kFsmPreWipe);
+    lock_after_wipe = true;
+    wipe_rounds_done = 0;
+  }
+
+  if (init_sec_wipe_is_running() && !is_locked && urnd_running) {
+    bool start_of_time_rma = rma_req == kLcTxOn && !has_state_to_wipe;
+    if (start_of_time_rma) {
+      init_sec_wipe_state = kInitSecWipeDone;
+      set_fsm_state(kFsmLocked);
+      status.write(kStatusLocked);
+    } else {
+      set_fsm_state(kFsmWiping);
+      if (is_locked)
+        lock_after_wipe = true;
+    }
+  }
+
+  changes();
+  commit(true);
+}
+
+void NativeSim::step_ext_wipe() {
+  stop_if_pending_halt();
+  changes();
+  commit(true);
+}
+
+void NativeSim::step_pre_exec() {
+  if (urnd_running)
+    set_fsm_state(kFsmExec);
+
+  on_stall(false);
+
+  if (rma_req == kLcTxOn)
+    lock_now();
+
+  if (insn_cnt.read() != 0)
+    insn_cnt.write(0);
+}
+
+void NativeSim::step_exec() {
+  urnd_step();
+
+  if (!has_next_insn) {
+    take_injected_err_bits();
+    on_stall(true);
+    return;
+  }
+
+  // Take a copy because on_retire might fetch a new instruction
+  Insn insn = next_insn;
+
+  // If an RMA request arrives, abandon the instruction and start wiping.
+  if (rma_req == kLcTxOn) {
+    stop_at_end_of_cycle(1);
+    set_fsm_state(kFsmPreWipe);
+    lock_after_wipe = true;
+    in_flight = false;
+  }
+
+  if (insn.op == kOpEmpty)
+    in_flight = false;
+
+  if (!in_flight) {
+    pre_insn(affects_control(insn.op));
+    phase = 0;
+  }
+  in_flight = exec_insn(insn);
+
+  if (rnd_rep_err_escalate)
+    stop_at_end_of_cycle(kErrRndRepChkFail);
+  if (rnd_fips_err_escalate)
+    stop_at_end_of_cycle(kErrRndFipsChkFail);
+
+  take_injected_err_bits();
+
+  if (pending_halt)
+    in_flight = false;
+
+  if (in_flight)
+    on_stall(false);
+  else
+    on_retire(insn);
+}
+
+void NativeSim::step_pre_wipe() {
+  status.write(kStatusBusySecWipeInt);
+
+  // An RMA request before we've seen EDN running means there's no secret
+  // state to wipe: do a single round and lock.
+  if (rma_req == kLcTxOn && !edn_seen_running) {
+    lock_after_wipe = true;
+    wipe_rounds_to_do = 1;
+    set_fsm_state(kFsmWiping);
+  }
+
+  if (wipe_start.read())
+    wipe_start.write(0);
+
+  delayed_insn_cnt_zero(0);
+
+  if (urnd_running) {
+    if (status.read() != kStatusBusySecWipeInt &&
+        status.read() != kStatusLocked)
+      status.write(kStatusBusySecWipeInt);
+    set_fsm_state(kFsmWiping);
+  }
+
+  on_stall(false);
+}
+
+void NativeSim::step_wiping() {
+  if (wipe_cycles < 0)
+    throw std::runtime_error("Wiping with no wipe cycle count.");
+
+  bool was_wiping = wipe_cycles > 0;
+  if (was_wiping)
+    --wipe_cycles;
+
+  bool locking = rma_req == kLcTxOn || lock_after_wipe;
+
+  if (rma_req == kLcTxOn)
+    lock_after_wipe = true;
+  if (pending_halt)
+    lock_after_wipe = true;
+
+  delayed_insn_cnt_zero(1);
+
+  if (wipe_cycles == 1) {
+    bool final_wipe_round = wipe_rounds_done == wipe_rounds_to_do - 1;
+    if (final_wipe_round) {
+      status.write(locking ? kStatusLocked : kStatusIdle);
+      wipe();
+    } else {
+      // Ask for a fresh URND seed for the next round
+      urnd_running = false;
+      urnd_client.request();
+    }
+  }
+
+  if (wipe_cycles == 0) {
+    if (was_wiping)
+      ++wipe_rounds_done;
+
+    bool final_wipe_round = wipe_rounds_done == wipe_rounds_to_do;
+    if (!final_wipe_round) {
+      set_fsm_state(kFsmPreWipe);
+    } else {
+      if (rma_req != kLcTxOff)
+        delayed_lock = true;
+
+      FsmState next_state;
+      if (locking) {
+        next_state = kFsmLocked;
+        status.write(kStatusLocked);
+      } else {
+        next_state = kFsmIdle;
+        if (init_sec_wipe_is_running())
+          init_sec_wipe_state = kInitSecWipeDone;
+      }
+      wipe_cycles = -1;
+      set_fsm_state(next_state);
+    }
+  }
+
+  on_stall(false);
+}
+
+void NativeSim::delayed_insn_cnt_zero(int delay_if_locking) {
+  // Only zero instruction count if we're wiping before lock and it isn't
+  // already zero.
+  if (!lock_after_wipe || insn_cnt.read() == 0)
+    return;
+
+  if (time_to_insn_cnt_zero < 0)
+    time_to_insn_cnt_zero = delay_if_locking;
+
+  int count = std::min(time_to_insn_cnt_zero, delay_if_locking);
+  if (count == 0) {
+    insn_cnt.write(0);
+    time_to_insn_cnt_zero = -1;
+  } else {
+    time_to_insn_cnt_zero = count - 1;
+  }
+}
+
+void NativeSim::on_stall(bool fetch_next) {
+  stop_if_pending_halt();
+  changes();
+  commit(true);
+  if (fetch_next) {
+    next_insn = fetch(pc);
+    has_next_insn = true;
+  }
+}
+
+void NativeSim::on_retire(const Insn &insn) {
+  post_insn();
+
+  // Check for pending_halt. We have to do this after post_insn(), which might
+  // set it because of an error at the end of a loop.
+  bool halting = stop_if_pending_halt();
+
+  changes();
+  commit(false);
+
+  // Fetch the next instruction unless this instruction had has_fetch_stall
+  // set (in which case we have an empty cycle) or we're stopping.
+  if (halting || has_fetch_stall(insn.op)) {
+    has_next_insn = false;
+  } else {
+    next_insn = fetch(pc);
+    has_next_insn = true;
+  }
+}
+
+bool NativeSim::exec_insn(const Insn &insn) {
+  switch (insn.op) {
+    case kOpIllegal:
+      stop_at_end_of_cycle(kErrIllegalInsn);
+      return false;
+
+    case kOpEmpty:
+      stop_at_end_of_cycle(kErrImemIntgViolation);
+      return false;
+
+    case kOpAdd:
+    case kOpSub:
+    case kOpSll:
+    case kOpSrl:
+    case kOpSra:
+    case kOpAnd:
+    case kOpOr:
+    case kOpXor: {
+      uint32_t a = read_gpr(insn.rs1);
+      uint32_t b = read_gpr(insn.rs2);
+      if (call_stack_err) {
+        stop_at_end_of_cycle(kErrCallStack);
+        return false;
+      }
+      uint32_t result;
+      switch (insn.op) {
+        case kOpAdd:
+          result = a + b;
+          break;
+        case kOpSub:
+          result = a - b;
+          break;
+        case kOpSll:
+          result = a << (b & 0x1f);
+          break;
+        case kOpSrl:
+          result = a >> (b & 0x1f);
+          break;
+        case kOpSra:
+          result = (uint32_t)((int32_t)a >> (b & 0x1f));
+          break;
+        case kOpAnd:
+          result = a & b;
+          break;
+        case kOpOr:
+          result = a | b;
+          break;
+        default:
+          result = a ^ b;
+          break;
+      }
+      write_gpr(insn.rd, result);
+      return false;
+    }
+
+    case kOpAddi:
+    case kOpSlli:
+    case kOpSrli:
+    case kOpSrai:
+    case kOpAndi:
+    case kOpOri:
+    case kOpXori: {
+      uint32_t a = read_gpr(insn.rs1);
+      if (call_stack_err) {
+        stop_at_end_of_cycle(kErrCallStack);
+        return false;
+      }
+      uint32_t result;
+      switch (insn.op) {
+        case kOpAddi:
+          result = a + insn.imm;
+          break;
+        case kOpSlli:
+          result = a << insn.imm;
+          break;
+        case kOpSrli:
+          result = a >> insn.imm;
+          break;
+        case kOpSrai:
+          result = (uint32_t)((int32_t)a >> insn.imm);
+          break;
+        case kOpAndi:
+          result = a & insn.imm;
+          break;
+        case kOpOri:
+          result = a | insn.imm;
+          break;
+        default:
+          result = a ^ insn.imm;
+          break;
+      }
+      write_gpr(insn.rd, result);
+      return false;
+    }
+
+    case kOpLui:
+      write_gpr(insn.rd, insn.imm);
+      return false;
+
+    case kOpLw:
+      // LW executes over two cycles. On the first cycle, we read the base
+      // address, compute the load address and check it for correctness, then
+      // perform the load itself. On the second cycle, we write the result to
+      // the destination register.
+      if (phase == 0) {
+        uint32_t base = read_gpr(insn.rs1);
+        if (call_stack_err) {
+          stop_at_end_of_cycle(kErrCallStack);
+          return false;
+        }
+        uint32_t addr = base + insn.imm;
+        if (!valid_32b_addr(addr)) {
+          stop_at_end_of_cycle(kErrBadDataAddr);
+          return false;
+        }
+        pend_valid = load_u32(addr, &pend_u32);
+        phase = 1;
+        return true;
+      }
+      if (!pend_valid) {
+        stop_at_end_of_cycle(kErrDmemIntgViolation);
+        return false;
+      }
+      write_gpr(insn.rd, pend_u32);
+      return false;
+
+    case kOpSw: {
+      uint32_t base = read_gpr(insn.rs1);
+      uint32_t addr = base + insn.imm;
+      uint32_t value = read_gpr(insn.rs2);
+
+      bool bad_grs1 = call_stack_err && insn.rs1 == 1;
+      bool saw_err = false;
+
+      if (call_stack_err) {
+        stop_at_end_of_cycle(kErrCallStack);
+        saw_err = true;
+      }
+      if (!valid_32b_addr(addr) && !bad_grs1) {
+        stop_at_end_of_cycle(kErrBadDataAddr);
+        saw_err = true;
+      }
+      if (!saw_err)
+        store_u32(addr, value);
+      return false;
+    }
+
+    case kOpBeq:
+    case kOpBne: {
+      uint32_t a = read_gpr(insn.rs1);
+      uint32_t b = read_gpr(insn.rs2);
+      if (call_stack_err) {
+        stop_at_end_of_cycle(kErrCallStack);
+        return false;
+      }
+      if ((a == b) == (insn.op == kOpBeq)) {
+        if (!is_pc_valid(insn.imm))
+          stop_at_end_of_cycle(kErrBadInsnAddr);
+        else
+          set_next_pc(insn.imm);
+      }
+      return false;
+    }
+
+    case kOpJal:
+      write_gpr(insn.rd, pc + 4);
+      if (!is_pc_valid(insn.imm))
+        stop_at_end_of_cycle(kErrBadInsnAddr);
+      else
+        set_next_pc(insn.imm);
+      return false;
+
+    case kOpJalr: {
+      uint32_t base = read_gpr(insn.rs1);
+      if (call_stack_err) {
+        stop_at_end_of_cycle(kErrCallStack);
+        return false;
+      }
+      write_gpr(insn.rd, pc + 4);
+      uint32_t next_pc = base + insn.imm;
+      if (!is_pc_valid(next_pc))
+        stop_at_end_of_cycle(kErrBadInsnAddr);
+      else
+        set_next_pc(next_pc);
+      return false;
+    }
+
+    case kOpCsrrs:
+    case kOpCsrrw: {
+      bool is_csrrs = insn.op == kOpCsrrs;
+      if (phase == 0) {
+        if (!csr_valid(insn.imm)) {
+          stop_at_end_of_cycle(kErrIllegalInsn);
+          return false;
+        }
+        pend_u32 = read_gpr(insn.rs1);
+        if (call_stack_err) {
+          stop_at_end_of_cycle(kErrCallStack);
+          return false;
+        }
+        phase = 1;
+      }
+
+      // A read from RND stalls until a value is available
+      bool reads_rnd = insn.imm == 0xfc0 && (is_csrrs || insn.rd != 0);
+      if (reads_rnd && !rnd_request_value())
+        return true;
+
+      if (is_csrrs) {
+        uint32_t old_val = read_csr(insn.imm);
+        write_gpr(insn.rd, old_val);
+        if (insn.rs1 != 0)
+          write_csr(insn.imm, old_val | pend_u32);
+      } else {
+        if (insn.rd != 0)
+          write_gpr(insn.rd, read_csr(insn.imm));
+        write_csr(insn.imm, pend_u32);
+      }
+      return false;
+    }
+
+    case kOpEcall:
+      stop_at_end_of_cycle(0);
+      return false;
+
+    case kOpLoop: {
+      uint32_t num_iters = read_gpr(insn.rs1);
+      if (call_stack_err) {
+        stop_at_end_of_cycle(kErrCallStack);
+        return false;
+      }
+      if (num_iters == 0)
+        stop_at_end_of_cycle(kErrLoop);
+      else
+        loop_start(num_iters, insn.imm);
+      return false;
+    }
+
+    case kOpLoopi:
+      if (insn.iterations == 0)
+        stop_at_end_of_cycle(kErrLoop);
+      else
+        loop_start(insn.iterations, insn.imm);
+      return false;
+
+    case kOpBnAdd:
+    case kOpBnAddc:
+    case kOpBnAddi:
+    case kOpBnSub:
+    case kOpBnSubb:
+    case kOpBnSubi:
+    case kOpBnCmp:
+    case kOpBnCmpb: {
+      const U256 &a = wdrs[insn.rs1];
+      U256 b;
+      if (insn.op == kOpBnAddi || insn.op == kOpBnSubi) {
+        b = u256_zero();
+        b.w[0] = insn.imm;
+      } else {
+        b = logical_byte_shift(wdrs[insn.rs2], insn.shift_type,
+                               insn.shift_bytes);
+      }
+
+      bool carry_in = (insn.op == kOpBnAddc || insn.op == kOpBnSubb ||
+                       insn.op == kOpBnCmpb) &&
+                      (flags[insn.fg] & kFlagC);
+      bool is_sub = insn.op != kOpBnAdd && insn.op != kOpBnAddc &&
+                    insn.op != kOpBnAddi;
+
+      U256 result;
+      bool carry = is_sub ? u256_sub(a, b, carry_in, &result)
+                          : u256_add(a, b, carry_in, &result);
+      if (insn.op != kOpBnCmp && insn.op != kOpBnCmpb)
+        write_wdr(insn.rd, result);
+      set_flags(insn.fg, mlz_for_result(carry, result));
+      return false;
+    }
+
+    case kOpBnAddm: {
+      U256 result;
+      bool carry = u256_add(wdrs[insn.rs1], wdrs[insn.rs2], false, &result);
+      if (carry || u256_ge(result, mod))
+        u256_sub(result, mod, false, &result);
+      write_wdr(insn.rd, result);
+      return false;
+    }
+
+    case kOpBnSubm: {
+      U256 result;
+      if (u256_sub(wdrs[insn.rs1], wdrs[insn.rs2], false, &result))
+        u256_add(result, mod, false, &result);
+      write_wdr(insn.rd, result);
+      return false;
+    }
+
+    case kOpBnMulqacc:
+    case kOpBnMulqaccWo:
+    case kOpBnMulqaccSo: {
+      uint64_t a_qw = wdrs[insn.rs1].w[insn.qs1];
+      uint64_t b_qw = wdrs[insn.rs2].w[insn.qs2];
+      unsigned __int128 mul_res = (unsigned __int128)a_qw * b_qw;
+      U256 shifted = u256_zero();
+      shifted.w[insn.acc_shift] = (uint64_t)mul_res;
+      if (insn.acc_shift < 3)
+        shifted.w[insn.acc_shift + 1] = (uint64_t)(mul_res >> 64);
+
+      U256 result;
+      u256_add(insn.zero_acc ? u256_zero() : acc, shifted, false, &result);
+
+      if (insn.op == kOpBnMulqacc) {
+        acc_next = result;
+        has_acc_next = true;
+      } else if (insn.op == kOpBnMulqaccWo) {
+        write_wdr(insn.rd, result);
+        acc_next = result;
+        has_acc_next = true;
+        set_flags(insn.fg, mlz_for_result(flags[insn.fg] & kFlagC, result));
+      } else {
+        // Write the low half of the result to the selected half of wrd and
+        // shift it out of the accumulator.
+        U256 new_wrd = wdrs[insn.rd];
+        new_wrd.w[2 * insn.sel] = result.w[0];
+        new_wrd.w[2 * insn.sel + 1] = result.w[1];
+        write_wdr(insn.rd, new_wrd);
+
+        acc_next = u256_shr(result, 128);
+        has_acc_next = true;
+
+        bool lo_zero = (result.w[0] | result.w[1]) == 0;
+        uint8_t old_flags = flags[insn.fg];
+        uint8_t new_flags = old_flags & kFlagC;
+        if (insn.sel) {
+          new_flags |= old_flags & kFlagL;
+          if (result.w[1] >> 63)
+            new_flags |= kFlagM;
+          if ((old_flags & kFlagZ) && lo_zero)
+            new_flags |= kFlagZ;
+        } else {
+          new_flags |= old_flags & kFlagM;
+          if (result.w[0] & 1)
+            new_flags |= kFlagL;
+          if (lo_zero)
+            new_flags |= kFlagZ;
+        }
+        set_flags(insn.fg, new_flags);
+      }
+      return false;
+    }
+
+    case kOpBnAnd:
+    case kOpBnOr:
+    case kOpBnXor:
+    case kOpBnNot: {
+      U256 result;
+      if (insn.op == kOpBnNot) {
+        result = u256_not(logical_byte_shift(wdrs[insn.rs1], insn.shift_type,
+                                             insn.shift_bytes));
+      } else {
+        U256 b = logical_byte_shift(wdrs[insn.rs2], insn.shift_type,
+                                    insn.shift_bytes);
+        if (insn.op == kOpBnAnd)
+          result = u256_and(wdrs[insn.rs1], b);
+        else if (insn.op == kOpBnOr)
+          result = u256_or(wdrs[insn.rs1], b);
+        else
+          result = u256_xor(wdrs[insn.rs1], b);
+      }
+      write_wdr(insn.rd, result);
+      set_flags(insn.fg, mlz_for_result(flags[insn.fg] & kFlagC, result));
+      return false;
+    }
+
+    case kOpBnRshi:
+      write_wdr(insn.rd, u512_shr(wdrs[insn.rs1], wdrs[insn.rs2], insn.imm));
+      return false;
+
+    case kOpBnSel: {
+      bool flag_is_set = (flags[insn.fg] >> insn.sel) & 1;
+      write_wdr(insn.rd, wdrs[flag_is_set ? insn.rs1 : insn.rs2]);
+      return false;
+    }
+
+    case kOpBnLid:
+    case kOpBnSid: {
+      // BN.LID and BN.SID execute over two cycles. On the first cycle, we read
+      // the base address, compute the address and check it for correctness
+      // and increment any GPRs. BN.LID also performs the load itself. On the
+      // second cycle, BN.LID updates the WDR with the result and BN.SID reads
+      // the WDR and performs the store.
+      bool is_lid = insn.op == kOpBnLid;
+      unsigned grd = is_lid ? insn.rd : insn.rs2;
+      if (phase == 0) {
+        if (insn.inc1 && insn.inc2) {
+          stop_at_end_of_cycle(kErrIllegalInsn);
+          return false;
+        }
+
+        uint32_t grs1_val = read_gpr(insn.rs1);
+        uint32_t addr = grs1_val + insn.imm;
+        uint32_t grd_val = read_gpr(grd);
+
+        bool bad_grs1 = call_stack_err && insn.rs1 == 1;
+        bool bad_grd = call_stack_err && grd == 1;
+        bool saw_err = false;
+
+        if (call_stack_err) {
+          stop_at_end_of_cycle(kErrCallStack);
+          saw_err = true;
+        }
+        if (grd_val > 31 && !bad_grd) {
+          stop_at_end_of_cycle(kErrIllegalInsn);
+          saw_err = true;
+        }
+        if (!valid_256b_addr(addr) && !bad_grs1) {
+          stop_at_end_of_cycle(kErrBadDataAddr);
+          saw_err = true;
+        }
+        if (saw_err)
+          return false;
+
+        pend_idx = grd_val & 0x1f;
+        pend_addr = addr;
+        if (is_lid)
+          pend_valid = load_u256(addr, &pend_u256);
+
+        if (is_lid) {
+          if (insn.inc2)
+            write_gpr(grd, grd_val + 1);
+          if (insn.inc1)
+            write_gpr(insn.rs1, grs1_val + 32);
+        } else {
+          if (insn.inc1)
+            write_gpr(insn.rs1, grs1_val + 32);
+          if (insn.inc2)
+            write_gpr(grd, grd_val + 1);
+        }
+
+        phase = 1;
+        return true;
+      }
+
+      if (is_lid) {
+        if (!pend_valid) {
+          stop_at_end_of_cycle(kErrDmemIntgViolation);
+          return false;
+        }
+        write_wdr(pend_idx, pend_u256);
+      } else {
+        const U256 &value = wdrs[pend_idx];
+        for (unsigned i = 0; i < 8; ++i)
+          store_u32(pend_addr + 4 * i, u256_word(value, i));
+      }
+      return false;
+    }
+
+    case kOpBnMov:
+      write_wdr(insn.rd, wdrs[insn.rs1]);
+      return false;
+
+    case kOpBnMovr:
+      if (phase == 0) {
+        if (insn.inc1 && insn.inc2) {
+          stop_at_end_of_cycle(kErrIllegalInsn);
+          return false;
+        }
+
+        uint32_t grd_val = read_gpr(insn.rd);
+        uint32_t grs_val = read_gpr(insn.rs1);
+
+        bool bad_grs = call_stack_err && insn.rs1 == 1;
+        bool bad_grd = call_stack_err && insn.rd == 1;
+        bool saw_err = false;
+
+        if (call_stack_err) {
+          stop_at_end_of_cycle(kErrCallStack);
+          saw_err = true;
+        }
+        if (grd_val > 31 && !bad_grd) {
+          stop_at_end_of_cycle(kErrIllegalInsn);
+          saw_err = true;
+        }
+        if (grs_val > 31 && !bad_grs) {
+          stop_at_end_of_cycle(kErrIllegalInsn);
+          saw_err = true;
+        }
+        if (saw_err)
+          return false;
+
+        pend_idx = grd_val & 0x1f;
+        pend_idx2 = grs_val & 0x1f;
+
+        if (insn.inc2)
+          write_gpr(insn.rd, grd_val + 1);
+        if (insn.inc1)
+          write_gpr(insn.rs1, grs_val + 1);
+
+        phase = 1;
+        return true;
+      }
+      write_wdr(pend_idx, wdrs[pend_idx2]);
+      return false;
+
+    case kOpBnWsrr: {
+      if (insn.imm > 7) {
+        stop_at_end_of_cycle(kErrIllegalInsn);
+        return false;
+      }
+
+      // A read from RND stalls until a value is available
+      if (insn.imm == 1 && !rnd_request_value())
+        return true;
+
+      U256 value;
+      switch (insn.imm) {
+        case 0:
+          value = mod;
+          break;
+        case 1:
+          value = rnd_read();
+          break;
+        case 2:
+          value = urnd_value;
+          ++state_version;
+          break;
+        case 3:
+          value = acc;
+          break;
+        default:
+          // The sideload keys might not have a value. If not, fail with a
+          // KEY_INVALID error.
+          if (!keys_valid) {
+            stop_at_end_of_cycle(kErrKeyInvalid);
+            return false;
+          }
+          // Keys can change under our feet, so reading one counts as a
+          // change of state for automatic loop warps.
+          value = read_key(insn.imm - 4);
+          ++state_version;
+          break;
+      }
+      write_wdr(insn.rd, value);
+      return false;
+    }
+
+    case kOpBnWsrw:
+      // Writes are ignored for everything except MOD and ACC.
+      if (insn.imm > 7) {
+        stop_at_end_of_cycle(kErrIllegalInsn);
+      } else if (insn.imm == 0) {
+        mod_next = wdrs[insn.rs1];
+        has_mod_next = true;
+      } else if (insn.imm == 3) {
+        acc_next = wdrs[insn.rs1];
+        has_acc_next = true;
+      }
+      return false;
+  }
+  return false;
+}
+
+void NativeSim::set_fsm_state(FsmState new_state) {
+  // If the new state is WIPING, set up the number of cycles it takes
+  if (new_state == kFsmWiping)
+    wipe_cycles = kWipeCycles;
+  next_fsm_state = new_state;
+}
+
+void NativeSim::stop_at_end_of_cycle(uint32_t new_err_bits) {
+  err_bits |= new_err_bits;
+  pending_halt = true;
+}
+
+bool NativeSim::stop_if_pending_halt() {
+  if (pending_halt) {
+    stop();
+    return true;
+  }
+  return false;
+}
+
+void NativeSim::stop() {
+  // If the instruction failed, discard its pending changes
+  if (err_bits && fsm_state == kFsmExec)
+    abort();
+
+  // Any fatal error, or any error at all if software errors are fatal (or an
+  // RMA request), means we should lock after wiping.
+  bool should_lock = (err_bits >> 16) != 0 || ((err_bits >> 10) & 1) ||
+                     (err_bits && software_errs_fatal) || rma_req == kLcTxOn;
+
+  ext_err_bits.write(err_bits);
+  pending_halt = false;
+
+  if (lock_immediately) {
+    set_fsm_state(kFsmLocked);
+    status.write(kStatusLocked);
+  } else if (fsm_state == kFsmExec) {
+    stop_pc.write(pc);
+    wipe_start.write(1);
+    wipe_start.commit();
+    set_fsm_state(kFsmPreWipe);
+    lock_after_wipe = should_lock;
+    wipe_rounds_done = 0;
+  } else if (fsm_state == kFsmPreWipe || fsm_state == kFsmWiping) {
+    lock_after_wipe = true;
+  } else if (init_sec_wipe_state == kInitSecWipeInProgress) {
+    pending_halt = true;
+  } else if (init_sec_wipe_state == kInitSecWipeDone) {
+    next_fsm_state = kFsmLocked;
+    status.write(kStatusLocked);
+  }
+
+  rnd_forget();
+}
+
+void NativeSim::take_injected_err_bits() {
+  if (injected_err_bits != 0) {
+    stop_at_end_of_cycle(injected_err_bits);
+    injected_err_bits = 0;
+  }
+}
+
+void NativeSim::abort() {
+  gpr_written = 0;
+  x1_saw_read = false;
+  call_stack_err = false;
+  has_pc_next_override = false;
+  dmem_stores.clear();
+  loop_err = false;
+
+  status.abort();
+  insn_cnt.abort();
+  ext_err_bits.abort();
+  stop_pc.abort();
+  rnd_req.abort();
+  wipe_start.abort();
+
+  has_mod_next = false;
+  has_acc_next = false;
+  flags_dirty = false;
+  wdr_written = 0;
+}
+
+void NativeSim::commit(bool sim_stalled) {
+  if (time_to_imem_invalidation >= 0) {
+    if (--time_to_imem_invalidation == 0) {
+      invalidated_imem = true;
+      time_to_imem_invalidation = -1;
+    }
+  }
+
+  FsmState old_state = fsm_state;
+  fsm_state = next_fsm_state;
+  if (fsm_state == old_state)
+    ++cycles_in_this_state;
+  else
+    cycles_in_this_state = 0;
+
+  status.commit();
+  insn_cnt.commit();
+  ext_err_bits.commit();
+  stop_pc.commit();
+  rnd_req.commit();
+  wipe_start.commit();
+
+  // We also commit URND in some "idle-ish" states
+  urnd_value = urnd_next_value;
+
+  // In other states there are no other pending changes.
+  if (old_state != kFsmExec && old_state != kFsmWiping)
+    return;
+
+  // GPRs. If x1 was read, pop the call stack; if it was written, push.
+  if (x1_saw_read) {
+    call_stack.pop_back();
+    x1_saw_read = false;
+    ++state_version;
+  }
+  for (unsigned i = 0; i < 32; ++i) {
+    if (!((gpr_written >> i) & 1))
+      continue;
+    if (i == 1) {
+      call_stack.push_back(gpr_next[1]);
+      ++state_version;
+    } else {
+      if (gprs[i] != gpr_next[i])
+        ++state_version;
+      gprs[i] = gpr_next[i];
+    }
+  }
+  gpr_written = 0;
+
+  // DMEM
+  for (const auto &entry : dmem_pending) {
+    dmem_data[entry.first] = entry.second;
+    dmem_valid[entry.first] = 1;
+  }
+  dmem_pending.clear();
+  for (const auto &store : dmem_stores) {
+    if (!dmem_valid[store.first] || dmem_data[store.first] != store.second)
+      ++state_version;
+    dmem_pending[store.first] = store.second;
+    dmem_dirty[store.first] = 1;
+  }
+  dmem_stores.clear();
+
+  // Loop stack
+  if (loop_pop_on_commit) {
+    loop_stack.pop_back();
+    loop_pop_on_commit = false;
+  }
+
+  // WSRs
+  if (has_mod_next) {
+    if (auto_loop_warps && !u256_eq(mod, mod_next))
+      ++state_version;
+    mod = mod_next;
+    has_mod_next = false;
+  }
+  has_rnd = has_rnd_next;
+  rnd = rnd_next;
+  rnd_pending = rnd_next_pending;
+  urnd_value = urnd_next_value;
+  if (has_acc_next) {
+    if (auto_loop_warps && !u256_eq(acc, acc_next))
+      ++state_version;
+    acc = acc_next;
+    has_acc_next = false;
+  }
+
+  // Flags
+  if (flags_dirty) {
+    if (flags[0] != flags_next[0] || flags[1] != flags_next[1])
+      ++state_version;
+    flags[0] = flags_next[0];
+    flags[1] = flags_next[1];
+    flags_dirty = false;
+  }
+
+  // WDRs
+  for (unsigned i = 0; i < 32; ++i) {
+    if (!((wdr_written >> i) & 1))
+      continue;
+    if (auto_loop_warps && !u256_eq(wdrs[i], wdr_next[i]))
+      ++state_version;
+    wdrs[i] = wdr_next[i];
+  }
+  wdr_written = 0;
+
+  if (loop_restart_on_commit) {
+    loop_iter_done();
+    loop_restart_on_commit = false;
+  }
+
+  if (!sim_stalled) {
+    pc = has_pc_next_override ? pc_next_override : pc + 4;
+    has_pc_next_override = false;
+  }
+}
+
+void NativeSim::changes() {
+  const ExtReg *regs[6] = {&status,  &insn_cnt, &ext_err_bits,
+                           &stop_pc, &rnd_req,  &wipe_start};
+  for (unsigned i = 0; i < 6; ++i) {
+    if (regs[i]->changed) {
+      changed_mask |= 1u << i;
+      changed_values[i] = regs[i]->change;
+    }
+  }
+}
+
+void NativeSim::pre_insn(bool insn_affects_control) {
+  // Check for branch instructions at the end of a loop body
+  if (insn_affects_control && !loop_stack.empty() &&
+      pc == loop_stack.back().last_addr)
+    loop_err = true;
+}
+
+void NativeSim::post_insn() {
+  increment_insn_cnt();
+  loop_step();
+
+  // A write to x1 with no read when the call stack is full overflows it.
+  if (((gpr_written >> 1) & 1) && !x1_saw_read && call_stack.size() == 8)
+    call_stack_err = true;
+
+  err_bits |= (call_stack_err ? kErrCallStack : 0) | (loop_err ? kErrLoop : 0);
+  if (err_bits)
+    pending_halt = true;
+
+  // Check that the next PC is valid, but only if we're not stopping anyway.
+  // This handles the case where we have a straight-line instruction at the
+  // top of memory. Jumps and branches to invalid addresses are handled in the
+  // instruction definition.
+  uint32_t next_pc = has_pc_next_override ? pc_next_override : pc + 4;
+  if (!is_pc_valid(next_pc) && !pending_halt)
+    stop_at_end_of_cycle(kErrBadInsnAddr);
+}
+
+void NativeSim::wipe() {
+  // The Python ISS marks the GPRs, WDRs, MOD and ACC as invalid, which leaves
+  // their values unchanged. Match that, clearing just the call stack and the
+  // flags.
+  call_stack.clear();
+  write_flags(0);
+}
+
+bool NativeSim::is_pc_valid(uint32_t addr) const {
+  return !(addr & 3) && addr < imem_size;
+}
+
+void NativeSim::set_next_pc(uint32_t next_pc) {
+  has_pc_next_override = true;
+  pc_next_override = next_pc;
+}
+
+uint32_t NativeSim::read_gpr(unsigned idx) {
+  if (idx == 0)
+    return 0;
+  if (idx == 1) {
+    // Reads from x1 pop the call stack (at commit)
+    if (call_stack.empty()) {
+      call_stack_err = true;
+      return 0;
+    }
+    x1_saw_read = true;
+    return call_stack.back();
+  }
+  return gprs[idx];
+}
+
+void NativeSim::write_gpr(unsigned idx, uint32_t value) {
+  if (idx == 0)
+    return;
+  gpr_written |= 1u << idx;
+  gpr_next[idx] = value;
+}
+
+void NativeSim::write_wdr(unsigned idx, const U256 &value) {
+  wdr_written |= 1u << idx;
+  wdr_next[idx] = value;
+}
+
+void NativeSim::write_flags(uint8_t value) {
+  flags_dirty = true;
+  flags_next[0] = value & 0xf;
+  flags_next[1] = (value >> 4) & 0xf;
+}
+
+void NativeSim::set_flags(unsigned fg, uint8_t value) {
+  if (!flags_dirty) {
+    flags_next[0] = flags[0];
+    flags_next[1] = flags[1];
+  }
+  flags_dirty = true;
+  flags_next[fg] = value;
+}
+
+bool NativeSim::csr_valid(uint32_t idx) const {
+  return idx == 0x7c0 || idx == 0x7c1 || idx == 0x7c8 ||
+         (0x7d0 <= idx && idx <= 0x7d8) || idx == 0xfc0 || idx == 0xfc1;
+}
+
+uint32_t NativeSim::read_csr(uint32_t idx) {
+  if (idx == 0x7c0 || idx == 0x7c1)
+    return flags[idx - 0x7c0];
+  if (idx == 0x7c8)
+    return read_flags();
+  if (0x7d0 <= idx && idx <= 0x7d7)
+    return u256_word(mod, idx - 0x7d0);
+  if (idx == 0x7d8)
+    return 0;
+  if (idx == 0xfc0) {
+    rnd_rep_err_escalate = rnd_rep_err;
+    rnd_fips_err_escalate = rnd_fips_err;
+    return u256_word(rnd_read(), 0);
+  }
+  assert(idx == 0xfc1);
+  ++state_version;
+  return u256_word(urnd_value, 0);
+}
+
+void NativeSim::write_csr(uint32_t idx, uint32_t value) {
+  if (idx == 0x7c0 || idx == 0x7c1) {
+    unsigned shift = 4 * (idx - 0x7c0);
+    write_flags((read_flags() & ~(0xf << shift)) | ((value & 0xf) << shift));
+  } else if (idx == 0x7c8) {
+    write_flags(value);
+  } else if (0x7d0 <= idx && idx <= 0x7d7) {
+    mod_next = mod;
+    u256_set_word(&mod_next, idx - 0x7d0, value);
+    has_mod_next = true;
+  } else if (idx == 0x7d8) {
+    rnd_request_value();
+  }
+  // Writes to RND and URND are ignored
+}
+
+bool NativeSim::rnd_request_value() {
+  if (has_rnd)
+    return true;
+  if (!rnd_pending) {
+    rnd_next_pending = true;
+    rnd_request();
+  }
+  return false;
+}
+
+U256 NativeSim::rnd_read() {
+  assert(has_rnd);
+  has_rnd_next = false;
+  ++state_version;
+  rnd_rep_err_escalate = rnd_rep_err;
+  rnd_fips_err_escalate = rnd_fips_err;
+  return rnd;
+}
+
+U256 NativeSim::read_key(unsigned idx) const {
+  // idx is 0 for KeyS0L, 1 for KeyS0H etc. The low WSR is the bottom 256 bits
+  // of the key and the high one is the top 128 bits, zero-extended.
+  const std::array<uint32_t, 12> &key = keys[idx / 2];
+  uint32_t words[8] = {0};
+  if (idx & 1)
+    std::copy(key.begin() + 8, key.end(), words);
+  else
+    std::copy(key.begin(), key.begin() + 8, words);
+  return u256_from_words(words);
+}
+
+void NativeSim::urnd_set_seed(const uint64_t seed[4]) {
+  urnd_running = true;
+  memcpy(urnd_state[0], seed, sizeof(urnd_state[0]));
+  // Step immediately to update the internal state with the new seed
+  urnd_step();
+}
+
+void NativeSim::urnd_step() {
+  if (!urnd_running)
+    return;
+
+  // A port of URNDWSR.step in otbnsim/sim/wsr.py (a xoshiro256++ PRNG, run
+  // four times in a chain to produce 256 bits).
+  for (unsigned i = 0; i < 4; ++i) {
+    uint64_t st[4];
+    memcpy(st, urnd_state[i], sizeof(st));
+
+    uint64_t *upd = urnd_state[(i + 1) & 3];
+    upd[0] = rol64(st[0] ^ st[2], 45);
+    upd[1] = st[3] ^ (st[2] << 17) ^ st[1];
+    upd[2] = st[3] ^ st[2] ^ st[1];
+    upd[3] = st[3] ^ st[2] ^ st[0];
+
+    urnd_next_value.w[i] = rol64(st[3] + st[0], 23) + st[3];
+  }
+}
+
+bool NativeSim::valid_32b_addr(uint32_t addr) const {
+  return !(addr & 3) && addr / 4 < dmem_data.size();
+}
+
+bool NativeSim::valid_256b_addr(uint32_t addr) const {
+  return !(addr & 31) && addr / 4 < dmem_data.size();
+}
+
+bool NativeSim::load_u32(uint32_t addr, uint32_t *value) const {
+  uint32_t idx = addr / 4;
+  // Handle "read under write" hazards
+  auto it = dmem_pending.find(idx);
+  if (it != dmem_pending.end()) {
+    *value = it->second;
+    return true;
+  }
+  *value = dmem_data[idx];
+  return dmem_valid[idx];
+}
+
+bool NativeSim::load_u256(uint32_t addr, U256 *value) const {
+  uint32_t words[8];
+  for (unsigned i = 0; i < 8; ++i) {
+    if (!load_u32(addr + 4 * i, &words[i]))
+      return false;
+  }
+  *value = u256_from_words(words);
+  return true;
+}
+
+void NativeSim::store_u32(uint32_t addr, uint32_t value) {
+  dmem_stores.push_back(std::make_pair(addr / 4, value));
+}
+
+void NativeSim::loop_start(uint32_t iterations, uint32_t bodysize) {
+  if (loop_stack.size() == 8)
+    loop_err = true;
+
+  LoopLevel level;
+  level.loop_count = iterations;
+  level.restarts_left = iterations - 1;
+  level.start_addr = pc + 4;
+  level.last_addr = level.start_addr + 4 * bodysize - 4;
+  level.iter_start_version = state_version;
+  level.auto_warped = false;
+  loop_stack.push_back(level);
+
+  // Any automatic warp for this loop was found on an earlier run through it
+  // and doesn't apply any more.
+  auto_warps.erase(level.last_addr);
+}
+
+void NativeSim::loop_step() {
+  loop_pop_on_commit = false;
+  if (loop_stack.empty())
+    return;
+
+  LoopLevel &top = loop_stack.back();
+
+  // Apply any loop warp for this address and the current iteration
+  auto warps = loop_warps.find(pc);
+  if (warps != loop_warps.end()) {
+    uint32_t cur_iter_count = top.loop_count - (1 + top.restarts_left);
+    auto warp = warps->second.find(cur_iter_count);
+    if (warp != warps->second.end())
+      top.restarts_left = top.loop_count - warp->second - 1;
+  }
+
+  // Similarly for any automatic warp
+  if (auto_loop_warps) {
+    auto warp = auto_warps.find(pc);
+    if (warp != auto_warps.end() &&
+        top.loop_count - (1 + top.restarts_left) == warp->second.first)
+      top.restarts_left = top.loop_count - warp->second.second - 1;
+  }
+
+  if (pc == top.last_addr) {
+    if (!top.restarts_left) {
+      loop_pop_on_commit = true;
+    } else {
+      --top.restarts_left;
+      set_next_pc(top.start_addr);
+      loop_restart_on_commit = auto_loop_warps;
+    }
+  }
+}
+
+void NativeSim::loop_iter_done() {
+  // This runs at the end of the commit for the last instruction of an
+  // iteration of the innermost loop, which will run again. If the iteration
+  // didn't change any state then neither will any of the iterations after it
+  // (they run the same instructions from the same state), so we can skip to
+  // the last one. The warp is applied two iterations later, so that the RTL
+  // (which asks for warps through OtbnNativeIss::get_auto_loop_warp) sees it
+  // in time, even if it is a cycle ahead of us.
+  assert(!loop_stack.empty());
+  LoopLevel &top = loop_stack.back();
+
+  if (!top.auto_warped && top.iter_start_version == state_version) {
+    // restarts_left has already been decremented for the next iteration
+    uint32_t done_iter = top.loop_count - top.restarts_left - 2;
+    uint32_t from_cnt = done_iter + 2;
+    uint32_t to_cnt = top.loop_count - 1;
+    if (from_cnt < to_cnt) {
+      auto_warps[top.last_addr] = std::make_pair(from_cnt, to_cnt);
+      top.auto_warped = true;
+    }
+  }
+  top.iter_start_version = state_version;
+}
+
+void NativeSim::increment_insn_cnt() {
+  uint32_t value = insn_cnt.read();
+  insn_cnt.write(value == 0xffffffff ? value : value + 1);
+}
+
+void NativeSim::rnd_request() {
+  rnd_client.request();
+  if (rnd_req.read() == 0)
+    rnd_req.write(1);
+}
+
+void NativeSim::rnd_forget() {
+  rnd_client.forget();
+  rnd_req.write(0);
+}
+
+OtbnNativeIss::OtbnNativeIss(uint32_t imem_bytes, uint32_t dmem_bytes)
+    : imem_bytes_(imem_bytes),
+      dmem_bytes_(dmem_bytes),
+      auto_loop_warps_(false),
+      sim_(new NativeSim(imem_bytes, dmem_bytes)) {}
+
+OtbnNativeIss::~OtbnNativeIss() {}
+
+void OtbnNativeIss::add_loop_warp(uint32_t addr, uint32_t from_cnt,
+                                  uint32_t to_cnt) {
+  sim_->loop_warps[addr][from_cnt] = to_cnt;
+}
+
+void OtbnNativeIss::clear_loop_warps() { sim_->loop_warps.clear(); }
+
+void OtbnNativeIss::set_auto_loop_warps(bool enable) {
+  auto_loop_warps_ = enable;
+  sim_->auto_loop_warps = enable;
+  if (!enable)
+    sim_->auto_warps.clear();
+}
+
+bool OtbnNativeIss::get_auto_loop_warp(uint32_t addr, uint32_t from_cnt,
+                                       uint32_t *to_cnt) const {
+  assert(to_cnt);
+  auto warp = sim_->auto_warps.find(addr);
+  if (warp == sim_->auto_warps.end() || warp->second.first != from_cnt)
+    return false;
+  *to_cnt = warp->second.second;
+  return true;
+}
+
+uint8_t *OtbnNativeIss::get_shared_buf(size_t num_bytes) {
+  if (shared_buf_.size() < num_bytes)
+    shared_buf_.resize(num_bytes);
+  return shared_buf_.data();
+}
+
+void OtbnNativeIss::load_d_shared(size_t num_bytes) {
+  assert(num_bytes <= shared_buf_.size());
+  sim_->load_data(shared_buf_.data(), num_bytes);
+}
+
+void OtbnNativeIss::load_i_shared(size_t num_bytes) {
+  assert(num_bytes <= shared_buf_.size());
+  sim_->load_program(shared_buf_.data(), num_bytes);
+}
+
+void OtbnNativeIss::dump_d_shared() const {
+  assert(shared_buf_.size() >= 5 * sim_->dmem_data.size());
+  sim_->dump_data(const_cast<uint8_t *>(shared_buf_.data()));
+}
+
+std::vector<std::pair<uint32_t, uint32_t>> OtbnNativeIss::dump_d_dirty_shared()
+    const {
+  assert(shared_buf_.size() >= 5 * sim_->dmem_data.size());
+  return sim_->dump_dirty_data(const_cast<uint8_t *>(shared_buf_.data()));
+}
+
+void OtbnNativeIss::start_operation(command_t command) {
+  switch (command) {
+    case Execute:
+      sim_->start();
+      break;
+    case DmemWipe:
+      sim_->start_mem_wipe(false);
+      break;
+    case ImemWipe:
+      sim_->start_mem_wipe(true);
+      break;
+  }
+}
+
+void OtbnNativeIss::edn_flush() { sim_->edn_flush(); }
+
+void OtbnNativeIss::edn_rnd_step(uint32_t edn_rnd_data, bool fips_err) {
+  sim_->rnd_client.take_word(edn_rnd_data, fips_err);
+}
+
+void OtbnNativeIss::edn_urnd_step(uint32_t edn_urnd_data) {
+  sim_->urnd_client.take_word(edn_urnd_data, false);
+}
+
+void OtbnNativeIss::edn_rnd_step256(const u256_t &edn_rnd_data,
+                                    uint8_t fips_errs) {
+  for (int i = 0; i < 8; ++i)
+    edn_rnd_step(edn_rnd_data.words[i], (fips_errs >> i) & 1);
+}
+
+void OtbnNativeIss::edn_urnd_step256(const u256_t &edn_urnd_data) {
+  for (int i = 0; i < 8; ++i)
+    edn_urnd_step(edn_urnd_data.words[i]);
+}
+
+void OtbnNativeIss::set_keymgr_value(const std::array<uint32_t, 12> &key0_arr,
+                                     const std::array<uint32_t, 12> &key1_arr,
+                                     bool valid) {
+  sim_->keys_valid = valid;
+  sim_->keys[0] = key0_arr;
+  sim_->keys[1] = key1_arr;
+}
+
+void OtbnNativeIss::otp_key_cdc_done() { sim_->on_otp_cdc_done(); }
+
+void OtbnNativeIss::edn_rnd_cdc_done() { sim_->rnd_completed(); }
+
+void OtbnNativeIss::edn_urnd_cdc_done() { sim_->urnd_completed(); }
+
+int OtbnNativeIss::step(bool gen_trace) {
+  sim_->step();
+
+  // This matches ISSWrapper::update_mirrored, with the changes in the order
+  // of the registers in NativeSim::changes().
+  const uint32_t mask = sim_->changed_mask;
+  const uint32_t *values = sim_->changed_values;
+
+  bool was_stopped = mirrored_.stopped();
+  if (mask & (1 << 0))
+    mirrored_.status = values[0];
+  bool done = mirrored_.stopped() && !was_stopped;
+
+  if (mask & (1 << 1))
+    mirrored_.insn_cnt = values[1];
+  if (mask & (1 << 2))
+    mirrored_.err_bits = values[2];
+  if (mask & (1 << 3))
+    mirrored_.stop_pc = values[3];
+  if (mask & (1 << 4))
+    mirrored_.rnd_req = values[4] != 0;
+  if (mask & (1 << 5))
+    mirrored_.wipe_start = values[5] != 0;
+
+  return done ? 1 : 0;
+}
+
+void OtbnNativeIss::invalidate_imem() { sim_->time_to_imem_invalidation = 2; }
+
+void OtbnNativeIss::invalidate_dmem() { sim_->invalidate_dmem(); }
+
+void OtbnNativeIss::set_software_errs_fatal(bool new_val) {
+  sim_->software_errs_fatal = new_val;
+}
+
+void OtbnNativeIss::initial_secure_wipe() { sim_->start_init_sec_wipe(); }
+
+uint32_t OtbnNativeIss::step_crc(const std::array<uint8_t, 6> &item,
+                                 uint32_t state) const {
+  // A bitwise CRC-32 (the same as zlib's crc32), as used for LOAD_CHECKSUM
+  uint32_t crc = ~state;
+  for (uint8_t byte : item) {
+    crc ^= byte;
+    for (int i = 0; i < 8; ++i)
+      crc = (crc >> 1) ^ (0xedb88320 & -(crc & 1));
+  }
+  return ~crc;
+}
+
+uint32_t OtbnNativeIss::step_crc_block(
+    const std::vector<std::array<uint8_t, 6>> &items, uint32_t state) const {
+  for (const auto &item : items)
+    state = step_crc(item, state);
+  return state;
+}
+
+void OtbnNativeIss::reset(bool gen_trace) {
+  // Like the Python ISS, which makes a new simulator object on reset, this
+  // also throws away any loop warps.
+  sim_.reset(new NativeSim(imem_bytes_, dmem_bytes_));
+  sim_->auto_loop_warps = auto_loop_warps_;
+  mirrored_.reset();
+}
+
+void OtbnNativeIss::send_err_escalation(uint32_t err_val,
+                                        bool lock_immediately) {
+  sim_->injected_err_bits |= err_val;
+  sim_->lock_immediately = lock_immediately;
+}
+
+void OtbnNativeIss::set_rma_req(uint8_t rma_req) {
+  switch (rma_req) {
+    case 0x5:
+      sim_->rma_req = kLcTxOn;
+      break;
+    case 0xa:
+      sim_->rma_req = kLcTxOff;
+      break;
+    default:
+      sim_->rma_req = kLcTxInvalid;
+      break;
+  }
+}
+
+void OtbnNativeIss::get_regs(std::array<uint32_t, 32> *gprs,
+                             std::array<u256_t, 32> *wdrs) {
+  assert(gprs && wdrs);
+
+  for (unsigned i = 0; i < 32; ++i)
+    (*gprs)[i] = sim_->gprs[i];
+  (*gprs)[0] = 0;
+  // Like a backdoor read in the Python ISS, return an obviously bogus value
+  // for x1 if the call stack is empty.
+  (*gprs)[1] = sim_->call_stack.empty() ? 0xcafef00d : sim_->call_stack.back();
+
+  for (unsigned i = 0; i < 32; ++i) {
+    for (unsigned j = 0; j < 8; ++j)
+      (*wdrs)[i].words[j] = u256_word(sim_->wdrs[i], j);
+  }
+}
+
+std::vector<uint32_t> OtbnNativeIss::get_call_stack() {
+  return sim_->call_stack;
+}
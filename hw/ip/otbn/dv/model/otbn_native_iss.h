@@ -0,0 +1,103 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+#ifndef OPENTITAN_HW_IP_OTBN_DV_MODEL_OTBN_NATIVE_ISS_H_
+#define OPENTITAN_HW_IP_OTBN_DV_MODEL_OTBN_NATIVE_ISS_H_
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "otbn_iss.h"
+
+// Forward declaration (the implementation is private in otbn_native_iss.cc)
+struct NativeSim;
+
+// An OTBN ISS that runs in this process.
+//
+// This is a C++ port of the Python ISS in hw/ip/otbn/dv/otbnsim, which
+// remains the reference model. It models the same cycle timing and external
+// register behaviour (so it can stand in for ISSWrapper when OtbnModel drives
+// the SystemVerilog side of otbn_core_model) but doesn't generate a trace, so
+// there is no cycle-by-cycle comparison with the RTL. The final-state checks in
+// OtbnModel::check still work.
+class OtbnNativeIss : public OtbnIss {
+ public:
+  // imem_bytes and dmem_bytes are the sizes of the two memories (including
+  // the DMEM scratchpad that isn't visible over the bus).
+  OtbnNativeIss(uint32_t imem_bytes, uint32_t dmem_bytes);
+  ~OtbnNativeIss() override;
+
+  void add_loop_warp(uint32_t addr, uint32_t from_cnt,
+                     uint32_t to_cnt) override;
+  void clear_loop_warps() override;
+
+  // Enable or disable automatic loop warps. When enabled, the ISS looks for
+  // loop iterations that don't change any architectural state. The iterations
+  // after such an iteration would do exactly the same, so the ISS warps past
+  // them to the last iteration. This is meant for runs that treat OTBN as a
+  // black box and only care about the final state: it changes the number of
+  // cycles that an operation takes, so the RTL must apply the same warps (see
+  // get_auto_loop_warp) to stay in step.
+  void set_auto_loop_warps(bool enable);
+
+  // If the ISS has found an automatic loop warp for the instruction at addr
+  // with an innermost loop count of from_cnt, write the count that it warps to
+  // to *to_cnt and return true. Counts use the same convention as
+  // add_loop_warp.
+  bool get_auto_loop_warp(uint32_t addr, uint32_t from_cnt,
+                          uint32_t *to_cnt) const;
+
+  // There is no other process here, so the "shared" buffer is just a buffer
+  // owned by this object.
+  uint8_t *get_shared_buf(size_t num_bytes) override;
+  void load_d_shared(size_t num_bytes) override;
+  void load_i_shared(size_t num_bytes) override;
+  void dump_d_shared() const override;
+  std::vector<std::pair<uint32_t, uint32_t>> dump_d_dirty_shared()
+      const override;
+
+  void start_operation(command_t command) override;
+  void edn_flush() override;
+  void edn_rnd_step(uint32_t edn_rnd_data, bool fips_err) override;
+  void edn_urnd_step(uint32_t edn_urnd_data) override;
+  void edn_rnd_step256(const u256_t &edn_rnd_data, uint8_t fips_errs) override;
+  void edn_urnd_step256(const u256_t &edn_urnd_data) override;
+  void set_keymgr_value(const std::array<uint32_t, 12> &key0_arr,
+                        const std::array<uint32_t, 12> &key1_arr,
+                        bool valid) override;
+  void otp_key_cdc_done() override;
+  void edn_rnd_cdc_done() override;
+  void edn_urnd_cdc_done() override;
+
+  // gen_trace is ignored: this ISS doesn't generate trace data.
+  int step(bool gen_trace) override;
+
+  void invalidate_imem() override;
+  void invalidate_dmem() override;
+  void set_software_errs_fatal(bool new_val) override;
+  void initial_secure_wipe() override;
+  uint32_t step_crc(const std::array<uint8_t, 6> &item,
+                    uint32_t state) const override;
+  uint32_t step_crc_block(const std::vector<std::array<uint8_t, 6>> &items,
+                          uint32_t state) const override;
+  void reset(bool gen_trace) override;
+  void send_err_escalation(uint32_t err_val, bool lock_immediately) override;
+  void set_rma_req(uint8_t rma_req) override;
+  void get_regs(std::array<uint32_t, 32> *gprs,
+                std::array<u256_t, 32> *wdrs) override;
+  std::vector<uint32_t> get_call_stack() override;
+
+ private:
+  uint32_t imem_bytes_;
+  uint32_t dmem_bytes_;
+  bool auto_loop_warps_;
+
+  std::unique_ptr<NativeSim> sim_;
+
+  std::vector<uint8_t> shared_buf_;
+};
+
+#endif  // OPENTITAN_HW_IP_OTBN_DV_MODEL_OTBN_NATIVE_ISS_H_
@@ -5,6 +5,7 @@
 #include "otbn_trace_checker.h"
 
 #include <cassert>
+#include <cstdlib>
 #include <cstring>
 #include <iostream>
 #include <memory>
@@ -14,6 +15,23 @@
 
 static std::unique_ptr<OtbnTraceChecker> trace_checker;
 
+// Return the number of matched entries to remember for error reports. This is
+// read from the OTBN_TRACE_CHECKER_HISTORY environment variable if it is set.
+static size_t get_history_size() {
+  const char *size_str = getenv("OTBN_TRACE_CHECKER_HISTORY");
+  if (!size_str)
+    return 16;
+
+  char *end;
+  unsigned long size = strtoul(size_str, &end, 0);
+  if (end == size_str || *end != '\0') {
+    std::cerr << "WARNING: Ignoring OTBN_TRACE_CHECKER_HISTORY value `"
+              << size_str << "': not a number.\n";
+    return 16;
+  }
+  return size;
+}
+
 OtbnTraceChecker::OtbnTraceChecker()
     : rtl_started_(false),
       rtl_pending_(false),
@@ -21,7 +39,10 @@ OtbnTraceChecker::OtbnTraceChecker()
       iss_pending_(false),
       done_(true),
       seen_err_(false),
-      last_data_vld_(false) {
+      last_data_vld_(false),
+      history_(get_history_size()),
+      history_next_(0),
+      history_len_(0) {
   OtbnTraceSource::get().AddListener(this);
 }
 
@@ -40,16 +61,15 @@ OtbnTraceChecker &OtbnTraceChecker::get() {
   return *trace_checker;
 }
 
-void OtbnTraceChecker::AcceptTraceString(const std::string &trace,
-                                         unsigned int cycle_count) {
+void OtbnTraceChecker::AcceptTraceRecord(const OtbnTraceRecord &record) {
   assert(!(rtl_pending_ && iss_pending_));
 
   if (seen_err_)
     return;
 
   done_ = false;
-  OtbnTraceEntry trace_entry;
-  if (!trace_entry.from_rtl_trace(trace)) {
+  OtbnTraceEntry &trace_entry = rtl_scratch_;
+  if (!trace_entry.from_rtl_trace(record)) {
     seen_err_ = true;
     return;
   }
@@ -83,6 +103,7 @@ void OtbnTraceChecker::AcceptTraceString(const std::string &trace,
     rtl_entry_.print("    ", std::cerr);
     std::cerr << "  Second RTL entry was:\n";
     trace_entry.print("    ", std::cerr);
+    PrintHistory();
     seen_err_ = true;
     return;
   }
@@ -118,7 +139,7 @@ void OtbnTraceChecker::AcceptTraceString(const std::string &trace,
       // This is the first partial entry. Set the rtl_started_ flag and save
       // trace_entry.
       rtl_started_ = true;
-      rtl_entry_ = trace_entry;
+      rtl_entry_.swap(trace_entry);
     }
     return;
   }
@@ -146,7 +167,7 @@ void OtbnTraceChecker::AcceptTraceString(const std::string &trace,
 
   rtl_pending_ = true;
   rtl_started_ = false;
-  rtl_entry_ = trace_entry;
+  rtl_entry_.swap(trace_entry);
 
   if (!MatchPair()) {
     seen_err_ = true;
@@ -160,7 +181,7 @@ bool OtbnTraceChecker::OnIssTrace(const std::vector<std::string> &lines) {
     return false;
   }
 
-  OtbnIssTraceEntry trace_entry;
+  OtbnIssTraceEntry &trace_entry = iss_scratch_;
   if (!trace_entry.from_iss_trace(lines)) {
     // Error parsing ISS trace. This has already printed a message to stderr.
     // Just return false to pass the error code along.
@@ -180,6 +201,7 @@ bool OtbnTraceChecker::OnIssTrace(const std::vector<std::string> &lines) {
     iss_entry_.print("    ", std::cerr);
     std::cerr << "  Second ISS entry was:\n";
     trace_entry.print("    ", std::cerr);
+    PrintHistory();
     seen_err_ = true;
     return false;
   }
@@ -192,7 +214,7 @@ bool OtbnTraceChecker::OnIssTrace(const std::vector<std::string> &lines) {
   }
 
   iss_started_ = true;
-  iss_entry_ = trace_entry;
+  iss_entry_.swap(trace_entry);
 
   // Set the pending flag if we've got the end of an event (either E or V).
   if (iss_entry_.is_final()) {
@@ -208,6 +230,8 @@ void OtbnTraceChecker::Flush() {
   iss_pending_ = false;
   iss_started_ = false;
   no_sec_wipe_data_chk_ = false;
+  history_next_ = 0;
+  history_len_ = 0;
 }
 
 bool OtbnTraceChecker::Finish() {
@@ -261,6 +285,7 @@ bool OtbnTraceChecker::MatchPair() {
     rtl_entry_.print("    ", std::cerr);
     std::cerr << "  ISS entry is:\n";
     iss_entry_.print("    ", std::cerr);
+    PrintHistory();
     seen_err_ = true;
     return false;
     if (rtl_entry_.trace_type() == OtbnTraceEntry::WipeComplete) {
@@ -274,9 +299,36 @@ bool OtbnTraceChecker::MatchPair() {
     last_data_vld_ = true;
   }
 
+  PushHistory(rtl_entry_);
   return true;
 }
 
+void OtbnTraceChecker::PushHistory(const OtbnTraceEntry &entry) {
+  if (history_.empty())
+    return;
+
+  // Assign into the existing slot, so that (once the ring is full) its string
+  // buffer gets reused rather than reallocated.
+  history_[history_next_].assign(entry.header());
+  history_next_ = (history_next_ + 1) % history_.size();
+  if (history_len_ < history_.size())
+    ++history_len_;
+}
+
+void OtbnTraceChecker::PrintHistory() const {
+  if (history_len_ == 0)
+    return;
+
+  std::cerr << "  The last " << history_len_
+            << " matching entries (oldest first) were:\n";
+  size_t idx = (history_next_ + history_.size() - history_len_) %
+               history_.size();
+  for (size_t i = 0; i < history_len_; ++i) {
+    std::cerr << "    " << history_[idx] << "\n";
+    idx = (idx + 1) % history_.size();
+  }
+}
+
 // Exposed over DPI as:
 //
 //  import "DPI-C" function bit
@@ -34,6 +34,12 @@
 //
 // To catch these cases, the ISS simulation must call the Finish() method when
 // it is done (which checks there are no outstanding events missing).
+//
+// The checker holds at most one (coalesced) entry from each side, so its memory
+// use doesn't depend on the length of the run. To give some context when it
+// reports an error, it also remembers the headers of the most recent matched
+// entries in a small ring buffer. Its size defaults to 16 and can be set with
+// the OTBN_TRACE_CHECKER_HISTORY environment variable (0 disables it).
 
 #include <iosfwd>
 #include <string>
@@ -52,8 +58,7 @@ class OtbnTraceChecker : public OtbnTraceListener {
 
   // Take a trace entry from the wrapped RTL. Any mismatch error is stored
   // until the next call to an API function that can respond with the error.
-  void AcceptTraceString(const std::string &trace,
-                         unsigned int cycle_count) override;
+  void AcceptTraceRecord(const OtbnTraceRecord &record) override;
 
   // Take a trace entry from the wrapped ISS.
   //
@@ -87,6 +92,18 @@ class OtbnTraceChecker : public OtbnTraceListener {
   // message to stderr and return false.
   bool MatchPair();
 
+  // Add the header of a matched entry to the history ring buffer
+  void PushHistory(const OtbnTraceEntry &entry);
+
+  // Print the history ring buffer, oldest first, to stderr
+  void PrintHistory() const;
+
+  // Entries that incoming traces get parsed into. These are only used as
+  // scratch space but, being reused, they avoid allocating new strings for
+  // every trace entry.
+  OtbnTraceEntry rtl_scratch_;
+  OtbnIssTraceEntry iss_scratch_;
+
   bool rtl_started_;
   bool rtl_pending_;
   OtbnTraceEntry rtl_entry_;
@@ -103,6 +120,12 @@ class OtbnTraceChecker : public OtbnTraceListener {
   bool last_data_vld_;
   OtbnIssTraceEntry::IssData last_data_;
   bool no_sec_wipe_data_chk_;
+
+  // Headers of the most recently matched entries. history_next_ is the slot
+  // that will be written next and history_len_ is the number of valid slots.
+  std::vector<std::string> history_;
+  size_t history_next_;
+  size_t history_len_;
 };
 
 #endif  // OPENTITAN_HW_IP_OTBN_DV_MODEL_OTBN_TRACE_CHECKER_H_
@@ -6,27 +6,41 @@
 
 #include <cassert>
 #include <iostream>
-#include <regex>
+#include <cstring>
 #include <sstream>
+#include <utility>
 
 bool OtbnTraceBodyLine::fill_from_string(const std::string &src,
                                          const std::string &line) {
-  // A valid line matches the following regex
-  std::regex re("(.) ([^:]+): (.+)");
-  std::smatch match;
+  return fill_from_line(src, OtbnTraceLine{line.data(), line.size()});
+}
+
+bool OtbnTraceBodyLine::fill_from_line(const std::string &src,
+                                       const OtbnTraceLine &line) {
+  // A valid line is of the form "T LOC: VALUE", where T is a single character,
+  // LOC is a non-empty string containing no ':' and VALUE is non-empty. No
+  // part may contain a newline.
+  const char *text = line.text;
+  size_t len = line.len;
+
+  const char *colon = nullptr;
+  if (len >= 2 && text[1] == ' ' && !memchr(text, '\n', len)) {
+    colon = static_cast<const char *>(memchr(text + 2, ':', len - 2));
+  }
+  size_t loc_len = colon ? colon - (text + 2) : 0;
+  size_t value_pos = 2 + loc_len + 2;
 
-  if (!std::regex_match(line, match, re)) {
+  if (!colon || loc_len == 0 || value_pos >= len || colon[1] != ' ') {
     std::cerr << "OTBN trace body line from " << src
-              << " does not have expected format. Saw: `" << line << "'.\n";
+              << " does not have expected format. Saw: `";
+    std::cerr.write(text, len) << "'.\n";
     return false;
   }
 
-  assert(match.size() == 4);
-
-  raw_ = line;
-  type_ = match[1].str()[0];
-  loc_ = match[2].str();
-  value_ = match[3].str();
+  raw_.assign(text, len);
+  type_ = text[0];
+  loc_.assign(text + 2, loc_len);
+  value_.assign(text + value_pos, len - value_pos);
   return true;
 }
 
@@ -63,27 +77,48 @@ bool OtbnTraceBodyLine::operator==(const OtbnTraceBodyLine &other) const {
   return true;
 }
 
-bool OtbnTraceEntry::from_rtl_trace(const std::string &trace) {
-  size_t eol = trace.find('\n');
-  hdr_ = trace.substr(0, eol);
+void OtbnTraceWrites::append(const OtbnTraceBodyLine &line) {
+  if (!(line == first)) {
+    changed = true;
+  }
+  last = line;
+  ++count;
+}
+
+void OtbnTraceWrites::append(const OtbnTraceWrites &later) {
+  // If later.first matches our first write then any write in later that
+  // differs from later.first also differs from our first write (when there are
+  // no unknown digits), so later.changed carries over.
+  if (later.changed || !(later.first == first)) {
+    changed = true;
+  }
+  last = later.last;
+  count += later.count;
+}
+
+bool OtbnTraceEntry::from_rtl_trace(const OtbnTraceRecord &record) {
+  const std::vector<OtbnTraceLine> &lines = record.lines();
+  if (lines.empty()) {
+    hdr_.clear();
+  } else {
+    hdr_.assign(lines[0].text, lines[0].len);
+  }
   trace_type_ = hdr_to_trace_type(hdr_);
+  writes_.clear();
 
-  while (eol != std::string::npos) {
-    size_t bol = eol + 1;
-    eol = trace.find('\n', bol);
-    size_t line_len =
-        (eol == std::string::npos) ? std::string::npos : eol - bol;
-    std::string line = trace.substr(bol, line_len);
+  // Parse body lines into a single object, so that its strings' buffers get
+  // reused from line to line.
+  OtbnTraceBodyLine parsed_line;
 
+  for (size_t i = 1; i < lines.size(); ++i) {
     // We're only interested in register writes
-    if (!(line.size() > 0 && line[0] == '>'))
+    if (lines[i].type() != '>')
       continue;
 
-    OtbnTraceBodyLine parsed_line;
-    if (!parsed_line.fill_from_string("RTL", line)) {
+    if (!parsed_line.fill_from_line("RTL", lines[i])) {
       return false;
     }
-    writes_[parsed_line.get_loc()].push_back(parsed_line);
+    add_write(parsed_line);
   }
   return true;
 }
@@ -128,8 +163,14 @@ bool OtbnTraceEntry::compare_rtl_iss_entries(const OtbnTraceEntry &other,
 void OtbnTraceEntry::print(const std::string &indent, std::ostream &os) const {
   os << indent << hdr_ << "\n";
   for (const auto &pr : writes_) {
-    for (const auto &line : pr.second) {
-      os << indent << line.get_string() << "\n";
+    const OtbnTraceWrites &writes = pr.second;
+    os << indent << writes.first.get_string() << "\n";
+    if (writes.count > 2) {
+      os << indent << "  (" << writes.count - 2 << " more write"
+         << (writes.count > 3 ? "s" : "") << " to " << pr.first << ")\n";
+    }
+    if (writes.count > 1) {
+      os << indent << writes.last.get_string() << "\n";
     }
   }
 }
@@ -137,22 +178,36 @@ void OtbnTraceEntry::print(const std::string &indent, std::ostream &os) const {
 void OtbnTraceEntry::take_writes(const OtbnTraceEntry &other,
                                  bool other_first) {
   for (const auto &pr : other.writes_) {
-    std::vector<OtbnTraceBodyLine> &so_far = writes_[pr.first];
-    if (other_first) {
-      // If other_first is true, we should prepend the writes from other. We do
-      // so by creating a temporary vector (with a copy of the writes from
-      // other) and then appending any writes we had before.
-      std::vector<OtbnTraceBodyLine> tmp(pr.second);
-      tmp.insert(tmp.end(), so_far.begin(), so_far.end());
-      writes_[pr.first] = tmp;
+    auto it = writes_.find(pr.first);
+    if (it == writes_.end()) {
+      writes_.emplace(pr.first, pr.second);
+    } else if (other_first) {
+      // The writes from other came first, so they go at the front: take a copy
+      // of them and append the writes we had before.
+      OtbnTraceWrites merged(pr.second);
+      merged.append(it->second);
+      it->second = merged;
     } else {
-      // If other_first is false, we should append the writes from other. We
-      // can do that with just a call to insert.
-      so_far.insert(so_far.end(), pr.second.begin(), pr.second.end());
+      it->second.append(pr.second);
     }
   }
 }
 
+void OtbnTraceEntry::swap(OtbnTraceEntry &other) {
+  std::swap(trace_type_, other.trace_type_);
+  hdr_.swap(other.hdr_);
+  writes_.swap(other.writes_);
+}
+
+void OtbnTraceEntry::add_write(const OtbnTraceBodyLine &line) {
+  auto it = writes_.find(line.get_loc());
+  if (it == writes_.end()) {
+    writes_.emplace(line.get_loc(), OtbnTraceWrites(line));
+  } else {
+    it->second.append(line);
+  }
+}
+
 bool OtbnTraceEntry::is_compatible(const OtbnTraceEntry &prev) const {
   // Two entries are compatible if they might both come from the multi-cycle
   // execution of one instruction. For example, you might expect to see these
@@ -223,10 +278,8 @@ bool OtbnTraceEntry::is_final() const {
 
 bool OtbnTraceEntry::check_entries_compatible(
     trace_type_t type, const std::string &key,
-    const std::vector<OtbnTraceBodyLine> &rtl_lines,
-    const std::vector<OtbnTraceBodyLine> &iss_lines, bool no_sec_wipe_data_chk,
-    std::string *err_desc) {
-  assert(rtl_lines.size() && iss_lines.size());
+    const OtbnTraceWrites &rtl_writes, const OtbnTraceWrites &iss_writes,
+    bool no_sec_wipe_data_chk, std::string *err_desc) {
   assert(type == WipeComplete || type == Exec);
   assert(err_desc);
 
@@ -235,9 +288,9 @@ bool OtbnTraceEntry::check_entries_compatible(
     // the key. We will also check that they are different, but
     // debugging is probably easier if the error message comments that
     // there aren't two lines *to* be different.
-    if (rtl_lines.size() < 2) {
+    if (rtl_writes.count < 2) {
       std::ostringstream oss;
-      oss << "There are " << rtl_lines.size() << " RTL lines for key `" << key
+      oss << "There are " << rtl_writes.count << " RTL lines for key `" << key
           << "'; we expected at least 2.";
       *err_desc = oss.str();
       return false;
@@ -246,15 +299,7 @@ bool OtbnTraceEntry::check_entries_compatible(
     // Make sure that the multiple writes to key actually contain
     // different values. This checks that we don't (e.g.) just write
     // zero to the key many times.
-    bool seen_change = false;
-    for (size_t i = 1; i < rtl_lines.size(); i++) {
-      if (!(rtl_lines[i] == rtl_lines[0])) {
-        seen_change = true;
-        break;
-      }
-    }
-
-    if (!seen_change && !no_sec_wipe_data_chk) {
+    if (!rtl_writes.changed && !no_sec_wipe_data_chk) {
       std::ostringstream oss;
       oss << "All RTL lines for key `" << key << "' are identical.";
       *err_desc = oss.str();
@@ -262,7 +307,7 @@ bool OtbnTraceEntry::check_entries_compatible(
     }
   }
 
-  if (!(rtl_lines.back() == iss_lines.back())) {
+  if (!(rtl_writes.last == iss_writes.last)) {
     std::ostringstream oss;
     oss << "Final values of ISS and RTL don't match for key `" << key << "'.";
     *err_desc = oss.str();
@@ -294,13 +339,49 @@ OtbnTraceEntry::trace_type_t OtbnTraceEntry::hdr_to_trace_type(
   }
 }
 
+void OtbnIssTraceEntry::swap(OtbnIssTraceEntry &other) {
+  OtbnTraceEntry::swap(other);
+  std::swap(data_.insn_addr, other.data_.insn_addr);
+  data_.mnemonic.swap(other.data_.mnemonic);
+}
+
+bool OtbnIssTraceEntry::parse_special_line(const std::string &line) {
+  // The line is "# @0x", then exactly 8 lower-case hex digits, then ": " and
+  // the mnemonic (which may be empty but mustn't contain a newline).
+  static const char prefix[] = "# @0x";
+  const size_t addr_pos = sizeof(prefix) - 1;
+  const size_t mnemonic_pos = addr_pos + 8 + 2;
+
+  if (line.size() < mnemonic_pos || line.compare(0, addr_pos, prefix) != 0 ||
+      line.compare(addr_pos + 8, 2, ": ") != 0 ||
+      line.find('\n', mnemonic_pos) != std::string::npos)
+    return false;
+
+  uint32_t addr = 0;
+  for (size_t i = addr_pos; i < addr_pos + 8; ++i) {
+    char c = line[i];
+    if ('0' <= c && c <= '9') {
+      addr = (addr << 4) | (uint32_t)(c - '0');
+    } else if ('a' <= c && c <= 'f') {
+      addr = (addr << 4) | (uint32_t)(c - 'a' + 10);
+    } else {
+      return false;
+    }
+  }
+
+  data_.insn_addr = addr;
+  data_.mnemonic = line.substr(mnemonic_pos);
+  return true;
+}
+
 bool OtbnIssTraceEntry::from_iss_trace(const std::vector<std::string> &lines) {
   // Read FSM. state 0 = read header; state 1 = read mnemonic (for E
   // lines); state 2 = read writes
   int state = 0;
-
-  std::regex re("# @0x([0-9a-f]{8}): (.*)");
-  std::smatch match;
+  hdr_.clear();
+  trace_type_ = Invalid;
+  writes_.clear();
+  OtbnTraceBodyLine parsed_line;
 
   for (const std::string &line : lines) {
     switch (state) {
@@ -318,15 +399,11 @@ bool OtbnIssTraceEntry::from_iss_trace(const std::vector<std::string> &lines) {
         //
         // where ADDR is an 8-digit instruction address (in hex) and mnemonic
         // is the string mnemonic.
-        if (!std::regex_match(line, match, re)) {
+        if (!parse_special_line(line)) {
           std::cerr << "Bad 'special' line for ISS trace with header `" << hdr_
                     << "': `" << line << "'.\n";
           return false;
         }
-        assert(match.size() == 3);
-        data_.insn_addr =
-            (uint32_t)strtoul(match[1].str().c_str(), nullptr, 16);
-        data_.mnemonic = match[2].str();
         state = 2;
         break;
 
@@ -336,11 +413,10 @@ bool OtbnIssTraceEntry::from_iss_trace(const std::vector<std::string> &lines) {
         // external register changes, not tracked by the RTL core simulation)
         bool is_bang = (line.size() > 0 && line[0] == '!');
         if (!is_bang) {
-          OtbnTraceBodyLine parsed_line;
           if (!parsed_line.fill_from_string("ISS", line)) {
             return false;
           }
-          writes_[parsed_line.get_loc()].push_back(parsed_line);
+          add_write(parsed_line);
         }
         break;
       }
@@ -9,6 +9,8 @@
 #include <string>
 #include <vector>
 
+#include "otbn_trace_record.h"
+
 // This models a body line in an OTBN trace entry (type '<', '>', 'R' or 'W').
 // Each of these lines is of the format
 //
@@ -24,6 +26,9 @@ class OtbnTraceBodyLine {
   // say where the line came from) and return false.
   bool fill_from_string(const std::string &src, const std::string &line);
 
+  // As above, but parsing a line of a trace record in place
+  bool fill_from_line(const std::string &src, const OtbnTraceLine &line);
+
   bool operator==(const OtbnTraceBodyLine &other) const;
 
   // Return the location that is being read or written
@@ -39,6 +44,29 @@ class OtbnTraceBodyLine {
   std::string value_;
 };
 
+// A summary of the writes to one location within a trace entry. A multi-cycle
+// instruction or a secure wipe can write to a location many times, but the
+// checks in OtbnTraceEntry only ever look at the first and last writes, the
+// number of writes and whether any write differed from the first one. Keeping
+// just that means an entry's size doesn't grow with the number of cycles it
+// covers, and merging two entries is constant time per location.
+struct OtbnTraceWrites {
+  OtbnTraceBodyLine first;
+  OtbnTraceBodyLine last;
+  size_t count;
+  // True if some write after the first had a different value from it
+  bool changed;
+
+  explicit OtbnTraceWrites(const OtbnTraceBodyLine &line)
+      : first(line), last(line), count(1), changed(false) {}
+
+  // Add a write that came after the writes summarised here
+  void append(const OtbnTraceBodyLine &line);
+
+  // Merge in writes that came after the writes summarised here
+  void append(const OtbnTraceWrites &later);
+};
+
 class OtbnTraceEntry {
  public:
   enum trace_type_t {
@@ -52,9 +80,9 @@ class OtbnTraceEntry {
 
   virtual ~OtbnTraceEntry(){};
 
-  // Parse a trace entry from the RTL into this object. On an error, print a
-  // message to stderr and return false.
-  bool from_rtl_trace(const std::string &trace);
+  // Parse a trace entry from the RTL into this object, replacing its previous
+  // contents. On an error, print a message to stderr and return false.
+  bool from_rtl_trace(const OtbnTraceRecord &record);
 
   bool compare_rtl_iss_entries(const OtbnTraceEntry &other,
                                bool no_sec_wipe_data_chk,
@@ -64,8 +92,14 @@ class OtbnTraceEntry {
 
   void take_writes(const OtbnTraceEntry &other, bool other_first);
 
+  // Exchange contents with other without copying
+  void swap(OtbnTraceEntry &other);
+
   trace_type_t trace_type() const { return trace_type_; }
 
+  // Return the header line of the entry
+  const std::string &header() const { return hdr_; }
+
   // True if this is an acceptable line to follow other (assumed to
   // have been of type Stall or WipeInProgress)
   bool is_compatible(const OtbnTraceEntry &other) const;
@@ -79,20 +113,24 @@ class OtbnTraceEntry {
  protected:
   static bool check_entries_compatible(
       trace_type_t type, const std::string &key,
-      const std::vector<OtbnTraceBodyLine> &rtl_lines,
-      const std::vector<OtbnTraceBodyLine> &iss_lines,
+      const OtbnTraceWrites &rtl_writes, const OtbnTraceWrites &iss_writes,
       bool no_sec_wipe_data_chk, std::string *err_desc);
 
   static trace_type_t hdr_to_trace_type(const std::string &hdr);
 
+  // Record a write parsed from a body line
+  void add_write(const OtbnTraceBodyLine &line);
+
   trace_type_t trace_type_;
   std::string hdr_;
   // The register writes for this trace entry, keyed by destination
-  std::map<std::string, std::vector<OtbnTraceBodyLine>> writes_;
+  std::map<std::string, OtbnTraceWrites> writes_;
 };
 
 class OtbnIssTraceEntry : public OtbnTraceEntry {
  public:
+  // Parse a trace entry from the ISS into this object, replacing its previous
+  // contents. On an error, print a message to stderr and return false.
   bool from_iss_trace(const std::vector<std::string> &lines);
 
   // Fields that are populated from the "special" line for ISS entries
@@ -102,6 +140,13 @@ class OtbnIssTraceEntry : public OtbnTraceEntry {
   };
 
   IssData data_;
+
+  void swap(OtbnIssTraceEntry &other);
+
+ private:
+  // Parse the "special" line (of the form "# @ADDR: MNEMONIC") into data_.
+  // Returns false if the line doesn't have that form.
+  bool parse_special_line(const std::string &line);
 };
 
 #endif  // OPENTITAN_HW_IP_OTBN_DV_MODEL_OTBN_TRACE_ENTRY_H_
@@ -3,7 +3,7 @@
 # SPDX-License-Identifier: Apache-2.0
 
 import struct
-from typing import Dict, List, Sequence, Optional
+from typing import Dict, List, Optional, Sequence, Set, Tuple
 
 from shared.mem_layout import get_memory_layout
 
@@ -66,6 +66,12 @@ class Dmem:
         self.trace: List[TraceDmemStore] = []
         self.pending: Dict[int, int] = {}
 
+        # The indices of words that have been written (by stores or an
+        # invalidation) since DMEM was last loaded. When checking the model
+        # against the RTL, which started with the same contents, only these
+        # words can differ.
+        self.dirty: Set[int] = set()
+
     def _load_5byte_le_words(self, data: bytes) -> None:
         '''Replace the start of memory with data
 
@@ -129,6 +135,17 @@ class Dmem:
             self._load_5byte_le_words(data)
         else:
             self._load_4byte_le_words(data)
+        self.dirty = set()
+
+    def _dump_le_word(self, idx: int) -> bytes:
+        '''Return the 32-bit word at index idx formatted for dump_le_words'''
+        # If there's a pending store, apply it. This matches the RTL, where
+        # we only observe the memory after that store has landed.
+        u32 = self.pending.get(idx, self.data[idx])
+
+        if u32 is None:
+            return struct.pack('<BI', 0, 0)
+        return struct.pack('<BI', 1, u32)
 
     def dump_le_words(self) -> bytes:
         '''Return the contents of memory as bytes.
@@ -137,17 +154,29 @@ class Dmem:
         words are themselves packed little-endian into 256-bit words.
 
         '''
-        ret = b''
-        for idx, u32 in enumerate(self.data):
-            # If there's a pending store, apply it. This matches the RTL, where
-            # we only observe the memory after that store has landed.
-            u32 = self.pending.get(idx, u32)
+        return b''.join(self._dump_le_word(idx)
+                        for idx in range(len(self.data)))
 
-            if u32 is None:
-                ret += struct.pack('<BI', 0, 0)
-            else:
-                ret += struct.pack('<BI', 1, u32)
+    def dump_dirty_le_words(self) -> List[Tuple[int, bytes]]:
+        '''Return the words written since DMEM was last loaded.
 
+        The result is a list of pairs (idx, data), one for each run of
+        consecutive dirty words, where idx is the index of the first 32-bit
+        word in the run and data is the run formatted as for dump_le_words.
+
+        '''
+        ret: List[Tuple[int, bytes]] = []
+        run_start = 0
+        run: List[bytes] = []
+        for idx in sorted(self.dirty):
+            if run and idx != run_start + len(run):
+                ret.append((run_start, b''.join(run)))
+                run = []
+            if not run:
+                run_start = idx
+            run.append(self._dump_le_word(idx))
+        if run:
+            ret.append((run_start, b''.join(run)))
         return ret
 
     def is_valid_256b_addr(self, addr: int) -> bool:
@@ -236,10 +265,12 @@ class Dmem:
             for i in range(256 // 32):
                 wr_data = (item.value >> (i * 32)) & mask
                 self.pending[(item.addr // 4) + i] = wr_data
+                self.dirty.add((item.addr // 4) + i)
 
         else:
             assert 0 <= item.value <= (1 << 32) - 1
             self.pending[item.addr // 4] = item.value
+            self.dirty.add(item.addr // 4)
 
     def commit(self) -> None:
         # Move items from self.pending to self.data
@@ -257,3 +288,4 @@ class Dmem:
 
     def empty_dmem(self) -> None:
         self.data = [None] * len(self.data)
+        self.dirty = set(range(len(self.data)))
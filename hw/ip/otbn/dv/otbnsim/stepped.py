@@ -37,6 +37,25 @@ prefixed with "0x" if they are hexadecimal.
     dump_d <path>           Write the current contents of DMEM to <path> (same
                             format as for load).
 
+    map_mem <path> <bytes>  Map the first <bytes> bytes of the file at <path>,
+                            which is shared with the process driving the
+                            simulation, for the commands below.
+
+    load_d_mapped <bytes>   Like load_d, reading <bytes> bytes from the start
+                            of the mapped file.
+
+    load_i_mapped <bytes>   Like load_i, reading <bytes> bytes from the start
+                            of the mapped file.
+
+    dump_d_mapped           Like dump_d, writing to the start of the mapped
+                            file.
+
+    dump_d_dirty_mapped     Like dump_d_mapped, but only write the words that
+                            have been written since DMEM was loaded, leaving
+                            the rest of the mapped file unchanged. Prints a
+                            line "DIRTY <idx> <count>" for each run of <count>
+                            such words, starting at word <idx>.
+
     print_regs              Write the hex contents of all registers to stdout
 
     edn_rnd_step            Send 32b RND Data to the model.
@@ -46,6 +65,15 @@ prefixed with "0x" if they are hexadecimal.
 
     edn_urnd_step           Send 32b URND seed data to the model.
 
+    edn_rnd_step256 <data> <fips_errs>
+                            Send a whole 256b RND value to the model, as if by
+                            8 edn_rnd_step commands starting with the least
+                            significant word. Bit i of <fips_errs> is the FIPS
+                            error flag for word i.
+
+    edn_urnd_step256 <data> Send a whole 256b URND seed to the model, as if by
+                            8 edn_urnd_step commands.
+
     edn_urnd_cdc_done       Finish the URND resseding process by signalling RTL
                             is also finished processing 32b packages from EDN
                             and set the seed.
@@ -67,19 +95,82 @@ prefixed with "0x" if they are hexadecimal.
                             change of state (this is pure, but handled in
                             Python to simplify verification).
 
+    step_crc_block <state> <item>...
+                            Like step_crc, but step the CRC with each 48-bit
+                            item in turn.
+
     send_err_escalation     React to an injected error.
 
     set_software_errs_fatal Set software_errs_fatal bit.
+
+    run <max_cycles>        Run up to <max_cycles> cycles, stopping early when
+                            the operation finishes or the model requests RND
+                            data. Print trace information for all cycles.
+
+The response to each command is a single binary frame on stdout. The frame
+starts with a fixed-size header of little-endian 32-bit words:
+
+    text_len                Number of bytes of text following the header
+    ext_written             Bitmask of the external registers (in the order of
+                            EXT_REG_NAMES) that were written by the command
+    ext_values[...]         The final value of each written external register
+    cycles                  Number of cycles stepped by the command
+
+The text is everything the command printed (trace lines for step and run),
+one line per entry.
 '''
 
 import binascii
+import io
+import mmap
+import struct
 import sys
-from typing import List, Optional
+from contextlib import redirect_stdout
+from typing import Dict, List, Optional
 
-from sim.decode import decode_file
+from sim.decode import decode_bytes, decode_file
+from sim.ext_regs import TraceExtRegChange
 from sim.load_elf import load_elf
 from sim.sim import OTBNSim
 
+# External registers that are reported in the header of each response, in the
+# order of bits in ext_written (this must match ISSWrapper).
+EXT_REG_NAMES = ['STATUS', 'INSN_CNT', 'ERR_BITS', 'STOP_PC',
+                 'RND_REQ', 'WIPE_START', 'LOAD_CHECKSUM']
+
+_FRAME_HDR = struct.Struct('<II{}II'.format(len(EXT_REG_NAMES)))
+
+# The file mapped by map_mem, through which memory contents are exchanged with
+# the process driving the simulation.
+_MAPPED_MEM = None  # type: Optional[mmap.mmap]
+
+
+class Response:
+    '''Non-text parts of the response to a command'''
+    def __init__(self) -> None:
+        self.ext_regs = {}  # type: Dict[str, int]
+        self.cycles = 0
+
+    def set_ext_reg(self, name: str, value: int) -> None:
+        if name in EXT_REG_NAMES:
+            self.ext_regs[name] = value
+
+    def to_frame(self, text: str) -> bytes:
+        payload = text.encode('utf-8')
+        written = 0
+        values = []
+        for idx, name in enumerate(EXT_REG_NAMES):
+            value = self.ext_regs.get(name)
+            if value is not None:
+                written |= 1 << idx
+            values.append(value or 0)
+        return _FRAME_HDR.pack(len(payload), written,
+                               *values, self.cycles) + payload
+
+
+# The response for the command currently being processed
+_RESPONSE = Response()
+
 
 def read_word(arg_name: str, word_data: str, bits: int) -> int:
     '''Try to read an unsigned word of the specified bit length'''
@@ -97,12 +188,6 @@ def read_word(arg_name: str, word_data: str, bits: int) -> int:
     return value
 
 
-def end_command() -> None:
-    '''Print a single '.' to stdout and flush, ending the output for command'''
-    print('.')
-    sys.stdout.flush()
-
-
 def check_arg_count(cmd: str, cnt: int, args: List[str]) -> None:
     if len(args) != cnt:
         if cnt == 0:
@@ -132,10 +217,8 @@ def on_start_operation(sim: OTBNSim, args: List[str]) -> Optional[OTBNSim]:
     return None
 
 
-def on_step(sim: OTBNSim, args: List[str]) -> Optional[OTBNSim]:
-    '''Step one instruction'''
-    check_arg_count('step', 0, args)
-
+def step_once(sim: OTBNSim) -> None:
+    '''Step one cycle, printing trace lines and recording external registers'''
     pc = sim.state.pc
     assert 0 == pc & 3
 
@@ -164,6 +247,8 @@ def on_step(sim: OTBNSim, args: List[str]) -> Optional[OTBNSim]:
         rt = c.rtl_trace()
         if rt is not None:
             rtl_changes.append(rt)
+        if isinstance(c, TraceExtRegChange):
+            _RESPONSE.set_ext_reg(c.name, c.erc.new_value)
 
     # This is a bit of a hack. Very occasionally, we'll see traced changes when
     # there's not actually an instruction in flight. For example, this happens
@@ -179,6 +264,27 @@ def on_step(sim: OTBNSim, args: List[str]) -> Optional[OTBNSim]:
         for rt in rtl_changes:
             print(rt)
 
+    _RESPONSE.cycles += 1
+
+
+def on_step(sim: OTBNSim, args: List[str]) -> Optional[OTBNSim]:
+    '''Step one instruction'''
+    check_arg_count('step', 0, args)
+    step_once(sim)
+    return None
+
+
+def on_run(sim: OTBNSim, args: List[str]) -> Optional[OTBNSim]:
+    '''Step until the operation finishes, RND is requested or a cycle limit'''
+    check_arg_count('run', 1, args)
+    max_cycles = read_word('max_cycles', args[0], 32)
+
+    for _ in range(max_cycles):
+        step_once(sim)
+        status = _RESPONSE.ext_regs.get('STATUS')
+        if status in [0, 0xff] or _RESPONSE.ext_regs.get('RND_REQ') == 1:
+            break
+
     return None
 
 
@@ -266,6 +372,90 @@ def on_dump_d(sim: OTBNSim, args: List[str]) -> Optional[OTBNSim]:
     return None
 
 
+def get_mapped_mem(cmd: str, num_bytes: int) -> mmap.mmap:
+    '''Return the mapped file, checking it holds at least num_bytes bytes'''
+    if _MAPPED_MEM is None:
+        raise ValueError('{} command before any map_mem command.'.format(cmd))
+    if num_bytes > len(_MAPPED_MEM):
+        raise ValueError('{} needs {} bytes, but only {} are mapped.'
+                         .format(cmd, num_bytes, len(_MAPPED_MEM)))
+    return _MAPPED_MEM
+
+
+def on_map_mem(sim: OTBNSim, args: List[str]) -> Optional[OTBNSim]:
+    '''Map a file that is shared with the process driving the simulation'''
+    check_arg_count('map_mem', 2, args)
+
+    path = args[0]
+    num_bytes = read_word('bytes', args[1], 32)
+
+    global _MAPPED_MEM
+    if _MAPPED_MEM is not None:
+        _MAPPED_MEM.close()
+        _MAPPED_MEM = None
+
+    print('MAP_MEM {!r} {}'.format(path, num_bytes))
+    with open(path, 'r+b') as handle:
+        _MAPPED_MEM = mmap.mmap(handle.fileno(), num_bytes)
+
+    return None
+
+
+def on_load_d_mapped(sim: OTBNSim, args: List[str]) -> Optional[OTBNSim]:
+    '''Load contents of data memory from the start of the mapped file'''
+    check_arg_count('load_d_mapped', 1, args)
+
+    num_bytes = read_word('bytes', args[0], 32)
+    mem = get_mapped_mem('load_d_mapped', num_bytes)
+
+    print('LOAD_D_MAPPED {}'.format(num_bytes))
+    sim.load_data(mem[:num_bytes], has_validity=True)
+
+    return None
+
+
+def on_load_i_mapped(sim: OTBNSim, args: List[str]) -> Optional[OTBNSim]:
+    '''Load contents of insn memory from the start of the mapped file'''
+    check_arg_count('load_i_mapped', 1, args)
+
+    num_bytes = read_word('bytes', args[0], 32)
+    mem = get_mapped_mem('load_i_mapped', num_bytes)
+
+    print('LOAD_I_MAPPED {}'.format(num_bytes))
+    sim.load_program(decode_bytes(0, mem[:num_bytes], 'mapped memory'))
+
+    return None
+
+
+def on_dump_d_mapped(sim: OTBNSim, args: List[str]) -> Optional[OTBNSim]:
+    '''Dump contents of data memory to the start of the mapped file'''
+    check_arg_count('dump_d_mapped', 0, args)
+
+    data = sim.state.dmem.dump_le_words()
+    mem = get_mapped_mem('dump_d_mapped', len(data))
+
+    print('DUMP_D_MAPPED {}'.format(len(data)))
+    mem[:len(data)] = data
+
+    return None
+
+
+def on_dump_d_dirty_mapped(sim: OTBNSim,
+                           args: List[str]) -> Optional[OTBNSim]:
+    '''Dump the data memory words written since it was loaded'''
+    check_arg_count('dump_d_dirty_mapped', 0, args)
+
+    dmem = sim.state.dmem
+    mem = get_mapped_mem('dump_d_dirty_mapped', 5 * len(dmem.data))
+
+    print('DUMP_D_DIRTY_MAPPED')
+    for idx, data in dmem.dump_dirty_le_words():
+        mem[5 * idx:5 * idx + len(data)] = data
+        print('DIRTY {} {}'.format(idx, len(data) // 5))
+
+    return None
+
+
 def on_print_regs(sim: OTBNSim, args: List[str]) -> Optional[OTBNSim]:
     '''Print registers to stdout'''
     check_arg_count('print_regs', 0, args)
@@ -310,6 +500,24 @@ def on_edn_urnd_step(sim: OTBNSim, args: List[str]) -> Optional[OTBNSim]:
     return None
 
 
+def on_edn_rnd_step256(sim: OTBNSim, args: List[str]) -> Optional[OTBNSim]:
+    check_arg_count('edn_rnd_step256', 2, args)
+    edn_rnd_data = read_word('edn_rnd_step256', args[0], 256)
+    fips_errs = read_word('fips_errs', args[1], 8)
+    for i in range(8):
+        sim.state.edn_rnd_step((edn_rnd_data >> (32 * i)) & 0xffffffff,
+                               bool((fips_errs >> i) & 1))
+    return None
+
+
+def on_edn_urnd_step256(sim: OTBNSim, args: List[str]) -> Optional[OTBNSim]:
+    check_arg_count('edn_urnd_step256', 1, args)
+    edn_urnd_data = read_word('edn_urnd_step256', args[0], 256)
+    for i in range(8):
+        sim.state.edn_urnd_step((edn_urnd_data >> (32 * i)) & 0xffffffff)
+    return None
+
+
 def on_edn_flush(sim: OTBNSim, args: List[str]) -> Optional[OTBNSim]:
     check_arg_count('edn_flush', 0, args)
     sim.state.edn_flush()
@@ -371,6 +579,23 @@ def on_step_crc(sim: OTBNSim, args: List[str]) -> Optional[OTBNSim]:
 
     new_state = binascii.crc32(item.to_bytes(6, 'little'), state)
     print(f'! otbn.LOAD_CHECKSUM: 0x{new_state:08x}')
+    _RESPONSE.set_ext_reg('LOAD_CHECKSUM', new_state)
+
+    return None
+
+
+def on_step_crc_block(sim: OTBNSim, args: List[str]) -> Optional[OTBNSim]:
+    if not args:
+        raise ValueError(f'step_crc_block expects at least one argument. '
+                         f'Got {args}.')
+
+    state = read_word('state', args[0], 32)
+    data = b''.join(read_word('item', arg, 48).to_bytes(6, 'little')
+                    for arg in args[1:])
+
+    new_state = binascii.crc32(data, state)
+    print(f'! otbn.LOAD_CHECKSUM: 0x{new_state:08x}')
+    _RESPONSE.set_ext_reg('LOAD_CHECKSUM', new_state)
 
     return None
 
@@ -407,17 +632,25 @@ _HANDLERS = {
     'start_operation': on_start_operation,
     'otp_key_cdc_done': on_otp_cdc_done,
     'step': on_step,
+    'run': on_run,
     'load_elf': on_load_elf,
     'add_loop_warp': on_add_loop_warp,
     'clear_loop_warps': on_clear_loop_warps,
     'load_d': on_load_d,
     'load_i': on_load_i,
     'dump_d': on_dump_d,
+    'map_mem': on_map_mem,
+    'load_d_mapped': on_load_d_mapped,
+    'load_i_mapped': on_load_i_mapped,
+    'dump_d_mapped': on_dump_d_mapped,
+    'dump_d_dirty_mapped': on_dump_d_dirty_mapped,
     'print_regs': on_print_regs,
     'print_call_stack': on_print_call_stack,
     'reset': on_reset,
     'edn_rnd_step': on_edn_rnd_step,
     'edn_urnd_step': on_edn_urnd_step,
+    'edn_rnd_step256': on_edn_rnd_step256,
+    'edn_urnd_step256': on_edn_urnd_step256,
     'edn_rnd_cdc_done': on_edn_rnd_cdc_done,
     'edn_urnd_cdc_done': on_edn_urnd_cdc_done,
     'edn_flush': on_edn_flush,
@@ -425,6 +658,7 @@ _HANDLERS = {
     'invalidate_dmem': on_invalidate_dmem,
     'set_keymgr_value': on_set_keymgr_value,
     'step_crc': on_step_crc,
+    'step_crc_block': on_step_crc_block,
     'send_err_escalation': on_send_err_escalation,
     'set_rma_req': on_set_rma_req,
     'initial_secure_wipe': on_initial_secure_wipe,
@@ -445,9 +679,17 @@ def on_input(sim: OTBNSim, line: str) -> Optional[OTBNSim]:
     if handler is None:
         raise RuntimeError('Unknown command: {!r}'.format(verb))
 
-    ret = handler(sim, words[1:])
-    print('.')
-    sys.stdout.flush()
+    global _RESPONSE
+    _RESPONSE = Response()
+
+    # Collect everything the handler prints, so that it can be sent back in a
+    # single frame (and a single write).
+    text = io.StringIO()
+    with redirect_stdout(text):
+        ret = handler(sim, words[1:])
+
+    sys.stdout.buffer.write(_RESPONSE.to_frame(text.getvalue()))
+    sys.stdout.buffer.flush()
 
     return ret
 
@@ -33,8 +33,7 @@ class LogTraceListener : public OtbnTraceListener {
    * std::runtime_error if the file cannot be opened.
    */
   LogTraceListener(const std::string &log_filename);
-  void AcceptTraceString(const std::string &trace,
-                         unsigned int cycle_count) override;
+  void AcceptTraceRecord(const OtbnTraceRecord &record) override;
 };
 
 #endif  // OPENTITAN_HW_IP_OTBN_DV_TRACER_CPP_LOG_TRACE_LISTENER_H_
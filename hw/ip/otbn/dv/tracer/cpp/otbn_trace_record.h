@@ -0,0 +1,84 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef OPENTITAN_HW_IP_OTBN_DV_TRACER_CPP_OTBN_TRACE_RECORD_H_
+#define OPENTITAN_HW_IP_OTBN_DV_TRACER_CPP_OTBN_TRACE_RECORD_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * A single line of OTBN trace output
+ *
+ * This doesn't own its text: it points into the trace string that the owning
+ * OtbnTraceRecord was parsed from.
+ */
+struct OtbnTraceLine {
+  const char *text;
+  size_t len;
+
+  /**
+   * The line type, which is its first character ('E', 'S', '<', '>' etc.)
+   */
+  char type() const { return len ? text[0] : '\0'; }
+
+  /**
+   * Take a copy of the line as a string
+   */
+  std::string str() const { return std::string(text, len); }
+};
+
+/**
+ * The OTBN trace output for a single cycle, split up into lines
+ *
+ * Records are built by OtbnTraceSource, which parses the trace string from the
+ * simulation once and passes the result to every listener. The record points
+ * into that string, so it is only valid for the duration of a call to
+ * OtbnTraceListener::AcceptTraceRecord(). The line storage is reused between
+ * cycles, so parsing doesn't allocate once it has grown to fit.
+ */
+class OtbnTraceRecord {
+ public:
+  OtbnTraceRecord() : trace_(""), cycle_count_(0) {}
+
+  /**
+   * Split trace (a null-terminated string of newline-separated lines) into
+   * lines, replacing any previous contents of the record
+   */
+  void Parse(const char *trace, unsigned int cycle_count) {
+    trace_ = trace;
+    cycle_count_ = cycle_count;
+    lines_.clear();
+
+    const char *bol = trace;
+    while (*bol) {
+      const char *eol = bol;
+      while (*eol && *eol != '\n') {
+        ++eol;
+      }
+      lines_.push_back(OtbnTraceLine{bol, static_cast<size_t>(eol - bol)});
+      bol = *eol ? eol + 1 : eol;
+    }
+  }
+
+  /**
+   * The cycle count associated with the trace output
+   */
+  unsigned int cycle_count() const { return cycle_count_; }
+
+  const std::vector<OtbnTraceLine> &lines() const { return lines_; }
+
+  /**
+   * The trace text that this record was parsed from
+   */
+  const char *c_str() const { return trace_; }
+
+ private:
+  const char *trace_;
+  unsigned int cycle_count_;
+  std::vector<OtbnTraceLine> lines_;
+};
+
+#endif  // OPENTITAN_HW_IP_OTBN_DV_TRACER_CPP_OTBN_TRACE_RECORD_H_
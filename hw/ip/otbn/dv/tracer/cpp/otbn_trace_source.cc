@@ -27,10 +27,10 @@ void OtbnTraceSource::RemoveListener(const OtbnTraceListener *listener) {
   listeners_.erase(it);
 }
 
-void OtbnTraceSource::Broadcast(const std::string &trace,
-                                unsigned cycle_count) {
+void OtbnTraceSource::Broadcast(const char *trace, unsigned cycle_count) {
+  record_.Parse(trace, cycle_count);
   for (OtbnTraceListener *listener : listeners_) {
-    listener->AcceptTraceString(trace, cycle_count);
+    listener->AcceptTraceRecord(record_);
   }
 }
 
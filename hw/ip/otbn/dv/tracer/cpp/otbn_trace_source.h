@@ -7,6 +7,7 @@
 #include <vector>
 
 #include "otbn_trace_listener.h"
+#include "otbn_trace_record.h"
 
 // A source for simulation trace data.
 //
@@ -28,11 +29,15 @@ class OtbnTraceSource {
   // Remove a listener from the source
   void RemoveListener(const OtbnTraceListener *listener);
 
-  // Send a trace string to all listeners
-  void Broadcast(const std::string &trace, unsigned cycle_count);
+  // Parse a trace string and send it to all listeners. The string is split
+  // into lines once, and all listeners see the same record.
+  void Broadcast(const char *trace, unsigned cycle_count);
 
  private:
   std::vector<OtbnTraceListener *> listeners_;
+
+  // Reused between calls to Broadcast to avoid allocating on every cycle
+  OtbnTraceRecord record_;
 };
 
 #endif  // OPENTITAN_HW_IP_OTBN_DV_TRACER_CPP_OTBN_TRACE_SOURCE_H_
@@ -0,0 +1,384 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "profile_trace_listener.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <iomanip>
+#include <ios>
+#include <sstream>
+
+namespace {
+
+// Instruction fields and encodings used to spot calls, returns and loops. See
+// hw/ip/otbn/data/enc-schemes.yml.
+enum {
+  kOpcodeMask = 0x7f,
+  kOpcodeJal = 0x6f,
+  kOpcodeJalr = 0x67,
+  kOpcodeCustom3 = 0x7b,
+  kFunct3Loop = 0,
+  kFunct3Loopi = 1,
+};
+
+uint32_t InsnOpcode(uint32_t insn) { return insn & kOpcodeMask; }
+uint32_t InsnRd(uint32_t insn) { return (insn >> 7) & 0x1f; }
+uint32_t InsnFunct3(uint32_t insn) { return (insn >> 12) & 0x7; }
+uint32_t InsnRs1(uint32_t insn) { return (insn >> 15) & 0x1f; }
+
+bool IsCall(uint32_t insn) {
+  uint32_t opcode = InsnOpcode(insn);
+  return (opcode == kOpcodeJal || opcode == kOpcodeJalr) && InsnRd(insn) == 1;
+}
+
+bool IsReturn(uint32_t insn) {
+  return InsnOpcode(insn) == kOpcodeJalr && InsnRd(insn) == 0 &&
+         InsnRs1(insn) == 1;
+}
+
+bool IsLoop(uint32_t insn) {
+  uint32_t funct3 = InsnFunct3(insn);
+  return InsnOpcode(insn) == kOpcodeCustom3 &&
+         (funct3 == kFunct3Loop || funct3 == kFunct3Loopi);
+}
+
+// The number of instructions in the body of a LOOP or LOOPI (the bodysize
+// field is stored minus one)
+uint32_t LoopBodySize(uint32_t insn) { return (insn >> 20) + 1; }
+
+// Parse 8 hex digits at text. Returns false if any of them isn't a hex digit.
+bool ParseHex32(const char *text, uint32_t *value) {
+  uint32_t acc = 0;
+  for (int i = 0; i < 8; ++i) {
+    char c = text[i];
+    uint32_t nibble;
+    if (c >= '0' && c <= '9') {
+      nibble = c - '0';
+    } else if (c >= 'a' && c <= 'f') {
+      nibble = c - 'a' + 10;
+    } else if (c >= 'A' && c <= 'F') {
+      nibble = c - 'A' + 10;
+    } else {
+      return false;
+    }
+    acc = (acc << 4) | nibble;
+  }
+  *value = acc;
+  return true;
+}
+
+std::string Hex32(uint32_t value) {
+  std::ostringstream oss;
+  oss << "0x" << std::hex << std::setw(8) << std::setfill('0') << value;
+  return oss.str();
+}
+
+}  // namespace
+
+ProfileTraceListener::ProfileTraceListener() { Reset(); }
+
+void ProfileTraceListener::Reset() {
+  // IMEM is 8kiB, so this is big enough for any valid PC.
+  pc_stats_.assign(8192 / 4, PcStats{0, 0, 0});
+
+  call_tree_.clear();
+  call_tree_.push_back(CallNode{0, 0, 0, 0, 0, {}});
+  cur_node_ = 0;
+  call_pending_ = false;
+
+  wipe_cycles_ = 0;
+  other_records_ = 0;
+}
+
+bool ProfileTraceListener::ParseInsnLine(const OtbnTraceLine &line,
+                                         uint32_t *pc, uint32_t *insn) {
+  // The line looks like "E PC: 0x00000158, insn: 0x01acd08b". If there was an
+  // IMEM integrity error, the instruction bits are replaced by "??".
+  static const char kPcPrefix[] = " PC: 0x";
+  static const char kInsnPrefix[] = ", insn: ";
+  const size_t pc_pos = sizeof(kPcPrefix) - 1 + 1;
+  const size_t insn_pos = pc_pos + 8 + sizeof(kInsnPrefix) - 1;
+
+  if (line.len < insn_pos + 2 ||
+      memcmp(line.text + 1, kPcPrefix, sizeof(kPcPrefix) - 1) != 0 ||
+      !ParseHex32(line.text + pc_pos, pc)) {
+    return false;
+  }
+
+  *insn = 0;
+  if (line.len >= insn_pos + 10 && line.text[insn_pos] == '0' &&
+      line.text[insn_pos + 1] == 'x') {
+    ParseHex32(line.text + insn_pos + 2, insn);
+  }
+  return true;
+}
+
+ProfileTraceListener::PcStats &ProfileTraceListener::GetPcStats(uint32_t pc) {
+  size_t idx = pc / 4;
+  if (idx >= pc_stats_.size()) {
+    pc_stats_.resize(idx + 1, PcStats{0, 0, 0});
+  }
+  return pc_stats_[idx];
+}
+
+void ProfileTraceListener::AcceptTraceRecord(const OtbnTraceRecord &record) {
+  // Header lines come first, so stop at the first line that isn't one.
+  for (const OtbnTraceLine &line : record.lines()) {
+    uint32_t pc, insn;
+    switch (line.type()) {
+      case 'E':
+        if (ParseInsnLine(line, &pc, &insn)) {
+          OnInsn(pc, insn, false);
+          return;
+        }
+        break;
+      case 'S':
+        if (ParseInsnLine(line, &pc, &insn)) {
+          OnInsn(pc, insn, true);
+          return;
+        }
+        break;
+      case 'U':
+        ++wipe_cycles_;
+        return;
+      case 'V':
+        // The end of a secure wipe is the end of a run (or the initial wipe
+        // after reset), so the next instruction starts from an empty stack.
+        ++wipe_cycles_;
+        cur_node_ = 0;
+        call_pending_ = false;
+        return;
+      default:
+        break;
+    }
+    break;
+  }
+  ++other_records_;
+}
+
+void ProfileTraceListener::OnInsn(uint32_t pc, uint32_t insn, bool stall) {
+  if (call_pending_) {
+    // This is the first cycle of the callee
+    call_pending_ = false;
+
+    std::map<uint32_t, size_t> &children = call_tree_[cur_node_].children;
+    auto it = children.find(pc);
+    if (it != children.end()) {
+      cur_node_ = it->second;
+    } else {
+      size_t child = call_tree_.size();
+      children[pc] = child;
+      call_tree_.push_back(CallNode{pc, cur_node_, 0, 0, 0, {}});
+      cur_node_ = child;
+    }
+    ++call_tree_[cur_node_].calls;
+  }
+
+  PcStats &stats = GetPcStats(pc);
+  CallNode &node = call_tree_[cur_node_];
+  stats.insn = insn;
+  if (stall) {
+    ++stats.stall_cycles;
+    ++node.stall_cycles;
+    return;
+  }
+  ++stats.exec_cycles;
+  ++node.exec_cycles;
+
+  // The cycle of a call or return instruction belongs to the caller or callee
+  // respectively, so the call stack changes after it has been counted.
+  if (IsCall(insn)) {
+    call_pending_ = true;
+  } else if (IsReturn(insn) && cur_node_ != 0) {
+    cur_node_ = node.parent;
+  }
+}
+
+std::string ProfileTraceListener::SymbolName(uint32_t addr) const {
+  auto it = symbols_.upper_bound(addr);
+  if (it == symbols_.begin()) {
+    return Hex32(addr);
+  }
+  --it;
+  if (it->first == addr) {
+    return it->second;
+  }
+  std::ostringstream oss;
+  oss << it->second << "+0x" << std::hex << (addr - it->first);
+  return oss.str();
+}
+
+std::string ProfileTraceListener::NodeName(size_t node) const {
+  return node == 0 ? "[otbn]" : SymbolName(call_tree_[node].entry_pc);
+}
+
+void ProfileTraceListener::WriteReport(std::ostream &os) const {
+  std::ios old_state(nullptr);
+  old_state.copyfmt(os);
+
+  // Cycles spent in each call tree node and its descendants. Children always
+  // have a larger index than their parent, so a single backwards pass works.
+  std::vector<uint64_t> subtree_cycles(call_tree_.size());
+  for (size_t i = call_tree_.size(); i-- > 0;) {
+    const CallNode &node = call_tree_[i];
+    subtree_cycles[i] += node.exec_cycles + node.stall_cycles;
+    if (i != 0) {
+      subtree_cycles[node.parent] += subtree_cycles[i];
+    }
+  }
+  uint64_t total_cycles = subtree_cycles[0];
+  uint64_t stall_cycles = 0;
+  for (const CallNode &node : call_tree_) {
+    stall_cycles += node.stall_cycles;
+  }
+
+  os << "OTBN profile: " << total_cycles << " instruction cycles ("
+     << stall_cycles << " stalled), " << wipe_cycles_ << " secure wipe cycles";
+  if (other_records_) {
+    os << ", " << other_records_ << " unrecognised trace records";
+  }
+  os << "\n";
+
+  auto percent = [total_cycles](uint64_t cycles) {
+    return total_cycles ? 100.0 * cycles / total_cycles : 0.0;
+  };
+  os << std::fixed << std::setprecision(2);
+
+  // Aggregate the call tree by function. Recursive calls are only counted
+  // once in a function's total (at the outermost frame).
+  struct FuncStats {
+    uint64_t calls;
+    uint64_t self_cycles;
+    uint64_t stall_cycles;
+    uint64_t total_cycles;
+  };
+  std::map<size_t, FuncStats> funcs;
+  std::map<uint32_t, size_t> func_by_entry;
+  for (size_t i = 0; i < call_tree_.size(); ++i) {
+    const CallNode &node = call_tree_[i];
+    auto ins = func_by_entry.insert(std::make_pair(node.entry_pc, i));
+    FuncStats &func = funcs[ins.first->second];
+    func.calls += node.calls;
+    func.self_cycles += node.exec_cycles + node.stall_cycles;
+    func.stall_cycles += node.stall_cycles;
+
+    bool recursive = false;
+    for (size_t j = i; j != 0 && !recursive;) {
+      j = call_tree_[j].parent;
+      recursive = j != 0 && call_tree_[j].entry_pc == node.entry_pc;
+    }
+    if (!recursive) {
+      func.total_cycles += subtree_cycles[i];
+    }
+  }
+
+  std::vector<std::pair<size_t, FuncStats>> sorted_funcs(funcs.begin(),
+                                                         funcs.end());
+  std::stable_sort(sorted_funcs.begin(), sorted_funcs.end(),
+                   [](const std::pair<size_t, FuncStats> &a,
+                      const std::pair<size_t, FuncStats> &b) {
+                     return a.second.self_cycles > b.second.self_cycles;
+                   });
+
+  os << "\nFunctions:\n"
+     << std::setw(12) << "self" << std::setw(8) << "%" << std::setw(12)
+     << "total" << std::setw(8) << "%" << std::setw(12) << "stalls"
+     << std::setw(10) << "calls"
+     << "  function\n";
+  for (const auto &pr : sorted_funcs) {
+    const FuncStats &func = pr.second;
+    os << std::setw(12) << func.self_cycles << std::setw(8)
+       << percent(func.self_cycles) << std::setw(12) << func.total_cycles
+       << std::setw(8) << percent(func.total_cycles) << std::setw(12)
+       << func.stall_cycles << std::setw(10) << func.calls << "  "
+       << NodeName(pr.first) << "\n";
+  }
+
+  // Per-instruction cycles, hottest first
+  std::vector<uint32_t> pcs;
+  for (size_t idx = 0; idx < pc_stats_.size(); ++idx) {
+    const PcStats &stats = pc_stats_[idx];
+    if (stats.exec_cycles || stats.stall_cycles) {
+      pcs.push_back(idx * 4);
+    }
+  }
+  auto pc_cycles = [this](uint32_t pc) {
+    const PcStats &stats = pc_stats_[pc / 4];
+    return stats.exec_cycles + stats.stall_cycles;
+  };
+  std::stable_sort(pcs.begin(), pcs.end(), [&](uint32_t a, uint32_t b) {
+    return pc_cycles(a) > pc_cycles(b);
+  });
+
+  os << "\nInstructions:\n"
+     << std::setw(10) << "pc" << std::setw(12) << "insn" << std::setw(12)
+     << "cycles" << std::setw(8) << "%" << std::setw(12) << "stalls"
+     << "  location\n";
+  for (uint32_t pc : pcs) {
+    const PcStats &stats = pc_stats_[pc / 4];
+    os << std::setw(10) << Hex32(pc) << std::setw(12) << Hex32(stats.insn)
+       << std::setw(12) << pc_cycles(pc) << std::setw(8)
+       << percent(pc_cycles(pc)) << std::setw(12) << stats.stall_cycles
+       << "  " << SymbolName(pc) << "\n";
+  }
+
+  // Loops, in address order. Each iteration starts by executing the first
+  // instruction of the body, so its count gives the iterations.
+  os << "\nLoops:\n"
+     << std::setw(10) << "pc" << std::setw(8) << "body" << std::setw(10)
+     << "entries" << std::setw(12) << "iterations" << std::setw(12)
+     << "avg iters" << std::setw(12) << "body cycles"
+     << "  location\n";
+  for (size_t idx = 0; idx < pc_stats_.size(); ++idx) {
+    const PcStats &stats = pc_stats_[idx];
+    if (!stats.exec_cycles || !IsLoop(stats.insn)) {
+      continue;
+    }
+    uint32_t body_size = LoopBodySize(stats.insn);
+    uint64_t iterations = 0;
+    uint64_t body_cycles = 0;
+    for (size_t body_idx = idx + 1;
+         body_idx <= idx + body_size && body_idx < pc_stats_.size();
+         ++body_idx) {
+      const PcStats &body_stats = pc_stats_[body_idx];
+      if (body_idx == idx + 1) {
+        iterations = body_stats.exec_cycles;
+      }
+      body_cycles += body_stats.exec_cycles + body_stats.stall_cycles;
+    }
+    os << std::setw(10) << Hex32(idx * 4) << std::setw(8) << body_size
+       << std::setw(10) << stats.exec_cycles << std::setw(12) << iterations
+       << std::setw(12) << (double)iterations / stats.exec_cycles
+       << std::setw(12) << body_cycles << "  " << SymbolName(idx * 4)
+       << "\n";
+  }
+
+  os.copyfmt(old_state);
+}
+
+void ProfileTraceListener::WriteCollapsedStacks(std::ostream &os) const {
+  for (size_t i = 0; i < call_tree_.size(); ++i) {
+    const CallNode &node = call_tree_[i];
+    uint64_t cycles = node.exec_cycles + node.stall_cycles;
+    if (!cycles) {
+      continue;
+    }
+
+    std::vector<size_t> stack;
+    for (size_t j = i; j != 0; j = call_tree_[j].parent) {
+      stack.push_back(j);
+    }
+    stack.push_back(0);
+
+    for (auto it = stack.rbegin(); it != stack.rend(); ++it) {
+      if (it != stack.rbegin()) {
+        os << ';';
+      }
+      os << NodeName(*it);
+    }
+    os << ' ' << cycles << '\n';
+  }
+}
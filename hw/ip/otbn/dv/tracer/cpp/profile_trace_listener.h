@@ -0,0 +1,121 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef OPENTITAN_HW_IP_OTBN_DV_TRACER_CPP_PROFILE_TRACE_LISTENER_H_
+#define OPENTITAN_HW_IP_OTBN_DV_TRACER_CPP_PROFILE_TRACE_LISTENER_H_
+
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "otbn_trace_listener.h"
+
+/**
+ * An OtbnTraceListener that profiles where an OTBN program spends its cycles.
+ *
+ * Only the header ('E', 'S', 'U' and 'V') line of each record is examined, and
+ * only the fixed-position PC and instruction fields of that line are parsed, so
+ * the per-cycle cost is a couple of table updates. Everything else (symbol
+ * lookup, aggregation and formatting) is done when a report is written.
+ *
+ * Cycles are counted per PC, split into executed ('E') and stalled ('S')
+ * cycles. Calls and returns are recognised from the instruction bits (a JAL or
+ * JALR that writes x1 is a call, a JALR through x1 that discards the link is a
+ * return) and used to maintain a call tree, so cycles can also be attributed to
+ * the function they were spent in and to the full call stack that led there.
+ * The call stack is reset by the secure wipe at the end of each run.
+ *
+ * Functions are named using a table of IMEM symbols (typically from
+ * OtbnMemUtil::GetImemSymbols()). Addresses without an exact symbol are named
+ * relative to the nearest symbol below them.
+ */
+class ProfileTraceListener : public OtbnTraceListener {
+ public:
+  typedef std::map<uint32_t, std::string> Symbols;
+
+  ProfileTraceListener();
+
+  void AcceptTraceRecord(const OtbnTraceRecord &record) override;
+
+  /**
+   * Set the symbols used to name addresses in reports
+   */
+  void SetSymbols(const Symbols &symbols) { symbols_ = symbols; }
+
+  /**
+   * Discard all collected data
+   */
+  void Reset();
+
+  /**
+   * Write a flat profile: cycles per function, per PC and per loop.
+   *
+   * The per-loop section lists each LOOP or LOOPI instruction that was
+   * executed, with the number of times the loop was entered, the total number
+   * of iterations and the cycles spent on the body's own instructions.
+   */
+  void WriteReport(std::ostream &os) const;
+
+  /**
+   * Write the call tree in "collapsed stack" format, with one line per call
+   * stack giving the ';'-separated function names from the outermost frame
+   * inwards followed by the number of cycles spent there. This is the input
+   * format for flamegraph.pl and compatible tools.
+   */
+  void WriteCollapsedStacks(std::ostream &os) const;
+
+ private:
+  struct PcStats {
+    uint32_t insn;
+    uint64_t exec_cycles;
+    uint64_t stall_cycles;
+  };
+
+  // A node in the call tree. The root node (index 0) has entry_pc 0 and
+  // represents code that runs before the first call.
+  struct CallNode {
+    uint32_t entry_pc;
+    size_t parent;
+    uint64_t calls;
+    uint64_t exec_cycles;
+    uint64_t stall_cycles;
+    std::map<uint32_t, size_t> children;
+  };
+
+  // Parse the PC and instruction from an 'E' or 'S' line. Returns false if
+  // the line doesn't have the expected format.
+  static bool ParseInsnLine(const OtbnTraceLine &line, uint32_t *pc,
+                            uint32_t *insn);
+
+  // Get the stats for pc, growing pc_stats_ if necessary
+  PcStats &GetPcStats(uint32_t pc);
+
+  // Count a cycle of the instruction at pc, which either stalled or completed
+  void OnInsn(uint32_t pc, uint32_t insn, bool stall);
+
+  // Name addr using symbols_, as "sym" or "sym+0xoff"
+  std::string SymbolName(uint32_t addr) const;
+
+  // Name a call tree node (the root is named "[otbn]")
+  std::string NodeName(size_t node) const;
+
+  // Indexed by PC / 4. Grown on demand.
+  std::vector<PcStats> pc_stats_;
+
+  std::vector<CallNode> call_tree_;
+  size_t cur_node_;
+
+  // Set by a call instruction: the next executed instruction is the entry
+  // point of the callee.
+  bool call_pending_;
+
+  uint64_t wipe_cycles_;
+  uint64_t other_records_;
+
+  Symbols symbols_;
+};
+
+#endif  // OPENTITAN_HW_IP_OTBN_DV_TRACER_CPP_PROFILE_TRACE_LISTENER_H_
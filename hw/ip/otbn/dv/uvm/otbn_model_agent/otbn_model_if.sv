@@ -78,6 +78,13 @@ interface otbn_model_if
     return crc_state;
   endfunction
 
+  // Like step_crc, but step the CRC with each of items in turn, with a single call to the model.
+  function automatic bit [31:0] step_crc_block(bit [47:0] items[], bit [31:0] crc_state);
+    `DV_CHECK_FATAL(u_model.otbn_model_step_crc_block(handle, items, crc_state) == 0,
+                    "Failed to update CRC", "otbn_model_if")
+    return crc_state;
+  endfunction
+
   // Pass loop warp rules to the model
   function automatic void take_loop_warps(chandle memutil);
     u_model.otbn_take_loop_warps(handle, memutil);
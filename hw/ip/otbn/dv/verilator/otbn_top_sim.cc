@@ -2,6 +2,7 @@
 // Licensed under the Apache License, Version 2.0, see LICENSE for details.
 // SPDX-License-Identifier: Apache-2.0
 
+#include <cstdlib>
 #include <fstream>
 #include <getopt.h>
 #include <iomanip>
@@ -9,6 +10,7 @@
 #include <memory>
 #include <string>
 #include <svdpi.h>
+#include <vector>
 
 #include "Votbn_top_sim__Syms.h"
 #include "log_trace_listener.h"
@@ -16,6 +18,7 @@
 #include "otbn_model.h"
 #include "otbn_trace_checker.h"
 #include "otbn_trace_source.h"
+#include "profile_trace_listener.h"
 #include "sv_scoped.h"
 #include "verilated_toplevel.h"
 #include "verilator_memutil.h"
@@ -27,17 +30,25 @@ extern unsigned int otbn_base_call_stack_get_element(int index);
 extern unsigned int otbn_base_reg_get(int index);
 extern unsigned int otbn_bignum_reg_get(int index, int quarter);
 extern svBit otbn_err_get();
+extern unsigned int otbn_insn_cnt_get();
 extern int otbn_core_get_stop_pc();
 }
 
 /**
- * SimCtrlExtension that adds a '--otbn-trace-file' command line option. If set
- * it sets up a LogTraceListener that will dump out the trace to the given log
- * file
+ * SimCtrlExtension that adds OTBN trace command line options.
+ *
+ * '--otbn-trace-file' sets up a LogTraceListener that will dump out the trace
+ * to the given log file. '--otbn-profile-file' and '--otbn-flamegraph-file' set
+ * up a ProfileTraceListener and write its report and collapsed call stacks to
+ * the given files at the end of the simulation.
  */
 class OtbnTraceUtil : public SimCtrlExtension {
  private:
+  const OtbnMemUtil &mem_util_;
   std::unique_ptr<LogTraceListener> log_trace_listener_;
+  std::unique_ptr<ProfileTraceListener> profile_trace_listener_;
+  std::string profile_filename_;
+  std::string flamegraph_filename_;
 
   bool SetupTraceLog(const std::string &log_filename) {
     try {
@@ -53,16 +64,57 @@ class OtbnTraceUtil : public SimCtrlExtension {
     return false;
   }
 
+  void SetupProfile() {
+    if (!profile_trace_listener_) {
+      profile_trace_listener_.reset(new ProfileTraceListener());
+      OtbnTraceSource::get().AddListener(profile_trace_listener_.get());
+    }
+  }
+
+  void WriteProfile() {
+    profile_trace_listener_->SetSymbols(mem_util_.GetImemSymbols());
+
+    if (!profile_filename_.empty()) {
+      std::ofstream os(profile_filename_);
+      if (os.is_open()) {
+        profile_trace_listener_->WriteReport(os);
+      } else {
+        std::cerr << "ERROR: Could not open profile file: "
+                  << profile_filename_ << std::endl;
+      }
+    }
+
+    if (!flamegraph_filename_.empty()) {
+      std::ofstream os(flamegraph_filename_);
+      if (os.is_open()) {
+        profile_trace_listener_->WriteCollapsedStacks(os);
+      } else {
+        std::cerr << "ERROR: Could not open flame graph file: "
+                  << flamegraph_filename_ << std::endl;
+      }
+    }
+  }
+
   void PrintHelp() {
     std::cout << "Trace log utilities:\n\n"
                  "--otbn-trace-file=FILE\n"
-                 "  Write OTBN trace log to FILE\n\n";
+                 "  Write OTBN trace log to FILE\n\n"
+                 "--otbn-profile-file=FILE\n"
+                 "  Write a profile of OTBN cycles by function, instruction\n"
+                 "  and loop to FILE\n\n"
+                 "--otbn-flamegraph-file=FILE\n"
+                 "  Write OTBN call stacks and their cycle counts to FILE in\n"
+                 "  collapsed stack format (as used by flamegraph.pl)\n\n";
   }
 
  public:
+  OtbnTraceUtil(const OtbnMemUtil &mem_util) : mem_util_(mem_util) {}
+
   virtual bool ParseCLIArguments(int argc, char **argv, bool &exit_app) {
     const struct option long_options[] = {
         {"otbn-trace-file", required_argument, nullptr, 'l'},
+        {"otbn-profile-file", required_argument, nullptr, 'p'},
+        {"otbn-flamegraph-file", required_argument, nullptr, 'f'},
         {"help", no_argument, nullptr, 'h'},
         {nullptr, no_argument, nullptr, 0}};
 
@@ -80,7 +132,18 @@ class OtbnTraceUtil : public SimCtrlExtension {
         case 1:
           break;
         case 'l':
-          return SetupTraceLog(optarg);
+          if (!SetupTraceLog(optarg)) {
+            return false;
+          }
+          break;
+        case 'p':
+          profile_filename_ = optarg;
+          SetupProfile();
+          break;
+        case 'f':
+          flamegraph_filename_ = optarg;
+          SetupProfile();
+          break;
         case 'h':
           PrintHelp();
           break;
@@ -93,17 +156,402 @@ class OtbnTraceUtil : public SimCtrlExtension {
   ~OtbnTraceUtil() {
     if (log_trace_listener_)
       OtbnTraceSource::get().RemoveListener(log_trace_listener_.get());
+    if (profile_trace_listener_) {
+      OtbnTraceSource::get().RemoveListener(profile_trace_listener_.get());
+      WriteProfile();
+    }
+  }
+};
+
+/**
+ * Check the result of a run that has finished
+ *
+ * This checks that there were no mismatches between the RTL and the model and
+ * that the run stopped at the expected address (if the ELF file gives one).
+ * Returns true if the run passed. On a failure, a message has been written to
+ * stderr and, if reason is not null, *reason is set to a short description.
+ */
+static bool CheckRunResult(const OtbnMemUtil &mem_util, std::string *reason) {
+  SVScoped top_scope("TOP.otbn_top_sim");
+
+  // Any mismatch has already been reported by the simulation
+  if (otbn_err_get()) {
+    if (reason) {
+      *reason = "mismatch or model error";
+    }
+    return false;
+  }
+
+  int exp_stop_pc = mem_util.GetExpEndAddr();
+  if (exp_stop_pc >= 0) {
+    SVScoped core_scope("TOP.otbn_top_sim.u_otbn_core_model");
+    int act_stop_pc = otbn_core_get_stop_pc();
+    if (exp_stop_pc != act_stop_pc) {
+      std::cerr << "ERROR: Expected stop PC from ELF file was 0x" << std::hex
+                << exp_stop_pc << ", but simulation actually stopped at 0x"
+                << act_stop_pc << std::dec << ".\n";
+      if (reason) {
+        *reason = "unexpected stop PC";
+      }
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/**
+ * SimCtrlExtension that adds a '--otbn-batch' command line option, which runs
+ * a list of ELF files one after the other in a single simulation.
+ *
+ * This avoids the cost of constructing the Verilated model and starting the
+ * ISS for each of them. Between runs, the design is reset and IMEM and DMEM
+ * are cleared to zero before the next ELF file is loaded. The model (and its
+ * ISS) is kept across the resets.
+ *
+ * The result of each run is written to a results file, with one line per ELF
+ * file giving PASS or FAIL, the number of cycles from reset until the end of
+ * the run, the number of instructions executed, the path of the ELF file and,
+ * for failures, a reason. These are separated by tabs.
+ */
+class OtbnBatchRunner : public SimCtrlExtension {
+ private:
+  OtbnMemUtil &mem_util_;
+  const CData *rst_n_;
+  std::vector<std::string> elfs_;
+  std::ofstream results_;
+  unsigned long timeout_cycles_;
+
+  // Index in elfs_ of the current run
+  size_t cur_;
+  // True between the end of a reset and the end of the run
+  bool running_;
+  // True if the next ELF file should be loaded at the next reset
+  bool load_pending_;
+  bool in_reset_;
+  unsigned long run_start_time_;
+  unsigned passes_, fails_;
+
+  bool ReadElfList(const std::string &list_path) {
+    std::ifstream list_file;
+    if (list_path != "-") {
+      list_file.open(list_path);
+      if (!list_file.is_open()) {
+        std::cerr << "ERROR: Could not open ELF list: " << list_path
+                  << std::endl;
+        return false;
+      }
+    }
+    std::istream &is = (list_path == "-") ? std::cin : list_file;
+
+    // One path per line. Blank lines and lines starting with '#' are ignored.
+    std::string line;
+    while (std::getline(is, line)) {
+      size_t first = line.find_first_not_of(" \t\r");
+      if (first == std::string::npos || line[first] == '#') {
+        continue;
+      }
+      size_t last = line.find_last_not_of(" \t\r");
+      elfs_.push_back(line.substr(first, last + 1 - first));
+    }
+    return true;
+  }
+
+  void WriteResult(bool passed, unsigned long cycles, unsigned insns,
+                   const std::string &reason) {
+    results_ << (passed ? "PASS" : "FAIL") << "\t" << cycles << "\t" << insns
+             << "\t" << elfs_[cur_];
+    if (!passed) {
+      results_ << "\t" << reason;
+    }
+    results_ << std::endl;
+    if (passed) {
+      ++passes_;
+    } else {
+      ++fails_;
+    }
+  }
+
+  // Record the result of the current run. Returns true if there is another
+  // ELF file to run, in which case it will be loaded at the next reset.
+  bool FinishRun(bool passed, const std::string &reason) {
+    unsigned long now = VerilatorSimCtrl::GetInstance().GetTime();
+    unsigned insns;
+    {
+      SVScoped top_scope("TOP.otbn_top_sim");
+      insns = otbn_insn_cnt_get();
+    }
+    WriteResult(passed, (now - run_start_time_) / 2, insns, reason);
+    running_ = false;
+
+    if (cur_ + 1 >= elfs_.size()) {
+      return false;
+    }
+    ++cur_;
+    load_pending_ = true;
+    VerilatorSimCtrl::GetInstance().RequestReset();
+    return true;
+  }
+
+  // Load elfs_[cur_], after clearing the memories. If it can't be loaded,
+  // record a failure and try the next one. Returns false if there are none
+  // left.
+  bool LoadCurrent(bool clear) {
+    for (; cur_ < elfs_.size(); ++cur_) {
+      try {
+        if (clear) {
+          for (bool is_imem : {true, false}) {
+            const ScrambledEcc32MemArea &area = mem_util_.GetMemArea(is_imem);
+            area.Write(0, std::vector<uint8_t>(area.GetSizeBytes(), 0));
+          }
+        }
+        mem_util_.LoadElf(elfs_[cur_]);
+        return true;
+      } catch (const std::exception &err) {
+        std::cerr << "ERROR: Failed to load " << elfs_[cur_] << ": "
+                  << err.what() << std::endl;
+        WriteResult(false, 0, 0, "load failed");
+      }
+    }
+    return false;
+  }
+
+  void PrintHelp() {
+    std::cout << "Batch mode:\n\n"
+                 "--otbn-batch=LIST\n"
+                 "  Run each of the ELF files listed in LIST (one per line,\n"
+                 "  or read from stdin if LIST is -), resetting the design\n"
+                 "  between runs\n\n"
+                 "--otbn-batch-results=FILE\n"
+                 "  Write the result and cycle count of each run to FILE\n"
+                 "  (default: otbn_batch_results.txt)\n\n"
+                 "--otbn-batch-timeout=CYCLES\n"
+                 "  Fail a run that hasn't finished after CYCLES cycles\n\n";
+  }
+
+ public:
+  OtbnBatchRunner(OtbnMemUtil &mem_util, const CData *rst_n)
+      : mem_util_(mem_util),
+        rst_n_(rst_n),
+        timeout_cycles_(0),
+        cur_(0),
+        running_(false),
+        load_pending_(false),
+        in_reset_(false),
+        run_start_time_(0),
+        passes_(0),
+        fails_(0) {}
+
+  bool IsEnabled() const { return !elfs_.empty(); }
+
+  virtual bool ParseCLIArguments(int argc, char **argv, bool &exit_app) {
+    const struct option long_options[] = {
+        {"otbn-batch", required_argument, nullptr, 'b'},
+        {"otbn-batch-results", required_argument, nullptr, 'r'},
+        {"otbn-batch-timeout", required_argument, nullptr, 't'},
+        {"help", no_argument, nullptr, 'h'},
+        {nullptr, no_argument, nullptr, 0}};
+
+    std::string list_path, results_path = "otbn_batch_results.txt";
+
+    // Reset the command parsing index in-case other utils have already parsed
+    // some arguments
+    optind = 1;
+    while (1) {
+      int c = getopt_long(argc, argv, "-h", long_options, nullptr);
+      if (c == -1) {
+        break;
+      }
+
+      switch (c) {
+        case 0:
+        case 1:
+          break;
+        case 'b':
+          list_path = optarg;
+          break;
+        case 'r':
+          results_path = optarg;
+          break;
+        case 't':
+          timeout_cycles_ = strtoul(optarg, nullptr, 0);
+          break;
+        case 'h':
+          PrintHelp();
+          break;
+      }
+    }
+
+    if (list_path.empty()) {
+      return true;
+    }
+
+    if (!ReadElfList(list_path)) {
+      exit_app = true;
+      return false;
+    }
+    if (elfs_.empty()) {
+      std::cerr << "ERROR: No ELF files listed in " << list_path << std::endl;
+      exit_app = true;
+      return false;
+    }
+
+    results_.open(results_path);
+    if (!results_.is_open()) {
+      std::cerr << "ERROR: Could not open batch results file: "
+                << results_path << std::endl;
+      exit_app = true;
+      return false;
+    }
+    results_ << "# result\tcycles\tinstructions\telf\treason" << std::endl;
+    return true;
+  }
+
+  virtual void PreExec() {
+    if (IsEnabled() && !LoadCurrent(false)) {
+      VerilatorSimCtrl::GetInstance().RequestStop(true);
+    }
+  }
+
+  virtual void OnClock(unsigned long sim_time) {
+    if (!IsEnabled()) {
+      return;
+    }
+
+    if (!*rst_n_) {
+      if (load_pending_) {
+        load_pending_ = false;
+        if (!LoadCurrent(true)) {
+          VerilatorSimCtrl::GetInstance().RequestStop(true);
+        }
+      }
+      in_reset_ = true;
+      return;
+    }
+
+    if (in_reset_) {
+      in_reset_ = false;
+      running_ = true;
+      run_start_time_ = sim_time;
+    }
+
+    if (running_ && timeout_cycles_ &&
+        (sim_time - run_start_time_) / 2 >= timeout_cycles_) {
+      std::cerr << "ERROR: " << elfs_[cur_] << " timed out after "
+                << timeout_cycles_ << " cycles." << std::endl;
+      if (!FinishRun(false, "timeout")) {
+        VerilatorSimCtrl::GetInstance().RequestStop(true);
+      }
+    }
+  }
+
+  // Called (over DPI) when the simulation thinks a run has finished. Returns
+  // true if the simulation should carry on.
+  bool OnRunDone(bool failed) {
+    if (!IsEnabled()) {
+      return false;
+    }
+    // We might be called again for a run that has already been recorded,
+    // before the reset for the next run happens.
+    if (!running_) {
+      return true;
+    }
+
+    std::string reason = "mismatch or model error";
+    bool passed = !failed && CheckRunResult(mem_util_, &reason);
+    return FinishRun(passed, reason);
+  }
+
+  virtual void PostExec() {
+    if (!IsEnabled()) {
+      return;
+    }
+    // Anything that didn't get to finish (because the simulation was stopped
+    // early) counts as a failure. Results are written in order, so the first
+    // ELF file without one is the current run, if any.
+    for (size_t i = passes_ + fails_; i < elfs_.size(); ++i) {
+      bool was_running = running_ && i == cur_;
+      cur_ = i;
+      WriteResult(false, 0, 0, was_running ? "not finished" : "not run");
+    }
+    std::cout << "Batch: " << passes_ << " passed, " << fails_ << " failed."
+              << std::endl;
+  }
+
+  bool AllPassed() const { return fails_ == 0 && passes_ == elfs_.size(); }
+};
+
+/**
+ * SimCtrlExtension that adds a '--otbn-auto-loop-warps' command line option.
+ *
+ * This tells the model to look for loop iterations that don't change any state
+ * and to skip the iterations after them, which are all the same. The warps
+ * that the model finds are applied to the RTL by OtbnTopApplyLoopWarp, just
+ * like the ones given by symbols in the ELF file. The model finds these warps
+ * with its native ISS, so this also needs the +otbn_native_iss plusarg.
+ */
+class OtbnAutoLoopWarps : public SimCtrlExtension {
+ private:
+  bool enabled_;
+
+  void PrintHelp() {
+    std::cout << "Loop warp utilities:\n\n"
+                 "--otbn-auto-loop-warps\n"
+                 "  Skip loop iterations that can't change any state (needs\n"
+                 "  +otbn_native_iss)\n\n";
+  }
+
+ public:
+  OtbnAutoLoopWarps() : enabled_(false) {}
+
+  bool IsEnabled() const { return enabled_; }
+
+  virtual bool ParseCLIArguments(int argc, char **argv, bool &exit_app) {
+    const struct option long_options[] = {
+        {"otbn-auto-loop-warps", no_argument, nullptr, 'a'},
+        {"help", no_argument, nullptr, 'h'},
+        {nullptr, no_argument, nullptr, 0}};
+
+    // Reset the command parsing index in-case other utils have already parsed
+    // some arguments
+    optind = 1;
+    while (1) {
+      int c = getopt_long(argc, argv, "-h", long_options, nullptr);
+      if (c == -1) {
+        break;
+      }
+
+      switch (c) {
+        case 0:
+        case 1:
+          break;
+        case 'a':
+          enabled_ = true;
+          break;
+        case 'h':
+          PrintHelp();
+          break;
+      }
+    }
+
+    return true;
   }
 };
 
 static otbn_top_sim *verilator_top;
 static OtbnMemUtil otbn_memutil("TOP.otbn_top_sim");
+static OtbnBatchRunner *batch_runner;
+static OtbnAutoLoopWarps *auto_loop_warps;
 
 int main(int argc, char **argv) {
   VerilatorMemUtil memutil(&otbn_memutil);
-  OtbnTraceUtil traceutil;
+  OtbnTraceUtil traceutil(otbn_memutil);
 
   otbn_top_sim top;
+  OtbnBatchRunner batch(otbn_memutil, &top.IO_RST_N);
+  batch_runner = &batch;
+  OtbnAutoLoopWarps auto_warps;
+  auto_loop_warps = &auto_warps;
   // Make the otbn_top_sim object visible to OtbnTopApplyLoopWarp.
   // This will leave a dangling pointer when we exit main, but that
   // doesn't really matter because we don't have anything that uses it
@@ -115,6 +563,8 @@ int main(int argc, char **argv) {
                  VerilatorSimCtrlFlags::ResetPolarityNegative);
   simctrl.RegisterExtension(&memutil);
   simctrl.RegisterExtension(&traceutil);
+  simctrl.RegisterExtension(&batch);
+  simctrl.RegisterExtension(&auto_warps);
 
   std::cout << "Simulation of OTBN" << std::endl
             << "==================" << std::endl
@@ -124,51 +574,63 @@ int main(int argc, char **argv) {
   int ret_code = pr.first;
   bool ran_simulation = pr.second;
 
-  if (ret_code != 0 || !ran_simulation) {
+  if (!ran_simulation) {
     return ret_code;
   }
 
-  svSetScope(svGetScopeFromName("TOP.otbn_top_sim"));
-
-  svBit model_err = otbn_err_get();
-  if (model_err) {
-    return 1;
+  // In batch mode, the runs have been checked as they finished
+  if (batch.IsEnabled()) {
+    return batch.AllPassed() ? 0 : 1;
   }
 
-  int exp_stop_pc = otbn_memutil.GetExpEndAddr();
-  if (exp_stop_pc >= 0) {
-    SVScoped core_scope("TOP.otbn_top_sim.u_otbn_core_model");
-    int act_stop_pc = otbn_core_get_stop_pc();
-    if (exp_stop_pc != act_stop_pc) {
-      std::cerr << "ERROR: Expected stop PC from ELF file was 0x" << std::hex
-                << exp_stop_pc << ", but simulation actually stopped at 0x"
-                << act_stop_pc << ".\n";
-      return 1;
-    }
+  if (ret_code != 0) {
+    return ret_code;
   }
 
-  return 0;
+  return CheckRunResult(otbn_memutil, nullptr) ? 0 : 1;
 }
 
-// This is executed over DPI on the first posedge of the clock after each
-// reset. It's in charge of telling the model about any loop warp symbols in
-// the ELF file.
-extern "C" int OtbnTopInstallLoopWarps() {
+// This is executed over DPI when a run has finished (or a check has failed).
+// It returns non-zero if the simulation should carry on with another run.
+extern "C" int OtbnTopRunDone(svBit failed) {
+  return (batch_runner && batch_runner->OnRunDone(failed)) ? 1 : 0;
+}
+
+// The loop counts of the loops the RTL is currently running, tracked by
+// OtbnTopApplyLoopWarp
+static std::vector<uint32_t> loop_count_stack;
+
+// Get the model from the otbn_core_model module. This should have been
+// initialised by the time it is first used because it gets set up in an
+// initial block and the callers don't run until the first clock edge.
+static OtbnModel *GetModel() {
   // Cast to the right base class of otbn_top_sim. Otherwise, you can't access
   // the "otbn_top_sim" member because you get the derived class's constructor
   // by accident.
   Votbn_top_sim &top = *verilator_top;
 
-  // Grab the model handle from the otbn_core_model module. This should have
-  // been initialised by now because it gets set up in an initial block and
-  // this code doesn't run until the first clock edge.
   auto sv_model_handle = top.otbn_top_sim->u_otbn_core_model->model_handle;
 
   // sv_model_handle will be some integer type. Check it's nonzero and, if so,
   // convert it to an OtbnModel*.
   assert(sv_model_handle != 0);
 
-  OtbnModel *model_handle = (OtbnModel *)sv_model_handle;
+  return (OtbnModel *)sv_model_handle;
+}
+
+// This is executed over DPI on the first posedge of the clock after each
+// reset. It's in charge of telling the model about any loop warp symbols in
+// the ELF file.
+extern "C" int OtbnTopInstallLoopWarps() {
+  // A run that was cut short by a reset might have left loops on the stack
+  loop_count_stack.clear();
+
+  OtbnModel *model_handle = GetModel();
+
+  if (auto_loop_warps->IsEnabled() &&
+      model_handle->use_auto_loop_warps() != 0) {
+    return -1;
+  }
 
   if (model_handle->take_loop_warps(otbn_memutil) != 0) {
     // Something went wrong when trying to update the model. We've already
@@ -229,11 +691,9 @@ auto get_loop_counter(LoopControllerT *loop_controller, uint32_t counter_idx)
 
 // This is executed over DPI on every negedge of the clock and is in charge of
 // updating the top of the loop stack if necessary to match loop warp symbols
-// in the ELF file.
+// in the ELF file or automatic loop warps found by the model.
 extern "C" void OtbnTopApplyLoopWarp() {
-  static std::vector<uint32_t> loop_count_stack;
-
-  // See not in OtbnTopInstallLoopWarps for why this upcast is needed.
+  // See the note in GetModel for why this upcast is needed.
   Votbn_top_sim &top = *verilator_top;
 
   auto loop_controller =
@@ -276,6 +736,9 @@ extern "C" void OtbnTopApplyLoopWarp() {
     uint32_t insn_addr = loop_controller->insn_addr_i;
 
     uint32_t new_cnt = otbn_memutil.GetLoopWarp(insn_addr, old_cnt);
+    if (old_cnt == new_cnt && auto_loop_warps->IsEnabled()) {
+      GetModel()->get_auto_loop_warp(insn_addr, old_cnt, &new_cnt);
+    }
     if (old_cnt != new_cnt) {
       // Convert from new_cnt back to the "iters" format by subtracting from
       // the total, but bottom out at 1 (the last iteration).
@@ -332,6 +332,11 @@ module otbn_top_sim (
     .alert_o          (                         )
   );
 
+  // Defined in otbn_top_sim.cc. Called when a run has finished or when a check has failed (in which
+  // case failed is set), this returns non-zero if the simulation should carry on with another run.
+  // In that case, the C++ side loads the next binary and resets the design.
+  import "DPI-C" context function int OtbnTopRunDone(bit failed);
+
   // When OTBN is done let a few more cycles run then finish simulation
   logic [1:0] finish_counter;
 
@@ -348,7 +353,9 @@ module otbn_top_sim (
       end
 
       if (finish_counter == 2'd3) begin
-        $finish;
+        if (OtbnTopRunDone(1'b0) == 0) begin
+          $finish;
+        end
       end
     end
   end
@@ -454,7 +461,9 @@ module otbn_top_sim (
         bad_cycles <= bad_cycles + 1;
       end
       if (bad_cycles >= 3) begin
-        $error("Mismatch or model error (see message above)");
+        if (OtbnTopRunDone(1'b1) == 0) begin
+          $error("Mismatch or model error (see message above)");
+        end
       end
     end
   end
@@ -526,4 +535,10 @@ module otbn_top_sim (
     return err_latched;
   endfunction
 
+  export "DPI-C" function otbn_insn_cnt_get;
+
+  function automatic int unsigned otbn_insn_cnt_get();
+    return insn_cnt;
+  endfunction
+
 endmodule
@@ -13,6 +13,10 @@ which will generate 10 OTBN binaries, each with up to 1500 instructions in
 their respective traces. It will also build a Verilated model of OTBN (using
 otbn_top_sim) and run the model on each binary.
 
+With --batch, the binaries are all run by a single simulation process (see the
+--otbn-batch option of otbn_top_sim), which writes the result of each run to
+results.txt.
+
 '''
 
 import argparse
@@ -46,6 +50,8 @@ def main() -> int:
                         help='Number of binaries to generate and run')
     parser.add_argument('--seed', type=int, default=1)
     parser.add_argument('--size', type=int, default=100)
+    parser.add_argument('--batch', action='store_true',
+                        help='Run all the binaries in one simulation')
     parser.add_argument('destdir', help='Destination directory')
 
     args = parser.parse_args()
@@ -68,7 +74,8 @@ def main() -> int:
     # Next, we make our own build.ninja, which says how to compile and run the
     # verilated testbench
     with open(os.path.join(args.destdir, 'build.ninja'), 'w') as ninja_handle:
-        write_ninja(ninja_handle, args.destdir, args.seed, args.count)
+        write_ninja(ninja_handle, args.destdir, args.seed, args.count,
+                    args.batch)
 
     # Finally, use ninja to run everything, continuing on error (so that you
     # can run 100 seeds and see what proportion fails).
@@ -79,7 +86,8 @@ def main() -> int:
 def write_ninja(handle: TextIO,
                 destdir: str,
                 seed: int,
-                count: int) -> None:
+                count: int,
+                batch: bool) -> None:
     handle.write('include build.ninja.gen\n\n')
 
     # Find the project directory, as viewed from destdir
@@ -98,6 +106,21 @@ def write_ninja(handle: TextIO,
     # Collect up all the generated files
     basenames = [str(seed + off) for off in range(count)]
 
+    if batch:
+        # Write a list of the binaries and a rule to run them all in one go
+        with open(os.path.join(destdir, 'elfs.txt'), 'w') as list_handle:
+            for name in basenames:
+                list_handle.write(f'{name}.elf\n')
+
+        handle.write(f'rule run_batch\n'
+                     f'  command = REPO_TOP={projdir_from_destdir} '
+                     f'$tb --otbn-batch=$in --otbn-batch-results=$out '
+                     f'>batch.out\n\n')
+        elfs = ' '.join([f'{name}.elf' for name in basenames])
+        handle.write(f'build results.txt: run_batch elfs.txt | $tb {elfs}\n\n')
+        handle.write('build run: phony results.txt\n\n')
+        return
+
     # Rules to run them
     handle.write(f'rule run\n'
                  f'  command = REPO_TOP={projdir_from_destdir} '
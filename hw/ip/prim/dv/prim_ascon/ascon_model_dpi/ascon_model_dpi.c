@@ -18,14 +18,13 @@ void c_dpi_aead_encrypt(svOpenArrayHandle ct, svOpenArrayHandle msg,
                         unsigned int msg_len, svOpenArrayHandle ad,
                         unsigned int ad_len, svOpenArrayHandle nonce,
                         svOpenArrayHandle key) {
-  unsigned long long *clen;
+  unsigned long long clen;
   unsigned long long mlen, alen;
   mlen = msg_len;
   alen = ad_len;
 
   // clen and nsec is accutally not needed, but part of the API
-  clen = (unsigned long long *)malloc(sizeof(unsigned long long));
-  uint8_t *nsec;
+  uint8_t *nsec = NULL;
 
   uint8_t *c, *m, *a, *npub, *k;
   c = (uint8_t *)svGetArrayPtr(ct);
@@ -60,7 +59,7 @@ void c_dpi_aead_encrypt(svOpenArrayHandle ct, svOpenArrayHandle msg,
   }
   printf("\n");*/
 
-  crypto_aead_encrypt(c, clen, m, mlen, a, alen, nsec, npub, k);
+  crypto_aead_encrypt(c, &clen, m, mlen, a, alen, nsec, npub, k);
   /*printf("ct length %d\n", (int)*clen);
 
   printf("ct =  ");
@@ -68,7 +67,6 @@ void c_dpi_aead_encrypt(svOpenArrayHandle ct, svOpenArrayHandle msg,
     printf("%02X", c[i]);
   }
   printf("\n");*/
-  free(clen);
   return;
 }
 
@@ -76,14 +74,13 @@ void c_dpi_aead_decrypt(svOpenArrayHandle ct, unsigned int ct_len,
                         svOpenArrayHandle msg, svOpenArrayHandle ad,
                         unsigned int ad_len, svOpenArrayHandle nonce,
                         svOpenArrayHandle key) {
-  unsigned long long *mlen;
+  unsigned long long mlen;
   unsigned long long clen, alen;
   clen = ct_len;
   alen = ad_len;
 
   // mlen and nsec is accutally not needed, but part of the API
-  mlen = (unsigned long long *)malloc(sizeof(unsigned long long));
-  uint8_t *nsec;
+  uint8_t *nsec = NULL;
 
   uint8_t *c, *m, *a, *npub, *k;
   c = (uint8_t *)svGetArrayPtr(ct);
@@ -117,7 +114,7 @@ void c_dpi_aead_decrypt(svOpenArrayHandle ct, unsigned int ct_len,
     printf("%02X", npub[i]);
   }
   printf("\n");*/
-  crypto_aead_decrypt(m, mlen, nsec, c, clen, a, alen, npub, k);
+  crypto_aead_decrypt(m, &mlen, nsec, c, clen, a, alen, npub, k);
   /*printf("msg length %d\n", (int)*mlen);
 
   printf("msg =  ");
@@ -125,66 +122,137 @@ void c_dpi_aead_decrypt(svOpenArrayHandle ct, unsigned int ct_len,
     printf("%02X", c[i]);
   }
   printf("\n");*/
-  free(mlen);
   return;
 }
 
 void c_dpi_ascon_round(const svBitVecVal *data_i, svBit *round_i,
                        svBitVecVal *data_o) {
-  uint8_t round;
+  ascon_state_t state;
 
   // get input data from simulator
-  ascon_state_t *state = ascon_data_get(data_i);
-  round = (uint8_t)*round_i;
+  ascon_data_get(data_i, &state);
 
-  ROUND(state, round);
+  ROUND(&state, (uint8_t)*round_i);
 
-  ascon_data_put(data_o, state);
+  ascon_data_put(data_o, &state);
+}
 
-  return;
+void ascon_data_get(const svBitVecVal *data_i, ascon_state_t *state) {
+  // get data from simulator, convert from 2D to 1D
+  for (int i = 0; i < 5; i++) {
+    state->x[i] = (uint64_t)data_i[2 * i] | ((uint64_t)data_i[2 * i + 1] << 32);
+  }
 }
 
-ascon_state_t *ascon_data_get(const svBitVecVal *data_i) {
-  ascon_state_t *data;
+void ascon_data_put(svBitVecVal *data_o, const ascon_state_t *state) {
+  // convert from 1D to 2D, write output data to simulation
+  for (int i = 0; i < 5; i++) {
+    data_o[2 * i] = (svBitVecVal)state->x[i];
+    data_o[2 * i + 1] = (svBitVecVal)(state->x[i] >> 32);
+  }
+}
 
-  // alloc data buffer
-  data = (ascon_state_t *)malloc(sizeof(ascon_state_t));
-  assert(data);
+void *c_dpi_ascon_ctx_new(void) {
+  ascon_state_t *state = (ascon_state_t *)calloc(1, sizeof(ascon_state_t));
+  assert(state);
+  return state;
+}
 
-  // get data from simulator, convert from 2D to 1D
-  printf("Getter:\n");
-  for (int i = 0; i < 5; i++) {
-    svBitVecVal value;
+void c_dpi_ascon_ctx_free(void *ctx) { free(ctx); }
 
-    value = data_i[2 * i];
-    data->x[i] = (uint64_t)value;
-    printf("Value of data_i = %X\n", value);
-    value = data_i[(2 * i) + 1];
-    data->x[i] |= ((uint64_t)value) << 32;
-    printf("Value of data_i = %X\n", value);
-    printf("Value of   X[%i] = %jX\n", i, data->x[i]);
+void c_dpi_ascon_ctx_set_state(void *ctx, const svBitVecVal *data_i) {
+  assert(ctx);
+  ascon_data_get(data_i, (ascon_state_t *)ctx);
+}
+
+void c_dpi_ascon_ctx_get_state(const void *ctx, svBitVecVal *data_o) {
+  assert(ctx);
+  ascon_data_put(data_o, (const ascon_state_t *)ctx);
+}
+
+void c_dpi_ascon_ctx_rounds(void *ctx, const svOpenArrayHandle rcon,
+                            unsigned int num_rounds) {
+  assert(ctx);
+  if (!num_rounds) {
+    return;
   }
 
-  return data;
+  const uint8_t *c = (const uint8_t *)svGetArrayPtr(rcon);
+  assert(c);
+
+  ascon_state_t *state = (ascon_state_t *)ctx;
+  for (unsigned int i = 0; i < num_rounds; i++) {
+    ROUND(state, c[i]);
+  }
 }
 
-void ascon_data_put(svBitVecVal *data_o, ascon_state_t *data) {
-  printf("Putter:\n");
-  // convert from 1D to 2D, write output data to simulation
-  for (int i = 0; i < 5; i++) {
-    svBitVecVal value;
+// Size in bytes of the nonce, the key and the tag
+#define ASCON_BLOCK_BYTES 16
+
+void c_dpi_aead_encrypt_batch(svOpenArrayHandle ct, svOpenArrayHandle msg,
+                              const svOpenArrayHandle msg_lens,
+                              svOpenArrayHandle ad,
+                              const svOpenArrayHandle ad_lens,
+                              svOpenArrayHandle nonce, svOpenArrayHandle key,
+                              unsigned int num_msgs) {
+  if (!num_msgs) {
+    return;
+  }
 
-    printf("Value of   X[%i] = %jX\n", i, data->x[i]);
-    value = (svBitVecVal)(data->x[i]);
-    printf("Value of data_o = %X\n", value);
-    data_o[(2 * i)] = value;
-    value = (svBitVecVal)((data->x[i]) >> (32));
-    printf("Value of data_o = %X\n", value);
-    data_o[(2 * i) + 1] = value;
+  uint8_t *c = (uint8_t *)svGetArrayPtr(ct);
+  const uint8_t *m = (const uint8_t *)svGetArrayPtr(msg);
+  const uint8_t *a = (const uint8_t *)svGetArrayPtr(ad);
+  const uint8_t *npub = (const uint8_t *)svGetArrayPtr(nonce);
+  const uint8_t *k = (const uint8_t *)svGetArrayPtr(key);
+  const uint32_t *m_lens = (const uint32_t *)svGetArrayPtr(msg_lens);
+  const uint32_t *a_lens = (const uint32_t *)svGetArrayPtr(ad_lens);
+  assert(npub && k && m_lens && a_lens);
+
+  for (unsigned int i = 0; i < num_msgs; i++) {
+    unsigned long long clen;
+    crypto_aead_encrypt(c, &clen, m, m_lens[i], a, a_lens[i], NULL, npub, k);
+
+    c += clen;
+    m += m_lens[i];
+    a += a_lens[i];
+    npub += ASCON_BLOCK_BYTES;
+    k += ASCON_BLOCK_BYTES;
   }
+}
 
-  // free data
-  free(data);
+void c_dpi_aead_decrypt_batch(svOpenArrayHandle ct,
+                              const svOpenArrayHandle ct_lens,
+                              svOpenArrayHandle msg, svOpenArrayHandle ad,
+                              const svOpenArrayHandle ad_lens,
+                              svOpenArrayHandle nonce, svOpenArrayHandle key,
+                              svOpenArrayHandle tag_ok,
+                              unsigned int num_msgs) {
+  if (!num_msgs) {
+    return;
+  }
 
-  return;
+  const uint8_t *c = (const uint8_t *)svGetArrayPtr(ct);
+  uint8_t *m = (uint8_t *)svGetArrayPtr(msg);
+  const uint8_t *a = (const uint8_t *)svGetArrayPtr(ad);
+  const uint8_t *npub = (const uint8_t *)svGetArrayPtr(nonce);
+  const uint8_t *k = (const uint8_t *)svGetArrayPtr(key);
+  const uint32_t *c_lens = (const uint32_t *)svGetArrayPtr(ct_lens);
+  const uint32_t *a_lens = (const uint32_t *)svGetArrayPtr(ad_lens);
+  uint8_t *ok = (uint8_t *)svGetArrayPtr(tag_ok);
+  assert(c && npub && k && c_lens && a_lens && ok);
+
+  for (unsigned int i = 0; i < num_msgs; i++) {
+    assert(c_lens[i] >= ASCON_BLOCK_BYTES);
+
+    unsigned long long mlen;
+    int ret =
+        crypto_aead_decrypt(m, &mlen, NULL, c, c_lens[i], a, a_lens[i], npub, k);
+    ok[i] = (ret == 0);
+
+    c += c_lens[i];
+    m += c_lens[i] - ASCON_BLOCK_BYTES;
+    a += a_lens[i];
+    npub += ASCON_BLOCK_BYTES;
+    k += ASCON_BLOCK_BYTES;
+  }
 }
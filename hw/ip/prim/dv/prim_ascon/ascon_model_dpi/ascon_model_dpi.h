@@ -24,9 +24,9 @@ extern "C" {
  * @param nonce   Input: 128 bit Nonce
  * @param key     Input: 128 bit Key
  */
-void c_dpi_aead_encrypt(svOpenArrayHandle ct, svOpenArrayHandle ad,
-                        unsigned int ad_len, svOpenArrayHandle msg,
-                        unsigned int msg_len, svOpenArrayHandle nonce,
+void c_dpi_aead_encrypt(svOpenArrayHandle ct, svOpenArrayHandle msg,
+                        unsigned int msg_len, svOpenArrayHandle ad,
+                        unsigned int ad_len, svOpenArrayHandle nonce,
                         svOpenArrayHandle key);
 /**
  * @brief
@@ -58,17 +58,103 @@ void c_dpi_ascon_round(const svBitVecVal *data_i, svBit *round_i,
  * Get packed data block from simulation.
  *
  * @param  data_i Input data from simulation
- * @return Pointer to data copied to memory, 0 in case of an error
+ * @param  state  Output: the state held in data_i
  */
-ascon_state_t *ascon_data_get(const svBitVecVal *data_i);
+void ascon_data_get(const svBitVecVal *data_i, ascon_state_t *state);
 
 /**
- * Write packed data block to simulation and free the source buffer afterwards.
+ * Write packed data block to simulation.
  *
  * @param  data_o Output data for simulation
- * @param  data   Data to be copied to simulation, freed after the operation
+ * @param  state  State to be copied to simulation
+ */
+void ascon_data_put(svBitVecVal *data_o, const ascon_state_t *state);
+
+/**
+ * Create a context holding an ascon state, which is initially all zero.
+ *
+ * The state stays on the C side, so a sequence of rounds can be applied
+ * without passing it through the simulator each time.
+ *
+ * @return Pointer to the context, to be freed with c_dpi_ascon_ctx_free()
+ */
+void *c_dpi_ascon_ctx_new(void);
+
+/**
+ * Free a context created by c_dpi_ascon_ctx_new().
+ */
+void c_dpi_ascon_ctx_free(void *ctx);
+
+/**
+ * Set the state of a context.
+ *
+ * @param  ctx     Context
+ * @param  data_i  Input data is expected to be 320 bit ascon state size
+ */
+void c_dpi_ascon_ctx_set_state(void *ctx, const svBitVecVal *data_i);
+
+/**
+ * Read the state of a context.
+ *
+ * @param  ctx     Context
+ * @param  data_o  Output data, 320 bit ascon state
+ */
+void c_dpi_ascon_ctx_get_state(const void *ctx, svBitVecVal *data_o);
+
+/**
+ * Apply num_rounds ascon rounds to the state of a context.
+ *
+ * @param  ctx        Context
+ * @param  rcon       Input: the round constant for each round
+ * @param  num_rounds Number of rounds (and number of elements of rcon)
+ */
+void c_dpi_ascon_ctx_rounds(void *ctx, const svOpenArrayHandle rcon,
+                            unsigned int num_rounds);
+
+/**
+ * Encrypt a batch of messages in one call.
+ *
+ * Messages, associated data and ciphertexts are concatenated: message i
+ * starts right after message i-1 in msg, and its ciphertext (including the
+ * 16 byte tag) right after that of message i-1 in ct.
+ *
+ * @param ct       Output: concatenated cipher texts + tags
+ * @param msg      Input: concatenated plaintexts
+ * @param msg_lens Input: length of each plaintext in bytes
+ * @param ad       Input: concatenated associated data
+ * @param ad_lens  Input: length of each associated data in bytes
+ * @param nonce    Input: 128 bit Nonce for each message
+ * @param key      Input: 128 bit Key for each message
+ * @param num_msgs Number of messages
+ */
+void c_dpi_aead_encrypt_batch(svOpenArrayHandle ct, svOpenArrayHandle msg,
+                              const svOpenArrayHandle msg_lens,
+                              svOpenArrayHandle ad,
+                              const svOpenArrayHandle ad_lens,
+                              svOpenArrayHandle nonce, svOpenArrayHandle key,
+                              unsigned int num_msgs);
+
+/**
+ * Decrypt a batch of messages in one call.
+ *
+ * The arrays are laid out as for c_dpi_aead_encrypt_batch().
+ *
+ * @param ct       Input: concatenated cipher texts + tags
+ * @param ct_lens  Input: length of each cipher text + tag in bytes
+ * @param msg      Output: concatenated plaintexts
+ * @param ad       Input: concatenated associated data
+ * @param ad_lens  Input: length of each associated data in bytes
+ * @param nonce    Input: 128 bit Nonce for each message
+ * @param key      Input: 128 bit Key for each message
+ * @param tag_ok   Output: 1 for each message whose tag matched, else 0
+ * @param num_msgs Number of messages
  */
-void ascon_data_put(svBitVecVal *data_o, ascon_state_t *data);
+void c_dpi_aead_decrypt_batch(svOpenArrayHandle ct,
+                              const svOpenArrayHandle ct_lens,
+                              svOpenArrayHandle msg, svOpenArrayHandle ad,
+                              const svOpenArrayHandle ad_lens,
+                              svOpenArrayHandle nonce, svOpenArrayHandle key,
+                              svOpenArrayHandle tag_ok, unsigned int num_msgs);
 
 #ifdef __cplusplus
 }  // extern "C"
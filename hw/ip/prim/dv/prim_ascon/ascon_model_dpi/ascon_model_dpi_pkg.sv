@@ -11,6 +11,28 @@ package ascon_model_dpi_pkg;
     output bit[4:0][7:0][7:0] data_o
   );
 
+  // A context keeps an ascon state on the C side, so that a sequence of rounds doesn't need to
+  // pass the state through the simulator after each one.
+  import "DPI-C" context function chandle c_dpi_ascon_ctx_new();
+
+  import "DPI-C" context function void c_dpi_ascon_ctx_free(chandle ctx);
+
+  import "DPI-C" context function void c_dpi_ascon_ctx_set_state(
+    input chandle ctx,
+    input bit[4:0][7:0][7:0] data_i
+  );
+
+  import "DPI-C" context function void c_dpi_ascon_ctx_get_state(
+    input  chandle ctx,
+    output bit[4:0][7:0][7:0] data_o
+  );
+
+  import "DPI-C" context function void c_dpi_ascon_ctx_rounds(
+    input chandle ctx,
+    input byte unsigned rcon[],
+    input int unsigned num_rounds
+  );
+
 
   import "DPI-C" context function void c_dpi_aead_encrypt(
     output byte unsigned ct[],
@@ -32,4 +54,30 @@ package ascon_model_dpi_pkg;
     input byte unsigned key[]
   );
 
+  // Batched versions of c_dpi_aead_encrypt and c_dpi_aead_decrypt. The messages, associated data
+  // and ciphertexts (each with its tag) are concatenated, with the length of each in the *_lens
+  // arrays. nonce and key hold 16 bytes for each message.
+  import "DPI-C" context function void c_dpi_aead_encrypt_batch(
+    output byte unsigned ct[],
+    input byte unsigned msg[],
+    input int unsigned msg_lens[],
+    input byte unsigned ad[],
+    input int unsigned ad_lens[],
+    input byte unsigned nonce[],
+    input byte unsigned key[],
+    input int unsigned num_msgs
+  );
+
+  import "DPI-C" context function void c_dpi_aead_decrypt_batch(
+    input byte unsigned ct[],
+    input int unsigned ct_lens[],
+    output byte unsigned msg[],
+    input byte unsigned ad[],
+    input int unsigned ad_lens[],
+    input byte unsigned nonce[],
+    input byte unsigned key[],
+    output byte unsigned tag_ok[],
+    input int unsigned num_msgs
+  );
+
 endpackage
@@ -10,6 +10,7 @@
 
 #include <cassert>
 #include <cstdint>
+#include <cstring>
 #include <svdpi.h>
 #include <vector>
 
@@ -50,6 +51,17 @@ class PresentState {
   // round and with is_last_round set, then count down.
   uint64_t dec_round(uint64_t input, unsigned round, bool is_last_round) const;
 
+  // A full encryption or decryption with num_rounds rounds. This is
+  // equivalent to calling enc_round (or dec_round) for each round in turn.
+  uint64_t encrypt(uint64_t input, unsigned num_rounds) const;
+  uint64_t decrypt(uint64_t input, unsigned num_rounds) const;
+
+  // Encrypt or decrypt n blocks from src into dst (which may be equal). This
+  // works on 64 blocks at a time, bitsliced so that each 64-bit word holds
+  // one bit position of all 64 blocks.
+  void crypt_blocks(bool decrypt, unsigned num_rounds, const uint64_t *src,
+                    uint64_t *dst, size_t n) const;
+
  private:
   static key128_t next_round_key(const key128_t &k, unsigned key_size,
                                  unsigned round_count);
@@ -59,8 +71,14 @@ class PresentState {
   static uint64_t sbox_layer(bool inverse, uint64_t data);
   static uint64_t perm_layer(bool inverse, uint64_t data);
 
+  // A bitsliced version of sbox_layer, applied to each group of four slices
+  static void sbox_layer_sliced(bool inverse, uint64_t slices[64]);
+
   unsigned key_size;
   std::vector<key128_t> key_schedule;
+
+  // The 64-bit keys used by add_round_key, one for each entry of key_schedule
+  std::vector<uint64_t> round_keys;
 };
 }  // namespace
 
@@ -73,6 +91,11 @@ PresentState::PresentState(unsigned key_size, key128_t key)
     key = next_round_key(key, key_size, i);
     key_schedule.push_back(key);
   }
+
+  round_keys.reserve(key_schedule.size());
+  for (const key128_t &k : key_schedule) {
+    round_keys.push_back(add_round_key(0, k, key_size));
+  }
 }
 
 uint64_t PresentState::enc_round(uint64_t input, unsigned round,
@@ -119,6 +142,111 @@ uint64_t PresentState::dec_round(uint64_t input, unsigned round,
   return w4;
 }
 
+uint64_t PresentState::encrypt(uint64_t input, unsigned num_rounds) const {
+  assert(1 <= num_rounds && num_rounds < round_keys.size());
+
+  uint64_t data = input;
+  for (unsigned round = 1; round <= num_rounds; ++round) {
+    data = perm_layer(false, sbox_layer(false, data ^ round_keys[round - 1]));
+  }
+  return data ^ round_keys[num_rounds];
+}
+
+uint64_t PresentState::decrypt(uint64_t input, unsigned num_rounds) const {
+  assert(1 <= num_rounds && num_rounds < round_keys.size());
+
+  uint64_t data = input ^ round_keys[num_rounds];
+  for (unsigned round = num_rounds; round >= 1; --round) {
+    data = sbox_layer(true, perm_layer(true, data)) ^ round_keys[round - 1];
+  }
+  return data;
+}
+
+// Transpose a 64x64 bit matrix in place, so that bit j of a[i] swaps with bit
+// i of a[j]. This converts between 64 blocks and 64 bit slices (and back).
+static void transpose64(uint64_t a[64]) {
+  uint64_t m = 0x00000000ffffffffULL;
+  for (unsigned j = 32; j != 0; j >>= 1, m ^= m << j) {
+    for (unsigned k = 0; k < 64; k = ((k | j) + 1) & ~j) {
+      uint64_t t = ((a[k] >> j) ^ a[k | j]) & m;
+      a[k] ^= t << j;
+      a[k | j] ^= t;
+    }
+  }
+}
+
+static void add_round_key_sliced(uint64_t slices[64], uint64_t k64) {
+  for (int i = 0; i < 64; ++i) {
+    slices[i] ^= (uint64_t)0 - ((k64 >> i) & 1);
+  }
+}
+
+static void perm_layer_sliced(bool inverse, uint64_t slices[64]) {
+  const uint8_t *perm = inverse ? bit_perm_inv : bit_perm;
+  uint64_t tmp[64];
+  for (int i = 0; i < 64; ++i) {
+    tmp[perm[i]] = slices[i];
+  }
+  memcpy(slices, tmp, sizeof(tmp));
+}
+
+void PresentState::sbox_layer_sliced(bool inverse, uint64_t slices[64]) {
+  // Each output bit of sbox4 and sbox4_inv, written in algebraic normal form
+  // (an XOR of products of input bits).
+  for (int i = 0; i < 64; i += 4) {
+    uint64_t *y = &slices[i];
+    uint64_t x0 = y[0], x1 = y[1], x2 = y[2], x3 = y[3];
+    uint64_t x01 = x0 & x1, x02 = x0 & x2, x03 = x0 & x3;
+    uint64_t x12 = x1 & x2, x13 = x1 & x3, x23 = x2 & x3;
+    uint64_t x012 = x01 & x2, x013 = x01 & x3, x023 = x02 & x3;
+
+    if (!inverse) {
+      y[0] = x0 ^ x2 ^ x12 ^ x3;
+      y[1] = x1 ^ x012 ^ x3 ^ x13 ^ x013 ^ x23 ^ x023;
+      y[2] = ~(x01 ^ x2 ^ x3 ^ x03 ^ x13 ^ x013 ^ x023);
+      y[3] = ~(x0 ^ x1 ^ x12 ^ x012 ^ x3 ^ x013 ^ x023);
+    } else {
+      y[0] = ~(x0 ^ x2 ^ x13);
+      y[1] = x0 ^ x1 ^ x02 ^ x012 ^ x3 ^ x13 ^ x013 ^ x23 ^ x023;
+      y[2] = ~(x01 ^ x02 ^ x12 ^ x012 ^ x3 ^ x03 ^ x13 ^ x013 ^ x023);
+      y[3] = x0 ^ x1 ^ x01 ^ x2 ^ x012 ^ x3 ^ x023;
+    }
+  }
+}
+
+void PresentState::crypt_blocks(bool decrypt, unsigned num_rounds,
+                                const uint64_t *src, uint64_t *dst,
+                                size_t n) const {
+  assert(1 <= num_rounds && num_rounds < round_keys.size());
+
+  for (size_t base = 0; base < n; base += 64) {
+    size_t lanes = (n - base < 64) ? n - base : 64;
+
+    uint64_t slices[64] = {0};
+    memcpy(slices, src + base, lanes * sizeof(uint64_t));
+    transpose64(slices);
+
+    if (!decrypt) {
+      for (unsigned round = 1; round <= num_rounds; ++round) {
+        add_round_key_sliced(slices, round_keys[round - 1]);
+        sbox_layer_sliced(false, slices);
+        perm_layer_sliced(false, slices);
+      }
+      add_round_key_sliced(slices, round_keys[num_rounds]);
+    } else {
+      add_round_key_sliced(slices, round_keys[num_rounds]);
+      for (unsigned round = num_rounds; round >= 1; --round) {
+        perm_layer_sliced(true, slices);
+        sbox_layer_sliced(true, slices);
+        add_round_key_sliced(slices, round_keys[round - 1]);
+      }
+    }
+
+    transpose64(slices);
+    memcpy(dst + base, slices, lanes * sizeof(uint64_t));
+  }
+}
+
 key128_t PresentState::next_round_key(const key128_t &k, unsigned key_size,
                                       unsigned round_count) {
   assert((round_count >> 5) == 0);
@@ -254,4 +382,55 @@ void c_dpi_present_dec_round(const PresentState *ps, unsigned round,
   dst[1] = out64 >> 32;
   dst[0] = (uint32_t)out64;
 }
+
+void c_dpi_present_encrypt(const PresentState *ps, unsigned num_rounds,
+                           const svBitVecVal *src, svBitVecVal *dst) {
+  assert(ps);
+
+  uint64_t in64 = ((uint64_t)src[1] << 32) | src[0];
+  uint64_t out64 = ps->encrypt(in64, num_rounds);
+
+  dst[1] = out64 >> 32;
+  dst[0] = (uint32_t)out64;
+}
+
+void c_dpi_present_decrypt(const PresentState *ps, unsigned num_rounds,
+                           const svBitVecVal *src, svBitVecVal *dst) {
+  assert(ps);
+
+  uint64_t in64 = ((uint64_t)src[1] << 32) | src[0];
+  uint64_t out64 = ps->decrypt(in64, num_rounds);
+
+  dst[1] = out64 >> 32;
+  dst[0] = (uint32_t)out64;
+}
+
+// Encrypt or decrypt every element of the open array src (of 64-bit words)
+// into dst, which must have the same size.
+void c_dpi_present_crypt_blocks(const PresentState *ps, unsigned num_rounds,
+                                unsigned char decrypt,
+                                const svOpenArrayHandle src,
+                                const svOpenArrayHandle dst) {
+  assert(ps);
+  assert(decrypt == 0 || decrypt == 1);
+
+  int n = svSize(src, 1);
+  assert(svSize(dst, 1) == n);
+  if (n <= 0)
+    return;
+
+  std::vector<uint64_t> blocks(n);
+  for (int i = 0; i < n; ++i) {
+    svBitVecVal w32s[2];
+    svGetBitArrElem1VecVal(w32s, src, svLow(src, 1) + i);
+    blocks[i] = ((uint64_t)w32s[1] << 32) | w32s[0];
+  }
+
+  ps->crypt_blocks(decrypt != 0, num_rounds, &blocks[0], &blocks[0], n);
+
+  for (int i = 0; i < n; ++i) {
+    svBitVecVal w32s[2] = {(uint32_t)blocks[i], (uint32_t)(blocks[i] >> 32)};
+    svPutBitArrElem1VecVal(dst, w32s, svLow(dst, 1) + i);
+  }
+}
 }
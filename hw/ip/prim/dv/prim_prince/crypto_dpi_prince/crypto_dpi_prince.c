@@ -28,6 +28,33 @@ extern uint64_t c_dpi_prince_decrypt(const uint64_t ciphertext,
                                old_key_schedule);
 }
 
+extern void c_dpi_prince_crypt_blocks(const svOpenArrayHandle data_i,
+                                      const uint64_t key0, const uint64_t key1,
+                                      int num_half_rounds, int old_key_schedule,
+                                      int decrypt, svOpenArrayHandle data_o) {
+  int n = svSize(data_i, 1);
+  if (svSize(data_o, 1) != n) {
+    fprintf(stderr,
+            "ERROR: c_dpi_prince_crypt_blocks: input has %d blocks but output "
+            "has %d.\n",
+            n, svSize(data_o, 1));
+    return;
+  }
+
+  for (int i = 0; i < n; ++i) {
+    svBitVecVal w32s[2];
+    svGetBitArrElem1VecVal(w32s, data_i, svLow(data_i, 1) + i);
+    uint64_t in64 = ((uint64_t)w32s[1] << 32) | w32s[0];
+
+    uint64_t out64 = prince_enc_dec_uint64(in64, key0, key1, decrypt != 0,
+                                           num_half_rounds, old_key_schedule);
+
+    w32s[0] = (uint32_t)out64;
+    w32s[1] = (uint32_t)(out64 >> 32);
+    svPutBitArrElem1VecVal(data_o, w32s, svLow(data_o, 1) + i);
+  }
+}
+
 #ifdef _cplusplus
 }
 #endif
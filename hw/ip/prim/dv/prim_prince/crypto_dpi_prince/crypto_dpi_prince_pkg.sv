@@ -27,6 +27,18 @@ package crypto_dpi_prince_pkg;
     input int unsigned      new_key_schedule
   );
 
+  // Encrypt (or decrypt) each 64-bit block of data_i with the same key and number of half-rounds,
+  // writing the results to data_o. This must be the same size as data_i.
+  import "DPI-C" context function void c_dpi_prince_crypt_blocks(
+    input bit [63:0]        data_i[],
+    input longint unsigned  key0,
+    input longint unsigned  key1,
+    input int unsigned      num_half_rounds,
+    input int unsigned      old_key_schedule,
+    input int unsigned      decrypt,
+    output bit [63:0]       data_o[]
+  );
+
   //////////////////////////////////////////////////////
   // SV wrapper functions to be used by the testbench //
   //////////////////////////////////////////////////////
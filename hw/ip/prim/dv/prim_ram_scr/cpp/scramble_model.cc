@@ -364,3 +364,173 @@ std::vector<uint8_t> scramble_decrypt_data(
     return xor_vectors(data_in, keystream);
   }
 }
+
+// Return the bottom width bits of x (width <= 64)
+static uint64_t mask_u64(uint64_t x, uint32_t width) {
+  return width >= 64 ? x : x & ((UINT64_C(1) << width) - 1);
+}
+
+// Read count bits (count <= 64) of a little-endian array of 64-bit words,
+// starting at bit_pos.
+static uint64_t read_u64_bits(const uint64_t *words, uint32_t bit_pos,
+                              uint32_t count) {
+  if (count == 0) {
+    return 0;
+  }
+
+  uint32_t idx = bit_pos / 64;
+  uint32_t shift = bit_pos % 64;
+
+  uint64_t ret = words[idx] >> shift;
+  if (shift && shift + count > 64) {
+    ret |= words[idx + 1] << (64 - shift);
+  }
+
+  return mask_u64(ret, count);
+}
+
+static uint64_t scramble_sbox_layer_u64(uint64_t in, uint32_t bit_width,
+                                        const uint8_t sbox[16]) {
+  uint64_t out = 0;
+  uint32_t num_nibbles = bit_width / 4;
+
+  for (uint32_t i = 0; i < num_nibbles; ++i) {
+    out |= (uint64_t)sbox[(in >> (4 * i)) & 0xf] << (4 * i);
+  }
+
+  // Where bit_width is not a multiple of 4 copy over the remaining bits
+  return out | (in & ~mask_u64(~UINT64_C(0), 4 * num_nibbles));
+}
+
+static uint64_t scramble_flip_layer_u64(uint64_t in, uint32_t bit_width) {
+  uint64_t out = 0;
+  for (uint32_t i = 0; i < bit_width; ++i) {
+    out |= ((in >> i) & 1) << (bit_width - i - 1);
+  }
+  return out;
+}
+
+static uint64_t scramble_perm_layer_u64(uint64_t in, uint32_t bit_width,
+                                        bool invert) {
+  uint32_t half = bit_width / 2;
+  uint64_t out = 0;
+
+  for (uint32_t i = 0; i < half; ++i) {
+    if (invert) {
+      out |= ((in >> i) & 1) << (i * 2);
+      out |= ((in >> (i + half)) & 1) << (i * 2 + 1);
+    } else {
+      out |= ((in >> (i * 2)) & 1) << i;
+      out |= ((in >> (i * 2 + 1)) & 1) << (i + half);
+    }
+  }
+
+  if (bit_width % 2) {
+    out |= in & (UINT64_C(1) << (bit_width - 1));
+  }
+
+  return out;
+}
+
+ScrambleKeySchedule::ScrambleKeySchedule(const std::vector<uint8_t> &key,
+                                         const std::vector<uint8_t> &nonce,
+                                         uint32_t nonce_width)
+    : nonce_width(nonce_width), nonce{} {
+  assert(key.size() == (kPrinceWidthByte * 2));
+  assert(nonce_width <= kScrambleMaxNonceWidth);
+  assert(nonce.size() >= ((nonce_width + 7) / 8));
+
+  // The key is little endian, so its top half is K0 and its bottom half is K1
+  // (matching the byte-reversed key passed to prince_enc_dec by the vector
+  // based model).
+  uint64_t key_lo = 0, key_hi = 0;
+  for (uint32_t i = 0; i < kPrinceWidthByte; ++i) {
+    key_lo |= (uint64_t)key[i] << (8 * i);
+    key_hi |= (uint64_t)key[kPrinceWidthByte + i] << (8 * i);
+  }
+  k0 = key_hi;
+  k0_prime = prince_k0_to_k0_prime(k0);
+  k1 = key_lo;
+
+  for (uint32_t i = 0; i < (nonce_width + 7) / 8; ++i) {
+    this->nonce[i / 8] |= (uint64_t)nonce[i] << (8 * (i % 8));
+  }
+  if (nonce_width % 64) {
+    uint32_t top = nonce_width / 64;
+    this->nonce[top] = mask_u64(this->nonce[top], nonce_width % 64);
+  }
+}
+
+uint32_t scramble_addr(uint32_t addr_in, uint32_t addr_width,
+                       const ScrambleKeySchedule &ks) {
+  assert(addr_width <= 32);
+  assert(addr_width <= ks.nonce_width);
+
+  // Address is scrambled by using substitution/permutation layer with the top
+  // addr_width bits of the nonce used as a key.
+  uint64_t key = read_u64_bits(ks.nonce.data(), ks.nonce_width - addr_width,
+                               addr_width);
+  uint64_t state = mask_u64(addr_in, addr_width);
+
+  for (uint32_t i = 0; i < kNumAddrSubstPermRounds; ++i) {
+    state ^= key;
+    state = scramble_sbox_layer_u64(state, addr_width, PRESENT_SBOX4);
+    state = scramble_flip_layer_u64(state, addr_width);
+    state = scramble_perm_layer_u64(state, addr_width, false);
+  }
+
+  return (uint32_t)(state ^ key);
+}
+
+// XOR the keystream for the word at addr onto data_in, writing the result to
+// data_out. Since the S&P layer is not used, this is the whole of both
+// encryption and decryption.
+static void scramble_xor_keystream_u64(const uint64_t *data_in,
+                                       uint64_t *data_out, uint32_t data_width,
+                                       uint32_t addr, uint32_t addr_width,
+                                       const ScrambleKeySchedule &ks,
+                                       bool repeat_keystream) {
+  assert(addr_width < kPrinceWidth);
+
+  uint32_t num_words = (data_width + kPrinceWidth - 1) / kPrinceWidth;
+  uint32_t nonce_bits_per_prince = kPrinceWidth - addr_width;
+  uint64_t addr_bits = mask_u64(addr, addr_width);
+
+  uint64_t keystream_block = 0;
+  for (uint32_t i = 0; i < num_words; ++i) {
+    // With a repeated keystream, we only need to run PRINCE once.
+    if (i == 0 || !repeat_keystream) {
+      // Initial vector is data for PRINCE to encrypt. The bottom addr_width
+      // bits are the address and the rest are taken from the nonce (each
+      // PRINCE instance using different nonce bits).
+      assert((i + 1) * nonce_bits_per_prince <= ks.nonce_width);
+      uint64_t iv = addr_bits | (read_u64_bits(ks.nonce.data(),
+                                               i * nonce_bits_per_prince,
+                                               nonce_bits_per_prince)
+                                 << addr_width);
+
+      keystream_block =
+          prince_core(iv ^ ks.k0, ks.k0, ks.k1, kNumPrinceHalfRounds) ^
+          ks.k0_prime;
+    }
+
+    uint32_t word_width = std::min(kPrinceWidth, data_width - i * kPrinceWidth);
+    data_out[i] = mask_u64(data_in[i] ^ keystream_block, word_width);
+  }
+}
+
+void scramble_encrypt_data(const uint64_t *data_in, uint64_t *data_out,
+                           uint32_t data_width, uint32_t addr,
+                           uint32_t addr_width, const ScrambleKeySchedule &ks,
+                           bool repeat_keystream) {
+  scramble_xor_keystream_u64(data_in, data_out, data_width, addr, addr_width,
+                             ks, repeat_keystream);
+}
+
+void scramble_decrypt_data(const uint64_t *data_in, uint64_t *data_out,
+                           uint32_t data_width, uint32_t addr,
+                           uint32_t addr_width, const ScrambleKeySchedule &ks,
+                           bool repeat_keystream) {
+  scramble_xor_keystream_u64(data_in, data_out, data_width, addr, addr_width,
+                             ks, repeat_keystream);
+}
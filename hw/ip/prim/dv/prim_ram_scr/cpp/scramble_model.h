@@ -5,12 +5,17 @@
 #ifndef OPENTITAN_HW_IP_PRIM_DV_PRIM_RAM_SCR_CPP_SCRAMBLE_MODEL_H_
 #define OPENTITAN_HW_IP_PRIM_DV_PRIM_RAM_SCR_CPP_SCRAMBLE_MODEL_H_
 
+#include <array>
 #include <stdint.h>
 #include <vector>
 
 const uint32_t kPrinceWidth = 64;
 const uint32_t kPrinceWidthByte = kPrinceWidth / 8;
 
+// The widest nonce supported by the fixed-width API below
+const uint32_t kScrambleMaxNonceWidth = 320;
+const uint32_t kScrambleMaxNonceWords64 = (kScrambleMaxNonceWidth + 63) / 64;
+
 // C++ model of memory scrambling. All byte vectors are in little endian byte
 // order (least significant byte at index 0).
 
@@ -76,4 +81,71 @@ std::vector<uint8_t> scramble_encrypt_data(
     uint32_t addr_width, const std::vector<uint8_t> &nonce,
     const std::vector<uint8_t> &key, bool repeat_keystream, bool use_sp_layer);
 
+// Fixed-width variant of the model. This avoids allocating on every call by
+// working on 64-bit words (least significant word first) with caller-provided
+// output buffers, and by converting the key and nonce once, up front. It
+// models the data scrambling without the S&P layer (which is how the hardware
+// is configured, see #20788).
+
+/** Key and nonce for scrambling, in a form that can be used for many words.
+ *
+ * Construct this once after the memory has been keyed and then pass it to the
+ * fixed-width functions below.
+ */
+struct ScrambleKeySchedule {
+  /**
+   * @param key         Byte vector of scrambling key (kPrinceWidthByte * 2
+   *                    bytes)
+   * @param nonce       Byte vector of scrambling nonce
+   * @param nonce_width Width of scramble nonce in bits (at most
+   *                    kScrambleMaxNonceWidth)
+   */
+  ScrambleKeySchedule(const std::vector<uint8_t> &key,
+                      const std::vector<uint8_t> &nonce, uint32_t nonce_width);
+
+  // PRINCE whitening and core keys, as used by prince_enc_dec_uint64
+  uint64_t k0, k0_prime, k1;
+
+  uint32_t nonce_width;
+  std::array<uint64_t, kScrambleMaxNonceWords64> nonce;
+};
+
+/** Scramble an address to give the physical address used to access the
+ * scrambled memory.
+ *
+ * @param addr_in    Address to scramble
+ * @param addr_width Width of the address in bits (at most 32)
+ * @param ks         Key schedule, holding the scrambling nonce
+ * @return Scrambled address
+ */
+uint32_t scramble_addr(uint32_t addr_in, uint32_t addr_width,
+                       const ScrambleKeySchedule &ks);
+
+/** Encrypt scrambled data
+ *
+ * @param data_in          Data to encrypt, as (data_width + 63) / 64 words
+ * @param data_out         Output buffer, with space for as many words as
+ *                         data_in. This may alias data_in.
+ * @param data_width       Width of data in bits
+ * @param addr             Data address
+ * @param addr_width       Width of the address in bits (at most 32)
+ * @param ks               Key schedule
+ * @param repeat_keystream Repeat the keystream of one single PRINCE instance if
+ *                         set to true. Otherwise multiple PRINCE instances are
+ *                         used.
+ */
+void scramble_encrypt_data(const uint64_t *data_in, uint64_t *data_out,
+                           uint32_t data_width, uint32_t addr,
+                           uint32_t addr_width, const ScrambleKeySchedule &ks,
+                           bool repeat_keystream);
+
+/** Decrypt scrambled data
+ *
+ * The arguments are as for the fixed-width scramble_encrypt_data.
+ */
+void scramble_decrypt_data(const uint64_t *data_in, uint64_t *data_out,
+                           uint32_t data_width, uint32_t addr,
+                           uint32_t addr_width, const ScrambleKeySchedule &ks,
+                           bool repeat_keystream);
+
 #endif  // OPENTITAN_HW_IP_PRIM_DV_PRIM_RAM_SCR_CPP_SCRAMBLE_MODEL_H_
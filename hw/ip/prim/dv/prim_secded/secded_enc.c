@@ -8,21 +8,22 @@
 #include "secded_enc.h"
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 // Calculates even parity for a 64-bit word
-static uint8_t calc_parity(uint64_t word, bool invert) {
-  bool parity = false;
-
-  while (word) {
-    if (word & 1) {
-      parity = !parity;
-    }
-
-    word >>= 1;
-  }
-
-  return parity ^ invert;
+static inline uint8_t calc_parity(uint64_t word, bool invert) {
+#ifdef __GNUC__
+  return __builtin_parityll(word) ^ invert;
+#else
+  word ^= word >> 32;
+  word ^= word >> 16;
+  word ^= word >> 8;
+  word ^= word >> 4;
+  word ^= word >> 2;
+  word ^= word >> 1;
+  return (word & 1) ^ invert;
+#endif
 }
 
 uint8_t enc_secded_22_16(const uint8_t bytes[2]) {
@@ -36,6 +37,12 @@ uint8_t enc_secded_22_16(const uint8_t bytes[2]) {
          (calc_parity(word & 0x11f3, false) << 5);
 }
 
+void enc_secded_22_16_buf(const uint8_t *src, size_t n, uint8_t *out) {
+  for (size_t i = 0; i < n; ++i) {
+    out[i] = enc_secded_22_16(src + 2 * i);
+  }
+}
+
 uint8_t enc_secded_28_22(const uint8_t bytes[3]) {
   uint32_t word = ((uint32_t)bytes[0] << 0) | ((uint32_t)bytes[1] << 8) |
                   ((uint32_t)bytes[2] << 16);
@@ -48,6 +55,12 @@ uint8_t enc_secded_28_22(const uint8_t bytes[3]) {
          (calc_parity(word & 0x3ed348, false) << 5);
 }
 
+void enc_secded_28_22_buf(const uint8_t *src, size_t n, uint8_t *out) {
+  for (size_t i = 0; i < n; ++i) {
+    out[i] = enc_secded_28_22(src + 3 * i);
+  }
+}
+
 uint8_t enc_secded_39_32(const uint8_t bytes[4]) {
   uint32_t word = ((uint32_t)bytes[0] << 0) | ((uint32_t)bytes[1] << 8) |
                   ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
@@ -61,6 +74,12 @@ uint8_t enc_secded_39_32(const uint8_t bytes[4]) {
          (calc_parity(word & 0x98505586, false) << 6);
 }
 
+void enc_secded_39_32_buf(const uint8_t *src, size_t n, uint8_t *out) {
+  for (size_t i = 0; i < n; ++i) {
+    out[i] = enc_secded_39_32(src + 4 * i);
+  }
+}
+
 uint8_t enc_secded_64_57(const uint8_t bytes[8]) {
   uint64_t word = ((uint64_t)bytes[0] << 0) | ((uint64_t)bytes[1] << 8) |
                   ((uint64_t)bytes[2] << 16) | ((uint64_t)bytes[3] << 24) |
@@ -76,6 +95,12 @@ uint8_t enc_secded_64_57(const uint8_t bytes[8]) {
          (calc_parity(word & 0x1fbdda769a46910, false) << 6);
 }
 
+void enc_secded_64_57_buf(const uint8_t *src, size_t n, uint8_t *out) {
+  for (size_t i = 0; i < n; ++i) {
+    out[i] = enc_secded_64_57(src + 8 * i);
+  }
+}
+
 uint8_t enc_secded_72_64(const uint8_t bytes[8]) {
   uint64_t word = ((uint64_t)bytes[0] << 0) | ((uint64_t)bytes[1] << 8) |
                   ((uint64_t)bytes[2] << 16) | ((uint64_t)bytes[3] << 24) |
@@ -92,6 +117,12 @@ uint8_t enc_secded_72_64(const uint8_t bytes[8]) {
          (calc_parity(word & 0x7aed348d221a4420, false) << 7);
 }
 
+void enc_secded_72_64_buf(const uint8_t *src, size_t n, uint8_t *out) {
+  for (size_t i = 0; i < n; ++i) {
+    out[i] = enc_secded_72_64(src + 8 * i);
+  }
+}
+
 uint8_t enc_secded_inv_22_16(const uint8_t bytes[2]) {
   uint16_t word = ((uint16_t)bytes[0] << 0) | ((uint16_t)bytes[1] << 8);
 
@@ -103,6 +134,12 @@ uint8_t enc_secded_inv_22_16(const uint8_t bytes[2]) {
          (calc_parity(word & 0x11f3, true) << 5);
 }
 
+void enc_secded_inv_22_16_buf(const uint8_t *src, size_t n, uint8_t *out) {
+  for (size_t i = 0; i < n; ++i) {
+    out[i] = enc_secded_inv_22_16(src + 2 * i);
+  }
+}
+
 uint8_t enc_secded_inv_28_22(const uint8_t bytes[3]) {
   uint32_t word = ((uint32_t)bytes[0] << 0) | ((uint32_t)bytes[1] << 8) |
                   ((uint32_t)bytes[2] << 16);
@@ -115,6 +152,12 @@ uint8_t enc_secded_inv_28_22(const uint8_t bytes[3]) {
          (calc_parity(word & 0x3ed348, true) << 5);
 }
 
+void enc_secded_inv_28_22_buf(const uint8_t *src, size_t n, uint8_t *out) {
+  for (size_t i = 0; i < n; ++i) {
+    out[i] = enc_secded_inv_28_22(src + 3 * i);
+  }
+}
+
 uint8_t enc_secded_inv_39_32(const uint8_t bytes[4]) {
   uint32_t word = ((uint32_t)bytes[0] << 0) | ((uint32_t)bytes[1] << 8) |
                   ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
@@ -128,6 +171,12 @@ uint8_t enc_secded_inv_39_32(const uint8_t bytes[4]) {
          (calc_parity(word & 0x98505586, false) << 6);
 }
 
+void enc_secded_inv_39_32_buf(const uint8_t *src, size_t n, uint8_t *out) {
+  for (size_t i = 0; i < n; ++i) {
+    out[i] = enc_secded_inv_39_32(src + 4 * i);
+  }
+}
+
 uint8_t enc_secded_inv_64_57(const uint8_t bytes[8]) {
   uint64_t word = ((uint64_t)bytes[0] << 0) | ((uint64_t)bytes[1] << 8) |
                   ((uint64_t)bytes[2] << 16) | ((uint64_t)bytes[3] << 24) |
@@ -143,6 +192,12 @@ uint8_t enc_secded_inv_64_57(const uint8_t bytes[8]) {
          (calc_parity(word & 0x1fbdda769a46910, false) << 6);
 }
 
+void enc_secded_inv_64_57_buf(const uint8_t *src, size_t n, uint8_t *out) {
+  for (size_t i = 0; i < n; ++i) {
+    out[i] = enc_secded_inv_64_57(src + 8 * i);
+  }
+}
+
 uint8_t enc_secded_inv_72_64(const uint8_t bytes[8]) {
   uint64_t word = ((uint64_t)bytes[0] << 0) | ((uint64_t)bytes[1] << 8) |
                   ((uint64_t)bytes[2] << 16) | ((uint64_t)bytes[3] << 24) |
@@ -158,3 +213,9 @@ uint8_t enc_secded_inv_72_64(const uint8_t bytes[8]) {
          (calc_parity(word & 0xcbdaaa4a91152210, false) << 6) |
          (calc_parity(word & 0x7aed348d221a4420, true) << 7);
 }
+
+void enc_secded_inv_72_64_buf(const uint8_t *src, size_t n, uint8_t *out) {
+  for (size_t i = 0; i < n; ++i) {
+    out[i] = enc_secded_inv_72_64(src + 8 * i);
+  }
+}
@@ -8,6 +8,7 @@
 #ifndef OPENTITAN_HW_IP_PRIM_DV_PRIM_SECDED_SECDED_ENC_H_
 #define OPENTITAN_HW_IP_PRIM_DV_PRIM_SECDED_SECDED_ENC_H_
 
+#include <stddef.h>
 #include <stdint.h>
 
 #ifdef __cplusplus
@@ -17,17 +18,31 @@ extern "C" {
 // Integrity encode functions for varying bit widths matching the functionality
 // of the RTL modules of the same name. Each takes an array of bytes in
 // little-endian order and returns the calculated integrity bits.
+//
+// The `_buf` variants encode `n` consecutive words, reading each word's bytes
+// from `src` in turn and writing its integrity bits to the matching element of
+// `out`. Use them to encode whole memory images.
 
 uint8_t enc_secded_22_16(const uint8_t bytes[2]);
+void enc_secded_22_16_buf(const uint8_t *src, size_t n, uint8_t *out);
 uint8_t enc_secded_28_22(const uint8_t bytes[3]);
+void enc_secded_28_22_buf(const uint8_t *src, size_t n, uint8_t *out);
 uint8_t enc_secded_39_32(const uint8_t bytes[4]);
+void enc_secded_39_32_buf(const uint8_t *src, size_t n, uint8_t *out);
 uint8_t enc_secded_64_57(const uint8_t bytes[8]);
+void enc_secded_64_57_buf(const uint8_t *src, size_t n, uint8_t *out);
 uint8_t enc_secded_72_64(const uint8_t bytes[8]);
+void enc_secded_72_64_buf(const uint8_t *src, size_t n, uint8_t *out);
 uint8_t enc_secded_inv_22_16(const uint8_t bytes[2]);
+void enc_secded_inv_22_16_buf(const uint8_t *src, size_t n, uint8_t *out);
 uint8_t enc_secded_inv_28_22(const uint8_t bytes[3]);
+void enc_secded_inv_28_22_buf(const uint8_t *src, size_t n, uint8_t *out);
 uint8_t enc_secded_inv_39_32(const uint8_t bytes[4]);
+void enc_secded_inv_39_32_buf(const uint8_t *src, size_t n, uint8_t *out);
 uint8_t enc_secded_inv_64_57(const uint8_t bytes[8]);
+void enc_secded_inv_64_57_buf(const uint8_t *src, size_t n, uint8_t *out);
 uint8_t enc_secded_inv_72_64(const uint8_t bytes[8]);
+void enc_secded_inv_72_64_buf(const uint8_t *src, size_t n, uint8_t *out);
 
 #ifdef __cplusplus
 }  // extern "C"
@@ -201,6 +201,23 @@ class sram_ctrl_bkdr_util extends mem_bkdr_util;
                                    logic [SRAM_KEY_WIDTH-1:0]         key,
                                    logic [SRAM_BLOCK_WIDTH-1:0]       nonce);
     bit [38:0] preload_data[] = new [num_entries];
+
+    // With the default number of PRINCE rounds, the whole image is encrypted in one DPI call. The
+    // result holds every row of the memory, indexed by scrambled address, so only the writes are
+    // left to do here.
+    if (num_prince_rounds_half == 3 && num_entries == depth && depth == (1 << addr_width)) begin
+      string scr_file = $sformatf("sram_ctrl_bkdr_util_%0d_scr.vmem", get_inst_id());
+      if (mem_bkdr_util_dpi_sram_scramble_vmem(file, scr_file, num_entries,
+                                               addr_offset >> addr_lsb, addr_width,
+                                               key, nonce) >= 0) begin
+        $readmemh(scr_file, preload_data);
+        foreach (preload_data[i]) begin
+          write39integ(i << addr_lsb, preload_data[i]);
+        end
+        return;
+      end
+    end
+
     $readmemh(file, preload_data);
     foreach(preload_data[i]) begin
       sram_encrypt_write32_integ(addr_offset + i * 4, preload_data[i], key, nonce, 0);
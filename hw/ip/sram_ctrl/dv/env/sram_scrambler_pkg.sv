@@ -149,8 +149,6 @@ package sram_scrambler_pkg;
   function automatic state_t gen_keystream(logic addr[], int addr_width,
                                            logic key[], logic nonce[],
                                            int num_prince_rounds_half = 3);
-    logic [NUM_PRINCE_ROUNDS_HALF_MAX-1:0][SRAM_BLOCK_WIDTH-1:0] prince_result_arr;
-
     logic [SRAM_BLOCK_WIDTH-1:0]  prince_plaintext;
     logic [SRAM_KEY_WIDTH-1:0]    prince_key;
     logic [SRAM_BLOCK_WIDTH-1:0]  prince_result;
@@ -180,11 +178,13 @@ package sram_scrambler_pkg;
       prince_key[i] = key[i];
     end
 
-    crypto_dpi_prince_pkg::sv_dpi_prince_encrypt(.plaintext(prince_plaintext),
-                                                 .key(prince_key),
-                                                 .old_key_schedule(0),
-                                                 .ciphertext(prince_result_arr));
-    prince_result = prince_result_arr[num_prince_rounds_half-1];
+    // Only the result after num_prince_rounds_half half-rounds is needed, so compute just that
+    // one rather than the results for every possible number of half-rounds.
+    prince_result = crypto_dpi_prince_pkg::c_dpi_prince_encrypt(prince_plaintext,
+                                                                prince_key[127:64],
+                                                                prince_key[63:0],
+                                                                num_prince_rounds_half,
+                                                                0);
 
     key_out = {<< {prince_result}};
 
@@ -0,0 +1,92 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <iostream>
+#include <string>
+
+#include "ecc32_mem_area.h"
+#include "elf_symbol_memutil.h"
+#include "fixed_width_mem_area.h"
+#include "scrambled_ecc32_mem_area.h"
+#include "verilated_toplevel.h"
+#include "verilator_memutil.h"
+#include "verilator_pc_profile.h"
+#include "verilator_sim_ctrl.h"
+
+#ifdef DPI_SHLIB
+#include "dpi_shlib.h"
+#endif
+
+int main(int argc, char **argv) {
+#ifdef DPI_SHLIB
+  // The DPI modules are in a separate library, which must be loaded before
+  // the initial blocks of the model call into them.
+  if (!DpiShlibLoadFromArgs(argc, argv)) {
+    return 1;
+  }
+#endif
+
+  chip_sim_tb top;
+  // The memory utilities keep the symbols of loaded ELF files for the PC
+  // profile.
+  ElfSymbolMemUtil elf_symbols;
+  VerilatorMemUtil memutil(&elf_symbols);
+  VerilatorPcProfile pc_profile(&elf_symbols);
+  VerilatorSimCtrl &simctrl = VerilatorSimCtrl::GetInstance();
+  simctrl.SetTop(&top, &top.clk_i, &top.rst_ni,
+                 VerilatorSimCtrlFlags::ResetPolarityNegative);
+
+  std::string chip_scope("TOP.chip_sim_tb.u_dut");
+  std::string top_scope(chip_scope + ".top_darjeeling");
+  std::string ram1p_adv_scope(
+      "u_prim_ram_1p_adv.gen_ram_inst[0].u_mem."
+      "gen_generic.u_impl_generic");
+  std::string rom_scope(
+      ".gen_rom_scramble_enabled.u_rom.u_rom."
+      "u_prim_rom.gen_generic.u_impl_generic");
+
+  FixedWidthMemArea<32> rom0(top_scope + ".u_rom_ctrl0" + rom_scope,
+                             0x8000 / 4);
+  FixedWidthMemArea<32> rom1(top_scope + ".u_rom_ctrl1" + rom_scope,
+                             0x10000 / 4);
+  // The SRAMs are scrambled with the key and nonce that sram_ctrl currently
+  // holds, so images must be loaded after these have been set up.
+  ScrambledEcc32MemArea ram(
+      top_scope + ".u_sram_ctrl_main.u_prim_ram_1p_scr", 0x10000 / 4, 1);
+  ScrambledEcc32MemArea mbox(
+      top_scope + ".u_sram_ctrl_mbox.u_prim_ram_1p_scr", 0x1000 / 4, 1);
+  // The CTN SRAM is part of the chip level and only protected by the TL-UL
+  // integrity bits.
+  Ecc32MemArea ctn(chip_scope + ".u_prim_ram_1p_adv_ctn.gen_ram_inst[0].u_mem."
+                                "gen_generic.u_impl_generic",
+                   0x100000 / 4, 1);
+
+  FixedWidthMemArea<32> otp(
+      top_scope + ".u_otp_ctrl.u_otp.gen_generic.u_impl_generic." +
+          ram1p_adv_scope,
+      0x4000 / 4);
+
+  memutil.RegisterMemoryArea("rom", 0x8000, &rom0);
+  memutil.RegisterMemoryArea("rom1", 0x20000, &rom1);
+  memutil.RegisterMemoryArea("ram", 0x10000000u, &ram);
+  memutil.RegisterMemoryArea("mbox", 0x11000000u, &mbox);
+  memutil.RegisterMemoryArea("ctn", 0x41000000u, &ctn);
+  memutil.RegisterMemoryArea("otp", 0x40000000u /* (bogus LMA) */, &otp);
+  simctrl.RegisterExtension(&memutil);
+  simctrl.RegisterExtension(&pc_profile);
+
+  // The initial reset delay must be long enough such that pwr/rst/clkmgr will
+  // release clocks to the entire design.  This allows for synchronous resets
+  // to appropriately propagate.
+  // The reset duration must be appropriately sized to the divider for clk_aon
+  // in chip_darjeeling_verilator.sv.  It must be at least 2 cycles of clk_aon.
+  simctrl.SetInitialResetDelay(20000);
+  simctrl.SetResetDuration(10);
+
+  std::cout << "Simulation of OpenTitan Darjeeling" << std::endl
+            << "==================================" << std::endl
+            << std::endl;
+
+  return simctrl.Exec(argc, argv).first;
+}
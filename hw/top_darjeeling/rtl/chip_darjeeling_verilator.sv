@@ -0,0 +1,708 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+module chip_darjeeling_verilator (
+  // Clock and Reset
+  input clk_i,
+  input rst_ni,
+
+  // communication with GPIO
+  input [31:0] cio_gpio_p2d_i,
+  output logic [31:0] cio_gpio_d2p_o,
+  output logic [31:0] cio_gpio_en_d2p_o,
+  output logic [31:0] cio_gpio_pull_en_o,
+  output logic [31:0] cio_gpio_pull_select_o,
+
+  // communication with UART
+  input cio_uart_rx_p2d_i,
+  output logic cio_uart_tx_d2p_o,
+  output logic cio_uart_tx_en_d2p_o,
+
+  // communication with SPI
+  input cio_spi_device_sck_p2d_i,
+  input cio_spi_device_csb_p2d_i,
+  input cio_spi_device_sdi_p2d_i,
+  output logic cio_spi_device_sdo_d2p_o,
+  output logic cio_spi_device_sdo_en_d2p_o,
+
+  // communication with JTAG
+  input cio_jtag_tck_p2d_i,
+  input cio_jtag_tms_p2d_i,
+  input cio_jtag_tdi_p2d_i,
+  input cio_jtag_trst_n_p2d_i,
+  output logic cio_jtag_tdo_d2p_o
+);
+
+  import top_darjeeling_pkg::*;
+
+  // TODO: instantiate padring and route these signals through that module
+  logic [pinmux_reg_pkg::NDioPads-1:0] dio_in;
+  logic [pinmux_reg_pkg::NDioPads-1:0] dio_out;
+  logic [pinmux_reg_pkg::NDioPads-1:0] dio_oe;
+  prim_pad_wrapper_pkg::pad_attr_t[pinmux_reg_pkg::NDioPads-1:0] dio_attr;
+
+  // All GPIOs, the UART and the SPI device are on dedicated pads in Darjeeling.
+  always_comb begin : assign_dio_in
+    dio_in = '0;
+    dio_in[DioGpioGpio31:DioGpioGpio0] = cio_gpio_p2d_i;
+    dio_in[DioSpiDeviceSck] = cio_spi_device_sck_p2d_i;
+    dio_in[DioSpiDeviceCsb] = cio_spi_device_csb_p2d_i;
+    dio_in[DioSpiDeviceSd0] = cio_spi_device_sdi_p2d_i;
+    dio_in[DioUart0Rx] = cio_uart_rx_p2d_i;
+  end
+
+  assign cio_gpio_d2p_o    = dio_out[DioGpioGpio31:DioGpioGpio0];
+  assign cio_gpio_en_d2p_o = dio_oe[DioGpioGpio31:DioGpioGpio0];
+
+  // Note: we're collecting the `pull_en` and `pull_select` signals together
+  // so that the GPIO DPI functions can simulate weak and strong GPIO
+  // inputs.  The `cio_gpio_pull_en_o` and `cio_gpio_pull_select_o` bit
+  // vectors should have the same ordering as the `cio_gpio_d2p_o` vector.
+  // See gpiodpi.c to see how weak/strong inputs work.
+  always_comb begin : assign_gpio_pull
+    for (int i = 0; i < 32; i++) begin
+      cio_gpio_pull_en_o[i]     = dio_attr[DioGpioGpio0 + i].pull_en;
+      cio_gpio_pull_select_o[i] = dio_attr[DioGpioGpio0 + i].pull_select;
+    end
+  end
+
+  assign cio_uart_tx_d2p_o    = dio_out[DioUart0Tx];
+  assign cio_uart_tx_en_d2p_o = dio_oe[DioUart0Tx];
+
+  assign cio_spi_device_sdo_d2p_o    = dio_out[DioSpiDeviceSd1];
+  assign cio_spi_device_sdo_en_d2p_o = dio_oe[DioSpiDeviceSd1];
+
+  // There is nothing connected to the muxed pads.
+  logic [pinmux_reg_pkg::NMioPads-1:0] mio_in;
+  logic [pinmux_reg_pkg::NMioPads-1:0] mio_out;
+  logic [pinmux_reg_pkg::NMioPads-1:0] mio_oe;
+  prim_pad_wrapper_pkg::pad_attr_t[pinmux_reg_pkg::NMioPads-1:0] mio_attr;
+  assign mio_in = '0;
+
+  logic unused_pads;
+  assign unused_pads = ^{mio_out, mio_oe, mio_attr};
+
+  ////////////////////////////////
+  // AST - Custom for Verilator //
+  ////////////////////////////////
+  ast_pkg::ast_pwst_t ast_pwst;
+
+  // pwrmgr interface
+  pwrmgr_pkg::pwr_ast_req_t base_ast_pwr;
+  pwrmgr_pkg::pwr_ast_rsp_t ast_base_pwr;
+  pwrmgr_pkg::pwr_boot_status_t pwrmgr_boot_status;
+
+  ast_pkg::ast_clks_t ast_base_clks;
+
+  logic clk_aon;
+  // reset is not used below becuase verilator uses only sync resets
+  // and also does not under 'x'.
+  // if we allow the divider below to reset, clk_aon will be silenced,
+  // and as a result all the clk_aon logic inside top_darjeeling does not
+  // get reset
+  prim_clock_div #(
+    .Divisor(4)
+  ) u_aon_div (
+    .clk_i,
+    .rst_ni(1'b1),
+    .step_down_req_i('0),
+    .step_down_ack_o(),
+    .test_en_i('0),
+    .clk_o(clk_aon)
+  );
+
+  ast_pkg::clks_osc_byp_t clks_osc_byp;
+  assign clks_osc_byp = '{
+    usb: clk_i,
+    sys: clk_i,
+    io:  clk_i,
+    aon: clk_aon
+  };
+
+  ///////////////////////////////////////
+  // AST - Common with other platforms //
+  ///////////////////////////////////////
+
+  // platform specific supply manipulation to create POR
+  logic [3:0] cnt;
+  logic vcc_supp;
+
+  // keep incrementing until saturation
+  always_ff @(posedge clk_aon) begin
+    if (cnt < 4'hf) begin
+      cnt <= cnt + 1'b1;
+    end
+  end
+
+  // create fake por condition
+  assign vcc_supp = cnt < 4'h4 ? 1'b0 :
+                    cnt < 4'h8 ? 1'b1 :
+                    cnt < 4'hc ? 1'b0 : 1'b1;
+
+  // TLUL interface
+  tlul_pkg::tl_h2d_t base_ast_bus;
+  tlul_pkg::tl_d2h_t ast_base_bus;
+
+  assign ast_base_pwr.main_pok = ast_pwst.main_pok;
+
+  logic [rstmgr_pkg::PowerDomains-1:0] por_n;
+  assign por_n = {ast_pwst.main_pok, ast_pwst.aon_pok};
+
+  // synchronization clocks / rests
+  clkmgr_pkg::clkmgr_out_t clkmgr_aon_clocks;
+  rstmgr_pkg::rstmgr_out_t rstmgr_aon_resets;
+
+  // monitored clock
+  logic sck_monitor;
+
+  // observe interface
+  logic [7:0] otp_obs;
+  ast_pkg::ast_obs_ctrl_t obs_ctrl;
+
+  // otp power sequence
+  otp_ctrl_pkg::otp_ast_req_t otp_ctrl_otp_ast_pwr_seq;
+  otp_ctrl_pkg::otp_ast_rsp_t otp_ctrl_otp_ast_pwr_seq_h;
+
+  // entropy source interface
+  entropy_src_pkg::entropy_src_hw_if_req_t entropy_src_hw_if_req;
+  entropy_src_pkg::entropy_src_hw_if_rsp_t entropy_src_hw_if_rsp;
+
+  // entropy distribution network
+  edn_pkg::edn_req_t ast_edn_edn_req;
+  edn_pkg::edn_rsp_t ast_edn_edn_rsp;
+
+  // alerts interface
+  ast_pkg::ast_alert_rsp_t ast_alert_rsp;
+  ast_pkg::ast_alert_req_t ast_alert_req;
+  assign ast_alert_rsp = '0;
+
+  // clock bypass req/ack
+  prim_mubi_pkg::mubi4_t io_clk_byp_req;
+  prim_mubi_pkg::mubi4_t io_clk_byp_ack;
+  prim_mubi_pkg::mubi4_t all_clk_byp_req;
+  prim_mubi_pkg::mubi4_t all_clk_byp_ack;
+  prim_mubi_pkg::mubi4_t hi_speed_sel;
+  prim_mubi_pkg::mubi4_t div_step_down_req;
+
+  // DFT connections
+  logic scan_en;
+  logic scan_rst_n;
+  prim_mubi_pkg::mubi4_t scanmode;
+  lc_ctrl_pkg::lc_tx_t lc_dft_en;
+
+  // Jitter enable
+  prim_mubi_pkg::mubi4_t jen;
+
+  // reset domain connections
+  import rstmgr_pkg::PowerDomains;
+  import rstmgr_pkg::DomainAonSel;
+  import rstmgr_pkg::Domain0Sel;
+
+  // AST does not use all clocks / resets forwarded to it
+  logic unused_slow_clk_en;
+  assign unused_slow_clk_en = base_ast_pwr.slow_clk_en;
+
+  logic unused_pwr_clamp;
+  assign unused_pwr_clamp = base_ast_pwr.pwr_clamp;
+
+  prim_mubi_pkg::mubi4_t ast_init_done;
+
+  ast #(
+    .EntropyStreams(ast_pkg::EntropyStreams),
+    .AdcChannels(ast_pkg::AdcChannels),
+    .AdcDataWidth(ast_pkg::AdcDataWidth),
+    .UsbCalibWidth(ast_pkg::UsbCalibWidth),
+    .Ast2PadOutWidth(ast_pkg::Ast2PadOutWidth),
+    .Pad2AstInWidth(ast_pkg::Pad2AstInWidth)
+  ) u_ast (
+    // different between verilator and other platforms
+    .clk_ast_ext_i         ( clk_i ),
+    .por_ni                ( rst_ni ),
+    // clocks' oschillator bypass for FPGA
+    .clk_osc_byp_i         ( clks_osc_byp ),
+    // USB IO Pull-up Calibration Setting
+    .usb_io_pu_cal_o       ( ),
+    // adc
+    .adc_a0_ai             ( '0 ),
+    .adc_a1_ai             ( '0 ),
+    // Direct short to PAD
+    .ast2pad_t0_ao         ( ),
+    .ast2pad_t1_ao         ( ),
+    // clocks and resets supplied for detection
+    .sns_clks_i            ( clkmgr_aon_clocks    ),
+    .sns_rsts_i            ( rstmgr_aon_resets    ),
+    .sns_spi_ext_clk_i     ( sck_monitor          ),
+    // tlul
+    .tl_i                  ( base_ast_bus ),
+    .tl_o                  ( ast_base_bus ),
+    // init done indication
+    .ast_init_done_o       ( ast_init_done ),
+    // buffered clocks & resets
+    .clk_ast_tlul_i (clkmgr_aon_clocks.clk_io_div4_infra),
+    .clk_ast_adc_i (clkmgr_aon_clocks.clk_aon_peri),
+    .clk_ast_alert_i (clkmgr_aon_clocks.clk_io_div4_secure),
+    .clk_ast_es_i (clkmgr_aon_clocks.clk_main_secure),
+    .clk_ast_rng_i (clkmgr_aon_clocks.clk_main_secure),
+    .clk_ast_usb_i (clkmgr_aon_clocks.clk_usb_peri),
+    .rst_ast_tlul_ni (rstmgr_aon_resets.rst_lc_io_div4_n[rstmgr_pkg::Domain0Sel]),
+    .rst_ast_adc_ni (rstmgr_aon_resets.rst_lc_aon_n[rstmgr_pkg::DomainAonSel]),
+    .rst_ast_alert_ni (rstmgr_aon_resets.rst_lc_io_div4_n[rstmgr_pkg::Domain0Sel]),
+    .rst_ast_es_ni (rstmgr_aon_resets.rst_lc_n[rstmgr_pkg::Domain0Sel]),
+    .rst_ast_rng_ni (rstmgr_aon_resets.rst_lc_n[rstmgr_pkg::Domain0Sel]),
+    .rst_ast_usb_ni (rstmgr_aon_resets.rst_por_usb_n[rstmgr_pkg::Domain0Sel]),
+
+    // pok test for FPGA
+    .vcc_supp_i            ( vcc_supp ),
+    .vcaon_supp_i          ( 1'b1 ),
+    .vcmain_supp_i         ( 1'b1 ),
+    .vioa_supp_i           ( 1'b1 ),
+    .viob_supp_i           ( 1'b1 ),
+    // pok
+    .ast_pwst_o            ( ast_pwst ),
+    .ast_pwst_h_o          ( ),
+    // main regulator
+    .main_env_iso_en_i     ( base_ast_pwr.pwr_clamp_env ),
+    .main_pd_ni            ( base_ast_pwr.main_pd_n ),
+    // pdm control (flash)/otp
+    .flash_power_down_h_o  ( ),
+    .flash_power_ready_h_o ( ),
+    .otp_power_seq_i       ( otp_ctrl_otp_ast_pwr_seq ),
+    .otp_power_seq_h_o     ( otp_ctrl_otp_ast_pwr_seq_h ),
+    // system source clock
+    .clk_src_sys_en_i      ( base_ast_pwr.core_clk_en ),
+    // need to add function in clkmgr
+    .clk_src_sys_jen_i     ( jen ),
+    .clk_src_sys_o         ( ast_base_clks.clk_sys  ),
+    .clk_src_sys_val_o     ( ast_base_pwr.core_clk_val ),
+    // aon source clock
+    .clk_src_aon_o         ( ast_base_clks.clk_aon ),
+    .clk_src_aon_val_o     ( ast_base_pwr.slow_clk_val ),
+    // io source clock
+    .clk_src_io_en_i       ( base_ast_pwr.io_clk_en ),
+    .clk_src_io_o          ( ast_base_clks.clk_io ),
+    .clk_src_io_val_o      ( ast_base_pwr.io_clk_val ),
+    .clk_src_io_48m_o      ( div_step_down_req ),
+    // usb source clock
+    .usb_ref_pulse_i       ( '0 ),
+    .usb_ref_val_i         ( '0 ),
+    .clk_src_usb_en_i      ( base_ast_pwr.usb_clk_en ),
+    .clk_src_usb_o         ( ast_base_clks.clk_usb ),
+    .clk_src_usb_val_o     ( ast_base_pwr.usb_clk_val ),
+    // entropy_src
+    .es_req_i              ( entropy_src_hw_if_req ),
+    .es_rsp_o              ( entropy_src_hw_if_rsp ),
+    // adc
+    .adc_pd_i              ( '0 ),
+    .adc_chnsel_i          ( '0 ),
+    .adc_d_o               (    ),
+    .adc_d_val_o           (    ),
+    // entropy
+    .entropy_rsp_i         ( ast_edn_edn_rsp ),
+    .entropy_req_o         ( ast_edn_edn_req ),
+    // alerts
+    .alert_rsp_i           ( ast_alert_rsp  ),
+    .alert_req_o           ( ast_alert_req  ),
+    // dft
+    .lc_dft_en_i           ( lc_dft_en        ),
+    .fla_obs_i             ( '0 ),
+    .usb_obs_i             ( '0 ),
+    .otp_obs_i             ( otp_obs ),
+    .otm_obs_i             ( '0 ),
+    .obs_ctrl_o            ( obs_ctrl ),
+    // pinmux related
+    .padmux2ast_i          ( '0         ),
+    .ast2padmux_o          (            ),
+    .ext_freq_is_96m_i     ( hi_speed_sel ),
+    .all_clk_byp_req_i     ( all_clk_byp_req  ),
+    .all_clk_byp_ack_o     ( all_clk_byp_ack  ),
+    .io_clk_byp_req_i      ( io_clk_byp_req   ),
+    .io_clk_byp_ack_o      ( io_clk_byp_ack   ),
+    .flash_bist_en_o       ( ),
+    // Memory configuration connections
+    .dpram_rmf_o           ( ),
+    .dpram_rml_o           ( ),
+    .spram_rm_o            ( ),
+    .sprgf_rm_o            ( ),
+    .sprom_rm_o            ( ),
+    // scan
+    .dft_scan_md_o         ( scanmode ),
+    .scan_shift_en_o       ( scan_en ),
+    .scan_reset_no         ( scan_rst_n )
+  );
+
+  //////////////////
+  // TAP Instance //
+  //////////////////
+
+  tlul_pkg::tl_h2d_t dmi_h2d;
+  tlul_pkg::tl_d2h_t dmi_d2h;
+  jtag_pkg::jtag_req_t jtag_req;
+  jtag_pkg::jtag_rsp_t jtag_rsp;
+
+  assign jtag_req.tck    = cio_jtag_tck_p2d_i;
+  assign jtag_req.tms    = cio_jtag_tms_p2d_i;
+  assign jtag_req.trst_n = cio_jtag_trst_n_p2d_i;
+  assign jtag_req.tdi    = cio_jtag_tdi_p2d_i;
+  assign cio_jtag_tdo_d2p_o = jtag_rsp.tdo;
+
+  tlul_jtag_dtm #(
+    .IdcodeValue(jtag_id_pkg::LC_DM_COMBINED_JTAG_IDCODE),
+    // See chip_darjeeling_asic.sv for the choice of this width.
+    .NumDmiByteAbits(18)
+  ) u_tlul_jtag_dtm (
+    .clk_i      (clkmgr_aon_clocks.clk_main_infra),
+    .rst_ni     (rstmgr_aon_resets.rst_sys_n[rstmgr_pkg::Domain0Sel]),
+    .jtag_i     (jtag_req),
+    .jtag_o     (jtag_rsp),
+    .scan_rst_ni(scan_rst_n),
+    .scanmode_i (scanmode),
+    .tl_h2d_o   (dmi_h2d),
+    .tl_d2h_i   (dmi_d2h)
+  );
+
+  ////////////////////////////////////////////
+  // CTN Address decoding and SRAM Instance //
+  ////////////////////////////////////////////
+
+  // The CTN SRAM is where test software is loaded. This is the same as in
+  // chip_darjeeling_asic.sv, minus the unused second CTN host.
+  localparam int CtnSramDw = top_pkg::TL_DW + tlul_pkg::DataIntgWidth;
+
+  tlul_pkg::tl_h2d_t ctn_tl_h2d;
+  tlul_pkg::tl_d2h_t ctn_tl_d2h;
+  tlul_pkg::tl_h2d_t ctn_s1n_tl_h2d[1];
+  tlul_pkg::tl_d2h_t ctn_s1n_tl_d2h[1];
+
+  // Steering signal for address decoding.
+  logic [0:0] ctn_dev_sel_s1n;
+
+  logic sram_req, sram_we, sram_rvalid;
+  logic [top_pkg::CtnSramAw-1:0] sram_addr;
+  logic [CtnSramDw-1:0] sram_wdata, sram_wmask, sram_rdata;
+
+  always_comb begin
+    // Default steering to generate error response if address is not within the range
+    ctn_dev_sel_s1n = 1'b1;
+    // Steering to CTN SRAM.
+    if ((ctn_tl_h2d.a_address & ~(TOP_DARJEELING_RAM_CTN_SIZE_BYTES-1)) ==
+        (TOP_DARJEELING_RAM_CTN_BASE_ADDR - TOP_DARJEELING_CTN_BASE_ADDR)) begin
+      ctn_dev_sel_s1n = 1'd0;
+    end
+  end
+
+  tlul_socket_1n #(
+    .HReqDepth (4'h0),
+    .HRspDepth (4'h0),
+    .DReqDepth (8'h0),
+    .DRspDepth (8'h0),
+    .N         (1)
+  ) u_ctn_s1n (
+    .clk_i        (clkmgr_aon_clocks.clk_main_infra),
+    .rst_ni       (rstmgr_aon_resets.rst_lc_n[rstmgr_pkg::Domain0Sel]),
+    .tl_h_i       (ctn_tl_h2d),
+    .tl_h_o       (ctn_tl_d2h),
+    .tl_d_o       (ctn_s1n_tl_h2d),
+    .tl_d_i       (ctn_s1n_tl_d2h),
+    .dev_select_i (ctn_dev_sel_s1n)
+  );
+
+  tlul_adapter_sram #(
+    .SramAw(top_pkg::CtnSramAw),
+    .SramDw(CtnSramDw - tlul_pkg::DataIntgWidth),
+    .Outstanding(2),
+    .ByteAccess(1),
+    .CmdIntgCheck(1),
+    .EnableRspIntgGen(1),
+    .EnableDataIntgGen(0),
+    .EnableDataIntgPt(1),
+    .SecFifoPtr      (0)
+  ) u_tlul_adapter_sram_ctn (
+    .clk_i       (clkmgr_aon_clocks.clk_main_infra),
+    .rst_ni      (rstmgr_aon_resets.rst_lc_n[rstmgr_pkg::Domain0Sel]),
+    .tl_i        (ctn_s1n_tl_h2d[0]),
+    .tl_o        (ctn_s1n_tl_d2h[0]),
+    // Ifetch is explicitly allowed
+    .en_ifetch_i (prim_mubi_pkg::MuBi4True),
+    .req_o       (sram_req),
+    .req_type_o  (),
+    // SRAM can always accept a request.
+    .gnt_i       (1'b1),
+    .we_o        (sram_we),
+    .addr_o      (sram_addr),
+    .wdata_o     (sram_wdata),
+    .wmask_o     (sram_wmask),
+    .intg_error_o(),
+    .user_rsvd_o (),
+    .rdata_i     (sram_rdata),
+    .rvalid_i    (sram_rvalid),
+    .rerror_i    ('0),
+    .compound_txn_in_progress_o(),
+    .readback_en_i(prim_mubi_pkg::MuBi4False),
+    .readback_error_o(),
+    .wr_collision_i(1'b0),
+    .write_pending_i(1'b0)
+  );
+
+  prim_ram_1p_adv #(
+    .Depth(top_pkg::CtnSramDepth),
+    .Width(CtnSramDw),
+    .DataBitsPerMask(CtnSramDw),
+    .EnableECC(0),
+    .EnableParity(0),
+    .EnableInputPipeline(1),
+    .EnableOutputPipeline(1)
+  ) u_prim_ram_1p_adv_ctn (
+    .clk_i    (clkmgr_aon_clocks.clk_main_infra),
+    .rst_ni   (rstmgr_aon_resets.rst_lc_n[rstmgr_pkg::Domain0Sel]),
+    .req_i    (sram_req),
+    .write_i  (sram_we),
+    .addr_i   (sram_addr),
+    .wdata_i  (sram_wdata),
+    .wmask_i  (sram_wmask),
+    .rdata_o  (sram_rdata),
+    .rvalid_o (sram_rvalid),
+    // No error detection is enabled inside SRAM.
+    // Bus ECC is checked at the consumer side.
+    .rerror_o (),
+    .cfg_i    ('0),
+    .cfg_rsp_o(),
+    .alert_o()
+  );
+
+  ////////////////////////////
+  // SoC Signal Tie-offs    //
+  ////////////////////////////
+
+  soc_proxy_pkg::soc_alert_req_t [soc_proxy_pkg::NumFatalExternalAlerts-1:0] soc_fatal_alert_req;
+  soc_proxy_pkg::soc_alert_req_t [soc_proxy_pkg::NumRecovExternalAlerts-1:0] soc_recov_alert_req;
+  assign soc_fatal_alert_req =
+      {soc_proxy_pkg::NumFatalExternalAlerts{soc_proxy_pkg::SOC_ALERT_REQ_DEFAULT}};
+  assign soc_recov_alert_req =
+      {soc_proxy_pkg::NumRecovExternalAlerts{soc_proxy_pkg::SOC_ALERT_REQ_DEFAULT}};
+
+  // Loop the internal reset request of the power manager back as a stretched external SoC reset
+  // request, as in chip_darjeeling_asic.sv.
+  logic  internal_request_d, internal_request_q;
+  logic  external_reset, count_up;
+  logic  [3:0] count;
+  assign internal_request_d = pwrmgr_boot_status.light_reset_req;
+  always_ff @(posedge clk_aon or negedge por_n[0]) begin
+    if (!por_n[0]) begin
+      external_reset     <= 1'b0;
+      internal_request_q <= 1'b0;
+      count_up           <= '0;
+      count              <= '0;
+    end else begin
+      internal_request_q <= internal_request_d;
+      if (!internal_request_q && internal_request_d) begin
+        count_up       <= 1'b1;
+        external_reset <= 1;
+      end else if (count == 'd8) begin
+        count_up       <= 0;
+        external_reset <= 0;
+        count          <= '0;
+      end else if (count_up) begin
+        count <= count + 1;
+      end
+    end
+  end
+
+  logic unused_signals;
+  assign unused_signals = ^{pwrmgr_boot_status.clk_status,
+                            pwrmgr_boot_status.cpu_fetch_en,
+                            pwrmgr_boot_status.lc_done,
+                            pwrmgr_boot_status.otp_done,
+                            pwrmgr_boot_status.rom_ctrl_status,
+                            pwrmgr_boot_status.strap_sampled,
+                            jtag_rsp.tdo_oe,
+                            ast_base_clks};
+
+  // TODO: check whether the pad indices below should be generated from the
+  // target-specific pinout configuration. These are the same as in
+  // chip_darjeeling_asic.sv.
+  localparam pinmux_pkg::target_cfg_t PinmuxTargetCfg = '{
+    tck_idx:        4,
+    tms_idx:        5,
+    trst_idx:       6,
+    tdi_idx:        7,
+    tdo_idx:        8,
+    tap_strap0_idx: 0,
+    tap_strap1_idx: 1,
+    dft_strap0_idx: 2,
+    dft_strap1_idx: 3,
+    // There is no USB device in Darjeeling.
+    usb_dp_idx:     0,
+    usb_dn_idx:     0,
+    usb_sense_idx:  0,
+    // TODO: connect these once the verilator chip-level has been merged with the chiplevel.sv.tpl
+    dio_pad_type: {pinmux_reg_pkg::NDioPads{prim_pad_wrapper_pkg::BidirStd}},
+    mio_pad_type: {pinmux_reg_pkg::NMioPads{prim_pad_wrapper_pkg::BidirStd}},
+    dio_scan_role: {pinmux_reg_pkg::NDioPads{prim_pad_wrapper_pkg::NoScan}},
+    mio_scan_role: {pinmux_reg_pkg::NMioPads{prim_pad_wrapper_pkg::NoScan}}
+  };
+
+  // Top-level design
+
+  top_darjeeling #(
+    .PinmuxAonTargetCfg(PinmuxTargetCfg),
+    .SecAesAllowForcingMasks(1'b1),
+    .SramCtrlMainInstrExec(1)
+  ) top_darjeeling (
+    // update por / reset connections, this is not quite right here
+    .por_n_i                           ( por_n                      ),
+    .clk_main_i                        ( clk_i                      ),
+    .clk_io_i                          ( clk_i                      ),
+    .clk_usb_i                         ( clk_i                      ),
+    .clk_aon_i                         ( clk_aon                    ),
+    // change the above
+    .clks_ast_o                        ( clkmgr_aon_clocks          ),
+    .clk_main_jitter_en_o              ( jen                        ),
+    .rsts_ast_o                        ( rstmgr_aon_resets          ),
+    .integrator_id_i                   ( '0                         ),
+    .sck_monitor_o                     ( sck_monitor                ),
+    .pwrmgr_ast_req_o                  ( base_ast_pwr               ),
+    .pwrmgr_ast_rsp_i                  ( ast_base_pwr               ),
+    .ast_edn_req_i                     ( ast_edn_edn_req            ),
+    .ast_edn_rsp_o                     ( ast_edn_edn_rsp            ),
+    .ast_tl_req_o                      ( base_ast_bus               ),
+    .ast_tl_rsp_i                      ( ast_base_bus               ),
+    .obs_ctrl_i                        ( obs_ctrl                   ),
+    .otp_ctrl_otp_ast_pwr_seq_o        ( otp_ctrl_otp_ast_pwr_seq   ),
+    .otp_ctrl_otp_ast_pwr_seq_h_i      ( otp_ctrl_otp_ast_pwr_seq_h ),
+    .otp_obs_o                         ( otp_obs                    ),
+    .otp_cfg_i                         ( '0                         ),
+    .otp_cfg_rsp_o                     (                            ),
+    .ctn_tl_h2d_o                      ( ctn_tl_h2d                 ),
+    .ctn_tl_d2h_i                      ( ctn_tl_d2h                 ),
+    .ac_range_check_overwrite_i        ( prim_mubi_pkg::MuBi8True   ),
+    .racl_error_i                      ( '0                         ),
+    .soc_gpi_async_o                   (                            ),
+    .soc_gpo_async_i                   ( '0                         ),
+    .soc_dbg_policy_bus_o              (                            ),
+    .debug_halt_cpu_boot_i             ( '0                         ),
+    .dma_sys_req_o                     (                            ),
+    .dma_sys_rsp_i                     ( '0                         ),
+    .mbx_tl_req_i                      ( tlul_pkg::TL_H2D_DEFAULT   ),
+    .mbx_tl_rsp_o                      (                            ),
+    .pwrmgr_boot_status_o              ( pwrmgr_boot_status         ),
+    .ctn_misc_tl_h2d_i                 ( tlul_pkg::TL_H2D_DEFAULT   ),
+    .ctn_misc_tl_d2h_o                 (                            ),
+    .soc_fatal_alert_req_i             ( soc_fatal_alert_req        ),
+    .soc_fatal_alert_rsp_o             (                            ),
+    .soc_recov_alert_req_i             ( soc_recov_alert_req        ),
+    .soc_recov_alert_rsp_o             (                            ),
+    .soc_intr_async_i                  ( '0                         ),
+    .soc_wkup_async_i                  ( 1'b0                       ),
+    .soc_rst_req_async_i               ( external_reset             ),
+    .soc_lsio_trigger_i                ( '0                         ),
+    .entropy_src_hw_if_req_o           ( entropy_src_hw_if_req      ),
+    .entropy_src_hw_if_rsp_i           ( entropy_src_hw_if_rsp      ),
+    .mbx0_doe_intr_en_o                (                            ),
+    .mbx0_doe_intr_o                   (                            ),
+    .mbx0_doe_intr_support_o           (                            ),
+    .mbx0_doe_async_msg_support_o      (                            ),
+    .mbx1_doe_intr_en_o                (                            ),
+    .mbx1_doe_intr_o                   (                            ),
+    .mbx1_doe_intr_support_o           (                            ),
+    .mbx1_doe_async_msg_support_o      (                            ),
+    .mbx2_doe_intr_en_o                (                            ),
+    .mbx2_doe_intr_o                   (                            ),
+    .mbx2_doe_intr_support_o           (                            ),
+    .mbx2_doe_async_msg_support_o      (                            ),
+    .mbx3_doe_intr_en_o                (                            ),
+    .mbx3_doe_intr_o                   (                            ),
+    .mbx3_doe_intr_support_o           (                            ),
+    .mbx3_doe_async_msg_support_o      (                            ),
+    .mbx4_doe_intr_en_o                (                            ),
+    .mbx4_doe_intr_o                   (                            ),
+    .mbx4_doe_intr_support_o           (                            ),
+    .mbx4_doe_async_msg_support_o      (                            ),
+    .mbx5_doe_intr_en_o                (                            ),
+    .mbx5_doe_intr_o                   (                            ),
+    .mbx5_doe_intr_support_o           (                            ),
+    .mbx5_doe_async_msg_support_o      (                            ),
+    .mbx6_doe_intr_en_o                (                            ),
+    .mbx6_doe_intr_o                   (                            ),
+    .mbx6_doe_intr_support_o           (                            ),
+    .mbx6_doe_async_msg_support_o      (                            ),
+    .mbx_jtag_doe_intr_en_o            (                            ),
+    .mbx_jtag_doe_intr_o               (                            ),
+    .mbx_jtag_doe_intr_support_o       (                            ),
+    .mbx_jtag_doe_async_msg_support_o  (                            ),
+    .mbx_pcie0_doe_intr_en_o           (                            ),
+    .mbx_pcie0_doe_intr_o              (                            ),
+    .mbx_pcie0_doe_intr_support_o      (                            ),
+    .mbx_pcie0_doe_async_msg_support_o (                            ),
+    .mbx_pcie1_doe_intr_en_o           (                            ),
+    .mbx_pcie1_doe_intr_o              (                            ),
+    .mbx_pcie1_doe_intr_support_o      (                            ),
+    .mbx_pcie1_doe_async_msg_support_o (                            ),
+    .io_clk_byp_req_o                  ( io_clk_byp_req             ),
+    .io_clk_byp_ack_i                  ( io_clk_byp_ack             ),
+    .all_clk_byp_req_o                 ( all_clk_byp_req            ),
+    .all_clk_byp_ack_i                 ( all_clk_byp_ack            ),
+    .hi_speed_sel_o                    ( hi_speed_sel               ),
+    .div_step_down_req_i               ( div_step_down_req          ),
+    .calib_rdy_i                       ( ast_init_done              ),
+
+    // OTP external voltage
+    .otp_ext_voltage_h_io              (                            ),
+
+    // DMI TL-UL
+    .dbg_tl_req_i                      ( dmi_h2d                    ),
+    .dbg_tl_rsp_o                      ( dmi_d2h                    ),
+    // Quasi-static word address for next_dm register value.
+    .rv_dm_next_dm_addr_i              ( '0                         ),
+
+    // Multiplexed I/O
+    .mio_in_i                          ( mio_in                     ),
+    .mio_out_o                         ( mio_out                    ),
+    .mio_oe_o                          ( mio_oe                     ),
+
+    // Dedicated I/O
+    .dio_in_i                          ( dio_in                     ),
+    .dio_out_o                         ( dio_out                    ),
+    .dio_oe_o                          ( dio_oe                     ),
+
+    // Pad attributes
+    .mio_attr_o                        ( mio_attr                   ),
+    .dio_attr_o                        ( dio_attr                   ),
+
+    // Memory attributes
+    // This is different between verilator and the rest of the platforms right now
+    .rom_ctrl0_cfg_i                           ( '0 ),
+    .rom_ctrl1_cfg_i                           ( '0 ),
+    .i2c_ram_1p_cfg_i                          ( '0 ),
+    .i2c_ram_1p_cfg_rsp_o                      (    ),
+    .sram_ctrl_ret_aon_ram_1p_cfg_i            ( '0 ),
+    .sram_ctrl_ret_aon_ram_1p_cfg_rsp_o        (    ),
+    .sram_ctrl_main_ram_1p_cfg_i               ( '0 ),
+    .sram_ctrl_main_ram_1p_cfg_rsp_o           (    ),
+    .sram_ctrl_mbox_ram_1p_cfg_i               ( '0 ),
+    .sram_ctrl_mbox_ram_1p_cfg_rsp_o           (    ),
+    .otbn_imem_ram_1p_cfg_i                    ( '0 ),
+    .otbn_imem_ram_1p_cfg_rsp_o                (    ),
+    .otbn_dmem_ram_1p_cfg_i                    ( '0 ),
+    .otbn_dmem_ram_1p_cfg_rsp_o                (    ),
+    .rv_core_ibex_icache_tag_ram_1p_cfg_i      ( '0 ),
+    .rv_core_ibex_icache_tag_ram_1p_cfg_rsp_o  (    ),
+    .rv_core_ibex_icache_data_ram_1p_cfg_i     ( '0 ),
+    .rv_core_ibex_icache_data_ram_1p_cfg_rsp_o (    ),
+    .spi_device_ram_2p_cfg_sys2spi_i           ( '0 ),
+    .spi_device_ram_2p_cfg_spi2sys_i           ( '0 ),
+    .spi_device_ram_2p_cfg_rsp_sys2spi_o       (    ),
+    .spi_device_ram_2p_cfg_rsp_spi2sys_o       (    ),
+
+    // DFT signals
+    .ast_lc_dft_en_o                   ( lc_dft_en                  ),
+    .ast_lc_hw_debug_en_o              (                            ),
+    .scan_rst_ni                       ( scan_rst_n                 ),
+    .scan_en_i                         ( scan_en                    ),
+    .scanmode_i                        ( scanmode                   ),
+
+    // FPGA build info
+    .fpga_info_i                       ( '0                         )
+  );
+
+endmodule : chip_darjeeling_verilator
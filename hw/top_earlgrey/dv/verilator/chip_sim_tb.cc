@@ -2,18 +2,35 @@
 // Licensed under the Apache License, Version 2.0, see LICENSE for details.
 // SPDX-License-Identifier: Apache-2.0
 
-#include <algorithm>
 #include <iostream>
 #include <string>
-#include <vector>
 
+#include "elf_symbol_memutil.h"
+#include "fixed_width_mem_area.h"
 #include "verilated_toplevel.h"
 #include "verilator_memutil.h"
+#include "verilator_pc_profile.h"
 #include "verilator_sim_ctrl.h"
 
+#ifdef DPI_SHLIB
+#include "dpi_shlib.h"
+#endif
+
 int main(int argc, char **argv) {
+#ifdef DPI_SHLIB
+  // The DPI modules are in a separate library, which must be loaded before
+  // the initial blocks of the model call into them.
+  if (!DpiShlibLoadFromArgs(argc, argv)) {
+    return 1;
+  }
+#endif
+
   chip_sim_tb top;
-  VerilatorMemUtil memutil;
+  // The memory utilities keep the symbols of loaded ELF files for the PC
+  // profile.
+  ElfSymbolMemUtil elf_symbols;
+  VerilatorMemUtil memutil(&elf_symbols);
+  VerilatorPcProfile pc_profile(&elf_symbols);
   VerilatorSimCtrl &simctrl = VerilatorSimCtrl::GetInstance();
   simctrl.SetTop(&top, &top.clk_i, &top.rst_ni,
                  VerilatorSimCtrlFlags::ResetPolarityNegative);
@@ -23,33 +40,33 @@ int main(int argc, char **argv) {
       "u_prim_ram_1p_adv.gen_ram_inst[0].u_mem."
       "gen_generic.u_impl_generic");
 
-  MemArea rom(top_scope + (".u_rom_ctrl.gen_rom_scramble_enabled.u_rom.u_rom."
-                           "u_prim_rom.gen_generic.u_impl_generic"),
-              0x4000 / 4, 4);
-  MemArea ram(top_scope + ".u_ram1p_ram_main." + ram1p_adv_scope, 0x20000 / 4,
-              4);
+  FixedWidthMemArea<32> rom(
+      top_scope + (".u_rom_ctrl.gen_rom_scramble_enabled.u_rom.u_rom."
+                   "u_prim_rom.gen_generic.u_impl_generic"),
+      0x4000 / 4);
+  FixedWidthMemArea<32> ram(
+      top_scope + ".u_ram1p_ram_main." + ram1p_adv_scope, 0x20000 / 4);
   // Only handle the lower bank of flash for now.
-  MemArea flash0(
+  FixedWidthMemArea<64> flash0(
       top_scope +
           ".u_flash_ctrl.u_eflash.u_flash.gen_generic.u_impl_generic."
           "gen_prim_flash_banks[0].u_prim_flash_bank.u_mem."
           "gen_generic.u_impl_generic",
-      0x80000 / 8, 8);
-  MemArea flash1(
+      0x80000 / 8);
+  FixedWidthMemArea<64> flash1(
       top_scope +
           ".u_flash_ctrl.u_eflash.u_flash.gen_generic.u_impl_generic."
           "gen_prim_flash_banks[1].u_prim_flash_bank.u_mem."
           "gen_generic.u_impl_generic",
-      0x80000 / 8, 8);
+      0x80000 / 8);
   // Start with the flash region erased. Future loads can overwrite.
-  std::vector<uint8_t> all_ones(flash0.GetSizeBytes());
-  std::fill(all_ones.begin(), all_ones.end(), 0xffu);
-  flash0.Write(/*word_offset=*/0, all_ones);
-  flash1.Write(/*word_offset=*/0, all_ones);
+  flash0.Fill(/*word_offset=*/0, flash0.GetSizeWords(), 0xffu);
+  flash1.Fill(/*word_offset=*/0, flash1.GetSizeWords(), 0xffu);
 
-  MemArea otp(top_scope + ".u_otp_ctrl.u_otp.gen_generic.u_impl_generic." +
-                  ram1p_adv_scope,
-              0x4000 / 4, 4);
+  FixedWidthMemArea<32> otp(
+      top_scope + ".u_otp_ctrl.u_otp.gen_generic.u_impl_generic." +
+          ram1p_adv_scope,
+      0x4000 / 4);
 
   memutil.RegisterMemoryArea("rom", 0x8000, &rom);
   memutil.RegisterMemoryArea("ram", 0x10000000u, &ram);
@@ -57,6 +74,7 @@ int main(int argc, char **argv) {
   memutil.RegisterMemoryArea("flash1", 0x20080000u, &flash1);
   memutil.RegisterMemoryArea("otp", 0x40000000u /* (bogus LMA) */, &otp);
   simctrl.RegisterExtension(&memutil);
+  simctrl.RegisterExtension(&pc_profile);
 
   // The initial reset delay must be long enough such that pwr/rst/clkmgr will
   // release clocks to the entire design.  This allows for synchronous resets
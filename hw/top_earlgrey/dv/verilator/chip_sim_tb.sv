@@ -26,6 +26,10 @@ module chip_sim_tb (
   logic cio_usbdev_dp_p2d, cio_usbdev_dp_d2p, cio_usbdev_dp_en_d2p;
   logic cio_usbdev_dn_p2d, cio_usbdev_dn_d2p, cio_usbdev_dn_en_d2p;
 
+  logic cio_i2c_sda_d2p, cio_i2c_sda_en_d2p;
+  logic cio_i2c_scl_d2p, cio_i2c_scl_en_d2p;
+  logic i2c_sda, i2c_scl, i2cdpi_sda, i2cdpi_scl;
+
   chip_earlgrey_verilator u_dut (
     .clk_i,
     .rst_ni,
@@ -63,7 +67,15 @@ module chip_sim_tb (
     .cio_usbdev_d_en_d2p_o(cio_usbdev_d_en_d2p),
     .cio_usbdev_se0_d2p_o(cio_usbdev_se0_d2p),
     .cio_usbdev_rx_enable_d2p_o(cio_usbdev_rx_enable_d2p),
-    .cio_usbdev_tx_use_d_se0_d2p_o(cio_usbdev_tx_use_d_se0_d2p)
+    .cio_usbdev_tx_use_d_se0_d2p_o(cio_usbdev_tx_use_d_se0_d2p),
+
+    // communication with I2C
+    .cio_i2c_sda_p2d_i(i2c_sda),
+    .cio_i2c_sda_d2p_o(cio_i2c_sda_d2p),
+    .cio_i2c_sda_en_d2p_o(cio_i2c_sda_en_d2p),
+    .cio_i2c_scl_p2d_i(i2c_scl),
+    .cio_i2c_scl_d2p_o(cio_i2c_scl_d2p),
+    .cio_i2c_scl_en_d2p_o(cio_i2c_scl_en_d2p)
   );
 
   // GPIO DPI
@@ -163,6 +175,22 @@ module chip_sim_tb (
     .tx_use_d_se0_d2p(cio_usbdev_tx_use_d_se0_d2p)
   );
 
+  // I2C DPI
+  // The bus is open drain with a pull-up: a line is low whenever the chip or the DPI model pulls
+  // it low.
+  assign i2c_sda = ~(cio_i2c_sda_en_d2p & ~cio_i2c_sda_d2p) & i2cdpi_sda;
+  assign i2c_scl = ~(cio_i2c_scl_en_d2p & ~cio_i2c_scl_d2p) & i2cdpi_scl;
+
+  i2cdpi u_i2cdpi (
+    .clk_i  (clk_i),
+    .rst_ni (rst_ni),
+    .active (1'b1),
+    .scl_i  (i2c_scl),
+    .sda_i  (i2c_sda),
+    .scl_o  (i2cdpi_scl),
+    .sda_o  (i2cdpi_sda)
+  );
+
   `define RV_CORE_IBEX      u_dut.top_earlgrey.u_rv_core_ibex
   `define SIM_SRAM_IF       u_sim_sram.u_sim_sram_if
 
@@ -208,6 +236,38 @@ module chip_sim_tb (
     end
   end
 
+`ifdef RVFI
+  // Per-PC instruction profile (see --pc-profile in verilator_pc_profile.h). Each instruction
+  // retired by the core is reported with the core clock cycles since the previous one retired.
+  import "DPI-C" function bit pc_profile_enabled();
+  import "DPI-C" function void pc_profile_retire(input int pc,
+                                                 input int next_pc,
+                                                 input int insn,
+                                                 input bit intr,
+                                                 input int cycles);
+
+  bit pc_profile_on;
+  int pc_profile_cycles;
+
+  // This runs on the first evaluation of the model, after the command line has been parsed.
+  initial pc_profile_on = pc_profile_enabled();
+
+  always @(posedge `RV_CORE_IBEX.clk_i or negedge `RV_CORE_IBEX.rst_ni) begin
+    if (!`RV_CORE_IBEX.rst_ni) begin
+      pc_profile_cycles <= 0;
+    end else if (pc_profile_on) begin
+      if (`RV_CORE_IBEX.rvfi_valid) begin
+        pc_profile_retire(`RV_CORE_IBEX.rvfi_pc_rdata, `RV_CORE_IBEX.rvfi_pc_wdata,
+                          `RV_CORE_IBEX.rvfi_insn, `RV_CORE_IBEX.rvfi_intr,
+                          pc_profile_cycles + 1);
+        pc_profile_cycles <= 0;
+      end else begin
+        pc_profile_cycles <= pc_profile_cycles + 1;
+      end
+    end
+  end
+`endif
+
   `undef RV_CORE_IBEX
   `undef SIM_SRAM_IF
 
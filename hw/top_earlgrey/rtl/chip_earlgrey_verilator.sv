@@ -41,7 +41,15 @@ module chip_earlgrey_verilator (
   output logic cio_usbdev_d_en_d2p_o,
   output logic cio_usbdev_se0_d2p_o,
   output logic cio_usbdev_rx_enable_d2p_o,
-  output logic cio_usbdev_tx_use_d_se0_d2p_o
+  output logic cio_usbdev_tx_use_d_se0_d2p_o,
+
+  // communication with I2C
+  input cio_i2c_sda_p2d_i,
+  output logic cio_i2c_sda_d2p_o,
+  output logic cio_i2c_sda_en_d2p_o,
+  input cio_i2c_scl_p2d_i,
+  output logic cio_i2c_scl_d2p_o,
+  output logic cio_i2c_scl_en_d2p_o
 );
 
   import top_earlgrey_pkg::*;
@@ -108,6 +116,9 @@ module chip_earlgrey_verilator (
     mio_in[MioPadIoc3] = cio_uart_rx_p2d_i;
     // USB VBUS sense
     mio_in[MioPadIoc7] = cio_usbdev_sense_p2d_i;
+    // I2C, on the pads that the I2C test utilities select for I2C0
+    mio_in[MioPadIoa7] = cio_i2c_sda_p2d_i;
+    mio_in[MioPadIoa8] = cio_i2c_scl_p2d_i;
   end
 
 
@@ -136,6 +147,11 @@ module chip_earlgrey_verilator (
   assign cio_uart_tx_d2p_o    = mio_out[MioPadIoc4];
   assign cio_uart_tx_en_d2p_o = mio_oe[MioPadIoc4];
 
+  assign cio_i2c_sda_d2p_o    = mio_out[MioPadIoa7];
+  assign cio_i2c_sda_en_d2p_o = mio_oe[MioPadIoa7];
+  assign cio_i2c_scl_d2p_o    = mio_out[MioPadIoa8];
+  assign cio_i2c_scl_en_d2p_o = mio_oe[MioPadIoa8];
+
   // Note: we're collecting the `pull_en` and `pull_select` signals together
   // so that the GPIO DPI functions can simulate weak and strong GPIO
   // inputs.  The `cio_gpio_pull_en_o` and `cio_gpio_pull_select_o` bit
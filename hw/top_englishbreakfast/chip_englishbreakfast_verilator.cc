@@ -4,6 +4,7 @@
 
 #include <iostream>
 
+#include "fixed_width_mem_area.h"
 #include "verilated_toplevel.h"
 #include "verilator_memutil.h"
 #include "verilator_sim_ctrl.h"
@@ -22,18 +23,18 @@ int main(int argc, char **argv) {
       "u_prim_ram_1p_adv.u_mem."
       "gen_generic.u_impl_generic");
 
-  MemArea rom(top_scope +
-                  ".u_rom_ctrl.gen_rom_scramble_disabled.u_rom."
-                  "u_prim_rom.gen_generic.u_impl_generic",
-              0x4000 / 4, 4);
-  MemArea ram(top_scope + ".u_ram1p_ram_main." + ram1p_adv_scope, 0x20000 / 4,
-              4);
-  MemArea flash0(
+  FixedWidthMemArea<32> rom(top_scope +
+                                ".u_rom_ctrl.gen_rom_scramble_disabled.u_rom."
+                                "u_prim_rom.gen_generic.u_impl_generic",
+                            0x4000 / 4);
+  FixedWidthMemArea<32> ram(
+      top_scope + ".u_ram1p_ram_main." + ram1p_adv_scope, 0x20000 / 4);
+  FixedWidthMemArea<64> flash0(
       top_scope +
           ".u_flash_ctrl.u_eflash.u_flash.gen_generic.u_impl_generic."
           "gen_prim_flash_banks[0].u_prim_flash_bank.u_mem."
           "gen_generic.u_impl_generic",
-      0x100000 / 8, 8);
+      0x100000 / 8);
 
   memutil.RegisterMemoryArea("rom", 0x8000, &rom);
   memutil.RegisterMemoryArea("ram", 0x10000000u, &ram);
@@ -156,3 +156,43 @@ ld_library = rule(
     },
     toolchains = ["@rules_cc//cc:toolchain_type"],
 )
+
+def hot_text_library(name, srcs, coverage = None, limit = None, **kwargs):
+    """Generate a hot text linker script library.
+
+    The device linker scripts include `hot_text.ld` at the start of `.text`,
+    from the library selected with `--//sw/device:hot_text=<label>`. This
+    macro generates that fragment with //util:hot_text_ld, placing the listed
+    functions first and in order, so that hot paths share icache lines and
+    flash prefetch buffers.
+
+    Args:
+      name: The name of the ld_library.
+      srcs: Hot function lists (one name per line) or folded stack profiles
+            (e.g. from the Verilator simulation's `--pc-profile`).
+      coverage: Percentage of the profiled cost to cover (default 90).
+      limit: Maximum number of functions to place.
+      **kwargs: Passed to the ld_library.
+    """
+    args = []
+    if coverage != None:
+        args.append("--coverage={}".format(coverage))
+    if limit != None:
+        args.append("--limit={}".format(limit))
+
+    # Each library gets its own directory, which ld_library adds to the
+    # linker search path.
+    out = "{}/hot_text.ld".format(name)
+    native.genrule(
+        name = "{}_gen".format(name),
+        srcs = srcs,
+        outs = [out],
+        cmd = "$(location //util:hot_text_ld) {} -o $@ $(SRCS)".format(" ".join(args)),
+        tools = ["//util:hot_text_ld"],
+        visibility = ["//visibility:private"],
+    )
+    ld_library(
+        name = name,
+        includes = [out],
+        **kwargs
+    )
@@ -13,6 +13,16 @@
 #include "sw/device/lib/testing/test_framework/ottf_main.h"
 #include "sw/device/lib/testing/test_framework/ottf_test_config.h"
 
+// The backend is chosen when `crc32.c` is compiled; the perftest variants in
+// the BUILD file pass the same define to this file so that it can be reported.
+#if defined(CRC32_BACKEND_CLMUL)
+static const char kBackend[] = "clmul";
+#elif defined(CRC32_BACKEND_TABLE)
+static const char kBackend[] = "table";
+#else
+static const char kBackend[] = "default";
+#endif
+
 OTTF_DEFINE_TEST_CONFIG();
 
 bool test_main(void) {
@@ -30,7 +40,13 @@ bool test_main(void) {
 
     CHECK(num_cycles <= UINT32_MAX);
     const uint32_t num_cycles_u32 = (uint32_t)num_cycles;
-    LOG_INFO("CRC32 computed in %d cycles.", num_cycles_u32);
+    // Report cycles/byte with two decimal places, as `base_printf()` cannot
+    // print floating-point values.
+    CHECK(num_cycles_u32 <= UINT32_MAX / 100);
+    const uint32_t centicycles_per_byte = num_cycles_u32 * 100 / sizeof(buf);
+    LOG_INFO("CRC32 (%s) computed in %d cycles, %d.%02d cycles/byte.",
+             kBackend, num_cycles_u32, centicycles_per_byte / 100,
+             centicycles_per_byte % 100);
 
     const uint32_t kExpectedChecksum = 0xa2912082;
     if (checksum != kExpectedChecksum) {
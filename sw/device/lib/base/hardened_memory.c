@@ -112,8 +112,15 @@ void hardened_memshred(uint32_t *dest, size_t word_len) {
   HARDENED_CHECK_EQ(count, expected_count);
 }
 
-hardened_bool_t hardened_memeq(const uint32_t *lhs, const uint32_t *rhs,
-                               size_t word_len) {
+void hardened_memeq_stream_init(hardened_memeq_stream_t *ctx) {
+  ctx->zeros = 0;
+  ctx->ones = UINT32_MAX;
+  ctx->word_len = 0;
+}
+
+void hardened_memeq_stream_update(hardened_memeq_stream_t *ctx,
+                                  const uint32_t *lhs, const uint32_t *rhs,
+                                  size_t word_len) {
   random_order_t order;
   random_order_init(&order, word_len);
 
@@ -132,8 +139,8 @@ hardened_bool_t hardened_memeq(const uint32_t *lhs, const uint32_t *rhs,
   };
   uintptr_t decoy_addr = (uintptr_t)&decoys;
 
-  uint32_t zeros = 0;
-  uint32_t ones = UINT32_MAX;
+  uint32_t zeros = ctx->zeros;
+  uint32_t ones = ctx->ones;
 
   // The loop is almost token-for-token the one above, but the copy is
   // replaced with something else.
@@ -168,6 +175,195 @@ hardened_bool_t hardened_memeq(const uint32_t *lhs, const uint32_t *rhs,
     ones = launder32(ones) & (launder32(a) ^ ~b);
   }
 
+  HARDENED_CHECK_EQ(count, expected_count);
+  ctx->zeros = zeros;
+  ctx->ones = ones;
+  ctx->word_len += word_len;
+}
+
+hardened_bool_t hardened_memeq_stream_final(const hardened_memeq_stream_t *ctx,
+                                            size_t expected_word_len) {
+  // A chunk that was skipped, e.g. by a fault on the caller's loop, must not
+  // let the comparison succeed.
+  if (launderw(ctx->word_len) != expected_word_len) {
+    return kHardenedBoolFalse;
+  }
+
+  if (launder32(ctx->zeros) == 0) {
+    HARDENED_CHECK_EQ(ctx->ones, UINT32_MAX);
+    HARDENED_CHECK_EQ(ctx->word_len, expected_word_len);
+    return kHardenedBoolTrue;
+  }
+
+  HARDENED_CHECK_NE(ctx->ones, UINT32_MAX);
+  return kHardenedBoolFalse;
+}
+
+hardened_bool_t hardened_memeq(const uint32_t *lhs, const uint32_t *rhs,
+                               size_t word_len) {
+  hardened_memeq_stream_t ctx;
+  hardened_memeq_stream_init(&ctx);
+  hardened_memeq_stream_update(&ctx, lhs, rhs, word_len);
+  return hardened_memeq_stream_final(&ctx, word_len);
+}
+
+// NOTE: The `_wide` variants below mirror the functions above, but each index
+// produced by the random order covers a pair of adjacent words. Only the parts
+// that differ from `hardened_memcpy()` are commented.
+enum {
+  // Number of bytes covered by one step of a `_wide` loop.
+  kWideStepBytes = 2 * sizeof(uint32_t),
+};
+
+void hardened_memcpy_wide(uint32_t *restrict dest, const uint32_t *restrict src,
+                          size_t word_len) {
+  // Walk over pairs of words; a trailing odd word is covered by a final pair
+  // whose second half is redirected to the decoys.
+  random_order_t order;
+  random_order_init(&order, (word_len + 1) / 2);
+
+  size_t count = 0;
+  size_t expected_count = random_order_len(&order);
+
+  uintptr_t src_addr = (uintptr_t)src;
+  uintptr_t dest_addr = (uintptr_t)dest;
+
+  uint32_t decoys[8];
+  uintptr_t decoy_addr = (uintptr_t)&decoys;
+
+  size_t byte_len = word_len * sizeof(uint32_t);
+  for (; launderw(count) < expected_count; count = launderw(count) + 1) {
+    // A single laundered index and barrier serve both words of the pair.
+    size_t byte_idx = launderw(random_order_advance(&order)) * kWideStepBytes;
+    barrierw(byte_idx);
+    size_t byte_idx0 = launderw(byte_idx);
+    size_t byte_idx1 = byte_idx0 + sizeof(uint32_t);
+
+    uintptr_t decoy1 = decoy_addr + (byte_idx0 % sizeof(decoys));
+    uintptr_t decoy2 =
+        decoy_addr + ((byte_idx0 + sizeof(decoys) / 2) % sizeof(decoys));
+    ct_boolw_t in0 = ct_sltuw(byte_idx0, byte_len);
+    ct_boolw_t in1 = ct_sltuw(byte_idx1, byte_len);
+
+    void *src0 = (void *)launderw(ct_cmovw(in0, src_addr + byte_idx0, decoy1));
+    void *src1 = (void *)launderw(
+        ct_cmovw(in1, src_addr + byte_idx1, decoy1 + sizeof(uint32_t)));
+    void *dest0 =
+        (void *)launderw(ct_cmovw(in0, dest_addr + byte_idx0, decoy2));
+    void *dest1 = (void *)launderw(
+        ct_cmovw(in1, dest_addr + byte_idx1, decoy2 + sizeof(uint32_t)));
+
+    // Issue both loads before both stores so that the second load does not
+    // wait on the first store.
+    uint32_t word0 = read_32(src0);
+    uint32_t word1 = read_32(src1);
+    write_32(word0, dest0);
+    write_32(word1, dest1);
+  }
+
+  HARDENED_CHECK_EQ(count, expected_count);
+}
+
+void hardened_memshred_wide(uint32_t *dest, size_t word_len) {
+  random_order_t order;
+  random_order_init(&order, (word_len + 1) / 2);
+
+  size_t count = 0;
+  size_t expected_count = random_order_len(&order);
+
+  uintptr_t data_addr = (uintptr_t)dest;
+
+  uint32_t decoys[8];
+  uintptr_t decoy_addr = (uintptr_t)&decoys;
+
+  size_t byte_len = word_len * sizeof(uint32_t);
+  for (; count < expected_count; count = launderw(count) + 1) {
+    size_t byte_idx = launderw(random_order_advance(&order)) * kWideStepBytes;
+    barrierw(byte_idx);
+    size_t byte_idx0 = launderw(byte_idx);
+    size_t byte_idx1 = byte_idx0 + sizeof(uint32_t);
+
+    uintptr_t decoy = decoy_addr + (byte_idx0 % sizeof(decoys));
+
+    void *data0 = (void *)launderw(
+        ct_cmovw(ct_sltuw(byte_idx0, byte_len), data_addr + byte_idx0, decoy));
+    void *data1 = (void *)launderw(ct_cmovw(ct_sltuw(byte_idx1, byte_len),
+                                            data_addr + byte_idx1,
+                                            decoy + sizeof(uint32_t)));
+
+    write_32(hardened_memshred_random_word(), data0);
+    write_32(hardened_memshred_random_word(), data1);
+  }
+
+  HARDENED_CHECK_EQ(count, expected_count);
+}
+
+/**
+ * Computes `a ^ ~b` without letting the compiler see the operation.
+ *
+ * With Zbb this is a single `xnor` whose inline asm also acts as the
+ * laundering barrier; otherwise `a` is laundered as in `hardened_memeq()`.
+ */
+static inline uint32_t opaque_xnor32(uint32_t a, uint32_t b) {
+#if defined(OT_PLATFORM_RV32) && defined(__riscv_zbb)
+  uint32_t result;
+  asm volatile("xnor %0, %1, %2" : "=r"(result) : "r"(a), "r"(b));
+  return result;
+#else
+  return launder32(a) ^ ~b;
+#endif
+}
+
+hardened_bool_t hardened_memeq_wide(const uint32_t *lhs, const uint32_t *rhs,
+                                    size_t word_len) {
+  random_order_t order;
+  random_order_init(&order, (word_len + 1) / 2);
+
+  size_t count = 0;
+  size_t expected_count = random_order_len(&order);
+
+  uintptr_t lhs_addr = (uintptr_t)lhs;
+  uintptr_t rhs_addr = (uintptr_t)rhs;
+
+  uint32_t decoys[8] = {
+      0xaaaaaaaa, 0xaaaaaaaa, 0xaaaaaaaa, 0xaaaaaaaa,
+      0xaaaaaaaa, 0xaaaaaaaa, 0xaaaaaaaa, 0xaaaaaaaa,
+  };
+  uintptr_t decoy_addr = (uintptr_t)&decoys;
+
+  uint32_t zeros = 0;
+  uint32_t ones = UINT32_MAX;
+
+  size_t byte_len = word_len * sizeof(uint32_t);
+  for (; count < expected_count; count = launderw(count) + 1) {
+    size_t byte_idx = launderw(random_order_advance(&order)) * kWideStepBytes;
+    barrierw(byte_idx);
+    size_t byte_idx0 = launderw(byte_idx);
+    size_t byte_idx1 = byte_idx0 + sizeof(uint32_t);
+
+    uintptr_t decoy1 = decoy_addr + (byte_idx0 % sizeof(decoys));
+    uintptr_t decoy2 =
+        decoy_addr + ((byte_idx0 + sizeof(decoys) / 2) % sizeof(decoys));
+    ct_boolw_t in0 = ct_sltuw(byte_idx0, byte_len);
+    ct_boolw_t in1 = ct_sltuw(byte_idx1, byte_len);
+
+    void *a0v = (void *)launderw(ct_cmovw(in0, lhs_addr + byte_idx0, decoy1));
+    void *a1v = (void *)launderw(
+        ct_cmovw(in1, lhs_addr + byte_idx1, decoy1 + sizeof(uint32_t)));
+    void *b0v = (void *)launderw(ct_cmovw(in0, rhs_addr + byte_idx0, decoy2));
+    void *b1v = (void *)launderw(
+        ct_cmovw(in1, rhs_addr + byte_idx1, decoy2 + sizeof(uint32_t)));
+
+    uint32_t a0 = read_32(a0v);
+    uint32_t a1 = read_32(a1v);
+    uint32_t b0 = read_32(b0v);
+    uint32_t b1 = read_32(b1v);
+
+    // Fold both words into the accumulators with one launder each.
+    zeros = launder32(zeros) | (launder32(a0) ^ b0) | (launder32(a1) ^ b1);
+    ones = launder32(ones) & opaque_xnor32(a0, b0) & opaque_xnor32(a1, b1);
+  }
+
   HARDENED_CHECK_EQ(count, expected_count);
   if (launder32(zeros) == 0) {
     HARDENED_CHECK_EQ(ones, UINT32_MAX);
@@ -83,6 +83,108 @@ void hardened_memshred(uint32_t *dest, size_t word_len);
 hardened_bool_t hardened_memeq(const uint32_t *lhs, const uint32_t *rhs,
                                size_t word_len);
 
+/**
+ * Copies 32-bit words between non-overlapping regions, two words at a time.
+ *
+ * This has the same contract as `hardened_memcpy()` and walks the buffers in
+ * the same randomized order with decoy accesses, but each step of the order
+ * covers a pair of adjacent words. This halves the number of laundering
+ * barriers and index computations per word, which matters for large buffers
+ * such as RSA key shares.
+ *
+ * @param dest The destination of the copy.
+ * @param src The source of the copy.
+ * @param word_len The number of words to copy.
+ */
+void hardened_memcpy_wide(uint32_t *OT_RESTRICT dest,
+                          const uint32_t *OT_RESTRICT src, size_t word_len);
+
+/**
+ * Fills a 32-bit aligned region of memory with random data, two words at a
+ * time.
+ *
+ * This has the same contract as `hardened_memshred()`; see
+ * `hardened_memcpy_wide()` for how it differs.
+ *
+ * @param dest The destination of the set.
+ * @param word_len The number of words to write.
+ */
+void hardened_memshred_wide(uint32_t *dest, size_t word_len);
+
+/**
+ * Compare two potentially-overlapping 32-bit aligned regions of memory for
+ * equality, two words at a time.
+ *
+ * This has the same contract as `hardened_memeq()`; see
+ * `hardened_memcpy_wide()` for how it differs. On targets with the Zbb
+ * extension, the per-word accumulation uses `xnor` directly.
+ *
+ * @param lhs The first buffer to compare.
+ * @param rhs The second buffer to compare.
+ * @param word_len The number of words to compare.
+ * @return Whether the buffers are equal.
+ */
+hardened_bool_t hardened_memeq_wide(const uint32_t *lhs, const uint32_t *rhs,
+                                    size_t word_len);
+
+/**
+ * State of a streaming hardened comparison.
+ *
+ * This allows comparing two long buffers chunk by chunk as they are produced,
+ * e.g. while reading a result out of a peripheral, without first staging
+ * either of them in RAM. The fields are private to the implementation.
+ */
+typedef struct hardened_memeq_stream {
+  /**
+   * OR of the XOR of every pair of compared words.
+   */
+  uint32_t zeros;
+  /**
+   * AND of the XNOR of every pair of compared words.
+   */
+  uint32_t ones;
+  /**
+   * Total number of words compared so far.
+   */
+  size_t word_len;
+} hardened_memeq_stream_t;
+
+/**
+ * Starts a streaming hardened comparison.
+ *
+ * @param ctx The comparison state to initialize.
+ */
+void hardened_memeq_stream_init(hardened_memeq_stream_t *ctx);
+
+/**
+ * Compares the next chunk of a streaming hardened comparison.
+ *
+ * Each chunk is compared with the same hardening measures as
+ * `hardened_memeq()`. The pointer requirements are also the same.
+ *
+ * @param ctx The comparison state.
+ * @param lhs The next chunk of the first buffer.
+ * @param rhs The next chunk of the second buffer.
+ * @param word_len The number of words in this chunk.
+ */
+void hardened_memeq_stream_update(hardened_memeq_stream_t *ctx,
+                                  const uint32_t *lhs, const uint32_t *rhs,
+                                  size_t word_len);
+
+/**
+ * Finishes a streaming hardened comparison.
+ *
+ * The buffers are reported equal only if every chunk compared equal and
+ * exactly `expected_word_len` words were compared in total, so skipping a
+ * chunk (e.g. by a fault) cannot make the buffers compare equal.
+ *
+ * @param ctx The comparison state.
+ * @param expected_word_len The total number of words of both buffers.
+ * @return Whether the buffers are equal.
+ */
+hardened_bool_t hardened_memeq_stream_final(const hardened_memeq_stream_t *ctx,
+                                            size_t expected_word_len);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -0,0 +1,122 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "sw/device/lib/base/hardened_memory.h"
+#include "sw/device/lib/base/macros.h"
+#include "sw/device/lib/base/memory.h"
+#include "sw/device/lib/runtime/ibex.h"
+#include "sw/device/lib/runtime/log.h"
+#include "sw/device/lib/testing/test_framework/check.h"
+#include "sw/device/lib/testing/test_framework/ottf_main.h"
+
+enum {
+  // One share of an RSA-4096 private exponent.
+  kBufWords = 4096 / 32,
+  kNumRuns = 10,
+};
+
+typedef struct perf_test {
+  // A human-readable name for this particular test, e.g. "hardened_memcpy".
+  const char *label;
+
+  // The function under test. Its runtime will be measured.
+  void (*func)(uint32_t *buf1, uint32_t *buf2, size_t word_len);
+} perf_test_t;
+
+// Cost of the unhardened baseline, reported for comparison.
+OT_NOINLINE void test_memcpy(uint32_t *buf1, uint32_t *buf2, size_t len) {
+  memcpy(buf1, buf2, len * sizeof(uint32_t));
+}
+
+OT_NOINLINE void test_hardened_memcpy(uint32_t *buf1, uint32_t *buf2,
+                                      size_t len) {
+  hardened_memcpy(buf1, buf2, len);
+}
+
+OT_NOINLINE void test_hardened_memcpy_wide(uint32_t *buf1, uint32_t *buf2,
+                                           size_t len) {
+  hardened_memcpy_wide(buf1, buf2, len);
+}
+
+OT_NOINLINE void test_hardened_memshred(uint32_t *buf1, uint32_t *buf2,
+                                        size_t len) {
+  hardened_memshred(buf1, len);
+}
+
+OT_NOINLINE void test_hardened_memshred_wide(uint32_t *buf1, uint32_t *buf2,
+                                             size_t len) {
+  hardened_memshred_wide(buf1, len);
+}
+
+OT_NOINLINE void test_hardened_memeq(uint32_t *buf1, uint32_t *buf2,
+                                     size_t len) {
+  CHECK(hardened_memeq(buf1, buf2, len) == kHardenedBoolTrue);
+}
+
+OT_NOINLINE void test_hardened_memeq_wide(uint32_t *buf1, uint32_t *buf2,
+                                          size_t len) {
+  CHECK(hardened_memeq_wide(buf1, buf2, len) == kHardenedBoolTrue);
+}
+
+static const perf_test_t kPerfTests[] = {
+    {.label = "memcpy", .func = &test_memcpy},
+    {.label = "hardened_memcpy", .func = &test_hardened_memcpy},
+    {.label = "hardened_memcpy_wide", .func = &test_hardened_memcpy_wide},
+    {.label = "hardened_memshred", .func = &test_hardened_memshred},
+    {.label = "hardened_memshred_wide", .func = &test_hardened_memshred_wide},
+    {.label = "hardened_memeq", .func = &test_hardened_memeq},
+    {.label = "hardened_memeq_wide", .func = &test_hardened_memeq_wide},
+};
+
+static uint32_t buf1[kBufWords];
+static uint32_t buf2[kBufWords];
+
+// Run the given `perf_test_t` and return the number of cycles it took.
+static uint64_t perf_test_run(const perf_test_t *test) {
+  uint64_t total_clock_cycles = 0;
+  for (size_t i = 0; i < kNumRuns; ++i) {
+    // Equal buffers, so that the `memeq` tests do the full comparison.
+    for (size_t j = 0; j < kBufWords; ++j) {
+      buf1[j] = buf2[j] = 0x9e3779b9 * (j + 1);
+    }
+
+    uint64_t start_cycles = ibex_mcycle_read();
+    test->func(buf1, buf2, kBufWords);
+    uint64_t end_cycles = ibex_mcycle_read();
+    total_clock_cycles += end_cycles - start_cycles;
+  }
+  return total_clock_cycles;
+}
+
+OTTF_DEFINE_TEST_CONFIG();
+
+// Reports the cycle count of each hardened memory function on a buffer the
+// size of an RSA-4096 key share, next to plain `memcpy()`. The test fails
+// only if a `_wide` variant is slower than the function it replaces.
+bool test_main(void) {
+  uint64_t num_cycles[ARRAYSIZE(kPerfTests)];
+  for (size_t i = 0; i < ARRAYSIZE(kPerfTests); ++i) {
+    num_cycles[i] = perf_test_run(&kPerfTests[i]);
+    // Cast cycle counts to `uint32_t` before printing because `base_printf()`
+    // cannot print `uint64_t`.
+    CHECK(num_cycles[i] < UINT32_MAX);
+    LOG_INFO("%s: %d cycles per %d words", kPerfTests[i].label,
+             (uint32_t)(num_cycles[i] / kNumRuns), kBufWords);
+  }
+
+  // Each `_wide` test directly follows the test of its baseline.
+  bool all_expectations_match = true;
+  for (size_t i = 2; i < ARRAYSIZE(kPerfTests); i += 2) {
+    if (num_cycles[i] > num_cycles[i - 1]) {
+      LOG_WARNING("%s is slower than %s", kPerfTests[i].label,
+                  kPerfTests[i - 1].label);
+      all_expectations_match = false;
+    }
+  }
+  return all_expectations_match;
+}
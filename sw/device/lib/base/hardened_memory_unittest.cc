@@ -53,5 +53,66 @@ TEST(HardenedMemory, MemEq) {
             kHardenedBoolFalse);
 }
 
+TEST(HardenedMemory, MemEqStream) {
+  std::vector<uint32_t> xs = {1, 2, 3, 4, 5, 6, 7, 8};
+  std::vector<uint32_t> ys = xs;
+
+  hardened_memeq_stream_t ctx;
+  hardened_memeq_stream_init(&ctx);
+  hardened_memeq_stream_update(&ctx, ys.data(), xs.data(), 3);
+  hardened_memeq_stream_update(&ctx, ys.data() + 3, xs.data() + 3, 5);
+  EXPECT_EQ(hardened_memeq_stream_final(&ctx, xs.size()), kHardenedBoolTrue);
+
+  // Comparing fewer words than expected must fail.
+  hardened_memeq_stream_init(&ctx);
+  hardened_memeq_stream_update(&ctx, ys.data(), xs.data(), 3);
+  EXPECT_EQ(hardened_memeq_stream_final(&ctx, xs.size()), kHardenedBoolFalse);
+
+  ++ys[5];
+  hardened_memeq_stream_init(&ctx);
+  hardened_memeq_stream_update(&ctx, ys.data(), xs.data(), 3);
+  hardened_memeq_stream_update(&ctx, ys.data() + 3, xs.data() + 3, 5);
+  EXPECT_EQ(hardened_memeq_stream_final(&ctx, xs.size()), kHardenedBoolFalse);
+}
+
+TEST(HardenedMemory, MemcpyWide) {
+  std::vector<uint32_t> xs = {1, 2, 3, 4, 5, 6, 7, 8};
+  std::vector<uint32_t> ys(8);
+
+  hardened_memcpy_wide(ys.data(), xs.data(), 0);
+  EXPECT_THAT(ys, Each(0));
+
+  // An odd length must not touch the word past the end.
+  hardened_memcpy_wide(ys.data(), xs.data(), 5);
+  EXPECT_THAT(ys, ElementsAre(1, 2, 3, 4, 5, 0, 0, 0));
+
+  hardened_memcpy_wide(ys.data(), xs.data(), xs.size());
+  EXPECT_EQ(ys, xs);
+}
+
+TEST(HardenedMemory, MemShredWide) {
+  std::vector<uint32_t> xs = {1, 2, 3, 4, 5, 6, 7, 8};
+  hardened_memshred_wide(xs.data(), 7);
+
+  EXPECT_THAT(xs, ElementsAre(kRandomWord, kRandomWord, kRandomWord,
+                              kRandomWord, kRandomWord, kRandomWord,
+                              kRandomWord, 8));
+}
+
+TEST(HardenedMemory, MemEqWide) {
+  std::vector<uint32_t> xs = {1, 2, 3, 4, 5, 6, 7, 8};
+  std::vector<uint32_t> ys = xs;
+
+  EXPECT_EQ(hardened_memeq_wide(ys.data(), xs.data(), xs.size()),
+            kHardenedBoolTrue);
+
+  // Differences past `word_len` are ignored.
+  ++ys[7];
+  EXPECT_EQ(hardened_memeq_wide(ys.data(), xs.data(), 7), kHardenedBoolTrue);
+
+  ++ys[6];
+  EXPECT_EQ(hardened_memeq_wide(ys.data(), xs.data(), 7), kHardenedBoolFalse);
+}
+
 }  // namespace
 }  // namespace hardened_memory_unittest
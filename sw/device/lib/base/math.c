@@ -10,6 +10,9 @@
  * Extern declaration of inline function.
  */
 extern size_t ceil_div(size_t a, size_t b);
+extern uint64_t umul64_hi(uint64_t a, uint64_t b);
+extern uint64_t udiv64_recip(uint64_t a, const udiv64_recip_t *recip);
+extern uint64_t udiv64_cached(uint64_t a, uint64_t b, udiv64_recip_t *recip);
 
 uint64_t udiv64_slow(uint64_t a, uint64_t b, uint64_t *rem_out) {
   uint64_t quot = 0, rem = 0;
@@ -48,3 +51,160 @@ uint64_t udiv64_slow(uint64_t a, uint64_t b, uint64_t *rem_out) {
   }
   return quot;
 }
+
+/**
+ * Counts the leading zeroes of a non-zero 32-bit value.
+ *
+ * This avoids `__builtin_clz()`, which may be lowered to a libgcc call.
+ */
+static int clz32(uint32_t x) {
+  int n = 0;
+  if (x <= 0x0000ffff) {
+    n += 16;
+    x <<= 16;
+  }
+  if (x <= 0x00ffffff) {
+    n += 8;
+    x <<= 8;
+  }
+  if (x <= 0x0fffffff) {
+    n += 4;
+    x <<= 4;
+  }
+  if (x <= 0x3fffffff) {
+    n += 2;
+    x <<= 2;
+  }
+  if (x <= 0x7fffffff) {
+    n += 1;
+  }
+  return n;
+}
+
+/**
+ * Divides the 64-bit value `u1:u0` by `v`, where `u1 < v` so that the quotient
+ * fits in 32 bits.
+ *
+ * This is Knuth's algorithm D with 16-bit digits, which only needs 32-bit
+ * divisions (Hacker's Delight, figure 9-3).
+ */
+static uint32_t udiv64_32(uint32_t u1, uint32_t u0, uint32_t v,
+                          uint32_t *rem_out) {
+  const uint32_t b = 1u << 16;
+
+  // Normalize the divisor so that its top bit is set.
+  int s = clz32(v);
+  v <<= s;
+  uint32_t vn1 = v >> 16;
+  uint32_t vn0 = v & 0xffff;
+  uint32_t un32 = (u1 << s) | (s == 0 ? 0 : u0 >> (32 - s));
+  uint32_t un10 = u0 << s;
+  uint32_t un1 = un10 >> 16;
+  uint32_t un0 = un10 & 0xffff;
+
+  // Estimate each quotient digit from the top divisor digit, then correct the
+  // estimate, which is at most two too large.
+  uint32_t q1 = un32 / vn1;
+  uint32_t rhat = un32 - q1 * vn1;
+  while (q1 >= b || q1 * vn0 > b * rhat + un1) {
+    q1 -= 1;
+    rhat += vn1;
+    if (rhat >= b) {
+      break;
+    }
+  }
+
+  uint32_t un21 = un32 * b + un1 - q1 * v;
+  uint32_t q0 = un21 / vn1;
+  rhat = un21 - q0 * vn1;
+  while (q0 >= b || q0 * vn0 > b * rhat + un0) {
+    q0 -= 1;
+    rhat += vn1;
+    if (rhat >= b) {
+      break;
+    }
+  }
+
+  *rem_out = (un21 * b + un0 - q0 * v) >> s;
+  return q1 * b + q0;
+}
+
+uint64_t udiv64(uint64_t a, uint64_t b, uint64_t *rem_out) {
+  uint32_t a_hi = a >> 32;
+  uint32_t a_lo = (uint32_t)a;
+  uint32_t b_hi = b >> 32;
+  uint32_t b_lo = (uint32_t)b;
+  uint64_t quot, rem;
+
+  if (b_hi == 0) {
+    if (a_hi == 0) {
+      quot = a_lo / b_lo;
+      rem = a_lo % b_lo;
+    } else {
+      // Divide the high word first, so that the remainder is less than the
+      // divisor and the rest of the quotient fits in 32 bits.
+      uint32_t q_hi = a_hi / b_lo;
+      uint32_t r_lo;
+      uint32_t q_lo = udiv64_32(a_hi - q_hi * b_lo, a_lo, b_lo, &r_lo);
+      quot = ((uint64_t)q_hi << 32) | q_lo;
+      rem = r_lo;
+    }
+  } else {
+    // The quotient fits in 32 bits. Estimating it from the top 32 bits of the
+    // normalized divisor and the dividend shifted right by one makes it either
+    // exact or one too large; decrementing it makes it exact or one too small,
+    // which is fixed up below.
+    int n = clz32(b_hi);
+    uint32_t v = (uint32_t)((b << n) >> 32);
+    uint64_t u = a >> 1;
+    uint32_t unused;
+    uint32_t q1 = udiv64_32(u >> 32, (uint32_t)u, v, &unused);
+    quot = ((uint64_t)q1 << n) >> 31;
+    if (quot != 0) {
+      quot -= 1;
+    }
+    rem = a - quot * b;
+    if (rem >= b) {
+      quot += 1;
+      rem -= b;
+    }
+  }
+
+  if (rem_out != NULL) {
+    *rem_out = rem;
+  }
+  return quot;
+}
+
+udiv64_recip_t udiv64_recip_init(uint64_t divisor) {
+  // l = ceil(log2(divisor)).
+  uint64_t d = divisor - 1;
+  uint32_t l = 0;
+  if (d >> 32 != 0) {
+    l = 64 - clz32(d >> 32);
+  } else if (d != 0) {
+    l = 32 - clz32((uint32_t)d);
+  }
+
+  // The multiplier is `floor(2^64 * (2^l - divisor) / divisor) + 1`. As
+  // `2^l - divisor < divisor`, the quotient fits in 64 bits and can be computed
+  // by long division, one bit at a time.
+  uint64_t rem = (l == 64 ? 0 : (uint64_t)1 << l) - divisor;
+  uint64_t multiplier = 0;
+  for (size_t i = 0; i < 64; ++i) {
+    uint64_t carry = rem >> 63;
+    rem <<= 1;
+    multiplier <<= 1;
+    if (carry || rem >= divisor) {
+      rem -= divisor;
+      multiplier |= 1;
+    }
+  }
+
+  return (udiv64_recip_t){
+      .divisor = divisor,
+      .multiplier = multiplier + 1,
+      .shift1 = l > 0 ? 1 : 0,
+      .shift2 = (uint8_t)(l > 0 ? l - 1 : 0),
+  };
+}
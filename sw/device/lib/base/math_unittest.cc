@@ -24,12 +24,23 @@ struct DivVector {
 
 class UDivTest : public testing::TestWithParam<DivVector> {};
 
-TEST_P(UDivTest, UDiv64) {
+TEST_P(UDivTest, UDiv64Slow) {
   uint64_t rem;
   EXPECT_EQ(udiv64_slow(GetParam().a, GetParam().b, &rem), GetParam().q);
   EXPECT_EQ(rem, GetParam().r);
 }
 
+TEST_P(UDivTest, UDiv64) {
+  uint64_t rem;
+  EXPECT_EQ(udiv64(GetParam().a, GetParam().b, &rem), GetParam().q);
+  EXPECT_EQ(rem, GetParam().r);
+}
+
+TEST_P(UDivTest, UDiv64Recip) {
+  udiv64_recip_t recip = udiv64_recip_init(GetParam().b);
+  EXPECT_EQ(udiv64_recip(GetParam().a, &recip), GetParam().q);
+}
+
 // Simple python snippet for generating vectors:
 //
 // import random
@@ -191,5 +202,45 @@ constexpr DivVector kDivVectors[] = {
 
 INSTANTIATE_TEST_SUITE_P(UDiv, UDivTest, testing::ValuesIn(kDivVectors));
 
+class UDivEdgeTest : public testing::TestWithParam<uint64_t> {};
+
+// Checks dividends around multiples of the divisor, where an inexact
+// reciprocal or quotient estimate would be off by one.
+TEST_P(UDivEdgeTest, NearMultiples) {
+  const uint64_t b = GetParam();
+  const udiv64_recip_t recip = udiv64_recip_init(b);
+  const uint64_t quotients[] = {0, 1, 2, 1000, UINT64_MAX / b};
+  for (uint64_t q : quotients) {
+    for (uint64_t r : {uint64_t{0}, uint64_t{1}, b - 1}) {
+      if (r >= b || q > (UINT64_MAX - r) / b) {
+        continue;
+      }
+      uint64_t a = q * b + r;
+      uint64_t rem;
+      EXPECT_EQ(udiv64(a, b, &rem), q) << a << " / " << b;
+      EXPECT_EQ(rem, r) << a << " % " << b;
+      EXPECT_EQ(udiv64_recip(a, &recip), q) << a << " / " << b;
+    }
+  }
+  EXPECT_EQ(udiv64(UINT64_MAX, b, nullptr), UINT64_MAX / b);
+  EXPECT_EQ(udiv64_recip(UINT64_MAX, &recip), UINT64_MAX / b);
+}
+
+INSTANTIATE_TEST_SUITE_P(UDivEdge, UDivEdgeTest,
+                         testing::Values(1, 2, 3, 7, 10, 1000, 1000000, 200000,
+                                         24000000, 100000000, 0xffff,
+                                         0x10000, 0x10001, 0xffffffff,
+                                         0x100000000, 0x100000001,
+                                         0x8000000000000000,
+                                         0x8000000000000001, UINT64_MAX));
+
+TEST(UDivCachedTest, Recompute) {
+  udiv64_recip_t recip = {0};
+  EXPECT_EQ(udiv64_cached(1000000, 1000, &recip), 1000);
+  EXPECT_EQ(recip.divisor, 1000);
+  EXPECT_EQ(udiv64_cached(1000000, 200000, &recip), 5);
+  EXPECT_EQ(recip.divisor, 200000);
+}
+
 }  // namespace
 }  // namespace math_unittest
@@ -15,17 +15,12 @@
 #define OT_PREFIX_IF_NOT_RV32(name) ot_##name
 #endif
 
-static size_t compute_num_leading_bytes(const void *left, const void *right,
-                                        size_t len) {
+static size_t compute_num_leading_bytes(const void *left, size_t len) {
   if (len < alignof(uint32_t)) {
     return len;
   }
   const size_t left_ahead = OT_UNSIGNED(misalignment32_of((uintptr_t)left));
-  const size_t right_ahead = OT_UNSIGNED(misalignment32_of((uintptr_t)right));
-  if (right == NULL || left_ahead == right_ahead) {
-    return (4 - left_ahead) & 0x3;
-  }
-  return len;
+  return (4 - left_ahead) & 0x3;
 }
 
 /**
@@ -33,20 +28,23 @@ static size_t compute_num_leading_bytes(const void *left, const void *right,
  *
  * It's more efficient for our memory functions to operate on `uint32_t` values
  * than individual bytes, but we can only read `uint32_t` values from aligned
- * addresses. This function effectively breaks the given buffers into three
+ * addresses. This function effectively breaks the given buffer into three
  * consecutive chunks: the unaligned "head", the aligned "body", and the
  * unaligned "tail".
  *
+ * The body is aligned for `left` only. Functions taking a second buffer must
+ * check its misalignment at the start of the body and, if it is nonzero, read
+ * it with `read_32_shifted()` and friends.
+ *
  * @param[in] left The memory function's first buffer argument. Cannot be NULL.
- * @param[in] right The memory function's second buffer argument. May be NULL.
- * @param[in] len The length in bytes of both `left` and `right.`
+ * @param[in] len The length in bytes of `left`.
  * @param[out] out_body_offset The start of the body region.
  * @param[out] out_tail_offset The start of the tail region.
  */
-static void compute_alignment(const void *left, const void *right, size_t len,
+static void compute_alignment(const void *left, size_t len,
                               size_t *out_body_offset,
                               size_t *out_tail_offset) {
-  const size_t num_leading_bytes = compute_num_leading_bytes(left, right, len);
+  const size_t num_leading_bytes = compute_num_leading_bytes(left, len);
   *out_body_offset = num_leading_bytes;
 
   const size_t num_words = (len - num_leading_bytes) / sizeof(uint32_t);
@@ -58,6 +56,39 @@ static uint32_t repeat_byte_to_u32(uint8_t byte) {
   return word << 24 | word << 16 | word << 8 | word;
 }
 
+/**
+ * Read `len` bytes, where `len` is less than four, into a `uint32_t`.
+ *
+ * The bytes are placed in the low end of the word, as if they had been read
+ * from the start of an aligned word.
+ */
+static uint32_t read_partial_32(const unsigned char *src, size_t len) {
+  uint32_t word = 0;
+  for (size_t i = 0; i < len; ++i) {
+    word |= (uint32_t)src[i] << (i * 8);
+  }
+  return word;
+}
+
+/**
+ * Extract the unaligned word that starts `shift` bytes into the aligned word
+ * `lo` and continues into the following aligned word `hi`.
+ *
+ * This lets the memory functions walk a buffer whose misalignment differs from
+ * the other buffer's with aligned loads only, rather than byte by byte.
+ *
+ * @param lo The lower of two consecutive aligned words.
+ * @param hi The higher of two consecutive aligned words.
+ * @param shift The misalignment, in bytes, of the word to extract. Must be 1,
+ *        2, or 3.
+ * @return The merged word.
+ */
+static uint32_t merge_32(uint32_t lo, uint32_t hi, size_t shift) {
+  static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__,
+                "merge_32 assumes that the system is little endian.");
+  return lo >> (shift * 8) | hi << (32 - shift * 8);
+}
+
 void *OT_PREFIX_IF_NOT_RV32(memcpy)(void *restrict dest,
                                     const void *restrict src, size_t len) {
   if (dest == NULL || src == NULL) {
@@ -66,14 +97,40 @@ void *OT_PREFIX_IF_NOT_RV32(memcpy)(void *restrict dest,
   unsigned char *dest8 = (unsigned char *)dest;
   const unsigned char *src8 = (const unsigned char *)src;
   size_t body_offset, tail_offset;
-  compute_alignment(dest, src, len, &body_offset, &tail_offset);
+  compute_alignment(dest, len, &body_offset, &tail_offset);
   size_t i = 0;
   for (; i < body_offset; ++i) {
     dest8[i] = src8[i];
   }
-  for (; i < tail_offset; i += sizeof(uint32_t)) {
-    uint32_t word = read_32(&src8[i]);
-    write_32(word, &dest8[i]);
+  const size_t shift = OT_UNSIGNED(misalignment32_of((uintptr_t)&src8[i]));
+  if (shift == 0) {
+    for (; i + 4 * sizeof(uint32_t) <= tail_offset;
+         i += 4 * sizeof(uint32_t)) {
+      uint32_t word0 = read_32(&src8[i]);
+      uint32_t word1 = read_32(&src8[i + 4]);
+      uint32_t word2 = read_32(&src8[i + 8]);
+      uint32_t word3 = read_32(&src8[i + 12]);
+      write_32(word0, &dest8[i]);
+      write_32(word1, &dest8[i + 4]);
+      write_32(word2, &dest8[i + 8]);
+      write_32(word3, &dest8[i + 12]);
+    }
+    for (; i < tail_offset; i += sizeof(uint32_t)) {
+      uint32_t word = read_32(&src8[i]);
+      write_32(word, &dest8[i]);
+    }
+  } else if (i + 2 * sizeof(uint32_t) <= tail_offset) {
+    // `src` is misaligned relative to `dest`. Each aligned load from `src`
+    // supplies the end of one `dest` word and the start of the next one; the
+    // loop stops a word early so that the loads never run past `len`.
+    uint32_t prev = read_partial_32(&src8[i], sizeof(uint32_t) - shift)
+                    << (shift * 8);
+    do {
+      uint32_t next = read_32(&src8[i + sizeof(uint32_t) - shift]);
+      write_32(merge_32(prev, next, shift), &dest8[i]);
+      prev = next;
+      i += sizeof(uint32_t);
+    } while (i + 2 * sizeof(uint32_t) <= tail_offset);
   }
   for (; i < len; ++i) {
     dest8[i] = src8[i];
@@ -86,7 +143,7 @@ void *OT_PREFIX_IF_NOT_RV32(memset)(void *dest, int value, size_t len) {
   const uint8_t value8 = (uint8_t)value;
 
   size_t body_offset, tail_offset;
-  compute_alignment(dest, NULL, len, &body_offset, &tail_offset);
+  compute_alignment(dest, len, &body_offset, &tail_offset);
   size_t i = 0;
   for (; i < body_offset; ++i) {
     dest8[i] = value8;
@@ -112,7 +169,7 @@ int OT_PREFIX_IF_NOT_RV32(memcmp)(const void *lhs, const void *rhs,
   const unsigned char *lhs8 = (const unsigned char *)lhs;
   const unsigned char *rhs8 = (const unsigned char *)rhs;
   size_t body_offset, tail_offset;
-  compute_alignment(lhs, rhs, len, &body_offset, &tail_offset);
+  compute_alignment(lhs, len, &body_offset, &tail_offset);
   size_t i = 0;
   for (; i < body_offset; ++i) {
     if (lhs8[i] < rhs8[i]) {
@@ -121,20 +178,39 @@ int OT_PREFIX_IF_NOT_RV32(memcmp)(const void *lhs, const void *rhs,
       return kMemCmpGt;
     }
   }
-  for (; i < tail_offset; i += sizeof(uint32_t)) {
+  const size_t shift = OT_UNSIGNED(misalignment32_of((uintptr_t)&rhs8[i]));
+  if (shift == 0) {
+    for (; i < tail_offset; i += sizeof(uint32_t)) {
 #if OT_BUILD_FOR_STATIC_ANALYZER
-    assert(&lhs8[i] != NULL);
-    assert(&rhs8[i] != NULL);
+      assert(&lhs8[i] != NULL);
+      assert(&rhs8[i] != NULL);
 #endif
-    uint32_t word_left = __builtin_bswap32(read_32(&lhs8[i]));
-    uint32_t word_right = __builtin_bswap32(read_32(&rhs8[i]));
-    static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__,
-                  "memcmp assumes that the system is little endian.");
-    if (word_left < word_right) {
-      return kMemCmpLt;
-    } else if (word_left > word_right) {
-      return kMemCmpGt;
+      uint32_t word_left = __builtin_bswap32(read_32(&lhs8[i]));
+      uint32_t word_right = __builtin_bswap32(read_32(&rhs8[i]));
+      static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__,
+                    "memcmp assumes that the system is little endian.");
+      if (word_left < word_right) {
+        return kMemCmpLt;
+      } else if (word_left > word_right) {
+        return kMemCmpGt;
+      }
     }
+  } else if (i + 2 * sizeof(uint32_t) <= tail_offset) {
+    // See `memcpy()` for how the misaligned `rhs` is read.
+    uint32_t prev = read_partial_32(&rhs8[i], sizeof(uint32_t) - shift)
+                    << (shift * 8);
+    do {
+      uint32_t next = read_32(&rhs8[i + sizeof(uint32_t) - shift]);
+      uint32_t word_left = __builtin_bswap32(read_32(&lhs8[i]));
+      uint32_t word_right = __builtin_bswap32(merge_32(prev, next, shift));
+      if (word_left < word_right) {
+        return kMemCmpLt;
+      } else if (word_left > word_right) {
+        return kMemCmpGt;
+      }
+      prev = next;
+      i += sizeof(uint32_t);
+    } while (i + 2 * sizeof(uint32_t) <= tail_offset);
   }
   for (; i < len; ++i) {
     if (lhs8[i] < rhs8[i]) {
@@ -150,7 +226,7 @@ int memrcmp(const void *lhs, const void *rhs, size_t len) {
   const unsigned char *lhs8 = (const unsigned char *)lhs;
   const unsigned char *rhs8 = (const unsigned char *)rhs;
   size_t body_offset, tail_offset;
-  compute_alignment(lhs, rhs, len, &body_offset, &tail_offset);
+  compute_alignment(lhs, len, &body_offset, &tail_offset);
   size_t end = len;
   for (; end > tail_offset; --end) {
     const size_t i = end - 1;
@@ -160,21 +236,41 @@ int memrcmp(const void *lhs, const void *rhs, size_t len) {
       return kMemCmpGt;
     }
   }
-  for (; end > body_offset; end -= sizeof(uint32_t)) {
-    const size_t i = end - sizeof(uint32_t);
+  const size_t shift = OT_UNSIGNED(misalignment32_of((uintptr_t)&rhs8[end]));
+  if (shift == 0) {
+    for (; end > body_offset; end -= sizeof(uint32_t)) {
+      const size_t i = end - sizeof(uint32_t);
 #if OT_BUILD_FOR_STATIC_ANALYZER
-    assert(&lhs8[i] != NULL);
-    assert(&rhs8[i] != NULL);
+      assert(&lhs8[i] != NULL);
+      assert(&rhs8[i] != NULL);
 #endif
-    uint32_t word_left = read_32(&lhs8[i]);
-    uint32_t word_right = read_32(&rhs8[i]);
-    static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__,
-                  "memrcmp assumes that the system is little endian.");
-    if (word_left < word_right) {
-      return kMemCmpLt;
-    } else if (word_left > word_right) {
-      return kMemCmpGt;
+      uint32_t word_left = read_32(&lhs8[i]);
+      uint32_t word_right = read_32(&rhs8[i]);
+      static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__,
+                    "memrcmp assumes that the system is little endian.");
+      if (word_left < word_right) {
+        return kMemCmpLt;
+      } else if (word_left > word_right) {
+        return kMemCmpGt;
+      }
     }
+  } else if (end >= body_offset + 2 * sizeof(uint32_t)) {
+    // Like `memcmp()`, but walking down: each aligned load from `rhs` supplies
+    // the start of one word and the end of the word below it.
+    uint32_t next = read_partial_32(&rhs8[end - shift], shift);
+    do {
+      const size_t i = end - sizeof(uint32_t);
+      uint32_t prev = read_32(&rhs8[i - shift]);
+      uint32_t word_left = read_32(&lhs8[i]);
+      uint32_t word_right = merge_32(prev, next, shift);
+      if (word_left < word_right) {
+        return kMemCmpLt;
+      } else if (word_left > word_right) {
+        return kMemCmpGt;
+      }
+      next = prev;
+      end = i;
+    } while (end >= body_offset + 2 * sizeof(uint32_t));
   }
   for (; end > 0; --end) {
     const size_t i = end - 1;
@@ -192,7 +288,7 @@ void *OT_PREFIX_IF_NOT_RV32(memchr)(const void *ptr, int value, size_t len) {
   const uint8_t value8 = (uint8_t)value;
 
   size_t body_offset, tail_offset;
-  compute_alignment(ptr, NULL, len, &body_offset, &tail_offset);
+  compute_alignment(ptr, len, &body_offset, &tail_offset);
   size_t i = 0;
   for (; i < body_offset; ++i) {
     if (ptr8[i] == value8) {
@@ -231,7 +327,7 @@ void *OT_PREFIX_IF_NOT_RV32(memrchr)(const void *ptr, int value, size_t len) {
   const uint8_t value8 = (uint8_t)value;
 
   size_t body_offset, tail_offset;
-  compute_alignment(ptr, NULL, len, &body_offset, &tail_offset);
+  compute_alignment(ptr, len, &body_offset, &tail_offset);
 
   size_t end = len;
   for (; end > tail_offset; --end) {
@@ -97,6 +97,13 @@ OT_NOINLINE void test_memcpy(uint8_t *buf1, uint8_t *buf2, size_t len) {
   memcpy(buf1, buf2, len);
 }
 
+// Copy from a source two bytes ahead of the word-aligned destination, like a
+// packet payload that follows a 16-bit header.
+OT_NOINLINE void test_memcpy_misaligned(uint8_t *buf1, uint8_t *buf2,
+                                        size_t len) {
+  memcpy(buf1, buf2 + 2, len - 2);
+}
+
 OT_NOINLINE void test_memset(uint8_t *buf1, uint8_t *buf2, size_t len) {
   const int value = buf2[0];
   memset(buf1, value, len);
@@ -110,6 +117,16 @@ OT_NOINLINE void test_memrcmp(uint8_t *buf1, uint8_t *buf2, size_t len) {
   memrcmp(buf1, buf2, len);
 }
 
+OT_NOINLINE void test_memcmp_misaligned(uint8_t *buf1, uint8_t *buf2,
+                                        size_t len) {
+  memcmp(buf1, buf2 + 1, len - 1);
+}
+
+OT_NOINLINE void test_memrcmp_misaligned(uint8_t *buf1, uint8_t *buf2,
+                                         size_t len) {
+  memrcmp(buf1, buf2 + 3, len - 3);
+}
+
 OT_NOINLINE void test_memchr(uint8_t *buf1, uint8_t *buf2, size_t len) {
   const uint8_t value = buf1[len - 1];
   memchr(buf1, value, len);
@@ -157,6 +174,13 @@ static const perf_test_t kPerfTests[] = {
         .func = &test_memcpy,
         .expected_max_num_cycles = 33270,
     },
+    {
+        .label = "memcpy_misaligned",
+        .setup_buf1 = &fill_buf_deterministic_values,
+        .setup_buf2 = &fill_buf_deterministic_values,
+        .func = &test_memcpy_misaligned,
+        .expected_max_num_cycles = 50000,
+    },
     {
         .label = "memset",
         .setup_buf1 = &fill_buf_zeroes,
@@ -185,6 +209,13 @@ static const perf_test_t kPerfTests[] = {
         .func = &test_memcmp,
         .expected_max_num_cycles = 110740,
     },
+    {
+        .label = "memcmp_misaligned_zeroes",
+        .setup_buf1 = &fill_buf_zeroes,
+        .setup_buf2 = &fill_buf_zeroes,
+        .func = &test_memcmp_misaligned,
+        .expected_max_num_cycles = 130000,
+    },
     {
         .label = "memrcmp_pathological",
         .setup_buf1 = &fill_buf_zeroes,
@@ -199,6 +230,13 @@ static const perf_test_t kPerfTests[] = {
         .func = &test_memrcmp,
         .expected_max_num_cycles = 50850,
     },
+    {
+        .label = "memrcmp_misaligned_zeroes",
+        .setup_buf1 = &fill_buf_zeroes,
+        .setup_buf2 = &fill_buf_zeroes,
+        .func = &test_memrcmp_misaligned,
+        .expected_max_num_cycles = 70000,
+    },
     {
         .label = "memchr_pathological",
         .setup_buf1 = &fill_buf_deterministic_values,
@@ -193,6 +193,34 @@ TEST_P(MemCpyTest, VaryDestAlignment) {
   }
 }
 
+TEST_P(MemCpyTest, VaryRelativeAlignment) {
+  auto memcpy_func = GetParam();
+
+  static constexpr size_t kLen = 64;
+  std::vector<uint8_t> src(kLen + 4);
+  for (size_t i = 0; i < src.size(); ++i) {
+    src[i] = static_cast<uint8_t>(i * 7 + 1);
+  }
+
+  for (size_t src_offset = 0; src_offset < 4; ++src_offset) {
+    for (size_t dest_offset = 0; dest_offset < 4; ++dest_offset) {
+      for (size_t len = 0; len <= kLen; ++len) {
+        SCOPED_TRACE(testing::Message()
+                     << "src_offset=" << src_offset
+                     << " dest_offset=" << dest_offset << " len=" << len);
+
+        std::vector<uint8_t> dest(kLen + 8, 0xff);
+        memcpy_func(&dest[dest_offset], &src[src_offset], len);
+
+        std::vector<uint8_t> dest_expected(kLen + 8, 0xff);
+        std::copy(&src[src_offset], &src[src_offset] + len,
+                  &dest_expected[dest_offset]);
+        EXPECT_EQ(dest, dest_expected);
+      }
+    }
+  }
+}
+
 TEST_P(MemCmpTest, NullParam) {
   auto memcmp_func = GetParam();
 
@@ -217,6 +245,47 @@ TEST_P(MemCmpTest, ZeroesVaryingOffsetsAndLengths) {
   }
 }
 
+TEST_P(MemCmpTest, VaryRelativeAlignment) {
+  auto memcmp_func = GetParam();
+
+  const bool reverse = memcmp_func == &memrcmp || memcmp_func == &ref_memrcmp;
+
+  static constexpr size_t kLen = 40;
+  for (size_t lhs_offset = 0; lhs_offset < 4; ++lhs_offset) {
+    for (size_t rhs_offset = 0; rhs_offset < 4; ++rhs_offset) {
+      for (size_t diff = 0; diff < kLen; ++diff) {
+        SCOPED_TRACE(testing::Message()
+                     << "lhs_offset=" << lhs_offset
+                     << " rhs_offset=" << rhs_offset << " diff=" << diff);
+
+        std::vector<uint8_t> lhs(kLen + 4, 0x5a);
+        std::vector<uint8_t> rhs(kLen + 4, 0x5a);
+        lhs[lhs_offset + diff] = 0x10;
+        rhs[rhs_offset + diff] = 0x20;
+        // A difference with the opposite sign past `diff` checks that the
+        // comparison stops at the first (or, for memrcmp, last) difference.
+        size_t same_start = 0;
+        size_t same_len = diff;
+        if (!reverse && diff + 1 < kLen) {
+          lhs[lhs_offset + diff + 1] = 0xff;
+        } else if (reverse) {
+          if (diff > 0) {
+            lhs[lhs_offset + diff - 1] = 0xff;
+          }
+          same_start = diff + 1;
+          same_len = kLen - same_start;
+        }
+
+        EXPECT_EQ(memcmp_func(&lhs[lhs_offset + same_start],
+                              &rhs[rhs_offset + same_start], same_len),
+                  0);
+        EXPECT_LT(memcmp_func(&lhs[lhs_offset], &rhs[rhs_offset], kLen), 0);
+        EXPECT_GT(memcmp_func(&rhs[rhs_offset], &lhs[lhs_offset], kLen), 0);
+      }
+    }
+  }
+}
+
 TEST_P(MemSetTest, Null) {
   auto memset_func = GetParam();
 
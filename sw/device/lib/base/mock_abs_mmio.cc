@@ -4,29 +4,58 @@
 
 #include "sw/device/lib/base/mock_abs_mmio.h"
 
+#include "sw/device/lib/base/mock_mmio_trace.h"
+
 namespace rom_test {
+namespace {
+void Trace(bool write, uint32_t addr, size_t width, uint32_t value,
+           const void *caller) {
+  mock_mmio::MmioTrace::Record({
+      .bus = mock_mmio::MmioBus::kAbs,
+      .write = write,
+      .device = 0,
+      .addr = addr,
+      .width = width,
+      .value = value,
+      .caller = caller,
+  });
+}
+}  // namespace
+
 extern "C" {
 uint8_t abs_mmio_read8(uint32_t addr) {
-  return MockAbsMmio::Instance().Read8(addr);
+  uint8_t value = MockAbsMmio::Instance().Read8(addr);
+  Trace(false, addr, sizeof(value), value, __builtin_return_address(0));
+  return value;
 }
 
 void abs_mmio_write8(uint32_t addr, uint8_t value) {
+  Trace(true, addr, sizeof(value), value, __builtin_return_address(0));
   MockAbsMmio::Instance().Write8(addr, value);
 }
 
 void abs_mmio_write8_shadowed(uint32_t addr, uint8_t value) {
+  // A shadowed write is two writes on the bus.
+  Trace(true, addr, sizeof(value), value, __builtin_return_address(0));
+  Trace(true, addr, sizeof(value), value, __builtin_return_address(0));
   MockAbsMmio::Instance().Write8Shadowed(addr, value);
 }
 
 uint32_t abs_mmio_read32(uint32_t addr) {
-  return MockAbsMmio::Instance().Read32(addr);
+  uint32_t value = MockAbsMmio::Instance().Read32(addr);
+  Trace(false, addr, sizeof(value), value, __builtin_return_address(0));
+  return value;
 }
 
 void abs_mmio_write32(uint32_t addr, uint32_t value) {
+  Trace(true, addr, sizeof(value), value, __builtin_return_address(0));
   MockAbsMmio::Instance().Write32(addr, value);
 }
 
 void abs_mmio_write32_shadowed(uint32_t addr, uint32_t value) {
+  // A shadowed write is two writes on the bus.
+  Trace(true, addr, sizeof(value), value, __builtin_return_address(0));
+  Trace(true, addr, sizeof(value), value, __builtin_return_address(0));
   MockAbsMmio::Instance().Write32Shadowed(addr, value);
 }
 }  // extern "C"
@@ -5,10 +5,26 @@
 #include "sw/device/lib/base/mock_mmio.h"
 
 #include "sw/device/lib/base/mmio.h"
+#include "sw/device/lib/base/mock_mmio_trace.h"
 
 namespace mock_mmio {
 std::random_device MockDevice::rd;
 
+namespace {
+void Trace(mmio_region_t base, bool write, ptrdiff_t offset, size_t width,
+           uint32_t value, const void *caller) {
+  MmioTrace::Record({
+      .bus = MmioBus::kRegion,
+      .write = write,
+      .device = reinterpret_cast<uintptr_t>(base.mock),
+      .addr = static_cast<uintptr_t>(offset),
+      .width = width,
+      .value = value,
+      .caller = caller,
+  });
+}
+}  // namespace
+
 // Definitions for the MOCK_MMIO-mode declarations in |mmio.h|.
 extern "C" {
 // dummy
@@ -18,36 +34,50 @@ mmio_region_t mmio_region_from_addr(uintptr_t address) {
 
 uint8_t mmio_region_read8(mmio_region_t base, ptrdiff_t offset) {
   auto *dev = static_cast<MockDevice *>(base.mock);
-  return dev->Read8(offset);
+  uint8_t value = dev->Read8(offset);
+  Trace(base, false, offset, sizeof(value), value,
+        __builtin_return_address(0));
+  return value;
 }
 
 uint32_t mmio_region_read32(mmio_region_t base, ptrdiff_t offset) {
   auto *dev = static_cast<MockDevice *>(base.mock);
-  return dev->Read32(offset);
+  uint32_t value = dev->Read32(offset);
+  Trace(base, false, offset, sizeof(value), value,
+        __builtin_return_address(0));
+  return value;
 }
 
 void mmio_region_write8(mmio_region_t base, ptrdiff_t offset, uint8_t value) {
   auto *dev = static_cast<MockDevice *>(base.mock);
+  Trace(base, true, offset, sizeof(value), value, __builtin_return_address(0));
   dev->Write8(offset, value);
 }
 
 void mmio_region_write8_shadowed(mmio_region_t base, ptrdiff_t offset,
                                  uint8_t value) {
   auto *dev = static_cast<MockDevice *>(base.mock);
-  dev->Write8(offset, value);
-  dev->Write8(offset, value);
+  for (int i = 0; i < 2; ++i) {
+    Trace(base, true, offset, sizeof(value), value,
+          __builtin_return_address(0));
+    dev->Write8(offset, value);
+  }
 }
 
 void mmio_region_write32(mmio_region_t base, ptrdiff_t offset, uint32_t value) {
   auto *dev = static_cast<MockDevice *>(base.mock);
+  Trace(base, true, offset, sizeof(value), value, __builtin_return_address(0));
   dev->Write32(offset, value);
 }
 
 void mmio_region_write32_shadowed(mmio_region_t base, ptrdiff_t offset,
                                   uint32_t value) {
   auto *dev = static_cast<MockDevice *>(base.mock);
-  dev->Write32(offset, value);
-  dev->Write32(offset, value);
+  for (int i = 0; i < 2; ++i) {
+    Trace(base, true, offset, sizeof(value), value,
+          __builtin_return_address(0));
+    dev->Write32(offset, value);
+  }
 }
 }  // extern "C"
 }  // namespace mock_mmio
@@ -6,10 +6,40 @@
 
 #include "gtest/gtest.h"
 #include "sw/device/lib/base/mmio.h"
+#include "sw/device/lib/base/mock_mmio_trace.h"
+
+// The MMIO trace resolves function names through the dynamic symbol table, so
+// the functions it is expected to name must have external linkage.
+namespace mmio_trace_test {
+/**
+ * Polls bit 0 of the register at offset 0x10 of |dev| until it is set.
+ */
+__attribute__((noinline)) uint32_t PollReady(mmio_region_t dev) {
+  uint32_t value;
+  do {
+    value = mmio_region_read32(dev, 0x10);
+  } while ((value & 1) == 0);
+  return value;
+}
+
+/**
+ * Reads the register at offset 0x0 of |dev| around a write to the register at
+ * |offset|, and returns whether its value changed.
+ */
+__attribute__((noinline)) bool ReadAroundWrite(mmio_region_t dev,
+                                               ptrdiff_t offset) {
+  uint32_t before = mmio_region_read32(dev, 0x0);
+  mmio_region_write32(dev, offset, 0x1);
+  return mmio_region_read32(dev, 0x0) != before;
+}
+}  // namespace mmio_trace_test
 
 namespace {
+using ::mmio_trace_test::PollReady;
+using ::mmio_trace_test::ReadAroundWrite;
 using ::mock_mmio::LeInt;
 using ::mock_mmio::MmioTest;
+using ::mock_mmio::MmioTrace;
 using ::testing::Test;
 
 /**
@@ -78,4 +108,67 @@ TEST_F(MockMmioTest, ExpectMask) {
   value &= ~(1 << 0x10);
   mmio_region_write32(dev().region(), 0x8, value);
 }
+
+class MmioTraceTest : public Test, public MmioTest {};
+
+TEST_F(MmioTraceTest, Summary) {
+  MmioTrace trace;
+  EXPECT_READ32(0x10, 0x0);
+  EXPECT_READ32(0x10, 0x0);
+  EXPECT_READ32(0x10, 0x1);
+  EXPECT_READ32(0x0, 0xa5);
+  EXPECT_WRITE32(0x4, 0x1);
+  EXPECT_READ32(0x0, 0xa5);
+  EXPECT_EQ(PollReady(dev().region()), 0x1);
+  EXPECT_FALSE(ReadAroundWrite(dev().region(), 0x4));
+
+  EXPECT_EQ(trace.accesses().size(), 6);
+  EXPECT_EQ(trace.PerFunction().size(), 2);
+
+  auto loops = trace.PollLoops();
+  ASSERT_EQ(loops.size(), 1) << trace.Report();
+  EXPECT_EQ(loops[0].first.addr, 0x10);
+  EXPECT_EQ(loops[0].iterations, 3);
+
+  auto redundant = trace.RedundantReads();
+  ASSERT_EQ(redundant.size(), 1) << trace.Report();
+  EXPECT_EQ(redundant[0].addr, 0x0);
+  EXPECT_EQ(redundant[0].value, 0xa5);
+}
+
+TEST_F(MmioTraceTest, WriteIsNotRedundant) {
+  MmioTrace trace;
+  EXPECT_READ32(0x0, 0xa5);
+  EXPECT_WRITE32(0x0, 0x1);
+  EXPECT_READ32(0x0, 0xa5);
+  EXPECT_FALSE(ReadAroundWrite(dev().region(), 0x0));
+
+  EXPECT_TRUE(trace.RedundantReads().empty()) << trace.Report();
+  EXPECT_TRUE(trace.PollLoops().empty()) << trace.Report();
+}
+
+TEST_F(MmioTraceTest, ShadowedWrite) {
+  MmioTrace trace;
+  EXPECT_WRITE32_SHADOWED(0x8, 0xcafe);
+  mmio_region_write32_shadowed(dev().region(), 0x8, 0xcafe);
+
+  ASSERT_EQ(trace.accesses().size(), 2);
+  EXPECT_TRUE(trace.accesses()[0].write);
+  EXPECT_TRUE(trace.accesses()[1].write);
+}
+
+TEST_F(MmioTraceTest, Inactive) {
+  {
+    MmioTrace trace;
+    EXPECT_READ32(0x0, 0x0);
+    EXPECT_EQ(mmio_region_read32(dev().region(), 0x0), 0x0);
+    trace.Clear();
+    EXPECT_TRUE(trace.accesses().empty());
+  }
+  EXPECT_READ32(0x0, 0x0);
+  EXPECT_EQ(mmio_region_read32(dev().region(), 0x0), 0x0);
+
+  MmioTrace trace;
+  EXPECT_TRUE(trace.accesses().empty());
+}
 }  // namespace
@@ -0,0 +1,155 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "sw/device/lib/base/mock_mmio_trace.h"
+
+#include <cstdlib>
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <iomanip>
+#include <sstream>
+
+#include "gtest/gtest.h"
+
+namespace mock_mmio {
+MmioTrace *MmioTrace::active_ = nullptr;
+
+MmioTrace::MmioTrace() {
+  EXPECT_EQ(active_, nullptr) << "Only one MmioTrace may be alive at a time";
+  active_ = this;
+}
+
+MmioTrace::~MmioTrace() {
+  if (active_ == this) {
+    active_ = nullptr;
+  }
+}
+
+void MmioTrace::Record(const MmioAccess &access) {
+  if (active_ != nullptr) {
+    active_->accesses_.push_back(access);
+  }
+}
+
+std::string MmioTrace::FunctionName(const void *addr) {
+  Dl_info info;
+  if (dladdr(addr, &info) != 0 && info.dli_sname != nullptr) {
+    int status;
+    char *demangled =
+        abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+    if (status == 0) {
+      std::string name(demangled);
+      std::free(demangled);
+      return name;
+    }
+    return info.dli_sname;
+  }
+  std::ostringstream os;
+  os << addr;
+  return os.str();
+}
+
+std::map<std::string, size_t> MmioTrace::PerFunction() const {
+  std::map<std::string, size_t> counts;
+  for (const auto &access : accesses_) {
+    ++counts[FunctionName(access.caller)];
+  }
+  return counts;
+}
+
+/**
+ * Returns whether the read `accesses[i]` continues a read-poll loop.
+ */
+static bool ContinuesPoll(const std::vector<MmioAccess> &accesses, size_t i) {
+  if (i == 0) {
+    return false;
+  }
+  const MmioAccess &prev = accesses[i - 1];
+  const MmioAccess &curr = accesses[i];
+  return !prev.write && !curr.write && prev.SameRegister(curr) &&
+         MmioTrace::FunctionName(prev.caller) ==
+             MmioTrace::FunctionName(curr.caller);
+}
+
+std::vector<MmioTrace::PollLoop> MmioTrace::PollLoops() const {
+  std::vector<PollLoop> loops;
+  for (size_t i = 0; i < accesses_.size(); ++i) {
+    if (!ContinuesPoll(accesses_, i)) {
+      continue;
+    }
+    if (!ContinuesPoll(accesses_, i - 1)) {
+      loops.push_back({accesses_[i - 1], 1});
+    }
+    ++loops.back().iterations;
+  }
+  return loops;
+}
+
+std::vector<MmioAccess> MmioTrace::RedundantReads() const {
+  std::vector<MmioAccess> redundant;
+  for (size_t i = 0; i < accesses_.size(); ++i) {
+    const MmioAccess &curr = accesses_[i];
+    if (curr.write || ContinuesPoll(accesses_, i)) {
+      continue;
+    }
+    // Find the previous access to the same register.
+    for (size_t j = i; j > 0; --j) {
+      const MmioAccess &prev = accesses_[j - 1];
+      if (!prev.SameRegister(curr)) {
+        continue;
+      }
+      if (!prev.write && prev.width == curr.width &&
+          prev.value == curr.value) {
+        redundant.push_back(curr);
+      }
+      break;
+    }
+  }
+  return redundant;
+}
+
+static std::string Describe(const MmioAccess &access) {
+  std::ostringstream os;
+  switch (access.bus) {
+    case MmioBus::kRegion:
+      os << "mmio_region";
+      break;
+    case MmioBus::kAbs:
+      os << "abs_mmio";
+      break;
+    case MmioBus::kSec:
+      os << "sec_mmio";
+      break;
+  }
+  os << (access.write ? "_write" : "_read") << access.width * 8 << "(";
+  if (access.bus == MmioBus::kRegion) {
+    os << "dev=0x" << std::hex << access.device << ", ";
+  }
+  os << "0x" << std::hex << access.addr << ") = 0x" << std::setw(8)
+     << std::setfill('0') << access.value << " in "
+     << MmioTrace::FunctionName(access.caller);
+  return os.str();
+}
+
+std::string MmioTrace::Report() const {
+  size_t reads = 0;
+  for (const auto &access : accesses_) {
+    reads += access.write ? 0 : 1;
+  }
+  std::ostringstream os;
+  os << "MMIO trace: " << accesses_.size() << " accesses (" << reads
+     << " reads, " << accesses_.size() - reads << " writes)\n";
+  for (const auto &entry : PerFunction()) {
+    os << "  " << entry.second << "\t" << entry.first << "\n";
+  }
+  for (const auto &loop : PollLoops()) {
+    os << "  poll loop: " << loop.iterations << " x " << Describe(loop.first)
+       << "\n";
+  }
+  for (const auto &access : RedundantReads()) {
+    os << "  redundant read: " << Describe(access) << "\n";
+  }
+  return os.str();
+}
+}  // namespace mock_mmio
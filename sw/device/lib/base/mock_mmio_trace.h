@@ -0,0 +1,150 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef OPENTITAN_SW_DEVICE_LIB_BASE_MOCK_MMIO_TRACE_H_
+#define OPENTITAN_SW_DEVICE_LIB_BASE_MOCK_MMIO_TRACE_H_
+
+#include <map>
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace mock_mmio {
+/**
+ * The interface through which a register was accessed.
+ */
+enum class MmioBus {
+  /** `mmio_region_*()`, addressed by mock device and offset. */
+  kRegion,
+  /** `abs_mmio_*()`, addressed by absolute address. */
+  kAbs,
+  /** `sec_mmio_*()`, addressed by absolute address. */
+  kSec,
+};
+
+/**
+ * A single register access recorded by an `MmioTrace`.
+ */
+struct MmioAccess {
+  MmioBus bus;
+  bool write;
+  /**
+   * The mock device of a `kRegion` access; zero otherwise.
+   */
+  uintptr_t device;
+  /**
+   * The offset of a `kRegion` access, or the absolute address otherwise.
+   */
+  uintptr_t addr;
+  /**
+   * The width of the access in bytes.
+   */
+  size_t width;
+  uint32_t value;
+  /**
+   * The return address of the access, i.e. a location in the function which
+   * performed it.
+   */
+  const void *caller;
+
+  /**
+   * Returns whether `other` accesses the same register.
+   */
+  bool SameRegister(const MmioAccess &other) const {
+    return bus == other.bus && device == other.device && addr == other.addr;
+  }
+};
+
+/**
+ * Records the register accesses made through the host mocks of `mmio.h`,
+ * `abs_mmio.h` and `sec_mmio.h` while it is alive, so that unit tests can
+ * bound the MMIO traffic of driver hot paths:
+ *
+ *   TEST_F(FlashCtrlTest, StatusGetTraffic) {
+ *     mock_mmio::MmioTrace trace;
+ *     // Set up expectations and call the driver as usual.
+ *     EXPECT_LE(trace.accesses().size(), 2);
+ *     EXPECT_TRUE(trace.RedundantReads().empty()) << trace.Report();
+ *   }
+ *
+ * Accesses are still forwarded to the mocks, so expectations work as usual.
+ * Only one trace may be alive at a time. Function names are resolved through
+ * the dynamic symbol table, which is why this library links with `-rdynamic`.
+ * Where a name is not available, e.g. for functions with internal linkage, the
+ * address of the call site is reported instead, so such a function's accesses
+ * are counted per call site.
+ */
+class MmioTrace {
+ public:
+  /**
+   * A run of consecutive reads of the same register from the same function,
+   * i.e. a read-poll loop.
+   */
+  struct PollLoop {
+    MmioAccess first;
+    size_t iterations;
+  };
+
+  MmioTrace();
+  ~MmioTrace();
+
+  MmioTrace(const MmioTrace &) = delete;
+  MmioTrace &operator=(const MmioTrace &) = delete;
+
+  /**
+   * Returns all the accesses recorded so far, in order.
+   */
+  const std::vector<MmioAccess> &accesses() const { return accesses_; }
+
+  /**
+   * Returns the number of accesses made by each function.
+   */
+  std::map<std::string, size_t> PerFunction() const;
+
+  /**
+   * Returns the read-poll loops, i.e. the runs of two or more consecutive
+   * reads of the same register from the same function.
+   */
+  std::vector<PollLoop> PollLoops() const;
+
+  /**
+   * Returns the reads of a register which returned the same value as the
+   * previous read of that register, with no write to it in between, and which
+   * are not part of a read-poll loop.
+   */
+  std::vector<MmioAccess> RedundantReads() const;
+
+  /**
+   * Returns a human-readable summary of the trace: the number of reads and
+   * writes, the accesses per function, the read-poll loops and the redundant
+   * reads.
+   */
+  std::string Report() const;
+
+  /**
+   * Clears the accesses recorded so far.
+   */
+  void Clear() { accesses_.clear(); }
+
+  /**
+   * Records an access in the trace which is alive, if any.
+   *
+   * Called by the MMIO mocks.
+   */
+  static void Record(const MmioAccess &access);
+
+  /**
+   * Returns the name of the function containing `addr`, or its address if the
+   * name cannot be resolved.
+   */
+  static std::string FunctionName(const void *addr);
+
+ private:
+  static MmioTrace *active_;
+  std::vector<MmioAccess> accesses_;
+};
+}  // namespace mock_mmio
+
+#endif  // OPENTITAN_SW_DEVICE_LIB_BASE_MOCK_MMIO_TRACE_H_
@@ -4,16 +4,75 @@
 
 #include "sw/device/lib/base/random_order.h"
 
-#include "sw/device/lib/base/bitfield.h"
+#include "sw/device/lib/base/hardened.h"
+#include "sw/device/lib/base/macros.h"
 
-// TODO: The current implementation is just a skeleton, and currently just
-// traverses from 0 to `min_len * 2`.
+// TODO: The per-word order is just a skeleton, and currently just traverses
+// from 0 to `min_len * 2`.
 
 void random_order_init(random_order_t *ctx, size_t min_len) {
   ctx->state = 0;
   ctx->max = min_len * 2;
+  ctx->block_len = ctx->max;
+  ctx->num_blocks = 1;
+  ctx->block = 0;
+  ctx->stride = 0;
+}
+
+// The source of randomness for the orders, which may be replaced at link-time.
+// This default is NOT random, see `random_order.h`.
+OT_WEAK
+uint32_t random_order_random_word(void) { return 0x5a3c96e1; }
+
+/**
+ * Returns the greatest common divisor of `a` and `b`.
+ */
+static size_t gcd(size_t a, size_t b) {
+  while (b != 0) {
+    size_t r = a % b;
+    a = b;
+    b = r;
+  }
+  return a;
+}
+
+void random_order_init_blocks(random_order_t *ctx, size_t min_len,
+                              size_t block_len, size_t decoy_blocks) {
+  size_t num_blocks = (min_len + block_len - 1) / block_len + decoy_blocks;
+
+  // Visit the blocks in the order `first + i * step (mod num_blocks)`, which
+  // is a permutation as long as `step` is coprime with `num_blocks`. The
+  // search for such a step terminates at `num_blocks - 1` at the latest.
+  size_t first = 0;
+  size_t step = 0;
+  if (num_blocks > 1) {
+    first = random_order_random_word() % num_blocks;
+    step = 1 + random_order_random_word() % (num_blocks - 1);
+    while (gcd(step, num_blocks) != 1) {
+      ++step;
+    }
+  }
+
+  ctx->state = 0;
+  ctx->max = num_blocks * block_len;
+  ctx->block_len = block_len;
+  ctx->num_blocks = num_blocks;
+  ctx->block = first * block_len;
+  ctx->stride = step * block_len;
 }
 
 size_t random_order_len(const random_order_t *ctx) { return ctx->max; }
 
-size_t random_order_advance(random_order_t *ctx) { return ctx->state++; }
+size_t random_order_advance(random_order_t *ctx) {
+  size_t value = ctx->block + ctx->state;
+
+  // The block boundaries only depend on the number of steps taken so far, so
+  // this branch does not reveal the order; the step to the next block is
+  // computed in constant time.
+  if (++ctx->state == ctx->block_len) {
+    ctx->state = 0;
+    size_t next = ctx->block + ctx->stride;
+    ctx->block = ct_cmovw(ct_sltuw(next, ctx->max), next, next - ctx->max);
+  }
+  return value;
+}
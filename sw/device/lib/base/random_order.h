@@ -6,6 +6,7 @@
 #define OPENTITAN_SW_DEVICE_LIB_BASE_RANDOM_ORDER_H_
 
 #include <stddef.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -33,8 +34,28 @@ extern "C" {
  * intentionally adding decoys to the sequence.
  */
 typedef struct random_order {
+  /**
+   * The position within the current block of the next value.
+   */
   size_t state;
+  /**
+   * The length of the sequence.
+   */
   size_t max;
+  /**
+   * The number of consecutive values in each block, and the number of blocks.
+   *
+   * Orders constructed by `random_order_init()` consist of a single block.
+   */
+  size_t block_len;
+  size_t num_blocks;
+  /**
+   * The first value of the current block, and the distance to the first value
+   * of the next block, which is a multiple of `block_len` by a number coprime
+   * with `num_blocks`.
+   */
+  size_t block;
+  size_t stride;
 } random_order_t;
 
 /**
@@ -49,6 +70,50 @@ typedef struct random_order {
  */
 void random_order_init(random_order_t *ctx, size_t min_len);
 
+/**
+ * Constructs a new, randomly-seeded block traversal order, running from `0` to
+ * at least `min_len`.
+ *
+ * The sequence is split into blocks of `block_len` consecutive values, which
+ * are visited in a random order. Each block is walked sequentially, so that
+ * every step costs an increment, plus a constant-time modular step at block
+ * boundaries. `decoy_blocks` blocks beyond `min_len` are interleaved with the
+ * others, and provide the decoy indices.
+ *
+ * Larger blocks and fewer decoys are cheaper, since the per-block step is
+ * amortized over more values and fewer values are visited; smaller blocks and
+ * more decoys make the order harder to recover from a side-channel trace. A
+ * `block_len` of eight words, i.e. 32 bytes, is a reasonable default for
+ * large buffers such as flash pages and RSA key shares.
+ *
+ * The block order is drawn from `random_order_random_word()`, whose default
+ * is a constant; see the warning there.
+ *
+ * @param ctx The context to initialize.
+ * @param min_len The minimum length this traversal order must visit.
+ * @param block_len The number of consecutive values in each block; must be
+ * non-zero.
+ * @param decoy_blocks The number of blocks of decoy values.
+ */
+void random_order_init_blocks(random_order_t *ctx, size_t min_len,
+                              size_t block_len, size_t decoy_blocks);
+
+/**
+ * Returns a random word, used to seed the traversal orders.
+ *
+ * This is a weak symbol which may be replaced at link-time by a source of
+ * randomness.
+ *
+ * WARNING: The default implementation returns a constant. Unless a program
+ * links in a definition backed by real entropy (e.g. Ibex's RND_DATA), every
+ * order from `random_order_init_blocks()` is the same fixed permutation, which
+ * gives no protection against side-channel attacks. Code that needs an
+ * unpredictable order must override this function.
+ *
+ * @return A random word.
+ */
+uint32_t random_order_random_word(void);
+
 /**
  * Returns the length of the sequence represented by `ctx`.
  *
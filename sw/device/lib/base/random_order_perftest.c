@@ -0,0 +1,120 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "sw/device/lib/base/hardened.h"
+#include "sw/device/lib/base/macros.h"
+#include "sw/device/lib/base/memory.h"
+#include "sw/device/lib/base/random_order.h"
+#include "sw/device/lib/runtime/ibex.h"
+#include "sw/device/lib/runtime/log.h"
+#include "sw/device/lib/testing/test_framework/check.h"
+#include "sw/device/lib/testing/test_framework/ottf_main.h"
+
+enum {
+  // A flash page.
+  kBufWords = 4096 / sizeof(uint32_t),
+  kNumRuns = 10,
+};
+
+typedef struct perf_test {
+  // A human-readable name for this particular order.
+  const char *label;
+  // Block length and number of decoy blocks; a `block_len` of zero selects
+  // the per-word order.
+  size_t block_len;
+  size_t decoy_blocks;
+} perf_test_t;
+
+static const perf_test_t kPerfTests[] = {
+    {.label = "per-word", .block_len = 0},
+    {.label = "blocks of 4, 4 decoys", .block_len = 4, .decoy_blocks = 4},
+    {.label = "blocks of 8, 4 decoys", .block_len = 8, .decoy_blocks = 4},
+    {.label = "blocks of 8, 16 decoys", .block_len = 8, .decoy_blocks = 16},
+    {.label = "blocks of 32, 1 decoy", .block_len = 32, .decoy_blocks = 1},
+};
+
+static uint32_t src[kBufWords];
+static uint32_t dest[kBufWords];
+
+/**
+ * Copies `src` to `dest` in the given order, with the same per-step
+ * laundering and decoy selection as `hardened_memcpy()`.
+ */
+OT_NOINLINE static void ordered_copy(random_order_t *order) {
+  size_t count = 0;
+  size_t expected_count = random_order_len(order);
+  uintptr_t src_addr = (uintptr_t)src;
+  uintptr_t dest_addr = (uintptr_t)dest;
+  uint32_t decoys[8];
+  uintptr_t decoy_addr = (uintptr_t)&decoys;
+
+  for (; launderw(count) < expected_count; count = launderw(count) + 1) {
+    size_t byte_idx = launderw(random_order_advance(order)) * sizeof(uint32_t);
+    barrierw(byte_idx);
+    uintptr_t decoy = decoy_addr + (byte_idx % sizeof(decoys));
+    ct_boolw_t in_range = ct_sltuw(launderw(byte_idx), sizeof(src));
+    void *srcp =
+        (void *)launderw(ct_cmovw(in_range, src_addr + byte_idx, decoy));
+    void *destp =
+        (void *)launderw(ct_cmovw(in_range, dest_addr + byte_idx, decoy));
+    write_32(read_32(srcp), destp);
+  }
+  HARDENED_CHECK_EQ(count, expected_count);
+}
+
+// Run the given `perf_test_t` and return the number of cycles it took,
+// including the construction of the order.
+static uint64_t perf_test_run(const perf_test_t *test) {
+  uint64_t total_clock_cycles = 0;
+  for (size_t i = 0; i < kNumRuns; ++i) {
+    memset(dest, 0, sizeof(dest));
+
+    uint64_t start_cycles = ibex_mcycle_read();
+    random_order_t order;
+    if (test->block_len == 0) {
+      random_order_init(&order, kBufWords);
+    } else {
+      random_order_init_blocks(&order, kBufWords, test->block_len,
+                               test->decoy_blocks);
+    }
+    ordered_copy(&order);
+    uint64_t end_cycles = ibex_mcycle_read();
+    total_clock_cycles += end_cycles - start_cycles;
+
+    CHECK_ARRAYS_EQ(dest, src, kBufWords);
+  }
+  return total_clock_cycles;
+}
+
+OTTF_DEFINE_TEST_CONFIG();
+
+// Reports the cycle count of a hardened copy of a flash page in the per-word
+// order and in a few block orders. The test fails only if a block order is
+// slower than the per-word order, which visits twice as many indices.
+bool test_main(void) {
+  for (size_t i = 0; i < kBufWords; ++i) {
+    src[i] = 0x9e3779b9 * (i + 1);
+  }
+
+  uint64_t num_cycles[ARRAYSIZE(kPerfTests)];
+  bool all_expectations_match = true;
+  for (size_t i = 0; i < ARRAYSIZE(kPerfTests); ++i) {
+    num_cycles[i] = perf_test_run(&kPerfTests[i]);
+    // Cast cycle counts to `uint32_t` before printing because `base_printf()`
+    // cannot print `uint64_t`.
+    CHECK(num_cycles[i] < UINT32_MAX);
+    LOG_INFO("%s: %d cycles per %d words", kPerfTests[i].label,
+             (uint32_t)(num_cycles[i] / kNumRuns), kBufWords);
+    if (i > 0 && num_cycles[i] > num_cycles[0]) {
+      LOG_WARNING("%s is slower than %s", kPerfTests[i].label,
+                  kPerfTests[0].label);
+      all_expectations_match = false;
+    }
+  }
+  return all_expectations_match;
+}
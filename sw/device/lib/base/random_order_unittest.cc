@@ -0,0 +1,93 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "sw/device/lib/base/random_order.h"
+
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace random_order_unittest {
+namespace {
+
+using ::testing::Each;
+
+// Override the default randomness source, so that each order is seeded
+// differently.
+uint32_t rng_state = 1;
+extern "C" uint32_t random_order_random_word() {
+  rng_state ^= rng_state << 13;
+  rng_state ^= rng_state >> 17;
+  rng_state ^= rng_state << 5;
+  return rng_state;
+}
+
+/**
+ * Walks `order` and returns the number of times each value was visited.
+ */
+std::vector<size_t> Visits(random_order_t *order) {
+  std::vector<size_t> visits(random_order_len(order));
+  for (size_t i = 0; i < visits.size(); ++i) {
+    size_t value = random_order_advance(order);
+    EXPECT_LT(value, visits.size());
+    if (value < visits.size()) {
+      ++visits[value];
+    }
+  }
+  return visits;
+}
+
+TEST(RandomOrder, PerWord) {
+  random_order_t order;
+  random_order_init(&order, 13);
+  EXPECT_GE(random_order_len(&order), 13);
+  EXPECT_THAT(Visits(&order), Each(1));
+}
+
+class RandomOrderBlocksTest
+    : public testing::TestWithParam<std::tuple<size_t, size_t, size_t>> {};
+
+TEST_P(RandomOrderBlocksTest, VisitsEachValueOnce) {
+  size_t min_len = std::get<0>(GetParam());
+  size_t block_len = std::get<1>(GetParam());
+  size_t decoy_blocks = std::get<2>(GetParam());
+  size_t num_blocks = (min_len + block_len - 1) / block_len + decoy_blocks;
+
+  for (size_t seed = 0; seed < 32; ++seed) {
+    random_order_t order;
+    random_order_init_blocks(&order, min_len, block_len, decoy_blocks);
+    EXPECT_EQ(random_order_len(&order), num_blocks * block_len);
+    EXPECT_THAT(Visits(&order), Each(1));
+  }
+}
+
+TEST_P(RandomOrderBlocksTest, WalksBlocksSequentially) {
+  size_t min_len = std::get<0>(GetParam());
+  size_t block_len = std::get<1>(GetParam());
+  size_t decoy_blocks = std::get<2>(GetParam());
+
+  random_order_t order;
+  random_order_init_blocks(&order, min_len, block_len, decoy_blocks);
+  for (size_t i = 0; i < random_order_len(&order); i += block_len) {
+    size_t first = random_order_advance(&order);
+    EXPECT_EQ(first % block_len, 0);
+    for (size_t j = 1; j < block_len; ++j) {
+      EXPECT_EQ(random_order_advance(&order), first + j);
+    }
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(AllSizes, RandomOrderBlocksTest,
+                         testing::Values(std::make_tuple(0, 8, 0),
+                                         std::make_tuple(0, 8, 1),
+                                         std::make_tuple(1, 1, 0),
+                                         std::make_tuple(13, 1, 3),
+                                         std::make_tuple(128, 8, 1),
+                                         std::make_tuple(1024, 8, 4),
+                                         std::make_tuple(1000, 16, 6),
+                                         std::make_tuple(60, 4, 0)));
+
+}  // namespace
+}  // namespace random_order_unittest
@@ -9,6 +9,7 @@
 #include "sw/device/lib/base/hardened.h"
 #include "sw/device/lib/base/macros.h"
 #include "sw/device/lib/base/memory.h"
+#include "sw/device/lib/crypto/drivers/clkmgr.h"
 #include "sw/device/lib/crypto/drivers/entropy.h"
 #include "sw/device/lib/crypto/impl/status.h"
 
@@ -26,6 +27,13 @@ enum {
   kAesKeyWordLen256 = 256 / (sizeof(uint32_t) * 8),
 };
 
+/**
+ * Keeps the AES clock running from `aes_begin()` to `aes_end()`.
+ */
+static clkmgr_hold_t clock_hold = {
+    .clock = kClkmgrClockAes,
+};
+
 /**
  * Spins until the AES hardware reports a specific status bit.
  */
@@ -98,6 +106,8 @@ static status_t aes_begin(aes_key_t key, const aes_block_t *iv,
   // its PRNG from EDN for masking every time a new key is provided.
   HARDENED_TRY(entropy_complex_check());
 
+  clkmgr_hold_acquire(&clock_hold);
+
   // Wait for the AES block to be idle.
   HARDENED_TRY(spin_until(AES_STATUS_IDLE_BIT));
 
@@ -247,6 +257,8 @@ status_t aes_decrypt_begin(const aes_key_t key, const aes_block_t *iv) {
 }
 
 status_t aes_update(aes_block_t *dest, const aes_block_t *src) {
+  clkmgr_hold_acquire(&clock_hold);
+
   if (dest != NULL) {
     // Check that either the output is valid or AES is busy, to avoid spinning
     // forever if the user passes a non-null `dest` when there is no output
@@ -278,6 +290,8 @@ status_t aes_update(aes_block_t *dest, const aes_block_t *src) {
 }
 
 status_t aes_end(aes_block_t *iv) {
+  clkmgr_hold_acquire(&clock_hold);
+
   uint32_t ctrl_reg = AES_CTRL_SHADOWED_REG_RESVAL;
   ctrl_reg = bitfield_bit32_write(ctrl_reg,
                                   AES_CTRL_SHADOWED_MANUAL_OPERATION_BIT, true);
@@ -298,5 +312,7 @@ status_t aes_end(aes_block_t *iv) {
       bitfield_bit32_write(trigger_reg, AES_TRIGGER_DATA_OUT_CLEAR_BIT, true);
   abs_mmio_write32(kBase + AES_TRIGGER_REG_OFFSET, trigger_reg);
 
-  return spin_until(AES_STATUS_IDLE_BIT);
+  status_t result = spin_until(AES_STATUS_IDLE_BIT);
+  clkmgr_hold_release(&clock_hold);
+  return result;
 }
@@ -0,0 +1,91 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "sw/device/lib/crypto/drivers/clkmgr.h"
+
+#include "sw/device/lib/base/abs_mmio.h"
+#include "sw/device/lib/base/bitfield.h"
+#include "sw/device/lib/base/macros.h"
+
+#include "clkmgr_regs.h"  // Generated.
+#include "hw/top_earlgrey/sw/autogen/top_earlgrey.h"
+
+OT_ASSERT_ENUM_VALUE(kClkmgrClockAes, CLKMGR_CLK_HINTS_CLK_MAIN_AES_HINT_BIT);
+OT_ASSERT_ENUM_VALUE(kClkmgrClockHmac, CLKMGR_CLK_HINTS_CLK_MAIN_HMAC_HINT_BIT);
+OT_ASSERT_ENUM_VALUE(kClkmgrClockKmac, CLKMGR_CLK_HINTS_CLK_MAIN_KMAC_HINT_BIT);
+OT_ASSERT_ENUM_VALUE(kClkmgrClockOtbn, CLKMGR_CLK_HINTS_CLK_MAIN_OTBN_HINT_BIT);
+OT_ASSERT_ENUM_VALUE(kClkmgrClockAes,
+                     CLKMGR_CLK_HINTS_STATUS_CLK_MAIN_AES_VAL_BIT);
+OT_ASSERT_ENUM_VALUE(kClkmgrClockHmac,
+                     CLKMGR_CLK_HINTS_STATUS_CLK_MAIN_HMAC_VAL_BIT);
+OT_ASSERT_ENUM_VALUE(kClkmgrClockKmac,
+                     CLKMGR_CLK_HINTS_STATUS_CLK_MAIN_KMAC_VAL_BIT);
+OT_ASSERT_ENUM_VALUE(kClkmgrClockOtbn,
+                     CLKMGR_CLK_HINTS_STATUS_CLK_MAIN_OTBN_VAL_BIT);
+
+enum {
+  /**
+   * Base address for the clock manager.
+   */
+  kBase = TOP_EARLGREY_CLKMGR_AON_BASE_ADDR,
+};
+
+/**
+ * Reference counts of the hintable clocks.
+ */
+static struct {
+  /**
+   * Number of outstanding `clkmgr_clock_acquire()` calls.
+   */
+  uint32_t count;
+  /**
+   * Whether the first of them set the hint, which must then be dropped again.
+   */
+  bool restore;
+} clocks[kClkmgrClockCount];
+
+void clkmgr_clock_acquire(clkmgr_clock_t clock) {
+  if (clocks[clock].count++ != 0) {
+    return;
+  }
+  uint32_t hints = abs_mmio_read32(kBase + CLKMGR_CLK_HINTS_REG_OFFSET);
+  clocks[clock].restore = !bitfield_bit32_read(hints, clock);
+  if (!clocks[clock].restore) {
+    return;
+  }
+  abs_mmio_write32(kBase + CLKMGR_CLK_HINTS_REG_OFFSET,
+                   bitfield_bit32_write(hints, clock, true));
+
+  // The hint is honored right away, but the clock only runs again a few cycles
+  // later, once the hint has crossed into the block's clock domain.
+  uint32_t status;
+  do {
+    status = abs_mmio_read32(kBase + CLKMGR_CLK_HINTS_STATUS_REG_OFFSET);
+  } while (!bitfield_bit32_read(status, clock));
+}
+
+void clkmgr_clock_release(clkmgr_clock_t clock) {
+  if (clocks[clock].count == 0 || --clocks[clock].count != 0 ||
+      !clocks[clock].restore) {
+    return;
+  }
+  // The clock manager keeps the clock running until the block is idle.
+  uint32_t hints = abs_mmio_read32(kBase + CLKMGR_CLK_HINTS_REG_OFFSET);
+  abs_mmio_write32(kBase + CLKMGR_CLK_HINTS_REG_OFFSET,
+                   bitfield_bit32_write(hints, clock, false));
+}
+
+void clkmgr_hold_acquire(clkmgr_hold_t *hold) {
+  if (!hold->held) {
+    clkmgr_clock_acquire(hold->clock);
+    hold->held = true;
+  }
+}
+
+void clkmgr_hold_release(clkmgr_hold_t *hold) {
+  if (hold->held) {
+    hold->held = false;
+    clkmgr_clock_release(hold->clock);
+  }
+}
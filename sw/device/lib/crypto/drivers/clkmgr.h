@@ -0,0 +1,92 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef OPENTITAN_SW_DEVICE_LIB_CRYPTO_DRIVERS_CLKMGR_H_
+#define OPENTITAN_SW_DEVICE_LIB_CRYPTO_DRIVERS_CLKMGR_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Hintable clocks of the crypto blocks.
+ *
+ * The values are the bit positions in the clock manager's `CLK_HINTS` and
+ * `CLK_HINTS_STATUS` registers.
+ */
+typedef enum clkmgr_clock {
+  kClkmgrClockAes = 0,
+  kClkmgrClockHmac = 1,
+  kClkmgrClockKmac = 2,
+  kClkmgrClockOtbn = 3,
+  kClkmgrClockCount = 4,
+} clkmgr_clock_t;
+
+/**
+ * Keeps the clock of a crypto block running.
+ *
+ * The clock manager only gates the clock of an idle block once software has
+ * dropped the block's hint, and a gated block hangs on any register access.
+ * The drivers therefore acquire the clock around register accesses. Calls are
+ * reference counted: the first one sets the hint if software has dropped it
+ * and waits until the clock is running again, and the matching
+ * `clkmgr_clock_release()` drops the hint again.
+ *
+ * Hints that are set (as after reset) are left alone, so the blocks are only
+ * gated between operations once the application has dropped their hints, e.g.
+ * with `dif_clkmgr_hintable_clock_set_hint()`. Other software that accesses a
+ * block whose hint was dropped must set the hint itself.
+ *
+ * @param clock The clock to acquire.
+ */
+void clkmgr_clock_acquire(clkmgr_clock_t clock);
+
+/**
+ * Releases a clock acquired with `clkmgr_clock_acquire()`.
+ *
+ * @param clock The clock to release.
+ */
+void clkmgr_clock_release(clkmgr_clock_t clock);
+
+/**
+ * A clock acquired for the duration of an operation that spans several driver
+ * calls, such as an AES or KMAC stream.
+ *
+ * Unlike `clkmgr_clock_acquire()`, acquiring a hold is idempotent, so an
+ * operation that is abandoned after an error keeps the clock only until the
+ * next one completes.
+ */
+typedef struct clkmgr_hold {
+  /**
+   * The clock to hold.
+   */
+  clkmgr_clock_t clock;
+  /**
+   * Whether the hold currently has the clock acquired.
+   */
+  bool held;
+} clkmgr_hold_t;
+
+/**
+ * Acquires the clock of a hold, unless it already has it.
+ *
+ * @param hold The hold.
+ */
+void clkmgr_hold_acquire(clkmgr_hold_t *hold);
+
+/**
+ * Releases the clock of a hold, if it has it.
+ *
+ * @param hold The hold.
+ */
+void clkmgr_hold_release(clkmgr_hold_t *hold);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // OPENTITAN_SW_DEVICE_LIB_CRYPTO_DRIVERS_CLKMGR_H_
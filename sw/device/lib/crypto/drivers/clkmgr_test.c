@@ -0,0 +1,215 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "sw/device/lib/crypto/drivers/clkmgr.h"
+
+#include "sw/device/lib/base/memory.h"
+#include "sw/device/lib/base/mmio.h"
+#include "sw/device/lib/crypto/drivers/aes.h"
+#include "sw/device/lib/crypto/drivers/entropy.h"
+#include "sw/device/lib/crypto/drivers/hmac.h"
+#include "sw/device/lib/crypto/drivers/kmac.h"
+#include "sw/device/lib/crypto/drivers/otbn.h"
+#include "sw/device/lib/crypto/impl/status.h"
+#include "sw/device/lib/dif/dif_clkmgr.h"
+#include "sw/device/lib/runtime/ibex.h"
+#include "sw/device/lib/runtime/log.h"
+#include "sw/device/lib/testing/test_framework/check.h"
+#include "sw/device/lib/testing/test_framework/ottf_main.h"
+
+#include "hw/top_earlgrey/sw/autogen/top_earlgrey.h"
+
+OTTF_DEFINE_TEST_CONFIG();
+
+enum {
+  /**
+   * Number of polls of `CLK_HINTS_STATUS` before giving up on a clock being
+   * gated.
+   */
+  kGatePollMax = 1000,
+  /**
+   * Number of words of the OTBN DMEM round trip.
+   */
+  kOtbnWords = 16,
+};
+
+static dif_clkmgr_t clkmgr;
+
+static const uint8_t kMessage[] = "Clock gating of the crypto blocks";
+
+static const uint32_t kKeyShare0[8] = {0x16157e2b, 0xa6d2ae28, 0x8815f7ab,
+                                       0x3c4fcf09};
+static const uint32_t kKeyShare1[8] = {0};
+
+static const aes_block_t kPlaintext = {
+    .data = {0xe2bec16b, 0x969f402e, 0x117e3de9, 0x2a179373},
+};
+
+/**
+ * Outputs of one round of operations on all crypto blocks.
+ */
+typedef struct outputs {
+  aes_block_t aes;
+  uint32_t hmac[8];
+  uint32_t kmac[kSha3_256DigestWords];
+  uint32_t otbn[kOtbnWords];
+} outputs_t;
+
+static status_t aes_op(outputs_t *out) {
+  aes_key_t key = {
+      .mode = kAesCipherModeEcb,
+      .sideload = kHardenedBoolFalse,
+      .key_len = 4,
+      .key_shares = {kKeyShare0, kKeyShare1},
+  };
+  TRY(aes_encrypt_begin(key, NULL));
+  TRY(aes_update(NULL, &kPlaintext));
+  TRY(aes_update(&out->aes, NULL));
+  return aes_end(NULL);
+}
+
+static status_t hmac_op(outputs_t *out) {
+  return hmac(kHmacModeSha256, NULL, 0, kMessage, sizeof(kMessage), out->hmac,
+              ARRAYSIZE(out->hmac));
+}
+
+static status_t kmac_op(outputs_t *out) {
+  return kmac_sha3_256(kMessage, sizeof(kMessage), out->kmac);
+}
+
+static status_t otbn_op(outputs_t *out) {
+  uint32_t data[kOtbnWords];
+  for (size_t i = 0; i < ARRAYSIZE(data); ++i) {
+    data[i] = 0x01010101 * i;
+  }
+  TRY(otbn_dmem_write(ARRAYSIZE(data), data, 0));
+  TRY(otbn_dmem_read(ARRAYSIZE(data), 0, out->otbn));
+  return otbn_dmem_sec_wipe();
+}
+
+typedef struct crypto_op {
+  const char *name;
+  clkmgr_clock_t clock;
+  status_t (*run)(outputs_t *out);
+} crypto_op_t;
+
+static const crypto_op_t kOps[] = {
+    {"aes", kClkmgrClockAes, aes_op},
+    {"hmac", kClkmgrClockHmac, hmac_op},
+    {"kmac", kClkmgrClockKmac, kmac_op},
+    {"otbn", kClkmgrClockOtbn, otbn_op},
+};
+
+static void hint_set(clkmgr_clock_t clock, dif_toggle_t state) {
+  CHECK_DIF_OK(dif_clkmgr_hintable_clock_set_hint(&clkmgr, clock, state));
+}
+
+static dif_toggle_t hint_get(clkmgr_clock_t clock) {
+  dif_toggle_t state;
+  CHECK_DIF_OK(dif_clkmgr_hintable_clock_get_hint(&clkmgr, clock, &state));
+  return state;
+}
+
+/**
+ * Waits for the clock manager to gate an idle clock.
+ */
+static status_t wait_for_gated(clkmgr_clock_t clock) {
+  for (size_t i = 0; i < kGatePollMax; ++i) {
+    dif_toggle_t state;
+    TRY(dif_clkmgr_hintable_clock_get_enabled(&clkmgr, clock, &state));
+    if (state == kDifToggleDisabled) {
+      return OK_STATUS();
+    }
+  }
+  return DEADLINE_EXCEEDED();
+}
+
+/**
+ * Runs an operation and returns the number of cycles it took.
+ */
+static status_t run_measured(const crypto_op_t *op, outputs_t *out,
+                             uint64_t *cycles) {
+  uint64_t start = ibex_mcycle_read();
+  TRY(op->run(out));
+  *cycles = ibex_mcycle_read() - start;
+  return OK_STATUS();
+}
+
+/**
+ * Checks that an operation restores the hint it found and that it gives the
+ * same result with a gated clock.
+ */
+static status_t run_op_test(const crypto_op_t *op) {
+  outputs_t expected, actual;
+  memset(&expected, 0, sizeof(expected));
+  memset(&actual, 0, sizeof(actual));
+
+  // With the hint set, the drivers leave the clock alone.
+  hint_set(op->clock, kDifToggleEnabled);
+  uint64_t clocked;
+  TRY(run_measured(op, &expected, &clocked));
+  TRY_CHECK(hint_get(op->clock) == kDifToggleEnabled);
+
+  // With the hint dropped, the drivers wake the clock up and let it be gated
+  // again afterwards.
+  hint_set(op->clock, kDifToggleDisabled);
+  TRY(wait_for_gated(op->clock));
+  uint64_t gated;
+  TRY(run_measured(op, &actual, &gated));
+  TRY_CHECK(hint_get(op->clock) == kDifToggleDisabled);
+  TRY(wait_for_gated(op->clock));
+  TRY_CHECK_ARRAYS_EQ((uint8_t *)&actual, (uint8_t *)&expected,
+                      sizeof(actual));
+
+  LOG_INFO("%s: %u cycles clocked, %u cycles from gated (%d)", op->name,
+           (uint32_t)clocked, (uint32_t)gated, (int32_t)(gated - clocked));
+  return OK_STATUS();
+}
+
+/**
+ * Checks that nested acquisitions keep the clock until the last release.
+ */
+static status_t run_nesting_test(void) {
+  hint_set(kClkmgrClockAes, kDifToggleDisabled);
+  clkmgr_clock_acquire(kClkmgrClockAes);
+  clkmgr_clock_acquire(kClkmgrClockAes);
+  TRY_CHECK(hint_get(kClkmgrClockAes) == kDifToggleEnabled);
+  clkmgr_clock_release(kClkmgrClockAes);
+  TRY_CHECK(hint_get(kClkmgrClockAes) == kDifToggleEnabled);
+  clkmgr_clock_release(kClkmgrClockAes);
+  TRY_CHECK(hint_get(kClkmgrClockAes) == kDifToggleDisabled);
+
+  // A hold is only counted once.
+  clkmgr_hold_t hold = {.clock = kClkmgrClockAes};
+  clkmgr_hold_acquire(&hold);
+  clkmgr_hold_acquire(&hold);
+  clkmgr_hold_release(&hold);
+  TRY_CHECK(hint_get(kClkmgrClockAes) == kDifToggleDisabled);
+  clkmgr_hold_release(&hold);
+  TRY_CHECK(hint_get(kClkmgrClockAes) == kDifToggleDisabled);
+  return OK_STATUS();
+}
+
+bool test_main(void) {
+  CHECK_DIF_OK(dif_clkmgr_init(
+      mmio_region_from_addr(TOP_EARLGREY_CLKMGR_AON_BASE_ADDR), &clkmgr));
+  CHECK_STATUS_OK(entropy_complex_init());
+  CHECK_STATUS_OK(kmac_hwip_default_configure());
+
+  status_t result = OK_STATUS();
+  EXECUTE_TEST(result, run_nesting_test);
+  for (size_t i = 0; i < ARRAYSIZE(kOps); ++i) {
+    status_t op_result = run_op_test(&kOps[i]);
+    if (!status_ok(op_result)) {
+      LOG_ERROR("%s failed: %r", kOps[i].name, op_result);
+      result = op_result;
+    }
+  }
+
+  // Leave all clocks running for the rest of the boot.
+  for (size_t i = 0; i < ARRAYSIZE(kOps); ++i) {
+    hint_set(kOps[i].clock, kDifToggleEnabled);
+  }
+  return status_ok(result);
+}
@@ -0,0 +1,121 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "sw/device/lib/crypto/drivers/dma.h"
+
+#include "sw/device/lib/base/abs_mmio.h"
+#include "sw/device/lib/base/bitfield.h"
+#include "sw/device/lib/base/memory.h"
+
+#ifdef OTCRYPTO_HAS_DMA
+#include "dma_regs.h"  // Generated.
+#endif
+
+// Module ID for status codes.
+#define MODULE_ID MAKE_MODULE_ID('d', 'd', 'm')
+
+/**
+ * DMA feeding configuration; `base_addr` is only valid if `enabled`.
+ */
+static struct {
+  hardened_bool_t enabled;
+  uint32_t base_addr;
+  size_t min_len;
+} dma_feed = {
+    .enabled = kHardenedBoolFalse,
+};
+
+#ifdef OTCRYPTO_HAS_DMA
+
+status_t dma_feed_enable(uint32_t dma_base_addr, size_t min_len) {
+  if (min_len == 0) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+  dma_feed.base_addr = dma_base_addr;
+  dma_feed.min_len = min_len;
+  dma_feed.enabled = kHardenedBoolTrue;
+  return OTCRYPTO_OK;
+}
+
+status_t dma_feed_fifo(const uint8_t *data, size_t len, uint32_t fifo_addr) {
+  if (launder32(dma_feed.enabled) != kHardenedBoolTrue ||
+      misalignment32_of((uintptr_t)data) != 0 ||
+      len % sizeof(uint32_t) != 0) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+  HARDENED_CHECK_EQ(dma_feed.enabled, kHardenedBoolTrue);
+  uint32_t base = dma_feed.base_addr;
+
+  // Read the buffer word by word and write every word to the FIFO address.
+  abs_mmio_write32(base + DMA_SRC_ADDR_LO_REG_OFFSET, (uint32_t)(uintptr_t)data);
+  abs_mmio_write32(base + DMA_SRC_ADDR_HI_REG_OFFSET, 0);
+  abs_mmio_write32(base + DMA_DST_ADDR_LO_REG_OFFSET, fifo_addr);
+  abs_mmio_write32(base + DMA_DST_ADDR_HI_REG_OFFSET, 0);
+  abs_mmio_write32(base + DMA_SRC_CONFIG_REG_OFFSET,
+                   bitfield_bit32_write(0, DMA_SRC_CONFIG_INCREMENT_BIT, true));
+  abs_mmio_write32(base + DMA_DST_CONFIG_REG_OFFSET,
+                   bitfield_bit32_write(0, DMA_DST_CONFIG_INCREMENT_BIT, false));
+
+  uint32_t asid_reg = 0;
+  asid_reg = bitfield_field32_write(asid_reg, DMA_ADDR_SPACE_ID_SRC_ASID_FIELD,
+                                    DMA_ADDR_SPACE_ID_SRC_ASID_VALUE_OT_ADDR);
+  asid_reg = bitfield_field32_write(asid_reg, DMA_ADDR_SPACE_ID_DST_ASID_FIELD,
+                                    DMA_ADDR_SPACE_ID_DST_ASID_VALUE_OT_ADDR);
+  abs_mmio_write32(base + DMA_ADDR_SPACE_ID_REG_OFFSET, asid_reg);
+
+  abs_mmio_write32(base + DMA_CHUNK_DATA_SIZE_REG_OFFSET, len);
+  abs_mmio_write32(base + DMA_TOTAL_DATA_SIZE_REG_OFFSET, len);
+  abs_mmio_write32(base + DMA_TRANSFER_WIDTH_REG_OFFSET,
+                   DMA_TRANSFER_WIDTH_TRANSACTION_WIDTH_VALUE_FOUR_BYTE);
+
+  uint32_t ctrl_reg = 0;
+  ctrl_reg = bitfield_field32_write(ctrl_reg, DMA_CONTROL_OPCODE_FIELD,
+                                    DMA_CONTROL_OPCODE_VALUE_COPY);
+  ctrl_reg = bitfield_bit32_write(ctrl_reg, DMA_CONTROL_INITIAL_TRANSFER_BIT,
+                                  true);
+  ctrl_reg = bitfield_bit32_write(ctrl_reg, DMA_CONTROL_GO_BIT, true);
+  abs_mmio_write32(base + DMA_CONTROL_REG_OFFSET, ctrl_reg);
+
+  // Wait for the transfer to finish. The FIFOs stall the DMA controller while
+  // they are full, so this takes about as long as the hash itself.
+  uint32_t status_reg;
+  do {
+    status_reg = abs_mmio_read32(base + DMA_STATUS_REG_OFFSET);
+  } while (!bitfield_bit32_read(status_reg, DMA_STATUS_DONE_BIT) &&
+           !bitfield_bit32_read(status_reg, DMA_STATUS_ERROR_BIT) &&
+           !bitfield_bit32_read(status_reg, DMA_STATUS_ABORTED_BIT));
+
+  // Clear the status bits, which are rw1c.
+  abs_mmio_write32(base + DMA_STATUS_REG_OFFSET, status_reg);
+
+  // A failed transfer leaves an unknown part of the message in the FIFO, so
+  // the operation cannot be continued.
+  if (bitfield_bit32_read(status_reg, DMA_STATUS_ERROR_BIT) ||
+      bitfield_bit32_read(status_reg, DMA_STATUS_ABORTED_BIT)) {
+    return OTCRYPTO_FATAL_ERR;
+  }
+  return OTCRYPTO_OK;
+}
+
+#else  // OTCRYPTO_HAS_DMA
+
+status_t dma_feed_enable(uint32_t dma_base_addr, size_t min_len) {
+  return OTCRYPTO_NOT_IMPLEMENTED;
+}
+
+status_t dma_feed_fifo(const uint8_t *data, size_t len, uint32_t fifo_addr) {
+  return OTCRYPTO_NOT_IMPLEMENTED;
+}
+
+#endif  // OTCRYPTO_HAS_DMA
+
+void dma_feed_disable(void) { dma_feed.enabled = kHardenedBoolFalse; }
+
+hardened_bool_t dma_feed_applicable(size_t len) {
+  if (dma_feed.enabled == kHardenedBoolTrue && len != 0 &&
+      len >= dma_feed.min_len) {
+    return kHardenedBoolTrue;
+  }
+  return kHardenedBoolFalse;
+}
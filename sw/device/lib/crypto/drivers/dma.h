@@ -0,0 +1,70 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef OPENTITAN_SW_DEVICE_LIB_CRYPTO_DRIVERS_DMA_H_
+#define OPENTITAN_SW_DEVICE_LIB_CRYPTO_DRIVERS_DMA_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "sw/device/lib/base/hardened.h"
+#include "sw/device/lib/crypto/impl/status.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Enables feeding message FIFOs with the DMA controller.
+ *
+ * Once enabled, the HMAC and KMAC drivers hand the word-aligned part of every
+ * message of at least `min_len` bytes to the DMA controller, which copies it
+ * into the message FIFO while Ibex waits. The FIFOs back-pressure the bus, so
+ * no handshake is needed. Shorter messages are still written by Ibex.
+ *
+ * The caller is responsible for the DMA-enabled memory range: it must cover
+ * the message buffers and the message FIFOs. The DMA controller must not be
+ * used by other software while the crypto drivers may be running.
+ *
+ * Only available on tops with a DMA controller; elsewhere this returns
+ * `OTCRYPTO_NOT_IMPLEMENTED`.
+ *
+ * @param dma_base_addr Base address of the DMA controller.
+ * @param min_len Minimum message length in bytes for using the DMA.
+ * @return Result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+status_t dma_feed_enable(uint32_t dma_base_addr, size_t min_len);
+
+/**
+ * Disables DMA feeding; all messages are written by Ibex again.
+ */
+void dma_feed_disable(void);
+
+/**
+ * Checks whether a message should be fed by the DMA controller.
+ *
+ * @param len Length of the word-aligned part of the message in bytes.
+ * @return `kHardenedBoolTrue` if `dma_feed_fifo()` should be used.
+ */
+hardened_bool_t dma_feed_applicable(size_t len);
+
+/**
+ * Copies a word-aligned buffer into a message FIFO with the DMA controller.
+ *
+ * Blocks until the DMA controller is done.
+ *
+ * @param data Source buffer, which must be word-aligned.
+ * @param len Length of the buffer in bytes; a multiple of the word size.
+ * @param fifo_addr Address of the message FIFO.
+ * @return Result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+status_t dma_feed_fifo(const uint8_t *data, size_t len, uint32_t fifo_addr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // OPENTITAN_SW_DEVICE_LIB_CRYPTO_DRIVERS_DMA_H_
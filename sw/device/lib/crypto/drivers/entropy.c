@@ -827,22 +827,348 @@ static status_t edn_check(const edn_config_t *config) {
   return OTCRYPTO_RECOV_ERR;
 }
 
-status_t entropy_complex_init(void) {
+enum {
+  /**
+   * Pool level, in words, below which a refill is started.
+   */
+  kEntropyPoolLowWatermarkWords = kEntropyPoolNumWords / 2,
+};
+static_assert((kEntropyPoolNumWords & (kEntropyPoolNumWords - 1)) == 0,
+              "kEntropyPoolNumWords must be a power of two.");
+static_assert(kEntropyPoolNumWords % kEntropyCsrngBitsBufferNumWords == 0,
+              "kEntropyPoolNumWords must be a multiple of the block size.");
+static_assert(kEntropyPoolMaxRequestWords <= kEntropyPoolNumWords,
+              "kEntropyPoolMaxRequestWords must fit in the pool.");
+
+/**
+ * Buffered output of the SW CSRNG instance.
+ *
+ * `words` is a ring buffer: `count` words starting at `head` are ready to be
+ * served, followed by `staged` words received so far from the refill in
+ * progress. Staged words join the pool only once CSRNG reports the generate
+ * command as done.
+ */
+typedef struct entropy_pool {
+  uint32_t words[kEntropyPoolNumWords];
+  size_t head;
+  size_t count;
+  size_t staged;
+  /**
+   * Number of blocks of the refill in progress still to be read.
+   */
+  size_t pending_blocks;
+  /**
+   * Whether a refill generate command has been issued and not yet completed.
+   */
+  hardened_bool_t refilling;
+  /**
+   * Whether all blocks of the refill in progress are FIPS-compatible.
+   */
+  hardened_bool_t staged_fips;
+  /**
+   * Whether the last refill was discarded. Background refills are not
+   * restarted until the DRBG state changes or a refill succeeds.
+   */
+  hardened_bool_t refill_failed;
+  /**
+   * Whether `entropy_pool_generate()` uses the pool.
+   */
+  hardened_bool_t enabled;
+} entropy_pool_t;
+
+static entropy_pool_t pool = {
+    .refilling = kHardenedBoolFalse,
+    .staged_fips = kHardenedBoolFalse,
+    .refill_failed = kHardenedBoolFalse,
+    .enabled = kHardenedBoolFalse,
+};
+
+/**
+ * Whether a generate command issued by `entropy_csrng_generate_start()` still
+ * has output to be read by `entropy_csrng_generate_data_get()`.
+ *
+ * The pool does not start refills while this is set, since CSRNG would only
+ * run the refill once the caller's output has been read.
+ */
+static hardened_bool_t csrng_generate_pending = kHardenedBoolFalse;
+
+/**
+ * Enables or disables CSRNG's `cs_cmd_req_done` interrupt.
+ *
+ * @param enable Whether to enable the interrupt.
+ */
+static void csrng_irq_cmd_req_done_enable(bool enable) {
+  uint32_t reg = abs_mmio_read32(kBaseCsrng + CSRNG_INTR_ENABLE_REG_OFFSET);
+  reg = bitfield_bit32_write(reg, CSRNG_INTR_COMMON_CS_CMD_REQ_DONE_BIT,
+                             enable);
+  abs_mmio_write32(kBaseCsrng + CSRNG_INTR_ENABLE_REG_OFFSET, reg);
+}
+
+/**
+ * Clears CSRNG's `cs_cmd_req_done` interrupt state bit.
+ */
+static void csrng_irq_cmd_req_done_acknowledge(void) {
+  abs_mmio_write32(
+      kBaseCsrng + CSRNG_INTR_STATE_REG_OFFSET,
+      bitfield_bit32_write(0, CSRNG_INTR_STATE_CS_CMD_REQ_DONE_BIT, true));
+}
+
+/**
+ * Returns the index in `pool.words` of the word `offset` words after the head.
+ */
+static size_t entropy_pool_index(size_t offset) {
+  return (pool.head + offset) & (kEntropyPoolNumWords - 1);
+}
+
+/**
+ * Zeroes `len` words of the pool, starting `offset` words after the head.
+ */
+static void entropy_pool_wipe(size_t offset, size_t len) {
+  for (size_t i = 0; i < len; ++i) {
+    pool.words[entropy_pool_index(offset + i)] = 0;
+  }
+}
+
+/**
+ * Starts refilling the free space of the pool.
+ *
+ * Issues a generate command for as many blocks as fit, without waiting for the
+ * output, and enables the `cs_cmd_req_done` interrupt until the command
+ * completes. Does nothing if a refill is already in progress.
+ *
+ * Must be called with the `cs_cmd_req_done` interrupt masked.
+ */
+OT_WARN_UNUSED_RESULT
+static status_t entropy_pool_refill_start(void) {
+  size_t num_blocks =
+      (kEntropyPoolNumWords - pool.count) / kEntropyCsrngBitsBufferNumWords;
+  if (pool.refilling == kHardenedBoolTrue ||
+      csrng_generate_pending == kHardenedBoolTrue || num_blocks == 0) {
+    return OTCRYPTO_OK;
+  }
+
+  // The generate command completes only once all of its output has been read;
+  // clear the interrupt state so that its completion can be detected.
+  csrng_irq_cmd_req_done_acknowledge();
+  HARDENED_TRY(csrng_send_app_cmd(kBaseCsrng,
+                                  (entropy_csrng_cmd_t){
+                                      .id = kEntropyDrbgOpGenerate,
+                                      .seed_material = NULL,
+                                      .generate_len = num_blocks,
+                                  },
+                                  kEntropyCsrngSendAppCmdTypeCsrng, false));
+  pool.refilling = kHardenedBoolTrue;
+  pool.pending_blocks = num_blocks;
+  pool.staged = 0;
+  pool.staged_fips = kHardenedBoolTrue;
+  csrng_irq_cmd_req_done_enable(true);
+  return OTCRYPTO_OK;
+}
+
+/**
+ * Makes progress on the refill in progress, if any.
+ *
+ * Reads the blocks CSRNG has produced so far into the staging area of the pool.
+ * Once all of them are read and CSRNG signals `cs_cmd_req_done`, the staged
+ * words join the pool, or are wiped if the command failed or any block was not
+ * FIPS-compatible.
+ *
+ * Must be called with the `cs_cmd_req_done` interrupt masked (or from its
+ * handler).
+ *
+ * @param blocking Whether to wait for the refill to complete.
+ */
+static void entropy_pool_refill_advance(bool blocking) {
+  if (pool.refilling != kHardenedBoolTrue) {
+    return;
+  }
+
+  while (pool.pending_blocks > 0) {
+    uint32_t reg = abs_mmio_read32(kBaseCsrng + CSRNG_GENBITS_VLD_REG_OFFSET);
+    if (!bitfield_bit32_read(reg, CSRNG_GENBITS_VLD_GENBITS_VLD_BIT)) {
+      if (!blocking) {
+        return;
+      }
+      continue;
+    }
+    if (!bitfield_bit32_read(reg, CSRNG_GENBITS_VLD_GENBITS_FIPS_BIT)) {
+      pool.staged_fips = kHardenedBoolFalse;
+    }
+
+    // Read the block in reverse word order, as in
+    // `entropy_csrng_generate_data_get()`.
+    for (size_t offset = 0; offset < kEntropyCsrngBitsBufferNumWords;
+         ++offset) {
+      size_t word_idx = pool.count + pool.staged +
+                        kEntropyCsrngBitsBufferNumWords - 1 - offset;
+      pool.words[entropy_pool_index(word_idx)] =
+          abs_mmio_read32(kBaseCsrng + CSRNG_GENBITS_REG_OFFSET);
+    }
+    pool.staged += kEntropyCsrngBitsBufferNumWords;
+    --pool.pending_blocks;
+  }
+
+  uint32_t reg = abs_mmio_read32(kBaseCsrng + CSRNG_INTR_STATE_REG_OFFSET);
+  while (!bitfield_bit32_read(reg, CSRNG_INTR_STATE_CS_CMD_REQ_DONE_BIT)) {
+    if (!blocking) {
+      return;
+    }
+    reg = abs_mmio_read32(kBaseCsrng + CSRNG_INTR_STATE_REG_OFFSET);
+  }
+  csrng_irq_cmd_req_done_enable(false);
+  csrng_irq_cmd_req_done_acknowledge();
+  pool.refilling = kHardenedBoolFalse;
+
+  // Check the "status" bit, which will be 0 unless there was an error.
+  reg = abs_mmio_read32(kBaseCsrng + CSRNG_SW_CMD_STS_REG_OFFSET);
+  if (bitfield_field32_read(reg, CSRNG_SW_CMD_STS_CMD_STS_FIELD) != 0 ||
+      pool.staged_fips != kHardenedBoolTrue) {
+    entropy_pool_wipe(pool.count, pool.staged);
+    pool.staged = 0;
+    pool.refill_failed = kHardenedBoolTrue;
+    return;
+  }
+  pool.count += pool.staged;
+  pool.staged = 0;
+  pool.refill_failed = kHardenedBoolFalse;
+}
+
+/**
+ * Completes any refill in progress, so that other commands can be sent to the
+ * SW CSRNG instance.
+ *
+ * Leaves the `cs_cmd_req_done` interrupt disabled.
+ *
+ * @param flush Whether to also wipe the pool, because the next command changes
+ * the DRBG state its contents were generated from.
+ */
+static void entropy_pool_quiesce(bool flush) {
+  csrng_irq_cmd_req_done_enable(false);
+  entropy_pool_refill_advance(/*blocking=*/true);
+  if (flush) {
+    entropy_pool_wipe(0, pool.count);
+    pool.head = 0;
+    pool.count = 0;
+    pool.refill_failed = kHardenedBoolFalse;
+  }
+}
+
+/**
+ * Drops the pool state without talking to CSRNG, e.g. before it is stopped.
+ */
+static void entropy_pool_reset(void) {
+  csrng_irq_cmd_req_done_enable(false);
+  entropy_pool_wipe(0, kEntropyPoolNumWords);
+  pool.head = 0;
+  pool.count = 0;
+  pool.staged = 0;
+  pool.pending_blocks = 0;
+  pool.refilling = kHardenedBoolFalse;
+  pool.refill_failed = kHardenedBoolFalse;
+  csrng_generate_pending = kHardenedBoolFalse;
+}
+
+/**
+ * Advances the pool's refill with the `cs_cmd_req_done` interrupt masked, and
+ * starts the next refill if the pool is low.
+ */
+static void entropy_pool_advance_masked(void) {
+  csrng_irq_cmd_req_done_enable(false);
+  entropy_pool_refill_advance(/*blocking=*/false);
+  if (pool.enabled == kHardenedBoolTrue &&
+      pool.refill_failed != kHardenedBoolTrue &&
+      pool.count < kEntropyPoolLowWatermarkWords) {
+    // Errors are reported by the next `entropy_pool_generate()` call, which
+    // falls back to a direct generate command.
+    if (!status_ok(entropy_pool_refill_start())) {
+      pool.refill_failed = kHardenedBoolTrue;
+    }
+  }
+  csrng_irq_cmd_req_done_enable(pool.refilling == kHardenedBoolTrue);
+}
+
+/**
+ * Whether `entropy_complex_init_staged()` has started entropy_src while
+ * CSRNG and the EDNs are still to be configured.
+ */
+static hardened_bool_t complex_staged = kHardenedBoolFalse;
+
+/**
+ * Stops the entropy complex and starts entropy_src in continuous mode.
+ *
+ * @param[out] config The continuous mode configuration.
+ * @return error on failure.
+ */
+OT_WARN_UNUSED_RESULT
+static status_t entropy_complex_start(const entropy_complex_config_t **config) {
+  entropy_pool_reset();
   entropy_complex_stop_all();
+  complex_staged = kHardenedBoolFalse;
 
-  const entropy_complex_config_t *config =
-      &kEntropyComplexConfigs[kEntropyComplexConfigIdContinuous];
-  if (launder32(config->id) != kEntropyComplexConfigIdContinuous) {
+  *config = &kEntropyComplexConfigs[kEntropyComplexConfigIdContinuous];
+  if (launder32((*config)->id) != kEntropyComplexConfigIdContinuous) {
     return OTCRYPTO_RECOV_ERR;
   }
+  return entropy_src_configure(&(*config)->entropy_src);
+}
 
-  HARDENED_TRY(entropy_src_configure(&config->entropy_src));
+/**
+ * Configures CSRNG and both EDNs in continuous mode.
+ *
+ * Blocks until each EDN has instantiated its CSRNG instance, which in turn
+ * waits for a seed from entropy_src.
+ *
+ * @param config The continuous mode configuration.
+ * @return error on failure.
+ */
+OT_WARN_UNUSED_RESULT
+static status_t entropy_complex_finish(const entropy_complex_config_t *config) {
   csrng_configure();
   HARDENED_TRY(edn_configure(&config->edn0));
   return edn_configure(&config->edn1);
 }
 
+/**
+ * Finishes a staged bring-up, if there is one pending.
+ *
+ * Called by every function that needs CSRNG or the EDNs, so that the rest of
+ * the complex is configured the first time randomness is needed.
+ *
+ * @return error on failure.
+ */
+OT_WARN_UNUSED_RESULT
+static status_t entropy_complex_ensure(void) {
+  if (launder32(complex_staged) == kHardenedBoolFalse) {
+    HARDENED_CHECK_EQ(complex_staged, kHardenedBoolFalse);
+    return OTCRYPTO_OK;
+  }
+  const entropy_complex_config_t *config =
+      &kEntropyComplexConfigs[kEntropyComplexConfigIdContinuous];
+  if (launder32(config->id) != kEntropyComplexConfigIdContinuous) {
+    return OTCRYPTO_RECOV_ERR;
+  }
+  // Clear the flag first; on failure, the complex is in an unknown state and
+  // must be initialized again.
+  complex_staged = kHardenedBoolFalse;
+  return entropy_complex_finish(config);
+}
+
+status_t entropy_complex_init(void) {
+  const entropy_complex_config_t *config;
+  HARDENED_TRY(entropy_complex_start(&config));
+  return entropy_complex_finish(config);
+}
+
+status_t entropy_complex_init_staged(void) {
+  const entropy_complex_config_t *config;
+  HARDENED_TRY(entropy_complex_start(&config));
+  complex_staged = kHardenedBoolTrue;
+  return OTCRYPTO_OK;
+}
+
 status_t entropy_complex_check(void) {
+  HARDENED_TRY(entropy_complex_ensure());
+
   const entropy_complex_config_t *config =
       &kEntropyComplexConfigs[kEntropyComplexConfigIdContinuous];
   if (launder32(config->id) != kEntropyComplexConfigIdContinuous) {
@@ -858,6 +1184,8 @@ status_t entropy_complex_check(void) {
 status_t entropy_csrng_instantiate(
     hardened_bool_t disable_trng_input,
     const entropy_seed_material_t *seed_material) {
+  HARDENED_TRY(entropy_complex_ensure());
+  entropy_pool_quiesce(/*flush=*/true);
   return csrng_send_app_cmd(kBaseCsrng,
                             (entropy_csrng_cmd_t){
                                 .id = kEntropyDrbgOpInstantiate,
@@ -870,6 +1198,8 @@ status_t entropy_csrng_instantiate(
 
 status_t entropy_csrng_reseed(hardened_bool_t disable_trng_input,
                               const entropy_seed_material_t *seed_material) {
+  HARDENED_TRY(entropy_complex_ensure());
+  entropy_pool_quiesce(/*flush=*/true);
   return csrng_send_app_cmd(kBaseCsrng,
                             (entropy_csrng_cmd_t){
                                 .id = kEntropyDrbgOpReseed,
@@ -881,6 +1211,8 @@ status_t entropy_csrng_reseed(hardened_bool_t disable_trng_input,
 }
 
 status_t entropy_csrng_update(const entropy_seed_material_t *seed_material) {
+  HARDENED_TRY(entropy_complex_ensure());
+  entropy_pool_quiesce(/*flush=*/true);
   return csrng_send_app_cmd(kBaseCsrng,
                             (entropy_csrng_cmd_t){
                                 .id = kEntropyDrbgOpUpdate,
@@ -892,16 +1224,23 @@ status_t entropy_csrng_update(const entropy_seed_material_t *seed_material) {
 
 status_t entropy_csrng_generate_start(
     const entropy_seed_material_t *seed_material, size_t len) {
+  HARDENED_TRY(entropy_complex_ensure());
   // Round up the number of 128bit blocks. Aligning with respect to uint32_t.
   // TODO(#6112): Consider using a canonical reference for alignment operations.
   const uint32_t num_128bit_blocks = ceil_div(len, 4);
-  return csrng_send_app_cmd(kBaseCsrng,
-                            (entropy_csrng_cmd_t){
-                                .id = kEntropyDrbgOpGenerate,
-                                .seed_material = seed_material,
-                                .generate_len = num_128bit_blocks,
-                            },
-                            kEntropyCsrngSendAppCmdTypeCsrng, true);
+  entropy_pool_quiesce(/*flush=*/false);
+  // Don't wait for the first block here; `entropy_csrng_generate_data_get()`
+  // waits for each block anyway, and returning straight away lets the caller
+  // overlap other work with the generate command.
+  HARDENED_TRY(csrng_send_app_cmd(kBaseCsrng,
+                                  (entropy_csrng_cmd_t){
+                                      .id = kEntropyDrbgOpGenerate,
+                                      .seed_material = seed_material,
+                                      .generate_len = num_128bit_blocks,
+                                  },
+                                  kEntropyCsrngSendAppCmdTypeCsrng, false));
+  csrng_generate_pending = kHardenedBoolTrue;
+  return OTCRYPTO_OK;
 }
 
 status_t entropy_csrng_generate_data_get(uint32_t *buf, size_t len,
@@ -938,6 +1277,7 @@ status_t entropy_csrng_generate_data_get(uint32_t *buf, size_t len,
       }
     }
   }
+  csrng_generate_pending = kHardenedBoolFalse;
 
   return res;
 }
@@ -950,6 +1290,8 @@ status_t entropy_csrng_generate(const entropy_seed_material_t *seed_material,
 }
 
 status_t entropy_csrng_uninstantiate(void) {
+  HARDENED_TRY(entropy_complex_ensure());
+  entropy_pool_quiesce(/*flush=*/true);
   return csrng_send_app_cmd(kBaseCsrng,
                             (entropy_csrng_cmd_t){
                                 .id = kEntropyDrbgOpUninstantiate,
@@ -958,3 +1300,60 @@ status_t entropy_csrng_uninstantiate(void) {
                             },
                             kEntropyCsrngSendAppCmdTypeCsrng, true);
 }
+
+status_t entropy_pool_enable(hardened_bool_t enable) {
+  if (launder32(enable) == kHardenedBoolTrue) {
+    HARDENED_CHECK_EQ(enable, kHardenedBoolTrue);
+    HARDENED_TRY(entropy_complex_ensure());
+    pool.enabled = kHardenedBoolTrue;
+    entropy_pool_advance_masked();
+    return OTCRYPTO_OK;
+  } else if (launder32(enable) == kHardenedBoolFalse) {
+    HARDENED_CHECK_EQ(enable, kHardenedBoolFalse);
+    entropy_pool_quiesce(/*flush=*/true);
+    pool.enabled = kHardenedBoolFalse;
+    return OTCRYPTO_OK;
+  }
+  return OTCRYPTO_BAD_ARGS;
+}
+
+status_t entropy_pool_generate(uint32_t *buf, size_t len) {
+  if (launder32(pool.enabled) != kHardenedBoolTrue ||
+      len > kEntropyPoolMaxRequestWords) {
+    return entropy_csrng_generate(&kEntropyEmptySeed, buf, len,
+                                  /*fips_check=*/kHardenedBoolTrue);
+  }
+
+  csrng_irq_cmd_req_done_enable(false);
+  entropy_pool_refill_advance(/*blocking=*/false);
+  if (pool.count < len) {
+    // Wait for the refill in progress; if that is not enough (or there was
+    // none), run another one.
+    entropy_pool_refill_advance(/*blocking=*/true);
+    if (pool.count < len) {
+      HARDENED_TRY(entropy_pool_refill_start());
+      entropy_pool_refill_advance(/*blocking=*/true);
+    }
+  }
+  if (pool.count < len) {
+    // The pool could not be refilled with FIPS-compatible output; the direct
+    // path reports why.
+    return entropy_csrng_generate(&kEntropyEmptySeed, buf, len,
+                                  /*fips_check=*/kHardenedBoolTrue);
+  }
+
+  for (size_t i = 0; i < len; ++i) {
+    size_t idx = entropy_pool_index(i);
+    buf[i] = pool.words[idx];
+    pool.words[idx] = 0;
+  }
+  pool.head = entropy_pool_index(len);
+  pool.count -= len;
+
+  entropy_pool_advance_masked();
+  return OTCRYPTO_OK;
+}
+
+void entropy_pool_poll(void) { entropy_pool_advance_masked(); }
+
+void entropy_pool_irq_handler(void) { entropy_pool_advance_masked(); }
@@ -33,6 +33,17 @@ enum {
    * Number of words in an entropy seed.
    */
   kEntropySeedWords = kEntropySeedBytes / sizeof(uint32_t),
+  /**
+   * Number of words of SW CSRNG output held by the output pool.
+   *
+   * Must be a power of two and a multiple of the 128-bit CSRNG block size.
+   */
+  kEntropyPoolNumWords = 32,
+  /**
+   * Largest request, in words, that `entropy_pool_generate()` serves from the
+   * output pool.
+   */
+  kEntropyPoolMaxRequestWords = 8,
 };
 
 /**
@@ -94,11 +105,31 @@ extern const entropy_seed_material_t kEntropyEmptySeed;
 OT_WARN_UNUSED_RESULT
 status_t entropy_complex_init(void);
 
+/**
+ * Starts configuring the entropy complex in continuous mode.
+ *
+ * Stops the complex and starts entropy_src like `entropy_complex_init()`, but
+ * returns without waiting for anything. CSRNG and the EDNs are configured the
+ * first time randomness is needed: by `entropy_complex_check()`, the SW CSRNG
+ * functions below or `entropy_pool_enable()`. Until then, entropy_src collects
+ * entropy in the background.
+ *
+ * Use this when there is other work to do before the first consumer of
+ * randomness. Hardware blocks that take entropy from an EDN by themselves
+ * (e.g. keymgr) must not be used before `entropy_complex_check()` is called.
+ *
+ * @return Operation status in `status_t` format.
+ */
+OT_WARN_UNUSED_RESULT
+status_t entropy_complex_init_staged(void);
+
 /**
  * Ensures that the entropy complex is ready for use.
  *
  * Ensures that the entropy complex is running and that `entropy_src` is in
  * FIPS mode, and verifies the thresholds for health tests in `entropy_src`.
+ * Finishes the bring-up started by `entropy_complex_init_staged()` first, if
+ * it is still pending.
  * This function should be called periodically while the entropy complex is in
  * use, because the threshold registers are not shadowed.
  *
@@ -162,6 +193,11 @@ status_t entropy_csrng_update(const entropy_seed_material_t *seed_material);
  * Use `entropy_csrng_generate_data_get()` to read the data from the CSRNG
  * output buffer.
  *
+ * Returns once the command has been issued, without waiting for any output,
+ * so the caller can do other work while CSRNG generates the first blocks. No
+ * other command may be sent to the SW CSRNG instance until the data has been
+ * read.
+ *
  * See `entropy_csrng_generate()` for requesting and reading the CSRNG output in
  * a single call.
  *
@@ -217,6 +253,62 @@ status_t entropy_csrng_generate(const entropy_seed_material_t *seed_material,
 OT_WARN_UNUSED_RESULT
 status_t entropy_csrng_uninstantiate(void);
 
+/**
+ * Enables or disables the SW CSRNG output pool.
+ *
+ * While enabled, `entropy_pool_generate()` serves small requests from a buffer
+ * of prefetched SW CSRNG output instead of issuing a generate command for each
+ * one. Enabling the pool starts filling it; disabling it wipes the buffered
+ * output. The pool is disabled after reset.
+ *
+ * The other `entropy_csrng_*` functions keep issuing their own commands. They
+ * first wait for any refill of the pool to complete, and the instantiate,
+ * reseed, update and uninstantiate commands also wipe the pool, since its
+ * contents were generated from the previous DRBG state.
+ *
+ * @param enable Whether to enable the pool.
+ * @return Operation status in `status_t` format.
+ */
+OT_WARN_UNUSED_RESULT
+status_t entropy_pool_enable(hardened_bool_t enable);
+
+/**
+ * Reads FIPS-compatible SW CSRNG output, from the output pool if possible.
+ *
+ * Equivalent to `entropy_csrng_generate()` with empty seed material and
+ * `fips_check` set. Requests of at most `kEntropyPoolMaxRequestWords` words are
+ * served from the pool while it is enabled; the pool is refilled in the
+ * background once it runs low. Larger requests, and requests that arrive while
+ * the pool cannot be refilled with FIPS-compatible output, are passed to
+ * `entropy_csrng_generate()`.
+ *
+ * @param buf A buffer to fill with random words.
+ * @param len The number of words to read into `buf`.
+ * @return Operation status in `status_t` format.
+ */
+OT_WARN_UNUSED_RESULT
+status_t entropy_pool_generate(uint32_t *buf, size_t len);
+
+/**
+ * Advances a refill of the SW CSRNG output pool without blocking.
+ *
+ * CSRNG holds back generated blocks until software reads them, so a refill
+ * makes progress whenever the pool is used, polled, or its interrupt handler
+ * runs. Callers that don't route CSRNG's `cs_cmd_req_done` interrupt to
+ * `entropy_pool_irq_handler()` can call this periodically instead.
+ */
+void entropy_pool_poll(void);
+
+/**
+ * Handler for CSRNG's `cs_cmd_req_done` interrupt.
+ *
+ * Call this from the interrupt handler for CSRNG's `cs_cmd_req_done`
+ * interrupt. The interrupt is enabled while a refill of the output pool is in
+ * progress; once the refill completes, the handler adds its output to the pool
+ * and starts the next refill if the pool is still low.
+ */
+void entropy_pool_irq_handler(void);
+
 #ifdef __cplusplus
 }
 #endif
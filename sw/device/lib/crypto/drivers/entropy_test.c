@@ -33,10 +33,25 @@ static status_t entropy_complex_init_test(void) {
   return OK_STATUS();
 }
 
+static status_t entropy_complex_init_staged_test(void) {
+  TRY(entropy_complex_init_staged());
+
+  // Finishes the bring-up and checks the configuration.
+  TRY(entropy_complex_check());
+
+  dif_otbn_t otbn;
+  TRY_CHECK(dif_otbn_init(mmio_region_from_addr(TOP_EARLGREY_OTBN_BASE_ADDR),
+                          &otbn) == kDifOk);
+  otbn_randomness_test_start(&otbn, /*iters=*/0);
+  TRY_CHECK(otbn_randomness_test_end(&otbn, /*skip_otbn_don_check=*/false));
+  return OK_STATUS();
+}
+
 bool test_main(void) {
   status_t result = OK_STATUS();
 
   EXECUTE_TEST(result, entropy_complex_init_test);
+  EXECUTE_TEST(result, entropy_complex_init_staged_test);
   EXECUTE_TEST(result, entropy_csrng_kat);
   return status_ok(result);
 }
@@ -8,6 +8,8 @@
 #include "sw/device/lib/base/bitfield.h"
 #include "sw/device/lib/base/hardened.h"
 #include "sw/device/lib/base/memory.h"
+#include "sw/device/lib/crypto/drivers/clkmgr.h"
+#include "sw/device/lib/crypto/drivers/dma.h"
 #include "sw/device/lib/crypto/impl/status.h"
 
 #include "hmac_regs.h"  // Generated.
@@ -76,6 +78,16 @@ enum {
    * Let's take a large margin and consider that 200 loops are enough.
    */
   kNumIterTimeout = 200,
+  /* HMAC inner and outer pads (FIPS 198-1, Section 3), repeated over a word. */
+  kHmacIpadWord = 0x36363636,
+  kHmacOpadWord = 0x5c5c5c5c,
+};
+
+/**
+ * Keeps the HMAC clock running while a driver call uses HMAC HWIP.
+ */
+static clkmgr_hold_t clock_hold = {
+    .clock = kClkmgrClockHmac,
 };
 
 /**
@@ -244,10 +256,15 @@ static void context_save(hmac_ctx_t *ctx) {
  * Write given byte array into the `MSG_FIFO`. This function should only be
  * called when HMAC HWIP is already running and expecting further message bytes.
  *
+ * If DMA feeding is enabled (see `dma_feed_enable()`), the word-aligned part
+ * of long messages is copied by the DMA controller.
+ *
  * @param message The incoming message buffer to be fed into HMAC_FIFO.
  * @param message_len The length of `message` in bytes.
+ * @return Result of the operation.
  */
-static void msg_fifo_write(const uint8_t *message, size_t message_len) {
+OT_WARN_UNUSED_RESULT
+static status_t msg_fifo_write(const uint8_t *message, size_t message_len) {
   // TODO(#23191): Should we handle backpressure here?
   // Begin by writing a one byte at a time until the data is aligned.
   size_t i = 0;
@@ -256,6 +273,14 @@ static void msg_fifo_write(const uint8_t *message, size_t message_len) {
     abs_mmio_write8(kHmacBaseAddr + HMAC_MSG_FIFO_REG_OFFSET, message[i]);
   }
 
+  // Hand the full words to the DMA controller if it is enabled.
+  size_t words_len = (message_len - i) & ~(sizeof(uint32_t) - 1);
+  if (dma_feed_applicable(words_len) == kHardenedBoolTrue) {
+    HARDENED_TRY(dma_feed_fifo(&message[i], words_len,
+                               kHmacBaseAddr + HMAC_MSG_FIFO_REG_OFFSET));
+    i += words_len;
+  }
+
   // Write one word at a time as long as there is a full word available.
   for (; i + sizeof(uint32_t) <= message_len; i += sizeof(uint32_t)) {
     uint32_t next_word = read_32(&message[i]);
@@ -266,6 +291,7 @@ static void msg_fifo_write(const uint8_t *message, size_t message_len) {
   for (; i < message_len; i++) {
     abs_mmio_write8(kHmacBaseAddr + HMAC_MSG_FIFO_REG_OFFSET, message[i]);
   }
+  return OTCRYPTO_OK;
 }
 
 /**
@@ -396,6 +422,7 @@ status_t hmac_update(hmac_ctx_t *ctx, const uint8_t *data, size_t len) {
   // handle the current partial block and the incoming message bytes.
   size_t leftover_len = (ctx->partial_block_len + len) % ctx->msg_block_bytelen;
 
+  clkmgr_hold_acquire(&clock_hold);
   // The previous caller should have left it clean, but it doesn't hurt to
   // clear again.
   hmac_hwip_clear();
@@ -404,10 +431,10 @@ status_t hmac_update(hmac_ctx_t *ctx, const uint8_t *data, size_t len) {
   context_restore(ctx);
 
   // Write `partial_block` to MSG_FIFO
-  msg_fifo_write(ctx->partial_block, ctx->partial_block_len);
+  HARDENED_TRY(msg_fifo_write(ctx->partial_block, ctx->partial_block_len));
 
   // Keep writing incoming bytes
-  msg_fifo_write(data, len - leftover_len);
+  HARDENED_TRY(msg_fifo_write(data, len - leftover_len));
 
   // Time to tell HMAC HWIP to stop, because we do not have enough message
   // bytes for another round.
@@ -428,6 +455,7 @@ status_t hmac_update(hmac_ctx_t *ctx, const uint8_t *data, size_t len) {
 
   // Clean up HMAC HWIP so it can be reused by other driver calls.
   hmac_hwip_clear();
+  clkmgr_hold_release(&clock_hold);
   return OTCRYPTO_OK;
 }
 
@@ -441,6 +469,7 @@ status_t hmac_final(hmac_ctx_t *ctx, uint32_t *digest, size_t digest_wordlen) {
     return OTCRYPTO_BAD_ARGS;
   }
 
+  clkmgr_hold_acquire(&clock_hold);
   // The previous caller should have left it clean, but it doesn't hurt to
   // clear again.
   hmac_hwip_clear();
@@ -450,7 +479,7 @@ status_t hmac_final(hmac_ctx_t *ctx, uint32_t *digest, size_t digest_wordlen) {
   context_restore(ctx);
 
   // Feed the final leftover bytes to HMAC HWIP.
-  msg_fifo_write(ctx->partial_block, ctx->partial_block_len);
+  HARDENED_TRY(msg_fifo_write(ctx->partial_block, ctx->partial_block_len));
 
   // All message bytes are fed, now hit the process button.
   uint32_t cmd_reg =
@@ -462,6 +491,7 @@ status_t hmac_final(hmac_ctx_t *ctx, uint32_t *digest, size_t digest_wordlen) {
 
   // Clean up HMAC HWIP so it can be reused by other driver calls.
   hmac_hwip_clear();
+  clkmgr_hold_release(&clock_hold);
 
   // TODO(#23191): Destroy sensitive values in the ctx object.
   return OTCRYPTO_OK;
@@ -476,6 +506,7 @@ status_t hmac(const hmac_mode_t hmac_mode, const uint32_t *key,
 
   // The previous caller should have left it clean, but it doesn't hurt to
   // clear again.
+  clkmgr_hold_acquire(&clock_hold);
   hmac_hwip_clear();
 
   uint32_t cfg_reg;
@@ -517,7 +548,7 @@ status_t hmac(const hmac_mode_t hmac_mode, const uint32_t *key,
       bitfield_bit32_write(HMAC_CMD_REG_RESVAL, HMAC_CMD_HASH_START_BIT, 1);
   abs_mmio_write32(kHmacBaseAddr + HMAC_CMD_REG_OFFSET, cmd_reg);
 
-  msg_fifo_write(data, len);
+  HARDENED_TRY(msg_fifo_write(data, len));
 
   cmd_reg =
       bitfield_bit32_write(HMAC_CMD_REG_RESVAL, HMAC_CMD_HASH_PROCESS_BIT, 1);
@@ -530,7 +561,263 @@ status_t hmac(const hmac_mode_t hmac_mode, const uint32_t *key,
 
   // Clean up HMAC HWIP so it can be reused by other driver calls.
   hmac_hwip_clear();
+  clkmgr_hold_release(&clock_hold);
 
   // TODO(#23191): Destroy sensitive values in the ctx object.
   return OTCRYPTO_OK;
 }
+
+status_t hmac_sha2_batch(const hmac_mode_t hmac_mode,
+                         const uint8_t *const *messages,
+                         const size_t *message_lens, uint32_t *const *digests,
+                         size_t num_messages, size_t digest_wordlen) {
+  if (num_messages > 0 &&
+      (messages == NULL || message_lens == NULL || digests == NULL)) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+  if (hmac_mode != kHmacModeSha256 && hmac_mode != kHmacModeSha384 &&
+      hmac_mode != kHmacModeSha512) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+
+  uint32_t cfg_reg;
+  size_t derived_msg_block_bytelen;
+  size_t derived_digest_wordlen;
+  HARDENED_TRY(cfg_derive(hmac_mode, &cfg_reg, &derived_msg_block_bytelen,
+                          &derived_digest_wordlen));
+  if (digest_wordlen != derived_digest_wordlen) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+  for (size_t i = 0; i < num_messages; i++) {
+    if ((messages[i] == NULL && message_lens[i] > 0) || digests[i] == NULL) {
+      return OTCRYPTO_BAD_ARGS;
+    }
+  }
+
+  // The previous caller should have left it clean, but it doesn't hurt to
+  // clear again.
+  clkmgr_hold_acquire(&clock_hold);
+  hmac_hwip_clear();
+
+  abs_mmio_write32(kHmacBaseAddr + HMAC_CFG_REG_OFFSET, cfg_reg);
+  // `sha_en` is not set by `cfg_derive` so we need to explicity set it now.
+  cfg_reg = bitfield_bit32_write(cfg_reg, HMAC_CFG_SHA_EN_BIT, true);
+  abs_mmio_write32(kHmacBaseAddr + HMAC_CFG_REG_OFFSET, cfg_reg);
+
+  size_t i = 0;
+  for (; launder32(i) < num_messages; i++) {
+    uint32_t cmd_reg =
+        bitfield_bit32_write(HMAC_CMD_REG_RESVAL, HMAC_CMD_HASH_START_BIT, 1);
+    abs_mmio_write32(kHmacBaseAddr + HMAC_CMD_REG_OFFSET, cmd_reg);
+
+    HARDENED_TRY(msg_fifo_write(messages[i], message_lens[i]));
+
+    cmd_reg =
+        bitfield_bit32_write(HMAC_CMD_REG_RESVAL, HMAC_CMD_HASH_PROCESS_BIT, 1);
+    abs_mmio_write32(kHmacBaseAddr + HMAC_CMD_REG_OFFSET, cmd_reg);
+
+    // Wait for HMAC HWIP operation to be completed.
+    status_t result = hmac_idle_wait();
+    if (!status_ok(result)) {
+      hmac_hwip_clear();
+      clkmgr_hold_release(&clock_hold);
+      return result;
+    }
+
+    digest_read(digests[i], digest_wordlen);
+  }
+  HARDENED_CHECK_EQ(i, num_messages);
+
+  // Clean up HMAC HWIP so it can be reused by other driver calls.
+  hmac_hwip_clear();
+  clkmgr_hold_release(&clock_hold);
+  return OTCRYPTO_OK;
+}
+
+/**
+ * For given HMAC mode, return the SHA-2 mode of its hash function.
+ *
+ * @param hmac_mode One of the HMAC modes.
+ * @param[out] sha2_mode The matching SHA-2 mode.
+ * @return Result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+static status_t sha2_mode_get(hmac_mode_t hmac_mode, hmac_mode_t *sha2_mode) {
+  switch (hmac_mode) {
+    case kHmacModeHmac256:
+      *sha2_mode = kHmacModeSha256;
+      break;
+    case kHmacModeHmac384:
+      *sha2_mode = kHmacModeSha384;
+      break;
+    case kHmacModeHmac512:
+      *sha2_mode = kHmacModeSha512;
+      break;
+    default:
+      return OTCRYPTO_BAD_ARGS;
+  }
+  return OTCRYPTO_OK;
+}
+
+/**
+ * Hash a single key block with SHA-2 and save the resulting state.
+ *
+ * HMAC HWIP is cleared before and after, also on errors.
+ *
+ * @param cfg_reg SHA-2 configuration from `cfg_derive`.
+ * @param block The key block.
+ * @param block_bytelen The length of `block` in bytes.
+ * @param[out] H The SHA-2 state after `block`.
+ * @param[out] lower The lower word of the message length after `block`.
+ * @param[out] upper The upper word of the message length after `block`.
+ * @return Result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+static status_t key_block_absorb(uint32_t cfg_reg, const uint32_t *block,
+                                 size_t block_bytelen, uint32_t *H,
+                                 uint32_t *lower, uint32_t *upper) {
+  clkmgr_hold_acquire(&clock_hold);
+  hmac_hwip_clear();
+  abs_mmio_write32(kHmacBaseAddr + HMAC_CFG_REG_OFFSET, cfg_reg);
+  cfg_reg = bitfield_bit32_write(cfg_reg, HMAC_CFG_SHA_EN_BIT, true);
+  abs_mmio_write32(kHmacBaseAddr + HMAC_CFG_REG_OFFSET, cfg_reg);
+  uint32_t cmd_reg =
+      bitfield_bit32_write(HMAC_CMD_REG_RESVAL, HMAC_CMD_HASH_START_BIT, 1);
+  abs_mmio_write32(kHmacBaseAddr + HMAC_CMD_REG_OFFSET, cmd_reg);
+
+  status_t result = msg_fifo_write((const uint8_t *)block, block_bytelen);
+  if (status_ok(result)) {
+    cmd_reg =
+        bitfield_bit32_write(HMAC_CMD_REG_RESVAL, HMAC_CMD_HASH_STOP_BIT, 1);
+    abs_mmio_write32(kHmacBaseAddr + HMAC_CMD_REG_OFFSET, cmd_reg);
+    result = hmac_idle_wait();
+  }
+  if (status_ok(result)) {
+    digest_read(H, kHmacMaxDigestWords);
+    *lower = abs_mmio_read32(kHmacBaseAddr + HMAC_MSG_LENGTH_LOWER_REG_OFFSET);
+    *upper = abs_mmio_read32(kHmacBaseAddr + HMAC_MSG_LENGTH_UPPER_REG_OFFSET);
+  }
+  hmac_hwip_clear();
+  clkmgr_hold_release(&clock_hold);
+  return result;
+}
+
+/**
+ * Finish a SHA-2 hash that resumes from a saved state.
+ *
+ * This is `context_restore` followed by `hmac_final` for a context with no
+ * partial block, without the need for a full `hmac_ctx_t`. HMAC HWIP is
+ * cleared before and after, also on errors.
+ *
+ * @param cfg_reg SHA-2 configuration from `cfg_derive`.
+ * @param H The saved SHA-2 state.
+ * @param lower The lower word of the saved message length.
+ * @param upper The upper word of the saved message length.
+ * @param data The rest of the message.
+ * @param len The length of `data` in bytes.
+ * @param[out] digest The digest.
+ * @param digest_wordlen The length of the digest in words.
+ * @return Result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+static status_t resumed_hash(uint32_t cfg_reg, const uint32_t *H,
+                             uint32_t lower, uint32_t upper,
+                             const uint8_t *data, size_t len, uint32_t *digest,
+                             size_t digest_wordlen) {
+  clkmgr_hold_acquire(&clock_hold);
+  hmac_hwip_clear();
+  abs_mmio_write32(kHmacBaseAddr + HMAC_CFG_REG_OFFSET, cfg_reg);
+  for (size_t i = 0; i < kHmacMaxDigestWords; i++) {
+    abs_mmio_write32(kHmacBaseAddr + HMAC_DIGEST_0_REG_OFFSET + 4 * i, H[i]);
+  }
+  abs_mmio_write32(kHmacBaseAddr + HMAC_MSG_LENGTH_LOWER_REG_OFFSET, lower);
+  abs_mmio_write32(kHmacBaseAddr + HMAC_MSG_LENGTH_UPPER_REG_OFFSET, upper);
+  // As in `context_restore`, `sha_en` can only be set now (see #23014).
+  cfg_reg = bitfield_bit32_write(cfg_reg, HMAC_CFG_SHA_EN_BIT, true);
+  abs_mmio_write32(kHmacBaseAddr + HMAC_CFG_REG_OFFSET, cfg_reg);
+  uint32_t cmd_reg =
+      bitfield_bit32_write(HMAC_CMD_REG_RESVAL, HMAC_CMD_HASH_CONTINUE_BIT, 1);
+  abs_mmio_write32(kHmacBaseAddr + HMAC_CMD_REG_OFFSET, cmd_reg);
+
+  status_t result = msg_fifo_write(data, len);
+  if (status_ok(result)) {
+    cmd_reg =
+        bitfield_bit32_write(HMAC_CMD_REG_RESVAL, HMAC_CMD_HASH_PROCESS_BIT, 1);
+    abs_mmio_write32(kHmacBaseAddr + HMAC_CMD_REG_OFFSET, cmd_reg);
+    result = hmac_idle_wait();
+  }
+  if (status_ok(result)) {
+    digest_read(digest, digest_wordlen);
+  }
+  hmac_hwip_clear();
+  clkmgr_hold_release(&clock_hold);
+  return result;
+}
+
+status_t hmac_keyed_state_init(hmac_keyed_state_t *state,
+                               const hmac_mode_t hmac_mode,
+                               const uint32_t *key, size_t key_wordlen) {
+  if (state == NULL || key == NULL) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+
+  hmac_mode_t sha2_mode;
+  HARDENED_TRY(sha2_mode_get(hmac_mode, &sha2_mode));
+  uint32_t cfg_reg;
+  size_t msg_block_bytelen;
+  size_t digest_wordlen;
+  HARDENED_TRY(
+      cfg_derive(sha2_mode, &cfg_reg, &msg_block_bytelen, &digest_wordlen));
+  // Ensure that the key length matches the internal block size.
+  if (msg_block_bytelen != key_wordlen * sizeof(uint32_t)) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+
+  // Both key blocks are one block long, so the saved message lengths match.
+  uint32_t pad[kHmacMaxBlockWords];
+  for (size_t i = 0; i < key_wordlen; i++) {
+    pad[i] = key[i] ^ kHmacIpadWord;
+  }
+  status_t result = key_block_absorb(cfg_reg, pad, msg_block_bytelen,
+                                     state->inner, &state->lower,
+                                     &state->upper);
+  if (status_ok(result)) {
+    for (size_t i = 0; i < key_wordlen; i++) {
+      pad[i] = key[i] ^ kHmacOpadWord;
+    }
+    result = key_block_absorb(cfg_reg, pad, msg_block_bytelen, state->outer,
+                              &state->lower, &state->upper);
+  }
+  memset(pad, 0, sizeof(pad));
+  return result;
+}
+
+status_t hmac_keyed(const hmac_keyed_state_t *state,
+                    const hmac_mode_t hmac_mode, const uint8_t *data,
+                    size_t len, uint32_t *digest, size_t digest_wordlen) {
+  if (state == NULL || digest == NULL || (data == NULL && len > 0)) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+
+  hmac_mode_t sha2_mode;
+  HARDENED_TRY(sha2_mode_get(hmac_mode, &sha2_mode));
+  uint32_t cfg_reg;
+  size_t msg_block_bytelen;
+  size_t derived_digest_wordlen;
+  HARDENED_TRY(cfg_derive(sha2_mode, &cfg_reg, &msg_block_bytelen,
+                          &derived_digest_wordlen));
+  if (digest_wordlen != derived_digest_wordlen) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+
+  // H(K0 ^ ipad || message), resuming after the inner key block.
+  uint32_t inner_digest[kHmacMaxDigestWords];
+  HARDENED_TRY(resumed_hash(cfg_reg, state->inner, state->lower, state->upper,
+                            data, len, inner_digest, digest_wordlen));
+
+  // H(K0 ^ opad || inner digest), resuming after the outer key block.
+  return resumed_hash(cfg_reg, state->outer, state->lower, state->upper,
+                      (const uint8_t *)inner_digest,
+                      digest_wordlen * sizeof(uint32_t), digest,
+                      digest_wordlen);
+}
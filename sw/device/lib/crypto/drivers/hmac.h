@@ -76,6 +76,26 @@ typedef struct hmac_ctx {
   size_t partial_block_len;
 } hmac_ctx_t;
 
+/**
+ * Precomputed state of an HMAC key.
+ *
+ * Holds the SHA-2 states after absorbing the inner (K0 ^ ipad) and outer
+ * (K0 ^ opad) key blocks, as saved from HMAC HWIP. With this state, each MAC
+ * under the same key costs only the compressions of the message itself plus
+ * one for the outer hash, and the key is never written to HWIP again.
+ *
+ * This is as sensitive as the key itself.
+ */
+typedef struct hmac_keyed_state {
+  // SHA-2 state after the inner key block.
+  uint32_t inner[kHmacMaxDigestWords];
+  // SHA-2 state after the outer key block.
+  uint32_t outer[kHmacMaxDigestWords];
+  // Message length after one key block, as saved from HWIP.
+  uint32_t lower;
+  uint32_t upper;
+} hmac_keyed_state_t;
+
 typedef enum hmac_mode {
   // SHA2-256
   kHmacModeSha256,
@@ -213,6 +233,74 @@ status_t hmac(const hmac_mode_t hmac_mode, const uint32_t *key,
               size_t key_wordlen, const uint8_t *data, size_t len,
               uint32_t *digest, size_t digest_wordlen);
 
+/**
+ * SHA-2 of several messages, back to back.
+ *
+ * Hashes each of `messages` in turn, as `hmac` would with `key = NULL`, but
+ * programs the configuration only once and keeps MSG_FIFO busy from one
+ * message to the next, with no context save or restore in between. This is
+ * the fastest way to compute many independent digests, e.g. one per flash
+ * page.
+ *
+ * Each of `digests` must point to a buffer of `digest_wordlen` words.
+ *
+ * @param hmac_mode One of the SHA-2 modes.
+ * @param messages The messages to hash.
+ * @param message_lens Length of each message in bytes.
+ * @param[out] digests Buffers for the digest of each message.
+ * @param num_messages Number of messages.
+ * @param digest_wordlen The length of each digest in words.
+ * @return Result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+status_t hmac_sha2_batch(const hmac_mode_t hmac_mode,
+                         const uint8_t *const *messages,
+                         const size_t *message_lens, uint32_t *const *digests,
+                         size_t num_messages, size_t digest_wordlen);
+
+/**
+ * Precomputes the keyed state for repeated HMACs under one key.
+ *
+ * Hashes the inner and outer key blocks, each in its own SHA-2 operation, and
+ * saves the resulting states to `state`. See `hmac_keyed` for how the state
+ * is used.
+ *
+ * `key` is the processed key K0, with the same requirements as for
+ * `hmac_init`.
+ *
+ * @param[out] state Precomputed keyed state.
+ * @param hmac_mode One of the HMAC modes.
+ * @param key Processed HMAC key.
+ * @param key_wordlen The length of HMAC key, which must match the internal
+ * block size of the underlying hash function.
+ * @return Result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+status_t hmac_keyed_state_init(hmac_keyed_state_t *state,
+                               const hmac_mode_t hmac_mode,
+                               const uint32_t *key, size_t key_wordlen);
+
+/**
+ * One-shot HMAC from a precomputed keyed state.
+ *
+ * Computes the same tag as `hmac` with the key that `state` was computed from,
+ * but as two SHA-2 operations that resume from the saved states: the inner
+ * hash of the message and the outer hash of the inner digest. HMAC HWIP is
+ * cleared after each of them.
+ *
+ * @param state Keyed state from `hmac_keyed_state_init`.
+ * @param hmac_mode The HMAC mode `state` was computed for.
+ * @param data The message.
+ * @param len Length of the message in bytes.
+ * @param[out] digest The tag.
+ * @param digest_wordlen The length of the tag in words.
+ * @return Result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+status_t hmac_keyed(const hmac_keyed_state_t *state,
+                    const hmac_mode_t hmac_mode, const uint8_t *data,
+                    size_t len, uint32_t *digest, size_t digest_wordlen);
+
 #ifdef __cplusplus
 }
 #endif
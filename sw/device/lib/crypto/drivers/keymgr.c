@@ -7,6 +7,7 @@
 #include "sw/device/lib/base/abs_mmio.h"
 #include "sw/device/lib/base/bitfield.h"
 #include "sw/device/lib/base/memory.h"
+#include "sw/device/lib/crypto/drivers/clkmgr.h"
 #include "sw/device/lib/crypto/drivers/entropy.h"
 #include "sw/device/lib/crypto/impl/status.h"
 #include "sw/device/lib/runtime/hart.h"
@@ -113,6 +114,24 @@ static status_t keymgr_wait_until_done(void) {
   return OTCRYPTO_FATAL_ERR;
 }
 
+/**
+ * Starts an operation and waits for it to complete.
+ *
+ * The key manager derives keys with KMAC, so the KMAC clock must run until the
+ * operation is done.
+ *
+ * @param diversification Diversification input for the operation.
+ * @return OK or error.
+ */
+OT_WARN_UNUSED_RESULT
+static status_t keymgr_run(keymgr_diversification_t diversification) {
+  clkmgr_clock_acquire(kClkmgrClockKmac);
+  keymgr_start(diversification);
+  status_t result = keymgr_wait_until_done();
+  clkmgr_clock_release(kClkmgrClockKmac);
+  return result;
+}
+
 /**
  * Set the control register of the key manager.
  *
@@ -146,8 +165,7 @@ status_t keymgr_generate_key_sw(keymgr_diversification_t diversification,
   WRITE_CTRL(NONE, GENERATE_SW);
 
   // Start the operation and wait for it to complete.
-  keymgr_start(diversification);
-  HARDENED_TRY(keymgr_wait_until_done());
+  HARDENED_TRY(keymgr_run(diversification));
 
   // Collect output.
   // TODO: for SCA hardening, randomize the order of these reads.
@@ -174,8 +192,7 @@ status_t keymgr_generate_key_aes(keymgr_diversification_t diversification) {
   WRITE_CTRL(AES, GENERATE_HW);
 
   // Start the operation and wait for it to complete.
-  keymgr_start(diversification);
-  return keymgr_wait_until_done();
+  return keymgr_run(diversification);
 }
 
 status_t keymgr_generate_key_kmac(keymgr_diversification_t diversification) {
@@ -187,8 +204,7 @@ status_t keymgr_generate_key_kmac(keymgr_diversification_t diversification) {
   WRITE_CTRL(KMAC, GENERATE_HW);
 
   // Start the operation and wait for it to complete.
-  keymgr_start(diversification);
-  return keymgr_wait_until_done();
+  return keymgr_run(diversification);
 }
 
 status_t keymgr_generate_key_otbn(keymgr_diversification_t diversification) {
@@ -200,8 +216,7 @@ status_t keymgr_generate_key_otbn(keymgr_diversification_t diversification) {
   WRITE_CTRL(OTBN, GENERATE_HW);
 
   // Start the operation and wait for it to complete.
-  keymgr_start(diversification);
-  return keymgr_wait_until_done();
+  return keymgr_run(diversification);
 }
 
 /**
@@ -7,6 +7,8 @@
 #include "sw/device/lib/base/abs_mmio.h"
 #include "sw/device/lib/base/bitfield.h"
 #include "sw/device/lib/base/memory.h"
+#include "sw/device/lib/crypto/drivers/clkmgr.h"
+#include "sw/device/lib/crypto/drivers/dma.h"
 #include "sw/device/lib/crypto/drivers/entropy.h"
 #include "sw/device/lib/crypto/impl/status.h"
 
@@ -70,6 +72,24 @@ enum {
 // "KMAC" string in little endian
 static const uint8_t kKmacFuncNameKMAC[] = {0x4b, 0x4d, 0x41, 0x43};
 
+/**
+ * Whether a stream started with `kmac_stream_init()` holds the KMAC block.
+ */
+static hardened_bool_t stream_active = kHardenedBoolFalse;
+
+/**
+ * Identifier of the most recently started stream.
+ */
+static uint32_t stream_id = 0;
+
+/**
+ * Keeps the KMAC clock running from `kmac_init()` until the KMAC core is
+ * released with `CMD.DONE`.
+ */
+static clkmgr_hold_t clock_hold = {
+    .clock = kClkmgrClockKmac,
+};
+
 // We need 5 bytes at most for encoding the length of cust_str and func_name.
 // That leaves 39 bytes for the string. We simply truncate it to 36 bytes.
 OT_ASSERT_ENUM_VALUE(kKmacPrefixMaxSize, 4 * KMAC_PREFIX_MULTIREG_COUNT - 8);
@@ -231,10 +251,15 @@ status_t kmac_key_length_check(size_t key_len) {
   return kmac_get_key_len_bytes(key_len, &key_len_enum);
 }
 
-status_t kmac_hwip_default_configure(void) {
-  // Ensure that the entropy complex is initialized.
-  HARDENED_TRY(entropy_complex_check());
-
+/**
+ * Checks the KMAC block and writes the default configuration.
+ *
+ * The KMAC clock must be acquired.
+ *
+ * @return Error code.
+ */
+OT_WARN_UNUSED_RESULT
+static status_t kmac_hwip_configure(void) {
   uint32_t status_reg = abs_mmio_read32(kKmacBaseAddr + KMAC_STATUS_REG_OFFSET);
 
   // Check that core is not in fault state
@@ -325,6 +350,16 @@ status_t kmac_hwip_default_configure(void) {
   return OTCRYPTO_OK;
 }
 
+status_t kmac_hwip_default_configure(void) {
+  // Ensure that the entropy complex is initialized.
+  HARDENED_TRY(entropy_complex_check());
+
+  clkmgr_clock_acquire(kClkmgrClockKmac);
+  status_t result = kmac_hwip_configure();
+  clkmgr_clock_release(kClkmgrClockKmac);
+  return result;
+}
+
 /**
  * Wait until given status bit is set.
  *
@@ -354,6 +389,34 @@ static status_t wait_status_bit(uint32_t bit_position, bool bit_value) {
   }
 }
 
+/**
+ * Read the number of free bytes in the message FIFO.
+ *
+ * Derived from `STATUS.fifo_depth`; the FIFO holds
+ * `KMAC_PARAM_NUM_ENTRIES_MSG_FIFO` entries of
+ * `KMAC_PARAM_NUM_BYTES_MSG_FIFO_ENTRY` bytes each.
+ *
+ * @param[out] free_bytes Number of bytes that can be written without stalling.
+ * @return Error status.
+ */
+OT_WARN_UNUSED_RESULT
+static status_t fifo_free_bytes(size_t *free_bytes) {
+  uint32_t reg = abs_mmio_read32(kKmacBaseAddr + KMAC_STATUS_REG_OFFSET);
+  if (bitfield_bit32_read(reg, KMAC_STATUS_ALERT_FATAL_FAULT_BIT)) {
+    return OTCRYPTO_FATAL_ERR;
+  }
+  if (bitfield_bit32_read(reg, KMAC_STATUS_ALERT_RECOV_CTRL_UPDATE_ERR_BIT)) {
+    return OTCRYPTO_RECOV_ERR;
+  }
+  uint32_t depth = bitfield_field32_read(reg, KMAC_STATUS_FIFO_DEPTH_FIELD);
+  if (depth > KMAC_PARAM_NUM_ENTRIES_MSG_FIFO) {
+    return OTCRYPTO_FATAL_ERR;
+  }
+  *free_bytes = (KMAC_PARAM_NUM_ENTRIES_MSG_FIFO - depth) *
+                KMAC_PARAM_NUM_BYTES_MSG_FIFO_ENTRY;
+  return OTCRYPTO_OK;
+}
+
 /**
  * Encode a given integer as byte array and return its size along with it.
  *
@@ -476,6 +539,14 @@ OT_WARN_UNUSED_RESULT
 static status_t kmac_init(kmac_operation_t operation,
                           kmac_security_str_t security_str,
                           hardened_bool_t hw_backed) {
+  // An active stream keeps its sponge state in the KMAC block, so KMAC would
+  // never become idle.
+  if (launder32(stream_active) != kHardenedBoolFalse) {
+    return OTCRYPTO_RECOV_ERR;
+  }
+  HARDENED_CHECK_EQ(stream_active, kHardenedBoolFalse);
+
+  clkmgr_hold_acquire(&clock_hold);
   HARDENED_TRY(wait_status_bit(KMAC_STATUS_SHA3_IDLE_BIT, 1));
 
   // If the operation is KMAC, ensure that the entropy complex has been
@@ -579,6 +650,71 @@ static status_t kmac_write_key_block(kmac_blinded_key_t *key) {
   return OTCRYPTO_OK;
 }
 
+/**
+ * Write message bytes to the KMAC message FIFO.
+ *
+ * KMAC must be in the absorbing phase. If DMA feeding is enabled (see
+ * `dma_feed_enable()`), the word-aligned part of long messages is copied by
+ * the DMA controller.
+ *
+ * @param message Input message string.
+ * @param message_len Message length in bytes.
+ * @return Error code.
+ */
+OT_WARN_UNUSED_RESULT
+static status_t kmac_write_msg(const uint8_t *message, size_t message_len) {
+  // Begin by writing a one byte at a time until the data is aligned.
+  size_t i = 0;
+  for (; misalignment32_of((uintptr_t)(&message[i])) > 0 && i < message_len;
+       i++) {
+    HARDENED_TRY(wait_status_bit(KMAC_STATUS_FIFO_FULL_BIT, 0));
+    abs_mmio_write8(kKmacBaseAddr + KMAC_MSG_FIFO_REG_OFFSET, message[i]);
+  }
+
+  // Hand the full words to the DMA controller if it is enabled. The FIFO
+  // stalls the bus while it is full, so it does not need to be polled.
+  size_t words_len = (message_len - i) & ~(sizeof(uint32_t) - 1);
+  if (dma_feed_applicable(words_len) == kHardenedBoolTrue) {
+    HARDENED_TRY(dma_feed_fifo(&message[i], words_len,
+                               kKmacBaseAddr + KMAC_MSG_FIFO_REG_OFFSET));
+    i += words_len;
+  }
+
+  // Write the remaining full words in bursts sized to the free space in the
+  // FIFO, so that the status register is read once per burst rather than once
+  // per word.
+  while (i + sizeof(uint32_t) <= message_len) {
+    size_t free_bytes;
+    HARDENED_TRY(fifo_free_bytes(&free_bytes));
+    size_t burst_end = i + (free_bytes & ~(sizeof(uint32_t) - 1));
+    if (burst_end > message_len) {
+      burst_end = message_len;
+    }
+    for (; i + sizeof(uint32_t) <= burst_end; i += sizeof(uint32_t)) {
+      uint32_t next_word = read_32(&message[i]);
+      abs_mmio_write32(kKmacBaseAddr + KMAC_MSG_FIFO_REG_OFFSET, next_word);
+    }
+  }
+
+  // For the last few bytes, we need to write one byte at a time again.
+  for (; i < message_len; i++) {
+    HARDENED_TRY(wait_status_bit(KMAC_STATUS_FIFO_FULL_BIT, 0));
+    abs_mmio_write8(kKmacBaseAddr + KMAC_MSG_FIFO_REG_OFFSET, message[i]);
+  }
+  return OTCRYPTO_OK;
+}
+
+/**
+ * Issue a command through the CMD register.
+ *
+ * @param cmd Command value, e.g. `KMAC_CMD_CMD_VALUE_START`.
+ */
+static void kmac_issue_cmd(uint32_t cmd) {
+  uint32_t cmd_reg = KMAC_CMD_REG_RESVAL;
+  cmd_reg = bitfield_field32_write(cmd_reg, KMAC_CMD_CMD_FIELD, cmd);
+  abs_mmio_write32(kKmacBaseAddr + KMAC_CMD_REG_OFFSET, cmd_reg);
+}
+
 /**
  * Common routine for feeding message blocks during SHA/SHAKE/cSHAKE/KMAC.
  *
@@ -623,26 +759,7 @@ static status_t kmac_process_msg_blocks(kmac_operation_t operation,
   abs_mmio_write32(kKmacBaseAddr + KMAC_CMD_REG_OFFSET, cmd_reg);
   HARDENED_TRY(wait_status_bit(KMAC_STATUS_SHA3_ABSORB_BIT, 1));
 
-  // Begin by writing a one byte at a time until the data is aligned.
-  size_t i = 0;
-  for (; misalignment32_of((uintptr_t)(&message[i])) > 0 && i < message_len;
-       i++) {
-    HARDENED_TRY(wait_status_bit(KMAC_STATUS_FIFO_FULL_BIT, 0));
-    abs_mmio_write8(kKmacBaseAddr + KMAC_MSG_FIFO_REG_OFFSET, message[i]);
-  }
-
-  // Write one word at a time as long as there is a full word available.
-  for (; i + sizeof(uint32_t) <= message_len; i += sizeof(uint32_t)) {
-    HARDENED_TRY(wait_status_bit(KMAC_STATUS_FIFO_FULL_BIT, 0));
-    uint32_t next_word = read_32(&message[i]);
-    abs_mmio_write32(kKmacBaseAddr + KMAC_MSG_FIFO_REG_OFFSET, next_word);
-  }
-
-  // For the last few bytes, we need to write one byte at a time again.
-  for (; i < message_len; i++) {
-    HARDENED_TRY(wait_status_bit(KMAC_STATUS_FIFO_FULL_BIT, 0));
-    abs_mmio_write8(kKmacBaseAddr + KMAC_MSG_FIFO_REG_OFFSET, message[i]);
-  }
+  HARDENED_TRY(kmac_write_msg(message, message_len));
 
   // If operation=KMAC, then we need to write `right_encode(digest->len)`
   if (operation == kKmacOperationKMAC) {
@@ -748,6 +865,7 @@ static status_t kmac_process_msg_blocks(kmac_operation_t operation,
   cmd_reg = bitfield_field32_write(cmd_reg, KMAC_CMD_CMD_FIELD,
                                    KMAC_CMD_CMD_VALUE_DONE);
   abs_mmio_write32(kKmacBaseAddr + KMAC_CMD_REG_OFFSET, cmd_reg);
+  clkmgr_hold_release(&clock_hold);
 
   return OTCRYPTO_OK;
 }
@@ -903,3 +1021,159 @@ status_t kmac_kmac_256(kmac_blinded_key_t *key, hardened_bool_t masked_digest,
   return kmac_process_msg_blocks(kKmacOperationKMAC, message, message_len,
                                  digest, digest_len, masked_digest);
 }
+
+/**
+ * Check that `ctx` belongs to the active stream.
+ *
+ * @param ctx Stream context.
+ * @return Error code.
+ */
+OT_WARN_UNUSED_RESULT
+static status_t kmac_stream_check(const kmac_ctx_t *ctx) {
+  if (ctx == NULL || launder32(stream_active) != kHardenedBoolTrue ||
+      ctx->stream_id != stream_id) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+  HARDENED_CHECK_EQ(stream_active, kHardenedBoolTrue);
+  return OTCRYPTO_OK;
+}
+
+status_t kmac_stream_init(kmac_ctx_t *ctx, kmac_stream_mode_t mode,
+                          const unsigned char *func_name, size_t func_name_len,
+                          const unsigned char *cust_str, size_t cust_str_len) {
+  if (ctx == NULL) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+
+  kmac_operation_t operation;
+  kmac_security_str_t security_str;
+  switch (mode) {
+    case kKmacStreamModeSha3_224:
+      operation = kKmacOperationSHA3;
+      security_str = kKmacSecurityStrength224;
+      break;
+    case kKmacStreamModeSha3_256:
+      operation = kKmacOperationSHA3;
+      security_str = kKmacSecurityStrength256;
+      break;
+    case kKmacStreamModeSha3_384:
+      operation = kKmacOperationSHA3;
+      security_str = kKmacSecurityStrength384;
+      break;
+    case kKmacStreamModeSha3_512:
+      operation = kKmacOperationSHA3;
+      security_str = kKmacSecurityStrength512;
+      break;
+    case kKmacStreamModeShake128:
+      operation = kKmacOperationSHAKE;
+      security_str = kKmacSecurityStrength128;
+      break;
+    case kKmacStreamModeShake256:
+      operation = kKmacOperationSHAKE;
+      security_str = kKmacSecurityStrength256;
+      break;
+    case kKmacStreamModeCshake128:
+      operation = kKmacOperationCSHAKE;
+      security_str = kKmacSecurityStrength128;
+      break;
+    case kKmacStreamModeCshake256:
+      operation = kKmacOperationCSHAKE;
+      security_str = kKmacSecurityStrength256;
+      break;
+    default:
+      return OTCRYPTO_BAD_ARGS;
+  }
+  if (operation != kKmacOperationCSHAKE &&
+      (func_name_len != 0 || cust_str_len != 0)) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+
+  HARDENED_TRY(kmac_init(operation, security_str,
+                         /*hw_backed=*/kHardenedBoolFalse));
+  if (operation == kKmacOperationCSHAKE) {
+    HARDENED_TRY(kmac_write_prefix_block(operation, func_name, func_name_len,
+                                         cust_str, cust_str_len));
+  }
+  HARDENED_TRY(kmac_get_keccak_rate_words(security_str, &ctx->rate_words));
+
+  kmac_issue_cmd(KMAC_CMD_CMD_VALUE_START);
+  HARDENED_TRY(wait_status_bit(KMAC_STATUS_SHA3_ABSORB_BIT, 1));
+
+  stream_id++;
+  stream_active = kHardenedBoolTrue;
+  ctx->stream_id = stream_id;
+  ctx->squeezing = kHardenedBoolFalse;
+  ctx->squeeze_offset = 0;
+  return OTCRYPTO_OK;
+}
+
+status_t kmac_stream_absorb(kmac_ctx_t *ctx, const uint8_t *message,
+                            size_t message_len) {
+  HARDENED_TRY(kmac_stream_check(ctx));
+  if (launder32(ctx->squeezing) != kHardenedBoolFalse) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+  HARDENED_CHECK_EQ(ctx->squeezing, kHardenedBoolFalse);
+
+  return kmac_write_msg(message, message_len);
+}
+
+status_t kmac_stream_squeeze(kmac_ctx_t *ctx, uint32_t *digest,
+                             size_t digest_len) {
+  HARDENED_TRY(kmac_stream_check(ctx));
+
+  // The first squeeze ends the absorbing phase.
+  if (launder32(ctx->squeezing) == kHardenedBoolFalse) {
+    HARDENED_CHECK_EQ(ctx->squeezing, kHardenedBoolFalse);
+    kmac_issue_cmd(KMAC_CMD_CMD_VALUE_PROCESS);
+    ctx->squeezing = kHardenedBoolTrue;
+    ctx->squeeze_offset = 0;
+  }
+  HARDENED_CHECK_EQ(ctx->squeezing, kHardenedBoolTrue);
+
+  size_t idx = 0;
+  while (launder32(idx) < digest_len) {
+    // Once the current state block is used up, issue `CMD.RUN` to generate
+    // more state.
+    if (launder32(ctx->squeeze_offset) == ctx->rate_words) {
+      HARDENED_CHECK_EQ(ctx->squeeze_offset, ctx->rate_words);
+      kmac_issue_cmd(KMAC_CMD_CMD_VALUE_RUN);
+      ctx->squeeze_offset = 0;
+    }
+
+    // Poll the status register until in the 'squeeze' state.
+    HARDENED_TRY(wait_status_bit(KMAC_STATUS_SHA3_SQUEEZE_BIT, 1));
+
+    // Unmask the output as we read it.
+    for (; launder32(idx) < digest_len &&
+           ctx->squeeze_offset < ctx->rate_words;
+         ctx->squeeze_offset++) {
+      uint32_t offset = ctx->squeeze_offset * sizeof(uint32_t);
+      digest[idx] = abs_mmio_read32(kKmacStateShare0Addr + offset);
+      digest[idx] ^= abs_mmio_read32(kKmacStateShare1Addr + offset);
+      idx++;
+    }
+  }
+  HARDENED_CHECK_EQ(idx, digest_len);
+
+  return OTCRYPTO_OK;
+}
+
+status_t kmac_stream_final(kmac_ctx_t *ctx) {
+  HARDENED_TRY(kmac_stream_check(ctx));
+
+  // `CMD.DONE` is only accepted in the squeezing phase.
+  if (launder32(ctx->squeezing) == kHardenedBoolFalse) {
+    HARDENED_CHECK_EQ(ctx->squeezing, kHardenedBoolFalse);
+    kmac_issue_cmd(KMAC_CMD_CMD_VALUE_PROCESS);
+    ctx->squeezing = kHardenedBoolTrue;
+  }
+  HARDENED_TRY(wait_status_bit(KMAC_STATUS_SHA3_SQUEEZE_BIT, 1));
+
+  // Release the KMAC core, so that it goes back to idle mode
+  kmac_issue_cmd(KMAC_CMD_CMD_VALUE_DONE);
+  clkmgr_hold_release(&clock_hold);
+  stream_active = kHardenedBoolFalse;
+  ctx->stream_id = 0;
+  return OTCRYPTO_OK;
+}
@@ -57,6 +57,49 @@ typedef struct kmac_blinded_key {
   hardened_bool_t hw_backed;
 } kmac_blinded_key_t;
 
+/**
+ * Hash modes supported by the KMAC streaming interface.
+ */
+typedef enum kmac_stream_mode {
+  // SHA3-224
+  kKmacStreamModeSha3_224,
+  // SHA3-256
+  kKmacStreamModeSha3_256,
+  // SHA3-384
+  kKmacStreamModeSha3_384,
+  // SHA3-512
+  kKmacStreamModeSha3_512,
+  // SHAKE128
+  kKmacStreamModeShake128,
+  // SHAKE256
+  kKmacStreamModeShake256,
+  // cSHAKE128
+  kKmacStreamModeCshake128,
+  // cSHAKE256
+  kKmacStreamModeCshake256,
+} kmac_stream_mode_t;
+
+/**
+ * Context for a streaming SHA-3/SHAKE/cSHAKE operation.
+ *
+ * Unlike the HMAC block, KMAC cannot restore a Keccak state written by
+ * software, so the sponge state stays in the KMAC block for the whole stream.
+ * This context only records the driver-side state needed to resume the
+ * operation. As a consequence, only one stream can be in progress at a time,
+ * and other KMAC operations fail until the stream is ended with
+ * `kmac_stream_final()`.
+ */
+typedef struct kmac_ctx {
+  // Identifies the stream that owns the KMAC block.
+  uint32_t stream_id;
+  // Keccak rate of the operation in 32-bit words.
+  size_t rate_words;
+  // Whether the sponge has moved on to the squeezing phase.
+  hardened_bool_t squeezing;
+  // Number of words of the current state block already read out.
+  size_t squeeze_offset;
+} kmac_ctx_t;
+
 /**
  * Check whether given key length is valid for KMAC.
 
@@ -293,6 +336,73 @@ status_t kmac_kmac_256(kmac_blinded_key_t *key, hardened_bool_t masked_digest,
                        const unsigned char *cust_str, size_t cust_str_len,
                        uint32_t *digest, size_t digest_len);
 
+/**
+ * Start a streaming SHA-3, SHAKE or cSHAKE operation.
+ *
+ * Configures KMAC for `mode` and puts it in the absorbing phase. The KMAC
+ * block stays reserved for this stream until `kmac_stream_final()` is called
+ * on it.
+ *
+ * `func_name` and `cust_str` are only used for cSHAKE and must be empty for
+ * the other modes. In total they can be at most `kKmacPrefixMaxSize` bytes.
+ *
+ * @param[out] ctx Stream context to initialize.
+ * @param mode Hash mode.
+ * @param func_name The function name (cSHAKE only).
+ * @param func_name_len The function name length in bytes.
+ * @param cust_str The customization string (cSHAKE only).
+ * @param cust_str_len The customization string length in bytes.
+ * @return Error status; `OTCRYPTO_RECOV_ERR` if another stream is active.
+ */
+OT_WARN_UNUSED_RESULT
+status_t kmac_stream_init(kmac_ctx_t *ctx, kmac_stream_mode_t mode,
+                          const unsigned char *func_name, size_t func_name_len,
+                          const unsigned char *cust_str, size_t cust_str_len);
+
+/**
+ * Absorb more message bytes into a streaming operation.
+ *
+ * The message is written straight to the KMAC message FIFO, so there is no
+ * limit on the total message length and no data is buffered in `ctx`. Must
+ * not be called after `kmac_stream_squeeze()`.
+ *
+ * @param ctx Stream context.
+ * @param message The input message.
+ * @param message_len The input message length in bytes.
+ * @return Error status.
+ */
+OT_WARN_UNUSED_RESULT
+status_t kmac_stream_absorb(kmac_ctx_t *ctx, const uint8_t *message,
+                            size_t message_len);
+
+/**
+ * Read output words from a streaming operation.
+ *
+ * The first call ends the absorbing phase. Each call continues where the
+ * previous one stopped, so an XOF can be squeezed on demand in chunks of any
+ * number of words. For fixed-length SHA-3, the caller must squeeze the digest
+ * with a single call.
+ *
+ * @param ctx Stream context.
+ * @param[out] digest Output buffer for the result.
+ * @param digest_len Requested output length in 32-bit words.
+ * @return Error status.
+ */
+OT_WARN_UNUSED_RESULT
+status_t kmac_stream_squeeze(kmac_ctx_t *ctx, uint32_t *digest,
+                             size_t digest_len);
+
+/**
+ * End a streaming operation and release the KMAC block.
+ *
+ * May be called in either phase, e.g. to abandon a stream.
+ *
+ * @param ctx Stream context.
+ * @return Error status.
+ */
+OT_WARN_UNUSED_RESULT
+status_t kmac_stream_final(kmac_ctx_t *ctx);
+
 #ifdef __cplusplus
 }
 #endif
@@ -9,11 +9,13 @@
 #include "sw/device/lib/base/hardened.h"
 #include "sw/device/lib/base/macros.h"
 #include "sw/device/lib/base/status.h"
+#include "sw/device/lib/crypto/drivers/clkmgr.h"
 #include "sw/device/lib/crypto/drivers/entropy.h"
 #include "sw/device/lib/crypto/impl/status.h"
 
 #include "hw/top_earlgrey/sw/autogen/top_earlgrey.h"
-#include "otbn_regs.h"  // Generated.
+#include "otbn_regs.h"           // Generated.
+#include "rv_core_ibex_regs.h"  // Generated.
 
 // Module ID for status codes.
 #define MODULE_ID MAKE_MODULE_ID('d', 'b', 'n')
@@ -31,6 +33,15 @@ enum {
    * IMEM size in bytes.
    */
   kOtbnIMemSizeBytes = OTBN_IMEM_SIZE_BYTES,
+  /**
+   * Base address for the Ibex wrapper, whose RND_DATA register provides the
+   * random start index of DMEM writes.
+   */
+  kIbexBase = TOP_EARLGREY_RV_CORE_IBEX_CFG_BASE_ADDR,
+  /**
+   * Number of RND_STATUS polls before giving up on fresh data from EDN.
+   */
+  kRndNumIterTimeout = 1000,
   /**
    * ERR_BITS register value in the case of no errors.
    *
@@ -63,6 +74,41 @@ typedef enum otbn_status {
   kOtbnStatusLocked = 0xFF,
 } otbn_status_t;
 
+/**
+ * The application currently resident in IMEM.
+ */
+typedef struct otbn_resident_app {
+  /**
+   * `kHardenedBoolTrue` if IMEM holds the application below.
+   */
+  hardened_bool_t valid;
+  /**
+   * Start and end of the application's IMEM image.
+   */
+  const uint32_t *imem_start;
+  const uint32_t *imem_end;
+  /**
+   * The application's checksum.
+   */
+  uint32_t checksum;
+  /**
+   * Value of `LOAD_CHECKSUM` after writing IMEM, before writing DMEM.
+   */
+  uint32_t imem_checksum;
+} otbn_resident_app_t;
+
+static otbn_resident_app_t resident_app = {
+    .valid = kHardenedBoolFalse,
+};
+
+static otbn_load_policy_t load_policy = kOtbnLoadPolicyAlwaysWipe;
+
+void otbn_load_policy_set(otbn_load_policy_t policy) { load_policy = policy; }
+
+void otbn_resident_app_invalidate(void) {
+  resident_app.valid = kHardenedBoolFalse;
+}
+
 /**
  * Ensures that a memory access fits within the given memory size.
  *
@@ -113,48 +159,136 @@ static status_t otbn_assert_idle(void) {
   return OTCRYPTO_ASYNC_INCOMPLETE;
 }
 
+/**
+ * Picks a random index less than `num_words` to start a transfer at.
+ *
+ * The index is taken from Ibex's RND_DATA register, like the silicon_creator
+ * OTBN driver does. It waits for fresh data from EDN, so the entropy complex
+ * must be running; this fails instead of hanging if it is not.
+ *
+ * @param num_words Number of words in the transfer.
+ * @param[out] start Start index (0 if `num_words` is 0).
+ * @return Result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+static status_t otbn_random_start(size_t num_words, size_t *start) {
+  uint32_t attempt_cnt = 0;
+  while (!bitfield_bit32_read(
+      abs_mmio_read32(kIbexBase + RV_CORE_IBEX_RND_STATUS_REG_OFFSET),
+      RV_CORE_IBEX_RND_STATUS_RND_DATA_VALID_BIT)) {
+    attempt_cnt++;
+    if (attempt_cnt >= kRndNumIterTimeout) {
+      return OTCRYPTO_FATAL_ERR;
+    }
+  }
+  uint32_t rnd = abs_mmio_read32(kIbexBase + RV_CORE_IBEX_RND_DATA_REG_OFFSET);
+  *start = ((uint64_t)rnd * (uint64_t)num_words) >> 32;
+  return OTCRYPTO_OK;
+}
+
+/**
+ * Copies words `start` to `end - 1` of `src` to OTBN's DMEM or IMEM.
+ *
+ * The loop is unrolled four times and has no per-word hardening; the caller
+ * checks the returned count once the whole transfer is done.
+ *
+ * @param dest_addr Destination address of word 0.
+ * @param src Source buffer.
+ * @param start First word to copy.
+ * @param end One past the last word to copy.
+ * @return Number of words copied.
+ */
+static size_t otbn_write_range(uint32_t dest_addr, const uint32_t *src,
+                               size_t start, size_t end) {
+  size_t i = start;
+  for (; launder32(i) + 4 <= end; i += 4) {
+    abs_mmio_write32(dest_addr + i * sizeof(uint32_t), src[i]);
+    abs_mmio_write32(dest_addr + (i + 1) * sizeof(uint32_t), src[i + 1]);
+    abs_mmio_write32(dest_addr + (i + 2) * sizeof(uint32_t), src[i + 2]);
+    abs_mmio_write32(dest_addr + (i + 3) * sizeof(uint32_t), src[i + 3]);
+  }
+  for (; launder32(i) < end; ++i) {
+    abs_mmio_write32(dest_addr + i * sizeof(uint32_t), src[i]);
+  }
+  return i - start;
+}
+
+/**
+ * Copies words `start` to `end - 1` of OTBN's DMEM to `dest`.
+ *
+ * See `otbn_write_range()`.
+ *
+ * @param src_addr Source address of word 0.
+ * @param dest Destination buffer.
+ * @param start First word to copy.
+ * @param end One past the last word to copy.
+ * @return Number of words copied.
+ */
+static size_t otbn_read_range(uint32_t src_addr, uint32_t *dest, size_t start,
+                              size_t end) {
+  size_t i = start;
+  for (; launder32(i) + 4 <= end; i += 4) {
+    dest[i] = abs_mmio_read32(src_addr + i * sizeof(uint32_t));
+    dest[i + 1] = abs_mmio_read32(src_addr + (i + 1) * sizeof(uint32_t));
+    dest[i + 2] = abs_mmio_read32(src_addr + (i + 2) * sizeof(uint32_t));
+    dest[i + 3] = abs_mmio_read32(src_addr + (i + 3) * sizeof(uint32_t));
+  }
+  for (; launder32(i) < end; ++i) {
+    dest[i] = abs_mmio_read32(src_addr + i * sizeof(uint32_t));
+  }
+  return i - start;
+}
+
 /**
  * Helper function for writing to OTBN's DMEM or IMEM.
  *
+ * Like `hardened_memcpy()`, the copy starts at a random word (wrapping around
+ * at the end) and the number of words copied is checked once at the end,
+ * rather than on every word.
+ *
  * @param dest_addr Destination address.
  * @param src Source buffer.
  * @param num_words Number of words to copy.
+ * @return Result of the operation.
  */
-static void otbn_write(uint32_t dest_addr, const uint32_t *src,
-                       size_t num_words) {
-  // TODO: replace 0 with a random index like the silicon_creator driver
-  // (requires an interface to Ibex's RND valid bit and data register).
-  size_t i = ((uint64_t)0 * (uint64_t)num_words) >> 32;
-  enum { kStep = 1 };
-  size_t iter_cnt = 0;
-  for (; launder32(iter_cnt) < num_words; ++iter_cnt) {
-    abs_mmio_write32(dest_addr + i * sizeof(uint32_t), src[i]);
-    i += kStep;
-    if (launder32(i) >= num_words) {
-      i -= num_words;
-    }
-    HARDENED_CHECK_LT(i, num_words);
-  }
-  HARDENED_CHECK_EQ(iter_cnt, num_words);
+OT_WARN_UNUSED_RESULT
+static status_t otbn_write(uint32_t dest_addr, const uint32_t *src,
+                           size_t num_words) {
+  size_t start = 0;
+  HARDENED_TRY(otbn_random_start(num_words, &start));
+  size_t count = otbn_write_range(dest_addr, src, start, num_words);
+  count += otbn_write_range(dest_addr, src, 0, start);
+  HARDENED_CHECK_EQ(count, num_words);
+  return OTCRYPTO_OK;
 }
 
 status_t otbn_dmem_write(size_t num_words, const uint32_t *src,
                          otbn_addr_t dest) {
   HARDENED_TRY(check_offset_len(dest, num_words, kOtbnDMemSizeBytes));
-  otbn_write(kBase + OTBN_DMEM_REG_OFFSET + dest, src, num_words);
-  return OTCRYPTO_OK;
+  clkmgr_clock_acquire(kClkmgrClockOtbn);
+  status_t result = otbn_write(kBase + OTBN_DMEM_REG_OFFSET + dest, src,
+                               num_words);
+  clkmgr_clock_release(kClkmgrClockOtbn);
+  return result;
 }
 
 status_t otbn_dmem_set(size_t num_words, const uint32_t src, otbn_addr_t dest) {
   HARDENED_TRY(check_offset_len(dest, num_words, kOtbnDMemSizeBytes));
 
   // No need to randomize here, since all the values are the same.
+  uint32_t dest_addr = kBase + OTBN_DMEM_REG_OFFSET + dest;
+  clkmgr_clock_acquire(kClkmgrClockOtbn);
   size_t i = 0;
+  for (; launder32(i) + 4 <= num_words; i += 4) {
+    abs_mmio_write32(dest_addr + i * sizeof(uint32_t), src);
+    abs_mmio_write32(dest_addr + (i + 1) * sizeof(uint32_t), src);
+    abs_mmio_write32(dest_addr + (i + 2) * sizeof(uint32_t), src);
+    abs_mmio_write32(dest_addr + (i + 3) * sizeof(uint32_t), src);
+  }
   for (; launder32(i) < num_words; ++i) {
-    abs_mmio_write32(kBase + OTBN_DMEM_REG_OFFSET + dest + i * sizeof(uint32_t),
-                     src);
-    HARDENED_CHECK_LT(i, num_words);
+    abs_mmio_write32(dest_addr + i * sizeof(uint32_t), src);
   }
+  clkmgr_clock_release(kClkmgrClockOtbn);
   HARDENED_CHECK_EQ(i, num_words);
   return OTCRYPTO_OK;
 }
@@ -162,17 +296,39 @@ status_t otbn_dmem_set(size_t num_words, const uint32_t src, otbn_addr_t dest) {
 status_t otbn_dmem_read(size_t num_words, otbn_addr_t src, uint32_t *dest) {
   HARDENED_TRY(check_offset_len(src, num_words, kOtbnDMemSizeBytes));
 
-  size_t i = 0;
-  for (; launder32(i) < num_words; ++i) {
-    dest[i] = abs_mmio_read32(kBase + OTBN_DMEM_REG_OFFSET + src +
-                              i * sizeof(uint32_t));
-  }
-  HARDENED_CHECK_EQ(i, num_words);
+  uint32_t src_addr = kBase + OTBN_DMEM_REG_OFFSET + src;
+  size_t start = 0;
+  HARDENED_TRY(otbn_random_start(num_words, &start));
+  clkmgr_clock_acquire(kClkmgrClockOtbn);
+  size_t count = otbn_read_range(src_addr, dest, start, num_words);
+  count += otbn_read_range(src_addr, dest, 0, start);
+  clkmgr_clock_release(kClkmgrClockOtbn);
+  HARDENED_CHECK_EQ(count, num_words);
 
   return OTCRYPTO_OK;
 }
 
-status_t otbn_execute(void) {
+status_t otbn_dmem_read_at(size_t num_words, otbn_addr_t src,
+                           size_t offset_words, uint32_t *dest) {
+  if (offset_words > kOtbnDMemSizeBytes / sizeof(uint32_t)) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+  uint32_t offset_bytes = offset_words * sizeof(uint32_t);
+  if (src > UINT32_MAX - offset_bytes) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+  return otbn_dmem_read(num_words, src + offset_bytes, dest);
+}
+
+/**
+ * Starts the execution of the loaded application.
+ *
+ * The OTBN clock must be acquired.
+ *
+ * @return Result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+static status_t execute(void) {
   // Ensure that the entropy complex is in a good state (for the RND
   // instruction and data wiping).
   HARDENED_TRY(entropy_complex_check());
@@ -184,7 +340,24 @@ status_t otbn_execute(void) {
   return OTCRYPTO_OK;
 }
 
-status_t otbn_busy_wait_for_done(void) {
+status_t otbn_execute(void) {
+  // OTBN is not idle while it runs, so the clock manager keeps its clock
+  // running until the application is done.
+  clkmgr_clock_acquire(kClkmgrClockOtbn);
+  status_t result = execute();
+  clkmgr_clock_release(kClkmgrClockOtbn);
+  return result;
+}
+
+/**
+ * Waits until OTBN is done and checks for errors.
+ *
+ * The OTBN clock must be acquired.
+ *
+ * @return Result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+static status_t busy_wait_for_done(void) {
   uint32_t status = launder32(UINT32_MAX);
   status_t res = (status_t){
       .value = (int32_t)launder32((uint32_t)kHardenedBoolTrue ^ status)};
@@ -206,6 +379,9 @@ status_t otbn_busy_wait_for_done(void) {
     return res;
   }
 
+  // OTBN may have wiped its memories on the error.
+  otbn_resident_app_invalidate();
+
   // If OTBN is idle (not locked), then return a recoverable error.
   if (launder32(status) == kOtbnStatusIdle) {
     HARDENED_CHECK_EQ(status, kOtbnStatusIdle);
@@ -217,31 +393,116 @@ status_t otbn_busy_wait_for_done(void) {
   return OTCRYPTO_FATAL_ERR;
 }
 
+status_t otbn_busy_wait_for_done(void) {
+  clkmgr_clock_acquire(kClkmgrClockOtbn);
+  status_t result = busy_wait_for_done();
+  clkmgr_clock_release(kClkmgrClockOtbn);
+  return result;
+}
+
+status_t otbn_poll_done(void) {
+  clkmgr_clock_acquire(kClkmgrClockOtbn);
+  status_t result = OTCRYPTO_ASYNC_INCOMPLETE;
+  uint32_t status = abs_mmio_read32(kBase + OTBN_STATUS_REG_OFFSET);
+  if (status == kOtbnStatusIdle || status == kOtbnStatusLocked) {
+    result = busy_wait_for_done();
+  }
+  clkmgr_clock_release(kClkmgrClockOtbn);
+  return result;
+}
+
+void otbn_irq_done_enable(bool enable) {
+  clkmgr_clock_acquire(kClkmgrClockOtbn);
+  abs_mmio_write32(kBase + OTBN_INTR_ENABLE_REG_OFFSET,
+                   enable ? 1u << OTBN_INTR_COMMON_DONE_BIT : 0);
+  clkmgr_clock_release(kClkmgrClockOtbn);
+}
+
+bool otbn_irq_done_enabled(void) {
+  clkmgr_clock_acquire(kClkmgrClockOtbn);
+  uint32_t reg = abs_mmio_read32(kBase + OTBN_INTR_ENABLE_REG_OFFSET);
+  clkmgr_clock_release(kClkmgrClockOtbn);
+  return bitfield_bit32_read(reg, OTBN_INTR_COMMON_DONE_BIT);
+}
+
+void otbn_irq_done_acknowledge(void) {
+  clkmgr_clock_acquire(kClkmgrClockOtbn);
+  abs_mmio_write32(kBase + OTBN_INTR_STATE_REG_OFFSET,
+                   1u << OTBN_INTR_COMMON_DONE_BIT);
+  clkmgr_clock_release(kClkmgrClockOtbn);
+}
+
 uint32_t otbn_err_bits_get(void) {
-  return abs_mmio_read32(kBase + OTBN_ERR_BITS_REG_OFFSET);
+  clkmgr_clock_acquire(kClkmgrClockOtbn);
+  uint32_t err_bits = abs_mmio_read32(kBase + OTBN_ERR_BITS_REG_OFFSET);
+  clkmgr_clock_release(kClkmgrClockOtbn);
+  return err_bits;
 }
 
 uint32_t otbn_instruction_count_get(void) {
-  return abs_mmio_read32(kBase + OTBN_INSN_CNT_REG_OFFSET);
+  clkmgr_clock_acquire(kClkmgrClockOtbn);
+  uint32_t count = abs_mmio_read32(kBase + OTBN_INSN_CNT_REG_OFFSET);
+  clkmgr_clock_release(kClkmgrClockOtbn);
+  return count;
 }
 
-status_t otbn_imem_sec_wipe(void) {
+/**
+ * Securely wipes IMEM.
+ *
+ * The OTBN clock must be acquired.
+ *
+ * @return Result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+static status_t imem_sec_wipe(void) {
   HARDENED_TRY(entropy_complex_check());
   HARDENED_TRY(otbn_assert_idle());
+  otbn_resident_app_invalidate();
   abs_mmio_write32(kBase + OTBN_CMD_REG_OFFSET, kOtbnCmdSecWipeImem);
-  HARDENED_TRY(otbn_busy_wait_for_done());
+  HARDENED_TRY(busy_wait_for_done());
   return OTCRYPTO_OK;
 }
 
-status_t otbn_dmem_sec_wipe(void) {
+status_t otbn_imem_sec_wipe(void) {
+  clkmgr_clock_acquire(kClkmgrClockOtbn);
+  status_t result = imem_sec_wipe();
+  clkmgr_clock_release(kClkmgrClockOtbn);
+  return result;
+}
+
+/**
+ * Securely wipes DMEM.
+ *
+ * The OTBN clock must be acquired.
+ *
+ * @return Result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+static status_t dmem_sec_wipe(void) {
   HARDENED_TRY(entropy_complex_check());
   HARDENED_TRY(otbn_assert_idle());
   abs_mmio_write32(kBase + OTBN_CMD_REG_OFFSET, kOtbnCmdSecWipeDmem);
-  HARDENED_TRY(otbn_busy_wait_for_done());
+  HARDENED_TRY(busy_wait_for_done());
   return OTCRYPTO_OK;
 }
 
-status_t otbn_set_ctrl_software_errs_fatal(bool enable) {
+status_t otbn_dmem_sec_wipe(void) {
+  clkmgr_clock_acquire(kClkmgrClockOtbn);
+  status_t result = dmem_sec_wipe();
+  clkmgr_clock_release(kClkmgrClockOtbn);
+  return result;
+}
+
+/**
+ * Sets whether software errors are fatal.
+ *
+ * The OTBN clock must be acquired.
+ *
+ * @param enable Whether software errors should be fatal.
+ * @return Result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+static status_t set_ctrl_software_errs_fatal(bool enable) {
   // Ensure OTBN is idle (otherwise CTRL writes will be ignored).
   HARDENED_TRY(otbn_assert_idle());
 
@@ -259,6 +520,13 @@ status_t otbn_set_ctrl_software_errs_fatal(bool enable) {
   return OTCRYPTO_OK;
 }
 
+status_t otbn_set_ctrl_software_errs_fatal(bool enable) {
+  clkmgr_clock_acquire(kClkmgrClockOtbn);
+  status_t result = set_ctrl_software_errs_fatal(enable);
+  clkmgr_clock_release(kClkmgrClockOtbn);
+  return result;
+}
+
 /**
  * Checks if the OTBN application's IMEM and DMEM address parameters are valid.
  *
@@ -286,7 +554,33 @@ static status_t check_app_address_ranges(const otbn_app_t *app) {
   return OTCRYPTO_OK;
 }
 
-status_t otbn_load_app(const otbn_app_t app) {
+/**
+ * Checks whether `app` is resident in IMEM and may be reused.
+ *
+ * @param app the OTBN application to check
+ * @return `kHardenedBoolTrue` if the IMEM load can be skipped.
+ */
+static hardened_bool_t app_is_resident(const otbn_app_t *app) {
+  if (load_policy != kOtbnLoadPolicyReuseResident ||
+      launder32(resident_app.valid) != kHardenedBoolTrue ||
+      resident_app.imem_start != app->imem_start ||
+      resident_app.imem_end != app->imem_end ||
+      resident_app.checksum != app->checksum) {
+    return kHardenedBoolFalse;
+  }
+  return kHardenedBoolTrue;
+}
+
+/**
+ * Loads an application into OTBN.
+ *
+ * The OTBN clock must be acquired.
+ *
+ * @param app The application to load.
+ * @return Result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+static status_t load_app(const otbn_app_t app) {
   HARDENED_TRY(check_app_address_ranges(&app));
 
   // Ensure OTBN is idle.
@@ -296,11 +590,22 @@ status_t otbn_load_app(const otbn_app_t app) {
   const size_t data_num_words =
       (size_t)(app.dmem_data_end - app.dmem_data_start);
 
-  HARDENED_TRY(otbn_imem_sec_wipe());
-  HARDENED_TRY(otbn_dmem_sec_wipe());
+  hardened_bool_t resident = app_is_resident(&app);
+  if (launder32(resident) == kHardenedBoolTrue) {
+    HARDENED_CHECK_EQ(resident, kHardenedBoolTrue);
+    HARDENED_TRY(dmem_sec_wipe());
 
-  // Reset the LOAD_CHECKSUM register.
-  abs_mmio_write32(kBase + OTBN_LOAD_CHECKSUM_REG_OFFSET, 0);
+    // Continue the checksum from where the IMEM writes of the full load left
+    // it, so the final value covers the whole application as before.
+    abs_mmio_write32(kBase + OTBN_LOAD_CHECKSUM_REG_OFFSET,
+                     resident_app.imem_checksum);
+  } else {
+    HARDENED_TRY(imem_sec_wipe());
+    HARDENED_TRY(dmem_sec_wipe());
+
+    // Reset the LOAD_CHECKSUM register.
+    abs_mmio_write32(kBase + OTBN_LOAD_CHECKSUM_REG_OFFSET, 0);
+  }
 
   // Ensure that the IMEM section fits in IMEM and the data section fits in
   // DMEM.
@@ -311,33 +616,45 @@ status_t otbn_load_app(const otbn_app_t app) {
   otbn_addr_t imem_offset = 0;
   HARDENED_TRY(
       check_offset_len(imem_offset, imem_num_words, kOtbnIMemSizeBytes));
-  uint32_t imem_start_addr = kBase + OTBN_IMEM_REG_OFFSET + imem_offset;
-  uint32_t i = 0;
-  for (; launder32(i) < imem_num_words; i++) {
-    HARDENED_CHECK_LT(i, imem_num_words);
-    abs_mmio_write32(imem_start_addr + i * sizeof(uint32_t), app.imem_start[i]);
+  // The app is written in order, since `LOAD_CHECKSUM` depends on the order
+  // of the writes.
+  if (launder32(resident) != kHardenedBoolTrue) {
+    uint32_t imem_start_addr = kBase + OTBN_IMEM_REG_OFFSET + imem_offset;
+    size_t count =
+        otbn_write_range(imem_start_addr, app.imem_start, 0, imem_num_words);
+    HARDENED_CHECK_EQ(count, imem_num_words);
+    resident_app.imem_checksum =
+        abs_mmio_read32(kBase + OTBN_LOAD_CHECKSUM_REG_OFFSET);
   }
-  HARDENED_CHECK_EQ(i, imem_num_words);
 
   // Write the data portion to DMEM.
   otbn_addr_t data_offset = app.dmem_data_start_addr;
   HARDENED_TRY(
       check_offset_len(data_offset, data_num_words, kOtbnDMemSizeBytes));
   uint32_t data_start_addr = kBase + OTBN_DMEM_REG_OFFSET + data_offset;
-  i = 0;
-  for (; launder32(i) < data_num_words; i++) {
-    HARDENED_CHECK_LT(i, data_num_words);
-    abs_mmio_write32(data_start_addr + i * sizeof(uint32_t),
-                     app.dmem_data_start[i]);
-  }
-  HARDENED_CHECK_EQ(i, data_num_words);
+  size_t count = otbn_write_range(data_start_addr, app.dmem_data_start, 0,
+                                  data_num_words);
+  HARDENED_CHECK_EQ(count, data_num_words);
 
   // Ensure that the checksum matches expectations.
   uint32_t checksum = abs_mmio_read32(kBase + OTBN_LOAD_CHECKSUM_REG_OFFSET);
   if (launder32(checksum) != app.checksum) {
+    otbn_resident_app_invalidate();
     return OTCRYPTO_FATAL_ERR;
   }
   HARDENED_CHECK_EQ(checksum, app.checksum);
 
+  resident_app.imem_start = app.imem_start;
+  resident_app.imem_end = app.imem_end;
+  resident_app.checksum = app.checksum;
+  resident_app.valid = kHardenedBoolTrue;
+
   return OTCRYPTO_OK;
 }
+
+status_t otbn_load_app(const otbn_app_t app) {
+  clkmgr_clock_acquire(kClkmgrClockOtbn);
+  status_t result = load_app(app);
+  clkmgr_clock_release(kClkmgrClockOtbn);
+  return result;
+}
@@ -197,6 +197,9 @@ typedef struct otbn_app {
  *
  * The caller must ensure OTBN is idle before calling this function.
  *
+ * The words are written starting from a random word and wrapping around, and
+ * the number of words written is checked once at the end.
+ *
  * @param num_words Length of the data in 32-bit words.
  * @param src The main memory location to copy from.
  * @param dest The DMEM location to copy to.
@@ -230,6 +233,8 @@ status_t otbn_dmem_set(size_t num_words, const uint32_t src, otbn_addr_t dest);
  *
  * The caller must ensure OTBN is idle before calling this function.
  *
+ * As for `otbn_dmem_write`, the words are read starting from a random word.
+ *
  * @param num_words Length of the data in 32-bit words.
  * @param src The DMEM location to copy from.
  * @param[out] dest The main memory location to copy to.
@@ -237,6 +242,23 @@ status_t otbn_dmem_set(size_t num_words, const uint32_t src, otbn_addr_t dest);
  */
 status_t otbn_dmem_read(size_t num_words, otbn_addr_t src, uint32_t *dest);
 
+/**
+ * Read part of a value in OTBN's data memory (DMEM)
+ *
+ * Reads `num_words` words starting `offset_words` words into the value at
+ * `src`. Use this to read back only the words of a result that are needed,
+ * for example the low limbs of a wide register or the words of a result that
+ * follow a header. The same restrictions as for `otbn_dmem_read` apply.
+ *
+ * @param num_words Length of the data to read in 32-bit words.
+ * @param src The DMEM location of the value.
+ * @param offset_words Offset in 32-bit words of the first word to read.
+ * @param[out] dest The main memory location to copy to.
+ * @return Result of the operation.
+ */
+status_t otbn_dmem_read_at(size_t num_words, otbn_addr_t src,
+                           size_t offset_words, uint32_t *dest);
+
 /**
  * Start the execution of the application loaded into OTBN.
  *
@@ -255,6 +277,38 @@ status_t otbn_execute(void);
  */
 status_t otbn_busy_wait_for_done(void);
 
+/**
+ * Checks whether OTBN has finished, without blocking.
+ *
+ * Returns `OTCRYPTO_ASYNC_INCOMPLETE` while OTBN is busy; otherwise, returns
+ * the same result as `otbn_busy_wait_for_done()`.
+ *
+ * @return Result of the operation.
+ */
+status_t otbn_poll_done(void);
+
+/**
+ * Enables or disables OTBN's `done` interrupt.
+ *
+ * The crypto library does not own the interrupt controller; routing the
+ * interrupt to a handler is up to the caller.
+ *
+ * @param enable Whether to enable the interrupt.
+ */
+void otbn_irq_done_enable(bool enable);
+
+/**
+ * Checks whether OTBN's `done` interrupt is enabled.
+ *
+ * @return Whether the interrupt is enabled.
+ */
+bool otbn_irq_done_enabled(void);
+
+/**
+ * Acknowledges OTBN's `done` interrupt.
+ */
+void otbn_irq_done_acknowledge(void);
+
 /**
  * Get the error bits set by the device if the operation failed.
  *
@@ -311,12 +365,53 @@ status_t otbn_dmem_sec_wipe(void);
  */
 status_t otbn_set_ctrl_software_errs_fatal(bool enable);
 
+/**
+ * Policy for reloading an application that is already in IMEM.
+ */
+typedef enum otbn_load_policy {
+  /**
+   * Always securely wipe IMEM and DMEM and rewrite the whole application.
+   */
+  kOtbnLoadPolicyAlwaysWipe = 0x5a1,
+  /**
+   * Skip wiping and rewriting IMEM if the application is already resident.
+   *
+   * DMEM is still securely wiped and its data section rewritten. Only use
+   * this policy if nothing else (e.g. the DIF or the silicon_creator driver)
+   * writes to OTBN's IMEM, since the residency is tracked by this driver.
+   */
+  kOtbnLoadPolicyReuseResident = 0xa5e,
+} otbn_load_policy_t;
+
+/**
+ * Sets the policy `otbn_load_app()` uses for resident applications.
+ *
+ * The default is `kOtbnLoadPolicyAlwaysWipe`.
+ *
+ * @param policy The new policy.
+ */
+void otbn_load_policy_set(otbn_load_policy_t policy);
+
+/**
+ * Forgets which application is resident in IMEM.
+ *
+ * The next call to `otbn_load_app()` will do a full load regardless of the
+ * policy. Call this after writing IMEM other than through this driver.
+ */
+void otbn_resident_app_invalidate(void);
+
 /**
  * (Re-)loads the provided application into OTBN.
  *
  * Load the application image with both instruction and data segments into
  * OTBN.
  *
+ * With `kOtbnLoadPolicyReuseResident`, if the same application was the last
+ * one loaded and OTBN has not reported an error since, only DMEM is wiped and
+ * its data section rewritten. The `LOAD_CHECKSUM` register is then seeded with
+ * the checksum of the IMEM writes recorded during the full load, so that the
+ * final checksum is still compared against the application's checksum.
+ *
  * This function will return an error if called when OTBN is not idle.
  *
  * @param ctx The context object.
@@ -0,0 +1,115 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "sw/device/lib/crypto/drivers/otbn_job.h"
+
+#include <stddef.h>
+
+#include "sw/device/lib/crypto/drivers/otbn.h"
+
+// Module ID for status codes.
+#define MODULE_ID MAKE_MODULE_ID('d', 'b', 'j')
+
+/**
+ * The job queue. The head is the job OTBN is running (if `running`).
+ */
+static otbn_job_t *queue_head = NULL;
+static otbn_job_t *queue_tail = NULL;
+static hardened_bool_t running = kHardenedBoolFalse;
+
+/**
+ * Removes the job at the head of the queue and reports its result.
+ */
+static void otbn_job_finish(status_t result) {
+  otbn_job_t *job = queue_head;
+  queue_head = job->next;
+  if (queue_head == NULL) {
+    queue_tail = NULL;
+  }
+  running = kHardenedBoolFalse;
+
+  job->next = NULL;
+  job->result = result;
+  job->done = kHardenedBoolTrue;
+  if (job->callback != NULL) {
+    job->callback(job->ctx, result);
+  }
+}
+
+/**
+ * Finalizes the running job if it is done and starts the next one(s).
+ *
+ * Must be called with the `done` interrupt masked (or from its handler).
+ */
+static void otbn_job_advance(void) {
+  while (queue_head != NULL) {
+    otbn_job_t *job = queue_head;
+    if (running == kHardenedBoolTrue) {
+      status_t result = otbn_poll_done();
+      if (result.value == OTCRYPTO_ASYNC_INCOMPLETE.value) {
+        return;
+      }
+      if (status_ok(result)) {
+        result = job->finalize(job->ctx);
+      }
+      otbn_job_finish(result);
+      continue;
+    }
+
+    status_t result = job->start(job->ctx);
+    if (!status_ok(result)) {
+      otbn_job_finish(result);
+      continue;
+    }
+    running = kHardenedBoolTrue;
+  }
+}
+
+/**
+ * Advances the queue with the `done` interrupt masked.
+ *
+ * The interrupt is acknowledged before looking at OTBN's status, so a job
+ * finishing afterwards raises it again. It is left enabled while there are
+ * jobs in the queue.
+ */
+static void otbn_job_advance_masked(void) {
+  otbn_irq_done_enable(false);
+  otbn_irq_done_acknowledge();
+  otbn_job_advance();
+  otbn_irq_done_enable(queue_head != NULL);
+}
+
+status_t otbn_job_submit(otbn_job_t *job) {
+  if (job == NULL || job->start == NULL || job->finalize == NULL) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+
+  otbn_irq_done_enable(false);
+  job->next = NULL;
+  job->done = kHardenedBoolFalse;
+  if (queue_tail == NULL) {
+    queue_head = job;
+  } else {
+    queue_tail->next = job;
+  }
+  queue_tail = job;
+  otbn_job_advance_masked();
+
+  return OTCRYPTO_OK;
+}
+
+status_t otbn_job_poll(void) {
+  otbn_job_advance_masked();
+  return queue_head == NULL ? OTCRYPTO_OK : OTCRYPTO_ASYNC_INCOMPLETE;
+}
+
+void otbn_job_irq_handler(void) { otbn_job_advance_masked(); }
+
+status_t otbn_job_wait(otbn_job_t *job) {
+  while (launder32(job->done) != kHardenedBoolTrue) {
+    otbn_job_advance_masked();
+  }
+  HARDENED_CHECK_EQ(job->done, kHardenedBoolTrue);
+  return job->result;
+}
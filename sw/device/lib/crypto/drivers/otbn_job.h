@@ -0,0 +1,113 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef OPENTITAN_SW_DEVICE_LIB_CRYPTO_DRIVERS_OTBN_JOB_H_
+#define OPENTITAN_SW_DEVICE_LIB_CRYPTO_DRIVERS_OTBN_JOB_H_
+
+#include <stdbool.h>
+
+#include "sw/device/lib/base/hardened.h"
+#include "sw/device/lib/crypto/impl/status.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * A job for OTBN.
+ *
+ * A job is run in two halves, which match the `*_start` and `*_finalize`
+ * functions of the OTBN-backed implementations (and the `*_async_start` and
+ * `*_async_finalize` functions of the `otcrypto` API): `start` loads the
+ * application, writes the inputs to DMEM and starts OTBN, and `finalize` reads
+ * the results back once OTBN is done. For example, an RSA signature is queued
+ * with a `start` calling `otcrypto_rsa_sign_async_start()` and a `finalize`
+ * calling `otcrypto_rsa_sign_async_finalize()`, with their arguments in `ctx`.
+ *
+ * The job struct is owned by the caller and must stay valid until its
+ * `callback` has been called.
+ */
+typedef struct otbn_job {
+  /**
+   * Writes the job's inputs and starts OTBN.
+   */
+  status_t (*start)(void *ctx);
+  /**
+   * Reads the job's results after OTBN is done.
+   */
+  status_t (*finalize)(void *ctx);
+  /**
+   * Called once the job has finished, with its result. May be NULL.
+   *
+   * This is called from `otbn_job_irq_handler()` when the job completes in the
+   * interrupt handler, so it should be short.
+   */
+  void (*callback)(void *ctx, status_t result);
+  /**
+   * Argument for the functions above.
+   */
+  void *ctx;
+  /**
+   * Result of the job, valid once `done` is `kHardenedBoolTrue`.
+   */
+  status_t result;
+  /**
+   * Whether the job has finished.
+   */
+  hardened_bool_t done;
+  /**
+   * Next job in the queue (internal).
+   */
+  struct otbn_job *next;
+} otbn_job_t;
+
+/**
+ * Adds a job to the OTBN job queue.
+ *
+ * If the queue is empty, the job is started immediately. Jobs are run in the
+ * order they were submitted. Other code must not use OTBN while the queue is
+ * not empty.
+ *
+ * @param job The job to queue.
+ * @return Result of the operation; errors from starting the job are reported
+ * through the job itself.
+ */
+OT_WARN_UNUSED_RESULT
+status_t otbn_job_submit(otbn_job_t *job);
+
+/**
+ * Advances the OTBN job queue without blocking.
+ *
+ * Finalizes the running job if OTBN has finished it, and starts the next one.
+ * Callers that don't route OTBN's `done` interrupt to
+ * `otbn_job_irq_handler()` can call this periodically instead.
+ *
+ * @return `OTCRYPTO_OK` if the queue is empty, `OTCRYPTO_ASYNC_INCOMPLETE`
+ * otherwise.
+ */
+OT_WARN_UNUSED_RESULT
+status_t otbn_job_poll(void);
+
+/**
+ * Handler for OTBN's `done` interrupt.
+ *
+ * Call this from the interrupt handler for OTBN's `done` interrupt. The
+ * interrupt is enabled while there are jobs in the queue.
+ */
+void otbn_job_irq_handler(void);
+
+/**
+ * Blocks until the given job has finished.
+ *
+ * @param job A job that has been submitted.
+ * @return The result of the job.
+ */
+OT_WARN_UNUSED_RESULT
+status_t otbn_job_wait(otbn_job_t *job);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // OPENTITAN_SW_DEVICE_LIB_CRYPTO_DRIVERS_OTBN_JOB_H_
@@ -228,6 +228,83 @@ static status_t get_block(otcrypto_const_byte_buf_t input,
   return OTCRYPTO_OK;
 }
 
+/**
+ * Checks the IV, loads the key and starts an AES operation.
+ *
+ * @param key Blinded key struct.
+ * @param iv IV (ignored in ECB mode).
+ * @param aes_mode Block cipher mode.
+ * @param aes_operation Encrypt or decrypt.
+ * @return Result of the operation.
+ */
+static status_t aes_start(const otcrypto_blinded_key_t *key,
+                          otcrypto_word32_buf_t iv,
+                          otcrypto_aes_mode_t aes_mode,
+                          otcrypto_aes_operation_t aes_operation) {
+  // Construct the IV and check its length. ECB mode will ignore the IV, so in
+  // this case it is left uninitialized.
+  aes_block_t aes_iv;
+  if (aes_mode == launder32(kAesCipherModeEcb)) {
+    HARDENED_CHECK_EQ(aes_mode, kAesCipherModeEcb);
+  } else {
+    HARDENED_CHECK_NE(aes_mode, kAesCipherModeEcb);
+
+    // The IV must be exactly one block long.
+    if (iv.data == NULL || launder32(iv.len) != kAesBlockNumWords) {
+      return OTCRYPTO_BAD_ARGS;
+    }
+    HARDENED_CHECK_EQ(iv.len, kAesBlockNumWords);
+    hardened_memcpy(aes_iv.data, iv.data, kAesBlockNumWords);
+  }
+
+  // Parse the AES key.
+  aes_key_t aes_key;
+  HARDENED_TRY(aes_key_construct(key, aes_mode, &aes_key));
+
+  // Start the operation (encryption or decryption).
+  switch (aes_operation) {
+    case kOtcryptoAesOperationEncrypt:
+      return aes_encrypt_begin(aes_key, &aes_iv);
+    case kOtcryptoAesOperationDecrypt:
+      return aes_decrypt_begin(aes_key, &aes_iv);
+    default:
+      return OTCRYPTO_BAD_ARGS;
+  }
+}
+
+/**
+ * Deinitializes the AES block and clears a sideloaded key.
+ *
+ * The final IV is written to `iv` unless the mode is ECB or `iv.data` is NULL.
+ *
+ * @param aes_mode Block cipher mode.
+ * @param hw_backed Whether the key was sideloaded.
+ * @param[out] iv Buffer for the final IV.
+ * @return Result of the operation.
+ */
+static status_t aes_finish(otcrypto_aes_mode_t aes_mode,
+                           hardened_bool_t hw_backed,
+                           otcrypto_word32_buf_t iv) {
+  if (aes_mode == launder32(kAesCipherModeEcb) || iv.data == NULL) {
+    HARDENED_TRY(aes_end(NULL));
+  } else {
+    if (launder32(iv.len) != kAesBlockNumWords) {
+      HARDENED_TRY(aes_end(NULL));
+      return OTCRYPTO_BAD_ARGS;
+    }
+    aes_block_t aes_iv;
+    HARDENED_TRY(aes_end(&aes_iv));
+    hardened_memcpy(iv.data, aes_iv.data, kAesBlockNumWords);
+  }
+
+  // If the key was sideloaded, clear it.
+  if (hw_backed == kHardenedBoolTrue) {
+    HARDENED_TRY(keymgr_sideload_clear_aes());
+  }
+
+  return OTCRYPTO_OK;
+}
+
 otcrypto_status_t otcrypto_aes_padded_plaintext_length(
     size_t plaintext_len, otcrypto_aes_padding_t aes_padding,
     size_t *padded_len) {
@@ -276,37 +353,8 @@ otcrypto_status_t otcrypto_aes(const otcrypto_blinded_key_t *key,
   }
   HARDENED_CHECK_EQ(cipher_output.len, input_nblocks * kAesBlockNumBytes);
 
-  // Construct the IV and check its length. ECB mode will ignore the IV, so in
-  // this case it is left uninitialized.
-  aes_block_t aes_iv;
-  if (aes_mode == launder32(kAesCipherModeEcb)) {
-    HARDENED_CHECK_EQ(aes_mode, kAesCipherModeEcb);
-  } else {
-    HARDENED_CHECK_NE(aes_mode, kAesCipherModeEcb);
-
-    // The IV must be exactly one block long.
-    if (launder32(iv.len) != kAesBlockNumWords) {
-      return OTCRYPTO_BAD_ARGS;
-    }
-    HARDENED_CHECK_EQ(iv.len, kAesBlockNumWords);
-    hardened_memcpy(aes_iv.data, iv.data, kAesBlockNumWords);
-  }
-
-  // Parse the AES key.
-  aes_key_t aes_key;
-  HARDENED_TRY(aes_key_construct(key, aes_mode, &aes_key));
-
-  // Start the operation (encryption or decryption).
-  switch (aes_operation) {
-    case kOtcryptoAesOperationEncrypt:
-      HARDENED_TRY(aes_encrypt_begin(aes_key, &aes_iv));
-      break;
-    case kOtcryptoAesOperationDecrypt:
-      HARDENED_TRY(aes_decrypt_begin(aes_key, &aes_iv));
-      break;
-    default:
-      return OTCRYPTO_BAD_ARGS;
-  }
+  // Load the key and IV and start the operation.
+  HARDENED_TRY(aes_start(key, iv, aes_mode, aes_operation));
 
   // Perform the cipher operation for all full blocks. The input and output are
   // offset by `block_offset` number of blocks, where `block_offset` can be 1
@@ -370,18 +418,259 @@ otcrypto_status_t otcrypto_aes(const otcrypto_blinded_key_t *key,
   // Check that the loop ran for the correct number of iterations.
   HARDENED_CHECK_EQ(i, 0);
 
-  // Deinitialize the AES block and update the IV (in ECB mode, skip the IV).
-  if (aes_mode == launder32(kAesCipherModeEcb)) {
-    HARDENED_TRY(aes_end(NULL));
-  } else {
-    HARDENED_TRY(aes_end(&aes_iv));
-    hardened_memcpy(iv.data, aes_iv.data, kAesBlockNumWords);
+  // Deinitialize the AES block and update the IV.
+  return aes_finish(aes_mode, key->config.hw_backed, iv);
+}
+
+enum {
+  /**
+   * Maximum number of blocks in flight in an AES session.
+   *
+   * As in `otcrypto_aes()`, software reads block x-1 while the hardware
+   * processes block x and software writes block x+1.
+   */
+  kAesSessionMaxPending = 2,
+};
+
+/**
+ * A block that has been fed to the AES hardware but not yet read back.
+ */
+typedef struct aes_session_pending {
+  // Destination of the output block.
+  unsigned char *dest;
+  // Number of bytes to write to `dest` (a whole block, except for a trailing
+  // partial block in CTR mode).
+  size_t len;
+} aes_session_pending_t;
+
+/**
+ * Internal layout of the opaque AES session.
+ */
+typedef struct aes_session {
+  // Block cipher mode (an `otcrypto_aes_mode_t` value).
+  uint32_t mode;
+  // Whether the key is sideloaded.
+  hardened_bool_t hw_backed;
+  // Number of blocks in flight.
+  size_t num_pending;
+  // Index of the oldest block in flight in `pending`.
+  size_t pending_head;
+  // Blocks in flight, in a ring buffer.
+  aes_session_pending_t pending[kAesSessionMaxPending];
+  // Output buffers for blocks whose destination can't be written in place.
+  aes_block_t scratch[kAesSessionMaxPending];
+  // Output of the last (partial) CTR block, whose tail is unused keystream.
+  aes_block_t keystream;
+  // Offset of the first unused byte in `keystream`.
+  size_t keystream_offset;
+} aes_session_t;
+
+// Ensure that the AES session is large enough for the internal struct.
+static_assert(
+    sizeof(otcrypto_aes_session_t) >= sizeof(aes_session_t),
+    "`otcrypto_aes_session_t` must be big enough to hold `aes_session_t`.");
+
+// Ensure that the internal struct is suitable for `hardened_memcpy()`.
+static_assert(sizeof(aes_session_t) % sizeof(uint32_t) == 0,
+              "Size of `aes_session_t` must be a multiple of the word size "
+              "for `hardened_memcpy()`");
+
+/**
+ * Save the internal AES session to an opaque AES session.
+ *
+ * @param[out] session Opaque session to copy to.
+ * @param aes_session The internal session object.
+ */
+static void aes_session_save(otcrypto_aes_session_t *restrict session,
+                             const aes_session_t *restrict aes_session) {
+  // As per the `hardened_memcpy()` documentation, it is OK to cast to
+  // `uint32_t *` here as long as `aes_session` is word-aligned, which it must
+  // be because all its fields are.
+  hardened_memcpy(session->data, (uint32_t *)aes_session,
+                  sizeof(aes_session_t) / sizeof(uint32_t));
+}
+
+/**
+ * Restore an internal AES session from an opaque AES session.
+ *
+ * @param session Opaque session to restore from.
+ * @param[out] aes_session Destination internal session object.
+ */
+static void aes_session_restore(const otcrypto_aes_session_t *restrict session,
+                                aes_session_t *restrict aes_session) {
+  hardened_memcpy((uint32_t *)aes_session, session->data,
+                  sizeof(aes_session_t) / sizeof(uint32_t));
+}
+
+/**
+ * Get the block the hardware output for a pending entry should go to.
+ *
+ * Whole blocks with a word-aligned destination are written in place; others
+ * go through the entry's scratch block.
+ *
+ * @param session AES session.
+ * @param slot Index of the entry in `session->pending`.
+ * @return Output block for the entry.
+ */
+static aes_block_t *aes_session_out_block(aes_session_t *session,
+                                          size_t slot) {
+  aes_session_pending_t *entry = &session->pending[slot];
+  if (entry->len == kAesBlockNumBytes &&
+      misalignment32_of((uintptr_t)entry->dest) == 0) {
+    return (aes_block_t *)entry->dest;
+  }
+  return &session->scratch[slot];
+}
+
+/**
+ * Feeds one block to the hardware, retiring the oldest block if the pipeline
+ * is full.
+ *
+ * @param session AES session.
+ * @param src Input block (NULL to only retire a block).
+ * @param dest Destination for the output of `src`.
+ * @param len Number of output bytes to write to `dest`.
+ * @return Result of the operation.
+ */
+static status_t aes_session_push(aes_session_t *session, const aes_block_t *src,
+                                 unsigned char *dest, size_t len) {
+  size_t slot = session->pending_head;
+  aes_block_t *out = NULL;
+  if (session->num_pending == kAesSessionMaxPending ||
+      (src == NULL && session->num_pending > 0)) {
+    out = aes_session_out_block(session, slot);
   }
 
-  // If the key was sideloaded, clear it.
-  if (key->config.hw_backed == kHardenedBoolTrue) {
-    HARDENED_TRY(keymgr_sideload_clear_aes());
+  HARDENED_TRY(aes_update(out, src));
+
+  if (out != NULL) {
+    // Retire the oldest block.
+    aes_session_pending_t *entry = &session->pending[slot];
+    if (out == &session->scratch[slot]) {
+      memcpy(entry->dest, out->data, entry->len);
+      if (entry->len < kAesBlockNumBytes) {
+        // Partial CTR block: keep the rest of the keystream.
+        session->keystream = *out;
+        session->keystream_offset = entry->len;
+      }
+    }
+    session->pending_head = (slot + 1) % kAesSessionMaxPending;
+    session->num_pending--;
   }
 
+  if (src != NULL) {
+    size_t tail = (session->pending_head + session->num_pending) %
+                  kAesSessionMaxPending;
+    session->pending[tail].dest = dest;
+    session->pending[tail].len = len;
+    session->num_pending++;
+  }
   return OTCRYPTO_OK;
 }
+
+/**
+ * Retires all blocks in flight.
+ *
+ * @param session AES session.
+ * @return Result of the operation.
+ */
+static status_t aes_session_drain(aes_session_t *session) {
+  while (session->num_pending > 0) {
+    HARDENED_TRY(aes_session_push(session, /*src=*/NULL, NULL, 0));
+  }
+  return OTCRYPTO_OK;
+}
+
+otcrypto_status_t otcrypto_aes_session_start(
+    const otcrypto_blinded_key_t *key, otcrypto_word32_buf_t iv,
+    otcrypto_aes_mode_t aes_mode, otcrypto_aes_operation_t aes_operation,
+    otcrypto_aes_session_t *session) {
+  if (key == NULL || session == NULL) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+
+  HARDENED_TRY(aes_start(key, iv, aes_mode, aes_operation));
+
+  aes_session_t aes_session;
+  memset(&aes_session, 0, sizeof(aes_session));
+  aes_session.mode = aes_mode;
+  aes_session.hw_backed = key->config.hw_backed;
+  aes_session.keystream_offset = kAesBlockNumBytes;
+  aes_session_save(session, &aes_session);
+  return OTCRYPTO_OK;
+}
+
+otcrypto_status_t otcrypto_aes_session_update(
+    otcrypto_aes_session_t *session, otcrypto_const_byte_buf_t cipher_input,
+    otcrypto_byte_buf_t cipher_output) {
+  if (session == NULL || cipher_input.data == NULL ||
+      cipher_output.data == NULL || cipher_input.len != cipher_output.len) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+
+  aes_session_t aes_session;
+  aes_session_restore(session, &aes_session);
+
+  bool is_ctr = aes_session.mode == kAesCipherModeCtr;
+  if (!is_ctr && cipher_input.len % kAesBlockNumBytes != 0) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+
+  const unsigned char *src = cipher_input.data;
+  unsigned char *dest = cipher_output.data;
+  size_t len = cipher_input.len;
+
+  // Use up the keystream left over from a partial CTR block.
+  if (is_ctr) {
+    const unsigned char *keystream =
+        (const unsigned char *)aes_session.keystream.data;
+    while (len > 0 && aes_session.keystream_offset < kAesBlockNumBytes) {
+      *dest++ = *src++ ^ keystream[aes_session.keystream_offset++];
+      len--;
+    }
+  }
+
+  // Feed whole blocks, reading word-aligned input in place.
+  aes_block_t block_in;
+  for (; len >= kAesBlockNumBytes; len -= kAesBlockNumBytes) {
+    const aes_block_t *in = (const aes_block_t *)src;
+    if (misalignment32_of((uintptr_t)src) != 0) {
+      memcpy(block_in.data, src, kAesBlockNumBytes);
+      in = &block_in;
+    }
+    HARDENED_TRY(aes_session_push(&aes_session, in, dest, kAesBlockNumBytes));
+    src += kAesBlockNumBytes;
+    dest += kAesBlockNumBytes;
+  }
+
+  // A trailing partial block (CTR only) is padded with zeroes, so the unused
+  // part of its output is keystream. Drain the pipeline so that the keystream
+  // is available to the next chunk.
+  if (len > 0) {
+    HARDENED_CHECK_EQ(is_ctr, true);
+    memset(block_in.data, 0, kAesBlockNumBytes);
+    memcpy(block_in.data, src, len);
+    HARDENED_TRY(aes_session_push(&aes_session, &block_in, dest, len));
+    HARDENED_TRY(aes_session_drain(&aes_session));
+  }
+
+  aes_session_save(session, &aes_session);
+  return OTCRYPTO_OK;
+}
+
+otcrypto_status_t otcrypto_aes_session_end(otcrypto_aes_session_t *session,
+                                           otcrypto_word32_buf_t iv) {
+  if (session == NULL) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+
+  aes_session_t aes_session;
+  aes_session_restore(session, &aes_session);
+  HARDENED_TRY(aes_session_drain(&aes_session));
+  hardened_memshred(session->data, ARRAYSIZE(session->data));
+
+  status_t result = aes_finish(aes_session.mode, aes_session.hw_backed, iv);
+  hardened_memshred((uint32_t *)&aes_session,
+                    sizeof(aes_session_t) / sizeof(uint32_t));
+  return result;
+}
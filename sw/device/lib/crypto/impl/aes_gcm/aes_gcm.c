@@ -71,20 +71,83 @@ static status_t aes_encrypt_block(const aes_key_t key, const aes_block_t *iv,
 }
 
 /**
- * Run GCTR on exactly one block of input.
+ * Run GCTR on full blocks of input.
+ *
+ * The AES block is configured once in CTR mode and then kept busy: each block
+ * is written to the hardware before the output of the previous block is read,
+ * and that output is absorbed into GHASH while the hardware processes the next
+ * block.
+ *
+ * The hardware increments the IV as a 128-bit integer, whereas GCM's inc32()
+ * only increments the last 32 bits. The hardware is therefore reconfigured
+ * with the software IV whenever those bits wrap around.
  *
  * Updates the IV in-place.
  *
  * @param key The AES key
  * @param iv Initialization vector, 128 bits
- * @param input Input block
- * @param[out] output Output block
+ * @param first Optional first input block, processed before `input`
+ * @param num_blocks Number of blocks, including `first`
+ * @param input Input buffer for the remaining blocks
+ * @param ghash_ctx GHASH context to absorb the ciphertext into (may be NULL)
+ * @param is_encrypt Whether the ciphertext is the output (true) or input
+ * @param[out] output Output buffer, `num_blocks` blocks
  */
 OT_WARN_UNUSED_RESULT
-static status_t gctr_process_block(const aes_key_t key, aes_block_t *iv,
-                                   aes_block_t *input, aes_block_t *output) {
-  HARDENED_TRY(aes_encrypt_block(key, iv, input, output));
-  block_inc32(iv);
+static status_t gctr_process_blocks(const aes_key_t key, aes_block_t *iv,
+                                    const aes_block_t *first,
+                                    size_t num_blocks, const uint8_t *input,
+                                    ghash_context_t *ghash_ctx,
+                                    hardened_bool_t is_encrypt,
+                                    uint8_t *output) {
+  aes_block_t block_in;
+  aes_block_t block_out;
+  for (size_t i = 0; i < num_blocks; ++i) {
+    if (i == 0 && first != NULL) {
+      block_in = *first;
+    } else {
+      memcpy(block_in.data, input, kAesBlockNumBytes);
+      input += kAesBlockNumBytes;
+    }
+
+    if (i == 0 || iv->data[kAesBlockNumWords - 1] == 0) {
+      if (i != 0) {
+        // Finish the session before the counter wraps.
+        HARDENED_TRY(aes_update(&block_out, /*src=*/NULL));
+        HARDENED_TRY(aes_end(NULL));
+      }
+      HARDENED_TRY(aes_encrypt_begin(key, iv));
+      HARDENED_TRY(aes_update(/*dest=*/NULL, &block_in));
+    } else {
+      // Queue block `i` before reading the output of block `i - 1`, so that
+      // the hardware can start on it right away.
+      HARDENED_TRY(aes_update(/*dest=*/NULL, &block_in));
+      HARDENED_TRY(aes_update(&block_out, /*src=*/NULL));
+    }
+    block_inc32(iv);
+
+    // Block `i` is now in flight; finish block `i - 1` meanwhile.
+    if (i != 0) {
+      memcpy(output, block_out.data, kAesBlockNumBytes);
+      if (ghash_ctx != NULL && is_encrypt == kHardenedBoolTrue) {
+        ghash_update(ghash_ctx, kAesBlockNumBytes, output);
+      }
+      output += kAesBlockNumBytes;
+    }
+    if (ghash_ctx != NULL && is_encrypt == kHardenedBoolFalse) {
+      ghash_update(ghash_ctx, kAesBlockNumBytes,
+                   (const uint8_t *)block_in.data);
+    }
+  }
+
+  if (num_blocks != 0) {
+    HARDENED_TRY(aes_update(&block_out, /*src=*/NULL));
+    HARDENED_TRY(aes_end(NULL));
+    memcpy(output, block_out.data, kAesBlockNumBytes);
+    if (ghash_ctx != NULL && is_encrypt == kHardenedBoolTrue) {
+      ghash_update(ghash_ctx, kAesBlockNumBytes, output);
+    }
+  }
   return OTCRYPTO_OK;
 }
 
@@ -108,12 +171,18 @@ static status_t gctr_process_block(const aes_key_t key, aes_block_t *iv,
  * generate more output, and the result should be the same as if all the data
  * was passed in one call.
  *
+ * If `ghash_ctx` is not NULL, the full blocks of ciphertext (the output if
+ * `is_encrypt` is true, the input otherwise) are absorbed into it as they are
+ * processed.
+ *
  * @param key The AES key
  * @param iv Initialization vector, 128 bits
  * @param partial_len Length of partial block data in bytes.
  * @param partial Partial AES block.
  * @param input_len Number of bytes for input and output
  * @param input Pointer to input buffer (may be NULL if `len` is 0)
+ * @param ghash_ctx GHASH context for the ciphertext (may be NULL)
+ * @param is_encrypt Whether this is an encryption operation
  * @param[out] output_len Number of output bytes written
  * @param[out] output Pointer to output buffer
  */
@@ -121,45 +190,37 @@ OT_WARN_UNUSED_RESULT
 static status_t aes_gcm_gctr(const aes_key_t key, aes_block_t *iv,
                              size_t partial_len, aes_block_t *partial,
                              size_t input_len, const uint8_t *input,
-                             size_t *output_len, uint8_t *output) {
+                             ghash_context_t *ghash_ctx,
+                             hardened_bool_t is_encrypt, size_t *output_len,
+                             uint8_t *output) {
   // Key must be intended for CTR mode.
   if (key.mode != kAesCipherModeCtr) {
     return OTCRYPTO_BAD_ARGS;
   }
 
+  unsigned char *partial_bytes = (unsigned char *)partial->data;
   if (input_len < kAesBlockNumBytes - partial_len) {
     // Not enough data for a full block; copy into the partial block.
-    unsigned char *partial_bytes = (unsigned char *)partial->data;
     memcpy(partial_bytes + partial_len, input, input_len);
-  } else {
-    // Construct a block from the partial data and the start of the new data.
-    unsigned char *partial_bytes = (unsigned char *)partial->data;
-    memcpy(partial_bytes + partial_len, input, kAesBlockNumBytes - partial_len);
-    input += kAesBlockNumBytes - partial_len;
-    input_len -= kAesBlockNumBytes - partial_len;
-
-    // Process the block.
-    aes_block_t block_out;
-    HARDENED_TRY(gctr_process_block(key, iv, partial, &block_out));
-    memcpy(output, block_out.data, kAesBlockNumBytes);
-    output += kAesBlockNumBytes;
-    *output_len = kAesBlockNumBytes;
-
-    // Process any remaining full blocks of input.
-    while (input_len >= kAesBlockNumBytes) {
-      memcpy(partial->data, input, kAesBlockNumBytes);
-      HARDENED_TRY(gctr_process_block(key, iv, partial, &block_out));
-      memcpy(output, block_out.data, kAesBlockNumBytes);
-      output += kAesBlockNumBytes;
-      *output_len += kAesBlockNumBytes;
-      input += kAesBlockNumBytes;
-      input_len -= kAesBlockNumBytes;
-    }
-
-    // Copy any remaining input into the partial block.
-    memcpy(partial->data, input, input_len);
+    *output_len = 0;
+    return OTCRYPTO_OK;
   }
 
+  // Construct a block from the partial data and the start of the new data.
+  memcpy(partial_bytes + partial_len, input, kAesBlockNumBytes - partial_len);
+  input += kAesBlockNumBytes - partial_len;
+  input_len -= kAesBlockNumBytes - partial_len;
+
+  // Process that block and any remaining full blocks of input.
+  size_t num_blocks = 1 + input_len / kAesBlockNumBytes;
+  HARDENED_TRY(gctr_process_blocks(key, iv, partial, num_blocks, input,
+                                   ghash_ctx, is_encrypt, output));
+  *output_len = num_blocks * kAesBlockNumBytes;
+  input += input_len - input_len % kAesBlockNumBytes;
+  input_len %= kAesBlockNumBytes;
+
+  // Copy any remaining input into the partial block.
+  memcpy(partial->data, input, input_len);
   return OTCRYPTO_OK;
 }
 
@@ -259,7 +320,8 @@ static status_t aes_gcm_get_tag(aes_gcm_context_t *ctx, size_t tag_len,
   aes_block_t empty = {.data = {0}};
   HARDENED_TRY(aes_gcm_gctr(ctx->key, &ctx->initial_counter_block,
                             /*partial_len=*/0, &empty, kAesBlockNumBytes,
-                            (unsigned char *)s.data, &full_tag_len,
+                            (unsigned char *)s.data, /*ghash_ctx=*/NULL,
+                            kHardenedBoolTrue, &full_tag_len,
                             (unsigned char *)full_tag));
 
   // Sanity check.
@@ -296,21 +358,29 @@ status_t aes_gcm_encrypt(const aes_key_t key, const size_t iv_len,
  * This process is actually the same for both encryption and decryption.
  *
  * @param key Underlying AES-CTR key.
+ * @param subkey_ctx GHASH context with the hash subkey for `key`, or NULL to
+ *        derive it.
  * @param iv_len Length of the initialization vector in 32-bit words.
  * @param iv Initialization vector (nonce).
  * @param[out] ctx Initialized context object.
  * @return Error status; OK if no errors.
  */
-static status_t aes_gcm_init(const aes_key_t key, const size_t iv_len,
-                             const uint32_t *iv, aes_gcm_context_t *ctx) {
+static status_t aes_gcm_init(const aes_key_t key,
+                             const ghash_context_t *subkey_ctx,
+                             const size_t iv_len, const uint32_t *iv,
+                             aes_gcm_context_t *ctx) {
   // Check for null pointers and IV length (must be 96 or 128 bits = 3 or 4
   // words).
   if (ctx == NULL || iv == NULL || (iv_len != 3 && iv_len != 4)) {
     return OTCRYPTO_BAD_ARGS;
   }
 
-  // Initialize the hash subkey H.
-  HARDENED_TRY(aes_gcm_hash_subkey(key, &ctx->ghash_ctx));
+  // Initialize the hash subkey H, unless it is already known.
+  if (subkey_ctx == NULL) {
+    HARDENED_TRY(aes_gcm_hash_subkey(key, &ctx->ghash_ctx));
+  } else {
+    memcpy(&ctx->ghash_ctx, subkey_ctx, sizeof(ghash_context_t));
+  }
 
   // Compute the counter block (called J0 in the NIST specification).
   HARDENED_TRY(aes_gcm_counter(iv_len, iv, &ctx->ghash_ctx,
@@ -348,7 +418,27 @@ static status_t aes_gcm_init(const aes_key_t key, const size_t iv_len,
 status_t aes_gcm_encrypt_init(const aes_key_t key, const size_t iv_len,
                               const uint32_t *iv, aes_gcm_context_t *ctx) {
   ctx->is_encrypt = kHardenedBoolTrue;
-  return aes_gcm_init(key, iv_len, iv, ctx);
+  return aes_gcm_init(key, /*subkey_ctx=*/NULL, iv_len, iv, ctx);
+}
+
+status_t aes_gcm_key_context_init(const aes_key_t key,
+                                  aes_gcm_key_context_t *key_ctx) {
+  if (key_ctx == NULL) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+  HARDENED_TRY(aes_gcm_hash_subkey(key, &key_ctx->ghash_ctx));
+  memcpy(&key_ctx->key, &key, sizeof(aes_key_t));
+  return OTCRYPTO_OK;
+}
+
+status_t aes_gcm_encrypt_init_with_key_context(
+    const aes_gcm_key_context_t *key_ctx, const size_t iv_len,
+    const uint32_t *iv, aes_gcm_context_t *ctx) {
+  if (key_ctx == NULL || ctx == NULL) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+  ctx->is_encrypt = kHardenedBoolTrue;
+  return aes_gcm_init(key_ctx->key, &key_ctx->ghash_ctx, iv_len, iv, ctx);
 }
 
 status_t aes_gcm_update_aad(aes_gcm_context_t *ctx, const size_t aad_len,
@@ -409,29 +499,20 @@ status_t aes_gcm_update_encrypted_data(aes_gcm_context_t *ctx, size_t input_len,
                  (unsigned char *)ctx->partial_ghash_block.data);
   }
 
-  // Process any full blocks of input with GCTR to generate more ciphertext.
+  if (ctx->is_encrypt != kHardenedBoolTrue &&
+      ctx->is_encrypt != kHardenedBoolFalse) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+
+  // Process any full blocks of input with GCTR to generate more ciphertext,
+  // and accumulate the ciphertext (the output for encryption, and the input
+  // for decryption) to the GHASH context along the way. Partial blocks of
+  // ciphertext are kept in the partial AES block until they are full.
   size_t partial_aes_block_len = ctx->input_len % kAesBlockNumBytes;
   HARDENED_TRY(aes_gcm_gctr(ctx->key, &ctx->gctr_iv, partial_aes_block_len,
                             &ctx->partial_aes_block, input_len, input,
-                            output_len, output));
-
-  // Accumulate any new ciphertext to the GHASH context. The ciphertext is the
-  // output for encryption, and the input for decryption.
-  if (ctx->is_encrypt == kHardenedBoolTrue) {
-    // Since we only generate ciphertext in full-block increments, no partial
-    // blocks are possible in this case.
-    if (*output_len % kGhashBlockNumBytes != 0) {
-      return OTCRYPTO_RECOV_ERR;
-    }
-    ghash_process_full_blocks(&ctx->ghash_ctx, /*partial_len=*/0,
-                              &ctx->partial_ghash_block, *output_len, output);
-  } else if (ctx->is_encrypt == kHardenedBoolFalse) {
-    size_t partial_ghash_block_len = ctx->input_len % kGhashBlockNumBytes;
-    ghash_process_full_blocks(&ctx->ghash_ctx, partial_ghash_block_len,
-                              &ctx->partial_ghash_block, input_len, input);
-  } else {
-    return OTCRYPTO_BAD_ARGS;
-  }
+                            &ctx->ghash_ctx, ctx->is_encrypt, output_len,
+                            output));
 
   ctx->input_len += input_len;
   return OTCRYPTO_OK;
@@ -477,8 +558,10 @@ status_t aes_gcm_final(aes_gcm_context_t *ctx, size_t tag_len, uint32_t *tag,
     memset(partial_aes_block_bytes + partial_aes_block_len, 0,
            kAesBlockNumBytes - partial_aes_block_len);
     aes_block_t block_out;
-    HARDENED_TRY(gctr_process_block(ctx->key, &ctx->gctr_iv,
-                                    &ctx->partial_aes_block, &block_out));
+    HARDENED_TRY(gctr_process_blocks(
+        ctx->key, &ctx->gctr_iv, &ctx->partial_aes_block, /*num_blocks=*/1,
+        /*input=*/NULL, /*ghash_ctx=*/NULL, kHardenedBoolTrue,
+        (uint8_t *)block_out.data));
     memcpy(output, block_out.data, partial_aes_block_len);
     *output_len = partial_aes_block_len;
   }
@@ -492,9 +575,8 @@ status_t aes_gcm_final(aes_gcm_context_t *ctx, size_t tag_len, uint32_t *tag,
   } else if (ctx->is_encrypt == kHardenedBoolFalse) {
     // If a partial block of ciphertext (input for decryption) remains,
     // accumulate it in GHASH.
-    size_t partial_ghash_block_len = ctx->input_len % kGhashBlockNumBytes;
-    ghash_update(&ctx->ghash_ctx, partial_ghash_block_len,
-                 (unsigned char *)ctx->partial_ghash_block.data);
+    ghash_update(&ctx->ghash_ctx, partial_aes_block_len,
+                 (unsigned char *)ctx->partial_aes_block.data);
   } else {
     return OTCRYPTO_BAD_ARGS;
   }
@@ -528,7 +610,17 @@ status_t aes_gcm_decrypt(const aes_key_t key, const size_t iv_len,
 status_t aes_gcm_decrypt_init(const aes_key_t key, const size_t iv_len,
                               const uint32_t *iv, aes_gcm_context_t *ctx) {
   ctx->is_encrypt = kHardenedBoolFalse;
-  return aes_gcm_init(key, iv_len, iv, ctx);
+  return aes_gcm_init(key, /*subkey_ctx=*/NULL, iv_len, iv, ctx);
+}
+
+status_t aes_gcm_decrypt_init_with_key_context(
+    const aes_gcm_key_context_t *key_ctx, const size_t iv_len,
+    const uint32_t *iv, aes_gcm_context_t *ctx) {
+  if (key_ctx == NULL || ctx == NULL) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+  ctx->is_encrypt = kHardenedBoolFalse;
+  return aes_gcm_init(key_ctx->key, &key_ctx->ghash_ctx, iv_len, iv, ctx);
 }
 
 status_t aes_gcm_decrypt_final(aes_gcm_context_t *ctx, size_t tag_len,
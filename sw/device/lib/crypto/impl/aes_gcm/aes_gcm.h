@@ -51,7 +51,9 @@ typedef struct aes_gcm_context {
    * Length is always equal to `aad_len % kGhashBlockNumBytes` if the state is
    * `kAesGcmStateUpdateAad`, and is always 0 if the state
    * is `kAesGcmStateUpdateEncryptedData` (since ciphertext gets accumulated in
-   * full-block increments). The block may be empty, but will never be full.
+   * full-block increments, with a partial block of ciphertext kept in
+   * `partial_aes_block` for decryption). The block may be empty, but will
+   * never be full.
    */
   ghash_block_t partial_ghash_block;
   /**
@@ -67,6 +69,29 @@ typedef struct aes_gcm_context {
   ghash_context_t ghash_ctx;
 } __attribute__((aligned(sizeof(uint32_t)))) aes_gcm_context_t;
 
+/**
+ * Per-key AES-GCM state, shared by all messages under the same key.
+ *
+ * Holds the hash subkey H = AES_K(0) in the form used by GHASH (including any
+ * precomputed product table), so that starting an operation with
+ * `aes_gcm_encrypt_init_with_key_context()` or
+ * `aes_gcm_decrypt_init_with_key_context()` needs neither an AES operation nor
+ * a table computation.
+ *
+ * The hash subkey is secret; callers must clear this struct when the key is no
+ * longer used.
+ */
+typedef struct aes_gcm_key_context {
+  /**
+   * Underlying AES-CTR key.
+   */
+  aes_key_t key;
+  /**
+   * GHASH context holding the hash subkey H; its state is not used.
+   */
+  ghash_context_t ghash_ctx;
+} __attribute__((aligned(sizeof(uint32_t)))) aes_gcm_key_context_t;
+
 /**
  * AES-GCM authenticated encryption as defined in NIST SP800-38D, algorithm 4.
  *
@@ -177,6 +202,34 @@ status_t aes_gcm_encrypt_init(const aes_key_t key, const size_t iv_len,
  * @param aad aad value (may be NULL if aad_len is 0)
  * @return Error status; OK if no errors
  */
+/**
+ * Computes the per-key state for AES-GCM operations with the given key.
+ *
+ * If the key is sideloaded, it must be loaded into the AES block when this is
+ * called and whenever an operation started with the result is in progress.
+ *
+ * @param key Underlying AES-CTR key.
+ * @param[out] key_ctx Per-key state.
+ * @return Error status; OK if no errors.
+ */
+OT_WARN_UNUSED_RESULT
+status_t aes_gcm_key_context_init(const aes_key_t key,
+                                  aes_gcm_key_context_t *key_ctx);
+
+/**
+ * Like `aes_gcm_encrypt_init()`, but uses the hash subkey from `key_ctx`.
+ *
+ * @param key_ctx Per-key state from `aes_gcm_key_context_init()`.
+ * @param iv_len Length of the initialization vector in 32-bit words.
+ * @param iv Initialization vector (nonce).
+ * @param[out] ctx Initialized context object.
+ * @return Error status; OK if no errors.
+ */
+OT_WARN_UNUSED_RESULT
+status_t aes_gcm_encrypt_init_with_key_context(
+    const aes_gcm_key_context_t *key_ctx, const size_t iv_len,
+    const uint32_t *iv, aes_gcm_context_t *ctx);
+
 OT_WARN_UNUSED_RESULT
 status_t aes_gcm_update_aad(aes_gcm_context_t *ctx, const size_t aad_len,
                             const uint8_t *aad);
@@ -293,6 +346,20 @@ status_t aes_gcm_decrypt_init(const aes_key_t key, const size_t iv_len,
  * @param[out] success True if authentication was successful, otherwise false
  * @return Error status; OK if no errors
  */
+/**
+ * Like `aes_gcm_decrypt_init()`, but uses the hash subkey from `key_ctx`.
+ *
+ * @param key_ctx Per-key state from `aes_gcm_key_context_init()`.
+ * @param iv_len Length of the initialization vector in 32-bit words.
+ * @param iv Initialization vector (nonce).
+ * @param[out] ctx Initialized context object.
+ * @return Error status; OK if no errors.
+ */
+OT_WARN_UNUSED_RESULT
+status_t aes_gcm_decrypt_init_with_key_context(
+    const aes_gcm_key_context_t *key_ctx, const size_t iv_len,
+    const uint32_t *iv, aes_gcm_context_t *ctx);
+
 OT_WARN_UNUSED_RESULT
 status_t aes_gcm_decrypt_final(aes_gcm_context_t *ctx, size_t tag_len,
                                const uint32_t *tag, size_t *output_len,
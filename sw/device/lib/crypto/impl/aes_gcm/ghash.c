@@ -15,22 +15,29 @@ enum {
    * Log2 of the number of bytes in an AES block.
    */
   kGhashBlockLog2NumBytes = 4,
+#ifndef OTCRYPTO_GHASH_CLMUL
   /**
    * Number of windows for Galois field pre-computed tables.
    *
-   * We suse 4-bit windows, so the number of windows is 2x the number of bytes
-   * in a block.
+   * With 4-bit windows the number of windows is 2x the number of bytes in a
+   * block; with 8-bit windows it is the number of bytes.
    */
-  kNumWindows = kGhashBlockNumBytes << 1,
+  kNumWindows = kGhashBlockNumBytes * 8 / OTCRYPTO_GHASH_WINDOW_BITS,
+  /**
+   * Mask for a single window.
+   */
+  kWindowMask = (1 << OTCRYPTO_GHASH_WINDOW_BITS) - 1,
+#endif
 };
 static_assert(kGhashBlockNumBytes == (1 << kGhashBlockLog2NumBytes),
               "kGhashBlockLog2NumBytes does not match kGhashBlockNumBytes");
 
+#ifndef OTCRYPTO_GHASH_CLMUL
 /**
  * Precomputed modular reduction constants for Galois field multiplication.
  *
- * This implementation uses 4-bit windows. The bytes here represent 12-bit
- * little-endian values.
+ * The table has one entry per window value. The bytes here represent
+ * little-endian values of up to 16 bits.
  *
  * The entry with index i in this table is equal to i * 0xe1, where the bytes i
  * and 0xe1 are interpreted as polynomials in the GCM Galois field. For
@@ -45,9 +52,47 @@ static_assert(kGhashBlockNumBytes == (1 << kGhashBlockLog2NumBytes),
  * table of a given hash subkey becomes higher, so larger windows are slower
  * for smaller inputs but faster for large inputs.
  */
+#if OTCRYPTO_GHASH_WINDOW_BITS == 8
+static const uint16_t kGFReduceTable[256] = {
+    0x0000, 0xc201, 0x8403, 0x4602, 0x0807, 0xca06, 0x8c04, 0x4e05,
+    0x100e, 0xd20f, 0x940d, 0x560c, 0x1809, 0xda08, 0x9c0a, 0x5e0b,
+    0x201c, 0xe21d, 0xa41f, 0x661e, 0x281b, 0xea1a, 0xac18, 0x6e19,
+    0x3012, 0xf213, 0xb411, 0x7610, 0x3815, 0xfa14, 0xbc16, 0x7e17,
+    0x4038, 0x8239, 0xc43b, 0x063a, 0x483f, 0x8a3e, 0xcc3c, 0x0e3d,
+    0x5036, 0x9237, 0xd435, 0x1634, 0x5831, 0x9a30, 0xdc32, 0x1e33,
+    0x6024, 0xa225, 0xe427, 0x2626, 0x6823, 0xaa22, 0xec20, 0x2e21,
+    0x702a, 0xb22b, 0xf429, 0x3628, 0x782d, 0xba2c, 0xfc2e, 0x3e2f,
+    0x8070, 0x4271, 0x0473, 0xc672, 0x8877, 0x4a76, 0x0c74, 0xce75,
+    0x907e, 0x527f, 0x147d, 0xd67c, 0x9879, 0x5a78, 0x1c7a, 0xde7b,
+    0xa06c, 0x626d, 0x246f, 0xe66e, 0xa86b, 0x6a6a, 0x2c68, 0xee69,
+    0xb062, 0x7263, 0x3461, 0xf660, 0xb865, 0x7a64, 0x3c66, 0xfe67,
+    0xc048, 0x0249, 0x444b, 0x864a, 0xc84f, 0x0a4e, 0x4c4c, 0x8e4d,
+    0xd046, 0x1247, 0x5445, 0x9644, 0xd841, 0x1a40, 0x5c42, 0x9e43,
+    0xe054, 0x2255, 0x6457, 0xa656, 0xe853, 0x2a52, 0x6c50, 0xae51,
+    0xf05a, 0x325b, 0x7459, 0xb658, 0xf85d, 0x3a5c, 0x7c5e, 0xbe5f,
+    0x00e1, 0xc2e0, 0x84e2, 0x46e3, 0x08e6, 0xcae7, 0x8ce5, 0x4ee4,
+    0x10ef, 0xd2ee, 0x94ec, 0x56ed, 0x18e8, 0xdae9, 0x9ceb, 0x5eea,
+    0x20fd, 0xe2fc, 0xa4fe, 0x66ff, 0x28fa, 0xeafb, 0xacf9, 0x6ef8,
+    0x30f3, 0xf2f2, 0xb4f0, 0x76f1, 0x38f4, 0xfaf5, 0xbcf7, 0x7ef6,
+    0x40d9, 0x82d8, 0xc4da, 0x06db, 0x48de, 0x8adf, 0xccdd, 0x0edc,
+    0x50d7, 0x92d6, 0xd4d4, 0x16d5, 0x58d0, 0x9ad1, 0xdcd3, 0x1ed2,
+    0x60c5, 0xa2c4, 0xe4c6, 0x26c7, 0x68c2, 0xaac3, 0xecc1, 0x2ec0,
+    0x70cb, 0xb2ca, 0xf4c8, 0x36c9, 0x78cc, 0xbacd, 0xfccf, 0x3ece,
+    0x8091, 0x4290, 0x0492, 0xc693, 0x8896, 0x4a97, 0x0c95, 0xce94,
+    0x909f, 0x529e, 0x149c, 0xd69d, 0x9898, 0x5a99, 0x1c9b, 0xde9a,
+    0xa08d, 0x628c, 0x248e, 0xe68f, 0xa88a, 0x6a8b, 0x2c89, 0xee88,
+    0xb083, 0x7282, 0x3480, 0xf681, 0xb884, 0x7a85, 0x3c87, 0xfe86,
+    0xc0a9, 0x02a8, 0x44aa, 0x86ab, 0xc8ae, 0x0aaf, 0x4cad, 0x8eac,
+    0xd0a7, 0x12a6, 0x54a4, 0x96a5, 0xd8a0, 0x1aa1, 0x5ca3, 0x9ea2,
+    0xe0b5, 0x22b4, 0x64b6, 0xa6b7, 0xe8b2, 0x2ab3, 0x6cb1, 0xaeb0,
+    0xf0bb, 0x32ba, 0x74b8, 0xb6b9, 0xf8bc, 0x3abd, 0x7cbf, 0xbebe,
+};
+#else
 static const uint16_t kGFReduceTable[16] = {
     0x0000, 0x201c, 0x4038, 0x6024, 0x8070, 0xa06c, 0xc048, 0xe054,
     0x00e1, 0x20fd, 0x40d9, 0x60c5, 0x8091, 0xa08d, 0xc0a9, 0xe0b5};
+#endif
+#endif
 
 /**
  * Performs a bitwise XOR of two blocks.
@@ -126,49 +171,123 @@ static inline void galois_mulx(const ghash_block_t *p, ghash_block_t *out) {
   out->data[0] ^= (0xe1 & mask);
 }
 
-/**
- * Reverse the bits of a 4-bit number.
- *
- * @param byte Input byte.
- * @return byte with lower 4 bits reversed and upper 4 unmodified.
- */
-static uint8_t reverse_bits(uint8_t byte) {
-  /* TODO: replace with rev.n (from 0.93 draft of bitmanip) once bitmanip
-   * extension is enabled. */
-  uint8_t out = 0;
-  for (size_t i = 0; i < 4; ++i) {
-    out <<= 1;
-    out |= (byte >> i) & 1;
-  }
-  return out;
+#ifdef OTCRYPTO_GHASH_CLMUL
+void ghash_init_subkey(const uint32_t *hash_subkey, ghash_context_t *ctx) {
+  // Carry-less multiplication needs no table; just keep the subkey.
+  memcpy(ctx->tbl[0].data, hash_subkey, kGhashBlockNumBytes);
 }
-
+#else
 void ghash_init_subkey(const uint32_t *hash_subkey, ghash_context_t *ctx) {
+  // Because the processor represents bytes with the MSB on the left and NIST
+  // uses a fully little-endian polynomial representation with the MSB on the
+  // right, the window value for 1 is the top bit of the window, and each bit
+  // further right is one power of x higher.
+  const size_t one = 1 << (OTCRYPTO_GHASH_WINDOW_BITS - 1);
+
   // Initialize 0 * H = 0.
   memset(ctx->tbl[0].data, 0, kGhashBlockNumBytes);
   // Initialize 1 * H = H.
-  memcpy(ctx->tbl[0x8].data, hash_subkey, kGhashBlockNumBytes);
-
-  // To get remaining entries, we use a variant of "shift and add"; in
-  // polynomial terms, a shift is a multiplication by x. Note that, because the
-  // processor represents bytes with the MSB on the left and NIST uses a fully
-  // little-endian polynomial representation with the MSB on the right, we have
-  // to reverse the bits of the indices.
-  for (uint8_t i = 2; i < 16; i += 2) {
-    // Find the product corresponding to (i >> 1) * H and multiply by x to
-    // shift 1; this will be i * H.
-    galois_mulx(&ctx->tbl[reverse_bits(i >> 1)], &ctx->tbl[reverse_bits(i)]);
-
-    // Add H to i * H to get (i + 1) * H.
-    block_xor(&ctx->tbl[reverse_bits(i)], &ctx->tbl[0x8],
-              &ctx->tbl[reverse_bits(i + 1)]);
+  memcpy(ctx->tbl[one].data, hash_subkey, kGhashBlockNumBytes);
+
+  // Compute the products of H with single powers of x (x * H, x^2 * H, ...)
+  // by repeated multiplication by x.
+  for (size_t i = one; i > 1; i >>= 1) {
+    galois_mulx(&ctx->tbl[i], &ctx->tbl[i >> 1]);
+  }
+
+  // Every other entry is the sum of the single-bit entries for its set bits.
+  // Fill them in by adding the highest set bit to an already-computed entry.
+  for (size_t i = 2; i <= one; i <<= 1) {
+    for (size_t j = 1; j < i; ++j) {
+      block_xor(&ctx->tbl[i], &ctx->tbl[j], &ctx->tbl[i + j]);
+    }
   }
 }
+#endif
 
 void ghash_init(ghash_context_t *ctx) {
   memset(ctx->state.data, 0, kGhashBlockNumBytes);
 }
 
+#ifdef OTCRYPTO_GHASH_CLMUL
+/**
+ * Carry-less multiplication, low half of the product.
+ */
+static inline uint32_t clmul32(uint32_t a, uint32_t b) {
+  uint32_t out;
+  asm("clmul %0, %1, %2" : "=r"(out) : "r"(a), "r"(b));
+  return out;
+}
+
+/**
+ * Carry-less multiplication, high half of the product.
+ */
+static inline uint32_t clmulh32(uint32_t a, uint32_t b) {
+  uint32_t out;
+  asm("clmulh %0, %1, %2" : "=r"(out) : "r"(a), "r"(b));
+  return out;
+}
+
+/**
+ * Multiply the GHASH state by the hash subkey.
+ *
+ * See NIST SP800-38D, section 6.3.
+ *
+ * Reading a block as a big-endian 128-bit integer gives its polynomial with
+ * the bits reflected (the coefficient of x^0 is the MSB). The carry-less
+ * product of two reflected operands is the reflected 255-bit product, so one
+ * left shift aligns it to 256 bits. The upper half then holds the low
+ * coefficients and the lower half the ones to reduce modulo
+ * x^128 + x^7 + x^2 + x + 1, which in the reflected domain is done with
+ * shifts (see the Intel white paper "Intel Carry-Less Multiplication
+ * Instruction and its Usage for Computing the GCM Mode", algorithm 5).
+ *
+ * Runs in constant time.
+ *
+ * @param ctx GHASH context, updated in place.
+ */
+static void galois_mul_state_key(ghash_context_t *ctx) {
+  // Load both operands as big-endian words, most significant first.
+  uint32_t a[kGhashBlockNumWords];
+  uint32_t b[kGhashBlockNumWords];
+  for (size_t i = 0; i < kGhashBlockNumWords; ++i) {
+    a[i] = __builtin_bswap32(ctx->state.data[i]);
+    b[i] = __builtin_bswap32(ctx->tbl[0].data[i]);
+  }
+
+  // Schoolbook multiplication into 256 bits, most significant word first.
+  uint32_t p[2 * kGhashBlockNumWords] = {0};
+  for (size_t i = 0; i < kGhashBlockNumWords; ++i) {
+    for (size_t j = 0; j < kGhashBlockNumWords; ++j) {
+      p[i + j] ^= clmulh32(a[i], b[j]);
+      p[i + j + 1] ^= clmul32(a[i], b[j]);
+    }
+  }
+
+  // Shift left by one and split into 64-bit halves, most significant first.
+  uint64_t x[4];
+  for (size_t i = 0; i < 4; ++i) {
+    uint32_t hi = (p[2 * i] << 1) | (p[2 * i + 1] >> 31);
+    uint32_t lo = p[2 * i + 1] << 1;
+    if (2 * i + 2 < ARRAYSIZE(p)) {
+      lo |= p[2 * i + 2] >> 31;
+    }
+    x[i] = ((uint64_t)hi << 32) | lo;
+  }
+
+  // Reduce the low 128 bits (`x[2]`, `x[3]`) into the high 128 bits.
+  uint64_t d = x[2] ^ (x[3] << 63) ^ (x[3] << 62) ^ (x[3] << 57);
+  uint64_t h1 = d ^ (d >> 1) ^ (d >> 2) ^ (d >> 7);
+  uint64_t h0 = x[3] ^ ((x[3] >> 1) | (d << 63)) ^ ((x[3] >> 2) | (d << 62)) ^
+                ((x[3] >> 7) | (d << 57));
+  uint64_t r[2] = {x[0] ^ h1, x[1] ^ h0};
+
+  for (size_t i = 0; i < 2; ++i) {
+    ctx->state.data[2 * i] = __builtin_bswap32((uint32_t)(r[i] >> 32));
+    ctx->state.data[2 * i + 1] = __builtin_bswap32((uint32_t)r[i]);
+  }
+}
+#else
 /**
  * Multiply the GHASH state by the hash subkey.
  *
@@ -189,10 +308,10 @@ static void galois_mul_state_key(ghash_context_t *ctx) {
   ghash_block_t result;
   memset(result.data, 0, kGhashBlockNumBytes);
 
-  // To compute the product, we iterate through the bytes of the input block,
-  // considering the most significant (in polynomial terms) first. For each
-  // byte b, we:
-  //   * multiply `result` by x^8 (shift all coefficients to the right)
+  // To compute the product, we iterate through the windows of the input
+  // block, considering the most significant (in polynomial terms) first. For
+  // each window b of w bits, we:
+  //   * multiply `result` by x^w (shift all coefficients to the right)
   //   * reduce the shifted `result` modulo the field modulus
   //   * look up the product `b * H` and add it to `result`
   //
@@ -200,11 +319,11 @@ static void galois_mul_state_key(ghash_context_t *ctx) {
   // `result` is 0.
   for (size_t i = 0; i < kNumWindows; ++i) {
     if (i != 0) {
-      // Save the most significant half-byte of `result` before shifting.
+      // Save the most significant window of `result` before shifting.
       uint8_t overflow =
-          block_byte_get(&result, kGhashBlockNumBytes - 1) & 0x0f;
+          block_byte_get(&result, kGhashBlockNumBytes - 1) & kWindowMask;
       // Shift `result` to the right, discarding high bits.
-      block_shiftr(&result, 4);
+      block_shiftr(&result, OTCRYPTO_GHASH_WINDOW_BITS);
       // Look up the product of `overflow` and the low terms of the modulus in
       // the precomputed table.
       uint16_t reduce_term = kGFReduceTable[overflow];
@@ -217,6 +336,9 @@ static void galois_mul_state_key(ghash_context_t *ctx) {
     // Add the product of the next window and H to `result`. We process the
     // windows starting with the most significant polynomial terms, which means
     // starting from the last byte and proceeding to the first.
+#if OTCRYPTO_GHASH_WINDOW_BITS == 8
+    uint8_t tbl_index = block_byte_get(&ctx->state, kNumWindows - 1 - i);
+#else
     uint8_t tbl_index = block_byte_get(&ctx->state, (kNumWindows - 1 - i) >> 1);
 
     // Select the less significant 4 bits if i is even, or the more significant
@@ -227,12 +349,15 @@ static void galois_mul_state_key(ghash_context_t *ctx) {
     } else {
       tbl_index &= 0x0f;
     }
+#endif
     block_xor(&result, &ctx->tbl[tbl_index], &result);
   }
 
   memcpy(ctx->state.data, result.data, kGhashBlockNumBytes);
 }
 
+#endif
+
 /**
  * Single-block update function for GHASH.
  *
@@ -12,6 +12,28 @@
 extern "C" {
 #endif  // __cplusplus
 
+/**
+ * GHASH backend selection.
+ *
+ * - If the target has the Zbc or Zbkc extension, GHASH uses the `clmul` and
+ *   `clmulh` instructions and stores only the hash subkey.
+ * - Otherwise, GHASH uses a precomputed product table with 4-bit windows (16
+ *   entries).
+ *
+ * Defining `OTCRYPTO_GHASH_TABLE8` selects 8-bit windows (256 entries)
+ * instead, which is faster for long inputs but makes the context much larger
+ * and the subkey setup slower. Defining `OTCRYPTO_GHASH_TABLE4` forces the
+ * 4-bit table. Both macros must be visible wherever this header is included.
+ */
+#if defined(OTCRYPTO_GHASH_TABLE8)
+#define OTCRYPTO_GHASH_WINDOW_BITS 8
+#elif defined(OTCRYPTO_GHASH_TABLE4) || \
+    !(defined(__riscv_zbc) || defined(__riscv_zbkc))
+#define OTCRYPTO_GHASH_WINDOW_BITS 4
+#else
+#define OTCRYPTO_GHASH_CLMUL 1
+#endif
+
 enum {
   /**
    * Size of a GHASH cipher block (128 bits) in bytes.
@@ -21,6 +43,14 @@ enum {
    * Size of a GHASH cipher block (128 bits) in words.
    */
   kGhashBlockNumWords = kGhashBlockNumBytes / sizeof(uint32_t),
+  /**
+   * Number of entries in the precomputed product table.
+   */
+#ifdef OTCRYPTO_GHASH_CLMUL
+  kGhashTableNumEntries = 1,
+#else
+  kGhashTableNumEntries = 1 << OTCRYPTO_GHASH_WINDOW_BITS,
+#endif
 };
 
 /**
@@ -32,9 +62,10 @@ typedef struct ghash_block {
 
 typedef struct ghash_context {
   /**
-   * Precomputed product table for the hash subkey.
+   * Precomputed product table for the hash subkey (just the hash subkey when
+   * using carry-less multiplication).
    */
-  ghash_block_t tbl[16];
+  ghash_block_t tbl[kGhashTableNumEntries];
   /**
    * Cipher block representing the current GHASH state.
    */
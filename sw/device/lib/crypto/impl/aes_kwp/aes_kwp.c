@@ -22,8 +22,161 @@ enum {
   kSemiblockBytes = kAesBlockNumBytes / 2,
   /** Number of 32-bit words in a semiblock (half an AES block). */
   kSemiblockWords = kSemiblockBytes / sizeof(uint32_t),
+  /** Maximum number of blocks in flight in a batch (see `aes_encrypt`). */
+  kAesKwpBlockOffset = 2,
 };
 
+/**
+ * Checks the result of the AES-KWP unwrapping function.
+ *
+ * @param a Final value of the first semiblock, A.
+ * @param r Final value of the remaining semiblocks, R.
+ * @param r_semiblocks Number of semiblocks in R.
+ * @param[out] plaintext_len Plaintext length in bytes, if valid.
+ * @return Whether the prefix and padding are valid.
+ */
+static hardened_bool_t kwp_unwrap_check(const uint32_t *a, const uint32_t *r,
+                                        size_t r_semiblocks,
+                                        size_t *plaintext_len) {
+  // Check that the first 32 bits of A match the AES-KWP fixed prefix.
+  if (a[0] != 0xa65959a6) {
+    return kHardenedBoolFalse;
+  }
+
+  // Decode the next 32 bits of A as the plaintext length.
+  *plaintext_len = __builtin_bswap32(a[1]);
+  size_t pad_len = kSemiblockBytes * r_semiblocks - *plaintext_len;
+
+  // Check that the padding length is valid.
+  if (pad_len >= kSemiblockBytes) {
+    return kHardenedBoolFalse;
+  }
+
+  // Check that the padding bytes are zero. Note: this should happen only after
+  // the prefix check. Otherwise it could expose a padding oracle, because
+  // memcmp is not constant-time.
+  if (pad_len != 0) {
+    uint8_t exp_pad[pad_len];
+    memset(exp_pad, 0, pad_len);
+    const unsigned char *pad_start =
+        ((const unsigned char *)r) + *plaintext_len;
+    if (memcmp(pad_start, exp_pad, pad_len) != 0) {
+      return kHardenedBoolFalse;
+    }
+  }
+
+  return kHardenedBoolTrue;
+}
+
+/**
+ * Working buffer of one key in a batch.
+ *
+ * The buffer holds A || R[1] || ... || R[n], where n is `num_semiblocks`.
+ */
+typedef struct kwp_state {
+  uint32_t *buf;
+  size_t num_semiblocks;
+} kwp_state_t;
+
+/**
+ * Encodes the index t and XORs it with the first semiblock.
+ *
+ * @param[in,out] a First semiblock, A.
+ * @param t Index.
+ */
+static void kwp_xor_index(uint32_t *a, uint64_t t) {
+  a[0] ^= __builtin_bswap32((uint32_t)(t >> 32));
+  a[1] ^= __builtin_bswap32((uint32_t)(t & UINT32_MAX));
+}
+
+/**
+ * Writes back the AES output for step i of one key in a batch.
+ *
+ * @param state Working buffer of the key.
+ * @param i Index of the semiblock of R that was processed.
+ * @param t Index for the step.
+ * @param decrypt Whether this is the unwrapping function.
+ * @param[in,out] block AES output for the step.
+ */
+static void kwp_batch_retire(const kwp_state_t *state, size_t i, uint64_t t,
+                             hardened_bool_t decrypt, aes_block_t *block) {
+  if (decrypt != kHardenedBoolTrue) {
+    kwp_xor_index(block->data, t);
+  }
+  hardened_memcpy(state->buf, block->data, kSemiblockWords);
+  hardened_memcpy(state->buf + i * kSemiblockWords,
+                  block->data + kSemiblockWords, kSemiblockWords);
+}
+
+/**
+ * Runs step (j, i) of the AES-KWP (un)wrapping function for a batch of keys.
+ *
+ * Keys with fewer than i semiblocks in R are skipped. The steps of different
+ * keys are independent, so they are run the way `aes_encrypt`/`aes_decrypt`
+ * run ECB blocks: up to `kAesKwpBlockOffset` blocks are in flight at once and
+ * the output of a key is only read once the input of a later key has been
+ * given to the AES block.
+ *
+ * The AES block must already be loaded with the KEK.
+ *
+ * @param states Working buffers of the keys.
+ * @param num_states Number of keys.
+ * @param j Outer loop index (0 to 5).
+ * @param i Index of the semiblock of R to process.
+ * @param decrypt Whether this is the unwrapping function.
+ * @return Error status; OK if no errors
+ */
+static status_t kwp_batch_step(const kwp_state_t *states, size_t num_states,
+                               size_t j, size_t i, hardened_bool_t decrypt) {
+  const kwp_state_t *pending[kAesKwpBlockOffset];
+  uint64_t pending_t[kAesKwpBlockOffset];
+  size_t num_pending = 0;
+  size_t head = 0;
+
+  aes_block_t block_in;
+  aes_block_t block_out;
+  for (size_t k = 0; k < num_states; k++) {
+    const kwp_state_t *state = &states[k];
+    if (i > state->num_semiblocks) {
+      continue;
+    }
+
+    // The index counts up from 1 while wrapping and back down to 1 while
+    // unwrapping; j counts up in both cases.
+    uint64_t round = decrypt == kHardenedBoolTrue ? 5 - j : j;
+    uint64_t t = round * state->num_semiblocks + i;
+
+    // Construct A || R[i] (with A ^ t when unwrapping).
+    hardened_memcpy(block_in.data, state->buf, kSemiblockWords);
+    hardened_memcpy(block_in.data + kSemiblockWords,
+                    state->buf + i * kSemiblockWords, kSemiblockWords);
+    if (decrypt == kHardenedBoolTrue) {
+      kwp_xor_index(block_in.data, t);
+    }
+
+    if (num_pending < kAesKwpBlockOffset) {
+      HARDENED_TRY(aes_update(/*dest=*/NULL, &block_in));
+      num_pending++;
+    } else {
+      HARDENED_TRY(aes_update(&block_out, &block_in));
+      kwp_batch_retire(pending[head], i, pending_t[head], decrypt, &block_out);
+      head = (head + 1) % kAesKwpBlockOffset;
+    }
+    size_t slot = (head + num_pending - 1) % kAesKwpBlockOffset;
+    pending[slot] = state;
+    pending_t[slot] = t;
+  }
+
+  // Retrieve the remaining outputs.
+  for (; num_pending > 0; num_pending--) {
+    HARDENED_TRY(aes_update(&block_out, /*src=*/NULL));
+    kwp_batch_retire(pending[head], i, pending_t[head], decrypt, &block_out);
+    head = (head + 1) % kAesKwpBlockOffset;
+  }
+
+  return OTCRYPTO_OK;
+}
+
 status_t aes_kwp_wrap(const aes_key_t kek, const uint32_t *plaintext,
                       const size_t plaintext_len, uint32_t *ciphertext) {
   // The plaintext length is expected to be at most 2^32 bytes.
@@ -142,41 +295,139 @@ status_t aes_kwp_unwrap(const aes_key_t kek, const uint32_t *ciphertext,
     }
   }
 
-  // Check that the first 32 bits of A match the AES-KWP fixed prefix.
-  if (block.data[0] != 0xa65959a6) {
+  // Check the prefix and padding.
+  size_t plaintext_len;
+  *success = kwp_unwrap_check(block.data, r, ciphertext_semiblocks - 1,
+                              &plaintext_len);
+  if (*success != kHardenedBoolTrue) {
     *success = kHardenedBoolFalse;
     return OTCRYPTO_OK;
   }
 
-  // Decode the next 32 bits of A as the plaintext length.
-  size_t plaintext_len = __builtin_bswap32(block.data[1]);
-  size_t pad_len =
-      kSemiblockBytes * (ciphertext_semiblocks - 1) - plaintext_len;
+  // Copy the plaintext into the destination buffer.
+  size_t plaintext_words = ceil_div(plaintext_len, sizeof(uint32_t));
+  hardened_memcpy(plaintext, r, plaintext_words);
+  return OTCRYPTO_OK;
+}
 
-  // Check that the padding length is valid.
-  if (pad_len >= kSemiblockBytes) {
-    *success = kHardenedBoolFalse;
-    return OTCRYPTO_OK;
+status_t aes_kwp_wrap_batch(const aes_key_t kek, aes_kwp_wrap_job_t *jobs,
+                            size_t num_jobs) {
+  if (jobs == NULL || num_jobs == 0) {
+    return OTCRYPTO_BAD_ARGS;
   }
 
-  // Check that the padding bytes are zero. Note: this should happen only after
-  // the prefix check. Otherwise it could expose a padding oracle, because
-  // memcmp is not constant-time.
-  if (pad_len != 0) {
-    uint8_t exp_pad[pad_len];
-    memset(exp_pad, 0, pad_len);
-    unsigned char *pad_start = ((unsigned char *)r) + plaintext_len;
-    if (memcmp(pad_start, exp_pad, pad_len) != 0) {
-      *success = kHardenedBoolFalse;
-      return OTCRYPTO_OK;
+  // Check all the jobs before writing anything.
+  kwp_state_t states[num_jobs];
+  size_t max_semiblocks = 0;
+  for (size_t k = 0; k < num_jobs; k++) {
+    size_t plaintext_len = jobs[k].plaintext_len;
+    if (jobs[k].plaintext == NULL || jobs[k].ciphertext == NULL ||
+        plaintext_len > UINT32_MAX || plaintext_len == 0) {
+      return OTCRYPTO_BAD_ARGS;
+    }
+    states[k].buf = jobs[k].ciphertext;
+    states[k].num_semiblocks = ceil_div(plaintext_len, kSemiblockBytes);
+    if (states[k].num_semiblocks < 2) {
+      // Plaintext is too short.
+      return OTCRYPTO_BAD_ARGS;
+    }
+    if (states[k].num_semiblocks > max_semiblocks) {
+      max_semiblocks = states[k].num_semiblocks;
     }
   }
 
-  // Copy the plaintext into the destination buffer.
-  size_t plaintext_words = ceil_div(plaintext_len, sizeof(uint32_t));
-  hardened_memcpy(plaintext, r, plaintext_words);
+  // Initialize each output buffer with (A || plaintext || padding), as in
+  // `aes_kwp_wrap`.
+  for (size_t k = 0; k < num_jobs; k++) {
+    size_t plaintext_len = jobs[k].plaintext_len;
+    size_t pad_len = kSemiblockBytes * states[k].num_semiblocks - plaintext_len;
+    uint32_t a[kSemiblockWords] = {0xa65959a6,
+                                   __builtin_bswap32(plaintext_len)};
+    hardened_memcpy(states[k].buf, a, kSemiblockWords);
+    hardened_memcpy(states[k].buf + kSemiblockWords, jobs[k].plaintext,
+                    ceil_div(plaintext_len, sizeof(uint32_t)));
+    unsigned char *pad_start =
+        ((unsigned char *)states[k].buf) + kSemiblockBytes + plaintext_len;
+    memset(pad_start, 0, pad_len);
+  }
+
+  // Load the AES block with the encryption key once for all keys.
+  HARDENED_TRY(aes_encrypt_begin(kek, /*iv=*/NULL));
+  for (size_t j = 0; j < 6; j++) {
+    for (size_t i = 1; i <= max_semiblocks; i++) {
+      HARDENED_TRY(kwp_batch_step(states, num_jobs, j, i,
+                                  /*decrypt=*/kHardenedBoolFalse));
+    }
+  }
+
+  // A is already in the first semiblock of each ciphertext.
+  return aes_end(/*iv=*/NULL);
+}
+
+status_t aes_kwp_unwrap_batch(const aes_key_t kek, aes_kwp_unwrap_job_t *jobs,
+                              size_t num_jobs) {
+  if (jobs == NULL || num_jobs == 0) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+
+  // Check all the jobs before writing anything.
+  kwp_state_t states[num_jobs];
+  size_t max_semiblocks = 0;
+  for (size_t k = 0; k < num_jobs; k++) {
+    size_t ciphertext_len = jobs[k].ciphertext_len;
+    if (jobs[k].ciphertext == NULL || jobs[k].plaintext == NULL ||
+        ciphertext_len > UINT32_MAX || ciphertext_len == 0 ||
+        ciphertext_len % kSemiblockBytes != 0) {
+      return OTCRYPTO_BAD_ARGS;
+    }
+    if (ciphertext_len / kSemiblockBytes < 3) {
+      // Ciphertext is too short.
+      return OTCRYPTO_BAD_ARGS;
+    }
+    // The plaintext buffer is the same length as the ciphertext, so it is
+    // used as the working buffer (A || R).
+    states[k].buf = jobs[k].plaintext;
+    states[k].num_semiblocks = ciphertext_len / kSemiblockBytes - 1;
+    if (states[k].num_semiblocks > max_semiblocks) {
+      max_semiblocks = states[k].num_semiblocks;
+    }
+  }
+
+  for (size_t k = 0; k < num_jobs; k++) {
+    jobs[k].success = kHardenedBoolFalse;
+    hardened_memcpy(states[k].buf, jobs[k].ciphertext,
+                    jobs[k].ciphertext_len / sizeof(uint32_t));
+  }
+
+  // Load the AES block with the decryption key once for all keys.
+  HARDENED_TRY(aes_decrypt_begin(kek, /*iv=*/NULL));
+  for (size_t j = 0; j < 6; j++) {
+    for (size_t i = max_semiblocks; 1 <= i; i--) {
+      HARDENED_TRY(kwp_batch_step(states, num_jobs, j, i,
+                                  /*decrypt=*/kHardenedBoolTrue));
+    }
+  }
+  HARDENED_TRY(aes_end(/*iv=*/NULL));
+
+  for (size_t k = 0; k < num_jobs; k++) {
+    // Move R to the start of the plaintext buffer, one semiblock at a time.
+    uint32_t a[kSemiblockWords];
+    uint32_t *buf = states[k].buf;
+    hardened_memcpy(a, buf, kSemiblockWords);
+    for (size_t i = 0; i < states[k].num_semiblocks; i++) {
+      hardened_memcpy(buf + i * kSemiblockWords,
+                      buf + (i + 1) * kSemiblockWords, kSemiblockWords);
+    }
+
+    size_t plaintext_len;
+    jobs[k].success =
+        kwp_unwrap_check(a, buf, states[k].num_semiblocks, &plaintext_len);
+    if (jobs[k].success != kHardenedBoolTrue) {
+      // Don't leave unauthenticated data in the output.
+      jobs[k].success = kHardenedBoolFalse;
+      hardened_memshred(buf, jobs[k].ciphertext_len / sizeof(uint32_t));
+    }
+  }
 
-  // Return success.
-  *success = kHardenedBoolTrue;
   return OTCRYPTO_OK;
 }
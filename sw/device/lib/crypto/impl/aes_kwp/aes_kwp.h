@@ -80,6 +80,92 @@ status_t aes_kwp_unwrap(const aes_key_t kek, const uint32_t *ciphertext,
                         const size_t ciphertext_len, hardened_bool_t *success,
                         uint32_t *plaintext);
 
+/**
+ * A key to wrap with `aes_kwp_wrap_batch`.
+ *
+ * The fields have the same requirements as the parameters of `aes_kwp_wrap`.
+ */
+typedef struct aes_kwp_wrap_job {
+  /**
+   * Key material to wrap.
+   */
+  const uint32_t *plaintext;
+  /**
+   * Plaintext length in bytes.
+   */
+  size_t plaintext_len;
+  /**
+   * Output buffer.
+   */
+  uint32_t *ciphertext;
+} aes_kwp_wrap_job_t;
+
+/**
+ * A key to unwrap with `aes_kwp_unwrap_batch`.
+ *
+ * The fields have the same requirements as the parameters of
+ * `aes_kwp_unwrap`.
+ */
+typedef struct aes_kwp_unwrap_job {
+  /**
+   * Key material to unwrap.
+   */
+  const uint32_t *ciphertext;
+  /**
+   * Ciphertext length in bytes.
+   */
+  size_t ciphertext_len;
+  /**
+   * Output buffer, same length as the ciphertext.
+   */
+  uint32_t *plaintext;
+  /**
+   * Set to whether the ciphertext was valid.
+   */
+  hardened_bool_t success;
+} aes_kwp_unwrap_job_t;
+
+/**
+ * AES-KWP authenticated encryption of several keys under the same KEK.
+ *
+ * Equivalent to calling `aes_kwp_wrap` for each job, but the KEK is loaded
+ * into the AES block only once and the AES operations for the different keys
+ * (which do not depend on each other) are interleaved so that the AES block
+ * is kept busy while software prepares the next input. The AES block is
+ * cleared once all keys are wrapped.
+ *
+ * All jobs are checked before any of them is started; if any job is invalid,
+ * no ciphertext is written.
+ *
+ * @param kek Key encryption key, AES key to encrypt with.
+ * @param jobs Keys to wrap.
+ * @param num_jobs Number of entries in `jobs`.
+ * @return Error status; OK if no errors
+ */
+OT_WARN_UNUSED_RESULT
+status_t aes_kwp_wrap_batch(const aes_key_t kek, aes_kwp_wrap_job_t *jobs,
+                            size_t num_jobs);
+
+/**
+ * AES-KWP authenticated decryption of several keys under the same KEK.
+ *
+ * Equivalent to calling `aes_kwp_unwrap` for each job, with the KEK loaded
+ * only once as for `aes_kwp_wrap_batch`.
+ *
+ * An OK status from this routine does NOT mean that the unwrapping succeeded,
+ * only that there were no errors during execution. The caller must check both
+ * the returned status and the `success` field of each job before reading its
+ * plaintext. The plaintext buffer of a job that fails to unwrap is cleared.
+ *
+ * @param kek Key encryption key, AES key to decrypt with.
+ * @param jobs Keys to unwrap.
+ * @param num_jobs Number of entries in `jobs`.
+ * @return Error status; OK if no errors
+ */
+OT_WARN_UNUSED_RESULT
+status_t aes_kwp_unwrap_batch(const aes_key_t kek, aes_kwp_unwrap_job_t *jobs,
+                              size_t num_jobs);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -178,6 +178,14 @@ static otcrypto_status_t generate(hardened_bool_t fips_check,
     return OTCRYPTO_BAD_ARGS;
   }
 
+  // Requests without additional input that need FIPS-compatible output may be
+  // served from the output pool.
+  if (launder32(fips_check) == kHardenedBoolTrue &&
+      additional_input.len == 0) {
+    HARDENED_CHECK_EQ(fips_check, kHardenedBoolTrue);
+    return entropy_pool_generate(drbg_output.data, drbg_output.len);
+  }
+
   entropy_seed_material_t seed_material;
   seed_material_construct(additional_input, &seed_material);
   HARDENED_TRY(entropy_csrng_generate(&seed_material, drbg_output.data,
@@ -200,6 +208,58 @@ otcrypto_status_t otcrypto_drbg_manual_generate(
                   drbg_output);
 }
 
+/**
+ * Length in words of the request started by
+ * `otcrypto_drbg_generate_async_start`.
+ */
+static size_t async_generate_len = 0;
+
+/**
+ * Whether a request started by `otcrypto_drbg_generate_async_start` has not
+ * yet been finalized.
+ */
+static hardened_bool_t async_generate_pending = kHardenedBoolFalse;
+
+otcrypto_status_t otcrypto_drbg_generate_async_start(
+    otcrypto_const_byte_buf_t additional_input, size_t output_len) {
+  if (additional_input.len != 0 && additional_input.data == NULL) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+  if (launder32(async_generate_pending) != kHardenedBoolFalse) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+
+  if (output_len != 0) {
+    entropy_seed_material_t seed_material;
+    HARDENED_TRY(seed_material_construct(additional_input, &seed_material));
+    HARDENED_TRY(entropy_csrng_generate_start(&seed_material, output_len));
+  }
+  async_generate_len = output_len;
+  async_generate_pending = kHardenedBoolTrue;
+  return OTCRYPTO_OK;
+}
+
+otcrypto_status_t otcrypto_drbg_generate_async_finalize(
+    otcrypto_word32_buf_t drbg_output) {
+  if (launder32(async_generate_pending) != kHardenedBoolTrue ||
+      drbg_output.len != async_generate_len ||
+      (drbg_output.len != 0 && drbg_output.data == NULL)) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+  HARDENED_CHECK_EQ(async_generate_pending, kHardenedBoolTrue);
+  async_generate_pending = kHardenedBoolFalse;
+
+  if (drbg_output.len == 0) {
+    return OTCRYPTO_OK;
+  }
+  return entropy_csrng_generate_data_get(drbg_output.data, drbg_output.len,
+                                         /*fips_check=*/kHardenedBoolTrue);
+}
+
+otcrypto_status_t otcrypto_drbg_pool_enable(hardened_bool_t enable) {
+  return entropy_pool_enable(enable);
+}
+
 otcrypto_status_t otcrypto_drbg_uninstantiate(void) {
   return entropy_csrng_uninstantiate();
 }
@@ -0,0 +1,315 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "sw/device/lib/crypto/impl/ecc/ed25519.h"
+
+#include "sw/device/lib/base/hardened.h"
+#include "sw/device/lib/base/hardened_memory.h"
+#include "sw/device/lib/crypto/drivers/otbn.h"
+
+#include "hw/top_earlgrey/sw/autogen/top_earlgrey.h"
+
+// Module ID for status codes.
+#define MODULE_ID MAKE_MODULE_ID('e', '2', 'r')
+
+// Declare the OTBN app.
+OTBN_DECLARE_APP_SYMBOLS(run_ed25519);  // The OTBN Ed25519 app.
+static const otbn_app_t kOtbnAppEd25519 = OTBN_APP_T_INIT(run_ed25519);
+
+// Declare offsets for input and output buffers.
+OTBN_DECLARE_SYMBOL_ADDR(run_ed25519, mode);        // Mode of operation.
+OTBN_DECLARE_SYMBOL_ADDR(run_ed25519, ok);          // Status code.
+OTBN_DECLARE_SYMBOL_ADDR(run_ed25519, seed0);       // Seed (share 0).
+OTBN_DECLARE_SYMBOL_ADDR(run_ed25519, seed1);       // Seed (share 1).
+OTBN_DECLARE_SYMBOL_ADDR(run_ed25519, h_a);         // Lower half of H(seed).
+OTBN_DECLARE_SYMBOL_ADDR(run_ed25519, h_r);         // Hash for nonce r.
+OTBN_DECLARE_SYMBOL_ADDR(run_ed25519, h_k);         // Hash for challenge k.
+OTBN_DECLARE_SYMBOL_ADDR(run_ed25519, enc_a);       // Public key A.
+OTBN_DECLARE_SYMBOL_ADDR(run_ed25519, enc_r);       // Signature point R.
+OTBN_DECLARE_SYMBOL_ADDR(run_ed25519, sig_s);       // Signature scalar S.
+OTBN_DECLARE_SYMBOL_ADDR(run_ed25519, enc_result);  // Verification result.
+OTBN_DECLARE_SYMBOL_ADDR(run_ed25519, batch_n);     // Batch size.
+OTBN_DECLARE_SYMBOL_ADDR(run_ed25519, batch_idx);   // Current batch item.
+OTBN_DECLARE_SYMBOL_ADDR(run_ed25519, batch_in);    // Batch inputs.
+OTBN_DECLARE_SYMBOL_ADDR(run_ed25519, batch_result);  // Batch results.
+
+static const otbn_addr_t kOtbnVarMode = OTBN_ADDR_T_INIT(run_ed25519, mode);
+static const otbn_addr_t kOtbnVarOk = OTBN_ADDR_T_INIT(run_ed25519, ok);
+static const otbn_addr_t kOtbnVarSeed0 = OTBN_ADDR_T_INIT(run_ed25519, seed0);
+static const otbn_addr_t kOtbnVarSeed1 = OTBN_ADDR_T_INIT(run_ed25519, seed1);
+static const otbn_addr_t kOtbnVarHashA = OTBN_ADDR_T_INIT(run_ed25519, h_a);
+static const otbn_addr_t kOtbnVarHashR = OTBN_ADDR_T_INIT(run_ed25519, h_r);
+static const otbn_addr_t kOtbnVarHashK = OTBN_ADDR_T_INIT(run_ed25519, h_k);
+static const otbn_addr_t kOtbnVarEncA = OTBN_ADDR_T_INIT(run_ed25519, enc_a);
+static const otbn_addr_t kOtbnVarEncR = OTBN_ADDR_T_INIT(run_ed25519, enc_r);
+static const otbn_addr_t kOtbnVarSigS = OTBN_ADDR_T_INIT(run_ed25519, sig_s);
+static const otbn_addr_t kOtbnVarEncResult =
+    OTBN_ADDR_T_INIT(run_ed25519, enc_result);
+static const otbn_addr_t kOtbnVarBatchN =
+    OTBN_ADDR_T_INIT(run_ed25519, batch_n);
+static const otbn_addr_t kOtbnVarBatchIdx =
+    OTBN_ADDR_T_INIT(run_ed25519, batch_idx);
+static const otbn_addr_t kOtbnVarBatchIn =
+    OTBN_ADDR_T_INIT(run_ed25519, batch_in);
+static const otbn_addr_t kOtbnVarBatchResult =
+    OTBN_ADDR_T_INIT(run_ed25519, batch_result);
+
+// Declare mode constants.
+OTBN_DECLARE_SYMBOL_ADDR(run_ed25519, MODE_GEN_SEED);
+OTBN_DECLARE_SYMBOL_ADDR(run_ed25519, MODE_KEYGEN);
+OTBN_DECLARE_SYMBOL_ADDR(run_ed25519, MODE_SIGN_COMMIT);
+OTBN_DECLARE_SYMBOL_ADDR(run_ed25519, MODE_SIGN_FINISH);
+OTBN_DECLARE_SYMBOL_ADDR(run_ed25519, MODE_VERIFY);
+OTBN_DECLARE_SYMBOL_ADDR(run_ed25519, MODE_VERIFY_BATCH);
+static const uint32_t kOtbnEd25519ModeGenSeed =
+    OTBN_ADDR_T_INIT(run_ed25519, MODE_GEN_SEED);
+static const uint32_t kOtbnEd25519ModeKeygen =
+    OTBN_ADDR_T_INIT(run_ed25519, MODE_KEYGEN);
+static const uint32_t kOtbnEd25519ModeSignCommit =
+    OTBN_ADDR_T_INIT(run_ed25519, MODE_SIGN_COMMIT);
+static const uint32_t kOtbnEd25519ModeSignFinish =
+    OTBN_ADDR_T_INIT(run_ed25519, MODE_SIGN_FINISH);
+static const uint32_t kOtbnEd25519ModeVerify =
+    OTBN_ADDR_T_INIT(run_ed25519, MODE_VERIFY);
+static const uint32_t kOtbnEd25519ModeVerifyBatch =
+    OTBN_ADDR_T_INIT(run_ed25519, MODE_VERIFY_BATCH);
+
+enum {
+  /*
+   * Mode is represented by a single word.
+   */
+  kOtbnEd25519ModeWords = 1,
+  /**
+   * Size of one batch verification input item (A, S, h_k) in bytes.
+   */
+  kOtbnBatchItemBytes = 4 * kOtbnWideWordNumBytes,
+};
+
+/**
+ * Start the Ed25519 app in the given mode.
+ *
+ * Expects the app to be loaded.
+ */
+static status_t ed25519_execute(uint32_t mode) {
+  HARDENED_TRY(otbn_dmem_write(kOtbnEd25519ModeWords, &mode, kOtbnVarMode));
+  return otbn_execute();
+}
+
+status_t ed25519_keygen_seed(ed25519_masked_seed_t *seed) {
+  // Load the Ed25519 app. Fails if OTBN is non-idle.
+  HARDENED_TRY(otbn_load_app(kOtbnAppEd25519));
+
+  // Generate the seed and wait for OTBN to complete.
+  HARDENED_TRY(ed25519_execute(kOtbnEd25519ModeGenSeed));
+  HARDENED_TRY(otbn_busy_wait_for_done());
+
+  // Read the seed shares; they stay in DMEM for `ed25519_keygen_finalize`.
+  HARDENED_TRY(otbn_dmem_read(kEd25519MaskedSeedShareWords, kOtbnVarSeed0,
+                              seed->share0));
+  return otbn_dmem_read(kEd25519MaskedSeedShareWords, kOtbnVarSeed1,
+                        seed->share1);
+}
+
+status_t ed25519_keygen_start(const uint32_t hash_lo[kEd25519ScalarWords]) {
+  // Set the hash of the seed.
+  HARDENED_TRY(otbn_dmem_write(kEd25519ScalarWords, hash_lo, kOtbnVarHashA));
+
+  // Start the OTBN routine.
+  return ed25519_execute(kOtbnEd25519ModeKeygen);
+}
+
+status_t ed25519_keygen_finalize(ed25519_masked_seed_t *seed,
+                                 uint32_t public_key[kEd25519PointWords]) {
+  // Spin here waiting for OTBN to complete.
+  HARDENED_TRY(otbn_busy_wait_for_done());
+
+  // Read the masked seed from OTBN dmem.
+  HARDENED_TRY(otbn_dmem_read(kEd25519MaskedSeedShareWords, kOtbnVarSeed0,
+                              seed->share0));
+  HARDENED_TRY(otbn_dmem_read(kEd25519MaskedSeedShareWords, kOtbnVarSeed1,
+                              seed->share1));
+
+  // Read the public key from OTBN dmem.
+  HARDENED_TRY(otbn_dmem_read(kEd25519PointWords, kOtbnVarEncA, public_key));
+
+  // Wipe DMEM.
+  HARDENED_TRY(otbn_dmem_sec_wipe());
+
+  return OTCRYPTO_OK;
+}
+
+status_t ed25519_sign_commit(const uint32_t hash_lo[kEd25519ScalarWords],
+                             const uint32_t hash_r[kEd25519HashWords],
+                             uint32_t public_key[kEd25519PointWords],
+                             uint32_t r[kEd25519PointWords]) {
+  // Load the Ed25519 app. Fails if OTBN is non-idle.
+  HARDENED_TRY(otbn_load_app(kOtbnAppEd25519));
+
+  // Set the hashes for the secret scalar and the nonce.
+  HARDENED_TRY(otbn_dmem_write(kEd25519ScalarWords, hash_lo, kOtbnVarHashA));
+  HARDENED_TRY(otbn_dmem_write(kEd25519HashWords, hash_r, kOtbnVarHashR));
+
+  // Compute A and R and wait for OTBN to complete.
+  HARDENED_TRY(ed25519_execute(kOtbnEd25519ModeSignCommit));
+  HARDENED_TRY(otbn_busy_wait_for_done());
+
+  // Read A and R; the secrets stay in DMEM for `ed25519_sign_finish_start`.
+  HARDENED_TRY(otbn_dmem_read(kEd25519PointWords, kOtbnVarEncA, public_key));
+  return otbn_dmem_read(kEd25519PointWords, kOtbnVarEncR, r);
+}
+
+status_t ed25519_sign_finish_start(const uint32_t hash_k[kEd25519HashWords]) {
+  // Set the challenge hash.
+  HARDENED_TRY(otbn_dmem_write(kEd25519HashWords, hash_k, kOtbnVarHashK));
+
+  // Start the OTBN routine.
+  return ed25519_execute(kOtbnEd25519ModeSignFinish);
+}
+
+status_t ed25519_sign_finalize(uint32_t s[kEd25519ScalarWords]) {
+  // Spin here waiting for OTBN to complete.
+  HARDENED_TRY(otbn_busy_wait_for_done());
+
+  // Read signature S out of OTBN dmem.
+  HARDENED_TRY(otbn_dmem_read(kEd25519ScalarWords, kOtbnVarSigS, s));
+
+  // Wipe DMEM.
+  HARDENED_TRY(otbn_dmem_sec_wipe());
+
+  return OTCRYPTO_OK;
+}
+
+status_t ed25519_verify_start(const ed25519_signature_t *signature,
+                              const uint32_t hash_k[kEd25519HashWords],
+                              const uint32_t public_key[kEd25519PointWords]) {
+  // Load the Ed25519 app. Fails if OTBN is non-idle.
+  HARDENED_TRY(otbn_load_app(kOtbnAppEd25519));
+
+  // Set the public key, signature and challenge hash. R is not used by OTBN,
+  // but is kept in DMEM for `ed25519_verify_finalize` to compare against.
+  HARDENED_TRY(otbn_dmem_write(kEd25519PointWords, public_key, kOtbnVarEncA));
+  HARDENED_TRY(otbn_dmem_write(kEd25519PointWords, signature->r, kOtbnVarEncR));
+  HARDENED_TRY(
+      otbn_dmem_write(kEd25519ScalarWords, signature->s, kOtbnVarSigS));
+  HARDENED_TRY(otbn_dmem_write(kEd25519HashWords, hash_k, kOtbnVarHashK));
+
+  // Start the OTBN routine.
+  return ed25519_execute(kOtbnEd25519ModeVerify);
+}
+
+status_t ed25519_verify_finalize(hardened_bool_t *result) {
+  // Spin here waiting for OTBN to complete.
+  HARDENED_TRY(otbn_busy_wait_for_done());
+
+  // Read the status code out of DMEM (false if basic checks on the validity of
+  // the signature and public key failed).
+  uint32_t ok;
+  HARDENED_TRY(otbn_dmem_read(1, kOtbnVarOk, &ok));
+  if (launder32(ok) != kHardenedBoolTrue) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+  HARDENED_CHECK_EQ(ok, kHardenedBoolTrue);
+
+  // Read the recomputed R and the one from the signature out of OTBN dmem.
+  uint32_t enc_result[kEd25519PointWords];
+  uint32_t enc_r[kEd25519PointWords];
+  HARDENED_TRY(
+      otbn_dmem_read(kEd25519PointWords, kOtbnVarEncResult, enc_result));
+  HARDENED_TRY(otbn_dmem_read(kEd25519PointWords, kOtbnVarEncR, enc_r));
+
+  *result = hardened_memeq(enc_result, enc_r, kEd25519PointWords);
+
+  // Wipe DMEM.
+  HARDENED_TRY(otbn_dmem_sec_wipe());
+
+  return OTCRYPTO_OK;
+}
+
+/**
+ * Verify up to `kEd25519BatchVerifyMaxItems` signatures in one OTBN run.
+ *
+ * Expects the Ed25519 app to be loaded and OTBN to be idle.
+ */
+static status_t ed25519_verify_batch_chunk(const ed25519_verify_item_t *items,
+                                           uint32_t num_items,
+                                           hardened_bool_t *results) {
+  uint32_t mode = kOtbnEd25519ModeVerifyBatch;
+  HARDENED_TRY(otbn_dmem_write(kOtbnEd25519ModeWords, &mode, kOtbnVarMode));
+  HARDENED_TRY(otbn_dmem_write(1, &num_items, kOtbnVarBatchN));
+
+  // Write all the items.
+  size_t i = 0;
+  for (; launder32(i) < num_items; i++) {
+    otbn_addr_t item_addr = kOtbnVarBatchIn + i * kOtbnBatchItemBytes;
+    HARDENED_TRY(
+        otbn_dmem_write(kEd25519PointWords, items[i].public_key, item_addr));
+    item_addr += kOtbnWideWordNumBytes;
+    HARDENED_TRY(
+        otbn_dmem_write(kEd25519ScalarWords, items[i].signature->s, item_addr));
+    item_addr += kOtbnWideWordNumBytes;
+    HARDENED_TRY(otbn_dmem_write(kEd25519HashWords, items[i].hash, item_addr));
+  }
+  HARDENED_CHECK_EQ(i, num_items);
+
+  // Run OTBN until it gets through the whole batch. An item failing the basic
+  // validity checks ends the run early; it is invalid, and the next run starts
+  // after it.
+  uint32_t start = 0;
+  while (start < num_items) {
+    HARDENED_TRY(otbn_dmem_write(1, &start, kOtbnVarBatchIdx));
+    HARDENED_TRY(otbn_execute());
+    HARDENED_TRY(otbn_busy_wait_for_done());
+
+    uint32_t ok;
+    uint32_t end;
+    HARDENED_TRY(otbn_dmem_read(1, kOtbnVarOk, &ok));
+    HARDENED_TRY(otbn_dmem_read(1, kOtbnVarBatchIdx, &end));
+    if (end < start || end > num_items ||
+        (end == num_items && launder32(ok) != kHardenedBoolTrue)) {
+      return OTCRYPTO_FATAL_ERR;
+    }
+
+    // Compare the recomputed R values of the items verified in this run.
+    for (i = start; launder32(i) < end; i++) {
+      uint32_t enc_result[kEd25519PointWords];
+      HARDENED_TRY(otbn_dmem_read(kEd25519PointWords,
+                                  kOtbnVarBatchResult + i * kEd25519PointBytes,
+                                  enc_result));
+      results[i] =
+          hardened_memeq(enc_result, items[i].signature->r, kEd25519PointWords);
+    }
+    HARDENED_CHECK_EQ(i, end);
+
+    if (end == num_items) {
+      break;
+    }
+    HARDENED_CHECK_NE(ok, kHardenedBoolTrue);
+    results[end] = kHardenedBoolFalse;
+    start = end + 1;
+  }
+
+  return OTCRYPTO_OK;
+}
+
+status_t ed25519_verify_batch(const ed25519_verify_item_t *items,
+                              size_t num_items, hardened_bool_t *results) {
+  // Load the Ed25519 app once for the whole batch. Fails if OTBN is non-idle.
+  HARDENED_TRY(otbn_load_app(kOtbnAppEd25519));
+
+  size_t done = 0;
+  while (done < num_items) {
+    size_t chunk = num_items - done;
+    if (chunk > kEd25519BatchVerifyMaxItems) {
+      chunk = kEd25519BatchVerifyMaxItems;
+    }
+    HARDENED_TRY(ed25519_verify_batch_chunk(&items[done], (uint32_t)chunk,
+                                            &results[done]));
+    done += chunk;
+  }
+
+  // Wipe DMEM.
+  HARDENED_TRY(otbn_dmem_sec_wipe());
+
+  return OTCRYPTO_OK;
+}
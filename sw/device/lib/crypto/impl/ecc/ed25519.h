@@ -0,0 +1,259 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef OPENTITAN_SW_DEVICE_LIB_CRYPTO_IMPL_ECC_ED25519_H_
+#define OPENTITAN_SW_DEVICE_LIB_CRYPTO_IMPL_ECC_ED25519_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "sw/device/lib/base/hardened.h"
+#include "sw/device/lib/crypto/drivers/otbn.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+enum {
+  /**
+   * Length of an encoded Ed25519 curve point in bits.
+   */
+  kEd25519PointBits = 256,
+  /**
+   * Length of an encoded Ed25519 curve point in bytes.
+   */
+  kEd25519PointBytes = kEd25519PointBits / 8,
+  /**
+   * Length of an encoded Ed25519 curve point in words.
+   */
+  kEd25519PointWords = kEd25519PointBytes / sizeof(uint32_t),
+  /**
+   * Length of an Ed25519 scalar (modulo the group order L) in bits.
+   */
+  kEd25519ScalarBits = 256,
+  /**
+   * Length of an Ed25519 scalar in bytes.
+   */
+  kEd25519ScalarBytes = kEd25519ScalarBits / 8,
+  /**
+   * Length of an Ed25519 scalar in words.
+   */
+  kEd25519ScalarWords = kEd25519ScalarBytes / sizeof(uint32_t),
+  /**
+   * Length of an Ed25519 private key (the seed) in bytes.
+   */
+  kEd25519SeedBytes = 32,
+  /**
+   * Length of a masked seed share in bits.
+   *
+   * This implementation uses extra redundant bits for side-channel protection.
+   */
+  kEd25519MaskedSeedShareBits = kEd25519SeedBytes * 8 + 64,
+  /**
+   * Length of a masked seed share in bytes.
+   */
+  kEd25519MaskedSeedShareBytes = kEd25519MaskedSeedShareBits / 8,
+  /**
+   * Length of a masked seed share in words.
+   */
+  kEd25519MaskedSeedShareWords =
+      kEd25519MaskedSeedShareBytes / sizeof(uint32_t),
+  /**
+   * Length of a SHA-512 digest in words.
+   */
+  kEd25519HashWords = 512 / 32,
+  /**
+   * Maximum number of signatures verified in one OTBN run of a batch.
+   *
+   * Must match BATCH_MAX_ITEMS in `run_ed25519.s`.
+   */
+  kEd25519BatchVerifyMaxItems = 8,
+};
+
+/**
+ * A type that holds a masked Ed25519 private key (the 32-byte seed).
+ *
+ * The seed is represented in two 320-bit shares, such that seed = (share0 ^
+ * share1) mod 2^256.
+ */
+typedef struct ed25519_masked_seed {
+  /**
+   * First share of the seed.
+   */
+  uint32_t share0[kEd25519MaskedSeedShareWords];
+  /**
+   * Second share of the seed.
+   */
+  uint32_t share1[kEd25519MaskedSeedShareWords];
+} ed25519_masked_seed_t;
+
+/**
+ * A type that holds an Ed25519 signature.
+ *
+ * The signature consists of the encoded point R and the scalar S, both in the
+ * byte order of RFC 8032.
+ */
+typedef struct ed25519_signature {
+  uint32_t r[kEd25519PointWords];
+  uint32_t s[kEd25519ScalarWords];
+} ed25519_signature_t;
+
+/**
+ * One signature of a batch verification.
+ */
+typedef struct ed25519_verify_item {
+  /**
+   * Signature to be verified.
+   */
+  const ed25519_signature_t *signature;
+  /**
+   * SHA-512(dom2 || R || A || M), the hash binding the signature to the
+   * message and key.
+   */
+  const uint32_t *hash;
+  /**
+   * Encoded public key A to check the signature against.
+   */
+  const uint32_t *public_key;
+} ed25519_verify_item_t;
+
+/**
+ * Generate a random Ed25519 seed on OTBN.
+ *
+ * Loads the Ed25519 app and leaves the seed in DMEM for
+ * `ed25519_keygen_start`. Blocks until OTBN is idle. Returns an
+ * `OTCRYPTO_ASYNC_INCOMPLETE` error if OTBN is busy when called.
+ *
+ * @param[out] seed Generated seed.
+ * @return Result of the operation (OK or error).
+ */
+OT_WARN_UNUSED_RESULT
+status_t ed25519_keygen_seed(ed25519_masked_seed_t *seed);
+
+/**
+ * Start an async Ed25519 public key computation on OTBN.
+ *
+ * Must follow `ed25519_keygen_seed`, with SHA-512 of the seed it returned.
+ *
+ * @param hash_lo Lower half of SHA-512(seed).
+ * @return Result of the operation (OK or error).
+ */
+OT_WARN_UNUSED_RESULT
+status_t ed25519_keygen_start(const uint32_t hash_lo[kEd25519ScalarWords]);
+
+/**
+ * Finish an async Ed25519 keypair generation operation on OTBN.
+ *
+ * Blocks until OTBN is idle.
+ *
+ * @param[out] seed Generated seed (the private key).
+ * @param[out] public_key Encoded public key A.
+ * @return Result of the operation (OK or error).
+ */
+OT_WARN_UNUSED_RESULT
+status_t ed25519_keygen_finalize(ed25519_masked_seed_t *seed,
+                                 uint32_t public_key[kEd25519PointWords]);
+
+/**
+ * Compute the public key and signature commitment R on OTBN.
+ *
+ * This is the first half of signature generation; the caller then hashes R
+ * with the public key and message and passes the result to
+ * `ed25519_sign_finish_start`. Blocks until OTBN is idle. Returns an
+ * `OTCRYPTO_ASYNC_INCOMPLETE` error if OTBN is busy when called.
+ *
+ * @param hash_lo Lower half of SHA-512(seed).
+ * @param hash_r SHA-512(dom2 || prefix || M), for the nonce r.
+ * @param[out] public_key Encoded public key A.
+ * @param[out] r Encoded commitment R.
+ * @return Result of the operation (OK or error).
+ */
+OT_WARN_UNUSED_RESULT
+status_t ed25519_sign_commit(const uint32_t hash_lo[kEd25519ScalarWords],
+                             const uint32_t hash_r[kEd25519HashWords],
+                             uint32_t public_key[kEd25519PointWords],
+                             uint32_t r[kEd25519PointWords]);
+
+/**
+ * Start the computation of the signature scalar S on OTBN.
+ *
+ * Must follow `ed25519_sign_commit`.
+ *
+ * @param hash_k SHA-512(dom2 || R || A || M).
+ * @return Result of the operation (OK or error).
+ */
+OT_WARN_UNUSED_RESULT
+status_t ed25519_sign_finish_start(const uint32_t hash_k[kEd25519HashWords]);
+
+/**
+ * Finish an async Ed25519 signature generation operation on OTBN.
+ *
+ * Blocks until OTBN is idle.
+ *
+ * @param[out] s Signature scalar S.
+ * @return Result of the operation (OK or error).
+ */
+OT_WARN_UNUSED_RESULT
+status_t ed25519_sign_finalize(uint32_t s[kEd25519ScalarWords]);
+
+/**
+ * Start an async Ed25519 signature verification operation on OTBN.
+ *
+ * Returns an `OTCRYPTO_ASYNC_INCOMPLETE` error if OTBN is busy.
+ *
+ * @param signature Signature to be verified.
+ * @param hash_k SHA-512(dom2 || R || A || M).
+ * @param public_key Encoded public key A.
+ * @return Result of the operation (OK or error).
+ */
+OT_WARN_UNUSED_RESULT
+status_t ed25519_verify_start(const ed25519_signature_t *signature,
+                              const uint32_t hash_k[kEd25519HashWords],
+                              const uint32_t public_key[kEd25519PointWords]);
+
+/**
+ * Finish an async Ed25519 signature verification operation on OTBN.
+ *
+ * Blocks until OTBN is idle.
+ *
+ * If the signature is valid, writes `kHardenedBoolTrue` to `result`;
+ * otherwise, writes `kHardenedBoolFalse`. As for
+ * `p256_ecdsa_verify_finalize`, a signature or public key failing the basic
+ * validity checks (S not below L, or A not a valid point encoding) results in
+ * an `OTCRYPTO_BAD_ARGS` error.
+ *
+ * @param[out] result Output buffer (true if signature is valid, false
+ * otherwise)
+ * @return Result of the operation (OK or error).
+ */
+OT_WARN_UNUSED_RESULT
+status_t ed25519_verify_finalize(hardened_bool_t *result);
+
+/**
+ * Verify a batch of Ed25519 signatures on OTBN.
+ *
+ * Loads the Ed25519 app once and verifies up to `kEd25519BatchVerifyMaxItems`
+ * signatures per OTBN run, looping over them on OTBN. Writes
+ * `kHardenedBoolTrue` to `results[i]` if signature i is valid, and
+ * `kHardenedBoolFalse` otherwise. Unlike `ed25519_verify_finalize`, a
+ * signature or public key failing the basic validity checks only makes its
+ * own result false; OTBN is then restarted at the next item.
+ *
+ * Blocks until OTBN is idle. Returns an `OTCRYPTO_ASYNC_INCOMPLETE` error if
+ * OTBN is busy when called.
+ *
+ * @param items Signatures to be verified.
+ * @param num_items Number of signatures.
+ * @param[out] results Verification result for each signature.
+ * @return Result of the operation (OK or error).
+ */
+OT_WARN_UNUSED_RESULT
+status_t ed25519_verify_batch(const ed25519_verify_item_t *items,
+                              size_t num_items, hardened_bool_t *results);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // OPENTITAN_SW_DEVICE_LIB_CRYPTO_IMPL_ECC_ED25519_H_
@@ -28,6 +28,12 @@ OTBN_DECLARE_SYMBOL_ADDR(run_p256, d0);    // Private key scalar d (share 0).
 OTBN_DECLARE_SYMBOL_ADDR(run_p256, d1);    // Private key scalar d (share 1).
 OTBN_DECLARE_SYMBOL_ADDR(run_p256, x_r);   // ECDSA verification result.
 OTBN_DECLARE_SYMBOL_ADDR(run_p256, ok);    // Status code.
+OTBN_DECLARE_SYMBOL_ADDR(run_p256, batch_n);    // Batch size.
+OTBN_DECLARE_SYMBOL_ADDR(run_p256, batch_idx);  // Current batch item.
+OTBN_DECLARE_SYMBOL_ADDR(run_p256, batch_in);   // Batch inputs.
+OTBN_DECLARE_SYMBOL_ADDR(run_p256, batch_x_r);  // Batch results.
+OTBN_DECLARE_SYMBOL_ADDR(run_p256, ephemeral_x);  // Ephemeral public key x.
+OTBN_DECLARE_SYMBOL_ADDR(run_p256, ephemeral_y);  // Ephemeral public key y.
 
 static const otbn_addr_t kOtbnVarMode = OTBN_ADDR_T_INIT(run_p256, mode);
 static const otbn_addr_t kOtbnVarMsg = OTBN_ADDR_T_INIT(run_p256, msg);
@@ -35,10 +41,20 @@ static const otbn_addr_t kOtbnVarR = OTBN_ADDR_T_INIT(run_p256, r);
 static const otbn_addr_t kOtbnVarS = OTBN_ADDR_T_INIT(run_p256, s);
 static const otbn_addr_t kOtbnVarX = OTBN_ADDR_T_INIT(run_p256, x);
 static const otbn_addr_t kOtbnVarY = OTBN_ADDR_T_INIT(run_p256, y);
+static const otbn_addr_t kOtbnVarEphemeralX =
+    OTBN_ADDR_T_INIT(run_p256, ephemeral_x);
+static const otbn_addr_t kOtbnVarEphemeralY =
+    OTBN_ADDR_T_INIT(run_p256, ephemeral_y);
 static const otbn_addr_t kOtbnVarD0 = OTBN_ADDR_T_INIT(run_p256, d0);
 static const otbn_addr_t kOtbnVarD1 = OTBN_ADDR_T_INIT(run_p256, d1);
 static const otbn_addr_t kOtbnVarXr = OTBN_ADDR_T_INIT(run_p256, x_r);
 static const otbn_addr_t kOtbnVarOk = OTBN_ADDR_T_INIT(run_p256, ok);
+static const otbn_addr_t kOtbnVarBatchN = OTBN_ADDR_T_INIT(run_p256, batch_n);
+static const otbn_addr_t kOtbnVarBatchIdx =
+    OTBN_ADDR_T_INIT(run_p256, batch_idx);
+static const otbn_addr_t kOtbnVarBatchIn = OTBN_ADDR_T_INIT(run_p256, batch_in);
+static const otbn_addr_t kOtbnVarBatchXr =
+    OTBN_ADDR_T_INIT(run_p256, batch_x_r);
 
 // Declare mode constants.
 OTBN_DECLARE_SYMBOL_ADDR(run_p256, MODE_KEYGEN);
@@ -48,6 +64,8 @@ OTBN_DECLARE_SYMBOL_ADDR(run_p256, MODE_ECDH);
 OTBN_DECLARE_SYMBOL_ADDR(run_p256, MODE_SIDELOAD_KEYGEN);
 OTBN_DECLARE_SYMBOL_ADDR(run_p256, MODE_SIDELOAD_SIGN);
 OTBN_DECLARE_SYMBOL_ADDR(run_p256, MODE_SIDELOAD_ECDH);
+OTBN_DECLARE_SYMBOL_ADDR(run_p256, MODE_VERIFY_BATCH);
+OTBN_DECLARE_SYMBOL_ADDR(run_p256, MODE_ECDH_EPHEMERAL);
 static const uint32_t kOtbnP256ModeKeygen =
     OTBN_ADDR_T_INIT(run_p256, MODE_KEYGEN);
 static const uint32_t kOtbnP256ModeSign = OTBN_ADDR_T_INIT(run_p256, MODE_SIGN);
@@ -60,6 +78,10 @@ static const uint32_t kOtbnP256ModeSideloadSign =
     OTBN_ADDR_T_INIT(run_p256, MODE_SIDELOAD_SIGN);
 static const uint32_t kOtbnP256ModeSideloadEcdh =
     OTBN_ADDR_T_INIT(run_p256, MODE_SIDELOAD_ECDH);
+static const uint32_t kOtbnP256ModeVerifyBatch =
+    OTBN_ADDR_T_INIT(run_p256, MODE_VERIFY_BATCH);
+static const uint32_t kOtbnP256ModeEcdhEphemeral =
+    OTBN_ADDR_T_INIT(run_p256, MODE_ECDH_EPHEMERAL);
 
 enum {
   /*
@@ -78,6 +100,10 @@ enum {
       (kOtbnWideWordNumWords -
        (kP256MaskedScalarShareWords % kOtbnWideWordNumWords)) %
       kOtbnWideWordNumWords,
+  /**
+   * Size of one batch verification input item (msg, r, s, x, y) in bytes.
+   */
+  kOtbnBatchItemBytes = 5 * kOtbnWideWordNumBytes,
 };
 
 static status_t p256_masked_scalar_write(const p256_masked_scalar_t *src,
@@ -166,7 +192,8 @@ status_t p256_sideload_keygen_finalize(p256_point_t *public_key) {
  * @param digest Digest to set (big-endian).
  * @return OK or error.
  */
-static status_t set_message_digest(const uint32_t digest[kP256ScalarWords]) {
+static status_t set_message_digest(const uint32_t digest[kP256ScalarWords],
+                                   otbn_addr_t dest) {
   // Set the message digest. We swap all the bytes so that OTBN can interpret
   // the digest as a little-endian integer, which is a more natural fit for the
   // architecture than the big-endian form requested by the specification (FIPS
@@ -178,7 +205,7 @@ static status_t set_message_digest(const uint32_t digest[kP256ScalarWords]) {
         __builtin_bswap32(digest[kP256ScalarWords - 1 - i]);
   }
   HARDENED_CHECK_EQ(i, kP256ScalarWords);
-  return otbn_dmem_write(kP256ScalarWords, digest_little_endian, kOtbnVarMsg);
+  return otbn_dmem_write(kP256ScalarWords, digest_little_endian, dest);
 }
 
 status_t p256_ecdsa_sign_start(const uint32_t digest[kP256ScalarWords],
@@ -191,7 +218,7 @@ status_t p256_ecdsa_sign_start(const uint32_t digest[kP256ScalarWords],
   HARDENED_TRY(otbn_dmem_write(kOtbnP256ModeWords, &mode, kOtbnVarMode));
 
   // Set the message digest.
-  HARDENED_TRY(set_message_digest(digest));
+  HARDENED_TRY(set_message_digest(digest, kOtbnVarMsg));
 
   // Set the private key shares.
   HARDENED_TRY(p256_masked_scalar_write(private_key, kOtbnVarD0, kOtbnVarD1));
@@ -210,7 +237,7 @@ status_t p256_ecdsa_sideload_sign_start(
   HARDENED_TRY(otbn_dmem_write(kOtbnP256ModeWords, &mode, kOtbnVarMode));
 
   // Set the message digest.
-  HARDENED_TRY(set_message_digest(digest));
+  HARDENED_TRY(set_message_digest(digest, kOtbnVarMsg));
 
   // Start the OTBN routine.
   return otbn_execute();
@@ -243,7 +270,7 @@ status_t p256_ecdsa_verify_start(const p256_ecdsa_signature_t *signature,
   HARDENED_TRY(otbn_dmem_write(kOtbnP256ModeWords, &mode, kOtbnVarMode));
 
   // Set the message digest.
-  HARDENED_TRY(set_message_digest(digest));
+  HARDENED_TRY(set_message_digest(digest, kOtbnVarMsg));
 
   // Set the signature R.
   HARDENED_TRY(otbn_dmem_write(kP256ScalarWords, signature->r, kOtbnVarR));
@@ -287,6 +314,98 @@ status_t p256_ecdsa_verify_finalize(const p256_ecdsa_signature_t *signature,
   return OTCRYPTO_OK;
 }
 
+/**
+ * Verify up to `kP256BatchVerifyMaxItems` signatures in one OTBN run.
+ *
+ * Expects the P-256 app to be loaded and OTBN to be idle.
+ */
+static status_t p256_ecdsa_verify_batch_chunk(
+    const p256_ecdsa_verify_item_t *items, uint32_t num_items,
+    hardened_bool_t *results) {
+  uint32_t mode = kOtbnP256ModeVerifyBatch;
+  HARDENED_TRY(otbn_dmem_write(kOtbnP256ModeWords, &mode, kOtbnVarMode));
+  HARDENED_TRY(otbn_dmem_write(1, &num_items, kOtbnVarBatchN));
+
+  // Write all the items.
+  size_t i = 0;
+  for (; launder32(i) < num_items; i++) {
+    otbn_addr_t item_addr = kOtbnVarBatchIn + i * kOtbnBatchItemBytes;
+    HARDENED_TRY(set_message_digest(items[i].digest, item_addr));
+    item_addr += kOtbnWideWordNumBytes;
+    HARDENED_TRY(
+        otbn_dmem_write(kP256ScalarWords, items[i].signature->r, item_addr));
+    item_addr += kOtbnWideWordNumBytes;
+    HARDENED_TRY(
+        otbn_dmem_write(kP256ScalarWords, items[i].signature->s, item_addr));
+    item_addr += kOtbnWideWordNumBytes;
+    HARDENED_TRY(
+        otbn_dmem_write(kP256CoordWords, items[i].public_key->x, item_addr));
+    item_addr += kOtbnWideWordNumBytes;
+    HARDENED_TRY(
+        otbn_dmem_write(kP256CoordWords, items[i].public_key->y, item_addr));
+  }
+  HARDENED_CHECK_EQ(i, num_items);
+
+  // Run OTBN until it gets through the whole batch. An item failing the basic
+  // validity checks ends the run early; it is invalid, and the next run starts
+  // after it.
+  uint32_t start = 0;
+  while (start < num_items) {
+    HARDENED_TRY(otbn_dmem_write(1, &start, kOtbnVarBatchIdx));
+    HARDENED_TRY(otbn_execute());
+    HARDENED_TRY(otbn_busy_wait_for_done());
+
+    uint32_t ok;
+    uint32_t end;
+    HARDENED_TRY(otbn_dmem_read(1, kOtbnVarOk, &ok));
+    HARDENED_TRY(otbn_dmem_read(1, kOtbnVarBatchIdx, &end));
+    if (end < start || end > num_items ||
+        (end == num_items && launder32(ok) != kHardenedBoolTrue)) {
+      return OTCRYPTO_FATAL_ERR;
+    }
+
+    // Compare the recovered x_r values of the items verified in this run.
+    for (i = start; launder32(i) < end; i++) {
+      uint32_t x_r[kP256ScalarWords];
+      HARDENED_TRY(otbn_dmem_read(
+          kP256ScalarWords, kOtbnVarBatchXr + i * kP256ScalarBytes, x_r));
+      results[i] = hardened_memeq(x_r, items[i].signature->r, kP256ScalarWords);
+    }
+    HARDENED_CHECK_EQ(i, end);
+
+    if (end == num_items) {
+      break;
+    }
+    HARDENED_CHECK_NE(ok, kHardenedBoolTrue);
+    results[end] = kHardenedBoolFalse;
+    start = end + 1;
+  }
+
+  return OTCRYPTO_OK;
+}
+
+status_t p256_ecdsa_verify_batch(const p256_ecdsa_verify_item_t *items,
+                                 size_t num_items, hardened_bool_t *results) {
+  // Load the P-256 app once for the whole batch. Fails if OTBN is non-idle.
+  HARDENED_TRY(otbn_load_app(kOtbnAppP256));
+
+  size_t done = 0;
+  while (done < num_items) {
+    size_t chunk = num_items - done;
+    if (chunk > kP256BatchVerifyMaxItems) {
+      chunk = kP256BatchVerifyMaxItems;
+    }
+    HARDENED_TRY(p256_ecdsa_verify_batch_chunk(&items[done], (uint32_t)chunk,
+                                               &results[done]));
+    done += chunk;
+  }
+
+  // Wipe DMEM.
+  HARDENED_TRY(otbn_dmem_sec_wipe());
+
+  return OTCRYPTO_OK;
+}
+
 status_t p256_ecdh_start(const p256_masked_scalar_t *private_key,
                          const p256_point_t *public_key) {
   // Load the P-256 app. Fails if OTBN is non-idle.
@@ -348,3 +467,50 @@ status_t p256_sideload_ecdh_start(const p256_point_t *public_key) {
   // Start the OTBN routine.
   return otbn_execute();
 }
+
+status_t p256_ecdh_ephemeral_start(const p256_point_t *public_key) {
+  // Load the P-256 app. Fails if OTBN is non-idle.
+  HARDENED_TRY(otbn_load_app(kOtbnAppP256));
+
+  // Set mode so start() will jump into ephemeral shared-key generation.
+  uint32_t mode = kOtbnP256ModeEcdhEphemeral;
+  HARDENED_TRY(otbn_dmem_write(kOtbnP256ModeWords, &mode, kOtbnVarMode));
+
+  // Set the public key x coordinate.
+  HARDENED_TRY(otbn_dmem_write(kP256CoordWords, public_key->x, kOtbnVarX));
+
+  // Set the public key y coordinate.
+  HARDENED_TRY(otbn_dmem_write(kP256CoordWords, public_key->y, kOtbnVarY));
+
+  // Start the OTBN routine.
+  return otbn_execute();
+}
+
+status_t p256_ecdh_ephemeral_finalize(p256_point_t *ephemeral_public_key,
+                                      p256_ecdh_shared_key_t *shared_key) {
+  // Spin here waiting for OTBN to complete.
+  HARDENED_TRY(otbn_busy_wait_for_done());
+
+  // Read the code indicating if the public key is valid.
+  uint32_t ok;
+  HARDENED_TRY(otbn_dmem_read(1, kOtbnVarOk, &ok));
+  if (launder32(ok) != kHardenedBoolTrue) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+  HARDENED_CHECK_EQ(ok, kHardenedBoolTrue);
+
+  // Read the ephemeral public key.
+  HARDENED_TRY(otbn_dmem_read(kP256CoordWords, kOtbnVarEphemeralX,
+                              ephemeral_public_key->x));
+  HARDENED_TRY(otbn_dmem_read(kP256CoordWords, kOtbnVarEphemeralY,
+                              ephemeral_public_key->y));
+
+  // Read the shares of the key from OTBN dmem (at vars x and y).
+  HARDENED_TRY(otbn_dmem_read(kP256CoordWords, kOtbnVarX, shared_key->share0));
+  HARDENED_TRY(otbn_dmem_read(kP256CoordWords, kOtbnVarY, shared_key->share1));
+
+  // Wipe DMEM.
+  HARDENED_TRY(otbn_dmem_sec_wipe());
+
+  return OTCRYPTO_OK;
+}
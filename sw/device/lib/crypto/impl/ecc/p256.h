@@ -54,6 +54,12 @@ enum {
    * Length of masked secret scalar share in words.
    */
   kP256MaskedScalarShareWords = kP256MaskedScalarShareBytes / sizeof(uint32_t),
+  /**
+   * Maximum number of signatures verified in one OTBN run of a batch.
+   *
+   * Must match BATCH_MAX_ITEMS in `run_p256.s`.
+   */
+  kP256BatchVerifyMaxItems = 8,
 };
 
 /**
@@ -99,6 +105,24 @@ typedef struct p256_ecdsa_signature_t {
   uint32_t s[kP256ScalarWords];
 } p256_ecdsa_signature_t;
 
+/**
+ * One signature of a batch verification.
+ */
+typedef struct p256_ecdsa_verify_item {
+  /**
+   * Signature to be verified.
+   */
+  const p256_ecdsa_signature_t *signature;
+  /**
+   * Digest of the message to check the signature against.
+   */
+  const uint32_t *digest;
+  /**
+   * Key to check the signature against.
+   */
+  const p256_point_t *public_key;
+} p256_ecdsa_verify_item_t;
+
 /**
  * A type that holds a blinded ECDH shared secret key.
  *
@@ -239,6 +263,28 @@ OT_WARN_UNUSED_RESULT
 status_t p256_ecdsa_verify_finalize(const p256_ecdsa_signature_t *signature,
                                     hardened_bool_t *result);
 
+/**
+ * Verify a batch of ECDSA/P-256 signatures on OTBN.
+ *
+ * Loads the P-256 app once and verifies up to `kP256BatchVerifyMaxItems`
+ * signatures per OTBN run, looping over them on OTBN. Writes
+ * `kHardenedBoolTrue` to `results[i]` if signature i is valid, and
+ * `kHardenedBoolFalse` otherwise. Unlike `p256_ecdsa_verify_finalize`, a
+ * signature or public key failing the basic validity checks only makes its
+ * own result false; OTBN is then restarted at the next item.
+ *
+ * Blocks until OTBN is idle. Returns an `OTCRYPTO_ASYNC_INCOMPLETE` error if
+ * OTBN is busy when called.
+ *
+ * @param items Signatures to be verified.
+ * @param num_items Number of signatures.
+ * @param[out] results Verification result for each signature.
+ * @return Result of the operation (OK or error).
+ */
+OT_WARN_UNUSED_RESULT
+status_t p256_ecdsa_verify_batch(const p256_ecdsa_verify_item_t *items,
+                                 size_t num_items, hardened_bool_t *results);
+
 /**
  * Start an async ECDH/P-256 shared key generation operation on OTBN.
  *
@@ -278,6 +324,33 @@ status_t p256_ecdh_finalize(p256_ecdh_shared_key_t *shared_key);
 OT_WARN_UNUSED_RESULT
 status_t p256_sideload_ecdh_start(const p256_point_t *public_key);
 
+/**
+ * Start an async ephemeral ECDH/P-256 operation on OTBN.
+ *
+ * Generates a fresh keypair (d, d*G) and the shared key with the given public
+ * key in a single run. The ephemeral private key never leaves OTBN.
+ *
+ * Returns an `OTCRYPTO_ASYNC_INCOMPLETE` error if OTBN is busy.
+ *
+ * @param public_key Peer public key (Q).
+ * @return Result of the operation (OK or error).
+ */
+OT_WARN_UNUSED_RESULT
+status_t p256_ecdh_ephemeral_start(const p256_point_t *public_key);
+
+/**
+ * Finish an async ephemeral ECDH/P-256 operation on OTBN.
+ *
+ * Blocks until OTBN is idle.
+ *
+ * @param[out] ephemeral_public_key Ephemeral public key (d*G).
+ * @param[out] shared_key Shared secret key (x-coordinate of d*Q).
+ * @return Result of the operation (OK or error).
+ */
+OT_WARN_UNUSED_RESULT
+status_t p256_ecdh_ephemeral_finalize(p256_point_t *ephemeral_public_key,
+                                      p256_ecdh_shared_key_t *shared_key);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -28,6 +28,8 @@ OTBN_DECLARE_SYMBOL_ADDR(run_p384, d0);    // Private key scalar d (share 0).
 OTBN_DECLARE_SYMBOL_ADDR(run_p384, d1);    // Private key scalar d (share 1).
 OTBN_DECLARE_SYMBOL_ADDR(run_p384, x_r);   // ECDSA verification result.
 OTBN_DECLARE_SYMBOL_ADDR(run_p384, ok);    // Status code.
+OTBN_DECLARE_SYMBOL_ADDR(run_p384, ephemeral_x);  // Ephemeral public key x.
+OTBN_DECLARE_SYMBOL_ADDR(run_p384, ephemeral_y);  // Ephemeral public key y.
 
 static const otbn_addr_t kOtbnVarMode = OTBN_ADDR_T_INIT(run_p384, mode);
 static const otbn_addr_t kOtbnVarMsg = OTBN_ADDR_T_INIT(run_p384, msg);
@@ -35,6 +37,10 @@ static const otbn_addr_t kOtbnVarR = OTBN_ADDR_T_INIT(run_p384, r);
 static const otbn_addr_t kOtbnVarS = OTBN_ADDR_T_INIT(run_p384, s);
 static const otbn_addr_t kOtbnVarX = OTBN_ADDR_T_INIT(run_p384, x);
 static const otbn_addr_t kOtbnVarY = OTBN_ADDR_T_INIT(run_p384, y);
+static const otbn_addr_t kOtbnVarEphemeralX =
+    OTBN_ADDR_T_INIT(run_p384, ephemeral_x);
+static const otbn_addr_t kOtbnVarEphemeralY =
+    OTBN_ADDR_T_INIT(run_p384, ephemeral_y);
 static const otbn_addr_t kOtbnVarD0 = OTBN_ADDR_T_INIT(run_p384, d0);
 static const otbn_addr_t kOtbnVarD1 = OTBN_ADDR_T_INIT(run_p384, d1);
 static const otbn_addr_t kOtbnVarXr = OTBN_ADDR_T_INIT(run_p384, x_r);
@@ -48,6 +54,7 @@ OTBN_DECLARE_SYMBOL_ADDR(run_p384, MODE_ECDH);
 OTBN_DECLARE_SYMBOL_ADDR(run_p384, MODE_SIDELOAD_KEYGEN);
 OTBN_DECLARE_SYMBOL_ADDR(run_p384, MODE_SIDELOAD_SIGN);
 OTBN_DECLARE_SYMBOL_ADDR(run_p384, MODE_SIDELOAD_ECDH);
+OTBN_DECLARE_SYMBOL_ADDR(run_p384, MODE_ECDH_EPHEMERAL);
 static const uint32_t kP384ModeKeygen = OTBN_ADDR_T_INIT(run_p384, MODE_KEYGEN);
 static const uint32_t kP384ModeSign = OTBN_ADDR_T_INIT(run_p384, MODE_SIGN);
 static const uint32_t kP384ModeVerify = OTBN_ADDR_T_INIT(run_p384, MODE_VERIFY);
@@ -58,6 +65,8 @@ static const uint32_t kP384ModeSideloadSign =
     OTBN_ADDR_T_INIT(run_p384, MODE_SIDELOAD_SIGN);
 static const uint32_t kP384ModeSideloadEcdh =
     OTBN_ADDR_T_INIT(run_p384, MODE_SIDELOAD_ECDH);
+static const uint32_t kP384ModeEcdhEphemeral =
+    OTBN_ADDR_T_INIT(run_p384, MODE_ECDH_EPHEMERAL);
 
 enum {
   /*
@@ -339,3 +348,50 @@ status_t p384_sideload_ecdh_start(const p384_point_t *public_key) {
   // Start the OTBN routine.
   return otbn_execute();
 }
+
+status_t p384_ecdh_ephemeral_start(const p384_point_t *public_key) {
+  // Load the ECDH/P-384 app. Fails if OTBN is non-idle.
+  HARDENED_TRY(otbn_load_app(kOtbnAppP384));
+
+  // Set mode so start() will jump into ephemeral shared-key generation.
+  uint32_t mode = kP384ModeEcdhEphemeral;
+  HARDENED_TRY(otbn_dmem_write(kP384ModeWords, &mode, kOtbnVarMode));
+
+  // Set the public key x coordinate.
+  HARDENED_TRY(otbn_dmem_write(kP384CoordWords, public_key->x, kOtbnVarX));
+
+  // Set the public key y coordinate.
+  HARDENED_TRY(otbn_dmem_write(kP384CoordWords, public_key->y, kOtbnVarY));
+
+  // Start the OTBN routine.
+  return otbn_execute();
+}
+
+status_t p384_ecdh_ephemeral_finalize(p384_point_t *ephemeral_public_key,
+                                      p384_ecdh_shared_key_t *shared_key) {
+  // Spin here waiting for OTBN to complete.
+  HARDENED_TRY(otbn_busy_wait_for_done());
+
+  // Read the code indicating if the public key is valid.
+  uint32_t ok;
+  HARDENED_TRY(otbn_dmem_read(1, kOtbnVarOk, &ok));
+  if (launder32(ok) != kHardenedBoolTrue) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+  HARDENED_CHECK_EQ(ok, kHardenedBoolTrue);
+
+  // Read the ephemeral public key.
+  HARDENED_TRY(otbn_dmem_read(kP384CoordWords, kOtbnVarEphemeralX,
+                              ephemeral_public_key->x));
+  HARDENED_TRY(otbn_dmem_read(kP384CoordWords, kOtbnVarEphemeralY,
+                              ephemeral_public_key->y));
+
+  // Read the shares of the key from OTBN dmem (at vars x and y).
+  HARDENED_TRY(otbn_dmem_read(kP384CoordWords, kOtbnVarX, shared_key->share0));
+  HARDENED_TRY(otbn_dmem_read(kP384CoordWords, kOtbnVarY, shared_key->share1));
+
+  // Wipe DMEM.
+  HARDENED_TRY(otbn_dmem_sec_wipe());
+
+  return OTCRYPTO_OK;
+}
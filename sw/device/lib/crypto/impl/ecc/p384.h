@@ -278,6 +278,33 @@ status_t p384_ecdh_finalize(p384_ecdh_shared_key_t *shared_key);
 OT_WARN_UNUSED_RESULT
 status_t p384_sideload_ecdh_start(const p384_point_t *public_key);
 
+/**
+ * Start an async ephemeral ECDH/P-384 operation on OTBN.
+ *
+ * Generates a fresh keypair (d, d*G) and the shared key with the given public
+ * key in a single run. The ephemeral private key never leaves OTBN.
+ *
+ * Returns an `OTCRYPTO_ASYNC_INCOMPLETE` error if OTBN is busy.
+ *
+ * @param public_key Peer public key (Q).
+ * @return Result of the operation (OK or error).
+ */
+OT_WARN_UNUSED_RESULT
+status_t p384_ecdh_ephemeral_start(const p384_point_t *public_key);
+
+/**
+ * Finish an async ephemeral ECDH/P-384 operation on OTBN.
+ *
+ * Blocks until OTBN is idle.
+ *
+ * @param[out] ephemeral_public_key Ephemeral public key (d*G).
+ * @param[out] shared_key Shared secret key (x-coordinate of d*Q).
+ * @return Result of the operation (OK or error).
+ */
+OT_WARN_UNUSED_RESULT
+status_t p384_ecdh_ephemeral_finalize(p384_point_t *ephemeral_public_key,
+                                      p384_ecdh_shared_key_t *shared_key);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -0,0 +1,179 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "sw/device/lib/crypto/impl/ecc/x25519.h"
+
+#include "sw/device/lib/base/hardened.h"
+#include "sw/device/lib/crypto/drivers/otbn.h"
+
+#include "hw/top_earlgrey/sw/autogen/top_earlgrey.h"
+
+// Module ID for status codes.
+#define MODULE_ID MAKE_MODULE_ID('x', '2', 'r')
+
+// Declare the OTBN app.
+OTBN_DECLARE_APP_SYMBOLS(run_x25519);  // The OTBN X25519 app.
+static const otbn_app_t kOtbnAppX25519 = OTBN_APP_T_INIT(run_x25519);
+
+// Declare offsets for input and output buffers.
+OTBN_DECLARE_SYMBOL_ADDR(run_x25519, mode);    // Mode of operation.
+OTBN_DECLARE_SYMBOL_ADDR(run_x25519, ok);      // Status code.
+OTBN_DECLARE_SYMBOL_ADDR(run_x25519, k0);      // Secret scalar k (share 0).
+OTBN_DECLARE_SYMBOL_ADDR(run_x25519, k1);      // Secret scalar k (share 1).
+OTBN_DECLARE_SYMBOL_ADDR(run_x25519, enc_u);   // Peer public key u.
+OTBN_DECLARE_SYMBOL_ADDR(run_x25519, enc_x0);  // Public key / result share 0.
+OTBN_DECLARE_SYMBOL_ADDR(run_x25519, enc_x1);  // Result share 1.
+
+static const otbn_addr_t kOtbnVarMode = OTBN_ADDR_T_INIT(run_x25519, mode);
+static const otbn_addr_t kOtbnVarOk = OTBN_ADDR_T_INIT(run_x25519, ok);
+static const otbn_addr_t kOtbnVarK0 = OTBN_ADDR_T_INIT(run_x25519, k0);
+static const otbn_addr_t kOtbnVarK1 = OTBN_ADDR_T_INIT(run_x25519, k1);
+static const otbn_addr_t kOtbnVarEncU = OTBN_ADDR_T_INIT(run_x25519, enc_u);
+static const otbn_addr_t kOtbnVarEncX0 = OTBN_ADDR_T_INIT(run_x25519, enc_x0);
+static const otbn_addr_t kOtbnVarEncX1 = OTBN_ADDR_T_INIT(run_x25519, enc_x1);
+
+// Declare mode constants.
+OTBN_DECLARE_SYMBOL_ADDR(run_x25519, MODE_KEYGEN);
+OTBN_DECLARE_SYMBOL_ADDR(run_x25519, MODE_X25519);
+OTBN_DECLARE_SYMBOL_ADDR(run_x25519, MODE_SIDELOAD_KEYGEN);
+OTBN_DECLARE_SYMBOL_ADDR(run_x25519, MODE_SIDELOAD_X25519);
+static const uint32_t kOtbnX25519ModeKeygen =
+    OTBN_ADDR_T_INIT(run_x25519, MODE_KEYGEN);
+static const uint32_t kOtbnX25519ModeX25519 =
+    OTBN_ADDR_T_INIT(run_x25519, MODE_X25519);
+static const uint32_t kOtbnX25519ModeSideloadKeygen =
+    OTBN_ADDR_T_INIT(run_x25519, MODE_SIDELOAD_KEYGEN);
+static const uint32_t kOtbnX25519ModeSideloadX25519 =
+    OTBN_ADDR_T_INIT(run_x25519, MODE_SIDELOAD_X25519);
+
+enum {
+  /*
+   * Mode is represented by a single word.
+   */
+  kOtbnX25519ModeWords = 1,
+  /**
+   * Number of extra padding words needed for masked scalar shares.
+   *
+   * See the corresponding constant in `p256.c`.
+   */
+  kMaskedScalarPaddingWords =
+      (kOtbnWideWordNumWords -
+       (kX25519MaskedScalarShareWords % kOtbnWideWordNumWords)) %
+      kOtbnWideWordNumWords,
+};
+
+/**
+ * Load the X25519 app and start it in the given mode.
+ *
+ * Fails if OTBN is non-idle.
+ */
+static status_t x25519_load_and_set_mode(uint32_t mode) {
+  HARDENED_TRY(otbn_load_app(kOtbnAppX25519));
+  return otbn_dmem_write(kOtbnX25519ModeWords, &mode, kOtbnVarMode);
+}
+
+status_t x25519_keygen_start(void) {
+  HARDENED_TRY(x25519_load_and_set_mode(kOtbnX25519ModeKeygen));
+
+  // Start the OTBN routine.
+  return otbn_execute();
+}
+
+status_t x25519_sideload_keygen_start(void) {
+  HARDENED_TRY(x25519_load_and_set_mode(kOtbnX25519ModeSideloadKeygen));
+
+  // Start the OTBN routine.
+  return otbn_execute();
+}
+
+status_t x25519_keygen_finalize(x25519_masked_scalar_t *private_key,
+                                uint32_t public_key[kX25519CoordWords]) {
+  // Spin here waiting for OTBN to complete.
+  HARDENED_TRY(otbn_busy_wait_for_done());
+
+  // Read the masked private key from OTBN dmem.
+  HARDENED_TRY(otbn_dmem_read(kX25519MaskedScalarShareWords, kOtbnVarK0,
+                              private_key->share0));
+  HARDENED_TRY(otbn_dmem_read(kX25519MaskedScalarShareWords, kOtbnVarK1,
+                              private_key->share1));
+
+  // Read the public key from OTBN dmem.
+  HARDENED_TRY(otbn_dmem_read(kX25519CoordWords, kOtbnVarEncX0, public_key));
+
+  // Wipe DMEM.
+  HARDENED_TRY(otbn_dmem_sec_wipe());
+
+  return OTCRYPTO_OK;
+}
+
+status_t x25519_sideload_keygen_finalize(
+    uint32_t public_key[kX25519CoordWords]) {
+  // Spin here waiting for OTBN to complete.
+  HARDENED_TRY(otbn_busy_wait_for_done());
+
+  // Read the public key from OTBN dmem.
+  HARDENED_TRY(otbn_dmem_read(kX25519CoordWords, kOtbnVarEncX0, public_key));
+
+  // Wipe DMEM.
+  HARDENED_TRY(otbn_dmem_sec_wipe());
+
+  return OTCRYPTO_OK;
+}
+
+status_t x25519_start(const x25519_masked_scalar_t *private_key,
+                      const uint32_t public_key[kX25519CoordWords]) {
+  HARDENED_TRY(x25519_load_and_set_mode(kOtbnX25519ModeX25519));
+
+  // Set the private key shares, with trailing 0s so that OTBN's 256-bit read
+  // of the upper part of each share does not cause an error.
+  HARDENED_TRY(otbn_dmem_write(kX25519MaskedScalarShareWords,
+                               private_key->share0, kOtbnVarK0));
+  HARDENED_TRY(otbn_dmem_write(kX25519MaskedScalarShareWords,
+                               private_key->share1, kOtbnVarK1));
+  HARDENED_TRY(otbn_dmem_set(kMaskedScalarPaddingWords, 0,
+                             kOtbnVarK0 + kX25519MaskedScalarShareBytes));
+  HARDENED_TRY(otbn_dmem_set(kMaskedScalarPaddingWords, 0,
+                             kOtbnVarK1 + kX25519MaskedScalarShareBytes));
+
+  // Set the peer public key.
+  HARDENED_TRY(otbn_dmem_write(kX25519CoordWords, public_key, kOtbnVarEncU));
+
+  // Start the OTBN routine.
+  return otbn_execute();
+}
+
+status_t x25519_sideload_start(const uint32_t public_key[kX25519CoordWords]) {
+  HARDENED_TRY(x25519_load_and_set_mode(kOtbnX25519ModeSideloadX25519));
+
+  // Set the peer public key.
+  HARDENED_TRY(otbn_dmem_write(kX25519CoordWords, public_key, kOtbnVarEncU));
+
+  // Start the OTBN routine.
+  return otbn_execute();
+}
+
+status_t x25519_finalize(x25519_shared_key_t *shared_key) {
+  // Spin here waiting for OTBN to complete.
+  HARDENED_TRY(otbn_busy_wait_for_done());
+
+  // Read the code indicating if the shared key is non-zero.
+  uint32_t ok;
+  HARDENED_TRY(otbn_dmem_read(1, kOtbnVarOk, &ok));
+  if (launder32(ok) != kHardenedBoolTrue) {
+    HARDENED_TRY(otbn_dmem_sec_wipe());
+    return OTCRYPTO_BAD_ARGS;
+  }
+  HARDENED_CHECK_EQ(ok, kHardenedBoolTrue);
+
+  // Read the shares of the key from OTBN dmem.
+  HARDENED_TRY(
+      otbn_dmem_read(kX25519CoordWords, kOtbnVarEncX0, shared_key->share0));
+  HARDENED_TRY(
+      otbn_dmem_read(kX25519CoordWords, kOtbnVarEncX1, shared_key->share1));
+
+  // Wipe DMEM.
+  HARDENED_TRY(otbn_dmem_sec_wipe());
+
+  return OTCRYPTO_OK;
+}
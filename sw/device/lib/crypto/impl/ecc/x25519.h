@@ -0,0 +1,177 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef OPENTITAN_SW_DEVICE_LIB_CRYPTO_IMPL_ECC_X25519_H_
+#define OPENTITAN_SW_DEVICE_LIB_CRYPTO_IMPL_ECC_X25519_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "sw/device/lib/base/hardened.h"
+#include "sw/device/lib/crypto/drivers/otbn.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+enum {
+  /**
+   * Length of an encoded Montgomery u-coordinate in bits.
+   */
+  kX25519CoordBits = 256,
+  /**
+   * Length of an encoded Montgomery u-coordinate in bytes.
+   */
+  kX25519CoordBytes = kX25519CoordBits / 8,
+  /**
+   * Length of an encoded Montgomery u-coordinate in words.
+   */
+  kX25519CoordWords = kX25519CoordBytes / sizeof(uint32_t),
+  /**
+   * Length of an X25519 secret scalar in bits.
+   */
+  kX25519ScalarBits = 256,
+  /**
+   * Length of an X25519 secret scalar in bytes.
+   */
+  kX25519ScalarBytes = kX25519ScalarBits / 8,
+  /**
+   * Length of a masked secret scalar share in bits.
+   *
+   * This implementation uses extra redundant bits for side-channel protection.
+   */
+  kX25519MaskedScalarShareBits = kX25519ScalarBits + 64,
+  /**
+   * Length of a masked secret scalar share in bytes.
+   */
+  kX25519MaskedScalarShareBytes = kX25519MaskedScalarShareBits / 8,
+  /**
+   * Length of masked secret scalar share in words.
+   */
+  kX25519MaskedScalarShareWords =
+      kX25519MaskedScalarShareBytes / sizeof(uint32_t),
+};
+
+/**
+ * A type that holds a masked X25519 secret scalar.
+ *
+ * The encoded scalar k is represented in two 320-bit shares, such that k =
+ * (share0 ^ share1) mod 2^256. The scalar is clamped by OTBN as specified in
+ * RFC 7748.
+ */
+typedef struct x25519_masked_scalar {
+  /**
+   * First share of the secret scalar.
+   */
+  uint32_t share0[kX25519MaskedScalarShareWords];
+  /**
+   * Second share of the secret scalar.
+   */
+  uint32_t share1[kX25519MaskedScalarShareWords];
+} x25519_masked_scalar_t;
+
+/**
+ * A type that holds a blinded X25519 shared secret key.
+ *
+ * The key is boolean-masked (XOR of the two shares).
+ */
+typedef struct x25519_shared_key {
+  uint32_t share0[kX25519CoordWords];
+  uint32_t share1[kX25519CoordWords];
+} x25519_shared_key_t;
+
+/**
+ * Start an async X25519 keypair generation operation on OTBN.
+ *
+ * Returns an `OTCRYPTO_ASYNC_INCOMPLETE` error if OTBN is busy.
+ *
+ * @return Result of the operation (OK or error).
+ */
+OT_WARN_UNUSED_RESULT
+status_t x25519_keygen_start(void);
+
+/**
+ * Finish an async X25519 keypair generation operation on OTBN.
+ *
+ * Blocks until OTBN is idle.
+ *
+ * @param[out] private_key Generated private key.
+ * @param[out] public_key Generated public key (encoded u-coordinate).
+ * @return Result of the operation (OK or error).
+ */
+OT_WARN_UNUSED_RESULT
+status_t x25519_keygen_finalize(x25519_masked_scalar_t *private_key,
+                                uint32_t public_key[kX25519CoordWords]);
+
+/**
+ * Start an async X25519 sideloaded keypair generation operation on OTBN.
+ *
+ * Expects a sideloaded key from keymgr to be already loaded on OTBN. Returns
+ * an `OTCRYPTO_ASYNC_INCOMPLETE` error if OTBN is busy.
+ *
+ * @return Result of the operation (OK or error).
+ */
+OT_WARN_UNUSED_RESULT
+status_t x25519_sideload_keygen_start(void);
+
+/**
+ * Finish an async X25519 sideloaded keypair generation operation on OTBN.
+ *
+ * Reads back only the public key. Blocks until OTBN is idle.
+ *
+ * @param[out] public_key Public key (encoded u-coordinate).
+ * @return Result of the operation (OK or error).
+ */
+OT_WARN_UNUSED_RESULT
+status_t x25519_sideload_keygen_finalize(
+    uint32_t public_key[kX25519CoordWords]);
+
+/**
+ * Start an async X25519 shared key generation operation on OTBN.
+ *
+ * Returns an `OTCRYPTO_ASYNC_INCOMPLETE` error if OTBN is busy.
+ *
+ * @param private_key Private key (k).
+ * @param public_key Peer public key (encoded u-coordinate).
+ * @return Result of the operation (OK or error).
+ */
+OT_WARN_UNUSED_RESULT
+status_t x25519_start(const x25519_masked_scalar_t *private_key,
+                      const uint32_t public_key[kX25519CoordWords]);
+
+/**
+ * Start an async X25519 shared key generation operation on OTBN.
+ *
+ * Uses a private key generated from a key manager seed. The key manager should
+ * already have sideloaded the key into OTBN before this operation is called.
+ *
+ * Returns an `OTCRYPTO_ASYNC_INCOMPLETE` error if OTBN is busy.
+ *
+ * @param public_key Peer public key (encoded u-coordinate).
+ * @return Result of the operation (OK or error).
+ */
+OT_WARN_UNUSED_RESULT
+status_t x25519_sideload_start(const uint32_t public_key[kX25519CoordWords]);
+
+/**
+ * Finish an async X25519 shared key generation operation on OTBN.
+ *
+ * Blocks until OTBN is idle. May be used after either `x25519_start` or
+ * `x25519_sideload_start`; the operation is the same.
+ *
+ * Returns an `OTCRYPTO_BAD_ARGS` error if the shared key is all-zero, which
+ * happens exactly when the peer public key is a point of small order (RFC
+ * 7748, section 6.1).
+ *
+ * @param[out] shared_key Shared secret key X25519(k, u).
+ * @return Result of the operation (OK or error).
+ */
+OT_WARN_UNUSED_RESULT
+status_t x25519_finalize(x25519_shared_key_t *shared_key);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // OPENTITAN_SW_DEVICE_LIB_CRYPTO_IMPL_ECC_X25519_H_
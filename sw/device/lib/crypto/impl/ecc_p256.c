@@ -53,6 +53,15 @@ otcrypto_status_t otcrypto_ecdh_p256(const otcrypto_blinded_key_t *private_key,
   return otcrypto_ecdh_p256_async_finalize(shared_secret);
 }
 
+otcrypto_status_t otcrypto_ecdh_p256_ephemeral(
+    const otcrypto_unblinded_key_t *peer_public_key,
+    otcrypto_unblinded_key_t *ephemeral_public_key,
+    otcrypto_blinded_key_t *shared_secret) {
+  HARDENED_TRY(otcrypto_ecdh_p256_ephemeral_async_start(peer_public_key));
+  return otcrypto_ecdh_p256_ephemeral_async_finalize(ephemeral_public_key,
+                                                     shared_secret);
+}
+
 /**
  * Calls P-256 key generation.
  *
@@ -210,7 +219,7 @@ static status_t internal_p256_keygen_finalize(
   public_key->checksum = integrity_unblinded_checksum(public_key);
 
   // Clear the OTBN sideload slot (in case the seed was sideloaded).
-  return keymgr_sideload_clear_otbn();
+  return keyblob_sideload_clear_otbn();
 }
 
 otcrypto_status_t otcrypto_ecdsa_p256_keygen_async_finalize(
@@ -315,13 +324,23 @@ otcrypto_status_t otcrypto_ecdsa_p256_sign_async_finalize(
   HARDENED_TRY(p256_ecdsa_sign_finalize(sig_p256));
 
   // Clear the OTBN sideload slot (in case the key was sideloaded).
-  return keymgr_sideload_clear_otbn();
+  return keyblob_sideload_clear_otbn();
 }
 
-otcrypto_status_t otcrypto_ecdsa_p256_verify_async_start(
+/**
+ * Checks the arguments of an ECDSA/P-256 signature verification.
+ *
+ * @param public_key Pointer to the unblinded public key (Q) struct.
+ * @param message_digest Message digest to be verified (pre-hashed).
+ * @param signature Signature to be verified.
+ * @param[out] item Verification inputs in the form the implementation takes.
+ * @return OK or error.
+ */
+OT_WARN_UNUSED_RESULT
+static status_t internal_p256_verify_args(
     const otcrypto_unblinded_key_t *public_key,
     const otcrypto_hash_digest_t message_digest,
-    otcrypto_const_word32_buf_t signature) {
+    otcrypto_const_word32_buf_t signature, p256_ecdsa_verify_item_t *item) {
   if (public_key == NULL || signature.data == NULL ||
       message_digest.data == NULL || public_key->key == NULL) {
     return OTCRYPTO_BAD_ARGS;
@@ -355,8 +374,56 @@ otcrypto_status_t otcrypto_ecdsa_p256_verify_async_start(
   HARDENED_TRY(p256_signature_length_check(signature.len));
   p256_ecdsa_signature_t *sig = (p256_ecdsa_signature_t *)signature.data;
 
+  item->signature = sig;
+  item->digest = message_digest.data;
+  item->public_key = pk;
+  return OTCRYPTO_OK;
+}
+
+otcrypto_status_t otcrypto_ecdsa_p256_verify_async_start(
+    const otcrypto_unblinded_key_t *public_key,
+    const otcrypto_hash_digest_t message_digest,
+    otcrypto_const_word32_buf_t signature) {
+  p256_ecdsa_verify_item_t item;
+  HARDENED_TRY(
+      internal_p256_verify_args(public_key, message_digest, signature, &item));
+
   // Start the asynchronous signature-verification routine.
-  return p256_ecdsa_verify_start(sig, message_digest.data, pk);
+  return p256_ecdsa_verify_start(item.signature, item.digest, item.public_key);
+}
+
+otcrypto_status_t otcrypto_ecdsa_p256_verify_batch(
+    const otcrypto_unblinded_key_t *const *public_keys,
+    const otcrypto_hash_digest_t *message_digests,
+    const otcrypto_const_word32_buf_t *signatures, size_t num_items,
+    hardened_bool_t *verification_results) {
+  if (public_keys == NULL || message_digests == NULL || signatures == NULL ||
+      verification_results == NULL) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+
+  // Check the arguments of a chunk of signatures at a time, then verify them
+  // together.
+  p256_ecdsa_verify_item_t items[kP256BatchVerifyMaxItems];
+  size_t done = 0;
+  while (done < num_items) {
+    size_t chunk = num_items - done;
+    if (chunk > kP256BatchVerifyMaxItems) {
+      chunk = kP256BatchVerifyMaxItems;
+    }
+    size_t i = 0;
+    for (; launder32(i) < chunk; i++) {
+      HARDENED_TRY(internal_p256_verify_args(
+          public_keys[done + i], message_digests[done + i],
+          signatures[done + i], &items[i]));
+    }
+    HARDENED_CHECK_EQ(i, chunk);
+    HARDENED_TRY(p256_ecdsa_verify_batch(items, chunk,
+                                         &verification_results[done]));
+    done += chunk;
+  }
+
+  return OTCRYPTO_OK;
 }
 
 otcrypto_status_t otcrypto_ecdsa_p256_verify_async_finalize(
@@ -448,8 +515,17 @@ otcrypto_status_t otcrypto_ecdh_p256_async_start(
   return OTCRYPTO_BAD_ARGS;
 }
 
-otcrypto_status_t otcrypto_ecdh_p256_async_finalize(
-    otcrypto_blinded_key_t *shared_secret) {
+/**
+ * Check the configuration of an ECDH shared secret for curve P-256.
+ *
+ * If this check passes, the keyblob has room for a masked x-coordinate.
+ *
+ * @param shared_secret Shared secret struct to check.
+ * @return OK if the configuration is valid or BAD_ARGS otherwise.
+ */
+OT_WARN_UNUSED_RESULT
+static status_t p256_shared_secret_check(
+    const otcrypto_blinded_key_t *shared_secret) {
   if (shared_secret == NULL || shared_secret->keyblob == NULL) {
     return OTCRYPTO_BAD_ARGS;
   }
@@ -473,6 +549,16 @@ otcrypto_status_t otcrypto_ecdh_p256_async_finalize(
       shared_secret->keyblob_length,
       keyblob_num_words(shared_secret->config) * sizeof(uint32_t));
 
+  return OTCRYPTO_OK;
+}
+
+otcrypto_status_t otcrypto_ecdh_p256_async_finalize(
+    otcrypto_blinded_key_t *shared_secret) {
+  if (shared_secret == NULL || shared_secret->keyblob == NULL) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+  HARDENED_TRY(p256_shared_secret_check(shared_secret));
+
   // Note: This operation wipes DMEM after retrieving the keys, so if an error
   // occurs after this point then the keys would be unrecoverable. This should
   // be the last potentially error-causing line before returning to the caller.
@@ -486,5 +572,71 @@ otcrypto_status_t otcrypto_ecdh_p256_async_finalize(
   shared_secret->checksum = integrity_blinded_checksum(shared_secret);
 
   // Clear the OTBN sideload slot (in case the seed was sideloaded).
-  return keymgr_sideload_clear_otbn();
+  return keyblob_sideload_clear_otbn();
+}
+
+otcrypto_status_t otcrypto_ecdh_p256_ephemeral_async_start(
+    const otcrypto_unblinded_key_t *peer_public_key) {
+  if (peer_public_key == NULL || peer_public_key->key == NULL) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+
+  // Check that the entropy complex is initialized.
+  HARDENED_TRY(entropy_complex_check());
+
+  // Check the integrity of the peer key.
+  if (launder32(integrity_unblinded_key_check(peer_public_key)) !=
+      kHardenedBoolTrue) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+  HARDENED_CHECK_EQ(integrity_unblinded_key_check(peer_public_key),
+                    kHardenedBoolTrue);
+
+  // Check the key mode.
+  if (launder32(peer_public_key->key_mode) != kOtcryptoKeyModeEcdhP256) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+  HARDENED_CHECK_EQ(peer_public_key->key_mode, kOtcryptoKeyModeEcdhP256);
+
+  // Check the key length.
+  HARDENED_TRY(p256_public_key_length_check(peer_public_key));
+  p256_point_t *pk = (p256_point_t *)peer_public_key->key;
+
+  return p256_ecdh_ephemeral_start(pk);
+}
+
+otcrypto_status_t otcrypto_ecdh_p256_ephemeral_async_finalize(
+    otcrypto_unblinded_key_t *ephemeral_public_key,
+    otcrypto_blinded_key_t *shared_secret) {
+  if (ephemeral_public_key == NULL || ephemeral_public_key->key == NULL ||
+      shared_secret == NULL || shared_secret->keyblob == NULL) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+
+  // Check the ephemeral public key.
+  if (launder32(ephemeral_public_key->key_mode) != kOtcryptoKeyModeEcdhP256) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+  HARDENED_CHECK_EQ(ephemeral_public_key->key_mode, kOtcryptoKeyModeEcdhP256);
+  HARDENED_TRY(p256_public_key_length_check(ephemeral_public_key));
+  p256_point_t *pk = (p256_point_t *)ephemeral_public_key->key;
+
+  // Check the shared secret.
+  HARDENED_TRY(p256_shared_secret_check(shared_secret));
+
+  // Note: This operation wipes DMEM after retrieving the keys, so if an error
+  // occurs after this point then the keys would be unrecoverable. This should
+  // be the last potentially error-causing line before returning to the caller.
+  p256_ecdh_shared_key_t ss;
+  HARDENED_TRY(p256_ecdh_ephemeral_finalize(pk, &ss));
+
+  keyblob_from_shares(ss.share0, ss.share1, shared_secret->config,
+                      shared_secret->keyblob);
+
+  // Set the checksums.
+  ephemeral_public_key->checksum =
+      integrity_unblinded_checksum(ephemeral_public_key);
+  shared_secret->checksum = integrity_blinded_checksum(shared_secret);
+
+  return OTCRYPTO_OK;
 }
@@ -53,6 +53,15 @@ otcrypto_status_t otcrypto_ecdh_p384(const otcrypto_blinded_key_t *private_key,
   return otcrypto_ecdh_p384_async_finalize(shared_secret);
 }
 
+otcrypto_status_t otcrypto_ecdh_p384_ephemeral(
+    const otcrypto_unblinded_key_t *peer_public_key,
+    otcrypto_unblinded_key_t *ephemeral_public_key,
+    otcrypto_blinded_key_t *shared_secret) {
+  HARDENED_TRY(otcrypto_ecdh_p384_ephemeral_async_start(peer_public_key));
+  return otcrypto_ecdh_p384_ephemeral_async_finalize(ephemeral_public_key,
+                                                     shared_secret);
+}
+
 /**
  * Calls P-384 key generation.
  *
@@ -233,7 +242,7 @@ otcrypto_status_t otcrypto_ecdsa_p384_keygen_async_finalize(
   HARDENED_TRY(internal_p384_keygen_finalize(private_key, public_key));
 
   // Clear the OTBN sideload slot (in case the seed was sideloaded).
-  return keymgr_sideload_clear_otbn();
+  return keyblob_sideload_clear_otbn();
 }
 
 otcrypto_status_t otcrypto_ecdsa_p384_sign_async_start(
@@ -319,7 +328,7 @@ otcrypto_status_t otcrypto_ecdsa_p384_sign_async_finalize(
   HARDENED_TRY(p384_ecdsa_sign_finalize(sig_p384));
 
   // Clear the OTBN sideload slot (in case the key was sideloaded).
-  return keymgr_sideload_clear_otbn();
+  return keyblob_sideload_clear_otbn();
 }
 otcrypto_status_t otcrypto_ecdsa_p384_verify_async_start(
     const otcrypto_unblinded_key_t *public_key,
@@ -450,8 +459,17 @@ otcrypto_status_t otcrypto_ecdh_p384_async_start(
   return OTCRYPTO_BAD_ARGS;
 }
 
-otcrypto_status_t otcrypto_ecdh_p384_async_finalize(
-    otcrypto_blinded_key_t *shared_secret) {
+/**
+ * Check the configuration of an ECDH shared secret for curve P-384.
+ *
+ * If this check passes, the keyblob has room for a masked x-coordinate.
+ *
+ * @param shared_secret Shared secret struct to check.
+ * @return OK if the configuration is valid or BAD_ARGS otherwise.
+ */
+OT_WARN_UNUSED_RESULT
+static status_t p384_shared_secret_check(
+    const otcrypto_blinded_key_t *shared_secret) {
   if (shared_secret == NULL || shared_secret->keyblob == NULL) {
     return OTCRYPTO_BAD_ARGS;
   }
@@ -475,6 +493,16 @@ otcrypto_status_t otcrypto_ecdh_p384_async_finalize(
       shared_secret->keyblob_length,
       keyblob_num_words(shared_secret->config) * sizeof(uint32_t));
 
+  return OTCRYPTO_OK;
+}
+
+otcrypto_status_t otcrypto_ecdh_p384_async_finalize(
+    otcrypto_blinded_key_t *shared_secret) {
+  if (shared_secret == NULL || shared_secret->keyblob == NULL) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+  HARDENED_TRY(p384_shared_secret_check(shared_secret));
+
   // Note: This operation wipes DMEM after retrieving the keys, so if an error
   // occurs after this point then the keys would be unrecoverable. This should
   // be the last potentially error-causing line before returning to the caller.
@@ -488,5 +516,71 @@ otcrypto_status_t otcrypto_ecdh_p384_async_finalize(
   shared_secret->checksum = integrity_blinded_checksum(shared_secret);
 
   // Clear the OTBN sideload slot (in case the seed was sideloaded).
-  return keymgr_sideload_clear_otbn();
+  return keyblob_sideload_clear_otbn();
+}
+
+otcrypto_status_t otcrypto_ecdh_p384_ephemeral_async_start(
+    const otcrypto_unblinded_key_t *peer_public_key) {
+  if (peer_public_key == NULL || peer_public_key->key == NULL) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+
+  // Check that the entropy complex is initialized.
+  HARDENED_TRY(entropy_complex_check());
+
+  // Check the integrity of the peer key.
+  if (launder32(integrity_unblinded_key_check(peer_public_key)) !=
+      kHardenedBoolTrue) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+  HARDENED_CHECK_EQ(integrity_unblinded_key_check(peer_public_key),
+                    kHardenedBoolTrue);
+
+  // Check the key mode.
+  if (launder32(peer_public_key->key_mode) != kOtcryptoKeyModeEcdhP384) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+  HARDENED_CHECK_EQ(peer_public_key->key_mode, kOtcryptoKeyModeEcdhP384);
+
+  // Check the key length.
+  HARDENED_TRY(p384_public_key_length_check(peer_public_key));
+  p384_point_t *pk = (p384_point_t *)peer_public_key->key;
+
+  return p384_ecdh_ephemeral_start(pk);
+}
+
+otcrypto_status_t otcrypto_ecdh_p384_ephemeral_async_finalize(
+    otcrypto_unblinded_key_t *ephemeral_public_key,
+    otcrypto_blinded_key_t *shared_secret) {
+  if (ephemeral_public_key == NULL || ephemeral_public_key->key == NULL ||
+      shared_secret == NULL || shared_secret->keyblob == NULL) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+
+  // Check the ephemeral public key.
+  if (launder32(ephemeral_public_key->key_mode) != kOtcryptoKeyModeEcdhP384) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+  HARDENED_CHECK_EQ(ephemeral_public_key->key_mode, kOtcryptoKeyModeEcdhP384);
+  HARDENED_TRY(p384_public_key_length_check(ephemeral_public_key));
+  p384_point_t *pk = (p384_point_t *)ephemeral_public_key->key;
+
+  // Check the shared secret.
+  HARDENED_TRY(p384_shared_secret_check(shared_secret));
+
+  // Note: This operation wipes DMEM after retrieving the keys, so if an error
+  // occurs after this point then the keys would be unrecoverable. This should
+  // be the last potentially error-causing line before returning to the caller.
+  p384_ecdh_shared_key_t ss;
+  HARDENED_TRY(p384_ecdh_ephemeral_finalize(pk, &ss));
+
+  keyblob_from_shares(ss.share0, ss.share1, shared_secret->config,
+                      shared_secret->keyblob);
+
+  // Set the checksums.
+  ephemeral_public_key->checksum =
+      integrity_unblinded_checksum(ephemeral_public_key);
+  shared_secret->checksum = integrity_blinded_checksum(shared_secret);
+
+  return OTCRYPTO_OK;
 }
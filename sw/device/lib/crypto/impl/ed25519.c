@@ -4,24 +4,52 @@
 
 #include "sw/device/lib/crypto/include/ed25519.h"
 
+#include "sw/device/lib/base/hardened_memory.h"
+#include "sw/device/lib/crypto/drivers/entropy.h"
+#include "sw/device/lib/crypto/drivers/hmac.h"
+#include "sw/device/lib/crypto/impl/ecc/ed25519.h"
+#include "sw/device/lib/crypto/impl/integrity.h"
+#include "sw/device/lib/crypto/impl/keyblob.h"
 #include "sw/device/lib/crypto/impl/status.h"
 #include "sw/device/lib/crypto/include/datatypes.h"
 
 // Module ID for status codes.
 #define MODULE_ID MAKE_MODULE_ID('e', '2', '5')
 
+enum {
+  /**
+   * Length of the unmasked seed in words.
+   */
+  kEd25519SeedWords = kEd25519SeedBytes / sizeof(uint32_t),
+  /**
+   * Length of a SHA-512 prehash for Ed25519ph in bytes.
+   */
+  kEd25519PrehashBytes = kEd25519HashWords * sizeof(uint32_t),
+};
+
+/**
+ * Domain separator dom2(phflag=1, context="") for Ed25519ph (RFC 8032,
+ * section 5.1).
+ */
+static const uint8_t kEd25519phDom2[] = {
+    'S', 'i', 'g', 'E', 'd', '2', '5', '5', '1', '9', ' ', 'n',
+    'o', ' ', 'E', 'd', '2', '5', '5', '1', '9', ' ', 'c', 'o',
+    'l', 'l', 'i', 's', 'i', 'o', 'n', 's', 0x01, 0x00,
+};
+
 otcrypto_status_t otcrypto_ed25519_keygen(
     otcrypto_blinded_key_t *private_key, otcrypto_unblinded_key_t *public_key) {
-  // TODO: Ed25519 is not yet implemented.
-  return OTCRYPTO_NOT_IMPLEMENTED;
+  HARDENED_TRY(otcrypto_ed25519_keygen_async_start(private_key));
+  return otcrypto_ed25519_keygen_async_finalize(private_key, public_key);
 }
 
 otcrypto_status_t otcrypto_ed25519_sign(
     const otcrypto_blinded_key_t *private_key,
     otcrypto_const_byte_buf_t input_message,
     otcrypto_eddsa_sign_mode_t sign_mode, otcrypto_word32_buf_t signature) {
-  // TODO: Ed25519 is not yet implemented.
-  return OTCRYPTO_NOT_IMPLEMENTED;
+  HARDENED_TRY(otcrypto_ed25519_sign_async_start(private_key, input_message,
+                                                 sign_mode, signature));
+  return otcrypto_ed25519_sign_async_finalize(signature);
 }
 
 otcrypto_status_t otcrypto_ed25519_verify(
@@ -29,34 +57,362 @@ otcrypto_status_t otcrypto_ed25519_verify(
     otcrypto_const_byte_buf_t input_message,
     otcrypto_eddsa_sign_mode_t sign_mode, otcrypto_const_word32_buf_t signature,
     hardened_bool_t *verification_result) {
-  // TODO: Ed25519 is not yet implemented.
-  return OTCRYPTO_NOT_IMPLEMENTED;
+  HARDENED_TRY(otcrypto_ed25519_verify_async_start(public_key, input_message,
+                                                   sign_mode, signature));
+  return otcrypto_ed25519_verify_async_finalize(verification_result);
+}
+
+/**
+ * Check the signing mode and the message length it requires.
+ *
+ * @param sign_mode EdDSA signature hashing mode.
+ * @param input_message Message (or prehash, for Ed25519ph).
+ * @return OK if the arguments are valid or BAD_ARGS otherwise.
+ */
+OT_WARN_UNUSED_RESULT
+static status_t ed25519_message_check(otcrypto_eddsa_sign_mode_t sign_mode,
+                                      otcrypto_const_byte_buf_t input_message) {
+  if (input_message.data == NULL && input_message.len != 0) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+
+  switch (launder32(sign_mode)) {
+    case kOtcryptoEddsaSignModeEddsa:
+      HARDENED_CHECK_EQ(sign_mode, kOtcryptoEddsaSignModeEddsa);
+      return OTCRYPTO_OK;
+    case kOtcryptoEddsaSignModeHashEddsa:
+      HARDENED_CHECK_EQ(sign_mode, kOtcryptoEddsaSignModeHashEddsa);
+      if (launder32(input_message.len) != kEd25519PrehashBytes) {
+        return OTCRYPTO_BAD_ARGS;
+      }
+      HARDENED_CHECK_EQ(input_message.len, kEd25519PrehashBytes);
+      return OTCRYPTO_OK;
+    default:
+      return OTCRYPTO_BAD_ARGS;
+  }
+}
+
+/**
+ * Compute SHA-512(dom2 || part0 || part1 || M) with the HMAC block.
+ *
+ * The domain separator is only included for Ed25519ph, as in RFC 8032.
+ *
+ * @param sign_mode EdDSA signature hashing mode.
+ * @param part0 First 32-byte part of the hash input.
+ * @param part1 Second 32-byte part of the hash input, or NULL if absent.
+ * @param input_message Message (or prehash, for Ed25519ph).
+ * @param[out] digest Resulting digest, as a little-endian integer.
+ * @return OK or error.
+ */
+OT_WARN_UNUSED_RESULT
+static status_t ed25519_hash(otcrypto_eddsa_sign_mode_t sign_mode,
+                             const uint32_t *part0, const uint32_t *part1,
+                             otcrypto_const_byte_buf_t input_message,
+                             uint32_t digest[kEd25519HashWords]) {
+  hmac_ctx_t ctx;
+  HARDENED_TRY(hmac_init(&ctx, kHmacModeSha512, /*key=*/NULL,
+                         /*key_wordlen=*/0));
+  if (launder32(sign_mode) == kOtcryptoEddsaSignModeHashEddsa) {
+    HARDENED_CHECK_EQ(sign_mode, kOtcryptoEddsaSignModeHashEddsa);
+    HARDENED_TRY(hmac_update(&ctx, kEd25519phDom2, sizeof(kEd25519phDom2)));
+  }
+  HARDENED_TRY(
+      hmac_update(&ctx, (const uint8_t *)part0, kEd25519PointBytes));
+  if (part1 != NULL) {
+    HARDENED_TRY(
+        hmac_update(&ctx, (const uint8_t *)part1, kEd25519PointBytes));
+  }
+  HARDENED_TRY(hmac_update(&ctx, input_message.data, input_message.len));
+
+  // The digest bytes are in the order of FIPS 180-4, so on this little-endian
+  // core the words already form the little-endian integer RFC 8032 expects.
+  return hmac_final(&ctx, digest, kEd25519HashWords);
+}
+
+/**
+ * Compute SHA-512 of the seed held in two boolean shares.
+ *
+ * The unmasked seed only lives on the stack for the duration of the hash.
+ *
+ * @param share0 First share of the seed.
+ * @param share1 Second share of the seed.
+ * @param[out] digest SHA-512(seed).
+ * @return OK or error.
+ */
+OT_WARN_UNUSED_RESULT
+static status_t ed25519_seed_hash(const uint32_t *share0, const uint32_t *share1,
+                                  uint32_t digest[kEd25519HashWords]) {
+  uint32_t seed[kEd25519SeedWords];
+  size_t i = 0;
+  for (; launder32(i) < kEd25519SeedWords; i++) {
+    seed[i] = share0[i] ^ share1[i];
+  }
+  HARDENED_CHECK_EQ(i, kEd25519SeedWords);
+
+  status_t err = hmac(kHmacModeSha512, /*key=*/NULL, /*key_wordlen=*/0,
+                      (const uint8_t *)seed, kEd25519SeedBytes, digest,
+                      kEd25519HashWords);
+  hardened_memshred(seed, kEd25519SeedWords);
+  return err;
+}
+
+/**
+ * Check the lengths of private keys for Ed25519.
+ *
+ * If this check passes, it is safe to interpret `private_key->keyblob` as a
+ * `ed25519_masked_seed_t *`. Hardware-backed keys are not supported, since
+ * the seed must be hashed on Ibex.
+ *
+ * @param private_key Private key struct to check.
+ * @return OK if the lengths are correct or an error otherwise.
+ */
+OT_WARN_UNUSED_RESULT
+static status_t ed25519_private_key_length_check(
+    const otcrypto_blinded_key_t *private_key) {
+  if (private_key->keyblob == NULL) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+
+  if (launder32(private_key->config.hw_backed) != kHardenedBoolFalse) {
+    return OTCRYPTO_NOT_IMPLEMENTED;
+  }
+  HARDENED_CHECK_EQ(private_key->config.hw_backed, kHardenedBoolFalse);
+
+  // Check the unmasked length.
+  if (launder32(private_key->config.key_length) != kEd25519SeedBytes) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+  HARDENED_CHECK_EQ(private_key->config.key_length, kEd25519SeedBytes);
+
+  // Check the single-share length.
+  if (launder32(keyblob_share_num_words(private_key->config)) !=
+      kEd25519MaskedSeedShareWords) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+  HARDENED_CHECK_EQ(keyblob_share_num_words(private_key->config),
+                    kEd25519MaskedSeedShareWords);
+
+  // Check the keyblob length.
+  if (launder32(private_key->keyblob_length) !=
+      sizeof(ed25519_masked_seed_t)) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+  HARDENED_CHECK_EQ(private_key->keyblob_length, sizeof(ed25519_masked_seed_t));
+
+  return OTCRYPTO_OK;
+}
+
+/**
+ * Check the length of public keys for Ed25519.
+ *
+ * If this check passes, it is safe to interpret `public_key->key` as an
+ * encoded point of `kEd25519PointWords` words.
+ *
+ * @param public_key Public key struct to check.
+ * @return OK if the lengths are correct or BAD_ARGS otherwise.
+ */
+OT_WARN_UNUSED_RESULT
+static status_t ed25519_public_key_length_check(
+    const otcrypto_unblinded_key_t *public_key) {
+  if (launder32(public_key->key_length) != kEd25519PointBytes) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+  HARDENED_CHECK_EQ(public_key->key_length, kEd25519PointBytes);
+  return OTCRYPTO_OK;
+}
+
+/**
+ * Check the length of a signature buffer for Ed25519.
+ *
+ * If this check passes on `len`, it is safe to interpret the buffer as
+ * `ed25519_signature_t *`.
+ *
+ * @param len Length to check.
+ * @return OK if the lengths are correct or BAD_ARGS otherwise.
+ */
+OT_WARN_UNUSED_RESULT
+static status_t ed25519_signature_length_check(size_t len) {
+  if (launder32(len) > UINT32_MAX / sizeof(uint32_t) ||
+      launder32(len) * sizeof(uint32_t) != sizeof(ed25519_signature_t)) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+  HARDENED_CHECK_EQ(len * sizeof(uint32_t), sizeof(ed25519_signature_t));
+
+  return OTCRYPTO_OK;
 }
 
 otcrypto_status_t otcrypto_ed25519_keygen_async_start(
     const otcrypto_blinded_key_t *private_key) {
-  // TODO: Ed25519 is not yet implemented.
-  return OTCRYPTO_NOT_IMPLEMENTED;
+  if (private_key == NULL || private_key->keyblob == NULL) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+
+  // Check the key mode.
+  if (launder32(private_key->config.key_mode) != kOtcryptoKeyModeEd25519) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+  HARDENED_CHECK_EQ(private_key->config.key_mode, kOtcryptoKeyModeEd25519);
+
+  // Check the key length.
+  HARDENED_TRY(ed25519_private_key_length_check(private_key));
+
+  // Check that the entropy complex is initialized.
+  HARDENED_TRY(entropy_complex_check());
+
+  // Generate the seed on OTBN, then hash it here. The seed stays in DMEM and
+  // is read back by the `finalize` call.
+  ed25519_masked_seed_t seed;
+  HARDENED_TRY(ed25519_keygen_seed(&seed));
+  uint32_t hash[kEd25519HashWords];
+  status_t err = ed25519_seed_hash(seed.share0, seed.share1, hash);
+  hardened_memshred(seed.share0, kEd25519MaskedSeedShareWords);
+  hardened_memshred(seed.share1, kEd25519MaskedSeedShareWords);
+  HARDENED_TRY(err);
+
+  err = ed25519_keygen_start(hash);
+  hardened_memshred(hash, kEd25519HashWords);
+  return err;
 }
 
 otcrypto_status_t otcrypto_ed25519_keygen_async_finalize(
     otcrypto_blinded_key_t *private_key, otcrypto_unblinded_key_t *public_key) {
-  // TODO: Ed25519 is not yet implemented.
-  return OTCRYPTO_NOT_IMPLEMENTED;
+  // Check for any NULL pointers.
+  if (private_key == NULL || public_key == NULL ||
+      private_key->keyblob == NULL || public_key->key == NULL) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+
+  // Check the key modes.
+  if (launder32(private_key->config.key_mode) != kOtcryptoKeyModeEd25519 ||
+      launder32(public_key->key_mode) != kOtcryptoKeyModeEd25519) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+  HARDENED_CHECK_EQ(private_key->config.key_mode, kOtcryptoKeyModeEd25519);
+  HARDENED_CHECK_EQ(public_key->key_mode, kOtcryptoKeyModeEd25519);
+
+  // Check the lengths of caller-allocated buffers.
+  HARDENED_TRY(ed25519_private_key_length_check(private_key));
+  HARDENED_TRY(ed25519_public_key_length_check(public_key));
+
+  // Note: This operation wipes DMEM after retrieving the keys, so if an error
+  // occurs after this point then the keys would be unrecoverable. This should
+  // be the last potentially error-causing line before returning to the caller.
+  ed25519_masked_seed_t *sk = (ed25519_masked_seed_t *)private_key->keyblob;
+  HARDENED_TRY(ed25519_keygen_finalize(sk, public_key->key));
+
+  private_key->checksum = integrity_blinded_checksum(private_key);
+  public_key->checksum = integrity_unblinded_checksum(public_key);
+  return OTCRYPTO_OK;
 }
 
 otcrypto_status_t otcrypto_ed25519_sign_async_start(
     const otcrypto_blinded_key_t *private_key,
     otcrypto_const_byte_buf_t input_message,
     otcrypto_eddsa_sign_mode_t sign_mode, otcrypto_word32_buf_t signature) {
-  // TODO: Ed25519 is not yet implemented.
-  return OTCRYPTO_NOT_IMPLEMENTED;
+  if (private_key == NULL || private_key->keyblob == NULL ||
+      signature.data == NULL) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+
+  // Check the integrity of the private key.
+  if (launder32(integrity_blinded_key_check(private_key)) !=
+      kHardenedBoolTrue) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+  HARDENED_CHECK_EQ(integrity_blinded_key_check(private_key),
+                    kHardenedBoolTrue);
+
+  // Check that the entropy complex is initialized.
+  HARDENED_TRY(entropy_complex_check());
+
+  if (launder32(private_key->config.key_mode) != kOtcryptoKeyModeEd25519) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+  HARDENED_CHECK_EQ(private_key->config.key_mode, kOtcryptoKeyModeEd25519);
+
+  // Check the message, key and signature lengths.
+  HARDENED_TRY(ed25519_message_check(sign_mode, input_message));
+  HARDENED_TRY(ed25519_private_key_length_check(private_key));
+  HARDENED_TRY(ed25519_signature_length_check(signature.len));
+  ed25519_masked_seed_t *sk = (ed25519_masked_seed_t *)private_key->keyblob;
+  ed25519_signature_t *sig = (ed25519_signature_t *)signature.data;
+
+  // Hash the seed: the lower half gives the secret scalar and the upper half
+  // the prefix for the nonce, r = H(dom2 || prefix || M).
+  uint32_t hash[kEd25519HashWords];
+  uint32_t hash_r[kEd25519HashWords];
+  HARDENED_TRY(ed25519_seed_hash(sk->share0, sk->share1, hash));
+  status_t err = ed25519_hash(sign_mode, &hash[kEd25519ScalarWords], NULL,
+                              input_message, hash_r);
+
+  // Compute A and R on OTBN.
+  uint32_t public_key[kEd25519PointWords];
+  if (status_ok(err)) {
+    err = ed25519_sign_commit(hash, hash_r, public_key, sig->r);
+  }
+  hardened_memshred(hash, kEd25519HashWords);
+  hardened_memshred(hash_r, kEd25519HashWords);
+  HARDENED_TRY(err);
+
+  // Start computing S with k = H(dom2 || R || A || M).
+  uint32_t hash_k[kEd25519HashWords];
+  HARDENED_TRY(
+      ed25519_hash(sign_mode, sig->r, public_key, input_message, hash_k));
+  return ed25519_sign_finish_start(hash_k);
 }
 
 otcrypto_status_t otcrypto_ed25519_sign_async_finalize(
     otcrypto_word32_buf_t signature) {
-  // TODO: Ed25519 is not yet implemented.
-  return OTCRYPTO_NOT_IMPLEMENTED;
+  if (signature.data == NULL) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+
+  HARDENED_TRY(ed25519_signature_length_check(signature.len));
+  ed25519_signature_t *sig = (ed25519_signature_t *)signature.data;
+  // Note: This operation wipes DMEM, so if an error occurs after this
+  // point then the signature would be unrecoverable. This should be the
+  // last potentially error-causing line before returning to the caller.
+  return ed25519_sign_finalize(sig->s);
+}
+
+/**
+ * Checks the arguments of an Ed25519 signature verification.
+ *
+ * @param public_key Pointer to the unblinded public key struct.
+ * @param signature Signature to be verified.
+ * @param[out] item Verification inputs, apart from the hash.
+ * @return OK or error.
+ */
+OT_WARN_UNUSED_RESULT
+static status_t internal_ed25519_verify_args(
+    const otcrypto_unblinded_key_t *public_key,
+    otcrypto_const_word32_buf_t signature, ed25519_verify_item_t *item) {
+  if (public_key == NULL || signature.data == NULL ||
+      public_key->key == NULL) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+
+  // Check the integrity of the public key.
+  if (launder32(integrity_unblinded_key_check(public_key)) !=
+      kHardenedBoolTrue) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+  HARDENED_CHECK_EQ(integrity_unblinded_key_check(public_key),
+                    kHardenedBoolTrue);
+
+  // Check the public key mode.
+  if (launder32(public_key->key_mode) != kOtcryptoKeyModeEd25519) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+  HARDENED_CHECK_EQ(public_key->key_mode, kOtcryptoKeyModeEd25519);
+
+  // Check the public key and signature lengths.
+  HARDENED_TRY(ed25519_public_key_length_check(public_key));
+  HARDENED_TRY(ed25519_signature_length_check(signature.len));
+
+  item->signature = (const ed25519_signature_t *)signature.data;
+  item->public_key = public_key->key;
+  return OTCRYPTO_OK;
 }
 
 otcrypto_status_t otcrypto_ed25519_verify_async_start(
@@ -64,12 +420,65 @@ otcrypto_status_t otcrypto_ed25519_verify_async_start(
     otcrypto_const_byte_buf_t input_message,
     otcrypto_eddsa_sign_mode_t sign_mode,
     otcrypto_const_word32_buf_t signature) {
-  // TODO: Ed25519 is not yet implemented.
-  return OTCRYPTO_NOT_IMPLEMENTED;
+  ed25519_verify_item_t item;
+  HARDENED_TRY(internal_ed25519_verify_args(public_key, signature, &item));
+  HARDENED_TRY(ed25519_message_check(sign_mode, input_message));
+
+  // Compute k = H(dom2 || R || A || M).
+  uint32_t hash_k[kEd25519HashWords];
+  HARDENED_TRY(ed25519_hash(sign_mode, item.signature->r, item.public_key,
+                            input_message, hash_k));
+
+  // Start the asynchronous signature-verification routine.
+  return ed25519_verify_start(item.signature, hash_k, item.public_key);
+}
+
+otcrypto_status_t otcrypto_ed25519_verify_batch(
+    const otcrypto_unblinded_key_t *const *public_keys,
+    const otcrypto_const_byte_buf_t *input_messages,
+    otcrypto_eddsa_sign_mode_t sign_mode,
+    const otcrypto_const_word32_buf_t *signatures, size_t num_items,
+    hardened_bool_t *verification_results) {
+  if (public_keys == NULL || input_messages == NULL || signatures == NULL ||
+      verification_results == NULL) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+
+  // Check the arguments and hash a chunk of signatures at a time, then verify
+  // them together.
+  ed25519_verify_item_t items[kEd25519BatchVerifyMaxItems];
+  uint32_t hashes[kEd25519BatchVerifyMaxItems][kEd25519HashWords];
+  size_t done = 0;
+  while (done < num_items) {
+    size_t chunk = num_items - done;
+    if (chunk > kEd25519BatchVerifyMaxItems) {
+      chunk = kEd25519BatchVerifyMaxItems;
+    }
+    size_t i = 0;
+    for (; launder32(i) < chunk; i++) {
+      HARDENED_TRY(internal_ed25519_verify_args(
+          public_keys[done + i], signatures[done + i], &items[i]));
+      HARDENED_TRY(
+          ed25519_message_check(sign_mode, input_messages[done + i]));
+      HARDENED_TRY(ed25519_hash(sign_mode, items[i].signature->r,
+                                items[i].public_key, input_messages[done + i],
+                                hashes[i]));
+      items[i].hash = hashes[i];
+    }
+    HARDENED_CHECK_EQ(i, chunk);
+    HARDENED_TRY(
+        ed25519_verify_batch(items, chunk, &verification_results[done]));
+    done += chunk;
+  }
+
+  return OTCRYPTO_OK;
 }
 
 otcrypto_status_t otcrypto_ed25519_verify_async_finalize(
     hardened_bool_t *verification_result) {
-  // TODO: Ed25519 is not yet implemented.
-  return OTCRYPTO_NOT_IMPLEMENTED;
+  if (verification_result == NULL) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+
+  return ed25519_verify_finalize(verification_result);
 }
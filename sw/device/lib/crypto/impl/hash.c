@@ -9,11 +9,25 @@
 #include "sw/device/lib/base/hardened_memory.h"
 #include "sw/device/lib/crypto/drivers/hmac.h"
 #include "sw/device/lib/crypto/drivers/kmac.h"
+#include "sw/device/lib/crypto/impl/sha2/sha512.h"
 #include "sw/device/lib/crypto/impl/status.h"
 
 // Module ID for status codes.
 #define MODULE_ID MAKE_MODULE_ID('h', 'a', 's')
 
+enum {
+  /**
+   * Number of messages handed to the HMAC driver at once by
+   * `otcrypto_hash_batch`.
+   */
+  kHashBatchChunkSize = 8,
+  /**
+   * Number of bytes fed to the HMAC block at a time by `otcrypto_hash_parallel`
+   * while OTBN is busy, between checks for whether OTBN needs its next run.
+   */
+  kHashParallelPollBytes = 1024,
+};
+
 // Check that internal and publicly exposed digest values match each other.
 static_assert(kSha256DigestBits == kHmacSha256DigestBits &&
                   kSha256DigestBytes == kHmacSha256DigestBytes &&
@@ -28,44 +42,113 @@ static_assert(kSha512DigestBits == kHmacSha512DigestBits &&
                   kSha512DigestWords == kHmacSha512DigestWords,
               "Exposed and driver-level SHA-512 digest size mismatch.");
 
-// Ensure that the hash context is large enough for HMAC driver struct.
+/**
+ * Internal layout of the generic hash context.
+ *
+ * The hash mode is recorded so that update and final calls can reach the right
+ * driver: SHA-2 streams are backed by the HMAC driver, SHA-3 and XOF streams by
+ * the KMAC driver.
+ */
+typedef struct hash_ctx {
+  // Hash mode of the stream (an `otcrypto_hash_mode_t` value).
+  uint32_t mode;
+  union {
+    hmac_ctx_t hmac;
+    kmac_ctx_t kmac;
+  } driver;
+} hash_ctx_t;
+
+// Ensure that the hash context is large enough for the internal struct.
 static_assert(
-    sizeof(otcrypto_hash_context_t) >= sizeof(hmac_ctx_t),
-    "`otcrypto_hash_context_t` must be big enough to hold `hmac_ctx_t`.");
+    sizeof(otcrypto_hash_context_t) >= sizeof(hash_ctx_t),
+    "`otcrypto_hash_context_t` must be big enough to hold `hash_ctx_t`.");
 
-// Ensure that HMAC driver struct is suitable for `hardened_memcpy()`.
-static_assert(sizeof(hmac_ctx_t) % sizeof(uint32_t) == 0,
-              "Size of `hmac_ctx_t` must be a multiple of the word size for "
+// Ensure that the internal struct is suitable for `hardened_memcpy()`.
+static_assert(sizeof(hash_ctx_t) % sizeof(uint32_t) == 0,
+              "Size of `hash_ctx_t` must be a multiple of the word size for "
               "`hardened_memcpy()`");
 
 /**
- * Save the internal HMAC driver context to a generic hash context.
+ * Save the internal hash context to a generic hash context.
  *
  * @param[out] ctx Generic hash context to copy to.
- * @param hmac_ctx The internal context object from HMAC driver.
+ * @param hash_ctx The internal context object.
  */
-static void hmac_ctx_save(otcrypto_hash_context_t *restrict ctx,
-                          const hmac_ctx_t *restrict hmac_ctx) {
+static void hash_ctx_save(otcrypto_hash_context_t *restrict ctx,
+                          const hash_ctx_t *restrict hash_ctx) {
   // As per the `hardened_memcpy()` documentation, it is OK to cast to
   // `uint32_t *` here as long as `state` is word-aligned, which it must be
   // because all its fields are.
-  hardened_memcpy(ctx->data, (uint32_t *)hmac_ctx,
-                  sizeof(hmac_ctx_t) / sizeof(uint32_t));
+  hardened_memcpy(ctx->data, (uint32_t *)hash_ctx,
+                  sizeof(hash_ctx_t) / sizeof(uint32_t));
 }
 
 /**
- * Restore an internal HMAC driver context from a generic hash context.
+ * Restore an internal hash context from a generic hash context.
  *
  * @param ctx Generic hash context to restore from.
- * @param[out] hmac_ctx Destination HMAC driver context object.
+ * @param[out] hash_ctx Destination internal context object.
  */
-static void hmac_ctx_restore(const otcrypto_hash_context_t *restrict ctx,
-                             hmac_ctx_t *restrict hmac_ctx) {
+static void hash_ctx_restore(const otcrypto_hash_context_t *restrict ctx,
+                             hash_ctx_t *restrict hash_ctx) {
   // As per the `hardened_memcpy()` documentation, it is OK to cast to
   // `uint32_t *` here as long as `state` is word-aligned, which it must be
   // because all its fields are.
-  hardened_memcpy((uint32_t *)hmac_ctx, ctx->data,
-                  sizeof(hmac_ctx_t) / sizeof(uint32_t));
+  hardened_memcpy((uint32_t *)hash_ctx, ctx->data,
+                  sizeof(hash_ctx_t) / sizeof(uint32_t));
+}
+
+/**
+ * Get the KMAC streaming mode for a SHA-3 or XOF hash mode.
+ *
+ * @param hash_mode Hash mode.
+ * @param[out] kmac_mode Corresponding KMAC streaming mode.
+ * @return Error status; `OTCRYPTO_BAD_ARGS` for modes not backed by KMAC.
+ */
+OT_WARN_UNUSED_RESULT
+static status_t kmac_stream_mode_get(otcrypto_hash_mode_t hash_mode,
+                                     kmac_stream_mode_t *kmac_mode) {
+  switch (launder32(hash_mode)) {
+    case kOtcryptoHashModeSha3_224:
+      *kmac_mode = kKmacStreamModeSha3_224;
+      return OTCRYPTO_OK;
+    case kOtcryptoHashModeSha3_256:
+      *kmac_mode = kKmacStreamModeSha3_256;
+      return OTCRYPTO_OK;
+    case kOtcryptoHashModeSha3_384:
+      *kmac_mode = kKmacStreamModeSha3_384;
+      return OTCRYPTO_OK;
+    case kOtcryptoHashModeSha3_512:
+      *kmac_mode = kKmacStreamModeSha3_512;
+      return OTCRYPTO_OK;
+    case kOtcryptoHashXofModeShake128:
+      *kmac_mode = kKmacStreamModeShake128;
+      return OTCRYPTO_OK;
+    case kOtcryptoHashXofModeShake256:
+      *kmac_mode = kKmacStreamModeShake256;
+      return OTCRYPTO_OK;
+    case kOtcryptoHashXofModeCshake128:
+      *kmac_mode = kKmacStreamModeCshake128;
+      return OTCRYPTO_OK;
+    case kOtcryptoHashXofModeCshake256:
+      *kmac_mode = kKmacStreamModeCshake256;
+      return OTCRYPTO_OK;
+    default:
+      return OTCRYPTO_BAD_ARGS;
+  }
+}
+
+/**
+ * Checks whether a hash mode is an extendable-output function.
+ *
+ * @param hash_mode Hash mode.
+ * @return True for SHAKE and cSHAKE modes.
+ */
+static bool is_xof_mode(otcrypto_hash_mode_t hash_mode) {
+  return hash_mode == kOtcryptoHashXofModeShake128 ||
+         hash_mode == kOtcryptoHashXofModeShake256 ||
+         hash_mode == kOtcryptoHashXofModeCshake128 ||
+         hash_mode == kOtcryptoHashXofModeCshake256;
 }
 
 /**
@@ -161,6 +244,254 @@ otcrypto_status_t otcrypto_hash(otcrypto_const_byte_buf_t input_message,
   return OTCRYPTO_OK;
 }
 
+otcrypto_status_t otcrypto_hash_batch(
+    const otcrypto_const_byte_buf_t *input_messages, size_t num_messages,
+    otcrypto_hash_digest_t *digests) {
+  if (num_messages == 0) {
+    return OTCRYPTO_OK;
+  }
+  if (input_messages == NULL || digests == NULL) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+
+  hmac_mode_t hmac_mode;
+  switch (digests[0].mode) {
+    case kOtcryptoHashModeSha256:
+      hmac_mode = kHmacModeSha256;
+      break;
+    case kOtcryptoHashModeSha384:
+      hmac_mode = kHmacModeSha384;
+      break;
+    case kOtcryptoHashModeSha512:
+      hmac_mode = kHmacModeSha512;
+      break;
+    default:
+      return OTCRYPTO_BAD_ARGS;
+  }
+
+  // Hand the messages to the driver in chunks, so that the pointer arrays
+  // stay small.
+  const uint8_t *messages[kHashBatchChunkSize];
+  size_t message_lens[kHashBatchChunkSize];
+  uint32_t *digest_data[kHashBatchChunkSize];
+  size_t i = 0;
+  while (i < num_messages) {
+    size_t chunk_len = 0;
+    for (; chunk_len < kHashBatchChunkSize && i < num_messages;
+         chunk_len++, i++) {
+      if (digests[i].mode != digests[0].mode || digests[i].data == NULL) {
+        return OTCRYPTO_BAD_ARGS;
+      }
+      HARDENED_TRY(check_digest_len(digests[i]));
+      messages[chunk_len] = input_messages[i].data;
+      message_lens[chunk_len] = input_messages[i].len;
+      digest_data[chunk_len] = digests[i].data;
+    }
+    HARDENED_TRY(hmac_sha2_batch(hmac_mode, messages, message_lens,
+                                 digest_data, chunk_len, digests[0].len));
+  }
+  HARDENED_CHECK_EQ(i, num_messages);
+
+  return OTCRYPTO_OK;
+}
+
+/**
+ * Checks whether a hash mode can be computed on OTBN.
+ *
+ * @param hash_mode Hash mode.
+ * @return True for SHA-384 and SHA-512.
+ */
+static bool is_otbn_mode(otcrypto_hash_mode_t hash_mode) {
+  return hash_mode == kOtcryptoHashModeSha384 ||
+         hash_mode == kOtcryptoHashModeSha512;
+}
+
+/**
+ * Starts hashing a message on OTBN.
+ *
+ * @param[out] ctx Context object for the OTBN computation.
+ * @param input_message Input message.
+ * @param hash_mode Hash mode (SHA-384 or SHA-512).
+ * @return Error status.
+ */
+OT_WARN_UNUSED_RESULT
+static status_t otbn_hash_start(sha512_async_ctx_t *ctx,
+                                otcrypto_const_byte_buf_t input_message,
+                                otcrypto_hash_mode_t hash_mode) {
+  switch (launder32(hash_mode)) {
+    case kOtcryptoHashModeSha384:
+      return sha384_async_start(ctx, input_message.data, input_message.len);
+    case kOtcryptoHashModeSha512:
+      return sha512_async_start(ctx, input_message.data, input_message.len);
+    default:
+      return OTCRYPTO_BAD_ARGS;
+  }
+}
+
+/**
+ * Reads the digest of a message hashed on OTBN.
+ *
+ * @param[out] digest Output digest; the mode must match the started one.
+ * @return Error status.
+ */
+OT_WARN_UNUSED_RESULT
+static status_t otbn_hash_finalize(otcrypto_hash_digest_t digest) {
+  switch (launder32(digest.mode)) {
+    case kOtcryptoHashModeSha384:
+      return sha384_async_finalize(digest.data);
+    case kOtcryptoHashModeSha512:
+      return sha512_async_finalize(digest.data);
+    default:
+      return OTCRYPTO_BAD_ARGS;
+  }
+}
+
+otcrypto_status_t otcrypto_hash_async_start(
+    otcrypto_const_byte_buf_t input_message, otcrypto_hash_mode_t hash_mode) {
+  if (input_message.data == NULL && input_message.len != 0) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+
+  // There is nowhere to keep the message pointer until finalize, so start all
+  // but the last run here.
+  sha512_async_ctx_t ctx;
+  HARDENED_TRY(otbn_hash_start(&ctx, input_message, hash_mode));
+  return sha512_async_flush(&ctx);
+}
+
+otcrypto_status_t otcrypto_hash_async_finalize(otcrypto_hash_digest_t digest) {
+  if (digest.data == NULL) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+  HARDENED_TRY(check_digest_len(digest));
+  return otbn_hash_finalize(digest);
+}
+
+/**
+ * Polls the OTBN computation, if any, without blocking.
+ *
+ * @param ctx Context object for the OTBN computation.
+ * @param[in,out] otbn_busy Whether OTBN is working on a message; cleared once
+ * it has finished.
+ * @return Error status.
+ */
+OT_WARN_UNUSED_RESULT
+static status_t otbn_hash_poll(sha512_async_ctx_t *ctx,
+                               hardened_bool_t *otbn_busy) {
+  if (*otbn_busy != kHardenedBoolTrue) {
+    return OTCRYPTO_OK;
+  }
+  status_t result = sha512_async_poll(ctx);
+  if (result.value == OTCRYPTO_ASYNC_INCOMPLETE.value) {
+    return OTCRYPTO_OK;
+  }
+  HARDENED_TRY(result);
+  *otbn_busy = kHardenedBoolFalse;
+  return OTCRYPTO_OK;
+}
+
+/**
+ * Hashes a message on the HMAC or KMAC block while OTBN works on another.
+ *
+ * SHA-2 messages are fed to the HMAC block in pieces, and OTBN is polled in
+ * between so that it gets its next run promptly.
+ *
+ * @param input_message Input message.
+ * @param digest Output digest.
+ * @param otbn_ctx Context object for the OTBN computation.
+ * @param otbn_busy Whether OTBN is working on a message.
+ * @return Error status.
+ */
+OT_WARN_UNUSED_RESULT
+static status_t hash_alongside_otbn(otcrypto_const_byte_buf_t input_message,
+                                    otcrypto_hash_digest_t digest,
+                                    sha512_async_ctx_t *otbn_ctx,
+                                    hardened_bool_t otbn_busy) {
+  hmac_mode_t hmac_mode;
+  switch (launder32(digest.mode)) {
+    case kOtcryptoHashModeSha256:
+      hmac_mode = kHmacModeSha256;
+      break;
+    case kOtcryptoHashModeSha384:
+      hmac_mode = kHmacModeSha384;
+      break;
+    case kOtcryptoHashModeSha512:
+      hmac_mode = kHmacModeSha512;
+      break;
+    default:
+      // SHA-3 is computed by KMAC in one go.
+      return otcrypto_hash(input_message, digest);
+  }
+  if (otbn_busy != kHardenedBoolTrue) {
+    return otcrypto_hash(input_message, digest);
+  }
+
+  hmac_ctx_t hmac_ctx;
+  HARDENED_TRY(hmac_init(&hmac_ctx, hmac_mode, /*key=*/NULL,
+                         /*key_wordlen=*/0));
+  const uint8_t *data = input_message.data;
+  size_t len = input_message.len;
+  while (len > 0) {
+    size_t piece_len =
+        len < kHashParallelPollBytes ? len : kHashParallelPollBytes;
+    HARDENED_TRY(hmac_update(&hmac_ctx, data, piece_len));
+    data += piece_len;
+    len -= piece_len;
+    HARDENED_TRY(otbn_hash_poll(otbn_ctx, &otbn_busy));
+  }
+  return hmac_final(&hmac_ctx, digest.data, digest.len);
+}
+
+otcrypto_status_t otcrypto_hash_parallel(
+    const otcrypto_const_byte_buf_t *input_messages, size_t num_messages,
+    otcrypto_hash_digest_t *digests) {
+  if (num_messages == 0) {
+    return OTCRYPTO_OK;
+  }
+  if (input_messages == NULL || digests == NULL) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+
+  // Check all arguments first, so that OTBN is never left running on error.
+  for (size_t i = 0; i < num_messages; i++) {
+    if ((input_messages[i].data == NULL && input_messages[i].len != 0) ||
+        digests[i].data == NULL) {
+      return OTCRYPTO_BAD_ARGS;
+    }
+    HARDENED_TRY(check_digest_len(digests[i]));
+  }
+
+  // Hand each SHA-384/512 message to OTBN if it is free, and everything else
+  // to the other blocks. OTBN is slower per block than the HMAC block, so
+  // taking messages only when it is free balances the load between the two.
+  sha512_async_ctx_t otbn_ctx;
+  size_t otbn_index = num_messages;
+  hardened_bool_t otbn_busy = kHardenedBoolFalse;
+  for (size_t i = 0; i < num_messages; i++) {
+    HARDENED_TRY(otbn_hash_poll(&otbn_ctx, &otbn_busy));
+    if (otbn_index != num_messages && otbn_busy == kHardenedBoolFalse) {
+      HARDENED_TRY(otbn_hash_finalize(digests[otbn_index]));
+      otbn_index = num_messages;
+    }
+
+    if (otbn_index == num_messages && is_otbn_mode(digests[i].mode)) {
+      HARDENED_TRY(
+          otbn_hash_start(&otbn_ctx, input_messages[i], digests[i].mode));
+      otbn_index = i;
+      otbn_busy = kHardenedBoolTrue;
+      continue;
+    }
+    HARDENED_TRY(hash_alongside_otbn(input_messages[i], digests[i], &otbn_ctx,
+                                     otbn_busy));
+  }
+
+  if (otbn_index != num_messages) {
+    HARDENED_TRY(sha512_async_flush(&otbn_ctx));
+    HARDENED_TRY(otbn_hash_finalize(digests[otbn_index]));
+  }
+  return OTCRYPTO_OK;
+}
+
 otcrypto_status_t otcrypto_xof_shake(otcrypto_const_byte_buf_t input_message,
                                      otcrypto_hash_digest_t digest) {
   switch (digest.mode) {
@@ -226,21 +557,36 @@ otcrypto_status_t otcrypto_hash_init(otcrypto_hash_context_t *const ctx,
     return OTCRYPTO_BAD_ARGS;
   }
 
-  hmac_ctx_t hmac_ctx;
+  hash_ctx_t hash_ctx;
+  hash_ctx.mode = hash_mode;
   switch (hash_mode) {
     case kOtcryptoHashModeSha256: {
-      HARDENED_TRY(hmac_init(&hmac_ctx, kHmacModeSha256, /*hmac_key=*/NULL,
-                             /*key_wordlen=*/0));
+      HARDENED_TRY(hmac_init(&hash_ctx.driver.hmac, kHmacModeSha256,
+                             /*hmac_key=*/NULL, /*key_wordlen=*/0));
       break;
     }
     case kOtcryptoHashModeSha384: {
-      HARDENED_TRY(hmac_init(&hmac_ctx, kHmacModeSha384, /*hmac_key=*/NULL,
-                             /*key_wordlen=*/0));
+      HARDENED_TRY(hmac_init(&hash_ctx.driver.hmac, kHmacModeSha384,
+                             /*hmac_key=*/NULL, /*key_wordlen=*/0));
       break;
     }
     case kOtcryptoHashModeSha512: {
-      HARDENED_TRY(hmac_init(&hmac_ctx, kHmacModeSha512, /*hmac_key=*/NULL,
-                             /*key_wordlen=*/0));
+      HARDENED_TRY(hmac_init(&hash_ctx.driver.hmac, kHmacModeSha512,
+                             /*hmac_key=*/NULL, /*key_wordlen=*/0));
+      break;
+    }
+    case kOtcryptoHashModeSha3_224:
+      OT_FALLTHROUGH_INTENDED;
+    case kOtcryptoHashModeSha3_256:
+      OT_FALLTHROUGH_INTENDED;
+    case kOtcryptoHashModeSha3_384:
+      OT_FALLTHROUGH_INTENDED;
+    case kOtcryptoHashModeSha3_512: {
+      kmac_stream_mode_t kmac_mode;
+      HARDENED_TRY(kmac_stream_mode_get(hash_mode, &kmac_mode));
+      HARDENED_TRY(kmac_stream_init(&hash_ctx.driver.kmac, kmac_mode,
+                                    /*func_name=*/NULL, /*func_name_len=*/0,
+                                    /*cust_str=*/NULL, /*cust_str_len=*/0));
       break;
     }
     default:
@@ -248,7 +594,7 @@ otcrypto_status_t otcrypto_hash_init(otcrypto_hash_context_t *const ctx,
       return OTCRYPTO_BAD_ARGS;
   }
 
-  hmac_ctx_save(ctx, &hmac_ctx);
+  hash_ctx_save(ctx, &hash_ctx);
   return OTCRYPTO_OK;
 }
 
@@ -258,10 +604,27 @@ otcrypto_status_t otcrypto_hash_update(
   if (ctx == NULL || (input_message.data == NULL && input_message.len != 0)) {
     return OTCRYPTO_BAD_ARGS;
   }
-  hmac_ctx_t hmac_ctx;
-  hmac_ctx_restore(ctx, &hmac_ctx);
-  HARDENED_TRY(hmac_update(&hmac_ctx, input_message.data, input_message.len));
-  hmac_ctx_save(ctx, &hmac_ctx);
+  hash_ctx_t hash_ctx;
+  hash_ctx_restore(ctx, &hash_ctx);
+  switch (launder32(hash_ctx.mode)) {
+    case kOtcryptoHashModeSha256:
+      OT_FALLTHROUGH_INTENDED;
+    case kOtcryptoHashModeSha384:
+      OT_FALLTHROUGH_INTENDED;
+    case kOtcryptoHashModeSha512:
+      HARDENED_TRY(hmac_update(&hash_ctx.driver.hmac, input_message.data,
+                               input_message.len));
+      break;
+    default: {
+      // SHA-3 and XOF streams; rejects contexts of unknown modes.
+      kmac_stream_mode_t kmac_mode;
+      HARDENED_TRY(kmac_stream_mode_get(hash_ctx.mode, &kmac_mode));
+      HARDENED_TRY(kmac_stream_absorb(&hash_ctx.driver.kmac, input_message.data,
+                                      input_message.len));
+      break;
+    }
+  }
+  hash_ctx_save(ctx, &hash_ctx);
   return OTCRYPTO_OK;
 }
 
@@ -274,10 +637,131 @@ otcrypto_status_t otcrypto_hash_final(otcrypto_hash_context_t *const ctx,
   // Check that digest length and mode are consistent.
   HARDENED_TRY(check_digest_len(digest));
 
-  hmac_ctx_t hmac_ctx;
-  hmac_ctx_restore(ctx, &hmac_ctx);
-  HARDENED_TRY(hmac_final(&hmac_ctx, digest.data, digest.len));
+  hash_ctx_t hash_ctx;
+  hash_ctx_restore(ctx, &hash_ctx);
+  if (launder32(hash_ctx.mode) != digest.mode) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+  HARDENED_CHECK_EQ(hash_ctx.mode, digest.mode);
+
+  switch (digest.mode) {
+    case kOtcryptoHashModeSha256:
+      OT_FALLTHROUGH_INTENDED;
+    case kOtcryptoHashModeSha384:
+      OT_FALLTHROUGH_INTENDED;
+    case kOtcryptoHashModeSha512:
+      HARDENED_TRY(hmac_final(&hash_ctx.driver.hmac, digest.data, digest.len));
+      break;
+    case kOtcryptoHashModeSha3_224:
+      OT_FALLTHROUGH_INTENDED;
+    case kOtcryptoHashModeSha3_256:
+      OT_FALLTHROUGH_INTENDED;
+    case kOtcryptoHashModeSha3_384:
+      OT_FALLTHROUGH_INTENDED;
+    case kOtcryptoHashModeSha3_512:
+      HARDENED_TRY(
+          kmac_stream_squeeze(&hash_ctx.driver.kmac, digest.data, digest.len));
+      HARDENED_TRY(kmac_stream_final(&hash_ctx.driver.kmac));
+      break;
+    default:
+      return OTCRYPTO_BAD_ARGS;
+  }
   // TODO(#23191): Clear `ctx`.
-  hmac_ctx_save(ctx, &hmac_ctx);
+  hash_ctx_save(ctx, &hash_ctx);
+  return OTCRYPTO_OK;
+}
+
+otcrypto_status_t otcrypto_xof_shake_init(otcrypto_hash_context_t *const ctx,
+                                          otcrypto_hash_mode_t xof_mode) {
+  if (ctx == NULL) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+  if (xof_mode != kOtcryptoHashXofModeShake128 &&
+      xof_mode != kOtcryptoHashXofModeShake256) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+
+  hash_ctx_t hash_ctx;
+  hash_ctx.mode = xof_mode;
+  kmac_stream_mode_t kmac_mode;
+  HARDENED_TRY(kmac_stream_mode_get(xof_mode, &kmac_mode));
+  HARDENED_TRY(kmac_stream_init(&hash_ctx.driver.kmac, kmac_mode,
+                                /*func_name=*/NULL, /*func_name_len=*/0,
+                                /*cust_str=*/NULL, /*cust_str_len=*/0));
+  hash_ctx_save(ctx, &hash_ctx);
+  return OTCRYPTO_OK;
+}
+
+otcrypto_status_t otcrypto_xof_cshake_init(
+    otcrypto_hash_context_t *const ctx, otcrypto_hash_mode_t xof_mode,
+    otcrypto_const_byte_buf_t function_name_string,
+    otcrypto_const_byte_buf_t customization_string) {
+  if (ctx == NULL ||
+      (function_name_string.data == NULL && function_name_string.len != 0) ||
+      (customization_string.data == NULL && customization_string.len != 0)) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+
+  kmac_stream_mode_t kmac_mode;
+  switch (xof_mode) {
+    case kOtcryptoHashXofModeCshake128:
+      kmac_mode = kKmacStreamModeCshake128;
+      break;
+    case kOtcryptoHashXofModeCshake256:
+      kmac_mode = kKmacStreamModeCshake256;
+      break;
+    default:
+      return OTCRYPTO_BAD_ARGS;
+  }
+
+  // According to NIST SP 800-185 Section 3.2, cSHAKE call should use SHAKE, if
+  // both `customization_string` and `function_name_string` are empty string
+  if (customization_string.len == 0 && function_name_string.len == 0) {
+    kmac_mode = kmac_mode == kKmacStreamModeCshake128 ? kKmacStreamModeShake128
+                                                      : kKmacStreamModeShake256;
+  }
+
+  hash_ctx_t hash_ctx;
+  hash_ctx.mode = xof_mode;
+  HARDENED_TRY(kmac_stream_init(
+      &hash_ctx.driver.kmac, kmac_mode, function_name_string.data,
+      function_name_string.len, customization_string.data,
+      customization_string.len));
+  hash_ctx_save(ctx, &hash_ctx);
+  return OTCRYPTO_OK;
+}
+
+otcrypto_status_t otcrypto_xof_squeeze(otcrypto_hash_context_t *const ctx,
+                                       otcrypto_hash_digest_t digest) {
+  if (ctx == NULL || (digest.data == NULL && digest.len != 0)) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+
+  hash_ctx_t hash_ctx;
+  hash_ctx_restore(ctx, &hash_ctx);
+  if (!is_xof_mode(digest.mode) || launder32(hash_ctx.mode) != digest.mode) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+  HARDENED_CHECK_EQ(hash_ctx.mode, digest.mode);
+
+  HARDENED_TRY(
+      kmac_stream_squeeze(&hash_ctx.driver.kmac, digest.data, digest.len));
+  hash_ctx_save(ctx, &hash_ctx);
+  return OTCRYPTO_OK;
+}
+
+otcrypto_status_t otcrypto_xof_final(otcrypto_hash_context_t *const ctx) {
+  if (ctx == NULL) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+
+  hash_ctx_t hash_ctx;
+  hash_ctx_restore(ctx, &hash_ctx);
+  if (!is_xof_mode(hash_ctx.mode)) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+
+  HARDENED_TRY(kmac_stream_final(&hash_ctx.driver.kmac));
+  hash_ctx_save(ctx, &hash_ctx);
   return OTCRYPTO_OK;
 }
@@ -6,18 +6,147 @@
 
 #include "sw/device/lib/base/hardened.h"
 
+// Key checksums are a CRC-32 (the IEEE 802.3 polynomial, bit-reflected)
+// computed one 32-bit word at a time. With Zbc (carry-less multiplication),
+// each word costs two multiplications; otherwise a 16-entry table is used,
+// which keeps the code small at the cost of eight lookups per word. Defining
+// `OTCRYPTO_INTEGRITY_TABLE` forces the table, for benchmarking.
+#if !defined(OTCRYPTO_INTEGRITY_TABLE) && \
+    (defined(__riscv_zbc) || defined(__riscv_zbkc))
+#define OTCRYPTO_INTEGRITY_CLMUL 1
+#endif
+
+enum {
+  /**
+   * Initial CRC value.
+   */
+  kIntegrityCrcInit = UINT32_MAX,
+  /**
+   * First word of the checksum of an unblinded key.
+   *
+   * Distinct from `kIntegrityBlindedDomain` so that the checksum of one kind
+   * of key is never valid for the other.
+   */
+  kIntegrityUnblindedDomain = 0x5a3c96e1,
+  /**
+   * First word of the checksum of a blinded key.
+   */
+  kIntegrityBlindedDomain = 0xa5c3691e,
+};
+
+#ifdef OTCRYPTO_INTEGRITY_CLMUL
+enum {
+  /**
+   * Bit-reflected Barrett constant: (floor(x^64 / P) << 1) | 1, where P is the
+   * CRC-32 polynomial.
+   */
+  kIntegrityCrcBarrettMu = 0xf7011641,
+  /**
+   * Bit-reflected CRC-32 polynomial, without its x^32 term.
+   */
+  kIntegrityCrcPoly = 0xedb88320,
+};
+
+/**
+ * Adds a word to a CRC-32.
+ *
+ * Reduces `(ctx ^ word) * x^32` modulo the polynomial with Barrett reduction
+ * in the bit-reflected domain, as `crc32.c` does for its clmul backend.
+ *
+ * @param ctx Current CRC value.
+ * @param word Word to add.
+ * @return Updated CRC value.
+ */
+static inline uint32_t crc_add32(uint32_t ctx, uint32_t word) {
+  uint32_t quotient;
+  ctx ^= word;
+  asm("clmul %0, %1, %2"
+      : "=r"(quotient)
+      : "r"(ctx), "r"(kIntegrityCrcBarrettMu));
+  asm("clmulr %0, %1, %2" : "=r"(ctx) : "r"(quotient), "r"(kIntegrityCrcPoly));
+  return ctx;
+}
+#else
+/**
+ * CRC-32 of each 4-bit value, for the bit-reflected polynomial 0xedb88320.
+ */
+static const uint32_t kIntegrityCrcTable[16] = {
+    0x00000000, 0x1db71064, 0x3b6e20c8, 0x26d930ac, 0x76dc4190, 0x6b6b51f4,
+    0x4db26158, 0x5005713c, 0xedb88320, 0xf00f9344, 0xd6d6a3e8, 0xcb61b38c,
+    0x9b64c2b0, 0x86d3d2d4, 0xa00ae278, 0xbdbdf21c,
+};
+
+/**
+ * Adds a word to a CRC-32.
+ *
+ * @param ctx Current CRC value.
+ * @param word Word to add.
+ * @return Updated CRC value.
+ */
+static inline uint32_t crc_add32(uint32_t ctx, uint32_t word) {
+  ctx ^= word;
+  for (size_t i = 0; i < 8; i++) {
+    ctx = (ctx >> 4) ^ kIntegrityCrcTable[ctx & 0xf];
+  }
+  return ctx;
+}
+#endif
+
+/**
+ * Adds key material to a CRC-32.
+ *
+ * The material is read a word at a time. If the length is not a multiple of
+ * the word size, the unused bytes of the last word are ignored. The length
+ * itself is added first, so zeros at the end are still detected.
+ *
+ * @param ctx Current CRC value.
+ * @param data Key material (may be NULL).
+ * @param len Length of the key material in bytes.
+ * @return Updated CRC value.
+ */
+static uint32_t crc_add_key_material(uint32_t ctx, const uint32_t *data,
+                                     size_t len) {
+  ctx = crc_add32(ctx, (uint32_t)len);
+  if (data == NULL) {
+    // Nothing to read; the checksum of a key with material will differ.
+    return crc_add32(ctx, UINT32_MAX);
+  }
+
+  size_t num_words = len / sizeof(uint32_t);
+  size_t i = 0;
+  for (; launder32(i) < num_words; i++) {
+    ctx = crc_add32(ctx, data[i]);
+  }
+  HARDENED_CHECK_EQ(i, num_words);
+
+  size_t rem_bytes = len % sizeof(uint32_t);
+  if (rem_bytes != 0) {
+    // Keep only the low (first, little-endian) bytes of the last word.
+    uint32_t mask = (UINT32_C(1) << (rem_bytes * 8)) - 1;
+    ctx = crc_add32(ctx, data[num_words] & mask);
+  }
+  return ctx;
+}
+
 uint32_t integrity_unblinded_checksum(const otcrypto_unblinded_key_t *key) {
-  // TODO: decide on a checksum algorithm and implement integrity checks.
-  // TODO: maybe check the key length to make sure it's not pushing UINT32_MAX,
-  // as an overflow protection.
-  return 0;
+  uint32_t ctx = kIntegrityCrcInit;
+  ctx = crc_add32(ctx, kIntegrityUnblindedDomain);
+  ctx = crc_add32(ctx, key->key_mode);
+  ctx = crc_add_key_material(ctx, key->key, key->key_length);
+  return ~ctx;
 }
 
 uint32_t integrity_blinded_checksum(const otcrypto_blinded_key_t *key) {
-  // TODO: decide on a checksum algorithm and implement integrity checks.
-  // TODO: maybe check the key length to make sure it's not pushing UINT32_MAX,
-  // as an overflow protection.
-  return 0;
+  uint32_t ctx = kIntegrityCrcInit;
+  ctx = crc_add32(ctx, kIntegrityBlindedDomain);
+  ctx = crc_add32(ctx, key->config.version);
+  ctx = crc_add32(ctx, key->config.key_mode);
+  ctx = crc_add32(ctx, (uint32_t)key->config.key_length);
+  ctx = crc_add32(ctx, key->config.hw_backed);
+  ctx = crc_add32(ctx, key->config.exportable);
+  ctx = crc_add32(ctx, key->config.security_level);
+  ctx = crc_add_key_material(ctx, key->keyblob, key->keyblob_length);
+  return ~ctx;
 }
 
 hardened_bool_t integrity_unblinded_key_check(
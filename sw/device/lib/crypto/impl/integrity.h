@@ -16,6 +16,12 @@
 extern "C" {
 #endif  // __cplusplus
 
+/**
+ * Key checksums are a CRC-32 over the key metadata and key material. They
+ * detect accidental or fault-induced corruption of a key struct; they are not
+ * a MAC and do not protect against deliberate modification.
+ */
+
 /**
  * Compute the checksum of an unblinded key.
  *
@@ -60,6 +60,110 @@ static status_t digest_num_words_from_key_mode(otcrypto_key_mode_t key_mode,
   return OTCRYPTO_OK;
 }
 
+/**
+ * Generate keying material with HMAC in counter mode.
+ *
+ * Computes the concatenation of HMAC(K, [i]_2 || Label || 0x00 || Context ||
+ * [L]_2) for i = 1, 2, ... (see NIST SP 800-108r1, section 4.1), where [i]_2
+ * and [L]_2 are 32-bit big-endian encodings of the counter and of
+ * `required_byte_len` in bits. The key derivation key is processed only once;
+ * each counter block starts from a copy of the initialized HMAC context.
+ *
+ * The caller must check the inputs and ensure that `keying_material_data` has
+ * room for `ceil(required_byte_len / (4 * digest_word_len))` digests.
+ *
+ * @param key_derivation_key Blinded key derivation key.
+ * @param kdf_label Label string.
+ * @param kdf_context Context string.
+ * @param required_byte_len Length L of the keying material in bytes.
+ * @param digest_word_len Digest length of the HMAC hash function in words.
+ * @param[out] keying_material_data Destination for the keying material.
+ * @return OK or error.
+ */
+static status_t hmac_ctr_generate(
+    const otcrypto_blinded_key_t *key_derivation_key,
+    const otcrypto_const_byte_buf_t kdf_label,
+    const otcrypto_const_byte_buf_t kdf_context, size_t required_byte_len,
+    size_t digest_word_len, uint32_t *keying_material_data) {
+  uint8_t zero = 0x00;
+  HARDENED_CHECK_LE(required_byte_len, UINT32_MAX / 8);
+  uint32_t required_bit_len = __builtin_bswap32(required_byte_len * 8);
+  size_t num_iterations = ceil_div(
+      ceil_div(required_byte_len, sizeof(uint32_t)), digest_word_len);
+
+  otcrypto_hmac_context_t key_ctx;
+  HARDENED_TRY(otcrypto_hmac_init(&key_ctx, key_derivation_key));
+
+  for (uint32_t i = 0; i < num_iterations; i++) {
+    otcrypto_hmac_context_t ctx = key_ctx;
+    uint32_t counter_be = __builtin_bswap32(i + 1);
+    HARDENED_TRY(otcrypto_hmac_update(
+        &ctx, (otcrypto_const_byte_buf_t){
+                  .data = (const unsigned char *const)&counter_be,
+                  .len = sizeof(counter_be)}));
+    HARDENED_TRY(otcrypto_hmac_update(&ctx, kdf_label));
+    HARDENED_TRY(otcrypto_hmac_update(
+        &ctx,
+        (otcrypto_const_byte_buf_t){.data = (const unsigned char *const)&zero,
+                                    .len = sizeof(zero)}));
+    HARDENED_TRY(otcrypto_hmac_update(&ctx, kdf_context));
+    HARDENED_TRY(otcrypto_hmac_update(
+        &ctx, (otcrypto_const_byte_buf_t){
+                  .data = (const unsigned char *const)&required_bit_len,
+                  .len = sizeof(required_bit_len)}));
+    uint32_t *tag_dest = keying_material_data + i * digest_word_len;
+    HARDENED_TRY(otcrypto_hmac_final(
+        &ctx,
+        (otcrypto_word32_buf_t){.data = tag_dest, .len = digest_word_len}));
+  }
+  return OTCRYPTO_OK;
+}
+
+/**
+ * Check the output keys of a multi-output KDF and sum up their lengths.
+ *
+ * Every key must be a non-hardware-backed key with a keyblob of the expected
+ * length. If `word_aligned` is set, every key length must also be a multiple
+ * of the word size.
+ *
+ * @param keying_materials Output keys.
+ * @param num_keys Number of output keys.
+ * @param word_aligned Whether key lengths must be multiples of 4 bytes.
+ * @param[out] total_byte_len Sum of the key lengths in bytes.
+ * @return OK or error.
+ */
+static status_t multi_output_check(
+    otcrypto_blinded_key_t *const *keying_materials, size_t num_keys,
+    bool word_aligned, size_t *total_byte_len) {
+  if (keying_materials == NULL || num_keys == 0) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+  *total_byte_len = 0;
+  for (size_t i = 0; i < num_keys; i++) {
+    const otcrypto_blinded_key_t *km = keying_materials[i];
+    if (km == NULL || km->keyblob == NULL || km->config.key_length == 0) {
+      return OTCRYPTO_BAD_ARGS;
+    }
+    if (launder32(km->config.hw_backed) != kHardenedBoolFalse) {
+      return OTCRYPTO_BAD_ARGS;
+    }
+    HARDENED_CHECK_EQ(km->config.hw_backed, kHardenedBoolFalse);
+    HARDENED_TRY(keyblob_ensure_xor_masked(km->config));
+    if (km->keyblob_length !=
+        keyblob_num_words(km->config) * sizeof(uint32_t)) {
+      return OTCRYPTO_BAD_ARGS;
+    }
+    if (word_aligned && km->config.key_length % sizeof(uint32_t) != 0) {
+      return OTCRYPTO_NOT_IMPLEMENTED;
+    }
+    if (km->config.key_length > UINT32_MAX / 8 - *total_byte_len) {
+      return OTCRYPTO_BAD_ARGS;
+    }
+    *total_byte_len += km->config.key_length;
+  }
+  return OTCRYPTO_OK;
+}
+
 otcrypto_status_t otcrypto_kdf_hmac_ctr(
     const otcrypto_blinded_key_t key_derivation_key,
     const otcrypto_const_byte_buf_t kdf_label,
@@ -138,45 +242,12 @@ otcrypto_status_t otcrypto_kdf_hmac_ctr(
   HARDENED_TRY(check_zero_byte(kdf_label));
   HARDENED_TRY(check_zero_byte(kdf_context));
 
-  // Setup
-  uint8_t zero = 0x00;
-  HARDENED_CHECK_LE(required_byte_len, UINT32_MAX / 8);
-  uint32_t required_bit_len = __builtin_bswap32(required_byte_len * 8);
-
-  // Repeatedly call HMAC to generate the derived key based on input data:
-  // [i]_2 || Label || 0x00 || Context || [L]_2
-  // (see NIST SP 800-108r1, section 4.1)
-  // [i]_2 is the binary representation of the counter value
-  // [L]_2 is the binary representation of the required bit length
-  // The counter value is updated within the loop
-
   uint32_t keying_material_len =
       required_word_len + digest_word_len - required_word_len % digest_word_len;
   uint32_t keying_material_data[keying_material_len];
-
-  for (uint32_t i = 0; i < num_iterations; i++) {
-    otcrypto_hmac_context_t ctx;
-    HARDENED_TRY(otcrypto_hmac_init(&ctx, &key_derivation_key));
-    uint32_t counter_be = __builtin_bswap32(i + 1);
-    HARDENED_TRY(otcrypto_hmac_update(
-        &ctx, (otcrypto_const_byte_buf_t){
-                  .data = (const unsigned char *const)&counter_be,
-                  .len = sizeof(counter_be)}));
-    HARDENED_TRY(otcrypto_hmac_update(&ctx, kdf_label));
-    HARDENED_TRY(otcrypto_hmac_update(
-        &ctx,
-        (otcrypto_const_byte_buf_t){.data = (const unsigned char *const)&zero,
-                                    .len = sizeof(zero)}));
-    HARDENED_TRY(otcrypto_hmac_update(&ctx, kdf_context));
-    HARDENED_TRY(otcrypto_hmac_update(
-        &ctx, (otcrypto_const_byte_buf_t){
-                  .data = (const unsigned char *const)&required_bit_len,
-                  .len = sizeof(required_bit_len)}));
-    uint32_t *tag_dest = keying_material_data + i * digest_word_len;
-    HARDENED_TRY(otcrypto_hmac_final(
-        &ctx,
-        (otcrypto_word32_buf_t){.data = tag_dest, .len = digest_word_len}));
-  }
+  HARDENED_TRY(hmac_ctr_generate(&key_derivation_key, kdf_label, kdf_context,
+                                 required_byte_len, digest_word_len,
+                                 keying_material_data));
 
   // Generate a mask (all-zero for now, since HMAC is unhardened anyway).
   uint32_t mask[digest_word_len];
@@ -192,17 +263,28 @@ otcrypto_status_t otcrypto_kdf_hmac_ctr(
   return OTCRYPTO_OK;
 }
 
-otcrypto_status_t otcrypto_kdf_kmac(
-    const otcrypto_blinded_key_t key_derivation_key,
+/**
+ * Generate keying material with a single KMAC invocation.
+ *
+ * Checks and loads the key derivation key (requesting a sideloaded key from
+ * keymgr if it is hardware-backed), then computes
+ * KMAC(K, Context, L, Label) (see NIST SP 800-108r1, section 4.4) with L set
+ * to `digest_words` words. The output is written in two shares, so `digest`
+ * must have room for `2 * digest_words` words.
+ *
+ * @param key_derivation_key Blinded key derivation key.
+ * @param kmac_mode Either KMAC128 or KMAC256 as PRF.
+ * @param kdf_label Label string.
+ * @param kdf_context Context string.
+ * @param[out] digest Destination for the masked keying material.
+ * @param digest_words Length of the keying material in words.
+ * @return OK or error.
+ */
+static status_t kdf_kmac_generate(
+    const otcrypto_blinded_key_t *key_derivation_key,
     otcrypto_kmac_mode_t kmac_mode, const otcrypto_const_byte_buf_t kdf_label,
-    const otcrypto_const_byte_buf_t kdf_context, size_t required_byte_len,
-    otcrypto_blinded_key_t *keying_material) {
-  // Check NULL pointers.
-  if (key_derivation_key.keyblob == NULL || keying_material == NULL ||
-      keying_material->keyblob == NULL) {
-    return OTCRYPTO_BAD_ARGS;
-  }
-
+    const otcrypto_const_byte_buf_t kdf_context, uint32_t *digest,
+    size_t digest_words) {
   // Check for null label with nonzero length.
   if (kdf_label.data == NULL && kdf_label.len != 0) {
     return OTCRYPTO_BAD_ARGS;
@@ -219,25 +301,26 @@ otcrypto_status_t otcrypto_kdf_kmac(
   }
 
   // Check the private key checksum.
-  if (integrity_blinded_key_check(&key_derivation_key) != kHardenedBoolTrue) {
+  if (integrity_blinded_key_check(key_derivation_key) != kHardenedBoolTrue) {
     return OTCRYPTO_BAD_ARGS;
   }
 
   // Check `key_len` is supported by KMAC HWIP.
   // The set of supported key sizes is {128, 192, 256, 384, 512).
-  HARDENED_TRY(kmac_key_length_check(key_derivation_key.config.key_length));
+  HARDENED_TRY(kmac_key_length_check(key_derivation_key->config.key_length));
 
   kmac_blinded_key_t kmac_key = {
       .share0 = NULL,
       .share1 = NULL,
-      .hw_backed = key_derivation_key.config.hw_backed,
-      .len = key_derivation_key.config.key_length,
+      .hw_backed = key_derivation_key->config.hw_backed,
+      .len = key_derivation_key->config.key_length,
   };
   // Validate key length of `key_derivation_key`.
-  if (key_derivation_key.config.hw_backed == kHardenedBoolTrue) {
+  if (key_derivation_key->config.hw_backed == kHardenedBoolTrue) {
     // Check that 1) key size matches sideload port size, 2) keyblob length
     // matches diversification length.
-    if (keyblob_share_num_words(key_derivation_key.config) * sizeof(uint32_t) !=
+    if (keyblob_share_num_words(key_derivation_key->config) *
+            sizeof(uint32_t) !=
         kKmacSideloadKeyLength / 8) {
       return OTCRYPTO_BAD_ARGS;
     }
@@ -246,20 +329,69 @@ otcrypto_status_t otcrypto_kdf_kmac(
     keymgr_diversification_t diversification;
     // Diversification call also checks that `key_derivation_key.keyblob_length`
     // is 8 words long.
-    HARDENED_TRY(keyblob_to_keymgr_diversification(&key_derivation_key,
+    HARDENED_TRY(keyblob_to_keymgr_diversification(key_derivation_key,
                                                    &diversification));
     HARDENED_TRY(keymgr_generate_key_kmac(diversification));
-  } else if (key_derivation_key.config.hw_backed == kHardenedBoolFalse) {
-    if (key_derivation_key.keyblob_length !=
-        keyblob_num_words(key_derivation_key.config) * sizeof(uint32_t)) {
+  } else if (key_derivation_key->config.hw_backed == kHardenedBoolFalse) {
+    if (key_derivation_key->keyblob_length !=
+        keyblob_num_words(key_derivation_key->config) * sizeof(uint32_t)) {
       return OTCRYPTO_BAD_ARGS;
     }
-    HARDENED_TRY(keyblob_to_shares(&key_derivation_key, &kmac_key.share0,
+    HARDENED_TRY(keyblob_to_shares(key_derivation_key, &kmac_key.share0,
                                    &kmac_key.share1));
   } else {
     return OTCRYPTO_BAD_ARGS;
   }
 
+  if (kmac_mode == kOtcryptoKmacModeKmac128) {
+    // Check if `key_mode` of the key derivation key matches `kmac_mode`.
+    if (key_derivation_key->config.key_mode != kOtcryptoKeyModeKdfKmac128) {
+      return OTCRYPTO_BAD_ARGS;
+    }
+    // No need to further check key size against security level because
+    // `kmac_key_length_check` ensures that the key is at least 128-bit.
+    HARDENED_TRY(kmac_kmac_128(&kmac_key, /*masked_digest=*/kHardenedBoolTrue,
+                               kdf_context.data, kdf_context.len,
+                               kdf_label.data, kdf_label.len, digest,
+                               digest_words));
+  } else if (kmac_mode == kOtcryptoKmacModeKmac256) {
+    // Check if `key_mode` of the key derivation key matches `kmac_mode`.
+    if (key_derivation_key->config.key_mode != kOtcryptoKeyModeKdfKmac256) {
+      return OTCRYPTO_BAD_ARGS;
+    }
+    // Check that key size matches the security strength. It should be at least
+    // 256-bit.
+    if (key_derivation_key->config.key_length < 256 / 8) {
+      return OTCRYPTO_BAD_ARGS;
+    }
+    HARDENED_TRY(kmac_kmac_256(&kmac_key, /*masked_digest=*/kHardenedBoolTrue,
+                               kdf_context.data, kdf_context.len,
+                               kdf_label.data, kdf_label.len, digest,
+                               digest_words));
+  } else {
+    return OTCRYPTO_BAD_ARGS;
+  }
+
+  if (key_derivation_key->config.hw_backed == kHardenedBoolTrue) {
+    HARDENED_TRY(keymgr_sideload_clear_kmac());
+  } else if (key_derivation_key->config.hw_backed != kHardenedBoolFalse) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+
+  return OTCRYPTO_OK;
+}
+
+otcrypto_status_t otcrypto_kdf_kmac(
+    const otcrypto_blinded_key_t key_derivation_key,
+    otcrypto_kmac_mode_t kmac_mode, const otcrypto_const_byte_buf_t kdf_label,
+    const otcrypto_const_byte_buf_t kdf_context, size_t required_byte_len,
+    otcrypto_blinded_key_t *keying_material) {
+  // Check NULL pointers.
+  if (key_derivation_key.keyblob == NULL || keying_material == NULL ||
+      keying_material->keyblob == NULL) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+
   // Check non-zero length for keying_material.
   if (required_byte_len == 0) {
     return OTCRYPTO_BAD_ARGS;
@@ -284,43 +416,131 @@ otcrypto_status_t otcrypto_kdf_kmac(
     return OTCRYPTO_BAD_ARGS;
   }
 
-  if (kmac_mode == kOtcryptoKmacModeKmac128) {
-    // Check if `key_mode` of the key derivation key matches `kmac_mode`.
-    if (key_derivation_key.config.key_mode != kOtcryptoKeyModeKdfKmac128) {
-      return OTCRYPTO_BAD_ARGS;
-    }
-    // No need to further check key size against security level because
-    // `kmac_key_length_check` ensures that the key is at least 128-bit.
-    HARDENED_TRY(kmac_kmac_128(
-        &kmac_key, /*masked_digest=*/kHardenedBoolTrue, kdf_context.data,
-        kdf_context.len, kdf_label.data, kdf_label.len,
-        keying_material->keyblob, required_byte_len / sizeof(uint32_t)));
-  } else if (kmac_mode == kOtcryptoKmacModeKmac256) {
-    // Check if `key_mode` of the key derivation key matches `kmac_mode`.
-    if (key_derivation_key.config.key_mode != kOtcryptoKeyModeKdfKmac256) {
-      return OTCRYPTO_BAD_ARGS;
-    }
-    // Check that key size matches the security strength. It should be at least
-    // 256-bit.
-    if (key_derivation_key.config.key_length < 256 / 8) {
-      return OTCRYPTO_BAD_ARGS;
+  // The masked KMAC output has the same layout as an XOR-masked keyblob, so it
+  // can be written to the keyblob directly.
+  HARDENED_TRY(kdf_kmac_generate(&key_derivation_key, kmac_mode, kdf_label,
+                                 kdf_context, keying_material->keyblob,
+                                 required_byte_len / sizeof(uint32_t)));
+
+  keying_material->checksum = integrity_blinded_checksum(keying_material);
+
+  return OTCRYPTO_OK;
+}
+
+otcrypto_status_t otcrypto_kdf_hmac_ctr_multi(
+    const otcrypto_blinded_key_t key_derivation_key,
+    const otcrypto_const_byte_buf_t kdf_label,
+    const otcrypto_const_byte_buf_t kdf_context,
+    otcrypto_blinded_key_t *const *keying_materials, size_t num_keys) {
+  // Check NULL pointers.
+  if (key_derivation_key.keyblob == NULL) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+
+  // Check the output keys and get the total length L of the keying material.
+  size_t total_byte_len;
+  HARDENED_TRY(multi_output_check(keying_materials, num_keys,
+                                  /*word_aligned=*/false, &total_byte_len));
+
+  // The underlying HMAC implementation is not currently hardened.
+  if (launder32(key_derivation_key.config.security_level) !=
+      kOtcryptoKeySecurityLevelLow) {
+    return OTCRYPTO_NOT_IMPLEMENTED;
+  }
+  for (size_t i = 0; i < num_keys; i++) {
+    if (launder32(keying_materials[i]->config.security_level) !=
+        kOtcryptoKeySecurityLevelLow) {
+      return OTCRYPTO_NOT_IMPLEMENTED;
     }
-    HARDENED_TRY(kmac_kmac_256(
-        &kmac_key, /*masked_digest=*/kHardenedBoolTrue, kdf_context.data,
-        kdf_context.len, kdf_label.data, kdf_label.len,
-        keying_material->keyblob, required_byte_len / sizeof(uint32_t)));
-  } else {
+  }
+
+  // Check for null label or context with nonzero length.
+  if ((kdf_label.data == NULL && kdf_label.len != 0) ||
+      (kdf_context.data == NULL && kdf_context.len != 0)) {
     return OTCRYPTO_BAD_ARGS;
   }
 
-  keying_material->checksum = integrity_blinded_checksum(keying_material);
+  // Check the private key checksum.
+  if (integrity_blinded_key_check(&key_derivation_key) != kHardenedBoolTrue) {
+    return OTCRYPTO_BAD_ARGS;
+  }
 
-  if (key_derivation_key.config.hw_backed == kHardenedBoolTrue) {
-    HARDENED_TRY(keymgr_sideload_clear_kmac());
-  } else if (key_derivation_key.config.hw_backed != kHardenedBoolFalse) {
+  // Infer the digest size.
+  size_t digest_word_len = 0;
+  HARDENED_TRY(digest_num_words_from_key_mode(
+      key_derivation_key.config.key_mode, &digest_word_len));
+
+  // 0x00 separates label and context, so neither may contain it.
+  HARDENED_TRY(check_zero_byte(kdf_label));
+  HARDENED_TRY(check_zero_byte(kdf_context));
+
+  // Derive all of the keying material in one pass.
+  size_t num_iterations = ceil_div(
+      ceil_div(total_byte_len, sizeof(uint32_t)), digest_word_len);
+  uint32_t keying_material_data[num_iterations * digest_word_len];
+  HARDENED_TRY(hmac_ctr_generate(&key_derivation_key, kdf_label, kdf_context,
+                                 total_byte_len, digest_word_len,
+                                 keying_material_data));
+
+  // Split it into the output keys in order (NIST SP 800-108r1, section 5).
+  const unsigned char *km_bytes = (const unsigned char *)keying_material_data;
+  size_t offset = 0;
+  for (size_t i = 0; i < num_keys; i++) {
+    otcrypto_blinded_key_t *km = keying_materials[i];
+    size_t key_words = keyblob_share_num_words(km->config);
+    uint32_t key[key_words];
+    // Generate a mask (all-zero for now, since HMAC is unhardened anyway).
+    uint32_t mask[key_words];
+    memset(key, 0, sizeof(key));
+    memset(mask, 0, sizeof(mask));
+    memcpy(key, km_bytes + offset, km->config.key_length);
+    HARDENED_TRY(
+        keyblob_from_key_and_mask(key, mask, km->config, km->keyblob));
+    km->checksum = integrity_blinded_checksum(km);
+    offset += km->config.key_length;
+  }
+  HARDENED_CHECK_EQ(offset, total_byte_len);
+
+  return OTCRYPTO_OK;
+}
+
+otcrypto_status_t otcrypto_kdf_kmac_multi(
+    const otcrypto_blinded_key_t key_derivation_key,
+    otcrypto_kmac_mode_t kmac_mode, const otcrypto_const_byte_buf_t kdf_label,
+    const otcrypto_const_byte_buf_t kdf_context,
+    otcrypto_blinded_key_t *const *keying_materials, size_t num_keys) {
+  // Check NULL pointers.
+  if (key_derivation_key.keyblob == NULL) {
     return OTCRYPTO_BAD_ARGS;
   }
 
+  // Check the output keys and get the total length L of the keying material.
+  // At the moment, `kmac_kmac_128/256` only supports word-sized digest lenghts,
+  // so each key must be a whole number of words.
+  size_t total_byte_len;
+  HARDENED_TRY(multi_output_check(keying_materials, num_keys,
+                                  /*word_aligned=*/true, &total_byte_len));
+
+  // Squeeze all of the keying material in one KMAC operation, as two shares.
+  size_t total_words = total_byte_len / sizeof(uint32_t);
+  uint32_t keying_material_data[2 * total_words];
+  HARDENED_TRY(kdf_kmac_generate(&key_derivation_key, kmac_mode, kdf_label,
+                                 kdf_context, keying_material_data,
+                                 total_words));
+
+  // Split it into the output keys in order (NIST SP 800-108r1, section 5),
+  // keeping it masked.
+  size_t offset = 0;
+  for (size_t i = 0; i < num_keys; i++) {
+    otcrypto_blinded_key_t *km = keying_materials[i];
+    keyblob_from_shares(&keying_material_data[offset],
+                        &keying_material_data[total_words + offset],
+                        km->config, km->keyblob);
+    km->checksum = integrity_blinded_checksum(km);
+    offset += km->config.key_length / sizeof(uint32_t);
+  }
+  HARDENED_CHECK_EQ(offset, total_words);
+
   return OTCRYPTO_OK;
 }
 
@@ -483,6 +703,7 @@ otcrypto_status_t otcrypto_kdf_hkdf_extract(const otcrypto_blinded_key_t ikm,
       .keyblob = salt_keyblob,
       .keyblob_length = sizeof(salt_keyblob),
   };
+  salt_key.checksum = integrity_blinded_checksum(&salt_key);
 
   // Call HMAC(salt, IKM).
   uint32_t tag_data[digest_words];
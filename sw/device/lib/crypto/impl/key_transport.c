@@ -85,6 +85,22 @@ otcrypto_status_t otcrypto_hw_backed_key(uint32_t version,
   return OTCRYPTO_OK;
 }
 
+otcrypto_status_t otcrypto_sideload_session_start(
+    const otcrypto_blinded_key_t *key) {
+  if (key == NULL || key->keyblob == NULL) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+  if (launder32(integrity_blinded_key_check(key)) != kHardenedBoolTrue) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+  HARDENED_CHECK_EQ(integrity_blinded_key_check(key), kHardenedBoolTrue);
+  return keyblob_sideload_session_start(key);
+}
+
+otcrypto_status_t otcrypto_sideload_session_end(void) {
+  return keyblob_sideload_session_end();
+}
+
 otcrypto_status_t otcrypto_wrapped_key_len(const otcrypto_key_config_t config,
                                            size_t *wrapped_num_words) {
   // Check that the total wrapped key length will fit in 32 bits.
@@ -161,11 +177,19 @@ static status_t aes_kwp_key_construct(const otcrypto_blinded_key_t *key_kek,
   return OTCRYPTO_OK;
 }
 
-otcrypto_status_t otcrypto_key_wrap(const otcrypto_blinded_key_t *key_to_wrap,
-                                    const otcrypto_blinded_key_t *key_kek,
-                                    otcrypto_word32_buf_t wrapped_key) {
-  if (key_to_wrap == NULL || key_to_wrap->keyblob == NULL || key_kek == NULL ||
-      key_kek->keyblob == NULL || wrapped_key.data == NULL) {
+/**
+ * Checks a key to wrap and the buffer for the wrapped key.
+ *
+ * @param key_to_wrap Blinded key that will be encrypted.
+ * @param wrapped_key Buffer for the encrypted key data.
+ * @param[out] plaintext_words Length of the plaintext to wrap (32-bit words).
+ * @return Result of the operation.
+ */
+static status_t key_wrap_check(const otcrypto_blinded_key_t *key_to_wrap,
+                               otcrypto_word32_buf_t wrapped_key,
+                               size_t *plaintext_words) {
+  if (key_to_wrap == NULL || key_to_wrap->keyblob == NULL ||
+      wrapped_key.data == NULL) {
     return OTCRYPTO_BAD_ARGS;
   }
 
@@ -184,11 +208,6 @@ otcrypto_status_t otcrypto_key_wrap(const otcrypto_blinded_key_t *key_to_wrap,
     return OTCRYPTO_BAD_ARGS;
   }
 
-  // Check the integrity/lengths/mode of the key encryption key, and construct
-  // an internal AES key.
-  aes_key_t kek;
-  HARDENED_TRY(aes_kwp_key_construct(key_kek, &kek));
-
   // Check the keyblob length.
   uint32_t keyblob_words = keyblob_num_words(key_to_wrap->config);
   if (key_to_wrap->keyblob_length != keyblob_words * sizeof(uint32_t)) {
@@ -200,21 +219,135 @@ otcrypto_status_t otcrypto_key_wrap(const otcrypto_blinded_key_t *key_to_wrap,
     return OTCRYPTO_BAD_ARGS;
   }
 
-  // Create the plaintext by copying the key configuration, checksum, keyblob
-  // length, and keyblob into a buffer.
   uint32_t config_words = sizeof(otcrypto_key_config_t) / sizeof(uint32_t);
-  size_t plaintext_num_words = config_words + 2 + keyblob_words;
-  uint32_t plaintext[plaintext_num_words];
+  *plaintext_words = config_words + 2 + keyblob_words;
+  return OTCRYPTO_OK;
+}
+
+/**
+ * Creates the plaintext to wrap for a key.
+ *
+ * The plaintext is the key configuration, checksum, keyblob length, and
+ * keyblob. The key must have been checked with `key_wrap_check`.
+ *
+ * @param key_to_wrap Blinded key that will be encrypted.
+ * @param[out] plaintext Buffer for the plaintext.
+ */
+static void key_wrap_plaintext(const otcrypto_blinded_key_t *key_to_wrap,
+                               uint32_t *plaintext) {
+  uint32_t config_words = sizeof(otcrypto_key_config_t) / sizeof(uint32_t);
+  uint32_t keyblob_words = keyblob_num_words(key_to_wrap->config);
   hardened_memcpy(plaintext, (uint32_t *)&key_to_wrap->config, config_words);
   plaintext[config_words] = key_to_wrap->checksum;
   plaintext[config_words + 1] = keyblob_words;
   hardened_memcpy(plaintext + config_words + 2, key_to_wrap->keyblob,
                   keyblob_words);
+}
+
+/**
+ * Extracts an unwrapped key from the plaintext created by
+ * `key_wrap_plaintext`.
+ *
+ * @param plaintext Successfully unwrapped plaintext.
+ * @param[out] success Whether the unwrapped key is valid.
+ * @param[out] unwrapped_key Decrypted key data.
+ * @return Result of the operation.
+ */
+static status_t key_unwrap_extract(const uint32_t *plaintext,
+                                   hardened_bool_t *success,
+                                   otcrypto_blinded_key_t *unwrapped_key) {
+  *success = kHardenedBoolFalse;
+
+  // Extract the key configuration.
+  uint32_t config_words = sizeof(otcrypto_key_config_t) / sizeof(uint32_t);
+  hardened_memcpy((uint32_t *)&unwrapped_key->config, plaintext, config_words);
+
+  // Extract the checksum and keyblob length.
+  unwrapped_key->checksum = plaintext[config_words];
+  uint32_t keyblob_words = plaintext[config_words + 1];
+  if (keyblob_words != keyblob_num_words(unwrapped_key->config)) {
+    *success = kHardenedBoolFalse;
+    return OTCRYPTO_OK;
+  }
+
+  // Extract the keyblob.
+  if (unwrapped_key->keyblob_length != keyblob_words * sizeof(uint32_t)) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+  hardened_memcpy(unwrapped_key->keyblob, plaintext + config_words + 2,
+                  keyblob_words);
+
+  // Finally, check the integrity of the key material we unwrapped.
+  *success = integrity_blinded_key_check(unwrapped_key);
+  return OTCRYPTO_OK;
+}
+
+otcrypto_status_t otcrypto_key_wrap(const otcrypto_blinded_key_t *key_to_wrap,
+                                    const otcrypto_blinded_key_t *key_kek,
+                                    otcrypto_word32_buf_t wrapped_key) {
+  if (key_kek == NULL || key_kek->keyblob == NULL) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+
+  // Check the key we are wrapping and the output buffer.
+  size_t plaintext_num_words;
+  HARDENED_TRY(key_wrap_check(key_to_wrap, wrapped_key, &plaintext_num_words));
+
+  // Check the integrity/lengths/mode of the key encryption key, and construct
+  // an internal AES key.
+  aes_key_t kek;
+  HARDENED_TRY(aes_kwp_key_construct(key_kek, &kek));
+
+  // Create the plaintext by copying the key configuration, checksum, keyblob
+  // length, and keyblob into a buffer.
+  uint32_t plaintext[plaintext_num_words];
+  key_wrap_plaintext(key_to_wrap, plaintext);
 
   // Wrap the key.
   return aes_kwp_wrap(kek, plaintext, sizeof(plaintext), wrapped_key.data);
 }
 
+otcrypto_status_t otcrypto_key_wrap_batch(
+    const otcrypto_blinded_key_t *keys_to_wrap, size_t num_keys,
+    const otcrypto_blinded_key_t *key_kek,
+    otcrypto_word32_buf_t *wrapped_keys) {
+  if (keys_to_wrap == NULL || num_keys == 0 || key_kek == NULL ||
+      key_kek->keyblob == NULL || wrapped_keys == NULL) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+
+  // Check all the keys and output buffers before doing anything else.
+  aes_kwp_wrap_job_t jobs[num_keys];
+  size_t total_words = 0;
+  for (size_t i = 0; i < num_keys; i++) {
+    size_t plaintext_num_words;
+    HARDENED_TRY(key_wrap_check(&keys_to_wrap[i], wrapped_keys[i],
+                                &plaintext_num_words));
+    jobs[i].plaintext_len = plaintext_num_words * sizeof(uint32_t);
+    jobs[i].ciphertext = wrapped_keys[i].data;
+    total_words += plaintext_num_words;
+  }
+
+  // Check the integrity/lengths/mode of the key encryption key, and construct
+  // an internal AES key.
+  aes_key_t kek;
+  HARDENED_TRY(aes_kwp_key_construct(key_kek, &kek));
+
+  // Create the plaintexts for all keys in one buffer.
+  uint32_t plaintext[total_words];
+  uint32_t *next = plaintext;
+  for (size_t i = 0; i < num_keys; i++) {
+    key_wrap_plaintext(&keys_to_wrap[i], next);
+    jobs[i].plaintext = next;
+    next += jobs[i].plaintext_len / sizeof(uint32_t);
+  }
+
+  // Wrap the keys, loading the key encryption key only once.
+  status_t result = aes_kwp_wrap_batch(kek, jobs, num_keys);
+  hardened_memshred(plaintext, ARRAYSIZE(plaintext));
+  return result;
+}
+
 otcrypto_status_t otcrypto_key_unwrap(otcrypto_const_word32_buf_t wrapped_key,
                                       const otcrypto_blinded_key_t *key_kek,
                                       hardened_bool_t *success,
@@ -249,31 +382,65 @@ otcrypto_status_t otcrypto_key_unwrap(otcrypto_const_word32_buf_t wrapped_key,
   }
   HARDENED_CHECK_EQ(*success, kHardenedBoolTrue);
 
-  // Set back to false while we check other conditions.
-  *success = kHardenedBoolFalse;
+  // Extract the key (this sets `success` back to false while it checks the
+  // remaining conditions).
+  return key_unwrap_extract(plaintext, success, unwrapped_key);
+}
 
-  // Extract the key configuration.
-  uint32_t config_words = sizeof(otcrypto_key_config_t) / sizeof(uint32_t);
-  hardened_memcpy((uint32_t *)&unwrapped_key->config, plaintext, config_words);
+otcrypto_status_t otcrypto_key_unwrap_batch(
+    const otcrypto_const_word32_buf_t *wrapped_keys, size_t num_keys,
+    const otcrypto_blinded_key_t *key_kek, hardened_bool_t *success,
+    otcrypto_blinded_key_t *unwrapped_keys) {
+  if (wrapped_keys == NULL || num_keys == 0 || key_kek == NULL ||
+      key_kek->keyblob == NULL || success == NULL || unwrapped_keys == NULL) {
+    return OTCRYPTO_BAD_ARGS;
+  }
 
-  // Extract the checksum and keyblob length.
-  unwrapped_key->checksum = plaintext[config_words];
-  uint32_t keyblob_words = plaintext[config_words + 1];
-  if (keyblob_words != keyblob_num_words(unwrapped_key->config)) {
-    *success = kHardenedBoolFalse;
-    return OTCRYPTO_OK;
+  // Check all the wrapped keys and output keys before doing anything else.
+  aes_kwp_unwrap_job_t jobs[num_keys];
+  size_t total_words = 0;
+  for (size_t i = 0; i < num_keys; i++) {
+    success[i] = kHardenedBoolFalse;
+    if (wrapped_keys[i].data == NULL || unwrapped_keys[i].keyblob == NULL) {
+      return OTCRYPTO_BAD_ARGS;
+    }
+
+    // Check that the configuration is aligned.
+    if (misalignment32_of((uintptr_t)&unwrapped_keys[i].config) != 0) {
+      return OTCRYPTO_BAD_ARGS;
+    }
+
+    jobs[i].ciphertext = wrapped_keys[i].data;
+    jobs[i].ciphertext_len = wrapped_keys[i].len * sizeof(uint32_t);
+    total_words += wrapped_keys[i].len;
   }
 
-  // Extract the keyblob.
-  if (unwrapped_key->keyblob_length != keyblob_words * sizeof(uint32_t)) {
-    return OTCRYPTO_BAD_ARGS;
+  // Check the integrity/lengths/mode of the key encryption key, and construct
+  // an internal AES key.
+  aes_key_t kek;
+  HARDENED_TRY(aes_kwp_key_construct(key_kek, &kek));
+
+  // Unwrap the keys, loading the key encryption key only once.
+  uint32_t plaintext[total_words];
+  uint32_t *next = plaintext;
+  for (size_t i = 0; i < num_keys; i++) {
+    jobs[i].plaintext = next;
+    next += wrapped_keys[i].len;
+  }
+  status_t result = aes_kwp_unwrap_batch(kek, jobs, num_keys);
+
+  // Extract the keys that unwrapped successfully.
+  for (size_t i = 0; status_ok(result) && i < num_keys; i++) {
+    if (launder32(jobs[i].success) != kHardenedBoolTrue) {
+      continue;
+    }
+    HARDENED_CHECK_EQ(jobs[i].success, kHardenedBoolTrue);
+    result = key_unwrap_extract(jobs[i].plaintext, &success[i],
+                                &unwrapped_keys[i]);
   }
-  hardened_memcpy(unwrapped_key->keyblob, plaintext + config_words + 2,
-                  keyblob_words);
 
-  // Finally, check the integrity of the key material we unwrapped.
-  *success = integrity_blinded_key_check(unwrapped_key);
-  return OTCRYPTO_OK;
+  hardened_memshred(plaintext, ARRAYSIZE(plaintext));
+  return result;
 }
 
 otcrypto_status_t otcrypto_import_blinded_key(
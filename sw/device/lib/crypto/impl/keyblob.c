@@ -12,6 +12,37 @@
 // Module ID for status codes.
 #define MODULE_ID MAKE_MODULE_ID('k', 'b', 'b')
 
+enum {
+  /**
+   * Number of words in a keymgr diversification.
+   */
+  kKeyblobDiversificationWords =
+      sizeof(keymgr_diversification_t) / sizeof(uint32_t),
+};
+
+/**
+ * State of the OTBN sideload session.
+ */
+typedef struct keyblob_sideload_session {
+  /**
+   * Whether a session is active.
+   */
+  hardened_bool_t active;
+  /**
+   * Whether the OTBN sideload slot holds the pinned key.
+   */
+  hardened_bool_t loaded;
+  /**
+   * Diversification of the pinned key.
+   */
+  keymgr_diversification_t diversification;
+} keyblob_sideload_session_t;
+
+static keyblob_sideload_session_t sideload_session = {
+    .active = kHardenedBoolFalse,
+    .loaded = kHardenedBoolFalse,
+};
+
 /**
  * Determine the number of bytes in one share of a blinded key.
  *
@@ -91,8 +122,8 @@ void keyblob_from_shares(const uint32_t *share0, const uint32_t *share1,
                          const otcrypto_key_config_t config,
                          uint32_t *keyblob) {
   size_t share_words = keyblob_share_num_words(config);
-  hardened_memcpy(keyblob, share0, share_words);
-  hardened_memcpy(keyblob + share_words, share1, share_words);
+  hardened_memcpy_wide(keyblob, share0, share_words);
+  hardened_memcpy_wide(keyblob + share_words, share1, share_words);
 }
 
 status_t keyblob_buffer_to_keymgr_diversification(
@@ -241,5 +272,59 @@ status_t keyblob_key_unmask(const otcrypto_blinded_key_t *key,
 status_t keyblob_sideload_key_otbn(const otcrypto_blinded_key_t *key) {
   keymgr_diversification_t diversification;
   HARDENED_TRY(keyblob_to_keymgr_diversification(key, &diversification));
-  return keymgr_generate_key_otbn(diversification);
+
+  hardened_bool_t pinned = kHardenedBoolFalse;
+  if (launder32(sideload_session.active) == kHardenedBoolTrue) {
+    pinned = hardened_memeq((uint32_t *)&diversification,
+                            (uint32_t *)&sideload_session.diversification,
+                            kKeyblobDiversificationWords);
+  }
+  if (launder32(pinned) == kHardenedBoolTrue &&
+      launder32(sideload_session.loaded) == kHardenedBoolTrue) {
+    // The slot still holds the pinned key; check again before reusing it.
+    HARDENED_CHECK_EQ(sideload_session.active, kHardenedBoolTrue);
+    HARDENED_CHECK_EQ(
+        hardened_memeq((uint32_t *)&diversification,
+                       (uint32_t *)&sideload_session.diversification,
+                       kKeyblobDiversificationWords),
+        kHardenedBoolTrue);
+    return OTCRYPTO_OK;
+  }
+
+  // Any other key replaces the pinned key in the slot.
+  sideload_session.loaded = kHardenedBoolFalse;
+  status_t result = keymgr_generate_key_otbn(diversification);
+  if (!status_ok(result)) {
+    HARDENED_TRY(keymgr_sideload_clear_otbn());
+    return result;
+  }
+  sideload_session.loaded = pinned;
+  return OTCRYPTO_OK;
+}
+
+status_t keyblob_sideload_clear_otbn(void) {
+  if (launder32(sideload_session.loaded) == kHardenedBoolTrue) {
+    HARDENED_CHECK_EQ(sideload_session.active, kHardenedBoolTrue);
+    return OTCRYPTO_OK;
+  }
+  return keymgr_sideload_clear_otbn();
+}
+
+status_t keyblob_sideload_session_start(const otcrypto_blinded_key_t *key) {
+  if (launder32(sideload_session.active) != kHardenedBoolFalse) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+  HARDENED_TRY(keyblob_to_keymgr_diversification(
+      key, &sideload_session.diversification));
+  sideload_session.loaded = kHardenedBoolFalse;
+  sideload_session.active = kHardenedBoolTrue;
+  return OTCRYPTO_OK;
+}
+
+status_t keyblob_sideload_session_end(void) {
+  sideload_session.active = kHardenedBoolFalse;
+  sideload_session.loaded = kHardenedBoolFalse;
+  hardened_memshred((uint32_t *)&sideload_session.diversification,
+                    kKeyblobDiversificationWords);
+  return keymgr_sideload_clear_otbn();
 }
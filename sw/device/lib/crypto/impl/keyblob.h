@@ -189,12 +189,50 @@ status_t keyblob_key_unmask(const otcrypto_blinded_key_t *key,
  *
  * This routine should only ever be called on hardware-backed keys.
  *
+ * If a sideload session is active and the slot still holds its key (see
+ * `keyblob_sideload_session_start()`), the key manager is not called again.
+ *
  * @param key Sideloaded key handle.
  * @return OK or error.
  */
 OT_WARN_UNUSED_RESULT
 status_t keyblob_sideload_key_otbn(const otcrypto_blinded_key_t *key);
 
+/**
+ * Clears the OTBN sideload slot after an operation.
+ *
+ * Does nothing while the slot holds the key of an active sideload session.
+ *
+ * @return OK or error.
+ */
+OT_WARN_UNUSED_RESULT
+status_t keyblob_sideload_clear_otbn(void);
+
+/**
+ * Starts an OTBN sideload session for a hardware-backed key.
+ *
+ * Pins the key's diversification: the first OTBN operation with the key
+ * derives it into the sideload slot as usual, but the slot is then kept until
+ * `keyblob_sideload_session_end()`. Operations with other keys still derive
+ * and clear the slot, after which the pinned key is derived again when next
+ * used. A failed derivation clears the slot.
+ *
+ * Returns `OTCRYPTO_BAD_ARGS` if a session is already active.
+ *
+ * @param key Sideloaded key handle.
+ * @return OK or error.
+ */
+OT_WARN_UNUSED_RESULT
+status_t keyblob_sideload_session_start(const otcrypto_blinded_key_t *key);
+
+/**
+ * Ends the OTBN sideload session, if any, and clears the sideload slot.
+ *
+ * @return OK or error.
+ */
+OT_WARN_UNUSED_RESULT
+status_t keyblob_sideload_session_end(void);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -29,6 +29,45 @@ static_assert(sizeof(hmac_ctx_t) % sizeof(uint32_t) == 0,
               "Size of `hmac_ctx_t` must be a multiple of the word size for "
               "`hardened_memcpy()`");
 
+enum {
+  /**
+   * Size of the HMAC driver keyed state in words.
+   */
+  kHmacKeyedStateWords = sizeof(hmac_keyed_state_t) / sizeof(uint32_t),
+};
+
+/**
+ * Blinded form of the HMAC driver keyed state.
+ *
+ * The keyblob holds the two shares of the driver state, as the keyblob of a
+ * blinded key would, so that the keyblob and integrity helpers apply to it
+ * through the view from `keyed_state_view()`.
+ */
+typedef struct hmac_keyed_state_blinded {
+  // Mode of the key the state was computed from.
+  otcrypto_key_mode_t key_mode;
+  // Two shares of the driver state.
+  uint32_t keyblob[2 * kHmacKeyedStateWords];
+  // Checksum of the blinded key view.
+  uint32_t checksum;
+} hmac_keyed_state_blinded_t;
+
+/**
+ * Ensure that the keyed state is large enough for the blinded driver state.
+ */
+static_assert(sizeof(otcrypto_hmac_keyed_state_t) >=
+                  sizeof(hmac_keyed_state_blinded_t),
+              "`otcrypto_hmac_keyed_state_t` must be big enough to hold "
+              "`hmac_keyed_state_blinded_t`.");
+
+/**
+ * Ensure that the driver keyed state is suitable for `hardened_memcpy()`.
+ */
+static_assert(sizeof(hmac_keyed_state_t) % sizeof(uint32_t) == 0 &&
+                  sizeof(hmac_keyed_state_blinded_t) % sizeof(uint32_t) == 0,
+              "Size of the keyed states must be a multiple of the word size "
+              "for `hardened_memcpy()`");
+
 /**
  * Save the internal HMAC driver context to a generic Hmac context.
  *
@@ -59,6 +98,30 @@ static void hmac_ctx_restore(const otcrypto_hmac_context_t *restrict ctx,
                   sizeof(hmac_ctx_t) / sizeof(uint32_t));
 }
 
+/**
+ * Returns a blinded key that refers to the shares of a keyed state.
+ *
+ * @param blinded Blinded keyed state.
+ * @return Blinded key view of `blinded`.
+ */
+static otcrypto_blinded_key_t keyed_state_view(
+    hmac_keyed_state_blinded_t *blinded) {
+  return (otcrypto_blinded_key_t){
+      .config =
+          {
+              .version = kOtcryptoLibVersion1,
+              .key_mode = blinded->key_mode,
+              .key_length = sizeof(hmac_keyed_state_t),
+              .hw_backed = kHardenedBoolFalse,
+              .exportable = kHardenedBoolFalse,
+              .security_level = kOtcryptoKeySecurityLevelLow,
+          },
+      .keyblob_length = sizeof(blinded->keyblob),
+      .keyblob = blinded->keyblob,
+      .checksum = blinded->checksum,
+  };
+}
+
 /**
  * For given `key_mode`, return the corresponding driver-level `hmac_mode` and
  * `block_size`. `block_size` is the internal block size of the hash function
@@ -369,3 +432,79 @@ otcrypto_status_t otcrypto_hmac_final(otcrypto_hmac_context_t *const ctx,
   hmac_ctx_save(ctx, &hmac_ctx);
   return OTCRYPTO_OK;
 }
+
+otcrypto_status_t otcrypto_hmac_keyed_state_init(
+    otcrypto_hmac_keyed_state_t *state, const otcrypto_blinded_key_t *key) {
+  if (state == NULL || key == NULL || key->keyblob == NULL) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+  // Same restrictions as for `otcrypto_hmac`.
+  if (key->config.hw_backed != kHardenedBoolFalse) {
+    return OTCRYPTO_NOT_IMPLEMENTED;
+  }
+  if (key->config.security_level != kOtcryptoKeySecurityLevelLow) {
+    return OTCRYPTO_NOT_IMPLEMENTED;
+  }
+
+  hmac_mode_t hmac_mode;
+  size_t block_size;
+  HARDENED_TRY(get_hmac_mode(key->config.key_mode, &hmac_mode, &block_size));
+
+  uint32_t processed_key[block_size];
+  HARDENED_TRY(hmac_key_process(key, processed_key));
+
+  hmac_keyed_state_t keyed;
+  status_t result =
+      hmac_keyed_state_init(&keyed, hmac_mode, processed_key, block_size);
+  hardened_memshred(processed_key, block_size);
+  HARDENED_TRY(result);
+
+  // Blind the driver state with a fresh mask.
+  hmac_keyed_state_blinded_t blinded = {.key_mode = key->config.key_mode};
+  otcrypto_blinded_key_t view = keyed_state_view(&blinded);
+  uint32_t mask[kHmacKeyedStateWords];
+  hardened_memshred(mask, ARRAYSIZE(mask));
+  result = keyblob_from_key_and_mask((uint32_t *)&keyed, mask, view.config,
+                                     blinded.keyblob);
+  hardened_memshred((uint32_t *)&keyed, kHmacKeyedStateWords);
+  HARDENED_TRY(result);
+  blinded.checksum = integrity_blinded_checksum(&view);
+
+  hardened_memcpy(state->data, (uint32_t *)&blinded,
+                  sizeof(blinded) / sizeof(uint32_t));
+  return OTCRYPTO_OK;
+}
+
+otcrypto_status_t otcrypto_hmac_keyed(const otcrypto_hmac_keyed_state_t *state,
+                                      otcrypto_const_byte_buf_t input_message,
+                                      otcrypto_word32_buf_t tag) {
+  if (state == NULL || tag.data == NULL) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+
+  // Check for null input message with nonzero length.
+  if (input_message.data == NULL && input_message.len != 0) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+
+  hmac_keyed_state_blinded_t blinded;
+  hardened_memcpy((uint32_t *)&blinded, state->data,
+                  sizeof(blinded) / sizeof(uint32_t));
+  otcrypto_blinded_key_t view = keyed_state_view(&blinded);
+  if (integrity_blinded_key_check(&view) != kHardenedBoolTrue) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+
+  hmac_mode_t hmac_mode;
+  size_t block_size;
+  HARDENED_TRY(get_hmac_mode(blinded.key_mode, &hmac_mode, &block_size));
+
+  // HMAC HWIP does not support masking, so we need to unmask the state.
+  hmac_keyed_state_t keyed;
+  HARDENED_TRY(
+      keyblob_key_unmask(&view, kHmacKeyedStateWords, (uint32_t *)&keyed));
+  status_t result = hmac_keyed(&keyed, hmac_mode, input_message.data,
+                               input_message.len, tag.data, tag.len);
+  hardened_memshred((uint32_t *)&keyed, kHmacKeyedStateWords);
+  return result;
+}
@@ -485,6 +485,55 @@ otcrypto_status_t otcrypto_rsa_keygen_async_finalize(
   return OTCRYPTO_OK;
 }
 
+otcrypto_status_t otcrypto_rsa_prime_pool_enable(hardened_bool_t enable,
+                                                 otcrypto_rsa_size_t size) {
+  if (launder32(enable) == kHardenedBoolFalse) {
+    HARDENED_CHECK_EQ(enable, kHardenedBoolFalse);
+    return rsa_prime_pool_configure(0);
+  }
+  if (launder32(enable) != kHardenedBoolTrue) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+  HARDENED_CHECK_EQ(enable, kHardenedBoolTrue);
+
+  switch (size) {
+    case kOtcryptoRsaSize2048:
+      return rsa_prime_pool_configure(kRsa2048NumWords);
+    case kOtcryptoRsaSize3072:
+      return rsa_prime_pool_configure(kRsa3072NumWords);
+    case kOtcryptoRsaSize4096:
+      return rsa_prime_pool_configure(kRsa4096NumWords);
+    default:
+      return OTCRYPTO_BAD_ARGS;
+  }
+
+  // Should be unreachable.
+  HARDENED_TRAP();
+  return OTCRYPTO_FATAL_ERR;
+}
+
+otcrypto_status_t otcrypto_rsa_prime_pool_refill(size_t *num_primes) {
+  HARDENED_TRY(otcrypto_rsa_prime_pool_refill_async_start());
+  return otcrypto_rsa_prime_pool_refill_async_finalize(num_primes);
+}
+
+otcrypto_status_t otcrypto_rsa_prime_pool_refill_async_start(void) {
+  // Check that the entropy complex is initialized.
+  HARDENED_TRY(entropy_complex_check());
+
+  return rsa_prime_pool_refill_start();
+}
+
+otcrypto_status_t otcrypto_rsa_prime_pool_refill_async_finalize(
+    size_t *num_primes) {
+  if (num_primes == NULL) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+  HARDENED_TRY(rsa_prime_pool_refill_finalize());
+  *num_primes = rsa_prime_pool_count();
+  return OTCRYPTO_OK;
+}
+
 otcrypto_status_t otcrypto_rsa_keypair_from_cofactor_async_start(
     otcrypto_rsa_size_t size, otcrypto_const_word32_buf_t modulus, uint32_t e,
     otcrypto_const_word32_buf_t cofactor_share0,
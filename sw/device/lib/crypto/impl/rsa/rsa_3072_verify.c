@@ -5,6 +5,7 @@
 #include "sw/device/lib/crypto/impl/rsa/rsa_3072_verify.h"
 
 #include "sw/device/lib/base/hardened.h"
+#include "sw/device/lib/base/hardened_memory.h"
 #include "sw/device/lib/base/macros.h"
 #include "sw/device/lib/base/memory.h"
 #include "sw/device/lib/crypto/drivers/otbn.h"
@@ -208,19 +209,23 @@ status_t rsa_3072_verify_finalize(const rsa_3072_int_t *message,
   // Spin here waiting for OTBN to complete.
   HARDENED_TRY(otbn_busy_wait_for_done());
 
-  // Read recovered message out of OTBN dmem.
-  rsa_3072_int_t recoveredMessage;
-  HARDENED_TRY(
-      read_rsa_3072_int_from_otbn(kOtbnVarRsaOutBuf, &recoveredMessage));
-
-  // TODO: harden this memory comparison
-  // Check if recovered message matches expectation
-  *result = kHardenedBoolTrue;
-  for (int i = 0; i < kRsa3072NumWords; i++) {
-    if (recoveredMessage.data[i] != message->data[i]) {
-      *result = kHardenedBoolFalse;
-    }
+  // Compare the recovered message to the expected one while reading it out of
+  // OTBN dmem, one wide word at a time, so that it is never staged in full.
+  static_assert(kRsa3072NumWords % kOtbnWideWordNumWords == 0,
+                "RSA-3072 integers must be a whole number of OTBN wide words.");
+  hardened_memeq_stream_t eq;
+  hardened_memeq_stream_init(&eq);
+  uint32_t chunk[kOtbnWideWordNumWords];
+  size_t i = 0;
+  for (; launderw(i) < kRsa3072NumWords; i += kOtbnWideWordNumWords) {
+    HARDENED_TRY(otbn_dmem_read(kOtbnWideWordNumWords,
+                                kOtbnVarRsaOutBuf + i * sizeof(uint32_t),
+                                chunk));
+    hardened_memeq_stream_update(&eq, chunk, &message->data[i],
+                                 kOtbnWideWordNumWords);
   }
+  HARDENED_CHECK_EQ(i, kRsa3072NumWords);
+  *result = hardened_memeq_stream_final(&eq, kRsa3072NumWords);
 
   return OTCRYPTO_OK;
 }
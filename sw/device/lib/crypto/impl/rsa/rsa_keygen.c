@@ -20,6 +20,7 @@ OTBN_DECLARE_SYMBOL_ADDR(run_rsa_keygen, mode);          // Application mode.
 OTBN_DECLARE_SYMBOL_ADDR(run_rsa_keygen, rsa_n);         // Public exponent n.
 OTBN_DECLARE_SYMBOL_ADDR(run_rsa_keygen, rsa_d);         // Private exponent d.
 OTBN_DECLARE_SYMBOL_ADDR(run_rsa_keygen, rsa_cofactor);  // Cofactor p or q.
+OTBN_DECLARE_SYMBOL_ADDR(run_rsa_keygen, ok);            // Pair check result.
 
 static const otbn_addr_t kOtbnVarRsaMode =
     OTBN_ADDR_T_INIT(run_rsa_keygen, mode);
@@ -27,6 +28,7 @@ static const otbn_addr_t kOtbnVarRsaN = OTBN_ADDR_T_INIT(run_rsa_keygen, rsa_n);
 static const otbn_addr_t kOtbnVarRsaD = OTBN_ADDR_T_INIT(run_rsa_keygen, rsa_d);
 static const otbn_addr_t kOtbnVarRsaCofactor =
     OTBN_ADDR_T_INIT(run_rsa_keygen, rsa_cofactor);
+static const otbn_addr_t kOtbnVarRsaOk = OTBN_ADDR_T_INIT(run_rsa_keygen, ok);
 
 // Declare mode constants.
 OTBN_DECLARE_SYMBOL_ADDR(run_rsa_keygen, MODE_GEN_RSA_2048);
@@ -41,6 +43,24 @@ static const uint32_t kOtbnRsaModeGen3072 =
     OTBN_ADDR_T_INIT(run_rsa_keygen, MODE_GEN_RSA_3072);
 static const uint32_t kOtbnRsaModeGen4096 =
     OTBN_ADDR_T_INIT(run_rsa_keygen, MODE_GEN_RSA_4096);
+OTBN_DECLARE_SYMBOL_ADDR(run_rsa_keygen, MODE_GEN_PRIME_RSA_2048);
+OTBN_DECLARE_SYMBOL_ADDR(run_rsa_keygen, MODE_GEN_PRIME_RSA_3072);
+OTBN_DECLARE_SYMBOL_ADDR(run_rsa_keygen, MODE_GEN_PRIME_RSA_4096);
+OTBN_DECLARE_SYMBOL_ADDR(run_rsa_keygen, MODE_FROM_PRIMES_RSA_2048);
+OTBN_DECLARE_SYMBOL_ADDR(run_rsa_keygen, MODE_FROM_PRIMES_RSA_3072);
+OTBN_DECLARE_SYMBOL_ADDR(run_rsa_keygen, MODE_FROM_PRIMES_RSA_4096);
+static const uint32_t kOtbnRsaModeGenPrime2048 =
+    OTBN_ADDR_T_INIT(run_rsa_keygen, MODE_GEN_PRIME_RSA_2048);
+static const uint32_t kOtbnRsaModeGenPrime3072 =
+    OTBN_ADDR_T_INIT(run_rsa_keygen, MODE_GEN_PRIME_RSA_3072);
+static const uint32_t kOtbnRsaModeGenPrime4096 =
+    OTBN_ADDR_T_INIT(run_rsa_keygen, MODE_GEN_PRIME_RSA_4096);
+static const uint32_t kOtbnRsaModeFromPrimes2048 =
+    OTBN_ADDR_T_INIT(run_rsa_keygen, MODE_FROM_PRIMES_RSA_2048);
+static const uint32_t kOtbnRsaModeFromPrimes3072 =
+    OTBN_ADDR_T_INIT(run_rsa_keygen, MODE_FROM_PRIMES_RSA_3072);
+static const uint32_t kOtbnRsaModeFromPrimes4096 =
+    OTBN_ADDR_T_INIT(run_rsa_keygen, MODE_FROM_PRIMES_RSA_4096);
 
 enum {
   /* Fixed public exponent for generated keys. This exponent is 2^16 + 1, also
@@ -48,8 +68,59 @@ enum {
   kFixedPublicExponent = 65537,
   /* Number of words used to represent the application mode. */
   kOtbnRsaModeWords = 1,
+  /* Maximum number of words in a prime (for RSA-4096). */
+  kRsaMaxPrimeWords = kRsa4096NumWords / 2,
+  /* Offset of the second share of a prime within its DMEM buffer (bytes). */
+  kOtbnPrimeShare1Offset = kRsaMaxPrimeWords * sizeof(uint32_t),
 };
 
+/**
+ * A prime from the prime pool, as two boolean shares.
+ */
+typedef struct rsa_pooled_prime {
+  uint32_t share0[kRsaMaxPrimeWords];
+  uint32_t share1[kRsaMaxPrimeWords];
+} rsa_pooled_prime_t;
+
+/**
+ * State of the prime pool.
+ */
+static struct {
+  /**
+   * Whether the pool is enabled.
+   */
+  hardened_bool_t enabled;
+  /**
+   * Number of words in each prime (half the modulus size).
+   */
+  size_t prime_words;
+  /**
+   * OTBN application mode for generating one prime of this size.
+   */
+  uint32_t gen_mode;
+  /**
+   * Whether OTBN is running a refill started by `rsa_prime_pool_refill_start`.
+   */
+  hardened_bool_t refilling;
+  /**
+   * Number of primes in `primes`.
+   */
+  size_t count;
+  rsa_pooled_prime_t primes[kRsaPrimePoolCapacity];
+} prime_pool = {
+    .enabled = kHardenedBoolFalse,
+    .refilling = kHardenedBoolFalse,
+    .count = 0,
+};
+
+/**
+ * Mode of the key generation operation in progress.
+ *
+ * This is the `FROM_PRIMES` mode if the running operation uses primes from the
+ * pool, and the `GEN` mode otherwise.
+ */
+static uint32_t keygen_mode = 0;
+
 /**
  * Start the OTBN key generation program in random-key mode.
  *
@@ -68,6 +139,49 @@ static status_t keygen_start(uint32_t mode) {
   return otbn_execute();
 }
 
+/**
+ * Start key generation, using two primes from the pool if it has them.
+ *
+ * @param gen_mode Mode parameter for keygen from scratch.
+ * @param from_primes_mode Mode parameter for keygen from pooled primes.
+ * @param prime_words Number of words in each prime.
+ * @return Result of the operation.
+ */
+static status_t keygen_start_pooled(uint32_t gen_mode,
+                                    uint32_t from_primes_mode,
+                                    size_t prime_words) {
+  if (launder32(prime_pool.enabled) != kHardenedBoolTrue ||
+      prime_pool.prime_words != prime_words || prime_pool.count < 2) {
+    keygen_mode = gen_mode;
+    return keygen_start(gen_mode);
+  }
+  HARDENED_CHECK_EQ(prime_pool.enabled, kHardenedBoolTrue);
+
+  // Load the RSA key generation app. Fails if OTBN is non-idle.
+  HARDENED_TRY(otbn_load_app(kOtbnAppRsaKeygen));
+
+  // Write the shares of the two most recent primes into DMEM.
+  rsa_pooled_prime_t *p = &prime_pool.primes[prime_pool.count - 1];
+  rsa_pooled_prime_t *q = &prime_pool.primes[prime_pool.count - 2];
+  HARDENED_TRY(otbn_dmem_write(prime_words, p->share0, kOtbnVarRsaCofactor));
+  HARDENED_TRY(otbn_dmem_write(prime_words, p->share1,
+                               kOtbnVarRsaCofactor + kOtbnPrimeShare1Offset));
+  HARDENED_TRY(otbn_dmem_write(prime_words, q->share0, kOtbnVarRsaD));
+  HARDENED_TRY(otbn_dmem_write(prime_words, q->share1,
+                               kOtbnVarRsaD + kOtbnPrimeShare1Offset));
+
+  // The primes are used up; remove them from the pool.
+  hardened_memshred((uint32_t *)p, sizeof(*p) / sizeof(uint32_t));
+  hardened_memshred((uint32_t *)q, sizeof(*q) / sizeof(uint32_t));
+  prime_pool.count -= 2;
+
+  // Set mode and start OTBN.
+  keygen_mode = from_primes_mode;
+  HARDENED_TRY(
+      otbn_dmem_write(kOtbnRsaModeWords, &from_primes_mode, kOtbnVarRsaMode));
+  return otbn_execute();
+}
+
 /**
  * Finalize a key generation operation (for either mode).
  *
@@ -104,14 +218,52 @@ static status_t keygen_finalize(uint32_t exp_mode, size_t num_words,
   return OTCRYPTO_OK;
 }
 
+/**
+ * Finalize a key generation operation started by `keygen_start_pooled`.
+ *
+ * If the operation used pooled primes and the pair failed its checks, runs key
+ * generation from scratch instead. This is very unlikely.
+ *
+ * @param gen_mode Mode parameter for keygen from scratch.
+ * @param num_words Number of words for modulus and private exponent.
+ * @param[out] n Buffer for the modulus.
+ * @param[out] d Buffer for the private exponent.
+ * @return OK or error.
+ */
+static status_t keygen_finalize_pooled(uint32_t gen_mode, size_t num_words,
+                                       uint32_t *n, uint32_t *d) {
+  if (launder32(keygen_mode) == gen_mode) {
+    HARDENED_CHECK_EQ(keygen_mode, gen_mode);
+    return keygen_finalize(gen_mode, num_words, n, d);
+  }
+
+  // Spin here waiting for OTBN to complete.
+  HARDENED_TRY(otbn_busy_wait_for_done());
+
+  // Check that the pair of primes was acceptable.
+  uint32_t ok = 0;
+  HARDENED_TRY(otbn_dmem_read(1, kOtbnVarRsaOk, &ok));
+  if (launder32(ok) != kHardenedBoolTrue) {
+    HARDENED_TRY(otbn_dmem_sec_wipe());
+    keygen_mode = gen_mode;
+    HARDENED_TRY(keygen_start(gen_mode));
+    return keygen_finalize(gen_mode, num_words, n, d);
+  }
+  HARDENED_CHECK_EQ(ok, kHardenedBoolTrue);
+
+  return keygen_finalize(keygen_mode, num_words, n, d);
+}
+
 status_t rsa_keygen_2048_start(void) {
-  return keygen_start(kOtbnRsaModeGen2048);
+  return keygen_start_pooled(kOtbnRsaModeGen2048, kOtbnRsaModeFromPrimes2048,
+                             kRsa2048NumWords / 2);
 }
 
 status_t rsa_keygen_2048_finalize(rsa_2048_public_key_t *public_key,
                                   rsa_2048_private_key_t *private_key) {
-  HARDENED_TRY(keygen_finalize(kOtbnRsaModeGen2048, kRsa2048NumWords,
-                               private_key->n.data, private_key->d.data));
+  HARDENED_TRY(keygen_finalize_pooled(kOtbnRsaModeGen2048, kRsa2048NumWords,
+                                      private_key->n.data,
+                                      private_key->d.data));
 
   // Copy the modulus to the public key.
   hardened_memcpy(public_key->n.data, private_key->n.data,
@@ -125,13 +277,15 @@ status_t rsa_keygen_2048_finalize(rsa_2048_public_key_t *public_key,
 }
 
 status_t rsa_keygen_3072_start(void) {
-  return keygen_start(kOtbnRsaModeGen3072);
+  return keygen_start_pooled(kOtbnRsaModeGen3072, kOtbnRsaModeFromPrimes3072,
+                             kRsa3072NumWords / 2);
 }
 
 status_t rsa_keygen_3072_finalize(rsa_3072_public_key_t *public_key,
                                   rsa_3072_private_key_t *private_key) {
-  HARDENED_TRY(keygen_finalize(kOtbnRsaModeGen3072, kRsa3072NumWords,
-                               private_key->n.data, private_key->d.data));
+  HARDENED_TRY(keygen_finalize_pooled(kOtbnRsaModeGen3072, kRsa3072NumWords,
+                                      private_key->n.data,
+                                      private_key->d.data));
 
   // Copy the modulus to the public key.
   hardened_memcpy(public_key->n.data, private_key->n.data,
@@ -145,13 +299,15 @@ status_t rsa_keygen_3072_finalize(rsa_3072_public_key_t *public_key,
 }
 
 status_t rsa_keygen_4096_start(void) {
-  return keygen_start(kOtbnRsaModeGen4096);
+  return keygen_start_pooled(kOtbnRsaModeGen4096, kOtbnRsaModeFromPrimes4096,
+                             kRsa4096NumWords / 2);
 }
 
 status_t rsa_keygen_4096_finalize(rsa_4096_public_key_t *public_key,
                                   rsa_4096_private_key_t *private_key) {
-  HARDENED_TRY(keygen_finalize(kOtbnRsaModeGen4096, kRsa4096NumWords,
-                               private_key->n.data, private_key->d.data));
+  HARDENED_TRY(keygen_finalize_pooled(kOtbnRsaModeGen4096, kRsa4096NumWords,
+                                      private_key->n.data,
+                                      private_key->d.data));
 
   // Copy the modulus to the public key.
   hardened_memcpy(public_key->n.data, private_key->n.data,
@@ -202,3 +358,94 @@ status_t rsa_keygen_from_cofactor_2048_finalize(
 
   return OTCRYPTO_OK;
 }
+
+status_t rsa_prime_pool_configure(size_t num_words) {
+  // Refuse to reconfigure the pool while OTBN is generating a prime for it.
+  if (launder32(prime_pool.refilling) != kHardenedBoolFalse) {
+    return OTCRYPTO_ASYNC_INCOMPLETE;
+  }
+  HARDENED_CHECK_EQ(prime_pool.refilling, kHardenedBoolFalse);
+
+  uint32_t gen_mode;
+  switch (num_words) {
+    case 0:
+      gen_mode = 0;
+      break;
+    case kRsa2048NumWords:
+      gen_mode = kOtbnRsaModeGenPrime2048;
+      break;
+    case kRsa3072NumWords:
+      gen_mode = kOtbnRsaModeGenPrime3072;
+      break;
+    case kRsa4096NumWords:
+      gen_mode = kOtbnRsaModeGenPrime4096;
+      break;
+    default:
+      return OTCRYPTO_BAD_ARGS;
+  }
+
+  // Wipe any stored primes.
+  hardened_memshred(
+      (uint32_t *)prime_pool.primes,
+      kRsaPrimePoolCapacity * sizeof(rsa_pooled_prime_t) / sizeof(uint32_t));
+  prime_pool.count = 0;
+  prime_pool.prime_words = num_words / 2;
+  prime_pool.gen_mode = gen_mode;
+  prime_pool.enabled = num_words == 0 ? kHardenedBoolFalse : kHardenedBoolTrue;
+  return OTCRYPTO_OK;
+}
+
+size_t rsa_prime_pool_count(void) { return prime_pool.count; }
+
+status_t rsa_prime_pool_refill_start(void) {
+  if (launder32(prime_pool.enabled) != kHardenedBoolTrue) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+  HARDENED_CHECK_EQ(prime_pool.enabled, kHardenedBoolTrue);
+
+  // Nothing to do if the pool is full.
+  if (prime_pool.count >= kRsaPrimePoolCapacity) {
+    prime_pool.refilling = kHardenedBoolFalse;
+    return OTCRYPTO_OK;
+  }
+
+  // Load the RSA key generation app. Fails if OTBN is non-idle.
+  HARDENED_TRY(otbn_load_app(kOtbnAppRsaKeygen));
+
+  // Set mode and start OTBN.
+  uint32_t mode = prime_pool.gen_mode;
+  HARDENED_TRY(otbn_dmem_write(kOtbnRsaModeWords, &mode, kOtbnVarRsaMode));
+  HARDENED_TRY(otbn_execute());
+  prime_pool.refilling = kHardenedBoolTrue;
+  return OTCRYPTO_OK;
+}
+
+status_t rsa_prime_pool_refill_finalize(void) {
+  if (launder32(prime_pool.refilling) == kHardenedBoolFalse) {
+    return OTCRYPTO_OK;
+  }
+  HARDENED_CHECK_EQ(prime_pool.refilling, kHardenedBoolTrue);
+  prime_pool.refilling = kHardenedBoolFalse;
+
+  // Spin here waiting for OTBN to complete.
+  HARDENED_TRY(otbn_busy_wait_for_done());
+
+  // Read the mode from OTBN dmem and panic if it's not as expected.
+  uint32_t act_mode = 0;
+  HARDENED_TRY(otbn_dmem_read(1, kOtbnVarRsaMode, &act_mode));
+  if (act_mode != prime_pool.gen_mode) {
+    return OTCRYPTO_FATAL_ERR;
+  }
+
+  // Read the shares of the new prime.
+  rsa_pooled_prime_t *prime = &prime_pool.primes[prime_pool.count];
+  HARDENED_TRY(otbn_dmem_read(prime_pool.prime_words, kOtbnVarRsaCofactor,
+                              prime->share0));
+  HARDENED_TRY(otbn_dmem_read(prime_pool.prime_words,
+                              kOtbnVarRsaCofactor + kOtbnPrimeShare1Offset,
+                              prime->share1));
+  prime_pool.count++;
+
+  // Wipe DMEM.
+  return otbn_dmem_sec_wipe();
+}
@@ -16,6 +16,13 @@
 extern "C" {
 #endif  // __cplusplus
 
+enum {
+  /**
+   * Number of primes the prime pool can hold.
+   */
+  kRsaPrimePoolCapacity = 4,
+};
+
 /**
  * Starts an RSA-2048 key generation operation; returns immediately.
  *
@@ -122,6 +129,53 @@ status_t rsa_keygen_from_cofactor_2048_start(
 status_t rsa_keygen_from_cofactor_2048_finalize(
     rsa_2048_public_key_t *public_key, rsa_2048_private_key_t *private_key);
 
+/**
+ * Configures the RSA prime pool.
+ *
+ * The prime pool holds primes for one RSA size, generated ahead of time with
+ * `rsa_prime_pool_refill_start`/`rsa_prime_pool_refill_finalize`. Each prime
+ * is stored as two boolean shares. Once the pool holds at least two primes,
+ * key generation for that size (`rsa_keygen_*_start`) builds the key from two
+ * pooled primes, which takes a small and predictable amount of time, instead
+ * of searching for primes. Otherwise key generation runs as usual.
+ *
+ * Reconfiguring the pool wipes any primes it holds.
+ *
+ * Returns an `OTCRYPTO_ASYNC_INCOMPLETE` error if a refill is in progress.
+ *
+ * @param num_words Number of words in the RSA modulus, or 0 to disable.
+ * @return Result of the operation (OK or error).
+ */
+status_t rsa_prime_pool_configure(size_t num_words);
+
+/**
+ * Returns the number of primes in the prime pool.
+ *
+ * @return Number of primes, at most `kRsaPrimePoolCapacity`.
+ */
+size_t rsa_prime_pool_count(void);
+
+/**
+ * Starts generating a prime for the prime pool; returns immediately.
+ *
+ * Does nothing if the pool is already full. Returns an
+ * `OTCRYPTO_ASYNC_INCOMPLETE` error if OTBN is busy, and `OTCRYPTO_BAD_ARGS`
+ * if the pool is disabled.
+ *
+ * @return Result of the operation (OK or error).
+ */
+status_t rsa_prime_pool_refill_start(void);
+
+/**
+ * Waits for prime generation to complete and adds the prime to the pool.
+ *
+ * Should be invoked only after `rsa_prime_pool_refill_start`. Blocks until
+ * OTBN is done processing.
+ *
+ * @return Result of the operation (OK or error).
+ */
+status_t rsa_prime_pool_refill_finalize(void);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -17,34 +17,45 @@ static const otbn_app_t kOtbnAppRsaModexp = OTBN_APP_T_INIT(run_rsa_modexp);
 OTBN_DECLARE_SYMBOL_ADDR(run_rsa_modexp, mode);   // Application mode.
 OTBN_DECLARE_SYMBOL_ADDR(run_rsa_modexp, n);      // Public modulus n.
 OTBN_DECLARE_SYMBOL_ADDR(run_rsa_modexp, d);      // Private exponent d.
+OTBN_DECLARE_SYMBOL_ADDR(run_rsa_modexp, e);      // Public exponent e.
 OTBN_DECLARE_SYMBOL_ADDR(run_rsa_modexp, inout);  // Input/output buffer.
 
 static const otbn_addr_t kOtbnVarRsaMode =
     OTBN_ADDR_T_INIT(run_rsa_modexp, mode);
 static const otbn_addr_t kOtbnVarRsaN = OTBN_ADDR_T_INIT(run_rsa_modexp, n);
 static const otbn_addr_t kOtbnVarRsaD = OTBN_ADDR_T_INIT(run_rsa_modexp, d);
+static const otbn_addr_t kOtbnVarRsaE = OTBN_ADDR_T_INIT(run_rsa_modexp, e);
 static const otbn_addr_t kOtbnVarRsaInOut =
     OTBN_ADDR_T_INIT(run_rsa_modexp, inout);
 
 // Declare mode constants.
 OTBN_DECLARE_SYMBOL_ADDR(run_rsa_modexp, MODE_RSA_2048_MODEXP);
 OTBN_DECLARE_SYMBOL_ADDR(run_rsa_modexp, MODE_RSA_2048_MODEXP_F4);
+OTBN_DECLARE_SYMBOL_ADDR(run_rsa_modexp, MODE_RSA_2048_MODEXP_VAR);
 OTBN_DECLARE_SYMBOL_ADDR(run_rsa_modexp, MODE_RSA_3072_MODEXP);
 OTBN_DECLARE_SYMBOL_ADDR(run_rsa_modexp, MODE_RSA_3072_MODEXP_F4);
+OTBN_DECLARE_SYMBOL_ADDR(run_rsa_modexp, MODE_RSA_3072_MODEXP_VAR);
 OTBN_DECLARE_SYMBOL_ADDR(run_rsa_modexp, MODE_RSA_4096_MODEXP);
 OTBN_DECLARE_SYMBOL_ADDR(run_rsa_modexp, MODE_RSA_4096_MODEXP_F4);
+OTBN_DECLARE_SYMBOL_ADDR(run_rsa_modexp, MODE_RSA_4096_MODEXP_VAR);
 static const uint32_t kMode2048Modexp =
     OTBN_ADDR_T_INIT(run_rsa_modexp, MODE_RSA_2048_MODEXP);
 static const uint32_t kMode2048ModexpF4 =
     OTBN_ADDR_T_INIT(run_rsa_modexp, MODE_RSA_2048_MODEXP_F4);
+static const uint32_t kMode2048ModexpVar =
+    OTBN_ADDR_T_INIT(run_rsa_modexp, MODE_RSA_2048_MODEXP_VAR);
 static const uint32_t kMode3072Modexp =
     OTBN_ADDR_T_INIT(run_rsa_modexp, MODE_RSA_3072_MODEXP);
 static const uint32_t kMode3072ModexpF4 =
     OTBN_ADDR_T_INIT(run_rsa_modexp, MODE_RSA_3072_MODEXP_F4);
+static const uint32_t kMode3072ModexpVar =
+    OTBN_ADDR_T_INIT(run_rsa_modexp, MODE_RSA_3072_MODEXP_VAR);
 static const uint32_t kMode4096Modexp =
     OTBN_ADDR_T_INIT(run_rsa_modexp, MODE_RSA_4096_MODEXP);
 static const uint32_t kMode4096ModexpF4 =
     OTBN_ADDR_T_INIT(run_rsa_modexp, MODE_RSA_4096_MODEXP_F4);
+static const uint32_t kMode4096ModexpVar =
+    OTBN_ADDR_T_INIT(run_rsa_modexp, MODE_RSA_4096_MODEXP_VAR);
 
 enum {
   /**
@@ -56,6 +67,42 @@ enum {
   kExponentF4 = 65537,
 };
 
+/**
+ * Checks that a public exponent is usable for variable-time exponentiation.
+ *
+ * RSA public exponents are odd and at least 3.
+ *
+ * @param exp Public exponent.
+ * @return OK if the exponent is valid, `OTCRYPTO_BAD_ARGS` otherwise.
+ */
+static status_t vartime_exponent_check(const uint32_t exp) {
+  if (exp < 3 || (exp & 1) == 0) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+  return OTCRYPTO_OK;
+}
+
+/**
+ * Selects the variable-time mode for an exponent.
+ *
+ * F4 has its own specialized routine; any other exponent is written to DMEM
+ * for the generic square-and-multiply routine.
+ *
+ * @param exp Public exponent.
+ * @param mode_f4 Mode for the exponent F4.
+ * @param mode_var Mode for other exponents.
+ * @return Status of the operation (OK or error).
+ */
+static status_t vartime_mode_set(const uint32_t exp, uint32_t mode_f4,
+                                 uint32_t mode_var) {
+  uint32_t mode = mode_f4;
+  if (exp != kExponentF4) {
+    mode = mode_var;
+    HARDENED_TRY(otbn_dmem_write(1, &exp, kOtbnVarRsaE));
+  }
+  return otbn_dmem_write(1, &mode, kOtbnVarRsaMode);
+}
+
 status_t rsa_modexp_wait(size_t *num_words) {
   // Spin here waiting for OTBN to complete.
   HARDENED_TRY(otbn_busy_wait_for_done());
@@ -65,11 +112,14 @@ status_t rsa_modexp_wait(size_t *num_words) {
   HARDENED_TRY(otbn_dmem_read(1, kOtbnVarRsaMode, &mode));
 
   *num_words = 0;
-  if (mode == kMode2048Modexp || mode == kMode2048ModexpF4) {
+  if (mode == kMode2048Modexp || mode == kMode2048ModexpF4 ||
+      mode == kMode2048ModexpVar) {
     *num_words = kRsa2048NumWords;
-  } else if (mode == kMode3072Modexp || mode == kMode3072ModexpF4) {
+  } else if (mode == kMode3072Modexp || mode == kMode3072ModexpF4 ||
+             mode == kMode3072ModexpVar) {
     *num_words = kRsa3072NumWords;
-  } else if (mode == kMode4096Modexp || mode == kMode4096ModexpF4) {
+  } else if (mode == kMode4096Modexp || mode == kMode4096ModexpF4 ||
+             mode == kMode4096ModexpVar) {
     *num_words = kRsa4096NumWords;
   } else {
     // Unrecognized mode.
@@ -128,21 +178,13 @@ status_t rsa_modexp_consttime_2048_start(const rsa_2048_int_t *base,
 status_t rsa_modexp_vartime_2048_start(const rsa_2048_int_t *base,
                                        const uint32_t exp,
                                        const rsa_2048_int_t *modulus) {
-  if (exp != kExponentF4) {
-    // TODO for other exponents, we temporarily fall back to the constant-time
-    // implementation until a variable-time implementation is supported.
-    rsa_2048_int_t exp_rsa;
-    memset(exp_rsa.data, 0, kRsa2048NumWords * sizeof(uint32_t));
-    exp_rsa.data[0] = exp;
-    return rsa_modexp_consttime_2048_start(base, &exp_rsa, modulus);
-  }
+  HARDENED_TRY(vartime_exponent_check(exp));
 
   // Load the OTBN app. Fails if OTBN is not idle.
   HARDENED_TRY(otbn_load_app(kOtbnAppRsaModexp));
 
-  // Set mode.
-  uint32_t mode = kMode2048ModexpF4;
-  HARDENED_TRY(otbn_dmem_write(1, &mode, kOtbnVarRsaMode));
+  // Set mode (and exponent, if needed).
+  HARDENED_TRY(vartime_mode_set(exp, kMode2048ModexpF4, kMode2048ModexpVar));
 
   // Set the base and the modulus n.
   HARDENED_TRY(otbn_dmem_write(kRsa2048NumWords, base->data, kOtbnVarRsaInOut));
@@ -178,21 +220,13 @@ status_t rsa_modexp_consttime_3072_start(const rsa_3072_int_t *base,
 status_t rsa_modexp_vartime_3072_start(const rsa_3072_int_t *base,
                                        const uint32_t exp,
                                        const rsa_3072_int_t *modulus) {
-  if (exp != kExponentF4) {
-    // TODO for other exponents, we temporarily fall back to the constant-time
-    // implementation until a variable-time implementation is supported.
-    rsa_3072_int_t exp_rsa;
-    memset(exp_rsa.data, 0, kRsa3072NumWords * sizeof(uint32_t));
-    exp_rsa.data[0] = exp;
-    return rsa_modexp_consttime_3072_start(base, &exp_rsa, modulus);
-  }
+  HARDENED_TRY(vartime_exponent_check(exp));
 
   // Load the OTBN app. Fails if OTBN is not idle.
   HARDENED_TRY(otbn_load_app(kOtbnAppRsaModexp));
 
-  // Set mode.
-  uint32_t mode = kMode3072ModexpF4;
-  HARDENED_TRY(otbn_dmem_write(1, &mode, kOtbnVarRsaMode));
+  // Set mode (and exponent, if needed).
+  HARDENED_TRY(vartime_mode_set(exp, kMode3072ModexpF4, kMode3072ModexpVar));
 
   // Set the base and the modulus n.
   HARDENED_TRY(otbn_dmem_write(kRsa3072NumWords, base->data, kOtbnVarRsaInOut));
@@ -228,21 +262,13 @@ status_t rsa_modexp_consttime_4096_start(const rsa_4096_int_t *base,
 status_t rsa_modexp_vartime_4096_start(const rsa_4096_int_t *base,
                                        const uint32_t exp,
                                        const rsa_4096_int_t *modulus) {
-  if (exp != kExponentF4) {
-    // TODO for other exponents, we temporarily fall back to the constant-time
-    // implementation until a variable-time implementation is supported.
-    rsa_4096_int_t exp_rsa;
-    memset(exp_rsa.data, 0, kRsa4096NumWords * sizeof(uint32_t));
-    exp_rsa.data[0] = exp;
-    return rsa_modexp_consttime_4096_start(base, &exp_rsa, modulus);
-  }
+  HARDENED_TRY(vartime_exponent_check(exp));
 
   // Load the OTBN app. Fails if OTBN is not idle.
   HARDENED_TRY(otbn_load_app(kOtbnAppRsaModexp));
 
-  // Set mode.
-  uint32_t mode = kMode4096ModexpF4;
-  HARDENED_TRY(otbn_dmem_write(1, &mode, kOtbnVarRsaMode));
+  // Set mode (and exponent, if needed).
+  HARDENED_TRY(vartime_mode_set(exp, kMode4096ModexpF4, kMode4096ModexpVar));
 
   // Set the base and the modulus n.
   HARDENED_TRY(otbn_dmem_write(kRsa4096NumWords, base->data, kOtbnVarRsaInOut));
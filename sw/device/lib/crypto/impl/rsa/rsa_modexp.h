@@ -51,7 +51,8 @@ status_t rsa_modexp_consttime_2048_start(const rsa_2048_int_t *base,
  * Start a variable-time RSA-2048 modular exponentiation.
  *
  * Do not use this construct with secret exponents; its timing depends on the
- * exponent.
+ * exponent. The exponent must be odd and at least 3. The common exponent
+ * 65537 has a specialized routine; others use generic square-and-multiply.
  *
  * Returns an `OTCRYPTO_ASYNC_INCOMPLETE` error if OTBN is busy.
  *
@@ -97,7 +98,8 @@ status_t rsa_modexp_consttime_3072_start(const rsa_3072_int_t *base,
  * Start a variable-time RSA-3072 modular exponentiation.
  *
  * Do not use this construct with secret exponents; its timing depends on the
- * exponent.
+ * exponent. The exponent must be odd and at least 3. The common exponent
+ * 65537 has a specialized routine; others use generic square-and-multiply.
  *
  * Returns an `OTCRYPTO_ASYNC_INCOMPLETE` error if OTBN is busy.
  *
@@ -143,7 +145,8 @@ status_t rsa_modexp_consttime_4096_start(const rsa_4096_int_t *base,
  * Start a variable-time RSA-4096 modular exponentiation.
  *
  * Do not use this construct with secret exponents; its timing depends on the
- * exponent.
+ * exponent. The exponent must be odd and at least 3. The common exponent
+ * 65537 has a specialized routine; others use generic square-and-multiply.
  *
  * Returns an `OTCRYPTO_ASYNC_INCOMPLETE` error if OTBN is busy.
  *
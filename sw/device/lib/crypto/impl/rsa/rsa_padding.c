@@ -269,6 +269,41 @@ static status_t digest_wordlen_get(otcrypto_hash_mode_t hash_mode,
   return OTCRYPTO_OK;
 }
 
+/**
+ * Compute one output block of MGF1: Hash(seed || counter).
+ *
+ * If `seed_ctx` is non-NULL, it is a hash stream that has already absorbed
+ * the seed; a copy of it is extended with the counter and finalized, leaving
+ * `seed_ctx` itself untouched for the next block. Otherwise the seed must be
+ * in the first `seed_len` bytes of `hash_input`, which must have room for the
+ * counter after it, and the block is computed with a one-shot hash.
+ *
+ * @param seed_ctx Hash stream that has absorbed the seed, or NULL.
+ * @param hash_input Seed followed by space for the counter (if no stream).
+ * @param seed_len Length of seed data in bytes.
+ * @param counter Block counter.
+ * @param[out] digest Destination for the block.
+ * @return Result of the operation (OK or error).
+ */
+OT_WARN_UNUSED_RESULT
+static status_t mgf1_block(const otcrypto_hash_context_t *seed_ctx,
+                           uint8_t *hash_input, size_t seed_len,
+                           uint32_t counter, otcrypto_hash_digest_t digest) {
+  uint32_t ctr = __builtin_bswap32(counter);
+  if (seed_ctx != NULL) {
+    otcrypto_hash_context_t ctx = *seed_ctx;
+    HARDENED_TRY(otcrypto_hash_update(
+        &ctx, (otcrypto_const_byte_buf_t){.data = (unsigned char *)&ctr,
+                                          .len = sizeof(ctr)}));
+    return otcrypto_hash_final(&ctx, digest);
+  }
+  memcpy(hash_input + seed_len, &ctr, sizeof(ctr));
+  return otcrypto_hash(
+      (otcrypto_const_byte_buf_t){.data = hash_input,
+                                  .len = seed_len + sizeof(ctr)},
+      digest);
+}
+
 /**
  * Mask generation function MGF1 (RFC 8017, appendix B.2.1).
  *
@@ -278,6 +313,11 @@ static status_t digest_wordlen_get(otcrypto_hash_mode_t hash_mode,
  * any extra bytes at the end of the mask will be initialized, but does not
  * make any guarantees about their values.
  *
+ * For SHA-2, the seed is absorbed into a single hash stream and each block
+ * continues from a copy of it, so the hash is only set up once per mask. SHA-3
+ * streams keep their state in the KMAC block and can't be copied, so those
+ * hash seed || counter from scratch for every block.
+ *
  * @param hash_mode Hash function to use.
  * @param seed Seed data.
  * @param seed_len Length of seed data in bytes.
@@ -297,21 +337,32 @@ static status_t mgf1(otcrypto_hash_mode_t hash_mode, const uint8_t *seed,
     return OTCRYPTO_BAD_ARGS;
   }
 
+  otcrypto_hash_context_t seed_ctx;
+  const otcrypto_hash_context_t *seed_ctx_ptr = NULL;
+  uint8_t hash_input[seed_len + sizeof(uint32_t)];
+  switch (hash_mode) {
+    case kOtcryptoHashModeSha256:
+      OT_FALLTHROUGH_INTENDED;
+    case kOtcryptoHashModeSha384:
+      OT_FALLTHROUGH_INTENDED;
+    case kOtcryptoHashModeSha512:
+      HARDENED_TRY(otcrypto_hash_init(&seed_ctx, hash_mode));
+      HARDENED_TRY(otcrypto_hash_update(
+          &seed_ctx,
+          (otcrypto_const_byte_buf_t){.data = seed, .len = seed_len}));
+      seed_ctx_ptr = &seed_ctx;
+      break;
+    default:
+      memcpy(hash_input, seed, seed_len);
+      break;
+  }
+
   // First, process the iterations in which the entire digest will fit in the
   // `mask` buffer.
-  uint8_t hash_input[seed_len + sizeof(uint32_t)];
-  memcpy(hash_input, seed, seed_len);
   for (uint32_t i = 0; i < num_iterations - 1; i++) {
-    uint32_t ctr = __builtin_bswap32(i);
-    memcpy(hash_input + seed_len, &ctr, sizeof(uint32_t));
     otcrypto_hash_digest_t digest = {
         .data = mask, .len = digest_wordlen, .mode = hash_mode};
-    HARDENED_TRY(otcrypto_hash(
-        (otcrypto_const_byte_buf_t){
-            .data = hash_input,
-            .len = sizeof(hash_input),
-        },
-        digest));
+    HARDENED_TRY(mgf1_block(seed_ctx_ptr, hash_input, seed_len, i, digest));
     mask += digest_wordlen;
     mask_len -= digest_bytelen;
   }
@@ -319,15 +370,11 @@ static status_t mgf1(otcrypto_hash_mode_t hash_mode, const uint8_t *seed,
 
   // Last iteration is special; use an intermediate buffer in case the digest
   // is longer than the remaining mask buffer.
-  uint32_t ctr = __builtin_bswap32(num_iterations - 1);
-  memcpy(hash_input + seed_len, &ctr, sizeof(uint32_t));
   uint32_t digest_data[digest_wordlen];
   otcrypto_hash_digest_t digest = {
       .data = digest_data, .len = digest_wordlen, .mode = hash_mode};
-  HARDENED_TRY(
-      otcrypto_hash((otcrypto_const_byte_buf_t){.data = hash_input,
-                                                .len = sizeof(hash_input)},
-                    digest));
+  HARDENED_TRY(mgf1_block(seed_ctx_ptr, hash_input, seed_len,
+                          num_iterations - 1, digest));
   hardened_memcpy(mask, digest_data, ceil_div(mask_len, sizeof(uint32_t)));
   return OTCRYPTO_OK;
 }
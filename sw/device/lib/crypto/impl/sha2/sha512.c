@@ -142,16 +142,14 @@ static status_t process_message_buffer(sha512_otbn_ctx_t *ctx) {
 }
 
 /**
- * Add a single message block to the processing buffer.
- *
- * Runs OTBN if the maximum number of message blocks has been reached.
+ * Write a single message block to the processing buffer in DMEM.
  *
  * @param ctx OTBN message buffer context information (updated in place).
  * @param block Block to write.
  * @return Result of the operation.
  */
-static status_t process_block(sha512_otbn_ctx_t *ctx,
-                              const sha512_message_block_t *block) {
+static status_t load_block(sha512_otbn_ctx_t *ctx,
+                           const sha512_message_block_t *block) {
   // Calculate the offset within the message buffer.
   size_t offset = ctx->num_blocks * kSha512MessageBlockBytes;
   otbn_addr_t dst = kOtbnVarSha512Msg + offset;
@@ -168,6 +166,21 @@ static status_t process_block(sha512_otbn_ctx_t *ctx,
     dst += sizeof(uint32_t);
   }
   ctx->num_blocks += 1;
+  return OTCRYPTO_OK;
+}
+
+/**
+ * Add a single message block to the processing buffer.
+ *
+ * Runs OTBN if the maximum number of message blocks has been reached.
+ *
+ * @param ctx OTBN message buffer context information (updated in place).
+ * @param block Block to write.
+ * @return Result of the operation.
+ */
+static status_t process_block(sha512_otbn_ctx_t *ctx,
+                              const sha512_message_block_t *block) {
+  HARDENED_TRY(load_block(ctx, block));
 
   // If we've reached the maximum number of message chunks for a single run,
   // then run the OTBN program to update the state in-place. Note that there
@@ -182,20 +195,20 @@ static status_t process_block(sha512_otbn_ctx_t *ctx,
 /**
  * Pad the block as described in FIPS 180-4, section 5.1.2.
  *
- * Padding fills the current block and may require one additional block. This
- * function calls `process_block` to load the padded block(s) into OTBN.
+ * Padding fills the current block and may require one additional block, which
+ * is written to `next`.
  *
  * The length of real data in the partial block should be the byte-length of
  * the message so far (total_len >> 3) modulo `kSha512MessageBlockBytes`.
  *
- * @param ctx OTBN message buffer context information (updated in place).
  * @param total_len Total length of message so far.
  * @param block Current (partial) block.
- * @return Result of the operation.
+ * @param[out] next Additional block, if needed.
+ * @return Number of padded blocks (1 or 2).
  */
-static status_t process_padding(sha512_otbn_ctx_t *ctx,
-                                const sha512_message_length_t total_len,
-                                sha512_message_block_t *block) {
+static size_t pad_blocks(const sha512_message_length_t total_len,
+                         sha512_message_block_t *block,
+                         sha512_message_block_t *next) {
   size_t partial_block_len = (total_len.lower >> 3) % kSha512MessageBlockBytes;
 
   // Get a byte-sized pointer to the end of the real data within the block.
@@ -210,27 +223,88 @@ static status_t process_padding(sha512_otbn_ctx_t *ctx,
   // kSha512MessageBlockBytes.
   memset(data_end, 0x80, 1);
 
+  size_t num_blocks = 1;
+  sha512_message_block_t *last = block;
   if (partial_block_len + 1 + 2 * sizeof(uint64_t) > kSha512MessageBlockBytes) {
     // We need to use the additional block. The first block is already
-    // complete, so process it and then zero out the block data again to
-    // prepare the next one.
-    HARDENED_TRY(process_block(ctx, block));
-    memset(block, 0, kSha512MessageBlockBytes);
+    // complete, so the length goes into a zeroed second block.
+    memset(next, 0, kSha512MessageBlockBytes);
+    last = next;
+    num_blocks = 2;
   }
 
   // Set the last 128 bits (=4 32b words) of the final block to the bit-length
   // in big-endian form.
-  block->data[kSha512MessageBlockWords - 1] =
+  last->data[kSha512MessageBlockWords - 1] =
       __builtin_bswap32(total_len.lower & UINT32_MAX);
-  block->data[kSha512MessageBlockWords - 2] =
+  last->data[kSha512MessageBlockWords - 2] =
       __builtin_bswap32(total_len.lower >> 32);
-  block->data[kSha512MessageBlockWords - 3] =
+  last->data[kSha512MessageBlockWords - 3] =
       __builtin_bswap32(total_len.upper & UINT32_MAX);
-  block->data[kSha512MessageBlockWords - 4] =
+  last->data[kSha512MessageBlockWords - 4] =
       __builtin_bswap32(total_len.upper >> 32);
+  return num_blocks;
+}
+
+/**
+ * Pad the block and load the padded block(s) into OTBN.
+ *
+ * Calls `process_block`, so OTBN runs if the message buffer fills up.
+ *
+ * @param ctx OTBN message buffer context information (updated in place).
+ * @param total_len Total length of message so far.
+ * @param block Current (partial) block.
+ * @return Result of the operation.
+ */
+static status_t process_padding(sha512_otbn_ctx_t *ctx,
+                                const sha512_message_length_t total_len,
+                                sha512_message_block_t *block) {
+  sha512_message_block_t next;
+  size_t num_blocks = pad_blocks(total_len, block, &next);
+  HARDENED_TRY(process_block(ctx, block));
+  if (num_blocks == 2) {
+    HARDENED_TRY(process_block(ctx, &next));
+  }
+  return OTCRYPTO_OK;
+}
+
+/**
+ * Write the hash state to DMEM.
+ *
+ * The OTBN app expects the state in a pre-processed format, with the 64-bit
+ * state words aligned to wide-word boundaries.
+ *
+ * @param H Hash state.
+ * @return Result of the operation.
+ */
+static status_t state_write(const uint32_t *H) {
+  otbn_addr_t state_write_addr = kOtbnVarSha512State;
+  for (size_t i = 0; i + 1 < kSha512StateWords; i += 2) {
+    HARDENED_TRY(otbn_dmem_write(1, &H[i + 1], state_write_addr));
+    HARDENED_TRY(
+        otbn_dmem_write(1, &H[i], state_write_addr + sizeof(uint32_t)));
+    state_write_addr += kOtbnWideWordNumBytes;
+  }
+  return OTCRYPTO_OK;
+}
 
-  // Process the last block.
-  return process_block(ctx, block);
+/**
+ * Read the hash state from DMEM.
+ *
+ * The state is still in the special form the OTBN app uses, with the 64-bit
+ * state words aligned to wide-word boundaries.
+ *
+ * @param[out] H Hash state.
+ * @return Result of the operation.
+ */
+static status_t state_read(uint32_t *H) {
+  otbn_addr_t state_read_addr = kOtbnVarSha512State;
+  for (size_t i = 0; i + 1 < kSha512StateWords; i += 2) {
+    HARDENED_TRY(otbn_dmem_read(1, state_read_addr, &H[i + 1]));
+    HARDENED_TRY(otbn_dmem_read(1, state_read_addr + sizeof(uint32_t), &H[i]));
+    state_read_addr += kOtbnWideWordNumBytes;
+  }
+  return OTCRYPTO_OK;
 }
 
 /**
@@ -253,15 +327,8 @@ static status_t process_message(sha512_state_t *state, const uint8_t *msg,
   sha512_state_t new_state;
   HARDENED_TRY(get_new_total_len(state, msg_len, &new_state.total_len));
 
-  // Set the initial state. The OTBN app expects the state in a pre-processed
-  // format, with the 64-bit state words aligned to wide-word boundaries.
-  otbn_addr_t state_write_addr = kOtbnVarSha512State;
-  for (size_t i = 0; i + 1 < kSha512StateWords; i += 2) {
-    HARDENED_TRY(otbn_dmem_write(1, &state->H[i + 1], state_write_addr));
-    HARDENED_TRY(
-        otbn_dmem_write(1, &state->H[i], state_write_addr + sizeof(uint32_t)));
-    state_write_addr += kOtbnWideWordNumBytes;
-  }
+  // Set the initial state.
+  HARDENED_TRY(state_write(state->H));
 
   // Start computing the first block for the hash computation by simply copying
   // the partial block. We won't use the partial block directly to avoid
@@ -301,16 +368,8 @@ static status_t process_message(sha512_state_t *state, const uint8_t *msg,
     HARDENED_TRY(process_message_buffer(&ctx));
   }
 
-  // Read the final state from OTBN dmem. The state is still in the special
-  // form the OTBN app uses, with the 64-bit state words aligned to wide-word
-  // boundaries.
-  otbn_addr_t state_read_addr = kOtbnVarSha512State;
-  for (size_t i = 0; i + 1 < kSha512StateWords; i += 2) {
-    HARDENED_TRY(otbn_dmem_read(1, state_read_addr, &new_state.H[i + 1]));
-    HARDENED_TRY(
-        otbn_dmem_read(1, state_read_addr + sizeof(uint32_t), &new_state.H[i]));
-    state_read_addr += kOtbnWideWordNumBytes;
-  }
+  // Read the final state from OTBN dmem.
+  HARDENED_TRY(state_read(new_state.H));
 
   // Clear OTBN's memory.
   HARDENED_TRY(otbn_dmem_sec_wipe());
@@ -424,3 +483,132 @@ status_t sha384(const uint8_t *msg, const size_t msg_len, uint32_t *digest) {
   state_shred(&state);
   return OTCRYPTO_OK;
 }
+
+/**
+ * Load the next run of message blocks into OTBN and start it.
+ *
+ * Loads up to `kSha512MaxMessageChunksPerOtbnRun` blocks. If the rest of the
+ * message and its padding fit, they are loaded as well and the run is the
+ * last one.
+ *
+ * @param ctx Context object; updated in-place.
+ * @return Result of the operation.
+ */
+static status_t async_run_start(sha512_async_ctx_t *ctx) {
+  sha512_otbn_ctx_t otbn_ctx = {.num_blocks = 0};
+  sha512_message_block_t block;
+  while (otbn_ctx.num_blocks < kSha512MaxMessageChunksPerOtbnRun &&
+         ctx->msg_len >= kSha512MessageBlockBytes) {
+    memcpy(block.data, ctx->msg, kSha512MessageBlockBytes);
+    HARDENED_TRY(load_block(&otbn_ctx, &block));
+    ctx->msg += kSha512MessageBlockBytes;
+    ctx->msg_len -= kSha512MessageBlockBytes;
+  }
+
+  if (ctx->msg_len < kSha512MessageBlockBytes) {
+    // The rest of the message is a partial block. Pad it, and finish the
+    // message in this run if there is space for the padded block(s).
+    sha512_message_block_t next;
+    memcpy(block.data, ctx->msg, ctx->msg_len);
+    size_t num_blocks = pad_blocks(ctx->total_len, &block, &next);
+    if (otbn_ctx.num_blocks + num_blocks <= kSha512MaxMessageChunksPerOtbnRun) {
+      HARDENED_TRY(load_block(&otbn_ctx, &block));
+      if (num_blocks == 2) {
+        HARDENED_TRY(load_block(&otbn_ctx, &next));
+      }
+      ctx->msg_len = 0;
+      ctx->pending = kHardenedBoolFalse;
+    }
+  }
+
+  HARDENED_TRY(otbn_dmem_write(1, &otbn_ctx.num_blocks, kOtbnVarSha512NChunks));
+  return otbn_execute();
+}
+
+/**
+ * Start an asynchronous computation from the given initial state.
+ *
+ * @param[out] ctx Context object.
+ * @param initial_state Initial state for SHA-512 or SHA-384.
+ * @param msg Input message.
+ * @param msg_len Input message length in bytes.
+ * @return Result of the operation.
+ */
+static status_t async_start(sha512_async_ctx_t *ctx,
+                            const uint32_t *initial_state, const uint8_t *msg,
+                            size_t msg_len) {
+  // Load the SHA-512 app. Fails if OTBN is non-idle.
+  HARDENED_TRY(otbn_load_app(kOtbnAppSha512));
+  HARDENED_TRY(state_write(initial_state));
+
+  ctx->msg = msg;
+  ctx->msg_len = msg_len;
+  ctx->total_len.lower = (uint64_t)msg_len << 3;
+  ctx->total_len.upper = 0;
+  ctx->pending = kHardenedBoolTrue;
+  return async_run_start(ctx);
+}
+
+status_t sha512_async_start(sha512_async_ctx_t *ctx, const uint8_t *msg,
+                            size_t msg_len) {
+  return async_start(ctx, kSha512InitialState, msg, msg_len);
+}
+
+status_t sha384_async_start(sha512_async_ctx_t *ctx, const uint8_t *msg,
+                            size_t msg_len) {
+  return async_start(ctx, kSha384InitialState, msg, msg_len);
+}
+
+status_t sha512_async_poll(sha512_async_ctx_t *ctx) {
+  status_t result = otbn_poll_done();
+  if (result.value == OTCRYPTO_ASYNC_INCOMPLETE.value) {
+    return OTCRYPTO_ASYNC_INCOMPLETE;
+  }
+  HARDENED_TRY(result);
+  if (launder32(ctx->pending) == kHardenedBoolFalse) {
+    return OTCRYPTO_OK;
+  }
+  // The state stays in DMEM between runs; only the message buffer needs to
+  // be refilled.
+  HARDENED_TRY(async_run_start(ctx));
+  return OTCRYPTO_ASYNC_INCOMPLETE;
+}
+
+status_t sha512_async_flush(sha512_async_ctx_t *ctx) {
+  while (launder32(ctx->pending) == kHardenedBoolTrue) {
+    HARDENED_TRY(otbn_busy_wait_for_done());
+    HARDENED_TRY(async_run_start(ctx));
+  }
+  HARDENED_CHECK_EQ(ctx->pending, kHardenedBoolFalse);
+  return OTCRYPTO_OK;
+}
+
+/**
+ * Wait for the last run and read the final state.
+ *
+ * @param[out] state Context object; only the `H` field is set.
+ * @return Result of the operation.
+ */
+static status_t async_state_get(sha512_state_t *state) {
+  HARDENED_TRY(otbn_busy_wait_for_done());
+  HARDENED_TRY(state_read(state->H));
+
+  // Clear OTBN's memory.
+  return otbn_dmem_sec_wipe();
+}
+
+status_t sha512_async_finalize(uint32_t *digest) {
+  sha512_state_t state;
+  HARDENED_TRY(async_state_get(&state));
+  sha512_digest_get(&state, digest);
+  hardened_memshred(state.H, kSha512StateWords);
+  return OTCRYPTO_OK;
+}
+
+status_t sha384_async_finalize(uint32_t *digest) {
+  sha512_state_t state;
+  HARDENED_TRY(async_state_get(&state));
+  sha384_digest_get(&state, digest);
+  hardened_memshred(state.H, kSha512StateWords);
+  return OTCRYPTO_OK;
+}
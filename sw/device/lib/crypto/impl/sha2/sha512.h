@@ -7,24 +7,13 @@
 
 #include "sw/device/lib/base/hardened.h"
 #include "sw/device/lib/crypto/drivers/otbn.h"
+#include "sw/device/lib/crypto/include/hash.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif  // __cplusplus
 
 enum {
-  /**
-   * SHA-384 digest size in bits.
-   */
-  kSha384DigestBits = 384,
-  /**
-   * SHA-384 digest size in bytes.
-   */
-  kSha384DigestBytes = kSha384DigestBits / 8,
-  /**
-   * SHA-384 digest size in words.
-   */
-  kSha384DigestWords = kSha384DigestBytes / sizeof(uint32_t),
   /**
    * SHA-512 message block size in bits.
    */
@@ -49,18 +38,6 @@ enum {
    * SHA-512 state buffer size in words.
    */
   kSha512StateWords = kSha512StateBytes / sizeof(uint32_t),
-  /**
-   * SHA-512 digest size in bits.
-   */
-  kSha512DigestBits = 512,
-  /**
-   * SHA-512 digest size in bytes.
-   */
-  kSha512DigestBytes = kSha512DigestBits / 8,
-  /**
-   * SHA-512 digest size in words.
-   */
-  kSha512DigestWords = kSha512DigestBytes / sizeof(uint32_t),
 };
 
 /**
@@ -246,6 +223,117 @@ status_t sha512_update(sha512_state_t *state, const uint8_t *msg,
 OT_WARN_UNUSED_RESULT
 status_t sha512_final(sha512_state_t *state, uint32_t *digest);
 
+/**
+ * A type that holds the context for an asynchronous one-shot SHA-512 or
+ * SHA-384 computation on OTBN.
+ *
+ * The hash state itself stays in OTBN's DMEM; the context only tracks the part
+ * of the message that has not been handed to OTBN yet.
+ */
+typedef struct sha512_async_ctx {
+  /**
+   * Message data not yet loaded into OTBN.
+   */
+  const uint8_t *msg;
+  /**
+   * Length of `msg` in bytes.
+   */
+  size_t msg_len;
+  /**
+   * Total message length, in bits.
+   */
+  sha512_message_length_t total_len;
+  /**
+   * Whether OTBN runs remain to be started after the current one.
+   */
+  hardened_bool_t pending;
+} sha512_async_ctx_t;
+
+/**
+ * Starts an asynchronous one-shot SHA-512 hash computation on OTBN.
+ *
+ * Loads the SHA-512 app and the first run of message blocks, and starts OTBN
+ * without waiting for it. OTBN processes at most 16 blocks per run; later runs
+ * are started by `sha512_async_poll()` or `sha512_async_flush()`, so the
+ * message must stay valid until `ctx->pending` is `kHardenedBoolFalse`.
+ *
+ * Returns OTCRYPTO_ASYNC_INCOMPLETE if OTBN is busy.
+ *
+ * @param[out] ctx Context object for the computation.
+ * @param msg Input message.
+ * @param msg_len Input message length in bytes.
+ * @return Result of the operation (OK or error).
+ */
+OT_WARN_UNUSED_RESULT
+status_t sha512_async_start(sha512_async_ctx_t *ctx, const uint8_t *msg,
+                            size_t msg_len);
+
+/**
+ * Starts an asynchronous one-shot SHA-384 hash computation on OTBN.
+ *
+ * Same as `sha512_async_start()`, but with the SHA-384 initial state.
+ *
+ * @param[out] ctx Context object for the computation.
+ * @param msg Input message.
+ * @param msg_len Input message length in bytes.
+ * @return Result of the operation (OK or error).
+ */
+OT_WARN_UNUSED_RESULT
+status_t sha384_async_start(sha512_async_ctx_t *ctx, const uint8_t *msg,
+                            size_t msg_len);
+
+/**
+ * Advances an asynchronous SHA-512/SHA-384 computation without blocking.
+ *
+ * If OTBN has finished its current run and message data remains, loads and
+ * starts the next run.
+ *
+ * @param ctx Context object for the computation; updated in-place.
+ * @return `OTCRYPTO_OK` once OTBN has finished the last run,
+ * `OTCRYPTO_ASYNC_INCOMPLETE` while it has not, or an error.
+ */
+OT_WARN_UNUSED_RESULT
+status_t sha512_async_poll(sha512_async_ctx_t *ctx);
+
+/**
+ * Blocks until the last OTBN run of a computation has been started.
+ *
+ * Afterwards, the message is no longer needed and only the last run may still
+ * be in progress.
+ *
+ * @param ctx Context object for the computation; updated in-place.
+ * @return Result of the operation (OK or error).
+ */
+OT_WARN_UNUSED_RESULT
+status_t sha512_async_flush(sha512_async_ctx_t *ctx);
+
+/**
+ * Finishes an asynchronous SHA-512 computation.
+ *
+ * Waits for the last OTBN run, reads the digest and clears OTBN's DMEM. The
+ * last run must have been started (see `sha512_async_flush()`).
+ *
+ * The caller must ensure that at least `kSha512DigestBytes` bytes of space are
+ * available at the location pointed to by `digest`.
+ *
+ * @param[out] digest Output buffer for digest.
+ * @return Result of the operation (OK or error).
+ */
+OT_WARN_UNUSED_RESULT
+status_t sha512_async_finalize(uint32_t *digest);
+
+/**
+ * Finishes an asynchronous SHA-384 computation.
+ *
+ * Same as `sha512_async_finalize()`, but writes a `kSha384DigestBytes`-byte
+ * digest.
+ *
+ * @param[out] digest Output buffer for digest.
+ * @return Result of the operation (OK or error).
+ */
+OT_WARN_UNUSED_RESULT
+status_t sha384_async_finalize(uint32_t *digest);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
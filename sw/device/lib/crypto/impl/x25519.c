@@ -4,6 +4,10 @@
 
 #include "sw/device/lib/crypto/include/x25519.h"
 
+#include "sw/device/lib/crypto/drivers/entropy.h"
+#include "sw/device/lib/crypto/impl/ecc/x25519.h"
+#include "sw/device/lib/crypto/impl/integrity.h"
+#include "sw/device/lib/crypto/impl/keyblob.h"
 #include "sw/device/lib/crypto/impl/status.h"
 #include "sw/device/lib/crypto/include/datatypes.h"
 
@@ -12,38 +16,239 @@
 
 otcrypto_status_t otcrypto_x25519_keygen(otcrypto_blinded_key_t *private_key,
                                          otcrypto_unblinded_key_t *public_key) {
-  // TODO: Connect X25519 operations to API.
-  return OTCRYPTO_NOT_IMPLEMENTED;
+  HARDENED_TRY(otcrypto_x25519_keygen_async_start(private_key));
+  return otcrypto_x25519_keygen_async_finalize(private_key, public_key);
 }
 
 otcrypto_status_t otcrypto_x25519(const otcrypto_blinded_key_t *private_key,
                                   const otcrypto_unblinded_key_t *public_key,
                                   otcrypto_blinded_key_t *shared_secret) {
-  // TODO: Connect X25519 operations to API.
-  return OTCRYPTO_NOT_IMPLEMENTED;
+  HARDENED_TRY(otcrypto_x25519_async_start(private_key, public_key));
+  return otcrypto_x25519_async_finalize(shared_secret);
+}
+
+/**
+ * Check the lengths of private keys for X25519.
+ *
+ * If this check passes and `hw_backed` is false, it is safe to interpret
+ * `private_key->keyblob` as a `x25519_masked_scalar_t *`.
+ *
+ * @param private_key Private key struct to check.
+ * @return OK if the lengths are correct or BAD_ARGS otherwise.
+ */
+OT_WARN_UNUSED_RESULT
+static status_t x25519_private_key_length_check(
+    const otcrypto_blinded_key_t *private_key) {
+  if (private_key->keyblob == NULL) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+
+  if (launder32(private_key->config.hw_backed) == kHardenedBoolTrue) {
+    // Skip the length check in this case; if the salt is the wrong length, the
+    // keyblob library will catch it before we sideload the key.
+    return OTCRYPTO_OK;
+  }
+  HARDENED_CHECK_NE(private_key->config.hw_backed, kHardenedBoolTrue);
+
+  // Check the unmasked length.
+  if (launder32(private_key->config.key_length) != kX25519ScalarBytes) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+  HARDENED_CHECK_EQ(private_key->config.key_length, kX25519ScalarBytes);
+
+  // Check the single-share length.
+  if (launder32(keyblob_share_num_words(private_key->config)) !=
+      kX25519MaskedScalarShareWords) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+  HARDENED_CHECK_EQ(keyblob_share_num_words(private_key->config),
+                    kX25519MaskedScalarShareWords);
+
+  // Check the keyblob length.
+  if (launder32(private_key->keyblob_length) !=
+      sizeof(x25519_masked_scalar_t)) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+  HARDENED_CHECK_EQ(private_key->keyblob_length,
+                    sizeof(x25519_masked_scalar_t));
+
+  return OTCRYPTO_OK;
+}
+
+/**
+ * Check the length of public keys for X25519.
+ *
+ * If this check passes, it is safe to interpret `public_key->key` as an
+ * encoded u-coordinate of `kX25519CoordWords` words.
+ *
+ * @param public_key Public key struct to check.
+ * @return OK if the lengths are correct or BAD_ARGS otherwise.
+ */
+OT_WARN_UNUSED_RESULT
+static status_t x25519_public_key_length_check(
+    const otcrypto_unblinded_key_t *public_key) {
+  if (launder32(public_key->key_length) != kX25519CoordBytes) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+  HARDENED_CHECK_EQ(public_key->key_length, kX25519CoordBytes);
+  return OTCRYPTO_OK;
 }
 
 otcrypto_status_t otcrypto_x25519_keygen_async_start(
     const otcrypto_blinded_key_t *private_key) {
-  // TODO: X25519 is not yet implemented.
-  return OTCRYPTO_NOT_IMPLEMENTED;
+  if (private_key == NULL || private_key->keyblob == NULL) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+
+  // Check the key mode.
+  if (launder32(private_key->config.key_mode) != kOtcryptoKeyModeX25519) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+  HARDENED_CHECK_EQ(private_key->config.key_mode, kOtcryptoKeyModeX25519);
+
+  // Check that the entropy complex is initialized.
+  HARDENED_TRY(entropy_complex_check());
+
+  if (launder32(private_key->config.hw_backed) == kHardenedBoolTrue) {
+    HARDENED_CHECK_EQ(private_key->config.hw_backed, kHardenedBoolTrue);
+    HARDENED_TRY(keyblob_sideload_key_otbn(private_key));
+    return x25519_sideload_keygen_start();
+  } else if (launder32(private_key->config.hw_backed) == kHardenedBoolFalse) {
+    HARDENED_CHECK_EQ(private_key->config.hw_backed, kHardenedBoolFalse);
+    return x25519_keygen_start();
+  }
+
+  // Invalid value for `hw_backed`.
+  return OTCRYPTO_BAD_ARGS;
 }
 
 otcrypto_status_t otcrypto_x25519_keygen_async_finalize(
     otcrypto_blinded_key_t *private_key, otcrypto_unblinded_key_t *public_key) {
-  // TODO: X25519 is not yet implemented.
-  return OTCRYPTO_NOT_IMPLEMENTED;
+  // Check for any NULL pointers.
+  if (private_key == NULL || public_key == NULL ||
+      private_key->keyblob == NULL || public_key->key == NULL) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+
+  // Check the key modes.
+  if (launder32(private_key->config.key_mode) != kOtcryptoKeyModeX25519 ||
+      launder32(public_key->key_mode) != kOtcryptoKeyModeX25519) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+  HARDENED_CHECK_EQ(private_key->config.key_mode, kOtcryptoKeyModeX25519);
+  HARDENED_CHECK_EQ(public_key->key_mode, kOtcryptoKeyModeX25519);
+
+  // Check the lengths of caller-allocated buffers.
+  HARDENED_TRY(x25519_private_key_length_check(private_key));
+  HARDENED_TRY(x25519_public_key_length_check(public_key));
+
+  // Note: The `finalize` operations wipe DMEM after retrieving the keys, so if
+  // an error occurs after this point then the keys would be unrecoverable.
+  // The `finalize` call should be the last potentially error-causing line
+  // before returning to the caller.
+
+  if (launder32(private_key->config.hw_backed) == kHardenedBoolTrue) {
+    HARDENED_CHECK_EQ(private_key->config.hw_backed, kHardenedBoolTrue);
+    HARDENED_TRY(x25519_sideload_keygen_finalize(public_key->key));
+  } else if (launder32(private_key->config.hw_backed) == kHardenedBoolFalse) {
+    HARDENED_CHECK_EQ(private_key->config.hw_backed, kHardenedBoolFalse);
+    x25519_masked_scalar_t *sk = (x25519_masked_scalar_t *)private_key->keyblob;
+    HARDENED_TRY(x25519_keygen_finalize(sk, public_key->key));
+    private_key->checksum = integrity_blinded_checksum(private_key);
+  } else {
+    return OTCRYPTO_BAD_ARGS;
+  }
+
+  // Prepare the public key.
+  public_key->checksum = integrity_unblinded_checksum(public_key);
+
+  // Clear the OTBN sideload slot (in case the seed was sideloaded).
+  return keyblob_sideload_clear_otbn();
 }
 
 otcrypto_status_t otcrypto_x25519_async_start(
     const otcrypto_blinded_key_t *private_key,
     const otcrypto_unblinded_key_t *public_key) {
-  // TODO: X25519 is not yet implemented.
-  return OTCRYPTO_NOT_IMPLEMENTED;
+  if (private_key == NULL || public_key == NULL || public_key->key == NULL ||
+      private_key->keyblob == NULL) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+
+  // Check the integrity of the keys.
+  if (launder32(integrity_blinded_key_check(private_key)) !=
+          kHardenedBoolTrue ||
+      launder32(integrity_unblinded_key_check(public_key)) !=
+          kHardenedBoolTrue) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+  HARDENED_CHECK_EQ(integrity_blinded_key_check(private_key),
+                    kHardenedBoolTrue);
+  HARDENED_CHECK_EQ(integrity_unblinded_key_check(public_key),
+                    kHardenedBoolTrue);
+
+  // Check the key modes.
+  if (launder32(private_key->config.key_mode) != kOtcryptoKeyModeX25519 ||
+      launder32(public_key->key_mode) != kOtcryptoKeyModeX25519) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+  HARDENED_CHECK_EQ(private_key->config.key_mode, kOtcryptoKeyModeX25519);
+  HARDENED_CHECK_EQ(public_key->key_mode, kOtcryptoKeyModeX25519);
+
+  // Check the key lengths.
+  HARDENED_TRY(x25519_private_key_length_check(private_key));
+  HARDENED_TRY(x25519_public_key_length_check(public_key));
+
+  if (launder32(private_key->config.hw_backed) == kHardenedBoolTrue) {
+    HARDENED_CHECK_EQ(private_key->config.hw_backed, kHardenedBoolTrue);
+    HARDENED_TRY(keyblob_sideload_key_otbn(private_key));
+    return x25519_sideload_start(public_key->key);
+  } else if (launder32(private_key->config.hw_backed) == kHardenedBoolFalse) {
+    HARDENED_CHECK_EQ(private_key->config.hw_backed, kHardenedBoolFalse);
+    x25519_masked_scalar_t *sk = (x25519_masked_scalar_t *)private_key->keyblob;
+    return x25519_start(sk, public_key->key);
+  }
+
+  // Invalid value for `hw_backed`.
+  return OTCRYPTO_BAD_ARGS;
 }
 
 otcrypto_status_t otcrypto_x25519_async_finalize(
     otcrypto_blinded_key_t *shared_secret) {
-  // TODO: X25519 is not yet implemented.
-  return OTCRYPTO_NOT_IMPLEMENTED;
+  if (shared_secret == NULL || shared_secret->keyblob == NULL) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+
+  // Shared keys cannot be sideloaded because they are software-generated.
+  if (launder32(shared_secret->config.hw_backed) != kHardenedBoolFalse) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+  HARDENED_CHECK_EQ(shared_secret->config.hw_backed, kHardenedBoolFalse);
+
+  // Check shared secret length.
+  if (launder32(shared_secret->config.key_length) != kX25519CoordBytes) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+  HARDENED_CHECK_EQ(shared_secret->config.key_length, kX25519CoordBytes);
+  if (launder32(shared_secret->keyblob_length) !=
+      keyblob_num_words(shared_secret->config) * sizeof(uint32_t)) {
+    return OTCRYPTO_BAD_ARGS;
+  }
+  HARDENED_CHECK_EQ(
+      shared_secret->keyblob_length,
+      keyblob_num_words(shared_secret->config) * sizeof(uint32_t));
+
+  // Note: This operation wipes DMEM after retrieving the keys, so if an error
+  // occurs after this point then the keys would be unrecoverable. This should
+  // be the last potentially error-causing line before returning to the caller.
+  x25519_shared_key_t ss;
+  HARDENED_TRY(x25519_finalize(&ss));
+
+  keyblob_from_shares(ss.share0, ss.share1, shared_secret->config,
+                      shared_secret->keyblob);
+
+  // Set the checksum.
+  shared_secret->checksum = integrity_blinded_checksum(shared_secret);
+
+  // Clear the OTBN sideload slot (in case the key was sideloaded).
+  return keyblob_sideload_clear_otbn();
 }
@@ -60,6 +60,25 @@ typedef enum otcrypto_aes_padding {
   kOtcryptoAesPaddingNull = 0x8ce,
 } otcrypto_aes_padding_t;
 
+enum {
+  /**
+   * The size of the opaque AES session struct in words.
+   * We assert that this value is large enough to host the internal session
+   * struct.
+   */
+  kOtcryptoAesSessionStructWords = 24,
+};
+
+/**
+ * Generic opaque AES session.
+ *
+ * Representation is internal to the AES implementation; initialize with
+ * #otcrypto_aes_session_start.
+ */
+typedef struct otcrypto_aes_session {
+  uint32_t data[kOtcryptoAesSessionStructWords];
+} otcrypto_aes_session_t;
+
 /**
  * Get the number of blocks needed for the plaintext length and padding mode.
  *
@@ -110,6 +129,69 @@ otcrypto_status_t otcrypto_aes(const otcrypto_blinded_key_t *key,
                                otcrypto_aes_padding_t aes_padding,
                                otcrypto_byte_buf_t cipher_output);
 
+/**
+ * Starts a persistent AES session.
+ *
+ * Loads the key and IV into the AES block once, so that many chunks of data
+ * can then be processed under the same key with
+ * #otcrypto_aes_session_update without re-keying or draining the hardware
+ * pipeline between chunks. This is meant for encrypting many small packets
+ * under one key.
+ *
+ * The session holds the AES block until #otcrypto_aes_session_end is called;
+ * no other AES operation may run in between. No padding is applied.
+ *
+ * @param key Pointer to the blinded key struct with key shares.
+ * @param iv Initialization vector, used for CBC, CFB, OFB, CTR modes. May be
+ *           NULL if mode is ECB.
+ * @param aes_mode Required AES mode of operation.
+ * @param aes_operation Required AES operation (encrypt or decrypt).
+ * @param[out] session Session object to initialize.
+ * @return The result of the operation.
+ */
+otcrypto_status_t otcrypto_aes_session_start(
+    const otcrypto_blinded_key_t *key, otcrypto_word32_buf_t iv,
+    otcrypto_aes_mode_t aes_mode, otcrypto_aes_operation_t aes_operation,
+    otcrypto_aes_session_t *session);
+
+/**
+ * Processes a chunk of data in a persistent AES session.
+ *
+ * In CTR mode, the chunk may have any length; otherwise it must be a multiple
+ * of the AES block size. The input and output must have the same length and
+ * may be the same buffer, but must not otherwise overlap. Word-aligned
+ * buffers are read and written by the hardware interface directly, without
+ * intermediate copies.
+ *
+ * To keep the pipeline full, up to two output blocks of a chunk are written
+ * by the following call to this function or by #otcrypto_aes_session_end, so
+ * the output buffer must remain valid until then. The exception is a CTR
+ * chunk that ends in a partial block, which is written out completely.
+ *
+ * @param session Session object.
+ * @param cipher_input Input data to be ciphered.
+ * @param[out] cipher_output Output data after cipher operation.
+ * @return The result of the operation.
+ */
+otcrypto_status_t otcrypto_aes_session_update(
+    otcrypto_aes_session_t *session, otcrypto_const_byte_buf_t cipher_input,
+    otcrypto_byte_buf_t cipher_output);
+
+/**
+ * Ends a persistent AES session.
+ *
+ * Writes the outstanding output blocks, clears the key from the AES block and
+ * releases the hardware. If `iv.data` is non-NULL, the final IV is written to
+ * it (not for ECB mode). In CTR mode, the final IV counts a trailing partial
+ * block as a whole one.
+ *
+ * @param session Session object.
+ * @param[out] iv Buffer for the final IV (may have NULL data).
+ * @return The result of the operation.
+ */
+otcrypto_status_t otcrypto_aes_session_end(otcrypto_aes_session_t *session,
+                                           otcrypto_word32_buf_t iv);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
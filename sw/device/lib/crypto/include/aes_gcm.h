@@ -39,7 +39,12 @@ typedef enum otcrypto_aes_gcm_tag_len {
  * change.
  */
 typedef struct otcrypto_aes_gcm_context {
+#ifdef OTCRYPTO_GHASH_TABLE8
+  // 8-bit GHASH tables hold 240 more blocks.
+  uint32_t data[98 + 240 * 4];
+#else
   uint32_t data[98];
+#endif
 } otcrypto_aes_gcm_context_t;
 
 /**
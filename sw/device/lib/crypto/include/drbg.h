@@ -90,6 +90,10 @@ otcrypto_status_t otcrypto_drbg_manual_reseed(
  * multiple of 4, some output from the hardware will be discarded. This detail
  * may be important for known-answer tests.
  *
+ * If the output pool is enabled (see `otcrypto_drbg_pool_enable`), requests
+ * with no additional input and at most 32 bytes of output are served from
+ * prefetched DRBG output instead of a fresh generate command.
+ *
  * @param additional_input Pointer to the additional data.
  * @param[out] drbg_output Pointer to the generated pseudo random bits.
  * @return Result of the DRBG generate operation.
@@ -120,6 +124,58 @@ otcrypto_status_t otcrypto_drbg_manual_generate(
     otcrypto_const_byte_buf_t additional_input,
     otcrypto_word32_buf_t drbg_output);
 
+/**
+ * Starts an asynchronous DRBG generate operation.
+ *
+ * Issues the generate command for `output_len` words and returns without
+ * waiting for the output, so that the hardware produces random bits while the
+ * caller does other work. Collect the output with
+ * `otcrypto_drbg_generate_async_finalize`.
+ *
+ * The output is checked for FIPS compatibility as in `otcrypto_drbg_generate`,
+ * but is never served from the output pool. No other DRBG function may be
+ * called until the operation is finalized.
+ *
+ * @param additional_input Pointer to the additional data.
+ * @param output_len Length of the expected output in 32-bit words.
+ * @return Result of the DRBG generate start operation.
+ */
+otcrypto_status_t otcrypto_drbg_generate_async_start(
+    otcrypto_const_byte_buf_t additional_input, size_t output_len);
+
+/**
+ * Finalizes an asynchronous DRBG generate operation.
+ *
+ * May block until the operation is complete.
+ *
+ * The length of `drbg_output` must match the `output_len` passed to the
+ * `_start` function; otherwise `OTCRYPTO_BAD_ARGS` is returned and the
+ * operation stays pending.
+ *
+ * @param[out] drbg_output Pointer to the generated pseudo random bits.
+ * @return Result of the DRBG generate finalize operation.
+ */
+otcrypto_status_t otcrypto_drbg_generate_async_finalize(
+    otcrypto_word32_buf_t drbg_output);
+
+/**
+ * Enables or disables the DRBG output pool.
+ *
+ * The pool holds prefetched DRBG output for small `otcrypto_drbg_generate`
+ * calls, and is refilled in the background when it runs low. It only accepts
+ * FIPS-compatible output, and is wiped whenever the DRBG is instantiated,
+ * reseeded or uninstantiated. `otcrypto_drbg_manual_generate` and calls with
+ * additional input always issue a fresh generate command.
+ *
+ * The pool is disabled by default. Refills progress whenever the pool is used;
+ * see `entropy_pool_irq_handler` in the entropy driver to also advance them
+ * from CSRNG's `cs_cmd_req_done` interrupt.
+ *
+ * @param enable Whether to enable the pool.
+ * @return Result of the operation.
+ */
+otcrypto_status_t otcrypto_drbg_pool_enable(hardened_bool_t enable);
+
 /**
  * Uninstantiates DRBG and clears the context.
  *
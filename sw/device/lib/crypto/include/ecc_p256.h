@@ -83,6 +83,35 @@ otcrypto_status_t otcrypto_ecdsa_p256_verify(
     otcrypto_const_word32_buf_t signature,
     hardened_bool_t *verification_result);
 
+/**
+ * Verifies a batch of ECDSA/P-256 signatures.
+ *
+ * Equivalent to calling `otcrypto_ecdsa_p256_verify` on each (public key,
+ * digest, signature) triple, but loads the P-256 application onto OTBN once
+ * and verifies several signatures per OTBN run. The same requirements on the
+ * inputs apply to each triple.
+ *
+ * A signature or public key that fails the basic validity checks (for which
+ * `otcrypto_ecdsa_p256_verify` would return an error) only makes its own entry
+ * of `verification_results` false, so one bad signature in a certificate
+ * bundle does not stop the others from being checked. As for a single
+ * signature, the caller must check `verification_results`.
+ *
+ * @param public_keys Pointers to the unblinded public keys (Q), one per item.
+ * @param message_digests Message digests to be verified (pre-hashed).
+ * @param signatures Signatures to be verified.
+ * @param num_items Number of signatures in the batch.
+ * @param[out] verification_results Whether each signature passed
+ * verification.
+ * @return Result of the batch verification operation.
+ */
+OT_WARN_UNUSED_RESULT
+otcrypto_status_t otcrypto_ecdsa_p256_verify_batch(
+    const otcrypto_unblinded_key_t *const *public_keys,
+    const otcrypto_hash_digest_t *message_digests,
+    const otcrypto_const_word32_buf_t *signatures, size_t num_items,
+    hardened_bool_t *verification_results);
+
 /**
  * Generates a key pair for ECDH with curve P-256.
  *
@@ -114,6 +143,30 @@ otcrypto_status_t otcrypto_ecdh_p256(const otcrypto_blinded_key_t *private_key,
                                      const otcrypto_unblinded_key_t *public_key,
                                      otcrypto_blinded_key_t *shared_secret);
 
+/**
+ * Ephemeral-static ECDH with curve P-256.
+ *
+ * Generates a fresh ephemeral keypair and computes the shared secret with the
+ * peer's public key in a single operation. This is equivalent to calling
+ * `otcrypto_ecdh_p256_keygen` and then `otcrypto_ecdh_p256` with the new
+ * private key, but the ephemeral private key never leaves the accelerator and
+ * is discarded when the operation completes.
+ *
+ * The caller should allocate space for the ephemeral public key and set its
+ * mode to ECDH with P-256, and allocate and configure the shared secret as for
+ * `otcrypto_ecdh_p256`.
+ *
+ * @param peer_public_key Pointer to the peer's unblinded public key (Q).
+ * @param[out] ephemeral_public_key Pointer to the ephemeral public key (d*G).
+ * @param[out] shared_secret Pointer to generated blinded shared key struct.
+ * @return Result of ephemeral ECDH shared secret generation.
+ */
+OT_WARN_UNUSED_RESULT
+otcrypto_status_t otcrypto_ecdh_p256_ephemeral(
+    const otcrypto_unblinded_key_t *peer_public_key,
+    otcrypto_unblinded_key_t *ephemeral_public_key,
+    otcrypto_blinded_key_t *shared_secret);
+
 /**
  * Starts asynchronous key generation for ECDSA/P-256.
  *
@@ -266,6 +319,34 @@ OT_WARN_UNUSED_RESULT
 otcrypto_status_t otcrypto_ecdh_p256_async_finalize(
     otcrypto_blinded_key_t *shared_secret);
 
+/**
+ * Starts asynchronous ephemeral-static ECDH with curve P-256.
+ *
+ * See `otcrypto_ecdh_p256_ephemeral` for requirements on input values.
+ *
+ * @param peer_public_key Pointer to the peer's unblinded public key (Q).
+ * @return Result of async ephemeral ECDH start operation.
+ */
+OT_WARN_UNUSED_RESULT
+otcrypto_status_t otcrypto_ecdh_p256_ephemeral_async_start(
+    const otcrypto_unblinded_key_t *peer_public_key);
+
+/**
+ * Finalizes asynchronous ephemeral-static ECDH with curve P-256.
+ *
+ * See `otcrypto_ecdh_p256_ephemeral` for requirements on input values.
+ *
+ * May block until the operation is complete.
+ *
+ * @param[out] ephemeral_public_key Pointer to the ephemeral public key (d*G).
+ * @param[out] shared_secret Pointer to generated blinded shared key struct.
+ * @return Result of async ephemeral ECDH finalize operation.
+ */
+OT_WARN_UNUSED_RESULT
+otcrypto_status_t otcrypto_ecdh_p256_ephemeral_async_finalize(
+    otcrypto_unblinded_key_t *ephemeral_public_key,
+    otcrypto_blinded_key_t *shared_secret);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -114,6 +114,30 @@ otcrypto_status_t otcrypto_ecdh_p384(const otcrypto_blinded_key_t *private_key,
                                      const otcrypto_unblinded_key_t *public_key,
                                      otcrypto_blinded_key_t *shared_secret);
 
+/**
+ * Ephemeral-static ECDH with curve P-384.
+ *
+ * Generates a fresh ephemeral keypair and computes the shared secret with the
+ * peer's public key in a single operation. This is equivalent to calling
+ * `otcrypto_ecdh_p384_keygen` and then `otcrypto_ecdh_p384` with the new
+ * private key, but the ephemeral private key never leaves the accelerator and
+ * is discarded when the operation completes.
+ *
+ * The caller should allocate space for the ephemeral public key and set its
+ * mode to ECDH with P-384, and allocate and configure the shared secret as for
+ * `otcrypto_ecdh_p384`.
+ *
+ * @param peer_public_key Pointer to the peer's unblinded public key (Q).
+ * @param[out] ephemeral_public_key Pointer to the ephemeral public key (d*G).
+ * @param[out] shared_secret Pointer to generated blinded shared key struct.
+ * @return Result of ephemeral ECDH shared secret generation.
+ */
+OT_WARN_UNUSED_RESULT
+otcrypto_status_t otcrypto_ecdh_p384_ephemeral(
+    const otcrypto_unblinded_key_t *peer_public_key,
+    otcrypto_unblinded_key_t *ephemeral_public_key,
+    otcrypto_blinded_key_t *shared_secret);
+
 /**
  * Starts asynchronous key generation for ECDSA/P-384.
  *
@@ -266,6 +290,34 @@ OT_WARN_UNUSED_RESULT
 otcrypto_status_t otcrypto_ecdh_p384_async_finalize(
     otcrypto_blinded_key_t *shared_secret);
 
+/**
+ * Starts asynchronous ephemeral-static ECDH with curve P-384.
+ *
+ * See `otcrypto_ecdh_p384_ephemeral` for requirements on input values.
+ *
+ * @param peer_public_key Pointer to the peer's unblinded public key (Q).
+ * @return Result of async ephemeral ECDH start operation.
+ */
+OT_WARN_UNUSED_RESULT
+otcrypto_status_t otcrypto_ecdh_p384_ephemeral_async_start(
+    const otcrypto_unblinded_key_t *peer_public_key);
+
+/**
+ * Finalizes asynchronous ephemeral-static ECDH with curve P-384.
+ *
+ * See `otcrypto_ecdh_p384_ephemeral` for requirements on input values.
+ *
+ * May block until the operation is complete.
+ *
+ * @param[out] ephemeral_public_key Pointer to the ephemeral public key (d*G).
+ * @param[out] shared_secret Pointer to generated blinded shared key struct.
+ * @return Result of async ephemeral ECDH finalize operation.
+ */
+OT_WARN_UNUSED_RESULT
+otcrypto_status_t otcrypto_ecdh_p384_ephemeral_async_finalize(
+    otcrypto_unblinded_key_t *ephemeral_public_key,
+    otcrypto_blinded_key_t *shared_secret);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -49,6 +49,10 @@ otcrypto_status_t otcrypto_ed25519_keygen(otcrypto_blinded_key_t *private_key,
 /**
  * Generates an Ed25519 digital signature.
  *
+ * In `kOtcryptoEddsaSignModeHashEddsa` mode (Ed25519ph from RFC 8032), the
+ * input message must be the 64-byte SHA-512 digest of the actual message.
+ * Hardware-backed private keys are not supported.
+ *
  * @param private_key Pointer to the blinded private key struct.
  * @param input_message Input message to be signed.
  * @param sign_mode EdDSA signature hashing mode.
@@ -83,6 +87,36 @@ otcrypto_status_t otcrypto_ed25519_verify(
     otcrypto_eddsa_sign_mode_t sign_mode, otcrypto_const_word32_buf_t signature,
     hardened_bool_t *verification_result);
 
+/**
+ * Verifies a batch of Ed25519 signatures.
+ *
+ * Equivalent to calling `otcrypto_ed25519_verify` on each (public key,
+ * message, signature) triple with the same `sign_mode`, but loads the Ed25519
+ * application onto OTBN once and verifies several signatures per OTBN run. The
+ * same requirements on the inputs apply to each triple.
+ *
+ * A signature or public key that fails the basic validity checks (for which
+ * `otcrypto_ed25519_verify` would return an error) only makes its own entry of
+ * `verification_results` false. As for a single signature, the caller must
+ * check `verification_results`.
+ *
+ * @param public_keys Pointers to the unblinded public keys, one per item.
+ * @param input_messages Input messages to be signed for verification.
+ * @param sign_mode EdDSA signature hashing mode, for all items.
+ * @param signatures Signatures to be verified.
+ * @param num_items Number of signatures in the batch.
+ * @param[out] verification_results Whether each signature passed
+ * verification.
+ * @return Result of the batch verification operation.
+ */
+OT_WARN_UNUSED_RESULT
+otcrypto_status_t otcrypto_ed25519_verify_batch(
+    const otcrypto_unblinded_key_t *const *public_keys,
+    const otcrypto_const_byte_buf_t *input_messages,
+    otcrypto_eddsa_sign_mode_t sign_mode,
+    const otcrypto_const_word32_buf_t *signatures, size_t num_items,
+    hardened_bool_t *verification_results);
+
 /**
  * Starts asynchronous key generation for Ed25519.
  *
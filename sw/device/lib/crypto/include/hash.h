@@ -69,6 +69,80 @@ typedef struct otcrypto_hash_context {
 otcrypto_status_t otcrypto_hash(otcrypto_const_byte_buf_t input_message,
                                 otcrypto_hash_digest_t digest);
 
+/**
+ * Performs a SHA-2 hash function on several independent messages.
+ *
+ * Equivalent to calling #otcrypto_hash on each message, but the messages are
+ * fed to the hardware back to back, without reconfiguring it in between. Use
+ * this to compute many digests at once, e.g. one per flash page.
+ *
+ * The caller should allocate space for each `digests[i].data` buffer and set
+ * the `mode` and `len` fields. All digests must use the same SHA-2 mode; SHA-3
+ * modes are not supported.
+ *
+ * @param input_messages Input messages to be hashed.
+ * @param num_messages Number of messages.
+ * @param[out] digests Output digest for each input message.
+ * @return Result of the hash operation.
+ */
+otcrypto_status_t otcrypto_hash_batch(
+    const otcrypto_const_byte_buf_t *input_messages, size_t num_messages,
+    otcrypto_hash_digest_t *digests);
+
+/**
+ * Starts an asynchronous SHA-2 hash computation on OTBN.
+ *
+ * OTBN can hash a SHA-384 or SHA-512 message while the HMAC block hashes
+ * others: start one message here, hash the others with #otcrypto_hash, and
+ * then collect the digest with #otcrypto_hash_async_finalize. OTBN must not be
+ * used for anything else in between.
+ *
+ * OTBN hashes at most 16 message blocks (2 KiB) per run. For longer messages,
+ * this function waits for all but the last run, so only the last run overlaps
+ * with the caller's work; #otcrypto_hash_parallel keeps OTBN busy throughout.
+ *
+ * @param input_message Input message to be hashed.
+ * @param hash_mode Hash mode; `kOtcryptoHashModeSha384` or
+ * `kOtcryptoHashModeSha512`.
+ * @return Result of async hash start operation.
+ */
+otcrypto_status_t otcrypto_hash_async_start(
+    otcrypto_const_byte_buf_t input_message, otcrypto_hash_mode_t hash_mode);
+
+/**
+ * Finalizes an asynchronous SHA-2 hash computation on OTBN.
+ *
+ * Blocks until OTBN is done. The caller should allocate space for the `digest`
+ * buffer and set the `mode` and `len` fields; the mode must be the one passed
+ * to #otcrypto_hash_async_start.
+ *
+ * @param[out] digest Output digest after hashing the input message.
+ * @return Result of async hash finalize operation.
+ */
+otcrypto_status_t otcrypto_hash_async_finalize(otcrypto_hash_digest_t digest);
+
+/**
+ * Performs hash functions on several independent messages, using both OTBN
+ * and the HMAC block.
+ *
+ * Equivalent to calling #otcrypto_hash on each message. Whenever OTBN is idle,
+ * the next SHA-384 or SHA-512 message is handed to it; the other messages are
+ * hashed by the HMAC or KMAC block in the meantime. Use this for independent
+ * streams such as Merkle tree leaves or the measurements of several images.
+ *
+ * The caller should allocate space for each `digests[i].data` buffer and set
+ * the `mode` and `len` fields. Digests may use different fixed-length hash
+ * modes. OTBN must be idle when this function is called.
+ *
+ * @param input_messages Input messages to be hashed.
+ * @param num_messages Number of messages.
+ * @param[out] digests Output digest for each input message.
+ * @return Result of the hash operation.
+ */
+otcrypto_status_t otcrypto_hash_parallel(
+    const otcrypto_const_byte_buf_t *input_messages, size_t num_messages,
+    otcrypto_hash_digest_t *digests);
+
 /**
  * Performs the SHAKE extendable output function (XOF) on input data.
  *
@@ -113,14 +187,18 @@ otcrypto_status_t otcrypto_xof_cshake(
  * Performs the INIT operation for a cryptographic hash function.
  *
  * Initializes the generic hash context. The required hash mode is selected
- * through the `hash_mode` parameter. Only `kOtcryptoHashModeSha256`,
- * `kOtcryptoHashModeSha384` and `kOtcryptoHashModeSha512` are supported. Other
- * modes are not supported and an error would be returned.
+ * through the `hash_mode` parameter. The SHA-2 and SHA-3 modes are supported;
+ * use #otcrypto_xof_shake_init or #otcrypto_xof_cshake_init for
+ * extendable-output functions.
  *
  * Populates the hash context with the selected hash mode and its digest and
  * block sizes. The structure of hash context and how it populates the required
  * fields are internal to the specific hash implementation.
  *
+ * SHA-3 streams keep their state in the KMAC block, which cannot save and
+ * restore it. Only one SHA-3 or XOF stream can be in progress at a time, and
+ * other KMAC-based operations return an error until it is finished.
+ *
  * @param ctx Pointer to the generic hash context struct.
  * @param hash_mode Required hash mode.
  * @return Result of the hash init operation.
@@ -136,7 +214,9 @@ otcrypto_status_t otcrypto_hash_init(otcrypto_hash_context_t *const ctx,
  * `ctx`. Any partial data is stored back in the context and combined with the
  * subsequent bytes.
  *
- * #otcrypto_hash_init should be called before this function.
+ * #otcrypto_hash_init should be called before this function. This function
+ * also absorbs input for the XOF streams started with #otcrypto_xof_shake_init
+ * or #otcrypto_xof_cshake_init, up to the first #otcrypto_xof_squeeze call.
  *
  * @param ctx Pointer to the generic hash context struct.
  * @param input_message Input message to be hashed.
@@ -164,6 +244,67 @@ otcrypto_status_t otcrypto_hash_update(otcrypto_hash_context_t *const ctx,
 otcrypto_status_t otcrypto_hash_final(otcrypto_hash_context_t *const ctx,
                                       otcrypto_hash_digest_t digest);
 
+/**
+ * Starts a streaming SHAKE extendable output function (XOF).
+ *
+ * The `xof_mode` parameter must be `kOtcryptoHashXofModeShake128` or
+ * `kOtcryptoHashXofModeShake256`. Input is absorbed with
+ * #otcrypto_hash_update, output is read with #otcrypto_xof_squeeze and the
+ * stream is ended with #otcrypto_xof_final.
+ *
+ * The stream keeps its state in the KMAC block, so only one SHA-3 or XOF
+ * stream can be in progress at a time.
+ *
+ * @param ctx Pointer to the generic hash context struct.
+ * @param xof_mode Required XOF mode.
+ * @return Result of the XOF init operation.
+ */
+otcrypto_status_t otcrypto_xof_shake_init(otcrypto_hash_context_t *const ctx,
+                                          otcrypto_hash_mode_t xof_mode);
+
+/**
+ * Starts a streaming cSHAKE extendable output function (XOF).
+ *
+ * Same as #otcrypto_xof_shake_init, but for `kOtcryptoHashXofModeCshake128`
+ * or `kOtcryptoHashXofModeCshake256`. See #otcrypto_xof_cshake for the
+ * meaning of `function_name_string` and `customization_string`.
+ *
+ * @param ctx Pointer to the generic hash context struct.
+ * @param xof_mode Required XOF mode.
+ * @param function_name_string NIST Function name string.
+ * @param customization_string Customization string for cSHAKE.
+ * @return Result of the XOF init operation.
+ */
+otcrypto_status_t otcrypto_xof_cshake_init(
+    otcrypto_hash_context_t *const ctx, otcrypto_hash_mode_t xof_mode,
+    otcrypto_const_byte_buf_t function_name_string,
+    otcrypto_const_byte_buf_t customization_string);
+
+/**
+ * Reads output from a streaming XOF.
+ *
+ * The first call ends the absorbing phase. Each call returns the next
+ * `digest.len` words of output, so the output can be read on demand without
+ * knowing its total length up front.
+ *
+ * The caller should allocate space for the `digest` buffer and set the `mode`
+ * and `len` fields. The `mode` must match the mode of the context.
+ *
+ * @param ctx Pointer to the generic hash context struct.
+ * @param[out] digest Next output words from the extendable output function.
+ * @return Result of the XOF squeeze operation.
+ */
+otcrypto_status_t otcrypto_xof_squeeze(otcrypto_hash_context_t *const ctx,
+                                       otcrypto_hash_digest_t digest);
+
+/**
+ * Ends a streaming XOF and releases the KMAC block.
+ *
+ * @param ctx Pointer to the generic hash context struct.
+ * @return Result of the XOF final operation.
+ */
+otcrypto_status_t otcrypto_xof_final(otcrypto_hash_context_t *const ctx);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -97,6 +97,61 @@ otcrypto_status_t otcrypto_kdf_kmac(
     const otcrypto_const_byte_buf_t kdf_context, size_t required_byte_len,
     otcrypto_blinded_key_t *keying_material);
 
+/**
+ * Derives several keys from one HMAC counter-mode KDF invocation.
+ *
+ * Computes keying material of length L = sum of the output key lengths as in
+ * `otcrypto_kdf_hmac_ctr` and splits it into the output keys in order (see
+ * NIST SP 800-108r1, section 5). The result for each key is therefore the
+ * corresponding slice of `otcrypto_kdf_hmac_ctr` with `required_byte_len` =
+ * L. The key derivation key is processed once for all counter blocks, which
+ * makes deriving many keys considerably cheaper than separate calls.
+ *
+ * The caller should allocate and partially populate each output key as for
+ * `otcrypto_kdf_hmac_ctr`; the key length in each configuration determines
+ * the size of its slice. Hardware-backed output keys are not supported.
+ *
+ * @param key_derivation_key Blinded key derivation key.
+ * @param kdf_label Label string according to SP 800-108r1.
+ * @param kdf_context Context string according to SP 800-108r1.
+ * @param[out] keying_materials Output keys to be populated by this function.
+ * @param num_keys Number of output keys.
+ * @return Result of the key derivation operation.
+ */
+otcrypto_status_t otcrypto_kdf_hmac_ctr_multi(
+    const otcrypto_blinded_key_t key_derivation_key,
+    const otcrypto_const_byte_buf_t kdf_label,
+    const otcrypto_const_byte_buf_t kdf_context,
+    otcrypto_blinded_key_t *const *keying_materials, size_t num_keys);
+
+/**
+ * Derives several keys from one KMAC KDF invocation.
+ *
+ * Computes keying material of length L = sum of the output key lengths as in
+ * `otcrypto_kdf_kmac`, in a single KMAC operation with one squeeze, and
+ * splits it into the output keys in order (see NIST SP 800-108r1, section 5).
+ * The keying material stays masked and is written directly into the output
+ * keyblobs. The result for each key is the corresponding slice of
+ * `otcrypto_kdf_kmac` with `required_byte_len` = L.
+ *
+ * The caller should allocate and partially populate each output key as for
+ * `otcrypto_kdf_kmac`. Each key length must be a multiple of 4 bytes, and
+ * hardware-backed output keys are not supported.
+ *
+ * @param key_derivation_key Blinded key derivation key.
+ * @param kmac_mode Either KMAC128 or KMAC256 as PRF.
+ * @param kdf_label Label string according to SP 800-108r1.
+ * @param kdf_context Context string according to SP 800-108r1.
+ * @param[out] keying_materials Output keys to be populated by this function.
+ * @param num_keys Number of output keys.
+ * @return Result of the key derivation operation.
+ */
+otcrypto_status_t otcrypto_kdf_kmac_multi(
+    const otcrypto_blinded_key_t key_derivation_key,
+    otcrypto_kmac_mode_t kmac_mode, const otcrypto_const_byte_buf_t kdf_label,
+    const otcrypto_const_byte_buf_t kdf_context,
+    otcrypto_blinded_key_t *const *keying_materials, size_t num_keys);
+
 /**
  * Performs HKDF in one shot, both expand and extract stages.
  *
@@ -77,6 +77,36 @@ otcrypto_status_t otcrypto_hw_backed_key(uint32_t version,
                                          const uint32_t salt[7],
                                          otcrypto_blinded_key_t *key);
 
+/**
+ * Starts a sideload session for a hardware-backed OTBN key.
+ *
+ * Normally, each ECDSA, ECDH or X25519 operation with a hardware-backed key
+ * asks the key manager to derive the key into OTBN's sideload slot and clears
+ * the slot afterwards. Within a session, the pinned key is derived once and
+ * stays in the slot for later operations with the same key, which saves the
+ * key manager round-trip when signing repeatedly with one key.
+ *
+ * Operations with other hardware-backed keys still work during the session;
+ * they replace the pinned key, which is derived again when next used. The slot
+ * is cleared when a derivation fails and at the end of the session.
+ *
+ * Only one session can be active at a time.
+ *
+ * @param key Hardware-backed key to pin.
+ * @return The result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+otcrypto_status_t otcrypto_sideload_session_start(
+    const otcrypto_blinded_key_t *key);
+
+/**
+ * Ends the sideload session, if any, and clears OTBN's sideload slot.
+ *
+ * @return The result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+otcrypto_status_t otcrypto_sideload_session_end(void);
+
 /**
  * Returns the length that the blinded key will have once wrapped.
  *
@@ -111,6 +141,30 @@ otcrypto_status_t otcrypto_key_wrap(const otcrypto_blinded_key_t *key_to_wrap,
                                     const otcrypto_blinded_key_t *key_kek,
                                     otcrypto_word32_buf_t wrapped_key);
 
+/**
+ * Wraps (encrypts) several secret keys with the same key encryption key.
+ *
+ * Equivalent to calling `otcrypto_key_wrap` for each key, but the key
+ * encryption key is loaded into the AES block only once and the AES
+ * operations for the different keys are interleaved. Use this to wrap many
+ * keys at once, for example when exporting a keyring.
+ *
+ * Each entry of `wrapped_keys` must be set up for the corresponding key as
+ * for `otcrypto_key_wrap`. All keys and buffers are checked before any key is
+ * wrapped.
+ *
+ * @param keys_to_wrap Blinded keys that will be encrypted.
+ * @param num_keys Number of keys to wrap.
+ * @param key_kek AES-KWP key used to encrypt the keys.
+ * @param[out] wrapped_keys Encrypted key data for each key.
+ * @return Result of the wrap operation.
+ */
+OT_WARN_UNUSED_RESULT
+otcrypto_status_t otcrypto_key_wrap_batch(
+    const otcrypto_blinded_key_t *keys_to_wrap, size_t num_keys,
+    const otcrypto_blinded_key_t *key_kek,
+    otcrypto_word32_buf_t *wrapped_keys);
+
 /**
  * Unwraps (decrypts) a secret key.
  *
@@ -147,6 +201,30 @@ otcrypto_status_t otcrypto_key_unwrap(otcrypto_const_word32_buf_t wrapped_key,
                                       hardened_bool_t *success,
                                       otcrypto_blinded_key_t *unwrapped_key);
 
+/**
+ * Unwraps (decrypts) several secret keys with the same key encryption key.
+ *
+ * Equivalent to calling `otcrypto_key_unwrap` for each key, with the key
+ * encryption key loaded only once as for `otcrypto_key_wrap_batch`.
+ *
+ * Each entry of `unwrapped_keys` must be set up as for `otcrypto_key_unwrap`.
+ * As there, an OK status does NOT mean that unwrapping succeeded; the caller
+ * must check both the returned status and the entry of `success` for a key
+ * before reading it.
+ *
+ * @param wrapped_keys Encrypted key data for each key.
+ * @param num_keys Number of keys to unwrap.
+ * @param key_kek AES-KWP key used to decrypt the keys.
+ * @param[out] success Whether each wrapped key was valid.
+ * @param[out] unwrapped_keys Decrypted key data for each key.
+ * @return Result of the aes-kwp unwrap operation.
+ */
+OT_WARN_UNUSED_RESULT
+otcrypto_status_t otcrypto_key_unwrap_batch(
+    const otcrypto_const_word32_buf_t *wrapped_keys, size_t num_keys,
+    const otcrypto_blinded_key_t *key_kek, hardened_bool_t *success,
+    otcrypto_blinded_key_t *unwrapped_keys);
+
 /**
  * Creates a blinded key struct from masked key material.
  *
@@ -41,6 +41,23 @@ typedef struct otcrypto_hmac_context {
   uint32_t data[kOtcryptoHashCtxStructWords];
 } otcrypto_hmac_context_t;
 
+enum {
+  /**
+   * Size of `otcrypto_hmac_keyed_state_t` in words.
+   */
+  kOtcryptoHmacKeyedStateWords = 80,
+};
+
+/**
+ * Precomputed HMAC key state.
+ *
+ * Representation is internal to the hmac implementation; initialize
+ * with #otcrypto_hmac_keyed_state_init.
+ */
+typedef struct otcrypto_hmac_keyed_state {
+  uint32_t data[kOtcryptoHmacKeyedStateWords];
+} otcrypto_hmac_keyed_state_t;
+
 /**
  * Performs the HMAC function on the input data.
  *
@@ -156,6 +173,41 @@ otcrypto_status_t otcrypto_hmac_update(otcrypto_hmac_context_t *const ctx,
 otcrypto_status_t otcrypto_hmac_final(otcrypto_hmac_context_t *const ctx,
                                       otcrypto_word32_buf_t tag);
 
+/**
+ * Precomputes the state of an HMAC key for repeated MACs.
+ *
+ * Hashes the inner and outer padded key blocks once and stores the resulting
+ * SHA-2 states in `state`, blinded in the same way as the key. The key has the
+ * same requirements as for #otcrypto_hmac.
+ *
+ * The state is as sensitive as the key itself and must be handled like it.
+ *
+ * @param[out] state Pointer to the keyed state struct.
+ * @param key Pointer to the blinded HMAC key struct.
+ * @return Result of the operation.
+ */
+otcrypto_status_t otcrypto_hmac_keyed_state_init(
+    otcrypto_hmac_keyed_state_t *state, const otcrypto_blinded_key_t *key);
+
+/**
+ * Performs the HMAC function on the input data with a precomputed key state.
+ *
+ * Returns the same tag as #otcrypto_hmac with the key that `state` was
+ * computed from. The key blocks are not hashed again, so for short messages
+ * this takes about half the hash computations of #otcrypto_hmac. `state` is
+ * not modified and can be used for any number of messages.
+ *
+ * The `tag` buffer is as for #otcrypto_hmac.
+ *
+ * @param state Pointer to the keyed state struct.
+ * @param input_message Input message to be hashed.
+ * @param[out] tag Output authentication tag.
+ * @return The result of the HMAC operation.
+ */
+otcrypto_status_t otcrypto_hmac_keyed(const otcrypto_hmac_keyed_state_t *state,
+                                      otcrypto_const_byte_buf_t input_message,
+                                      otcrypto_word32_buf_t tag);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
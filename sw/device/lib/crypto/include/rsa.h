@@ -294,6 +294,54 @@ otcrypto_status_t otcrypto_rsa_keygen_async_start(otcrypto_rsa_size_t size);
 otcrypto_status_t otcrypto_rsa_keygen_async_finalize(
     otcrypto_unblinded_key_t *public_key, otcrypto_blinded_key_t *private_key);
 
+/**
+ * Enables or disables the RSA prime pool.
+ *
+ * The prime pool holds up to four primes for one RSA size. The primes are
+ * generated ahead of time, for example while OTBN would otherwise be idle, and
+ * are stored masked as two boolean shares. While the pool holds at least two
+ * primes, `otcrypto_rsa_keygen` for that size builds the key from two pooled
+ * primes, which takes a small and predictable amount of time. Otherwise it
+ * searches for primes as usual, so the pool never changes the results of key
+ * generation, only its latency.
+ *
+ * The pool is disabled by default. Enabling or disabling it wipes any primes
+ * it holds. Use `otcrypto_rsa_prime_pool_refill` (or its asynchronous
+ * equivalent, e.g. from an OTBN job queue) to fill it.
+ *
+ * @param enable Whether to enable the pool.
+ * @param size RSA size parameter; ignored when disabling the pool.
+ * @return Result of the operation.
+ */
+otcrypto_status_t otcrypto_rsa_prime_pool_enable(hardened_bool_t enable,
+                                                 otcrypto_rsa_size_t size);
+
+/**
+ * Generates one prime for the RSA prime pool.
+ *
+ * Does nothing if the pool is full.
+ *
+ * @param[out] num_primes Number of primes in the pool afterwards.
+ * @return Result of the operation.
+ */
+otcrypto_status_t otcrypto_rsa_prime_pool_refill(size_t *num_primes);
+
+/**
+ * Starts generating one prime for the RSA prime pool.
+ *
+ * @return Result of the operation.
+ */
+otcrypto_status_t otcrypto_rsa_prime_pool_refill_async_start(void);
+
+/**
+ * Finalizes generating one prime for the RSA prime pool.
+ *
+ * @param[out] num_primes Number of primes in the pool afterwards.
+ * @return Result of the operation.
+ */
+otcrypto_status_t otcrypto_rsa_prime_pool_refill_async_finalize(
+    size_t *num_primes);
+
 /**
  * Starts constructing an RSA private key using a cofactor.
  *
@@ -139,3 +139,88 @@ dif_result_t dif_mbx_generate_response(const dif_mbx_t *mbx,
 
   return kDifOk;
 }
+
+dif_result_t dif_mbx_request_view(const dif_mbx_t *mbx,
+                                  dif_mbx_transaction_t *view) {
+  if (mbx == NULL || view == NULL) {
+    return kDifBadArg;
+  }
+
+  uint32_t base =
+      mmio_region_read32(mbx->base_addr, MBX_INBOUND_BASE_ADDRESS_REG_OFFSET);
+  uint32_t imbx_wr_ptr =
+      mmio_region_read32(mbx->base_addr, MBX_INBOUND_WRITE_PTR_REG_OFFSET);
+  if (imbx_wr_ptr < base) {
+    return kDifError;
+  }
+
+  view->data_dwords = (uint32_t *)(uintptr_t)base;
+  view->nr_dwords = (imbx_wr_ptr - base) / sizeof(uint32_t);
+  return kDifOk;
+}
+
+dif_result_t dif_mbx_response_view(const dif_mbx_t *mbx,
+                                   dif_mbx_transaction_t *view) {
+  if (mbx == NULL || view == NULL) {
+    return kDifBadArg;
+  }
+
+  uint32_t curr_ptr =
+      mmio_region_read32(mbx->base_addr, MBX_OUTBOUND_READ_PTR_REG_OFFSET);
+  uint32_t limit =
+      mmio_region_read32(mbx->base_addr, MBX_OUTBOUND_LIMIT_ADDRESS_REG_OFFSET);
+  if (limit < curr_ptr) {
+    return kDifError;
+  }
+
+  // The limit address is inclusive.
+  uint32_t nr_dwords = (limit - curr_ptr) / sizeof(uint32_t) + 1;
+  view->data_dwords = (uint32_t *)(uintptr_t)curr_ptr;
+  view->nr_dwords = nr_dwords < DOE_MAILBOX_MAX_OBJECT_SIZE
+                        ? nr_dwords
+                        : DOE_MAILBOX_MAX_OBJECT_SIZE;
+  return kDifOk;
+}
+
+dif_result_t dif_mbx_response_commit(const dif_mbx_t *mbx,
+                                     uint32_t nr_dwords) {
+  if (mbx == NULL || nr_dwords > DOE_MAILBOX_MAX_OBJECT_SIZE) {
+    return kDifBadArg;
+  }
+
+  mmio_region_write32(mbx->base_addr, MBX_OUTBOUND_OBJECT_SIZE_REG_OFFSET,
+                      nr_dwords);
+  return kDifOk;
+}
+
+dif_result_t dif_mbx_generate_response_gather(
+    const dif_mbx_t *mbx, const dif_mbx_transaction_t *segments,
+    size_t nr_segments) {
+  if (mbx == NULL || (segments == NULL && nr_segments != 0)) {
+    return kDifBadArg;
+  }
+
+  uint32_t total = 0;
+  for (size_t i = 0; i < nr_segments; ++i) {
+    if (segments[i].data_dwords == NULL && segments[i].nr_dwords != 0) {
+      return kDifBadArg;
+    }
+    if (segments[i].nr_dwords > DOE_MAILBOX_MAX_OBJECT_SIZE - total) {
+      return kDifBadArg;
+    }
+    total += segments[i].nr_dwords;
+  }
+
+  uint32_t curr_ptr =
+      mmio_region_read32(mbx->base_addr, MBX_OUTBOUND_READ_PTR_REG_OFFSET);
+  for (size_t i = 0; i < nr_segments; ++i) {
+    for (uint32_t j = 0; j < segments[i].nr_dwords; ++j) {
+      abs_mmio_write32(curr_ptr, segments[i].data_dwords[j]);
+      curr_ptr += sizeof(uint32_t);
+    }
+  }
+
+  mmio_region_write32(mbx->base_addr, MBX_OUTBOUND_OBJECT_SIZE_REG_OFFSET,
+                      total);
+  return kDifOk;
+}
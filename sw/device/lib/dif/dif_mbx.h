@@ -117,6 +117,66 @@ OT_WARN_UNUSED_RESULT
 dif_result_t dif_mbx_generate_response(const dif_mbx_t *mbx,
                                        const dif_mbx_transaction_t response);
 
+/**
+ * Gets a view of the DoE Mailbox request in place in the inbound SRAM region.
+ *
+ * Unlike `dif_mbx_process_request()` nothing is copied: on return
+ * `view->data_dwords` points at the start of the inbound region and
+ * `view->nr_dwords` is the number of dwords written by the requester. The view
+ * is only valid until the request is acknowledged.
+ *
+ * @param mbx A DOE Mailbox handle.
+ * @param[out] view The request, in place.
+ * @return The result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+dif_result_t dif_mbx_request_view(const dif_mbx_t *mbx,
+                                  dif_mbx_transaction_t *view);
+
+/**
+ * Gets a view of the outbound SRAM region so a response can be built in place.
+ *
+ * On return `view->data_dwords` points at where the response starts and
+ * `view->nr_dwords` is the space available, capped at
+ * `DOE_MAILBOX_MAX_OBJECT_SIZE`. Once the response has been written, publish
+ * it with `dif_mbx_response_commit()`.
+ *
+ * @param mbx A DOE Mailbox handle.
+ * @param[out] view The writable outbound region.
+ * @return The result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+dif_result_t dif_mbx_response_view(const dif_mbx_t *mbx,
+                                   dif_mbx_transaction_t *view);
+
+/**
+ * Publishes a response that was built in place in the outbound SRAM region.
+ *
+ * @param mbx A DOE Mailbox handle.
+ * @param nr_dwords The size of the response in dwords.
+ * @return The result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+dif_result_t dif_mbx_response_commit(const dif_mbx_t *mbx, uint32_t nr_dwords);
+
+/**
+ * Writes a DoE Mailbox response gathered from several segments to the
+ * internal SRAM.
+ *
+ * The segments are written back to back, in order, and published as a single
+ * response, so a header and a payload held in different buffers need not be
+ * copied together first.
+ *
+ * @param mbx A DOE Mailbox handle.
+ * @param segments The pieces of the response.
+ * @param nr_segments The number of entries in `segments`.
+ * @return The result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+dif_result_t dif_mbx_generate_response_gather(
+    const dif_mbx_t *mbx, const dif_mbx_transaction_t *segments,
+    size_t nr_segments);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -290,4 +290,99 @@ TEST_F(ProcessResponseTests, BadArg) {
   EXPECT_DIF_BADARG(dif_mbx_generate_response(&mbx_, response2));
 }
 
+class RequestViewTests : public MbxTestInitialized {};
+
+TEST_F(RequestViewTests, Success) {
+  dif_mbx_transaction_t view;
+
+  EXPECT_READ32(MBX_INBOUND_BASE_ADDRESS_REG_OFFSET, 0x1000);
+  EXPECT_READ32(MBX_INBOUND_WRITE_PTR_REG_OFFSET, 0x1010);
+
+  EXPECT_DIF_OK(dif_mbx_request_view(&mbx_, &view));
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(view.data_dwords), 0x1000);
+  EXPECT_EQ(view.nr_dwords, 4);
+}
+
+TEST_F(RequestViewTests, BadArg) {
+  dif_mbx_transaction_t view;
+
+  EXPECT_DIF_BADARG(dif_mbx_request_view(nullptr, &view));
+  EXPECT_DIF_BADARG(dif_mbx_request_view(&mbx_, nullptr));
+}
+
+class ResponseViewTests : public MbxTestInitialized {};
+
+TEST_F(ResponseViewTests, Success) {
+  dif_mbx_transaction_t view;
+
+  EXPECT_READ32(MBX_OUTBOUND_READ_PTR_REG_OFFSET, 0x2000);
+  EXPECT_READ32(MBX_OUTBOUND_LIMIT_ADDRESS_REG_OFFSET, 0x200C);
+
+  EXPECT_DIF_OK(dif_mbx_response_view(&mbx_, &view));
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(view.data_dwords), 0x2000);
+  EXPECT_EQ(view.nr_dwords, 4);
+
+  EXPECT_WRITE32(MBX_OUTBOUND_OBJECT_SIZE_REG_OFFSET, 3);
+  EXPECT_DIF_OK(dif_mbx_response_commit(&mbx_, 3));
+}
+
+TEST_F(ResponseViewTests, CappedAtMaxObjectSize) {
+  dif_mbx_transaction_t view;
+
+  EXPECT_READ32(MBX_OUTBOUND_READ_PTR_REG_OFFSET, 0x2000);
+  EXPECT_READ32(MBX_OUTBOUND_LIMIT_ADDRESS_REG_OFFSET, 0x3FFC);
+
+  EXPECT_DIF_OK(dif_mbx_response_view(&mbx_, &view));
+  EXPECT_EQ(view.nr_dwords, DOE_MAILBOX_MAX_OBJECT_SIZE);
+}
+
+TEST_F(ResponseViewTests, BadArg) {
+  dif_mbx_transaction_t view;
+
+  EXPECT_DIF_BADARG(dif_mbx_response_view(nullptr, &view));
+  EXPECT_DIF_BADARG(dif_mbx_response_view(&mbx_, nullptr));
+  EXPECT_DIF_BADARG(dif_mbx_response_commit(nullptr, 1));
+  EXPECT_DIF_BADARG(
+      dif_mbx_response_commit(&mbx_, DOE_MAILBOX_MAX_OBJECT_SIZE + 1));
+}
+
+class ResponseGatherTests : public MbxTestInitialized {};
+
+TEST_F(ResponseGatherTests, Success) {
+  std::array<uint32_t, 2> header = {0x123456, 0x456789};
+  std::array<uint32_t, 3> payload = {0xDEADBEEF, 0xCAFEDEAD, 0xFEEDF00D};
+  dif_mbx_transaction_t segments[] = {
+      {.data_dwords = header.data(), .nr_dwords = header.size()},
+      {.data_dwords = nullptr, .nr_dwords = 0},
+      {.data_dwords = payload.data(), .nr_dwords = payload.size()},
+  };
+
+  EXPECT_READ32(MBX_OUTBOUND_READ_PTR_REG_OFFSET, 0x1000);
+  EXPECT_ABS_WRITE32(0x1000, header[0]);
+  EXPECT_ABS_WRITE32(0x1004, header[1]);
+  EXPECT_ABS_WRITE32(0x1008, payload[0]);
+  EXPECT_ABS_WRITE32(0x100C, payload[1]);
+  EXPECT_ABS_WRITE32(0x1010, payload[2]);
+  EXPECT_WRITE32(MBX_OUTBOUND_OBJECT_SIZE_REG_OFFSET, 5);
+
+  EXPECT_DIF_OK(
+      dif_mbx_generate_response_gather(&mbx_, segments, std::size(segments)));
+}
+
+TEST_F(ResponseGatherTests, BadArg) {
+  uint32_t data = 0;
+  dif_mbx_transaction_t too_big[] = {
+      {.data_dwords = &data, .nr_dwords = DOE_MAILBOX_MAX_OBJECT_SIZE},
+      {.data_dwords = &data, .nr_dwords = 1},
+  };
+  dif_mbx_transaction_t null_data[] = {
+      {.data_dwords = nullptr, .nr_dwords = 1},
+  };
+
+  EXPECT_DIF_BADARG(dif_mbx_generate_response_gather(nullptr, null_data, 0));
+  EXPECT_DIF_BADARG(dif_mbx_generate_response_gather(&mbx_, nullptr, 1));
+  EXPECT_DIF_BADARG(dif_mbx_generate_response_gather(&mbx_, too_big, 2));
+  EXPECT_DIF_BADARG(dif_mbx_generate_response_gather(&mbx_, null_data, 1));
+}
+
 }  // namespace dif_mbx_test
@@ -667,6 +667,21 @@ dif_result_t dif_otp_ctrl_relative_address(dif_otp_ctrl_partition_t partition,
   return kDifOk;
 }
 
+dif_result_t dif_otp_ctrl_get_partition_layout(
+    dif_otp_ctrl_partition_t partition,
+    dif_otp_ctrl_partition_layout_t *layout) {
+  if (partition >= ARRAYSIZE(kPartitions) || layout == NULL) {
+    return kDifBadArg;
+  }
+
+  *layout = (dif_otp_ctrl_partition_layout_t){
+      .size = kPartitions[partition].len,
+      .dai_granule = kPartitions[partition].align_mask + 1,
+      .is_software = kPartitions[partition].is_software,
+  };
+  return kDifOk;
+}
+
 dif_result_t dif_otp_ctrl_dai_read_start(const dif_otp_ctrl_t *otp,
                                          dif_otp_ctrl_partition_t partition,
                                          uint32_t address) {
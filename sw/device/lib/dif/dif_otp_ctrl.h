@@ -257,6 +257,26 @@ typedef struct dif_otp_ctrl_config {
   uint32_t consistency_period_mask;
 } dif_otp_ctrl_config_t;
 
+/**
+ * The layout of an OTP partition, as needed to read it in bulk.
+ */
+typedef struct dif_otp_ctrl_partition_layout {
+  /**
+   * The size of the partition in bytes, including its digest if it has one.
+   */
+  uint32_t size;
+  /**
+   * The number of bytes returned by each Direct Access Interface read: eight
+   * for secret partitions and four for all others.
+   */
+  uint32_t dai_granule;
+  /**
+   * Whether this is a software partition, which can be read through the
+   * software config window unless it has been read-locked.
+   */
+  bool is_software;
+} dif_otp_ctrl_partition_layout_t;
+
 /**
  * A hardware-level status code.
  */
@@ -687,6 +707,18 @@ dif_result_t dif_otp_ctrl_relative_address(dif_otp_ctrl_partition_t partition,
                                            uint32_t abs_address,
                                            uint32_t *relative_address);
 
+/**
+ * Gets the layout of a partition.
+ *
+ * @param partition The partition to describe.
+ * @param[out] layout The layout of `partition`.
+ * @return The result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+dif_result_t dif_otp_ctrl_get_partition_layout(
+    dif_otp_ctrl_partition_t partition,
+    dif_otp_ctrl_partition_layout_t *layout);
+
 /**
  * Schedules a read on the Direct Access Interface.
  *
@@ -740,6 +740,34 @@ INSTANTIATE_TEST_SUITE_P(
       return info.param.name;
     });
 
+class PartitionLayoutTest : public OtpTest {};
+
+TEST_F(PartitionLayoutTest, Software) {
+  dif_otp_ctrl_partition_layout_t layout;
+  EXPECT_DIF_OK(dif_otp_ctrl_get_partition_layout(
+      kDifOtpCtrlPartitionOwnerSwCfg, &layout));
+  EXPECT_EQ(layout.size, OTP_CTRL_PARAM_OWNER_SW_CFG_SIZE);
+  EXPECT_EQ(layout.dai_granule, sizeof(uint32_t));
+  EXPECT_TRUE(layout.is_software);
+}
+
+TEST_F(PartitionLayoutTest, Secret) {
+  dif_otp_ctrl_partition_layout_t layout;
+  EXPECT_DIF_OK(
+      dif_otp_ctrl_get_partition_layout(kDifOtpCtrlPartitionSecret2, &layout));
+  EXPECT_EQ(layout.size, OTP_CTRL_PARAM_SECRET2_SIZE);
+  EXPECT_EQ(layout.dai_granule, sizeof(uint64_t));
+  EXPECT_FALSE(layout.is_software);
+}
+
+TEST_F(PartitionLayoutTest, BadArgs) {
+  dif_otp_ctrl_partition_layout_t layout;
+  EXPECT_DIF_BADARG(dif_otp_ctrl_get_partition_layout(
+      static_cast<dif_otp_ctrl_partition_t>(-1), &layout));
+  EXPECT_DIF_BADARG(
+      dif_otp_ctrl_get_partition_layout(kDifOtpCtrlPartitionSecret2, nullptr));
+}
+
 class DaiReadTest : public OtpTest {};
 
 TEST_F(DaiReadTest, Read32) {
@@ -1140,27 +1140,20 @@ dif_result_t dif_spi_device_tpm_write_data(dif_spi_device_handle_t *spi,
   if (spi == NULL || buf == NULL) {
     return kDifBadArg;
   }
-  dif_spi_device_tpm_data_status_t status;
-  dif_result_t result = dif_spi_device_tpm_get_data_status(spi, &status);
-  uint8_t offset = length & 0x3;  // lower two bits of length
-  uint32_t rdfifo_wdata;
-
-  DIF_RETURN_IF_ERROR(result);
-
-  // TODO: Ensure the received length is greater than FIFO SIZE
   if (DIF_SPI_DEVICE_TPM_FIFO_DEPTH * sizeof(uint32_t) < length) {
     return kDifOutOfRange;
   }
-  for (int i = 0; i < length; i += 4) {
-    if (i + 4 > length) {
-      // Send partial
-      rdfifo_wdata = 0;
-      for (int j = 0; j <= offset; j++) {
-        rdfifo_wdata |= (uint32_t)(buf[i + j]) << (8 * j);
-      }
-    } else {
-      // Type casting to uint32_t then fetch
-      rdfifo_wdata = *((uint32_t *)buf + (i >> 2));
+  // Whole words are read straight from `buf`, which need not be aligned.
+  size_t i = 0;
+  for (; i + sizeof(uint32_t) <= length; i += sizeof(uint32_t)) {
+    mmio_region_write32(spi->dev.base_addr, SPI_DEVICE_TPM_READ_FIFO_REG_OFFSET,
+                        read_32(&buf[i]));
+  }
+  if (i < length) {
+    // Send the remaining bytes in the low bytes of a final word.
+    uint32_t rdfifo_wdata = 0;
+    for (size_t j = 0; i + j < length; ++j) {
+      rdfifo_wdata |= (uint32_t)buf[i + j] << (8 * j);
     }
     mmio_region_write32(spi->dev.base_addr, SPI_DEVICE_TPM_READ_FIFO_REG_OFFSET,
                         rdfifo_wdata);
@@ -941,7 +941,7 @@ TEST_F(TpmTest, CommandAndData) {
   dif_spi_device_tpm_data_status_t status;
   uint8_t command;
   uint32_t address;
-  uint8_t data[4] = {17, 34, 51, 68};
+  uint8_t data[6] = {17, 34, 51, 68, 85, 102};
   uint32_t read_data[4];
   EXPECT_READ32(SPI_DEVICE_TPM_STATUS_REG_OFFSET,
                 {
@@ -970,16 +970,16 @@ TEST_F(TpmTest, CommandAndData) {
   EXPECT_EQ(command, 0x43);
   EXPECT_EQ(address, 0xd40124);
 
-  EXPECT_READ32(SPI_DEVICE_TPM_STATUS_REG_OFFSET,
-                {
-                    {SPI_DEVICE_TPM_STATUS_CMDADDR_NOTEMPTY_BIT, 0},
-                    {SPI_DEVICE_TPM_STATUS_WRFIFO_PENDING_BIT, 0},
-                });
   EXPECT_WRITE32(SPI_DEVICE_TPM_READ_FIFO_REG_OFFSET,
-                 (data[3] << 24) | (data[2] << 16) | (data[1] << 8) | data[0]);
-
+                 (data[2] << 16) | (data[1] << 8) | data[0]);
   EXPECT_DIF_OK(dif_spi_device_tpm_write_data(&spi_, /*length=*/3, data));
 
+  // Whole words are read from an unaligned buffer, then the remaining bytes.
+  EXPECT_WRITE32(SPI_DEVICE_TPM_READ_FIFO_REG_OFFSET,
+                 (data[4] << 24) | (data[3] << 16) | (data[2] << 8) | data[1]);
+  EXPECT_WRITE32(SPI_DEVICE_TPM_READ_FIFO_REG_OFFSET, data[5]);
+  EXPECT_DIF_OK(dif_spi_device_tpm_write_data(&spi_, /*length=*/5, &data[1]));
+
   for (uint32_t i = 0; i < 4; i++) {
     constexpr uint32_t kSpiDeviceTpmWriteFifoOffset =
         SPI_DEVICE_INGRESS_BUFFER_REG_OFFSET +
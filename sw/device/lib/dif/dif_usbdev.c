@@ -549,6 +549,38 @@ dif_result_t dif_usbdev_buffer_write(const dif_usbdev_t *usbdev,
   return kDifOk;
 }
 
+dif_result_t dif_usbdev_buffer_get_view(const dif_usbdev_t *usbdev,
+                                        const dif_usbdev_buffer_t *buffer,
+                                        dif_usbdev_buffer_view_t *view) {
+  if (usbdev == NULL || buffer == NULL || view == NULL ||
+      (buffer->type != kDifUsbdevBufferTypeRead &&
+       buffer->type != kDifUsbdevBufferTypeWrite) ||
+      misalignment32_of(buffer->offset)) {
+    return kDifBadArg;
+  }
+
+  *view = (dif_usbdev_buffer_view_t){
+      .offset = (ptrdiff_t)get_buffer_addr(buffer->id, buffer->offset),
+      .length = buffer->remaining_bytes,
+  };
+
+  return kDifOk;
+}
+
+dif_result_t dif_usbdev_buffer_commit(const dif_usbdev_t *usbdev,
+                                      dif_usbdev_buffer_t *buffer, size_t len) {
+  if (usbdev == NULL || buffer == NULL ||
+      buffer->type != kDifUsbdevBufferTypeWrite ||
+      len > buffer->remaining_bytes) {
+    return kDifBadArg;
+  }
+
+  buffer->offset += len;
+  buffer->remaining_bytes -= len;
+
+  return kDifOk;
+}
+
 dif_result_t dif_usbdev_send(const dif_usbdev_t *usbdev, uint8_t endpoint,
                              dif_usbdev_buffer_t *buffer) {
   if (usbdev == NULL || !is_valid_endpoint(endpoint) || buffer == NULL ||
@@ -118,6 +118,29 @@ typedef struct dif_usbdev_buffer {
   dif_usbdev_buffer_type_t type;
 } dif_usbdev_buffer_t;
 
+/**
+ * A view of the packet data held in a USB device buffer.
+ *
+ * The packet buffer memory supports only aligned 32-bit accesses. A view
+ * locates a buffer's data within the registers of the USB device so that
+ * clients can process it in place with `mmio_region_read32()` and
+ * `mmio_region_write32()`, instead of copying it to or from RAM with
+ * `dif_usbdev_buffer_read()` and `dif_usbdev_buffer_write()`.
+ *
+ * See also: `dif_usbdev_buffer_get_view`, `dif_usbdev_buffer_commit`.
+ */
+typedef struct dif_usbdev_buffer_view {
+  /**
+   * Word-aligned offset of the data from the base address of the USB device.
+   */
+  ptrdiff_t offset;
+  /**
+   * For read buffers: number of bytes of packet data.
+   * For write buffers: number of bytes that can be written.
+   */
+  size_t length;
+} dif_usbdev_buffer_view_t;
+
 /**
  * Configuration for initializing a USB device.
  */
@@ -480,6 +503,47 @@ dif_result_t dif_usbdev_buffer_write(const dif_usbdev_t *usbdev,
                                      const uint8_t *src, size_t src_len,
                                      size_t *bytes_written);
 
+/**
+ * Get a view of the packet data in a buffer.
+ *
+ * Clients can call this function with a buffer provided by `dif_usbdev_recv`
+ * to read an incoming packet payload in place, and then return the buffer with
+ * `dif_usbdev_buffer_return`. With a buffer provided by
+ * `dif_usbdev_buffer_request`, clients can write an outgoing packet payload in
+ * place, record its length with `dif_usbdev_buffer_commit`, and queue it with
+ * `dif_usbdev_send`.
+ *
+ * The view starts at the next byte that `dif_usbdev_buffer_read` or
+ * `dif_usbdev_buffer_write` would access, which must be word-aligned.
+ *
+ * @param usbdev A USB device.
+ * @param buffer A buffer provided by `dif_usbdev_recv` or
+ *               `dif_usbdev_buffer_request`.
+ * @param[out] view The location and length of the data.
+ * @return The result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+dif_result_t dif_usbdev_buffer_get_view(const dif_usbdev_t *usbdev,
+                                        const dif_usbdev_buffer_t *buffer,
+                                        dif_usbdev_buffer_view_t *view);
+
+/**
+ * Record outgoing packet payload that was written in place.
+ *
+ * Clients should call this function after writing `len` bytes to the start of
+ * the view provided by `dif_usbdev_buffer_get_view`. The bytes are then part of
+ * the packet sent by `dif_usbdev_send`, as if they had been written with
+ * `dif_usbdev_buffer_write`.
+ *
+ * @param usbdev A USB device.
+ * @param buffer A buffer provided by `dif_usbdev_buffer_request`.
+ * @param len Number of bytes written.
+ * @return The result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+dif_result_t dif_usbdev_buffer_commit(const dif_usbdev_t *usbdev,
+                                      dif_usbdev_buffer_t *buffer, size_t len);
+
 /**
  * Mark a packet ready for transmission from an endpoint.
  *
@@ -41,6 +41,7 @@ TEST_F(UsbdevTest, NullArgsTest) {
   dif_usbdev_wake_status_t wake_status;
   dif_usbdev_phy_pins_sense_t phy_pins_status;
   dif_usbdev_phy_pins_drive_t phy_pins_drive;
+  dif_usbdev_buffer_view_t view;
 
   EXPECT_DIF_BADARG(dif_usbdev_configure(nullptr, &buffer_pool, config));
   EXPECT_DIF_BADARG(dif_usbdev_configure(&usbdev_, nullptr, config));
@@ -90,6 +91,11 @@ TEST_F(UsbdevTest, NullArgsTest) {
                                             /*src_len=*/1, &size_arg));
   EXPECT_DIF_BADARG(dif_usbdev_buffer_write(&usbdev_, &buffer, &uint8_arg,
                                             /*src_len=*/1, nullptr));
+  EXPECT_DIF_BADARG(dif_usbdev_buffer_get_view(nullptr, &buffer, &view));
+  EXPECT_DIF_BADARG(dif_usbdev_buffer_get_view(&usbdev_, nullptr, &view));
+  EXPECT_DIF_BADARG(dif_usbdev_buffer_get_view(&usbdev_, &buffer, nullptr));
+  EXPECT_DIF_BADARG(dif_usbdev_buffer_commit(nullptr, &buffer, /*len=*/1));
+  EXPECT_DIF_BADARG(dif_usbdev_buffer_commit(&usbdev_, nullptr, /*len=*/1));
   EXPECT_DIF_BADARG(dif_usbdev_send(nullptr, /*endpoint=*/0, &buffer));
   EXPECT_DIF_BADARG(dif_usbdev_send(&usbdev_, /*endpoint=*/0, nullptr));
   EXPECT_DIF_BADARG(dif_usbdev_get_tx_sent(nullptr, &uint16_arg));
@@ -820,6 +826,71 @@ TEST_F(UsbdevTest, InPacket) {
       dif_usbdev_clear_tx_status(&usbdev_, &buffer_pool, /*endpoint=*/5));
 }
 
+TEST_F(UsbdevTest, InPacketInPlace) {
+  dif_usbdev_buffer_pool_t buffer_pool;
+  dif_usbdev_config_t phy_config = {
+      .have_differential_receiver = kDifToggleEnabled,
+      .use_tx_d_se0 = kDifToggleDisabled,
+      .single_bit_eop = kDifToggleDisabled,
+      .pin_flip = kDifToggleDisabled,
+      .clock_sync_signals = kDifToggleEnabled,
+  };
+  EXPECT_WRITE32(USBDEV_PHY_CONFIG_REG_OFFSET,
+                 {
+                     {USBDEV_PHY_CONFIG_USE_DIFF_RCVR_BIT, 1},
+                     {USBDEV_PHY_CONFIG_TX_USE_D_SE0_BIT, 0},
+                     {USBDEV_PHY_CONFIG_EOP_SINGLE_BIT_BIT, 0},
+                     {USBDEV_PHY_CONFIG_PINFLIP_BIT, 0},
+                     {USBDEV_PHY_CONFIG_USB_REF_DISABLE_BIT, 0},
+                 });
+  EXPECT_DIF_OK(dif_usbdev_configure(&usbdev_, &buffer_pool, phy_config));
+
+  dif_usbdev_buffer_t buffer;
+  EXPECT_DIF_OK(dif_usbdev_buffer_request(&usbdev_, &buffer_pool, &buffer));
+
+  // The view covers the whole buffer.
+  dif_usbdev_buffer_view_t view;
+  EXPECT_DIF_OK(dif_usbdev_buffer_get_view(&usbdev_, &buffer, &view));
+  EXPECT_EQ(view.offset, USBDEV_BUFFER_REG_OFFSET + buffer.id * 64);
+  EXPECT_EQ(view.length, 64);
+
+  // Can't commit more than the buffer holds.
+  EXPECT_DIF_BADARG(dif_usbdev_buffer_commit(&usbdev_, &buffer, /*len=*/65));
+  EXPECT_DIF_OK(dif_usbdev_buffer_commit(&usbdev_, &buffer, /*len=*/12));
+
+  // The view follows the committed data.
+  EXPECT_DIF_OK(dif_usbdev_buffer_get_view(&usbdev_, &buffer, &view));
+  EXPECT_EQ(view.offset, USBDEV_BUFFER_REG_OFFSET + buffer.id * 64 + 12);
+  EXPECT_EQ(view.length, 52);
+
+  // No view of a buffer that is not word-aligned.
+  uint8_t byte = 0;
+  size_t bytes_written;
+  EXPECT_READ32(USBDEV_BUFFER_REG_OFFSET + buffer.id * 64 + 12, 0);
+  EXPECT_WRITE32(USBDEV_BUFFER_REG_OFFSET + buffer.id * 64 + 12, 0);
+  EXPECT_DIF_OK(
+      dif_usbdev_buffer_write(&usbdev_, &buffer, &byte, 1, &bytes_written));
+  EXPECT_DIF_BADARG(dif_usbdev_buffer_get_view(&usbdev_, &buffer, &view));
+
+  // The committed length is sent.
+  EXPECT_WRITE32(USBDEV_CONFIGIN_5_REG_OFFSET,
+                 {
+                     {USBDEV_CONFIGIN_5_BUFFER_5_OFFSET, buffer.id},
+                     {USBDEV_CONFIGIN_5_SIZE_5_OFFSET, 13},
+                 });
+  EXPECT_WRITE32(USBDEV_CONFIGIN_5_REG_OFFSET,
+                 {
+                     {USBDEV_CONFIGIN_5_BUFFER_5_OFFSET, buffer.id},
+                     {USBDEV_CONFIGIN_5_SIZE_5_OFFSET, 13},
+                     {USBDEV_CONFIGIN_5_RDY_5_BIT, 1},
+                 });
+  EXPECT_DIF_OK(dif_usbdev_send(&usbdev_, /*endpoint=*/5, &buffer));
+
+  // Read buffers can't be committed.
+  buffer.type = kDifUsbdevBufferTypeRead;
+  EXPECT_DIF_BADARG(dif_usbdev_buffer_commit(&usbdev_, &buffer, /*len=*/0));
+}
+
 TEST_F(UsbdevTest, DeviceAddresses) {
   uint8_t address = 101;
   EXPECT_READ32(USBDEV_USBCTRL_REG_OFFSET,
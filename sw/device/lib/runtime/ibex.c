@@ -26,6 +26,54 @@ uint32_t ibex_mepc_read(void) {
 
 void ibex_mepc_write(uint32_t mepc) { CSR_WRITE(CSR_REG_MEPC, mepc); }
 
+// The CSR macros need constant addresses, so the accesses to the event
+// counters are unrolled.
+#define IBEX_HPM_EVENTS(X) \
+  X(3)                     \
+  X(4)                     \
+  X(5)                     \
+  X(6)                     \
+  X(7)                     \
+  X(8)                     \
+  X(9)                     \
+  X(10)                    \
+  X(11)                    \
+  X(12)
+
+void ibex_hpm_configure(uint32_t events) {
+  // `mcountinhibit` bits: 0 is `mcycle`, 2 is `minstret` and N is
+  // `mhpmcounterN`.
+  uint32_t all_events = ((1u << kIbexHpmEventCount) - 1) << kIbexHpmEventFirst;
+  events &= all_events;
+  // Stop the counters while clearing them.
+  CSR_SET_BITS(CSR_REG_MCOUNTINHIBIT, all_events);
+#define IBEX_HPM_CLEAR(n_)                          \
+  if (events & (1u << n_)) {                        \
+    CSR_WRITE(CSR_REG_MHPMCOUNTER##n_, (uint32_t)0);    \
+    CSR_WRITE(CSR_REG_MHPMCOUNTER##n_##H, (uint32_t)0); \
+  }
+  IBEX_HPM_EVENTS(IBEX_HPM_CLEAR)
+#undef IBEX_HPM_CLEAR
+  CSR_CLEAR_BITS(CSR_REG_MCOUNTINHIBIT, events | (1u << 0) | (1u << 2));
+}
+
+void ibex_hpm_read(ibex_hpm_counters_t *counters) {
+  counters->cycles = ibex_mcycle_read();
+  uint32_t instret_low;
+  uint32_t instret_high;
+  uint32_t instret_high_2;
+  do {
+    CSR_READ(CSR_REG_MINSTRETH, &instret_high);
+    CSR_READ(CSR_REG_MINSTRET, &instret_low);
+    CSR_READ(CSR_REG_MINSTRETH, &instret_high_2);
+  } while (instret_high != instret_high_2);
+  counters->instret = (uint64_t)instret_high << 32 | instret_low;
+#define IBEX_HPM_READ(n_) \
+  CSR_READ(CSR_REG_MHPMCOUNTER##n_, &counters->events[n_ - kIbexHpmEventFirst]);
+  IBEX_HPM_EVENTS(IBEX_HPM_READ)
+#undef IBEX_HPM_READ
+}
+
 // `extern` declarations to give the inline functions in the
 // corresponding header a link location.
 
@@ -91,6 +91,109 @@ inline uint64_t ibex_mcycle_read(void) {
   return (uint64_t)cycle_high << 32 | cycle_low;
 }
 
+/**
+ * An Ibex hardware performance monitor event.
+ *
+ * Ibex hardwires the event selectors: `mhpmcounterN` always counts event `N`.
+ * The number of implemented counters depends on the top-level (Earl Grey only
+ * has `kIbexHpmEventDataWait` and `kIbexHpmEventInstrWait`); unimplemented
+ * counters read as zero.
+ */
+typedef enum ibex_hpm_event {
+  /**
+   * Cycles waiting for data memory (loads and stores).
+   */
+  kIbexHpmEventDataWait = 3,
+  /**
+   * Cycles waiting for instruction fetches.
+   */
+  kIbexHpmEventInstrWait = 4,
+  /**
+   * Number of loads.
+   */
+  kIbexHpmEventLoads = 5,
+  /**
+   * Number of stores.
+   */
+  kIbexHpmEventStores = 6,
+  /**
+   * Number of unconditional jumps.
+   */
+  kIbexHpmEventJumps = 7,
+  /**
+   * Number of conditional branches.
+   */
+  kIbexHpmEventBranches = 8,
+  /**
+   * Number of taken conditional branches.
+   */
+  kIbexHpmEventBranchesTaken = 9,
+  /**
+   * Number of retired compressed instructions.
+   */
+  kIbexHpmEventCompressedInstrs = 10,
+  /**
+   * Cycles waiting for a multiplication to complete.
+   */
+  kIbexHpmEventMulWait = 11,
+  /**
+   * Cycles waiting for a division to complete.
+   */
+  kIbexHpmEventDivWait = 12,
+} ibex_hpm_event_t;
+
+enum {
+  /**
+   * The first event in `ibex_hpm_event_t`.
+   */
+  kIbexHpmEventFirst = kIbexHpmEventDataWait,
+  /**
+   * The number of events in `ibex_hpm_event_t`.
+   */
+  kIbexHpmEventCount = kIbexHpmEventDivWait - kIbexHpmEventFirst + 1,
+};
+
+/**
+ * A snapshot of the Ibex performance counters.
+ */
+typedef struct ibex_hpm_counters {
+  /**
+   * Value of `mcycle`.
+   */
+  uint64_t cycles;
+  /**
+   * Value of `minstret`.
+   */
+  uint64_t instret;
+  /**
+   * Value of the counter for each event, indexed by
+   * `event - kIbexHpmEventFirst`.
+   */
+  uint32_t events[kIbexHpmEventCount];
+} ibex_hpm_counters_t;
+
+/**
+ * Configures the Ibex performance counters.
+ *
+ * The counters for the events in `events` are cleared and enabled, the
+ * counters for the other events are disabled. `mcycle` and `minstret` are
+ * always enabled since other code relies on `mcycle`.
+ *
+ * @param events Bitmask of the events to count, with bit `N` set for event `N`
+ * (for example `1 << kIbexHpmEventInstrWait`).
+ */
+void ibex_hpm_configure(uint32_t events);
+
+/**
+ * Reads all the Ibex performance counters.
+ *
+ * Only the low 32 bits of the event counters are read, which is their full
+ * width on Earl Grey.
+ *
+ * @param[out] counters The counter values.
+ */
+void ibex_hpm_read(ibex_hpm_counters_t *counters);
+
 /**
  * Reads the mcause register.
  *
@@ -175,7 +278,7 @@ void ibex_mepc_write(uint32_t mepc);
 OT_WARN_UNUSED_RESULT
 inline ibex_timeout_t ibex_timeout_init(uint32_t timeout_usec) {
   return (ibex_timeout_t){
-      .cycles = udiv64_slow(kClockFreqCpuHz * timeout_usec, 1000000, NULL),
+      .cycles = udiv64(kClockFreqCpuHz * timeout_usec, 1000000, NULL),
       .start = ibex_mcycle_read(),
   };
 }
@@ -200,8 +303,8 @@ inline bool ibex_timeout_check(const ibex_timeout_t *timeout) {
  */
 OT_WARN_UNUSED_RESULT
 inline uint64_t ibex_timeout_elapsed(const ibex_timeout_t *timeout) {
-  return udiv64_slow((ibex_mcycle_read() - timeout->start) * 1000000,
-                     kClockFreqCpuHz, NULL);
+  return udiv64((ibex_mcycle_read() - timeout->start) * 1000000,
+                kClockFreqCpuHz, NULL);
 }
 
 /**
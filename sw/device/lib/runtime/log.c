@@ -20,6 +20,18 @@
 static_assert(sizeof(log_fields_t) == 20,
               "log_fields_t must always be 20 bytes.");
 
+#ifndef OT_LOG_BINARY
+#define OT_LOG_BINARY 0
+#endif
+
+/**
+ * Whether informational logs are written in the binary format. Builds may
+ * enable it by default with `--copt=-DOT_LOG_BINARY=1`.
+ */
+static bool log_binary = OT_LOG_BINARY;
+
+void base_log_set_binary(bool enable) { log_binary = enable; }
+
 /**
  * Converts a severity to a static string.
  */
@@ -60,6 +72,27 @@ void base_log_internal_core(const log_fields_t *log, ...) {
   // nothing was printed for some time.
   static uint16_t global_log_counter = 0;
 
+  if (log_binary && log->severity == kLogSeverityInfo) {
+    uint32_t fields = (uint32_t)(uintptr_t)log;
+    char record[kLogBinaryRecordHeaderSize] = {
+        (char)kLogBinaryRecordMarker,
+        (char)fields,
+        (char)(fields >> 8),
+        (char)(fields >> 16),
+        (char)(fields >> 24),
+        (char)global_log_counter,
+        (char)(global_log_counter >> 8),
+    };
+    ++global_log_counter;
+    base_printf("%!s", sizeof(record), record);
+
+    va_list args;
+    va_start(args, log);
+    base_vprintf_binary(log->format, args);
+    va_end(args);
+    return;
+  }
+
   base_printf("%s%05d %s:%d] ", stringify_severity(log->severity),
               global_log_counter, base_name, log->line);
   ++global_log_counter;
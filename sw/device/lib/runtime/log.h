@@ -87,6 +87,31 @@ typedef struct log_fields {
   const char *format;
 } log_fields_t;
 
+/**
+ * Binary log record format.
+ *
+ * When binary logging is enabled, an informational log is written as a record
+ * instead of a formatted line: the marker byte, the address of the log's
+ * `log_fields_t` as a little-endian 32-bit word and the log counter as a
+ * little-endian 16-bit word, followed by the values of the arguments encoded
+ * by `base_vprintf_binary()`. The marker cannot occur in UTF-8 text. The host
+ * looks the fields up in the ELF file to format the line, see
+ * util/device_sw_utils/decode_binary_logs.py.
+ */
+enum {
+  kLogBinaryRecordMarker = 0xfe,
+  kLogBinaryRecordHeaderSize = 7,
+};
+
+/**
+ * Selects whether informational logs are written as binary log records.
+ *
+ * Warnings and errors are always formatted on the device.
+ *
+ * @param enable true to write binary records; false to format logs.
+ */
+void base_log_set_binary(bool enable);
+
 // Internal functions exposed only for access by macros. Their
 // real doxygen can be found in log.c.
 /**
@@ -9,6 +9,7 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include "sw/device/lib/base/crc32.h"
 #include "sw/device/lib/base/macros.h"
 #include "sw/device/lib/base/memory.h"
 #include "sw/device/lib/base/status.h"
@@ -80,6 +81,8 @@ static const size_t kSpiDeviceMaxFramePayloadSizeBytes =
     kSpiDeviceReadBufferSizeBytes - kSpiDeviceFrameHeaderSizeBytes -
     kSpiDeviceBufferPreservedSizeBytes - 4;
 static const uint32_t kSpiDeviceFrameMagicNumber = 0xa5a5beef;
+static const uint32_t kSpiDeviceFrameCrcMagicNumber = 0xa5a5c3c3;
+static const size_t kSpiDeviceFrameCrcSizeBytes = 4;
 static uint32_t spi_device_frame_num = 0;
 
 static status_t spi_device_send_data(dif_spi_device_handle_t *spi_device,
@@ -126,12 +129,22 @@ static status_t spi_device_send_data(dif_spi_device_handle_t *spi_device,
  * -----------------------------------|   Data   |
  * |     0xFF Pad Bytes    | <4-bytes |          |
  * -----------------------------------|----------|
+ * |   CRC32 (optional)    | 4-bytes  | Trailer  |
+ * -----------------------------------------------
+ *
+ * Frames with a CRC32 trailer use a different magic number so that the host
+ * knows to read and check the trailer. The CRC32 covers the data bytes only,
+ * not the padding.
  */
-static size_t spi_device_send_frame(void *data, const char *buf, size_t len) {
+static size_t spi_device_send_frame(void *data, const char *buf, size_t len,
+                                    bool crc) {
   dif_spi_device_handle_t *spi_device = (dif_spi_device_handle_t *)data;
   const size_t data_packet_size_bytes = ((len + 3u) & ~3u);
-  const size_t frame_size_bytes =
-      kSpiDeviceFrameHeaderSizeBytes + data_packet_size_bytes;
+  const size_t frame_size_bytes = kSpiDeviceFrameHeaderSizeBytes +
+                                  data_packet_size_bytes +
+                                  (crc ? kSpiDeviceFrameCrcSizeBytes : 0);
+  const uint32_t magic =
+      crc ? kSpiDeviceFrameCrcMagicNumber : kSpiDeviceFrameMagicNumber;
   uint8_t frame_header_bytes[kSpiDeviceFrameHeaderSizeBytes];
 
   static uint32_t next_write_address = 0;
@@ -142,7 +155,7 @@ static size_t spi_device_send_frame(void *data, const char *buf, size_t len) {
 
   // Add the magic bytes.
   for (size_t i = 0; i < 4; ++i) {
-    frame_header_bytes[i] = (kSpiDeviceFrameMagicNumber >> (i * 8)) & 0xff;
+    frame_header_bytes[i] = (magic >> (i * 8)) & 0xff;
   }
   // Add the frame number.
   for (size_t i = 0; i < 4; ++i) {
@@ -210,6 +223,22 @@ static size_t spi_device_send_frame(void *data, const char *buf, size_t len) {
     }
   }
 
+  // Send the CRC32 trailer.
+  if (crc) {
+    uint32_t checksum = crc32(buf, len);
+    uint8_t crc_bytes[kSpiDeviceFrameCrcSizeBytes];
+    for (size_t i = 0; i < kSpiDeviceFrameCrcSizeBytes; ++i) {
+      crc_bytes[i] = (checksum >> (i * 8)) & 0xff;
+    }
+    size_t crc_write_address = (data_write_address + data_packet_size_bytes) %
+                               kSpiDeviceReadBufferSizeBytes;
+    if (!status_ok(spi_device_send_data(spi_device, crc_bytes,
+                                        kSpiDeviceFrameCrcSizeBytes,
+                                        crc_write_address))) {
+      return 0;
+    }
+  }
+
   // Send frame header.
   if (!status_ok(spi_device_send_data(spi_device, frame_header_bytes,
                                       kSpiDeviceFrameHeaderSizeBytes,
@@ -224,16 +253,20 @@ static size_t spi_device_send_frame(void *data, const char *buf, size_t len) {
   return len;
 }
 
-static size_t base_dev_spi_device(void *data, const char *buf, size_t len) {
+static size_t spi_device_send_frames(void *data, const char *buf, size_t len,
+                                     bool crc) {
+  const size_t max_payload_len =
+      kSpiDeviceMaxFramePayloadSizeBytes -
+      (crc ? kSpiDeviceFrameCrcSizeBytes : 0);
   size_t write_data_len = 0;
 
   while (write_data_len < len) {
     size_t payload_len = len - write_data_len;
-    if (payload_len > kSpiDeviceMaxFramePayloadSizeBytes) {
-      payload_len = kSpiDeviceMaxFramePayloadSizeBytes;
+    if (payload_len > max_payload_len) {
+      payload_len = max_payload_len;
     }
 
-    if (spi_device_send_frame(data, buf + write_data_len, payload_len) ==
+    if (spi_device_send_frame(data, buf + write_data_len, payload_len, crc) ==
         payload_len) {
       write_data_len += payload_len;
     }
@@ -242,8 +275,21 @@ static size_t base_dev_spi_device(void *data, const char *buf, size_t len) {
   return write_data_len;
 }
 
+static size_t base_dev_spi_device(void *data, const char *buf, size_t len) {
+  return spi_device_send_frames(data, buf, len, /*crc=*/false);
+}
+
+static size_t base_dev_spi_device_crc(void *data, const char *buf,
+                                      size_t len) {
+  return spi_device_send_frames(data, buf, len, /*crc=*/true);
+}
+
 sink_func_ptr get_spi_device_sink(void) { return &base_dev_spi_device; }
 
+sink_func_ptr get_spi_device_crc_sink(void) {
+  return &base_dev_spi_device_crc;
+}
+
 static size_t base_dev_uart(void *data, const char *buf, size_t len) {
   const dif_uart_t *uart = (const dif_uart_t *)data;
   for (size_t i = 0; i < len; ++i) {
@@ -448,8 +494,28 @@ static size_t write_digits(buffer_sink_t out, uint32_t value, uint32_t width,
     ++len;
   }
   while (value > 0) {
-    uint32_t digit = value % base;
-    value /= base;
+    // Dispatch on the supported bases so that the compiler sees constant
+    // divisors: hex and octal become shifts and decimal a multiplication,
+    // instead of a (slow) division by a variable on every digit.
+    uint32_t digit;
+    switch (base) {
+      case 16:
+        digit = value & 0xf;
+        value >>= 4;
+        break;
+      case 10:
+        digit = value % 10;
+        value /= 10;
+        break;
+      case 8:
+        digit = value & 0x7;
+        value >>= 3;
+        break;
+      default:
+        digit = value % base;
+        value /= base;
+        break;
+    }
     buffer[kWordBits - 1 - len] = glyphs[digit];
     ++len;
   }
@@ -512,32 +578,31 @@ static size_t hex_dump(buffer_sink_t out, const char *bytes, size_t len,
                        uint32_t width, char padding, bool big_endian,
                        const char *glyphs) {
   size_t bytes_written = 0;
-  char buf[32];
-  size_t buffered = 0;
+  char buf[64];
   if (len < width) {
     width -= len;
     memset(buf, padding, sizeof(buf));
     while (width > 0) {
-      size_t to_write = width > ARRAYSIZE(buf) ? 32 : width;
+      size_t to_write = width > ARRAYSIZE(buf) ? ARRAYSIZE(buf) : width;
       bytes_written += out.sink(out.data, buf, to_write);
       width -= to_write;
     }
   }
 
-  for (size_t i = 0; i < len; ++i) {
-    size_t idx = big_endian ? len - i - 1 : i;
-    buf[buffered] = glyphs[(bytes[idx] >> 4) & 0xf];
-    buf[buffered + 1] = glyphs[bytes[idx] & 0xf];
-    buffered += 2;
-
-    if (buffered == ARRAYSIZE(buf)) {
-      bytes_written += out.sink(out.data, buf, buffered);
-      buffered = 0;
+  // Convert as many bytes as fit in `buf` in one go and hand each full chunk
+  // to the sink with a single call.
+  size_t i = 0;
+  while (i < len) {
+    size_t chunk = len - i;
+    if (chunk > ARRAYSIZE(buf) / 2) {
+      chunk = ARRAYSIZE(buf) / 2;
     }
-  }
-
-  if (buffered != 0) {
-    bytes_written += out.sink(out.data, buf, buffered);
+    for (size_t j = 0; j < chunk; ++j, ++i) {
+      uint8_t byte = (uint8_t)bytes[big_endian ? len - i - 1 : i];
+      buf[2 * j] = glyphs[byte >> 4];
+      buf[2 * j + 1] = glyphs[byte & 0xf];
+    }
+    bytes_written += out.sink(out.data, buf, 2 * chunk);
   }
   return bytes_written;
 }
@@ -576,16 +641,21 @@ static void process_specifier(buffer_sink_t out, format_specifier_t spec,
     }
     case kFourCC: {
       uint32_t value = va_arg(*args, uint32_t);
+      // Worst case, every byte is escaped as `\xNN`.
+      char buf[4 * sizeof(uint32_t)];
+      size_t len = 0;
       for (size_t i = 0; i < sizeof(uint32_t); ++i, value >>= 8) {
         uint8_t ch = (uint8_t)value;
         if (ch >= 32 && ch < 127) {
-          *bytes_written += out.sink(out.data, (const char *)&ch, 1);
+          buf[len++] = (char)ch;
         } else {
-          *bytes_written += out.sink(out.data, "\\x", 2);
-          *bytes_written += out.sink(out.data, &kDigitsLow[ch >> 4], 1);
-          *bytes_written += out.sink(out.data, &kDigitsLow[ch & 15], 1);
+          buf[len++] = '\\';
+          buf[len++] = 'x';
+          buf[len++] = kDigitsLow[ch >> 4];
+          buf[len++] = kDigitsLow[ch & 15];
         }
       }
+      *bytes_written += out.sink(out.data, buf, len);
       break;
     }
     case kString: {
@@ -759,6 +829,105 @@ size_t base_vfprintf(buffer_sink_t out, const char *format, va_list args) {
   return bytes_written;
 }
 
+static size_t write_binary_word(buffer_sink_t out, uint32_t value) {
+  char bytes[sizeof(uint32_t)];
+  for (size_t i = 0; i < sizeof(bytes); ++i) {
+    bytes[i] = (char)(value >> (i * 8));
+  }
+  return out.sink(out.data, bytes, sizeof(bytes));
+}
+
+static size_t write_binary_buffer(buffer_sink_t out, const char *buf,
+                                  size_t len) {
+  size_t bytes_written = write_binary_word(out, (uint32_t)len);
+  return bytes_written + out.sink(out.data, buf, len);
+}
+
+size_t base_vfprintf_binary(buffer_sink_t out, const char *format,
+                            va_list args) {
+  if (out.sink == NULL) {
+    out.sink = &base_dev_null;
+  }
+  // The literal text of `format` and any parse errors are not written; the
+  // host reproduces them from the format string.
+  buffer_sink_t text_out = {.data = NULL, .sink = &base_dev_null};
+  size_t text_written = 0;
+
+  // See `base_vfprintf()` for why this copy is necessary.
+  va_list args_copy;
+  va_copy(args_copy, args);
+
+  size_t bytes_written = 0;
+  while (format[0] != '\0') {
+    if (!consume_until_percent(text_out, &format, &text_written)) {
+      break;
+    }
+    format_specifier_t spec;
+    if (!consume_format_specifier(text_out, &format, &text_written, &spec)) {
+      break;
+    }
+    // This mirrors the arguments consumed by `process_specifier()`.
+    switch (spec.type) {
+      case kCharacter:
+      case kSignedDec1:
+      case kSignedDec2:
+      case kUnsignedOct:
+      case kPointer:
+      case kUnsignedDec:
+        if (!spec.is_nonstd) {
+          bytes_written += write_binary_word(out, va_arg(args_copy, uint32_t));
+        }
+        break;
+      case kString: {
+        size_t len = 0;
+        if (spec.is_nonstd) {
+          len = va_arg(args_copy, size_t);
+        }
+        char *value = va_arg(args_copy, char *);
+        while (!spec.is_nonstd && value[len] != '\0') {
+          ++len;
+        }
+        bytes_written += write_binary_buffer(out, value, len);
+        break;
+      }
+      case kUnsignedHexLow:
+      case kUnsignedHexHigh:
+      case kHexLeLow:
+      case kHexLeHigh:
+        if (spec.is_nonstd) {
+          size_t len = va_arg(args_copy, size_t);
+          char *value = va_arg(args_copy, char *);
+          bytes_written += write_binary_buffer(out, value, len);
+        } else if (spec.type == kUnsignedHexLow ||
+                   spec.type == kUnsignedHexHigh) {
+          bytes_written += write_binary_word(out, va_arg(args_copy, uint32_t));
+        }
+        break;
+      case kFourCC:
+      case kSvHexLow:
+      case kSvHexHigh:
+      case kSvBinary:
+        bytes_written += write_binary_word(out, va_arg(args_copy, uint32_t));
+        break;
+      case kStatusResult: {
+        status_t value = va_arg(args_copy, status_t);
+        bytes_written += write_binary_word(out, (uint32_t)value.value);
+        break;
+      }
+      default:
+        // `%%` and invalid specifiers consume no arguments.
+        break;
+    }
+  }
+
+  va_end(args_copy);
+  return bytes_written;
+}
+
+size_t base_vprintf_binary(const char *format, va_list args) {
+  return base_vfprintf_binary(base_stdout, format, args);
+}
+
 const char kBaseHexdumpDefaultFmtAlphabet[256] =
     // clang-format off
   // First 32 characters are not printable.
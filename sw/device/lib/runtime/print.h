@@ -53,6 +53,12 @@ typedef struct buffer_sink {
  */
 sink_func_ptr get_spi_device_sink(void);
 
+/**
+ * Returns a function pointer to the spi device sink function that appends a
+ * CRC32 trailer to every frame.
+ */
+sink_func_ptr get_spi_device_crc_sink(void);
+
 /**
  * Returns a function pointer to the uart sink function.
  */
@@ -188,6 +194,39 @@ size_t base_fprintf(buffer_sink_t out, const char *format, ...);
  */
 size_t base_vfprintf(buffer_sink_t out, const char *format, va_list args);
 
+/**
+ * Writes the values for `format` to the sink `out` in binary, without
+ * formatting them.
+ *
+ * Each value consumed by a specifier in `format` is written as a little-endian
+ * 32-bit word, except for the buffers printed by %s, %!s, %!x, %!X, %!y and
+ * %!Y, which are written as their length, as a 32-bit word, followed by their
+ * bytes. The text of `format` itself is not written. This allows a host that
+ * knows `format` to produce the output of `base_vfprintf()` later, see
+ * util/device_sw_utils/decode_binary_logs.py.
+ *
+ * This function *does not* take ownership of `args`; callers are responsible
+ * for calling `va_end`.
+ *
+ * @param out a sink to print to.
+ * @param format the format spec.
+ * @param args values to interpolate in the format spec.
+ * @return the number of bytes written.
+ */
+size_t base_vfprintf_binary(buffer_sink_t out, const char *format,
+                            va_list args);
+
+/**
+ * Writes the values for `format` to stdout in binary, without formatting them.
+ *
+ * See `base_vfprintf_binary()` for the encoding.
+ *
+ * @param format the format spec.
+ * @param args values to interpolate in the format spec.
+ * @return the number of bytes written.
+ */
+size_t base_vprintf_binary(const char *format, va_list args);
+
 /**
  * Configuration options for `base_hexdump` and friends.
  */
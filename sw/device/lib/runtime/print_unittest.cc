@@ -145,6 +145,31 @@ TEST_F(PrintfTest, UpperLeHexStringWithLen) {
   EXPECT_EQ(buf_, "Hello, EFBEADDE!\n");
 }
 
+TEST_F(PrintfTest, LongHexString) {
+  // Longer than the internal conversion buffer, so it is flushed in chunks.
+  std::string bytes;
+  std::string expected_be;
+  std::string expected_le;
+  for (int i = 0; i < 100; ++i) {
+    bytes.push_back(static_cast<char>(i * 7));
+    expected_le += absl::StrFormat("%02x", (i * 7) & 0xff);
+    expected_be = absl::StrFormat("%02x", (i * 7) & 0xff) + expected_be;
+  }
+  EXPECT_EQ(base_printf("%!x", bytes.size(), bytes.data()), 200);
+  EXPECT_EQ(buf_, expected_be);
+  buf_.clear();
+  EXPECT_EQ(base_printf("%!y", bytes.size(), bytes.data()), 200);
+  EXPECT_EQ(buf_, expected_le);
+}
+
+TEST_F(PrintfTest, HexStringWithWidePadding) {
+  uint32_t val = 0xdeadbeef;
+  // The width counts bytes, so one padding character is written per missing
+  // byte.
+  EXPECT_EQ(base_printf("%!032x", 4, &val), 36);
+  EXPECT_EQ(buf_, std::string(28, '0') + "deadbeef");
+}
+
 TEST_F(PrintfTest, SignedInt) {
   EXPECT_EQ(base_printf("Hello, %i!\n", 42), 11);
   EXPECT_EQ(buf_, "Hello, 42!\n");
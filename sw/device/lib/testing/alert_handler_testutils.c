@@ -145,13 +145,15 @@ status_t alert_handler_testutils_configure_all(
   return OK_STATUS();
 }
 
+// Reciprocal for the conversion from microseconds, computed on first use.
+static udiv64_recip_t us_per_s_recip;
+
 status_t alert_handler_testutils_get_cycles_from_us(uint64_t microseconds,
                                                     uint32_t *cycles) {
-  uint64_t cycles_ = udiv64_slow(
+  uint64_t cycles_ = udiv64_cached(
       microseconds * dt_clock_frequency(dt_alert_handler_clock(
                          (dt_alert_handler_t)0, kDtAlertHandlerClockClk)),
-      1000000,
-      /*rem_out=*/NULL);
+      1000000, &us_per_s_recip);
   TRY_CHECK(cycles_ < UINT32_MAX,
             "The value 0x%08x%08x can't fit into the 32 bits timer counter.",
             (uint32_t)(cycles_ >> 32), (uint32_t)cycles_);
@@ -104,7 +104,7 @@ status_t alert_handler_testutils_get_cycles_from_us(uint64_t microseconds,
  * frequencies, and other platforms get the cycle count rescaled by a factor
  * of 10. It should be used in the conversion of time duration to cycle counts,
  * as in
- *  cycles = udiv64_slow(micros * clockFreqHz, 1000000, NULL) *
+ *  cycles = udiv64(micros * clockFreqHz, 1000000, NULL) *
  *           cycle_rescaling_factor();
  */
 uint32_t alert_handler_testutils_cycle_rescaling_factor(void);
@@ -17,13 +17,17 @@
 
 #define MODULE_ID MAKE_MODULE_ID('a', 'o', 't')
 
+// Reciprocals for the conversions between microseconds and AON cycles, which
+// tests tend to do while polling. They are computed on first use.
+static udiv64_recip_t us_per_s_recip;
+static udiv64_recip_t aon_freq_recip;
+
 status_t aon_timer_testutils_get_aon_cycles_32_from_us(uint64_t microseconds,
                                                        uint32_t *cycles) {
-  uint64_t cycles_ =
-      udiv64_slow(microseconds * dt_clock_frequency(dt_aon_timer_clock(
-                                     kDtAonTimerAon, kDtAonTimerClockAon)),
-                  1000000,
-                  /*rem_out=*/NULL);
+  uint64_t cycles_ = udiv64_cached(
+      microseconds * dt_clock_frequency(dt_aon_timer_clock(
+                         kDtAonTimerAon, kDtAonTimerClockAon)),
+      1000000, &us_per_s_recip);
   TRY_CHECK(cycles_ <= UINT32_MAX,
             "The value 0x%08x%08x can't fit into the 32 bits timer counter.",
             (uint32_t)(cycles_ >> 32), (uint32_t)cycles_);
@@ -33,20 +37,19 @@ status_t aon_timer_testutils_get_aon_cycles_32_from_us(uint64_t microseconds,
 
 status_t aon_timer_testutils_get_aon_cycles_64_from_us(uint64_t microseconds,
                                                        uint64_t *cycles) {
-  *cycles =
-      udiv64_slow(microseconds * dt_clock_frequency(dt_aon_timer_clock(
-                                     kDtAonTimerAon, kDtAonTimerClockAon)),
-                  1000000,
-                  /*rem_out=*/NULL);
+  *cycles = udiv64_cached(
+      microseconds * dt_clock_frequency(dt_aon_timer_clock(
+                         kDtAonTimerAon, kDtAonTimerClockAon)),
+      1000000, &us_per_s_recip);
   return OK_STATUS();
 }
 
 status_t aon_timer_testutils_get_us_from_aon_cycles(uint64_t cycles,
                                                     uint32_t *us) {
-  uint64_t uss = udiv64_slow(cycles * 1000000,
-                             dt_clock_frequency(dt_aon_timer_clock(
-                                 kDtAonTimerAon, kDtAonTimerClockAon)),
-                             /*rem_out=*/NULL);
+  uint64_t uss = udiv64_cached(cycles * 1000000,
+                               dt_clock_frequency(dt_aon_timer_clock(
+                                   kDtAonTimerAon, kDtAonTimerClockAon)),
+                               &aon_freq_recip);
   TRY_CHECK(uss <= UINT32_MAX,
             "The value 0x%08x%08x can't fit into the 32 bits timer counter.",
             (uint32_t)(uss >> 32), (uint32_t)uss);
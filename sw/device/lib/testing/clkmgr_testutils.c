@@ -74,24 +74,22 @@ void initialize_expected_counts(void) {
   // The expected counts are derived from the ratios of the frequencies of the
   // various clocks to the AON clock. For example, 48 Mhz / 200 kHz = 240.
   const uint32_t kDeviceCpuCount =
-      cast_safely(udiv64_slow(kClockFreqCpuHz, kClockFreqAonHz,
-                              /*rem_out=*/NULL));
+      cast_safely(udiv64(kClockFreqCpuHz, kClockFreqAonHz, /*rem_out=*/NULL));
   const uint32_t kDeviceIoCount =
-      cast_safely(udiv64_slow(kClockFreqPeripheralHz, kClockFreqAonHz,
-                              /*rem_out=*/NULL) *
+      cast_safely(udiv64(kClockFreqPeripheralHz, kClockFreqAonHz,
+                         /*rem_out=*/NULL) *
                   4);
 #if defined(OPENTITAN_IS_EARLGREY)
   const uint32_t kDeviceIoDiv2Count =
-      cast_safely(udiv64_slow(kClockFreqPeripheralHz, kClockFreqAonHz,
-                              /*rem_out=*/NULL) *
+      cast_safely(udiv64(kClockFreqPeripheralHz, kClockFreqAonHz,
+                         /*rem_out=*/NULL) *
                   2);
 #endif
   const uint32_t kDeviceIoDiv4Count =
-      cast_safely(udiv64_slow(kClockFreqPeripheralHz, kClockFreqAonHz,
-                              /*rem_out=*/NULL));
+      cast_safely(udiv64(kClockFreqPeripheralHz, kClockFreqAonHz,
+                         /*rem_out=*/NULL));
   const uint32_t kDeviceUsbCount =
-      cast_safely(udiv64_slow(kClockFreqUsbHz, kClockFreqAonHz,
-                              /*rem_out=*/NULL));
+      cast_safely(udiv64(kClockFreqUsbHz, kClockFreqAonHz, /*rem_out=*/NULL));
 
   LOG_INFO("Variability for Io %d is %d", kDeviceIoCount,
            get_count_variability(kDeviceIoCount, kVariabilityPercentage));
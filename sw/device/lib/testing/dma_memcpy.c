@@ -0,0 +1,155 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "sw/device/lib/testing/dma_memcpy.h"
+
+#include <stdbool.h>
+
+#include "sw/device/lib/base/memory.h"
+#include "sw/device/lib/dif/dif_dma.h"
+#include "sw/device/lib/dif/dif_rv_plic.h"
+#include "sw/device/lib/testing/test_framework/ottf_isrs.h"
+
+#define MODULE_ID MAKE_MODULE_ID('d', 'm', 'c')
+
+static dif_dma_t dma;
+static size_t dma_threshold;
+static volatile bool dma_busy;
+static dma_memcpy_callback_t dma_callback;
+static void *dma_callback_ctx;
+
+// Source of DMA fills: the DMA reads this word repeatedly without
+// incrementing the source address.
+static uint32_t fill_word;
+
+static void dma_isr(uint32_t *exc_info, dif_rv_plic_irq_id_t plic_id,
+                    void *ctx) {
+  status_t result = OK_STATUS();
+  dif_dma_status_t status;
+  if (dif_dma_status_get(&dma, &status) != kDifOk) {
+    result = INTERNAL();
+  } else if (status & kDifDmaStatusError) {
+    dif_dma_error_code_t error = kDifDmaErrorNone;
+    OT_DISCARD(dif_dma_error_code_get(&dma, &error));
+    result = INTERNAL((int32_t)error);
+  } else if (!(status & kDifDmaStatusDone)) {
+    // Spurious: the transfer is still running.
+    return;
+  }
+
+  // Both interrupts are status type: they stay asserted until the status bits
+  // that drive them are cleared.
+  OT_DISCARD(dif_dma_status_clear(&dma));
+  OT_DISCARD(dif_dma_irq_acknowledge_all(&dma));
+
+  dma_memcpy_callback_t callback = dma_callback;
+  dma_busy = false;
+  if (callback != NULL) {
+    callback(result, dma_callback_ctx);
+  }
+}
+
+status_t dma_memcpy_init(dt_dma_t dt, size_t threshold,
+                         uint32_t irq_priority) {
+  TRY(dif_dma_init_from_dt(dt, &dma));
+  dma_threshold = threshold;
+  dma_busy = false;
+
+  TRY(ottf_irq_register(dt_dma_irq_to_plic_id(dt, kDtDmaIrqDmaDone),
+                        irq_priority, /*preemptible=*/false, dma_isr, NULL));
+  TRY(ottf_irq_register(dt_dma_irq_to_plic_id(dt, kDtDmaIrqDmaError),
+                        irq_priority, /*preemptible=*/false, dma_isr, NULL));
+  TRY(dif_dma_irq_set_enabled(&dma, kDifDmaIrqDmaDone, kDifToggleEnabled));
+  TRY(dif_dma_irq_set_enabled(&dma, kDifDmaIrqDmaError, kDifToggleEnabled));
+  return OK_STATUS();
+}
+
+/**
+ * Returns whether `[addr, addr + len)` lies inside the DMA enabled memory
+ * range.
+ */
+static bool in_dma_range(uintptr_t addr, size_t len) {
+  bool valid;
+  uint32_t base;
+  size_t size;
+  if (dif_dma_is_memory_range_valid(&dma, &valid) != kDifOk || !valid ||
+      dif_dma_memory_range_get(&dma, &base, &size) != kDifOk) {
+    return false;
+  }
+  return addr >= base && addr - base <= size && len <= size - (addr - base);
+}
+
+/**
+ * Returns whether a transfer should go to the DMA.
+ */
+static bool use_dma(uintptr_t dest, uintptr_t src, size_t src_len,
+                    size_t len) {
+  if (len < dma_threshold || len == 0) {
+    return false;
+  }
+  if (misalignment32_of(dest) != 0 || misalignment32_of(src) != 0 ||
+      len % sizeof(uint32_t) != 0) {
+    return false;
+  }
+  return in_dma_range(dest, len) && in_dma_range(src, src_len);
+}
+
+static status_t dma_start(uintptr_t dest, uintptr_t src, bool src_increment,
+                          size_t len, dma_memcpy_callback_t callback,
+                          void *ctx) {
+  dif_dma_transaction_t transaction = {
+      .source = {.address = src, .asid = kDifDmaOpentitanInternalBus},
+      .destination = {.address = dest, .asid = kDifDmaOpentitanInternalBus},
+      .src_config = {.wrap = false, .increment = src_increment},
+      .dst_config = {.wrap = false, .increment = true},
+      .total_size = len,
+      .chunk_size = len,
+      .width = kDifDmaTransWidth4Bytes};
+
+  dma_callback = callback;
+  dma_callback_ctx = ctx;
+  dma_busy = true;
+  TRY(dif_dma_status_clear(&dma));
+  TRY(dif_dma_configure(&dma, transaction));
+  TRY(dif_dma_start(&dma, kDifDmaCopyOpcode));
+  return OK_STATUS();
+}
+
+status_t dma_memcpy_async(void *dest, const void *src, size_t len,
+                          dma_memcpy_callback_t callback, void *ctx) {
+  if (use_dma((uintptr_t)dest, (uintptr_t)src, len, len)) {
+    if (dma_busy) {
+      return UNAVAILABLE();
+    }
+    return dma_start((uintptr_t)dest, (uintptr_t)src, /*src_increment=*/true,
+                     len, callback, ctx);
+  }
+
+  memcpy(dest, src, len);
+  if (callback != NULL) {
+    callback(OK_STATUS(), ctx);
+  }
+  return OK_STATUS();
+}
+
+status_t dma_memset_async(void *dest, uint8_t value, size_t len,
+                          dma_memcpy_callback_t callback, void *ctx) {
+  if (use_dma((uintptr_t)dest, (uintptr_t)&fill_word, sizeof(fill_word),
+              len)) {
+    if (dma_busy) {
+      return UNAVAILABLE();
+    }
+    fill_word = value * 0x01010101u;
+    return dma_start((uintptr_t)dest, (uintptr_t)&fill_word,
+                     /*src_increment=*/false, len, callback, ctx);
+  }
+
+  memset(dest, value, len);
+  if (callback != NULL) {
+    callback(OK_STATUS(), ctx);
+  }
+  return OK_STATUS();
+}
+
+bool dma_memcpy_busy(void) { return dma_busy; }
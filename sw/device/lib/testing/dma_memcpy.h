@@ -0,0 +1,85 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef OPENTITAN_SW_DEVICE_LIB_TESTING_DMA_MEMCPY_H_
+#define OPENTITAN_SW_DEVICE_LIB_TESTING_DMA_MEMCPY_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "dt/dt_dma.h"  // Generated
+#include "sw/device/lib/base/macros.h"
+#include "sw/device/lib/base/status.h"
+
+/**
+ * @file
+ * @brief Asynchronous memcpy/memset that offloads large transfers to the DMA.
+ *
+ * Transfers of at least the configured threshold are run on the DMA when the
+ * source and destination are word aligned and lie inside the DMA enabled
+ * memory range; the caller is notified from the DMA done or error interrupt,
+ * dispatched through `ottf_irq_register()`. Everything else is done on Ibex
+ * with `memcpy()`/`memset()` and the callback is called before returning.
+ *
+ * Only one DMA transfer can be in flight at a time.
+ */
+
+/**
+ * Called when a transfer has finished.
+ *
+ * For DMA transfers this runs in interrupt context.
+ *
+ * @param result OK_STATUS, or an error if the DMA reported one.
+ * @param ctx The context pointer given when the transfer was started.
+ */
+typedef void (*dma_memcpy_callback_t)(status_t result, void *ctx);
+
+/**
+ * Initializes the DMA and registers its interrupts with the OTTF.
+ *
+ * The DMA enabled memory range must have been configured beforehand (it may
+ * be locked); transfers outside it always use the CPU.
+ *
+ * @param dt The DMA instance to use.
+ * @param threshold Transfers of fewer bytes than this always use the CPU.
+ * @param irq_priority The PLIC priority of the DMA interrupts.
+ * @return The result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+status_t dma_memcpy_init(dt_dma_t dt, size_t threshold, uint32_t irq_priority);
+
+/**
+ * Copies `len` bytes from `src` to `dest`, which must not overlap.
+ *
+ * @param dest The destination buffer.
+ * @param src The source buffer.
+ * @param len The number of bytes to copy.
+ * @param callback Called when the copy is done. May be NULL.
+ * @param ctx Passed to `callback`.
+ * @return UNAVAILABLE if the copy needs the DMA and it is busy, otherwise OK.
+ */
+OT_WARN_UNUSED_RESULT
+status_t dma_memcpy_async(void *dest, const void *src, size_t len,
+                          dma_memcpy_callback_t callback, void *ctx);
+
+/**
+ * Fills `len` bytes at `dest` with `value`.
+ *
+ * @param dest The destination buffer.
+ * @param value The byte to fill with.
+ * @param len The number of bytes to fill.
+ * @param callback Called when the fill is done. May be NULL.
+ * @param ctx Passed to `callback`.
+ * @return UNAVAILABLE if the fill needs the DMA and it is busy, otherwise OK.
+ */
+OT_WARN_UNUSED_RESULT
+status_t dma_memset_async(void *dest, uint8_t value, size_t len,
+                          dma_memcpy_callback_t callback, void *ctx);
+
+/**
+ * Returns whether a DMA transfer is in flight.
+ */
+bool dma_memcpy_busy(void);
+
+#endif  // OPENTITAN_SW_DEVICE_LIB_TESTING_DMA_MEMCPY_H_
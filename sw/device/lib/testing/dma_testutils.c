@@ -87,3 +87,44 @@ void setup_spi_dma_transaction(dif_spi_host_t *spi_host, dif_dma_t *dma,
   CHECK_DIF_OK(dif_dma_configure(dma, transaction));
   CHECK_DIF_OK(dif_dma_handshake_enable(dma));
 }
+
+static void dma_copy_blocking(dif_dma_t *dma,
+                              dif_dma_transaction_address_t source,
+                              dif_dma_transaction_address_t destination,
+                              uint32_t nr_dwords) {
+  dif_dma_transaction_t transaction = {
+      .source = source,
+      .destination = destination,
+      .src_config = {.wrap = false, .increment = true},
+      .dst_config = {.wrap = false, .increment = true},
+      .total_size = nr_dwords * sizeof(uint32_t),
+      .chunk_size = nr_dwords * sizeof(uint32_t),
+      .width = kDifDmaTransWidth4Bytes};
+
+  CHECK_DIF_OK(dif_dma_configure(dma, transaction));
+  CHECK_DIF_OK(dif_dma_start(dma, kDifDmaCopyOpcode));
+  CHECK_DIF_OK(dif_dma_status_poll(dma, kDifDmaStatusDone));
+}
+
+void dma_mbx_request_copy(dif_dma_t *dma, const dif_mbx_transaction_t *request,
+                          uint32_t offset_dwords, uint32_t nr_dwords,
+                          dif_dma_transaction_address_t destination) {
+  CHECK(offset_dwords <= request->nr_dwords &&
+        nr_dwords <= request->nr_dwords - offset_dwords);
+  dif_dma_transaction_address_t source = {
+      .address = (uint32_t)&request->data_dwords[offset_dwords],
+      .asid = kDifDmaOpentitanInternalBus};
+  dma_copy_blocking(dma, source, destination, nr_dwords);
+}
+
+void dma_mbx_response_copy(dif_dma_t *dma,
+                           const dif_mbx_transaction_t *response,
+                           uint32_t offset_dwords, uint32_t nr_dwords,
+                           dif_dma_transaction_address_t source) {
+  CHECK(offset_dwords <= response->nr_dwords &&
+        nr_dwords <= response->nr_dwords - offset_dwords);
+  dif_dma_transaction_address_t destination = {
+      .address = (uint32_t)&response->data_dwords[offset_dwords],
+      .asid = kDifDmaOpentitanInternalBus};
+  dma_copy_blocking(dma, source, destination, nr_dwords);
+}
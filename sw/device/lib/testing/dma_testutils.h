@@ -6,6 +6,7 @@
 #define OPENTITAN_SW_DEVICE_LIB_TESTING_DMA_TESTUTILS_H_
 
 #include "sw/device/lib/dif/dif_dma.h"
+#include "sw/device/lib/dif/dif_mbx.h"
 #include "sw/device/lib/dif/dif_pinmux.h"
 #include "sw/device/lib/dif/dif_spi_host.h"
 #include "sw/device/lib/testing/test_framework/check.h"
@@ -55,4 +56,33 @@ void setup_spi_dma_transaction(dif_spi_host_t *spi_host, dif_dma_t *dma,
  */
 uint32_t get_digest_length(dif_dma_transaction_opcode_t opcode);
 
+/**
+ * Use the DMA to copy part of a DoE Mailbox request, in place in the inbound
+ * SRAM region, to another address. Blocks until the copy is done.
+ *
+ *  @param dma A DMA DIF handle.
+ *  @param request A request view from `dif_mbx_request_view()`.
+ *  @param offset_dwords Where in the request to start copying.
+ *  @param nr_dwords The number of dwords to copy.
+ *  @param destination Where to copy to.
+ */
+void dma_mbx_request_copy(dif_dma_t *dma, const dif_mbx_transaction_t *request,
+                          uint32_t offset_dwords, uint32_t nr_dwords,
+                          dif_dma_transaction_address_t destination);
+
+/**
+ * Use the DMA to copy data into a DoE Mailbox response being built in place
+ * in the outbound SRAM region. Blocks until the copy is done.
+ *
+ *  @param dma A DMA DIF handle.
+ *  @param response A response view from `dif_mbx_response_view()`.
+ *  @param offset_dwords Where in the response to start writing.
+ *  @param nr_dwords The number of dwords to copy.
+ *  @param source Where to copy from.
+ */
+void dma_mbx_response_copy(dif_dma_t *dma,
+                           const dif_mbx_transaction_t *response,
+                           uint32_t offset_dwords, uint32_t nr_dwords,
+                           dif_dma_transaction_address_t source);
+
 #endif  // OPENTITAN_SW_DEVICE_LIB_TESTING_DMA_TESTUTILS_H_
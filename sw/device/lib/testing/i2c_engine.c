@@ -0,0 +1,377 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "sw/device/lib/testing/i2c_engine.h"
+
+#include <stdatomic.h>
+
+#include "sw/device/lib/base/bitfield.h"
+#include "sw/device/lib/base/mmio.h"
+#include "sw/device/lib/runtime/irq.h"
+
+#include "i2c_regs.h"  // Generated.
+
+enum {
+  kI2cWrite = 0,
+  kI2cRead = 1,
+  // The engine is woken up with half of each FIFO still to go, which leaves
+  // it plenty of slack at any bus speed.
+  kFmtThreshold = I2C_PARAM_FIFO_DEPTH / 2,
+  kRxThreshold = I2C_PARAM_FIFO_DEPTH / 2,
+  kTxThreshold = I2C_PARAM_FIFO_DEPTH / 2,
+  kAcqThreshold = I2C_PARAM_ACQ_FIFO_DEPTH / 2,
+  // A read command requests at most 256 bytes, encoded as 0.
+  kMaxReadChunk = 256,
+};
+
+status_t i2c_engine_ring_init(i2c_engine_ring_t *ring, uint8_t *buf,
+                              size_t size) {
+  if (ring == NULL || buf == NULL || size == 0 || (size & (size - 1)) != 0) {
+    return INVALID_ARGUMENT();
+  }
+  *ring = (i2c_engine_ring_t){.buf = buf, .size = size};
+  return OK_STATUS();
+}
+
+/**
+ * Appends a byte to a ring buffer which is known not to be full.
+ */
+static void ring_push(i2c_engine_ring_t *ring, uint8_t byte) {
+  size_t tail = ring->tail;
+  ring->buf[tail & (ring->size - 1)] = byte;
+  // Publish the byte before the index which makes it visible to the consumer.
+  atomic_signal_fence(memory_order_release);
+  ring->tail = tail + 1;
+}
+
+/**
+ * Removes a byte from a ring buffer which is known not to be empty.
+ */
+static uint8_t ring_pop(i2c_engine_ring_t *ring) {
+  size_t head = ring->head;
+  atomic_signal_fence(memory_order_acquire);
+  uint8_t byte = ring->buf[head & (ring->size - 1)];
+  atomic_signal_fence(memory_order_release);
+  ring->head = head + 1;
+  return byte;
+}
+
+static void fmt_write(const dif_i2c_t *i2c, uint8_t byte, uint32_t flags) {
+  mmio_region_write32(
+      i2c->base_addr, I2C_FDATA_REG_OFFSET,
+      bitfield_field32_write(flags, I2C_FDATA_FBYTE_FIELD, byte));
+}
+
+/**
+ * Returns whether all the FMT entries of the host transfer have been queued.
+ */
+static bool host_queued(const i2c_engine_t *engine) {
+  if (!engine->addr_queued) {
+    return false;
+  }
+  if (engine->rx_buf != NULL) {
+    return engine->rx_requested == engine->rx_len;
+  }
+  return engine->tx_queued == engine->tx_len;
+}
+
+/**
+ * Writes up to `free` entries of the host transfer to the FMT FIFO.
+ */
+static void fmt_fill(i2c_engine_t *engine, uint32_t free) {
+  const dif_i2c_t *i2c = engine->i2c;
+  if (!engine->addr_queued && free > 0) {
+    uint8_t rw = engine->rx_buf != NULL ? kI2cRead : kI2cWrite;
+    fmt_write(i2c, (uint8_t)(engine->addr << 1) | rw,
+              bitfield_bit32_write(0, I2C_FDATA_START_BIT, true));
+    engine->addr_queued = true;
+    --free;
+  }
+  if (engine->rx_buf == NULL) {
+    while (free > 0 && engine->tx_queued < engine->tx_len) {
+      bool last = engine->tx_queued == engine->tx_len - 1;
+      fmt_write(i2c, engine->tx_buf[engine->tx_queued],
+                bitfield_bit32_write(0, I2C_FDATA_STOP_BIT, last));
+      ++engine->tx_queued;
+      --free;
+    }
+    return;
+  }
+  while (free > 0 && engine->rx_requested < engine->rx_len) {
+    size_t chunk = engine->rx_len - engine->rx_requested;
+    if (chunk > kMaxReadChunk) {
+      chunk = kMaxReadChunk;
+    }
+    engine->rx_requested += chunk;
+    // ACK the last byte of every chunk but the last, so that the target keeps
+    // sending, and end the transfer after the last one.
+    bool last = engine->rx_requested == engine->rx_len;
+    uint32_t flags = bitfield_bit32_write(0, I2C_FDATA_READB_BIT, true);
+    flags = bitfield_bit32_write(flags, I2C_FDATA_RCONT_BIT, !last);
+    flags = bitfield_bit32_write(flags, I2C_FDATA_STOP_BIT, last);
+    fmt_write(i2c, (uint8_t)chunk, flags);
+    --free;
+  }
+}
+
+/**
+ * Reads up to `level` bytes from the RX FIFO into the host read buffer.
+ */
+static status_t rx_drain(i2c_engine_t *engine, uint32_t level) {
+  while (level > 0 && engine->rx_received < engine->rx_len) {
+    TRY(dif_i2c_read_byte(engine->i2c,
+                          &engine->rx_buf[engine->rx_received]));
+    ++engine->rx_received;
+    --level;
+  }
+  return OK_STATUS();
+}
+
+/**
+ * Moves up to `level` ACQ FIFO entries into the target RX ring buffer, keeping
+ * only the data bytes.
+ */
+static status_t acq_drain(i2c_engine_t *engine, uint32_t level) {
+  i2c_engine_ring_t *ring = engine->target_rx;
+  // An entry cannot be peeked at, so stop while the ring buffer is full even
+  // if the next entry is not a data byte.
+  while (level > 0 && i2c_engine_ring_level(ring) < ring->size) {
+    uint8_t byte;
+    dif_i2c_signal_t signal;
+    TRY(dif_i2c_acquire_byte(engine->i2c, &byte, &signal));
+    --level;
+    switch (signal) {
+      case kDifI2cSignalNone:
+        ring_push(ring, byte);
+        break;
+      case kDifI2cSignalStop:
+      case kDifI2cSignalNackStop:
+        engine->target_stops = engine->target_stops + 1;
+        break;
+      default:
+        // The address of a new transaction, or a NACKed byte.
+        break;
+    }
+  }
+  return OK_STATUS();
+}
+
+/**
+ * Writes up to `free` bytes from the target TX ring buffer to the TX FIFO.
+ */
+static status_t tx_fill(i2c_engine_t *engine, uint32_t free) {
+  i2c_engine_ring_t *ring = engine->target_tx;
+  while (free > 0 && i2c_engine_ring_level(ring) > 0) {
+    TRY(dif_i2c_transmit_byte(engine->i2c, ring_pop(ring)));
+    --free;
+  }
+  return OK_STATUS();
+}
+
+/**
+ * Ends the host transfer in progress and calls its completion callback.
+ */
+static void host_finish(i2c_engine_t *engine, status_t result) {
+  engine->host_busy = false;
+  if (engine->done != NULL) {
+    engine->done(result, engine->done_ctx);
+  }
+}
+
+/**
+ * Recovers from a halt of the controller and fails the host transfer.
+ */
+static status_t host_halted(i2c_engine_t *engine) {
+  const dif_i2c_t *i2c = engine->i2c;
+  dif_i2c_controller_halt_events_t events;
+  TRY(dif_i2c_get_controller_halt_events(i2c, &events));
+  TRY(dif_i2c_reset_fmt_fifo(i2c));
+  TRY(dif_i2c_reset_rx_fifo(i2c));
+  TRY(dif_i2c_clear_controller_halt_events(i2c, events));
+  // Toggling the host enable makes the controller issue a STOP.
+  TRY(dif_i2c_host_set_enabled(i2c, kDifToggleDisabled));
+  TRY(dif_i2c_host_set_enabled(i2c, kDifToggleEnabled));
+  if (engine->host_busy) {
+    host_finish(engine, events.nack_received ? UNAVAILABLE() : ABORTED());
+  }
+  return OK_STATUS();
+}
+
+/**
+ * Services the engine with interrupts masked, for calls from thread context.
+ */
+static status_t service_locked(i2c_engine_t *engine) {
+  irq_global_ctrl(false);
+  status_t result = i2c_engine_service(engine);
+  irq_global_ctrl(true);
+  return result;
+}
+
+status_t i2c_engine_init(i2c_engine_t *engine, const dif_i2c_t *i2c) {
+  if (engine == NULL || i2c == NULL) {
+    return INVALID_ARGUMENT();
+  }
+  *engine = (i2c_engine_t){.i2c = i2c};
+  TRY(dif_i2c_set_host_watermarks(i2c, kRxThreshold, kFmtThreshold));
+  TRY(dif_i2c_set_target_watermarks(i2c, kTxThreshold, kAcqThreshold));
+  return i2c_engine_service(engine);
+}
+
+/**
+ * Starts a host transfer whose buffers have been set up by the caller.
+ */
+static status_t host_start(i2c_engine_t *engine, uint8_t addr,
+                           i2c_engine_done_t done, void *ctx) {
+  engine->addr = addr;
+  engine->tx_queued = 0;
+  engine->rx_requested = 0;
+  engine->rx_received = 0;
+  engine->addr_queued = false;
+  engine->done = done;
+  engine->done_ctx = ctx;
+  // Drop a stale `cmd_complete`, which would otherwise end the transfer early.
+  TRY(dif_i2c_irq_acknowledge(engine->i2c, kDifI2cIrqCmdComplete));
+  engine->host_busy = true;
+  return service_locked(engine);
+}
+
+status_t i2c_engine_host_write(i2c_engine_t *engine, uint8_t addr,
+                               const uint8_t *data, size_t length,
+                               i2c_engine_done_t done, void *ctx) {
+  if (engine == NULL || data == NULL || length == 0 || addr > 0x7f) {
+    return INVALID_ARGUMENT();
+  }
+  if (engine->host_busy) {
+    return FAILED_PRECONDITION();
+  }
+  engine->tx_buf = data;
+  engine->tx_len = length;
+  engine->rx_buf = NULL;
+  engine->rx_len = 0;
+  return host_start(engine, addr, done, ctx);
+}
+
+status_t i2c_engine_host_read(i2c_engine_t *engine, uint8_t addr, uint8_t *data,
+                              size_t length, i2c_engine_done_t done,
+                              void *ctx) {
+  if (engine == NULL || data == NULL || length == 0 || addr > 0x7f) {
+    return INVALID_ARGUMENT();
+  }
+  if (engine->host_busy) {
+    return FAILED_PRECONDITION();
+  }
+  engine->tx_buf = NULL;
+  engine->tx_len = 0;
+  engine->rx_buf = data;
+  engine->rx_len = length;
+  return host_start(engine, addr, done, ctx);
+}
+
+status_t i2c_engine_target_start(i2c_engine_t *engine, i2c_engine_ring_t *rx,
+                                 i2c_engine_ring_t *tx) {
+  if (engine == NULL) {
+    return INVALID_ARGUMENT();
+  }
+  engine->target_rx = rx;
+  engine->target_tx = tx;
+  engine->target_stops = 0;
+  return service_locked(engine);
+}
+
+status_t i2c_engine_target_write(i2c_engine_t *engine, const uint8_t *data,
+                                 size_t length) {
+  if (engine == NULL || data == NULL || engine->target_tx == NULL) {
+    return INVALID_ARGUMENT();
+  }
+  i2c_engine_ring_t *ring = engine->target_tx;
+  size_t count = 0;
+  while (count < length && i2c_engine_ring_level(ring) < ring->size) {
+    ring_push(ring, data[count++]);
+  }
+  TRY(service_locked(engine));
+  return OK_STATUS((int32_t)count);
+}
+
+status_t i2c_engine_target_read(i2c_engine_t *engine, uint8_t *data,
+                                size_t length) {
+  if (engine == NULL || data == NULL || engine->target_rx == NULL) {
+    return INVALID_ARGUMENT();
+  }
+  i2c_engine_ring_t *ring = engine->target_rx;
+  size_t count = 0;
+  while (count < length && i2c_engine_ring_level(ring) > 0) {
+    data[count++] = ring_pop(ring);
+  }
+  // Room was made in the ring buffer, so resume draining the ACQ FIFO.
+  TRY(service_locked(engine));
+  return OK_STATUS((int32_t)count);
+}
+
+status_t i2c_engine_service(i2c_engine_t *engine) {
+  const dif_i2c_t *i2c = engine->i2c;
+
+  // `cmd_complete` is an event: acknowledge it before looking at the FIFOs,
+  // so that a STOP after this point raises it again.
+  bool stopped;
+  TRY(dif_i2c_irq_is_pending(i2c, kDifI2cIrqCmdComplete, &stopped));
+  if (stopped) {
+    TRY(dif_i2c_irq_acknowledge(i2c, kDifI2cIrqCmdComplete));
+  }
+  bool halted;
+  TRY(dif_i2c_irq_is_pending(i2c, kDifI2cIrqControllerHalt, &halted));
+  if (halted) {
+    TRY(host_halted(engine));
+  }
+
+  dif_i2c_level_t fmt_level, rx_level, tx_level, acq_level;
+  TRY(dif_i2c_get_fifo_levels(i2c, &fmt_level, &rx_level, &tx_level,
+                              &acq_level));
+  if (engine->host_busy) {
+    if (engine->rx_buf != NULL) {
+      TRY(rx_drain(engine, rx_level));
+    }
+    fmt_fill(engine, I2C_PARAM_FIFO_DEPTH - fmt_level);
+  }
+  if (engine->target_rx != NULL) {
+    TRY(acq_drain(engine, acq_level));
+  }
+  if (engine->target_tx != NULL) {
+    TRY(tx_fill(engine, I2C_PARAM_FIFO_DEPTH - tx_level));
+  }
+
+  // The engine only ever issues a single STOP per transfer, at its end, and
+  // the RX FIFO was drained above, after that STOP.
+  if (engine->host_busy && stopped && host_queued(engine) &&
+      engine->rx_received == engine->rx_len) {
+    host_finish(engine, OK_STATUS());
+  }
+
+  // Wait only for the conditions which would let the engine make progress.
+  // The threshold interrupts are level-sensitive, so a condition which became
+  // true since the FIFO levels were read fires as soon as it is enabled.
+  bool host = engine->host_busy;
+  bool target_rx = engine->target_rx != NULL;
+  dif_i2c_irq_enable_snapshot_t enables;
+  TRY(dif_i2c_irq_disable_all(i2c, &enables));
+  enables = bitfield_bit32_write(enables, kDifI2cIrqFmtThreshold,
+                                 host && !host_queued(engine));
+  enables = bitfield_bit32_write(
+      enables, kDifI2cIrqRxThreshold,
+      host && engine->rx_received < engine->rx_len);
+  enables = bitfield_bit32_write(enables, kDifI2cIrqControllerHalt, host);
+  // A STOP ends the host transfer, and flushes the tail of a target transfer
+  // which is below the ACQ threshold.
+  enables = bitfield_bit32_write(enables, kDifI2cIrqCmdComplete,
+                                 host || target_rx);
+  enables = bitfield_bit32_write(
+      enables, kDifI2cIrqAcqThreshold,
+      target_rx && i2c_engine_ring_level(engine->target_rx) <
+                       engine->target_rx->size);
+  enables = bitfield_bit32_write(
+      enables, kDifI2cIrqTxThreshold,
+      engine->target_tx != NULL &&
+          i2c_engine_ring_level(engine->target_tx) > 0);
+  TRY(dif_i2c_irq_restore_all(i2c, &enables));
+  return OK_STATUS();
+}
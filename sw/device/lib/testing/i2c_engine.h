@@ -0,0 +1,251 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef OPENTITAN_SW_DEVICE_LIB_TESTING_I2C_ENGINE_H_
+#define OPENTITAN_SW_DEVICE_LIB_TESTING_I2C_ENGINE_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "sw/device/lib/base/status.h"
+#include "sw/device/lib/dif/dif_i2c.h"
+
+/**
+ * Interrupt-driven I2C transfer engine.
+ *
+ * The `i2c_testutils` helpers move one byte at a time and poll the FIFO
+ * levels in between, which cannot keep up with a sustained stream at Fast-mode
+ * Plus. The engine instead moves data from the I2C interrupts:
+ *
+ * - As a host, it programs the FMT FIFO in batches (as many entries as it has
+ *   room for, without re-reading the status in between) whenever its level
+ *   drops below the `fmt_threshold`, drains the RX FIFO whenever its level
+ *   rises above the `rx_threshold`, and calls a completion callback once the
+ *   transfer's STOP has been issued.
+ * - As a target, it streams the bytes written by the external host from the
+ *   ACQ FIFO into a software ring buffer, and the bytes read by the external
+ *   host from another ring buffer into the TX FIFO. When a ring buffer is full
+ *   (or empty), the hardware stretches the clock until software catches up.
+ *
+ * The engine only enables the interrupts it is waiting for, so the
+ * level-sensitive threshold interrupts do not fire while there is nothing to
+ * do. The caller is responsible for routing the I2C interrupts through the
+ * PLIC and calling `i2c_engine_service()` from their ISR.
+ */
+
+/**
+ * A ring buffer of bytes, shared between the engine's ISR and the code it
+ * interrupts. `head` and `tail` are free-running byte counters.
+ */
+typedef struct i2c_engine_ring {
+  /**
+   * Storage for `size` bytes; `size` must be a power of two.
+   */
+  uint8_t *buf;
+  size_t size;
+  volatile size_t head;
+  volatile size_t tail;
+} i2c_engine_ring_t;
+
+/**
+ * Called once a host transfer completes.
+ *
+ * @param result The result of the transfer: OK, `kUnavailable` if the target
+ * NACKed, or `kAborted` if the transfer was halted for any other reason.
+ * @param ctx The context passed when starting the transfer.
+ */
+typedef void (*i2c_engine_done_t)(status_t result, void *ctx);
+
+typedef struct i2c_engine {
+  /**
+   * The I2C handle.
+   */
+  const dif_i2c_t *i2c;
+  /**
+   * The 7-bit address of the target of the host transfer in progress.
+   */
+  uint8_t addr;
+  /**
+   * The data of a host write, and the number of bytes of it already written to
+   * the FMT FIFO.
+   */
+  const uint8_t *tx_buf;
+  size_t tx_len;
+  size_t tx_queued;
+  /**
+   * The buffer of a host read, the number of bytes of it requested through
+   * the FMT FIFO, and the number of bytes received.
+   */
+  uint8_t *rx_buf;
+  size_t rx_len;
+  size_t rx_requested;
+  size_t rx_received;
+  /**
+   * Whether the START and address of the host transfer have been queued.
+   */
+  bool addr_queued;
+  /**
+   * Completion callback and its context.
+   */
+  i2c_engine_done_t done;
+  void *done_ctx;
+  /**
+   * Whether a host transfer is in progress.
+   */
+  volatile bool host_busy;
+  /**
+   * Target ring buffers, or NULL if the target side is not streamed by the
+   * engine. `target_rx` receives the data bytes written by the external host;
+   * `target_tx` holds the bytes to return to it on reads.
+   */
+  i2c_engine_ring_t *target_rx;
+  i2c_engine_ring_t *target_tx;
+  /**
+   * The number of target transactions which have ended (with a STOP).
+   */
+  volatile uint32_t target_stops;
+} i2c_engine_t;
+
+/**
+ * Initializes a ring buffer.
+ *
+ * @param ring The ring buffer.
+ * @param buf Storage for the bytes.
+ * @param size The size of `buf`, a power of two.
+ * @return The result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+status_t i2c_engine_ring_init(i2c_engine_ring_t *ring, uint8_t *buf,
+                              size_t size);
+
+/**
+ * Returns the number of bytes in a ring buffer.
+ *
+ * @param ring The ring buffer.
+ * @return The number of bytes in the ring buffer.
+ */
+static inline size_t i2c_engine_ring_level(const i2c_engine_ring_t *ring) {
+  return ring->tail - ring->head;
+}
+
+/**
+ * Initializes the engine.
+ *
+ * The I2C block should already be configured and enabled as a host and/or
+ * target. This sets the FIFO thresholds the engine relies on and disables the
+ * interrupts it manages.
+ *
+ * @param engine The engine to initialize.
+ * @param i2c An I2C handle.
+ * @return The result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+status_t i2c_engine_init(i2c_engine_t *engine, const dif_i2c_t *i2c);
+
+/**
+ * Starts a host write of `length` bytes to the target at `addr`, followed by a
+ * STOP.
+ *
+ * The buffer must remain valid until the transfer completes.
+ *
+ * @param engine The engine.
+ * @param addr The 7-bit address of the target.
+ * @param data The bytes to write.
+ * @param length The number of bytes to write.
+ * @param done Called (from the ISR) once the transfer completes; may be NULL.
+ * @param ctx Passed to `done`.
+ * @return The result of the operation; `kFailedPrecondition` if a host
+ * transfer is already in progress.
+ */
+OT_WARN_UNUSED_RESULT
+status_t i2c_engine_host_write(i2c_engine_t *engine, uint8_t addr,
+                               const uint8_t *data, size_t length,
+                               i2c_engine_done_t done, void *ctx);
+
+/**
+ * Starts a host read of `length` bytes from the target at `addr`, followed by
+ * a STOP.
+ *
+ * Reads longer than 256 bytes are issued as consecutive read commands which
+ * ACK their last byte, so that the target sees a single transfer.
+ *
+ * @param engine The engine.
+ * @param addr The 7-bit address of the target.
+ * @param[out] data The buffer to receive the bytes.
+ * @param length The number of bytes to read.
+ * @param done Called (from the ISR) once the transfer completes; may be NULL.
+ * @param ctx Passed to `done`.
+ * @return The result of the operation; `kFailedPrecondition` if a host
+ * transfer is already in progress.
+ */
+OT_WARN_UNUSED_RESULT
+status_t i2c_engine_host_read(i2c_engine_t *engine, uint8_t addr, uint8_t *data,
+                              size_t length, i2c_engine_done_t done, void *ctx);
+
+/**
+ * Returns whether a host transfer is in progress.
+ *
+ * @param engine The engine.
+ * @return Whether a host transfer is in progress.
+ */
+static inline bool i2c_engine_host_is_busy(const i2c_engine_t *engine) {
+  return engine->host_busy;
+}
+
+/**
+ * Starts streaming the target side of the I2C block through ring buffers.
+ *
+ * @param engine The engine.
+ * @param rx Receives the data bytes written by the external host; may be NULL.
+ * @param tx Holds the bytes returned to the external host on reads; may be
+ * NULL.
+ * @return The result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+status_t i2c_engine_target_start(i2c_engine_t *engine, i2c_engine_ring_t *rx,
+                                 i2c_engine_ring_t *tx);
+
+/**
+ * Queues bytes to be returned to the external host on reads.
+ *
+ * Must not be called from the engine's ISR.
+ *
+ * @param engine The engine.
+ * @param data The bytes to queue.
+ * @param length The number of bytes to queue.
+ * @return The number of bytes queued, which is less than `length` if the ring
+ * buffer is full.
+ */
+OT_WARN_UNUSED_RESULT
+status_t i2c_engine_target_write(i2c_engine_t *engine, const uint8_t *data,
+                                 size_t length);
+
+/**
+ * Takes bytes written by the external host.
+ *
+ * Must not be called from the engine's ISR.
+ *
+ * @param engine The engine.
+ * @param[out] data The buffer to receive the bytes.
+ * @param length The size of `data`.
+ * @return The number of bytes taken, which is less than `length` if fewer
+ * bytes have been received.
+ */
+OT_WARN_UNUSED_RESULT
+status_t i2c_engine_target_read(i2c_engine_t *engine, uint8_t *data,
+                                size_t length);
+
+/**
+ * Moves the data of the transfers in progress.
+ *
+ * Should be called from the ISR of any of the I2C interrupts.
+ *
+ * @param engine The engine.
+ * @return The result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+status_t i2c_engine_service(i2c_engine_t *engine);
+
+#endif  // OPENTITAN_SW_DEVICE_LIB_TESTING_I2C_ENGINE_H_
@@ -395,7 +395,7 @@ status_t i2c_testutils_set_speed(const dif_i2c_t *i2c, dif_i2c_speed_t speed) {
   dif_i2c_timing_config_t timing_config = {
       .lowest_target_device_speed = speed,
       .clock_period_nanos =
-          (uint32_t)udiv64_slow(1000000000, kClockFreqPeripheralHz, NULL),
+          (uint32_t)udiv64(1000000000, kClockFreqPeripheralHz, NULL),
       .sda_rise_nanos = 400,
       .sda_fall_nanos = 110,
       .scl_period_nanos = 1000000 / speed_khz};
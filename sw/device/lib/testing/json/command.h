@@ -24,8 +24,10 @@ extern "C" {
     value(_, I2cTestConfig) \
     value(_, MemRead) \
     value(_, MemRead32) \
+    value(_, MemReadRange) \
     value(_, MemWrite) \
     value(_, MemWrite32) \
+    value(_, MemWriteRange) \
     value(_, PinmuxConfig) \
     value(_, SpiConfigureJedecId) \
     value(_, SpiReadStatus) \
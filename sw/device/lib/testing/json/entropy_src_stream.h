@@ -0,0 +1,43 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+#ifndef OPENTITAN_SW_DEVICE_LIB_TESTING_JSON_ENTROPY_SRC_STREAM_H_
+#define OPENTITAN_SW_DEVICE_LIB_TESTING_JSON_ENTROPY_SRC_STREAM_H_
+
+#include "sw/device/lib/ujson/ujson_derive.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+// clang-format off
+
+#define MODULE_ID MAKE_MODULE_ID('j', 'e', 's')
+
+// Configuration of a raw entropy stream, sent by the host before streaming.
+// `single_bit_mode` takes the values of `dif_entropy_src_single_bit_mode_t`.
+// With `quality_checks` set, the device runs the monobit test on each block
+// of streamed samples.
+#define STRUCT_ENTROPY_SRC_STREAM_CONFIG(field, string) \
+    field(single_bit_mode, uint32_t) \
+    field(frames, uint32_t) \
+    field(quality_checks, bool)
+UJSON_SERDE_STRUCT(EntropySrcStreamConfig, entropy_src_stream_config_t, STRUCT_ENTROPY_SRC_STREAM_CONFIG);
+
+// Summary of a raw entropy stream, sent by the device once all frames have
+// been sent. Frames that were dropped due to observe FIFO overflows or
+// post-health-test drops are not counted in `frames_sent`; their sequence
+// numbers are skipped.
+#define STRUCT_ENTROPY_SRC_STREAM_SUMMARY(field, string) \
+    field(frames_sent, uint32_t) \
+    field(frames_dropped, uint32_t) \
+    field(blocks_checked, uint32_t) \
+    field(blocks_failed, uint32_t) \
+    field(elapsed_us, uint64_t)
+UJSON_SERDE_STRUCT(EntropySrcStreamSummary, entropy_src_stream_summary_t, STRUCT_ENTROPY_SRC_STREAM_SUMMARY);
+
+#undef MODULE_ID
+
+// clang-format on
+#ifdef __cplusplus
+}
+#endif
+#endif  // OPENTITAN_SW_DEVICE_LIB_TESTING_JSON_ENTROPY_SRC_STREAM_H_
@@ -10,6 +10,127 @@
 
 #define MODULE_ID MAKE_MODULE_ID('j', 's', 'm')
 
+enum {
+  /**
+   * Bytes of memory hex-encoded per write to the console in a range read.
+   */
+  kMemHexEncodeBytes = 32,
+};
+
+static const char kHexDigits[] = "0123456789abcdef";
+
+/**
+ * A chunk of a range read, to be sent as a `MemHexChunk`.
+ */
+typedef struct mem_read_chunk {
+  uintptr_t address;
+  size_t len;
+} mem_read_chunk_t;
+
+/**
+ * A chunk of a range write, as parsed from a `MemHexChunk`.
+ */
+typedef struct mem_write_chunk {
+  uint32_t address;
+  size_t len;
+  uint8_t data[kMemRangeChunkBytes];
+} mem_write_chunk_t;
+
+/**
+ * Serializes a chunk of memory as a `MemHexChunk`.
+ *
+ * The memory is read and hex-encoded a few bytes at a time, straight into the
+ * console output.
+ */
+static status_t mem_read_chunk_serialize(ujson_t *uj,
+                                         const mem_read_chunk_t *chunk) {
+  static const char kAddressKey[] = "{\"address\":";
+  static const char kDataKey[] = ",\"data\":\"";
+  uint32_t address = (uint32_t)chunk->address;
+  TRY(ujson_putbuf(uj, kAddressKey, sizeof(kAddressKey) - 1));
+  TRY(ujson_serialize_uint32_t(uj, &address));
+  TRY(ujson_putbuf(uj, kDataKey, sizeof(kDataKey) - 1));
+  for (size_t off = 0; off < chunk->len; off += kMemHexEncodeBytes) {
+    uint8_t bytes[kMemHexEncodeBytes];
+    char hex[2 * kMemHexEncodeBytes];
+    size_t n = chunk->len - off;
+    if (n > sizeof(bytes)) {
+      n = sizeof(bytes);
+    }
+    memcpy(bytes, (const void *)(chunk->address + off), n);
+    for (size_t i = 0; i < n; ++i) {
+      hex[2 * i] = kHexDigits[bytes[i] >> 4];
+      hex[2 * i + 1] = kHexDigits[bytes[i] & 0xf];
+    }
+    TRY(ujson_putbuf(uj, hex, 2 * n));
+  }
+  TRY(ujson_putbuf(uj, "\"}", 2));
+  return OK_STATUS();
+}
+
+/**
+ * Returns the value of a hex digit, or -1 if `ch` is not one.
+ */
+static int hex_digit_value(char ch) {
+  if (ch >= '0' && ch <= '9') {
+    return ch - '0';
+  }
+  ch |= 0x20;
+  if (ch >= 'a' && ch <= 'f') {
+    return ch - 'a' + 10;
+  }
+  return -1;
+}
+
+/**
+ * Parses a hex-encoded JSON string of at most `kMemRangeChunkBytes` bytes into
+ * `chunk->data`.
+ */
+static status_t mem_hex_string_deserialize(ujson_t *uj,
+                                           mem_write_chunk_t *chunk) {
+  TRY(ujson_consume(uj, '"'));
+  chunk->len = 0;
+  while (true) {
+    char ch = (char)TRY(ujson_getc(uj));
+    if (ch == '"') {
+      return OK_STATUS();
+    }
+    int hi = hex_digit_value(ch);
+    int lo = hex_digit_value((char)TRY(ujson_getc(uj)));
+    if (hi < 0 || lo < 0 || chunk->len == sizeof(chunk->data)) {
+      return INVALID_ARGUMENT();
+    }
+    chunk->data[chunk->len++] = (uint8_t)(hi << 4 | lo);
+  }
+}
+
+/**
+ * Deserializes a `MemHexChunk`, decoding the data as it is read.
+ */
+static status_t mem_write_chunk_deserialize(ujson_t *uj,
+                                            mem_write_chunk_t *chunk) {
+  size_t nfield = 0;
+  char key[16];
+  chunk->address = 0;
+  chunk->len = 0;
+  TRY(ujson_consume(uj, '{'));
+  while (TRY(ujson_consume_maybe(uj, '}')) == 0) {
+    if (nfield++ > 0) {
+      TRY(ujson_consume(uj, ','));
+    }
+    TRY(ujson_parse_qs(uj, key, sizeof(key)));
+    TRY(ujson_consume(uj, ':'));
+    if (ujson_streq(key, "address")) {
+      TRY(ujson_deserialize_uint32_t(uj, &chunk->address));
+    } else if (ujson_streq(key, "data")) {
+      TRY(mem_hex_string_deserialize(uj, chunk));
+    } else {
+      return INVALID_ARGUMENT();
+    }
+  }
+  return OK_STATUS();
+}
+
 status_t ujcmd_mem_read32(ujson_t *uj) {
   mem_read32_req_t op;
   mem_read32_resp_t resp;
@@ -52,3 +173,46 @@ status_t ujcmd_mem_write(ujson_t *uj) {
   memcpy((void *)op.address, op.data, op.data_len);
   return RESP_OK_STATUS(uj);
 }
+
+status_t ujcmd_mem_read_range(ujson_t *uj) {
+  mem_range_req_t op;
+  TRY(UJSON_WITH_CRC(ujson_deserialize_mem_range_req_t, uj, &op));
+  if (op.address + op.data_len < op.address) {
+    return INVALID_ARGUMENT();
+  }
+  mem_read_chunk_t chunk = {.address = op.address};
+  for (size_t done = 0; done < op.data_len; done += chunk.len) {
+    chunk.address = op.address + done;
+    chunk.len = op.data_len - done;
+    if (chunk.len > kMemRangeChunkBytes) {
+      chunk.len = kMemRangeChunkBytes;
+    }
+    RESP_OK(mem_read_chunk_serialize, uj, &chunk);
+  }
+  return OK_STATUS();
+}
+
+status_t ujcmd_mem_write_range(ujson_t *uj) {
+  mem_range_req_t op;
+  TRY(UJSON_WITH_CRC(ujson_deserialize_mem_range_req_t, uj, &op));
+  if (op.address + op.data_len < op.address) {
+    return INVALID_ARGUMENT();
+  }
+  for (size_t done = 0; done < op.data_len;) {
+    // Only the chunk being received is held in RAM. It is copied to its
+    // destination once its CRC has been checked.
+    mem_write_chunk_t chunk;
+    TRY(UJSON_WITH_CRC(mem_write_chunk_deserialize, uj, &chunk));
+    size_t expected_len = op.data_len - done;
+    if (expected_len > kMemRangeChunkBytes) {
+      expected_len = kMemRangeChunkBytes;
+    }
+    if (chunk.address != op.address + done || chunk.len != expected_len) {
+      return INVALID_ARGUMENT();
+    }
+    memcpy((void *)(uintptr_t)chunk.address, chunk.data, chunk.len);
+    done += chunk.len;
+    RESP_OK_STATUS(uj, (int32_t)done);
+  }
+  return OK_STATUS();
+}
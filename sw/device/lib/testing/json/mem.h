@@ -42,12 +42,44 @@ UJSON_SERDE_STRUCT(MemWrite32Req, mem_write32_req_t, STRUCT_MEM_WRITE32_REQ);
     field(data_len, uint16_t)
 UJSON_SERDE_STRUCT(MemWriteReq, mem_write_req_t, STRUCT_MEM_WRITE_REQ);
 
+// A range of memory for the `MemReadRange` and `MemWriteRange` commands.
+//
+// The data itself is sent after the request, as `MemHexChunk` messages of up
+// to `kMemRangeChunkBytes` bytes each, in address order. For a read, the
+// device sends each chunk as a `RESP_OK` message. For a write, the host sends
+// each chunk (with a CRC) and the device acknowledges it with a `RESP_OK`
+// status once the chunk has been written.
+#define STRUCT_MEM_RANGE_REQ(field, string) \
+    field(address, uint32_t) \
+    field(data_len, uint32_t)
+UJSON_SERDE_STRUCT(MemRangeReq, mem_range_req_t, STRUCT_MEM_RANGE_REQ);
+
+// One chunk of a range, with the bytes encoded as lowercase hex (two
+// characters per byte). The device parses and emits these directly rather
+// than through the derived functions, so that it never holds the encoded
+// string; the size here (2 * kMemRangeChunkBytes + 1) only matters to the host.
+#define STRUCT_MEM_HEX_CHUNK(field, string) \
+    field(address, uint32_t) \
+    string(data, 1025)
+UJSON_SERDE_STRUCT(MemHexChunk, mem_hex_chunk_t, STRUCT_MEM_HEX_CHUNK);
+
 #ifndef RUST_PREPROCESSOR_EMIT
 
+enum {
+  /**
+   * Largest number of bytes in a `MemHexChunk`.
+   *
+   * The encoded chunk, with its JSON framing, fits in one SPI console frame.
+   */
+  kMemRangeChunkBytes = 512,
+};
+
 status_t ujcmd_mem_read32(ujson_t *uj);
 status_t ujcmd_mem_read(ujson_t *uj);
+status_t ujcmd_mem_read_range(ujson_t *uj);
 status_t ujcmd_mem_write32(ujson_t *uj);
 status_t ujcmd_mem_write(ujson_t *uj);
+status_t ujcmd_mem_write_range(ujson_t *uj);
 
 #endif
 
@@ -0,0 +1,76 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#define UJSON_SERDE_IMPL 1
+#include "sw/device/lib/testing/json/profile.h"
+
+#include "sw/device/lib/base/memory.h"
+#include "sw/device/lib/testing/profile.h"
+#include "sw/device/lib/testing/test_framework/ujson_ottf.h"
+
+#define MODULE_ID MAKE_MODULE_ID('j', 'p', 'f')
+
+status_t ujson_profile_report(ujson_t *uj) {
+  // Each distinct zone is identified by its first record; the records of a
+  // zone are then aggregated when its summary is sent.
+  size_t count = profile_zone_count();
+  bool seen[PROFILE_ZONE_RECORDS] = {false};
+  profile_report_t report = {
+      .zones = 0,
+      .dropped = profile_zone_dropped(),
+  };
+  for (size_t i = 0; i < count; ++i) {
+    profile_zone_record_t first;
+    if (seen[i] || !profile_zone_get(i, &first)) {
+      continue;
+    }
+    ++report.zones;
+    for (size_t j = i; j < count; ++j) {
+      profile_zone_record_t record;
+      if (profile_zone_get(j, &record) && record.name == first.name &&
+          record.depth == first.depth) {
+        seen[j] = true;
+      }
+    }
+  }
+  TRY(RESP_OK(ujson_serialize_profile_report_t, uj, &report));
+
+  memset(seen, 0, sizeof(seen));
+  for (size_t i = 0; i < count; ++i) {
+    profile_zone_record_t first;
+    if (seen[i] || !profile_zone_get(i, &first)) {
+      continue;
+    }
+    profile_zone_summary_t summary = {
+        .depth = first.depth,
+        .min_cycles = UINT32_MAX,
+    };
+    size_t name_len = 0;
+    while (name_len < sizeof(summary.name) - 1 && first.name[name_len] != 0) {
+      summary.name[name_len] = first.name[name_len];
+      ++name_len;
+    }
+    for (size_t j = i; j < count; ++j) {
+      profile_zone_record_t record;
+      if (!profile_zone_get(j, &record) || record.name != first.name ||
+          record.depth != first.depth) {
+        continue;
+      }
+      seen[j] = true;
+      ++summary.calls;
+      summary.total_cycles += record.cycles;
+      if (record.cycles < summary.min_cycles) {
+        summary.min_cycles = record.cycles;
+      }
+      if (record.cycles > summary.max_cycles) {
+        summary.max_cycles = record.cycles;
+      }
+      summary.total_instret += record.instret;
+      summary.total_lsu_stall_cycles += record.lsu_stall_cycles;
+      summary.total_ifetch_stall_cycles += record.ifetch_stall_cycles;
+    }
+    TRY(RESP_OK(ujson_serialize_profile_zone_summary_t, uj, &summary));
+  }
+  return OK_STATUS();
+}
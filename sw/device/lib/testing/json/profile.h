@@ -0,0 +1,52 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef OPENTITAN_SW_DEVICE_LIB_TESTING_JSON_PROFILE_H_
+#define OPENTITAN_SW_DEVICE_LIB_TESTING_JSON_PROFILE_H_
+
+#include "sw/device/lib/ujson/ujson_derive.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+// clang-format off
+
+#define MODULE_ID MAKE_MODULE_ID('j', 'p', 'h')
+
+#define STRUCT_PROFILE_REPORT(field, string) \
+    field(zones, uint32_t) \
+    field(dropped, uint32_t)
+UJSON_SERDE_STRUCT(ProfileReport, profile_report_t, STRUCT_PROFILE_REPORT);
+
+#define STRUCT_PROFILE_ZONE_SUMMARY(field, string) \
+    string(name, 32) \
+    field(depth, uint32_t) \
+    field(calls, uint32_t) \
+    field(total_cycles, uint64_t) \
+    field(min_cycles, uint32_t) \
+    field(max_cycles, uint32_t) \
+    field(total_instret, uint64_t) \
+    field(total_lsu_stall_cycles, uint64_t) \
+    field(total_ifetch_stall_cycles, uint64_t)
+UJSON_SERDE_STRUCT(ProfileZoneSummary, profile_zone_summary_t, STRUCT_PROFILE_ZONE_SUMMARY);
+
+#ifndef RUST_PREPROCESSOR_EMIT
+/**
+ * Report the zones recorded with `profile_zone_begin()`/`profile_zone_end()`.
+ *
+ * The records are aggregated by name and depth. A `profile_report_t` is sent
+ * first, followed by one `profile_zone_summary_t` per aggregated zone.
+ *
+ * @param uj A ujson IO context.
+ * @return The result of the operation.
+ */
+status_t ujson_profile_report(ujson_t *uj);
+#endif
+
+#undef MODULE_ID
+
+// clang-format on
+#ifdef __cplusplus
+}
+#endif
+#endif  // OPENTITAN_SW_DEVICE_LIB_TESTING_JSON_PROFILE_H_
@@ -42,14 +42,29 @@ static uint64_t *const kNvCounters[] = {
     nv_counter_3,
 };
 
+/**
+ * RAM shadow of the counters.
+ *
+ * The counters only change through the functions in this file, so once a
+ * counter has been read from flash, its value is tracked here and later reads
+ * don't touch flash. The shadow starts out invalid after each reset.
+ */
+static uint32_t counter_cache[ARRAYSIZE(kNvCounters)];
+static bool counter_cache_valid[ARRAYSIZE(kNvCounters)];
+
 status_t flash_ctrl_testutils_counter_get(size_t counter, uint32_t *value) {
   TRY_CHECK(value != NULL);
   TRY_CHECK(counter < ARRAYSIZE(kNvCounters));
+  if (counter_cache_valid[counter]) {
+    *value = counter_cache[counter];
+    return OK_STATUS();
+  }
   TRY_CHECK((uint32_t)&_non_volatile_counter_flash_words ==
             kNonVolatileCounterFlashWords);
 
   // Use a reverse loop since `flash_ctrl_testutils_counter_set_at_least()` can
-  // introduce gaps.
+  // introduce gaps. Because of the gaps, every word above the last zero word
+  // has to be read anyway, so this can't be shortened with a binary search.
   size_t i = kNonVolatileCounterFlashWords - 1;
   for (; i < kNonVolatileCounterFlashWords; --i) {
     if (kNvCounters[counter][i] == 0) {
@@ -57,19 +72,21 @@ status_t flash_ctrl_testutils_counter_get(size_t counter, uint32_t *value) {
     }
   }
   *value = i + 1;
+  counter_cache[counter] = *value;
+  counter_cache_valid[counter] = true;
   return OK_STATUS();
 }
 
 status_t flash_ctrl_testutils_counter_increment(
     dif_flash_ctrl_state_t *flash_state, size_t counter) {
-  size_t i;
-  TRY(flash_ctrl_testutils_counter_get(counter, &i));
-  TRY_CHECK(i < kNonVolatileCounterFlashWords,
-            "Non-volatile counter %u is at its maximum", counter);
-  TRY(flash_ctrl_testutils_counter_set_at_least(flash_state, counter, i + 1));
   uint32_t value;
   TRY(flash_ctrl_testutils_counter_get(counter, &value));
-  TRY_CHECK(value == i + 1, "Counter increment failed");
+  TRY_CHECK(value < kNonVolatileCounterFlashWords,
+            "Non-volatile counter %u is at its maximum", counter);
+  TRY(flash_ctrl_testutils_counter_set_at_least(flash_state, counter,
+                                                value + 1));
+  // Only the programmed word needs to be checked.
+  TRY_CHECK(kNvCounters[counter][value] == 0, "Counter increment failed");
   return OK_STATUS();
 }
 
@@ -78,15 +95,25 @@ status_t flash_ctrl_testutils_counter_set_at_least(
   TRY_CHECK(val <= kNonVolatileCounterFlashWords,
             "Non-volatile counter %u new value %u > max value %u", counter, val,
             kNonVolatileCounterFlashWords);
+  TRY_CHECK(counter < ARRAYSIZE(kNvCounters));
   if (val == 0) {
     return OK_STATUS();
   }
   uint32_t new_val[FLASH_CTRL_PARAM_BYTES_PER_WORD / sizeof(uint32_t)] = {0, 0};
-  return flash_ctrl_testutils_write(flash_state,
-                                    (uint32_t)&kNvCounters[counter][val - 1] -
-                                        TOP_EARLGREY_FLASH_CTRL_MEM_BASE_ADDR,
-                                    0, new_val, kDifFlashCtrlPartitionTypeData,
-                                    ARRAYSIZE(new_val));
+  status_t result = flash_ctrl_testutils_write(
+      flash_state,
+      (uint32_t)&kNvCounters[counter][val - 1] -
+          TOP_EARLGREY_FLASH_CTRL_MEM_BASE_ADDR,
+      0, new_val, kDifFlashCtrlPartitionTypeData, ARRAYSIZE(new_val));
+  if (!status_ok(result)) {
+    // The word may or may not have been programmed.
+    counter_cache_valid[counter] = false;
+    return result;
+  }
+  if (counter_cache_valid[counter] && counter_cache[counter] < val) {
+    counter_cache[counter] = val;
+  }
+  return OK_STATUS();
 }
 
 // At the beginning of the simulation (Verilator, VCS,etc.),
@@ -97,8 +124,10 @@ status_t flash_ctrl_testutils_counter_set_at_least(
 // its flash region with non-zero values.
 status_t flash_ctrl_testutils_counter_init_zero(
     dif_flash_ctrl_state_t *flash_state, size_t counter) {
+  TRY_CHECK(counter < ARRAYSIZE(kNvCounters));
   uint32_t new_val[FLASH_CTRL_PARAM_BYTES_PER_WORD / sizeof(uint32_t)] = {0xaa,
                                                                           0xbb};
+  counter_cache_valid[counter] = false;
   for (int ii = 0; ii < kNonVolatileCounterFlashWords; ii++) {
     TRY(flash_ctrl_testutils_erase_and_write_page(
         flash_state,
@@ -106,5 +135,7 @@ status_t flash_ctrl_testutils_counter_init_zero(
             TOP_EARLGREY_FLASH_CTRL_MEM_BASE_ADDR,
         0, new_val, kDifFlashCtrlPartitionTypeData, ARRAYSIZE(new_val)));
   }
+  counter_cache[counter] = 0;
+  counter_cache_valid[counter] = true;
   return OK_STATUS();
 }
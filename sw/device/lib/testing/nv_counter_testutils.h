@@ -13,6 +13,10 @@
 /**
  * Returns the value of a non-volatile counter in flash.
  *
+ * Only the first call after a reset reads flash; the counter's value is then
+ * kept in RAM and updated by the functions below. Programming or erasing the
+ * counters by other means is not tracked.
+ *
  * @param counter Counter ID, [0, 2].
  * @param[out] Value of the non-volatile counter
  * @return The result of the operation.
@@ -115,6 +115,43 @@ status_t otp_ctrl_testutils_dai_read64_array(const dif_otp_ctrl_t *otp,
   return OK_STATUS();
 }
 
+status_t otp_ctrl_testutils_read_partition(const dif_otp_ctrl_t *otp,
+                                           dif_otp_ctrl_partition_t partition,
+                                           uint32_t *buffer, size_t len) {
+  dif_otp_ctrl_partition_layout_t layout;
+  TRY(dif_otp_ctrl_get_partition_layout(partition, &layout));
+  size_t granule_words = layout.dai_granule / sizeof(uint32_t);
+  if (len > layout.size / sizeof(uint32_t) || len % granule_words != 0) {
+    return INVALID_ARGUMENT();
+  }
+
+  if (layout.is_software) {
+    bool locked = true;
+    if (dif_otp_ctrl_reading_is_locked(otp, partition, &locked) == kDifOk &&
+        !locked) {
+      TRY(dif_otp_ctrl_read_blocking(otp, partition, 0, buffer, len));
+      return OK_STATUS();
+    }
+  }
+
+  TRY(otp_ctrl_testutils_wait_for_dai(otp));
+  uint32_t addr = 0;
+  for (size_t i = 0; i < len; i += granule_words) {
+    TRY(dif_otp_ctrl_dai_read_start(otp, partition, addr));
+    addr += layout.dai_granule;
+    TRY(otp_ctrl_testutils_wait_for_dai(otp));
+    if (granule_words == 1) {
+      TRY(dif_otp_ctrl_dai_read32_end(otp, &buffer[i]));
+    } else {
+      uint64_t value;
+      TRY(dif_otp_ctrl_dai_read64_end(otp, &value));
+      buffer[i] = (uint32_t)value;
+      buffer[i + 1] = (uint32_t)(value >> 32);
+    }
+  }
+  return OK_STATUS();
+}
+
 /**
  * Checks if there were any errors found after executing a DAI write transaction
  * to the SECRET2 partition.
@@ -136,6 +173,21 @@ static status_t otp_ctrl_dai_write_error_check(const dif_otp_ctrl_t *otp) {
   return INTERNAL();
 }
 
+/**
+ * Returns true if `partition` is a software partition, which is neither
+ * scrambled nor ECC protected and so can be read back and compared before
+ * programming.
+ */
+static bool is_sw_partition(dif_otp_ctrl_partition_t partition) {
+  return
+#ifdef OPENTITAN_IS_EARLGREY
+      partition == kDifOtpCtrlPartitionRotCreatorAuthCodesign ||
+      partition == kDifOtpCtrlPartitionRotCreatorAuthState ||
+#endif  // OPENTITAN_IS_EARLGREY
+      partition == kDifOtpCtrlPartitionCreatorSwCfg ||
+      partition == kDifOtpCtrlPartitionOwnerSwCfg;
+}
+
 status_t otp_ctrl_testutils_dai_write32(const dif_otp_ctrl_t *otp,
                                         dif_otp_ctrl_partition_t partition,
                                         uint32_t start_address,
@@ -143,13 +195,7 @@ status_t otp_ctrl_testutils_dai_write32(const dif_otp_ctrl_t *otp,
   // Software partitions don't have scrambling or ECC enabled, so it is possible
   // to read the value and compare it against the expected value before
   // performing the write.
-  bool check_before_write = (
-#ifdef OPENTITAN_IS_EARLGREY
-      partition == kDifOtpCtrlPartitionRotCreatorAuthCodesign ||
-      partition == kDifOtpCtrlPartitionRotCreatorAuthState ||
-#endif  // OPENTITAN_IS_EARLGREY
-      partition == kDifOtpCtrlPartitionCreatorSwCfg ||
-      partition == kDifOtpCtrlPartitionOwnerSwCfg);
+  bool check_before_write = is_sw_partition(partition);
   uint32_t stop_address = start_address + (len * sizeof(uint32_t));
   for (uint32_t addr = start_address, i = 0; addr < stop_address;
        addr += sizeof(uint32_t), ++i) {
@@ -199,3 +245,62 @@ status_t otp_ctrl_testutils_dai_write64(const dif_otp_ctrl_t *otp,
   }
   return OK_STATUS();
 }
+
+/**
+ * The number of words read through the software window at a time by
+ * `otp_ctrl_testutils_dai_write32_batch()`.
+ */
+enum { kBatchChunkWords = 16 };
+
+status_t otp_ctrl_testutils_dai_write32_batch(
+    const dif_otp_ctrl_t *otp, dif_otp_ctrl_partition_t partition,
+    uint32_t start_address, const uint32_t *buffer, size_t len) {
+  if (!is_sw_partition(partition)) {
+    return INVALID_ARGUMENT();
+  }
+
+  // Read the current contents a chunk at a time and program the words that
+  // differ back to back, without the per-word DAI reads before and after each
+  // write that `otp_ctrl_testutils_dai_write32()` does.
+  TRY(otp_ctrl_testutils_wait_for_dai(otp));
+  uint32_t chunk[kBatchChunkWords];
+  size_t programmed = 0;
+  for (size_t i = 0; i < len; i += kBatchChunkWords) {
+    size_t n = len - i < kBatchChunkWords ? len - i : kBatchChunkWords;
+    uint32_t addr = start_address + i * sizeof(uint32_t);
+    TRY(dif_otp_ctrl_read_blocking(otp, partition, addr, chunk, n));
+    for (size_t j = 0; j < n; ++j, addr += sizeof(uint32_t)) {
+      if (chunk[j] == buffer[i + j]) {
+        continue;
+      }
+      // OTP bits can't be cleared, so only blank words can be programmed.
+      if (chunk[j] != 0) {
+        LOG_ERROR("OTP partition: %d addr[0x%x] got: 0x%08x, expected: 0x%08x",
+                  partition, addr, chunk[j], buffer[i + j]);
+        return INTERNAL();
+      }
+      TRY(dif_otp_ctrl_dai_program32(otp, partition, addr, buffer[i + j]));
+      TRY(otp_ctrl_testutils_wait_for_dai(otp));
+      TRY(otp_ctrl_dai_write_error_check(otp));
+      ++programmed;
+    }
+  }
+  if (programmed == 0) {
+    return OK_STATUS();
+  }
+
+  // Verify the whole range with one pass over the software window.
+  for (size_t i = 0; i < len; i += kBatchChunkWords) {
+    size_t n = len - i < kBatchChunkWords ? len - i : kBatchChunkWords;
+    uint32_t addr = start_address + i * sizeof(uint32_t);
+    TRY(dif_otp_ctrl_read_blocking(otp, partition, addr, chunk, n));
+    for (size_t j = 0; j < n; ++j, addr += sizeof(uint32_t)) {
+      if (chunk[j] != buffer[i + j]) {
+        LOG_ERROR("OTP partition: %d addr[0x%x] got: 0x%08x, expected: 0x%08x",
+                  partition, addr, chunk[j], buffer[i + j]);
+        return INTERNAL();
+      }
+    }
+  }
+  return OK_STATUS();
+}
@@ -114,6 +114,30 @@ status_t otp_ctrl_testutils_dai_read64_array(const dif_otp_ctrl_t *otp,
                                              uint32_t start_address,
                                              uint64_t *buffer, size_t len);
 
+/**
+ * Reads the first `len` 32bit words of an OTP partition.
+ *
+ * Software partitions that are not read-locked are copied out of the software
+ * config window. Other partitions are read through the DAI, waiting only once
+ * per access and issuing the next read as soon as the previous one returns.
+ * 64bit DAI reads are stored least significant word first.
+ *
+ * Pass `len` equal to the partition size (see
+ * `dif_otp_ctrl_get_partition_layout()`) divided by four to read the whole
+ * partition, including its digest.
+ *
+ * @param otp otp_ctrl instance.
+ * @param partition OTP partition.
+ * @param[out] buffer The 32bit array buffer.
+ * @param len The number of 32bit words to read into the buffer. Must be even
+ *            for partitions with 64bit DAI access.
+ * @return OK_STATUS on successful read.
+ */
+OT_WARN_UNUSED_RESULT
+status_t otp_ctrl_testutils_read_partition(const dif_otp_ctrl_t *otp,
+                                           dif_otp_ctrl_partition_t partition,
+                                           uint32_t *buffer, size_t len);
+
 /**
  * Writes `len` number of 32bit words from buffer into otp `partition` starting
  * at `start_address` using the DAI interface.
@@ -141,6 +165,35 @@ status_t otp_ctrl_testutils_dai_write32(const dif_otp_ctrl_t *otp,
                                         uint32_t start_address,
                                         const uint32_t *buffer, size_t len);
 
+/**
+ * Writes `len` number of 32bit words from buffer into a software `partition`
+ * starting at `start_address`, programming only the words that change.
+ *
+ * This is a faster alternative to `otp_ctrl_testutils_dai_write32()` for
+ * large writes. The current contents of the range are read through the
+ * partition's memory-mapped window, the words that differ from `buffer` are
+ * programmed back to back using the DAI, and the whole range is then read back
+ * through the window once to check it.
+ *
+ * As for `otp_ctrl_testutils_dai_write32()`, a word that differs from the
+ * expected value is only programmed if it is currently zero.
+ *
+ * @param otp otp_ctrl instance.
+ * @param partition OTP partition. Must be a software partition (see
+ * `otp_ctrl_testutils_dai_write32()`), since others can't be read through the
+ * window.
+ * @param start_address Address relative to the start of the `partition`. Must
+ * be a 32bit aligned address.
+ * @param buffer The buffer containing the data to be written into OTP.
+ * @param len The number of 32bit words to write into otp.
+ * @return OK_STATUS on success, INVALID_ARGUMENT if `partition` isn't a
+ * software partition.
+ */
+OT_WARN_UNUSED_RESULT
+status_t otp_ctrl_testutils_dai_write32_batch(
+    const dif_otp_ctrl_t *otp, dif_otp_ctrl_partition_t partition,
+    uint32_t start_address, const uint32_t *buffer, size_t len);
+
 /**
  * Writes `len` number of 64bit words from buffer into otp `partition` starting
  * at `start_address` using the DAI interface.
@@ -0,0 +1,96 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "sw/device/lib/testing/pc_sampler.h"
+
+#include "dt/dt_api.h"  // Generated
+#include "sw/device/lib/dif/dif_rv_timer.h"
+#include "sw/device/lib/runtime/ibex.h"
+#include "sw/device/lib/runtime/irq.h"
+#include "sw/device/lib/testing/test_framework/check.h"
+
+#define MODULE_ID MAKE_MODULE_ID('p', 'c', 's')
+
+static const uint32_t kHart = 0;
+static const uint32_t kComparator = 0;
+static const uint64_t kTickFreqHz = 1000 * 1000;  // 1 MHz.
+
+static dif_rv_timer_t timer;
+static bool sampling = false;
+static uint64_t period_ticks;
+static size_t num_samples;
+static uint32_t num_dropped;
+static uint32_t samples[PC_SAMPLER_MAX_SAMPLES];
+
+/**
+ * Arm the timer to fire one period from now.
+ */
+static dif_result_t arm_next(void) {
+  uint64_t now;
+  DIF_RETURN_IF_ERROR(dif_rv_timer_counter_read(&timer, kHart, &now));
+  return dif_rv_timer_arm(&timer, kHart, kComparator, now + period_ticks);
+}
+
+status_t pc_sampler_start(dt_rv_timer_t dt, uint32_t period_us) {
+  TRY_CHECK(period_us > 0);
+  TRY(dif_rv_timer_init_from_dt(dt, &timer));
+  TRY(dif_rv_timer_reset(&timer));
+
+  dif_rv_timer_tick_params_t tick_params;
+  TRY(dif_rv_timer_approximate_tick_params(
+      dt_clock_frequency(dt_rv_timer_clock(dt, kDtRvTimerClockClk)),
+      kTickFreqHz, &tick_params));
+  TRY(dif_rv_timer_set_tick_params(&timer, kHart, tick_params));
+  TRY(dif_rv_timer_irq_set_enabled(&timer, kDtRvTimerIrqTimerExpiredHart0Timer0,
+                                   kDifToggleEnabled));
+
+  period_ticks = period_us;
+  num_samples = 0;
+  num_dropped = 0;
+  TRY(arm_next());
+  sampling = true;
+  irq_timer_ctrl(true);
+  irq_global_ctrl(true);
+  TRY(dif_rv_timer_counter_set_enabled(&timer, kHart, kDifToggleEnabled));
+  return OK_STATUS();
+}
+
+status_t pc_sampler_stop(void) {
+  sampling = false;
+  TRY(dif_rv_timer_counter_set_enabled(&timer, kHart, kDifToggleDisabled));
+  TRY(dif_rv_timer_irq_set_enabled(&timer, kDtRvTimerIrqTimerExpiredHart0Timer0,
+                                   kDifToggleDisabled));
+  TRY(dif_rv_timer_irq_acknowledge(&timer,
+                                   kDtRvTimerIrqTimerExpiredHart0Timer0));
+  return OK_STATUS();
+}
+
+bool pc_sampler_handle_irq(void) {
+  bool pending = false;
+  if (!sampling ||
+      dif_rv_timer_irq_is_pending(&timer, kDtRvTimerIrqTimerExpiredHart0Timer0,
+                                  &pending) != kDifOk ||
+      !pending) {
+    return false;
+  }
+  // `mepc` holds the PC of the instruction that was interrupted.
+  if (num_samples < PC_SAMPLER_MAX_SAMPLES) {
+    samples[num_samples++] = ibex_mepc_read();
+  } else {
+    ++num_dropped;
+  }
+  // Re-arm before acknowledging so the interrupt doesn't fire again straight
+  // away.
+  CHECK_DIF_OK(arm_next());
+  CHECK_DIF_OK(dif_rv_timer_irq_acknowledge(
+      &timer, kDtRvTimerIrqTimerExpiredHart0Timer0));
+  return true;
+}
+
+size_t pc_sampler_get_samples(const uint32_t **out_samples) {
+  *out_samples = samples;
+  return num_samples;
+}
+
+uint32_t pc_sampler_dropped(void) { return num_dropped; }
@@ -0,0 +1,83 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef OPENTITAN_SW_DEVICE_LIB_TESTING_PC_SAMPLER_H_
+#define OPENTITAN_SW_DEVICE_LIB_TESTING_PC_SAMPLER_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "dt/dt_rv_timer.h"  // Generated
+#include "sw/device/lib/base/status.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/**
+ * Maximum number of PC samples that are recorded. Further samples are dropped.
+ */
+#define PC_SAMPLER_MAX_SAMPLES 1024
+
+/**
+ * Start sampling the PC periodically for a statistical profile.
+ *
+ * Comparator 0 of hart 0 of the given rv_timer is used to interrupt the CPU
+ * every `period_us` microseconds, and the interrupted PC is recorded. The test
+ * must forward its timer interrupts to `pc_sampler_handle_irq()`:
+ *
+ *   void ottf_timer_isr(uint32_t *exc_info) {
+ *     CHECK(pc_sampler_handle_irq());
+ *   }
+ *
+ * This function enables the timer interrupt and global interrupts. Previously
+ * recorded samples are discarded.
+ *
+ * @param dt The rv_timer instance to use.
+ * @param period_us Sampling period in microseconds.
+ * @return The result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+status_t pc_sampler_start(dt_rv_timer_t dt, uint32_t period_us);
+
+/**
+ * Stop sampling the PC.
+ *
+ * The recorded samples remain available.
+ *
+ * @return The result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+status_t pc_sampler_stop(void);
+
+/**
+ * Handle a timer interrupt for the PC sampler.
+ *
+ * Records `mepc` and re-arms the timer.
+ *
+ * @return Whether the interrupt came from the PC sampler's timer.
+ */
+bool pc_sampler_handle_irq(void);
+
+/**
+ * Get the recorded PC samples.
+ *
+ * @param[out] samples Set to the samples, in the order they were taken.
+ * @return The number of samples.
+ */
+size_t pc_sampler_get_samples(const uint32_t **samples);
+
+/**
+ * Get the number of samples that were dropped because the buffer was full.
+ *
+ * @return The number of dropped samples.
+ */
+uint32_t pc_sampler_dropped(void);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // OPENTITAN_SW_DEVICE_LIB_TESTING_PC_SAMPLER_H_
@@ -4,6 +4,7 @@
 
 #include "sw/device/lib/testing/profile.h"
 
+#include "sw/device/lib/base/csr.h"
 #include "sw/device/lib/runtime/ibex.h"
 #include "sw/device/lib/testing/test_framework/check.h"
 
@@ -22,3 +23,108 @@ uint32_t profile_end_and_print(uint64_t t_start, char *name) {
   LOG_INFO("%s took %u cycles or %u ms @ 100 MHz.", name, cycles, time_ms);
   return cycles;
 }
+
+/**
+ * `mcountinhibit` bits for `mcycle`, `minstret`, `mhpmcounter3` and
+ * `mhpmcounter4`.
+ */
+static const uint32_t kCountInhibitMask =
+    (1u << 0) | (1u << 2) | (1u << 3) | (1u << 4);
+
+/**
+ * Counter values at the start of an open zone.
+ */
+typedef struct zone_start {
+  const char *name;
+  uint32_t cycles;
+  uint32_t instret;
+  uint32_t lsu_stall_cycles;
+  uint32_t ifetch_stall_cycles;
+} zone_start_t;
+
+static bool sample_perf = false;
+static size_t zone_depth = 0;
+static zone_start_t zone_stack[PROFILE_ZONE_MAX_DEPTH];
+static profile_zone_record_t zone_records[PROFILE_ZONE_RECORDS];
+// Index of the next record to write and the total number ever written.
+static size_t zone_records_next = 0;
+static uint32_t zone_records_total = 0;
+
+/**
+ * Sample the counters into `sample`.
+ *
+ * Only the low 32 bits of `mcycle` are used: zones are expected to be shorter
+ * than 2^32 cycles, and the wrapping difference is then still correct.
+ */
+static inline void sample_counters(zone_start_t *sample) {
+  CSR_READ(CSR_REG_MCYCLE, &sample->cycles);
+  if (sample_perf) {
+    CSR_READ(CSR_REG_MINSTRET, &sample->instret);
+    CSR_READ(CSR_REG_MHPMCOUNTER3, &sample->lsu_stall_cycles);
+    CSR_READ(CSR_REG_MHPMCOUNTER4, &sample->ifetch_stall_cycles);
+  }
+}
+
+void profile_zones_init(bool sample_perf_counters) {
+  sample_perf = sample_perf_counters;
+  zone_depth = 0;
+  zone_records_next = 0;
+  zone_records_total = 0;
+  if (sample_perf_counters) {
+    CSR_CLEAR_BITS(CSR_REG_MCOUNTINHIBIT, kCountInhibitMask);
+  }
+}
+
+void profile_zone_begin(const char *name) {
+  CHECK(zone_depth < PROFILE_ZONE_MAX_DEPTH, "Too many nested zones");
+  zone_start_t *start = &zone_stack[zone_depth++];
+  start->name = name;
+  // Sample last so that the bookkeeping isn't counted.
+  sample_counters(start);
+}
+
+void profile_zone_end(void) {
+  // Sample first so that the bookkeeping isn't counted.
+  zone_start_t end;
+  sample_counters(&end);
+  CHECK(zone_depth > 0, "No zone to end");
+  const zone_start_t *start = &zone_stack[--zone_depth];
+
+  profile_zone_record_t *record = &zone_records[zone_records_next];
+  zone_records_next = (zone_records_next + 1) % PROFILE_ZONE_RECORDS;
+  ++zone_records_total;
+  record->name = start->name;
+  record->depth = (uint32_t)zone_depth;
+  record->cycles = end.cycles - start->cycles;
+  if (sample_perf) {
+    record->instret = end.instret - start->instret;
+    record->lsu_stall_cycles = end.lsu_stall_cycles - start->lsu_stall_cycles;
+    record->ifetch_stall_cycles =
+        end.ifetch_stall_cycles - start->ifetch_stall_cycles;
+  } else {
+    record->instret = 0;
+    record->lsu_stall_cycles = 0;
+    record->ifetch_stall_cycles = 0;
+  }
+}
+
+size_t profile_zone_count(void) {
+  return zone_records_total < PROFILE_ZONE_RECORDS ? zone_records_total
+                                                   : PROFILE_ZONE_RECORDS;
+}
+
+uint32_t profile_zone_dropped(void) {
+  return zone_records_total - (uint32_t)profile_zone_count();
+}
+
+bool profile_zone_get(size_t index, profile_zone_record_t *record) {
+  size_t count = profile_zone_count();
+  if (index >= count) {
+    return false;
+  }
+  // The oldest record is the one that will be overwritten next once the
+  // buffer is full, and the first one otherwise.
+  size_t oldest = count < PROFILE_ZONE_RECORDS ? 0 : zone_records_next;
+  *record = zone_records[(oldest + index) % PROFILE_ZONE_RECORDS];
+  return true;
+}
@@ -5,6 +5,8 @@
 #ifndef OPENTITAN_SW_DEVICE_LIB_TESTING_PROFILE_H_
 #define OPENTITAN_SW_DEVICE_LIB_TESTING_PROFILE_H_
 
+#include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 #ifdef __cplusplus
@@ -50,6 +52,115 @@ uint32_t profile_end(uint64_t t_start);
  */
 uint32_t profile_end_and_print(uint64_t t_start, char *name);
 
+/**
+ * Maximum nesting depth of profiling zones.
+ */
+#define PROFILE_ZONE_MAX_DEPTH 8
+
+/**
+ * Number of completed zones kept in the ring buffer. Older records are
+ * overwritten once it is full.
+ */
+#define PROFILE_ZONE_RECORDS 64
+
+/**
+ * A completed profiling zone.
+ *
+ * All counts are the difference between the end and the start of the zone and
+ * include the time spent in nested zones. The instruction and stall counts are
+ * only valid if the zones were initialized with `sample_perf_counters` set.
+ */
+typedef struct profile_zone_record {
+  /**
+   * Name of the zone, as passed to `profile_zone_begin()`.
+   */
+  const char *name;
+  /**
+   * Nesting depth of the zone, 0 for an outermost zone.
+   */
+  uint32_t depth;
+  /**
+   * Number of cycles (`mcycle`).
+   */
+  uint32_t cycles;
+  /**
+   * Number of retired instructions (`minstret`).
+   */
+  uint32_t instret;
+  /**
+   * Number of cycles waiting for loads and stores (`mhpmcounter3`).
+   */
+  uint32_t lsu_stall_cycles;
+  /**
+   * Number of cycles waiting for instruction fetches (`mhpmcounter4`).
+   */
+  uint32_t ifetch_stall_cycles;
+} profile_zone_record_t;
+
+/**
+ * Reset the profiling zones and discard all recorded data.
+ *
+ * Basic usage:
+ *   profile_zones_init(true);
+ *   profile_zone_begin("outer");
+ *   profile_zone_begin("inner");
+ *   // Do some stuff
+ *   profile_zone_end();
+ *   profile_zone_end();
+ *   // Then e.g. report with `ujson_profile_report()`.
+ *
+ * Zones must be ended in the reverse order they were begun. Only reading
+ * `mcycle` at the zone boundaries keeps the overhead to a few instructions;
+ * sampling the other counters adds a few CSR reads per boundary.
+ *
+ * @param sample_perf_counters Whether to also sample `minstret` and the Ibex
+ * performance counters. This enables the counters if they were inhibited.
+ */
+void profile_zones_init(bool sample_perf_counters);
+
+/**
+ * Begin a nested profiling zone.
+ *
+ * Beginning more than `PROFILE_ZONE_MAX_DEPTH` nested zones is a fatal error.
+ *
+ * @param name Name of the zone. The string is not copied and must stay valid
+ * until the data has been reported (a string literal is typical).
+ */
+void profile_zone_begin(const char *name);
+
+/**
+ * End the innermost profiling zone and record it in the ring buffer.
+ *
+ * Ending a zone that was not begun is a fatal error.
+ */
+void profile_zone_end(void);
+
+/**
+ * Get the number of records available in the ring buffer.
+ *
+ * @return The number of records, at most `PROFILE_ZONE_RECORDS`.
+ */
+size_t profile_zone_count(void);
+
+/**
+ * Get the number of records that were overwritten because the ring buffer was
+ * full.
+ *
+ * @return The number of lost records.
+ */
+uint32_t profile_zone_dropped(void);
+
+/**
+ * Get a record from the ring buffer.
+ *
+ * Records are ordered by the time their zone ended, oldest first.
+ *
+ * @param index Index of the record, less than `profile_zone_count()`.
+ * @param[out] record The record.
+ * @return Whether `index` was valid.
+ */
+bool profile_zone_get(size_t index, profile_zone_record_t *record);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -82,11 +82,60 @@ uint32_t rand_testutils_gen32_range(uint32_t min, uint32_t max) {
   if (range == 0) {
     return min;
   }
-  uint32_t result = min + (rand_testutils_gen32() % (range + 1));
+  // Scale the random value into the range with a multiply and a shift, which
+  // avoids the multi-cycle division of `%` on Ibex.
+  uint64_t scaled = (uint64_t)rand_testutils_gen32() * ((uint64_t)range + 1);
+  uint32_t result = min + (uint32_t)(scaled >> 32);
   CHECK(result >= min && result <= max);
   return result;
 }
 
+static inline uint32_t rotl32(uint32_t x, uint32_t k) {
+  return (x << k) | (x >> (32 - k));
+}
+
+/**
+ * Steps a xoshiro128++ generator.
+ *
+ * See https://prng.di.unimi.it/xoshiro128plusplus.c.
+ */
+static inline uint32_t xoshiro128pp_next(uint32_t s[4]) {
+  uint32_t result = rotl32(s[0] + s[3], 7) + s[0];
+  uint32_t t = s[1] << 9;
+  s[2] ^= s[0];
+  s[3] ^= s[1];
+  s[1] ^= s[2];
+  s[0] ^= s[3];
+  s[2] ^= t;
+  s[3] = rotl32(s[3], 11);
+  return result;
+}
+
+void rand_testutils_fill(void *buf, size_t len) {
+  uint32_t state[4];
+  uint32_t any_set = 0;
+  for (size_t i = 0; i < ARRAYSIZE(state); ++i) {
+    CHECK_STATUS_OK(rv_core_ibex_testutils_get_rnd_data(
+        rand_testutils_rng_ctx.rv_core_ibex,
+        rand_testutils_rng_ctx.entropy_fetch_timeout_usec, &state[i]));
+    any_set |= state[i];
+  }
+  // The all-zero state is the only one that xoshiro never leaves.
+  if (any_set == 0) {
+    state[0] = 1;
+  }
+
+  unsigned char *buf8 = buf;
+  for (; len >= sizeof(uint32_t); len -= sizeof(uint32_t)) {
+    write_32(xoshiro128pp_next(state), buf8);
+    buf8 += sizeof(uint32_t);
+  }
+  if (len > 0) {
+    uint32_t word = xoshiro128pp_next(state);
+    memcpy(buf8, &word, len);
+  }
+}
+
 void rand_testutils_shuffle(void *array, size_t size, size_t length) {
   if (length <= 1) {
     return;
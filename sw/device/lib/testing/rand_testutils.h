@@ -91,15 +91,30 @@ uint32_t rand_testutils_gen32(void);
  * Returns a random unsigned integer within a given range.
  *
  * This function invokes `rand_testutils_gen32()` and restricts the returned
- * value to be within the supplied range, inclusive of the range limits. Note
- * that a uniform distribution of values within the given range is not
- * guaranteed.
+ * value to be within the supplied range, inclusive of the range limits. The
+ * value is scaled into the range with a multiply and a shift rather than a
+ * division, so the upper bits of the random value select it. Note that a
+ * uniform distribution of values within the given range is not guaranteed.
  * @param min The lower limit of the range.
  * @param max The upper limit of the range.
  * @return The computed random value within the supplied range.
  */
 uint32_t rand_testutils_gen32_range(uint32_t min, uint32_t max);
 
+/**
+ * Fills a buffer with pseudo-random bytes.
+ *
+ * This is meant for tests that need large amounts of random data. Rather than
+ * stepping the LFSR by one bit per word, a xoshiro128++ generator produces a
+ * full word per step. It is seeded with 128 bits from the hardware on every
+ * call, so the contents of consecutive buffers are unrelated. The LFSR state
+ * is not affected.
+ *
+ * @param buf The buffer to fill, which need not be word-aligned.
+ * @param len The length of the buffer in bytes.
+ */
+void rand_testutils_fill(void *buf, size_t len);
+
 /** Shuffles an arbitrary array of elements.
  *
  * The shuffling occurs in-place. The reseeding of the LFSR is temporarily
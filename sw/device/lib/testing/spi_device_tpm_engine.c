@@ -0,0 +1,308 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "sw/device/lib/testing/spi_device_tpm_engine.h"
+
+#include "sw/device/lib/base/bitfield.h"
+#include "sw/device/lib/base/memory.h"
+
+enum {
+  /**
+   * Fields of the command byte of a TPM transaction header.
+   */
+  kTpmCommandReadBit = 0x80,
+  kTpmCommandSizeMask = 0x3f,
+  /**
+   * Register offset and locality fields of a TPM address.
+   */
+  kTpmAddrRegMask = 0xfff,
+  kTpmAddrLocalityShift = 12,
+  kTpmAddrLocalityMask = 0xf,
+  kTpmNumLocalities = 5,
+  /**
+   * Register offsets.
+   */
+  kTpmRegAccess = 0x000,
+  kTpmRegSts = 0x018,
+  kTpmRegDataFifo = 0x024,
+  kTpmRegXDataFifo = 0x080,
+  kTpmRegXDataFifoEnd = 0x840,
+  /**
+   * TPM_STS bits.
+   */
+  kTpmStsValid = 1 << 7,
+  kTpmStsCommandReady = 1 << 6,
+  kTpmStsGo = 1 << 5,
+  kTpmStsDataAvail = 1 << 4,
+  kTpmStsExpect = 1 << 3,
+  kTpmStsResponseRetry = 1 << 1,
+  /**
+   * TPM_ACCESS_x bits.
+   */
+  kTpmAccessValid = 1 << 7,
+  kTpmAccessActiveLocality = 1 << 5,
+  kTpmAccessRequestUse = 1 << 1,
+  /**
+   * Size of the TPM read and write FIFOs, which bounds the burst count.
+   */
+  kTpmMaxBurst = 64,
+  /**
+   * Size of a TPM command header, and offset of its big-endian size field.
+   */
+  kTpmHeaderLen = 10,
+  kTpmHeaderSizeOffset = 2,
+};
+
+static const bitfield_field32_t kTpmStsBurstCountField = {
+    .mask = 0xffff,
+    .index = 8,
+};
+
+static bool is_data_fifo(uint32_t reg) {
+  return reg == kTpmRegDataFifo ||
+         (reg >= kTpmRegXDataFifo && reg < kTpmRegXDataFifoEnd);
+}
+
+/**
+ * Returns whether the command being received is incomplete.
+ */
+static bool command_expects_more(const spi_device_tpm_engine_t *engine) {
+  if (engine->cmd_len < kTpmHeaderLen) {
+    return true;
+  }
+  uint32_t size =
+      bitfield_byteswap32(read_32(&engine->cmd_buf[kTpmHeaderSizeOffset]));
+  return engine->cmd_len < size;
+}
+
+/**
+ * Writes the TPM_STS value for the current state.
+ */
+static status_t update_sts(spi_device_tpm_engine_t *engine) {
+  uint32_t sts = kTpmStsValid;
+  size_t burst = 0;
+  switch (engine->state) {
+    case kSpiDeviceTpmEngineStateReady:
+      sts |= kTpmStsCommandReady;
+      burst = kTpmMaxBurst;
+      break;
+    case kSpiDeviceTpmEngineStateReception:
+      if (command_expects_more(engine)) {
+        sts |= kTpmStsExpect;
+      }
+      burst = kTpmMaxBurst;
+      break;
+    case kSpiDeviceTpmEngineStateCompletion: {
+      size_t remaining = engine->resp_len - engine->resp_offset;
+      if (remaining > 0) {
+        sts |= kTpmStsDataAvail;
+        // The host reads a whole burst at a time, so it must not exceed the
+        // rest of the response.
+        burst = remaining < kTpmMaxBurst ? remaining : kTpmMaxBurst;
+      }
+      break;
+    }
+    default:
+      break;
+  }
+  sts = bitfield_field32_write(sts, kTpmStsBurstCountField, (uint32_t)burst);
+  TRY(dif_spi_device_tpm_set_sts_reg(engine->spi_device, sts));
+  return OK_STATUS();
+}
+
+/**
+ * Discards the current command and response.
+ */
+static void reset(spi_device_tpm_engine_t *engine) {
+  engine->state = kSpiDeviceTpmEngineStateReady;
+  engine->cmd_len = 0;
+  engine->resp = NULL;
+  engine->resp_len = 0;
+  engine->resp_offset = 0;
+  engine->resp_pending = 0;
+}
+
+/**
+ * Handles a write of `length` bytes to `addr`.
+ */
+static status_t handle_write(spi_device_tpm_engine_t *engine, uint32_t addr,
+                             size_t length) {
+  dif_spi_device_handle_t *spi = engine->spi_device;
+  // The host sends the payload right after the header.
+  dif_spi_device_tpm_data_status_t status;
+  do {
+    TRY(dif_spi_device_tpm_get_data_status(spi, &status));
+  } while (!status.wrfifo_acquired);
+
+  uint32_t reg = addr & kTpmAddrRegMask;
+  uint8_t data[kTpmMaxBurst];
+  if (is_data_fifo(reg)) {
+    if (engine->state == kSpiDeviceTpmEngineStateReady) {
+      engine->state = kSpiDeviceTpmEngineStateReception;
+    }
+    if (engine->state == kSpiDeviceTpmEngineStateReception &&
+        engine->cmd_len + length <= engine->cmd_buf_len) {
+      TRY(dif_spi_device_tpm_read_data(spi, length,
+                                       &engine->cmd_buf[engine->cmd_len]));
+      engine->cmd_len += length;
+    } else {
+      engine->dropped += length;
+    }
+  } else {
+    TRY(dif_spi_device_tpm_read_data(spi, length, data));
+  }
+  TRY(dif_spi_device_tpm_free_write_fifo(spi));
+
+  if (reg == kTpmRegSts) {
+    uint32_t sts = 0;
+    memcpy(&sts, data, length < sizeof(sts) ? length : sizeof(sts));
+    if (sts & kTpmStsCommandReady) {
+      reset(engine);
+    } else if ((sts & kTpmStsGo) &&
+               engine->state == kSpiDeviceTpmEngineStateReception &&
+               !command_expects_more(engine)) {
+      engine->state = kSpiDeviceTpmEngineStateExecution;
+      ++engine->commands;
+    } else if ((sts & kTpmStsResponseRetry) &&
+               engine->state == kSpiDeviceTpmEngineStateCompletion) {
+      engine->resp_offset = 0;
+    }
+  } else if (reg == kTpmRegAccess) {
+    uint8_t locality = (addr >> kTpmAddrLocalityShift) & kTpmAddrLocalityMask;
+    if (locality < kTpmNumLocalities) {
+      uint8_t access = kTpmAccessValid;
+      if (data[0] & kTpmAccessRequestUse) {
+        access |= kTpmAccessActiveLocality;
+      }
+      TRY(dif_spi_device_tpm_set_access_reg(spi, locality, access));
+    }
+  }
+  return update_sts(engine);
+}
+
+/**
+ * Handles a read of `length` bytes from `addr`.
+ */
+static status_t handle_read(spi_device_tpm_engine_t *engine, uint32_t addr,
+                            size_t length) {
+  size_t n = 0;
+  if (is_data_fifo(addr & kTpmAddrRegMask) &&
+      engine->state == kSpiDeviceTpmEngineStateCompletion) {
+    size_t remaining = engine->resp_len - engine->resp_offset;
+    n = remaining < length ? remaining : length;
+  }
+  engine->resp_pending = n;
+
+  if (n == length) {
+    // The common case: copy the staged response straight into the read FIFO.
+    TRY(dif_spi_device_tpm_write_data(
+        engine->spi_device, length,
+        (uint8_t *)&engine->resp[engine->resp_offset]));
+    return OK_STATUS();
+  }
+  // Registers that are not implemented and reads past the end of the
+  // response return 0xff.
+  uint8_t data[kTpmMaxBurst];
+  if (n > 0) {
+    memcpy(data, &engine->resp[engine->resp_offset], n);
+  }
+  memset(&data[n], 0xff, length - n);
+  TRY(dif_spi_device_tpm_write_data(engine->spi_device, length, data));
+  return OK_STATUS();
+}
+
+status_t spi_device_tpm_engine_init(spi_device_tpm_engine_t *engine,
+                                    dif_spi_device_handle_t *spi_device,
+                                    uint8_t *cmd_buf, size_t cmd_buf_len) {
+  if (engine == NULL || spi_device == NULL || cmd_buf == NULL ||
+      cmd_buf_len < kTpmHeaderLen) {
+    return INVALID_ARGUMENT();
+  }
+  engine->spi_device = spi_device;
+  engine->cmd_buf = cmd_buf;
+  engine->cmd_buf_len = cmd_buf_len;
+  engine->commands = 0;
+  engine->dropped = 0;
+  reset(engine);
+
+  const dif_spi_device_tpm_config_t kConfig = {
+      .interface = kDifSpiDeviceTpmInterfaceFifo,
+      .disable_return_by_hardware = false,
+      .disable_address_prefix_check = false,
+      .disable_locality_check = false,
+  };
+  TRY(dif_spi_device_tpm_configure(spi_device, kDifToggleEnabled, kConfig));
+  TRY(dif_spi_device_tpm_set_access_reg(spi_device, 0, kTpmAccessValid));
+  TRY(update_sts(engine));
+
+  TRY(dif_spi_device_irq_acknowledge(&spi_device->dev,
+                                     kDifSpiDeviceIrqTpmRdfifoCmdEnd));
+  TRY(dif_spi_device_irq_set_enabled(
+      &spi_device->dev, kDifSpiDeviceIrqTpmHeaderNotEmpty, kDifToggleEnabled));
+  TRY(dif_spi_device_irq_set_enabled(
+      &spi_device->dev, kDifSpiDeviceIrqTpmRdfifoCmdEnd, kDifToggleEnabled));
+  return OK_STATUS();
+}
+
+status_t spi_device_tpm_engine_service(spi_device_tpm_engine_t *engine) {
+  dif_spi_device_handle_t *spi = engine->spi_device;
+  dif_spi_device_tpm_data_status_t status;
+
+  // A read always ends before the header of the next transaction is
+  // uploaded, so handle its end first.
+  bool read_end;
+  TRY(dif_spi_device_irq_is_pending(
+      &spi->dev, kDifSpiDeviceIrqTpmRdfifoCmdEnd, &read_end));
+  if (read_end) {
+    TRY(dif_spi_device_irq_acknowledge(&spi->dev,
+                                       kDifSpiDeviceIrqTpmRdfifoCmdEnd));
+    TRY(dif_spi_device_tpm_get_data_status(spi, &status));
+    if (!status.rdfifo_aborted) {
+      engine->resp_offset += engine->resp_pending;
+    }
+    engine->resp_pending = 0;
+    TRY(update_sts(engine));
+  }
+
+  TRY(dif_spi_device_tpm_get_data_status(spi, &status));
+  while (status.cmd_addr_valid) {
+    uint8_t command;
+    uint32_t addr;
+    TRY(dif_spi_device_tpm_get_command(spi, &command, &addr));
+    size_t length = (command & kTpmCommandSizeMask) + 1u;
+    if (command & kTpmCommandReadBit) {
+      TRY(handle_read(engine, addr, length));
+    } else {
+      TRY(handle_write(engine, addr, length));
+    }
+    TRY(dif_spi_device_tpm_get_data_status(spi, &status));
+  }
+  return OK_STATUS();
+}
+
+bool spi_device_tpm_engine_get_command(spi_device_tpm_engine_t *engine,
+                                       const uint8_t **cmd, size_t *length) {
+  if (engine->state != kSpiDeviceTpmEngineStateExecution) {
+    return false;
+  }
+  *cmd = engine->cmd_buf;
+  *length = engine->cmd_len;
+  return true;
+}
+
+status_t spi_device_tpm_engine_respond(spi_device_tpm_engine_t *engine,
+                                       const uint8_t *resp, size_t length) {
+  if (resp == NULL && length > 0) {
+    return INVALID_ARGUMENT();
+  }
+  if (engine->state != kSpiDeviceTpmEngineStateExecution) {
+    return FAILED_PRECONDITION();
+  }
+  engine->resp = resp;
+  engine->resp_len = length;
+  engine->resp_offset = 0;
+  engine->resp_pending = 0;
+  engine->state = kSpiDeviceTpmEngineStateCompletion;
+  return update_sts(engine);
+}
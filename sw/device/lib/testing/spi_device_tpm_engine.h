@@ -0,0 +1,157 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef OPENTITAN_SW_DEVICE_LIB_TESTING_SPI_DEVICE_TPM_ENGINE_H_
+#define OPENTITAN_SW_DEVICE_LIB_TESTING_SPI_DEVICE_TPM_ENGINE_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "sw/device/lib/base/status.h"
+#include "sw/device/lib/dif/dif_spi_device.h"
+
+/**
+ * Interrupt-driven TPM FIFO interface transport for the SPI device.
+ *
+ * The engine implements the command/response flow of the TCG PC Client TPM
+ * FIFO interface on top of the TPM submodule of the SPI device: the host
+ * writes a command to TPM_DATA_FIFO, sets TPM_STS.tpmGo, polls TPM_STS until
+ * dataAvail is set and reads the response back from TPM_DATA_FIFO.
+ *
+ * TPM_STS, TPM_ACCESS_x and the other return-by-hardware registers are read by
+ * the host without software involvement; the engine keeps them up to date as
+ * the state changes. The transactions that software must handle are moved from
+ * the `tpm_header_not_empty` interrupt:
+ *  - Writes to TPM_DATA_FIFO are copied straight from the write FIFO into the
+ *    command buffer, without an intermediate copy.
+ *  - Reads of TPM_DATA_FIFO are served from the response buffer, which is
+ *    staged by `spi_device_tpm_engine_respond()` before dataAvail is set, so
+ *    the interrupt handler only has to copy it into the read FIFO.
+ *  - Writes to TPM_STS and TPM_ACCESS_x move the engine between states.
+ * The `tpm_rdfifo_cmd_end` interrupt marks the end of each read, at which
+ * point an aborted read is rewound and TPM_STS is updated.
+ *
+ * The hardware drops data written to the read FIFO while no read command is
+ * active, so a response cannot be pushed ahead of the host's read.
+ *
+ * The caller is responsible for routing the `tpm_header_not_empty` and
+ * `tpm_rdfifo_cmd_end` interrupts through the PLIC and calling
+ * `spi_device_tpm_engine_service()` from its ISR. Commands are executed
+ * outside of the ISR: poll `spi_device_tpm_engine_get_command()` and reply
+ * with `spi_device_tpm_engine_respond()`.
+ */
+
+/**
+ * States of the TPM FIFO interface.
+ */
+typedef enum spi_device_tpm_engine_state {
+  /**
+   * Ready to receive a command (TPM_STS.commandReady is set).
+   */
+  kSpiDeviceTpmEngineStateReady,
+  /**
+   * Receiving a command.
+   */
+  kSpiDeviceTpmEngineStateReception,
+  /**
+   * A complete command is waiting for `spi_device_tpm_engine_respond()`.
+   */
+  kSpiDeviceTpmEngineStateExecution,
+  /**
+   * The response is being read by the host.
+   */
+  kSpiDeviceTpmEngineStateCompletion,
+} spi_device_tpm_engine_state_t;
+
+typedef struct spi_device_tpm_engine {
+  /**
+   * The SPI device handle.
+   */
+  dif_spi_device_handle_t *spi_device;
+  /**
+   * The buffer receiving commands, and the number of bytes received so far.
+   */
+  uint8_t *cmd_buf;
+  size_t cmd_buf_len;
+  size_t cmd_len;
+  /**
+   * The response being read by the host, the number of bytes read so far and
+   * the number of bytes pushed for the read in progress.
+   */
+  const uint8_t *resp;
+  size_t resp_len;
+  size_t resp_offset;
+  size_t resp_pending;
+  /**
+   * The current state.
+   */
+  volatile spi_device_tpm_engine_state_t state;
+  /**
+   * The number of commands received and of bytes dropped because a command
+   * overflowed the command buffer.
+   */
+  uint32_t commands;
+  uint32_t dropped;
+} spi_device_tpm_engine_t;
+
+/**
+ * Initializes the engine and enables the TPM submodule in FIFO mode.
+ *
+ * The engine enables the `tpm_header_not_empty` and `tpm_rdfifo_cmd_end`
+ * interrupts of the SPI device.
+ *
+ * @param engine The engine to initialize.
+ * @param spi_device A SPI device handle.
+ * @param cmd_buf The buffer receiving commands.
+ * @param cmd_buf_len The length of `cmd_buf`, in bytes.
+ * @return The result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+status_t spi_device_tpm_engine_init(spi_device_tpm_engine_t *engine,
+                                    dif_spi_device_handle_t *spi_device,
+                                    uint8_t *cmd_buf, size_t cmd_buf_len);
+
+/**
+ * Handles the TPM transactions uploaded to software.
+ *
+ * Should be called from the ISR of the `tpm_header_not_empty` and
+ * `tpm_rdfifo_cmd_end` interrupts.
+ *
+ * @param engine The engine.
+ * @return The result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+status_t spi_device_tpm_engine_service(spi_device_tpm_engine_t *engine);
+
+/**
+ * Returns the command to execute, if there is one.
+ *
+ * @param engine The engine.
+ * @param[out] cmd The command.
+ * @param[out] length The length of the command, in bytes.
+ * @return Whether a command is waiting for a response.
+ */
+OT_WARN_UNUSED_RESULT
+bool spi_device_tpm_engine_get_command(spi_device_tpm_engine_t *engine,
+                                       const uint8_t **cmd, size_t *length);
+
+/**
+ * Stages the response to the command returned by
+ * `spi_device_tpm_engine_get_command()` and sets TPM_STS.dataAvail.
+ *
+ * The response is read by the host directly from `resp`, which must remain
+ * valid until the host writes TPM_STS.commandReady.
+ *
+ * @param engine The engine.
+ * @param resp The response.
+ * @param length The length of the response, in bytes.
+ * @return The result of the operation; `kFailedPrecondition` if there is no
+ * command to respond to.
+ */
+OT_WARN_UNUSED_RESULT
+status_t spi_device_tpm_engine_respond(spi_device_tpm_engine_t *engine,
+                                       const uint8_t *resp, size_t length);
+
+#endif  // OPENTITAN_SW_DEVICE_LIB_TESTING_SPI_DEVICE_TPM_ENGINE_H_
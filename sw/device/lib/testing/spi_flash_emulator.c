@@ -116,15 +116,73 @@ static status_t prepare_jedec_id(dif_spi_device_handle_t *spid) {
   return OK_STATUS();
 }
 
+// Prepares the identification tables presented to the upstream host and
+// enables quad mode on the backend EEPROM.
+static status_t prepare_backend(dif_spi_host_t *spih,
+                                dif_spi_device_handle_t *spid) {
+  TRY(prepare_jedec_id(spid));
+  uint8_t quad_enable = (uint8_t)TRY(read_and_prepare_sfdp(spih, spid));
+  LOG_INFO("Setting the EEPROM's QE bit via mechanism %d", quad_enable);
+  TRY(spi_flash_testutils_quad_enable(spih, quad_enable, /*enabled=*/true));
+  return OK_STATUS();
+}
+
+// Forwards an uploaded erase or program command to the backend EEPROM.
+// Clears `running` if the command was a reset.
+static status_t execute_upload(dif_spi_host_t *spih, const upload_info_t *info,
+                               bool *running) {
+  switch (info->opcode) {
+    case kSpiDeviceFlashOpChipErase:
+      TRY(spi_flash_testutils_erase_chip(spih));
+      break;
+    case kSpiDeviceFlashOpSectorErase:
+      TRY(spi_flash_testutils_erase_sector(spih, info->address, info->addr_4b));
+      break;
+    case kSpiDeviceFlashOpBlockErase32k:
+      TRY(spi_flash_testutils_erase_op(spih, kSpiDeviceFlashOpBlockErase32k,
+                                       info->address, info->addr_4b));
+      break;
+    case kSpiDeviceFlashOpBlockErase64k:
+      TRY(spi_flash_testutils_erase_op(spih, kSpiDeviceFlashOpBlockErase64k,
+                                       info->address, info->addr_4b));
+      break;
+    case kSpiDeviceFlashOpPageProgram:
+      TRY(spi_flash_testutils_program_page(spih, info->data, info->data_len,
+                                           info->address, info->addr_4b));
+      break;
+    case kSpiDeviceFlashOpSectorErase4b:
+      TRY(spi_flash_testutils_erase_op(spih, kSpiDeviceFlashOpSectorErase4b,
+                                       info->address, /*addr_is_4b=*/true));
+      break;
+    case kSpiDeviceFlashOpBlockErase32k4b:
+      TRY(spi_flash_testutils_erase_op(spih, kSpiDeviceFlashOpBlockErase32k4b,
+                                       info->address, /*addr_is_4b=*/true));
+      break;
+    case kSpiDeviceFlashOpBlockErase64k4b:
+      TRY(spi_flash_testutils_erase_op(spih, kSpiDeviceFlashOpBlockErase64k4b,
+                                       info->address, /*addr_is_4b=*/true));
+      break;
+    case kSpiDeviceFlashOpPageProgram4b:
+      TRY(spi_flash_testutils_program_op(
+          spih, kSpiDeviceFlashOpPageProgram4b, info->data, info->data_len,
+          info->address,
+          /*addr_is_4b=*/true, kTransactionWidthMode111));
+      break;
+    case kSpiDeviceFlashOpReset:
+      *running = false;
+      break;
+    default:
+      LOG_ERROR("Unknown SPI op: %02x", info->opcode);
+  }
+  return OK_STATUS();
+}
+
 status_t spi_flash_emulator(dif_spi_host_t *spih,
                             dif_spi_device_handle_t *spid) {
   // TODO: add a mode that uses spi_device address translation.
   LOG_INFO("Configuring spi_flash_emulator.");
   TRY(dif_spi_device_set_passthrough_mode(spid, kDifToggleDisabled));
-  TRY(prepare_jedec_id(spid));
-  uint8_t quad_enable = (uint8_t)TRY(read_and_prepare_sfdp(spih, spid));
-  LOG_INFO("Setting the EEPROM's QE bit via mechanism %d", quad_enable);
-  TRY(spi_flash_testutils_quad_enable(spih, quad_enable, /*enabled=*/true));
+  TRY(prepare_backend(spih, spid));
   TRY(dif_spi_device_set_passthrough_mode(spid, kDifToggleEnabled));
   LOG_INFO("Starting spi_flash_emulator.");
 
@@ -134,52 +192,297 @@ status_t spi_flash_emulator(dif_spi_host_t *spih,
     TRY(spi_device_testutils_wait_for_upload(spid, &info));
 
     TRY(dif_spi_device_set_passthrough_mode(spid, kDifToggleDisabled));
+    TRY(execute_upload(spih, &info, &running));
+    TRY(dif_spi_device_set_passthrough_mode(spid, kDifToggleEnabled));
+    TRY(dif_spi_device_set_flash_status_registers(spid, 0));
+  }
+  LOG_INFO("Exiting spi_flash_emulator.");
+  return OK_STATUS();
+}
+
+enum {
+  // The spi_device read buffer is split into two halves. Flash address `A` is
+  // served from read buffer offset `A % kReadbufSize`.
+  kReadbufHalf = 1024,
+  kReadbufSize = 2 * kReadbufHalf,
+  // Offset into the current half at which the next half is prefetched.
+  kReadbufWatermark = kReadbufHalf / 2,
+  kPageSize = 256,
+  kFlashAddr3bLimit = 1 << 24,
+};
+
+/**
+ * State of the read buffer emulator.
+ *
+ * `window` mirrors the read buffer, which holds flash addresses
+ * [base, base + kReadbufSize). The host reads linearly from the half starting
+ * at `base`; the other half is the next kilobyte of flash.
+ */
+typedef struct readbuf_emulator {
+  dif_spi_host_t *spih;
+  dif_spi_device_handle_t *spid;
+  uint32_t base;
+  alignas(uint32_t) uint8_t window[kReadbufSize];
+  // Flash data for [staged_addr, staged_addr + kReadbufHalf), fetched at the
+  // watermark so a flip only needs a copy into the read buffer.
+  bool staged;
+  uint32_t staged_addr;
+  alignas(uint32_t) uint8_t staging[kReadbufHalf];
+  // A page program that has not yet been sent to the backend EEPROM. Later
+  // programs that continue it within the same page are merged into it.
+  size_t prog_len;
+  uint32_t prog_addr;
+  uint8_t prog_opcode;
+  bool prog_4b;
+  alignas(uint32_t) uint8_t prog[kPageSize];
+} readbuf_emulator_t;
+
+// Reads flash data from the backend EEPROM with a single quad read
+// transaction: `length` bytes from `address` into `buf`, followed by
+// `wrap_length` bytes into `wrap_buf`. The second receive segment lets a
+// range that wraps around the end of the read buffer be fetched in one go.
+// Unlike `spi_flash_testutils_read_op`, this is not limited to a page.
+static status_t bulk_read(dif_spi_host_t *spih, uint32_t address, uint8_t *buf,
+                          size_t length, uint8_t *wrap_buf,
+                          size_t wrap_length) {
+  bool addr_is_4b = address + length + wrap_length > kFlashAddr3bLimit;
+  dif_spi_host_segment_t transaction[] = {
+      {.type = kDifSpiHostSegmentTypeOpcode,
+       .opcode = {.opcode = kSpiDeviceFlashOpReadQuad,
+                  .width = kDifSpiHostWidthStandard}},
+      {
+          .type = kDifSpiHostSegmentTypeAddress,
+          .address =
+              {
+                  .width = kDifSpiHostWidthStandard,
+                  .mode = addr_is_4b ? kDifSpiHostAddrMode4b
+                                     : kDifSpiHostAddrMode3b,
+                  .address = address,
+              },
+      },
+      {
+          .type = kDifSpiHostSegmentTypeDummy,
+          .dummy =
+              {
+                  .width = kDifSpiHostWidthStandard,
+                  .length = 8,
+              },
+      },
+      {
+          .type = kDifSpiHostSegmentTypeRx,
+          .rx =
+              {
+                  .width = kDifSpiHostWidthQuad,
+                  .buf = buf,
+                  .length = length,
+              },
+      },
+      {
+          .type = kDifSpiHostSegmentTypeRx,
+          .rx =
+              {
+                  .width = kDifSpiHostWidthQuad,
+                  .buf = wrap_buf,
+                  .length = wrap_length,
+              },
+      },
+  };
+  size_t segments = ARRAYSIZE(transaction) - (wrap_length == 0 ? 1 : 0);
+  TRY(dif_spi_host_transaction(spih, /*csid=*/0, transaction, segments));
+  return OK_STATUS();
+}
+
+// Sends any pending page program to the backend EEPROM.
+static status_t flush_program(readbuf_emulator_t *emu) {
+  if (emu->prog_len == 0) {
+    return OK_STATUS();
+  }
+  TRY(spi_flash_testutils_program_op(emu->spih, emu->prog_opcode, emu->prog,
+                                     emu->prog_len, emu->prog_addr,
+                                     emu->prog_4b, kTransactionWidthMode111));
+  emu->prog_len = 0;
+  return OK_STATUS();
+}
+
+// Copies `length` bytes of `window` starting at flash address `address` into
+// the read buffer. The range must not wrap around the end of the buffer.
+static status_t publish_window(readbuf_emulator_t *emu, uint32_t address,
+                               size_t length) {
+  uint32_t offset = address % kReadbufSize;
+  TRY(dif_spi_device_write_flash_buffer(emu->spid,
+                                        kDifSpiDeviceFlashBufferTypeEFlash,
+                                        offset, length, &emu->window[offset]));
+  return OK_STATUS();
+}
+
+// Refills the whole read buffer from the backend, starting at the kilobyte
+// containing `address`.
+static status_t load_window(readbuf_emulator_t *emu, uint32_t address) {
+  TRY(flush_program(emu));
+  emu->base = address & ~(uint32_t)(kReadbufHalf - 1);
+  emu->staged = false;
+  uint32_t offset = emu->base % kReadbufSize;
+  size_t length = kReadbufSize - offset;
+  TRY(bulk_read(emu->spih, emu->base, &emu->window[offset], length,
+                emu->window, offset));
+  TRY(dif_spi_device_write_flash_buffer(emu->spid,
+                                        kDifSpiDeviceFlashBufferTypeEFlash, 0,
+                                        kReadbufSize, emu->window));
+  return OK_STATUS();
+}
+
+// Prefetches the kilobyte that replaces the current half after the next flip.
+static status_t prefetch_next(readbuf_emulator_t *emu) {
+  uint32_t next = emu->base + kReadbufSize;
+  if (emu->staged && emu->staged_addr == next) {
+    return OK_STATUS();
+  }
+  TRY(flush_program(emu));
+  TRY(bulk_read(emu->spih, next, emu->staging, kReadbufHalf, NULL, 0));
+  emu->staged = true;
+  emu->staged_addr = next;
+  return OK_STATUS();
+}
+
+// Moves the window after the host crossed into the other half of the read
+// buffer. A linear read refills the half the host just left with the kilobyte
+// after the one it is now reading; anything else reloads the whole window.
+static status_t advance_window(readbuf_emulator_t *emu) {
+  uint32_t address;
+  TRY(dif_spi_device_get_last_read_address(emu->spid, &address));
+  uint32_t half = address & ~(uint32_t)(kReadbufHalf - 1);
+  if (half == emu->base) {
+    return OK_STATUS();
+  }
+  if (half != emu->base + kReadbufHalf) {
+    return load_window(emu, address);
+  }
+  uint32_t next = half + kReadbufHalf;
+  uint32_t offset = next % kReadbufSize;
+  if (emu->staged && emu->staged_addr == next) {
+    memcpy(&emu->window[offset], emu->staging, kReadbufHalf);
+  } else {
+    TRY(flush_program(emu));
+    TRY(bulk_read(emu->spih, next, &emu->window[offset], kReadbufHalf, NULL,
+                  0));
+  }
+  emu->staged = false;
+  emu->base = half;
+  TRY(publish_window(emu, next, kReadbufHalf));
+  return OK_STATUS();
+}
+
+// Queues a page program, merging it into the pending one if it continues it
+// within the same page. The window and staging copies are updated right away
+// (programming can only clear bits) so the host reads back its own writes
+// before they reach the backend.
+static status_t queue_program(readbuf_emulator_t *emu,
+                              const upload_info_t *info) {
+  uint32_t page = info->address & ~(uint32_t)(kPageSize - 1);
+  if (info->address + info->data_len > page + kPageSize) {
+    // The program wraps around within the page; don't try to merge it.
+    TRY(flush_program(emu));
+    bool running = true;
+    TRY(execute_upload(emu->spih, info, &running));
+    return load_window(emu, emu->base);
+  }
+  bool contiguous = emu->prog_len != 0 && info->opcode == emu->prog_opcode &&
+                    info->address == emu->prog_addr + emu->prog_len &&
+                    page == (emu->prog_addr & ~(uint32_t)(kPageSize - 1));
+  if (!contiguous) {
+    TRY(flush_program(emu));
+    emu->prog_addr = info->address;
+    emu->prog_opcode = info->opcode;
+    emu->prog_4b =
+        info->opcode == kSpiDeviceFlashOpPageProgram4b || info->addr_4b;
+  }
+  memcpy(&emu->prog[emu->prog_len], info->data, info->data_len);
+  emu->prog_len += info->data_len;
+
+  bool in_window = false;
+  for (size_t i = 0; i < info->data_len; ++i) {
+    uint32_t address = info->address + i;
+    if (address - emu->base < kReadbufSize) {
+      emu->window[address % kReadbufSize] &= info->data[i];
+      in_window = true;
+    }
+    if (emu->staged && address - emu->staged_addr < kReadbufHalf) {
+      emu->staging[address - emu->staged_addr] &= info->data[i];
+    }
+  }
+  if (in_window) {
+    // A page never straddles the end of the read buffer, so the programmed
+    // range is contiguous in the buffer too.
+    TRY(publish_window(emu, page, kPageSize));
+  }
+  if (emu->prog_len == kPageSize) {
+    TRY(flush_program(emu));
+  }
+  return OK_STATUS();
+}
+
+status_t spi_flash_emulator_readbuf(dif_spi_host_t *spih,
+                                    dif_spi_device_handle_t *spid) {
+  // The state is too large for the stack.
+  static readbuf_emulator_t emu;
+  memset(&emu, 0, sizeof(emu));
+  emu.spih = spih;
+  emu.spid = spid;
+
+  LOG_INFO("Configuring spi_flash_emulator in read buffer mode.");
+  TRY(dif_spi_device_set_passthrough_mode(spid, kDifToggleDisabled));
+  TRY(prepare_backend(spih, spid));
+  TRY(dif_spi_device_reset_eflash_buffer(spid));
+  TRY(dif_spi_device_set_eflash_read_threshold(spid, kReadbufWatermark));
+  TRY(load_window(&emu, 0));
+  TRY(dif_spi_device_irq_acknowledge(&spid->dev, kDifSpiDeviceIrqReadbufFlip));
+  TRY(dif_spi_device_irq_acknowledge(&spid->dev,
+                                     kDifSpiDeviceIrqReadbufWatermark));
+  LOG_INFO("Starting spi_flash_emulator.");
+
+  bool running = true;
+  while (running) {
+    bool pending;
+    // Handle a flip before the watermark so that the prefetch is relative to
+    // the half the host is reading now.
+    TRY(dif_spi_device_irq_is_pending(&spid->dev, kDifSpiDeviceIrqReadbufFlip,
+                                      &pending));
+    if (pending) {
+      TRY(dif_spi_device_irq_acknowledge(&spid->dev,
+                                         kDifSpiDeviceIrqReadbufFlip));
+      TRY(advance_window(&emu));
+    }
+    TRY(dif_spi_device_irq_is_pending(
+        &spid->dev, kDifSpiDeviceIrqReadbufWatermark, &pending));
+    if (pending) {
+      TRY(dif_spi_device_irq_acknowledge(&spid->dev,
+                                         kDifSpiDeviceIrqReadbufWatermark));
+      TRY(prefetch_next(&emu));
+    }
+    TRY(dif_spi_device_irq_is_pending(
+        &spid->dev, kDifSpiDeviceIrqUploadCmdfifoNotEmpty, &pending));
+    if (!pending) {
+      continue;
+    }
+
+    upload_info_t info = {0};
+    TRY(spi_device_testutils_wait_for_upload(spid, &info));
     switch (info.opcode) {
-      case kSpiDeviceFlashOpChipErase:
-        TRY(spi_flash_testutils_erase_chip(spih));
-        break;
-      case kSpiDeviceFlashOpSectorErase:
-        TRY(spi_flash_testutils_erase_sector(spih, info.address, info.addr_4b));
-        break;
-      case kSpiDeviceFlashOpBlockErase32k:
-        TRY(spi_flash_testutils_erase_op(spih, kSpiDeviceFlashOpBlockErase32k,
-                                         info.address, info.addr_4b));
-        break;
-      case kSpiDeviceFlashOpBlockErase64k:
-        TRY(spi_flash_testutils_erase_op(spih, kSpiDeviceFlashOpBlockErase64k,
-                                         info.address, info.addr_4b));
-        break;
       case kSpiDeviceFlashOpPageProgram:
-        TRY(spi_flash_testutils_program_page(spih, info.data, info.data_len,
-                                             info.address, info.addr_4b));
-        break;
-      case kSpiDeviceFlashOpSectorErase4b:
-        TRY(spi_flash_testutils_erase_op(spih, kSpiDeviceFlashOpSectorErase4b,
-                                         info.address, /*addr_is_4b=*/true));
-        break;
-      case kSpiDeviceFlashOpBlockErase32k4b:
-        TRY(spi_flash_testutils_erase_op(spih, kSpiDeviceFlashOpBlockErase32k4b,
-                                         info.address, /*addr_is_4b=*/true));
-        break;
-      case kSpiDeviceFlashOpBlockErase64k4b:
-        TRY(spi_flash_testutils_erase_op(spih, kSpiDeviceFlashOpBlockErase64k4b,
-                                         info.address, /*addr_is_4b=*/true));
-        break;
       case kSpiDeviceFlashOpPageProgram4b:
-        TRY(spi_flash_testutils_program_op(
-            spih, kSpiDeviceFlashOpPageProgram4b, info.data, info.data_len,
-            info.address,
-            /*addr_is_4b=*/true, kTransactionWidthMode111));
-        break;
-      case kSpiDeviceFlashOpReset:
-        running = false;
+        TRY(queue_program(&emu, &info));
         break;
       default:
-        LOG_ERROR("Unknown SPI op: %02x", info.opcode);
+        TRY(flush_program(&emu));
+        TRY(execute_upload(spih, &info, &running));
+        if (running) {
+          // An erase may have changed any part of the window.
+          TRY(load_window(&emu, emu.base));
+        }
     }
-    TRY(dif_spi_device_set_passthrough_mode(spid, kDifToggleEnabled));
     TRY(dif_spi_device_set_flash_status_registers(spid, 0));
   }
+  TRY(flush_program(&emu));
   LOG_INFO("Exiting spi_flash_emulator.");
   return OK_STATUS();
 }
@@ -22,4 +22,25 @@
 status_t spi_flash_emulator(dif_spi_host_t *spih,
                             dif_spi_device_handle_t *spid);
 
+/**
+ * Emulate a SPI eeprom, serving reads from the spi_device read buffer.
+ *
+ * Unlike `spi_flash_emulator`, spi_device is kept in flash mode. The read
+ * buffer is kept filled ahead of the host's linear read pointer: the next
+ * kilobyte is prefetched from the backend eeprom when the host passes the
+ * read buffer watermark and copied in when the buffer flips. Reads that jump
+ * outside the buffered window reload it, so this mode is meant for hosts that
+ * read the flash sequentially. Sequential page programs are merged into a
+ * single program of the backend eeprom.
+ *
+ * spi_device must already be configured as for passthrough, e.g. with
+ * `spi_device_testutils_configure_passthrough`.
+ *
+ * @param spih A SPI host handle.
+ * @param spid A SPI device handle.
+ * @return A status.
+ */
+status_t spi_flash_emulator_readbuf(dif_spi_host_t *spih,
+                                    dif_spi_device_handle_t *spid);
+
 #endif  // OPENTITAN_SW_DEVICE_LIB_TESTING_SPI_FLASH_EMULATOR_H_
@@ -0,0 +1,289 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "sw/device/lib/testing/spi_host_engine.h"
+
+#include "sw/device/lib/base/bitfield.h"
+#include "sw/device/lib/base/memory.h"
+#include "sw/device/lib/base/mmio.h"
+
+#include "spi_host_regs.h"  // Generated.
+
+/**
+ * Returns the receive buffer and length of `segment`, if it receives data.
+ */
+static bool segment_rx(const dif_spi_host_segment_t *segment, uint8_t **buf,
+                       size_t *length) {
+  switch (segment->type) {
+    case kDifSpiHostSegmentTypeRx:
+      *buf = segment->rx.buf;
+      *length = segment->rx.length;
+      return true;
+    case kDifSpiHostSegmentTypeBidirectional:
+      *buf = segment->bidir.rxbuf;
+      *length = segment->bidir.length;
+      return true;
+    default:
+      return false;
+  }
+}
+
+/**
+ * Advances the RX cursor to the next segment which receives data.
+ */
+static void rx_skip(spi_host_engine_t *engine) {
+  uint8_t *buf;
+  size_t length;
+  while (engine->rx_index < engine->num_segments &&
+         !segment_rx(&engine->segments[engine->rx_index], &buf, &length)) {
+    ++engine->rx_index;
+  }
+}
+
+/**
+ * Writes up to `free` words of the pending TX data to the TX FIFO.
+ */
+static void tx_fill(spi_host_engine_t *engine, uint32_t free) {
+  mmio_region_t base = engine->spi_host->base_addr;
+  while (free > 0 && engine->tx_remaining > 0) {
+    if (engine->tx_remaining >= sizeof(uint32_t)) {
+      mmio_region_write32(base, SPI_HOST_TXDATA_REG_OFFSET,
+                          read_32(engine->tx_buf));
+      engine->tx_buf += sizeof(uint32_t);
+      engine->tx_remaining -= sizeof(uint32_t);
+    } else {
+      mmio_region_write8(base, SPI_HOST_TXDATA_REG_OFFSET, *engine->tx_buf);
+      engine->tx_buf += 1;
+      engine->tx_remaining -= 1;
+    }
+    --free;
+  }
+}
+
+/**
+ * Reads up to `words` words from the RX FIFO into the receiving segments.
+ *
+ * The hardware starts the data of each segment at a new word, so the unused
+ * bytes of the last word of a segment are discarded.
+ */
+static void rx_drain(spi_host_engine_t *engine, uint32_t words) {
+  mmio_region_t base = engine->spi_host->base_addr;
+  while (words > 0 && engine->rx_index < engine->num_segments) {
+    uint8_t *buf;
+    size_t length;
+    segment_rx(&engine->segments[engine->rx_index], &buf, &length);
+    uint32_t word = mmio_region_read32(base, SPI_HOST_RXDATA_REG_OFFSET);
+    --words;
+    size_t remaining = length - engine->rx_offset;
+    if (remaining >= sizeof(uint32_t)) {
+      write_32(word, buf + engine->rx_offset);
+      engine->rx_offset += sizeof(uint32_t);
+    } else {
+      memcpy(buf + engine->rx_offset, &word, remaining);
+      engine->rx_offset += remaining;
+    }
+    if (engine->rx_offset == length) {
+      ++engine->rx_index;
+      engine->rx_offset = 0;
+      rx_skip(engine);
+    }
+  }
+}
+
+/**
+ * Issues the command of the next segment, writing its opcode or address to the
+ * TX FIFO. The caller must check that the command queue is ready and that the
+ * TX FIFO has room for one word.
+ */
+static status_t issue_command(spi_host_engine_t *engine) {
+  const dif_spi_host_t *spi_host = engine->spi_host;
+  dif_spi_host_segment_t *segment = &engine->segments[engine->cmd_index];
+  bool last_segment = engine->cmd_index == engine->num_segments - 1;
+  ++engine->cmd_index;
+
+  switch (segment->type) {
+    case kDifSpiHostSegmentTypeOpcode:
+      mmio_region_write8(spi_host->base_addr, SPI_HOST_TXDATA_REG_OFFSET,
+                         segment->opcode.opcode);
+      TRY(dif_spi_host_write_command(spi_host, 1, segment->opcode.width,
+                                     kDifSpiHostDirectionTx, last_segment));
+      break;
+    case kDifSpiHostSegmentTypeAddress: {
+      // The address appears on the wire in big-endian order.
+      uint32_t address = bitfield_byteswap32(segment->address.address);
+      uint16_t length = 4;
+      if (segment->address.mode == kDifSpiHostAddrMode3b) {
+        length = 3;
+        address >>= 8;
+      }
+      mmio_region_write32(spi_host->base_addr, SPI_HOST_TXDATA_REG_OFFSET,
+                          address);
+      TRY(dif_spi_host_write_command(spi_host, length, segment->address.width,
+                                     kDifSpiHostDirectionTx, last_segment));
+      break;
+    }
+    case kDifSpiHostSegmentTypeDummy:
+      // As in the DIF, a zero-length dummy segment is not programmed, since
+      // the hardware would treat it as 512 cycles.
+      if (segment->dummy.length > 0) {
+        TRY(dif_spi_host_write_command(
+            spi_host, (uint16_t)segment->dummy.length, segment->dummy.width,
+            kDifSpiHostDirectionDummy, last_segment));
+      }
+      break;
+    case kDifSpiHostSegmentTypeTx:
+      TRY(dif_spi_host_write_command(spi_host, (uint16_t)segment->tx.length,
+                                     segment->tx.width, kDifSpiHostDirectionTx,
+                                     last_segment));
+      engine->tx_buf = segment->tx.buf;
+      engine->tx_remaining = segment->tx.length;
+      break;
+    case kDifSpiHostSegmentTypeRx:
+      TRY(dif_spi_host_write_command(spi_host, (uint16_t)segment->rx.length,
+                                     segment->rx.width, kDifSpiHostDirectionRx,
+                                     last_segment));
+      break;
+    case kDifSpiHostSegmentTypeBidirectional:
+      TRY(dif_spi_host_write_command(
+          spi_host, (uint16_t)segment->bidir.length, segment->bidir.width,
+          kDifSpiHostDirectionBidirectional, last_segment));
+      engine->tx_buf = segment->bidir.txbuf;
+      engine->tx_remaining = segment->bidir.length;
+      break;
+    default:
+      return INVALID_ARGUMENT();
+  }
+  return OK_STATUS();
+}
+
+/**
+ * Enables exactly the events in `events`.
+ */
+static status_t events_set(const spi_host_engine_t *engine,
+                           dif_spi_host_events_t events) {
+  TRY(dif_spi_host_event_set_enabled(engine->spi_host,
+                                     kDifSpiHostEvtAll & ~events, false));
+  if (events != 0) {
+    TRY(dif_spi_host_event_set_enabled(engine->spi_host, events, true));
+  }
+  return OK_STATUS();
+}
+
+status_t spi_host_engine_init(spi_host_engine_t *engine,
+                              const dif_spi_host_t *spi_host) {
+  if (engine == NULL || spi_host == NULL) {
+    return INVALID_ARGUMENT();
+  }
+  *engine = (spi_host_engine_t){.spi_host = spi_host};
+  return events_set(engine, 0);
+}
+
+status_t spi_host_engine_start(spi_host_engine_t *engine, uint32_t csid,
+                               dif_spi_host_segment_t *segments, size_t length,
+                               spi_host_engine_done_t done, void *ctx) {
+  if (engine == NULL || segments == NULL || length == 0) {
+    return INVALID_ARGUMENT();
+  }
+  if (engine->busy) {
+    return FAILED_PRECONDITION();
+  }
+  for (size_t i = 0; i < length; ++i) {
+    uint8_t *buf;
+    size_t data_length = 0;
+    switch (segments[i].type) {
+      case kDifSpiHostSegmentTypeOpcode:
+      case kDifSpiHostSegmentTypeAddress:
+        continue;
+      case kDifSpiHostSegmentTypeDummy:
+        if (segments[i].dummy.length > UINT16_MAX) {
+          return INVALID_ARGUMENT();
+        }
+        continue;
+      case kDifSpiHostSegmentTypeTx:
+        data_length = segments[i].tx.length;
+        break;
+      default:
+        if (!segment_rx(&segments[i], &buf, &data_length)) {
+          return INVALID_ARGUMENT();
+        }
+        break;
+    }
+    // `COMMAND.LEN` holds the length minus one.
+    if (data_length == 0 || data_length > UINT16_MAX) {
+      return INVALID_ARGUMENT();
+    }
+  }
+
+  *engine = (spi_host_engine_t){
+      .spi_host = engine->spi_host,
+      .segments = segments,
+      .num_segments = length,
+      .done = done,
+      .done_ctx = ctx,
+      .busy = true,
+  };
+  rx_skip(engine);
+  mmio_region_write32(engine->spi_host->base_addr, SPI_HOST_CSID_REG_OFFSET,
+                      csid);
+  return spi_host_engine_service(engine);
+}
+
+status_t spi_host_engine_service(spi_host_engine_t *engine) {
+  if (!engine->busy) {
+    return OK_STATUS();
+  }
+
+  dif_spi_host_status_t status;
+  bool progress;
+  do {
+    progress = false;
+    TRY(dif_spi_host_get_status(engine->spi_host, &status));
+    uint32_t tx_free = SPI_HOST_PARAM_TX_DEPTH - status.tx_queue_depth;
+    if (engine->tx_remaining > 0) {
+      if (tx_free > 0) {
+        tx_fill(engine, tx_free);
+        progress = true;
+      }
+    } else if (engine->cmd_index < engine->num_segments && status.ready &&
+               tx_free > 0) {
+      TRY(issue_command(engine));
+      progress = true;
+    }
+    if (engine->rx_index < engine->num_segments &&
+        status.rx_queue_depth > 0) {
+      rx_drain(engine, status.rx_queue_depth);
+      progress = true;
+    }
+  } while (progress);
+
+  bool issued = engine->cmd_index == engine->num_segments &&
+                engine->tx_remaining == 0;
+  bool received = engine->rx_index == engine->num_segments;
+  if (issued && received && !status.active && status.cmd_queue_depth == 0) {
+    TRY(events_set(engine, 0));
+    engine->busy = false;
+    if (engine->done != NULL) {
+      engine->done(engine->done_ctx);
+    }
+    return OK_STATUS();
+  }
+
+  // Wait only for the conditions which would let the engine make progress.
+  // The events are level-sensitive, so a condition which became true since
+  // the status was read raises the interrupt as soon as it is enabled.
+  dif_spi_host_events_t events = 0;
+  if (engine->tx_remaining > 0 ||
+      (engine->cmd_index < engine->num_segments && status.ready)) {
+    events |= kDifSpiHostEvtTxWm;
+  } else if (engine->cmd_index < engine->num_segments) {
+    events |= kDifSpiHostEvtReady;
+  }
+  if (!received) {
+    events |= kDifSpiHostEvtRxWm;
+  }
+  if (issued) {
+    events |= kDifSpiHostEvtIdle;
+  }
+  return events_set(engine, events);
+}
@@ -0,0 +1,137 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef OPENTITAN_SW_DEVICE_LIB_TESTING_SPI_HOST_ENGINE_H_
+#define OPENTITAN_SW_DEVICE_LIB_TESTING_SPI_HOST_ENGINE_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "sw/device/lib/base/status.h"
+#include "sw/device/lib/dif/dif_spi_host.h"
+
+/**
+ * Interrupt-driven SPI host transaction engine.
+ *
+ * `dif_spi_host_transaction()` busy-waits on the command, TX and RX queues for
+ * the whole transaction. The engine instead queues a chain of segments (the
+ * same `dif_spi_host_segment_t` descriptors the DIF takes) and moves the data
+ * from the `spi_event` interrupt: it issues commands while the command queue
+ * has room, tops up the TX FIFO when it drains below `tx_watermark`, empties
+ * the RX FIFO when it fills past `rx_watermark`, and calls a completion
+ * callback once the last segment has been received and the bus is idle.
+ *
+ * The engine only enables the individual `EVENT_ENABLE` conditions it is
+ * waiting for, so the (level-sensitive) `spi_event` interrupt does not fire
+ * while there is nothing to do. The caller is responsible for enabling the
+ * `spi_event` interrupt, routing it through the PLIC and calling
+ * `spi_host_engine_service()` from its ISR.
+ */
+
+/**
+ * Called once a transaction completes.
+ *
+ * @param ctx The context passed to `spi_host_engine_start()`.
+ */
+typedef void (*spi_host_engine_done_t)(void *ctx);
+
+typedef struct spi_host_engine {
+  /**
+   * The SPI host handle.
+   */
+  const dif_spi_host_t *spi_host;
+  /**
+   * The segments of the transaction in progress.
+   */
+  dif_spi_host_segment_t *segments;
+  size_t num_segments;
+  /**
+   * The next segment whose command is to be issued.
+   */
+  size_t cmd_index;
+  /**
+   * The TX data of the last issued segment still to be written to the TX FIFO.
+   * No further commands are issued until it has all been written, since the
+   * TX FIFO is consumed in command order.
+   */
+  const uint8_t *tx_buf;
+  size_t tx_remaining;
+  /**
+   * The next segment to receive data, and the offset within it.
+   */
+  size_t rx_index;
+  size_t rx_offset;
+  /**
+   * Completion callback and its context.
+   */
+  spi_host_engine_done_t done;
+  void *done_ctx;
+  /**
+   * Whether a transaction is in progress.
+   */
+  volatile bool busy;
+} spi_host_engine_t;
+
+/**
+ * Initializes the engine.
+ *
+ * The SPI host should already be configured, with its output enabled. Both
+ * `tx_watermark` and `rx_watermark` must be non-zero and no larger than the
+ * respective FIFO depth, or the engine would either never be woken up or be
+ * woken up continuously.
+ *
+ * @param engine The engine to initialize.
+ * @param spi_host A SPI host handle.
+ * @return The result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+status_t spi_host_engine_init(spi_host_engine_t *engine,
+                              const dif_spi_host_t *spi_host);
+
+/**
+ * Starts a transaction.
+ *
+ * Issues as much of the transaction as the hardware queues accept and returns;
+ * the rest is moved by `spi_host_engine_service()`. The segments and their
+ * buffers must remain valid until the transaction completes.
+ *
+ * @param engine The engine.
+ * @param csid The chip select line to assert.
+ * @param segments The segments of the transaction.
+ * @param length The number of segments.
+ * @param done Called (from the ISR) once the transaction completes; may be
+ * NULL.
+ * @param ctx Passed to `done`.
+ * @return The result of the operation; `kFailedPrecondition` if a transaction
+ * is already in progress.
+ */
+OT_WARN_UNUSED_RESULT
+status_t spi_host_engine_start(spi_host_engine_t *engine, uint32_t csid,
+                               dif_spi_host_segment_t *segments, size_t length,
+                               spi_host_engine_done_t done, void *ctx);
+
+/**
+ * Moves the data of the transaction in progress.
+ *
+ * Should be called from the ISR of the `spi_event` interrupt. Does nothing if
+ * no transaction is in progress.
+ *
+ * @param engine The engine.
+ * @return The result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+status_t spi_host_engine_service(spi_host_engine_t *engine);
+
+/**
+ * Returns whether a transaction is in progress.
+ *
+ * @param engine The engine.
+ * @return Whether a transaction is in progress.
+ */
+static inline bool spi_host_engine_is_busy(const spi_host_engine_t *engine) {
+  return engine->busy;
+}
+
+#endif  // OPENTITAN_SW_DEVICE_LIB_TESTING_SPI_HOST_ENGINE_H_
@@ -49,8 +49,8 @@ status_t sram_ctrl_testutils_scramble(const dif_sram_ctrl_t *sram_ctrl) {
   // inaccurate results due to clock period being zero. It should not be a
   // problem with the second version, as clock frequency won't be less than
   // 850. We add 1 microsecond to account for flooring.
-  uint32_t usec = (uint32_t)udiv64_slow(
-      1000000, udiv64_slow(kClockFreqCpuHz, 850, NULL) + 1, NULL);
+  uint32_t usec = (uint32_t)udiv64(
+      1000000, udiv64(kClockFreqCpuHz, 850, NULL) + 1, NULL);
 
   // Loop until new scrambling key has been obtained.
   LOG_INFO("Waiting for SRAM scrambling to finish");
@@ -62,8 +62,8 @@ status_t sram_ctrl_testutils_scramble(const dif_sram_ctrl_t *sram_ctrl) {
 status_t sram_ctrl_testutils_wipe(const dif_sram_ctrl_t *sram_ctrl) {
   CHECK_DIF_OK(dif_sram_ctrl_wipe(sram_ctrl));
   // The timeout calculation is the same as the scramble timeout.
-  uint32_t usec = (uint32_t)udiv64_slow(
-      1000000, udiv64_slow(kClockFreqCpuHz, 850, NULL) + 1, NULL);
+  uint32_t usec = (uint32_t)udiv64(
+      1000000, udiv64(kClockFreqCpuHz, 850, NULL) + 1, NULL);
   LOG_INFO("Waiting for SRAM wipe to finish");
   IBEX_SPIN_FOR(check_finished(sram_ctrl, kDifSramCtrlStatusInitDone), usec);
   return OK_STATUS();
@@ -80,7 +80,7 @@ void sysrst_ctrl_testutils_set_ec_rst_pulse_width(
     dif_sysrst_ctrl_t *sysrst_ctrl, uint32_t pulse_us) {
   // The register field counts in aon_clock ticks.
   uint64_t ticks =
-      udiv64_slow((uint64_t)pulse_us * kClockFreqAonHz, 1000 * 1000, NULL);
+      udiv64((uint64_t)pulse_us * kClockFreqAonHz, 1000 * 1000, NULL);
   // The register field is 16-bit wide.
   OT_ASSERT_ENUM_VALUE(SYSRST_CTRL_EC_RST_CTL_EC_RST_PULSE_OFFSET, 0);
   CHECK(ticks <= SYSRST_CTRL_EC_RST_CTL_EC_RST_PULSE_MASK);
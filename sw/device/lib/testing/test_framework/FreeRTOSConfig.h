@@ -44,6 +44,16 @@
 #define configUSE_TIME_SLICING 0
 #define configUSE_16_BIT_TICKS 0
 
+// Tickless idle: the idle task sleeps in `wfi` instead of spinning (see
+// `vPortSuppressTicksAndSleep()` in freertos_port.c).
+#define configUSE_TICKLESS_IDLE 2
+#ifndef __ASSEMBLER__
+#include <stdint.h>
+void vPortSuppressTicksAndSleep(uint32_t xExpectedIdleTime);
+#endif
+#define portSUPPRESS_TICKS_AND_SLEEP(xExpectedIdleTime) \
+  vPortSuppressTicksAndSleep(xExpectedIdleTime)
+
 // Software timers.
 #define configUSE_TIMERS 0
 
@@ -8,6 +8,9 @@
 /**
  * Sends the LLVM profile buffer along with its length and CRC32.
  *
+ * The buffer is run-length compressed and sent as base64 over the console; use
+ * `util/coverage/device_profile_data.py` to extract it from the device output.
+ *
  * This function must be called at the end of a test. Note that this profile
  * data is raw and must be indexed before it can be used to generate coverage
  * reports.
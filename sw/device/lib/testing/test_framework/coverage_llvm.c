@@ -23,12 +23,128 @@ int __llvm_profile_runtime;
  */
 static char buf[0x8000] = {0};
 
+enum {
+  /**
+   * Longest run of literal or zero bytes in one token of the compressed data.
+   */
+  kRunMax = 128,
+  /**
+   * Shortest run of zero bytes that is worth its own token.
+   */
+  kZeroRunMin = 3,
+  /**
+   * Bytes of compressed data per line; 57 bytes give 76 base64 characters.
+   */
+  kBytesPerLine = 57,
+};
+
+/**
+ * Base64 digits.
+ */
+static const char kBase64Digits[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+/**
+ * Buffers compressed data until there is a full line to send.
+ */
+typedef struct line_writer {
+  uint8_t data[kBytesPerLine];
+  size_t len;
+} line_writer_t;
+
+/**
+ * Sends the buffered bytes of `w` as a line of base64.
+ */
+static void line_flush(line_writer_t *w) {
+  char line[kBytesPerLine / 3 * 4 + 1];
+  size_t out = 0;
+  for (size_t i = 0; i < w->len; i += 3) {
+    size_t n = w->len - i < 3 ? w->len - i : 3;
+    uint32_t group = (uint32_t)w->data[i] << 16;
+    if (n > 1) {
+      group |= (uint32_t)w->data[i + 1] << 8;
+    }
+    if (n > 2) {
+      group |= w->data[i + 2];
+    }
+    for (size_t j = 0; j < 4; ++j) {
+      size_t digit = (group >> (18 - 6 * j)) & 0x3f;
+      line[out++] = j <= n ? kBase64Digits[digit] : '=';
+    }
+  }
+  line[out] = '\0';
+  if (out > 0) {
+    base_printf("%s\r\n", line);
+  }
+  w->len = 0;
+}
+
 /**
- * Sends the given buffer as a hex string over UART.
+ * Adds `len` bytes to the line being built, sending full lines.
+ */
+static void line_write(line_writer_t *w, const uint8_t *data, size_t len) {
+  for (size_t i = 0; i < len; ++i) {
+    w->data[w->len++] = data[i];
+    if (w->len == kBytesPerLine) {
+      line_flush(w);
+    }
+  }
+}
+
+/**
+ * Sends `len` literal bytes, split into tokens of at most `kRunMax` bytes.
+ */
+static void send_literals(line_writer_t *w, const uint8_t *data, size_t len) {
+  while (len > 0) {
+    size_t n = len < kRunMax ? len : kRunMax;
+    uint8_t token = (uint8_t)(n - 1);
+    line_write(w, &token, 1);
+    line_write(w, data, n);
+    data += n;
+    len -= n;
+  }
+}
+
+/**
+ * Sends the given buffer run-length compressed, as base64 over the console.
  *
- * Lines are limited to 80 characters. Longer buffers will be broken to multiple
- * lines.
+ * Most of a profile buffer is counters, and most counters are zero, so only
+ * runs of zero bytes are compressed. The compressed data is a sequence of
+ * tokens: a byte `t < 0x80` is followed by `t + 1` literal bytes and a byte
+ * `t >= 0x80` stands for `t - 0x7f` zero bytes. See
+ * `util/coverage/device_profile_data.py` for the decoder.
  */
+static void send_compressed(const uint8_t *data, size_t len) {
+  line_writer_t w = {.len = 0};
+  size_t lit_start = 0;
+  size_t i = 0;
+  while (i < len) {
+    if (data[i] != 0) {
+      ++i;
+      continue;
+    }
+    size_t zeros = 1;
+    while (i + zeros < len && data[i + zeros] == 0) {
+      ++zeros;
+    }
+    if (zeros < kZeroRunMin) {
+      i += zeros;
+      continue;
+    }
+    send_literals(&w, &data[lit_start], i - lit_start);
+    i += zeros;
+    lit_start = i;
+    while (zeros > 0) {
+      size_t n = zeros < kRunMax ? zeros : kRunMax;
+      uint8_t token = (uint8_t)(0x80 + n - 1);
+      line_write(&w, &token, 1);
+      zeros -= n;
+    }
+  }
+  send_literals(&w, &data[lit_start], len - lit_start);
+  line_flush(&w);
+}
+
 void coverage_send_buffer(void) {
   // It looks like we don't have a way to read the profile buffer incrementally.
   // Thus, we define the following buffer.
@@ -41,27 +157,12 @@ void coverage_send_buffer(void) {
   } else {
     size_t buf_size = (size_t)buf_size_u64;
     __llvm_profile_write_buffer(buf);
-    // Send the buffer along with its length and CRC32.
+    // Send the buffer along with its length and CRC32. The data lines are
+    // printed without the log prefix to keep them short.
     uint32_t checksum = crc32(buf, buf_size);
-    LOG_INFO("LLVM profile data (length: %u bytes, CRC32: 0x%08x):",
+    LOG_INFO("LLVM profile data (length: %u bytes, CRC32: 0x%08x, rle64):",
              (uint32_t)buf_size, checksum);
-    enum {
-      kBytesPerLine = 40,
-      // Print one less byte in the first line to account for "0x".
-      kBytesFirstLine = kBytesPerLine - 1,
-    };
-    size_t bytes_this_line =
-        buf_size < kBytesFirstLine ? buf_size : kBytesFirstLine;
-    char *read_ptr = (char *)buf + buf_size - bytes_this_line;
-    LOG_INFO("0x%!x", bytes_this_line, read_ptr);
-    buf_size -= bytes_this_line;
-    while (buf_size > 0) {
-      size_t bytes_this_line =
-          buf_size < kBytesPerLine ? buf_size : kBytesPerLine;
-      read_ptr -= bytes_this_line;
-      LOG_INFO("%!x", bytes_this_line, read_ptr);
-      buf_size -= bytes_this_line;
-    }
+    send_compressed((const uint8_t *)buf, buf_size);
   }
   // Send `EOT` so that `cat` can exit. Note that this requires enabling
   // `icanon` using `stty`.
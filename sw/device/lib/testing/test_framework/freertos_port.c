@@ -8,6 +8,7 @@
 #include "external/freertos/portable/GCC/RISC-V/portmacro.h"
 #include "sw/device/lib/base/macros.h"
 #include "sw/device/lib/dif/dif_rv_timer.h"
+#include "sw/device/lib/runtime/hart.h"
 #include "sw/device/lib/runtime/irq.h"
 #include "sw/device/lib/runtime/log.h"
 #include "sw/device/lib/testing/test_framework/FreeRTOSConfig.h"
@@ -81,6 +82,60 @@ void vPortSetupTimerInterrupt(void) {
 
 #endif  // configUSE_PREEMPTION
 
+// ----------------------------------------------------------------------------
+// Tickless Idle
+//
+// Called by the idle task, with the scheduler suspended, when no task is ready
+// to run. Only an interrupt can make a task ready, so the core sleeps until
+// one arrives instead of spinning in the idle loop.
+// ----------------------------------------------------------------------------
+void vPortSuppressTicksAndSleep(TickType_t xExpectedIdleTime) {
+  irq_global_ctrl(false);
+  // An interrupt that arrived since the idle task decided to sleep may have
+  // made a task ready.
+  if (eTaskConfirmSleepModeStatus() == eAbortSleep) {
+    irq_global_ctrl(true);
+    return;
+  }
+
+#if configUSE_PREEMPTION
+  // Stretch the current tick period to cover the expected idle time, so that
+  // the periodic tick does not wake the core up.
+  CHECK_DIF_OK(dif_rv_timer_counter_set_enabled(&timer, kTimerHartId,
+                                                kDifToggleDisabled));
+  CHECK_DIF_OK(dif_rv_timer_arm(&timer, kTimerHartId, kTimerComparatorId,
+                                kTimerDeadline * xExpectedIdleTime));
+  CHECK_DIF_OK(dif_rv_timer_counter_set_enabled(&timer, kTimerHartId,
+                                                kDifToggleEnabled));
+#endif  // configUSE_PREEMPTION
+
+  // `wfi` returns on a pending interrupt even though it is globally masked.
+  wait_for_interrupt();
+
+#if configUSE_PREEMPTION
+  // Account for the complete tick periods slept, and restore the periodic tick
+  // for the remainder of the current one. If the stretched period has expired,
+  // its interrupt is still pending and counts as the last tick.
+  CHECK_DIF_OK(dif_rv_timer_counter_set_enabled(&timer, kTimerHartId,
+                                                kDifToggleDisabled));
+  uint64_t count;
+  CHECK_DIF_OK(dif_rv_timer_counter_read(&timer, kTimerHartId, &count));
+  TickType_t slept = (TickType_t)(count / kTimerDeadline);
+  if (slept >= xExpectedIdleTime) {
+    slept = xExpectedIdleTime - 1;
+  }
+  vTaskStepTick(slept);
+  CHECK_DIF_OK(dif_rv_timer_counter_write(&timer, kTimerHartId,
+                                          count - slept * kTimerDeadline));
+  CHECK_DIF_OK(dif_rv_timer_arm(&timer, kTimerHartId, kTimerComparatorId,
+                                kTimerDeadline));
+  CHECK_DIF_OK(dif_rv_timer_counter_set_enabled(&timer, kTimerHartId,
+                                                kDifToggleEnabled));
+#endif  // configUSE_PREEMPTION
+
+  irq_global_ctrl(true);
+}
+
 // ----------------------------------------------------------------------------
 // Scheduler Setup
 // ----------------------------------------------------------------------------
@@ -4,9 +4,15 @@
 
 #include "sw/device/lib/testing/test_framework/ottf_console.h"
 
+#include <assert.h>
+#include <stdatomic.h>
 #include <stdbool.h>
 #include <stdint.h>
 
+#include "sw/device/lib/base/bitfield.h"
+#include "sw/device/lib/base/crc32.h"
+#include "sw/device/lib/base/csr.h"
+#include "sw/device/lib/base/memory.h"
 #include "sw/device/lib/base/mmio.h"
 #include "sw/device/lib/base/status.h"
 #include "sw/device/lib/dif/dif_rv_plic.h"
@@ -36,12 +42,37 @@ enum {
    * SPI device console configuration parameters.
    */
   kSpiDeviceRxCommitWait = 63,  // clock cycles
+  /**
+   * Framed SPI device console parameters. A host frame is a 32-bit length, the
+   * payload and a CRC32 of the payload, all little-endian.
+   */
+  kFrameHeaderSize = sizeof(uint32_t),
+  kFrameTrailerSize = sizeof(uint32_t),
+  kFrameRxMaxPayloadSize = 2048,  // bytes
+  kFrameTxBufferSize = 1024,      // bytes
   /**
    * Flow control parameters.
    */
   kFlowControlLowWatermark = 4,   // bytes
   kFlowControlHighWatermark = 8,  // bytes
   kFlowControlRxWatermark = kDifUartWatermarkByte8,
+  /**
+   * Console buffering parameters. The buffer sizes must be powers of two.
+   *
+   * The TX watermark IRQ refills the TX FIFO before it runs dry. With
+   * buffering, flow control pauses the host while the RX FIFO can still hold
+   * the bytes in flight, and resumes it once the RX buffer has been drained.
+   */
+  kTxBufferSize = 1024,  // bytes
+  kRxBufferSize = 256,   // bytes
+  kBufferingTxWatermark = kDifUartWatermarkByte16,
+  kBufferingPauseLevel = kRxBufferSize - 32,  // bytes
+  kBufferingResumeLevel = kRxBufferSize / 4,  // bytes
+  /**
+   * Interrupt enable bits in `mstatus` and `mie`.
+   */
+  kMstatusMieBit = 3,
+  kMieMeieBit = 11,
   /**
    * HART PLIC Target.
    */
@@ -62,6 +93,33 @@ static status_t (*getc)(void *);
 static volatile ottf_console_flow_control_t flow_control_state;
 static volatile uint32_t flow_control_irqs;
 
+static_assert((kTxBufferSize & (kTxBufferSize - 1)) == 0,
+              "kTxBufferSize must be a power of two");
+static_assert((kRxBufferSize & (kRxBufferSize - 1)) == 0,
+              "kRxBufferSize must be a power of two");
+
+// Console ring buffers used when `enable_uart_buffering` is set. `head` and
+// `tail` are free-running byte counters. One side of each ring runs in the
+// console ISR; the other runs in thread context with the corresponding UART
+// IRQ masked whenever it touches the FIFO.
+static bool buffering_enabled;
+static uint8_t tx_buffer[kTxBufferSize];
+static volatile size_t tx_head;
+static volatile size_t tx_tail;
+static uint8_t rx_buffer[kRxBufferSize];
+static volatile size_t rx_head;
+static volatile size_t rx_tail;
+
+// Framed SPI device console state. The received frame is kept in a word array
+// so that its payload, which follows the 32-bit length, is word-aligned.
+static uint32_t frame_rx[(kFrameHeaderSize + kFrameRxMaxPayloadSize +
+                          kFrameTrailerSize) /
+                         sizeof(uint32_t)];
+static size_t frame_rx_len;
+static size_t frame_rx_pos;
+static char frame_tx[kFrameTxBufferSize];
+static size_t frame_tx_len;
+
 void *ottf_console_get(void) {
   switch (kOttfTestConfig.console.type) {
     case kOttfConsoleSpiDevice:
@@ -79,6 +137,144 @@ static status_t uart_getc(void *io) {
   return OK_STATUS(byte);
 }
 
+static status_t manage_flow_control(const dif_uart_t *uart,
+                                    ottf_console_flow_control_t ctrl);
+
+/**
+ * Returns whether the console ISR can currently run on this hart.
+ */
+static bool console_irqs_enabled(void) {
+  uint32_t mstatus;
+  uint32_t mie;
+  CSR_READ(CSR_REG_MSTATUS, &mstatus);
+  CSR_READ(CSR_REG_MIE, &mie);
+  return bitfield_bit32_read(mstatus, kMstatusMieBit) &&
+         bitfield_bit32_read(mie, kMieMeieBit);
+}
+
+/**
+ * Moves as much buffered output as fits into the UART TX FIFO.
+ *
+ * The TX watermark IRQ is left enabled while output remains buffered.
+ */
+static void tx_buffer_drain(const dif_uart_t *uart) {
+  while (tx_tail != tx_head) {
+    size_t start = tx_tail & (kTxBufferSize - 1);
+    size_t len = tx_head - tx_tail;
+    if (len > kTxBufferSize - start) {
+      len = kTxBufferSize - start;
+    }
+    size_t written;
+    CHECK_DIF_OK(dif_uart_bytes_send(uart, &tx_buffer[start], len, &written));
+    if (written == 0) {
+      break;
+    }
+    tx_tail += written;
+  }
+  CHECK_DIF_OK(dif_uart_irq_set_enabled(
+      uart, kDifUartIrqTxWatermark,
+      tx_tail != tx_head ? kDifToggleEnabled : kDifToggleDisabled));
+}
+
+/**
+ * Drains the TX buffer from thread context.
+ */
+static void tx_buffer_kick(const dif_uart_t *uart) {
+  CHECK_DIF_OK(dif_uart_irq_set_enabled(uart, kDifUartIrqTxWatermark,
+                                        kDifToggleDisabled));
+  tx_buffer_drain(uart);
+}
+
+static void tx_buffer_flush(const dif_uart_t *uart) {
+  while (tx_tail != tx_head) {
+    tx_buffer_kick(uart);
+  }
+}
+
+static size_t uart_buffered_sink(void *io, const char *buf, size_t len) {
+  const dif_uart_t *uart = (const dif_uart_t *)io;
+  size_t i = 0;
+  while (i < len) {
+    size_t start = tx_head & (kTxBufferSize - 1);
+    size_t n = kTxBufferSize - (tx_head - tx_tail);
+    if (n > kTxBufferSize - start) {
+      n = kTxBufferSize - start;
+    }
+    if (n > len - i) {
+      n = len - i;
+    }
+    memcpy(&tx_buffer[start], &buf[i], n);
+    atomic_signal_fence(memory_order_release);
+    tx_head += n;
+    i += n;
+    // Start the transmission, or wait for room if the buffer is full.
+    tx_buffer_kick(uart);
+  }
+  if (!console_irqs_enabled()) {
+    // Nothing drains the buffer from interrupt context while printing from an
+    // ISR or a fault handler, or before interrupts are enabled.
+    tx_buffer_flush(uart);
+  }
+  return len;
+}
+
+/**
+ * Moves the contents of the UART RX FIFO into the RX buffer while it has room.
+ */
+static void rx_buffer_fill(const dif_uart_t *uart) {
+  while (rx_head - rx_tail < kRxBufferSize) {
+    size_t start = rx_head & (kRxBufferSize - 1);
+    size_t len = kRxBufferSize - (rx_head - rx_tail);
+    if (len > kRxBufferSize - start) {
+      len = kRxBufferSize - start;
+    }
+    size_t read;
+    CHECK_DIF_OK(dif_uart_bytes_receive(uart, len, &rx_buffer[start], &read));
+    atomic_signal_fence(memory_order_release);
+    rx_head += read;
+    if (read < len) {
+      break;
+    }
+  }
+}
+
+/**
+ * Keeps the RX watermark IRQ enabled while the RX buffer has room.
+ *
+ * The IRQ is status type, so it must stay disabled while the buffer is full
+ * and received bytes are left in the RX FIFO.
+ */
+static void rx_irq_update(const dif_uart_t *uart) {
+  CHECK_DIF_OK(dif_uart_irq_set_enabled(
+      uart, kDifUartIrqRxWatermark,
+      rx_head - rx_tail < kRxBufferSize ? kDifToggleEnabled
+                                        : kDifToggleDisabled));
+}
+
+static status_t uart_buffered_getc(void *io) {
+  const dif_uart_t *uart = (const dif_uart_t *)io;
+  while (true) {
+    // Keep the ISR out while this function moves data into the RX buffer and
+    // updates the flow control state.
+    CHECK_DIF_OK(dif_uart_irq_set_enabled(uart, kDifUartIrqRxWatermark,
+                                          kDifToggleDisabled));
+    bool available = rx_tail != rx_head;
+    uint8_t byte = 0;
+    if (available) {
+      byte = rx_buffer[rx_tail & (kRxBufferSize - 1)];
+      atomic_signal_fence(memory_order_acq_rel);
+      ++rx_tail;
+    }
+    rx_buffer_fill(uart);
+    status_t s = manage_flow_control(uart, kOttfConsoleFlowControlAuto);
+    rx_irq_update(uart);
+    TRY(s);
+    if (available) {
+      return OK_STATUS(byte);
+    }
+  }
+}
+
 /*
  * The user of this function needs to be aware of the following:
  * 1. The exact amount of data expected to be sent from the host side must be
@@ -100,6 +296,46 @@ static status_t spi_device_getc(void *io) {
   return OK_STATUS(info.data[index++]);
 }
 
+static void spi_device_frame_flush(dif_spi_device_handle_t *spi_device) {
+  if (frame_tx_len > 0) {
+    get_spi_device_crc_sink()(spi_device, frame_tx, frame_tx_len);
+    frame_tx_len = 0;
+  }
+}
+
+/**
+ * Collects console output into frames. A frame is sent when the buffer fills
+ * up, when a write ends a line, and before waiting for a frame from the host,
+ * so that each response goes out as few frames as possible.
+ */
+static size_t spi_device_framed_sink(void *io, const char *buf, size_t len) {
+  dif_spi_device_handle_t *spi_device = (dif_spi_device_handle_t *)io;
+  for (size_t i = 0; i < len; ++i) {
+    if (frame_tx_len == kFrameTxBufferSize) {
+      spi_device_frame_flush(spi_device);
+    }
+    frame_tx[frame_tx_len++] = buf[i];
+  }
+  if (len > 0 && buf[len - 1] == '\n') {
+    spi_device_frame_flush(spi_device);
+  }
+  return len;
+}
+
+/**
+ * Serves the payload of host frames one byte at a time, so that ujson commands
+ * can be carried in frames without changing their handlers.
+ */
+static status_t spi_device_framed_getc(void *io) {
+  OT_DISCARD(io);
+  while (frame_rx_pos == frame_rx_len) {
+    const uint8_t *payload;
+    size_t len;
+    TRY(ottf_console_spi_device_frame_recv(&payload, &len));
+  }
+  return OK_STATUS(((const uint8_t *)&frame_rx[1])[frame_rx_pos++]);
+}
+
 static void spi_device_wait_for_sync(dif_spi_device_handle_t *spi_device) {
   const uint8_t kBootMagicPattern[4] = {0x02, 0xb0, 0xfe, 0xca};
   const uint8_t kEmptyPattern[4] = {0};
@@ -134,14 +370,22 @@ void ottf_console_init(void) {
         base_addr = dt_uart_primary_reg_block(kDtUart0);
       }
 
-      ottf_console_configure_uart(base_addr);
+      // Set before configuring the UART, which may switch to buffered I/O.
       sink = get_uart_sink();
       getc = uart_getc;
+      ottf_console_configure_uart(base_addr);
       break;
     case (kOttfConsoleSpiDevice):
       ottf_console_configure_spi_device(base_addr);
-      sink = get_spi_device_sink();
-      getc = spi_device_getc;
+      if (kOttfTestConfig.console.framed) {
+        sink = spi_device_framed_sink;
+        getc = spi_device_framed_getc;
+        base_set_stdout((buffer_sink_t){.data = &ottf_console_spi_device,
+                                        .sink = &spi_device_framed_sink});
+      } else {
+        sink = get_spi_device_sink();
+        getc = spi_device_getc;
+      }
       break;
     default:
       CHECK(false, "unsupported OTTF console interface.");
@@ -166,6 +410,11 @@ void ottf_console_configure_uart(uintptr_t base_addr) {
                           }));
   base_uart_stdout(&ottf_console_uart);
 
+  // Initialize/Configure console buffering (if requested).
+  if (kOttfTestConfig.enable_uart_buffering) {
+    ottf_console_buffering_enable();
+  }
+
   // Initialize/Configure console flow control (if requested).
   if (kOttfTestConfig.enable_uart_flow_control) {
     ottf_console_flow_control_enable();
@@ -257,32 +506,35 @@ void ottf_console_configure_spi_device(uintptr_t base_addr) {
   base_spi_device_stdout(&ottf_console_spi_device);
 }
 
-static uint32_t get_flow_control_watermark_plic_id(void) {
+static uint32_t get_console_plic_id(dt_uart_irq_t irq) {
   for (size_t i = 0; i < kDtUartCount; i++) {
     dt_uart_t uart = (dt_uart_t)i;
     if (kOttfTestConfig.console.base_addr == dt_uart_primary_reg_block(uart)) {
-      return dt_uart_irq_to_plic_id(uart, kDtUartIrqRxWatermark);
+      return dt_uart_irq_to_plic_id(uart, irq);
     }
   }
-  return dt_uart_irq_to_plic_id(kDtUart0, kDtUartIrqRxWatermark);
+  return dt_uart_irq_to_plic_id(kDtUart0, irq);
 }
 
-void ottf_console_flow_control_enable(void) {
-  dif_uart_t *uart = (dif_uart_t *)ottf_console_get();
-  CHECK_DIF_OK(dif_uart_watermark_rx_set(uart, kFlowControlRxWatermark));
-  CHECK_DIF_OK(dif_uart_irq_set_enabled(uart, kDifUartIrqRxWatermark,
-                                        kDifToggleEnabled));
-
+static void console_plic_irq_enable(dt_uart_irq_t irq) {
+  uint32_t plic_id = get_console_plic_id(irq);
   // Set IRQ priorities to MAX
-  CHECK_DIF_OK(dif_rv_plic_irq_set_priority(
-      &ottf_plic, get_flow_control_watermark_plic_id(), kDifRvPlicMaxPriority));
+  CHECK_DIF_OK(
+      dif_rv_plic_irq_set_priority(&ottf_plic, plic_id, kDifRvPlicMaxPriority));
   // Set Ibex IRQ priority threshold level
   CHECK_DIF_OK(dif_rv_plic_target_set_threshold(&ottf_plic, kPlicTarget,
                                                 kDifRvPlicMinPriority));
   // Enable IRQs in PLIC
-  CHECK_DIF_OK(dif_rv_plic_irq_set_enabled(&ottf_plic,
-                                           get_flow_control_watermark_plic_id(),
-                                           kPlicTarget, kDifToggleEnabled));
+  CHECK_DIF_OK(dif_rv_plic_irq_set_enabled(&ottf_plic, plic_id, kPlicTarget,
+                                           kDifToggleEnabled));
+}
+
+void ottf_console_flow_control_enable(void) {
+  dif_uart_t *uart = (dif_uart_t *)ottf_console_get();
+  CHECK_DIF_OK(dif_uart_watermark_rx_set(uart, kFlowControlRxWatermark));
+  CHECK_DIF_OK(dif_uart_irq_set_enabled(uart, kDifUartIrqRxWatermark,
+                                        kDifToggleEnabled));
+  console_plic_irq_enable(kDtUartIrqRxWatermark);
 
   flow_control_state = kOttfConsoleFlowControlAuto;
   irq_global_ctrl(true);
@@ -292,6 +544,43 @@ void ottf_console_flow_control_enable(void) {
                             kOttfConsoleFlowControlResume);
 }
 
+void ottf_console_buffering_enable(void) {
+  dif_uart_t *uart = &ottf_console_uart;
+  if (buffering_enabled) {
+    tx_buffer_flush(uart);
+  }
+  CHECK_DIF_OK(dif_uart_irq_set_enabled(uart, kDifUartIrqTxWatermark,
+                                        kDifToggleDisabled));
+  tx_head = tx_tail = 0;
+  rx_head = rx_tail = 0;
+  CHECK_DIF_OK(dif_uart_watermark_tx_set(uart, kBufferingTxWatermark));
+  CHECK_DIF_OK(dif_uart_watermark_rx_set(uart, kFlowControlRxWatermark));
+  console_plic_irq_enable(kDtUartIrqTxWatermark);
+  console_plic_irq_enable(kDtUartIrqRxWatermark);
+
+  buffering_enabled = true;
+  sink = uart_buffered_sink;
+  getc = uart_buffered_getc;
+  base_set_stdout(
+      (buffer_sink_t){.data = (void *)uart, .sink = &uart_buffered_sink});
+  CHECK_DIF_OK(dif_uart_irq_set_enabled(uart, kDifUartIrqRxWatermark,
+                                        kDifToggleEnabled));
+  irq_global_ctrl(true);
+  irq_external_ctrl(true);
+}
+
+void ottf_console_flush(void) {
+  if (!buffering_enabled) {
+    return;
+  }
+  dif_uart_t *uart = &ottf_console_uart;
+  tx_buffer_flush(uart);
+  size_t avail = 0;
+  while (avail < kDifUartFifoSizeBytes) {
+    CHECK_DIF_OK(dif_uart_tx_bytes_available(uart, &avail));
+  }
+}
+
 // This version of the function is safe to call from within the ISR.
 static status_t manage_flow_control(const dif_uart_t *uart,
                                     ottf_console_flow_control_t ctrl) {
@@ -300,27 +589,46 @@ static status_t manage_flow_control(const dif_uart_t *uart,
   }
   if (ctrl == kOttfConsoleFlowControlAuto) {
     uint32_t avail;
-    TRY(dif_uart_rx_bytes_available(uart, &avail));
-    if (avail < kFlowControlLowWatermark &&
+    uint32_t low_watermark = kFlowControlLowWatermark;
+    uint32_t high_watermark = kFlowControlHighWatermark;
+    if (buffering_enabled) {
+      // The RX watermark IRQ is managed by the buffering code, which keeps the
+      // RX FIFO drained into the RX buffer, so track the buffer level instead.
+      avail = (uint32_t)(rx_head - rx_tail);
+      low_watermark = kBufferingResumeLevel;
+      high_watermark = kBufferingPauseLevel;
+    } else {
+      TRY(dif_uart_rx_bytes_available(uart, &avail));
+    }
+    if (avail < low_watermark &&
         flow_control_state != kOttfConsoleFlowControlResume) {
       // Enable RX watermark interrupt when RX FIFO level is below the
       // watermark.
-      CHECK_DIF_OK(dif_uart_irq_set_enabled(uart, kDifUartIrqRxWatermark,
-                                            kDifToggleEnabled));
+      if (!buffering_enabled) {
+        CHECK_DIF_OK(dif_uart_irq_set_enabled(uart, kDifUartIrqRxWatermark,
+                                              kDifToggleEnabled));
+      }
       ctrl = kOttfConsoleFlowControlResume;
-    } else if (avail >= kFlowControlHighWatermark &&
+    } else if (avail >= high_watermark &&
                flow_control_state != kOttfConsoleFlowControlPause) {
       ctrl = kOttfConsoleFlowControlPause;
       // RX watermark interrupt is status type, so disable the interrupt whilst
       // RX FIFO is above the watermark to avoid an inifite loop of ISRs.
-      CHECK_DIF_OK(dif_uart_irq_set_enabled(uart, kDifUartIrqRxWatermark,
-                                            kDifToggleDisabled));
+      if (!buffering_enabled) {
+        CHECK_DIF_OK(dif_uart_irq_set_enabled(uart, kDifUartIrqRxWatermark,
+                                              kDifToggleDisabled));
+      }
     } else {
       return OK_STATUS((int32_t)flow_control_state);
     }
   }
+  // The TX FIFO may be full of buffered console output, so wait for room
+  // instead of dropping the flow control character.
   uint8_t byte = (uint8_t)ctrl;
-  CHECK_DIF_OK(dif_uart_bytes_send(uart, &byte, 1, NULL));
+  size_t written = 0;
+  while (written == 0) {
+    CHECK_DIF_OK(dif_uart_bytes_send(uart, &byte, 1, &written));
+  }
   flow_control_state = ctrl;
   return OK_STATUS((int32_t)flow_control_state);
 }
@@ -328,14 +636,33 @@ static status_t manage_flow_control(const dif_uart_t *uart,
 bool ottf_console_flow_control_isr(uint32_t *exc_info) {
   dif_uart_t *uart = (dif_uart_t *)ottf_console_get();
   flow_control_irqs += 1;
+  bool handled = false;
+  if (buffering_enabled) {
+    bool tx;
+    dif_toggle_t tx_enabled;
+    CHECK_DIF_OK(dif_uart_irq_is_pending(uart, kDifUartIrqTxWatermark, &tx));
+    CHECK_DIF_OK(
+        dif_uart_irq_get_enabled(uart, kDifUartIrqTxWatermark, &tx_enabled));
+    if (tx && tx_enabled == kDifToggleEnabled) {
+      tx_buffer_drain(uart);
+      CHECK_DIF_OK(dif_uart_irq_acknowledge(uart, kDifUartIrqTxWatermark));
+      handled = true;
+    }
+  }
   bool rx;
   CHECK_DIF_OK(dif_uart_irq_is_pending(uart, kDifUartIrqRxWatermark, &rx));
   if (rx) {
+    if (buffering_enabled) {
+      rx_buffer_fill(uart);
+    }
     manage_flow_control(uart, kOttfConsoleFlowControlAuto);
+    if (buffering_enabled) {
+      rx_irq_update(uart);
+    }
     CHECK_DIF_OK(dif_uart_irq_acknowledge(uart, kDifUartIrqRxWatermark));
-    return true;
+    handled = true;
   }
-  return false;
+  return handled;
 }
 
 // The public API has to save and restore interrupts to avoid an
@@ -379,6 +706,41 @@ size_t ottf_console_spi_device_read(size_t buf_size, uint8_t *const buf) {
   return received_data_len;
 }
 
+status_t ottf_console_spi_device_frame_recv(const uint8_t **payload,
+                                             size_t *len) {
+  spi_device_frame_flush(&ottf_console_spi_device);
+  frame_rx_pos = 0;
+  frame_rx_len = 0;
+  size_t received =
+      ottf_console_spi_device_read(sizeof(frame_rx), (uint8_t *)frame_rx);
+  if (received < kFrameHeaderSize + kFrameTrailerSize ||
+      received > sizeof(frame_rx)) {
+    return OUT_OF_RANGE((int32_t)received);
+  }
+  uint32_t payload_len = frame_rx[0];
+  if (payload_len != received - kFrameHeaderSize - kFrameTrailerSize) {
+    return DATA_LOSS((int32_t)payload_len);
+  }
+  const uint8_t *data = (const uint8_t *)&frame_rx[1];
+  if (crc32(data, payload_len) != read_32(data + payload_len)) {
+    return DATA_LOSS(0);
+  }
+  frame_rx_len = payload_len;
+  *payload = data;
+  *len = payload_len;
+  return OK_STATUS((int32_t)payload_len);
+}
+
+status_t ottf_console_spi_device_frame_send(const uint8_t *buf, size_t len) {
+  spi_device_frame_flush(&ottf_console_spi_device);
+  size_t written = get_spi_device_crc_sink()(&ottf_console_spi_device,
+                                             (const char *)buf, len);
+  if (written != len) {
+    return DATA_LOSS((int32_t)(len - written));
+  }
+  return OK_STATUS((int32_t)len);
+}
+
 status_t ottf_console_putbuf(void *io, const char *buf, size_t len) {
   size_t written_len = sink(io, buf, len);
   if (len != written_len) {
@@ -78,13 +78,38 @@ status_t ottf_console_flow_control(const dif_uart_t *uart,
 void ottf_console_flow_control_enable(void);
 
 /**
- * Manage console flow control from interrupt context.
+ * Enable interrupt-driven buffering for the OTTF console.
+ *
+ * Console output is queued in a RAM buffer and moved to the UART TX FIFO by
+ * the TX watermark IRQ, so console writes only wait when the buffer is full.
+ * Console input is moved from the RX FIFO into a RAM buffer by the RX
+ * watermark IRQ. If flow control is also enabled, `Pause` and `Resume` are
+ * sent based on the fill level of the RX buffer instead of the RX FIFO.
+ *
+ * Output written while interrupts are disabled (e.g. from an ISR) is
+ * transmitted before the write returns.
+ *
+ * This function configures UART interrupts at the PLIC and enables interrupts
+ * at the CPU.
+ */
+void ottf_console_buffering_enable(void);
+
+/**
+ * Wait until all buffered OTTF console output has been transmitted.
+ *
+ * Tests using console buffering should call this before resetting the chip or
+ * reconfiguring the console UART. This is a no-op without buffering.
+ */
+void ottf_console_flush(void);
+
+/**
+ * Manage console flow control and buffering from interrupt context.
  *
  * Call this when a console UART interrupt triggers.
  *
  * @param exc_info The OTTF execution info passed to all ISRs.
- * @return True if an RX Watermark IRQ was detected and handled. False
- * otherwise.
+ * @return True if an RX Watermark IRQ, or a TX Watermark IRQ with buffering
+ * enabled, was detected and handled. False otherwise.
  */
 bool ottf_console_flow_control_isr(uint32_t *exc_info);
 
@@ -109,6 +134,37 @@ uint32_t ottf_console_get_flow_control_irqs(void);
  */
 size_t ottf_console_spi_device_read(size_t buf_size, uint8_t *const buf);
 
+/**
+ * Receive a frame from the host via the OTTF SPI device console.
+ *
+ * A host frame consists of the payload length as a 32-bit word, the payload
+ * and the CRC32 of the payload, all little-endian, and is uploaded the same way
+ * as data read by `ottf_console_spi_device_read()`. Any buffered console
+ * output is sent to the host before waiting for the frame.
+ *
+ * The payload is left in place in a word-aligned buffer owned by the console
+ * and stays valid until the next frame is received. With
+ * `kOttfTestConfig.console.framed` set, `ottf_console_getc()` also consumes the
+ * payload of the received frames, so ujson commands can be sent in frames.
+ *
+ * @param[out] payload Set to the start of the received payload.
+ * @param[out] len Set to the length of the received payload in bytes.
+ * @return The payload length, `kOutOfRange` if the frame does not fit in the
+ * receive buffer, or `kDataLoss` if its length or CRC32 is wrong.
+ */
+status_t ottf_console_spi_device_frame_recv(const uint8_t **payload,
+                                            size_t *len);
+
+/**
+ * Send a buffer to the host via the OTTF SPI device console in frames with a
+ * CRC32 trailer. Any buffered console output is sent first.
+ *
+ * @param buf The buffer to send.
+ * @param len The length of the buffer.
+ * @return The number of bytes sent or an error.
+ */
+status_t ottf_console_spi_device_frame_send(const uint8_t *buf, size_t len);
+
 /**
  * Write a buffer to the OTTF console.
  *
@@ -0,0 +1,67 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "sw/device/lib/base/status.h"
+#include "sw/device/lib/runtime/ibex.h"
+#include "sw/device/lib/runtime/print.h"
+#include "sw/device/lib/testing/test_framework/check.h"
+#include "sw/device/lib/testing/test_framework/ottf_console.h"
+#include "sw/device/lib/testing/test_framework/ottf_main.h"
+#include "sw/device/lib/testing/test_framework/ujson_ottf.h"
+#include "sw/device/lib/ujson/ujson.h"
+
+OTTF_DEFINE_TEST_CONFIG(.enable_uart_buffering = true,
+                        .enable_uart_flow_control = true);
+
+enum {
+  /**
+   * Number of lines queued at once. Together they fit in the console TX
+   * buffer, so the writes should not wait for the UART.
+   */
+  kLineCount = 12,
+};
+
+status_t ottf_console_buffer_test(ujson_t *uj) {
+  // Queue much more output than the UART TX FIFO holds and compare the time
+  // the CPU spends writing it with the time the UART needs to send it.
+  uint64_t start = ibex_mcycle_read();
+  for (size_t i = 0; i < kLineCount; ++i) {
+    base_printf("WAIT %02d: the quick brown fox jumps over the lazy dog\r\n",
+                (int)i);
+  }
+  uint64_t queued = ibex_mcycle_read() - start;
+  ottf_console_flush();
+  uint64_t drained = ibex_mcycle_read() - start;
+  base_printf("TIMING: queued=%u drained=%u cycles\r\n", (uint32_t)queued,
+              (uint32_t)drained);
+  CHECK(queued < drained / 4, "Console writes waited for the UART");
+
+  base_printf("Reading\r\n");
+  // Receive a line of text into a buffer.
+  uint8_t buf[256] = {0};
+  for (size_t i = 0; i < sizeof(buf) - 1; ++i) {
+    char ch = (char)TRY(ujson_getc(uj));
+    if (ch == '\n') {
+      break;
+    }
+    buf[i] = ch;
+  }
+
+  // The TX buffer must have been drained by the watermark interrupt.
+  CHECK(ottf_console_get_flow_control_irqs() > 0);
+
+  // Print out the received data so the test can check that it matches what was
+  // sent.
+  base_printf("RESULT:%s\r\n", buf);
+  return OK_STATUS();
+}
+
+bool test_main(void) {
+  ujson_t uj = ujson_ottf_console();
+  status_t status = ottf_console_buffer_test(&uj);
+  return status_ok(status);
+}
@@ -0,0 +1,130 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "sw/device/lib/testing/test_framework/ottf_executor.h"
+
+#include <stdatomic.h>
+
+#include "sw/device/lib/base/bitfield.h"
+#include "sw/device/lib/runtime/irq.h"
+#include "sw/device/lib/testing/test_framework/ottf_main.h"
+#include "sw/device/lib/testing/test_framework/ottf_test_config.h"
+#include "sw/device/lib/testing/test_framework/ottf_wait.h"
+
+// Incremented by every stage completion, so that the executor can tell whether
+// a completion happened between its last poll and going to sleep.
+static volatile uint32_t completions;
+
+extern uint32_t ottf_spsc_queue_size(const ottf_spsc_queue_t *queue);
+
+status_t ottf_spsc_queue_init(ottf_spsc_queue_t *queue, void **slots,
+                              uint32_t capacity) {
+  if (queue == NULL || slots == NULL || capacity == 0 ||
+      bitfield_popcount32(capacity) != 1) {
+    return INVALID_ARGUMENT();
+  }
+  *queue = (ottf_spsc_queue_t){.slots = slots, .capacity = capacity};
+  return OK_STATUS();
+}
+
+bool ottf_spsc_queue_push(ottf_spsc_queue_t *queue, void *job) {
+  uint32_t tail = queue->tail;
+  if (tail - queue->head == queue->capacity) {
+    return false;
+  }
+  queue->slots[tail & (queue->capacity - 1)] = job;
+  // Publish the job before the index which makes it visible to the consumer.
+  atomic_signal_fence(memory_order_release);
+  queue->tail = tail + 1;
+  return true;
+}
+
+bool ottf_spsc_queue_pop(ottf_spsc_queue_t *queue, void **job) {
+  uint32_t head = queue->head;
+  if (queue->tail == head) {
+    return false;
+  }
+  atomic_signal_fence(memory_order_acquire);
+  *job = queue->slots[head & (queue->capacity - 1)];
+  // Read the job before the index which hands the slot back to the producer.
+  atomic_signal_fence(memory_order_release);
+  queue->head = head + 1;
+  return true;
+}
+
+void ottf_stage_complete(ottf_stage_t *stage) {
+  void *job = stage->job;
+  if (job == NULL) {
+    return;
+  }
+  // Cannot fail: the executor reserved room for the job when starting it.
+  (void)ottf_spsc_queue_push(stage->output, job);
+  stage->completed = stage->completed + 1;
+  stage->job = NULL;
+  completions = completions + 1;
+}
+
+status_t ottf_executor_poll(const ottf_executor_t *executor) {
+  int32_t started = 0;
+  // Walk the pipeline from the end, so that room freed in a stage's output by
+  // the next stage is used in the same poll.
+  for (size_t i = executor->num_stages; i > 0; --i) {
+    ottf_stage_t *stage = executor->stages[i - 1];
+    if (stage->job != NULL ||
+        ottf_spsc_queue_size(stage->output) == stage->output->capacity) {
+      continue;
+    }
+    void *job;
+    if (!ottf_spsc_queue_pop(stage->input, &job)) {
+      continue;
+    }
+    stage->job = job;
+    ++started;
+    TRY(stage->start(stage, job));
+  }
+  return OK_STATUS(started);
+}
+
+static bool executor_idle(const ottf_executor_t *executor) {
+  for (size_t i = 0; i < executor->num_stages; ++i) {
+    const ottf_stage_t *stage = executor->stages[i];
+    if (stage->job != NULL || ottf_spsc_queue_size(stage->input) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+status_t ottf_executor_run_until_idle(const ottf_executor_t *executor,
+                                      uint32_t timeout_usec) {
+  const ottf_wait_t wait = ottf_wait_start(timeout_usec, 0);
+  status_t result = OK_STATUS();
+  while (true) {
+    uint32_t seen = completions;
+    status_t started = ottf_executor_poll(executor);
+    if (!status_ok(started)) {
+      result = started;
+      break;
+    }
+    if (executor_idle(executor)) {
+      break;
+    }
+    if (started.value > 0) {
+      continue;
+    }
+    if (kOttfTestConfig.enable_concurrency) {
+      ottf_task_yield();
+    }
+    irq_global_ctrl(false);
+    // Nothing to do until a stage completes, unless one already has.
+    if (completions == seen && !ottf_wait_sleep(&wait)) {
+      result = DEADLINE_EXCEEDED();
+      irq_global_ctrl(true);
+      break;
+    }
+    irq_global_ctrl(true);
+  }
+  ottf_wait_end(&wait);
+  return result;
+}
@@ -0,0 +1,167 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef OPENTITAN_SW_DEVICE_LIB_TESTING_TEST_FRAMEWORK_OTTF_EXECUTOR_H_
+#define OPENTITAN_SW_DEVICE_LIB_TESTING_TEST_FRAMEWORK_OTTF_EXECUTOR_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "sw/device/lib/base/macros.h"
+#include "sw/device/lib/base/status.h"
+
+/**
+ * Pipelined job executor for multi-peripheral tests.
+ *
+ * A pipeline is a chain of stages connected by single-producer,
+ * single-consumer queues of jobs. Each stage drives one hardware block: the
+ * executor hands it the next job from its input queue whenever it is idle,
+ * and the stage reports completion with `ottf_stage_complete()`, typically
+ * from the block's ISR, which moves the job to its output queue. Since every
+ * stage processes a job at a time, all blocks of the pipeline can be busy
+ * with consecutive jobs at once.
+ *
+ * Jobs are opaque pointers owned by the test, e.g. buffer descriptors.
+ */
+
+/**
+ * A lock-free single-producer, single-consumer queue of jobs.
+ *
+ * The producer and consumer may be an ISR and the code it interrupts.
+ */
+typedef struct ottf_spsc_queue {
+  /**
+   * Storage for `capacity` jobs; `capacity` must be a power of two.
+   */
+  void **slots;
+  uint32_t capacity;
+  /**
+   * Free-running indices of the next job to pop and push.
+   */
+  volatile uint32_t head;
+  volatile uint32_t tail;
+} ottf_spsc_queue_t;
+
+/**
+ * Initializes a queue.
+ *
+ * @param queue The queue.
+ * @param slots Storage for the jobs.
+ * @param capacity The number of `slots`, a power of two.
+ * @return The result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+status_t ottf_spsc_queue_init(ottf_spsc_queue_t *queue, void **slots,
+                              uint32_t capacity);
+
+/**
+ * Returns the number of jobs in a queue.
+ */
+OT_WARN_UNUSED_RESULT
+inline uint32_t ottf_spsc_queue_size(const ottf_spsc_queue_t *queue) {
+  return queue->tail - queue->head;
+}
+
+/**
+ * Pushes a job onto a queue; called by the producer only.
+ *
+ * @return False if the queue is full.
+ */
+OT_WARN_UNUSED_RESULT
+bool ottf_spsc_queue_push(ottf_spsc_queue_t *queue, void *job);
+
+/**
+ * Pops a job from a queue; called by the consumer only.
+ *
+ * @return False if the queue is empty.
+ */
+OT_WARN_UNUSED_RESULT
+bool ottf_spsc_queue_pop(ottf_spsc_queue_t *queue, void **job);
+
+typedef struct ottf_stage ottf_stage_t;
+
+/**
+ * Starts processing a job.
+ *
+ * Called by the executor when the stage is idle and has a job in its input
+ * queue. The stage must eventually call `ottf_stage_complete()`, either before
+ * returning or from an ISR.
+ *
+ * @param stage The stage.
+ * @param job The job.
+ * @return The result of the operation; an error stops the executor.
+ */
+typedef status_t (*ottf_stage_start_t)(ottf_stage_t *stage, void *job);
+
+struct ottf_stage {
+  /**
+   * Starts a job.
+   */
+  ottf_stage_start_t start;
+  /**
+   * Context for `start`.
+   */
+  void *ctx;
+  /**
+   * The queue the stage takes jobs from, and the queue it passes them on to.
+   * The output of a stage is the input of the next; the output of the last
+   * stage is drained by the test.
+   */
+  ottf_spsc_queue_t *input;
+  ottf_spsc_queue_t *output;
+  /**
+   * The job in progress, or NULL if the stage is idle.
+   */
+  void *volatile job;
+  /**
+   * The number of jobs the stage has completed.
+   */
+  volatile uint32_t completed;
+};
+
+/**
+ * Completes the job in progress of a stage and passes it on.
+ *
+ * May be called from an ISR. The executor only starts a job when the output
+ * queue has room for it, so this cannot fail.
+ *
+ * @param stage The stage.
+ */
+void ottf_stage_complete(ottf_stage_t *stage);
+
+typedef struct ottf_executor {
+  ottf_stage_t **stages;
+  size_t num_stages;
+} ottf_executor_t;
+
+/**
+ * Starts the next job of every idle stage which has one.
+ *
+ * @param executor The executor.
+ * @return The number of jobs started, or an error from a stage.
+ */
+OT_WARN_UNUSED_RESULT
+status_t ottf_executor_poll(const ottf_executor_t *executor);
+
+/**
+ * Runs the pipeline until all of its input queues are empty and all of its
+ * stages are idle.
+ *
+ * The output queue of the last stage is not drained while this runs, so it
+ * must have room for all the jobs still in the pipeline.
+ *
+ * Between polls, the core sleeps until a stage completes (see ottf_wait.h);
+ * when `enable_concurrency` is set, other tasks are given the chance to run
+ * first.
+ *
+ * @param executor The executor.
+ * @param timeout_usec The timeout in microseconds.
+ * @return The result of the operation; `kDeadlineExceeded` on timeout.
+ */
+OT_WARN_UNUSED_RESULT
+status_t ottf_executor_run_until_idle(const ottf_executor_t *executor,
+                                      uint32_t timeout_usec);
+
+#endif  // OPENTITAN_SW_DEVICE_LIB_TESTING_TEST_FRAMEWORK_OTTF_EXECUTOR_H_
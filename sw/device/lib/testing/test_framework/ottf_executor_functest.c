@@ -0,0 +1,132 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "sw/device/lib/base/macros.h"
+#include "sw/device/lib/base/status.h"
+#include "sw/device/lib/dif/dif_gpio.h"
+#include "sw/device/lib/runtime/irq.h"
+#include "sw/device/lib/runtime/log.h"
+#include "sw/device/lib/testing/test_framework/check.h"
+#include "sw/device/lib/testing/test_framework/ottf_executor.h"
+#include "sw/device/lib/testing/test_framework/ottf_isrs.h"
+#include "sw/device/lib/testing/test_framework/ottf_main.h"
+
+OTTF_DEFINE_TEST_CONFIG();
+
+// Runs jobs through a two-stage pipeline: the first stage completes its jobs
+// synchronously, the second from an interrupt (a forced GPIO IRQ stands in for
+// a peripheral finishing its work). The queue between the stages is much
+// smaller than the number of jobs, so that it wraps around many times.
+
+static const dt_gpio_t kGpioDt = kDtGpio;
+
+enum {
+  kNumJobs = 32,
+  kWords = 8,
+  kLinkCapacity = 2,
+  kTimeoutMicros = 100000,
+};
+
+typedef struct job {
+  uint32_t id;
+  uint32_t data[kWords];
+  uint32_t sum;
+} job_t;
+
+static dif_gpio_t gpio;
+static job_t jobs[kNumJobs];
+
+static void *source_slots[kNumJobs];
+static void *link_slots[kLinkCapacity];
+static void *sink_slots[kNumJobs];
+static ottf_spsc_queue_t source;
+static ottf_spsc_queue_t link;
+static ottf_spsc_queue_t sink;
+
+static status_t fill_start(ottf_stage_t *stage, void *job) {
+  job_t *j = job;
+  for (size_t i = 0; i < kWords; ++i) {
+    j->data[i] = j->id * kWords + i;
+  }
+  ottf_stage_complete(stage);
+  return OK_STATUS();
+}
+
+static status_t sum_start(ottf_stage_t *stage, void *job) {
+  TRY(dif_gpio_irq_force(&gpio, 0, true));
+  return OK_STATUS();
+}
+
+static ottf_stage_t fill_stage = {
+    .start = fill_start,
+    .input = &source,
+    .output = &link,
+};
+static ottf_stage_t sum_stage = {
+    .start = sum_start,
+    .input = &link,
+    .output = &sink,
+};
+
+// Plays the part of the peripheral doing the work of the second stage.
+static void sum_isr(uint32_t *exc_info, dif_rv_plic_irq_id_t plic_id,
+                    void *ctx) {
+  ottf_stage_t *stage = ctx;
+  job_t *j = stage->job;
+  j->sum = 0;
+  for (size_t i = 0; i < kWords; ++i) {
+    j->sum += j->data[i];
+  }
+  CHECK_DIF_OK(dif_gpio_irq_acknowledge(&gpio, 0));
+  ottf_stage_complete(stage);
+}
+
+static status_t pipeline_test(void) {
+  TRY(ottf_spsc_queue_init(&source, source_slots, ARRAYSIZE(source_slots)));
+  TRY(ottf_spsc_queue_init(&link, link_slots, ARRAYSIZE(link_slots)));
+  TRY(ottf_spsc_queue_init(&sink, sink_slots, ARRAYSIZE(sink_slots)));
+  for (uint32_t i = 0; i < kNumJobs; ++i) {
+    jobs[i] = (job_t){.id = i};
+    TRY_CHECK(ottf_spsc_queue_push(&source, &jobs[i]));
+  }
+
+  ottf_stage_t *stages[] = {&fill_stage, &sum_stage};
+  ottf_executor_t executor = {.stages = stages,
+                              .num_stages = ARRAYSIZE(stages)};
+  TRY(ottf_executor_run_until_idle(&executor, kTimeoutMicros));
+
+  TRY_CHECK(fill_stage.completed == kNumJobs);
+  TRY_CHECK(sum_stage.completed == kNumJobs);
+  TRY_CHECK(ottf_spsc_queue_size(&sink) == kNumJobs);
+  for (uint32_t i = 0; i < kNumJobs; ++i) {
+    void *job;
+    TRY_CHECK(ottf_spsc_queue_pop(&sink, &job));
+    job_t *j = job;
+    // Sum of `i * kWords + k` for k in [0, kWords).
+    uint32_t expected = i * kWords * kWords + kWords * (kWords - 1) / 2;
+    TRY_CHECK(j->id == i, "Job %u completed out of order", j->id);
+    TRY_CHECK(j->sum == expected, "Job %u: sum %u, expected %u", i, j->sum,
+              expected);
+  }
+  void *extra;
+  TRY_CHECK(!ottf_spsc_queue_pop(&sink, &extra));
+  return OK_STATUS();
+}
+
+bool test_main(void) {
+  CHECK_DIF_OK(dif_gpio_init_from_dt(kGpioDt, &gpio));
+  CHECK_DIF_OK(dif_gpio_irq_set_enabled(&gpio, 0, kDifToggleEnabled));
+  CHECK_STATUS_OK(ottf_irq_register(
+      dt_gpio_irq_to_plic_id(kGpioDt, kDtGpioIrqGpio0), /*priority=*/1,
+      /*preemptible=*/false, sum_isr, &sum_stage));
+  irq_global_ctrl(true);
+  irq_external_ctrl(true);
+
+  status_t result = OK_STATUS();
+  EXECUTE_TEST(result, pipeline_test);
+  return status_ok(result);
+}
@@ -0,0 +1,173 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "sw/device/lib/base/macros.h"
+#include "sw/device/lib/base/status.h"
+#include "sw/device/lib/dif/dif_gpio.h"
+#include "sw/device/lib/runtime/ibex.h"
+#include "sw/device/lib/runtime/irq.h"
+#include "sw/device/lib/runtime/log.h"
+#include "sw/device/lib/testing/test_framework/check.h"
+#include "sw/device/lib/testing/test_framework/ottf_isrs.h"
+#include "sw/device/lib/testing/test_framework/ottf_main.h"
+
+OTTF_DEFINE_TEST_CONFIG();
+
+// Measures the cycles from raising an IRQ to its handler running, through the
+// registered handler table and through `ottf_handle_irq()`, and checks that a
+// preemptible handler is preempted by a higher priority IRQ only.
+
+static const dt_gpio_t kGpioDt = kDtGpio;
+
+enum {
+  kIterations = 16,
+  kLowPriority = 1,
+  kHighPriority = 2,
+  kPreemptTimeoutMicros = 100,
+};
+
+static dif_gpio_t gpio;
+static dt_plic_irq_id_t gpio0_plic_id;
+static dt_plic_irq_id_t gpio1_plic_id;
+
+static volatile uint64_t handler_cycle;
+static volatile uint32_t handled_irqs;
+// Whether the IRQ of gpio1 was handled while the handler of gpio0 was running.
+static volatile bool gpio1_nested;
+
+static void gpio_irq_fire(dif_gpio_irq_t irq) {
+  CHECK_DIF_OK(dif_gpio_irq_force(&gpio, irq, true));
+}
+
+static void gpio_irq_done(dif_gpio_irq_t irq) {
+  CHECK_DIF_OK(dif_gpio_irq_acknowledge(&gpio, irq));
+  handled_irqs = handled_irqs + 1;
+}
+
+static void record_handler(uint32_t *exc_info, dif_rv_plic_irq_id_t plic_id,
+                           void *ctx) {
+  handler_cycle = ibex_mcycle_read();
+  gpio_irq_done((dif_gpio_irq_t)(uintptr_t)ctx);
+}
+
+// Fallback path, used while no handler is registered for the GPIO IRQs.
+bool ottf_handle_irq(uint32_t *exc_info, dt_instance_id_t devid,
+                     dif_rv_plic_irq_id_t plic_id) {
+  if (plic_id != gpio0_plic_id) {
+    return false;
+  }
+  handler_cycle = ibex_mcycle_read();
+  gpio_irq_done(0);
+  return true;
+}
+
+static void wait_for_irqs(uint32_t count) {
+  ATOMIC_WAIT_FOR_INTERRUPT(handled_irqs >= count);
+}
+
+/**
+ * Returns the mean number of cycles from forcing the IRQ of gpio0 to the
+ * handler running.
+ */
+static uint32_t measure_latency(void) {
+  uint64_t total = 0;
+  handled_irqs = 0;
+  for (uint32_t i = 0; i < kIterations; ++i) {
+    uint64_t start = ibex_mcycle_read();
+    gpio_irq_fire(0);
+    wait_for_irqs(i + 1);
+    total += handler_cycle - start;
+  }
+  return (uint32_t)(total / kIterations);
+}
+
+static status_t dispatch_latency_test(void) {
+  TRY(dif_rv_plic_irq_set_priority(&ottf_plic, gpio0_plic_id, kLowPriority));
+  TRY(dif_rv_plic_irq_set_enabled(&ottf_plic, gpio0_plic_id, 0,
+                                  kDifToggleEnabled));
+  uint32_t fallback = measure_latency();
+
+  TRY(ottf_irq_register(gpio0_plic_id, kLowPriority, /*preemptible=*/false,
+                        record_handler, (void *)0));
+  uint32_t registered = measure_latency();
+  TRY(ottf_irq_unregister(gpio0_plic_id));
+
+  LOG_INFO("IRQ dispatch: %u cycles registered, %u cycles ottf_handle_irq",
+           registered, fallback);
+  TRY_CHECK(registered <= fallback);
+  return OK_STATUS();
+}
+
+static void gpio1_handler(uint32_t *exc_info, dif_rv_plic_irq_id_t plic_id,
+                          void *ctx) {
+  gpio_irq_done(1);
+}
+
+// Raises the IRQ of gpio1 and gives it time to preempt this handler.
+static void gpio0_handler(uint32_t *exc_info, dif_rv_plic_irq_id_t plic_id,
+                          void *ctx) {
+  uint32_t before = handled_irqs;
+  gpio_irq_fire(1);
+  ibex_timeout_t timeout = ibex_timeout_init(kPreemptTimeoutMicros);
+  while (handled_irqs == before && !ibex_timeout_check(&timeout)) {
+  }
+  gpio1_nested = handled_irqs != before;
+  gpio_irq_done(0);
+}
+
+static status_t preemption_test(void) {
+  // A higher priority IRQ preempts a preemptible handler.
+  TRY(ottf_irq_register(gpio0_plic_id, kLowPriority, /*preemptible=*/true,
+                        gpio0_handler, NULL));
+  TRY(ottf_irq_register(gpio1_plic_id, kHighPriority, /*preemptible=*/false,
+                        gpio1_handler, NULL));
+  handled_irqs = 0;
+  gpio1_nested = false;
+  gpio_irq_fire(0);
+  wait_for_irqs(2);
+  TRY_CHECK(gpio1_nested, "gpio1 did not preempt the gpio0 handler");
+
+  // An equal priority IRQ waits for the handler to complete.
+  TRY(ottf_irq_register(gpio1_plic_id, kLowPriority, /*preemptible=*/false,
+                        gpio1_handler, NULL));
+  handled_irqs = 0;
+  gpio1_nested = true;
+  gpio_irq_fire(0);
+  wait_for_irqs(2);
+  TRY_CHECK(!gpio1_nested, "gpio1 preempted an equal priority handler");
+
+  // A handler which is not preemptible is never preempted.
+  TRY(ottf_irq_register(gpio0_plic_id, kLowPriority, /*preemptible=*/false,
+                        gpio0_handler, NULL));
+  TRY(ottf_irq_register(gpio1_plic_id, kHighPriority, /*preemptible=*/false,
+                        gpio1_handler, NULL));
+  handled_irqs = 0;
+  gpio1_nested = true;
+  gpio_irq_fire(0);
+  wait_for_irqs(2);
+  TRY_CHECK(!gpio1_nested, "gpio1 preempted a non-preemptible handler");
+
+  TRY(ottf_irq_unregister(gpio0_plic_id));
+  TRY(ottf_irq_unregister(gpio1_plic_id));
+  return OK_STATUS();
+}
+
+bool test_main(void) {
+  CHECK_DIF_OK(dif_gpio_init_from_dt(kGpioDt, &gpio));
+  gpio0_plic_id = dt_gpio_irq_to_plic_id(kGpioDt, kDtGpioIrqGpio0);
+  gpio1_plic_id = dt_gpio_irq_to_plic_id(kGpioDt, kDtGpioIrqGpio1);
+  CHECK_DIF_OK(dif_gpio_irq_set_enabled(&gpio, 0, kDifToggleEnabled));
+  CHECK_DIF_OK(dif_gpio_irq_set_enabled(&gpio, 1, kDifToggleEnabled));
+  CHECK_DIF_OK(dif_rv_plic_target_set_threshold(&ottf_plic, 0, 0));
+  irq_global_ctrl(true);
+  irq_external_ctrl(true);
+
+  status_t result = OK_STATUS();
+  EXECUTE_TEST(result, dispatch_latency_test);
+  EXECUTE_TEST(result, preemption_test);
+  return status_ok(result);
+}
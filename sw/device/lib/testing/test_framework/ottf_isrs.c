@@ -10,12 +10,34 @@
 #include "sw/device/lib/dif/dif_rv_plic.h"
 #include "sw/device/lib/runtime/hart.h"
 #include "sw/device/lib/runtime/ibex.h"
+#include "sw/device/lib/runtime/irq.h"
 #include "sw/device/lib/runtime/log.h"
 #include "sw/device/lib/runtime/print.h"
 #include "sw/device/lib/testing/test_framework/check.h"
+#include "sw/device/lib/testing/test_framework/ottf_test_config.h"
+
+#include "rv_plic_regs.h"  // Generated.
 
 dif_rv_plic_t ottf_plic;
 
+enum {
+  kOttfPlicTarget = 0,
+};
+
+typedef struct ottf_irq_entry {
+  ottf_irq_handler_t handler;
+  void *ctx;
+  uint32_t priority;
+  bool preemptible;
+} ottf_irq_entry_t;
+
+// Registered external IRQ handlers, indexed by PLIC IRQ ID.
+static ottf_irq_entry_t irq_table[RV_PLIC_PARAM_NUM_SRC];
+
+// The current PLIC threshold of the OTTF target, raised while a preemptible
+// handler runs.
+static uint32_t plic_threshold;
+
 // Fault reasons from
 // https://riscv.org/wp-content/uploads/2017/05/riscv-privileged-v1.10.pdf
 static const char *exception_reason[] = {
@@ -190,8 +212,15 @@ void ottf_software_isr(uint32_t *exc_info) {
   abort();
 }
 
+OT_WEAK
+bool ottf_wait_timer_isr(uint32_t *exc_info) { return false; }
+
 OT_WEAK
 void ottf_timer_isr(uint32_t *exc_info) {
+  // See if that interrupt was raised by a sleeping wait (see ottf_wait.h).
+  if (ottf_wait_timer_isr(exc_info)) {
+    return;
+  }
   ottf_generic_fault_print(exc_info, "Timer IRQ", ibex_mcause_read());
   abort();
 }
@@ -199,11 +228,78 @@ void ottf_timer_isr(uint32_t *exc_info) {
 OT_WEAK
 bool ottf_console_flow_control_isr(uint32_t *exc_info) { return false; }
 
+status_t ottf_irq_register(dif_rv_plic_irq_id_t plic_id, uint32_t priority,
+                           bool preemptible, ottf_irq_handler_t handler,
+                           void *ctx) {
+  if (plic_id == kDtPlicIrqIdNone || plic_id >= RV_PLIC_PARAM_NUM_SRC ||
+      priority == 0 || priority > kDifRvPlicMaxPriority || handler == NULL) {
+    return INVALID_ARGUMENT();
+  }
+  if (preemptible && kOttfTestConfig.enable_concurrency) {
+    return FAILED_PRECONDITION();
+  }
+  irq_table[plic_id] = (ottf_irq_entry_t){
+      .handler = handler,
+      .ctx = ctx,
+      .priority = priority,
+      .preemptible = preemptible,
+  };
+  TRY(dif_rv_plic_irq_set_priority(&ottf_plic, plic_id, priority));
+  TRY(dif_rv_plic_irq_set_enabled(&ottf_plic, plic_id, kOttfPlicTarget,
+                                  kDifToggleEnabled));
+  return OK_STATUS();
+}
+
+status_t ottf_irq_unregister(dif_rv_plic_irq_id_t plic_id) {
+  if (plic_id == kDtPlicIrqIdNone || plic_id >= RV_PLIC_PARAM_NUM_SRC) {
+    return INVALID_ARGUMENT();
+  }
+  TRY(dif_rv_plic_irq_set_enabled(&ottf_plic, plic_id, kOttfPlicTarget,
+                                  kDifToggleDisabled));
+  irq_table[plic_id] = (ottf_irq_entry_t){0};
+  return OK_STATUS();
+}
+
+/**
+ * Runs a registered handler, with interrupts enabled above its priority if it
+ * is preemptible.
+ *
+ * The trap entry code saves MEPC and MSTATUS on the stack, so a nested trap
+ * does not clobber the state needed to return from this one.
+ */
+static void dispatch_registered(uint32_t *exc_info,
+                                dif_rv_plic_irq_id_t plic_irq_id,
+                                const ottf_irq_entry_t *entry) {
+  if (!entry->preemptible) {
+    entry->handler(exc_info, plic_irq_id, entry->ctx);
+    return;
+  }
+  uint32_t threshold = plic_threshold;
+  plic_threshold = entry->priority;
+  CHECK_DIF_OK(dif_rv_plic_target_set_threshold(&ottf_plic, kOttfPlicTarget,
+                                                entry->priority));
+  irq_global_ctrl(true);
+  entry->handler(exc_info, plic_irq_id, entry->ctx);
+  irq_global_ctrl(false);
+  plic_threshold = threshold;
+  CHECK_DIF_OK(
+      dif_rv_plic_target_set_threshold(&ottf_plic, kOttfPlicTarget, threshold));
+}
+
 OT_WEAK
 void ottf_external_isr(uint32_t *exc_info) {
-  const uint32_t kPlicTarget = 0;
   dif_rv_plic_irq_id_t plic_irq_id;
-  CHECK_DIF_OK(dif_rv_plic_irq_claim(&ottf_plic, kPlicTarget, &plic_irq_id));
+  CHECK_DIF_OK(
+      dif_rv_plic_irq_claim(&ottf_plic, kOttfPlicTarget, &plic_irq_id));
+
+  // Registered handlers are dispatched directly from the table.
+  if (plic_irq_id < RV_PLIC_PARAM_NUM_SRC &&
+      irq_table[plic_irq_id].handler != NULL) {
+    dispatch_registered(exc_info, plic_irq_id, &irq_table[plic_irq_id]);
+    CHECK_DIF_OK(
+        dif_rv_plic_irq_complete(&ottf_plic, kOttfPlicTarget, plic_irq_id));
+    return;
+  }
 
   dt_instance_id_t devid = dt_plic_id_to_instance_id(plic_irq_id);
   // See if the test code wants to handle it.
@@ -212,7 +308,7 @@ void ottf_external_isr(uint32_t *exc_info) {
   if (handled || ottf_console_flow_control_isr(exc_info)) {
     // Complete the IRQ at PLIC.
     CHECK_DIF_OK(
-        dif_rv_plic_irq_complete(&ottf_plic, kPlicTarget, plic_irq_id));
+        dif_rv_plic_irq_complete(&ottf_plic, kOttfPlicTarget, plic_irq_id));
     return;
   }
 
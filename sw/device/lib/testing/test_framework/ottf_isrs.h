@@ -4,8 +4,10 @@
 
 #ifndef OPENTITAN_SW_DEVICE_LIB_TESTING_TEST_FRAMEWORK_OTTF_ISRS_H_
 #define OPENTITAN_SW_DEVICE_LIB_TESTING_TEST_FRAMEWORK_OTTF_ISRS_H_
+#include <stdbool.h>
 #include <stdint.h>
 
+#include "sw/device/lib/base/status.h"
 #include "sw/device/lib/dif/dif_rv_plic.h"
 
 /**
@@ -164,6 +166,54 @@ void ottf_external_isr(uint32_t *exc_info);
 bool ottf_handle_irq(uint32_t *exc_info, dt_instance_id_t inst_id,
                      dif_rv_plic_irq_id_t plic_id);
 
+/**
+ * Handler for an external IRQ registered with `ottf_irq_register()`.
+ *
+ * Called after `ottf_external_isr` has claimed the interrupt at the PLIC; the
+ * interrupt is completed at the PLIC when the handler returns.
+ *
+ * @param exc_info The saved context of the interrupted code.
+ * @param plic_id The PLIC IRQ ID being handled.
+ * @param ctx The context pointer passed to `ottf_irq_register()`.
+ */
+typedef void (*ottf_irq_handler_t)(uint32_t *exc_info,
+                                   dif_rv_plic_irq_id_t plic_id, void *ctx);
+
+/**
+ * Registers a handler for an external IRQ.
+ *
+ * `ottf_external_isr` looks registered handlers up in a table indexed by the
+ * PLIC IRQ ID, before falling back to `ottf_handle_irq` and the OTTF console,
+ * so interrupt-heavy tests do not pay for the DT instance lookup and a switch
+ * over the IRQ IDs on every interrupt.
+ *
+ * The IRQ is given `priority` and enabled at the PLIC. If `preemptible` is
+ * set, the handler runs with interrupts enabled and the PLIC threshold raised
+ * to `priority`, so that IRQs of a strictly higher priority preempt it. This
+ * is not supported when `enable_concurrency` is set, since the FreeRTOS trap
+ * handler keeps a single saved context per task.
+ *
+ * @param plic_id The PLIC IRQ ID to handle.
+ * @param priority The PLIC priority of the IRQ, greater than zero.
+ * @param preemptible Whether higher priority IRQs may preempt the handler.
+ * @param handler The handler.
+ * @param ctx Passed to `handler`.
+ * @return The result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+status_t ottf_irq_register(dif_rv_plic_irq_id_t plic_id, uint32_t priority,
+                           bool preemptible, ottf_irq_handler_t handler,
+                           void *ctx);
+
+/**
+ * Unregisters the handler of an external IRQ and disables it at the PLIC.
+ *
+ * @param plic_id The PLIC IRQ ID.
+ * @return The result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+status_t ottf_irq_unregister(dif_rv_plic_irq_id_t plic_id);
+
 /**
  * OTTF external NMI internal IRQ handler.
  *
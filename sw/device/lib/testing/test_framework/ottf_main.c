@@ -102,6 +102,8 @@ void status_report(status_t status) {
 }
 
 static void report_test_status(bool result) {
+  // The test harness looks for the final status messages as text.
+  base_log_set_binary(false);
   // Reinitialize UART before print any debug output if the test clobbered it.
   if (kDeviceType != kDeviceSimDV) {
     if (kOttfTestConfig.console.test_may_clobber) {
@@ -168,6 +170,9 @@ void _ottf_main(void) {
     if (!kOttfTestConfig.silence_console_prints) {
       LOG_INFO("Running %s", kOttfTestConfig.file);
     }
+    if (kOttfTestConfig.enable_binary_logs) {
+      base_log_set_binary(true);
+    }
   }
 
   // Initialize a global random number generator testutil context to provide
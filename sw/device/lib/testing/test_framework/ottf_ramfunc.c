@@ -0,0 +1,87 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "sw/device/lib/testing/test_framework/ottf_ramfunc.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "dt/dt_sram_ctrl.h"  // Generated
+#include "sw/device/lib/base/csr.h"
+#include "sw/device/lib/dif/dif_sram_ctrl.h"
+#include "sw/device/silicon_creator/lib/drivers/epmp.h"
+
+#define MODULE_ID MAKE_MODULE_ID('o', 'r', 'f')
+
+/**
+ * Bounds of the `OTTF_RAMFUNC` functions, from the OTTF linker script.
+ */
+extern char _ottf_ramfunc_start[];
+extern char _ottf_ramfunc_end[];
+
+enum {
+  /**
+   * The boot stages give read-write access to RAM through the last ePMP entry,
+   * which has the lowest priority.
+   */
+  kRamEpmpEntry = 15,
+};
+
+/**
+ * Get the configuration byte of an ePMP entry.
+ */
+static uint8_t pmpcfg_get(const uint32_t *pmpcfg, int entry) {
+  return (uint8_t)(pmpcfg[entry / 4] >> ((entry % 4) * 8));
+}
+
+/**
+ * Enable instruction fetches from the main SRAM.
+ */
+static status_t sram_exec_enable(void) {
+  dif_sram_ctrl_t sram_ctrl;
+  TRY(dif_sram_ctrl_init_from_dt(kDtSramCtrlMain, &sram_ctrl));
+  dif_result_t res =
+      dif_sram_ctrl_exec_set_enabled(&sram_ctrl, kDifToggleEnabled);
+  if (res == kDifLocked) {
+    // The register may have been locked after execution was enabled.
+    dif_toggle_t state;
+    TRY(dif_sram_ctrl_exec_get_enabled(&sram_ctrl, &state));
+    return state == kDifToggleEnabled ? OK_STATUS() : FAILED_PRECONDITION();
+  }
+  return INTO_STATUS(res);
+}
+
+status_t ottf_ramfunc_enable(void) {
+  epmp_region_t region = {
+      .start = (uintptr_t)_ottf_ramfunc_start,
+      .end = (uintptr_t)_ottf_ramfunc_end,
+  };
+  if (region.start == region.end) {
+    return OK_STATUS();
+  }
+
+  uint32_t pmpcfg[4];
+  CSR_READ(CSR_REG_PMPCFG0, &pmpcfg[0]);
+  CSR_READ(CSR_REG_PMPCFG1, &pmpcfg[1]);
+  CSR_READ(CSR_REG_PMPCFG2, &pmpcfg[2]);
+  CSR_READ(CSR_REG_PMPCFG3, &pmpcfg[3]);
+
+  // A TOR region needs two unused entries, and the entry after them must not
+  // be a TOR region since it uses the address of the second one as its base.
+  int entry = -1;
+  for (int i = kRamEpmpEntry - 2; i >= 0; --i) {
+    if (pmpcfg_get(pmpcfg, i) == 0 && pmpcfg_get(pmpcfg, i + 1) == 0 &&
+        (pmpcfg_get(pmpcfg, i + 2) & EPMP_CFG_A_MASK) != EPMP_CFG_A_TOR) {
+      entry = i;
+      break;
+    }
+  }
+  if (entry < 0) {
+    return RESOURCE_EXHAUSTED();
+  }
+
+  TRY(sram_exec_enable());
+  epmp_set_tor((uint8_t)entry, region, kEpmpPermLockedReadExecute);
+  return OK_STATUS();
+}
@@ -0,0 +1,51 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef OPENTITAN_SW_DEVICE_LIB_TESTING_TEST_FRAMEWORK_OTTF_RAMFUNC_H_
+#define OPENTITAN_SW_DEVICE_LIB_TESTING_TEST_FRAMEWORK_OTTF_RAMFUNC_H_
+
+#include "sw/device/lib/base/macros.h"
+#include "sw/device/lib/base/status.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/**
+ * Marks a function to be executed from main SRAM.
+ *
+ * The OTTF linker script places these functions in the `.data` section, so
+ * they are stored in flash and copied to SRAM by the OTTF startup code along
+ * with the rest of `.data`. Instruction fetches from SRAM have no flash wait
+ * states, which helps hot loops that don't fit in the ICache.
+ *
+ * `ottf_ramfunc_enable()` must be called before any such function is called.
+ *
+ * Example:
+ *   OTTF_RAMFUNC
+ *   static uint32_t hot_loop(const uint32_t *data, size_t len) { ... }
+ */
+#define OTTF_RAMFUNC OT_SECTION(".data.ottf_ramfunc") OT_NOINLINE
+
+/**
+ * Allow execution of the functions marked with `OTTF_RAMFUNC`.
+ *
+ * This enables instruction fetches in the main SRAM controller and configures
+ * a locked read-execute ePMP TOR region covering exactly those functions. The
+ * region uses the highest pair of unused ePMP entries below the RAM entry
+ * configured by the boot stages, so it takes priority over it. It does nothing
+ * if no functions are marked.
+ *
+ * @return The result of the operation: `kFailedPrecondition` if execution
+ * from SRAM is disabled and locked, `kResourceExhausted` if there are no free
+ * ePMP entries.
+ */
+OT_WARN_UNUSED_RESULT
+status_t ottf_ramfunc_enable(void);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // OPENTITAN_SW_DEVICE_LIB_TESTING_TEST_FRAMEWORK_OTTF_RAMFUNC_H_
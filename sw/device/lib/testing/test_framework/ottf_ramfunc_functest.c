@@ -0,0 +1,77 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "sw/device/lib/base/macros.h"
+#include "sw/device/lib/base/status.h"
+#include "sw/device/lib/runtime/ibex.h"
+#include "sw/device/lib/runtime/log.h"
+#include "sw/device/lib/testing/test_framework/check.h"
+#include "sw/device/lib/testing/test_framework/ottf_main.h"
+#include "sw/device/lib/testing/test_framework/ottf_ramfunc.h"
+
+OTTF_DEFINE_TEST_CONFIG();
+
+extern char _ottf_ramfunc_start[];
+extern char _ottf_ramfunc_end[];
+
+enum {
+  kIterations = 1000,
+};
+
+// The same loop is built in flash and in SRAM. It reports its own PC so the
+// test can check where it ran.
+#define DEFINE_LOOP(name_, attrs_)                             \
+  attrs_ static uint32_t name_(uint32_t seed, uint32_t *pc) {  \
+    asm volatile("auipc %0, 0" : "=r"(*pc));                   \
+    uint32_t acc = seed;                                       \
+    for (uint32_t i = 0; i < kIterations; ++i) {               \
+      acc = (acc << 5 | acc >> 27) ^ (acc + i);                \
+      asm volatile("" : "+r"(acc));                            \
+    }                                                          \
+    return acc;                                                \
+  }
+
+DEFINE_LOOP(flash_loop, OT_NOINLINE)
+DEFINE_LOOP(ram_loop, OTTF_RAMFUNC)
+
+static bool in_ramfunc_region(uint32_t pc) {
+  return pc >= (uintptr_t)_ottf_ramfunc_start &&
+         pc < (uintptr_t)_ottf_ramfunc_end;
+}
+
+static void log_counters(const char *where, const ibex_hpm_counters_t *start,
+                         const ibex_hpm_counters_t *end) {
+  LOG_INFO("%s: %u cycles, %u instruction fetch wait cycles", where,
+           (uint32_t)(end->cycles - start->cycles),
+           end->events[kIbexHpmEventInstrWait - kIbexHpmEventFirst] -
+               start->events[kIbexHpmEventInstrWait - kIbexHpmEventFirst]);
+}
+
+bool test_main(void) {
+  CHECK_STATUS_OK(ottf_ramfunc_enable());
+  ibex_hpm_configure(1u << kIbexHpmEventInstrWait);
+
+  ibex_hpm_counters_t start;
+  ibex_hpm_counters_t end;
+  uint32_t flash_pc;
+  uint32_t ram_pc;
+
+  ibex_hpm_read(&start);
+  uint32_t flash_result = flash_loop(0x1234, &flash_pc);
+  ibex_hpm_read(&end);
+  log_counters("flash", &start, &end);
+
+  ibex_hpm_read(&start);
+  uint32_t ram_result = ram_loop(0x1234, &ram_pc);
+  ibex_hpm_read(&end);
+  log_counters("sram", &start, &end);
+
+  CHECK(!in_ramfunc_region(flash_pc), "flash_loop ran from SRAM");
+  CHECK(in_ramfunc_region(ram_pc), "ram_loop ran from %x", ram_pc);
+  CHECK(flash_result == ram_result);
+  return true;
+}
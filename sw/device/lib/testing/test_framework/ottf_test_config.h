@@ -29,6 +29,12 @@ typedef struct ottf_console {
    * reconfigure it before printing the test status.
    */
   bool test_may_clobber;
+  /**
+   * Indicates that the SPI device console should exchange length-prefixed,
+   * CRC32-checked frames with the host instead of a raw byte stream (see
+   * `ottf_console_spi_device_frame_recv()`). Ignored for the UART console.
+   */
+  bool framed;
 } ottf_console_t;
 
 /**
@@ -73,6 +79,23 @@ typedef struct ottf_test_config {
    */
   bool enable_uart_flow_control;
 
+  /**
+   * Indicates that the OTTF console should buffer UART output and input in RAM
+   * and move it to and from the UART FIFOs from the TX and RX watermark
+   * interrupts, so that console writes return without waiting for the line.
+   * Like flow control, this unmasks the external interrupt and enables
+   * interrupt handling before `test_main` begins.
+   */
+  bool enable_uart_buffering;
+
+  /**
+   * Indicates that informational logs should be written as compact binary
+   * records once the test is running, leaving their formatting to the host
+   * (see `base_log_set_binary()`). The test status messages are still
+   * formatted on the device.
+   */
+  bool enable_binary_logs;
+
   /**
    * Indicates that this test needs an explicit clear of the RSTMGR reset_reason
    * register.  This may be necessary for tests that execute with the OTP
@@ -0,0 +1,89 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "sw/device/lib/testing/test_framework/ottf_wait.h"
+
+#include "dt/dt_rv_timer.h"
+#include "sw/device/lib/arch/device.h"
+#include "sw/device/lib/dif/dif_rv_timer.h"
+#include "sw/device/lib/runtime/hart.h"
+#include "sw/device/lib/runtime/irq.h"
+#include "sw/device/lib/testing/test_framework/check.h"
+
+enum {
+  kWaitHartId = 0,
+  kWaitComparatorId = 0,
+  // The counter runs at 1MHz, so that ticks are microseconds.
+  kWaitTickHz = 1000000,
+};
+
+static dif_rv_timer_t timer;
+static bool timer_initialized;
+
+static void timer_init(void) {
+  if (timer_initialized) {
+    return;
+  }
+  CHECK_DIF_OK(dif_rv_timer_init_from_dt(kDtRvTimer, &timer));
+  CHECK_DIF_OK(dif_rv_timer_reset(&timer));
+  dif_rv_timer_tick_params_t tick_params;
+  CHECK_DIF_OK(dif_rv_timer_approximate_tick_params(
+      kClockFreqPeripheralHz, kWaitTickHz, &tick_params));
+  CHECK_DIF_OK(dif_rv_timer_set_tick_params(&timer, kWaitHartId, tick_params));
+  CHECK_DIF_OK(dif_rv_timer_irq_set_enabled(
+      &timer, kDifRvTimerIrqTimerExpiredHart0Timer0, kDifToggleEnabled));
+  CHECK_DIF_OK(dif_rv_timer_counter_set_enabled(&timer, kWaitHartId,
+                                                kDifToggleEnabled));
+  irq_timer_ctrl(true);
+  timer_initialized = true;
+}
+
+static uint64_t timer_now(void) {
+  uint64_t now;
+  CHECK_DIF_OK(dif_rv_timer_counter_read(&timer, kWaitHartId, &now));
+  return now;
+}
+
+ottf_wait_t ottf_wait_start(uint32_t timeout_usec, uint32_t period_usec) {
+  timer_init();
+  return (ottf_wait_t){
+      .deadline = timer_now() + timeout_usec,
+      .period = period_usec,
+  };
+}
+
+bool ottf_wait_sleep(const ottf_wait_t *wait) {
+  uint64_t now = timer_now();
+  if (now >= wait->deadline) {
+    return false;
+  }
+  uint64_t wakeup = wait->deadline;
+  if (wait->period != 0 && now + wait->period < wakeup) {
+    wakeup = now + wait->period;
+  }
+  CHECK_DIF_OK(
+      dif_rv_timer_arm(&timer, kWaitHartId, kWaitComparatorId, wakeup));
+  wait_for_interrupt();
+  return true;
+}
+
+void ottf_wait_end(const ottf_wait_t *wait) {
+  CHECK_DIF_OK(
+      dif_rv_timer_arm(&timer, kWaitHartId, kWaitComparatorId, UINT64_MAX));
+  CHECK_DIF_OK(dif_rv_timer_irq_acknowledge(
+      &timer, kDifRvTimerIrqTimerExpiredHart0Timer0));
+}
+
+bool ottf_wait_timer_isr(uint32_t *exc_info) {
+  if (!timer_initialized) {
+    return false;
+  }
+  // Disarm the comparator before acknowledging, since the interrupt is raised
+  // again for as long as the counter is past the comparator.
+  CHECK_DIF_OK(
+      dif_rv_timer_arm(&timer, kWaitHartId, kWaitComparatorId, UINT64_MAX));
+  CHECK_DIF_OK(dif_rv_timer_irq_acknowledge(
+      &timer, kDifRvTimerIrqTimerExpiredHart0Timer0));
+  return true;
+}
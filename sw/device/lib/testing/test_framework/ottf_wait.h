@@ -0,0 +1,137 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef OPENTITAN_SW_DEVICE_LIB_TESTING_TEST_FRAMEWORK_OTTF_WAIT_H_
+#define OPENTITAN_SW_DEVICE_LIB_TESTING_TEST_FRAMEWORK_OTTF_WAIT_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "sw/device/lib/base/macros.h"
+#include "sw/device/lib/base/status.h"
+#include "sw/device/lib/runtime/irq.h"
+#include "sw/device/lib/testing/test_framework/check.h"
+
+/**
+ * Sleeping waits.
+ *
+ * `IBEX_SPIN_FOR` keeps the core busy polling until its condition holds. The
+ * waits below instead put the core to sleep with `wfi` between checks of the
+ * condition, and use comparator 0 of the hart 0 `rv_timer` to wake it up at
+ * the deadline or at the end of each polling period. The core is also woken up
+ * by any other enabled interrupt, so a condition that is set from an ISR is
+ * noticed straight away.
+ *
+ * The OTTF claims the `rv_timer` the first time one of these waits is used:
+ * tests which program the `rv_timer` themselves must not use them.
+ */
+
+typedef struct ottf_wait {
+  /**
+   * The `rv_timer` counter value at which the wait times out.
+   */
+  uint64_t deadline;
+  /**
+   * The number of counter ticks between checks of a condition that is not
+   * signalled by an interrupt, or zero to only wake up on interrupts.
+   */
+  uint64_t period;
+} ottf_wait_t;
+
+/**
+ * Starts a wait.
+ *
+ * @param timeout_usec The timeout of the wait, in microseconds.
+ * @param period_usec The interval at which to re-check the condition if no
+ * interrupt arrives, in microseconds, or zero to only check it after an
+ * interrupt.
+ * @return The wait.
+ */
+OT_WARN_UNUSED_RESULT
+ottf_wait_t ottf_wait_start(uint32_t timeout_usec, uint32_t period_usec);
+
+/**
+ * Sleeps until an interrupt or the next wake-up time of a wait.
+ *
+ * Must be called with interrupts globally disabled, right after checking the
+ * condition being waited for, so that an interrupt arriving in between still
+ * wakes the core (`wfi` returns on a pending interrupt even if it is globally
+ * masked). Interrupts are left disabled; the caller re-enables them to run the
+ * pending ISR.
+ *
+ * @param wait The wait.
+ * @return False if the deadline has passed.
+ */
+OT_WARN_UNUSED_RESULT
+bool ottf_wait_sleep(const ottf_wait_t *wait);
+
+/**
+ * Ends a wait, disarming its wake-up timer.
+ *
+ * @param wait The wait.
+ */
+void ottf_wait_end(const ottf_wait_t *wait);
+
+/**
+ * Handles the `rv_timer` interrupt raised by a wait.
+ *
+ * Called by the default `ottf_timer_isr`.
+ *
+ * @return Whether the interrupt was raised by a wait.
+ */
+bool ottf_wait_timer_isr(uint32_t *exc_info);
+
+/**
+ * Waits until `expr` is true, sleeping between checks.
+ *
+ * `expr` is re-checked after every interrupt, and every `period_usec` if that
+ * is non-zero.
+ *
+ * @param expr An expression that is evaluated multiple times until true.
+ * @param timeout_usec Timeout in microseconds.
+ * @param period_usec Polling period in microseconds, or zero.
+ * @return `kDeadlineExceeded` in case of timeout.
+ */
+#define OTTF_TRY_WFI_FOR(expr, timeout_usec, period_usec)                   \
+  do {                                                                      \
+    const ottf_wait_t wait_ = ottf_wait_start(timeout_usec, period_usec);   \
+    bool expired_ = false;                                                  \
+    while (true) {                                                          \
+      irq_global_ctrl(false);                                               \
+      if ((expr)) {                                                         \
+        break;                                                              \
+      }                                                                     \
+      if (!ottf_wait_sleep(&wait_)) {                                       \
+        expired_ = true;                                                    \
+        break;                                                              \
+      }                                                                     \
+      irq_global_ctrl(true);                                                \
+    }                                                                       \
+    irq_global_ctrl(true);                                                  \
+    ottf_wait_end(&wait_);                                                  \
+    if (expired_) {                                                         \
+      return DEADLINE_EXCEEDED();                                           \
+    }                                                                       \
+  } while (0)
+
+/**
+ * Same as `OTTF_TRY_WFI_FOR` above, but aborts on timeout.
+ */
+#define OTTF_WFI_FOR(expr, timeout_usec, period_usec)                       \
+  do {                                                                      \
+    const ottf_wait_t wait_ = ottf_wait_start(timeout_usec, period_usec);   \
+    while (true) {                                                          \
+      irq_global_ctrl(false);                                               \
+      if ((expr)) {                                                         \
+        break;                                                              \
+      }                                                                     \
+      CHECK(ottf_wait_sleep(&wait_), "Timed out after %d usec waiting for " \
+            #expr, (uint32_t)timeout_usec);                                 \
+      irq_global_ctrl(true);                                                \
+    }                                                                       \
+    irq_global_ctrl(true);                                                  \
+    ottf_wait_end(&wait_);                                                  \
+  } while (0)
+
+#endif  // OPENTITAN_SW_DEVICE_LIB_TESTING_TEST_FRAMEWORK_OTTF_WAIT_H_
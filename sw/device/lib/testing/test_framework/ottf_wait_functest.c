@@ -0,0 +1,67 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "sw/device/lib/base/status.h"
+#include "sw/device/lib/runtime/ibex.h"
+#include "sw/device/lib/runtime/log.h"
+#include "sw/device/lib/testing/test_framework/check.h"
+#include "sw/device/lib/testing/test_framework/ottf_main.h"
+#include "sw/device/lib/testing/test_framework/ottf_wait.h"
+
+OTTF_DEFINE_TEST_CONFIG();
+
+enum {
+  kTimeoutMicros = 1000,
+  kPeriodMicros = 100,
+  kPeriods = 5,
+};
+
+// Number of times the condition of a wait was evaluated.
+static uint32_t checks;
+
+static bool count_check(bool result) {
+  ++checks;
+  return result;
+}
+
+static status_t wait_for_never(void) {
+  OTTF_TRY_WFI_FOR(count_check(false), kTimeoutMicros, 0);
+  return OK_STATUS();
+}
+
+// A wait without a polling period sleeps until its deadline.
+static status_t timeout_test(void) {
+  checks = 0;
+  ibex_timeout_t timer = ibex_timeout_init(0);
+  status_t result = wait_for_never();
+  uint32_t elapsed = (uint32_t)ibex_timeout_elapsed(&timer);
+  LOG_INFO("Timed out after %u usec and %u checks", elapsed, checks);
+  TRY_CHECK(status_err(result) == kDeadlineExceeded);
+  TRY_CHECK(elapsed >= kTimeoutMicros);
+  // One check before sleeping, one after the deadline wake-up.
+  TRY_CHECK(checks <= 2, "The wait spun instead of sleeping");
+  return OK_STATUS();
+}
+
+// A wait with a polling period checks its condition once per period.
+static status_t period_test(void) {
+  checks = 0;
+  ibex_timeout_t timer = ibex_timeout_init(0);
+  OTTF_TRY_WFI_FOR(count_check(checks >= kPeriods), 10 * kTimeoutMicros,
+                   kPeriodMicros);
+  uint32_t elapsed = (uint32_t)ibex_timeout_elapsed(&timer);
+  LOG_INFO("Condition met after %u usec and %u checks", elapsed, checks);
+  TRY_CHECK(elapsed >= (kPeriods - 1) * kPeriodMicros);
+  return OK_STATUS();
+}
+
+bool test_main(void) {
+  status_t result = OK_STATUS();
+  EXECUTE_TEST(result, timeout_test);
+  EXECUTE_TEST(result, period_test);
+  return status_ok(result);
+}
@@ -32,6 +32,11 @@ void test_status_set(test_status_t test_status) {
   // emitting instructions as Ibex doesn't reorder memory accesses itself.
   atomic_signal_fence(memory_order_release);
 
+  // The test harness looks for the test status messages as text.
+  if (test_status == kTestStatusPassed || test_status == kTestStatusFailed) {
+    base_log_set_binary(false);
+  }
+
   switch (test_status) {
     case kTestStatusPassed: {
       LOG_INFO("PASS!");
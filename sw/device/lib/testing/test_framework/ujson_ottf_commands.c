@@ -24,6 +24,12 @@ status_t ujson_ottf_dispatch(ujson_t *uj, test_command_t command) {
     case kTestCommandMemWrite:
       RESP_ERR(uj, ujcmd_mem_write(uj));
       break;
+    case kTestCommandMemReadRange:
+      RESP_ERR(uj, ujcmd_mem_read_range(uj));
+      break;
+    case kTestCommandMemWriteRange:
+      RESP_ERR(uj, ujcmd_mem_write_range(uj));
+      break;
     default:
       return UNIMPLEMENTED();
   }
@@ -140,8 +140,16 @@ status_t usb_testutils_poll(usb_testutils_ctx_t *ctx) {
     }
   }
 
-  // Keep buffers available for packet reception
-  TRY(dif_usbdev_fill_available_fifos(ctx->dev, ctx->buffer_pool));
+  // Keep buffers available for packet reception. The Available Buffer FIFOs
+  // are only drained by packet reception, and buffers only return to the pool
+  // when packets are sent or received, so there is nothing to do otherwise;
+  // the FIFO-empty interrupts catch any buffers freed outside of this function
+  const dif_usbdev_irq_state_snapshot_t kIrqsRefill =
+      (1u << kDifUsbdevIrqPktReceived) | (1u << kDifUsbdevIrqPktSent) |
+      (1u << kDifUsbdevIrqAvSetupEmpty) | (1u << kDifUsbdevIrqAvOutEmpty);
+  if (istate & kIrqsRefill) {
+    TRY(dif_usbdev_fill_available_fifos(ctx->dev, ctx->buffer_pool));
+  }
 
   if (istate & (1u << kDifUsbdevIrqPktReceived)) {
     // TODO: we run the risk of starving the IN side here if the rx_callback(s)
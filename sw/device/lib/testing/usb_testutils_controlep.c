@@ -459,7 +459,7 @@ status_t usb_testutils_controlep_config_wait(
       // simply want to set the timeout in terms of clock cycles.
       uint64_t clk_cycles = 48 * timeout_usecs;
       timeout_usecs =
-          (uint32_t)udiv64_slow(clk_cycles * 1000000, kClockFreqCpuHz, NULL);
+          (uint32_t)udiv64(clk_cycles * 1000000, kClockFreqCpuHz, NULL);
     } break;
     default:
       // With an FGPA build the host software will respond more slowly and there
@@ -32,16 +32,17 @@
 static const enum {
   kReadMethodNone = 0u,  // Just discard the data; do not read it from usbdev
   kReadMethodStandard,   // Use standard dif_usbdev_buffer_read() function
-  kReadMethodFaster      // Faster implementation
-} read_method = kReadMethodStandard;
+  kReadMethodFaster      // Check the data in place in the packet buffer
+} read_method = USBUTILS_MEM_FASTER ? kReadMethodFaster : kReadMethodStandard;
 
 /**
  * Write method to be employed
  */
 static const enum {
   kWriteMethodStandard = 1u,  // Use standard dif_usbdev_buffer_write() function
-  kWriteMethodFaster          // Faster implementation
-} write_method = kWriteMethodStandard;
+  kWriteMethodFaster  // Generate the data in place in the packet buffer
+} write_method =
+    USBUTILS_MEM_FASTER ? kWriteMethodFaster : kWriteMethodStandard;
 
 /**
  * Diagnostic logging; expensive
@@ -235,6 +236,39 @@ static bool buffer_sig_check(usb_testutils_streams_ctx_t *ctx,
   return true;
 }
 
+#if USBUTILS_MEM_FASTER
+// Fill a buffer with LFSR-generated data, writing it directly to the packet
+// buffer memory instead of staging it in RAM first
+static void buffer_fill_in_place(usb_testutils_streams_ctx_t *ctx,
+                                 usbdev_stream_t *s, dif_usbdev_buffer_t *buf,
+                                 uint8_t num_bytes) {
+  const dif_usbdev_t *dev = ctx->usbdev->dev;
+  dif_usbdev_buffer_view_t view;
+  CHECK_DIF_OK(dif_usbdev_buffer_get_view(dev, buf, &view));
+  CHECK(num_bytes <= view.length);
+
+  if (s->generating) {
+    uint8_t lfsr = s->tx.lfsr;
+    // The packet buffer supports only 32-bit writes, so collect the bytes
+    // into words
+    for (size_t i = 0; i < num_bytes; i += sizeof(uint32_t)) {
+      uint32_t word = 0u;
+      for (size_t b = 0; b < sizeof(uint32_t) && i + b < num_bytes; b++) {
+        word |= (uint32_t)lfsr << (b * 8);
+        lfsr = LFSR_ADVANCE(lfsr);
+      }
+      mmio_region_write32(dev->base_addr, view.offset + (ptrdiff_t)i, word);
+    }
+
+    // Update the LFSR for the next packet
+    s->tx.lfsr = lfsr;
+  }
+
+  CHECK_DIF_OK(dif_usbdev_buffer_commit(dev, buf, num_bytes));
+  s->tx.bytes += num_bytes;
+}
+#endif
+
 // Fill a buffer with LFSR-generated data
 static void buffer_fill(usb_testutils_streams_ctx_t *ctx, usbdev_stream_t *s,
                         dif_usbdev_buffer_t *buf, uint8_t num_bytes) {
@@ -243,6 +277,14 @@ static void buffer_fill(usb_testutils_streams_ctx_t *ctx, usbdev_stream_t *s,
   CHECK(num_bytes <= buf->remaining_bytes);
   CHECK(num_bytes <= sizeof(data));
 
+#if USBUTILS_MEM_FASTER
+  // Traffic logging needs the data in RAM
+  if (write_method == kWriteMethodFaster && !(s->verbose && log_traffic)) {
+    buffer_fill_in_place(ctx, s, buf, num_bytes);
+    return;
+  }
+#endif
+
   if (s->generating) {
     // Emit LFSR-generated byte stream; keep this brief so that we can
     // reduce our latency in responding to USB events (usb_testutils employs
@@ -271,8 +313,7 @@ static void buffer_fill(usb_testutils_streams_ctx_t *ctx, usbdev_stream_t *s,
   switch (write_method) {
 #if USBUTILS_MEM_FASTER
     case kWriteMethodFaster:
-      // TODO: integrate faster transfers to/from USB device packet buffer
-      // memory.
+      // Only reached when logging traffic; see `buffer_fill_in_place()`
       OT_FALLTHROUGH_INTENDED;
 #endif
     default:
@@ -284,6 +325,86 @@ static void buffer_fill(usb_testutils_streams_ctx_t *ctx, usbdev_stream_t *s,
   s->tx.bytes += bytes_written;
 }
 
+#if USBUTILS_MEM_FASTER
+// Check the contents of a received buffer in place, reading the packet buffer
+// memory directly instead of copying the packet into RAM first
+static void buffer_check_in_place(usb_testutils_streams_ctx_t *ctx,
+                                  usbdev_stream_t *s,
+                                  dif_usbdev_rx_packet_info_t packet_info,
+                                  dif_usbdev_buffer_t buf) {
+  usb_testutils_ctx_t *usbdev = ctx->usbdev;
+  const mmio_region_t base = usbdev->dev->base_addr;
+  uint8_t len = packet_info.length;
+
+  dif_usbdev_buffer_view_t view;
+  CHECK_DIF_OK(dif_usbdev_buffer_get_view(usbdev->dev, &buf, &view));
+  CHECK(len <= view.length);
+
+  // Byte offset of LFSR-generated byte stream
+  size_t offset = 0U;
+
+  if (len > 0) {
+    switch (s->xfr_type) {
+      case kUsbTransferTypeIsochronous: {
+        // Only the signature is copied out of the packet buffer
+        uint32_t sig_words[sizeof(usbdev_stream_sig_t) / sizeof(uint32_t)];
+        for (size_t i = 0; i < ARRAYSIZE(sig_words); i++) {
+          sig_words[i] = mmio_region_read32(
+              base, view.offset + (ptrdiff_t)(i * sizeof(uint32_t)));
+        }
+        const usbdev_stream_sig_t *sig = (usbdev_stream_sig_t *)sig_words;
+        bool ok = buffer_sig_check(ctx, s, sig, len);
+        CHECK(ok, "S%u: Received packet invalid", s->id);
+
+        offset = sizeof(*sig);
+      }  // no break
+        OT_FALLTHROUGH_INTENDED;
+      case kUsbTransferTypeInterrupt:
+        OT_FALLTHROUGH_INTENDED;
+      case kUsbTransferTypeBulk: {
+        uint8_t rxtx_lfsr = s->rxtx_lfsr;
+        uint8_t rx_lfsr = s->rx_lfsr;
+
+        // The signature is a whole number of words, so `offset` is aligned
+        for (size_t i = offset; i < len; i += sizeof(uint32_t)) {
+          uint32_t word = mmio_region_read32(base, view.offset + (ptrdiff_t)i);
+          for (size_t b = 0; b < sizeof(uint32_t) && i + b < len; b++) {
+            // Received data should be the XOR of two LFSR-generated PRND
+            // streams - ours on the transmission side, and that of the DPI
+            // model
+            uint8_t expected = rxtx_lfsr ^ rx_lfsr;
+            uint8_t actual = (uint8_t)(word >> (b * 8));
+            CHECK(expected == actual,
+                  "S%u: Unexpected received data 0x%02x : (LFSRs 0x%02x "
+                  "0x%02x)",
+                  s->id, actual, rxtx_lfsr, rx_lfsr);
+
+            rxtx_lfsr = LFSR_ADVANCE(rxtx_lfsr);
+            rx_lfsr = LFSR_ADVANCE(rx_lfsr);
+          }
+        }
+
+        // Update the LFSRs for the next packet
+        s->rxtx_lfsr = rxtx_lfsr;
+        s->rx_lfsr = rx_lfsr;
+
+        // Update the count of LFSR bytes received
+        s->rx_bytes += len - offset;
+      } break;
+
+      default:
+        CHECK(s->xfr_type == kUsbTransferTypeControl);
+        break;
+    }
+  }
+
+  // Nothing was read through the DIF, so the buffer must be returned
+  // explicitly
+  CHECK_DIF_OK(
+      dif_usbdev_buffer_return(usbdev->dev, usbdev->buffer_pool, &buf));
+}
+#endif
+
 // Check the contents of a received buffer
 static void buffer_check(usb_testutils_streams_ctx_t *ctx, usbdev_stream_t *s,
                          dif_usbdev_rx_packet_info_t packet_info,
@@ -291,6 +412,14 @@ static void buffer_check(usb_testutils_streams_ctx_t *ctx, usbdev_stream_t *s,
   usb_testutils_ctx_t *usbdev = ctx->usbdev;
   uint8_t len = packet_info.length;
 
+#if USBUTILS_MEM_FASTER
+  // Traffic logging needs the data in RAM
+  if (read_method == kReadMethodFaster && !(s->verbose && log_traffic)) {
+    buffer_check_in_place(ctx, s, packet_info, buf);
+    return;
+  }
+#endif
+
   if (len > 0) {
     alignas(uint32_t) uint8_t data[USBDEV_MAX_PACKET_SIZE];
 
@@ -304,9 +433,8 @@ static void buffer_check(usb_testutils_streams_ctx_t *ctx, usbdev_stream_t *s,
     size_t bytes_read;
     switch (read_method) {
 #if USBUTILS_MEM_FASTER
-      // Faster read performance using custom routine
       case kReadMethodFaster:
-        // TODO: faster read method not yet integrated, defaulting to standard
+        // Only reached when logging traffic; see `buffer_check_in_place()`
         OT_FALLTHROUGH_INTENDED;
 #endif
       default:
@@ -455,10 +583,17 @@ static status_t strm_rx(void *cb_v, dif_usbdev_rx_packet_info_t packet_info,
 
       switch (read_method) {
 #if USBUTILS_MEM_FASTER
-        // Faster read performance using custom routine
-        case kReadMethodFaster:
-          // TODO: faster read method not yet integrated, defaulting to standard
-          OT_FALLTHROUGH_INTENDED;
+        case kReadMethodFaster: {
+          // Read the data in place, without copying it into RAM
+          dif_usbdev_buffer_view_t view;
+          TRY(dif_usbdev_buffer_get_view(usbdev->dev, &buf, &view));
+          for (size_t i = 0; i < len; i += sizeof(uint32_t)) {
+            (void)mmio_region_read32(usbdev->dev->base_addr,
+                                     view.offset + (ptrdiff_t)i);
+          }
+          TRY(dif_usbdev_buffer_return(usbdev->dev, usbdev->buffer_pool,
+                                       &buf));
+        } break;
 #endif
         //  Use the standard interface
         default:
@@ -22,13 +22,63 @@ ujson_t ujson_init(void *context, status_t (*getc)(void *),
   return u;
 }
 
-void ujson_crc32_reset(ujson_t *uj) { crc32_init(&uj->crc32); }
+// Adds the input consumed from the input buffer to the CRC32. The buffered
+// input is added in bulk rather than a character at a time.
+static void crc32_sync_input(ujson_t *uj) {
+  if (uj->in_crc != uj->in) {
+    crc32_add(&uj->crc32, uj->in_crc, (size_t)(uj->in - uj->in_crc));
+    uj->in_crc = uj->in;
+  }
+}
+
+void ujson_crc32_reset(ujson_t *uj) {
+  crc32_init(&uj->crc32);
+  uj->in_crc = uj->in;
+}
 
-uint32_t ujson_crc32_finish(ujson_t *uj) { return crc32_finish(&uj->crc32); }
+uint32_t ujson_crc32_finish(ujson_t *uj) {
+  crc32_sync_input(uj);
+  return crc32_finish(&uj->crc32);
+}
+
+void ujson_set_input(ujson_t *uj, const char *buf, size_t len) {
+  crc32_sync_input(uj);
+  uj->in = buf;
+  uj->in_end = buf + len;
+  uj->in_crc = buf;
+}
+
+status_t ujson_set_output(ujson_t *uj, char *buf, size_t size) {
+  TRY(ujson_flush(uj));
+  uj->out = buf;
+  uj->out_size = buf == NULL ? 0 : size;
+  return OK_STATUS();
+}
+
+status_t ujson_flush(ujson_t *uj) {
+  size_t len = uj->out_len;
+  if (len == 0) {
+    return OK_STATUS();
+  }
+  uj->out_len = 0;
+  TRY(uj->putbuf(uj->io_context, uj->out, len));
+  return OK_STATUS();
+}
 
 status_t ujson_putbuf(ujson_t *uj, const char *buf, size_t len) {
   crc32_add(&uj->crc32, buf, len);
-  return uj->putbuf(uj->io_context, buf, len);
+  if (uj->out == NULL) {
+    return uj->putbuf(uj->io_context, buf, len);
+  }
+  if (len > uj->out_size - uj->out_len) {
+    TRY(ujson_flush(uj));
+    if (len >= uj->out_size) {
+      return uj->putbuf(uj->io_context, buf, len);
+    }
+  }
+  memcpy(uj->out + uj->out_len, buf, len);
+  uj->out_len += len;
+  return OK_STATUS();
 }
 
 status_t ujson_getc(ujson_t *uj) {
@@ -36,13 +86,31 @@ status_t ujson_getc(ujson_t *uj) {
   if (buffer >= 0) {
     uj->buffer = -1;
     return OK_STATUS(buffer);
-  } else {
-    status_t s = uj->getc(uj->io_context);
-    if (!status_err(s)) {
-      crc32_add8(&uj->crc32, (uint8_t)s.value);
+  }
+  if (uj->in != NULL) {
+    if (uj->in < uj->in_end) {
+      return OK_STATUS((uint8_t)*uj->in++);
     }
-    return s;
+    // The input buffer is exhausted; continue with `getc`.
+    crc32_sync_input(uj);
+    uj->in = uj->in_end = uj->in_crc = NULL;
+  }
+  if (uj->getc == NULL) {
+    return RESOURCE_EXHAUSTED();
+  }
+  // The peer may be waiting for the output before it sends more input.
+  TRY(ujson_flush(uj));
+  status_t s = uj->getc(uj->io_context);
+  if (!status_err(s)) {
+    crc32_add8(&uj->crc32, (uint8_t)s.value);
   }
+  return s;
+}
+
+// Returns whether the input buffer can be read directly, i.e. there is no
+// character pushed back by `ujson_ungetc()`.
+static bool input_buffered(const ujson_t *uj) {
+  return uj->in != NULL && uj->buffer < 0;
 }
 
 status_t ujson_ungetc(ujson_t *uj, char ch) {
@@ -113,6 +181,20 @@ status_t ujson_parse_qs(ujson_t *uj, char *str, size_t len) {
   len--;  // One char for the nul terminator.
   TRY(ujson_consume(uj, '"'));
   while (true) {
+    if (input_buffered(uj)) {
+      // Copy the characters up to the next quote or escape sequence straight
+      // from the input buffer.
+      const char *p = uj->in;
+      while (p < uj->in_end && *p != '"' && *p != '\\') {
+        if (len > 0) {
+          *str++ = *p;
+          --len;
+          n++;
+        }
+        ++p;
+      }
+      uj->in = p;
+    }
     ch = (char)TRY(ujson_getc(uj));
     if (ch == '\"')
       break;
@@ -155,30 +237,93 @@ status_t ujson_parse_qs(ujson_t *uj, char *str, size_t len) {
   return OK_STATUS(n);
 }
 
+// Returns the value of the digit `ch` in `base` (10 or 16), or -1 if `ch` is
+// not a digit.
+static int digit_value(char ch, uint32_t base) {
+  if (ch >= '0' && ch <= '9') {
+    return ch - '0';
+  }
+  char lower = ch | 0x20;
+  if (base == 16 && lower >= 'a' && lower <= 'f') {
+    return lower - 'a' + 10;
+  }
+  return -1;
+}
+
+// Parses an integer directly from the input buffer. Returns false without
+// consuming any input if the integer is not followed by a terminator within
+// the buffer or is malformed, in which case the caller must fall back to
+// parsing a character at a time.
+static bool parse_integer_buffered(ujson_t *uj, uint64_t *value, bool *neg) {
+  const char *p = uj->in;
+  const char *end = uj->in_end;
+  while (p < end && is_space(*p)) {
+    ++p;
+  }
+  *neg = p < end && *p == '-';
+  if (*neg) {
+    ++p;
+  }
+  uint32_t base = 10;
+  if (end - p >= 2 && p[0] == '0' && (p[1] == 'x' || p[1] == 'X')) {
+    base = 16;
+    p += 2;
+  }
+  const char *digits = p;
+  uint64_t v = 0;
+  int digit;
+  while (p < end && (digit = digit_value(*p, base)) >= 0) {
+    v = v * base + (uint32_t)digit;
+    ++p;
+  }
+  if (p == digits || p == end) {
+    return false;
+  }
+  uj->in = p;
+  *value = v;
+  return true;
+}
+
 status_t ujson_parse_integer(ujson_t *uj, void *result, size_t rsz) {
-  char ch = (char)TRY(consume_whitespace(uj));
   bool neg = false;
-
-  if (ch == '-') {
-    neg = true;
-    ch = (char)TRY(ujson_getc(uj));
-  }
   uint64_t value = 0;
 
-  if (!(ch >= '0' && ch <= '9')) {
-    return NOT_FOUND();
-  }
-  status_t s;
-  while (ch >= '0' && ch <= '9') {
-    value *= 10;
-    value += ch - '0';
-    s = ujson_getc(uj);
-    if (status_err(s))
-      break;
-    ch = (char)s.value;
+  if (!input_buffered(uj) || !parse_integer_buffered(uj, &value, &neg)) {
+    char ch = (char)TRY(consume_whitespace(uj));
+    neg = false;
+    if (ch == '-') {
+      neg = true;
+      ch = (char)TRY(ujson_getc(uj));
+    }
+
+    uint32_t base = 10;
+    int digit = digit_value(ch, base);
+    if (digit < 0) {
+      return NOT_FOUND();
+    }
+    bool first = true;
+    status_t s;
+    while (true) {
+      value = value * base + (uint32_t)digit;
+      s = ujson_getc(uj);
+      if (status_err(s))
+        break;
+      ch = (char)s.value;
+      if (first && digit == 0 && (ch == 'x' || ch == 'X')) {
+        base = 16;
+        ch = (char)TRY(ujson_getc(uj));
+        if (digit_value(ch, base) < 0) {
+          return NOT_FOUND();
+        }
+      }
+      first = false;
+      digit = digit_value(ch, base);
+      if (digit < 0)
+        break;
+    }
+    if (status_ok(s))
+      TRY(ujson_ungetc(uj, ch));
   }
-  if (status_ok(s))
-    TRY(ujson_ungetc(uj, ch));
 
   if (neg) {
     if (value > (uint64_t)INT64_MAX + 1) {
@@ -25,6 +25,21 @@ typedef struct ujson {
   int16_t buffer;
   /** Holds the rolling CRC32 of characters that are sent and received.*/
   uint32_t crc32;
+  /**
+   * The unread part of the input buffer set by `ujson_set_input()`, or NULL
+   * when reading from `getc`.
+   */
+  const char *in;
+  const char *in_end;
+  /** Start of the consumed input not yet added to `crc32`. */
+  const char *in_crc;
+  /**
+   * The output buffer set by `ujson_set_output()`, or NULL when writing
+   * straight to `putbuf`.
+   */
+  char *out;
+  size_t out_size;
+  size_t out_len;
 } ujson_t;
 
 // clang-format off
@@ -49,6 +64,42 @@ typedef struct ujson {
 ujson_t ujson_init(void *context, status_t (*getc)(void *),
                    status_t (*putbuf)(void *, const char *, size_t));
 
+/**
+ * Parses from a contiguous input buffer.
+ *
+ * Characters are taken from `buf` until it is exhausted, after which the
+ * context reads from its `getc` function again (if any). Reading from a buffer
+ * avoids a `getc` call per character and lets integers and strings be parsed
+ * directly from memory. The buffer must remain valid while it is being read.
+ *
+ * @param uj A ujson IO context.
+ * @param buf The input to parse.
+ * @param len The length of the input.
+ */
+void ujson_set_input(ujson_t *uj, const char *buf, size_t len);
+
+/**
+ * Accumulates output in a buffer.
+ *
+ * Written data is collected in `buf` and passed to `putbuf` when the buffer
+ * fills up, when `ujson_flush()` is called, and before the context waits for
+ * input from `getc`. Writes that do not fit in the buffer are passed through.
+ *
+ * @param uj A ujson IO context.
+ * @param buf The buffer to collect output in, or NULL to write unbuffered.
+ * @param size The size of the buffer.
+ * @return OK or an error from flushing previously buffered output.
+ */
+status_t ujson_set_output(ujson_t *uj, char *buf, size_t size);
+
+/**
+ * Writes any buffered output to `putbuf`.
+ *
+ * @param uj A ujson IO context.
+ * @return OK or an error.
+ */
+status_t ujson_flush(ujson_t *uj);
+
 /**
  * Gets a single character from the input.
  *
@@ -147,6 +198,8 @@ status_t ujson_parse_qs(ujson_t *uj, char *str, size_t len);
 /**
  * Parse a JSON integer.
  *
+ * Both decimal and `0x`-prefixed hexadecimal integers are accepted.
+ *
  * @param uj A ujson IO context.
  * @param result: The parsed integer.
  * @param rsz: The size of the integer (in bytes).
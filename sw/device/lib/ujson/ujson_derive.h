@@ -91,9 +91,13 @@
     } \
     TRY(ujson_putbuf(uj, "]", 1));
 
+// Field names are C identifiers and need no escaping, so each key is written
+// with its quotes and colon as one string constant.
+#define ujson_ser_key(name_) \
+    TRY(ujson_putbuf(uj, "\"" #name_ "\":", sizeof("\"" #name_ "\":") - 1))
+
 #define ujson_ser_field(name_, type_, ...) { \
-        TRY(ujson_serialize_string(uj, #name_)); \
-        TRY(ujson_putbuf(uj, ":", 1)); \
+        ujson_ser_key(name_); \
         OT_IIF(OT_NOT(OT_VA_ARGS_COUNT(dummy, ##__VA_ARGS__))) \
         ( /*then*/ \
             TRY(ujson_serialize_##type_(uj, &self->name_)); \
@@ -106,8 +110,7 @@
     }
 
 #define ujson_ser_string(name_, size_, ...) { \
-        TRY(ujson_serialize_string(uj, #name_)); \
-        TRY(ujson_putbuf(uj, ":", 1)); \
+        ujson_ser_key(name_); \
         OT_IIF(OT_NOT(OT_VA_ARGS_COUNT(dummy, ##__VA_ARGS__))) \
         ( /*then*/ \
             TRY(ujson_serialize_string(uj, self->name_)); \
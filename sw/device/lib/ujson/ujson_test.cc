@@ -166,6 +166,115 @@ TEST(UJson, ParseIntegerError) {
   EXPECT_EQ(status_err(s), kOutOfRange);
 }
 
+TEST(UJson, ParseHexInteger) {
+  SourceSink ss("0x1F 0Xabcdef01 -0x10 0xz");
+  ujson uj = ss.UJson();
+  uint32_t u;
+  int32_t i;
+
+  EXPECT_EQ(status_err(ujson_parse_integer(&uj, (void *)&u, sizeof(u))), kOk);
+  EXPECT_EQ(u, 0x1f);
+  EXPECT_EQ(status_err(ujson_parse_integer(&uj, (void *)&u, sizeof(u))), kOk);
+  EXPECT_EQ(u, 0xabcdef01);
+  EXPECT_EQ(status_err(ujson_parse_integer(&uj, (void *)&i, sizeof(i))), kOk);
+  EXPECT_EQ(i, -16);
+  EXPECT_EQ(status_err(ujson_parse_integer(&uj, (void *)&u, sizeof(u))),
+            kNotFound);
+}
+
+TEST(UJson, BufferedInput) {
+  const std::string input = R"json([12, 0x34,-5 ] "a\tb" 678)json";
+  SourceSink ss(" 9");
+  ujson uj = ss.UJson();
+  ujson_set_input(&uj, input.data(), input.size());
+  int32_t values[3];
+  char buf[8];
+
+  EXPECT_EQ(status_err(ujson_consume(&uj, '[')), kOk);
+  for (size_t i = 0; i < 3; ++i) {
+    if (i) {
+      EXPECT_EQ(status_err(ujson_consume(&uj, ',')), kOk);
+    }
+    EXPECT_EQ(status_err(ujson_deserialize_int32_t(&uj, &values[i])), kOk);
+  }
+  EXPECT_EQ(status_err(ujson_consume(&uj, ']')), kOk);
+  EXPECT_EQ(values[0], 12);
+  EXPECT_EQ(values[1], 0x34);
+  EXPECT_EQ(values[2], -5);
+
+  status_t s = ujson_parse_qs(&uj, buf, sizeof(buf));
+  EXPECT_EQ(status_err(s), kOk);
+  EXPECT_EQ(std::string(buf), "a\tb");
+
+  // The integer runs to the end of the buffer, so parsing continues with
+  // `getc` once the buffer is exhausted.
+  uint32_t t;
+  EXPECT_EQ(status_err(ujson_deserialize_uint32_t(&uj, &t)), kOk);
+  EXPECT_EQ(t, 678);
+  EXPECT_EQ(status_err(ujson_deserialize_uint32_t(&uj, &t)), kOk);
+  EXPECT_EQ(t, 9);
+}
+
+TEST(UJson, BufferedInputCrc) {
+  const std::string input = R"json({"a": [1, 2, 3], "b": "xyz"} )json";
+  SourceSink ss(input);
+  ujson uj = ss.UJson();
+  char buf[8];
+  uint32_t t;
+
+  // Parse the same input with and without an input buffer.
+  uint32_t crc[2];
+  for (size_t pass = 0; pass < 2; ++pass) {
+    ss.Reset();
+    uj = ss.UJson();
+    if (pass) {
+      ujson_set_input(&uj, input.data(), input.size());
+    }
+    ujson_crc32_reset(&uj);
+    EXPECT_EQ(status_err(ujson_consume(&uj, '{')), kOk);
+    EXPECT_EQ(status_err(ujson_parse_qs(&uj, buf, sizeof(buf))), kOk);
+    EXPECT_EQ(status_err(ujson_consume(&uj, ':')), kOk);
+    EXPECT_EQ(status_err(ujson_consume(&uj, '[')), kOk);
+    for (size_t i = 0; i < 3; ++i) {
+      if (i) {
+        EXPECT_EQ(status_err(ujson_consume(&uj, ',')), kOk);
+      }
+      EXPECT_EQ(status_err(ujson_deserialize_uint32_t(&uj, &t)), kOk);
+    }
+    EXPECT_EQ(status_err(ujson_consume(&uj, ']')), kOk);
+    EXPECT_EQ(status_err(ujson_consume(&uj, ',')), kOk);
+    EXPECT_EQ(status_err(ujson_parse_qs(&uj, buf, sizeof(buf))), kOk);
+    EXPECT_EQ(status_err(ujson_consume(&uj, ':')), kOk);
+    EXPECT_EQ(status_err(ujson_parse_qs(&uj, buf, sizeof(buf))), kOk);
+    EXPECT_EQ(status_err(ujson_consume(&uj, '}')), kOk);
+    crc[pass] = ujson_crc32_finish(&uj);
+  }
+  EXPECT_EQ(crc[0], crc[1]);
+}
+
+TEST(UJson, BufferedOutput) {
+  SourceSink ss;
+  ujson uj = ss.UJson();
+  char buf[8];
+
+  EXPECT_EQ(status_err(ujson_set_output(&uj, buf, sizeof(buf))), kOk);
+  EXPECT_TRUE(status_ok(ujson_putbuf(&uj, "abc", 3)));
+  EXPECT_TRUE(status_ok(ujson_putbuf(&uj, "123", 3)));
+  EXPECT_EQ(ss.Sink(), "");
+
+  // Data that does not fit flushes the buffer.
+  EXPECT_TRUE(status_ok(ujson_putbuf(&uj, "xyz", 3)));
+  EXPECT_EQ(ss.Sink(), "abc123");
+
+  // Data larger than the buffer is written straight through.
+  EXPECT_TRUE(status_ok(ujson_putbuf(&uj, "0123456789", 10)));
+  EXPECT_EQ(ss.Sink(), "abc123xyz0123456789");
+
+  EXPECT_TRUE(status_ok(ujson_putbuf(&uj, "!", 1)));
+  EXPECT_EQ(status_err(ujson_flush(&uj)), kOk);
+  EXPECT_EQ(ss.Sink(), "abc123xyz0123456789!");
+}
+
 TEST(UJson, SerializeString) {
   SourceSink ss;
   ujson uj = ss.UJson();
@@ -4,21 +4,47 @@
 
 #include "sw/device/silicon_creator/lib/base/mock_sec_mmio.h"
 
+#include "sw/device/lib/base/mock_mmio_trace.h"
+
 namespace rom_test {
+namespace {
+void Trace(bool write, uint32_t addr, uint32_t value, const void *caller) {
+  mock_mmio::MmioTrace::Record({
+      .bus = mock_mmio::MmioBus::kSec,
+      .write = write,
+      .device = 0,
+      .addr = addr,
+      .width = sizeof(uint32_t),
+      .value = value,
+      .caller = caller,
+  });
+}
+}  // namespace
+
 extern "C" {
 sec_mmio_ctx_t sec_mmio_ctx;
 
 void sec_mmio_init(void) { MockSecMmio::Instance().Init(); }
 
 uint32_t sec_mmio_read32(uint32_t addr) {
-  return MockSecMmio::Instance().Read32(addr);
+  uint32_t value = MockSecMmio::Instance().Read32(addr);
+  Trace(false, addr, value, __builtin_return_address(0));
+  return value;
+}
+
+void sec_mmio_record32(uint32_t addr, uint32_t value) {
+  MockSecMmio::Instance().Record32(addr, value);
 }
 
 void sec_mmio_write32(uint32_t addr, uint32_t value) {
+  Trace(true, addr, value, __builtin_return_address(0));
   MockSecMmio::Instance().Write32(addr, value);
 }
 
 void sec_mmio_write32_shadowed(uint32_t addr, uint32_t value) {
+  // A shadowed write is two writes on the bus.
+  Trace(true, addr, value, __builtin_return_address(0));
+  Trace(true, addr, value, __builtin_return_address(0));
   MockSecMmio::Instance().Write32Shadowed(addr, value);
 }
 
@@ -19,6 +19,7 @@ class MockSecMmio : public global_mock::GlobalMock<MockSecMmio> {
  public:
   MOCK_METHOD(void, Init, ());
   MOCK_METHOD(uint32_t, Read32, (uint32_t addr));
+  MOCK_METHOD(void, Record32, (uint32_t addr, uint32_t value));
   MOCK_METHOD(void, Write32, (uint32_t addr, uint32_t value));
   MOCK_METHOD(void, Write32Shadowed, (uint32_t addr, uint32_t value));
   MOCK_METHOD(void, CheckValues, (uint32_t rnd_offset));
@@ -40,6 +41,18 @@ using MockSecMmio = testing::StrictMock<internal::MockSecMmio>;
   EXPECT_CALL(::rom_test::MockSecMmio::Instance(), Read32(addr)) \
       .WillOnce(testing::Return(mock_mmio::ToInt<uint32_t>(__VA_ARGS__)))
 
+/**
+ * Expect the given 32-bit value to be recorded for the given address without a
+ * read.
+ *
+ * @param addr Register address.
+ * @param ...  Expected value to be recorded. May be an integer, a pointer to
+ * little-endian data, or a `std::initializer_list<BitField>`.
+ */
+#define EXPECT_SEC_RECORD32(addr, ...)             \
+  EXPECT_CALL(::rom_test::MockSecMmio::Instance(), \
+              Record32(addr, mock_mmio::ToInt<uint32_t>(__VA_ARGS__)));
+
 /**
  * Expect a sec_mmio write to the given address with the given 32-bit value.
  *
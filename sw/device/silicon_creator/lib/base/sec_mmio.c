@@ -25,7 +25,94 @@ enum {
 
   // Number of address-value pairs in the table.
   kEntryCount = ARRAYSIZE(sec_mmio_ctx.addrs),
+
+  // Number of buckets in the address index. A power of two at least twice
+  // `kEntryCount`, which keeps the load factor at or below 0.5 with the table
+  // full, so that probe sequences stay short.
+  kIndexSize = 2048,
+  kIndexShift = 32 - 11,
+  kIndexMask = kIndexSize - 1,
+  // Bits of a bucket that hold the entry index. The remaining bits hold the
+  // complement of the low bits of the index.
+  kIndexEntryBits = 10,
+  kIndexCheckMask = (1 << (16 - kIndexEntryBits)) - 1,
+  // Multiplier used to spread MMIO addresses across the index.
+  kIndexHashMul = 0x9e3779b1u,
 };
+static_assert(kIndexSize >= 2 * kEntryCount, "Address index is too small");
+static_assert((kIndexSize & kIndexMask) == 0,
+              "Address index size must be a power of two");
+static_assert((1u << (32 - kIndexShift)) == kIndexSize,
+              "kIndexShift does not match kIndexSize");
+static_assert(kEntryCount <= (1 << kIndexEntryBits),
+              "Entry indices do not fit in a bucket");
+
+/**
+ * Open-addressing index from MMIO address to its `sec_mmio_ctx` entry.
+ *
+ * A bucket is zero when empty, otherwise it holds the entry index in its upper
+ * `kIndexEntryBits` bits and the complement of the low bits of the index below
+ * them, so that no entry encodes to zero. Buckets are 16 bits wide to keep the
+ * index at 4 KiB. The index lives in each stage's own `.bss` because the
+ * layout of `sec_mmio_ctx` is shared with the previous boot stage. It is only
+ * used to find the candidate entry: every hit is checked against
+ * `sec_mmio_ctx.addrs`, and a faulted miss can at most append a duplicate
+ * entry, which `sec_mmio_check_values()` still compares against the hardware.
+ */
+static uint16_t index_buckets[kIndexSize];
+/**
+ * Number of `sec_mmio_ctx` entries present in `index_buckets`.
+ */
+static uint32_t index_count;
+
+static void index_clear(void) {
+  for (size_t i = 0; i < kIndexSize; ++i) {
+    index_buckets[i] = 0;
+  }
+  index_count = 0;
+}
+
+static uint32_t index_hash(uint32_t addr) {
+  return ((addr >> 2) * kIndexHashMul) >> kIndexShift;
+}
+
+static uint16_t index_encode(uint32_t entry) {
+  return (uint16_t)(entry << (16 - kIndexEntryBits) |
+                    (~entry & kIndexCheckMask));
+}
+
+/**
+ * Decodes a non-empty bucket, checking the redundant copy of the index.
+ */
+static uint32_t index_decode(uint32_t bucket) {
+  uint32_t entry = bucket >> (16 - kIndexEntryBits);
+  HARDENED_CHECK_EQ((entry ^ bucket) & kIndexCheckMask, kIndexCheckMask);
+  HARDENED_CHECK_LT(entry, sec_mmio_ctx.last_index);
+  return entry;
+}
+
+static void index_insert(uint32_t entry) {
+  uint32_t b = index_hash(sec_mmio_ctx.addrs[entry]);
+  while (index_buckets[b] != 0) {
+    b = (b + 1) & kIndexMask;
+  }
+  index_buckets[b] = index_encode(entry);
+}
+
+/**
+ * Adds the entries not yet present in the index, e.g. those inherited from
+ * the previous boot stage.
+ */
+static void index_sync(void) {
+  const uint32_t last_index = sec_mmio_ctx.last_index;
+  HARDENED_CHECK_LE(last_index, kEntryCount);
+  if (index_count > last_index) {
+    index_clear();
+  }
+  for (; index_count < last_index; ++index_count) {
+    index_insert(index_count);
+  }
+}
 
 /**
  * Updates or inserts the register entry pointed to by MMIO `addr` with the
@@ -34,19 +121,25 @@ enum {
  * Increments the `sec_mmio_ctx.last_index`.
  */
 static void upsert_register(uint32_t addr, uint32_t value) {
+  index_sync();
   const uint32_t last_index = sec_mmio_ctx.last_index;
-  uint32_t i = 0, j = last_index - 1;
-  for (; launder32(i) < last_index && launder32(j) < last_index; ++i, --j) {
-    if (launder32(sec_mmio_ctx.addrs[i]) == addr) {
+  uint32_t i = last_index;
+  uint32_t b = index_hash(addr);
+  for (; index_buckets[b] != 0; b = (b + 1) & kIndexMask) {
+    uint32_t entry = index_decode(index_buckets[b]);
+    if (launder32(sec_mmio_ctx.addrs[entry]) == addr) {
+      i = entry;
       sec_mmio_ctx.values[i] = value;
       break;
     }
   }
   if (launder32(i) == last_index && launder32(i) < kSecMmioRegFileSize) {
-    HARDENED_CHECK_EQ(j, UINT32_MAX);
+    HARDENED_CHECK_EQ(index_buckets[b], 0);
     sec_mmio_ctx.addrs[i] = addr;
     sec_mmio_ctx.values[i] = value;
+    index_buckets[b] = index_encode(i);
     ++sec_mmio_ctx.last_index;
+    ++index_count;
   }
   // The following checks serve as an additional fault detection mechanism.
   HARDENED_CHECK_EQ(sec_mmio_ctx.addrs[i], addr);
@@ -70,6 +163,7 @@ void sec_mmio_init(void) {
   check ^= sec_mmio_ctx.check_count;
   check ^= sec_mmio_ctx.expected_write_count;
   HARDENED_CHECK_EQ(check, kSecMmioValZero);
+  index_clear();
 }
 
 void sec_mmio_next_stage_init(void) {
@@ -83,6 +177,7 @@ void sec_mmio_next_stage_init(void) {
   HARDENED_CHECK_EQ(i, kEntryCount);
   HARDENED_CHECK_EQ(r, UINT32_MAX);
   HARDENED_CHECK_EQ(sec_mmio_ctx.check_count, 0);
+  index_clear();
 }
 
 OT_WARN_UNUSED_RESULT
@@ -96,6 +191,12 @@ uint32_t sec_mmio_read32(uint32_t addr) {
   return value;
 }
 
+void sec_mmio_record32(uint32_t addr, uint32_t value) {
+  uint32_t masked_value = value ^ kSecMmioMaskVal;
+  barrier32(masked_value);
+  upsert_register(addr, masked_value);
+}
+
 void sec_mmio_write32(uint32_t addr, uint32_t value) {
   abs_mmio_write32(addr, value);
   uint32_t masked_value = value ^ kSecMmioMaskVal;
@@ -160,6 +160,21 @@ void sec_mmio_next_stage_init(void);
 OT_WARN_UNUSED_RESULT
 uint32_t sec_mmio_read32(uint32_t addr);
 
+/**
+ * Records `value` as the expected value of the MMIO register at `addr`
+ * without accessing the register.
+ *
+ * This is meant for drivers that return a register's value from a verified
+ * copy in RAM instead of reading it with `sec_mmio_read32()`. The value is
+ * compared against the register by `sec_mmio_check_values()`, so a fault that
+ * corrupts the copy, or the value taken from it, is detected in the same way
+ * as a faulted `sec_mmio_read32()`.
+ *
+ * @param addr The address of the register.
+ * @param value The value returned to the caller in place of a read.
+ */
+void sec_mmio_record32(uint32_t addr, uint32_t value);
+
 /**
  * Writes an aligned uint32_t to the MMIO region `base` at the give byte
  * `offset`.
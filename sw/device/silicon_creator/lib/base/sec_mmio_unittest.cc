@@ -5,7 +5,9 @@
 #include "sw/device/silicon_creator/lib/base/sec_mmio.h"
 
 #include <array>
+#include <chrono>
 #include <cstdlib>
+#include <string>
 #include <vector>
 
 #include "gtest/gtest.h"
@@ -102,6 +104,21 @@ TEST_F(SecMmioTest, Read32OrDie) {
   EXPECT_EQ(ctx_->last_index, 2);
 }
 
+TEST_F(SecMmioTest, Record32) {
+  // No MMIO access is expected when recording a value.
+  sec_mmio_record32(0, 0x12345678);
+  sec_mmio_record32(4, 0x87654321);
+  sec_mmio_record32(0, 0x87654321);
+
+  EXPECT_EQ(ctx_->write_count, 0);
+  EXPECT_EQ(ctx_->last_index, 2);
+
+  // The recorded values are checked against the hardware.
+  EXPECT_ABS_READ32(0, 0x87654321);
+  EXPECT_ABS_READ32(4, 0x87654321);
+  sec_mmio_check_values(/*rnd_offset=*/0);
+}
+
 TEST_F(SecMmioTest, Write32) {
   EXPECT_ABS_WRITE32(0, 0x12345678);
   EXPECT_ABS_READ32(0, 0x12345678);
@@ -174,6 +191,61 @@ TEST_F(SecMmioTest, CheckCount) {
   EXPECT_EQ(ctx_->check_count, 2);
 }
 
+TEST_F(SecMmioTest, UpsertFullRegFile) {
+  // Fill the whole register file and then update every entry again, which is
+  // the worst case for the lookup in `upsert_register()`. The elapsed time is
+  // recorded so that changes to the lookup can be compared.
+  auto start = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < kSecMmioRegFileSize; ++i) {
+    EXPECT_ABS_WRITE32(i * sizeof(uint32_t), i);
+    EXPECT_ABS_READ32(i * sizeof(uint32_t), i);
+    sec_mmio_write32(i * sizeof(uint32_t), i);
+  }
+  EXPECT_EQ(ctx_->last_index, kSecMmioRegFileSize);
+
+  for (uint32_t i = kSecMmioRegFileSize; i > 0; --i) {
+    uint32_t addr = (i - 1) * sizeof(uint32_t);
+    EXPECT_ABS_READ32(addr, ~i);
+    EXPECT_ABS_READ32(addr, ~i);
+    EXPECT_EQ(sec_mmio_read32(addr), ~i);
+  }
+  auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - start);
+  RecordProperty("upsert_us", std::to_string(elapsed.count()));
+
+  EXPECT_EQ(ctx_->last_index, kSecMmioRegFileSize);
+  EXPECT_EQ(ctx_->write_count, kSecMmioRegFileSize);
+  for (uint32_t i = 0; i < kSecMmioRegFileSize; ++i) {
+    EXPECT_EQ(ctx_->addrs[i], i * sizeof(uint32_t));
+  }
+}
+
+TEST_F(SecMmioTest, UpsertAfterNextStageInit) {
+  // Entries inherited from the previous stage must be found by the lookup
+  // instead of being appended again.
+  EXPECT_ABS_WRITE32(0, 0x12345678);
+  EXPECT_ABS_READ32(0, 0x12345678);
+  sec_mmio_write32(0, 0x12345678);
+  EXPECT_ABS_WRITE32(4, 0x87654321);
+  EXPECT_ABS_READ32(4, 0x87654321);
+  sec_mmio_write32(4, 0x87654321);
+
+  sec_mmio_next_stage_init();
+
+  EXPECT_ABS_WRITE32(4, 0);
+  EXPECT_ABS_READ32(4, 0);
+  sec_mmio_write32(4, 0);
+  EXPECT_ABS_WRITE32(8, 1);
+  EXPECT_ABS_READ32(8, 1);
+  sec_mmio_write32(8, 1);
+  EXPECT_EQ(ctx_->last_index, 3);
+
+  EXPECT_ABS_READ32(0, 0x12345678);
+  EXPECT_ABS_READ32(4, 0);
+  EXPECT_ABS_READ32(8, 1);
+  sec_mmio_check_values(/*rnd_offset=*/0);
+}
+
 // Negative test cases trigger assertions, which are caugth by `EXPECT_DEATH`
 // calls.
 class SecMmioDeathTest : public SecMmioTest {};
@@ -211,6 +283,19 @@ TEST_F(SecMmioDeathTest, CheckValuesSimulatedFault) {
       "");
 }
 
+TEST_F(SecMmioDeathTest, Record32SimulatedFault) {
+  EXPECT_DEATH(
+      {
+        // A recorded value that doesn't match the hardware, e.g. from a
+        // faulted RAM copy, is caught by the next check.
+        sec_mmio_record32(0, 0x12345678);
+
+        EXPECT_ABS_READ32(0, 0x12345679);
+        sec_mmio_check_values(/*rnd_offset=*/0);
+      },
+      "");
+}
+
 TEST_F(SecMmioDeathTest, CheckCountWriteMismatch) {
   // The developer forgot to increment the write counter, or an attacker
   // glitched the sec write operation.
@@ -51,6 +51,48 @@ static const flash_ctrl_info_page_t *kPages[kPageCount] = {
     &kFlashCtrlInfoPageBootData0,
     &kFlashCtrlInfoPageBootData1,
 };
+static_assert(ARRAYSIZE((boot_data_hint_t){0}.first_empty_index) ==
+                  kPageCount,
+              "Boot data hint must have an entry for each page");
+
+/**
+ * Location hint set by `boot_data_hint_init()`, `NULL` if not set.
+ */
+static boot_data_hint_t *hint;
+
+void boot_data_hint_init(boot_data_hint_t *new_hint) { hint = new_hint; }
+
+/**
+ * Returns the hinted index of the first empty entry of the given page.
+ *
+ * @param page_index Index of the page in `kPages`.
+ * @return Hinted index, `UINT32_MAX` if there is no hint.
+ */
+static size_t boot_data_hint_get(size_t page_index) {
+  if (hint == NULL || hint->identifier != kBootDataHintIdentifier) {
+    return UINT32_MAX;
+  }
+  return hint->first_empty_index[page_index];
+}
+
+/**
+ * Updates the hinted index of the first empty entry of the given page.
+ *
+ * @param page_index Index of the page in `kPages`.
+ * @param first_empty_index Index of the first empty entry of the page.
+ */
+static void boot_data_hint_update(size_t page_index,
+                                  size_t first_empty_index) {
+  if (hint == NULL) {
+    return;
+  }
+  if (hint->identifier != kBootDataHintIdentifier) {
+    hint->first_empty_index[0] = UINT32_MAX;
+    hint->first_empty_index[1] = UINT32_MAX;
+    hint->identifier = kBootDataHintIdentifier;
+  }
+  hint->first_empty_index[page_index] = first_empty_index;
+}
 
 /**
  * Computes the SHA-256 digest of a boot data entry.
@@ -314,17 +356,145 @@ typedef struct active_page_info {
   size_t last_valid_index;
 } active_page_info_t;
 
+/**
+ * Checks whether the boot data entry at the given page and index is empty.
+ *
+ * Reads all words of the entry only if its sniffed identifier indicates that
+ * it can be empty.
+ *
+ * @param page A boot data page.
+ * @param index Index of the entry to check in the given page.
+ * @param[out] is_empty Whether the entry is empty.
+ * @return The result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+static rom_error_t boot_data_entry_is_empty(const flash_ctrl_info_page_t *page,
+                                            size_t index,
+                                            hardened_bool_t *is_empty) {
+  *is_empty = kHardenedBoolFalse;
+  uint32_t masked_identifier;
+  HARDENED_RETURN_IF_ERROR(boot_data_sniff(page, index, &masked_identifier));
+  if (masked_identifier == kFlashCtrlErasedWord) {
+    boot_data_t buf;
+    HARDENED_RETURN_IF_ERROR(boot_data_entry_read(page, index, &buf));
+    *is_empty = boot_data_is_empty(&buf);
+  }
+  return kErrorOk;
+}
+
+/**
+ * Checks whether the entry at the given index is the first empty entry of the
+ * given page, i.e. the entry before it is not empty and the entry itself is
+ * empty. `kBootDataEntriesPerPage` is the first empty index of a full page.
+ *
+ * @param page A boot data page.
+ * @param index Candidate index, at most `kBootDataEntriesPerPage`.
+ * @param[out] is_first_empty Whether `index` is the first empty index.
+ * @return The result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+static rom_error_t boot_data_first_empty_check(
+    const flash_ctrl_info_page_t *page, size_t index,
+    hardened_bool_t *is_first_empty) {
+  *is_first_empty = kHardenedBoolFalse;
+  hardened_bool_t is_empty;
+  if (index > 0) {
+    HARDENED_RETURN_IF_ERROR(
+        boot_data_entry_is_empty(page, index - 1, &is_empty));
+    if (launder32(is_empty) != kHardenedBoolFalse) {
+      return kErrorOk;
+    }
+    HARDENED_CHECK_EQ(is_empty, kHardenedBoolFalse);
+  }
+  if (index < kBootDataEntriesPerPage) {
+    HARDENED_RETURN_IF_ERROR(boot_data_entry_is_empty(page, index, &is_empty));
+    if (launder32(is_empty) != kHardenedBoolTrue) {
+      return kErrorOk;
+    }
+    HARDENED_CHECK_EQ(is_empty, kHardenedBoolTrue);
+  }
+  *is_first_empty = kHardenedBoolTrue;
+  return kErrorOk;
+}
+
+/**
+ * Finds the first empty entry of the given page.
+ *
+ * Entries are written in order, so all entries before the first empty entry
+ * are non-empty and all entries after it are empty. This function first tries
+ * the hinted index, then performs a binary search. Both results are confirmed
+ * by checking the neighboring entries with `boot_data_first_empty_check()`. If
+ * the page does not have the expected layout, this function falls back to a
+ * forward search.
+ *
+ * @param page A boot data page.
+ * @param hint_index Hinted index of the first empty entry.
+ * @param[out] first_empty_index Index of the first empty entry if any and
+ * `kBootDataEntriesPerPage` otherwise.
+ * @return The result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+static rom_error_t boot_data_first_empty_find(
+    const flash_ctrl_info_page_t *page, size_t hint_index,
+    size_t *first_empty_index) {
+  hardened_bool_t is_first_empty = kHardenedBoolFalse;
+  size_t index = hint_index;
+  if (index <= kBootDataEntriesPerPage) {
+    HARDENED_RETURN_IF_ERROR(
+        boot_data_first_empty_check(page, index, &is_first_empty));
+  }
+
+  if (launder32(is_first_empty) != kHardenedBoolTrue) {
+    size_t lo = 0, hi = kBootDataEntriesPerPage;
+    while (lo < hi) {
+      size_t mid = lo + (hi - lo) / 2;
+      hardened_bool_t is_empty;
+      HARDENED_RETURN_IF_ERROR(boot_data_entry_is_empty(page, mid, &is_empty));
+      if (launder32(is_empty) == kHardenedBoolTrue) {
+        hi = mid;
+      } else {
+        lo = mid + 1;
+      }
+    }
+    index = lo;
+    HARDENED_RETURN_IF_ERROR(
+        boot_data_first_empty_check(page, index, &is_first_empty));
+  }
+
+  if (launder32(is_first_empty) != kHardenedBoolTrue) {
+    hardened_bool_t is_empty = kHardenedBoolFalse;
+    size_t r = kBootDataEntriesPerPage - 1;
+    for (index = 0; launder32(index) < kBootDataEntriesPerPage &&
+                    launder32(r) < kBootDataEntriesPerPage;
+         ++index, --r) {
+      HARDENED_RETURN_IF_ERROR(
+          boot_data_entry_is_empty(page, index, &is_empty));
+      if (launder32(is_empty) == kHardenedBoolTrue) {
+        HARDENED_CHECK_EQ(is_empty, kHardenedBoolTrue);
+        break;
+      }
+      HARDENED_CHECK_EQ(is_empty, kHardenedBoolFalse);
+    }
+    HARDENED_CHECK_EQ(index + r, kBootDataEntriesPerPage - 1);
+  }
+
+  HARDENED_CHECK_LE(index, kBootDataEntriesPerPage);
+  *first_empty_index = index;
+  return kErrorOk;
+}
+
 /**
  * Updates the given active page info struct and last valid boot data entry
  * using the given page.
  *
- * This function performs a forward search to find the first empty boot data
- * entry followed by a backward search to find the last valid boot data entry.
- * If the page has an entry that is newer than the one passed in, this function
- * updates `page_info` and `boot_data`. Reads must be enabled for the given page
- * before this function is called, see `boot_data_page_info_get()`.
+ * This function finds the first empty boot data entry, see
+ * `boot_data_first_empty_find()`, followed by a backward search to find the
+ * last valid boot data entry. If the page has an entry that is newer than the
+ * one passed in, this function updates `page_info` and `boot_data`. Reads must
+ * be enabled for the given page before this function is called, see
+ * `boot_data_page_info_get()`.
  *
- * @param page A boot data page.
+ * @param page_index Index of the boot data page in `kPages`.
  * @param[in,out] page_info Active page info struct. Updated if the given page
  * has a newer entry.
  * @param[in,out] boot_data Last valid boot data entry found so far. Updated if
@@ -333,45 +503,33 @@ typedef struct active_page_info {
  */
 OT_WARN_UNUSED_RESULT
 static rom_error_t boot_data_page_info_update_impl(
-    const flash_ctrl_info_page_t *page, active_page_info_t *page_info,
-    boot_data_t *boot_data) {
-  uint32_t sniff_results[kBootDataEntriesPerPage];
-
+    size_t page_index, active_page_info_t *page_info, boot_data_t *boot_data) {
+  const flash_ctrl_info_page_t *page = kPages[page_index];
   boot_data_t buf;
 
-  // Perform a forward search to find the first empty entry.
+  size_t first_empty_index;
+  HARDENED_RETURN_IF_ERROR(boot_data_first_empty_find(
+      page, boot_data_hint_get(page_index), &first_empty_index));
+  boot_data_hint_update(page_index, first_empty_index);
   hardened_bool_t has_empty_entry = kHardenedBoolFalse;
-  size_t i = 0, r = kBootDataEntriesPerPage - 1;
-  for (; launder32(i) < kBootDataEntriesPerPage &&
-         launder32(r) < kBootDataEntriesPerPage;
-       ++i, --r) {
-    // Read and cache the identifier to quickly determine if an entry can be
-    // empty or valid.
-    HARDENED_RETURN_IF_ERROR(boot_data_sniff(page, i, &sniff_results[i]));
-    // Check all words of this entry only if it can be empty.
-    if (sniff_results[i] == kFlashCtrlErasedWord) {
-      HARDENED_RETURN_IF_ERROR(boot_data_entry_read(page, i, &buf));
-      has_empty_entry = boot_data_is_empty(&buf);
-      if (launder32(has_empty_entry) == kHardenedBoolTrue) {
-        HARDENED_CHECK_EQ(has_empty_entry, kHardenedBoolTrue);
-        break;
-      }
-      HARDENED_CHECK_EQ(has_empty_entry, kHardenedBoolFalse);
-    }
+  if (launder32(first_empty_index) < kBootDataEntriesPerPage) {
+    HARDENED_CHECK_LT(first_empty_index, kBootDataEntriesPerPage);
+    has_empty_entry = kHardenedBoolTrue;
   }
-  // At the end of this loop, `i` is the index of the first empty entry if any
-  // and `kBootDataEntriesPerPage` otherwise.
-  HARDENED_CHECK_LE(i, kBootDataEntriesPerPage);
-  size_t first_empty_index = i;
-  HARDENED_CHECK_EQ(i + r, kBootDataEntriesPerPage - 1);
+  size_t i = first_empty_index;
+  size_t r = kBootDataEntriesPerPage - 1 - i;
 
-  // Perform a backward search to find the last valid entry.
+  // Perform a backward search to find the last valid entry. The search stops
+  // at the first invalidated entry: an entry is only invalidated after a newer
+  // one is written, so no entry before it can be the newest one.
   hardened_bool_t has_valid_entry = kHardenedBoolFalse;
   for (--i, ++r; launder32(i) < kBootDataEntriesPerPage &&
                  launder32(r) < kBootDataEntriesPerPage;
        --i, ++r) {
-    // Check the digest only if this entry can be valid.
-    if (sniff_results[i] == kBootDataIdentifier) {
+    // Read and check the digest only if this entry can be valid.
+    uint32_t masked_identifier;
+    HARDENED_RETURN_IF_ERROR(boot_data_sniff(page, i, &masked_identifier));
+    if (masked_identifier == kBootDataIdentifier) {
       HARDENED_RETURN_IF_ERROR(boot_data_entry_read(page, i, &buf));
       rom_error_t is_valid = boot_data_check(&buf);
       if (launder32(is_valid) == kErrorOk) {
@@ -382,11 +540,12 @@ static rom_error_t boot_data_page_info_update_impl(
         break;
       }
       HARDENED_CHECK_EQ(is_valid, kErrorBootDataInvalid);
+    } else if (launder32(masked_identifier) == kBootDataInvalidEntry) {
+      HARDENED_CHECK_EQ(masked_identifier, kBootDataInvalidEntry);
+      break;
     }
   }
-  // At the end of this loop, `i` is the index of the last valid entry if any
-  // and `UINT32_MAX`, otherwise. `r` must be less than or equal to
-  // `first_empty_index`.
+  // At the end of this loop, `i` is the index of the last valid entry if any.
   HARDENED_CHECK_EQ(i + r, kBootDataEntriesPerPage - 1);
 
   if (launder32(has_valid_entry) == kHardenedBoolTrue) {
@@ -433,7 +592,7 @@ static rom_error_t boot_data_page_info_update_impl(
  * This function wraps the actual implementation to enable and disable reads for
  * the given page, see `boot_data_page_info_get_impl()`.
  *
- * @param page A boot data page.
+ * @param page_index Index of the boot data page in `kPages`.
  * @param[in,out] page_info Active page info struct. Updated if the given page
  * has a newer entry.
  * @param[in,out] boot_data Last valid boot data entry found so far. Updated if
@@ -441,16 +600,17 @@ static rom_error_t boot_data_page_info_update_impl(
  * @return The result of the operation.
  */
 OT_WARN_UNUSED_RESULT
-static rom_error_t boot_data_page_info_update(
-    const flash_ctrl_info_page_t *page, active_page_info_t *page_info,
-    boot_data_t *boot_data) {
+static rom_error_t boot_data_page_info_update(size_t page_index,
+                                              active_page_info_t *page_info,
+                                              boot_data_t *boot_data) {
+  const flash_ctrl_info_page_t *page = kPages[page_index];
   flash_ctrl_info_perms_set(page, (flash_ctrl_perms_t){
                                       .read = kMultiBitBool4True,
                                       .write = kMultiBitBool4False,
                                       .erase = kMultiBitBool4False,
                                   });
   rom_error_t error =
-      boot_data_page_info_update_impl(page, page_info, boot_data);
+      boot_data_page_info_update_impl(page_index, page_info, boot_data);
   flash_ctrl_info_perms_set(page, (flash_ctrl_perms_t){
                                       .read = kMultiBitBool4False,
                                       .write = kMultiBitBool4False,
@@ -485,9 +645,9 @@ static rom_error_t boot_data_active_page_find(active_page_info_t *page_info,
   static_assert(kPageCount == 2,
                 "Number of pages changed, unrolled loop must be updated");
   HARDENED_RETURN_IF_ERROR(
-      boot_data_page_info_update(kPages[0], page_info, boot_data));
+      boot_data_page_info_update(0, page_info, boot_data));
   HARDENED_RETURN_IF_ERROR(
-      boot_data_page_info_update(kPages[1], page_info, boot_data));
+      boot_data_page_info_update(1, page_info, boot_data));
 
   return kErrorOk;
 }
@@ -621,17 +781,20 @@ rom_error_t boot_data_write(const boot_data_t *boot_data) {
     // invalidate the old entry.
     new_entry.counter = last_entry.counter + 1;
     boot_data_digest_compute(&new_entry, &new_entry.digest);
+    const size_t active_page_index = active_page.page == kPages[0] ? 0 : 1;
     if (active_page.has_empty_entry == kHardenedBoolTrue) {
       RETURN_IF_ERROR(boot_data_entry_write(active_page.page,
                                             active_page.first_empty_index,
                                             &new_entry, kHardenedBoolFalse));
+      boot_data_hint_update(active_page_index,
+                            active_page.first_empty_index + 1);
     } else {
       // Erase the other page and write the new entry there if the active page
       // is full.
-      const flash_ctrl_info_page_t *new_page =
-          active_page.page == kPages[0] ? kPages[1] : kPages[0];
-      RETURN_IF_ERROR(
-          boot_data_entry_write(new_page, 0, &new_entry, kHardenedBoolTrue));
+      const size_t new_page_index = active_page_index ^ 1;
+      RETURN_IF_ERROR(boot_data_entry_write(kPages[new_page_index], 0,
+                                            &new_entry, kHardenedBoolTrue));
+      boot_data_hint_update(new_page_index, 1);
     }
     // Invalidate the previous entry so that there is only one valid entry
     // across both pages.
@@ -644,6 +807,7 @@ rom_error_t boot_data_write(const boot_data_t *boot_data) {
     boot_data_digest_compute(&new_entry, &new_entry.digest);
     RETURN_IF_ERROR(
         boot_data_entry_write(kPages[0], 0, &new_entry, kHardenedBoolTrue));
+    boot_data_hint_update(0, 1);
   }
 
   return kErrorOk;
@@ -170,6 +170,45 @@ typedef enum boot_slot {
   kBootSlotUnspecified = 0x55555555,
 } boot_slot_t;
 
+/**
+ * Location hint for the boot data entries.
+ *
+ * Stored in the retention SRAM so that boot stages after a warm reset can
+ * locate the active entries without searching the boot data pages. The hint is
+ * never trusted: `boot_data_read()` and `boot_data_write()` confirm it against
+ * the flash contents and fall back to searching the pages if it is stale.
+ */
+typedef struct boot_data_hint {
+  /**
+   * Set to `kBootDataHintIdentifier` when the fields below are populated.
+   */
+  uint32_t identifier;
+  /**
+   * Index of the first empty entry in each boot data page.
+   */
+  uint32_t first_empty_index[2];
+} boot_data_hint_t;
+OT_ASSERT_MEMBER_OFFSET(boot_data_hint_t, identifier, 0);
+OT_ASSERT_MEMBER_OFFSET(boot_data_hint_t, first_empty_index, 4);
+OT_ASSERT_SIZE(boot_data_hint_t, 12);
+
+enum {
+  /**
+   * Boot data hint identifier value (ASCII "BDHT").
+   */
+  kBootDataHintIdentifier = 0x54484442,
+};
+
+/**
+ * Sets the location hint used by subsequent boot data operations.
+ *
+ * Passing `NULL` disables the hint. The hint is updated every time the boot
+ * data pages are searched or written.
+ *
+ * @param hint Location hint, typically in the retention SRAM.
+ */
+void boot_data_hint_init(boot_data_hint_t *hint);
+
 /**
  * Reads the boot data stored in the flash info partition.
  *
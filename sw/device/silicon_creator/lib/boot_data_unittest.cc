@@ -109,68 +109,54 @@ class BootDataTest : public rom_test::RomTest {
     std::fill_n(non_erased_entry_.begin(), kBootDataNumWords, 0x01234567);
     std::fill_n(part_erased_entry_.begin(), kBootDataNumWords, 0x01234567);
     std::fill_n(part_erased_entry_.begin(), 3, kFlashCtrlErasedWord);
+    boot_data_hint_init(nullptr);
   }
 
   /**
-   * Sets an expectation that a given boot data entry in the given info page
-   * is read. The data and return value given by the read can be specified.
-   *
-   * @param page   The info page containing the boot data entry.
-   * @param index  The index of the boot data entry in the page.
-   * @param offset Offset into the boot data entry expected to be read from.
-   * @param data   Mock data to be read at this entry. The number of words is
-   *               unchecked and can be less than (or greater) than the boot
-   *               data entry size.
-   * @param error  Value to be returned by the read.
-   * @param count  Optionally the number of values expected to be read from the
-   *               start of the entry. Useful for expecting sniffs.
+   * Contents of a mocked boot data page, one array of words per entry.
+   */
+  using PageContents = std::array<std::array<uint32_t, kBootDataNumWords>,
+                                  kBootDataEntriesPerPage>;
+
+  /**
+   * Returns the contents of a fully erased boot data page.
    */
-  void ExpectRead(const flash_ctrl_info_page_t *page, size_t index,
-                  std::array<uint32_t, kBootDataNumWords> data,
-                  rom_error_t error) {
-    size_t offset = index * sizeof(boot_data_t);
-
-    // Mock out flash_ctrl_page_info_read to pass the given `data` and return
-    // the given `error`.
-    //
-    // Using a lambda rather than `.SetArrayArgument(...).Return(error)`
-    // because we have to cast the `void*` argument to a real pointer type
-    // before we can write to it.
-    EXPECT_CALL(flash_ctrl_, InfoRead(page, offset, kBootDataNumWords, _))
-        .WillOnce([data, error](auto, auto, auto, void *out) {
-          uint32_t *out_words = static_cast<uint32_t *>(out);
-          std::copy_n(data.begin(), kBootDataNumWords, out_words);
-          return error;
-        });
+  PageContents ErasedContents() {
+    PageContents contents;
+    contents.fill(erased_entry_);
+    return contents;
   }
 
   /**
-   * Sets an expectation that a given boot data entry in an info page was
-   * sniffed (i.e. with `boot_data_sniff`).
+   * Sets an expectation that the given info page is read any number of times
+   * and at any offset, with reads served from the given `contents`.
+   *
+   * The number of reads is accumulated in `read_count_`.
    *
-   * @param page  The info page containing the boot entry.
-   * @param index The index of the boot info entry in the page.
-   * @param data  Data of the boot data entry (only first three words read).
-   * @param error Value to be returned by the read.
+   * @param page     The info page expected to be read.
+   * @param contents Mock contents of the page.
    */
-  template <size_t N>
-  void ExpectSniff(const flash_ctrl_info_page_t *page, size_t index,
-                   std::array<uint32_t, N> data, rom_error_t error) {
-    static_assert(N > 3, "Data must be at least three words for a sniff");
-
-    constexpr uint32_t kIsValidOffset = offsetof(boot_data_t, is_valid);
-    size_t offset = index * sizeof(boot_data_t) + kIsValidOffset;
-
-    // As with `ExpectRead`, provide the given `data` and `error` using a lambda
-    // to support casting the `void*` parameter before writing.
-    EXPECT_CALL(flash_ctrl_, InfoRead(page, offset, 3, _))
-        .WillOnce([data, error](auto, auto, auto, void *out) {
-          uint32_t *out_words = static_cast<uint32_t *>(out);
-          std::copy_n(data.begin(), 3, out_words);
-          return error;
-        });
+  void ExpectPageReads(const flash_ctrl_info_page_t *page,
+                       PageContents contents) {
+    EXPECT_CALL(flash_ctrl_, InfoRead(page, _, _, _))
+        .WillRepeatedly(
+            [this, contents](auto, uint32_t offset, uint32_t word_count,
+                             void *out) {
+              EXPECT_LE(offset + word_count * sizeof(uint32_t),
+                        sizeof(PageContents));
+              std::memcpy(
+                  out, reinterpret_cast<const char *>(contents.data()) + offset,
+                  word_count * sizeof(uint32_t));
+              ++read_count_;
+              return kErrorOk;
+            });
   }
 
+  /**
+   * Number of info page reads served by `ExpectPageReads()`.
+   */
+  size_t read_count_ = 0;
+
   /**
    * Sets an expectation that a digest for the given `boot` data is computed.
    *
@@ -264,37 +250,35 @@ class BootDataTest : public rom_test::RomTest {
     // #1. Non-erased and bootable provided boot_data.
     // #2. Non-erased and bootable but invalid digest.
     // #3. Entry with sniffed area erased but the rest not.
-    // #4. Fully erased entry.
+    // #4 and onwards. Fully erased entries.
+    PageContents contents = ErasedContents();
+    contents[0] = non_erased_entry_;
+    contents[1] = boot_data_raw;
+    contents[2] = boot_data_raw;
+    contents[3] = part_erased_entry_;
     return [=](const flash_ctrl_info_page_t *page) {
-      // Expect to sniff each entry, fully reading if it could be erased.
-      ExpectSniff(page, 0, non_erased_entry_, kErrorOk);
-      ExpectSniff(page, 1, boot_data_raw, kErrorOk);
-      ExpectSniff(page, 2, boot_data_raw, kErrorOk);
-      ExpectSniff(page, 3, part_erased_entry_, kErrorOk);
-      ExpectRead(page, 3, part_erased_entry_, kErrorOk);
-      ExpectSniff(page, 4, erased_entry_, kErrorOk);
-      ExpectRead(page, 4, erased_entry_, kErrorOk);
-
-      // Check the last seen bootable entry's digest (mocked as invalid).
-      ExpectRead(page, 2, boot_data_raw, kErrorOk);
+      // Expect to find the first empty entry and then to search backwards,
+      // reading the last seen bootable entry and checking its digest (mocked
+      // as invalid).
+      ExpectPageReads(page, contents);
       ExpectDigestCompute(boot_data, false);
 
       // Step back to the previously seen bootable entry (provided `boot_data`).
-      ExpectRead(page, 1, boot_data_raw, kErrorOk);
+      ExpectPageReads(page, contents);
       ExpectDigestCompute(boot_data, valid_digest);
+
+      // Continue the search if the provided `boot_data` is mocked as invalid.
+      ExpectPageReads(page, contents);
     };
   }
 
   /**
-   * Provides a lambda function mocking a page with only an erased entry.
+   * Provides a lambda function mocking a fully erased page.
    *
    * @return Lambda function for use with `ExpectPageScan`.
    */
   auto ErasedPage() {
-    return [this](auto page) {
-      ExpectSniff(page, 0, erased_entry_, kErrorOk);
-      ExpectRead(page, 0, erased_entry_, kErrorOk);
-    };
+    return [this](auto page) { ExpectPageReads(page, ErasedContents()); };
   }
 
   /**
@@ -445,5 +429,81 @@ TEST_F(BootDataReadTest, ReadV1AsV2Test) {
   EXPECT_EQ(boot_data, kValidEntry0);
 }
 
+TEST_F(BootDataReadTest, ReadStopsAtInvalidatedEntry) {
+  // An entry is invalidated only after a newer entry is written, so the
+  // backward search stops at the first invalidated entry even if an older
+  // entry was left valid by an interrupted invalidation.
+  PageContents contents = ErasedContents();
+  std::memcpy(contents[0].data(), &kValidEntry0, sizeof(boot_data_t));
+  boot_data_t invalidated = kValidEntry0;
+  invalidated.is_valid = kBootDataInvalidEntry;
+  std::memcpy(contents[1].data(), &invalidated, sizeof(boot_data_t));
+  ExpectPageScan(&kFlashCtrlInfoPageBootData0,
+                 [&](auto page) { ExpectPageReads(page, contents); });
+  ExpectPageScan(&kFlashCtrlInfoPageBootData1, EntryPage(kValidEntry1));
+
+  boot_data_t boot_data = {{0}};
+  EXPECT_EQ(boot_data_read(kLcStateTest, &boot_data), kErrorOk);
+  EXPECT_EQ(boot_data, kValidEntry1);
+}
+
+class BootDataHintTest : public BootDataTest {
+ protected:
+  boot_data_hint_t hint_ = {};
+};
+
+TEST_F(BootDataHintTest, ReadUpdatesHint) {
+  boot_data_hint_init(&hint_);
+  ExpectPageScan(&kFlashCtrlInfoPageBootData0, EntryPage(kValidEntry0));
+  ExpectPageScan(&kFlashCtrlInfoPageBootData1, ErasedPage());
+
+  boot_data_t boot_data = {{0}};
+  EXPECT_EQ(boot_data_read(kLcStateTest, &boot_data), kErrorOk);
+  EXPECT_EQ(boot_data, kValidEntry0);
+  EXPECT_EQ(hint_.identifier, kBootDataHintIdentifier);
+  EXPECT_EQ(hint_.first_empty_index[0], 4);
+  EXPECT_EQ(hint_.first_empty_index[1], 0);
+}
+
+TEST_F(BootDataHintTest, ReadWithHint) {
+  // Search both pages without a hint first.
+  ExpectPageScan(&kFlashCtrlInfoPageBootData0, EntryPage(kValidEntry0));
+  ExpectPageScan(&kFlashCtrlInfoPageBootData1, ErasedPage());
+  boot_data_t boot_data = {{0}};
+  EXPECT_EQ(boot_data_read(kLcStateTest, &boot_data), kErrorOk);
+  size_t search_read_count = read_count_;
+
+  // A correct hint only needs the neighboring entries to be checked.
+  read_count_ = 0;
+  hint_ = {
+      .identifier = kBootDataHintIdentifier,
+      .first_empty_index = {4, 0},
+  };
+  boot_data_hint_init(&hint_);
+  ExpectPageScan(&kFlashCtrlInfoPageBootData0, EntryPage(kValidEntry0));
+  ExpectPageScan(&kFlashCtrlInfoPageBootData1, ErasedPage());
+  boot_data = {{0}};
+  EXPECT_EQ(boot_data_read(kLcStateTest, &boot_data), kErrorOk);
+  EXPECT_EQ(boot_data, kValidEntry0);
+  EXPECT_LT(read_count_, search_read_count);
+}
+
+TEST_F(BootDataHintTest, ReadWithStaleHint) {
+  // A stale hint is detected and corrected.
+  hint_ = {
+      .identifier = kBootDataHintIdentifier,
+      .first_empty_index = {9, 1},
+  };
+  boot_data_hint_init(&hint_);
+  ExpectPageScan(&kFlashCtrlInfoPageBootData0, EntryPage(kValidEntry0));
+  ExpectPageScan(&kFlashCtrlInfoPageBootData1, ErasedPage());
+
+  boot_data_t boot_data = {{0}};
+  EXPECT_EQ(boot_data_read(kLcStateTest, &boot_data), kErrorOk);
+  EXPECT_EQ(boot_data, kValidEntry0);
+  EXPECT_EQ(hint_.first_empty_index[0], 4);
+  EXPECT_EQ(hint_.first_empty_index[1], 0);
+}
+
 }  // namespace
 }  // namespace boot_data_unittest
@@ -5,7 +5,9 @@
 #include "sw/device/silicon_creator/lib/boot_log.h"
 
 #include "sw/device/lib/base/macros.h"
+#include "sw/device/lib/base/memory.h"
 #include "sw/device/silicon_creator/lib/drivers/hmac.h"
+#include "sw/device/silicon_creator/lib/drivers/ibex.h"
 
 static void boot_log_digest_compute(const boot_log_t *boot_log,
                                     hmac_digest_t *digest) {
@@ -90,3 +92,25 @@ void boot_log_check_or_init(boot_log_t *boot_log, uint32_t rom_ext_slot,
   boot_log_digest_update(boot_log);
   return;
 }
+
+void boot_timing_init(boot_timing_t *timing) {
+  memset(timing, 0, sizeof(*timing));
+  timing->identifier = kBootTimingIdentifier;
+}
+
+void boot_timing_record(boot_timing_t *timing, boot_timing_event_t event) {
+  // Start a new trace if the previous stage did not initialize one (e.g. an
+  // older ROM).
+  if (timing->identifier != kBootTimingIdentifier ||
+      timing->count > ARRAYSIZE(timing->entry)) {
+    boot_timing_init(timing);
+  }
+  uint32_t count = timing->count;
+  if (count < ARRAYSIZE(timing->entry)) {
+    timing->entry[count] = (boot_timing_entry_t){
+        .event = event,
+        .mcycle = ibex_mcycle32(),
+    };
+    timing->count = count + 1;
+  }
+}
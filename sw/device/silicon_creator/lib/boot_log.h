@@ -53,8 +53,12 @@ typedef struct boot_log {
   uint32_t primary_bl0_slot;
   /** Whether the RET-RAM was initialized on this boot (hardened_bool_t). */
   uint32_t retention_ram_initialized;
+  /** Cycles the ROM spent measuring (hashing) the ROM_EXT image. */
+  uint32_t rom_ext_measure_cycles;
+  /** Cycles the ROM_EXT spent measuring (hashing) the BL0 image. */
+  uint32_t bl0_measure_cycles;
   /** Pad to 128 bytes. */
-  uint32_t reserved[8];
+  uint32_t reserved[6];
 } boot_log_t;
 
 OT_ASSERT_MEMBER_OFFSET(boot_log_t, digest, 0);
@@ -72,7 +76,9 @@ OT_ASSERT_MEMBER_OFFSET(boot_log_t, rom_ext_min_sec_ver, 80);
 OT_ASSERT_MEMBER_OFFSET(boot_log_t, bl0_min_sec_ver, 84);
 OT_ASSERT_MEMBER_OFFSET(boot_log_t, primary_bl0_slot, 88);
 OT_ASSERT_MEMBER_OFFSET(boot_log_t, retention_ram_initialized, 92);
-OT_ASSERT_MEMBER_OFFSET(boot_log_t, reserved, 96);
+OT_ASSERT_MEMBER_OFFSET(boot_log_t, rom_ext_measure_cycles, 96);
+OT_ASSERT_MEMBER_OFFSET(boot_log_t, bl0_measure_cycles, 100);
+OT_ASSERT_MEMBER_OFFSET(boot_log_t, reserved, 104);
 
 enum {
   /**
@@ -81,6 +87,85 @@ enum {
   kBootLogIdentifier = 0x474f4c42,
 };
 
+/**
+ * Events recorded in the boot timing trace.
+ *
+ * The values are part of the retention SRAM layout read by owner firmware and
+ * host tooling and must not be renumbered.
+ */
+typedef enum boot_timing_event {
+  /** ROM: boot_log initialized. */
+  kBootTimingEventRomInit = 1,
+  /** ROM: ROM_EXT image measured. */
+  kBootTimingEventRomExtMeasure = 2,
+  /** ROM: ROM_EXT SPHINCS+ signature verified. */
+  kBootTimingEventRomExtSpxVerify = 3,
+  /** ROM: ROM_EXT ECDSA signature verified. */
+  kBootTimingEventRomExtEcdsaVerify = 4,
+  /** ROM: jumping to the ROM_EXT. */
+  kBootTimingEventRomExit = 5,
+  /** ROM_EXT: immutable section keymgr advance and UDS/CDI_0 keys done. */
+  kBootTimingEventImmSectionDice = 6,
+  /** ROM_EXT: mutable section entered. */
+  kBootTimingEventRomExtStart = 7,
+  /** ROM_EXT: ownership state initialized. */
+  kBootTimingEventOwnershipInit = 8,
+  /** ROM_EXT: BL0 image measured. */
+  kBootTimingEventBl0Measure = 9,
+  /** ROM_EXT: BL0 signature verified. */
+  kBootTimingEventBl0Verify = 10,
+  /** ROM_EXT: keymgr advanced and CDI_1 key and certificate done. */
+  kBootTimingEventDiceCdi1 = 11,
+  /** ROM_EXT: DICE certificates written back to flash (if changed). */
+  kBootTimingEventDiceFlush = 12,
+  /** ROM_EXT: jumping to BL0. */
+  kBootTimingEventRomExtExit = 13,
+  /** First event value available to owner firmware. */
+  kBootTimingEventOwnerFirst = 0x100,
+} boot_timing_event_t;
+
+/**
+ * A single boot timing trace entry.
+ */
+typedef struct boot_timing_entry {
+  /** Event that was recorded (boot_timing_event_t). */
+  uint32_t event;
+  /** Low 32 bits of `mcycle` when the event was recorded. */
+  uint32_t mcycle;
+} boot_timing_entry_t;
+
+enum {
+  /**
+   * Boot timing identifier value (ASCII "BTIM").
+   */
+  kBootTimingIdentifier = 0x4d495442,
+  /**
+   * Number of entries in the boot timing trace.
+   */
+  kBootTimingEntryCount = 31,
+};
+
+/**
+ * The boot timing trace records when each boot stage reached a given point.
+ *
+ * `mcycle` runs uninterrupted from reset through the ROM, ROM_EXT and owner
+ * stages, so timestamps from different stages can be compared directly.
+ * Unlike the boot_log, the trace is not covered by a digest.
+ */
+typedef struct boot_timing {
+  /** Identifier (`BTIM`). */
+  uint32_t identifier;
+  /** Number of valid entries. */
+  uint32_t count;
+  /** Trace entries in the order they were recorded. */
+  boot_timing_entry_t entry[kBootTimingEntryCount];
+} boot_timing_t;
+
+OT_ASSERT_MEMBER_OFFSET(boot_timing_t, identifier, 0);
+OT_ASSERT_MEMBER_OFFSET(boot_timing_t, count, 4);
+OT_ASSERT_MEMBER_OFFSET(boot_timing_t, entry, 8);
+OT_ASSERT_SIZE(boot_timing_t, 256);
+
 /**
  * Updates the digest of the boot_log.
  *
@@ -114,6 +199,23 @@ rom_error_t boot_log_check(const boot_log_t *boot_log);
 void boot_log_check_or_init(boot_log_t *boot_log, uint32_t rom_ext_slot,
                             const chip_info_t *info);
 
+/**
+ * Clears the boot timing trace.
+ *
+ * @param timing A buffer that holds the boot timing trace.
+ */
+void boot_timing_init(boot_timing_t *timing);
+
+/**
+ * Appends an entry with the current cycle count to the boot timing trace.
+ *
+ * The event is dropped if the trace is full.
+ *
+ * @param timing A buffer that holds the boot timing trace.
+ * @param event The event to record.
+ */
+void boot_timing_record(boot_timing_t *timing, boot_timing_event_t event);
+
 #ifdef __cplusplus
 }
 #endif
@@ -171,5 +171,33 @@ TEST_F(BootLogTest, BootLogCheckFailure) {
   EXPECT_EQ(expected_chip_version, boot_log.chip_version);
 }
 
+TEST_F(BootLogTest, BootTimingRecord) {
+  boot_timing_t timing;
+  memset(&timing, 0xa5, sizeof(timing));
+
+  // Recording into an uninitialized trace starts a new one.
+  boot_timing_record(&timing, kBootTimingEventRomInit);
+  EXPECT_EQ(timing.identifier, kBootTimingIdentifier);
+  EXPECT_EQ(timing.count, 1u);
+  EXPECT_EQ(timing.entry[0].event, kBootTimingEventRomInit);
+
+  boot_timing_record(&timing, kBootTimingEventRomExit);
+  EXPECT_EQ(timing.count, 2u);
+  EXPECT_EQ(timing.entry[1].event, kBootTimingEventRomExit);
+  EXPECT_GE(timing.entry[1].mcycle, timing.entry[0].mcycle);
+
+  // Events are dropped once the trace is full.
+  for (size_t i = timing.count; i < kBootTimingEntryCount + 2; ++i) {
+    boot_timing_record(&timing, kBootTimingEventOwnerFirst);
+  }
+  EXPECT_EQ(timing.count, kBootTimingEntryCount);
+  EXPECT_EQ(timing.entry[kBootTimingEntryCount - 1].event,
+            kBootTimingEventOwnerFirst);
+
+  boot_timing_init(&timing);
+  EXPECT_EQ(timing.identifier, kBootTimingIdentifier);
+  EXPECT_EQ(timing.count, 0u);
+}
+
 }  // namespace
 }  // namespace boot_log_unittest
@@ -109,6 +109,9 @@ static rom_error_t bootstrap_sector_erase(uint32_t addr) {
  * Handles access permissions and programs up to 256 bytes of flash memory
  * starting at `addr`.
  *
+ * Clears the WIP and WEL bits of the flash status register once `addr` has been
+ * validated, before programming starts.
+ *
  * If `byte_count` is not a multiple of flash word size, it's rounded up to next
  * flash word and missing bytes in `data` are set to `0xff`.
  *
@@ -158,6 +161,11 @@ static rom_error_t bootstrap_page_program(uint32_t addr, size_t byte_count,
   }
   size_t rem_word_count = byte_count / sizeof(uint32_t);
 
+  // The payload has already been copied out of the spi_device buffer, so clear
+  // WIP and WEL now: the host uploads the next command while this one is being
+  // programmed. Commands are still handled strictly in order.
+  spi_device_flash_status_clear();
+
   flash_ctrl_data_default_perms_set((flash_ctrl_perms_t){
       .read = kMultiBitBool4False,
       .write = kMultiBitBool4True,
@@ -293,7 +301,10 @@ static rom_error_t bootstrap_handle_program(bootstrap_state_t *state) {
     case kSpiDeviceOpcodePageProgram:
       error = bootstrap_page_program(cmd.address, cmd.payload_byte_count,
                                      cmd.payload);
-      break;
+      // `bootstrap_page_program()` clears the flash status before programming;
+      // clearing it again here could drop the WEL bit of the next command.
+      HARDENED_RETURN_IF_ERROR(error);
+      return error;
     case kSpiDeviceOpcodeReset:
       // In a normal build, this function inlines to nothing.
       stack_utilization_print();
@@ -71,11 +71,63 @@ void asn1_push_bytes(asn1_state_t *state, const uint8_t *bytes, size_t size) {
   state->offset += size;
 }
 
+/**
+ * Compute the number of octets needed to encode a tag length.
+ *
+ * @param length Length of the tag contents.
+ * @return The size of the length encoding, or 0 if the length is too large.
+ */
+static size_t asn1_len_size(size_t length) {
+  if (length <= 0x7f) {
+    // Short form.
+    return 1;
+  } else if (length <= 0xff) {
+    // Long form with one length octet.
+    return 2;
+  } else if (length <= 0xffff) {
+    // Long form with two length octets.
+    return 3;
+  }
+  return 0;
+}
+
+/**
+ * Write the encoding of a tag length.
+ *
+ * The caller must make sure that `out` has room for `asn1_len_size(length)`
+ * bytes and that the length is not too large.
+ *
+ * @param out Pointer to the length octets.
+ * @param length Length of the tag contents.
+ */
+static void asn1_write_len(uint8_t *out, size_t length) {
+  if (length <= 0x7f) {
+    out[0] = (uint8_t)length;
+  } else if (length <= 0xff) {
+    out[0] = 0x81;
+    out[1] = (uint8_t)length;
+  } else {
+    out[0] = 0x82;
+    out[1] = (uint8_t)(length >> 8);
+    out[2] = (uint8_t)(length & 0xff);
+  }
+}
+
+size_t asn1_tag_size(size_t content_size) {
+  size_t len_size = asn1_len_size(content_size);
+  if (len_size == 0) {
+    return 0;
+  }
+  return 1 + len_size + content_size;
+}
+
 void asn1_start_tag(asn1_state_t *state, asn1_tag_t *new_tag, uint8_t id) {
   new_tag->state = NULL;
   RETURN_IF_ASN1_ERROR(state);
 
   new_tag->state = state;
+  new_tag->sized = false;
+  new_tag->content_size = 0;
   asn1_push_byte(state, id);
   RETURN_IF_ASN1_ERROR(state);
   new_tag->len_offset = state->offset;
@@ -88,73 +140,85 @@ void asn1_start_tag(asn1_state_t *state, asn1_tag_t *new_tag, uint8_t id) {
   new_tag->len_size = 1;
 }
 
+void asn1_start_tag_sized(asn1_state_t *state, asn1_tag_t *new_tag, uint8_t id,
+                          size_t content_size) {
+  new_tag->state = NULL;
+  RETURN_IF_ASN1_ERROR(state);
+
+  size_t len_size = asn1_len_size(content_size);
+  if (len_size == 0) {
+    // Length too large.
+    RAISE_ASN1_ERROR(state, kErrorAsn1Internal);
+  }
+  new_tag->state = state;
+  new_tag->sized = true;
+  new_tag->content_size = content_size;
+  asn1_push_byte(state, id);
+  RETURN_IF_ASN1_ERROR(state);
+  new_tag->len_offset = state->offset;
+  // The length is known so we can write its final encoding right away.
+  uint8_t len[3];
+  asn1_write_len(len, content_size);
+  asn1_push_bytes(state, len, len_size);
+  RETURN_IF_ASN1_ERROR(state);
+  new_tag->len_size = len_size;
+}
+
 void asn1_finish_tag(asn1_tag_t *tag) {
   if (tag->state == NULL)
     return;
   RETURN_IF_ASN1_ERROR(tag->state);
-  // Sanity check: asn1_start_tag should have output one byte.
-  if (tag->len_size != 1) {
-    RAISE_ASN1_ERROR(tag->state, kErrorAsn1Internal);
-  }
   // Compute actually used length.
   size_t length = tag->state->offset - tag->len_offset - tag->len_size;
-  // Compute the size of the minimal encoding.
-  size_t final_len_size;
-  if (length <= 0x7f) {
-    // We only need one byte to hold the length.
-    final_len_size = 1;
-  } else if (length <= 0xff) {
-    // We need two bytes to hold the length: we need to move the data before
-    // we can write the second byte.
-    final_len_size = 2;
-  } else if (length <= 0xffff) {
-    // We need three bytes to hold the length: we need to move the data before
-    // we can write the second and third bytes.
-    final_len_size = 3;
+  if (tag->sized) {
+    // The length was written by asn1_start_tag_sized, we only need to check
+    // that the caller pushed what it announced.
+    if (length != tag->content_size) {
+      RAISE_ASN1_ERROR(tag->state, kErrorAsn1Internal);
+    }
   } else {
-    // Length too large.
-    RAISE_ASN1_ERROR(tag->state, kErrorAsn1Internal);
-  }
-  // If the final length uses more bytes than we initially allocated, we
-  // need to shift all the tag data backwards.
-  if (tag->len_size != final_len_size) {
-    // Make sure that the data actually fits into the buffer.
-    size_t new_buffer_size =
-        tag->state->offset + final_len_size - tag->len_size;
-    if (new_buffer_size > tag->state->size) {
-      RAISE_ASN1_ERROR(tag->state, kErrorAsn1BufferExhausted);
+    // Sanity check: asn1_start_tag should have output one byte.
+    if (tag->len_size != 1) {
+      RAISE_ASN1_ERROR(tag->state, kErrorAsn1Internal);
     }
-    // Copy backwards.
-    for (size_t i = 0; i < length; i++) {
-      tag->state->buffer[tag->len_offset + final_len_size + length - 1 - i] =
-          tag->state->buffer[tag->len_offset + tag->len_size + length - 1 - i];
+    // Compute the size of the minimal encoding.
+    size_t final_len_size = asn1_len_size(length);
+    if (final_len_size == 0) {
+      // Length too large.
+      RAISE_ASN1_ERROR(tag->state, kErrorAsn1Internal);
     }
+    // If the final length uses more bytes than we initially allocated, we
+    // need to shift all the tag data backwards.
+    if (tag->len_size != final_len_size) {
+      // Make sure that the data actually fits into the buffer.
+      size_t new_buffer_size =
+          tag->state->offset + final_len_size - tag->len_size;
+      if (new_buffer_size > tag->state->size) {
+        RAISE_ASN1_ERROR(tag->state, kErrorAsn1BufferExhausted);
+      }
+      // Copy backwards.
+      for (size_t i = 0; i < length; i++) {
+        tag->state->buffer[tag->len_offset + final_len_size + length - 1 - i] =
+            tag->state
+                ->buffer[tag->len_offset + tag->len_size + length - 1 - i];
+      }
+    }
+    // Write the length in the buffer.
+    asn1_write_len(&tag->state->buffer[tag->len_offset], length);
+    // Fix up state offset.
+    tag->state->offset += final_len_size - tag->len_size;
   }
-  // Write the length in the buffer.
-  if (length <= 0x7f) {
-    tag->state->buffer[tag->len_offset] = (uint8_t)length;
-  } else if (length <= 0xff) {
-    tag->state->buffer[tag->len_offset + 0] = 0x81;
-    tag->state->buffer[tag->len_offset + 1] = (uint8_t)length;
-  } else if (length <= 0xffff) {
-    tag->state->buffer[tag->len_offset + 0] = 0x82;
-    tag->state->buffer[tag->len_offset + 1] = (uint8_t)(length >> 8);
-    tag->state->buffer[tag->len_offset + 2] = (uint8_t)(length & 0xff);
-  } else {
-    // Length too large.
-    RAISE_ASN1_ERROR(tag->state, kErrorAsn1Internal);
-  }
-  // Fix up state offset.
-  tag->state->offset += final_len_size - tag->len_size;
   // Hardening: clear out the tag structure to prevent accidental reuse.
   tag->state = NULL;
   tag->len_offset = 0;
   tag->len_size = 0;
+  tag->content_size = 0;
+  tag->sized = false;
 }
 
 void asn1_push_bool(asn1_state_t *state, uint8_t tag, bool value) {
   asn1_tag_t tag_st;
-  asn1_start_tag(state, &tag_st, tag);
+  asn1_start_tag_sized(state, &tag_st, tag, 1);
   asn1_push_byte(state, value ? 0xff : 0);
   asn1_finish_tag(&tag_st);
 }
@@ -186,8 +250,6 @@ void asn1_push_integer(asn1_state_t *state, uint8_t tag, bool is_signed,
   if (size == 0 || (bytes_be == NULL && size > 0)) {
     RAISE_ASN1_ERROR(state, kErrorAsn1PushIntegerInvalidArgument);
   }
-  asn1_tag_t tag_st;
-  asn1_start_tag(state, &tag_st, tag);
   // Compute smallest possible encoding: ASN1 forbids that the first 9 bits (ie
   // first octet) and MSB of the second octet are either all ones or all zeroes.
 
@@ -197,6 +259,7 @@ void asn1_push_integer(asn1_state_t *state, uint8_t tag, bool is_signed,
     size -= 1;
   }
 
+  bool pad = false;
   if (is_signed) {
     // Integers in ASN.1 are always signed and represented in two's complement.
     // So for unsigned numbers that has MSB set, add a 0x00 padding.
@@ -206,9 +269,13 @@ void asn1_push_integer(asn1_state_t *state, uint8_t tag, bool is_signed,
     }
   } else {
     // For unsigned numbers, add a 0x00 padding if the first octet has MSB set.
-    if ((bytes_be[0] >> 7) == 1) {
-      asn1_push_byte(state, 0);
-    }
+    pad = (bytes_be[0] >> 7) == 1;
+  }
+  // The length is now known so the tag can be emitted in a single pass.
+  asn1_tag_t tag_st;
+  asn1_start_tag_sized(state, &tag_st, tag, size + (pad ? 1 : 0));
+  if (pad) {
+    asn1_push_byte(state, 0);
   }
   asn1_push_bytes(state, bytes_be, size);
   asn1_finish_tag(&tag_st);
@@ -235,7 +302,7 @@ void asn1_push_integer_pad(asn1_state_t *state, bool is_signed,
 
 void asn1_push_oid_raw(asn1_state_t *state, const uint8_t *bytes, size_t size) {
   asn1_tag_t tag;
-  asn1_start_tag(state, &tag, kAsn1TagNumberOid);
+  asn1_start_tag_sized(state, &tag, kAsn1TagNumberOid, size);
   asn1_push_bytes(state, bytes, size);
   asn1_finish_tag(&tag);
 }
@@ -259,7 +326,7 @@ static const char kLowercaseHexChars[16] = {'0', '1', '2', '3', '4', '5',
 void asn1_push_hexstring(asn1_state_t *state, uint8_t id, const uint8_t *bytes,
                          size_t size) {
   asn1_tag_t tag;
-  asn1_start_tag(state, &tag, id);
+  asn1_start_tag_sized(state, &tag, id, 2 * size);
   while (size > 0) {
     asn1_push_byte(state, (uint8_t)kLowercaseHexChars[bytes[0] >> 4]);
     asn1_push_byte(state, (uint8_t)kLowercaseHexChars[bytes[0] & 0xf]);
@@ -101,6 +101,10 @@ typedef struct asn1_tag {
   size_t len_offset;
   // How many bytes were allocated for the length octets.
   size_t len_size;
+  // Announced size of the contents (only valid if `sized` is true).
+  size_t content_size;
+  // Whether the tag was started by `asn1_start_tag_sized`.
+  bool sized;
 } asn1_tag_t;
 
 /**
@@ -162,12 +166,46 @@ typedef enum asn1_tag_number {
  */
 void asn1_start_tag(asn1_state_t *state, asn1_tag_t *new_tag, uint8_t id);
 
+/**
+ * Compute the encoded size of a tag.
+ *
+ * This can be used to compute the size of nested tags bottom-up so that they
+ * can be started with `asn1_start_tag_sized`.
+ *
+ * @param content_size Size of the tag contents in bytes.
+ * @return The size of the identifier, length and contents octets, or 0 if the
+ * contents are too large to be encoded.
+ */
+size_t asn1_tag_size(size_t content_size);
+
+/**
+ * Start an ASN1 tag whose contents size is known in advance.
+ *
+ * Unlike `asn1_start_tag`, this writes the final length encoding right away so
+ * `asn1_finish_tag` never needs to move the contents. The caller must push
+ * exactly `content_size` bytes before finishing the tag, otherwise
+ * `asn1_finish_tag` raises `kErrorAsn1Internal`.
+ *
+ * Note: This function tracks its error in the asn1 state, and the error will
+ * be returned by `asn1_finish` in the end. This function will be no-op when
+ * the state has an active error.
+ *
+ * @param state Pointer to the state initialized by asn1_start.
+ * @param[out] new_tag Pointer to a user-allocated tag to be initialized.
+ * @param id Identifier byte of the tag (see ASN1_CLASS_*, ASN1_FORM_* and
+ * ASN1_TAG_*).
+ * @param content_size Size of the tag contents in bytes.
+ */
+void asn1_start_tag_sized(asn1_state_t *state, asn1_tag_t *new_tag, uint8_t id,
+                          size_t content_size);
+
 /**
  * Finish an ASN1 tag.
  *
  * If size hint provided to asn1_start_tag does not match the actual size
  * of the data, this function will fix it up, potentially at the cost of moving
- * bytes within the buffer.
+ * bytes within the buffer. Tags started with `asn1_start_tag_sized` are only
+ * checked against the announced size.
  *
  * Note: the `tag` will be cleared out after this call.
  *
@@ -481,5 +481,66 @@ TEST(Asn1, TagLengthEncoding) {
   EXPECT_EQ(buf, expected);
 }
 
+// Make sure that sized tags produce the same encoding without moving data.
+TEST(Asn1, SizedTagLengthEncoding) {
+  asn1_state_t state;
+  std::vector<uint8_t> buf;
+  buf.resize(0xfffff);
+  std::vector<uint8_t> expected;
+
+#define ADD_SIZED_BYTES(fill, fill_size, ...)                               \
+  do {                                                                      \
+    std::vector<uint8_t> tmp(fill_size, fill);                              \
+    const uint8_t kData[] = {__VA_ARGS__};                                  \
+    expected.push_back(0x30); /* Identifier octet (universal, sequence). */ \
+    expected.insert(expected.end(), kData,                                  \
+                    kData + sizeof(kData)); /* Length encoding */           \
+    expected.insert(expected.end(), tmp.begin(), tmp.end());                \
+    EXPECT_EQ(asn1_tag_size(tmp.size()), 1 + sizeof(kData) + tmp.size());   \
+    asn1_tag_t tag;                                                         \
+    asn1_start_tag_sized(&state, &tag, kAsn1TagNumberSequence, tmp.size()); \
+    EXPECT_EQ(state.error, kErrorOk);                                       \
+    asn1_push_bytes(&state, tmp.data(), tmp.size());                        \
+    EXPECT_EQ(state.error, kErrorOk);                                       \
+    asn1_finish_tag(&tag);                                                  \
+    EXPECT_EQ(state.error, kErrorOk);                                       \
+  } while (0)
+
+  EXPECT_EQ(asn1_start(&state, &buf[0], buf.size()), kErrorOk);
+  ADD_SIZED_BYTES(0x00, 0, 0x00);
+  ADD_SIZED_BYTES(0xa5, 0x7f, 0x7f);
+  ADD_SIZED_BYTES(0xb6, 0x80, 0x81, 0x80);
+  ADD_SIZED_BYTES(0xc7, 0xff, 0x81, 0xff);
+  ADD_SIZED_BYTES(0xd8, 0x100, 0x82, 0x01, 0x00);
+  ADD_SIZED_BYTES(0xe9, 0xffff, 0x82, 0xff, 0xff);
+  size_t out_size;
+  EXPECT_EQ(asn1_finish(&state, &out_size), kErrorOk);
+  EXPECT_EQ(out_size, expected.size());
+  buf.resize(out_size);
+  EXPECT_EQ(buf, expected);
+  EXPECT_EQ(asn1_tag_size(0x10000), 0);
+}
+
+// Make sure that nested sized tags work and that size mismatches are caught.
+TEST(Asn1, SizedTagNested) {
+  asn1_state_t state;
+  uint8_t buf[8];
+  const std::array<uint8_t, 5> kExpectedResult = {0x30, 0x03, 0x01, 0x01, 0xff};
+  EXPECT_EQ(asn1_start(&state, buf, sizeof(buf)), kErrorOk);
+  asn1_tag_t tag;
+  asn1_start_tag_sized(&state, &tag, kAsn1TagNumberSequence, asn1_tag_size(1));
+  asn1_push_bool(&state, kAsn1TagNumberBoolean, true);
+  asn1_finish_tag(&tag);
+  size_t out_size;
+  EXPECT_EQ(asn1_finish(&state, &out_size), kErrorOk);
+  EXPECT_EQ_CONST_ARRAY(buf, out_size, kExpectedResult);
+
+  EXPECT_EQ(asn1_start(&state, buf, sizeof(buf)), kErrorOk);
+  asn1_start_tag_sized(&state, &tag, kAsn1TagNumberSequence, 2);
+  asn1_push_byte(&state, 0);
+  asn1_finish_tag(&tag);
+  EXPECT_EQ(asn1_finish(&state, &out_size), kErrorAsn1Internal);
+}
+
 }  // namespace
 }  // namespace asn1_unittest
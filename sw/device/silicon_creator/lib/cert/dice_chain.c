@@ -24,12 +24,35 @@
 
 #include "flash_ctrl_regs.h"  // Generated.
 
+/**
+ * Cache record kept at the end of the DICE certificates page.
+ *
+ * It allows the CDI_1 keygen to be skipped when nothing that goes into the
+ * CDI_1 key or certificate has changed since the previous boot.
+ */
+typedef struct dice_chain_cache {
+  /**
+   * Digest of the inputs to the CDI_1 key and certificate.
+   */
+  hmac_digest_t cdi_1_binding;
+  /**
+   * CDI_1 public key ID derived from the inputs in `cdi_1_binding`.
+   */
+  hmac_digest_t cdi_1_pubkey_id;
+} dice_chain_cache_t;
+
 enum {
   /**
    * The size of the scratch buffer that is large enough for constructing the
    * CDI certs.
    */
   kScratchCertSizeBytes = FLASH_CTRL_PARAM_BYTES_PER_PAGE,
+  /**
+   * Offset of the `dice_chain_cache_t` record in the DICE certificates page.
+   * Certificates in this page must end before this offset.
+   */
+  kDiceChainCacheOffset =
+      FLASH_CTRL_PARAM_BYTES_PER_PAGE - sizeof(dice_chain_cache_t),
 };
 
 /**
@@ -108,8 +131,19 @@ cert_key_id_pair_t dice_chain_cdi_0_key_ids = (cert_key_id_pair_t){
 OT_WARN_UNUSED_RESULT
 OT_NOINLINE
 static size_t dice_chain_get_tail_size(void) {
-  HARDENED_CHECK_GE(sizeof(dice_chain.data), dice_chain.tail_offset);
-  return sizeof(dice_chain.data) - dice_chain.tail_offset;
+  size_t limit = sizeof(dice_chain.data);
+  if (dice_chain.info_page == &kFlashCtrlInfoPageDiceCerts) {
+    limit = kDiceChainCacheOffset;
+  }
+  HARDENED_CHECK_GE(limit, dice_chain.tail_offset);
+  return limit - dice_chain.tail_offset;
+}
+
+// Get the cache record of the DICE certificates page.
+OT_WARN_UNUSED_RESULT
+static dice_chain_cache_t *dice_chain_get_cache(void) {
+  HARDENED_CHECK_EQ(dice_chain.info_page, &kFlashCtrlInfoPageDiceCerts);
+  return (dice_chain_cache_t *)&dice_chain.data[kDiceChainCacheOffset];
 }
 
 // Get the pointer to the remaining tail space that is not processed yet.
@@ -307,16 +341,17 @@ rom_error_t dice_chain_attestation_creator(
       /*sealing_binding=*/&seal_binding_value,
       /*attest_binding=*/rom_ext_measurement,
       rom_ext_manifest->max_key_version));
-  HARDENED_RETURN_IF_ERROR(otbn_boot_cert_ecc_p256_keygen(
-      kDiceKeyCdi0, &static_dice_cdi_0.cdi_0_pubkey_id,
-      &static_dice_cdi_0.cdi_0_pubkey));
+  HARDENED_RETURN_IF_ERROR(otbn_boot_cert_ecc_p256_keygen_start(kDiceKeyCdi0));
 
-  // Switch page for the device generated CDI_0.
+  // Switch page for the device generated CDI_0 while OTBN generates the key.
   RETURN_IF_ERROR(dice_chain_load_flash(&kFlashCtrlInfoPageDiceCerts));
 
   // Seek to skip previous objects.
   RETURN_IF_ERROR(dice_chain_skip_cert_obj("UDS", /*name_size=*/4));
 
+  HARDENED_RETURN_IF_ERROR(otbn_boot_cert_ecc_p256_keygen_finalize(
+      &static_dice_cdi_0.cdi_0_pubkey_id, &static_dice_cdi_0.cdi_0_pubkey));
+
   // Check if the current CDI_0 cert is valid.
   RETURN_IF_ERROR(dice_chain_load_cert_obj("CDI_0", /*name_size=*/6));
   if (dice_chain.cert_valid == kHardenedBoolFalse) {
@@ -394,10 +429,38 @@ static rom_error_t dice_chain_attestation_check_cdi_0(void) {
   return kErrorOk;
 }
 
+/**
+ * Computes the digest of everything the CDI_1 key and certificate depend on.
+ *
+ * The CDI_0 key ID covers the silicon and ROM_EXT stages, the attestation
+ * measurement and key version cover the owner keymgr stage, and the
+ * ownership transfer count covers the owner secret, which is rotated on each
+ * transfer.
+ */
+static void dice_chain_cdi_1_binding(const hmac_digest_t *attest_measurement,
+                                     const manifest_t *owner_manifest,
+                                     owner_app_domain_t key_domain,
+                                     uint32_t ownership_transfers,
+                                     hmac_digest_t *binding) {
+  hmac_sha256_configure(false);
+  hmac_sha256_start();
+  hmac_sha256_update(&static_dice_cdi_0.cdi_0_pubkey_id,
+                     sizeof(static_dice_cdi_0.cdi_0_pubkey_id));
+  hmac_sha256_update(attest_measurement, sizeof(*attest_measurement));
+  hmac_sha256_update(&owner_manifest->max_key_version,
+                     sizeof(owner_manifest->max_key_version));
+  hmac_sha256_update(&owner_manifest->security_version,
+                     sizeof(owner_manifest->security_version));
+  hmac_sha256_update(&key_domain, sizeof(key_domain));
+  hmac_sha256_update(&ownership_transfers, sizeof(ownership_transfers));
+  hmac_sha256_process();
+  hmac_sha256_final(binding);
+}
+
 rom_error_t dice_chain_attestation_owner(
     const manifest_t *owner_manifest, keymgr_binding_value_t *bl0_measurement,
     hmac_digest_t *owner_measurement, keymgr_binding_value_t *sealing_binding,
-    owner_app_domain_t key_domain) {
+    owner_app_domain_t key_domain, uint32_t ownership_transfers) {
   // Handles the certificates from the immutable rom_ext first.
   RETURN_IF_ERROR(dice_chain_attestation_check_uds());
   RETURN_IF_ERROR(dice_chain_attestation_check_cdi_0());
@@ -424,11 +487,27 @@ rom_error_t dice_chain_attestation_owner(
       /*sealing_binding=*/sealing_binding,
       /*attest_binding=*/(keymgr_binding_value_t *)&attest_measurement,
       owner_manifest->max_key_version));
-  HARDENED_RETURN_IF_ERROR(otbn_boot_cert_ecc_p256_keygen(
-      kDiceKeyCdi1, &dice_chain.subject_pubkey_id, &dice_chain.subject_pubkey));
 
-  // Check if the current CDI_1 cert is valid.
-  RETURN_IF_ERROR(dice_chain_load_cert_obj("CDI_1", /*name_size=*/6));
+  // If the inputs are unchanged since the cache was written, check the cert
+  // against the cached key ID and skip the keygen. The X.509 validity check
+  // only looks at the key ID.
+  hmac_digest_t binding;
+  dice_chain_cdi_1_binding(&attest_measurement, owner_manifest, key_domain,
+                           ownership_transfers, &binding);
+  dice_chain_cache_t *cache = dice_chain_get_cache();
+  dice_chain.cert_valid = kHardenedBoolFalse;
+  if (memcmp(&cache->cdi_1_binding, &binding, sizeof(binding)) == 0) {
+    dice_chain.subject_pubkey_id = cache->cdi_1_pubkey_id;
+    RETURN_IF_ERROR(dice_chain_load_cert_obj("CDI_1", /*name_size=*/6));
+  }
+  if (dice_chain.cert_valid == kHardenedBoolFalse) {
+    HARDENED_RETURN_IF_ERROR(otbn_boot_cert_ecc_p256_keygen(
+        kDiceKeyCdi1, &dice_chain.subject_pubkey_id,
+        &dice_chain.subject_pubkey));
+
+    // Check if the current CDI_1 cert is valid.
+    RETURN_IF_ERROR(dice_chain_load_cert_obj("CDI_1", /*name_size=*/6));
+  }
   if (dice_chain.cert_valid == kHardenedBoolFalse) {
     dbg_puts("CDI_1 certificate not valid. Updating it ...\r\n");
     // Update the cert page buffer.
@@ -452,6 +531,15 @@ rom_error_t dice_chain_attestation_owner(
   }
   dice_chain.endorsement_pubkey_id = dice_chain.subject_pubkey_id;
 
+  // Refresh the cache record for the next boot.
+  if (memcmp(&cache->cdi_1_binding, &binding, sizeof(binding)) != 0 ||
+      memcmp(&cache->cdi_1_pubkey_id, &dice_chain.subject_pubkey_id,
+             sizeof(dice_chain.subject_pubkey_id)) != 0) {
+    cache->cdi_1_binding = binding;
+    cache->cdi_1_pubkey_id = dice_chain.subject_pubkey_id;
+    dice_chain.data_dirty = kHardenedBoolTrue;
+  }
+
   sc_keymgr_sw_binding_unlock_wait();
 
   return kErrorOk;
@@ -491,5 +579,9 @@ rom_error_t dice_chain_init(void) {
   flash_ctrl_info_cfg_set(&kFlashCtrlInfoPageFactoryCerts,
                           kCertificateInfoPageCfg);
   flash_ctrl_cert_info_page_owner_restrict(&kFlashCtrlInfoPageFactoryCerts);
+
+  // The attestation keys are generated by the OTBN boot-services program,
+  // which ROM has already loaded for signature verification.
+  HARDENED_RETURN_IF_ERROR(otbn_boot_app_resident_load());
   return kErrorOk;
 }
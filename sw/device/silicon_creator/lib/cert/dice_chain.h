@@ -53,13 +53,14 @@ rom_error_t dice_chain_attestation_creator(
  * @param sealing_binding Pointer to the owner's sealing diversification
  *        constant.
  * @param key_domain Domain of the Owner SW signing key.
+ * @param ownership_transfers Number of ownership transfers from boot data.
  * @return errors encountered during the operation.
  */
 OT_WARN_UNUSED_RESULT
 rom_error_t dice_chain_attestation_owner(
     const manifest_t *owner_manifest, keymgr_binding_value_t *bl0_measurement,
     hmac_digest_t *owner_measurement, keymgr_binding_value_t *sealing_binding,
-    owner_app_domain_t key_domain);
+    owner_app_domain_t key_domain, uint32_t ownership_transfers);
 
 /**
  * Write back the certificate chain to flash if changed.
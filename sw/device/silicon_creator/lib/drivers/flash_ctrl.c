@@ -228,6 +228,57 @@ static rom_error_t write(uint32_t addr, flash_ctrl_partition_t partition,
   return kErrorOk;
 }
 
+enum {
+  /**
+   * Number of words in an information page.
+   */
+  kInfoPageWordCount = FLASH_CTRL_PARAM_BYTES_PER_PAGE / sizeof(uint32_t),
+};
+
+/**
+ * Cached information pages, see `flash_ctrl_info_cache_enable()`.
+ */
+static flash_ctrl_info_cache_entry_t *info_cache;
+static size_t info_cache_count;
+
+/**
+ * Returns the cache entry of an information page, or NULL if the page is not
+ * cached.
+ *
+ * @param info_page An info page.
+ * @return The cache entry of the page.
+ */
+static flash_ctrl_info_cache_entry_t *info_cache_entry_get(
+    const flash_ctrl_info_page_t *info_page) {
+  for (size_t i = 0; i < info_cache_count; ++i) {
+    if (info_cache[i].info_page == info_page) {
+      return &info_cache[i];
+    }
+  }
+  return NULL;
+}
+
+/**
+ * Invalidates and wipes a cache entry.
+ *
+ * @param entry A cache entry.
+ */
+static void info_cache_entry_clear(flash_ctrl_info_cache_entry_t *entry) {
+  entry->valid = kHardenedBoolFalse;
+  for (size_t i = 0; i < kInfoPageWordCount; ++i) {
+    entry->data[i] = 0;
+  }
+}
+
+/**
+ * Invalidates and wipes all cache entries.
+ */
+static void info_cache_clear(void) {
+  for (size_t i = 0; i < info_cache_count; ++i) {
+    info_cache_entry_clear(&info_cache[i]);
+  }
+}
+
 /**
  * Disables all access to a page until next reset.
  *
@@ -237,6 +288,7 @@ static rom_error_t write(uint32_t addr, flash_ctrl_partition_t partition,
  * @param info_page An info page.
  */
 static void page_lockdown(const flash_ctrl_info_page_t *info_page) {
+  flash_ctrl_info_cache_evict(info_page);
   sec_mmio_write32(flash_ctrl_core_base() + info_page->cfg_offset, 0);
   sec_mmio_write32(flash_ctrl_core_base() + info_page->cfg_wen_offset, 0);
 }
@@ -352,9 +404,19 @@ rom_error_t flash_ctrl_data_read(uint32_t addr, uint32_t word_count,
   return wait_for_done(kErrorFlashCtrlDataRead);
 }
 
-rom_error_t flash_ctrl_info_read(const flash_ctrl_info_page_t *info_page,
-                                 uint32_t offset, uint32_t word_count,
-                                 void *data) {
+/**
+ * Reads data from an information page, bypassing the cache.
+ *
+ * @param info_page Information page to read from.
+ * @param offset Offset from the start of the page.
+ * @param word_count Number of bus words to read.
+ * @param[out] data Buffer to store the read data.
+ * @return Result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+static rom_error_t info_read(const flash_ctrl_info_page_t *info_page,
+                             uint32_t offset, uint32_t word_count,
+                             void *data) {
   transaction_start((transaction_params_t){
       .addr = info_page->base_addr + offset,
       .op_type = FLASH_CTRL_CONTROL_OP_VALUE_READ,
@@ -367,6 +429,31 @@ rom_error_t flash_ctrl_info_read(const flash_ctrl_info_page_t *info_page,
   return wait_for_done(kErrorFlashCtrlInfoRead);
 }
 
+rom_error_t flash_ctrl_info_read(const flash_ctrl_info_page_t *info_page,
+                                 uint32_t offset, uint32_t word_count,
+                                 void *data) {
+  flash_ctrl_info_cache_entry_t *entry = info_cache_entry_get(info_page);
+  const uint32_t word_offset = offset / sizeof(uint32_t);
+  if (entry != NULL && offset % sizeof(uint32_t) == 0 &&
+      word_offset <= kInfoPageWordCount &&
+      word_count <= kInfoPageWordCount - word_offset) {
+    if (launder32(entry->valid) != kHardenedBoolTrue &&
+        info_read(info_page, 0, kInfoPageWordCount, entry->data) == kErrorOk) {
+      entry->valid = kHardenedBoolTrue;
+    }
+    if (launder32(entry->valid) == kHardenedBoolTrue) {
+      HARDENED_CHECK_EQ(entry->valid, kHardenedBoolTrue);
+      memcpy(data, &entry->data[word_offset], word_count * sizeof(uint32_t));
+      return kErrorOk;
+    }
+    // Part of the page could not be read, e.g. because of an ECC error. Only
+    // read the requested words so that the caller gets the same result as
+    // without the cache.
+    info_cache_entry_clear(entry);
+  }
+  return info_read(info_page, offset, word_count, data);
+}
+
 rom_error_t flash_ctrl_info_read_zeros_on_read_error(
     const flash_ctrl_info_page_t *info_page, uint32_t offset,
     uint32_t word_count, void *data) {
@@ -383,6 +470,27 @@ rom_error_t flash_ctrl_info_read_zeros_on_read_error(
   return err;
 }
 
+void flash_ctrl_info_cache_enable(flash_ctrl_info_cache_entry_t *entries,
+                                  size_t count) {
+  info_cache_clear();
+  info_cache = entries;
+  info_cache_count = count;
+  info_cache_clear();
+}
+
+void flash_ctrl_info_cache_evict(const flash_ctrl_info_page_t *info_page) {
+  flash_ctrl_info_cache_entry_t *entry = info_cache_entry_get(info_page);
+  if (entry != NULL) {
+    info_cache_entry_clear(entry);
+  }
+}
+
+void flash_ctrl_info_cache_disable(void) {
+  info_cache_clear();
+  info_cache = NULL;
+  info_cache_count = 0;
+}
+
 void flash_ctrl_info_lock(const flash_ctrl_info_page_t *info_page) {
   abs_mmio_write32(flash_ctrl_core_base() + info_page->cfg_wen_offset, 0);
 }
@@ -396,6 +504,7 @@ rom_error_t flash_ctrl_data_write(uint32_t addr, uint32_t word_count,
 rom_error_t flash_ctrl_info_write(const flash_ctrl_info_page_t *info_page,
                                   uint32_t offset, uint32_t word_count,
                                   const void *data) {
+  flash_ctrl_info_cache_evict(info_page);
   const uint32_t addr = info_page->base_addr + offset;
   return write(addr, kFlashCtrlPartitionInfo0, word_count, data,
                kErrorFlashCtrlInfoWrite);
@@ -403,6 +512,12 @@ rom_error_t flash_ctrl_info_write(const flash_ctrl_info_page_t *info_page,
 
 rom_error_t flash_ctrl_data_erase(uint32_t addr,
                                   flash_ctrl_erase_type_t erase_type) {
+  flash_ctrl_data_erase_start(addr, erase_type);
+  return flash_ctrl_data_erase_finalize();
+}
+
+void flash_ctrl_data_erase_start(uint32_t addr,
+                                 flash_ctrl_erase_type_t erase_type) {
   transaction_start((transaction_params_t){
       .addr = addr,
       .op_type = FLASH_CTRL_CONTROL_OP_VALUE_ERASE,
@@ -411,6 +526,9 @@ rom_error_t flash_ctrl_data_erase(uint32_t addr,
       // Does not apply to erase transactions.
       .word_count = 1,
   });
+}
+
+rom_error_t flash_ctrl_data_erase_finalize(void) {
   return wait_for_done(kErrorFlashCtrlDataErase);
 }
 
@@ -465,6 +583,11 @@ rom_error_t flash_ctrl_data_erase_verify(uint32_t addr,
 
 rom_error_t flash_ctrl_info_erase(const flash_ctrl_info_page_t *info_page,
                                   flash_ctrl_erase_type_t erase_type) {
+  if (erase_type == kFlashCtrlEraseTypePage) {
+    flash_ctrl_info_cache_evict(info_page);
+  } else {
+    info_cache_clear();
+  }
   transaction_start((transaction_params_t){
       .addr = info_page->base_addr,
       .op_type = FLASH_CTRL_CONTROL_OP_VALUE_ERASE,
@@ -514,6 +637,10 @@ void flash_ctrl_info_perms_set(const flash_ctrl_info_page_t *info_page,
   reg = bitfield_field32_write(
       reg, FLASH_CTRL_BANK0_INFO0_PAGE_CFG_0_ERASE_EN_0_FIELD, perms.erase);
   sec_mmio_write32(flash_ctrl_core_base() + info_page->cfg_offset, reg);
+
+  if (perms.read != kMultiBitBool4True) {
+    flash_ctrl_info_cache_evict(info_page);
+  }
 }
 
 void flash_ctrl_data_default_cfg_set(flash_ctrl_cfg_t cfg) {
@@ -717,6 +844,9 @@ void flash_ctrl_info_cfg_set(const flash_ctrl_info_page_t *info_page,
   reg = bitfield_field32_write(
       reg, FLASH_CTRL_BANK0_INFO0_PAGE_CFG_0_HE_EN_0_FIELD, cfg.he);
   sec_mmio_write32(flash_ctrl_core_base() + info_page->cfg_offset, reg);
+
+  // Scrambling and ECC change what reads of the page return.
+  flash_ctrl_info_cache_evict(info_page);
 }
 
 void flash_ctrl_info_cfg_lock(const flash_ctrl_info_page_t *info_page) {
@@ -5,12 +5,15 @@
 #define OPENTITAN_SW_DEVICE_SILICON_CREATOR_LIB_DRIVERS_FLASH_CTRL_H_
 
 #include <limits.h>
+#include <stddef.h>
 
 #include "sw/device/lib/base/bitfield.h"
 #include "sw/device/lib/base/hardened.h"
 #include "sw/device/lib/base/multibits.h"
 #include "sw/device/silicon_creator/lib/error.h"
 
+#include "flash_ctrl_regs.h"  // Generated.
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -339,6 +342,59 @@ rom_error_t flash_ctrl_info_read_zeros_on_read_error(
     const flash_ctrl_info_page_t *info_page, uint32_t offset,
     uint32_t word_count, void *data);
 
+/**
+ * A RAM copy of an information page, see `flash_ctrl_info_cache_enable()`.
+ */
+typedef struct flash_ctrl_info_cache_entry {
+  /**
+   * Information page to cache.
+   */
+  const flash_ctrl_info_page_t *info_page;
+  /**
+   * Whether `data` holds the contents of the page.
+   */
+  hardened_bool_t valid;
+  /**
+   * Contents of the page.
+   */
+  uint32_t data[FLASH_CTRL_PARAM_BYTES_PER_PAGE / sizeof(uint32_t)];
+} flash_ctrl_info_cache_entry_t;
+
+/**
+ * Serves reads of the given information pages from RAM.
+ *
+ * The first `flash_ctrl_info_read()` of a page in `entries` reads the whole
+ * page in a single transaction and later reads of the page are copied from
+ * RAM. A page that cannot be read in full keeps being read from flash.
+ *
+ * The copy of a page is wiped when the page is written or erased, when its
+ * configuration changes and when its read permission is revoked or it is
+ * locked down, so a copy never outlives read access to the page.
+ *
+ * @param entries Cache entries, with `info_page` set. The storage must remain
+ *                valid until `flash_ctrl_info_cache_disable()`.
+ * @param count Number of entries.
+ */
+void flash_ctrl_info_cache_enable(flash_ctrl_info_cache_entry_t *entries,
+                                  size_t count);
+
+/**
+ * Wipes the RAM copy of an information page, if any.
+ *
+ * The page is read again in a single transaction the next time it is needed.
+ *
+ * @param info_page Information page to evict.
+ */
+void flash_ctrl_info_cache_evict(const flash_ctrl_info_page_t *info_page);
+
+/**
+ * Wipes all RAM copies of information pages and stops caching reads.
+ *
+ * After this call, the caller can reuse or shred the storage passed to
+ * `flash_ctrl_info_cache_enable()`.
+ */
+void flash_ctrl_info_cache_disable(void);
+
 /**
  * Locks the configuration of an information page.
  *
@@ -419,6 +475,28 @@ OT_WARN_UNUSED_RESULT
 rom_error_t flash_ctrl_data_erase(uint32_t addr,
                                   flash_ctrl_erase_type_t erase_type);
 
+/**
+ * Starts erasing a data partition page or bank without waiting for it.
+ *
+ * Ibex may do other work, such as receiving the data for the next page,
+ * while the erase runs. No other flash_ctrl operation may be started until
+ * `flash_ctrl_data_erase_finalize()` returns. Host reads from the bank being
+ * erased stall until the erase completes.
+ *
+ * @param addr Address that falls within the bank or page being deleted.
+ * @param erase_type Whether to erase a page or a bank.
+ */
+void flash_ctrl_data_erase_start(uint32_t addr,
+                                 flash_ctrl_erase_type_t erase_type);
+
+/**
+ * Waits for an erase started with `flash_ctrl_data_erase_start()`.
+ *
+ * @return Result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+rom_error_t flash_ctrl_data_erase_finalize(void);
+
 /**
  * Verifies that a data partition page or bank was erased.
  *
@@ -4,6 +4,7 @@
 
 #include "sw/device/silicon_creator/lib/drivers/flash_ctrl.h"
 
+#include <algorithm>
 #include <array>
 
 #include "absl/strings/str_cat.h"
@@ -368,6 +369,16 @@ TEST_F(TransferTest, EraseDataPageOk) {
             kErrorOk);
 }
 
+TEST_F(TransferTest, EraseDataPageStartFinalize) {
+  ExpectTransferStart(0, 0, 0, FLASH_CTRL_CONTROL_OP_VALUE_ERASE, 0x01234567,
+                      1);
+  flash_ctrl_data_erase_start(0x01234567, kFlashCtrlEraseTypePage);
+
+  ExpectWaitForDone(false, false);
+  ExpectWaitForDone(true, false);
+  EXPECT_EQ(flash_ctrl_data_erase_finalize(), kErrorOk);
+}
+
 TEST_F(TransferTest, EraseInfoPageOk) {
   // Address of the `kFlashCtrlInfoPageOwnerSlot0` page, see `info_page_addr`.
   const uint32_t addr =
@@ -428,6 +439,114 @@ TEST_F(TransferTest, TransferInternalError) {
             kErrorFlashCtrlDataRead);
 }
 
+class InfoCacheTest : public TransferTest {
+ protected:
+  static constexpr uint32_t kPageWords =
+      FLASH_CTRL_PARAM_BYTES_PER_PAGE / sizeof(uint32_t);
+  // Address of the `kFlashCtrlInfoPageBootData0` page, see `info_page_addr`.
+  const uint32_t addr_ = 1 * FLASH_CTRL_PARAM_BYTES_PER_BANK;
+
+  InfoCacheTest() : page_(kPageWords) {
+    for (uint32_t i = 0; i < kPageWords; ++i) {
+      page_[i] = i * 0x01010101;
+    }
+    cache_[0].info_page = &kFlashCtrlInfoPageBootData0;
+    flash_ctrl_info_cache_enable(cache_.data(), cache_.size());
+  }
+
+  ~InfoCacheTest() override { flash_ctrl_info_cache_disable(); }
+
+  void ExpectPageFill(bool error) {
+    ExpectTransferStart(1, 0, 0, FLASH_CTRL_CONTROL_OP_VALUE_READ, addr_,
+                        kPageWords);
+    ExpectReadData(page_);
+    ExpectWaitForDone(true, error);
+  }
+
+  void CheckRead(uint32_t offset, uint32_t word_count) {
+    std::vector<uint32_t> words_out(word_count);
+    EXPECT_EQ(flash_ctrl_info_read(&kFlashCtrlInfoPageBootData0, offset,
+                                   word_count, &words_out.front()),
+              kErrorOk);
+    auto begin = page_.begin() + offset / sizeof(uint32_t);
+    EXPECT_EQ(words_out, std::vector<uint32_t>(begin, begin + word_count));
+  }
+
+  std::vector<uint32_t> page_;
+  std::array<flash_ctrl_info_cache_entry_t, 1> cache_{};
+};
+
+TEST_F(InfoCacheTest, ReadsPageOnce) {
+  ExpectPageFill(false);
+  CheckRead(0x40, 3);
+  CheckRead(0x7f0, 4);
+  CheckRead(0, kPageWords);
+}
+
+TEST_F(InfoCacheTest, UncachedPage) {
+  // Address of the `kFlashCtrlInfoPageOwnerSlot0` page, see `info_page_addr`.
+  const uint32_t addr =
+      1 * FLASH_CTRL_PARAM_BYTES_PER_BANK + 2 * FLASH_CTRL_PARAM_BYTES_PER_PAGE;
+  ExpectTransferStart(1, 0, 0, FLASH_CTRL_CONTROL_OP_VALUE_READ, addr,
+                      words_.size());
+  ExpectReadData(words_);
+  ExpectWaitForDone(true, false);
+  std::vector<uint32_t> words_out(words_.size());
+  EXPECT_EQ(flash_ctrl_info_read(&kFlashCtrlInfoPageOwnerSlot0, 0,
+                                 words_.size(), &words_out.front()),
+            kErrorOk);
+  EXPECT_EQ(words_out, words_);
+}
+
+TEST_F(InfoCacheTest, FillErrorReadsWords) {
+  ExpectPageFill(true);
+  ExpectTransferStart(1, 0, 0, FLASH_CTRL_CONTROL_OP_VALUE_READ, addr_ + 0x40,
+                      words_.size());
+  ExpectReadData(words_);
+  ExpectWaitForDone(true, true);
+  std::vector<uint32_t> words_out(words_.size());
+  EXPECT_EQ(flash_ctrl_info_read(&kFlashCtrlInfoPageBootData0, 0x40,
+                                 words_.size(), &words_out.front()),
+            kErrorFlashCtrlInfoRead);
+  EXPECT_THAT(cache_[0].data, Each(0));
+}
+
+TEST_F(InfoCacheTest, WriteEvicts) {
+  ExpectPageFill(false);
+  CheckRead(0x40, 3);
+
+  ExpectTransferStart(1, 0, 0, FLASH_CTRL_CONTROL_OP_VALUE_PROG, addr_ + 0x40,
+                      words_.size());
+  ExpectProgData(words_);
+  ExpectWaitForDone(true, false);
+  EXPECT_EQ(flash_ctrl_info_write(&kFlashCtrlInfoPageBootData0, 0x40,
+                                  words_.size(), &words_.front()),
+            kErrorOk);
+  EXPECT_THAT(cache_[0].data, Each(0));
+
+  std::copy(words_.begin(), words_.end(), page_.begin() + 0x10);
+  ExpectPageFill(false);
+  CheckRead(0x40, words_.size());
+}
+
+TEST_F(InfoCacheTest, ReadPermRevokeEvicts) {
+  ExpectPageFill(false);
+  CheckRead(0x40, 3);
+
+  const uint32_t cfg_offset =
+      InfoPages().at(&kFlashCtrlInfoPageBootData0).cfg_offset;
+  EXPECT_SEC_READ32(base_ + cfg_offset, 0x9999999);
+  EXPECT_SEC_WRITE32(base_ + cfg_offset, 0x9999996);
+  flash_ctrl_info_perms_set(&kFlashCtrlInfoPageBootData0,
+                            {
+                                .read = kMultiBitBool4False,
+                                .write = kMultiBitBool4False,
+                                .erase = kMultiBitBool4False,
+                            });
+  EXPECT_EQ(cache_[0].valid, kHardenedBoolFalse);
+  EXPECT_THAT(cache_[0].data, Each(0));
+}
+
 class ExecTest : public FlashCtrlTest {};
 
 TEST_F(ExecTest, Set) {
@@ -40,6 +40,10 @@ void hmac_sha256_configure(bool big_endian_digest) {
   abs_mmio_write32(hmac_base() + HMAC_CFG_REG_OFFSET, reg);
 }
 
+uint32_t hmac_sha256_cfg_get(void) {
+  return abs_mmio_read32(hmac_base() + HMAC_CFG_REG_OFFSET);
+}
+
 inline void hmac_sha256_start(void) {
   uint32_t cmd = bitfield_bit32_write(0, HMAC_CMD_HASH_START_BIT, true);
   abs_mmio_write32(hmac_base() + HMAC_CMD_REG_OFFSET, cmd);
@@ -90,11 +94,15 @@ static void wait_for_done(void) {
 }
 
 void hmac_sha256_final_truncated(uint32_t *digest, size_t len) {
+  hmac_sha256_final_truncated_cfg(digest, len, hmac_sha256_cfg_get());
+}
+
+void hmac_sha256_final_truncated_cfg(uint32_t *digest, size_t len,
+                                     uint32_t cfg) {
   wait_for_done();
 
   uint32_t result, incr;
-  uint32_t reg = abs_mmio_read32(hmac_base() + HMAC_CFG_REG_OFFSET);
-  if (bitfield_bit32_read(reg, HMAC_CFG_DIGEST_SWAP_BIT)) {
+  if (bitfield_bit32_read(cfg, HMAC_CFG_DIGEST_SWAP_BIT)) {
     // Big-endian output.
     result = HMAC_DIGEST_0_REG_OFFSET;
     incr = sizeof(uint32_t);
@@ -153,9 +161,12 @@ void hmac_sha256_save(hmac_context_t *ctx) {
 }
 
 void hmac_sha256_restore(const hmac_context_t *ctx) {
+  hmac_sha256_restore_cfg(ctx, hmac_sha256_cfg_get());
+}
+
+void hmac_sha256_restore_cfg(const hmac_context_t *ctx, uint32_t cfg) {
   // Clear the `sha_en` bit to ensure the message length registers are
   // writeable. Leave the rest of the configuration unchanged.
-  uint32_t cfg = abs_mmio_read32(hmac_base() + HMAC_CFG_REG_OFFSET);
   cfg = bitfield_bit32_write(cfg, HMAC_CFG_SHA_EN_BIT, false);
   abs_mmio_write32(hmac_base() + HMAC_CFG_REG_OFFSET, cfg);
 
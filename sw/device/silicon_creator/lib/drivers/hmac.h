@@ -56,6 +56,18 @@ typedef struct hmac_context {
  */
 void hmac_sha256_configure(bool big_endian_digest);
 
+/**
+ * Reads the current configuration of the HMAC block.
+ *
+ * Hot loops that restore and finalize many short operations under the same
+ * configuration can read it once with this function and pass it to
+ * `hmac_sha256_restore_cfg()` and `hmac_sha256_final_truncated_cfg()`, which
+ * saves a register read in each of those calls.
+ *
+ * @return The value of the HMAC configuration register.
+ */
+uint32_t hmac_sha256_cfg_get(void);
+
 /**
  * Starts a new operation on the pre-configured HMAC block.
  *
@@ -113,6 +125,16 @@ void hmac_sha256_process(void);
  */
 void hmac_sha256_final_truncated(uint32_t *digest, size_t len);
 
+/**
+ * Same as `hmac_sha256_final_truncated()`, for a known configuration.
+ *
+ * @param[out] digest Buffer to copy digest to.
+ * @param[out] len Requested word-length.
+ * @param cfg Current configuration, as returned by `hmac_sha256_cfg_get()`.
+ */
+void hmac_sha256_final_truncated_cfg(uint32_t *digest, size_t len,
+                                     uint32_t cfg);
+
 /**
  * Finalizes SHA256 operation and writes `digest` buffer.
  *
@@ -161,6 +183,14 @@ void hmac_sha256_save(hmac_context_t *ctx);
  */
 void hmac_sha256_restore(const hmac_context_t *ctx);
 
+/**
+ * Same as `hmac_sha256_restore()`, for a known configuration.
+ *
+ * @param ctx Saved operation state.
+ * @param cfg Current configuration, as returned by `hmac_sha256_cfg_get()`.
+ */
+void hmac_sha256_restore_cfg(const hmac_context_t *ctx, uint32_t cfg);
+
 #ifdef __cplusplus
 }
 #endif
@@ -203,7 +203,7 @@ static rom_error_t keymgr_wait_until_done(void) {
   return kErrorKeymgrInternal;
 }
 
-rom_error_t sc_keymgr_generate_key(
+rom_error_t sc_keymgr_generate_key_start(
     sc_keymgr_dest_t destination, sc_keymgr_key_type_t key_type,
     sc_keymgr_diversification_t diversification) {
   HARDENED_RETURN_IF_ERROR(keymgr_is_idle());
@@ -239,11 +239,21 @@ rom_error_t sc_keymgr_generate_key(
 
   // Issue the start command.
   abs_mmio_write32(kBase + KEYMGR_START_REG_OFFSET, 1 << KEYMGR_START_EN_BIT);
+  return kErrorOk;
+}
 
-  // Block until keymgr is done.
+rom_error_t sc_keymgr_generate_key_finalize(void) {
   return keymgr_wait_until_done();
 }
 
+rom_error_t sc_keymgr_generate_key(
+    sc_keymgr_dest_t destination, sc_keymgr_key_type_t key_type,
+    sc_keymgr_diversification_t diversification) {
+  HARDENED_RETURN_IF_ERROR(
+      sc_keymgr_generate_key_start(destination, key_type, diversification));
+  return sc_keymgr_generate_key_finalize();
+}
+
 rom_error_t sc_keymgr_sideload_clear(sc_keymgr_dest_t destination) {
   HARDENED_RETURN_IF_ERROR(keymgr_is_idle());
 
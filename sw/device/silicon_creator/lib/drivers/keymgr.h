@@ -248,6 +248,34 @@ rom_error_t sc_keymgr_generate_key(sc_keymgr_dest_t destination,
                                    sc_keymgr_key_type_t key_type,
                                    sc_keymgr_diversification_t diversification);
 
+/**
+ * Starts generating a key manager key and sideloading it to the requested
+ * block, without waiting for the operation to complete.
+ *
+ * Ibex is free to use other peripherals while the key manager runs, e.g. to
+ * prepare the inputs of the operation that consumes the key. The caller must
+ * call `sc_keymgr_generate_key_finalize()` before issuing another key manager
+ * operation or using the sideloaded key.
+ *
+ * @param destination: Hardware destination for key material.
+ * @param key_type Key type: attestation or sealing.
+ * @param diversification Diversification input for the key derivation.
+ * @return OK or error.
+ */
+OT_WARN_UNUSED_RESULT
+rom_error_t sc_keymgr_generate_key_start(
+    sc_keymgr_dest_t destination, sc_keymgr_key_type_t key_type,
+    sc_keymgr_diversification_t diversification);
+
+/**
+ * Waits for a key generation started with `sc_keymgr_generate_key_start()`
+ * to complete.
+ *
+ * @return OK or error.
+ */
+OT_WARN_UNUSED_RESULT
+rom_error_t sc_keymgr_generate_key_finalize(void);
+
 /**
  * Clear the requested sideloaded key slot.
  *
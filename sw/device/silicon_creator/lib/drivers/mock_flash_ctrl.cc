@@ -46,6 +46,15 @@ rom_error_t flash_ctrl_data_erase(uint32_t addr,
   return MockFlashCtrl::Instance().DataErase(addr, erase_type);
 }
 
+void flash_ctrl_data_erase_start(uint32_t addr,
+                                 flash_ctrl_erase_type_t erase_type) {
+  MockFlashCtrl::Instance().DataEraseStart(addr, erase_type);
+}
+
+rom_error_t flash_ctrl_data_erase_finalize(void) {
+  return MockFlashCtrl::Instance().DataEraseFinalize();
+}
+
 rom_error_t flash_ctrl_data_erase_verify(uint32_t addr,
                                          flash_ctrl_erase_type_t erase_type) {
   return MockFlashCtrl::Instance().DataEraseVerify(addr, erase_type);
@@ -56,6 +65,19 @@ rom_error_t flash_ctrl_info_erase(const flash_ctrl_info_page_t *info_page,
   return MockFlashCtrl::Instance().InfoErase(info_page, erase_type);
 }
 
+void flash_ctrl_info_cache_enable(flash_ctrl_info_cache_entry_t *entries,
+                                  size_t count) {
+  MockFlashCtrl::Instance().InfoCacheEnable(entries, count);
+}
+
+void flash_ctrl_info_cache_evict(const flash_ctrl_info_page_t *info_page) {
+  MockFlashCtrl::Instance().InfoCacheEvict(info_page);
+}
+
+void flash_ctrl_info_cache_disable(void) {
+  MockFlashCtrl::Instance().InfoCacheDisable();
+}
+
 void flash_ctrl_data_default_perms_set(flash_ctrl_perms_t perms) {
   MockFlashCtrl::Instance().DataDefaultPermsSet(perms);
 }
@@ -28,10 +28,15 @@ class MockFlashCtrl : public global_mock::GlobalMock<MockFlashCtrl> {
               (const flash_ctrl_info_page_t *, uint32_t, uint32_t,
                const void *));
   MOCK_METHOD(rom_error_t, DataErase, (uint32_t, flash_ctrl_erase_type_t));
+  MOCK_METHOD(void, DataEraseStart, (uint32_t, flash_ctrl_erase_type_t));
+  MOCK_METHOD(rom_error_t, DataEraseFinalize, ());
   MOCK_METHOD(rom_error_t, DataEraseVerify,
               (uint32_t, flash_ctrl_erase_type_t));
   MOCK_METHOD(rom_error_t, InfoErase,
               (const flash_ctrl_info_page_t *, flash_ctrl_erase_type_t));
+  MOCK_METHOD(void, InfoCacheEnable, (flash_ctrl_info_cache_entry_t *, size_t));
+  MOCK_METHOD(void, InfoCacheEvict, (const flash_ctrl_info_page_t *));
+  MOCK_METHOD(void, InfoCacheDisable, ());
   MOCK_METHOD(void, DataDefaultPermsSet, (flash_ctrl_perms_t));
   MOCK_METHOD(void, InfoPermsSet,
               (const flash_ctrl_info_page_t *, flash_ctrl_perms_t));
@@ -10,6 +10,10 @@ void hmac_sha256_configure(bool big_endian_digest) {
   MockHmac::Instance().sha256_configure(big_endian_digest);
 }
 
+uint32_t hmac_sha256_cfg_get(void) {
+  return MockHmac::Instance().sha256_cfg_get();
+}
+
 void hmac_sha256_start(void) { MockHmac::Instance().sha256_start(); }
 
 void hmac_sha256_init(void) { MockHmac::Instance().sha256_init(); }
@@ -28,6 +32,11 @@ void hmac_sha256_final_truncated(uint32_t *digest, size_t len) {
   MockHmac::Instance().sha256_final_truncated(digest, len);
 }
 
+void hmac_sha256_final_truncated_cfg(uint32_t *digest, size_t len,
+                                     uint32_t cfg) {
+  MockHmac::Instance().sha256_final_truncated_cfg(digest, len, cfg);
+}
+
 void hmac_sha256_final(hmac_digest_t *digest) {
   MockHmac::Instance().sha256_final(digest);
 }
@@ -43,5 +52,9 @@ void hmac_sha256_save(hmac_context_t *ctx) {
 void hmac_sha256_restore(const hmac_context_t *ctx) {
   MockHmac::Instance().sha256_restore(ctx);
 }
+
+void hmac_sha256_restore_cfg(const hmac_context_t *ctx, uint32_t cfg) {
+  MockHmac::Instance().sha256_restore_cfg(ctx, cfg);
+}
 }  // extern "C"
 }  // namespace rom_test
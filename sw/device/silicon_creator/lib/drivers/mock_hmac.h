@@ -18,16 +18,19 @@ namespace internal {
 class MockHmac : public global_mock::GlobalMock<MockHmac> {
  public:
   MOCK_METHOD(void, sha256_configure, (bool));
+  MOCK_METHOD(uint32_t, sha256_cfg_get, ());
   MOCK_METHOD(void, sha256_start, ());
   MOCK_METHOD(void, sha256_init, ());
   MOCK_METHOD(void, sha256_update, (const void *, size_t));
   MOCK_METHOD(void, sha256_update_words, (const uint32_t *, size_t));
   MOCK_METHOD(void, sha256_process, ());
   MOCK_METHOD(void, sha256_final_truncated, (uint32_t *, size_t));
+  MOCK_METHOD(void, sha256_final_truncated_cfg, (uint32_t *, size_t, uint32_t));
   MOCK_METHOD(void, sha256_final, (hmac_digest_t *));
   MOCK_METHOD(void, sha256, (const void *, size_t, hmac_digest_t *));
   MOCK_METHOD(void, sha256_save, (hmac_context_t *));
   MOCK_METHOD(void, sha256_restore, (const hmac_context_t *));
+  MOCK_METHOD(void, sha256_restore_cfg, (const hmac_context_t *, uint32_t));
 };
 
 }  // namespace internal
@@ -22,6 +22,10 @@ void otp_read(uint32_t address, uint32_t *data, size_t num_words) {
   return MockOtp::Instance().read(address, data, num_words);
 }
 
+rom_error_t otp_snapshot(otp_partition_t partition) {
+  return MockOtp::Instance().Snapshot(partition);
+}
+
 void otp_creator_sw_cfg_lockdown(void) {
   MockOtp::Instance().CreatorSwCfgLockdown();
 }
@@ -20,6 +20,7 @@ class MockOtp : public global_mock::GlobalMock<MockOtp> {
   MOCK_METHOD(uint32_t, read32, (uint32_t address));
   MOCK_METHOD(uint32_t, read64, (uint32_t address));
   MOCK_METHOD(void, read, (uint32_t address, uint32_t *data, size_t num_words));
+  MOCK_METHOD(rom_error_t, Snapshot, (otp_partition_t partition));
   MOCK_METHOD(void, CreatorSwCfgLockdown, ());
 };
 
@@ -68,9 +68,40 @@ rom_error_t sc_otbn_busy_wait_for_done(void) {
   return kErrorOtbnUnavailable;
 }
 
+/**
+ * Copies words `start` to `end - 1` of `src` to OTBN's DMEM or IMEM.
+ *
+ * The loop is unrolled four times and has no per-word hardening; the caller
+ * checks the returned count once the whole transfer is done.
+ *
+ * @param dest_addr Destination address of word 0.
+ * @param src Source buffer.
+ * @param start First word to copy.
+ * @param end One past the last word to copy.
+ * @return Number of words copied.
+ */
+static uint32_t sc_otbn_write_range(uint32_t dest_addr, const uint32_t *src,
+                                    uint32_t start, uint32_t end) {
+  uint32_t i = start;
+  for (; launder32(i) + 4 <= end; i += 4) {
+    abs_mmio_write32(dest_addr + i * sizeof(uint32_t), src[i]);
+    abs_mmio_write32(dest_addr + (i + 1) * sizeof(uint32_t), src[i + 1]);
+    abs_mmio_write32(dest_addr + (i + 2) * sizeof(uint32_t), src[i + 2]);
+    abs_mmio_write32(dest_addr + (i + 3) * sizeof(uint32_t), src[i + 3]);
+  }
+  for (; launder32(i) < end; ++i) {
+    abs_mmio_write32(dest_addr + i * sizeof(uint32_t), src[i]);
+  }
+  return i - start;
+}
+
 /**
  * Helper function for writing to OTBN's DMEM or IMEM.
  *
+ * Like `hardened_memcpy()`, the copy starts at a random word (wrapping around
+ * at the end) and the number of words copied is checked once at the end,
+ * rather than on every word.
+ *
  * @param dest_addr Destination address.
  * @param src Source buffer.
  * @param num_words Number of words to copy.
@@ -78,20 +109,10 @@ rom_error_t sc_otbn_busy_wait_for_done(void) {
 static void sc_otbn_write(uint32_t dest_addr, const uint32_t *src,
                           size_t num_words) {
   // Start from a random index less than `num_words`.
-  uint32_t i = ((uint64_t)rnd_uint32() * (uint64_t)num_words) >> 32;
-  enum { kStep = 1 };
-  uint32_t iter_cnt = 0, r_iter_cnt = num_words - 1;
-  for (; launder32(iter_cnt) < num_words && launder32(r_iter_cnt) < num_words;
-       ++iter_cnt, --r_iter_cnt) {
-    abs_mmio_write32(dest_addr + i * sizeof(uint32_t), src[i]);
-    i += kStep;
-    if (launder32(i) >= num_words) {
-      i -= num_words;
-    }
-    HARDENED_CHECK_LT(i, num_words);
-  }
-  HARDENED_CHECK_EQ(iter_cnt, num_words);
-  HARDENED_CHECK_EQ(r_iter_cnt, UINT32_MAX);
+  uint32_t start = ((uint64_t)rnd_uint32() * (uint64_t)num_words) >> 32;
+  uint32_t count = sc_otbn_write_range(dest_addr, src, start, num_words);
+  count += sc_otbn_write_range(dest_addr, src, 0, start);
+  HARDENED_CHECK_EQ(count, num_words);
 }
 
 OT_WARN_UNUSED_RESULT
@@ -115,38 +136,52 @@ rom_error_t sc_otbn_dmem_read(size_t num_words, sc_otbn_addr_t src,
                               uint32_t *dest) {
   HARDENED_RETURN_IF_ERROR(
       check_offset_len(src, num_words, OTBN_DMEM_SIZE_BYTES));
-  uint32_t i = 0, r = num_words - 1;
-  for (; launder32(i) < num_words && launder32(r) < num_words; ++i, --r) {
-    dest[i] = abs_mmio_read32(kBase + OTBN_DMEM_REG_OFFSET + src +
-                              i * sizeof(uint32_t));
+  uint32_t src_addr = kBase + OTBN_DMEM_REG_OFFSET + src;
+  uint32_t i = 0;
+  for (; launder32(i) + 4 <= num_words; i += 4) {
+    dest[i] = abs_mmio_read32(src_addr + i * sizeof(uint32_t));
+    dest[i + 1] = abs_mmio_read32(src_addr + (i + 1) * sizeof(uint32_t));
+    dest[i + 2] = abs_mmio_read32(src_addr + (i + 2) * sizeof(uint32_t));
+    dest[i + 3] = abs_mmio_read32(src_addr + (i + 3) * sizeof(uint32_t));
+  }
+  for (; launder32(i) < num_words; ++i) {
+    dest[i] = abs_mmio_read32(src_addr + i * sizeof(uint32_t));
   }
   HARDENED_CHECK_EQ(i, num_words);
-  HARDENED_CHECK_EQ(r, UINT32_MAX);
   return kErrorOk;
 }
 
+enum {
+  kIntrStateDone = (1 << OTBN_INTR_COMMON_DONE_BIT),
+};
+
 /**
- * Helper function for running an OTBN command.
+ * Helper function for issuing an OTBN command without waiting for it.
+ *
+ * @param cmd OTBN command.
+ */
+static void sc_otbn_cmd_issue(sc_otbn_cmd_t cmd) {
+  abs_mmio_write32(kBase + OTBN_INTR_STATE_REG_OFFSET, kIntrStateDone);
+  abs_mmio_write32(kBase + OTBN_CMD_REG_OFFSET, cmd);
+}
+
+/**
+ * Helper function for waiting for a command issued with `sc_otbn_cmd_issue()`.
  *
  * This function blocks until OTBN is idle.
  *
- * @param cmd OTBN command.
  * @param error Error to return if operation fails.
  * @return Result of the operation.
  */
 OT_WARN_UNUSED_RESULT
-static rom_error_t sc_otbn_cmd_run(sc_otbn_cmd_t cmd, rom_error_t error) {
+static rom_error_t sc_otbn_cmd_wait(rom_error_t error) {
   enum {
-    kIntrStateDone = (1 << OTBN_INTR_COMMON_DONE_BIT),
     // Use a bit index that doesn't overlap with error bits.
     kResDoneBit = 31,
   };
   static_assert((UINT32_C(1) << kResDoneBit) > kOtbnErrBitsLast,
                 "kResDoneBit must not overlap with OTBN error bits");
 
-  abs_mmio_write32(kBase + OTBN_INTR_STATE_REG_OFFSET, kIntrStateDone);
-  abs_mmio_write32(kBase + OTBN_CMD_REG_OFFSET, cmd);
-
   rom_error_t res = kErrorOk ^ (UINT32_C(1) << kResDoneBit);
   uint32_t reg = 0;
   do {
@@ -177,7 +212,22 @@ static rom_error_t sc_otbn_cmd_run(sc_otbn_cmd_t cmd, rom_error_t error) {
   return error;
 }
 
-rom_error_t sc_otbn_execute(void) {
+/**
+ * Helper function for running an OTBN command.
+ *
+ * This function blocks until OTBN is idle.
+ *
+ * @param cmd OTBN command.
+ * @param error Error to return if operation fails.
+ * @return Result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+static rom_error_t sc_otbn_cmd_run(sc_otbn_cmd_t cmd, rom_error_t error) {
+  sc_otbn_cmd_issue(cmd);
+  return sc_otbn_cmd_wait(error);
+}
+
+rom_error_t sc_otbn_execute_start(void) {
   // If OTBN is busy, wait for it to be done.
   HARDENED_RETURN_IF_ERROR(sc_otbn_busy_wait_for_done());
 
@@ -187,13 +237,40 @@ rom_error_t sc_otbn_execute(void) {
   sec_mmio_write32(kBase + OTBN_CTRL_REG_OFFSET,
                    1 << OTBN_CTRL_SOFTWARE_ERRS_FATAL_BIT);
 
-  return sc_otbn_cmd_run(kScOtbnCmdExecute, kErrorOtbnExecutionFailed);
+  sc_otbn_cmd_issue(kScOtbnCmdExecute);
+  return kErrorOk;
+}
+
+rom_error_t sc_otbn_execute_finalize(void) {
+  return sc_otbn_cmd_wait(kErrorOtbnExecutionFailed);
+}
+
+rom_error_t sc_otbn_execute(void) {
+  HARDENED_RETURN_IF_ERROR(sc_otbn_execute_start());
+  return sc_otbn_execute_finalize();
 }
 
 uint32_t sc_otbn_instruction_count_get(void) {
   return abs_mmio_read32(kBase + OTBN_INSN_CNT_REG_OFFSET);
 }
 
+void sc_otbn_instruction_count_wait(uint32_t insn_count) {
+  // The instruction count is only reset once OTBN starts executing, so it is
+  // only meaningful while the status is `kScOtbnStatusBusyExecute`. The `done`
+  // interrupt, which `sc_otbn_cmd_wait()` clears after each command, signals
+  // that the program has already stopped.
+  uint32_t status;
+  uint32_t count;
+  do {
+    uint32_t intr_state = abs_mmio_read32(kBase + OTBN_INTR_STATE_REG_OFFSET);
+    if (bitfield_bit32_read(intr_state, OTBN_INTR_COMMON_DONE_BIT)) {
+      return;
+    }
+    status = abs_mmio_read32(kBase + OTBN_STATUS_REG_OFFSET);
+    count = abs_mmio_read32(kBase + OTBN_INSN_CNT_REG_OFFSET);
+  } while (status != kScOtbnStatusBusyExecute || count < insn_count);
+}
+
 rom_error_t sc_otbn_imem_sec_wipe(void) {
   return sc_otbn_cmd_run(kScOtbnCmdSecWipeImem, kErrorOtbnSecWipeImemFailed);
 }
@@ -248,3 +325,46 @@ rom_error_t sc_otbn_load_app(const sc_otbn_app_t app) {
   }
   return kErrorOk;
 }
+
+rom_error_t sc_otbn_load_app_resident(const sc_otbn_app_t app) {
+  HARDENED_RETURN_IF_ERROR(check_app_address_ranges(app));
+
+  // If OTBN is busy, wait for it to be done.
+  HARDENED_RETURN_IF_ERROR(sc_otbn_busy_wait_for_done());
+
+  const size_t imem_num_words = (size_t)(app.imem_end - app.imem_start);
+  const size_t data_num_words =
+      (size_t)(app.dmem_data_end - app.dmem_data_start);
+  HARDENED_RETURN_IF_ERROR(
+      check_offset_len(0, imem_num_words, OTBN_IMEM_SIZE_BYTES));
+  HARDENED_RETURN_IF_ERROR(check_offset_len(
+      app.dmem_data_start_addr, data_num_words, OTBN_DMEM_SIZE_BYTES));
+
+  // Only DMEM is wiped; it may hold secrets from the previous boot stage.
+  HARDENED_RETURN_IF_ERROR(sc_otbn_dmem_sec_wipe());
+
+  // `LOAD_CHECKSUM` only covers writes, so write every IMEM word back in
+  // place. Both memories are written in order, since the checksum depends on
+  // the order of the writes.
+  abs_mmio_write32(kBase + OTBN_LOAD_CHECKSUM_REG_OFFSET, 0);
+  uint32_t imem_addr = kBase + OTBN_IMEM_REG_OFFSET;
+  uint32_t i = 0;
+  for (; launder32(i) < imem_num_words; ++i) {
+    uint32_t addr = imem_addr + i * sizeof(uint32_t);
+    abs_mmio_write32(addr, abs_mmio_read32(addr));
+  }
+  HARDENED_CHECK_EQ(i, imem_num_words);
+
+  uint32_t data_addr = kBase + OTBN_DMEM_REG_OFFSET + app.dmem_data_start_addr;
+  uint32_t count =
+      sc_otbn_write_range(data_addr, app.dmem_data_start, 0, data_num_words);
+  HARDENED_CHECK_EQ(count, data_num_words);
+
+  uint32_t checksum = abs_mmio_read32(kBase + OTBN_LOAD_CHECKSUM_REG_OFFSET);
+  if (launder32(checksum) == app.checksum) {
+    HARDENED_CHECK_EQ(checksum, app.checksum);
+    return kErrorOk;
+  }
+  // IMEM doesn't hold this application; load it from scratch.
+  return sc_otbn_load_app(app);
+}
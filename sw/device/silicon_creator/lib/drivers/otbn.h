@@ -113,6 +113,14 @@ typedef struct sc_otbn_app {
    * time.
    */
   const sc_otbn_addr_t dmem_data_start_addr;
+  /**
+   * Application checksum.
+   *
+   * CRC32 over IMEM and the `.data` portion of DMEM, in the form accumulated
+   * by OTBN's `LOAD_CHECKSUM` register when the application is written in
+   * order (see `util/otbn_build.py`).
+   */
+  const uint32_t checksum;
 } sc_otbn_app_t;
 
 /**
@@ -177,12 +185,13 @@ typedef struct sc_otbn_app {
  * @param app_name Name of the application to load, which is typically the
  *                 name of the main (assembly) source file.
  */
-#define OTBN_DECLARE_APP_SYMBOLS(app_name)             \
-  OTBN_DECLARE_SYMBOL_PTR(app_name, _imem_start);      \
-  OTBN_DECLARE_SYMBOL_PTR(app_name, _imem_end);        \
-  OTBN_DECLARE_SYMBOL_PTR(app_name, _dmem_data_start); \
-  OTBN_DECLARE_SYMBOL_PTR(app_name, _dmem_data_end);   \
-  OTBN_DECLARE_SYMBOL_ADDR(app_name, _dmem_data_start);
+#define OTBN_DECLARE_APP_SYMBOLS(app_name)              \
+  OTBN_DECLARE_SYMBOL_PTR(app_name, _imem_start);       \
+  OTBN_DECLARE_SYMBOL_PTR(app_name, _imem_end);         \
+  OTBN_DECLARE_SYMBOL_PTR(app_name, _dmem_data_start);  \
+  OTBN_DECLARE_SYMBOL_PTR(app_name, _dmem_data_end);    \
+  OTBN_DECLARE_SYMBOL_ADDR(app_name, _dmem_data_start); \
+  OTBN_DECLARE_SYMBOL_ADDR(app_name, _checksum)
 
 /**
  * Initializes the OTBN application information structure.
@@ -201,6 +210,7 @@ typedef struct sc_otbn_app {
       .dmem_data_start = OTBN_SYMBOL_PTR(app_name, _dmem_data_start),       \
       .dmem_data_end = OTBN_SYMBOL_PTR(app_name, _dmem_data_end),           \
       .dmem_data_start_addr = OTBN_ADDR_T_INIT(app_name, _dmem_data_start), \
+      .checksum = OTBN_ADDR_T_INIT(app_name, _checksum),                    \
   })
 
 /**
@@ -221,6 +231,22 @@ typedef struct sc_otbn_app {
 OT_WARN_UNUSED_RESULT
 rom_error_t sc_otbn_load_app(const sc_otbn_app_t app);
 
+/**
+ * Loads an application into OTBN, reusing its IMEM if it is already there.
+ *
+ * Meant for an application left in OTBN by an earlier boot stage. DMEM is
+ * wiped and its data section rewritten, but instead of wiping IMEM and loading
+ * it again, each IMEM word is read back and written in place. The
+ * `LOAD_CHECKSUM` register then covers what is actually in IMEM, and is
+ * compared against the application's checksum. If they differ, the
+ * application is loaded from scratch with `sc_otbn_load_app()`.
+ *
+ * @param app The application expected to be resident in OTBN.
+ * @return The result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+rom_error_t sc_otbn_load_app_resident(const sc_otbn_app_t app);
+
 /**
  * Copies data from the CPU memory to OTBN data memory.
  *
@@ -256,6 +282,31 @@ rom_error_t sc_otbn_dmem_read(size_t num_words, const sc_otbn_addr_t src,
 OT_WARN_UNUSED_RESULT
 rom_error_t sc_otbn_execute(void);
 
+/**
+ * Starts the execution of the application loaded into OTBN without waiting
+ * for it to complete.
+ *
+ * Ibex is free to use other peripherals while OTBN runs. The caller must call
+ * `sc_otbn_execute_finalize()` before touching OTBN again.
+ *
+ * `SEC_MMIO_WRITE_INCREMENT(kScOtbnSecMmioExecute)` applies to this function
+ * rather than to `sc_otbn_execute_finalize()`.
+ *
+ * @return Result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+rom_error_t sc_otbn_execute_start(void);
+
+/**
+ * Waits for an execution started with `sc_otbn_execute_start()` to complete.
+ *
+ * This function blocks until OTBN is idle.
+ *
+ * @return Result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+rom_error_t sc_otbn_execute_finalize(void);
+
 /**
  * Blocks until OTBN is idle.
  *
@@ -283,6 +334,18 @@ rom_error_t sc_otbn_busy_wait_for_done(void);
 OT_WARN_UNUSED_RESULT
 uint32_t sc_otbn_instruction_count_get(void);
 
+/**
+ * Waits until the program started by `sc_otbn_execute_start()` has executed at
+ * least `insn_count` instructions, or has stopped.
+ *
+ * This lets the caller reuse inputs that the program only reads at its start,
+ * such as a sideloaded key, while OTBN is still running. Errors are reported by
+ * `sc_otbn_execute_finalize()`.
+ *
+ * @param insn_count The number of instructions to wait for.
+ */
+void sc_otbn_instruction_count_wait(uint32_t insn_count);
+
 /**
  * Wipe IMEM securely.
  *
@@ -129,6 +129,69 @@ TEST_F(ExecuteTest, ExecuteBlockUntilIdle) {
   EXPECT_EQ(sc_otbn_execute(), kErrorOk);
 }
 
+TEST_F(ExecuteTest, ExecuteStartFinalize) {
+  // Read twice for hardening.
+  EXPECT_ABS_READ32(base_ + OTBN_STATUS_REG_OFFSET, kScOtbnStatusIdle);
+  EXPECT_ABS_READ32(base_ + OTBN_STATUS_REG_OFFSET, kScOtbnStatusIdle);
+
+  EXPECT_SEC_WRITE32(base_ + OTBN_CTRL_REG_OFFSET, 0x1);
+
+  EXPECT_ABS_WRITE32(base_ + OTBN_INTR_STATE_REG_OFFSET,
+                     {
+                         {OTBN_INTR_COMMON_DONE_BIT, 1},
+                     });
+  EXPECT_ABS_WRITE32(base_ + OTBN_CMD_REG_OFFSET, kScOtbnCmdExecute);
+
+  // Starting must not wait for the `done` interrupt.
+  EXPECT_EQ(sc_otbn_execute_start(), kErrorOk);
+
+  EXPECT_ABS_READ32(base_ + OTBN_INTR_STATE_REG_OFFSET, 0);
+  EXPECT_ABS_READ32(base_ + OTBN_INTR_STATE_REG_OFFSET,
+                    {
+                        {OTBN_INTR_COMMON_DONE_BIT, 1},
+                    });
+  EXPECT_ABS_WRITE32(base_ + OTBN_INTR_STATE_REG_OFFSET,
+                     {
+                         {OTBN_INTR_COMMON_DONE_BIT, 1},
+                     });
+  EXPECT_ABS_READ32(base_ + OTBN_ERR_BITS_REG_OFFSET, err_bits_ok_);
+  EXPECT_ABS_READ32(base_ + OTBN_STATUS_REG_OFFSET, kScOtbnStatusIdle);
+  EXPECT_ABS_READ32(base_ + OTBN_STATUS_REG_OFFSET, kScOtbnStatusIdle);
+
+  EXPECT_EQ(sc_otbn_execute_finalize(), kErrorOk);
+}
+
+TEST_F(ExecuteTest, InstructionCountWait) {
+  // Not started yet: the instruction count is stale.
+  EXPECT_ABS_READ32(base_ + OTBN_INTR_STATE_REG_OFFSET, 0);
+  EXPECT_ABS_READ32(base_ + OTBN_STATUS_REG_OFFSET, kScOtbnStatusIdle);
+  EXPECT_ABS_READ32(base_ + OTBN_INSN_CNT_REG_OFFSET, 1000);
+  // Running, but below the requested count.
+  EXPECT_ABS_READ32(base_ + OTBN_INTR_STATE_REG_OFFSET, 0);
+  EXPECT_ABS_READ32(base_ + OTBN_STATUS_REG_OFFSET, kScOtbnStatusBusyExecute);
+  EXPECT_ABS_READ32(base_ + OTBN_INSN_CNT_REG_OFFSET, 5);
+  // Running, and reached the requested count.
+  EXPECT_ABS_READ32(base_ + OTBN_INTR_STATE_REG_OFFSET, 0);
+  EXPECT_ABS_READ32(base_ + OTBN_STATUS_REG_OFFSET, kScOtbnStatusBusyExecute);
+  EXPECT_ABS_READ32(base_ + OTBN_INSN_CNT_REG_OFFSET, 13);
+
+  sc_otbn_instruction_count_wait(13);
+}
+
+TEST_F(ExecuteTest, InstructionCountWaitDone) {
+  EXPECT_ABS_READ32(base_ + OTBN_INTR_STATE_REG_OFFSET, 0);
+  EXPECT_ABS_READ32(base_ + OTBN_STATUS_REG_OFFSET, kScOtbnStatusBusyExecute);
+  EXPECT_ABS_READ32(base_ + OTBN_INSN_CNT_REG_OFFSET, 5);
+  // The program stopped before reaching the requested count, e.g. because of
+  // an error.
+  EXPECT_ABS_READ32(base_ + OTBN_INTR_STATE_REG_OFFSET,
+                    {
+                        {OTBN_INTR_COMMON_DONE_BIT, 1},
+                    });
+
+  sc_otbn_instruction_count_wait(13);
+}
+
 class IsBusyTest : public OtbnTest {};
 
 TEST_F(IsBusyTest, Success) {
@@ -204,6 +267,25 @@ TEST_F(DmemWriteTest, SuccessWithOffset) {
   EXPECT_EQ(sc_otbn_dmem_write(2, test_data.data(), dest_addr), kErrorOk);
 }
 
+TEST_F(DmemWriteTest, SuccessRandomStart) {
+  // Test assumption.
+  static_assert(OTBN_DMEM_SIZE_BYTES >= 24, "OTBN DMEM size too small.");
+
+  std::array<uint32_t, 6> test_data = {0x12345678, 0xabcdef01, 0x23456789,
+                                       0xbcdef012, 0x3456789a, 0xcdef0123};
+  sc_otbn_addr_t dest_addr = 0;
+
+  // Start at word 1 (of 6), so the writes wrap around after word 5.
+  EXPECT_CALL(rnd_, Uint32()).WillOnce(Return(0x40000000));
+  for (size_t i : {1, 2, 3, 4, 5, 0}) {
+    EXPECT_ABS_WRITE32(base_ + OTBN_DMEM_REG_OFFSET + dest_addr + i * 4,
+                       test_data[i]);
+  }
+
+  EXPECT_EQ(sc_otbn_dmem_write(test_data.size(), test_data.data(), dest_addr),
+            kErrorOk);
+}
+
 TEST_F(DmemWriteTest, FailureOutOfRange) {
   std::array<uint32_t, 2> test_data = {0x12345678, 0xabcdef01};
   sc_otbn_addr_t dest_addr = OTBN_DMEM_SIZE_BYTES;
@@ -310,6 +392,73 @@ TEST_F(OtbnAppTest, OtbnLoadAppSuccess) {
   EXPECT_EQ(sc_otbn_load_app(app), kErrorOk);
 }
 
+TEST_F(OtbnAppTest, OtbnLoadAppResidentSuccess) {
+  std::array<uint32_t, 2> imem_data = {0x01234567, 0x89abcdef};
+  std::array<uint32_t, 2> dmem_data = {0x456789ab, 0xcdef0123};
+  sc_otbn_addr_t dmem_data_offset = 0x12;
+  constexpr uint32_t kChecksum = 0x5a5a1234;
+  sc_otbn_app_t app = {
+      .imem_start = imem_data.data(),
+      .imem_end = imem_data.data() + imem_data.size(),
+      .dmem_data_start = dmem_data.data(),
+      .dmem_data_end = dmem_data.data() + dmem_data.size(),
+      .dmem_data_start_addr = dmem_data_offset,
+      .checksum = kChecksum,
+  };
+
+  // `sc_otbn_busy_wait_for_done`
+  EXPECT_ABS_READ32(base_ + OTBN_STATUS_REG_OFFSET, kScOtbnStatusIdle);
+  EXPECT_ABS_READ32(base_ + OTBN_STATUS_REG_OFFSET, kScOtbnStatusIdle);
+  // `sc_otbn_dmem_sec_wipe`, but no IMEM wipe.
+  ExpectCmdRun(kScOtbnCmdSecWipeDmem, err_bits_ok_, kScOtbnStatusIdle);
+  // IMEM is written back in place, then the data section is written in order.
+  EXPECT_ABS_WRITE32(base_ + OTBN_LOAD_CHECKSUM_REG_OFFSET, 0);
+  for (size_t i = 0; i < imem_data.size(); ++i) {
+    uint32_t addr = base_ + OTBN_IMEM_REG_OFFSET + i * sizeof(uint32_t);
+    EXPECT_ABS_READ32(addr, imem_data[i]);
+    EXPECT_ABS_WRITE32(addr, imem_data[i]);
+  }
+  for (size_t i = 0; i < dmem_data.size(); ++i) {
+    EXPECT_ABS_WRITE32(base_ + OTBN_DMEM_REG_OFFSET + dmem_data_offset +
+                           i * sizeof(uint32_t),
+                       dmem_data[i]);
+  }
+  EXPECT_ABS_READ32(base_ + OTBN_LOAD_CHECKSUM_REG_OFFSET, kChecksum);
+
+  EXPECT_EQ(sc_otbn_load_app_resident(app), kErrorOk);
+}
+
+TEST_F(OtbnAppTest, OtbnLoadAppResidentMismatch) {
+  std::array<uint32_t, 1> imem_data = {0x01234567};
+  std::array<uint32_t, 0> dmem_data = {};
+  sc_otbn_app_t app = {
+      .imem_start = imem_data.data(),
+      .imem_end = imem_data.data() + imem_data.size(),
+      .dmem_data_start = dmem_data.data(),
+      .dmem_data_end = dmem_data.data() + dmem_data.size(),
+      .dmem_data_start_addr = 0,
+      .checksum = 0x5a5a1234,
+  };
+
+  EXPECT_ABS_READ32(base_ + OTBN_STATUS_REG_OFFSET, kScOtbnStatusIdle);
+  EXPECT_ABS_READ32(base_ + OTBN_STATUS_REG_OFFSET, kScOtbnStatusIdle);
+  ExpectCmdRun(kScOtbnCmdSecWipeDmem, err_bits_ok_, kScOtbnStatusIdle);
+  EXPECT_ABS_WRITE32(base_ + OTBN_LOAD_CHECKSUM_REG_OFFSET, 0);
+  EXPECT_ABS_READ32(base_ + OTBN_IMEM_REG_OFFSET, 0xdeadbeef);
+  EXPECT_ABS_WRITE32(base_ + OTBN_IMEM_REG_OFFSET, 0xdeadbeef);
+  EXPECT_ABS_READ32(base_ + OTBN_LOAD_CHECKSUM_REG_OFFSET, 0);
+
+  // The checksum doesn't match, so the app is loaded from scratch.
+  EXPECT_ABS_READ32(base_ + OTBN_STATUS_REG_OFFSET, kScOtbnStatusIdle);
+  EXPECT_ABS_READ32(base_ + OTBN_STATUS_REG_OFFSET, kScOtbnStatusIdle);
+  ExpectCmdRun(kScOtbnCmdSecWipeDmem, err_bits_ok_, kScOtbnStatusIdle);
+  ExpectCmdRun(kScOtbnCmdSecWipeImem, err_bits_ok_, kScOtbnStatusIdle);
+  EXPECT_CALL(rnd_, Uint32()).WillOnce(Return(0));
+  EXPECT_ABS_WRITE32(base_ + OTBN_IMEM_REG_OFFSET, imem_data[0]);
+
+  EXPECT_EQ(sc_otbn_load_app_resident(app), kErrorOk);
+}
+
 TEST_F(OtbnAppTest, OtbnLoadInvalidAppEmptyImem) {
   // Create an invalid app with an empty IMEM range.
   std::array<uint32_t, 0> imem_data = {};
@@ -8,6 +8,7 @@
 
 #include "sw/device/lib/base/abs_mmio.h"
 #include "sw/device/lib/base/bitfield.h"
+#include "sw/device/lib/base/hardened.h"
 #include "sw/device/lib/base/memory.h"
 #include "sw/device/silicon_creator/lib/base/sec_mmio.h"
 #include "sw/device/silicon_creator/lib/error.h"
@@ -62,11 +63,46 @@ const otp_partition_info_t kOtpPartitions[] = {
 };
 // clang-format on
 
+// Used by stages that never call `otp_snapshot()`, which then do not link
+// otp_snapshot.c and its RAM copies.
+OT_WEAK const uint32_t *otp_snapshot_get(uint32_t address,
+                                         size_t num_words) {
+  return NULL;
+}
+
+OT_WEAK void otp_snapshot_discard(otp_partition_t partition) {}
+
+/**
+ * Returns `value`, the cached copy of the word at OTP `address`, after adding
+ * it to the sec_mmio expectations.
+ *
+ * Most software config words are security settings (hardened enables, the
+ * sigverify and immutable ROM_EXT configuration). Recording them means that
+ * `sec_mmio_check_values()` compares each value that was handed out against
+ * the OTP window, so a single fault on the RAM copy is caught the same way as
+ * a faulted `sec_mmio_read32()`.
+ */
+static uint32_t snapshot_record(uint32_t address, uint32_t value) {
+  sec_mmio_record32(kBase + OTP_CTRL_SW_CFG_WINDOW_REG_OFFSET + address, value);
+  return value;
+}
+
 uint32_t otp_read32(uint32_t address) {
+  const uint32_t *cached = otp_snapshot_get(address, 1);
+  if (cached != NULL) {
+    return snapshot_record(address, cached[0]);
+  }
   return sec_mmio_read32(kBase + OTP_CTRL_SW_CFG_WINDOW_REG_OFFSET + address);
 }
 
 uint64_t otp_read64(uint32_t address) {
+  const uint32_t *cached = otp_snapshot_get(address, 2);
+  if (cached != NULL) {
+    uint64_t value = snapshot_record(address + sizeof(uint32_t), cached[1]);
+    value <<= 32;
+    value |= snapshot_record(address, cached[0]);
+    return value;
+  }
   uint32_t reg_offset = OTP_CTRL_SW_CFG_WINDOW_REG_OFFSET + address;
   uint64_t value = sec_mmio_read32(kBase + reg_offset + sizeof(uint32_t));
   value <<= 32;
@@ -76,10 +112,15 @@ uint64_t otp_read64(uint32_t address) {
 }
 
 void otp_read(uint32_t address, uint32_t *data, size_t num_words) {
+  const uint32_t *cached = otp_snapshot_get(address, num_words);
   uint32_t reg_offset = OTP_CTRL_SW_CFG_WINDOW_REG_OFFSET + address;
   size_t i = 0, r = num_words - 1;
   for (; launder32(i) < num_words && launder32(r) < num_words; ++i, --r) {
-    data[i] = sec_mmio_read32(kBase + reg_offset + i * sizeof(uint32_t));
+    if (cached != NULL) {
+      data[i] = snapshot_record(address + i * sizeof(uint32_t), cached[i]);
+    } else {
+      data[i] = sec_mmio_read32(kBase + reg_offset + i * sizeof(uint32_t));
+    }
   }
   HARDENED_CHECK_EQ(i, num_words);
   HARDENED_CHECK_EQ(r, SIZE_MAX);
@@ -144,5 +185,7 @@ rom_error_t otp_dai_read(otp_partition_t partition, uint32_t relative_address,
 
 void otp_creator_sw_cfg_lockdown(void) {
   SEC_MMIO_ASSERT_WRITE_INCREMENT(kOtpSecMmioCreatorSwCfgLockDown, 1);
+  // The RAM copy must not outlive read access to the partition.
+  otp_snapshot_discard(kOtpPartitionCreatorSwCfg);
   sec_mmio_write32(kBase + OTP_CTRL_CREATOR_SW_CFG_READ_LOCK_REG_OFFSET, 0);
 }
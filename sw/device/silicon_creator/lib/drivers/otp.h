@@ -78,6 +78,47 @@ typedef enum otp_partition {
  */
 extern const otp_partition_info_t kOtpPartitions[];
 
+/**
+ * Copies a software config partition into RAM to serve later reads.
+ *
+ * The copy is checked against the partition digest and, on success,
+ * `otp_read32()`, `otp_read64()` and `otp_read()` return values from RAM
+ * instead of the OTP window. A partition that is not locked yet (i.e. whose
+ * digest is zero) is not copied and reads keep using the OTP window.
+ *
+ * Values served from RAM are still recorded with `sec_mmio_record32()`, so
+ * `sec_mmio_check_values()` compares them against the OTP window just like
+ * values read with `sec_mmio_read32()`.
+ *
+ * `otp_creator_sw_cfg_lockdown()` discards the copy of the CREATOR_SW_CFG
+ * partition.
+ *
+ * This function is implemented in otp_snapshot.c, which a stage only links if
+ * it calls this function. Stages that don't pay neither the code nor the RAM
+ * for the copies.
+ *
+ * @param partition The partition to copy, `kOtpPartitionCreatorSwCfg` or
+ *                  `kOtpPartitionOwnerSwCfg`.
+ * @return The result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+rom_error_t otp_snapshot(otp_partition_t partition);
+
+/**
+ * Returns the verified RAM copy of `num_words` words at OTP `address`, or NULL
+ * if no snapshot holds the whole range.
+ *
+ * Internal to the OTP driver. The weak default in otp.c always returns NULL.
+ */
+const uint32_t *otp_snapshot_get(uint32_t address, size_t num_words);
+
+/**
+ * Wipes the RAM copy of `partition` and stops serving reads from it.
+ *
+ * Internal to the OTP driver. The weak default in otp.c does nothing.
+ */
+void otp_snapshot_discard(otp_partition_t partition);
+
 /**
  * Perform a blocking 32-bit read from the memory mapped software config
  * partitions.
@@ -163,7 +204,8 @@ rom_error_t otp_dai_read(otp_partition_t partition, uint32_t address,
  * Disables read access to CREATOR_SW_CFG partition until next reset.
  *
  * This function must be called in ROM_EXT before handing over execution to the
- * first owner boot stage.
+ * first owner boot stage. It also discards the RAM copy of the partition made
+ * by `otp_snapshot()`.
  */
 void otp_creator_sw_cfg_lockdown(void);
 
@@ -0,0 +1,128 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "sw/device/silicon_creator/lib/drivers/otp.h"
+
+#include <stddef.h>
+
+#include "sw/device/lib/base/abs_mmio.h"
+#include "sw/device/lib/base/hardened.h"
+#include "sw/device/lib/base/macros.h"
+#include "sw/device/silicon_creator/lib/drivers/hmac.h"
+#include "sw/device/silicon_creator/lib/error.h"
+
+#include "hw/top_earlgrey/sw/autogen/top_earlgrey.h"
+#include "otp_ctrl_regs.h"  // Generated.
+
+enum {
+  kBase = TOP_EARLGREY_OTP_CTRL_CORE_BASE_ADDR,
+  kCreatorSwCfgNumWords = (OTP_CTRL_PARAM_CREATOR_SW_CFG_SIZE -
+                           OTP_CTRL_PARAM_CREATOR_SW_CFG_DIGEST_SIZE) /
+                          sizeof(uint32_t),
+  kOwnerSwCfgNumWords = (OTP_CTRL_PARAM_OWNER_SW_CFG_SIZE -
+                         OTP_CTRL_PARAM_OWNER_SW_CFG_DIGEST_SIZE) /
+                        sizeof(uint32_t),
+  /**
+   * Number of partitions that can be snapshotted, i.e. the partitions that
+   * are mapped in the software config window.
+   */
+  kSnapshotCount = kOtpPartitionOwnerSwCfg + 1,
+};
+
+/**
+ * RAM copies of the software config partitions.
+ *
+ * A copy is only used while the corresponding entry of `snapshot_valid` is
+ * `kHardenedBoolTrue`, which `otp_snapshot()` only sets after checking the
+ * copy against the partition digest.
+ */
+static uint32_t creator_sw_cfg_snapshot[kCreatorSwCfgNumWords];
+static uint32_t owner_sw_cfg_snapshot[kOwnerSwCfgNumWords];
+static hardened_bool_t snapshot_valid[kSnapshotCount];
+
+static uint32_t *snapshot_data(otp_partition_t partition) {
+  switch (launder32(partition)) {
+    case kOtpPartitionCreatorSwCfg:
+      HARDENED_CHECK_EQ(partition, kOtpPartitionCreatorSwCfg);
+      return creator_sw_cfg_snapshot;
+    case kOtpPartitionOwnerSwCfg:
+      HARDENED_CHECK_EQ(partition, kOtpPartitionOwnerSwCfg);
+      return owner_sw_cfg_snapshot;
+    default:
+      HARDENED_TRAP();
+      OT_UNREACHABLE();
+  }
+}
+
+void otp_snapshot_discard(otp_partition_t partition) {
+  snapshot_valid[partition] = kHardenedBoolFalse;
+  uint32_t *data = snapshot_data(partition);
+  const size_t num_words = kOtpPartitions[partition].size / sizeof(uint32_t);
+  for (size_t i = 0; i < num_words; ++i) {
+    data[i] = 0;
+  }
+}
+
+const uint32_t *otp_snapshot_get(uint32_t address, size_t num_words) {
+  if ((address & (sizeof(uint32_t) - 1)) != 0) {
+    return NULL;
+  }
+  for (size_t p = 0; p < kSnapshotCount; ++p) {
+    if (launder32(snapshot_valid[p]) != kHardenedBoolTrue) {
+      continue;
+    }
+    const otp_partition_info_t *info = &kOtpPartitions[p];
+    if (address < info->start_addr) {
+      continue;
+    }
+    size_t offset = address - info->start_addr;
+    if (offset > info->size ||
+        num_words > (info->size - offset) / sizeof(uint32_t)) {
+      continue;
+    }
+    HARDENED_CHECK_EQ(snapshot_valid[p], kHardenedBoolTrue);
+    return snapshot_data((otp_partition_t)p) + offset / sizeof(uint32_t);
+  }
+  return NULL;
+}
+
+rom_error_t otp_snapshot(otp_partition_t partition) {
+  if (launder32(partition) >= kSnapshotCount) {
+    return kErrorOtpBadPartition;
+  }
+  HARDENED_CHECK_LT(partition, kSnapshotCount);
+  otp_snapshot_discard(partition);
+
+  uint64_t expected_digest = otp_partition_digest_read(partition);
+  if (expected_digest == 0) {
+    // The partition is not locked yet, so there is nothing to check the copy
+    // against. Keep serving reads from the OTP window.
+    return kErrorOk;
+  }
+
+  uint32_t *data = snapshot_data(partition);
+  const size_t num_words = kOtpPartitions[partition].size / sizeof(uint32_t);
+  uint32_t addr = kBase + OTP_CTRL_SW_CFG_WINDOW_REG_OFFSET +
+                  kOtpPartitions[partition].start_addr;
+  size_t i = 0, r = num_words - 1;
+  for (; launder32(i) < num_words && launder32(r) < num_words; ++i, --r) {
+    data[i] = abs_mmio_read32(addr + i * sizeof(uint32_t));
+  }
+  HARDENED_CHECK_EQ(i, num_words);
+  HARDENED_CHECK_EQ(r, SIZE_MAX);
+
+  // The digest of a software partition is the least significant 64 bits of
+  // the SHA-256 digest of its contents, see `individualize_sw_cfg.c`.
+  hmac_digest_t act_digest;
+  hmac_sha256(data, kOtpPartitions[partition].size, &act_digest);
+  uint32_t diff = launder32(act_digest.digest[0] ^ (uint32_t)expected_digest);
+  diff |= act_digest.digest[1] ^ (uint32_t)(expected_digest >> 32);
+  if (launder32(diff) != 0) {
+    otp_snapshot_discard(partition);
+    return kErrorOtpBadDigest;
+  }
+  HARDENED_CHECK_EQ(diff, 0);
+  snapshot_valid[partition] = kHardenedBoolTrue;
+  return kErrorOk;
+}
@@ -10,6 +10,7 @@
 #include "sw/device/lib/base/mmio.h"
 #include "sw/device/lib/base/mock_abs_mmio.h"
 #include "sw/device/silicon_creator/lib/base/mock_sec_mmio.h"
+#include "sw/device/silicon_creator/lib/drivers/mock_hmac.h"
 #include "sw/device/silicon_creator/lib/error.h"
 #include "sw/device/silicon_creator/testing/rom_test.h"
 
@@ -19,7 +20,10 @@
 namespace otp_unittest {
 namespace {
 using ::testing::ElementsAre;
+using ::testing::_;
 using ::testing::ElementsAreArray;
+using ::testing::NotNull;
+using ::testing::SetArgPointee;
 
 constexpr int kMaxOtpWordsToRead = 10;
 
@@ -216,5 +220,131 @@ TEST_P(OtpDaiReadTest, ReadLenN32bitWords) {
 INSTANTIATE_TEST_SUITE_P(Read32bitWordArrays, OtpDaiReadTest,
                          testing::Range(0, kMaxOtpWordsToRead));
 
+class OtpSnapshotTest : public OtpReadTest {
+ protected:
+  static constexpr uint32_t kOffset = OTP_CTRL_PARAM_OWNER_SW_CFG_OFFSET;
+  static constexpr size_t kNumWords =
+      (OTP_CTRL_PARAM_OWNER_SW_CFG_SIZE -
+       OTP_CTRL_PARAM_OWNER_SW_CFG_DIGEST_SIZE) /
+      sizeof(uint32_t);
+
+  void ExpectDigestRead(uint64_t digest) {
+    EXPECT_SEC_READ32(
+        base_ + OTP_CTRL_OWNER_SW_CFG_DIGEST_0_REG_OFFSET + sizeof(uint32_t),
+        digest >> 32);
+    EXPECT_SEC_READ32(base_ + OTP_CTRL_OWNER_SW_CFG_DIGEST_0_REG_OFFSET,
+                      digest);
+  }
+
+  /**
+   * Expects a snapshot of the OWNER_SW_CFG partition whose SHA-256 digest
+   * truncates to `act_digest`.
+   */
+  void ExpectSnapshot(uint64_t digest, uint64_t act_digest) {
+    ExpectDigestRead(digest);
+    for (size_t i = 0; i < kNumWords; ++i) {
+      EXPECT_ABS_READ32(
+          base_ + mmap_window_offset_ + kOffset + i * sizeof(uint32_t), i);
+    }
+    hmac_digest_t hmac_digest{};
+    hmac_digest.digest[0] = act_digest;
+    hmac_digest.digest[1] = act_digest >> 32;
+    EXPECT_CALL(hmac_, sha256(NotNull(), kNumWords * sizeof(uint32_t), _))
+        .WillOnce(SetArgPointee<2>(hmac_digest));
+  }
+
+  /**
+   * Drops the snapshot so that later tests read from the OTP window.
+   */
+  void DropSnapshot() {
+    ExpectDigestRead(0);
+    EXPECT_EQ(otp_snapshot(kOtpPartitionOwnerSwCfg), kErrorOk);
+  }
+
+  rom_test::MockHmac hmac_;
+};
+
+TEST_F(OtpSnapshotTest, ReadsServedFromSnapshot) {
+  ExpectSnapshot(0x0123456789abcdef, 0x0123456789abcdef);
+  EXPECT_EQ(otp_snapshot(kOtpPartitionOwnerSwCfg), kErrorOk);
+
+  // No read expectations: the reads below must not touch the OTP window, but
+  // each value must still be recorded for `sec_mmio_check_values()`.
+  EXPECT_SEC_RECORD32(base_ + mmap_window_offset_ + kOffset + 4 * 4, 4);
+  EXPECT_EQ(otp_read32(kOffset + 4 * sizeof(uint32_t)), 4);
+  EXPECT_SEC_RECORD32(base_ + mmap_window_offset_ + kOffset + 3 * 4, 3);
+  EXPECT_SEC_RECORD32(base_ + mmap_window_offset_ + kOffset + 2 * 4, 2);
+  EXPECT_EQ(otp_read64(kOffset + 2 * sizeof(uint32_t)), 0x0000000300000002);
+  for (size_t i = kNumWords - 3; i < kNumWords; ++i) {
+    EXPECT_SEC_RECORD32(base_ + mmap_window_offset_ + kOffset + i * 4, i);
+  }
+  std::array<uint32_t, 3> buf;
+  otp_read(kOffset + (kNumWords - 3) * sizeof(uint32_t), buf.data(),
+           buf.size());
+  EXPECT_THAT(buf, ElementsAre(kNumWords - 3, kNumWords - 2, kNumWords - 1));
+
+  // Reads past the end of the partition still use the OTP window.
+  EXPECT_SEC_READ32(
+      base_ + mmap_window_offset_ + kOffset + kNumWords * sizeof(uint32_t),
+      0x5a5a5a5a);
+  EXPECT_SEC_READ32(base_ + mmap_window_offset_ + kOffset +
+                        (kNumWords - 1) * sizeof(uint32_t),
+                    kNumWords - 1);
+  EXPECT_EQ(otp_read64(kOffset + (kNumWords - 1) * sizeof(uint32_t)),
+            0x5a5a5a5a00000000 | (kNumWords - 1));
+
+  DropSnapshot();
+}
+
+TEST_F(OtpSnapshotTest, BadDigest) {
+  ExpectSnapshot(0x0123456789abcdef, 0x0123456789abcdee);
+  EXPECT_EQ(otp_snapshot(kOtpPartitionOwnerSwCfg), kErrorOtpBadDigest);
+
+  EXPECT_SEC_READ32(base_ + mmap_window_offset_ + kOffset, 0x00010203);
+  EXPECT_EQ(otp_read32(kOffset), 0x00010203);
+}
+
+TEST_F(OtpSnapshotTest, UnlockedPartition) {
+  ExpectDigestRead(0);
+  EXPECT_EQ(otp_snapshot(kOtpPartitionOwnerSwCfg), kErrorOk);
+
+  EXPECT_SEC_READ32(base_ + mmap_window_offset_ + kOffset, 0x00010203);
+  EXPECT_EQ(otp_read32(kOffset), 0x00010203);
+}
+
+TEST_F(OtpSnapshotTest, BadPartition) {
+  EXPECT_EQ(otp_snapshot(kOtpPartitionHwCfg0), kErrorOtpBadPartition);
+}
+
+TEST_F(OtpSnapshotTest, LockdownDropsCreatorSnapshot) {
+  constexpr uint32_t kCreatorOffset = OTP_CTRL_PARAM_CREATOR_SW_CFG_OFFSET;
+  constexpr size_t kCreatorNumWords =
+      (OTP_CTRL_PARAM_CREATOR_SW_CFG_SIZE -
+       OTP_CTRL_PARAM_CREATOR_SW_CFG_DIGEST_SIZE) /
+      sizeof(uint32_t);
+  EXPECT_SEC_READ32(
+      base_ + OTP_CTRL_CREATOR_SW_CFG_DIGEST_0_REG_OFFSET + sizeof(uint32_t),
+      0);
+  EXPECT_SEC_READ32(base_ + OTP_CTRL_CREATOR_SW_CFG_DIGEST_0_REG_OFFSET, 1);
+  for (size_t i = 0; i < kCreatorNumWords; ++i) {
+    EXPECT_ABS_READ32(
+        base_ + mmap_window_offset_ + kCreatorOffset + i * sizeof(uint32_t),
+        0);
+  }
+  hmac_digest_t hmac_digest{};
+  hmac_digest.digest[0] = 1;
+  EXPECT_CALL(hmac_, sha256(NotNull(), kCreatorNumWords * sizeof(uint32_t), _))
+      .WillOnce(SetArgPointee<2>(hmac_digest));
+  EXPECT_EQ(otp_snapshot(kOtpPartitionCreatorSwCfg), kErrorOk);
+  EXPECT_SEC_RECORD32(base_ + mmap_window_offset_ + kCreatorOffset, 0);
+  EXPECT_EQ(otp_read32(kCreatorOffset), 0);
+
+  EXPECT_SEC_WRITE32(base_ + OTP_CTRL_CREATOR_SW_CFG_READ_LOCK_REG_OFFSET, 0);
+  otp_creator_sw_cfg_lockdown();
+
+  EXPECT_SEC_READ32(base_ + mmap_window_offset_ + kCreatorOffset, 0xffffffff);
+  EXPECT_EQ(otp_read32(kCreatorOffset), 0xffffffff);
+}
+
 }  // namespace
 }  // namespace otp_unittest
@@ -9,14 +9,38 @@
 
 #include "dt/dt_sram_ctrl.h"
 #include "sw/device/lib/base/macros.h"
+#include "sw/device/silicon_creator/lib/boot_data.h"
 #include "sw/device/silicon_creator/lib/boot_log.h"
 #include "sw/device/silicon_creator/lib/boot_svc/boot_svc_msg.h"
 #include "sw/device/silicon_creator/lib/error.h"
+#include "sw/device/silicon_creator/lib/event_trace.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+enum {
+  /**
+   * Size of the verified image tag in words.
+   */
+  kRetentionSramVerifiedImageTagWords = 8,
+};
+
+/**
+ * Verified image record.
+ *
+ * The ROM_EXT stores a KMAC tag of the last owner image that passed signature
+ * verification here. The tag is keyed with a keymgr-derived sealing key, so it
+ * can only be produced by a boot stage holding that key.
+ */
+typedef struct retention_sram_verified_image {
+  /**
+   * KMAC-256 tag over the image digest, signature and verifying key.
+   */
+  uint32_t tag[kRetentionSramVerifiedImageTagWords];
+} retention_sram_verified_image_t;
+OT_ASSERT_SIZE(retention_sram_verified_image_t, 32);
+
 /**
  * Retention SRAM silicon creator area.
  */
@@ -49,12 +73,36 @@ typedef struct retention_sram_creator {
    * - We can add additional members at the end (growing up into reserved
    *   space) without affecting the layout of other structures.
    */
-  uint32_t reserved[(2044 - (sizeof(uint32_t)          // reset_reason
-                             + sizeof(boot_svc_msg_t)  // boot services message
-                             + sizeof(boot_log_t)      // boot_log
-                             + sizeof(rom_error_t)     // last_shutdown_reason
+  uint32_t reserved[(2044 - (sizeof(uint32_t)            // reset_reason
+                             + sizeof(boot_svc_msg_t)    // boot_svc_msg
+                             + sizeof(retention_sram_verified_image_t)
+                             + sizeof(boot_data_hint_t)  // boot_data_hint
+                             + sizeof(boot_timing_t)     // boot_timing
+                             + sizeof(boot_log_t)        // boot_log
+                             + sizeof(rom_error_t)       // last_shutdown_reason
                              )) /
                     sizeof(uint32_t)];
+  /**
+   * Verified image record.
+   *
+   * Lets the ROM_EXT skip the signature check of an unchanged owner image on
+   * warm boots. Reinitialized with the rest of the retention SRAM on PoR.
+   */
+  retention_sram_verified_image_t verified_image;
+  /**
+   * Boot data location hint.
+   *
+   * Index of the first empty boot data entry in each page, maintained by the
+   * boot data module so that warm boots can skip searching the pages.
+   */
+  boot_data_hint_t boot_data_hint;
+  /**
+   * Boot timing trace.
+   *
+   * Cycle counts recorded by the ROM, ROM_EXT and (optionally) the owner
+   * firmware at the start and end of each boot stage and its main operations.
+   */
+  boot_timing_t boot_timing;
   /**
    * Boot log area.
    *
@@ -73,6 +121,9 @@ typedef struct retention_sram_creator {
 OT_ASSERT_MEMBER_OFFSET(retention_sram_creator_t, reset_reasons, 0);
 OT_ASSERT_MEMBER_OFFSET(retention_sram_creator_t, boot_svc_msg, 4);
 OT_ASSERT_MEMBER_OFFSET(retention_sram_creator_t, reserved, 260);
+OT_ASSERT_MEMBER_OFFSET(retention_sram_creator_t, verified_image, 1612);
+OT_ASSERT_MEMBER_OFFSET(retention_sram_creator_t, boot_data_hint, 1644);
+OT_ASSERT_MEMBER_OFFSET(retention_sram_creator_t, boot_timing, 1656);
 OT_ASSERT_MEMBER_OFFSET(retention_sram_creator_t, boot_log, 1912);
 OT_ASSERT_MEMBER_OFFSET(retention_sram_creator_t, last_shutdown_reason, 2040);
 OT_ASSERT_SIZE(boot_svc_msg_t, 256);
@@ -91,8 +142,18 @@ typedef struct retention_sram_owner {
    * Tests that need to trigger (or detect) a device reset may use this field to
    * preserve state information across resets.
    */
-  uint32_t reserved[2048 / sizeof(uint32_t)];
+  uint32_t reserved[(2048 - sizeof(event_trace_t)) / sizeof(uint32_t)];
+  /**
+   * Event trace ring.
+   *
+   * The most recent events recorded by the owner firmware with
+   * `event_trace_record()`. The silicon creator boot stages only read it, e.g.
+   * to send it to the host in rescue mode.
+   */
+  event_trace_t event_trace;
 } retention_sram_owner_t;
+OT_ASSERT_MEMBER_OFFSET(retention_sram_owner_t, reserved, 0);
+OT_ASSERT_MEMBER_OFFSET(retention_sram_owner_t, event_trace, 1528);
 OT_ASSERT_SIZE(retention_sram_owner_t, 2048);
 
 /**
@@ -102,9 +102,12 @@ int uart_getchar(uint32_t timeout_ms) {
 void uart_write(const void *data, size_t len) {
   const uint8_t *d = (const uint8_t *)data;
   while (len) {
-    uart_putchar(*d++);
+    putchar_nonblocking(*d++);
     len--;
   }
+  // Let the FIFO absorb the buffer and only wait for the transmitter once.
+  while (!uart_tx_idle()) {
+  }
 }
 
 void uart_write_hex(uint32_t val, size_t len, uint32_t after) {
@@ -81,7 +81,8 @@ class BytesSendTest : public UartTest {
    * Sets TX bytes expectations.
    *
    * Every sent byte by the "send bytes" routine is expected to result in the
-   * STATUS read of 0 (FIFO not full), and write to WDATA.
+   * STATUS read of 0 (FIFO not full), and write to WDATA. The transmitter is
+   * only polled for idle once the whole buffer is in the FIFO.
    */
   void ExpectSendBytes(int num_elements = kBytesArray.size()) {
     ASSERT_LE(num_elements, kBytesArray.size());
@@ -90,15 +91,16 @@ class BytesSendTest : public UartTest {
       EXPECT_ABS_READ32(base_ + UART_STATUS_REG_OFFSET,
                         {{UART_STATUS_TXFULL_BIT, false}});
       EXPECT_ABS_WRITE32(base_ + UART_WDATA_REG_OFFSET, value);
-      EXPECT_ABS_READ32(base_ + UART_STATUS_REG_OFFSET,
-                        {{UART_STATUS_TXIDLE_BIT, true}});
     }
+    EXPECT_ABS_READ32(base_ + UART_STATUS_REG_OFFSET,
+                      {{UART_STATUS_TXIDLE_BIT, false}});
+    EXPECT_ABS_READ32(base_ + UART_STATUS_REG_OFFSET,
+                      {{UART_STATUS_TXIDLE_BIT, true}});
   }
 };
 
 TEST_F(BytesSendTest, SendBuffer) {
   ExpectSendBytes();
-  // Calling uart_write implicitly tests uart_putchar.
   uart_write(kBytesArray.data(), kBytesArray.size());
 }
 
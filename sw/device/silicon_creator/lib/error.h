@@ -55,6 +55,7 @@ enum module_ {
   kModuleCert =            MODULE_CODE('C', 'E'),
   kModuleOwnership =       MODULE_CODE('O', 'W'),
   kModulePersoTlv =        MODULE_CODE('P', 'T'),
+  kModuleOtp =             MODULE_CODE('O', 'T'),
   // clang-format on
 };
 
@@ -231,6 +232,9 @@ enum module_ {
   X(kErrorPersoTlvCertNameTooLong,    ERROR_(2, kModulePersoTlv, kOutOfRange)), \
   X(kErrorPersoTlvOutputBufTooSmall,  ERROR_(3, kModulePersoTlv, kOutOfRange)), \
   \
+  X(kErrorOtpBadPartition,            ERROR_(0, kModuleOtp, kInvalidArgument)), \
+  X(kErrorOtpBadDigest,               ERROR_(1, kModuleOtp, kDataLoss)), \
+  \
   /* This comment prevent clang from trying to format the macro. */
 
 // clang-format on
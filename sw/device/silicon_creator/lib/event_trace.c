@@ -0,0 +1,31 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "sw/device/silicon_creator/lib/event_trace.h"
+
+#include <assert.h>
+
+#include "sw/device/lib/base/memory.h"
+
+static_assert((kEventTraceEntryCount & (kEventTraceEntryCount - 1)) == 0,
+              "`kEventTraceEntryCount` must be a power of two.");
+
+event_trace_t *event_trace_active = NULL;
+
+// `extern` declarations to give the inline functions in the corresponding
+// header a link location.
+extern void event_trace_record(uint32_t id, uint32_t arg0, uint32_t arg1);
+
+void event_trace_clear(event_trace_t *trace) {
+  memset(trace, 0, sizeof(*trace));
+  trace->identifier = kEventTraceIdentifier;
+}
+
+void event_trace_init(event_trace_t *trace) {
+  // The retention SRAM holds random data after PoR.
+  if (trace->identifier != kEventTraceIdentifier) {
+    event_trace_clear(trace);
+  }
+  event_trace_active = trace;
+}
@@ -0,0 +1,128 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef OPENTITAN_SW_DEVICE_SILICON_CREATOR_LIB_EVENT_TRACE_H_
+#define OPENTITAN_SW_DEVICE_SILICON_CREATOR_LIB_EVENT_TRACE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "sw/device/lib/base/macros.h"
+#include "sw/device/silicon_creator/lib/drivers/ibex.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum {
+  /**
+   * Event trace identifier value (ASCII "ETRC").
+   */
+  kEventTraceIdentifier = 0x43525445,
+  /**
+   * Number of entries in the event trace ring.
+   *
+   * Must be a power of two so that the ring index is a simple mask.
+   */
+  kEventTraceEntryCount = 32,
+};
+
+/**
+ * A single event trace entry.
+ */
+typedef struct event_trace_entry {
+  /** Event ID, chosen by the firmware that records the event. */
+  uint32_t id;
+  /** Low 32 bits of `mcycle` when the event was recorded. */
+  uint32_t mcycle;
+  /** First event argument. */
+  uint32_t arg0;
+  /** Second event argument. */
+  uint32_t arg1;
+} event_trace_entry_t;
+
+OT_ASSERT_SIZE(event_trace_entry_t, 16);
+
+/**
+ * A ring of the most recent events recorded by the firmware.
+ *
+ * The ring lives in retention SRAM and is kept across all resets except PoR,
+ * so the events that led up to a watchdog, alert or software reset can be read
+ * back afterwards. Unlike the boot_log, the trace is not covered by a digest.
+ */
+typedef struct event_trace {
+  /** Identifier (`ETRC`). */
+  uint32_t identifier;
+  /**
+   * Number of events recorded since the trace was initialized.
+   *
+   * The next event is written to `entry[next % kEventTraceEntryCount]`, so the
+   * oldest entry is overwritten once the ring is full.
+   */
+  uint32_t next;
+  /** Trace entries. */
+  event_trace_entry_t entry[kEventTraceEntryCount];
+} event_trace_t;
+
+OT_ASSERT_MEMBER_OFFSET(event_trace_t, identifier, 0);
+OT_ASSERT_MEMBER_OFFSET(event_trace_t, next, 4);
+OT_ASSERT_MEMBER_OFFSET(event_trace_t, entry, 8);
+OT_ASSERT_SIZE(event_trace_t, 520);
+
+/**
+ * The trace that `event_trace_record()` writes to, or NULL if tracing has not
+ * been started with `event_trace_init()`.
+ */
+extern event_trace_t *event_trace_active;
+
+/**
+ * Starts tracing into the given trace.
+ *
+ * Events already in `trace` are kept if its identifier is valid, so that the
+ * events recorded before a reset can be read back after it. Otherwise, the
+ * trace is cleared.
+ *
+ * @param trace A buffer that holds the event trace, normally
+ *        `&retention_sram_get()->owner.event_trace`.
+ */
+void event_trace_init(event_trace_t *trace);
+
+/**
+ * Clears all events from the given trace.
+ *
+ * @param trace A buffer that holds the event trace.
+ */
+void event_trace_clear(event_trace_t *trace);
+
+/**
+ * Records an event in the active trace.
+ *
+ * This only takes a handful of instructions and can be left enabled in hot
+ * paths and production builds. It does nothing if tracing has not been
+ * started. Events recorded from an interrupt handler may overwrite an event
+ * that the interrupted code was recording at the same time.
+ *
+ * @param id The event ID.
+ * @param arg0 The first event argument.
+ * @param arg1 The second event argument.
+ */
+inline void event_trace_record(uint32_t id, uint32_t arg0, uint32_t arg1) {
+  event_trace_t *trace = event_trace_active;
+  if (trace != NULL) {
+    uint32_t next = trace->next;
+    event_trace_entry_t *entry = &trace->entry[next % kEventTraceEntryCount];
+    entry->id = id;
+    entry->mcycle = ibex_mcycle32();
+    entry->arg0 = arg0;
+    entry->arg1 = arg1;
+    // Count the event only once its entry is complete.
+    trace->next = next + 1;
+  }
+}
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // OPENTITAN_SW_DEVICE_SILICON_CREATOR_LIB_EVENT_TRACE_H_
@@ -0,0 +1,84 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "sw/device/silicon_creator/lib/event_trace.h"
+
+#include <cstring>
+
+#include "gtest/gtest.h"
+
+namespace event_trace_unittest {
+namespace {
+
+class EventTraceTest : public testing::Test {
+ protected:
+  void SetUp() override { memset(&trace_, 0xa5, sizeof(trace_)); }
+  void TearDown() override { event_trace_active = nullptr; }
+
+  event_trace_t trace_;
+};
+
+TEST_F(EventTraceTest, RecordWithoutInit) {
+  event_trace_active = nullptr;
+  event_trace_record(1, 2, 3);
+  EXPECT_NE(trace_.identifier, kEventTraceIdentifier);
+}
+
+TEST_F(EventTraceTest, InitClearsInvalidTrace) {
+  event_trace_init(&trace_);
+  EXPECT_EQ(event_trace_active, &trace_);
+  EXPECT_EQ(trace_.identifier, kEventTraceIdentifier);
+  EXPECT_EQ(trace_.next, 0u);
+  for (const auto &entry : trace_.entry) {
+    EXPECT_EQ(entry.id, 0u);
+  }
+}
+
+TEST_F(EventTraceTest, Record) {
+  event_trace_init(&trace_);
+  event_trace_record(0x10, 0x11, 0x12);
+  event_trace_record(0x20, 0x21, 0x22);
+
+  EXPECT_EQ(trace_.next, 2u);
+  EXPECT_EQ(trace_.entry[0].id, 0x10u);
+  EXPECT_EQ(trace_.entry[0].arg0, 0x11u);
+  EXPECT_EQ(trace_.entry[0].arg1, 0x12u);
+  EXPECT_EQ(trace_.entry[1].id, 0x20u);
+  EXPECT_EQ(trace_.entry[1].arg0, 0x21u);
+  EXPECT_EQ(trace_.entry[1].arg1, 0x22u);
+  EXPECT_GE(trace_.entry[1].mcycle, trace_.entry[0].mcycle);
+}
+
+TEST_F(EventTraceTest, RecordWrapsAround) {
+  event_trace_init(&trace_);
+  for (uint32_t i = 0; i < kEventTraceEntryCount + 3; ++i) {
+    event_trace_record(i, 0, 0);
+  }
+
+  EXPECT_EQ(trace_.next, kEventTraceEntryCount + 3);
+  // The oldest events were overwritten by the newest ones.
+  EXPECT_EQ(trace_.entry[0].id, kEventTraceEntryCount);
+  EXPECT_EQ(trace_.entry[2].id, kEventTraceEntryCount + 2);
+  EXPECT_EQ(trace_.entry[3].id, 3u);
+}
+
+TEST_F(EventTraceTest, InitKeepsValidTrace) {
+  event_trace_init(&trace_);
+  event_trace_record(0x10, 0x11, 0x12);
+
+  // Tracing resumes after a reset without losing the earlier events.
+  event_trace_active = nullptr;
+  event_trace_init(&trace_);
+  event_trace_record(0x20, 0x21, 0x22);
+  EXPECT_EQ(trace_.next, 2u);
+  EXPECT_EQ(trace_.entry[0].id, 0x10u);
+  EXPECT_EQ(trace_.entry[1].id, 0x20u);
+
+  event_trace_clear(&trace_);
+  EXPECT_EQ(trace_.identifier, kEventTraceIdentifier);
+  EXPECT_EQ(trace_.next, 0u);
+}
+
+}  // namespace
+}  // namespace event_trace_unittest
@@ -17,5 +17,9 @@ rom_error_t boot_data_write(const boot_data_t *boot_data) {
 rom_error_t boot_data_digest_is_valid(const boot_data *boot_data) {
   return MockBootData::Instance().Check(boot_data);
 }
+
+void boot_data_hint_init(boot_data_hint_t *hint) {
+  MockBootData::Instance().HintInit(hint);
+}
 }  // extern "C"
 }  // namespace rom_test
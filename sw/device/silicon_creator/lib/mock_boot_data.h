@@ -21,6 +21,7 @@ class MockBootData : public global_mock::GlobalMock<MockBootData> {
               (lifecycle_state_t lc_state, boot_data_t *boot_data));
   MOCK_METHOD(rom_error_t, Write, (const boot_data_t *boot_data));
   MOCK_METHOD(rom_error_t, Check, (const boot_data_t *boot_data));
+  MOCK_METHOD(void, HintInit, (boot_data_hint_t * hint));
 };
 
 }  // namespace internal
@@ -28,6 +28,7 @@ OTBN_DECLARE_SYMBOL_ADDR(boot, r);     // ECDSA signature component r.
 OTBN_DECLARE_SYMBOL_ADDR(boot, s);     // ECDSA signature component s.
 OTBN_DECLARE_SYMBOL_ADDR(boot, x_r);   // ECDSA verification result.
 OTBN_DECLARE_SYMBOL_ADDR(boot, ok);    // ECDSA verification status.
+OTBN_DECLARE_SYMBOL_ADDR(boot, q_table);  // ECDSA public key comb table.
 OTBN_DECLARE_SYMBOL_ADDR(
     boot, attestation_additional_seed);  // Additional seed for ECDSA keygen.
 
@@ -40,6 +41,8 @@ static const sc_otbn_addr_t kOtbnVarBootR = OTBN_ADDR_T_INIT(boot, r);
 static const sc_otbn_addr_t kOtbnVarBootS = OTBN_ADDR_T_INIT(boot, s);
 static const sc_otbn_addr_t kOtbnVarBootXr = OTBN_ADDR_T_INIT(boot, x_r);
 static const sc_otbn_addr_t kOtbnVarBootOk = OTBN_ADDR_T_INIT(boot, ok);
+static const sc_otbn_addr_t kOtbnVarBootQTable =
+    OTBN_ADDR_T_INIT(boot, q_table);
 static const sc_otbn_addr_t kOtbnVarBootAttestationAdditionalSeed =
     OTBN_ADDR_T_INIT(boot, attestation_additional_seed);
 
@@ -72,6 +75,21 @@ enum {
    * Value taken from `boot.s`.
    */
   kOtbnBootModeAttestationKeySave = 0x64d,
+  /*
+   * Mode to run signature verification with a public key table.
+   *
+   * Value taken from `boot.s`.
+   */
+  kOtbnBootModeSigverifyTable = 0x176,
+  /*
+   * Number of instructions the attestation keygen mode executes until it has
+   * copied the sideloaded key into its registers: the mode dispatch in `start`
+   * (7), the first two instructions of `attestation_keygen` (2) and the four
+   * `bn.wsrr` of `attestation_secret_key_from_seed` (4).
+   *
+   * Value taken from `boot.s`.
+   */
+  kOtbnBootAttestationKeygenSideloadInsns = 13,
   /* Size of the OTBN attestation seed buffer in 32-bit words (rounding the
      attestation seed size up to the next OTBN wide word). */
   kOtbnAttestationSeedBufferWords =
@@ -110,24 +128,23 @@ static rom_error_t load_attestation_keygen_seed(uint32_t additional_seed_idx,
 
 rom_error_t otbn_boot_app_load(void) { return sc_otbn_load_app(kOtbnAppBoot); }
 
-rom_error_t otbn_boot_attestation_keygen(
-    uint32_t additional_seed_idx, sc_keymgr_key_type_t key_type,
-    sc_keymgr_diversification_t diversification,
-    ecdsa_p256_public_key_t *public_key) {
-  // Trigger key manager to sideload the attestation key into OTBN.
-  HARDENED_RETURN_IF_ERROR(
-      sc_keymgr_generate_key_otbn(key_type, diversification));
+rom_error_t otbn_boot_app_resident_load(void) {
+  return sc_otbn_load_app_resident(kOtbnAppBoot);
+}
 
+/**
+ * Writes the mode and additional seed of an attestation keygen to DMEM.
+ *
+ * @param seed The additional seed.
+ * @return The result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+static rom_error_t attestation_keygen_inputs_write(const uint32_t *seed) {
   // Write the mode.
   uint32_t mode = kOtbnBootModeAttestationKeygen;
   HARDENED_RETURN_IF_ERROR(
       sc_otbn_dmem_write(kOtbnBootModeWords, &mode, kOtbnVarBootMode));
 
-  // Load the additional seed from flash info.
-  uint32_t seed[kAttestationSeedWords];
-  HARDENED_RETURN_IF_ERROR(
-      load_attestation_keygen_seed(additional_seed_idx, seed));
-
   // Write the additional seed to OTBN DMEM.
   HARDENED_RETURN_IF_ERROR(sc_otbn_dmem_write(
       kAttestationSeedWords, seed, kOtbnVarBootAttestationAdditionalSeed));
@@ -135,13 +152,47 @@ rom_error_t otbn_boot_attestation_keygen(
   // (since data is aligned to 256-bit words).
   uint32_t zero_buf[kOtbnAttestationSeedBufferWords - kAttestationSeedWords] = {
       0};
-  HARDENED_RETURN_IF_ERROR(sc_otbn_dmem_write(
+  return sc_otbn_dmem_write(
       ARRAYSIZE(zero_buf), zero_buf,
-      kOtbnVarBootAttestationAdditionalSeed + kAttestationSeedBytes));
+      kOtbnVarBootAttestationAdditionalSeed + kAttestationSeedBytes);
+}
 
-  // Run the OTBN program (blocks until OTBN is done).
-  HARDENED_RETURN_IF_ERROR(sc_otbn_execute());
+/**
+ * Starts the attestation keygen program once the key manager has sideloaded
+ * its key, and waits until the program has consumed the key.
+ *
+ * @return The result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+static rom_error_t attestation_keygen_execute_start(void) {
+  HARDENED_RETURN_IF_ERROR(sc_keymgr_generate_key_finalize());
+  HARDENED_RETURN_IF_ERROR(sc_otbn_execute_start());
   SEC_MMIO_WRITE_INCREMENT(kScOtbnSecMmioExecute);
+  sc_otbn_instruction_count_wait(kOtbnBootAttestationKeygenSideloadInsns);
+  return kErrorOk;
+}
+
+rom_error_t otbn_boot_attestation_keygen_start(
+    uint32_t additional_seed_idx, sc_keymgr_key_type_t key_type,
+    sc_keymgr_diversification_t diversification) {
+  // Trigger key manager to sideload the attestation key into OTBN, and prepare
+  // the rest of the inputs while it runs.
+  HARDENED_RETURN_IF_ERROR(sc_keymgr_generate_key_start(
+      kScKeymgrDestOtbn, key_type, diversification));
+
+  // Load the additional seed from flash info.
+  uint32_t seed[kAttestationSeedWords];
+  HARDENED_RETURN_IF_ERROR(
+      load_attestation_keygen_seed(additional_seed_idx, seed));
+  HARDENED_RETURN_IF_ERROR(attestation_keygen_inputs_write(seed));
+
+  return attestation_keygen_execute_start();
+}
+
+rom_error_t otbn_boot_attestation_keygen_finalize(
+    ecdsa_p256_public_key_t *public_key) {
+  // Wait for the OTBN program to complete.
+  HARDENED_RETURN_IF_ERROR(sc_otbn_execute_finalize());
 
   // TODO(#20023): Check the instruction count register (see `mod_exp_otbn`).
 
@@ -154,6 +205,15 @@ rom_error_t otbn_boot_attestation_keygen(
   return kErrorOk;
 }
 
+rom_error_t otbn_boot_attestation_keygen(
+    uint32_t additional_seed_idx, sc_keymgr_key_type_t key_type,
+    sc_keymgr_diversification_t diversification,
+    ecdsa_p256_public_key_t *public_key) {
+  HARDENED_RETURN_IF_ERROR(otbn_boot_attestation_keygen_start(
+      additional_seed_idx, key_type, diversification));
+  return otbn_boot_attestation_keygen_finalize(public_key);
+}
+
 /**
  * Helper function to convert an ECC P256 public key from little to big endian
  * in place.
@@ -163,14 +223,18 @@ static void pubkey_le_to_be_convert(ecdsa_p256_public_key_t *pubkey) {
   util_reverse_bytes(pubkey->y, kEcdsaP256PublicKeyCoordBytes);
 }
 
-rom_error_t otbn_boot_cert_ecc_p256_keygen(sc_keymgr_ecc_key_t key,
-                                           hmac_digest_t *pubkey_id,
-                                           ecdsa_p256_public_key_t *pubkey) {
+rom_error_t otbn_boot_cert_ecc_p256_keygen_start(sc_keymgr_ecc_key_t key) {
   HARDENED_RETURN_IF_ERROR(sc_keymgr_state_check(key.required_keymgr_state));
 
-  // Generate / sideload key material into OTBN, and generate the ECC keypair.
-  HARDENED_RETURN_IF_ERROR(otbn_boot_attestation_keygen(
-      key.keygen_seed_idx, key.type, *key.keymgr_diversifier, pubkey));
+  // Generate / sideload key material into OTBN, and start generating the ECC
+  // keypair.
+  return otbn_boot_attestation_keygen_start(key.keygen_seed_idx, key.type,
+                                            *key.keymgr_diversifier);
+}
+
+rom_error_t otbn_boot_cert_ecc_p256_keygen_finalize(
+    hmac_digest_t *pubkey_id, ecdsa_p256_public_key_t *pubkey) {
+  HARDENED_RETURN_IF_ERROR(otbn_boot_attestation_keygen_finalize(pubkey));
 
   // Keys are represented in certificates in big endian format, but the key is
   // output from OTBN in little endian format, so we convert the key to
@@ -188,12 +252,52 @@ rom_error_t otbn_boot_cert_ecc_p256_keygen(sc_keymgr_ecc_key_t key,
   return kErrorOk;
 }
 
+rom_error_t otbn_boot_cert_ecc_p256_keygen(sc_keymgr_ecc_key_t key,
+                                           hmac_digest_t *pubkey_id,
+                                           ecdsa_p256_public_key_t *pubkey) {
+  HARDENED_RETURN_IF_ERROR(otbn_boot_cert_ecc_p256_keygen_start(key));
+  return otbn_boot_cert_ecc_p256_keygen_finalize(pubkey_id, pubkey);
+}
+
+rom_error_t otbn_boot_cert_ecc_p256_keygen_batch(
+    const sc_keymgr_ecc_key_t *keys, size_t num_keys,
+    hmac_digest_t *pubkey_ids, ecdsa_p256_public_key_t *pubkeys) {
+  if (num_keys == 0) {
+    return kErrorOk;
+  }
+  HARDENED_RETURN_IF_ERROR(otbn_boot_cert_ecc_p256_keygen_start(keys[0]));
+
+  for (size_t i = 1; i < num_keys; ++i) {
+    // OTBN has consumed the previous key, so the key manager can derive the
+    // next one while OTBN generates the previous keypair.
+    HARDENED_RETURN_IF_ERROR(
+        sc_keymgr_state_check(keys[i].required_keymgr_state));
+    HARDENED_RETURN_IF_ERROR(
+        sc_keymgr_generate_key_start(kScKeymgrDestOtbn, keys[i].type,
+                                     *keys[i].keymgr_diversifier));
+    uint32_t seed[kAttestationSeedWords];
+    HARDENED_RETURN_IF_ERROR(
+        load_attestation_keygen_seed(keys[i].keygen_seed_idx, seed));
+
+    // Collect the previous keypair, and start the next one as soon as its key
+    // is ready.
+    HARDENED_RETURN_IF_ERROR(otbn_boot_cert_ecc_p256_keygen_finalize(
+        &pubkey_ids[i - 1], &pubkeys[i - 1]));
+    HARDENED_RETURN_IF_ERROR(attestation_keygen_inputs_write(seed));
+    HARDENED_RETURN_IF_ERROR(attestation_keygen_execute_start());
+  }
+
+  return otbn_boot_cert_ecc_p256_keygen_finalize(&pubkey_ids[num_keys - 1],
+                                                 &pubkeys[num_keys - 1]);
+}
+
 rom_error_t otbn_boot_attestation_key_save(
     uint32_t additional_seed_idx, sc_keymgr_key_type_t key_type,
     sc_keymgr_diversification_t diversification) {
-  // Trigger key manager to sideload the attestation key into OTBN.
-  HARDENED_RETURN_IF_ERROR(
-      sc_keymgr_generate_key_otbn(key_type, diversification));
+  // Trigger key manager to sideload the attestation key into OTBN, and prepare
+  // the rest of the inputs while it runs.
+  HARDENED_RETURN_IF_ERROR(sc_keymgr_generate_key_start(
+      kScKeymgrDestOtbn, key_type, diversification));
 
   // Write the mode.
   uint32_t mode = kOtbnBootModeAttestationKeySave;
@@ -217,6 +321,7 @@ rom_error_t otbn_boot_attestation_key_save(
       kAttestationSeedWords, seed, kOtbnVarBootAttestationAdditionalSeed));
 
   // Run the OTBN program (blocks until OTBN is done).
+  HARDENED_RETURN_IF_ERROR(sc_keymgr_generate_key_finalize());
   HARDENED_RETURN_IF_ERROR(sc_otbn_execute());
   SEC_MMIO_WRITE_INCREMENT(kScOtbnSecMmioExecute);
 
@@ -272,12 +377,21 @@ rom_error_t otbn_boot_attestation_endorse(const hmac_digest_t *digest,
   return kErrorOk;
 }
 
-rom_error_t otbn_boot_sigverify(const ecdsa_p256_public_key_t *key,
-                                const ecdsa_p256_signature_t *sig,
-                                const hmac_digest_t *digest,
-                                uint32_t *recovered_r) {
+/**
+ * Writes the inputs of a signature verification and starts OTBN.
+ *
+ * @param mode Verification mode.
+ * @param key An ECDSA-P256 public key.
+ * @param sig An ECDSA-P256 signature.
+ * @param digest Message digest to check against.
+ * @return The result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+static rom_error_t sigverify_start(uint32_t mode,
+                                   const ecdsa_p256_public_key_t *key,
+                                   const ecdsa_p256_signature_t *sig,
+                                   const hmac_digest_t *digest) {
   // Write the mode.
-  uint32_t mode = kOtbnBootModeSigverify;
   HARDENED_RETURN_IF_ERROR(
       sc_otbn_dmem_write(kOtbnBootModeWords, &mode, kOtbnVarBootMode));
 
@@ -298,8 +412,30 @@ rom_error_t otbn_boot_sigverify(const ecdsa_p256_public_key_t *key,
                                               sig->s, kOtbnVarBootS));
 
   // Start the OTBN routine.
-  HARDENED_RETURN_IF_ERROR(sc_otbn_execute());
+  HARDENED_RETURN_IF_ERROR(sc_otbn_execute_start());
   SEC_MMIO_WRITE_INCREMENT(kScOtbnSecMmioExecute);
+  return kErrorOk;
+}
+
+rom_error_t otbn_boot_sigverify_start(const ecdsa_p256_public_key_t *key,
+                                      const ecdsa_p256_signature_t *sig,
+                                      const hmac_digest_t *digest) {
+  return sigverify_start(kOtbnBootModeSigverify, key, sig, digest);
+}
+
+rom_error_t otbn_boot_sigverify_table_start(
+    const ecdsa_p256_public_key_t *key,
+    const ecdsa_p256_public_key_table_t *table,
+    const ecdsa_p256_signature_t *sig, const hmac_digest_t *digest) {
+  // Write the table.
+  HARDENED_RETURN_IF_ERROR(sc_otbn_dmem_write(
+      kEcdsaP256PublicKeyTableWords, table->points, kOtbnVarBootQTable));
+  return sigverify_start(kOtbnBootModeSigverifyTable, key, sig, digest);
+}
+
+rom_error_t otbn_boot_sigverify_finalize(uint32_t *recovered_r) {
+  // Wait for the OTBN routine to complete.
+  HARDENED_RETURN_IF_ERROR(sc_otbn_execute_finalize());
 
   // Check if the signature passed basic checks.
   uint32_t ok;
@@ -318,3 +454,11 @@ rom_error_t otbn_boot_sigverify(const ecdsa_p256_public_key_t *key,
   return sc_otbn_dmem_read(kEcdsaP256SignatureComponentWords, kOtbnVarBootXr,
                            recovered_r);
 }
+
+rom_error_t otbn_boot_sigverify(const ecdsa_p256_public_key_t *key,
+                                const ecdsa_p256_signature_t *sig,
+                                const hmac_digest_t *digest,
+                                uint32_t *recovered_r) {
+  HARDENED_RETURN_IF_ERROR(otbn_boot_sigverify_start(key, sig, digest));
+  return otbn_boot_sigverify_finalize(recovered_r);
+}
@@ -30,6 +30,19 @@ extern "C" {
 OT_WARN_UNUSED_RESULT
 rom_error_t otbn_boot_app_load(void);
 
+/**
+ * Loads the OTBN boot-services application, reusing the copy left by ROM.
+ *
+ * ROM loads the same program for signature verification. Instead of wiping
+ * and reloading IMEM, this checks the resident copy against the program's
+ * checksum with OTBN's `LOAD_CHECKSUM` register, and only loads it again if
+ * the check fails. DMEM is always wiped and its data section rewritten.
+ *
+ * @return The result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+rom_error_t otbn_boot_app_resident_load(void);
+
 /**
  * Generate an attestation public key from a keymgr-derived secret.
  *
@@ -118,6 +131,83 @@ rom_error_t otbn_boot_cert_ecc_p256_keygen(sc_keymgr_ecc_key_t key,
                                            hmac_digest_t *pubkey_id,
                                            ecdsa_p256_public_key_t *pubkey);
 
+/**
+ * Starts generating an attestation keypair without waiting for OTBN.
+ *
+ * Asynchronous variant of `otbn_boot_attestation_keygen()`. The key manager
+ * derives the sideloaded key while Ibex loads the additional seed into DMEM.
+ * The function returns once OTBN has copied the sideloaded key into its
+ * registers. From then on Ibex may issue further key manager operations, e.g.
+ * the derivation of the next key, but must not access OTBN until
+ * `otbn_boot_attestation_keygen_finalize()` returns.
+ *
+ * @param additional_seed_idx The attestation key generation seed index to load.
+ * @param key_type Keymgr key type to generate, attestation or sealing.
+ * @param diversification Salt and version information for key manager.
+ * @return The result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+rom_error_t otbn_boot_attestation_keygen_start(
+    uint32_t additional_seed_idx, sc_keymgr_key_type_t key_type,
+    sc_keymgr_diversification_t diversification);
+
+/**
+ * Waits for a keypair generation started with
+ * `otbn_boot_attestation_keygen_start()`.
+ *
+ * @param[out] public_key Attestation public key.
+ * @return The result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+rom_error_t otbn_boot_attestation_keygen_finalize(
+    ecdsa_p256_public_key_t *public_key);
+
+/**
+ * Starts generating a certificate keypair without waiting for OTBN.
+ *
+ * Asynchronous variant of `otbn_boot_cert_ecc_p256_keygen()`; see
+ * `otbn_boot_attestation_keygen_start()` for what Ibex may do while OTBN runs.
+ *
+ * @param key The description of the desired key to generate.
+ * @return The result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+rom_error_t otbn_boot_cert_ecc_p256_keygen_start(sc_keymgr_ecc_key_t key);
+
+/**
+ * Waits for a keypair generation started with
+ * `otbn_boot_cert_ecc_p256_keygen_start()`.
+ *
+ * @param[out] pubkey_id The public key ID (for embedding into certificates).
+ * @param[out] pubkey The public key.
+ * @return The result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+rom_error_t otbn_boot_cert_ecc_p256_keygen_finalize(
+    hmac_digest_t *pubkey_id, ecdsa_p256_public_key_t *pubkey);
+
+/**
+ * Generates several certificate keypairs, overlapping the key manager
+ * derivation of each key with the OTBN keypair generation of the previous one.
+ *
+ * Produces the same keys as calling `otbn_boot_cert_ecc_p256_keygen()` for
+ * each key in turn, but takes roughly the time of the OTBN runs alone, rather
+ * than the sum of the key manager and OTBN times.
+ *
+ * Preconditions: keymgr has been initialized and cranked to the stage
+ * required by each key.
+ *
+ * @param keys The descriptions of the keys to generate.
+ * @param num_keys The number of keys to generate.
+ * @param[out] pubkey_ids The public key IDs, one per key.
+ * @param[out] pubkeys The public keys, one per key.
+ * @return The result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+rom_error_t otbn_boot_cert_ecc_p256_keygen_batch(
+    const sc_keymgr_ecc_key_t *keys, size_t num_keys,
+    hmac_digest_t *pubkey_ids, ecdsa_p256_public_key_t *pubkeys);
+
 /**
  * Saves an attestation private key to OTBN's scratchpad.
  *
@@ -200,6 +290,60 @@ rom_error_t otbn_boot_sigverify(const ecdsa_p256_public_key_t *key,
                                 const hmac_digest_t *digest,
                                 uint32_t *recovered_r);
 
+/**
+ * Starts an ECDSA-P256 signature verification on OTBN without waiting for it.
+ *
+ * Asynchronous variant of `otbn_boot_sigverify()`: Ibex may use other
+ * peripherals (e.g. HMAC/KMAC) while OTBN runs, but must not access OTBN
+ * until `otbn_boot_sigverify_finalize()` returns.
+ *
+ * Expects the OTBN boot-services program to already be loaded; see
+ * `otbn_boot_app_load`.
+ *
+ * @param key An ECDSA-P256 public key.
+ * @param sig An ECDSA-P256 signature.
+ * @param digest Message digest to check against.
+ * @return The result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+rom_error_t otbn_boot_sigverify_start(const ecdsa_p256_public_key_t *key,
+                                      const ecdsa_p256_signature_t *sig,
+                                      const hmac_digest_t *digest);
+
+/**
+ * Starts an ECDSA-P256 signature verification with a precomputed key table.
+ *
+ * Same as `otbn_boot_sigverify_start()`, but OTBN uses the comb table of the
+ * public key instead of a generic double-and-add loop, which makes the
+ * verification about a third faster. OTBN checks that the first entry of the
+ * table is `key` and fails the verification otherwise; the other entries are
+ * trusted, so `table` must come from storage that is as trustworthy as `key`.
+ *
+ * Expects the OTBN boot-services program to already be loaded; see
+ * `otbn_boot_app_load`.
+ *
+ * @param key An ECDSA-P256 public key.
+ * @param table Precomputed table for `key`.
+ * @param sig An ECDSA-P256 signature.
+ * @param digest Message digest to check against.
+ * @return The result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+rom_error_t otbn_boot_sigverify_table_start(
+    const ecdsa_p256_public_key_t *key,
+    const ecdsa_p256_public_key_table_t *table,
+    const ecdsa_p256_signature_t *sig, const hmac_digest_t *digest);
+
+/**
+ * Waits for a verification started with `otbn_boot_sigverify_start()` or
+ * `otbn_boot_sigverify_table_start()`.
+ *
+ * @param[out] recovered_r Buffer for the recovered `r` value.
+ * @return The result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+rom_error_t otbn_boot_sigverify_finalize(uint32_t *recovered_r);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -5,6 +5,8 @@
 #include "sw/device/lib/crypto/drivers/entropy.h"
 #include "sw/device/lib/dif/dif_keymgr.h"
 #include "sw/device/lib/dif/dif_kmac.h"
+#include "sw/device/lib/runtime/ibex.h"
+#include "sw/device/lib/runtime/log.h"
 #include "sw/device/lib/testing/flash_ctrl_testutils.h"
 #include "sw/device/lib/testing/keymgr_testutils.h"
 #include "sw/device/lib/testing/test_framework/check.h"
@@ -35,6 +37,41 @@ static const ecdsa_p256_public_key_t kEcdsaKey = {
           0xbfececf0, 0x9b94e34d, 0x59b12f3c},
 };
 
+// Precomputed table for `kEcdsaKey` (from `ecdsa_p256_table_gen.py`).
+static const ecdsa_p256_public_key_table_t kEcdsaKeyTable = {
+    .points =
+        {
+            0x1ceb402b, 0x9dc600d1, 0x182ec21b, 0x5ede3640,
+            0x3566bdac, 0x1debf94b, 0x1a286a75, 0x8904d749,
+            0x63eab6dc, 0x0c53bf99, 0x086d3ee7, 0x1076efa6,
+            0x8dd8ece2, 0xbfececf0, 0x9b94e34d, 0x59b12f3c,
+            0xe20ac58f, 0xd0f178d6, 0xa1945010, 0x2e43fe5d,
+            0x981d20cf, 0xc57132c3, 0x3d3c6cf9, 0xcf8cabd6,
+            0x3ba86f9b, 0xfb487da2, 0xd6e2f109, 0xe3039522,
+            0x57e89d3d, 0x7b059c59, 0x83307f4e, 0x1ede63a8,
+            0xb13245d3, 0x17105689, 0x472a2555, 0x4bc156b5,
+            0x7c803d38, 0x8e518277, 0x116b9c05, 0x710dce6b,
+            0x5f79603e, 0x18e19f98, 0x3d06153f, 0xa01b2f35,
+            0xb35d825e, 0x4033f726, 0xd96f18ff, 0x5e3cbad3,
+            0x43f4a778, 0xf75cbd1f, 0xb9e6489d, 0x17a2662e,
+            0xfc304ad8, 0x7799e432, 0x9d843a85, 0xa1bcc71c,
+            0x8dc76fb3, 0xd60825a7, 0x39fabc71, 0xf1124f7e,
+            0x70203a1a, 0x96986bfa, 0x704d0d13, 0xdeede05c,
+            0xd26acd06, 0xd99bb78e, 0xc659e9a5, 0xa6dbefd3,
+            0xec2eb3e7, 0x579f2650, 0x062c3d28, 0x53724888,
+            0xd6350561, 0x501d24c7, 0x4fe15797, 0x2efe50e9,
+            0x1b741f8a, 0x681030c6, 0xb0193be6, 0xd02fe9dd,
+            0x0ec185fc, 0x94b30796, 0xc305d736, 0x473c3850,
+            0xbf835795, 0x7ec20869, 0xf367ac08, 0x016cb084,
+            0x2496c5f7, 0xb62ead05, 0xc0673672, 0x877a5c64,
+            0x902b72df, 0x59ef763a, 0x08224b0d, 0x7e92cbf7,
+            0x84524bb1, 0xdb3014e2, 0x8e4cb481, 0x48098b24,
+            0xc676bce0, 0x35d86fbd, 0xf0f0986d, 0x84a5543d,
+            0x0fb73342, 0x3108c5c4, 0x426f5c43, 0x52bc6560,
+            0x95736ba8, 0x25c47eed, 0x162a98d4, 0x873cf057,
+        },
+};
+
 // Valid ECDSA-P256 signature for `kTestMessage`.
 static const ecdsa_p256_signature_t kEcdsaSignature = {
     .r = {0x4811545a, 0x088d927b, 0x5d8624b5, 0x2ef1f329, 0x184ba14a,
@@ -73,6 +110,26 @@ rom_error_t sigverify_test(void) {
   return kErrorOk;
 }
 
+rom_error_t sigverify_table_test(void) {
+  hmac_digest_t digest;
+  hmac_sha256(kTestMessage, kTestMessageLen, &digest);
+
+  uint32_t recovered_r[kEcdsaP256SignatureComponentWords];
+  RETURN_IF_ERROR(otbn_boot_sigverify_table_start(&kEcdsaKey, &kEcdsaKeyTable,
+                                                  &kEcdsaSignature, &digest));
+  RETURN_IF_ERROR(otbn_boot_sigverify_finalize(recovered_r));
+  CHECK_ARRAYS_EQ(recovered_r, kEcdsaSignature.r, ARRAYSIZE(kEcdsaSignature.r));
+
+  // A table for a different key must be rejected.
+  ecdsa_p256_public_key_table_t bad_table = kEcdsaKeyTable;
+  bad_table.points[0] ^= 1;
+  RETURN_IF_ERROR(otbn_boot_sigverify_table_start(&kEcdsaKey, &bad_table,
+                                                  &kEcdsaSignature, &digest));
+  CHECK(otbn_boot_sigverify_finalize(recovered_r) ==
+        kErrorSigverifyBadEcdsaSignature);
+  return kErrorOk;
+}
+
 rom_error_t attestation_keygen_test(void) {
   // Check that key generations with different seeds result in different keys.
   ecdsa_p256_public_key_t pk_uds;
@@ -123,6 +180,55 @@ rom_error_t attestation_keygen_test(void) {
   return kErrorOk;
 }
 
+rom_error_t attestation_keygen_batch_test(void) {
+  const sc_keymgr_ecc_key_t kKeys[] = {
+      {
+          .type = kScKeymgrKeyTypeAttestation,
+          .keygen_seed_idx = kFlashInfoFieldUdsKeySeedIdx,
+          .keymgr_diversifier = &kDiversification,
+          .required_keymgr_state = kScKeymgrStateCreatorRootKey,
+      },
+      {
+          .type = kScKeymgrKeyTypeAttestation,
+          .keygen_seed_idx = kFlashInfoFieldCdi0KeySeedIdx,
+          .keymgr_diversifier = &kDiversification,
+          .required_keymgr_state = kScKeymgrStateCreatorRootKey,
+      },
+      {
+          .type = kScKeymgrKeyTypeSealing,
+          .keygen_seed_idx = kFlashInfoFieldTpmEkKeySeedIdx,
+          .keymgr_diversifier = &kDiversification,
+          .required_keymgr_state = kScKeymgrStateCreatorRootKey,
+      },
+  };
+
+  // Generate the keys one after the other.
+  hmac_digest_t ids[ARRAYSIZE(kKeys)];
+  ecdsa_p256_public_key_t pks[ARRAYSIZE(kKeys)];
+  uint64_t start = ibex_mcycle_read();
+  for (size_t i = 0; i < ARRAYSIZE(kKeys); ++i) {
+    RETURN_IF_ERROR(otbn_boot_cert_ecc_p256_keygen(kKeys[i], &ids[i], &pks[i]));
+  }
+  uint32_t sequential_cycles = (uint32_t)(ibex_mcycle_read() - start);
+
+  // Check that overlapping the key manager and OTBN results in the same keys.
+  hmac_digest_t batch_ids[ARRAYSIZE(kKeys)];
+  ecdsa_p256_public_key_t batch_pks[ARRAYSIZE(kKeys)];
+  start = ibex_mcycle_read();
+  RETURN_IF_ERROR(otbn_boot_cert_ecc_p256_keygen_batch(
+      kKeys, ARRAYSIZE(kKeys), batch_ids, batch_pks));
+  uint32_t batch_cycles = (uint32_t)(ibex_mcycle_read() - start);
+  LOG_INFO("%d keys: %d cycles sequentially, %d cycles batched",
+           ARRAYSIZE(kKeys), sequential_cycles, batch_cycles);
+
+  CHECK_ARRAYS_EQ((unsigned char *)batch_pks, (unsigned char *)pks,
+                  sizeof(pks));
+  CHECK_ARRAYS_EQ((unsigned char *)batch_ids, (unsigned char *)ids,
+                  sizeof(ids));
+  CHECK(batch_cycles <= sequential_cycles);
+  return kErrorOk;
+}
+
 rom_error_t attestation_advance_and_endorse_test(void) {
   // Generate and save the a keypair.
   ecdsa_p256_public_key_t pk;
@@ -250,7 +356,9 @@ bool test_main(void) {
   CHECK(otbn_boot_app_load() == kErrorOk);
 
   EXECUTE_TEST(result, sigverify_test);
+  EXECUTE_TEST(result, sigverify_table_test);
   EXECUTE_TEST(result, attestation_keygen_test);
+  EXECUTE_TEST(result, attestation_keygen_batch_test);
   EXECUTE_TEST(result, attestation_advance_and_endorse_test);
   EXECUTE_TEST(result, attestation_keygen_test);
   EXECUTE_TEST(result, attestation_advance_and_endorse_test);
@@ -345,7 +345,7 @@ typedef struct owner_rescue_config {
    * length: 16 + sizeof(command_allow).
    */
   tlv_header_t header;
-  /** The rescue type.  Currently, only `XMDM` is supported. */
+  /** The rescue type: `XMDM` (xmodem over UART) or `SPIF` (SPI flash). */
   uint32_t rescue_type;
   /** The start offset of the rescue region in flash (in pages). */
   uint16_t start;
@@ -25,6 +25,65 @@ enum {
   kFlashPageSize = FLASH_CTRL_PARAM_BYTES_PER_PAGE,
 };
 
+/**
+ * The result of a successful `owner_block_parse()` of one of the owner pages.
+ */
+typedef struct owner_block_parse_cache {
+  /** Whether this entry holds a parse result. */
+  hardened_bool_t valid;
+  /** The configuration items found in the page. */
+  owner_config_t config;
+  /** The number of application keys found in the page. */
+  size_t key_count;
+  /** Pointers to the application keys found in the page. */
+  const owner_application_key_t *key[ARRAYSIZE(
+      ((owner_application_keyring_t *)NULL)->key)];
+} owner_block_parse_cache_t;
+
+static owner_block_parse_cache_t parse_cache[ARRAYSIZE(owner_page)];
+
+void owner_block_parse_cache_invalidate(void) {
+  for (size_t i = 0; i < ARRAYSIZE(parse_cache); ++i) {
+    parse_cache[i].valid = kHardenedBoolFalse;
+  }
+}
+
+static owner_block_parse_cache_t *parse_cache_get(const owner_block_t *block) {
+  for (size_t i = 0; i < ARRAYSIZE(owner_page); ++i) {
+    if (block == &owner_page[i]) {
+      return &parse_cache[i];
+    }
+  }
+  return NULL;
+}
+
+static uint64_t keyring_sort_key(const owner_application_key_t *key) {
+  return (uint64_t)key->key_alg << 32 | key->data.id;
+}
+
+/**
+ * Append a key to the keyring, keeping `keyring->order` sorted.
+ *
+ * Keys that compare equal keep their keyring order so that a lookup returns
+ * the first matching key.
+ */
+static void keyring_add(owner_application_keyring_t *keyring,
+                        const owner_application_key_t *key) {
+  if (keyring->length >= ARRAYSIZE(keyring->key)) {
+    return;
+  }
+  size_t n = keyring->length++;
+  keyring->key[n] = key;
+  uint64_t sort_key = keyring_sort_key(key);
+  size_t i = n;
+  for (; i > 0 && keyring_sort_key(keyring->key[keyring->order[i - 1]]) >
+                      sort_key;
+       --i) {
+    keyring->order[i] = keyring->order[i - 1];
+  }
+  keyring->order[i] = (uint8_t)n;
+}
+
 hardened_bool_t owner_block_newversion_mode(void) {
   if (owner_page_valid[0] == kOwnerPageStatusSealed &&
       (owner_page[0].update_mode == kOwnershipUpdateModeNewVersion ||
@@ -79,9 +138,9 @@ void owner_config_default(owner_config_t *config) {
   config->sram_exec = kOwnerSramExecModeDisabledLocked;
 }
 
-rom_error_t owner_block_parse(const owner_block_t *block,
-                              owner_config_t *config,
-                              owner_application_keyring_t *keyring) {
+static rom_error_t owner_block_parse_items(
+    const owner_block_t *block, owner_config_t *config,
+    owner_application_keyring_t *keyring, owner_block_parse_cache_t *cache) {
   owner_config_default(config);
   if (block->header.tag != kTlvTagOwner)
     return kErrorOwnershipInvalidTag;
@@ -111,8 +170,9 @@ rom_error_t owner_block_parse(const owner_block_t *block,
         if (item->version.major != 0)
           return kErrorOwnershipAPPKVersion;
 
-        if (keyring->length < ARRAYSIZE(keyring->key)) {
-          keyring->key[keyring->length++] =
+        keyring_add(keyring, (const owner_application_key_t *)item);
+        if (cache->key_count < ARRAYSIZE(cache->key)) {
+          cache->key[cache->key_count++] =
               (const owner_application_key_t *)item;
         }
         break;
@@ -149,6 +209,33 @@ rom_error_t owner_block_parse(const owner_block_t *block,
   return kErrorOk;
 }
 
+rom_error_t owner_block_parse(const owner_block_t *block,
+                              owner_config_t *config,
+                              owner_application_keyring_t *keyring) {
+  owner_block_parse_cache_t *cache = parse_cache_get(block);
+  if (cache != NULL && launder32(cache->valid) == kHardenedBoolTrue) {
+    HARDENED_CHECK_EQ(cache->valid, kHardenedBoolTrue);
+    *config = cache->config;
+    for (size_t i = 0; i < cache->key_count; ++i) {
+      keyring_add(keyring, cache->key[i]);
+    }
+    return kErrorOk;
+  }
+
+  owner_block_parse_cache_t result = {
+      .valid = kHardenedBoolFalse,
+      .key_count = 0,
+  };
+  HARDENED_RETURN_IF_ERROR(
+      owner_block_parse_items(block, config, keyring, &result));
+  if (cache != NULL) {
+    result.config = *config;
+    result.valid = kHardenedBoolTrue;
+    *cache = result;
+  }
+  return kErrorOk;
+}
+
 rom_error_t owner_block_flash_check(const owner_flash_config_t *flash) {
   size_t len = (flash->header.length - sizeof(owner_flash_config_t)) /
                sizeof(owner_flash_region_t);
@@ -306,7 +393,21 @@ rom_error_t owner_block_info_apply(const owner_flash_info_config_t *info) {
 rom_error_t owner_keyring_find_key(const owner_application_keyring_t *keyring,
                                    uint32_t key_alg, uint32_t key_id,
                                    size_t *index) {
-  for (size_t i = 0; i < keyring->length; ++i) {
+  // Binary search for the first key not less than the requested one.
+  const uint64_t sort_key = (uint64_t)key_alg << 32 | key_id;
+  size_t lo = 0;
+  size_t hi = keyring->length;
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    if (keyring_sort_key(keyring->key[keyring->order[mid]]) < sort_key) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  if (lo < keyring->length) {
+    size_t i = keyring->order[lo];
+    HARDENED_CHECK_LT(i, keyring->length);
     if (keyring->key[i]->key_alg == key_alg &&
         keyring->key[i]->data.id == key_id) {
       *index = i;
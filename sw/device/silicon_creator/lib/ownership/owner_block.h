@@ -56,6 +56,8 @@ typedef struct owner_application_keyring {
   size_t length;
   /** Pointers to the application keys. */
   const owner_application_key_t *key[16];
+  /** Indices into `key`, sorted by key algorithm and key ID. */
+  uint8_t order[16];
 } owner_application_keyring_t;
 
 /**
@@ -86,6 +88,9 @@ void owner_config_default(owner_config_t *config);
 /**
  * Parse an owner block, extracting pointers to keys and configuration items.
  *
+ * A successful parse of one of the RAM owner pages is cached, so parsing the
+ * same page again does not walk its TLV items.
+ *
  * @param block The owner block to parse.
  * @param config A pointer to a config struct holding pointers to config items.
  * @param keyring A pointer to a keyring struct holding application key
@@ -96,6 +101,15 @@ rom_error_t owner_block_parse(const owner_block_t *block,
                               owner_config_t *config,
                               owner_application_keyring_t *keyring);
 
+/**
+ * Drop the results of previous `owner_block_parse()` calls on the owner pages.
+ *
+ * The parse results of `owner_page[0]` and `owner_page[1]` are kept until this
+ * function is called.  It must be called whenever the RAM copy of the owner
+ * pages changes.
+ */
+void owner_block_parse_cache_invalidate(void);
+
 /**
  * Check the flash config for errors.
  *
@@ -128,6 +142,15 @@ rom_error_t owner_block_flash_apply(const owner_flash_config_t *flash,
  */
 rom_error_t owner_block_info_apply(const owner_flash_info_config_t *info);
 
+/**
+ * Find an application key in the keyring.
+ *
+ * @param keyring A pointer to a keyring populated by `owner_block_parse()`.
+ * @param key_alg The algorithm of the key.
+ * @param key_id The ID of the key.
+ * @param index The index of the key in `keyring->key`.
+ * @return error code.
+ */
 rom_error_t owner_keyring_find_key(const owner_application_keyring_t *keyring,
                                    uint32_t key_alg, uint32_t key_id,
                                    size_t *index);
@@ -722,4 +722,83 @@ INSTANTIATE_TEST_SUITE_P(AllCases, RomExtFlashConfigTest,
                                          &invalid_flash_2, &invalid_flash_3,
                                          &invalid_flash_4));
 
+TEST_F(OwnerBlockTest, ParseOwnerPageCached) {
+  EXPECT_CALL(flash_ctrl_, DataDefaultCfgGet)
+      .WillRepeatedly(Return(default_config));
+  memcpy(&owner_page[0], basic_owner, sizeof(owner_page[0]));
+  owner_block_parse_cache_invalidate();
+  owner_config_t config;
+  owner_application_keyring_t keyring{};
+  EXPECT_EQ(owner_block_parse(&owner_page[0], &config, &keyring), kErrorOk);
+  EXPECT_EQ(keyring.length, 1);
+
+  // A cached parse does not look at the page again.
+  owner_page[0].header.tag = 0x41414141;
+  owner_config_t cached;
+  owner_application_keyring_t cached_keyring{};
+  EXPECT_EQ(owner_block_parse(&owner_page[0], &cached, &cached_keyring),
+            kErrorOk);
+  EXPECT_EQ(cached.sram_exec, config.sram_exec);
+  EXPECT_EQ(cached.flash, config.flash);
+  EXPECT_EQ(cached.info, config.info);
+  EXPECT_EQ(cached.rescue, config.rescue);
+  EXPECT_EQ(cached_keyring.length, 1);
+  EXPECT_EQ(cached_keyring.key[0], keyring.key[0]);
+
+  owner_block_parse_cache_invalidate();
+  EXPECT_EQ(owner_block_parse(&owner_page[0], &cached, &cached_keyring),
+            kErrorOwnershipInvalidTag);
+}
+
+TEST_F(OwnerBlockTest, FindKey) {
+  constexpr uint32_t kKeyLength = offsetof(owner_application_key_t, data) +
+                                  sizeof(ecdsa_p256_public_key_t);
+  struct {
+    uint32_t alg;
+    uint32_t id;
+  } keys[] = {
+      {kOwnershipKeyAlgEcdsaP256, 0x30}, {kOwnershipKeyAlgSpx, 0x10},
+      {kOwnershipKeyAlgEcdsaP256, 0x10}, {kOwnershipKeyAlgEcdsaP256, 0x20},
+      {kOwnershipKeyAlgSpx, 0x30},       {kOwnershipKeyAlgEcdsaP256, 0x20},
+      {kOwnershipKeyAlgEcdsaP256, 0x05}, {kOwnershipKeyAlgRsa, 0x20},
+  };
+  owner_block_t block;
+  memset(&block, 0, sizeof(block));
+  block.header.tag = kTlvTagOwner;
+  block.header.length = sizeof(owner_block_t);
+  memset(block.data, 0x5a, sizeof(block.data));
+  for (size_t i = 0; i < ARRAYSIZE(keys); ++i) {
+    auto *key = reinterpret_cast<owner_application_key_t *>(block.data +
+                                                            i * kKeyLength);
+    memset(key, 0, kKeyLength);
+    key->header.tag = kTlvTagApplicationKey;
+    key->header.length = kKeyLength;
+    key->key_alg = keys[i].alg;
+    key->data.id = keys[i].id;
+  }
+  owner_config_t config;
+  owner_application_keyring_t keyring{};
+  ASSERT_EQ(owner_block_parse(&block, &config, &keyring), kErrorOk);
+  ASSERT_EQ(keyring.length, ARRAYSIZE(keys));
+
+  for (size_t i = 0; i < ARRAYSIZE(keys); ++i) {
+    size_t index = SIZE_MAX;
+    EXPECT_EQ(owner_keyring_find_key(&keyring, keys[i].alg, keys[i].id, &index),
+              kErrorOk);
+    // Duplicate keys resolve to the first one in the keyring.
+    size_t expected = i == 5 ? 3 : i;
+    EXPECT_EQ(index, expected);
+  }
+  size_t index;
+  EXPECT_EQ(owner_keyring_find_key(&keyring, kOwnershipKeyAlgEcdsaP256, 0x15,
+                                   &index),
+            kErrorOwnershipKeyNotFound);
+  EXPECT_EQ(
+      owner_keyring_find_key(&keyring, kOwnershipKeyAlgSpx, 0x40, &index),
+      kErrorOwnershipKeyNotFound);
+  EXPECT_EQ(owner_keyring_find_key(&keyring, kOwnershipKeyAlgSpxq20, 0x10,
+                                   &index),
+            kErrorOwnershipKeyNotFound);
+}
+
 }  // namespace
@@ -97,6 +97,7 @@ static rom_error_t locked_owner_init(boot_data_t *bootdata,
              owner_page_valid[1] == kOwnerPageStatusSealed) {
     // Page 0 bad, Page 1 good: copy page 1 to page 0.
     memcpy(&owner_page[0], &owner_page[1], sizeof(owner_page[0]));
+    owner_block_parse_cache_invalidate();
     HARDENED_RETURN_IF_ERROR(flash_ctrl_info_erase(
         &kFlashCtrlInfoPageOwnerSlot0, kFlashCtrlEraseTypePage));
     HARDENED_RETURN_IF_ERROR(flash_ctrl_info_write(
@@ -108,6 +109,7 @@ static rom_error_t locked_owner_init(boot_data_t *bootdata,
              owner_page_valid[0] == kOwnerPageStatusSealed) {
     // Page 1 bad, Page 0 good: copy page 0 to page 1.
     memcpy(&owner_page[1], &owner_page[0], sizeof(owner_page[0]));
+    owner_block_parse_cache_invalidate();
     HARDENED_RETURN_IF_ERROR(flash_ctrl_info_erase(
         &kFlashCtrlInfoPageOwnerSlot1, kFlashCtrlEraseTypePage));
     HARDENED_RETURN_IF_ERROR(flash_ctrl_info_write(
@@ -250,6 +252,9 @@ rom_error_t ownership_init(boot_data_t *bootdata, owner_config_t *config,
   // function and possibly relegate it to the `default` case below, only to
   // be used should the chip enter the "no owner recovery" state.
   HARDENED_RETURN_IF_ERROR(sku_creator_owner_init(bootdata, config, keyring));
+  // The owner pages were just read from flash and possibly rewritten by
+  // `sku_creator_owner_init`, so any earlier parse results are stale.
+  owner_block_parse_cache_invalidate();
 
   rom_error_t error = kErrorOwnershipNoOwner;
   // TODO(#22386): Harden this switch/case statement.
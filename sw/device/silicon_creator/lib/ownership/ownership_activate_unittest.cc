@@ -41,6 +41,7 @@ class OwnershipActivateTest : public rom_test::RomTest {
     owner_page[1].lock_constraint = 0;
     memset(owner_page[1].device_id, 0x7e, sizeof(owner_page[1].device_id));
     memset(owner_page[1].data, 0x5a, sizeof(owner_page[1].data));
+    owner_block_parse_cache_invalidate();
   }
 
   void MakePage1Valid(bool valid) {
@@ -52,6 +52,15 @@ enum {
    * Size of an attestation signature in 32b words.
    */
   kAttestationSignatureWords = kAttestationSignatureBytes / sizeof(uint32_t),
+  /**
+   * Number of points in a precomputed public key table.
+   */
+  kEcdsaP256PublicKeyTablePoints = 7,
+  /**
+   * Size of a precomputed public key table in 32b words.
+   */
+  kEcdsaP256PublicKeyTableWords =
+      kEcdsaP256PublicKeyTablePoints * 2 * kEcdsaP256PublicKeyCoordWords,
 };
 
 /**
@@ -68,6 +77,22 @@ typedef struct ecdsa_p256_public_key {
   uint32_t y[kEcdsaP256PublicKeyCoordWords];
 } ecdsa_p256_public_key_t;
 
+/**
+ * Precomputed multiples of an ECDSA-P256 public key Q.
+ *
+ * Entry i - 1, for 0 < i < 8, holds the affine x- and y-coordinates of
+ * i_0*Q + i_1*2^107*Q + i_2*2^214*Q, where i = i_0 + 2*i_1 + 4*i_2. The first
+ * entry is Q itself. Tables are generated with `ecdsa_p256_table_gen.py` and
+ * let OTBN verify signatures with a comb instead of a double-and-add loop (see
+ * `otbn_boot_sigverify_table_start()`).
+ *
+ * A table must come from storage that is as trustworthy as the key itself:
+ * OTBN only checks that the first entry matches the key.
+ */
+typedef struct ecdsa_p256_public_key_table {
+  uint32_t points[kEcdsaP256PublicKeyTableWords];
+} ecdsa_p256_public_key_table_t;
+
 /**
  * Holds an attestation signature (ECDSA-P256).
  */
@@ -0,0 +1,152 @@
+#!/usr/bin/env python3
+# Copyright lowRISC contributors (OpenTitan project).
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+'''
+Generate the precomputed table of an ECDSA-P256 public key.
+
+The table lets the OTBN boot services verify signatures for a fixed key with
+the same 3-tooth comb (spacing 107) that `p256_base.s` uses for the base
+point: entry i, for 0 < i < 8, is the affine point
+
+  i_0*Q + i_1*2^107*Q + i_2*2^214*Q, where i = i_0 + 2*i_1 + 4*i_2.
+
+The output is a C header defining an `ecdsa_p256_public_key_table_t`
+initializer, with each coordinate in little-endian 32-bit words, as the key
+headers in `sw/device/silicon_creator/rom/keys` do.
+
+The key is read from a DER-encoded SubjectPublicKeyInfo file (e.g. the
+`*.pub.der` files next to the key headers) or given as hex coordinates.
+'''
+
+import argparse
+import sys
+
+P = 2**256 - 2**224 + 2**192 + 2**96 - 1
+A = P - 3
+B = 0x5ac635d8aa3a93e7b3ebbd55769886bc651d06b0cc53b0f63bce3c3e27d2604b
+G = (0x6b17d1f2e12c4247f8bce6e563a440f277037d812deb33a0f4a13945d898c296,
+     0x4fe342e2fe1a7f9b8ee7eb4a7c0f9e162bce33576b315ececbb6406837bf51f5)
+
+# Comb spacing, must match `p256_verify_table` in `p256_verify.s`.
+SPACING = 107
+NUM_ENTRIES = 7
+
+
+def on_curve(pt):
+    x, y = pt
+    return (y * y - (x * x * x + A * x + B)) % P == 0
+
+
+def add(p1, p2):
+    '''Adds two affine points; None is the point at infinity.'''
+    if p1 is None:
+        return p2
+    if p2 is None:
+        return p1
+    (x1, y1), (x2, y2) = p1, p2
+    if x1 == x2:
+        if (y1 + y2) % P == 0:
+            return None
+        lam = (3 * x1 * x1 + A) * pow(2 * y1, -1, P) % P
+    else:
+        lam = (y2 - y1) * pow(x2 - x1, -1, P) % P
+    x3 = (lam * lam - x1 - x2) % P
+    return (x3, (lam * (x1 - x3) - y1) % P)
+
+
+def double_n(pt, n):
+    for _ in range(n):
+        pt = add(pt, pt)
+    return pt
+
+
+def comb_table(q):
+    '''Returns the 7 comb table entries for the point q.'''
+    teeth = [q, double_n(q, SPACING), double_n(q, 2 * SPACING)]
+    table = []
+    for i in range(1, NUM_ENTRIES + 1):
+        pt = None
+        for bit, tooth in enumerate(teeth):
+            if (i >> bit) & 1:
+                pt = add(pt, tooth)
+        table.append(pt)
+    return table
+
+
+def read_der_public_key(path):
+    '''Extracts the point from a P-256 SubjectPublicKeyInfo.
+
+    The uncompressed point (0x04 || x || y) is the last 65 bytes of the
+    encoding.
+    '''
+    with open(path, 'rb') as f:
+        der = f.read()
+    point = der[-65:]
+    if len(point) != 65 or point[0] != 0x04:
+        raise ValueError(f'{path}: not an uncompressed P-256 point')
+    return (int.from_bytes(point[1:33], 'big'),
+            int.from_bytes(point[33:], 'big'))
+
+
+def to_words(v):
+    return [(v >> (32 * i)) & 0xffffffff for i in range(8)]
+
+
+def format_header(name, guard, table):
+    lines = [
+        '// Copyright lowRISC contributors (OpenTitan project).',
+        '// Licensed under the Apache License, Version 2.0, see LICENSE for '
+        'details.',
+        '// SPDX-License-Identifier: Apache-2.0',
+        '',
+        '// Generated by ecdsa_p256_table_gen.py. Do not edit.',
+        '',
+        f'#ifndef {guard}',
+        f'#define {guard}',
+        '',
+        f'#define {name} \\',
+        '  { \\',
+        '    .points = { \\',
+    ]
+    for x, y in table:
+        for coord in (x, y):
+            words = to_words(coord)
+            for i in range(0, len(words), 4):
+                row = ', '.join(f'0x{w:08x}' for w in words[i:i + 4])
+                lines.append(f'      {row}, \\')
+    lines += ['    }, \\', '  }', '', f'#endif  // {guard}', '']
+    return '\n'.join(lines)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip())
+    src = parser.add_mutually_exclusive_group(required=True)
+    src.add_argument('--der', help='DER-encoded public key')
+    src.add_argument('--xy', nargs=2, metavar=('X', 'Y'),
+                     help='affine coordinates in hex')
+    src.add_argument('--base-point', action='store_true',
+                     help='use the base point G (to check p256_comb_table)')
+    parser.add_argument('--name', required=True,
+                        help='name of the initializer macro')
+    parser.add_argument('-o', '--output', type=argparse.FileType('w'),
+                        default=sys.stdout, help='output header')
+    args = parser.parse_args()
+
+    if args.der:
+        q = read_der_public_key(args.der)
+    elif args.xy:
+        q = (int(args.xy[0], 16), int(args.xy[1], 16))
+    else:
+        q = G
+    if not on_curve(q):
+        print('Public key is not on the P-256 curve.', file=sys.stderr)
+        return 1
+
+    guard = 'OPENTITAN_' + args.name.upper() + '_H_'
+    args.output.write(format_header(args.name, guard, comb_table(q)))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -122,9 +122,26 @@ rom_error_t sigverify_ecdsa_p256_verify(const ecdsa_p256_signature_t *signature,
                                         const ecdsa_p256_public_key_t *key,
                                         const hmac_digest_t *act_digest,
                                         uint32_t *flash_exec) {
-  ecdsa_p256_signature_t recovered_r;
   rom_error_t error =
-      otbn_boot_sigverify(key, signature, act_digest, (uint32_t *)&recovered_r);
+      sigverify_ecdsa_p256_verify_start(signature, key, act_digest);
+  if (launder32(error) != kErrorOk) {
+    *flash_exec ^= UINT32_MAX;
+    return error;
+  }
+  HARDENED_CHECK_EQ(error, kErrorOk);
+  return sigverify_ecdsa_p256_verify_finalize(signature, flash_exec);
+}
+
+rom_error_t sigverify_ecdsa_p256_verify_start(
+    const ecdsa_p256_signature_t *signature, const ecdsa_p256_public_key_t *key,
+    const hmac_digest_t *act_digest) {
+  return otbn_boot_sigverify_start(key, signature, act_digest);
+}
+
+rom_error_t sigverify_ecdsa_p256_verify_finalize(
+    const ecdsa_p256_signature_t *signature, uint32_t *flash_exec) {
+  ecdsa_p256_signature_t recovered_r;
+  rom_error_t error = otbn_boot_sigverify_finalize((uint32_t *)&recovered_r);
   if (launder32(error) != kErrorOk) {
     *flash_exec ^= UINT32_MAX;
     return error;
@@ -71,6 +71,23 @@ static uint32_t shift_left(sigverify_rsa_buffer_t *a) {
   return msb;
 }
 
+/**
+ * One digit of the inner loop of `mont_mul()`.
+ *
+ * Accumulates x_i*y_j and u_i*n_j into `acc0` and `acc1` and writes the low
+ * word of `acc1` to `result[j - 1]`.
+ */
+static OT_ALWAYS_INLINE void mont_mul_step(uint32_t x_i, uint32_t u_i,
+                                           const sigverify_rsa_key_t *key,
+                                           const sigverify_rsa_buffer_t *y,
+                                           sigverify_rsa_buffer_t *result,
+                                           size_t j, uint64_t *acc0,
+                                           uint64_t *acc1) {
+  *acc0 = (uint64_t)x_i * y->data[j] + result->data[j] + (*acc0 >> 32);
+  *acc1 = (uint64_t)u_i * key->n.data[j] + (uint32_t)*acc0 + (*acc1 >> 32);
+  result->data[j - 1] = (uint32_t)*acc1;
+}
+
 /**
  * Computes the Montgomery reduction of the product of two integers.
  *
@@ -109,11 +126,20 @@ static void mont_mul(const sigverify_rsa_key_t *key,
     // Holds the sum of the all three addends in step 2.2.
     uint64_t acc1 = (uint64_t)u_i * key->n.data[0] + (uint32_t)acc0;
 
-    // Process the i^th digit of `x`, i.e. `x[i]`.
-    for (size_t j = 1; j < ARRAYSIZE(result->data); ++j) {
-      acc0 = (uint64_t)x->data[i] * y->data[j] + result->data[j] + (acc0 >> 32);
-      acc1 = (uint64_t)u_i * key->n.data[j] + (uint32_t)acc0 + (acc1 >> 32);
-      result->data[j - 1] = (uint32_t)acc1;
+    // Process the i^th digit of `x`, i.e. `x[i]`. The loop is unrolled by
+    // four; digits 1 to 3 are handled first so that the number of remaining
+    // digits is a multiple of four.
+    static_assert((kSigVerifyRsaNumWords - 4) % 4 == 0,
+                  "Unexpected RSA word count.");
+    const uint32_t x_i = x->data[i];
+    mont_mul_step(x_i, u_i, key, y, result, 1, &acc0, &acc1);
+    mont_mul_step(x_i, u_i, key, y, result, 2, &acc0, &acc1);
+    mont_mul_step(x_i, u_i, key, y, result, 3, &acc0, &acc1);
+    for (size_t j = 4; j < ARRAYSIZE(result->data); j += 4) {
+      mont_mul_step(x_i, u_i, key, y, result, j, &acc0, &acc1);
+      mont_mul_step(x_i, u_i, key, y, result, j + 1, &acc0, &acc1);
+      mont_mul_step(x_i, u_i, key, y, result, j + 2, &acc0, &acc1);
+      mont_mul_step(x_i, u_i, key, y, result, j + 3, &acc0, &acc1);
     }
     acc0 = (acc0 >> 32) + (acc1 >> 32);
     result->data[ARRAYSIZE(result->data) - 1] = (uint32_t)acc0;
@@ -170,6 +196,13 @@ static void calc_r_square(const sigverify_rsa_key_t *key,
 rom_error_t sigverify_mod_exp_ibex(const sigverify_rsa_key_t *key,
                                    const sigverify_rsa_buffer_t *sig,
                                    sigverify_rsa_buffer_t *result) {
+  return sigverify_mod_exp_ibex_rr(key, NULL, sig, result);
+}
+
+rom_error_t sigverify_mod_exp_ibex_rr(const sigverify_rsa_key_t *key,
+                                      const sigverify_rsa_buffer_t *rr,
+                                      const sigverify_rsa_buffer_t *sig,
+                                      sigverify_rsa_buffer_t *result) {
   // Reject the signature if it is too large (n <= sig): RFC 8017, section
   // 5.2.2, step 1.
   if (greater_equal_modulus(key, sig)) {
@@ -178,10 +211,14 @@ rom_error_t sigverify_mod_exp_ibex(const sigverify_rsa_key_t *key,
 
   sigverify_rsa_buffer_t buf;
 
-  // result = R^2 mod n
-  calc_r_square(key, result);
   // buf = sig * R mod n
-  mont_mul(key, sig, result, &buf);
+  if (rr == NULL) {
+    // result = R^2 mod n
+    calc_r_square(key, result);
+    mont_mul(key, sig, result, &buf);
+  } else {
+    mont_mul(key, sig, rr, &buf);
+  }
   for (size_t i = 0; i < 8; ++i) {
     // result = sig^{2*4^i} * R mod n (sig's exponent: 2, 8, 32, ..., 32768)
     mont_mul(key, &buf, &buf, result);
@@ -35,6 +35,27 @@ rom_error_t sigverify_mod_exp_ibex(const sigverify_rsa_key_t *key,
                                    const sigverify_rsa_buffer_t *sig,
                                    sigverify_rsa_buffer_t *result);
 
+/**
+ * Computes the modular exponentiation of an RSA signature on Ibex with a
+ * precomputed Montgomery constant.
+ *
+ * Same as `sigverify_mod_exp_ibex()`, but uses `rr` instead of computing
+ * R^2 mod n, where R = 2^`kSigVerifyRsaNumBits`, for keys that are known at
+ * build time. The other Montgomery constant, -n^-1 mod 2^32, is already part
+ * of `key`.
+ *
+ * @param key An RSA public key.
+ * @param rr Buffer that holds R^2 mod n, little-endian, or NULL to compute it.
+ * @param sig Buffer that holds the signature, little-endian.
+ * @param result Buffer to write the result to, little-endian.
+ * @return The result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+rom_error_t sigverify_mod_exp_ibex_rr(const sigverify_rsa_key_t *key,
+                                      const sigverify_rsa_buffer_t *rr,
+                                      const sigverify_rsa_buffer_t *sig,
+                                      sigverify_rsa_buffer_t *result);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -139,6 +139,47 @@ TEST_P(ModExp, EncMsg) {
   EXPECT_THAT(res.data, ::testing::ElementsAreArray(GetParam().enc_msg->data));
 }
 
+/**
+ * Computes R^2 mod n by doubling 1 modulo n 2*`kSigVerifyRsaNumBits` times.
+ */
+sigverify_rsa_buffer_t RSquare(const sigverify_rsa_key_t &key) {
+  sigverify_rsa_buffer_t rr = {{1}};
+  for (size_t iter = 0; iter < 2 * kSigVerifyRsaNumBits; ++iter) {
+    bool ge = rr.data[kSigVerifyRsaNumWords - 1] >> 31;
+    for (size_t i = kSigVerifyRsaNumWords - 1; i > 0; --i) {
+      rr.data[i] = (rr.data[i] << 1) | (rr.data[i - 1] >> 31);
+    }
+    rr.data[0] <<= 1;
+    if (!ge) {
+      ge = true;
+      for (size_t i = kSigVerifyRsaNumWords; i-- > 0;) {
+        if (rr.data[i] != key.n.data[i]) {
+          ge = rr.data[i] > key.n.data[i];
+          break;
+        }
+      }
+    }
+    if (ge) {
+      uint32_t borrow = 0;
+      for (size_t i = 0; i < kSigVerifyRsaNumWords; ++i) {
+        uint32_t temp = rr.data[i] - borrow;
+        borrow = (rr.data[i] < borrow) + (temp < key.n.data[i]);
+        rr.data[i] = temp - key.n.data[i];
+      }
+    }
+  }
+  return rr;
+}
+
+TEST_P(ModExp, EncMsgPrecomputedRr) {
+  sigverify_rsa_buffer_t rr = RSquare(GetParam().key);
+  sigverify_rsa_buffer_t res;
+  EXPECT_EQ(sigverify_mod_exp_ibex_rr(&GetParam().key, &rr, &GetParam().sig,
+                                      &res),
+            kErrorOk);
+  EXPECT_THAT(res.data, ::testing::ElementsAreArray(GetParam().enc_msg->data));
+}
+
 INSTANTIATE_TEST_SUITE_P(AllCases, ModExp, testing::ValuesIn(kSigTestCases));
 
 }  // namespace
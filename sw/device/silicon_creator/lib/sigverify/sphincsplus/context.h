@@ -32,6 +32,13 @@ typedef struct spx_ctx {
    * SHA256 state that absorbed pub_seed and padding.
    */
   hmac_context_t state_seeded;
+  /**
+   * HMAC configuration register value, as set up by `spx_hash_initialize()`.
+   *
+   * Cached so that the many tweakable hashes of a verification do not each
+   * read it back from the hardware.
+   */
+  uint32_t hmac_cfg;
 } spx_ctx_t;
 
 #ifdef __cplusplus
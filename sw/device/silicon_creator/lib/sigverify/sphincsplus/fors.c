@@ -49,6 +49,13 @@ static void message_to_indices(const uint8_t *m, uint32_t *indices) {
 void fors_pk_from_sig(const uint32_t *sig, const uint8_t *m,
                       const spx_ctx_t *ctx, const spx_addr_t *fors_addr,
                       uint32_t *pk) {
+  spx_sig_stream_t stream = {.sig = sig, .window = NULL};
+  fors_pk_from_sig_stream(&stream, m, ctx, fors_addr, pk);
+}
+
+void fors_pk_from_sig_stream(spx_sig_stream_t *sig, const uint8_t *m,
+                             const spx_ctx_t *ctx, const spx_addr_t *fors_addr,
+                             uint32_t *pk) {
   // Initialize the FORS tree address.
   spx_addr_t fors_tree_addr = {.addr = {0}};
   spx_addr_keypair_copy(&fors_tree_addr, fors_addr);
@@ -69,16 +76,18 @@ void fors_pk_from_sig(const uint32_t *sig, const uint8_t *m,
     spx_addr_tree_height_set(&fors_tree_addr, 0);
     spx_addr_tree_index_set(&fors_tree_addr, indices[i] + idx_offset);
 
+    // Read the secret key part and the authentication path of this tree.
+    const uint32_t *tree_sig =
+        spx_utils_sig_next(sig, kSpxNWords * (kSpxForsHeight + 1));
+
     // Derive the leaf from the included secret key part.
     uint32_t leaf[kSpxNWords];
-    fors_sk_to_leaf(sig, ctx, &fors_tree_addr, leaf);
-    sig += kSpxNWords;
+    fors_sk_to_leaf(tree_sig, ctx, &fors_tree_addr, leaf);
 
     // Derive the corresponding root node of this tree.
     uint32_t *root = &roots[i * kSpxNWords];
-    spx_utils_compute_root(leaf, indices[i], idx_offset, sig, kSpxForsHeight,
-                           ctx, &fors_tree_addr, root);
-    sig += kSpxNWords * kSpxForsHeight;
+    spx_utils_compute_root(leaf, indices[i], idx_offset, tree_sig + kSpxNWords,
+                           kSpxForsHeight, ctx, &fors_tree_addr, root);
   }
 
   // Hash horizontally across all tree roots to derive the public key.
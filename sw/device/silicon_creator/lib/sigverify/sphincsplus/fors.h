@@ -12,6 +12,7 @@
 #include "sw/device/silicon_creator/lib/error.h"
 #include "sw/device/silicon_creator/lib/sigverify/sphincsplus/address.h"
 #include "sw/device/silicon_creator/lib/sigverify/sphincsplus/context.h"
+#include "sw/device/silicon_creator/lib/sigverify/sphincsplus/utils.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -35,6 +36,22 @@ void fors_pk_from_sig(const uint32_t *sig, const uint8_t *m,
                       const spx_ctx_t *ctx, const spx_addr_t *fors_addr,
                       uint32_t *pk);
 
+/**
+ * Derives the FORS public key from a signature stream.
+ *
+ * Like `fors_pk_from_sig()`, but reads the signature one FORS tree (secret
+ * key and authentication path) at a time from `sig`.
+ *
+ * @param sig FORS signature stream; advanced past the FORS signature.
+ * @param m Message corresponding to the signature.
+ * @param ctx Context object.
+ * @param fors_addr A FORS tree address.
+ * @param[out] pk Resulting public key.
+ */
+void fors_pk_from_sig_stream(spx_sig_stream_t *sig, const uint8_t *m,
+                             const spx_ctx_t *ctx, const spx_addr_t *fors_addr,
+                             uint32_t *pk);
+
 #ifdef __cplusplus
 }
 #endif
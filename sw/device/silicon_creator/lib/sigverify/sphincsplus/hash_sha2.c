@@ -59,6 +59,7 @@ inline rom_error_t spx_hash_initialize(spx_ctx_t *ctx) {
   memset(padding, 0, sizeof(padding));
   hmac_sha256_update_words(padding, ARRAYSIZE(padding));
   hmac_sha256_save(&ctx->state_seeded);
+  ctx->hmac_cfg = hmac_sha256_cfg_get();
   return kErrorOk;
 }
 
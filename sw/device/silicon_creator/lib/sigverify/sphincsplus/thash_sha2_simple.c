@@ -13,9 +13,9 @@
 
 void thash(const uint32_t *in, size_t inblocks, const spx_ctx_t *ctx,
            const spx_addr_t *addr, uint32_t *out) {
-  hmac_sha256_restore(&ctx->state_seeded);
+  hmac_sha256_restore_cfg(&ctx->state_seeded, ctx->hmac_cfg);
   hmac_sha256_update((unsigned char *)addr->addr, kSpxSha256AddrBytes);
   hmac_sha256_update_words(in, inblocks * kSpxNWords);
   hmac_sha256_process();
-  hmac_sha256_final_truncated(out, kSpxNWords);
+  hmac_sha256_final_truncated_cfg(out, kSpxNWords, ctx->hmac_cfg);
 }
@@ -7,6 +7,7 @@
 
 #include "sw/device/silicon_creator/lib/sigverify/sphincsplus/utils.h"
 
+#include "sw/device/lib/base/hardened.h"
 #include "sw/device/lib/base/memory.h"
 #include "sw/device/silicon_creator/lib/drivers/hmac.h"
 #include "sw/device/silicon_creator/lib/error.h"
@@ -14,6 +15,27 @@
 #include "sw/device/silicon_creator/lib/sigverify/sphincsplus/params.h"
 #include "sw/device/silicon_creator/lib/sigverify/sphincsplus/thash.h"
 
+const uint32_t *spx_utils_sig_next(spx_sig_stream_t *stream,
+                                   size_t num_words) {
+  const uint32_t *words = stream->sig;
+  stream->sig += num_words;
+  if (stream->window == NULL) {
+    return words;
+  }
+  HARDENED_CHECK_LE(num_words, stream->window_words);
+  size_t i = 0;
+  for (; i + 4 <= num_words; i += 4) {
+    stream->window[i] = words[i];
+    stream->window[i + 1] = words[i + 1];
+    stream->window[i + 2] = words[i + 2];
+    stream->window[i + 3] = words[i + 3];
+  }
+  for (; i < num_words; ++i) {
+    stream->window[i] = words[i];
+  }
+  return stream->window;
+}
+
 uint64_t spx_utils_bytes_to_u64(const uint8_t *in, size_t inlen) {
   uint64_t retval = 0;
   for (size_t i = 0; i < inlen; i++) {
@@ -8,6 +8,7 @@
 #ifndef OPENTITAN_SW_DEVICE_SILICON_CREATOR_LIB_SIGVERIFY_SPHINCSPLUS_UTILS_H_
 #define OPENTITAN_SW_DEVICE_SILICON_CREATOR_LIB_SIGVERIFY_SPHINCSPLUS_UTILS_H_
 
+#include <stddef.h>
 #include <stdint.h>
 
 #include "sw/device/lib/base/macros.h"
@@ -19,6 +20,42 @@
 extern "C" {
 #endif
 
+/**
+ * Sequential reader for a SPHINCS+ signature.
+ *
+ * Verification consumes the signature strictly in order: R, the FORS trees,
+ * then a WOTS signature and authentication path per layer. A stream hands out
+ * each of these components in turn. Without a window, components are read in
+ * place. With a window, each component is first copied into it with a linear
+ * burst of reads, so a signature in flash is read sequentially (and through
+ * the flash read buffers) rather than interleaved with hashing.
+ */
+typedef struct spx_sig_stream {
+  /**
+   * Next unread word of the signature.
+   */
+  const uint32_t *sig;
+  /**
+   * Buffer for the current component, or NULL to read in place.
+   */
+  uint32_t *window;
+  /**
+   * Size of `window` in words.
+   */
+  size_t window_words;
+} spx_sig_stream_t;
+
+/**
+ * Returns the next `num_words` words of a signature stream.
+ *
+ * The returned pointer is valid until the next call on the same stream.
+ *
+ * @param stream Signature stream.
+ * @param num_words Number of words to read; must fit in the window, if any.
+ * @return Pointer to the words read.
+ */
+const uint32_t *spx_utils_sig_next(spx_sig_stream_t *stream, size_t num_words);
+
 /**
  * Convert from big-endian bytes to a 64-bit integer.
  *
@@ -25,11 +25,32 @@ static_assert(kSpxVerifySigWords * sizeof(uint32_t) == kSpxVerifySigBytes,
 static_assert(kSpxVerifyPkWords * sizeof(uint32_t) == kSpxVerifyPkBytes,
               "kSpxVerifyPkWords and kSpxVerifyPkBytes do not match.");
 static_assert(kSpxD <= UINT8_MAX, "kSpxD must fit into a uint8_t.");
-rom_error_t spx_verify(const uint32_t *sig, const uint8_t *msg_prefix_1,
-                       size_t msg_prefix_1_len, const uint8_t *msg_prefix_2,
-                       size_t msg_prefix_2_len, const uint8_t *msg_prefix_3,
-                       size_t msg_prefix_3_len, const uint8_t *msg,
-                       size_t msg_len, const uint32_t *pk, uint32_t *root) {
+enum {
+  /**
+   * Size of the window used by `spx_verify_streaming()`, in words.
+   *
+   * Large enough for the largest signature component: a WOTS signature, a
+   * FORS tree (secret key and authentication path) or a hypertree
+   * authentication path.
+   */
+  kSpxVerifyWindowWords = kSpxWotsWords > (kSpxForsHeight + 1) * kSpxNWords
+                              ? kSpxWotsWords
+                              : (kSpxForsHeight + 1) * kSpxNWords,
+};
+static_assert(kSpxVerifyWindowWords >= kSpxTreeHeight * kSpxNWords,
+              "Window too small for a hypertree authentication path.");
+
+/**
+ * Computes the root for a signature stream and message under a public key.
+ *
+ * Implements `spx_verify()`, reading the signature through `sig`.
+ */
+OT_WARN_UNUSED_RESULT
+static rom_error_t spx_verify_stream(
+    spx_sig_stream_t *sig, const uint8_t *msg_prefix_1, size_t msg_prefix_1_len,
+    const uint8_t *msg_prefix_2, size_t msg_prefix_2_len,
+    const uint8_t *msg_prefix_3, size_t msg_prefix_3_len, const uint8_t *msg,
+    size_t msg_len, const uint32_t *pk, uint32_t *root) {
   spx_ctx_t ctx;
   memcpy(ctx.pub_seed, pk, kSpxN);
 
@@ -50,16 +71,15 @@ rom_error_t spx_verify(const uint32_t *sig, const uint8_t *msg_prefix_1,
   uint64_t tree;
   uint32_t idx_leaf;
   HARDENED_RETURN_IF_ERROR(spx_hash_message(
-      sig, pk, msg_prefix_1, msg_prefix_1_len, msg_prefix_2, msg_prefix_2_len,
-      msg_prefix_3, msg_prefix_3_len, msg, msg_len, mhash, &tree, &idx_leaf));
-  sig += kSpxNWords;
+      spx_utils_sig_next(sig, kSpxNWords), pk, msg_prefix_1, msg_prefix_1_len,
+      msg_prefix_2, msg_prefix_2_len, msg_prefix_3, msg_prefix_3_len, msg,
+      msg_len, mhash, &tree, &idx_leaf));
 
   // Layer correctly defaults to 0, so no need to set_layer_addr.
   spx_addr_tree_set(&wots_addr, tree);
   spx_addr_keypair_set(&wots_addr, idx_leaf);
 
-  fors_pk_from_sig(sig, mhash, &ctx, &wots_addr, root);
-  sig += kSpxForsWords;
+  fors_pk_from_sig_stream(sig, mhash, &ctx, &wots_addr, root);
 
   // For each subtree..
   for (uint8_t i = 0; i < kSpxD; i++) {
@@ -75,17 +95,17 @@ rom_error_t spx_verify(const uint32_t *sig, const uint8_t *msg_prefix_1,
     // Initially, root is the FORS pk, but on subsequent iterations it is
     // the root of the subtree below the currently processed subtree.
     uint32_t wots_pk[kSpxWotsWords];
-    wots_pk_from_sig(sig, root, &ctx, &wots_addr, wots_pk);
-    sig += kSpxWotsWords;
+    wots_pk_from_sig(spx_utils_sig_next(sig, kSpxWotsWords), root, &ctx,
+                     &wots_addr, wots_pk);
 
     // Compute the leaf node using the WOTS public key.
     uint32_t leaf[kSpxNWords];
     thash(wots_pk, kSpxWotsLen, &ctx, &wots_pk_addr, leaf);
 
     // Compute the root node of this subtree.
-    spx_utils_compute_root(leaf, idx_leaf, 0, sig, kSpxTreeHeight, &ctx,
-                           &tree_addr, root);
-    sig += kSpxTreeHeight * kSpxNWords;
+    spx_utils_compute_root(leaf, idx_leaf, 0,
+                           spx_utils_sig_next(sig, kSpxTreeHeight * kSpxNWords),
+                           kSpxTreeHeight, &ctx, &tree_addr, root);
 
     // Update the indices for the next layer.
     idx_leaf = (tree & ((1 << kSpxTreeHeight) - 1));
@@ -95,6 +115,33 @@ rom_error_t spx_verify(const uint32_t *sig, const uint8_t *msg_prefix_1,
   return kErrorOk;
 }
 
+rom_error_t spx_verify(const uint32_t *sig, const uint8_t *msg_prefix_1,
+                       size_t msg_prefix_1_len, const uint8_t *msg_prefix_2,
+                       size_t msg_prefix_2_len, const uint8_t *msg_prefix_3,
+                       size_t msg_prefix_3_len, const uint8_t *msg,
+                       size_t msg_len, const uint32_t *pk, uint32_t *root) {
+  spx_sig_stream_t stream = {.sig = sig, .window = NULL};
+  return spx_verify_stream(&stream, msg_prefix_1, msg_prefix_1_len,
+                           msg_prefix_2, msg_prefix_2_len, msg_prefix_3,
+                           msg_prefix_3_len, msg, msg_len, pk, root);
+}
+
+rom_error_t spx_verify_streaming(
+    const uint32_t *sig, const uint8_t *msg_prefix_1, size_t msg_prefix_1_len,
+    const uint8_t *msg_prefix_2, size_t msg_prefix_2_len,
+    const uint8_t *msg_prefix_3, size_t msg_prefix_3_len, const uint8_t *msg,
+    size_t msg_len, const uint32_t *pk, uint32_t *root) {
+  uint32_t window[kSpxVerifyWindowWords];
+  spx_sig_stream_t stream = {
+      .sig = sig,
+      .window = window,
+      .window_words = ARRAYSIZE(window),
+  };
+  return spx_verify_stream(&stream, msg_prefix_1, msg_prefix_1_len,
+                           msg_prefix_2, msg_prefix_2_len, msg_prefix_3,
+                           msg_prefix_3_len, msg, msg_len, pk, root);
+}
+
 inline void spx_public_key_root(const uint32_t *pk, uint32_t *root) {
   memcpy(root, pk + kSpxNWords, kSpxN);
 }
@@ -69,6 +69,37 @@ rom_error_t spx_verify(const uint32_t *sig, const uint8_t *msg_prefix_1,
                        size_t msg_prefix_3_len, const uint8_t *msg,
                        size_t msg_len, const uint32_t *pk, uint32_t *root);
 
+/**
+ * Computes the root for a signature in flash and a message under a public key.
+ *
+ * Same as `spx_verify()`, but each signature component (R, a FORS tree, a
+ * WOTS signature or an authentication path) is copied into a small window in
+ * SRAM with one sequential burst of reads before it is used. This suits a
+ * signature in memory-mapped flash: reads stay linear and don't stall in the
+ * middle of hashing, and only the window (less than 600 bytes) is held in
+ * SRAM at a time.
+ *
+ * @param sig Input signature (`kSpxVerifySigBytes` bytes long).
+ * @param msg_prefix_1 Optional message prefix.
+ * @param msg_prefix_1_len Length of the first prefix.
+ * @param msg_prefix_2 Optional message prefix.
+ * @param msg_prefix_2_len Length of the second prefix.
+ * @param msg_prefix_3 Optional message prefix.
+ * @param msg_prefix_3_len Length of the third prefix.
+ * @param msg Input message.
+ * @param msg_len Legth of message (bytes).
+ * @param pk Public key (`kSpxVerifyPkBytes` bytes long).
+ * @param[out] root Buffer for computed tree root (`kSpxVerifyRootNumWords`
+ *                  words long).
+ * @return Error code indicating if the operation succeeded.
+ */
+OT_WARN_UNUSED_RESULT
+rom_error_t spx_verify_streaming(
+    const uint32_t *sig, const uint8_t *msg_prefix_1, size_t msg_prefix_1_len,
+    const uint8_t *msg_prefix_2, size_t msg_prefix_2_len,
+    const uint8_t *msg_prefix_3, size_t msg_prefix_3_len, const uint8_t *msg,
+    size_t msg_len, const uint32_t *pk, uint32_t *root);
+
 /**
  * Extract the public key root.
  *
@@ -45,13 +45,13 @@ static void gen_chain(const uint32_t *in, uint8_t start, const spx_ctx_t *ctx,
   spx_addr_hash_set(addr, start);
   for (uint8_t i = start; i + 1 < kSpxWotsW; i++) {
     // This loop body is essentially just `thash`, inlined for performance.
-    hmac_sha256_restore(&ctx->state_seeded);
+    hmac_sha256_restore_cfg(&ctx->state_seeded, ctx->hmac_cfg);
     hmac_sha256_update((unsigned char *)addr->addr, kSpxSha256AddrBytes);
     hmac_sha256_update_words(out, kSpxNWords);
     hmac_sha256_process();
     // Update the address while HMAC is processing for performance reasons.
     spx_addr_hash_set(addr, i + 1);
-    hmac_sha256_final_truncated(out, kSpxNWords);
+    hmac_sha256_final_truncated_cfg(out, kSpxNWords, ctx->hmac_cfg);
   }
 }
 
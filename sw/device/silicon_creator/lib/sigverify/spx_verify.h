@@ -53,6 +53,10 @@ uint32_t sigverify_spx_verify_enabled(lifecycle_state_t lc_state);
  * raw message is ignored and we sign the digest. If it is unset, we ignore the
  * digest and sign the raw message.
  *
+ * The signature is normally in flash (e.g. a manifest extension), so it is
+ * read one component at a time into a small SRAM window; see
+ * `spx_verify_streaming()`.
+ *
  * @param signature Signature to be verified.
  * @param key Signer's SPHINCS+ public key.
  * @param config Signer's SPHINCS+ key configuration.
@@ -2,9 +2,18 @@
 // Licensed under the Apache License, Version 2.0, see LICENSE for details.
 // SPDX-License-Identifier: Apache-2.0
 
+#include "sw/device/lib/base/memory.h"
+#include "sw/device/lib/runtime/log.h"
+#include "sw/device/lib/testing/profile.h"
 #include "sw/device/lib/testing/test_framework/check.h"
 #include "sw/device/lib/testing/test_framework/ottf_main.h"
+#include "sw/device/silicon_creator/lib/sigverify/sphincsplus/address.h"
+#include "sw/device/silicon_creator/lib/sigverify/sphincsplus/context.h"
+#include "sw/device/silicon_creator/lib/sigverify/sphincsplus/fors.h"
+#include "sw/device/silicon_creator/lib/sigverify/sphincsplus/hash.h"
+#include "sw/device/silicon_creator/lib/sigverify/sphincsplus/params.h"
 #include "sw/device/silicon_creator/lib/sigverify/sphincsplus/verify.h"
+#include "sw/device/silicon_creator/lib/sigverify/sphincsplus/wots.h"
 #include "sw/device/silicon_creator/lib/sigverify/spx_verify.h"
 
 /**
@@ -438,6 +447,73 @@ static rom_error_t spx_verify_impl_test(void) {
   return error;
 }
 
+static rom_error_t spx_verify_streaming_impl_test(void) {
+  sigverify_spx_root_t expected_root;
+  sigverify_spx_root_t actual_root;
+  spx_public_key_root(kPubKey.data, expected_root.data);
+  rom_error_t error = spx_verify_streaming(
+      kSignature.data, kSpxVerifyDomainSep, sizeof(kSpxVerifyDomainSep), NULL,
+      0, NULL, 0, (const uint8_t *)kMessage, kMessageLen, kPubKey.data,
+      actual_root.data);
+  if (memcmp(&expected_root, &actual_root, sizeof(sigverify_spx_root_t)) != 0) {
+    return kErrorUnknown;
+  }
+  return error;
+}
+
+/**
+ * Reports the cycle counts of the phases of `spx_verify()`.
+ *
+ * The FORS and WOTS+ phases are run on their own, on the corresponding parts
+ * of the test signature; the message they are run on does not affect their
+ * cost much, so arbitrary values are used.
+ */
+static rom_error_t spx_verify_phases_test(void) {
+  sigverify_spx_root_t root;
+  uint64_t t_start = profile_start();
+  RETURN_IF_ERROR(spx_verify(kSignature.data, kSpxVerifyDomainSep,
+                             sizeof(kSpxVerifyDomainSep), NULL, 0, NULL, 0,
+                             (const uint8_t *)kMessage, kMessageLen,
+                             kPubKey.data, root.data));
+  uint32_t total = profile_end(t_start);
+
+  t_start = profile_start();
+  RETURN_IF_ERROR(spx_verify_streaming(
+      kSignature.data, kSpxVerifyDomainSep, sizeof(kSpxVerifyDomainSep), NULL,
+      0, NULL, 0, (const uint8_t *)kMessage, kMessageLen, kPubKey.data,
+      root.data));
+  uint32_t streaming = profile_end(t_start);
+
+  spx_ctx_t ctx;
+  memcpy(ctx.pub_seed, kPubKey.data, kSpxN);
+  t_start = profile_start();
+  RETURN_IF_ERROR(spx_hash_initialize(&ctx));
+  uint32_t init = profile_end(t_start);
+
+  spx_addr_t addr = {.addr = {0}};
+  spx_addr_type_set(&addr, kSpxAddrTypeWots);
+  const uint32_t *sig = kSignature.data + kSpxNWords;
+  uint8_t mhash[kSpxForsMsgBytes];
+  memset(mhash, 0x5a, sizeof(mhash));
+  uint32_t fors_pk[kSpxNWords];
+  t_start = profile_start();
+  fors_pk_from_sig(sig, mhash, &ctx, &addr, fors_pk);
+  uint32_t fors = profile_end(t_start);
+  sig += kSpxForsWords;
+
+  uint32_t wots_pk[kSpxWotsWords];
+  t_start = profile_start();
+  wots_pk_from_sig(sig, fors_pk, &ctx, &addr, wots_pk);
+  uint32_t wots = profile_end(t_start);
+
+  LOG_INFO("spx_verify: %u cycles", total);
+  LOG_INFO("spx_verify_streaming: %u cycles", streaming);
+  LOG_INFO("  hash init: %u cycles", init);
+  LOG_INFO("  FORS: %u cycles", fors);
+  LOG_INFO("  WOTS+ (one of %u layers): %u cycles", kSpxD, wots);
+  return kErrorOk;
+}
+
 static rom_error_t spx_verify_disabled_bad_signature_test(void) {
   disable_spx_verify();
 
@@ -521,6 +597,8 @@ bool test_main(void) {
 
   EXECUTE_TEST(error, spx_success_to_ok_test);
   EXECUTE_TEST(error, spx_verify_impl_test);
+  EXECUTE_TEST(error, spx_verify_streaming_impl_test);
+  EXECUTE_TEST(error, spx_verify_phases_test);
   EXECUTE_TEST(error, spx_verify_disabled_bad_signature_test);
   EXECUTE_TEST(error, spx_verify_disabled_good_signature_test);
   EXECUTE_TEST(error, spx_verify_enabled_bad_signature_test);
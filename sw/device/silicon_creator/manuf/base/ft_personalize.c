@@ -479,20 +479,28 @@ static status_t personalize_gen_dice_certificates(ujson_t *uj) {
    ****************************************************************************/
   size_t curr_cert_size = 0;
 
-  // Generate UDS keys and (TBS) cert.
-  curr_cert_size = kUdsMaxTbsSizeBytes;
+  // Generate UDS keys.
   TRY(otbn_boot_cert_ecc_p256_keygen(kDiceKeyUds, &uds_pubkey_id,
-                                     &curr_pubkey));
-  memcpy(&uds_pubkey, &curr_pubkey, sizeof(ecdsa_p256_public_key_t));
+                                     &uds_pubkey));
   TRY(otbn_boot_attestation_key_save(kDiceKeyUds.keygen_seed_idx,
                                      kDiceKeyUds.type,
                                      *kDiceKeyUds.keymgr_diversifier));
 
+  // Advance the keymgr and start generating the CDI_0 keys on OTBN. The UDS
+  // (TBS) cert is built on Ibex while OTBN runs, since it only needs the UDS
+  // public key.
+  compute_keymgr_owner_int_binding(&certgen_inputs);
+  TRY(sc_keymgr_owner_int_advance(&sealing_binding_value,
+                                  &attestation_binding_value,
+                                  /*max_key_version=*/0));
+  TRY(otbn_boot_cert_ecc_p256_keygen_start(kDiceKeyCdi0));
+
   // Build the certificate in a temp buffer, use all_certs for that.
+  curr_cert_size = kUdsMaxTbsSizeBytes;
   TRY(dice_uds_tbs_cert_build(
       &otp_creator_sw_cfg_measurement, &otp_owner_sw_cfg_measurement,
       &otp_rot_creator_auth_codesign_measurement,
-      &otp_rot_creator_auth_state_measurement, &uds_key_ids, &curr_pubkey,
+      &otp_rot_creator_auth_state_measurement, &uds_key_ids, &uds_pubkey,
       all_certs, &curr_cert_size));
   // DO NOT CHANGE THE "UDS" STRING BELOW with modifying the `dice_cert_names`
   // collection in sw/host/provisioning/ft_lib/src/lib.rs.
@@ -503,18 +511,23 @@ static status_t personalize_gen_dice_certificates(ujson_t *uj) {
       kDiceCertFormat, all_certs, curr_cert_size, &perso_blob_to_host));
   LOG_INFO("Generated UDS certificate.");
 
-  // Generate CDI_0 keys and cert.
+  // Collect the CDI_0 keys and build the cert (which is endorsed with the UDS
+  // key on OTBN).
+  TRY(otbn_boot_cert_ecc_p256_keygen_finalize(&cdi_0_pubkey_id, &curr_pubkey));
   curr_cert_size = kCdi0MaxCertSizeBytes;
-  compute_keymgr_owner_int_binding(&certgen_inputs);
-  TRY(sc_keymgr_owner_int_advance(&sealing_binding_value,
-                                  &attestation_binding_value,
-                                  /*max_key_version=*/0));
-  TRY(otbn_boot_cert_ecc_p256_keygen(kDiceKeyCdi0, &cdi_0_pubkey_id,
-                                     &curr_pubkey));
   TRY(dice_cdi_0_cert_build((hmac_digest_t *)certgen_inputs.rom_ext_measurement,
                             certgen_inputs.rom_ext_security_version,
                             &cdi_0_key_ids, &curr_pubkey, all_certs,
                             &curr_cert_size));
+
+  // Advance the keymgr and start generating the CDI_1 keys, then record the
+  // CDI_0 cert while OTBN runs.
+  compute_keymgr_owner_binding(&certgen_inputs);
+  TRY(sc_keymgr_owner_advance(&sealing_binding_value,
+                              &attestation_binding_value,
+                              /*max_key_version=*/0));
+  TRY(otbn_boot_cert_ecc_p256_keygen_start(kDiceKeyCdi1));
+
   cdi_0_offset = perso_blob_to_host.next_free;
   // DO NOT CHANGE THE "CDI_0" STRING BELOW with modifying the `dice_cert_names`
   // collection in sw/host/provisioning/ft_lib/src/lib.rs.
@@ -523,14 +536,9 @@ static status_t personalize_gen_dice_certificates(ujson_t *uj) {
                                         curr_cert_size, &perso_blob_to_host));
   LOG_INFO("Generated CDI_0 certificate.");
 
-  // Generate CDI_1 keys and cert.
+  // Collect the CDI_1 keys and build the cert.
+  TRY(otbn_boot_cert_ecc_p256_keygen_finalize(&cdi_1_pubkey_id, &curr_pubkey));
   curr_cert_size = kCdi1MaxCertSizeBytes;
-  compute_keymgr_owner_binding(&certgen_inputs);
-  TRY(sc_keymgr_owner_advance(&sealing_binding_value,
-                              &attestation_binding_value,
-                              /*max_key_version=*/0));
-  TRY(otbn_boot_cert_ecc_p256_keygen(kDiceKeyCdi1, &cdi_1_pubkey_id,
-                                     &curr_pubkey));
   TRY(dice_cdi_1_cert_build(
       (hmac_digest_t *)certgen_inputs.owner_measurement,
       (hmac_digest_t *)certgen_inputs.owner_manifest_measurement,
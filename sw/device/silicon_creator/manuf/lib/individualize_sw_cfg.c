@@ -91,8 +91,8 @@ static status_t otp_img_write(const dif_otp_ctrl_t *otp,
     TRY(dif_otp_ctrl_relative_address(partition, kv[i].offset, &offset));
     switch (kv[i].type) {
       case kOptValTypeUint32Buff:
-        TRY(otp_ctrl_testutils_dai_write32(otp, partition, offset,
-                                           kv[i].value32, kv[i].num_values));
+        TRY(otp_ctrl_testutils_dai_write32_batch(
+            otp, partition, offset, kv[i].value32, kv[i].num_values));
         break;
       case kOptValTypeUint64Buff:
         TRY(otp_ctrl_testutils_dai_write64(otp, partition, offset,
@@ -207,20 +207,20 @@ static status_t manuf_individualize_device_ast_cfg(
   // Write AST configuration data to OTP.
   size_t ast_cfg_offset =
       kFlashInfoFieldAstCalibrationData.byte_offset / sizeof(uint32_t);
+  // Check the range is valid.
+  if (kFlashInfoAstCalibrationDataSizeIn32BitWords * sizeof(uint32_t) >
+      OTP_CTRL_PARAM_CREATOR_SW_CFG_AST_CFG_SIZE) {
+    return OUT_OF_RANGE();
+  }
+  uint32_t relative_addr;
+  TRY(dif_otp_ctrl_relative_address(
+      kDifOtpCtrlPartitionCreatorSwCfg,
+      OTP_CTRL_PARAM_CREATOR_SW_CFG_AST_CFG_OFFSET, &relative_addr));
+  TRY(otp_ctrl_testutils_dai_write32_batch(
+      otp_ctrl, kDifOtpCtrlPartitionCreatorSwCfg, relative_addr,
+      &flash_info_page_buf[ast_cfg_offset],
+      kFlashInfoAstCalibrationDataSizeIn32BitWords));
   for (size_t i = 0; i < kFlashInfoAstCalibrationDataSizeIn32BitWords; ++i) {
-    uint32_t addr =
-        OTP_CTRL_PARAM_CREATOR_SW_CFG_AST_CFG_OFFSET + i * sizeof(uint32_t);
-    uint32_t data = flash_info_page_buf[ast_cfg_offset + i];
-    uint32_t relative_addr;
-    // Check the range is valid.
-    if (addr < kValidAstCfgOtpAddrLow || addr >= kInvalidAstCfgOtpAddrHigh) {
-      return OUT_OF_RANGE();
-    }
-    TRY(dif_otp_ctrl_relative_address(kDifOtpCtrlPartitionCreatorSwCfg, addr,
-                                      &relative_addr));
-    TRY(otp_ctrl_testutils_dai_write32(otp_ctrl,
-                                       kDifOtpCtrlPartitionCreatorSwCfg,
-                                       relative_addr, &data, /*len=*/1));
     flash_info_page_buf[ast_cfg_offset + i] =
         UINT32_MAX;  // Erase AST config data after use.
   }
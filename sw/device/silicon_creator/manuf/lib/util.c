@@ -77,8 +77,8 @@ status_t manuf_util_hash_otp_partition(const dif_otp_ctrl_t *otp_ctrl,
           vendor_test_32bit_array[(OTP_CTRL_PARAM_VENDOR_TEST_SIZE -
                                    OTP_CTRL_PARAM_VENDOR_TEST_DIGEST_SIZE) /
                                   sizeof(uint32_t)];
-      TRY(otp_ctrl_testutils_dai_read32_array(
-          otp_ctrl, kDifOtpCtrlPartitionVendorTest, 0, vendor_test_32bit_array,
+      TRY(otp_ctrl_testutils_read_partition(
+          otp_ctrl, kDifOtpCtrlPartitionVendorTest, vendor_test_32bit_array,
           (OTP_CTRL_PARAM_VENDOR_TEST_SIZE -
            OTP_CTRL_PARAM_VENDOR_TEST_DIGEST_SIZE) /
               sizeof(uint32_t)));
@@ -114,8 +114,8 @@ status_t manuf_util_hash_otp_partition(const dif_otp_ctrl_t *otp_ctrl,
           [(OTP_CTRL_PARAM_ROT_CREATOR_AUTH_CODESIGN_SIZE -
             OTP_CTRL_PARAM_ROT_CREATOR_AUTH_CODESIGN_DIGEST_SIZE) /
            sizeof(uint32_t)];
-      TRY(otp_ctrl_testutils_dai_read32_array(
-          otp_ctrl, kDifOtpCtrlPartitionRotCreatorAuthCodesign, 0,
+      TRY(otp_ctrl_testutils_read_partition(
+          otp_ctrl, kDifOtpCtrlPartitionRotCreatorAuthCodesign,
           rot_creator_auth_codesign_32bit_array,
           (OTP_CTRL_PARAM_ROT_CREATOR_AUTH_CODESIGN_SIZE -
            OTP_CTRL_PARAM_ROT_CREATOR_AUTH_CODESIGN_DIGEST_SIZE) /
@@ -132,8 +132,8 @@ status_t manuf_util_hash_otp_partition(const dif_otp_ctrl_t *otp_ctrl,
           [(OTP_CTRL_PARAM_ROT_CREATOR_AUTH_STATE_SIZE -
             OTP_CTRL_PARAM_ROT_CREATOR_AUTH_STATE_DIGEST_SIZE) /
            sizeof(uint32_t)];
-      TRY(otp_ctrl_testutils_dai_read32_array(
-          otp_ctrl, kDifOtpCtrlPartitionRotCreatorAuthState, 0,
+      TRY(otp_ctrl_testutils_read_partition(
+          otp_ctrl, kDifOtpCtrlPartitionRotCreatorAuthState,
           rot_creator_auth_state_32bit_array,
           (OTP_CTRL_PARAM_ROT_CREATOR_AUTH_STATE_SIZE -
            OTP_CTRL_PARAM_ROT_CREATOR_AUTH_STATE_DIGEST_SIZE) /
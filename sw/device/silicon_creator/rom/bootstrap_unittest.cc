@@ -102,6 +102,7 @@ TEST_F(BootstrapTest, BootstrapSimple) {
   auto cmd = PageProgramCmd(0, 16);
   ExpectSpiCmd(cmd);
   ExpectSpiFlashStatusGet(true);
+  EXPECT_CALL(spi_device_, FlashStatusClear());
 
   std::vector<uint8_t> flash_bytes(cmd.payload,
                                    cmd.payload + cmd.payload_byte_count);
@@ -111,7 +112,6 @@ TEST_F(BootstrapTest, BootstrapSimple) {
       .WillOnce(Return(kErrorOk));
   ExpectFlashCtrlAllDisable();
 
-  EXPECT_CALL(spi_device_, FlashStatusClear());
   // Reset
   ExpectSpiCmd(ResetCmd());
   EXPECT_CALL(rstmgr_, Reset());
@@ -133,6 +133,7 @@ TEST_F(BootstrapTest, BootstrapOddPayload) {
   auto cmd = PageProgramCmd(0, 17);
   ExpectSpiCmd(cmd);
   ExpectSpiFlashStatusGet(true);
+  EXPECT_CALL(spi_device_, FlashStatusClear());
 
   std::vector<uint8_t> flash_bytes(cmd.payload,
                                    cmd.payload + cmd.payload_byte_count);
@@ -145,7 +146,6 @@ TEST_F(BootstrapTest, BootstrapOddPayload) {
       .WillOnce(Return(kErrorOk));
   ExpectFlashCtrlAllDisable();
 
-  EXPECT_CALL(spi_device_, FlashStatusClear());
   // Reset
   ExpectSpiCmd(ResetCmd());
   EXPECT_CALL(rstmgr_, Reset());
@@ -167,6 +167,7 @@ TEST_F(BootstrapTest, BootstrapMisalignedAddrLongPayload) {
   auto cmd = PageProgramCmd(0xfff0, 256);
   ExpectSpiCmd(cmd);
   ExpectSpiFlashStatusGet(true);
+  EXPECT_CALL(spi_device_, FlashStatusClear());
 
   std::vector<uint8_t> flash_bytes_0(cmd.payload, cmd.payload + 16);
   std::vector<uint8_t> flash_bytes_1(cmd.payload + 16,
@@ -179,7 +180,6 @@ TEST_F(BootstrapTest, BootstrapMisalignedAddrLongPayload) {
       .WillOnce(Return(kErrorOk));
   ExpectFlashCtrlAllDisable();
 
-  EXPECT_CALL(spi_device_, FlashStatusClear());
   // Reset
   ExpectSpiCmd(ResetCmd());
   EXPECT_CALL(rstmgr_, Reset());
@@ -201,6 +201,7 @@ TEST_F(BootstrapTest, BootstrapMisalignedAddrShortPayload) {
   auto cmd = PageProgramCmd(816, 8);
   ExpectSpiCmd(cmd);
   ExpectSpiFlashStatusGet(true);
+  EXPECT_CALL(spi_device_, FlashStatusClear());
 
   std::vector<uint8_t> flash_bytes(cmd.payload,
                                    cmd.payload + cmd.payload_byte_count);
@@ -210,7 +211,6 @@ TEST_F(BootstrapTest, BootstrapMisalignedAddrShortPayload) {
       .WillOnce(Return(kErrorOk));
   ExpectFlashCtrlAllDisable();
 
-  EXPECT_CALL(spi_device_, FlashStatusClear());
   // Reset
   ExpectSpiCmd(ResetCmd());
   EXPECT_CALL(rstmgr_, Reset());
@@ -232,6 +232,7 @@ TEST_F(BootstrapTest, BootstrapStartWithSectorErase) {
   auto cmd = PageProgramCmd(0, 16);
   ExpectSpiCmd(cmd);
   ExpectSpiFlashStatusGet(true);
+  EXPECT_CALL(spi_device_, FlashStatusClear());
 
   std::vector<uint8_t> flash_bytes(cmd.payload,
                                    cmd.payload + cmd.payload_byte_count);
@@ -243,7 +244,6 @@ TEST_F(BootstrapTest, BootstrapStartWithSectorErase) {
       .WillOnce(Return(kErrorOk));
   ExpectFlashCtrlAllDisable();
 
-  EXPECT_CALL(spi_device_, FlashStatusClear());
   // Reset
   ExpectSpiCmd(ResetCmd());
   EXPECT_CALL(rstmgr_, Reset());
@@ -265,6 +265,7 @@ TEST_F(BootstrapTest, BootstrapProgramWithErase) {
   auto cmd = PageProgramCmd(0, 16);
   ExpectSpiCmd(cmd);
   ExpectSpiFlashStatusGet(true);
+  EXPECT_CALL(spi_device_, FlashStatusClear());
 
   std::vector<uint8_t> flash_bytes(cmd.payload,
                                    cmd.payload + cmd.payload_byte_count);
@@ -276,7 +277,6 @@ TEST_F(BootstrapTest, BootstrapProgramWithErase) {
       .WillOnce(Return(kErrorOk));
   ExpectFlashCtrlAllDisable();
 
-  EXPECT_CALL(spi_device_, FlashStatusClear());
   // Chip erase
   ExpectSpiCmd(ChipEraseCmd());
   ExpectSpiFlashStatusGet(true);
@@ -416,6 +416,7 @@ TEST_F(BootstrapTest, DataWriteError) {
   auto cmd = PageProgramCmd(0, 16);
   ExpectSpiCmd(cmd);
   ExpectSpiFlashStatusGet(true);
+  EXPECT_CALL(spi_device_, FlashStatusClear());
 
   std::vector<uint8_t> flash_bytes(cmd.payload,
                                    cmd.payload + cmd.payload_byte_count);
@@ -444,6 +445,7 @@ TEST_F(BootstrapTest, DataWriteErrorMisalignedAddr) {
   auto cmd = PageProgramCmd(0xf0, 16);
   ExpectSpiCmd(cmd);
   ExpectSpiFlashStatusGet(true);
+  EXPECT_CALL(spi_device_, FlashStatusClear());
 
   std::vector<uint8_t> flash_bytes(cmd.payload,
                                    cmd.payload + cmd.payload_byte_count);
@@ -100,6 +100,13 @@ uint32_t flash_ecc_exc_handler_en;
 // A check value for the reset reason.
 uint32_t reset_reason_check;
 
+/**
+ * Records a boot timing event in the retention SRAM.
+ */
+static void rom_timing_record(boot_timing_event_t event) {
+  boot_timing_record(&retention_sram_get()->creator.boot_timing, event);
+}
+
 static inline bool rom_console_enabled(void) {
   return otp_read32(OTP_CTRL_PARAM_OWNER_SW_CFG_ROM_BANNER_EN_OFFSET) !=
          kHardenedBoolFalse;
@@ -248,6 +255,11 @@ static rom_error_t rom_init(void) {
   boot_log->chip_version = kChipInfo.scm_revision;
   boot_log->retention_ram_initialized =
       reset_reasons & reset_mask ? kHardenedBoolTrue : kHardenedBoolFalse;
+  boot_timing_init(&retention_sram_get()->creator.boot_timing);
+  rom_timing_record(kBootTimingEventRomInit);
+
+  // Locate the boot data entries using the hint kept in the retention RAM.
+  boot_data_hint_init(&retention_sram_get()->creator.boot_data_hint);
 
   // Always store the retention RAM version so the ROM_EXT can depend on its
   // accuracy even after scrambling.
@@ -331,8 +343,6 @@ static rom_error_t rom_verify(const manifest_t *manifest,
   HARDENED_RETURN_IF_ERROR(otbn_boot_app_load());
   CFI_FUNC_COUNTER_INCREMENT(rom_counters, kCfiRomVerify, 1);
 
-  // Load secure boot keys from OTP into RAM.
-  HARDENED_RETURN_IF_ERROR(sigverify_otp_keys_init(&sigverify_ctx));
   // ECDSA key.
   const ecdsa_p256_public_key_t *ecdsa_key = NULL;
   HARDENED_RETURN_IF_ERROR(sigverify_ecdsa_p256_key_get(
@@ -363,6 +373,7 @@ static rom_error_t rom_verify(const manifest_t *manifest,
   memset(boot_measurements.rom_ext.data, (int)rnd_uint32(),
          sizeof(boot_measurements.rom_ext.data));
   // Add anti-rollback poisoning word to measurement.
+  uint32_t measure_start = ibex_mcycle32();
   hmac_sha256_init();
   hmac_sha256_update(anti_rollback, anti_rollback_len);
   HARDENED_CHECK_GE(manifest->security_version,
@@ -380,6 +391,9 @@ static rom_error_t rom_verify(const manifest_t *manifest,
   hmac_sha256_process();
   hmac_digest_t act_digest;
   hmac_sha256_final(&act_digest);
+  retention_sram_get()->creator.boot_log.rom_ext_measure_cycles =
+      ibex_mcycle32() - measure_start;
+  rom_timing_record(kBootTimingEventRomExtMeasure);
   // Copy the ROM_EXT measurement to the .static_critical section.
   static_assert(sizeof(boot_measurements.rom_ext) == sizeof(act_digest),
                 "Unexpected ROM_EXT digest size.");
@@ -391,28 +405,30 @@ static rom_error_t rom_verify(const manifest_t *manifest,
   /**
    * Verify the ECDSA/SPX+ signatures of ROM_EXT.
    *
-   * We swap the order of signature verifications randomly.
+   * ECDSA runs on OTBN while SPX+ runs on Ibex and HMAC, so we start the ECDSA
+   * verification, verify the SPX+ signature while OTBN is busy, and then wait
+   * for OTBN. The ECDSA result is always collected so that OTBN is idle when
+   * we return, and `flash_exec` only holds the unlock value if both checks
+   * pass.
    */
   *flash_exec = 0;
-  if (rnd_uint32() < 0x80000000) {
-    HARDENED_RETURN_IF_ERROR(sigverify_ecdsa_p256_verify(
-        &manifest->ecdsa_signature, ecdsa_key, &act_digest, flash_exec));
-
-    return sigverify_spx_verify(
-        spx_signature, spx_key, spx_config, lc_state,
-        &usage_constraints_from_hw, sizeof(usage_constraints_from_hw),
-        anti_rollback, anti_rollback_len, digest_region.start,
-        digest_region.length, &act_digest, flash_exec);
+  rom_error_t ecdsa_error = sigverify_ecdsa_p256_verify_start(
+      &manifest->ecdsa_signature, ecdsa_key, &act_digest);
+  rom_error_t spx_error = sigverify_spx_verify(
+      spx_signature, spx_key, spx_config, lc_state, &usage_constraints_from_hw,
+      sizeof(usage_constraints_from_hw), anti_rollback, anti_rollback_len,
+      digest_region.start, digest_region.length, &act_digest, flash_exec);
+  rom_timing_record(kBootTimingEventRomExtSpxVerify);
+  if (launder32(ecdsa_error) == kErrorOk) {
+    HARDENED_CHECK_EQ(ecdsa_error, kErrorOk);
+    ecdsa_error = sigverify_ecdsa_p256_verify_finalize(
+        &manifest->ecdsa_signature, flash_exec);
+    rom_timing_record(kBootTimingEventRomExtEcdsaVerify);
   } else {
-    HARDENED_RETURN_IF_ERROR(sigverify_spx_verify(
-        spx_signature, spx_key, spx_config, lc_state,
-        &usage_constraints_from_hw, sizeof(usage_constraints_from_hw),
-        anti_rollback, anti_rollback_len, digest_region.start,
-        digest_region.length, &act_digest, flash_exec));
-
-    return sigverify_ecdsa_p256_verify(&manifest->ecdsa_signature, ecdsa_key,
-                                       &act_digest, flash_exec);
+    *flash_exec ^= UINT32_MAX;
   }
+  HARDENED_RETURN_IF_ERROR(spx_error);
+  return ecdsa_error;
 }
 
 /* These symbols are defined in
@@ -667,6 +683,8 @@ static rom_error_t rom_boot(const manifest_t *manifest, uint32_t flash_exec) {
   // In a normal build, this function inlines to nothing.
   stack_utilization_print();
 
+  rom_timing_record(kBootTimingEventRomExit);
+
   // (Potentially) Execute the immutable ROM_EXT section.
   uint32_t rom_ext_immutable_section_enabled =
       otp_read32(OTP_CTRL_PARAM_CREATOR_SW_CFG_IMMUTABLE_ROM_EXT_EN_OFFSET);
@@ -731,6 +749,11 @@ static rom_error_t rom_try_boot(void) {
   // Read boot data from flash
   HARDENED_RETURN_IF_ERROR(boot_data_read(lc_state, &boot_data));
 
+  // Load secure boot keys from OTP into RAM and check their integrity once for
+  // both ROM_EXT slots, so that failing over to the second slot does not
+  // reload them.
+  HARDENED_RETURN_IF_ERROR(sigverify_otp_keys_init(&sigverify_ctx));
+
   boot_policy_manifests_t manifests = boot_policy_manifests_get();
   uint32_t flash_exec = 0;
 
@@ -0,0 +1,49 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "sw/device/lib/base/status.h"
+#include "sw/device/lib/runtime/log.h"
+#include "sw/device/lib/testing/test_framework/check.h"
+#include "sw/device/lib/testing/test_framework/ottf_main.h"
+#include "sw/device/silicon_creator/lib/boot_log.h"
+#include "sw/device/silicon_creator/lib/drivers/retention_sram.h"
+
+// Reports how long the ROM_EXT took to verify this image, so that ROM_EXT
+// builds can be compared (e.g. with and without `//sw/device:hot_text`).
+
+OTTF_DEFINE_TEST_CONFIG();
+
+static status_t event_mcycle(const boot_timing_t *timing,
+                             boot_timing_event_t event, uint32_t *mcycle) {
+  for (uint32_t i = 0; i < timing->count && i < kBootTimingEntryCount; ++i) {
+    if (timing->entry[i].event == event) {
+      *mcycle = timing->entry[i].mcycle;
+      return OK_STATUS();
+    }
+  }
+  return NOT_FOUND();
+}
+
+static status_t verify_timing_print(void) {
+  retention_sram_creator_t *creator = &retention_sram_get()->creator;
+  TRY(boot_log_check(&creator->boot_log));
+  const boot_timing_t *timing = &creator->boot_timing;
+  TRY_CHECK(timing->identifier == kBootTimingIdentifier);
+
+  uint32_t start, measured, verified;
+  TRY(event_mcycle(timing, kBootTimingEventRomExtStart, &start));
+  TRY(event_mcycle(timing, kBootTimingEventBl0Measure, &measured));
+  TRY(event_mcycle(timing, kBootTimingEventBl0Verify, &verified));
+
+  LOG_INFO("bl0_measure_cycles = %u", creator->boot_log.bl0_measure_cycles);
+  LOG_INFO("bl0_signature_cycles = %u", verified - measured);
+  LOG_INFO("rom_ext_to_bl0_verified_cycles = %u", verified - start);
+  return OK_STATUS();
+}
+
+bool test_main(void) {
+  status_t result = OK_STATUS();
+  EXECUTE_TEST(result, verify_timing_print);
+  return status_ok(result);
+}
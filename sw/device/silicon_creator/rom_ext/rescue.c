@@ -12,6 +12,7 @@
 #include "sw/device/silicon_creator/lib/drivers/lifecycle.h"
 #include "sw/device/silicon_creator/lib/drivers/retention_sram.h"
 #include "sw/device/silicon_creator/lib/drivers/rstmgr.h"
+#include "sw/device/silicon_creator/lib/drivers/spi_device.h"
 #include "sw/device/silicon_creator/lib/drivers/uart.h"
 #include "sw/device/silicon_creator/lib/ownership/datatypes.h"
 #include "sw/device/silicon_creator/lib/ownership/owner_block.h"
@@ -30,6 +31,8 @@ const uint32_t kFlashBankSize =
 static rescue_state_t rescue_state;
 
 rom_error_t flash_firmware_block(rescue_state_t *state) {
+  static_assert(sizeof(state->data) == FLASH_CTRL_PARAM_BYTES_PER_PAGE,
+                "Each firmware block must fill exactly one flash page");
   uint32_t bank_offset =
       state->mode == kRescueModeFirmwareSlotB ? kFlashBankSize : 0;
   if (state->flash_offset == 0) {
@@ -40,18 +43,24 @@ rom_error_t flash_firmware_block(rescue_state_t *state) {
         .write = kMultiBitBool4True,
         .erase = kMultiBitBool4True,
     });
-    for (uint32_t addr = state->flash_start; addr < state->flash_limit;
-         addr += kFlashPageSize) {
-      HARDENED_RETURN_IF_ERROR(
-          flash_ctrl_data_erase(bank_offset + addr, kFlashCtrlEraseTypePage));
-    }
+    // Only the first page is erased up front. Each following page is erased
+    // while the host sends the block destined for it.
+    HARDENED_RETURN_IF_ERROR(flash_ctrl_data_erase(
+        bank_offset + state->flash_start, kFlashCtrlEraseTypePage));
     state->flash_offset = state->flash_start;
+  } else if (state->flash_offset < state->flash_limit) {
+    // Wait for the erase started after the previous block.
+    HARDENED_RETURN_IF_ERROR(flash_ctrl_data_erase_finalize());
   }
   if (state->flash_offset < state->flash_limit) {
     HARDENED_RETURN_IF_ERROR(flash_ctrl_data_write(
         bank_offset + state->flash_offset,
         sizeof(state->data) / sizeof(uint32_t), state->data));
     state->flash_offset += sizeof(state->data);
+    if (state->flash_offset < state->flash_limit) {
+      flash_ctrl_data_erase_start(bank_offset + state->flash_offset,
+                                  kFlashCtrlEraseTypePage);
+    }
   } else {
     xmodem_cancel(iohandle);
     return kErrorRescueImageTooBig;
@@ -59,6 +68,33 @@ rom_error_t flash_firmware_block(rescue_state_t *state) {
   return kErrorOk;
 }
 
+/**
+ * Completes a firmware upload by erasing the rest of the rescue region.
+ *
+ * The region used to be erased in full before the first block was written;
+ * pages past the end of a short image must still end up erased.
+ *
+ * @param state The rescue state.
+ * @return Result of the operation.
+ */
+static rom_error_t flash_firmware_finish(rescue_state_t *state) {
+  if ((state->mode != kRescueModeFirmware &&
+       state->mode != kRescueModeFirmwareSlotB) ||
+      state->flash_offset == 0 || state->flash_offset >= state->flash_limit) {
+    return kErrorOk;
+  }
+  uint32_t bank_offset =
+      state->mode == kRescueModeFirmwareSlotB ? kFlashBankSize : 0;
+  HARDENED_RETURN_IF_ERROR(flash_ctrl_data_erase_finalize());
+  for (uint32_t addr = state->flash_offset + kFlashPageSize;
+       addr < state->flash_limit; addr += kFlashPageSize) {
+    HARDENED_RETURN_IF_ERROR(
+        flash_ctrl_data_erase(bank_offset + addr, kFlashCtrlEraseTypePage));
+  }
+  state->flash_offset = state->flash_limit;
+  return kErrorOk;
+}
+
 rom_error_t flash_owner_block(rescue_state_t *state, boot_data_t *bootdata) {
   if (bootdata->ownership_state == kOwnershipStateUnlockedAny ||
       bootdata->ownership_state == kOwnershipStateUnlockedSelf ||
@@ -166,6 +202,12 @@ static void validate_mode(uint32_t mode, rescue_state_t *state,
       case kRescueModeBootLog:
         dbg_printf("ok: receive boot_log via xmodem-crc\r\n");
         break;
+      case kRescueModeBootTiming:
+        dbg_printf("ok: receive boot_timing via xmodem-crc\r\n");
+        break;
+      case kRescueModeEventTrace:
+        dbg_printf("ok: receive event_trace via xmodem-crc\r\n");
+        break;
       case kRescueModeBootSvcRsp:
         dbg_printf("ok: receive boot_svc response via xmodem-crc\r\n");
         break;
@@ -224,6 +266,14 @@ static rom_error_t handle_send_modes(rescue_state_t *state,
       HARDENED_RETURN_IF_ERROR(xmodem_send(iohandle, &rr->creator.boot_log,
                                            sizeof(rr->creator.boot_log)));
       break;
+    case kRescueModeBootTiming:
+      HARDENED_RETURN_IF_ERROR(xmodem_send(iohandle, &rr->creator.boot_timing,
+                                           sizeof(rr->creator.boot_timing)));
+      break;
+    case kRescueModeEventTrace:
+      HARDENED_RETURN_IF_ERROR(xmodem_send(iohandle, &rr->owner.event_trace,
+                                           sizeof(rr->owner.event_trace)));
+      break;
     case kRescueModeBootSvcRsp:
       HARDENED_RETURN_IF_ERROR(xmodem_send(iohandle, &rr->creator.boot_svc_msg,
                                            sizeof(rr->creator.boot_svc_msg)));
@@ -274,6 +324,8 @@ static rom_error_t handle_recv_modes(rescue_state_t *state,
   retention_sram_t *rr = retention_sram_get();
   switch (state->mode) {
     case kRescueModeBootLog:
+    case kRescueModeBootTiming:
+    case kRescueModeEventTrace:
     case kRescueModeBootSvcRsp:
     case kRescueModeOpenTitanID:
     case kRescueModeOwnerPage0:
@@ -348,6 +400,7 @@ static rom_error_t protocol(rescue_state_t *state, boot_data_t *bootdata) {
           }
           HARDENED_RETURN_IF_ERROR(handle_recv_modes(&rescue_state, bootdata));
         }
+        HARDENED_RETURN_IF_ERROR(flash_firmware_finish(state));
         xmodem_ack(iohandle, true);
         if (!state->reboot) {
           state->frame = 1;
@@ -379,6 +432,123 @@ static rom_error_t protocol(rescue_state_t *state, boot_data_t *bootdata) {
   }
 }
 
+/**
+ * Checks that `[addr, addr + len)` lies within the rescue region of either
+ * firmware slot.
+ *
+ * @param state The rescue state.
+ * @param addr Absolute flash address.
+ * @param len Length in bytes.
+ * @return Whether the range may be erased or programmed.
+ */
+static bool spi_flash_range_ok(const rescue_state_t *state, uint32_t addr,
+                               uint32_t len) {
+  uint32_t offset = addr >= kFlashBankSize ? addr - kFlashBankSize : addr;
+  return offset < kFlashBankSize && offset >= state->flash_start &&
+         offset < state->flash_limit && len <= state->flash_limit - offset;
+}
+
+/**
+ * Handles one erase or program command of the SPI flash rescue protocol.
+ *
+ * Addresses are absolute flash addresses so the image can be written with the
+ * same tooling (and the same image layout) as ROM bootstrap.
+ *
+ * @param state The rescue state.
+ * @param cmd The command received from the host.
+ * @return Result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+static rom_error_t spi_flash_cmd_handle(rescue_state_t *state,
+                                        spi_device_cmd_t *cmd) {
+  enum {
+    kSectorSize = 4096,
+    kFlashWordMask = FLASH_CTRL_PARAM_BYTES_PER_WORD - 1,
+  };
+  switch (cmd->opcode) {
+    case kSpiDeviceOpcodeSectorErase: {
+      uint32_t addr = cmd->address & ~(uint32_t)(kSectorSize - 1);
+      if (!spi_flash_range_ok(state, addr, kSectorSize)) {
+        return kErrorRescueImageTooBig;
+      }
+      HARDENED_RETURN_IF_ERROR(
+          flash_ctrl_data_erase(addr, kFlashCtrlEraseTypePage));
+      return flash_ctrl_data_erase(addr + kFlashPageSize,
+                                   kFlashCtrlEraseTypePage);
+    }
+    case kSpiDeviceOpcodeChipErase:
+      // Only the rescue regions of the two slots are erased.
+      for (uint32_t addr = state->flash_start; addr < state->flash_limit;
+           addr += kFlashPageSize) {
+        HARDENED_RETURN_IF_ERROR(
+            flash_ctrl_data_erase(addr, kFlashCtrlEraseTypePage));
+        HARDENED_RETURN_IF_ERROR(flash_ctrl_data_erase(
+            kFlashBankSize + addr, kFlashCtrlEraseTypePage));
+      }
+      return kErrorOk;
+    case kSpiDeviceOpcodePageProgram: {
+      // Pad to the next flash word with `0xff`. Unlike a real SPI flash, the
+      // data does not wrap around at the 256-byte page boundary.
+      size_t len = cmd->payload_byte_count;
+      while (len & kFlashWordMask) {
+        cmd->payload[len++] = 0xff;
+      }
+      if (cmd->address & kFlashWordMask ||
+          !spi_flash_range_ok(state, cmd->address, len)) {
+        return kErrorRescueImageTooBig;
+      }
+      return flash_ctrl_data_write(cmd->address, len / sizeof(uint32_t),
+                                   cmd->payload);
+    }
+    default:
+      // Ignore anything else, e.g. a 0x0 opcode due to a glitch on the bus.
+      return kErrorOk;
+  }
+}
+
+/**
+ * Firmware rescue over spi_device in flash emulation mode.
+ *
+ * The host erases and programs the rescue region with SECTOR_ERASE,
+ * CHIP_ERASE and PAGE_PROGRAM, polling the WIP bit between commands, and ends
+ * the session with RESET. Each page is transferred at the SPI clock rate
+ * without a per-block acknowledgement round-trip.
+ *
+ * @param state The rescue state.
+ * @return Result of the operation; `kErrorRescueReboot` on RESET.
+ */
+OT_WARN_UNUSED_RESULT
+static rom_error_t spi_flash_protocol(rescue_state_t *state) {
+  if (owner_rescue_command_allowed(state->config, kRescueModeFirmware) !=
+      kHardenedBoolTrue) {
+    return kErrorRescueBadMode;
+  }
+  dbg_printf("ok: spi flash rescue\r\n");
+  spi_device_init();
+  // TODO(#24428): Make sure we interact correctly with owner flash region
+  // configuration.
+  flash_ctrl_data_default_perms_set((flash_ctrl_perms_t){
+      .read = kMultiBitBool4True,
+      .write = kMultiBitBool4True,
+      .erase = kMultiBitBool4True,
+  });
+
+  spi_device_cmd_t cmd;
+  while (true) {
+    RETURN_IF_ERROR(spi_device_cmd_get(&cmd));
+    if (cmd.opcode == kSpiDeviceOpcodeReset) {
+      return kErrorRescueReboot;
+    }
+    // Erase and program require WREN, ignore if WEL is not set.
+    if (!bitfield_bit32_read(spi_device_flash_status_get(),
+                             kSpiDeviceWelBit)) {
+      continue;
+    }
+    HARDENED_RETURN_IF_ERROR(spi_flash_cmd_handle(state, &cmd));
+    spi_device_flash_status_clear();
+  }
+}
+
 rom_error_t rescue_protocol(boot_data_t *bootdata,
                             const owner_rescue_config_t *config) {
   rescue_state.config = config;
@@ -393,7 +563,13 @@ rom_error_t rescue_protocol(boot_data_t *bootdata,
     rescue_state.flash_limit =
         (uint32_t)(config->start + config->size) * kFlashPageSize;
   }
-  rom_error_t result = protocol(&rescue_state, bootdata);
+  rom_error_t result;
+  if ((hardened_bool_t)config != kHardenedBoolFalse &&
+      config->rescue_type == kRescueTypeSpiFlash) {
+    result = spi_flash_protocol(&rescue_state);
+  } else {
+    result = protocol(&rescue_state, bootdata);
+  }
   if (result == kErrorRescueReboot) {
     rstmgr_reset();
   }
@@ -19,11 +19,25 @@ enum {
   kRescueDetectTime = 350,
 };
 
+/**
+ * Rescue transports, selected by `owner_rescue_config_t.rescue_type`.
+ */
+typedef enum {
+  /** `XMDM`: XMODEM-CRC over the UART. */
+  kRescueTypeXmodem = 0x4d444d58,
+  /** `SPIF`: spi_device in flash emulation mode. */
+  kRescueTypeSpiFlash = 0x46495053,
+} rescue_type_t;
+
 typedef enum {
   /** `BAUD` */
   kRescueModeBaud = 0x42415544,
   /** `BLOG` */
   kRescueModeBootLog = 0x424c4f47,
+  /** `BTIM` */
+  kRescueModeBootTiming = 0x4254494d,
+  /** `ETRC` */
+  kRescueModeEventTrace = 0x45545243,
   /** `BRSP` */
   kRescueModeBootSvcRsp = 0x42525350,
   /** `BREQ` */
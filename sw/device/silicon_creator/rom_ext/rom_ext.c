@@ -6,6 +6,7 @@
 
 #include "sw/device/lib/arch/device.h"
 #include "sw/device/lib/base/csr.h"
+#include "sw/device/lib/base/hardened_memory.h"
 #include "sw/device/lib/base/macros.h"
 #include "sw/device/lib/base/memory.h"
 #include "sw/device/lib/base/stdasm.h"
@@ -25,6 +26,8 @@
 #include "sw/device/silicon_creator/lib/drivers/flash_ctrl.h"
 #include "sw/device/silicon_creator/lib/drivers/hmac.h"
 #include "sw/device/silicon_creator/lib/drivers/ibex.h"
+#include "sw/device/silicon_creator/lib/drivers/keymgr.h"
+#include "sw/device/silicon_creator/lib/drivers/kmac.h"
 #include "sw/device/silicon_creator/lib/drivers/lifecycle.h"
 #include "sw/device/silicon_creator/lib/drivers/otp.h"
 #include "sw/device/silicon_creator/lib/drivers/pinmux.h"
@@ -70,6 +73,25 @@ owner_application_keyring_t keyring;
 // Verifying key index
 size_t verify_key;
 
+// Cycles spent measuring the most recently verified BL0 image.
+uint32_t bl0_measure_cycles;
+
+// Info pages read several times during boot, served from RAM until handoff.
+// The boot data pages are scanned entry by entry and the attestation key
+// seeds are read for every attestation key.
+static flash_ctrl_info_cache_entry_t info_page_cache[] = {
+    {.info_page = &kFlashCtrlInfoPageBootData0},
+    {.info_page = &kFlashCtrlInfoPageBootData1},
+    {.info_page = &kFlashCtrlInfoPageAttestationKeySeeds},
+};
+
+/**
+ * Records a boot timing event in the retention SRAM.
+ */
+static void rom_ext_timing_record(boot_timing_event_t event) {
+  boot_timing_record(&retention_sram_get()->creator.boot_timing, event);
+}
+
 OT_WARN_UNUSED_RESULT
 static rom_error_t rom_ext_irq_error(void) {
   uint32_t mcause;
@@ -135,6 +157,7 @@ void rom_ext_check_rom_expectations(void) {
 OT_WARN_UNUSED_RESULT
 static rom_error_t rom_ext_init(boot_data_t *boot_data) {
   sec_mmio_next_stage_init();
+  flash_ctrl_info_cache_enable(info_page_cache, ARRAYSIZE(info_page_cache));
   lc_state = lifecycle_state_get();
   pinmux_init();
   // Configure UART0 as stdout.
@@ -155,6 +178,7 @@ static rom_error_t rom_ext_init(boot_data_t *boot_data) {
   HARDENED_RETURN_IF_ERROR(retention_sram_check_version());
 
   // Get the boot_data record
+  boot_data_hint_init(&retention_sram_get()->creator.boot_data_hint);
   HARDENED_RETURN_IF_ERROR(boot_data_read(lc_state, boot_data));
 
   return kErrorOk;
@@ -192,15 +216,133 @@ void rom_ext_sram_exec(owner_sram_exec_mode_t mode) {
   }
 }
 
+#ifdef ROM_EXT_VERIFIED_IMAGE_CACHE
+enum {
+  /**
+   * Domain separator for verified image tags (ASCII "VIMG").
+   *
+   * The tags share the KMAC key and prefix set up by `ownership_seal_init()`
+   * with the owner page seals, whose input starts with the "OWNR" tag.
+   */
+  kVerifiedImageIdentifier = 0x474d4956,
+};
+
+/**
+ * Computes the verified image tag of an owner image.
+ *
+ * The tag binds the measured image digest, which covers the usage constraints
+ * and the whole signed region, to the signature and the verifying key, so any
+ * change to the image in flash or to the owner keyring yields a new tag.
+ *
+ * The sealing key is generated in the `CreatorRootKey` stage, which the key
+ * manager has left before BL0 runs, so BL0 can only compute tags while the key
+ * is still in the KMAC sideload slot. `rom_ext_boot()` must clear the slot
+ * before handing over execution.
+ *
+ * @param manifest Manifest of the owner image.
+ * @param key Application key that verifies the image.
+ * @param digest Digest of the image as computed by `rom_ext_verify()`.
+ * @param[out] tag Output buffer for the tag.
+ * @return The result of the operation.
+ */
+OT_WARN_UNUSED_RESULT
+static rom_error_t verified_image_tag(const manifest_t *manifest,
+                                      const owner_application_key_t *key,
+                                      const hmac_digest_t *digest,
+                                      uint32_t *tag) {
+  const uint32_t header[2] = {kVerifiedImageIdentifier,
+                              (uint32_t)(uintptr_t)manifest};
+  HARDENED_RETURN_IF_ERROR(kmac_kmac256_start());
+  kmac_kmac256_absorb(header, sizeof(header));
+  kmac_kmac256_absorb(digest, sizeof(*digest));
+  kmac_kmac256_absorb(&manifest->ecdsa_signature,
+                      sizeof(manifest->ecdsa_signature));
+  kmac_kmac256_absorb(&key->data.ecdsa, sizeof(key->data.ecdsa));
+  return kmac_kmac256_final(tag, kRetentionSramVerifiedImageTagWords);
+}
+#endif
+
+/**
+ * Result of verifying the image in one BL0 slot during this boot.
+ *
+ * A MinBl0SecVer boot service request verifies both slots before the boot
+ * policy verifies the slot it boots. Flash and the owner keyring do not change
+ * in between, so the digest and the signature verification result of each
+ * slot are recorded and reused. The boot policy checks, which depend on boot
+ * data that the request may have updated, are always repeated.
+ */
+typedef struct rom_ext_verify_cache_entry {
+  /**
+   * `kHardenedBoolTrue` if the entry holds a result.
+   */
+  hardened_bool_t valid;
+  /**
+   * Key that verified the image, and its ID.
+   */
+  const owner_application_key_t *key;
+  uint32_t key_id;
+  /**
+   * Digest of the image and the cycles spent computing it.
+   */
+  hmac_digest_t digest;
+  uint32_t measure_cycles;
+  /**
+   * Result of the signature verification.
+   */
+  rom_error_t result;
+} rom_ext_verify_cache_entry_t;
+
+// Verification results of slots A and B, in that order.
+static rom_ext_verify_cache_entry_t verify_cache[2];
+
+/**
+ * Returns the verification cache entry of a BL0 slot.
+ *
+ * @param manifest Manifest of the owner image.
+ * @return The entry, or NULL if `manifest` is not at the start of a slot.
+ */
+static rom_ext_verify_cache_entry_t *verify_cache_entry_get(
+    const manifest_t *manifest) {
+  if (manifest == rom_ext_boot_policy_manifest_a_get()) {
+    return &verify_cache[0];
+  }
+  if (manifest == rom_ext_boot_policy_manifest_b_get()) {
+    return &verify_cache[1];
+  }
+  return NULL;
+}
+
+/**
+ * Records the verification result of a BL0 slot.
+ *
+ * @param entry Entry of the slot, may be NULL.
+ * @param key_id ID of the key that verified the image.
+ * @param digest Digest of the image.
+ * @param result Result of the signature verification.
+ */
+static void verify_cache_record(rom_ext_verify_cache_entry_t *entry,
+                                uint32_t key_id, const hmac_digest_t *digest,
+                                rom_error_t result) {
+  if (entry == NULL) {
+    return;
+  }
+  entry->key = keyring.key[verify_key];
+  entry->key_id = key_id;
+  memcpy(&entry->digest, digest, sizeof(entry->digest));
+  entry->measure_cycles = bl0_measure_cycles;
+  entry->result = result;
+  entry->valid = kHardenedBoolTrue;
+}
+
 OT_WARN_UNUSED_RESULT
 static rom_error_t rom_ext_verify(const manifest_t *manifest,
                                   const boot_data_t *boot_data) {
   RETURN_IF_ERROR(rom_ext_boot_policy_manifest_check(manifest, boot_data));
   ownership_key_alg_t key_alg = kOwnershipKeyAlgEcdsaP256;
-  RETURN_IF_ERROR(owner_keyring_find_key(
-      &keyring, key_alg,
-      sigverify_ecdsa_p256_key_id_get(&manifest->ecdsa_public_key),
-      &verify_key));
+  uint32_t key_id =
+      sigverify_ecdsa_p256_key_id_get(&manifest->ecdsa_public_key);
+  RETURN_IF_ERROR(
+      owner_keyring_find_key(&keyring, key_alg, key_id, &verify_key));
 
   dbg_printf("app_verify: key=%u alg=%C domain=%C\r\n", verify_key,
              keyring.key[verify_key]->key_alg,
@@ -209,6 +351,21 @@ static rom_error_t rom_ext_verify(const manifest_t *manifest,
   memset(boot_measurements.bl0.data, (int)rnd_uint32(),
          sizeof(boot_measurements.bl0.data));
 
+  // Reuse the result of an earlier verification of this slot with the same
+  // key, restoring the measurement it produced.
+  rom_ext_verify_cache_entry_t *entry = verify_cache_entry_get(manifest);
+  if (entry != NULL && launder32(entry->valid) == kHardenedBoolTrue &&
+      entry->key == keyring.key[verify_key] && entry->key_id == key_id) {
+    HARDENED_CHECK_EQ(entry->valid, kHardenedBoolTrue);
+    memcpy(&boot_measurements.bl0, &entry->digest,
+           sizeof(boot_measurements.bl0));
+    bl0_measure_cycles = entry->measure_cycles;
+    dbg_printf("app_verify: reused\r\n");
+    rom_ext_timing_record(kBootTimingEventBl0Verify);
+    return entry->result;
+  }
+
+  uint32_t measure_start = ibex_mcycle32();
   hmac_sha256_init();
   // Hash usage constraints.
   manifest_usage_constraints_t usage_constraints_from_hw;
@@ -225,15 +382,44 @@ static rom_error_t rom_ext_verify(const manifest_t *manifest,
   hmac_sha256_process();
   hmac_digest_t act_digest;
   hmac_sha256_final(&act_digest);
+  bl0_measure_cycles = ibex_mcycle32() - measure_start;
+  rom_ext_timing_record(kBootTimingEventBl0Measure);
 
   static_assert(sizeof(boot_measurements.bl0) == sizeof(act_digest),
                 "Unexpected BL0 digest size.");
   memcpy(&boot_measurements.bl0, &act_digest, sizeof(boot_measurements.bl0));
 
+#ifdef ROM_EXT_VERIFIED_IMAGE_CACHE
+  // On a warm boot with an unchanged image, the tag recorded after the last
+  // successful verification matches and the signature check can be skipped.
+  retention_sram_verified_image_t *record =
+      &retention_sram_get()->creator.verified_image;
+  uint32_t tag[kRetentionSramVerifiedImageTagWords];
+  HARDENED_RETURN_IF_ERROR(verified_image_tag(
+      manifest, keyring.key[verify_key], &act_digest, tag));
+  if (hardened_memeq(record->tag, tag, ARRAYSIZE(tag)) == kHardenedBoolTrue) {
+    HARDENED_CHECK_EQ(hardened_memeq(tag, record->tag, ARRAYSIZE(tag)),
+                      kHardenedBoolTrue);
+    dbg_printf("app_verify: cached\r\n");
+    rom_ext_timing_record(kBootTimingEventBl0Verify);
+    verify_cache_record(entry, key_id, &act_digest, kErrorOk);
+    return kErrorOk;
+  }
+#endif
+
   uint32_t flash_exec = 0;
-  return sigverify_ecdsa_p256_verify(&manifest->ecdsa_signature,
-                                     &keyring.key[verify_key]->data.ecdsa,
-                                     &act_digest, &flash_exec);
+  rom_error_t error = sigverify_ecdsa_p256_verify(
+      &manifest->ecdsa_signature, &keyring.key[verify_key]->data.ecdsa,
+      &act_digest, &flash_exec);
+  rom_ext_timing_record(kBootTimingEventBl0Verify);
+#ifdef ROM_EXT_VERIFIED_IMAGE_CACHE
+  if (launder32(error) == kErrorOk) {
+    HARDENED_CHECK_EQ(error, kErrorOk);
+    memcpy(record->tag, tag, sizeof(record->tag));
+  }
+#endif
+  verify_cache_record(entry, key_id, &act_digest, error);
+  return error;
 }
 
 /**
@@ -285,15 +471,30 @@ static rom_error_t rom_ext_boot(boot_data_t *boot_data, boot_log_t *boot_log,
   // Generate CDI_1 attestation keys and certificate.
   HARDENED_RETURN_IF_ERROR(dice_chain_attestation_owner(
       manifest, &boot_measurements.bl0, &owner_measurement, &sealing_binding,
-      key->key_domain));
+      key->key_domain, boot_data->ownership_transfers));
+  rom_ext_timing_record(kBootTimingEventDiceCdi1);
 
   // Write the DICE certs to flash if they have been updated.
   HARDENED_RETURN_IF_ERROR(dice_chain_flush_flash());
+  rom_ext_timing_record(kBootTimingEventDiceFlush);
 
   // Remove write and erase access to the certificate pages before handing over
   // execution to the owner firmware (owner firmware can still read).
   flash_ctrl_cert_info_page_owner_restrict(&kFlashCtrlInfoPageDiceCerts);
 
+  // Clear the sealing key from the KMAC sideload slot. The slot survives key
+  // manager advances, and the owner stage must not be able to seal owner pages
+  // or forge verified image tags.
+  HARDENED_RETURN_IF_ERROR(sc_keymgr_sideload_clear(kScKeymgrDestKmac));
+
+  // Stop caching info pages and shred the copies, which include the
+  // attestation key seeds, before the owner stage can read the RAM.
+  flash_ctrl_info_cache_disable();
+  for (size_t i = 0; i < ARRAYSIZE(info_page_cache); ++i) {
+    hardened_memshred(info_page_cache[i].data,
+                      ARRAYSIZE(info_page_cache[i].data));
+  }
+
   // Disable access to silicon creator info pages, the OTP creator partition
   // and the OTP direct access interface until the next reset.
   flash_ctrl_creator_info_pages_lockdown();
@@ -379,6 +580,7 @@ static rom_error_t rom_ext_boot(boot_data_t *boot_data, boot_log_t *boot_log,
                                    TOP_EARLGREY_OTP_CTRL_CORE_BASE_ADDR);
   // Jump to OWNER entry point.
   dbg_printf("entry: 0x%x\r\n", (unsigned int)entry_point);
+  rom_ext_timing_record(kBootTimingEventRomExtExit);
   ((owner_stage_entry_point *)entry_point)();
 
   return kErrorRomExtBootFailed;
@@ -553,6 +755,7 @@ static rom_error_t rom_ext_try_next_stage(boot_data_t *boot_data,
     } else {
       return kErrorRomExtBootFailed;
     }
+    boot_log->bl0_measure_cycles = bl0_measure_cycles;
     boot_log_digest_update(boot_log);
 
     // Boot fails if a verified ROM_EXT cannot be booted.
@@ -575,6 +778,7 @@ static rom_error_t rom_ext_try_next_stage(boot_data_t *boot_data,
 }
 
 static rom_error_t rom_ext_start(boot_data_t *boot_data, boot_log_t *boot_log) {
+  rom_ext_timing_record(kBootTimingEventRomExtStart);
   HARDENED_RETURN_IF_ERROR(rom_ext_init(boot_data));
   const manifest_t *self = rom_ext_manifest();
   dbg_printf("Starting ROM_EXT %u.%u\r\n", self->version_major,
@@ -605,6 +809,7 @@ static rom_error_t rom_ext_start(boot_data_t *boot_data, boot_log_t *boot_log) {
   if (error != kErrorOk) {
     dbg_printf("ownership_init: %x\r\n", error);
   }
+  rom_ext_timing_record(kBootTimingEventOwnershipInit);
 
   // Configure SRAM execution as the owner requested.
   rom_ext_sram_exec(owner_config.sram_exec);
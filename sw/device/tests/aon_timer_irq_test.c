@@ -95,13 +95,13 @@ static uint64_t tick_count_get(void) {
 static void execute_test(dif_aon_timer_t *aon_timer, uint64_t irq_time_us,
                          dt_aon_timer_irq_t expected_irq) {
   // The interrupt time should be `irq_time_us ±5%`.
-  uint64_t variation = udiv64_slow(irq_time_us * 5, 100, NULL);
+  uint64_t variation = udiv64(irq_time_us * 5, 100, NULL);
   CHECK(variation > 0);
   uint64_t sleep_range_h = irq_time_us + variation;
   uint64_t sleep_range_l = irq_time_us - variation;
 
   // Add 1500 cpu cycles of overhead to cover irq handling.
-  sleep_range_h += udiv64_slow(1500 * 1000000, kClockFreqCpuHz, NULL);
+  sleep_range_h += udiv64(1500 * 1000000, kClockFreqCpuHz, NULL);
 
   uint64_t count_cycles = 0;
   CHECK_STATUS_OK(aon_timer_testutils_get_aon_cycles_64_from_us(irq_time_us,
@@ -223,9 +223,9 @@ bool test_main(void) {
     kMaxCycles = 45 * 1000,
   };
   uint64_t low_time_range =
-      udiv64_slow(kMinCycles * (uint64_t)1000000, kClockFreqCpuHz, NULL);
+      udiv64(kMinCycles * (uint64_t)1000000, kClockFreqCpuHz, NULL);
   uint64_t high_time_range =
-      udiv64_slow(kMaxCycles * (uint64_t)1000000, kClockFreqCpuHz, NULL);
+      udiv64(kMaxCycles * (uint64_t)1000000, kClockFreqCpuHz, NULL);
 
   // no error in the reference time measurement.
   uint64_t irq_time = rand_testutils_gen32_range((uint32_t)low_time_range,
@@ -61,8 +61,8 @@ static void wdog_bite_test(const dif_aon_timer_t *aon_timer,
   // The `intr_state` takes 3 aon clock cycles to rise plus 2 extra cycles as a
   // precaution.
   uint32_t wait_us = (uint32_t)bark_time_us +
-                     (uint32_t)udiv64_slow(5 * 1000000 + kClockFreqAonHz - 1,
-                                           kClockFreqAonHz, NULL);
+                     (uint32_t)udiv64(5 * 1000000 + kClockFreqAonHz - 1,
+                                      kClockFreqAonHz, NULL);
 
   // Wait bark time and check that the bark interrupt requested.
   busy_spin_micros(wait_us);
@@ -248,6 +248,67 @@ static status_t decrypt_streaming_test(void) {
   return run_decrypt(test, /*streaming=*/true);
 }
 
+/**
+ * Test encryption with a persistent AES session.
+ *
+ * Only runs for ECB and CTR modes. The plaintext is fed in chunks of varying
+ * length (whole blocks for ECB, arbitrary lengths for CTR) and the output is
+ * compared against the expected ciphertext, without the padding.
+ */
+static status_t encrypt_session_test(void) {
+  if (test->mode != kOtcryptoAesModeEcb && test->mode != kOtcryptoAesModeCtr) {
+    return OK_STATUS();
+  }
+  otcrypto_key_config_t config = make_key_config(test);
+  uint32_t keyblob[keyblob_num_words(config)];
+  TRY(keyblob_from_key_and_mask(test->key, kKeyMask, config, keyblob));
+  otcrypto_blinded_key_t key = {
+      .config = config,
+      .keyblob_length = sizeof(keyblob),
+      .keyblob = keyblob,
+  };
+  key.checksum = integrity_blinded_checksum(&key);
+
+  uint32_t iv_data[kAesBlockWords];
+  memcpy(iv_data, test->iv, kAesBlockBytes);
+  otcrypto_word32_buf_t iv = {
+      .data = iv_data,
+      .len = kAesBlockWords,
+  };
+
+  // ECB can only process whole blocks.
+  size_t len = test->plaintext_len;
+  size_t chunk_unit = 1;
+  if (test->mode == kOtcryptoAesModeEcb) {
+    len -= len % kAesBlockBytes;
+    chunk_unit = kAesBlockBytes;
+  }
+  unsigned char ciphertext[len + 1];
+
+  otcrypto_aes_session_t session;
+  TRY(otcrypto_aes_session_start(&key, iv, test->mode,
+                                 kOtcryptoAesOperationEncrypt, &session));
+  const unsigned char *plaintext = (const unsigned char *)test->plaintext;
+  size_t offset = 0;
+  for (size_t i = 1; offset < len; ++i) {
+    // Use chunk lengths of 1, 2, 3, ... units.
+    size_t chunk_len = i * chunk_unit;
+    if (chunk_len > len - offset) {
+      chunk_len = len - offset;
+    }
+    otcrypto_const_byte_buf_t input = {.data = &plaintext[offset],
+                                       .len = chunk_len};
+    otcrypto_byte_buf_t output = {.data = &ciphertext[offset],
+                                  .len = chunk_len};
+    TRY(otcrypto_aes_session_update(&session, input, output));
+    offset += chunk_len;
+  }
+  TRY(otcrypto_aes_session_end(&session, iv));
+
+  TRY_CHECK_ARRAYS_EQ(ciphertext, (unsigned char *)test->exp_ciphertext, len);
+  return OK_STATUS();
+}
+
 OTTF_DEFINE_TEST_CONFIG();
 
 bool test_main(void) {
@@ -263,6 +324,7 @@ bool test_main(void) {
     EXECUTE_TEST(result, decrypt_test);
     EXECUTE_TEST(result, encrypt_streaming_test);
     EXECUTE_TEST(result, decrypt_streaming_test);
+    EXECUTE_TEST(result, encrypt_session_test);
     LOG_INFO("Finished AES test %d.", i + 1);
   }
 
@@ -102,6 +102,131 @@ static status_t wrap_unwrap_random_test(void) {
   return run_wrap_unwrap(&kmac_key, &kek);
 }
 
+/**
+ * Returns the configuration of a KMAC key of the given length.
+ *
+ * @param key_length Key length in bytes.
+ */
+static otcrypto_key_config_t kmac_key_config(size_t key_length) {
+  return (otcrypto_key_config_t){
+      .version = kOtcryptoLibVersion1,
+      .key_mode = kOtcryptoKeyModeKmac256,
+      .key_length = key_length,
+      .hw_backed = kHardenedBoolFalse,
+      .security_level = kOtcryptoKeySecurityLevelLow,
+  };
+}
+
+/**
+ * Test wrapping/unwrapping several random keys of different lengths at once.
+ *
+ * The batch results must match wrapping each key on its own.
+ */
+static status_t wrap_unwrap_batch_test(void) {
+  enum { kNumKeys = 3, kMaxKeyblobWords = (256 / 8) * 2 / sizeof(uint32_t) };
+
+  // Generate random KMAC keys.
+  otcrypto_const_byte_buf_t personalization = {.data = NULL, .len = 0};
+  uint32_t keyblobs[kNumKeys][kMaxKeyblobWords];
+  otcrypto_blinded_key_t keys[kNumKeys] = {
+      {
+          .config = kmac_key_config(128 / 8),
+          .keyblob_length = (128 / 8) * 2,
+          .keyblob = keyblobs[0],
+      },
+      {
+          .config = kmac_key_config(256 / 8),
+          .keyblob_length = (256 / 8) * 2,
+          .keyblob = keyblobs[1],
+      },
+      {
+          .config = kmac_key_config(192 / 8),
+          .keyblob_length = (192 / 8) * 2,
+          .keyblob = keyblobs[2],
+      },
+  };
+  for (size_t i = 0; i < kNumKeys; i++) {
+    TRY(otcrypto_symmetric_keygen(personalization, &keys[i]));
+  }
+
+  // Generate a random AES-KWP key.
+  uint32_t kek_keyblob[(kWrappingKeyConfig.key_length * 2) / sizeof(uint32_t)];
+  otcrypto_blinded_key_t kek = {
+      .config = kWrappingKeyConfig,
+      .keyblob_length = sizeof(kek_keyblob),
+      .keyblob = kek_keyblob,
+  };
+  TRY(otcrypto_symmetric_keygen(personalization, &kek));
+
+  // Wrap the keys all at once.
+  size_t max_wrapped_words;
+  TRY(otcrypto_wrapped_key_len(keys[1].config, &max_wrapped_words));
+  uint32_t wrapped_data[kNumKeys][max_wrapped_words];
+  otcrypto_word32_buf_t wrapped_keys[kNumKeys];
+  for (size_t i = 0; i < kNumKeys; i++) {
+    wrapped_keys[i].data = wrapped_data[i];
+    TRY(otcrypto_wrapped_key_len(keys[i].config, &wrapped_keys[i].len));
+  }
+  TRY(otcrypto_key_wrap_batch(keys, kNumKeys, &kek, wrapped_keys));
+
+  // Check against wrapping the keys one at a time.
+  for (size_t i = 0; i < kNumKeys; i++) {
+    uint32_t exp_wrapped_data[wrapped_keys[i].len];
+    otcrypto_word32_buf_t exp_wrapped_key = {
+        .data = exp_wrapped_data,
+        .len = ARRAYSIZE(exp_wrapped_data),
+    };
+    TRY(otcrypto_key_wrap(&keys[i], &kek, exp_wrapped_key));
+    TRY_CHECK_ARRAYS_EQ(wrapped_keys[i].data, exp_wrapped_data,
+                        ARRAYSIZE(exp_wrapped_data));
+  }
+
+  // Unwrap the keys all at once.
+  uint32_t unwrapped_keyblobs[kNumKeys][kMaxKeyblobWords];
+  otcrypto_blinded_key_t unwrapped_keys[kNumKeys] = {
+      {
+          .keyblob_length = keys[0].keyblob_length,
+          .keyblob = unwrapped_keyblobs[0],
+      },
+      {
+          .keyblob_length = keys[1].keyblob_length,
+          .keyblob = unwrapped_keyblobs[1],
+      },
+      {
+          .keyblob_length = keys[2].keyblob_length,
+          .keyblob = unwrapped_keyblobs[2],
+      },
+  };
+  otcrypto_const_word32_buf_t const_wrapped_keys[kNumKeys] = {
+      {.data = wrapped_keys[0].data, .len = wrapped_keys[0].len},
+      {.data = wrapped_keys[1].data, .len = wrapped_keys[1].len},
+      {.data = wrapped_keys[2].data, .len = wrapped_keys[2].len},
+  };
+  hardened_bool_t success[kNumKeys];
+  TRY(otcrypto_key_unwrap_batch(const_wrapped_keys, kNumKeys, &kek, success,
+                                unwrapped_keys));
+
+  // Check the results.
+  for (size_t i = 0; i < kNumKeys; i++) {
+    TRY_CHECK(success[i] == kHardenedBoolTrue);
+    TRY_CHECK_ARRAYS_EQ(unwrapped_keys[i].keyblob, keys[i].keyblob,
+                        keys[i].keyblob_length / sizeof(uint32_t));
+    TRY_CHECK(memcmp(&unwrapped_keys[i].config, &keys[i].config,
+                     sizeof(otcrypto_key_config_t)) == 0);
+    TRY_CHECK(unwrapped_keys[i].checksum == keys[i].checksum);
+  }
+
+  // Corrupt one wrapped key; only that key should fail to unwrap.
+  wrapped_data[1][0] ^= 1;
+  TRY(otcrypto_key_unwrap_batch(const_wrapped_keys, kNumKeys, &kek, success,
+                                unwrapped_keys));
+  TRY_CHECK(success[0] == kHardenedBoolTrue);
+  TRY_CHECK(success[1] == kHardenedBoolFalse);
+  TRY_CHECK(success[2] == kHardenedBoolTrue);
+
+  return OK_STATUS();
+}
+
 OTTF_DEFINE_TEST_CONFIG();
 
 bool test_main(void) {
@@ -109,6 +234,7 @@ bool test_main(void) {
 
   CHECK_STATUS_OK(entropy_complex_init());
   EXECUTE_TEST(result, wrap_unwrap_random_test);
+  EXECUTE_TEST(result, wrap_unwrap_batch_test);
 
   return status_ok(result);
 }
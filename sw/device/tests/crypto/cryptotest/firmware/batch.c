@@ -0,0 +1,46 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "sw/device/tests/crypto/cryptotest/firmware/batch.h"
+
+static const char kHexDigits[] = "0123456789abcdef";
+
+/**
+ * Returns the value of a hex digit, or -1 if `c` is not one.
+ */
+static int hex_digit_value(char c) {
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  }
+  if (c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
+  }
+  if (c >= 'A' && c <= 'F') {
+    return c - 'A' + 10;
+  }
+  return -1;
+}
+
+status_t batch_hex_decode(const char *hex, size_t len, uint8_t *out) {
+  for (size_t i = 0; i < len; i++) {
+    int hi = hex_digit_value(hex[2 * i]);
+    if (hi < 0) {
+      // Also catches the terminating NUL of a string that is too short.
+      return INVALID_ARGUMENT();
+    }
+    int lo = hex_digit_value(hex[2 * i + 1]);
+    if (lo < 0) {
+      return INVALID_ARGUMENT();
+    }
+    out[i] = (uint8_t)((hi << 4) | lo);
+  }
+  return OK_STATUS();
+}
+
+void batch_hex_encode(const uint8_t *data, size_t len, char *hex) {
+  for (size_t i = 0; i < len; i++) {
+    hex[2 * i] = kHexDigits[data[i] >> 4];
+    hex[2 * i + 1] = kHexDigits[data[i] & 0xf];
+  }
+}
@@ -0,0 +1,43 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef OPENTITAN_SW_DEVICE_TESTS_CRYPTO_CRYPTOTEST_FIRMWARE_BATCH_H_
+#define OPENTITAN_SW_DEVICE_TESTS_CRYPTO_CRYPTOTEST_FIRMWARE_BATCH_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "sw/device/lib/base/status.h"
+
+/**
+ * Helpers for the batched commands.
+ *
+ * Batched commands carry the inputs of many vectors back to back in one hex
+ * string, along with an array of per-vector lengths. This keeps the JSON
+ * compact (two characters per byte) and lets the host run a whole batch in
+ * one console round trip.
+ */
+
+/**
+ * Decodes `len` bytes from a hex string.
+ *
+ * @param hex Hex string; must hold at least `2 * len` characters.
+ * @param len Number of bytes to decode.
+ * @param[out] out Destination buffer, `len` bytes.
+ * @return OK or INVALID_ARGUMENT if `hex` is too short or not hex.
+ */
+status_t batch_hex_decode(const char *hex, size_t len, uint8_t *out);
+
+/**
+ * Encodes `len` bytes as lowercase hex.
+ *
+ * Writes exactly `2 * len` characters and does not NUL-terminate.
+ *
+ * @param data Bytes to encode.
+ * @param len Number of bytes.
+ * @param[out] hex Destination, `2 * len` characters.
+ */
+void batch_hex_encode(const uint8_t *data, size_t len, char *hex);
+
+#endif  // OPENTITAN_SW_DEVICE_TESTS_CRYPTO_CRYPTOTEST_FIRMWARE_BATCH_H_
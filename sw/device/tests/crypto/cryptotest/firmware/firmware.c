@@ -66,6 +66,12 @@ status_t process_cmd(ujson_t *uj) {
       case kCryptotestCommandSphincsPlus:
         RESP_ERR(uj, handle_sphincsplus(uj));
         break;
+      case kCryptotestCommandHashBatch:
+        RESP_ERR(uj, handle_hash_batch(uj));
+        break;
+      case kCryptotestCommandHmacBatch:
+        RESP_ERR(uj, handle_hmac_batch(uj));
+        break;
       default:
         LOG_ERROR("Unrecognized command: %d", cmd);
         RESP_ERR(uj, INVALID_ARGUMENT());
@@ -14,8 +14,99 @@
 #include "sw/device/lib/runtime/log.h"
 #include "sw/device/lib/testing/test_framework/ujson_ottf.h"
 #include "sw/device/lib/ujson/ujson.h"
+#include "sw/device/tests/crypto/cryptotest/firmware/batch.h"
 #include "sw/device/tests/crypto/cryptotest/json/hash_commands.h"
 
+/**
+ * Parameters of a hash algorithm.
+ */
+typedef struct hash_params {
+  otcrypto_hash_mode_t mode;
+  // Digest length in 32-bit words.
+  size_t digest_len;
+  // Whether the algorithm supports the stepwise API.
+  bool test_stepwise;
+  // Oneshot hash API for the algorithm (unset for cSHAKE).
+  otcrypto_status_t (*hash_oneshot)(otcrypto_const_byte_buf_t,
+                                    otcrypto_hash_digest_t);
+} hash_params_t;
+
+/**
+ * Looks up the parameters of a hash algorithm.
+ *
+ * @param algorithm Hash algorithm.
+ * @param xof_len Requested output length in bytes (ignored for SHA2/3).
+ * @param[out] params Algorithm parameters.
+ * @return OK or INVALID_ARGUMENT for unsupported algorithms.
+ */
+static status_t hash_params_get(cryptotest_hash_algorithm_t algorithm,
+                                size_t xof_len, hash_params_t *params) {
+  params->test_stepwise = false;
+  params->hash_oneshot = NULL;
+  switch (algorithm) {
+    case kCryptotestHashAlgorithmSha256:
+      params->mode = kOtcryptoHashModeSha256;
+      params->digest_len = kSha256DigestWords;
+      params->hash_oneshot = otcrypto_hash;
+      params->test_stepwise = true;
+      break;
+    case kCryptotestHashAlgorithmSha384:
+      params->mode = kOtcryptoHashModeSha384;
+      params->digest_len = kSha384DigestWords;
+      params->hash_oneshot = otcrypto_hash;
+      params->test_stepwise = true;
+      break;
+    case kCryptotestHashAlgorithmSha512:
+      params->mode = kOtcryptoHashModeSha512;
+      params->digest_len = kSha512DigestWords;
+      params->hash_oneshot = otcrypto_hash;
+      params->test_stepwise = true;
+      break;
+    case kCryptotestHashAlgorithmSha3_224:
+      params->mode = kOtcryptoHashModeSha3_224;
+      params->digest_len = kSha3_224DigestWords;
+      params->hash_oneshot = otcrypto_hash;
+      break;
+    case kCryptotestHashAlgorithmSha3_256:
+      params->mode = kOtcryptoHashModeSha3_256;
+      params->digest_len = kSha3_256DigestWords;
+      params->hash_oneshot = otcrypto_hash;
+      break;
+    case kCryptotestHashAlgorithmSha3_384:
+      params->mode = kOtcryptoHashModeSha3_384;
+      params->digest_len = kSha3_384DigestWords;
+      params->hash_oneshot = otcrypto_hash;
+      break;
+    case kCryptotestHashAlgorithmSha3_512:
+      params->mode = kOtcryptoHashModeSha3_512;
+      params->digest_len = kSha3_512DigestWords;
+      params->hash_oneshot = otcrypto_hash;
+      break;
+    case kCryptotestHashAlgorithmShake128:
+      params->mode = kOtcryptoHashXofModeShake128;
+      params->digest_len = ceil_div(xof_len, sizeof(uint32_t));
+      params->hash_oneshot = otcrypto_xof_shake;
+      break;
+    case kCryptotestHashAlgorithmShake256:
+      params->mode = kOtcryptoHashXofModeShake256;
+      params->digest_len = ceil_div(xof_len, sizeof(uint32_t));
+      params->hash_oneshot = otcrypto_xof_shake;
+      break;
+    case kCryptotestHashAlgorithmCshake128:
+      params->mode = kOtcryptoHashXofModeCshake128;
+      params->digest_len = ceil_div(xof_len, sizeof(uint32_t));
+      break;
+    case kCryptotestHashAlgorithmCshake256:
+      params->mode = kOtcryptoHashXofModeCshake256;
+      params->digest_len = ceil_div(xof_len, sizeof(uint32_t));
+      break;
+    default:
+      LOG_ERROR("Unsupported hash algorithm: %d", algorithm);
+      return INVALID_ARGUMENT();
+  }
+  return OK_STATUS();
+}
+
 status_t handle_hash(ujson_t *uj) {
   // Declare test arguments
   cryptotest_hash_algorithm_t uj_algorithm;
@@ -47,75 +138,10 @@ status_t handle_hash(ujson_t *uj) {
       .len = 0,
   };
 
-  // Handle to correct oneshot hash API for the provided algorithm
-  otcrypto_status_t (*hash_oneshot)(otcrypto_const_byte_buf_t,
-                                    otcrypto_hash_digest_t);
-
-  // Digest length in 32-bit words
-  size_t digest_len;
-  uint8_t test_stepwise = false;
-  otcrypto_hash_mode_t mode;
-  switch (uj_algorithm) {
-    case kCryptotestHashAlgorithmSha256:
-      mode = kOtcryptoHashModeSha256;
-      digest_len = kSha256DigestWords;
-      hash_oneshot = otcrypto_hash;
-      test_stepwise = true;
-      break;
-    case kCryptotestHashAlgorithmSha384:
-      mode = kOtcryptoHashModeSha384;
-      digest_len = kSha384DigestWords;
-      hash_oneshot = otcrypto_hash;
-      test_stepwise = true;
-      break;
-    case kCryptotestHashAlgorithmSha512:
-      mode = kOtcryptoHashModeSha512;
-      digest_len = kSha512DigestWords;
-      hash_oneshot = otcrypto_hash;
-      test_stepwise = true;
-      break;
-    case kCryptotestHashAlgorithmSha3_224:
-      mode = kOtcryptoHashModeSha3_224;
-      digest_len = kSha3_224DigestWords;
-      hash_oneshot = otcrypto_hash;
-      break;
-    case kCryptotestHashAlgorithmSha3_256:
-      mode = kOtcryptoHashModeSha3_256;
-      digest_len = kSha3_256DigestWords;
-      hash_oneshot = otcrypto_hash;
-      break;
-    case kCryptotestHashAlgorithmSha3_384:
-      mode = kOtcryptoHashModeSha3_384;
-      digest_len = kSha3_384DigestWords;
-      hash_oneshot = otcrypto_hash;
-      break;
-    case kCryptotestHashAlgorithmSha3_512:
-      mode = kOtcryptoHashModeSha3_512;
-      digest_len = kSha3_512DigestWords;
-      hash_oneshot = otcrypto_hash;
-      break;
-    case kCryptotestHashAlgorithmShake128:
-      mode = kOtcryptoHashXofModeShake128;
-      digest_len = ceil_div(uj_shake_digest_length.length, sizeof(uint32_t));
-      hash_oneshot = otcrypto_xof_shake;
-      break;
-    case kCryptotestHashAlgorithmShake256:
-      mode = kOtcryptoHashXofModeShake256;
-      digest_len = ceil_div(uj_shake_digest_length.length, sizeof(uint32_t));
-      hash_oneshot = otcrypto_xof_shake;
-      break;
-    case kCryptotestHashAlgorithmCshake128:
-      mode = kOtcryptoHashXofModeCshake128;
-      digest_len = ceil_div(uj_shake_digest_length.length, sizeof(uint32_t));
-      break;
-    case kCryptotestHashAlgorithmCshake256:
-      mode = kOtcryptoHashXofModeCshake256;
-      digest_len = ceil_div(uj_shake_digest_length.length, sizeof(uint32_t));
-      break;
-    default:
-      LOG_ERROR("Unsupported hash algorithm: %d", uj_algorithm);
-      return INVALID_ARGUMENT();
-  }
+  hash_params_t params;
+  TRY(hash_params_get(uj_algorithm, uj_shake_digest_length.length, &params));
+  size_t digest_len = params.digest_len;
+  otcrypto_hash_mode_t mode = params.mode;
 
   // Create digest skeleton
   uint32_t digest_buf[digest_len];
@@ -135,7 +161,7 @@ status_t handle_hash(ujson_t *uj) {
                                    customization_string, digest);
       break;
     default:
-      status = hash_oneshot(input_message, digest);
+      status = params.hash_oneshot(input_message, digest);
   }
   if (status.value != kOtcryptoStatusValueOk) {
     LOG_ERROR("Bad status value: 0x%x", status.value);
@@ -149,7 +175,7 @@ status_t handle_hash(ujson_t *uj) {
   // stepwise test
   memset(digest_buf, 0, digest_len * sizeof(uint32_t));
   // Test the stepwise API for algorithms that support it
-  if (test_stepwise) {
+  if (params.test_stepwise) {
     otcrypto_hash_context_t ctx;
     status = otcrypto_hash_init(&ctx, mode);
     if (status.value != kOtcryptoStatusValueOk) {
@@ -185,3 +211,70 @@ status_t handle_hash(ujson_t *uj) {
   RESP_OK(ujson_serialize_cryptotest_hash_output_t, uj, &uj_output);
   return OK_STATUS(0);
 }
+
+// Batch buffers; static to keep them off the stack.
+static cryptotest_hash_batch_t uj_batch;
+static cryptotest_hash_batch_output_t uj_batch_output;
+static uint8_t batch_messages[HASH_CMD_BATCH_MAX_MESSAGE_BYTES];
+
+status_t handle_hash_batch(ujson_t *uj) {
+  cryptotest_hash_algorithm_t uj_algorithm;
+  TRY(ujson_deserialize_cryptotest_hash_algorithm_t(uj, &uj_algorithm));
+  TRY(ujson_deserialize_cryptotest_hash_batch_t(uj, &uj_batch));
+  if (uj_batch.count > HASH_CMD_BATCH_MAX_VECTORS ||
+      uj_algorithm == kCryptotestHashAlgorithmCshake128 ||
+      uj_algorithm == kCryptotestHashAlgorithmCshake256) {
+    return INVALID_ARGUMENT();
+  }
+
+  // Decode all messages up front.
+  size_t messages_len = 0;
+  for (size_t i = 0; i < uj_batch.count; i++) {
+    messages_len += uj_batch.message_lens[i];
+  }
+  if (messages_len > HASH_CMD_BATCH_MAX_MESSAGE_BYTES) {
+    return INVALID_ARGUMENT();
+  }
+  TRY(batch_hex_decode(uj_batch.messages, messages_len, batch_messages));
+
+  uint32_t digest_buf[HASH_CMD_MAX_DIGEST_BYTES / sizeof(uint32_t)];
+  const uint8_t *msg = batch_messages;
+  char *out = uj_batch_output.digests;
+  size_t digests_len = 0;
+  for (size_t i = 0; i < uj_batch.count; i++) {
+    hash_params_t params;
+    TRY(hash_params_get(uj_algorithm, uj_batch.digest_lens[i], &params));
+    size_t digest_bytes = params.digest_len * sizeof(uint32_t);
+    if (digest_bytes > sizeof(digest_buf) ||
+        digests_len + digest_bytes > HASH_CMD_BATCH_MAX_DIGEST_BYTES) {
+      return INVALID_ARGUMENT();
+    }
+
+    otcrypto_const_byte_buf_t input_message = {
+        .len = uj_batch.message_lens[i],
+        .data = msg,
+    };
+    otcrypto_hash_digest_t digest = {
+        .data = digest_buf,
+        .mode = params.mode,
+        .len = params.digest_len,
+    };
+    otcrypto_status_t status = params.hash_oneshot(input_message, digest);
+    if (status.value != kOtcryptoStatusValueOk) {
+      LOG_ERROR("Bad status value: 0x%x", status.value);
+      return INTERNAL(status.value);
+    }
+
+    batch_hex_encode((const uint8_t *)digest_buf, digest_bytes, out);
+    out += 2 * digest_bytes;
+    digests_len += digest_bytes;
+    uj_batch_output.digest_lens[i] = (uint16_t)digest_bytes;
+    msg += uj_batch.message_lens[i];
+  }
+  *out = '\0';
+  uj_batch_output.count = uj_batch.count;
+
+  RESP_OK(ujson_serialize_cryptotest_hash_batch_output_t, uj,
+          &uj_batch_output);
+  return OK_STATUS(0);
+}
@@ -10,4 +10,10 @@
 
 status_t handle_hash(ujson_t *uj);
 
+/**
+ * Hashes a batch of messages with one algorithm and returns all digests in
+ * one response.
+ */
+status_t handle_hash_batch(ujson_t *uj);
+
 #endif  // OPENTITAN_SW_DEVICE_TESTS_CRYPTO_CRYPTOTEST_FIRMWARE_HASH_H_
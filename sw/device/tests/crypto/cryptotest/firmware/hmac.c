@@ -11,6 +11,7 @@
 #include "sw/device/lib/runtime/log.h"
 #include "sw/device/lib/testing/test_framework/ujson_ottf.h"
 #include "sw/device/lib/ujson/ujson.h"
+#include "sw/device/tests/crypto/cryptotest/firmware/batch.h"
 #include "sw/device/tests/crypto/cryptotest/json/hmac_commands.h"
 
 const unsigned int kOtcryptoHmacTagBytesSha256 = 32;
@@ -33,46 +34,53 @@ static const uint32_t kTestMask[48] = {
     0xA5D39BD2, 0xAB479AD5, 0x5786D029, 0x2E4B7CD7, 0xB77A3D76, 0xE2A09962,
 };
 
-status_t handle_hmac(ujson_t *uj) {
-  // Declare test arguments
-  cryptotest_hmac_hash_alg_t uj_hash_alg;
-  cryptotest_hmac_key_t uj_key;
-  cryptotest_hmac_message_t uj_message;
-  // Deserialize test arguments from UART
-  TRY(ujson_deserialize_cryptotest_hmac_hash_alg_t(uj, &uj_hash_alg));
-  TRY(ujson_deserialize_cryptotest_hmac_key_t(uj, &uj_key));
-  TRY(ujson_deserialize_cryptotest_hmac_message_t(uj, &uj_message));
-
+/**
+ * Computes one HMAC tag.
+ *
+ * @param hash_alg Hash algorithm.
+ * @param key_bytes Key.
+ * @param key_len Key length in bytes.
+ * @param message Message.
+ * @param[out] tag_buf Tag, `MaxTagWords` words.
+ * @param[out] tag_bytes Tag length in bytes.
+ * @return OK or an error.
+ */
+static status_t hmac_compute(cryptotest_hmac_hash_alg_t hash_alg,
+                             const uint8_t *key_bytes, size_t key_len,
+                             otcrypto_const_byte_buf_t message,
+                             uint32_t *tag_buf, size_t *tag_bytes) {
   otcrypto_key_mode_t key_mode;
-  unsigned int tag_bytes;
-  switch (uj_hash_alg) {
+  switch (hash_alg) {
     case kCryptotestHmacHashAlgSha256:
       key_mode = kOtcryptoKeyModeHmacSha256;
-      tag_bytes = kOtcryptoHmacTagBytesSha256;
+      *tag_bytes = kOtcryptoHmacTagBytesSha256;
       break;
     case kCryptotestHmacHashAlgSha384:
       key_mode = kOtcryptoKeyModeHmacSha384;
-      tag_bytes = kOtcryptoHmacTagBytesSha384;
+      *tag_bytes = kOtcryptoHmacTagBytesSha384;
       break;
     case kCryptotestHmacHashAlgSha512:
       key_mode = kOtcryptoKeyModeHmacSha512;
-      tag_bytes = kOtcryptoHmacTagBytesSha512;
+      *tag_bytes = kOtcryptoHmacTagBytesSha512;
       break;
     default:
-      LOG_ERROR("Unsupported HMAC key mode: %d", uj_hash_alg);
+      LOG_ERROR("Unsupported HMAC key mode: %d", hash_alg);
       return INVALID_ARGUMENT();
   }
+  if (key_len > sizeof(kTestMask)) {
+    return INVALID_ARGUMENT();
+  }
   // Build the key configuration
   otcrypto_key_config_t config = {
       .version = kOtcryptoLibVersion1,
       .key_mode = key_mode,
-      .key_length = uj_key.key_len,
+      .key_length = key_len,
       .hw_backed = kHardenedBoolFalse,
       .security_level = kOtcryptoKeySecurityLevelLow,
   };
   // Create buffer to store key
-  uint32_t key_buf[uj_key.key_len];
-  memcpy(key_buf, uj_key.key, uj_key.key_len);
+  uint32_t key_buf[ARRAYSIZE(kTestMask)];
+  memcpy(key_buf, key_bytes, key_len);
   // Create keyblob
   uint32_t keyblob[keyblob_num_words(config)];
   // Create blinded key
@@ -82,6 +90,29 @@ status_t handle_hmac(ujson_t *uj) {
       .keyblob_length = sizeof(keyblob),
       .keyblob = keyblob,
   };
+  key.checksum = integrity_blinded_checksum(&key);
+
+  // Create tag
+  otcrypto_word32_buf_t tag = {
+      .len = *tag_bytes / sizeof(uint32_t),
+      .data = tag_buf,
+  };
+  otcrypto_status_t status = otcrypto_hmac(&key, message, tag);
+  if (status.value != kOtcryptoStatusValueOk) {
+    return INTERNAL(status.value);
+  }
+  return OK_STATUS();
+}
+
+status_t handle_hmac(ujson_t *uj) {
+  // Declare test arguments
+  cryptotest_hmac_hash_alg_t uj_hash_alg;
+  cryptotest_hmac_key_t uj_key;
+  cryptotest_hmac_message_t uj_message;
+  // Deserialize test arguments from UART
+  TRY(ujson_deserialize_cryptotest_hmac_hash_alg_t(uj, &uj_hash_alg));
+  TRY(ujson_deserialize_cryptotest_hmac_key_t(uj, &uj_key));
+  TRY(ujson_deserialize_cryptotest_hmac_message_t(uj, &uj_message));
 
   // Create input message
   uint8_t msg_buf[uj_message.message_len];
@@ -91,16 +122,10 @@ status_t handle_hmac(ujson_t *uj) {
       .data = msg_buf,
   };
 
-  // Create tag
   uint32_t tag_buf[MaxTagWords];
-  otcrypto_word32_buf_t tag = {
-      .len = tag_bytes / sizeof(uint32_t),
-      .data = tag_buf,
-  };
-  otcrypto_status_t status = otcrypto_hmac(&key, input_message, tag);
-  if (status.value != kOtcryptoStatusValueOk) {
-    return INTERNAL(status.value);
-  }
+  size_t tag_bytes;
+  TRY(hmac_compute(uj_hash_alg, uj_key.key, uj_key.key_len, input_message,
+                   tag_buf, &tag_bytes));
   // Copy tag to uJSON type
   cryptotest_hmac_tag_t uj_tag;
   memcpy(uj_tag.tag, tag_buf, tag_bytes);
@@ -110,3 +135,57 @@ status_t handle_hmac(ujson_t *uj) {
   RESP_OK(ujson_serialize_cryptotest_hmac_tag_t, uj, &uj_tag);
   return OK_STATUS(0);
 }
+
+// Batch buffers; static to keep them off the stack.
+static cryptotest_hmac_batch_t uj_batch;
+static cryptotest_hmac_batch_output_t uj_batch_output;
+static uint8_t batch_keys[HMAC_CMD_BATCH_MAX_KEY_BYTES];
+static uint8_t batch_messages[HMAC_CMD_BATCH_MAX_MESSAGE_BYTES];
+
+status_t handle_hmac_batch(ujson_t *uj) {
+  cryptotest_hmac_hash_alg_t uj_hash_alg;
+  TRY(ujson_deserialize_cryptotest_hmac_hash_alg_t(uj, &uj_hash_alg));
+  TRY(ujson_deserialize_cryptotest_hmac_batch_t(uj, &uj_batch));
+  if (uj_batch.count > HMAC_CMD_BATCH_MAX_VECTORS) {
+    return INVALID_ARGUMENT();
+  }
+
+  // Decode all keys and messages up front.
+  size_t keys_len = 0;
+  size_t messages_len = 0;
+  for (size_t i = 0; i < uj_batch.count; i++) {
+    keys_len += uj_batch.key_lens[i];
+    messages_len += uj_batch.message_lens[i];
+  }
+  if (keys_len > HMAC_CMD_BATCH_MAX_KEY_BYTES ||
+      messages_len > HMAC_CMD_BATCH_MAX_MESSAGE_BYTES) {
+    return INVALID_ARGUMENT();
+  }
+  TRY(batch_hex_decode(uj_batch.keys, keys_len, batch_keys));
+  TRY(batch_hex_decode(uj_batch.messages, messages_len, batch_messages));
+
+  const uint8_t *key = batch_keys;
+  const uint8_t *msg = batch_messages;
+  char *out = uj_batch_output.tags;
+  size_t tag_bytes = 0;
+  for (size_t i = 0; i < uj_batch.count; i++) {
+    otcrypto_const_byte_buf_t input_message = {
+        .len = uj_batch.message_lens[i],
+        .data = msg,
+    };
+    uint32_t tag_buf[MaxTagWords];
+    TRY(hmac_compute(uj_hash_alg, key, uj_batch.key_lens[i], input_message,
+                     tag_buf, &tag_bytes));
+    batch_hex_encode((const uint8_t *)tag_buf, tag_bytes, out);
+    out += 2 * tag_bytes;
+    key += uj_batch.key_lens[i];
+    msg += uj_batch.message_lens[i];
+  }
+  *out = '\0';
+  uj_batch_output.count = uj_batch.count;
+  uj_batch_output.tag_len = tag_bytes;
+
+  RESP_OK(ujson_serialize_cryptotest_hmac_batch_output_t, uj,
+          &uj_batch_output);
+  return OK_STATUS(0);
+}
@@ -10,4 +10,10 @@
 
 status_t handle_hmac(ujson_t *uj);
 
+/**
+ * Computes HMAC tags for a batch of (key, message) pairs with one hash
+ * algorithm and returns all tags in one response.
+ */
+status_t handle_hmac_batch(ujson_t *uj);
+
 #endif  // OPENTITAN_SW_DEVICE_TESTS_CRYPTO_CRYPTOTEST_FIRMWARE_HMAC_H_
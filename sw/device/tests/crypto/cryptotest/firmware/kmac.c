@@ -85,6 +85,7 @@ status_t handle_kmac(ujson_t *uj) {
       .keyblob_length = sizeof(keyblob),
       .keyblob = keyblob,
   };
+  key.checksum = integrity_blinded_checksum(&key);
 
   // Create input message
   uint8_t msg_buf[uj_message.message_len];
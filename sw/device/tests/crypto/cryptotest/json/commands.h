@@ -19,7 +19,9 @@ extern "C" {
     value(_, Hash) \
     value(_, Hmac) \
     value(_, Kmac) \
-    value(_, SphincsPlus)
+    value(_, SphincsPlus) \
+    value(_, HashBatch) \
+    value(_, HmacBatch)
 UJSON_SERDE_ENUM(CryptotestCommand, cryptotest_cmd_t, COMMAND);
 
 // clang-format on
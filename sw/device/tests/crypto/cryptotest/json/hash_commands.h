@@ -12,6 +12,9 @@ extern "C" {
 #define HASH_CMD_MAX_MESSAGE_BYTES 17068
 #define HASH_CMD_MAX_CUSTOMIZATION_STRING_BYTES 16
 #define HASH_CMD_MAX_DIGEST_BYTES 256
+#define HASH_CMD_BATCH_MAX_VECTORS 32
+#define HASH_CMD_BATCH_MAX_MESSAGE_BYTES 4096
+#define HASH_CMD_BATCH_MAX_DIGEST_BYTES 2048
 
 // clang-format off
 
@@ -46,6 +49,22 @@ UJSON_SERDE_STRUCT(CryptotestHashMessage, cryptotest_hash_message_t, HASH_MESSAG
     field(digest_len, size_t)
 UJSON_SERDE_STRUCT(CryptotestHashOutput, cryptotest_hash_output_t, HASH_OUTPUT);
 
+// Batched hashing: `messages` holds the hex-encoded messages back to back and
+// `digest_lens` is only used for the XOFs. cSHAKE is not supported.
+#define HASH_BATCH(field, string) \
+    field(count, size_t) \
+    field(message_lens, uint16_t, HASH_CMD_BATCH_MAX_VECTORS) \
+    field(digest_lens, uint16_t, HASH_CMD_BATCH_MAX_VECTORS) \
+    string(messages, 2 * HASH_CMD_BATCH_MAX_MESSAGE_BYTES + 1)
+UJSON_SERDE_STRUCT(CryptotestHashBatch, cryptotest_hash_batch_t, HASH_BATCH);
+
+// Results of a batch: the hex-encoded digests back to back.
+#define HASH_BATCH_OUTPUT(field, string) \
+    field(count, size_t) \
+    field(digest_lens, uint16_t, HASH_CMD_BATCH_MAX_VECTORS) \
+    string(digests, 2 * HASH_CMD_BATCH_MAX_DIGEST_BYTES + 1)
+UJSON_SERDE_STRUCT(CryptotestHashBatchOutput, cryptotest_hash_batch_output_t, HASH_BATCH_OUTPUT);
+
 // clang-format on
 
 #ifdef __cplusplus
@@ -12,6 +12,9 @@ extern "C" {
 #define HMAC_CMD_MAX_MESSAGE_BYTES 256
 #define HMAC_CMD_MAX_KEY_BYTES 192
 #define HMAC_CMD_MAX_TAG_BYTES 64
+#define HMAC_CMD_BATCH_MAX_VECTORS 32
+#define HMAC_CMD_BATCH_MAX_KEY_BYTES 2048
+#define HMAC_CMD_BATCH_MAX_MESSAGE_BYTES 4096
 
 // clang-format off
 
@@ -39,6 +42,23 @@ UJSON_SERDE_STRUCT(CryptotestHmacKey, cryptotest_hmac_key_t, HMAC_KEY);
     field(tag_len, size_t)
 UJSON_SERDE_STRUCT(CryptotestHmacTag, cryptotest_hmac_tag_t, HMAC_TAG);
 
+// Batched HMAC: `keys` and `messages` hold the hex-encoded keys and messages
+// back to back. Each key is at most HMAC_CMD_MAX_KEY_BYTES long.
+#define HMAC_BATCH(field, string) \
+    field(count, size_t) \
+    field(key_lens, uint16_t, HMAC_CMD_BATCH_MAX_VECTORS) \
+    field(message_lens, uint16_t, HMAC_CMD_BATCH_MAX_VECTORS) \
+    string(keys, 2 * HMAC_CMD_BATCH_MAX_KEY_BYTES + 1) \
+    string(messages, 2 * HMAC_CMD_BATCH_MAX_MESSAGE_BYTES + 1)
+UJSON_SERDE_STRUCT(CryptotestHmacBatch, cryptotest_hmac_batch_t, HMAC_BATCH);
+
+// Results of a batch: the hex-encoded tags, `tag_len` bytes each.
+#define HMAC_BATCH_OUTPUT(field, string) \
+    field(count, size_t) \
+    field(tag_len, size_t) \
+    string(tags, 2 * HMAC_CMD_BATCH_MAX_VECTORS * HMAC_CMD_MAX_TAG_BYTES + 1)
+UJSON_SERDE_STRUCT(CryptotestHmacBatchOutput, cryptotest_hmac_batch_output_t, HMAC_BATCH_OUTPUT);
+
 // clang-format on
 
 #ifdef __cplusplus
@@ -79,6 +79,68 @@ static status_t random_test(void) {
       kRandomnessQualitySignificanceOnePercent);
 }
 
+static status_t pool_test(void) {
+  // Instantiate DRBG and enable the output pool.
+  TRY(otcrypto_drbg_instantiate(/*perso_string=*/kEmptyBuffer));
+  TRY(otcrypto_drbg_pool_enable(kHardenedBoolTrue));
+
+  // Draw output in small requests, which are served from the pool.
+  uint32_t output_data[256];
+  for (size_t i = 0; i < ARRAYSIZE(output_data); i += 2) {
+    otcrypto_word32_buf_t output = {
+        .data = &output_data[i],
+        .len = 2,
+    };
+    TRY(otcrypto_drbg_generate(/*additional_input=*/kEmptyBuffer, output));
+  }
+  TRY(randomness_quality_monobit_test(
+      (unsigned char *)output_data, sizeof(output_data),
+      kRandomnessQualitySignificanceOnePercent));
+
+  // Deterministic mode must not be affected by the pool.
+  TRY(kat_test());
+
+  // FIPS checks still apply to output served from the pool.
+  otcrypto_word32_buf_t output = {
+      .data = output_data,
+      .len = 1,
+  };
+  TRY_CHECK(!status_ok(
+      otcrypto_drbg_generate(/*additional_input=*/kEmptyBuffer, output)));
+
+  TRY(otcrypto_drbg_pool_enable(kHardenedBoolFalse));
+  return otcrypto_drbg_instantiate(/*perso_string=*/kEmptyBuffer);
+}
+
+static status_t async_test(void) {
+  // Instantiate DRBG.
+  TRY(otcrypto_drbg_instantiate(/*perso_string=*/kEmptyBuffer));
+
+  uint32_t output_data[1024];
+  otcrypto_word32_buf_t output = {
+      .data = output_data,
+      .len = ARRAYSIZE(output_data),
+  };
+  TRY(otcrypto_drbg_generate_async_start(/*additional_input=*/kEmptyBuffer,
+                                         ARRAYSIZE(output_data)));
+
+  // Only one operation can be in progress at a time.
+  TRY_CHECK(!status_ok(otcrypto_drbg_generate_async_start(
+      /*additional_input=*/kEmptyBuffer, ARRAYSIZE(output_data))));
+
+  // The output buffer must match the requested length.
+  otcrypto_word32_buf_t short_output = {
+      .data = output_data,
+      .len = ARRAYSIZE(output_data) - 1,
+  };
+  TRY_CHECK(!status_ok(otcrypto_drbg_generate_async_finalize(short_output)));
+
+  TRY(otcrypto_drbg_generate_async_finalize(output));
+  return randomness_quality_monobit_test(
+      (unsigned char *)output_data, sizeof(output_data),
+      kRandomnessQualitySignificanceOnePercent);
+}
+
 bool test_main(void) {
   status_t result = OK_STATUS();
 
@@ -88,5 +150,7 @@ bool test_main(void) {
 
   EXECUTE_TEST(result, kat_test);
   EXECUTE_TEST(result, random_test);
+  EXECUTE_TEST(result, pool_test);
+  EXECUTE_TEST(result, async_test);
   return status_ok(result);
 }
@@ -131,12 +131,92 @@ status_t key_exchange_test(void) {
   return OTCRYPTO_OK;
 }
 
+status_t ephemeral_key_exchange_test(void) {
+  // Allocate space for B's static keypair.
+  uint32_t keyblobB[keyblob_num_words(kEcdhPrivateKeyConfig)];
+  otcrypto_blinded_key_t private_keyB = {
+      .config = kEcdhPrivateKeyConfig,
+      .keyblob_length = sizeof(keyblobB),
+      .keyblob = keyblobB,
+      .checksum = 0,
+  };
+  uint32_t pkB[kP256PublicKeyWords] = {0};
+  otcrypto_unblinded_key_t public_keyB = {
+      .key_mode = kOtcryptoKeyModeEcdhP256,
+      .key_length = sizeof(pkB),
+      .key = pkB,
+  };
+
+  // Allocate space for A's ephemeral public key.
+  uint32_t pkA[kP256PublicKeyWords] = {0};
+  otcrypto_unblinded_key_t public_keyA = {
+      .key_mode = kOtcryptoKeyModeEcdhP256,
+      .key_length = sizeof(pkA),
+      .key = pkA,
+  };
+
+  // Generate B's keypair.
+  LOG_INFO("Generating keypair B...");
+  TRY(otcrypto_ecdh_p256_keygen(&private_keyB, &public_keyB));
+
+  // Allocate space for two shared keys.
+  uint32_t shared_keyblobA[keyblob_num_words(kEcdhSharedKeyConfig)];
+  otcrypto_blinded_key_t shared_keyA = {
+      .config = kEcdhSharedKeyConfig,
+      .keyblob_length = sizeof(shared_keyblobA),
+      .keyblob = shared_keyblobA,
+      .checksum = 0,
+  };
+  uint32_t shared_keyblobB[keyblob_num_words(kEcdhSharedKeyConfig)];
+  otcrypto_blinded_key_t shared_keyB = {
+      .config = kEcdhSharedKeyConfig,
+      .keyblob_length = sizeof(shared_keyblobB),
+      .keyblob = shared_keyblobB,
+      .checksum = 0,
+  };
+
+  // Generate A's ephemeral keypair and the shared secret from A's side in one
+  // operation.
+  LOG_INFO("Generating ephemeral keypair and shared secret (A)...");
+  TRY(otcrypto_ecdh_p256_ephemeral(&public_keyB, &public_keyA, &shared_keyA));
+
+  // Sanity check; public keys should be different from each other.
+  CHECK_ARRAYS_NE(pkA, pkB, ARRAYSIZE(pkA));
+
+  // Compute the shared secret from B's side of the computation (using B's
+  // private key and A's ephemeral public key).
+  LOG_INFO("Generating shared secret (B)...");
+  TRY(otcrypto_ecdh_p256(&private_keyB, &public_keyA, &shared_keyB));
+
+  // Get pointers to individual shares of both shared keys.
+  uint32_t *keyA0;
+  uint32_t *keyA1;
+  TRY(keyblob_to_shares(&shared_keyA, &keyA0, &keyA1));
+  uint32_t *keyB0;
+  uint32_t *keyB1;
+  TRY(keyblob_to_shares(&shared_keyB, &keyB0, &keyB1));
+
+  // Unmask the keys and check that they match.
+  uint32_t keyA[kP256SharedKeyWords];
+  uint32_t keyB[kP256SharedKeyWords];
+  for (size_t i = 0; i < ARRAYSIZE(keyA); i++) {
+    keyA[i] = keyA0[i] ^ keyA1[i];
+    keyB[i] = keyB0[i] ^ keyB1[i];
+  }
+  CHECK_ARRAYS_EQ(keyA, keyB, ARRAYSIZE(keyA));
+
+  return OTCRYPTO_OK;
+}
+
 OTTF_DEFINE_TEST_CONFIG();
 
 bool test_main(void) {
   CHECK_STATUS_OK(entropy_testutils_auto_mode_init());
 
   status_t err = key_exchange_test();
+  if (status_ok(err)) {
+    err = ephemeral_key_exchange_test();
+  }
   if (!status_ok(err)) {
     // If there was an error, print the OTBN error bits and instruction count.
     LOG_INFO("OTBN error bits: 0x%08x", otbn_err_bits_get());
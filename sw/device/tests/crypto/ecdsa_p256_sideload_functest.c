@@ -102,6 +102,62 @@ status_t sign_then_verify_test(void) {
   return OK_STATUS();
 }
 
+status_t sign_in_session_test(void) {
+  // Allocate space for a hardware-backed key.
+  uint32_t keyblob[keyblob_num_words(kPrivateKeyConfig)];
+  otcrypto_blinded_key_t private_key = {
+      .config = kPrivateKeyConfig,
+      .keyblob_length = sizeof(keyblob),
+      .keyblob = keyblob,
+  };
+  TRY(otcrypto_hw_backed_key(kPrivateKeyVersion, kPrivateKeySalt,
+                             &private_key));
+
+  // Pin the key for the whole sequence of operations.
+  TRY(otcrypto_sideload_session_start(&private_key));
+
+  uint32_t pk[kP256PublicKeyWords] = {0};
+  otcrypto_unblinded_key_t public_key = {
+      .key_mode = kOtcryptoKeyModeEcdsaP256,
+      .key_length = sizeof(pk),
+      .key = pk,
+  };
+  TRY(otcrypto_ecdsa_p256_keygen(&private_key, &public_key));
+
+  otcrypto_const_byte_buf_t message = {
+      .len = sizeof(kMessage) - 1,
+      .data = (unsigned char *)&kMessage,
+  };
+  uint32_t message_digest_data[kSha256DigestWords];
+  otcrypto_hash_digest_t message_digest = {
+      .data = message_digest_data,
+      .len = ARRAYSIZE(message_digest_data),
+      .mode = kOtcryptoHashModeSha256,
+  };
+  TRY(otcrypto_hash(message, message_digest));
+
+  // Sign several times; only the first operation derives the key.
+  for (size_t i = 0; i < 3; i++) {
+    LOG_INFO("Signing in session (%d)...", i);
+    uint32_t sig[kP256SignatureWords] = {0};
+    TRY(otcrypto_ecdsa_p256_sign(
+        &private_key, message_digest,
+        (otcrypto_word32_buf_t){.data = sig, .len = ARRAYSIZE(sig)}));
+
+    hardened_bool_t verification_result;
+    TRY(otcrypto_ecdsa_p256_verify(
+        &public_key, message_digest,
+        (otcrypto_const_word32_buf_t){.data = sig, .len = ARRAYSIZE(sig)},
+        &verification_result));
+    TRY_CHECK(verification_result == kHardenedBoolTrue);
+  }
+
+  // Only one session at a time.
+  TRY_CHECK(otcrypto_sideload_session_start(&private_key).value ==
+            OTCRYPTO_BAD_ARGS.value);
+  return otcrypto_sideload_session_end();
+}
+
 static status_t test_setup(void) {
   // Initialize the key manager and advance to OwnerRootKey state.  Note: the
   // keymgr testutils set this up using software entropy, so there is no need
@@ -134,6 +190,7 @@ bool test_main(void) {
 
   CHECK_STATUS_OK(test_setup());
   EXECUTE_TEST(result, sign_then_verify_test);
+  EXECUTE_TEST(result, sign_in_session_test);
 
   return status_ok(result);
 }
@@ -48,6 +48,51 @@ status_t ecdsa_p256_verify_test(
   return OTCRYPTO_OK;
 }
 
+enum {
+  /**
+   * Number of test vectors per batch; spans more than one OTBN run.
+   */
+  kBatchSize = 2 * kP256BatchVerifyMaxItems + 1,
+};
+
+status_t ecdsa_p256_verify_batch_test(size_t first, size_t num_items) {
+  uint32_t digest_bufs[kBatchSize][kSha256DigestWords];
+  p256_ecdsa_verify_item_t items[kBatchSize];
+  hardened_bool_t results[kBatchSize];
+  for (size_t i = 0; i < num_items; i++) {
+    const ecdsa_p256_verify_test_vector_t *testvec =
+        &ecdsa_p256_verify_tests[first + i];
+    otcrypto_const_byte_buf_t msg_buf = {
+        .data = testvec->msg,
+        .len = testvec->msg_len,
+    };
+    otcrypto_hash_digest_t digest = {
+        .mode = kOtcryptoHashModeSha256,
+        .data = digest_bufs[i],
+        .len = kSha256DigestWords,
+    };
+    TRY(otcrypto_hash(msg_buf, digest));
+    items[i].signature = &testvec->signature;
+    items[i].digest = digest_bufs[i];
+    items[i].public_key = &testvec->public_key;
+  }
+
+  TRY(p256_ecdsa_verify_batch(items, num_items, results));
+
+  for (size_t i = 0; i < num_items; i++) {
+    hardened_bool_t expected = ecdsa_p256_verify_tests[first + i].valid
+                                   ? kHardenedBoolTrue
+                                   : kHardenedBoolFalse;
+    if (results[i] != expected) {
+      LOG_ERROR("Batch verification of test vector %d gave the wrong result.",
+                first + i + 1);
+      return OTCRYPTO_RECOV_ERR;
+    }
+  }
+
+  return OTCRYPTO_OK;
+}
+
 OTTF_DEFINE_TEST_CONFIG();
 
 bool test_main(void) {
@@ -77,6 +122,18 @@ bool test_main(void) {
       result = false;
     }
   }
+  for (size_t i = 0; i < kEcdsaP256VerifyNumTests; i += kBatchSize) {
+    size_t num_items = kEcdsaP256VerifyNumTests - i;
+    if (num_items > kBatchSize) {
+      num_items = kBatchSize;
+    }
+    status_t err = ecdsa_p256_verify_batch_test(i, num_items);
+    if (!status_ok(err)) {
+      LOG_ERROR("ecdsa_p256_verify_batch_test from test vector %d : error %r",
+                i + 1, err);
+      result = false;
+    }
+  }
   LOG_INFO("Finished ecdsa_p256_verify_test:%s", RULE_NAME);
 
   return result;
@@ -0,0 +1,186 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "sw/device/lib/base/memory.h"
+#include "sw/device/lib/crypto/drivers/otbn.h"
+#include "sw/device/lib/crypto/impl/integrity.h"
+#include "sw/device/lib/crypto/impl/keyblob.h"
+#include "sw/device/lib/crypto/include/datatypes.h"
+#include "sw/device/lib/crypto/include/ed25519.h"
+#include "sw/device/lib/runtime/log.h"
+#include "sw/device/lib/testing/entropy_testutils.h"
+#include "sw/device/lib/testing/profile.h"
+#include "sw/device/lib/testing/test_framework/check.h"
+#include "sw/device/lib/testing/test_framework/ottf_main.h"
+
+enum {
+  /* Number of bytes in an Ed25519 private key (seed). */
+  kEd25519PrivateKeyBytes = 256 / 8,
+  /* Number of 32-bit words in an Ed25519 public key. */
+  kEd25519PublicKeyWords = 256 / 32,
+  /* Number of 32-bit words in an Ed25519 signature. */
+  kEd25519SignatureWords = 512 / 32,
+  /* Number of signatures in the batch verification test. */
+  kBatchSize = 3,
+};
+
+static const otcrypto_key_config_t kPrivateKeyConfig = {
+    .version = kOtcryptoLibVersion1,
+    .key_mode = kOtcryptoKeyModeEd25519,
+    .key_length = kEd25519PrivateKeyBytes,
+    .hw_backed = kHardenedBoolFalse,
+    .security_level = kOtcryptoKeySecurityLevelLow,
+};
+
+// RFC 8032, section 7.1, TEST 1 (empty message).
+static const uint8_t kSeed[kEd25519PrivateKeyBytes] = {
+    0x9d, 0x61, 0xb1, 0x9d, 0xef, 0xfd, 0x5a, 0x60, 0xba, 0x84, 0x4a,
+    0xf4, 0x92, 0xec, 0x2c, 0xc4, 0x44, 0x49, 0xc5, 0x69, 0x7b, 0x32,
+    0x69, 0x19, 0x70, 0x3b, 0xac, 0x03, 0x1c, 0xae, 0x7f, 0x60,
+};
+static const uint8_t kPublicKey[kEd25519PublicKeyWords * sizeof(uint32_t)] = {
+    0xd7, 0x5a, 0x98, 0x01, 0x82, 0xb1, 0x0a, 0xb7, 0xd5, 0x4b, 0xfe,
+    0xd3, 0xc9, 0x64, 0x07, 0x3a, 0x0e, 0xe1, 0x72, 0xf3, 0xda, 0xa6,
+    0x23, 0x25, 0xaf, 0x02, 0x1a, 0x68, 0xf7, 0x07, 0x51, 0x1a,
+};
+static const uint8_t kSignature[kEd25519SignatureWords * sizeof(uint32_t)] = {
+    0xe5, 0x56, 0x43, 0x00, 0xc3, 0x60, 0xac, 0x72, 0x90, 0x86, 0xe2,
+    0xcc, 0x80, 0x6e, 0x82, 0x8a, 0x84, 0x87, 0x7f, 0x1e, 0xb8, 0xe5,
+    0xd9, 0x74, 0xd8, 0x73, 0xe0, 0x65, 0x22, 0x49, 0x01, 0x55, 0x5f,
+    0xb8, 0x82, 0x15, 0x90, 0xa3, 0x3b, 0xac, 0xc6, 0x1e, 0x39, 0x70,
+    0x1c, 0xf9, 0xb4, 0x6b, 0xd2, 0x5b, 0xf5, 0xf0, 0x59, 0x5b, 0xbe,
+    0x24, 0x65, 0x51, 0x41, 0x43, 0x8e, 0x7a, 0x10, 0x0b,
+};
+
+// Message for the keygen and batch tests.
+static const char kMessage[] = "test message";
+
+static status_t known_answer_test(void) {
+  // Import the seed, split into shares.
+  uint32_t share0[keyblob_share_num_words(kPrivateKeyConfig)];
+  uint32_t share1[keyblob_share_num_words(kPrivateKeyConfig)];
+  memset(share0, 0, sizeof(share0));
+  memset(share1, 0, sizeof(share1));
+  memcpy(share0, kSeed, sizeof(kSeed));
+  uint32_t keyblob[keyblob_num_words(kPrivateKeyConfig)];
+  keyblob_from_shares(share0, share1, kPrivateKeyConfig, keyblob);
+  otcrypto_blinded_key_t private_key = {
+      .config = kPrivateKeyConfig,
+      .keyblob_length = sizeof(keyblob),
+      .keyblob = keyblob,
+  };
+  private_key.checksum = integrity_blinded_checksum(&private_key);
+
+  uint32_t sig[kEd25519SignatureWords] = {0};
+  otcrypto_const_byte_buf_t msg = {.data = NULL, .len = 0};
+  uint64_t t_start = profile_start();
+  TRY(otcrypto_ed25519_sign(
+      &private_key, msg, kOtcryptoEddsaSignModeEddsa,
+      (otcrypto_word32_buf_t){.data = sig, .len = ARRAYSIZE(sig)}));
+  profile_end_and_print(t_start, "Ed25519 sign");
+  TRY_CHECK_ARRAYS_EQ((uint8_t *)sig, kSignature, sizeof(kSignature));
+
+  uint32_t pk[kEd25519PublicKeyWords];
+  memcpy(pk, kPublicKey, sizeof(pk));
+  otcrypto_unblinded_key_t public_key = {
+      .key_mode = kOtcryptoKeyModeEd25519,
+      .key_length = sizeof(pk),
+      .key = pk,
+  };
+  public_key.checksum = integrity_unblinded_checksum(&public_key);
+
+  hardened_bool_t result;
+  t_start = profile_start();
+  TRY(otcrypto_ed25519_verify(
+      &public_key, msg, kOtcryptoEddsaSignModeEddsa,
+      (otcrypto_const_word32_buf_t){.data = sig, .len = ARRAYSIZE(sig)},
+      &result));
+  profile_end_and_print(t_start, "Ed25519 verify");
+  TRY_CHECK(result == kHardenedBoolTrue);
+
+  // A corrupted R must fail verification.
+  sig[0] ^= 1;
+  TRY(otcrypto_ed25519_verify(
+      &public_key, msg, kOtcryptoEddsaSignModeEddsa,
+      (otcrypto_const_word32_buf_t){.data = sig, .len = ARRAYSIZE(sig)},
+      &result));
+  TRY_CHECK(result == kHardenedBoolFalse);
+
+  return OTCRYPTO_OK;
+}
+
+static status_t keygen_sign_verify_batch_test(void) {
+  // Generate a keypair.
+  uint32_t keyblob[keyblob_num_words(kPrivateKeyConfig)];
+  otcrypto_blinded_key_t private_key = {
+      .config = kPrivateKeyConfig,
+      .keyblob_length = sizeof(keyblob),
+      .keyblob = keyblob,
+  };
+  uint32_t pk[kEd25519PublicKeyWords] = {0};
+  otcrypto_unblinded_key_t public_key = {
+      .key_mode = kOtcryptoKeyModeEd25519,
+      .key_length = sizeof(pk),
+      .key = pk,
+  };
+  uint64_t t_start = profile_start();
+  TRY(otcrypto_ed25519_keygen(&private_key, &public_key));
+  profile_end_and_print(t_start, "Ed25519 keygen");
+
+  // Sign the same message several times; Ed25519 is deterministic, so all the
+  // signatures are equal. Corrupt the middle one.
+  otcrypto_const_byte_buf_t msg = {
+      .data = (const uint8_t *)kMessage,
+      .len = sizeof(kMessage) - 1,
+  };
+  uint32_t sigs[kBatchSize][kEd25519SignatureWords];
+  for (size_t i = 0; i < kBatchSize; i++) {
+    TRY(otcrypto_ed25519_sign(
+        &private_key, msg, kOtcryptoEddsaSignModeEddsa,
+        (otcrypto_word32_buf_t){.data = sigs[i], .len = ARRAYSIZE(sigs[i])}));
+  }
+  TRY_CHECK_ARRAYS_EQ(sigs[0], sigs[2], kEd25519SignatureWords);
+  sigs[1][kEd25519SignatureWords - 1] ^= 1;
+
+  const otcrypto_unblinded_key_t *public_keys[kBatchSize] = {
+      &public_key, &public_key, &public_key};
+  const otcrypto_const_byte_buf_t msgs[kBatchSize] = {msg, msg, msg};
+  const otcrypto_const_word32_buf_t sig_bufs[kBatchSize] = {
+      {.data = sigs[0], .len = kEd25519SignatureWords},
+      {.data = sigs[1], .len = kEd25519SignatureWords},
+      {.data = sigs[2], .len = kEd25519SignatureWords},
+  };
+  hardened_bool_t results[kBatchSize];
+  t_start = profile_start();
+  TRY(otcrypto_ed25519_verify_batch(public_keys, msgs,
+                                    kOtcryptoEddsaSignModeEddsa, sig_bufs,
+                                    kBatchSize, results));
+  profile_end_and_print(t_start, "Ed25519 verify batch of 3");
+  TRY_CHECK(results[0] == kHardenedBoolTrue);
+  TRY_CHECK(results[1] == kHardenedBoolFalse);
+  TRY_CHECK(results[2] == kHardenedBoolTrue);
+
+  return OTCRYPTO_OK;
+}
+
+OTTF_DEFINE_TEST_CONFIG();
+
+bool test_main(void) {
+  CHECK_STATUS_OK(entropy_testutils_auto_mode_init());
+
+  status_t err = known_answer_test();
+  if (status_ok(err)) {
+    err = keygen_sign_verify_batch_test();
+  }
+  if (!status_ok(err)) {
+    // If there was an error, print the OTBN error bits and instruction count.
+    LOG_INFO("OTBN error bits: 0x%08x", otbn_err_bits_get());
+    LOG_INFO("OTBN instruction count: 0x%08x", otbn_instruction_count_get());
+    // Print the error.
+    CHECK_STATUS_OK(err);
+    return false;
+  }
+
+  return true;
+}
@@ -2,6 +2,7 @@
 // Licensed under the Apache License, Version 2.0, see LICENSE for details.
 // SPDX-License-Identifier: Apache-2.0
 
+#include "sw/device/lib/base/memory.h"
 #include "sw/device/lib/crypto/impl/integrity.h"
 #include "sw/device/lib/crypto/include/datatypes.h"
 #include "sw/device/lib/crypto/include/hash.h"
@@ -85,6 +86,19 @@ static status_t run_test_vector(void) {
     case kHmacTestOperationHmacSha512:
       TRY(otcrypto_hmac(&current_test_vector->key, current_test_vector->message,
                         tag_buf));
+      TRY_CHECK_ARRAYS_EQ(act_tag, current_test_vector->digest.data,
+                          digest_len);
+      // The precomputed key state must give the same tag, every time.
+      otcrypto_hmac_keyed_state_t keyed_state;
+      TRY(otcrypto_hmac_keyed_state_init(&keyed_state,
+                                         &current_test_vector->key));
+      for (size_t i = 0; i < 2; i++) {
+        memset(act_tag, 0, sizeof(act_tag));
+        TRY(otcrypto_hmac_keyed(&keyed_state, current_test_vector->message,
+                                tag_buf));
+        TRY_CHECK_ARRAYS_EQ(act_tag, current_test_vector->digest.data,
+                            digest_len);
+      }
       break;
     default:
       return OTCRYPTO_BAD_ARGS;
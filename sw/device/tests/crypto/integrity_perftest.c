@@ -0,0 +1,107 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "sw/device/lib/base/macros.h"
+#include "sw/device/lib/crypto/impl/integrity.h"
+#include "sw/device/lib/runtime/log.h"
+#include "sw/device/lib/testing/profile.h"
+#include "sw/device/lib/testing/test_framework/check.h"
+#include "sw/device/lib/testing/test_framework/ottf_main.h"
+
+// Module ID for status codes.
+#define MODULE_ID MAKE_MODULE_ID('t', 's', 't')
+
+enum {
+  /**
+   * Longest keyblob to time, in words (an RSA-4096 private exponent, masked).
+   */
+  kMaxKeyblobWords = 4096 / 32 * 2,
+};
+
+/**
+ * Keyblob lengths to time, in bytes: AES-128, AES-256, masked P-256 scalar
+ * and RSA-2048 and RSA-4096 private exponents.
+ */
+static const size_t kKeyblobLens[] = {32, 64, 80, 512, kMaxKeyblobWords * 4};
+
+/**
+ * Expected checksum of the AES-256 key in `integrity_perf_test`, computed with
+ * `zlib.crc32` over the same words.
+ */
+static const uint32_t kExpChecksum = 0x9d6d9084;
+
+static uint32_t keyblob[kMaxKeyblobWords];
+
+/**
+ * Name of the checksum backend this test was built with.
+ */
+static const char *backend_name(void) {
+#if defined(OTCRYPTO_INTEGRITY_TABLE) || \
+    !(defined(__riscv_zbc) || defined(__riscv_zbkc))
+  return "4-bit table";
+#else
+  return "clmul";
+#endif
+}
+
+/**
+ * Returns a key over the first `keyblob_len` bytes of `keyblob`.
+ */
+static otcrypto_blinded_key_t make_key(size_t keyblob_len) {
+  return (otcrypto_blinded_key_t){
+      .config =
+          {
+              .version = kOtcryptoLibVersion1,
+              .key_mode = kOtcryptoKeyModeAesCtr,
+              .key_length = 256 / 8,
+              .hw_backed = kHardenedBoolFalse,
+              .exportable = kHardenedBoolFalse,
+              .security_level = kOtcryptoKeySecurityLevelLow,
+          },
+      .keyblob_length = keyblob_len,
+      .keyblob = keyblob,
+  };
+}
+
+/**
+ * Times the checksum and the check that every crypto call makes on its keys.
+ */
+static status_t integrity_perf_test(void) {
+  LOG_INFO("Key checksum backend: %s", backend_name());
+  for (size_t i = 0; i < ARRAYSIZE(keyblob); ++i) {
+    keyblob[i] = 0x01010101 * (i % 16);
+  }
+
+  for (size_t i = 0; i < ARRAYSIZE(kKeyblobLens); ++i) {
+    otcrypto_blinded_key_t key = make_key(kKeyblobLens[i]);
+
+    uint64_t t_start = profile_start();
+    key.checksum = integrity_blinded_checksum(&key);
+    uint32_t checksum_cycles = profile_end(t_start);
+
+    t_start = profile_start();
+    hardened_bool_t ok = integrity_blinded_key_check(&key);
+    uint32_t check_cycles = profile_end(t_start);
+
+    TRY_CHECK(ok == kHardenedBoolTrue);
+    LOG_INFO("Keyblob of %d bytes: checksum %d cycles, check %d cycles",
+             kKeyblobLens[i], checksum_cycles, check_cycles);
+  }
+
+  // Check that the backend is correct and that a flipped bit is detected.
+  otcrypto_blinded_key_t key = make_key(64);
+  key.checksum = integrity_blinded_checksum(&key);
+  TRY_CHECK(key.checksum == kExpChecksum);
+  keyblob[3] ^= 1 << 7;
+  TRY_CHECK(integrity_blinded_key_check(&key) == kHardenedBoolFalse);
+  return OK_STATUS();
+}
+
+OTTF_DEFINE_TEST_CONFIG();
+
+bool test_main(void) {
+  status_t result = OK_STATUS();
+  EXECUTE_TEST(result, integrity_perf_test);
+  return status_ok(result);
+}
@@ -1082,6 +1082,114 @@ static status_t kdf_hmac_ctr_sha512_kdk256_km16_test(void) {
   return run_test(&test);
 }
 
+/**
+ * Key configuration for the outputs of the multi-output test.
+ *
+ * @param key_length Key length in bytes.
+ * @return Key configuration.
+ */
+static otcrypto_key_config_t multi_km_config(size_t key_length) {
+  return (otcrypto_key_config_t){
+      .version = kOtcryptoLibVersion1,
+      .key_mode = kOtcryptoKeyModeAesCtr,
+      .key_length = key_length,
+      .hw_backed = kHardenedBoolFalse,
+      .exportable = kHardenedBoolFalse,
+      .security_level = kOtcryptoKeySecurityLevelLow,
+  };
+}
+
+/**
+ * Multi-output test case:
+ *
+ * Derives the keying material of test case 2 as three keys of 16, 13 and 3
+ * bytes and checks that each key is the corresponding slice.
+ */
+static status_t kdf_hmac_ctr_sha256_multi_test(void) {
+  uint32_t kdk_data[] = {
+      0x0b0b0b0b, 0x0b0b0b0b, 0x0b0b0b0b, 0x0b0b0b0b,
+      0x0b0b0b0b, 0x0b0b0b0b, 0x0b0b0b0b, 0x0b0b0b0b,
+  };
+  uint8_t context_data[] = {
+      0x60, 0x61, 0x62, 0x63, 0x64, 0x65,
+  };
+  uint8_t label_data[] = {
+      0xb0, 0xb1, 0xb2, 0xb3, 0xb4, 0xb5,
+  };
+  uint32_t km_data[] = {
+      0x704bb412, 0x30c07602, 0xf999cd74, 0x4b576387,
+      0x301cf77b, 0x79230234, 0xf5b8f00b, 0x863ccf3f,
+  };
+  const size_t km_bytelens[] = {16, 13, 3};
+
+  otcrypto_key_config_t kdk_config = {
+      .version = kOtcryptoLibVersion1,
+      .key_mode = kOtcryptoKeyModeHmacSha256,
+      .key_length = sizeof(kdk_data),
+      .hw_backed = kHardenedBoolFalse,
+      .exportable = kHardenedBoolFalse,
+      .security_level = kOtcryptoKeySecurityLevelLow,
+  };
+  uint32_t kdk_keyblob[keyblob_num_words(kdk_config)];
+  TRY(keyblob_from_key_and_mask(kdk_data, kTestMask, kdk_config, kdk_keyblob));
+  otcrypto_blinded_key_t kdk = {
+      .config = kdk_config,
+      .keyblob = kdk_keyblob,
+      .keyblob_length = sizeof(kdk_keyblob),
+  };
+  kdk.checksum = integrity_blinded_checksum(&kdk);
+
+  uint32_t km0_keyblob[2 * 4];
+  uint32_t km1_keyblob[2 * 4];
+  uint32_t km2_keyblob[2 * 1];
+  otcrypto_blinded_key_t kms[] = {
+      {
+          .config = multi_km_config(km_bytelens[0]),
+          .keyblob = km0_keyblob,
+          .keyblob_length = sizeof(km0_keyblob),
+      },
+      {
+          .config = multi_km_config(km_bytelens[1]),
+          .keyblob = km1_keyblob,
+          .keyblob_length = sizeof(km1_keyblob),
+      },
+      {
+          .config = multi_km_config(km_bytelens[2]),
+          .keyblob = km2_keyblob,
+          .keyblob_length = sizeof(km2_keyblob),
+      },
+  };
+  otcrypto_blinded_key_t *km_ptrs[] = {&kms[0], &kms[1], &kms[2]};
+
+  otcrypto_const_byte_buf_t context = {
+      .data = context_data,
+      .len = sizeof(context_data),
+  };
+  otcrypto_const_byte_buf_t label = {
+      .data = label_data,
+      .len = sizeof(label_data),
+  };
+  TRY(otcrypto_kdf_hmac_ctr_multi(kdk, label, context, km_ptrs,
+                                  ARRAYSIZE(km_ptrs)));
+
+  // Unmask each key and compare it to its slice of the expected value.
+  const unsigned char *expected = (const unsigned char *)km_data;
+  for (size_t i = 0; i < ARRAYSIZE(kms); i++) {
+    TRY_CHECK(integrity_blinded_key_check(&kms[i]) == kHardenedBoolTrue);
+    uint32_t *km_share0;
+    uint32_t *km_share1;
+    TRY(keyblob_to_shares(&kms[i], &km_share0, &km_share1));
+    uint32_t unmasked_km[keyblob_share_num_words(kms[i].config)];
+    for (size_t j = 0; j < ARRAYSIZE(unmasked_km); j++) {
+      unmasked_km[j] = km_share0[j] ^ km_share1[j];
+    }
+    TRY_CHECK_ARRAYS_EQ((unsigned char *)unmasked_km, expected,
+                        km_bytelens[i]);
+    expected += km_bytelens[i];
+  }
+  return OK_STATUS();
+}
+
 OTTF_DEFINE_TEST_CONFIG();
 
 bool test_main(void) {
@@ -1111,5 +1219,8 @@ bool test_main(void) {
   EXECUTE_TEST(test_result, kdf_hmac_ctr_sha512_kdk256_km256_test);
   EXECUTE_TEST(test_result, kdf_hmac_ctr_sha512_kdk256_km16_test);
 
+  // Multi-output test
+  EXECUTE_TEST(test_result, kdf_hmac_ctr_sha256_multi_test);
+
   return status_ok(test_result);
 }
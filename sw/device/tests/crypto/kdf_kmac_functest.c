@@ -102,6 +102,83 @@ static status_t run_test_vector(void) {
   return OTCRYPTO_OK;
 }
 
+/**
+ * Key configuration for the outputs of the multi-output test.
+ *
+ * @param num_words Key length in 32-bit words.
+ * @return Key configuration.
+ */
+static otcrypto_key_config_t multi_km_config(size_t num_words) {
+  return (otcrypto_key_config_t){
+      // Dummy key mode, as in `run_test_vector()`.
+      .key_mode = kOtcryptoKeyModeKdfKmac128,
+      .key_length = num_words * sizeof(uint32_t),
+      .hw_backed = kHardenedBoolFalse,
+      .security_level = kOtcryptoKeySecurityLevelLow,
+      .exportable = kHardenedBoolTrue,
+  };
+}
+
+/**
+ * Run the test pointed to by `current_test_vector` through the multi-output
+ * API, splitting the keying material into two keys.
+ */
+static status_t run_test_vector_multi(void) {
+  size_t km_num_words = current_test_vector->expected_output.len;
+  if (km_num_words < 2) {
+    // Nothing to split.
+    return OTCRYPTO_OK;
+  }
+  const size_t km_words[2] = {km_num_words / 2,
+                              km_num_words - km_num_words / 2};
+
+  otcrypto_kmac_mode_t mode;
+  TRY(get_kmac_mode(current_test_vector->test_operation, &mode));
+
+  uint32_t km0_keyblob[2 * km_words[0]];
+  uint32_t km1_keyblob[2 * km_words[1]];
+  otcrypto_blinded_key_t kms[] = {
+      {
+          .config = multi_km_config(km_words[0]),
+          .keyblob = km0_keyblob,
+          .keyblob_length = sizeof(km0_keyblob),
+      },
+      {
+          .config = multi_km_config(km_words[1]),
+          .keyblob = km1_keyblob,
+          .keyblob_length = sizeof(km1_keyblob),
+      },
+  };
+  otcrypto_blinded_key_t *km_ptrs[] = {&kms[0], &kms[1]};
+
+  current_test_vector->key_derivation_key.checksum =
+      integrity_blinded_checksum(&current_test_vector->key_derivation_key);
+
+  TRY(otcrypto_kdf_kmac_multi(current_test_vector->key_derivation_key, mode,
+                              current_test_vector->label,
+                              current_test_vector->context, km_ptrs,
+                              ARRAYSIZE(km_ptrs)));
+
+  // Unmask each key and compare it to its slice of the expected value.
+  const uint32_t *expected = current_test_vector->expected_output.data;
+  for (size_t i = 0; i < ARRAYSIZE(kms); i++) {
+    HARDENED_CHECK_EQ(integrity_blinded_key_check(&kms[i]), kHardenedBoolTrue);
+    uint32_t km_share0[km_words[i]];
+    uint32_t km_share1[km_words[i]];
+    TRY(otcrypto_export_blinded_key(
+        kms[i],
+        (otcrypto_word32_buf_t){.data = km_share0, .len = km_words[i]},
+        (otcrypto_word32_buf_t){.data = km_share1, .len = km_words[i]}));
+    uint32_t actual_output[km_words[i]];
+    for (size_t j = 0; j < ARRAYSIZE(actual_output); j++) {
+      actual_output[j] = km_share0[j] ^ km_share1[j];
+    }
+    TRY_CHECK_ARRAYS_EQ(actual_output, expected, km_words[i]);
+    expected += km_words[i];
+  }
+  return OTCRYPTO_OK;
+}
+
 OTTF_DEFINE_TEST_CONFIG();
 bool test_main(void) {
   LOG_INFO("Testing cryptolib KDF-KMAC driver.");
@@ -117,6 +194,7 @@ bool test_main(void) {
              ARRAYSIZE(kKdfTestVectors),
              current_test_vector->vector_identifier);
     EXECUTE_TEST(test_result, run_test_vector);
+    EXECUTE_TEST(test_result, run_test_vector_multi);
   }
   return status_ok(test_result);
 }
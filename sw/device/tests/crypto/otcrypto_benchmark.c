@@ -0,0 +1,1054 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "sw/device/lib/base/macros.h"
+#include "sw/device/lib/base/memory.h"
+#include "sw/device/lib/crypto/drivers/otbn.h"
+#include "sw/device/lib/crypto/impl/integrity.h"
+#include "sw/device/lib/crypto/include/aes.h"
+#include "sw/device/lib/crypto/include/aes_gcm.h"
+#include "sw/device/lib/crypto/include/datatypes.h"
+#include "sw/device/lib/crypto/include/drbg.h"
+#include "sw/device/lib/crypto/include/ecc_p256.h"
+#include "sw/device/lib/crypto/include/ecc_p384.h"
+#include "sw/device/lib/crypto/include/ed25519.h"
+#include "sw/device/lib/crypto/include/hash.h"
+#include "sw/device/lib/crypto/include/kdf.h"
+#include "sw/device/lib/crypto/include/key_transport.h"
+#include "sw/device/lib/crypto/include/mac.h"
+#include "sw/device/lib/crypto/include/rsa.h"
+#include "sw/device/lib/crypto/include/x25519.h"
+#include "sw/device/lib/runtime/ibex.h"
+#include "sw/device/lib/runtime/log.h"
+#include "sw/device/lib/runtime/print.h"
+#include "sw/device/lib/testing/entropy_testutils.h"
+#include "sw/device/lib/testing/test_framework/check.h"
+#include "sw/device/lib/testing/test_framework/ottf_main.h"
+#include "sw/device/silicon_creator/lib/stack_utilization_asm.h"
+
+/**
+ * Benchmarks for the public cryptolib API.
+ *
+ * Each operation is run once per parameter value: the input size in bytes for
+ * operations on messages, and the key size in bits otherwise. For every run,
+ * one CSV line is printed on the console:
+ *
+ *   BENCH,<operation>,<parameter>,<ibex cycles>,<otbn instructions>,<stack>
+ *
+ * where the OTBN instruction count is for the last OTBN program the operation
+ * ran (0 if it does not use OTBN) and the stack column is the peak stack usage
+ * in bytes. Lines that do not start with "BENCH," are log output.
+ */
+
+// Module ID for status codes.
+#define MODULE_ID MAKE_MODULE_ID('b', 'c', 'h')
+
+enum {
+  /* Largest input size in the sweep. */
+  kMaxInputBytes = 4096,
+  /* Words of stack left untouched below the caller's frame when painting. */
+  kStackRedZoneWords = 32,
+  /* Number of bytes in a symmetric keyblob for a 256-bit key (two shares). */
+  kSymmetricKeyblobBytes = 2 * 256 / 8,
+  /* Number of bytes in a symmetric keyblob for a 512-bit key (two shares). */
+  kSymmetricKeyblobMaxBytes = 2 * 512 / 8,
+  /* Number of bytes in a P-256, Ed25519 or X25519 keyblob. */
+  kEcc256KeyblobBytes = 2 * (256 + 64) / 8,
+  /* Number of bytes in a P-384 keyblob. */
+  kEcc384KeyblobBytes = 2 * (384 + 64) / 8,
+  /* Number of 32-bit words in a P-256 public key or signature. */
+  kP256PointWords = 512 / 32,
+  /* Number of 32-bit words in a P-384 public key or signature. */
+  kP384PointWords = 768 / 32,
+  /* Number of 32-bit words in an Ed25519/X25519 public key. */
+  kCurve25519PublicKeyWords = 256 / 32,
+  /* Number of 32-bit words in an Ed25519 signature. */
+  kEd25519SignatureWords = 512 / 32,
+  /* Number of RSA sizes. */
+  kRsaNumSizes = 3,
+  /* Largest RSA modulus, in 32-bit words. */
+  kRsaMaxWords = 4096 / 32,
+  /* Number of bytes in the RSA-OAEP test message. */
+  kRsaMessageBytes = 32,
+};
+
+// Input sizes for operations on messages.
+static const size_t kInputSizes[] = {16, 64, 256, 1024, kMaxInputBytes};
+// Key size for AES, HMAC-SHA256 and the 256-bit curves.
+static const size_t kKeySize256[] = {256};
+// Key size for P-384.
+static const size_t kKeySize384[] = {384};
+// RSA key sizes.
+static const size_t kRsaSizes[] = {2048, 3072, 4096};
+
+// Input and output buffers.
+static uint8_t input[kMaxInputBytes];
+static uint8_t output[kMaxInputBytes];
+
+// Empty buffer for optional arguments.
+static const otcrypto_const_byte_buf_t kEmpty = {.data = NULL, .len = 0};
+
+// Fixed IV for the AES modes that need one.
+static uint32_t iv_data[4];
+
+/**
+ * Configuration for a software symmetric key.
+ *
+ * @param mode Key mode.
+ * @param bits Key length in bits.
+ */
+#define SYMMETRIC_KEY_CONFIG(mode, bits)            \
+  {                                                 \
+    .version = kOtcryptoLibVersion1,                \
+    .key_mode = mode,                               \
+    .key_length = (bits) / 8,                       \
+    .hw_backed = kHardenedBoolFalse,                \
+    .security_level = kOtcryptoKeySecurityLevelLow, \
+  }
+
+// Keyblobs and key structs for the symmetric operations.
+static uint32_t aes_ecb_keyblob[kSymmetricKeyblobBytes / sizeof(uint32_t)];
+static uint32_t aes_cbc_keyblob[kSymmetricKeyblobBytes / sizeof(uint32_t)];
+static uint32_t aes_cfb_keyblob[kSymmetricKeyblobBytes / sizeof(uint32_t)];
+static uint32_t aes_ofb_keyblob[kSymmetricKeyblobBytes / sizeof(uint32_t)];
+static uint32_t aes_ctr_keyblob[kSymmetricKeyblobBytes / sizeof(uint32_t)];
+static uint32_t aes_gcm_keyblob[kSymmetricKeyblobBytes / sizeof(uint32_t)];
+static uint32_t aes_kwp_keyblob[kSymmetricKeyblobBytes / sizeof(uint32_t)];
+static uint32_t hmac256_keyblob[kSymmetricKeyblobBytes / sizeof(uint32_t)];
+static uint32_t hmac384_keyblob[kSymmetricKeyblobMaxBytes / sizeof(uint32_t)];
+static uint32_t hmac512_keyblob[kSymmetricKeyblobMaxBytes / sizeof(uint32_t)];
+static uint32_t kmac128_keyblob[kSymmetricKeyblobBytes / sizeof(uint32_t)];
+static uint32_t kmac256_keyblob[kSymmetricKeyblobBytes / sizeof(uint32_t)];
+static uint32_t kdf_hmac_keyblob[kSymmetricKeyblobBytes / sizeof(uint32_t)];
+static uint32_t kdf_kmac_keyblob[kSymmetricKeyblobBytes / sizeof(uint32_t)];
+static uint32_t derived_keyblob[kSymmetricKeyblobBytes / sizeof(uint32_t)];
+
+static otcrypto_blinded_key_t aes_ecb_key = {
+    .config = SYMMETRIC_KEY_CONFIG(kOtcryptoKeyModeAesEcb, 256),
+    .keyblob_length = sizeof(aes_ecb_keyblob),
+    .keyblob = aes_ecb_keyblob,
+};
+static otcrypto_blinded_key_t aes_cbc_key = {
+    .config = SYMMETRIC_KEY_CONFIG(kOtcryptoKeyModeAesCbc, 256),
+    .keyblob_length = sizeof(aes_cbc_keyblob),
+    .keyblob = aes_cbc_keyblob,
+};
+static otcrypto_blinded_key_t aes_cfb_key = {
+    .config = SYMMETRIC_KEY_CONFIG(kOtcryptoKeyModeAesCfb, 256),
+    .keyblob_length = sizeof(aes_cfb_keyblob),
+    .keyblob = aes_cfb_keyblob,
+};
+static otcrypto_blinded_key_t aes_ofb_key = {
+    .config = SYMMETRIC_KEY_CONFIG(kOtcryptoKeyModeAesOfb, 256),
+    .keyblob_length = sizeof(aes_ofb_keyblob),
+    .keyblob = aes_ofb_keyblob,
+};
+static otcrypto_blinded_key_t aes_ctr_key = {
+    .config = SYMMETRIC_KEY_CONFIG(kOtcryptoKeyModeAesCtr, 256),
+    .keyblob_length = sizeof(aes_ctr_keyblob),
+    .keyblob = aes_ctr_keyblob,
+};
+static otcrypto_blinded_key_t aes_gcm_key = {
+    .config = SYMMETRIC_KEY_CONFIG(kOtcryptoKeyModeAesGcm, 256),
+    .keyblob_length = sizeof(aes_gcm_keyblob),
+    .keyblob = aes_gcm_keyblob,
+};
+static otcrypto_blinded_key_t aes_kwp_key = {
+    .config = SYMMETRIC_KEY_CONFIG(kOtcryptoKeyModeAesKwp, 256),
+    .keyblob_length = sizeof(aes_kwp_keyblob),
+    .keyblob = aes_kwp_keyblob,
+};
+static otcrypto_blinded_key_t hmac256_key = {
+    .config = SYMMETRIC_KEY_CONFIG(kOtcryptoKeyModeHmacSha256, 256),
+    .keyblob_length = sizeof(hmac256_keyblob),
+    .keyblob = hmac256_keyblob,
+};
+static otcrypto_blinded_key_t hmac384_key = {
+    .config = SYMMETRIC_KEY_CONFIG(kOtcryptoKeyModeHmacSha384, 384),
+    .keyblob_length = 2 * 384 / 8,
+    .keyblob = hmac384_keyblob,
+};
+static otcrypto_blinded_key_t hmac512_key = {
+    .config = SYMMETRIC_KEY_CONFIG(kOtcryptoKeyModeHmacSha512, 512),
+    .keyblob_length = sizeof(hmac512_keyblob),
+    .keyblob = hmac512_keyblob,
+};
+static otcrypto_blinded_key_t kmac128_key = {
+    .config = SYMMETRIC_KEY_CONFIG(kOtcryptoKeyModeKmac128, 256),
+    .keyblob_length = sizeof(kmac128_keyblob),
+    .keyblob = kmac128_keyblob,
+};
+static otcrypto_blinded_key_t kmac256_key = {
+    .config = SYMMETRIC_KEY_CONFIG(kOtcryptoKeyModeKmac256, 256),
+    .keyblob_length = sizeof(kmac256_keyblob),
+    .keyblob = kmac256_keyblob,
+};
+static otcrypto_blinded_key_t kdf_hmac_key = {
+    .config = SYMMETRIC_KEY_CONFIG(kOtcryptoKeyModeHmacSha256, 256),
+    .keyblob_length = sizeof(kdf_hmac_keyblob),
+    .keyblob = kdf_hmac_keyblob,
+};
+static otcrypto_blinded_key_t kdf_kmac_key = {
+    .config = SYMMETRIC_KEY_CONFIG(kOtcryptoKeyModeKdfKmac256, 256),
+    .keyblob_length = sizeof(kdf_kmac_keyblob),
+    .keyblob = kdf_kmac_keyblob,
+};
+// Output of the key derivation functions.
+static otcrypto_blinded_key_t derived_key = {
+    .config = SYMMETRIC_KEY_CONFIG(kOtcryptoKeyModeAesCtr, 256),
+    .keyblob_length = sizeof(derived_keyblob),
+    .keyblob = derived_keyblob,
+};
+
+/**
+ * An asymmetric key pair along with a message digest and signature buffer.
+ */
+typedef struct ecc_state {
+  otcrypto_blinded_key_t private_key;
+  otcrypto_unblinded_key_t public_key;
+  uint32_t signature[kP384PointWords];
+  size_t signature_words;
+} ecc_state_t;
+
+static uint32_t p256_keyblob[kEcc256KeyblobBytes / sizeof(uint32_t)];
+static uint32_t p256_pk[kP256PointWords];
+static ecc_state_t p256 = {
+    .private_key =
+        {
+            .config =
+                {
+                    .version = kOtcryptoLibVersion1,
+                    .key_mode = kOtcryptoKeyModeEcdsaP256,
+                    .key_length = 256 / 8,
+                    .hw_backed = kHardenedBoolFalse,
+                    .security_level = kOtcryptoKeySecurityLevelLow,
+                },
+            .keyblob_length = sizeof(p256_keyblob),
+            .keyblob = p256_keyblob,
+        },
+    .public_key =
+        {
+            .key_mode = kOtcryptoKeyModeEcdsaP256,
+            .key_length = sizeof(p256_pk),
+            .key = p256_pk,
+        },
+    .signature_words = kP256PointWords,
+};
+
+static uint32_t p384_keyblob[kEcc384KeyblobBytes / sizeof(uint32_t)];
+static uint32_t p384_pk[kP384PointWords];
+static ecc_state_t p384 = {
+    .private_key =
+        {
+            .config =
+                {
+                    .version = kOtcryptoLibVersion1,
+                    .key_mode = kOtcryptoKeyModeEcdsaP384,
+                    .key_length = 384 / 8,
+                    .hw_backed = kHardenedBoolFalse,
+                    .security_level = kOtcryptoKeySecurityLevelLow,
+                },
+            .keyblob_length = sizeof(p384_keyblob),
+            .keyblob = p384_keyblob,
+        },
+    .public_key =
+        {
+            .key_mode = kOtcryptoKeyModeEcdsaP384,
+            .key_length = sizeof(p384_pk),
+            .key = p384_pk,
+        },
+    .signature_words = kP384PointWords,
+};
+
+static uint32_t ecdh_p256_keyblob[kEcc256KeyblobBytes / sizeof(uint32_t)];
+static uint32_t ecdh_p256_pk[kP256PointWords];
+static otcrypto_blinded_key_t ecdh_p256_private_key = {
+    .config =
+        {
+            .version = kOtcryptoLibVersion1,
+            .key_mode = kOtcryptoKeyModeEcdhP256,
+            .key_length = 256 / 8,
+            .hw_backed = kHardenedBoolFalse,
+            .security_level = kOtcryptoKeySecurityLevelLow,
+        },
+    .keyblob_length = sizeof(ecdh_p256_keyblob),
+    .keyblob = ecdh_p256_keyblob,
+};
+static otcrypto_unblinded_key_t ecdh_p256_public_key = {
+    .key_mode = kOtcryptoKeyModeEcdhP256,
+    .key_length = sizeof(ecdh_p256_pk),
+    .key = ecdh_p256_pk,
+};
+
+static uint32_t ecdh_p384_keyblob[kEcc384KeyblobBytes / sizeof(uint32_t)];
+static uint32_t ecdh_p384_pk[kP384PointWords];
+static otcrypto_blinded_key_t ecdh_p384_private_key = {
+    .config =
+        {
+            .version = kOtcryptoLibVersion1,
+            .key_mode = kOtcryptoKeyModeEcdhP384,
+            .key_length = 384 / 8,
+            .hw_backed = kHardenedBoolFalse,
+            .security_level = kOtcryptoKeySecurityLevelLow,
+        },
+    .keyblob_length = sizeof(ecdh_p384_keyblob),
+    .keyblob = ecdh_p384_keyblob,
+};
+static otcrypto_unblinded_key_t ecdh_p384_public_key = {
+    .key_mode = kOtcryptoKeyModeEcdhP384,
+    .key_length = sizeof(ecdh_p384_pk),
+    .key = ecdh_p384_pk,
+};
+
+// Ephemeral public keys for the fused keygen and key exchange.
+static uint32_t ecdh_p256_ephemeral_pk[kP256PointWords];
+static otcrypto_unblinded_key_t ecdh_p256_ephemeral_public_key = {
+    .key_mode = kOtcryptoKeyModeEcdhP256,
+    .key_length = sizeof(ecdh_p256_ephemeral_pk),
+    .key = ecdh_p256_ephemeral_pk,
+};
+static uint32_t ecdh_p384_ephemeral_pk[kP384PointWords];
+static otcrypto_unblinded_key_t ecdh_p384_ephemeral_public_key = {
+    .key_mode = kOtcryptoKeyModeEcdhP384,
+    .key_length = sizeof(ecdh_p384_ephemeral_pk),
+    .key = ecdh_p384_ephemeral_pk,
+};
+
+// ECDH shared secrets (any 384-bit symmetric key mode works for P-384).
+static uint32_t shared_keyblob[kEcc384KeyblobBytes / sizeof(uint32_t)];
+static otcrypto_blinded_key_t ecdh_p256_shared_key = {
+    .config = SYMMETRIC_KEY_CONFIG(kOtcryptoKeyModeAesCtr, 256),
+    .keyblob_length = 2 * 256 / 8,
+    .keyblob = shared_keyblob,
+};
+static otcrypto_blinded_key_t ecdh_p384_shared_key = {
+    .config = SYMMETRIC_KEY_CONFIG(kOtcryptoKeyModeHmacSha384, 384),
+    .keyblob_length = 2 * 384 / 8,
+    .keyblob = shared_keyblob,
+};
+
+static uint32_t ed25519_keyblob[kEcc256KeyblobBytes / sizeof(uint32_t)];
+static uint32_t ed25519_pk[kCurve25519PublicKeyWords];
+static uint32_t ed25519_sig[kEd25519SignatureWords];
+static otcrypto_blinded_key_t ed25519_private_key = {
+    .config =
+        {
+            .version = kOtcryptoLibVersion1,
+            .key_mode = kOtcryptoKeyModeEd25519,
+            .key_length = 256 / 8,
+            .hw_backed = kHardenedBoolFalse,
+            .security_level = kOtcryptoKeySecurityLevelLow,
+        },
+    .keyblob_length = sizeof(ed25519_keyblob),
+    .keyblob = ed25519_keyblob,
+};
+static otcrypto_unblinded_key_t ed25519_public_key = {
+    .key_mode = kOtcryptoKeyModeEd25519,
+    .key_length = sizeof(ed25519_pk),
+    .key = ed25519_pk,
+};
+
+static uint32_t x25519_keyblob[kEcc256KeyblobBytes / sizeof(uint32_t)];
+static uint32_t x25519_pk[kCurve25519PublicKeyWords];
+static otcrypto_blinded_key_t x25519_private_key = {
+    .config =
+        {
+            .version = kOtcryptoLibVersion1,
+            .key_mode = kOtcryptoKeyModeX25519,
+            .key_length = 256 / 8,
+            .hw_backed = kHardenedBoolFalse,
+            .security_level = kOtcryptoKeySecurityLevelLow,
+        },
+    .keyblob_length = sizeof(x25519_keyblob),
+    .keyblob = x25519_keyblob,
+};
+static otcrypto_unblinded_key_t x25519_public_key = {
+    .key_mode = kOtcryptoKeyModeX25519,
+    .key_length = sizeof(x25519_pk),
+    .key = x25519_pk,
+};
+
+/**
+ * An RSA key pair of one size, with buffers for its results.
+ *
+ * The encryption key structs share the key material of the signing key pair.
+ */
+typedef struct rsa_state {
+  otcrypto_rsa_size_t size;
+  size_t num_words;
+  otcrypto_unblinded_key_t public_key;
+  otcrypto_blinded_key_t private_key;
+  otcrypto_unblinded_key_t enc_public_key;
+  otcrypto_blinded_key_t enc_private_key;
+  uint32_t signature[kRsaMaxWords];
+  uint32_t ciphertext[kRsaMaxWords];
+} rsa_state_t;
+
+static uint32_t rsa2048_pk[kOtcryptoRsa2048PublicKeyBytes / sizeof(uint32_t)];
+static uint32_t rsa3072_pk[kOtcryptoRsa3072PublicKeyBytes / sizeof(uint32_t)];
+static uint32_t rsa4096_pk[kOtcryptoRsa4096PublicKeyBytes / sizeof(uint32_t)];
+static uint32_t
+    rsa2048_keyblob[kOtcryptoRsa2048PrivateKeyblobBytes / sizeof(uint32_t)];
+static uint32_t
+    rsa3072_keyblob[kOtcryptoRsa3072PrivateKeyblobBytes / sizeof(uint32_t)];
+static uint32_t
+    rsa4096_keyblob[kOtcryptoRsa4096PrivateKeyblobBytes / sizeof(uint32_t)];
+
+/**
+ * Initializer for an `rsa_state_t`.
+ *
+ * @param bits RSA size in bits.
+ */
+#define RSA_STATE(bits)                                                    \
+  {                                                                        \
+    .size = kOtcryptoRsaSize##bits, .num_words = (bits) / 32,              \
+    .public_key =                                                          \
+        {                                                                  \
+            .key_mode = kOtcryptoKeyModeRsaSignPkcs,                       \
+            .key_length = kOtcryptoRsa##bits##PublicKeyBytes,              \
+            .key = rsa##bits##_pk,                                         \
+        },                                                                 \
+    .private_key =                                                         \
+        {                                                                  \
+            .config =                                                      \
+                {                                                          \
+                    .version = kOtcryptoLibVersion1,                       \
+                    .key_mode = kOtcryptoKeyModeRsaSignPkcs,               \
+                    .key_length = kOtcryptoRsa##bits##PrivateKeyBytes,     \
+                    .hw_backed = kHardenedBoolFalse,                       \
+                    .security_level = kOtcryptoKeySecurityLevelLow,        \
+                },                                                         \
+            .keyblob_length = kOtcryptoRsa##bits##PrivateKeyblobBytes,     \
+            .keyblob = rsa##bits##_keyblob,                                \
+        },                                                                 \
+    .enc_public_key =                                                      \
+        {                                                                  \
+            .key_mode = kOtcryptoKeyModeRsaEncryptOaep,                    \
+            .key_length = kOtcryptoRsa##bits##PublicKeyBytes,              \
+            .key = rsa##bits##_pk,                                         \
+        },                                                                 \
+    .enc_private_key = {                                                   \
+        .config =                                                          \
+            {                                                              \
+                .version = kOtcryptoLibVersion1,                           \
+                .key_mode = kOtcryptoKeyModeRsaEncryptOaep,                \
+                .key_length = kOtcryptoRsa##bits##PrivateKeyBytes,         \
+                .hw_backed = kHardenedBoolFalse,                           \
+                .security_level = kOtcryptoKeySecurityLevelLow,            \
+            },                                                             \
+        .keyblob_length = kOtcryptoRsa##bits##PrivateKeyblobBytes,         \
+        .keyblob = rsa##bits##_keyblob,                                    \
+    },                                                                     \
+  }
+
+static rsa_state_t rsa_states[kRsaNumSizes] = {
+    RSA_STATE(2048),
+    RSA_STATE(3072),
+    RSA_STATE(4096),
+};
+
+// SHA-256 digest signed by the ECDSA, RSA and Ed25519ph benchmarks.
+static uint32_t digest_data[512 / 32];
+static otcrypto_hash_digest_t digest = {
+    .mode = kOtcryptoHashModeSha256,
+    .data = digest_data,
+    .len = 256 / 32,
+};
+
+/**
+ * Returns a buffer with the first `len` bytes of `input`.
+ */
+static otcrypto_const_byte_buf_t input_buf(size_t len) {
+  return (otcrypto_const_byte_buf_t){.data = input, .len = len};
+}
+
+/**
+ * Returns a buffer with the first `len` bytes of `output`.
+ */
+static otcrypto_byte_buf_t output_buf(size_t len) {
+  return (otcrypto_byte_buf_t){.data = output, .len = len};
+}
+
+/**
+ * Returns the RSA state for the given size in bits.
+ */
+static rsa_state_t *rsa_state_get(size_t bits) {
+  for (size_t i = 0; i < kRsaNumSizes; i++) {
+    if (rsa_states[i].num_words * 32 == bits) {
+      return &rsa_states[i];
+    }
+  }
+  return NULL;
+}
+
+static status_t aes_run(otcrypto_blinded_key_t *key, otcrypto_aes_mode_t mode,
+                        size_t len) {
+  otcrypto_word32_buf_t iv = {.data = iv_data, .len = ARRAYSIZE(iv_data)};
+  return otcrypto_aes(key, iv, mode, kOtcryptoAesOperationEncrypt,
+                      input_buf(len), kOtcryptoAesPaddingNull,
+                      output_buf(len));
+}
+
+static status_t bench_aes_ecb(size_t len) {
+  return aes_run(&aes_ecb_key, kOtcryptoAesModeEcb, len);
+}
+
+static status_t bench_aes_cbc(size_t len) {
+  return aes_run(&aes_cbc_key, kOtcryptoAesModeCbc, len);
+}
+
+static status_t bench_aes_cfb(size_t len) {
+  return aes_run(&aes_cfb_key, kOtcryptoAesModeCfb, len);
+}
+
+static status_t bench_aes_ofb(size_t len) {
+  return aes_run(&aes_ofb_key, kOtcryptoAesModeOfb, len);
+}
+
+static status_t bench_aes_ctr(size_t len) {
+  return aes_run(&aes_ctr_key, kOtcryptoAesModeCtr, len);
+}
+
+static status_t bench_aes_gcm_encrypt(size_t len) {
+  uint32_t tag[128 / 32];
+  return otcrypto_aes_gcm_encrypt(
+      &aes_gcm_key, input_buf(len),
+      (otcrypto_const_word32_buf_t){.data = iv_data, .len = 96 / 32}, kEmpty,
+      kOtcryptoAesGcmTagLen128, output_buf(len),
+      (otcrypto_word32_buf_t){.data = tag, .len = ARRAYSIZE(tag)});
+}
+
+static status_t bench_aes_gcm_decrypt(size_t len) {
+  // The tag is wrong, but decryption runs in full either way.
+  uint32_t tag[128 / 32] = {0};
+  hardened_bool_t success;
+  return otcrypto_aes_gcm_decrypt(
+      &aes_gcm_key, input_buf(len),
+      (otcrypto_const_word32_buf_t){.data = iv_data, .len = 96 / 32}, kEmpty,
+      kOtcryptoAesGcmTagLen128,
+      (otcrypto_const_word32_buf_t){.data = tag, .len = ARRAYSIZE(tag)},
+      output_buf(len), &success);
+}
+
+static status_t bench_aes_kwp_wrap(size_t bits) {
+  OT_DISCARD(bits);
+  size_t wrapped_words;
+  TRY(otcrypto_wrapped_key_len(aes_ctr_key.config, &wrapped_words));
+  return otcrypto_key_wrap(
+      &aes_ctr_key, &aes_kwp_key,
+      (otcrypto_word32_buf_t){.data = (uint32_t *)output,
+                              .len = wrapped_words});
+}
+
+static status_t bench_aes_kwp_unwrap(size_t bits) {
+  OT_DISCARD(bits);
+  size_t wrapped_words;
+  TRY(otcrypto_wrapped_key_len(aes_ctr_key.config, &wrapped_words));
+  hardened_bool_t success;
+  TRY(otcrypto_key_unwrap(
+      (otcrypto_const_word32_buf_t){.data = (uint32_t *)output,
+                                    .len = wrapped_words},
+      &aes_kwp_key, &success, &derived_key));
+  TRY_CHECK(success == kHardenedBoolTrue);
+  return OTCRYPTO_OK;
+}
+
+static status_t hash_run(otcrypto_hash_mode_t mode, size_t digest_bits,
+                         size_t len) {
+  return otcrypto_hash(input_buf(len),
+                       (otcrypto_hash_digest_t){.mode = mode,
+                                                .data = digest_data,
+                                                .len = digest_bits / 32});
+}
+
+static status_t bench_sha256(size_t len) {
+  return hash_run(kOtcryptoHashModeSha256, 256, len);
+}
+
+static status_t bench_sha384(size_t len) {
+  return hash_run(kOtcryptoHashModeSha384, 384, len);
+}
+
+static status_t bench_sha512(size_t len) {
+  return hash_run(kOtcryptoHashModeSha512, 512, len);
+}
+
+static status_t bench_sha3_224(size_t len) {
+  return hash_run(kOtcryptoHashModeSha3_224, 224, len);
+}
+
+static status_t bench_sha3_256(size_t len) {
+  return hash_run(kOtcryptoHashModeSha3_256, 256, len);
+}
+
+static status_t bench_sha3_384(size_t len) {
+  return hash_run(kOtcryptoHashModeSha3_384, 384, len);
+}
+
+static status_t bench_sha3_512(size_t len) {
+  return hash_run(kOtcryptoHashModeSha3_512, 512, len);
+}
+
+static status_t bench_shake128(size_t len) {
+  return otcrypto_xof_shake(
+      input_buf(len), (otcrypto_hash_digest_t){
+                          .mode = kOtcryptoHashXofModeShake128,
+                          .data = digest_data,
+                          .len = 256 / 32,
+                      });
+}
+
+static status_t bench_shake256(size_t len) {
+  return otcrypto_xof_shake(
+      input_buf(len), (otcrypto_hash_digest_t){
+                          .mode = kOtcryptoHashXofModeShake256,
+                          .data = digest_data,
+                          .len = 512 / 32,
+                      });
+}
+
+static status_t hmac_run(otcrypto_blinded_key_t *key, size_t tag_bits,
+                         size_t len) {
+  return otcrypto_hmac(key, input_buf(len),
+                       (otcrypto_word32_buf_t){.data = (uint32_t *)output,
+                                               .len = tag_bits / 32});
+}
+
+static status_t bench_hmac_sha256(size_t len) {
+  return hmac_run(&hmac256_key, 256, len);
+}
+
+static status_t bench_hmac_sha384(size_t len) {
+  return hmac_run(&hmac384_key, 384, len);
+}
+
+static status_t bench_hmac_sha512(size_t len) {
+  return hmac_run(&hmac512_key, 512, len);
+}
+
+static status_t kmac_run(otcrypto_blinded_key_t *key, otcrypto_kmac_mode_t mode,
+                         size_t len) {
+  return otcrypto_kmac(key, input_buf(len), mode, kEmpty, 256 / 8,
+                       (otcrypto_word32_buf_t){.data = (uint32_t *)output,
+                                               .len = 256 / 32});
+}
+
+static status_t bench_kmac128(size_t len) {
+  return kmac_run(&kmac128_key, kOtcryptoKmacModeKmac128, len);
+}
+
+static status_t bench_kmac256(size_t len) {
+  return kmac_run(&kmac256_key, kOtcryptoKmacModeKmac256, len);
+}
+
+static status_t bench_kdf_hmac_ctr(size_t bits) {
+  return otcrypto_kdf_hmac_ctr(kdf_hmac_key, input_buf(16), input_buf(16),
+                               bits / 8, &derived_key);
+}
+
+static status_t bench_kdf_kmac(size_t bits) {
+  return otcrypto_kdf_kmac(kdf_kmac_key, kOtcryptoKmacModeKmac256,
+                           input_buf(16), input_buf(16), bits / 8,
+                           &derived_key);
+}
+
+static status_t bench_hkdf(size_t bits) {
+  OT_DISCARD(bits);
+  return otcrypto_kdf_hkdf(kdf_hmac_key, input_buf(16), input_buf(16),
+                           &derived_key);
+}
+
+static status_t bench_drbg_generate(size_t len) {
+  return otcrypto_drbg_generate(
+      kEmpty, (otcrypto_word32_buf_t){.data = (uint32_t *)output,
+                                      .len = len / sizeof(uint32_t)});
+}
+
+static status_t bench_ecdsa_p256_keygen(size_t bits) {
+  OT_DISCARD(bits);
+  return otcrypto_ecdsa_p256_keygen(&p256.private_key, &p256.public_key);
+}
+
+static status_t bench_ecdsa_p256_sign(size_t bits) {
+  OT_DISCARD(bits);
+  return otcrypto_ecdsa_p256_sign(
+      &p256.private_key, digest,
+      (otcrypto_word32_buf_t){.data = p256.signature,
+                              .len = p256.signature_words});
+}
+
+static status_t bench_ecdsa_p256_verify(size_t bits) {
+  OT_DISCARD(bits);
+  hardened_bool_t result;
+  TRY(otcrypto_ecdsa_p256_verify(
+      &p256.public_key, digest,
+      (otcrypto_const_word32_buf_t){.data = p256.signature,
+                                    .len = p256.signature_words},
+      &result));
+  TRY_CHECK(result == kHardenedBoolTrue);
+  return OTCRYPTO_OK;
+}
+
+static status_t bench_ecdh_p256_keygen(size_t bits) {
+  OT_DISCARD(bits);
+  return otcrypto_ecdh_p256_keygen(&ecdh_p256_private_key,
+                                   &ecdh_p256_public_key);
+}
+
+static status_t bench_ecdh_p256(size_t bits) {
+  OT_DISCARD(bits);
+  return otcrypto_ecdh_p256(&ecdh_p256_private_key, &ecdh_p256_public_key,
+                            &ecdh_p256_shared_key);
+}
+
+static status_t bench_ecdh_p256_ephemeral(size_t bits) {
+  OT_DISCARD(bits);
+  return otcrypto_ecdh_p256_ephemeral(&ecdh_p256_public_key,
+                                      &ecdh_p256_ephemeral_public_key,
+                                      &ecdh_p256_shared_key);
+}
+
+static status_t bench_ecdsa_p384_keygen(size_t bits) {
+  OT_DISCARD(bits);
+  return otcrypto_ecdsa_p384_keygen(&p384.private_key, &p384.public_key);
+}
+
+static status_t bench_ecdsa_p384_sign(size_t bits) {
+  OT_DISCARD(bits);
+  return otcrypto_ecdsa_p384_sign(
+      &p384.private_key, digest,
+      (otcrypto_word32_buf_t){.data = p384.signature,
+                              .len = p384.signature_words});
+}
+
+static status_t bench_ecdsa_p384_verify(size_t bits) {
+  OT_DISCARD(bits);
+  hardened_bool_t result;
+  TRY(otcrypto_ecdsa_p384_verify(
+      &p384.public_key, digest,
+      (otcrypto_const_word32_buf_t){.data = p384.signature,
+                                    .len = p384.signature_words},
+      &result));
+  TRY_CHECK(result == kHardenedBoolTrue);
+  return OTCRYPTO_OK;
+}
+
+static status_t bench_ecdh_p384_keygen(size_t bits) {
+  OT_DISCARD(bits);
+  return otcrypto_ecdh_p384_keygen(&ecdh_p384_private_key,
+                                   &ecdh_p384_public_key);
+}
+
+static status_t bench_ecdh_p384(size_t bits) {
+  OT_DISCARD(bits);
+  return otcrypto_ecdh_p384(&ecdh_p384_private_key, &ecdh_p384_public_key,
+                            &ecdh_p384_shared_key);
+}
+
+static status_t bench_ecdh_p384_ephemeral(size_t bits) {
+  OT_DISCARD(bits);
+  return otcrypto_ecdh_p384_ephemeral(&ecdh_p384_public_key,
+                                      &ecdh_p384_ephemeral_public_key,
+                                      &ecdh_p384_shared_key);
+}
+
+static status_t bench_ed25519_keygen(size_t bits) {
+  OT_DISCARD(bits);
+  return otcrypto_ed25519_keygen(&ed25519_private_key, &ed25519_public_key);
+}
+
+static status_t bench_ed25519_sign(size_t len) {
+  return otcrypto_ed25519_sign(
+      &ed25519_private_key, input_buf(len), kOtcryptoEddsaSignModeEddsa,
+      (otcrypto_word32_buf_t){.data = ed25519_sig,
+                              .len = ARRAYSIZE(ed25519_sig)});
+}
+
+static status_t bench_ed25519_verify(size_t len) {
+  hardened_bool_t result;
+  TRY(otcrypto_ed25519_verify(
+      &ed25519_public_key, input_buf(len), kOtcryptoEddsaSignModeEddsa,
+      (otcrypto_const_word32_buf_t){.data = ed25519_sig,
+                                    .len = ARRAYSIZE(ed25519_sig)},
+      &result));
+  TRY_CHECK(result == kHardenedBoolTrue);
+  return OTCRYPTO_OK;
+}
+
+static status_t bench_x25519_keygen(size_t bits) {
+  OT_DISCARD(bits);
+  return otcrypto_x25519_keygen(&x25519_private_key, &x25519_public_key);
+}
+
+static status_t bench_x25519(size_t bits) {
+  OT_DISCARD(bits);
+  return otcrypto_x25519(&x25519_private_key, &x25519_public_key,
+                         &ecdh_p256_shared_key);
+}
+
+static status_t bench_rsa_keygen(size_t bits) {
+  rsa_state_t *rsa = rsa_state_get(bits);
+  TRY_CHECK(rsa != NULL);
+  TRY(otcrypto_rsa_keygen(rsa->size, &rsa->public_key, &rsa->private_key));
+
+  // Set up the encryption key structs, which share the same key material.
+  rsa->enc_public_key.checksum =
+      integrity_unblinded_checksum(&rsa->enc_public_key);
+  rsa->enc_private_key.checksum =
+      integrity_blinded_checksum(&rsa->enc_private_key);
+  return OTCRYPTO_OK;
+}
+
+static status_t bench_rsa_sign(size_t bits) {
+  rsa_state_t *rsa = rsa_state_get(bits);
+  TRY_CHECK(rsa != NULL);
+  return otcrypto_rsa_sign(
+      &rsa->private_key, digest, kOtcryptoRsaPaddingPss,
+      (otcrypto_word32_buf_t){.data = rsa->signature, .len = rsa->num_words});
+}
+
+static status_t bench_rsa_verify(size_t bits) {
+  rsa_state_t *rsa = rsa_state_get(bits);
+  TRY_CHECK(rsa != NULL);
+  hardened_bool_t result;
+  TRY(otcrypto_rsa_verify(
+      &rsa->public_key, digest, kOtcryptoRsaPaddingPss,
+      (otcrypto_const_word32_buf_t){.data = rsa->signature,
+                                    .len = rsa->num_words},
+      &result));
+  TRY_CHECK(result == kHardenedBoolTrue);
+  return OTCRYPTO_OK;
+}
+
+static status_t bench_rsa_encrypt(size_t bits) {
+  rsa_state_t *rsa = rsa_state_get(bits);
+  TRY_CHECK(rsa != NULL);
+  return otcrypto_rsa_encrypt(
+      &rsa->enc_public_key, kOtcryptoHashModeSha256,
+      input_buf(kRsaMessageBytes), kEmpty,
+      (otcrypto_word32_buf_t){.data = rsa->ciphertext, .len = rsa->num_words});
+}
+
+static status_t bench_rsa_decrypt(size_t bits) {
+  rsa_state_t *rsa = rsa_state_get(bits);
+  TRY_CHECK(rsa != NULL);
+  size_t plaintext_len;
+  TRY(otcrypto_rsa_decrypt(
+      &rsa->enc_private_key, kOtcryptoHashModeSha256,
+      (otcrypto_const_word32_buf_t){.data = rsa->ciphertext,
+                                    .len = rsa->num_words},
+      kEmpty, output_buf(rsa->num_words * sizeof(uint32_t)), &plaintext_len));
+  TRY_CHECK(plaintext_len == kRsaMessageBytes);
+  return OTCRYPTO_OK;
+}
+
+/**
+ * A benchmarked operation.
+ */
+typedef struct benchmark {
+  /**
+   * Name of the operation in the CSV output.
+   */
+  const char *name;
+  /**
+   * Runs the operation once.
+   */
+  status_t (*run)(size_t param);
+  /**
+   * Parameter values to run the operation with.
+   */
+  const size_t *params;
+  size_t num_params;
+  /**
+   * Whether the operation runs on OTBN.
+   */
+  bool otbn;
+} benchmark_t;
+
+/**
+ * Benchmarks, in the order they run. Keygen benchmarks come before the
+ * operations that use their keys.
+ */
+static const benchmark_t kBenchmarks[] = {
+    {"aes_ecb_encrypt", bench_aes_ecb, kInputSizes, ARRAYSIZE(kInputSizes)},
+    {"aes_cbc_encrypt", bench_aes_cbc, kInputSizes, ARRAYSIZE(kInputSizes)},
+    {"aes_cfb_encrypt", bench_aes_cfb, kInputSizes, ARRAYSIZE(kInputSizes)},
+    {"aes_ofb_encrypt", bench_aes_ofb, kInputSizes, ARRAYSIZE(kInputSizes)},
+    {"aes_ctr_encrypt", bench_aes_ctr, kInputSizes, ARRAYSIZE(kInputSizes)},
+    {"aes_gcm_encrypt", bench_aes_gcm_encrypt, kInputSizes,
+     ARRAYSIZE(kInputSizes)},
+    {"aes_gcm_decrypt", bench_aes_gcm_decrypt, kInputSizes,
+     ARRAYSIZE(kInputSizes)},
+    {"aes_kwp_wrap", bench_aes_kwp_wrap, kKeySize256, ARRAYSIZE(kKeySize256)},
+    {"aes_kwp_unwrap", bench_aes_kwp_unwrap, kKeySize256,
+     ARRAYSIZE(kKeySize256)},
+    {"sha256", bench_sha256, kInputSizes, ARRAYSIZE(kInputSizes)},
+    {"sha384", bench_sha384, kInputSizes, ARRAYSIZE(kInputSizes)},
+    {"sha512", bench_sha512, kInputSizes, ARRAYSIZE(kInputSizes)},
+    {"sha3_224", bench_sha3_224, kInputSizes, ARRAYSIZE(kInputSizes)},
+    {"sha3_256", bench_sha3_256, kInputSizes, ARRAYSIZE(kInputSizes)},
+    {"sha3_384", bench_sha3_384, kInputSizes, ARRAYSIZE(kInputSizes)},
+    {"sha3_512", bench_sha3_512, kInputSizes, ARRAYSIZE(kInputSizes)},
+    {"shake128", bench_shake128, kInputSizes, ARRAYSIZE(kInputSizes)},
+    {"shake256", bench_shake256, kInputSizes, ARRAYSIZE(kInputSizes)},
+    {"hmac_sha256", bench_hmac_sha256, kInputSizes, ARRAYSIZE(kInputSizes)},
+    {"hmac_sha384", bench_hmac_sha384, kInputSizes, ARRAYSIZE(kInputSizes)},
+    {"hmac_sha512", bench_hmac_sha512, kInputSizes, ARRAYSIZE(kInputSizes)},
+    {"kmac128", bench_kmac128, kInputSizes, ARRAYSIZE(kInputSizes)},
+    {"kmac256", bench_kmac256, kInputSizes, ARRAYSIZE(kInputSizes)},
+    {"kdf_hmac_ctr", bench_kdf_hmac_ctr, kKeySize256, ARRAYSIZE(kKeySize256)},
+    {"kdf_kmac256", bench_kdf_kmac, kKeySize256, ARRAYSIZE(kKeySize256)},
+    {"hkdf_sha256", bench_hkdf, kKeySize256, ARRAYSIZE(kKeySize256)},
+    {"drbg_generate", bench_drbg_generate, kInputSizes,
+     ARRAYSIZE(kInputSizes)},
+    {"ecdsa_p256_keygen", bench_ecdsa_p256_keygen, kKeySize256,
+     ARRAYSIZE(kKeySize256), true},
+    {"ecdsa_p256_sign", bench_ecdsa_p256_sign, kKeySize256,
+     ARRAYSIZE(kKeySize256), true},
+    {"ecdsa_p256_verify", bench_ecdsa_p256_verify, kKeySize256,
+     ARRAYSIZE(kKeySize256), true},
+    {"ecdh_p256_keygen", bench_ecdh_p256_keygen, kKeySize256,
+     ARRAYSIZE(kKeySize256), true},
+    {"ecdh_p256", bench_ecdh_p256, kKeySize256, ARRAYSIZE(kKeySize256), true},
+    {"ecdh_p256_ephemeral", bench_ecdh_p256_ephemeral, kKeySize256,
+     ARRAYSIZE(kKeySize256), true},
+    {"ecdsa_p384_keygen", bench_ecdsa_p384_keygen, kKeySize384,
+     ARRAYSIZE(kKeySize384), true},
+    {"ecdsa_p384_sign", bench_ecdsa_p384_sign, kKeySize384,
+     ARRAYSIZE(kKeySize384), true},
+    {"ecdsa_p384_verify", bench_ecdsa_p384_verify, kKeySize384,
+     ARRAYSIZE(kKeySize384), true},
+    {"ecdh_p384_keygen", bench_ecdh_p384_keygen, kKeySize384,
+     ARRAYSIZE(kKeySize384), true},
+    {"ecdh_p384", bench_ecdh_p384, kKeySize384, ARRAYSIZE(kKeySize384), true},
+    {"ecdh_p384_ephemeral", bench_ecdh_p384_ephemeral, kKeySize384,
+     ARRAYSIZE(kKeySize384), true},
+    {"ed25519_keygen", bench_ed25519_keygen, kKeySize256,
+     ARRAYSIZE(kKeySize256), true},
+    {"ed25519_sign", bench_ed25519_sign, kInputSizes, ARRAYSIZE(kInputSizes),
+     true},
+    {"ed25519_verify", bench_ed25519_verify, kInputSizes,
+     ARRAYSIZE(kInputSizes), true},
+    {"x25519_keygen", bench_x25519_keygen, kKeySize256, ARRAYSIZE(kKeySize256),
+     true},
+    {"x25519", bench_x25519, kKeySize256, ARRAYSIZE(kKeySize256), true},
+    {"rsa_keygen", bench_rsa_keygen, kRsaSizes, ARRAYSIZE(kRsaSizes), true},
+    {"rsa_sign_pss", bench_rsa_sign, kRsaSizes, ARRAYSIZE(kRsaSizes), true},
+    {"rsa_verify_pss", bench_rsa_verify, kRsaSizes, ARRAYSIZE(kRsaSizes),
+     true},
+    {"rsa_encrypt_oaep", bench_rsa_encrypt, kRsaSizes, ARRAYSIZE(kRsaSizes),
+     true},
+    {"rsa_decrypt_oaep", bench_rsa_decrypt, kRsaSizes, ARRAYSIZE(kRsaSizes),
+     true},
+};
+
+extern uint32_t _stack_start[];
+
+/**
+ * Fills the unused part of the stack with `STACK_UTILIZATION_FREE_PATTERN`.
+ *
+ * Leaves `kStackRedZoneWords` words below this function's frame alone.
+ */
+static OT_NOINLINE void stack_paint(void) {
+  uint32_t marker = 0;
+  uint32_t *end = &marker - kStackRedZoneWords;
+  // Skip the first word, which may be an ePMP stack guard (as in
+  // `stack_utilization_print`).
+  for (volatile uint32_t *p = _stack_start + 1; p < end; p++) {
+    *p = STACK_UTILIZATION_FREE_PATTERN;
+  }
+}
+
+/**
+ * Returns how far below `top` the stack has been used since `stack_paint`.
+ */
+static size_t stack_used(const uint32_t *top) {
+  const volatile uint32_t *p = _stack_start + 1;
+  while (p < top && *p == STACK_UTILIZATION_FREE_PATTERN) {
+    p++;
+  }
+  return (size_t)((uintptr_t)top - (uintptr_t)p);
+}
+
+/**
+ * Formats a 64-bit count in decimal (`base_printf` has no 64-bit support).
+ *
+ * @param value Value to format.
+ * @param[out] buf Destination buffer, at least 21 bytes.
+ * @return Pointer to the formatted string within `buf`.
+ */
+static const char *u64_to_dec(uint64_t value, char *buf) {
+  char *p = &buf[20];
+  *p = '\0';
+  do {
+    *--p = (char)('0' + value % 10);
+    value /= 10;
+  } while (value != 0);
+  return p;
+}
+
+/**
+ * Runs one benchmark with one parameter and prints the CSV line.
+ */
+static status_t benchmark_run(const benchmark_t *bench, size_t param) {
+  uint32_t top = 0;
+  stack_paint();
+  uint64_t t_start = ibex_mcycle_read();
+  status_t result = bench->run(param);
+  uint64_t cycles = ibex_mcycle_read() - t_start;
+  size_t stack = stack_used(&top);
+  if (!status_ok(result)) {
+    LOG_ERROR("%s(%u) failed", bench->name, param);
+    return result;
+  }
+
+  char cycles_str[21];
+  uint32_t otbn_insns = bench->otbn ? otbn_instruction_count_get() : 0;
+  base_printf("BENCH,%s,%u,%s,%u,%u\r\n", bench->name, param,
+              u64_to_dec(cycles, cycles_str), otbn_insns, stack);
+  return OTCRYPTO_OK;
+}
+
+/**
+ * Generates the symmetric keys and fills the input buffer.
+ */
+static status_t benchmark_setup(void) {
+  otcrypto_blinded_key_t *keys[] = {
+      &aes_ecb_key,  &aes_cbc_key,     &aes_cfb_key,  &aes_ofb_key,
+      &aes_ctr_key,  &aes_gcm_key,     &aes_kwp_key,  &hmac256_key,
+      &hmac384_key,  &hmac512_key,     &kmac128_key,  &kmac256_key,
+      &kdf_hmac_key, &kdf_kmac_key,
+  };
+  for (size_t i = 0; i < ARRAYSIZE(keys); i++) {
+    TRY(otcrypto_symmetric_keygen(kEmpty, keys[i]));
+  }
+
+  TRY(otcrypto_drbg_instantiate(kEmpty));
+  TRY(otcrypto_drbg_generate(
+      kEmpty, (otcrypto_word32_buf_t){.data = (uint32_t *)input,
+                                      .len = sizeof(input) / sizeof(uint32_t)}));
+  memcpy(iv_data, input, sizeof(iv_data));
+  TRY(otcrypto_hash(input_buf(64), digest));
+  return OTCRYPTO_OK;
+}
+
+OTTF_DEFINE_TEST_CONFIG();
+
+bool test_main(void) {
+  CHECK_STATUS_OK(entropy_testutils_auto_mode_init());
+  CHECK_STATUS_OK(benchmark_setup());
+
+  base_printf("BENCH,operation,param,cycles,otbn_instructions,stack_bytes\r\n");
+  status_t result = OK_STATUS();
+  for (size_t i = 0; i < ARRAYSIZE(kBenchmarks); i++) {
+    const benchmark_t *bench = &kBenchmarks[i];
+    for (size_t j = 0; j < bench->num_params; j++) {
+      status_t err = benchmark_run(bench, bench->params[j]);
+      if (!status_ok(err)) {
+        result = err;
+      }
+    }
+  }
+  return status_ok(result);
+}
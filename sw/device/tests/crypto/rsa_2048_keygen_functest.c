@@ -125,6 +125,26 @@ status_t keygen_then_sign_test(void) {
   return OK_STATUS();
 }
 
+status_t prime_pool_keygen_test(void) {
+  TRY(otcrypto_rsa_prime_pool_enable(kHardenedBoolTrue, kOtcryptoRsaSize2048));
+
+  // Generate two primes, enough for one key.
+  LOG_INFO("Filling prime pool...");
+  size_t num_primes = 0;
+  TRY(otcrypto_rsa_prime_pool_refill(&num_primes));
+  TRY_CHECK(num_primes == 1);
+  TRY(otcrypto_rsa_prime_pool_refill(&num_primes));
+  TRY_CHECK(num_primes == 2);
+
+  // Key generation should use up both primes.
+  TRY(keygen_then_sign_test());
+  TRY(otcrypto_rsa_prime_pool_refill(&num_primes));
+  TRY_CHECK(num_primes == 1);
+
+  return otcrypto_rsa_prime_pool_enable(kHardenedBoolFalse,
+                                        kOtcryptoRsaSize2048);
+}
+
 OTTF_DEFINE_TEST_CONFIG();
 
 bool test_main(void) {
@@ -132,5 +152,6 @@ bool test_main(void) {
 
   status_t test_result = OK_STATUS();
   EXECUTE_TEST(test_result, keygen_then_sign_test);
+  EXECUTE_TEST(test_result, prime_pool_keygen_test);
   return status_ok(test_result);
 }
@@ -2,6 +2,7 @@
 // Licensed under the Apache License, Version 2.0, see LICENSE for details.
 // SPDX-License-Identifier: Apache-2.0
 
+#include "sw/device/lib/base/macros.h"
 #include "sw/device/lib/crypto/drivers/entropy.h"
 #include "sw/device/lib/crypto/drivers/hmac.h"
 #include "sw/device/lib/crypto/include/datatypes.h"
@@ -167,6 +168,112 @@ static status_t multiple_update_streaming_test(void) {
   return OK_STATUS();
 }
 
+/**
+ * Expected digests for `kExactBlockMessage` fed three times and
+ * `kTwoBlockMessage` fed four times.
+ *
+ * Computed with Python's `hashlib.sha256`.
+ */
+static const uint8_t kExactBlockX3ExpDigest[] = {
+    0x4b, 0xda, 0xf0, 0xc2, 0xd3, 0x51, 0x11, 0x4b, 0x2b, 0xa0, 0x55,
+    0xd7, 0xc3, 0x94, 0x13, 0x83, 0xc2, 0x0f, 0x5a, 0xa4, 0xc6, 0xb6,
+    0x2f, 0xc4, 0x7e, 0x04, 0x72, 0xd4, 0xc2, 0xf5, 0xeb, 0x0d,
+};
+static const uint8_t kTwoBlockX4ExpDigest[] = {
+    0xc7, 0xf1, 0xc8, 0xa2, 0x06, 0x73, 0xc7, 0xb6, 0x32, 0x15, 0xbe,
+    0x59, 0x41, 0x6f, 0x71, 0x2f, 0x9e, 0x4a, 0x3d, 0xbd, 0x1f, 0x43,
+    0xf6, 0x9d, 0xb1, 0xee, 0x27, 0xa1, 0x63, 0x3d, 0x35, 0x5c,
+};
+
+/**
+ * Finalize `ctx` and compare against `exp_digest`.
+ */
+static status_t finalize_and_check(otcrypto_hash_context_t *ctx,
+                                   const uint8_t *exp_digest) {
+  uint32_t act_digest[kHmacSha256DigestWords];
+  otcrypto_hash_digest_t digest_buf = {
+      .data = act_digest,
+      .len = kHmacSha256DigestWords,
+      .mode = kOtcryptoHashModeSha256,
+  };
+  TRY(otcrypto_hash_final(ctx, digest_buf));
+  TRY_CHECK_ARRAYS_EQ((unsigned char *)act_digest, exp_digest,
+                      kHmacSha256DigestBytes);
+  return OK_STATUS();
+}
+
+/**
+ * Test streaming API with interleaved streams and a copied context.
+ *
+ * Checks that switching streams, and advancing an old copy of a stream,
+ * restore the right state into HWIP.
+ */
+static status_t interleaved_streaming_test(void) {
+  otcrypto_hash_context_t ctx_a;
+  otcrypto_hash_context_t ctx_a_copy;
+  otcrypto_hash_context_t ctx_b;
+  TRY(otcrypto_hash_init(&ctx_a, kOtcryptoHashModeSha256));
+  TRY(otcrypto_hash_init(&ctx_b, kOtcryptoHashModeSha256));
+
+  otcrypto_const_byte_buf_t exact_buf = {
+      .data = kExactBlockMessage,
+      .len = kExactBlockMessageLen,
+  };
+  otcrypto_const_byte_buf_t two_block_buf = {
+      .data = kTwoBlockMessage,
+      .len = kTwoBlockMessageLen,
+  };
+
+  TRY(otcrypto_hash_update(&ctx_a, exact_buf));
+  ctx_a_copy = ctx_a;
+  TRY(otcrypto_hash_update(&ctx_a, exact_buf));
+  TRY(otcrypto_hash_update(&ctx_b, two_block_buf));
+  TRY(otcrypto_hash_update(&ctx_b, two_block_buf));
+  TRY(otcrypto_hash_update(&ctx_a, exact_buf));
+  TRY(otcrypto_hash_update(&ctx_b, two_block_buf));
+  TRY(otcrypto_hash_update(&ctx_b, two_block_buf));
+  TRY(finalize_and_check(&ctx_b, kTwoBlockX4ExpDigest));
+  TRY(finalize_and_check(&ctx_a, kExactBlockX3ExpDigest));
+
+  // The copy was taken after the first update of `ctx_a`.
+  TRY(otcrypto_hash_update(&ctx_a_copy, exact_buf));
+  TRY(otcrypto_hash_update(&ctx_a_copy, exact_buf));
+  return finalize_and_check(&ctx_a_copy, kExactBlockX3ExpDigest);
+}
+
+/**
+ * Test the batch API against the single-message results.
+ */
+static status_t batch_test(void) {
+  const otcrypto_const_byte_buf_t msgs[] = {
+      {.data = kExactBlockMessage, .len = kExactBlockMessageLen},
+      {.data = NULL, .len = 0},
+      {.data = kTwoBlockMessage, .len = kTwoBlockMessageLen},
+  };
+  uint32_t act_digests[ARRAYSIZE(msgs)][kHmacSha256DigestWords];
+  otcrypto_hash_digest_t digest_bufs[ARRAYSIZE(msgs)];
+  for (size_t i = 0; i < ARRAYSIZE(msgs); i++) {
+    digest_bufs[i] = (otcrypto_hash_digest_t){
+        .data = act_digests[i],
+        .len = kHmacSha256DigestWords,
+        .mode = kOtcryptoHashModeSha256,
+    };
+  }
+  TRY(otcrypto_hash_batch(msgs, ARRAYSIZE(msgs), digest_bufs));
+
+  for (size_t i = 0; i < ARRAYSIZE(msgs); i++) {
+    uint32_t exp_digest[kHmacSha256DigestWords];
+    otcrypto_hash_digest_t exp_buf = {
+        .data = exp_digest,
+        .len = kHmacSha256DigestWords,
+        .mode = kOtcryptoHashModeSha256,
+    };
+    TRY(otcrypto_hash(msgs[i], exp_buf));
+    TRY_CHECK_ARRAYS_EQ(act_digests[i], exp_digest, kHmacSha256DigestWords);
+  }
+  return OK_STATUS();
+}
+
 OTTF_DEFINE_TEST_CONFIG();
 
 bool test_main(void) {
@@ -176,5 +283,7 @@ bool test_main(void) {
   EXECUTE_TEST(test_result, empty_test);
   EXECUTE_TEST(test_result, one_update_streaming_test);
   EXECUTE_TEST(test_result, multiple_update_streaming_test);
+  EXECUTE_TEST(test_result, interleaved_streaming_test);
+  EXECUTE_TEST(test_result, batch_test);
   return status_ok(test_result);
 }
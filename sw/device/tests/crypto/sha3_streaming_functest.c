@@ -0,0 +1,162 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "sw/device/lib/base/macros.h"
+#include "sw/device/lib/crypto/drivers/entropy.h"
+#include "sw/device/lib/crypto/drivers/kmac.h"
+#include "sw/device/lib/crypto/include/datatypes.h"
+#include "sw/device/lib/crypto/include/hash.h"
+#include "sw/device/lib/runtime/log.h"
+#include "sw/device/lib/testing/test_framework/check.h"
+#include "sw/device/lib/testing/test_framework/ottf_main.h"
+
+// Module ID for status codes.
+#define MODULE_ID MAKE_MODULE_ID('s', '3', 't')
+
+/**
+ * Two-block (for SHA-2) test message.
+ *
+ * Expected outputs computed with Python's `hashlib`:
+ *   hashlib.sha3_256(msg).digest()
+ *   hashlib.shake_128(msg).digest(200)
+ */
+static const unsigned char kMessage[] =
+    "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+static const size_t kMessageLen = sizeof(kMessage) - 1;
+static const uint8_t kSha3_256ExpDigest[] = {
+    0x41, 0xc0, 0xdb, 0xa2, 0xa9, 0xd6, 0x24, 0x08, 0x49, 0x10, 0x03, 0x76,
+    0xa8, 0x23, 0x5e, 0x2c, 0x82, 0xe1, 0xb9, 0x99, 0x8a, 0x99, 0x9e, 0x21,
+    0xdb, 0x32, 0xdd, 0x97, 0x49, 0x6d, 0x33, 0x76,
+};
+// 200 bytes, longer than one SHAKE128 rate block (168 bytes).
+static const uint8_t kShake128ExpOutput[] = {
+    0x1a, 0x96, 0x18, 0x2b, 0x50, 0xfb, 0x8c, 0x7e, 0x74, 0xe0, 0xa7, 0x07,
+    0x78, 0x8f, 0x55, 0xe9, 0x82, 0x09, 0xb8, 0xd9, 0x1f, 0xad, 0xe8, 0xf3,
+    0x2f, 0x8d, 0xd5, 0xcf, 0xf7, 0xbf, 0x21, 0xf5, 0x4e, 0xe5, 0xf1, 0x95,
+    0x50, 0x82, 0x5a, 0x6e, 0x07, 0x00, 0x30, 0x51, 0x9e, 0x94, 0x42, 0x63,
+    0xac, 0x1c, 0x67, 0x65, 0x28, 0x70, 0x65, 0x62, 0x1f, 0x9f, 0xcb, 0x32,
+    0x01, 0x72, 0x3e, 0x32, 0x23, 0xb6, 0x3a, 0x46, 0xc2, 0x93, 0x8a, 0xa9,
+    0x53, 0xba, 0x84, 0x01, 0xd0, 0xea, 0x77, 0xb8, 0xd2, 0x64, 0x90, 0x77,
+    0x55, 0x66, 0x40, 0x7b, 0x95, 0x67, 0x3c, 0x0f, 0x4c, 0xc1, 0xce, 0x9f,
+    0xd9, 0x66, 0x14, 0x8d, 0x7e, 0xfd, 0xff, 0x26, 0xbb, 0xf9, 0xf4, 0x8a,
+    0x21, 0xc6, 0xda, 0x35, 0xbf, 0xaa, 0x54, 0x56, 0x54, 0xf7, 0x0a, 0xe5,
+    0x86, 0xff, 0x10, 0x13, 0x14, 0x20, 0x77, 0x14, 0x83, 0xec, 0x92, 0xed,
+    0xab, 0x40, 0x8c, 0x76, 0x7b, 0xf4, 0xc5, 0xb4, 0xff, 0xfa, 0xa8, 0x0c,
+    0x8c, 0xa2, 0x14, 0xd8, 0x4c, 0x4d, 0xc7, 0x00, 0xd0, 0xc5, 0x06, 0x30,
+    0xb2, 0xff, 0xc3, 0x79, 0x3e, 0xa4, 0xd8, 0x72, 0x58, 0xb4, 0xc9, 0x54,
+    0x8c, 0x54, 0x85, 0xa5, 0xca, 0x66, 0x6e, 0xf7, 0x3f, 0xbd, 0x81, 0x6d,
+    0x41, 0x8a, 0xea, 0x63, 0x95, 0xb5, 0x03, 0xad, 0xdd, 0x9b, 0x15, 0x0f,
+    0x9e, 0x06, 0x63, 0x32, 0x5f, 0x01, 0xe5, 0x51,
+};
+
+/**
+ * Feeds `kMessage` to `ctx` in updates of 0, 1, 2, ... bytes.
+ */
+static status_t absorb_in_pieces(otcrypto_hash_context_t *ctx) {
+  const unsigned char *next = kMessage;
+  size_t len = kMessageLen;
+  size_t update_size = 0;
+  while (len > 0) {
+    update_size = len <= update_size ? len : update_size;
+    otcrypto_const_byte_buf_t msg_buf = {
+        .data = next,
+        .len = update_size,
+    };
+    next += update_size;
+    len -= update_size;
+    update_size++;
+    TRY(otcrypto_hash_update(ctx, msg_buf));
+  }
+  return OK_STATUS();
+}
+
+/**
+ * Test SHA3-256 through the streaming API.
+ */
+static status_t sha3_256_streaming_test(void) {
+  otcrypto_hash_context_t ctx;
+  TRY(otcrypto_hash_init(&ctx, kOtcryptoHashModeSha3_256));
+  TRY(absorb_in_pieces(&ctx));
+
+  uint32_t act_digest[kSha3_256DigestWords];
+  otcrypto_hash_digest_t digest_buf = {
+      .data = act_digest,
+      .len = ARRAYSIZE(act_digest),
+      .mode = kOtcryptoHashModeSha3_256,
+  };
+  TRY(otcrypto_hash_final(&ctx, digest_buf));
+  TRY_CHECK_ARRAYS_EQ((unsigned char *)act_digest, kSha3_256ExpDigest,
+                      sizeof(kSha3_256ExpDigest));
+  return OK_STATUS();
+}
+
+/**
+ * Test SHAKE128 squeezed in chunks that cross a rate block boundary.
+ */
+static status_t shake128_squeeze_test(void) {
+  otcrypto_hash_context_t ctx;
+  TRY(otcrypto_xof_shake_init(&ctx, kOtcryptoHashXofModeShake128));
+  TRY(absorb_in_pieces(&ctx));
+
+  uint32_t act_output[sizeof(kShake128ExpOutput) / sizeof(uint32_t)];
+  const size_t kChunkWords[] = {7, 20, 0, 23};
+  size_t offset = 0;
+  for (size_t i = 0; i < ARRAYSIZE(kChunkWords); i++) {
+    otcrypto_hash_digest_t output_buf = {
+        .data = &act_output[offset],
+        .len = kChunkWords[i],
+        .mode = kOtcryptoHashXofModeShake128,
+    };
+    TRY(otcrypto_xof_squeeze(&ctx, output_buf));
+    offset += kChunkWords[i];
+  }
+  TRY_CHECK(offset == ARRAYSIZE(act_output));
+  TRY(otcrypto_xof_final(&ctx));
+
+  TRY_CHECK_ARRAYS_EQ((unsigned char *)act_output, kShake128ExpOutput,
+                      sizeof(kShake128ExpOutput));
+  return OK_STATUS();
+}
+
+/**
+ * Test that KMAC cannot be used by a second stream while one is active.
+ */
+static status_t exclusive_stream_test(void) {
+  otcrypto_hash_context_t ctx;
+  otcrypto_hash_context_t other_ctx;
+  TRY(otcrypto_hash_init(&ctx, kOtcryptoHashModeSha3_256));
+  TRY_CHECK(!status_ok(otcrypto_hash_init(&other_ctx,
+                                          kOtcryptoHashModeSha3_512)));
+  TRY(absorb_in_pieces(&ctx));
+
+  uint32_t act_digest[kSha3_256DigestWords];
+  otcrypto_hash_digest_t digest_buf = {
+      .data = act_digest,
+      .len = ARRAYSIZE(act_digest),
+      .mode = kOtcryptoHashModeSha3_256,
+  };
+  TRY(otcrypto_hash_final(&ctx, digest_buf));
+  TRY_CHECK_ARRAYS_EQ((unsigned char *)act_digest, kSha3_256ExpDigest,
+                      sizeof(kSha3_256ExpDigest));
+
+  // Once the first stream is done, KMAC is available again.
+  TRY(otcrypto_hash_init(&other_ctx, kOtcryptoHashModeSha3_256));
+  TRY(absorb_in_pieces(&other_ctx));
+  TRY(otcrypto_hash_final(&other_ctx, digest_buf));
+  TRY_CHECK_ARRAYS_EQ((unsigned char *)act_digest, kSha3_256ExpDigest,
+                      sizeof(kSha3_256ExpDigest));
+  return OK_STATUS();
+}
+
+OTTF_DEFINE_TEST_CONFIG();
+
+bool test_main(void) {
+  status_t test_result = OK_STATUS();
+  CHECK_STATUS_OK(entropy_complex_init());
+  CHECK_STATUS_OK(kmac_hwip_default_configure());
+  EXECUTE_TEST(test_result, sha3_256_streaming_test);
+  EXECUTE_TEST(test_result, shake128_squeeze_test);
+  EXECUTE_TEST(test_result, exclusive_stream_test);
+  return status_ok(test_result);
+}
@@ -104,6 +104,33 @@ status_t sha512_streaming_test(const unsigned char *msg, size_t msg_len,
   return OTCRYPTO_OK;
 }
 
+/**
+ * Run a test using the asynchronous OTBN SHA-512 API.
+ */
+status_t sha512_async_test(const unsigned char *msg, size_t msg_len,
+                           const uint8_t *expected_digest) {
+  otcrypto_const_byte_buf_t input_message = {
+      .data = msg,
+      .len = msg_len,
+  };
+  TRY(otcrypto_hash_async_start(input_message, kOtcryptoHashModeSha512));
+
+  // Allocate space for the computed digest.
+  uint32_t actual_digest_data[512 / 32];
+  otcrypto_hash_digest_t actual_digest = {
+      .data = actual_digest_data,
+      .len = ARRAYSIZE(actual_digest_data),
+      .mode = kOtcryptoHashModeSha512,
+  };
+  TRY(otcrypto_hash_async_finalize(actual_digest));
+
+  // Check that the expected and actual digests match.
+  TRY_CHECK_ARRAYS_EQ((unsigned char *)actual_digest_data, expected_digest,
+                      sizeof(actual_digest_data));
+
+  return OTCRYPTO_OK;
+}
+
 static status_t one_block_test(void) {
   return sha512_test(kOneBlockMessage, kOneBlockMessageLen, kOneBlockExpDigest);
 }
@@ -117,6 +144,70 @@ static status_t streaming_test(void) {
                                kTwoBlockExpDigest);
 }
 
+static status_t async_test(void) {
+  TRY(sha512_async_test(kOneBlockMessage, kOneBlockMessageLen,
+                        kOneBlockExpDigest));
+  return sha512_async_test(kTwoBlockMessage, kTwoBlockMessageLen,
+                           kTwoBlockExpDigest);
+}
+
+enum {
+  /**
+   * Length of the long messages for the parallel test; more than two OTBN
+   * runs of 16 blocks each.
+   */
+  kLongMessageLen = 5000,
+  /**
+   * Number of messages for the parallel test.
+   */
+  kParallelNumMessages = 5,
+};
+
+static uint8_t long_messages[kParallelNumMessages][kLongMessageLen];
+
+/**
+ * Hash several long messages with `otcrypto_hash_parallel`, so that both OTBN
+ * and the HMAC block get some, and check them against `otcrypto_hash`.
+ */
+static status_t parallel_test(void) {
+  for (size_t i = 0; i < kParallelNumMessages; i++) {
+    for (size_t j = 0; j < kLongMessageLen; j++) {
+      long_messages[i][j] = (uint8_t)(i * 31 + j * 7);
+    }
+  }
+
+  // Vary the lengths to cover different padding cases, and mix in a SHA-256
+  // message that OTBN can't take.
+  const otcrypto_const_byte_buf_t input_messages[kParallelNumMessages] = {
+      {.data = long_messages[0], .len = kLongMessageLen},
+      {.data = long_messages[1], .len = kLongMessageLen - 100},
+      {.data = long_messages[2], .len = kLongMessageLen - 3},
+      {.data = long_messages[3], .len = 2048},
+      {.data = long_messages[4], .len = 2047},
+  };
+  otcrypto_hash_digest_t digests[kParallelNumMessages];
+  uint32_t digest_data[kParallelNumMessages][512 / 32];
+  for (size_t i = 0; i < kParallelNumMessages; i++) {
+    otcrypto_hash_mode_t mode =
+        i == 2 ? kOtcryptoHashModeSha256 : kOtcryptoHashModeSha512;
+    digests[i] = (otcrypto_hash_digest_t){
+        .data = digest_data[i],
+        .len = mode == kOtcryptoHashModeSha256 ? 256 / 32 : 512 / 32,
+        .mode = mode,
+    };
+  }
+  TRY(otcrypto_hash_parallel(input_messages, kParallelNumMessages, digests));
+
+  for (size_t i = 0; i < kParallelNumMessages; i++) {
+    uint32_t exp_digest_data[512 / 32];
+    otcrypto_hash_digest_t exp_digest = digests[i];
+    exp_digest.data = exp_digest_data;
+    TRY(otcrypto_hash(input_messages[i], exp_digest));
+    TRY_CHECK_ARRAYS_EQ(digest_data[i], exp_digest_data, digests[i].len);
+  }
+  return OTCRYPTO_OK;
+}
+
 OTTF_DEFINE_TEST_CONFIG();
 
 // Holds the test result.
@@ -128,5 +219,7 @@ bool test_main(void) {
   EXECUTE_TEST(test_result, one_block_test);
   EXECUTE_TEST(test_result, two_block_test);
   EXECUTE_TEST(test_result, streaming_test);
+  EXECUTE_TEST(test_result, async_test);
+  EXECUTE_TEST(test_result, parallel_test);
   return status_ok(test_result);
 }
@@ -0,0 +1,221 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "sw/device/lib/base/memory.h"
+#include "sw/device/lib/crypto/drivers/otbn.h"
+#include "sw/device/lib/crypto/impl/integrity.h"
+#include "sw/device/lib/crypto/impl/keyblob.h"
+#include "sw/device/lib/crypto/include/datatypes.h"
+#include "sw/device/lib/crypto/include/x25519.h"
+#include "sw/device/lib/runtime/log.h"
+#include "sw/device/lib/testing/entropy_testutils.h"
+#include "sw/device/lib/testing/profile.h"
+#include "sw/device/lib/testing/test_framework/check.h"
+#include "sw/device/lib/testing/test_framework/ottf_main.h"
+
+enum {
+  /* Number of bytes in an X25519 private key. */
+  kX25519PrivateKeyBytes = 256 / 8,
+  /* Number of 32-bit words in an X25519 public key. */
+  kX25519PublicKeyWords = 256 / 32,
+  /* Number of bytes in an X25519 shared key. */
+  kX25519SharedKeyBytes = 256 / 8,
+  /* Number of 32-bit words in an X25519 shared key. */
+  kX25519SharedKeyWords = kX25519SharedKeyBytes / sizeof(uint32_t),
+};
+
+// Configuration for the private key.
+static const otcrypto_key_config_t kX25519PrivateKeyConfig = {
+    .version = kOtcryptoLibVersion1,
+    .key_mode = kOtcryptoKeyModeX25519,
+    .key_length = kX25519PrivateKeyBytes,
+    .hw_backed = kHardenedBoolFalse,
+    .security_level = kOtcryptoKeySecurityLevelLow,
+};
+
+// Configuration for the shared (symmetric) key. As for ECDH/P-256, any
+// symmetric mode that supports 256-bit keys is OK here.
+static const otcrypto_key_config_t kX25519SharedKeyConfig = {
+    .version = kOtcryptoLibVersion1,
+    .key_mode = kOtcryptoKeyModeAesCtr,
+    .key_length = kX25519SharedKeyBytes,
+    .hw_backed = kHardenedBoolFalse,
+    .security_level = kOtcryptoKeySecurityLevelLow,
+};
+
+// RFC 7748, section 6.1: Alice's private key, Bob's public key and the shared
+// secret.
+static const uint8_t kAlicePrivateKey[kX25519PrivateKeyBytes] = {
+    0x77, 0x07, 0x6d, 0x0a, 0x73, 0x18, 0xa5, 0x7d, 0x3c, 0x16, 0xc1,
+    0x72, 0x51, 0xb2, 0x66, 0x45, 0xdf, 0x4c, 0x2f, 0x87, 0xeb, 0xc0,
+    0x99, 0x2a, 0xb1, 0x77, 0xfb, 0xa5, 0x1d, 0xb9, 0x2c, 0x2a,
+};
+static const uint8_t kBobPublicKey[kX25519PublicKeyWords * sizeof(uint32_t)] =
+    {
+        0xde, 0x9e, 0xdb, 0x7d, 0x7b, 0x7d, 0xc1, 0xb4, 0xd3, 0x5b, 0x61,
+        0xc2, 0xec, 0xe4, 0x35, 0x37, 0x3f, 0x83, 0x43, 0xc8, 0x5b, 0x78,
+        0x67, 0x4d, 0xad, 0xfc, 0x7e, 0x14, 0x6f, 0x88, 0x2b, 0x4f,
+};
+static const uint8_t kSharedSecret[kX25519SharedKeyBytes] = {
+    0x4a, 0x5d, 0x9d, 0x5b, 0xa4, 0xce, 0x2d, 0xe1, 0x72, 0x8e, 0x3b,
+    0xf4, 0x80, 0x35, 0x0f, 0x25, 0xe0, 0x7e, 0x21, 0xc9, 0x47, 0xd1,
+    0x9e, 0x33, 0x76, 0xf0, 0x9b, 0x3c, 0x1e, 0x16, 0x17, 0x42,
+};
+
+/**
+ * Unmask a shared key into `key`.
+ */
+static status_t shared_key_unmask(const otcrypto_blinded_key_t *shared_key,
+                                  uint32_t key[kX25519SharedKeyWords]) {
+  uint32_t *share0;
+  uint32_t *share1;
+  TRY(keyblob_to_shares(shared_key, &share0, &share1));
+  for (size_t i = 0; i < kX25519SharedKeyWords; i++) {
+    key[i] = share0[i] ^ share1[i];
+  }
+  return OTCRYPTO_OK;
+}
+
+static status_t known_answer_test(void) {
+  // Import Alice's private key as unmasked shares.
+  uint32_t share0[keyblob_share_num_words(kX25519PrivateKeyConfig)];
+  uint32_t share1[keyblob_share_num_words(kX25519PrivateKeyConfig)];
+  memset(share0, 0, sizeof(share0));
+  memset(share1, 0, sizeof(share1));
+  memcpy(share0, kAlicePrivateKey, sizeof(kAlicePrivateKey));
+  uint32_t keyblob[keyblob_num_words(kX25519PrivateKeyConfig)];
+  keyblob_from_shares(share0, share1, kX25519PrivateKeyConfig, keyblob);
+  otcrypto_blinded_key_t private_key = {
+      .config = kX25519PrivateKeyConfig,
+      .keyblob_length = sizeof(keyblob),
+      .keyblob = keyblob,
+  };
+  private_key.checksum = integrity_blinded_checksum(&private_key);
+
+  uint32_t pk[kX25519PublicKeyWords];
+  memcpy(pk, kBobPublicKey, sizeof(pk));
+  otcrypto_unblinded_key_t public_key = {
+      .key_mode = kOtcryptoKeyModeX25519,
+      .key_length = sizeof(pk),
+      .key = pk,
+  };
+  public_key.checksum = integrity_unblinded_checksum(&public_key);
+
+  uint32_t shared_keyblob[keyblob_num_words(kX25519SharedKeyConfig)];
+  otcrypto_blinded_key_t shared_key = {
+      .config = kX25519SharedKeyConfig,
+      .keyblob_length = sizeof(shared_keyblob),
+      .keyblob = shared_keyblob,
+      .checksum = 0,
+  };
+  uint64_t t_start = profile_start();
+  TRY(otcrypto_x25519(&private_key, &public_key, &shared_key));
+  profile_end_and_print(t_start, "X25519");
+
+  uint32_t key[kX25519SharedKeyWords];
+  TRY(shared_key_unmask(&shared_key, key));
+  TRY_CHECK_ARRAYS_EQ((uint8_t *)key, kSharedSecret, sizeof(kSharedSecret));
+
+  // The all-zero u-coordinate is a low-order point and must be rejected.
+  memset(pk, 0, sizeof(pk));
+  public_key.checksum = integrity_unblinded_checksum(&public_key);
+  TRY_CHECK(!status_ok(otcrypto_x25519(&private_key, &public_key,
+                                       &shared_key)));
+
+  return OTCRYPTO_OK;
+}
+
+static status_t key_exchange_test(void) {
+  // Allocate space for two private keys.
+  uint32_t keyblobA[keyblob_num_words(kX25519PrivateKeyConfig)];
+  otcrypto_blinded_key_t private_keyA = {
+      .config = kX25519PrivateKeyConfig,
+      .keyblob_length = sizeof(keyblobA),
+      .keyblob = keyblobA,
+      .checksum = 0,
+  };
+  uint32_t keyblobB[keyblob_num_words(kX25519PrivateKeyConfig)];
+  otcrypto_blinded_key_t private_keyB = {
+      .config = kX25519PrivateKeyConfig,
+      .keyblob_length = sizeof(keyblobB),
+      .keyblob = keyblobB,
+      .checksum = 0,
+  };
+
+  // Allocate space for two public keys.
+  uint32_t pkA[kX25519PublicKeyWords] = {0};
+  uint32_t pkB[kX25519PublicKeyWords] = {0};
+  otcrypto_unblinded_key_t public_keyA = {
+      .key_mode = kOtcryptoKeyModeX25519,
+      .key_length = sizeof(pkA),
+      .key = pkA,
+  };
+  otcrypto_unblinded_key_t public_keyB = {
+      .key_mode = kOtcryptoKeyModeX25519,
+      .key_length = sizeof(pkB),
+      .key = pkB,
+  };
+
+  LOG_INFO("Generating keypair A...");
+  uint64_t t_start = profile_start();
+  TRY(otcrypto_x25519_keygen(&private_keyA, &public_keyA));
+  profile_end_and_print(t_start, "X25519 keygen");
+
+  LOG_INFO("Generating keypair B...");
+  TRY(otcrypto_x25519_keygen(&private_keyB, &public_keyB));
+
+  // Sanity check; public keys should be different from each other.
+  CHECK_ARRAYS_NE(pkA, pkB, ARRAYSIZE(pkA));
+
+  // Allocate space for two shared keys.
+  uint32_t shared_keyblobA[keyblob_num_words(kX25519SharedKeyConfig)];
+  otcrypto_blinded_key_t shared_keyA = {
+      .config = kX25519SharedKeyConfig,
+      .keyblob_length = sizeof(shared_keyblobA),
+      .keyblob = shared_keyblobA,
+      .checksum = 0,
+  };
+  uint32_t shared_keyblobB[keyblob_num_words(kX25519SharedKeyConfig)];
+  otcrypto_blinded_key_t shared_keyB = {
+      .config = kX25519SharedKeyConfig,
+      .keyblob_length = sizeof(shared_keyblobB),
+      .keyblob = shared_keyblobB,
+      .checksum = 0,
+  };
+
+  LOG_INFO("Generating shared secret (A)...");
+  TRY(otcrypto_x25519(&private_keyA, &public_keyB, &shared_keyA));
+  LOG_INFO("Generating shared secret (B)...");
+  TRY(otcrypto_x25519(&private_keyB, &public_keyA, &shared_keyB));
+
+  // Unmask the keys and check that they match.
+  uint32_t keyA[kX25519SharedKeyWords];
+  uint32_t keyB[kX25519SharedKeyWords];
+  TRY(shared_key_unmask(&shared_keyA, keyA));
+  TRY(shared_key_unmask(&shared_keyB, keyB));
+  CHECK_ARRAYS_EQ(keyA, keyB, ARRAYSIZE(keyA));
+
+  return OTCRYPTO_OK;
+}
+
+OTTF_DEFINE_TEST_CONFIG();
+
+bool test_main(void) {
+  CHECK_STATUS_OK(entropy_testutils_auto_mode_init());
+
+  status_t err = known_answer_test();
+  if (status_ok(err)) {
+    err = key_exchange_test();
+  }
+  if (!status_ok(err)) {
+    // If there was an error, print the OTBN error bits and instruction count.
+    LOG_INFO("OTBN error bits: 0x%08x", otbn_err_bits_get());
+    LOG_INFO("OTBN instruction count: 0x%08x", otbn_instruction_count_get());
+    // Print the error.
+    CHECK_STATUS_OK(err);
+    return false;
+  }
+
+  return true;
+}
@@ -182,9 +182,9 @@ status_t firmware_override_observe(
     TRY_CHECK(!ibex_timeout_check(&tmo), "did not collect samples in time");
     uint64_t elapsed = ibex_timeout_elapsed(&tmo);
     uint64_t freq =
-        udiv64_slow((uint64_t)nr_samples * (uint64_t)1000000, elapsed, NULL);
+        udiv64((uint64_t)nr_samples * (uint64_t)1000000, elapsed, NULL);
     LOG_INFO("done in %ums (~ %usamples/s)",
-             (uint32_t)udiv64_slow(elapsed, 1000, NULL), (uint32_t)freq);
+             (uint32_t)udiv64(elapsed, 1000, NULL), (uint32_t)freq);
 
     // Let observe FIFO overflow
     if (repeat_count > 0) {
@@ -0,0 +1,422 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "sw/device/lib/base/bitfield.h"
+#include "sw/device/lib/base/memory.h"
+#include "sw/device/lib/base/mmio.h"
+#include "sw/device/lib/dif/dif_base.h"
+#include "sw/device/lib/dif/dif_entropy_src.h"
+#include "sw/device/lib/dif/dif_pinmux.h"
+#include "sw/device/lib/runtime/ibex.h"
+#include "sw/device/lib/runtime/log.h"
+#include "sw/device/lib/testing/edn_testutils.h"
+#include "sw/device/lib/testing/entropy_src_testutils.h"
+#include "sw/device/lib/testing/entropy_testutils.h"
+#include "sw/device/lib/testing/json/entropy_src_stream.h"
+#include "sw/device/lib/testing/pinmux_testutils.h"
+#include "sw/device/lib/testing/randomness_quality.h"
+#include "sw/device/lib/testing/test_framework/check.h"
+#include "sw/device/lib/testing/test_framework/ottf_main.h"
+#include "sw/device/lib/testing/test_framework/ujson_ottf.h"
+#include "sw/device/lib/testing/usb_testutils.h"
+#include "sw/device/lib/testing/usb_testutils_controlep.h"
+#include "sw/device/lib/ujson/ujson.h"
+
+#include "entropy_src_regs.h"                         // Generated.
+#include "hw/top_earlgrey/sw/autogen/top_earlgrey.h"  // Generated.
+
+/**
+ * Streams raw entropy_src samples to the host for SP 800-90B
+ * characterization.
+ *
+ * The host sends an `entropy_src_stream_config_t` over the console. The
+ * device then routes the raw (health tested, unconditioned) samples to the
+ * observe FIFO and sends them in frames over a bulk IN endpoint of the USB
+ * device. While one frame is being sent, the other one is filled from the
+ * observe FIFO.
+ *
+ * The samples of a frame are contiguous. Whenever the observe FIFO overflows
+ * or the hardware drops health tested bits, the frame being filled is
+ * discarded and its sequence number is skipped, such that the host can tell
+ * where the contiguous runs of samples end.
+ *
+ * Once all frames have been sent, the device replies with an
+ * `entropy_src_stream_summary_t`.
+ */
+
+OTTF_DEFINE_TEST_CONFIG();
+
+enum {
+  kEntropySrcHealthTestWindowSize = 0x200,
+  /**
+   * Observe FIFO threshold: half of the FIFO size.
+   */
+  kEntropySrcFifoThreshold = ENTROPY_SRC_PARAM_OBSERVE_FIFO_DEPTH / 2,
+  /**
+   * Number of sample words in a frame.
+   */
+  kFrameWords = 1024,
+  /**
+   * Frame header magic, "ESRW" in little endian.
+   */
+  kFrameMagic = 0x57525345,
+  /**
+   * USB endpoint of the sample stream.
+   */
+  kStreamEndpoint = 1,
+  /**
+   * Size of the blocks of samples that are checked with the monobit test.
+   * The checks run in between reads of the observe FIFO, so each block must
+   * be small enough to not let the FIFO overflow.
+   */
+  kQualityBlockBytes = 128,
+  /**
+   * Timeout for the USB device to be configured by the host.
+   */
+  kUsbConfigTimeoutUsec = 30 * 1000 * 1000,
+  /**
+   * Timeout for the last frame to be read by the host.
+   */
+  kUsbSendTimeoutUsec = 5 * 1000 * 1000,
+};
+
+/**
+ * A frame of samples, as sent over USB.
+ */
+typedef struct stream_frame {
+  /**
+   * `kFrameMagic`.
+   */
+  uint32_t magic;
+  /**
+   * Sequence number of the frame. Skipped sequence numbers are frames that
+   * were discarded.
+   */
+  uint32_t seq;
+  /**
+   * Number of sample words in `data`.
+   */
+  uint32_t words;
+  uint32_t reserved;
+  uint32_t data[kFrameWords];
+} stream_frame_t;
+
+/**
+ * State of one of the two frame buffers.
+ */
+typedef struct stream_buffer {
+  stream_frame_t frame;
+  /**
+   * Number of sample words read into the frame.
+   */
+  size_t fill;
+  /**
+   * Offset of the next block to check, or `sizeof(frame.data)` when all
+   * blocks have been checked.
+   */
+  size_t check_offset;
+} stream_buffer_t;
+
+static dif_entropy_src_t entropy_src;
+static dif_csrng_t csrng;
+static dif_edn_t edn0;
+static dif_edn_t edn1;
+static dif_pinmux_t pinmux;
+
+static usb_testutils_ctx_t usbdev;
+static usb_testutils_controlep_ctx_t usbdev_control;
+
+static stream_buffer_t buffers[2];
+/**
+ * Whether a frame is being sent over USB. There is at most one transfer in
+ * flight on the endpoint.
+ */
+static volatile bool frame_in_flight;
+
+static uint8_t config_descriptors[] = {
+    USB_CFG_DSCR_HEAD(
+        USB_CFG_DSCR_LEN + USB_INTERFACE_DSCR_LEN + USB_EP_DSCR_LEN, 1),
+    VEND_INTERFACE_DSCR(0, 1, 0x50, 1),
+    USB_BULK_EP_DSCR(1, kStreamEndpoint, USBDEV_MAX_PACKET_SIZE, 0),
+};
+
+/**
+ * Callback for the completion of a frame transfer.
+ */
+static status_t frame_sent(void *ctx, usb_testutils_xfr_result_t result) {
+  TRY_CHECK(result == kUsbTestutilsXfrResultOk, "frame transfer failed: %d",
+            result);
+  frame_in_flight = false;
+  return OK_STATUS();
+}
+
+/**
+ * Bring up the USB device and wait for the host to configure it.
+ */
+static status_t usb_init(void) {
+  TRY(dif_pinmux_init(mmio_region_from_addr(TOP_EARLGREY_PINMUX_AON_BASE_ADDR),
+                      &pinmux));
+  pinmux_testutils_init(&pinmux);
+  TRY(dif_pinmux_input_select(&pinmux,
+                              kTopEarlgreyPinmuxPeripheralInUsbdevSense,
+                              kTopEarlgreyPinmuxInselIoc7));
+
+  TRY(usb_testutils_init(&usbdev, /*pinflip=*/false, /*en_diff_rcvr=*/true,
+                         /*tx_use_d_se0=*/false));
+  TRY(usb_testutils_controlep_init(&usbdev_control, &usbdev, 0,
+                                   config_descriptors,
+                                   sizeof(config_descriptors), NULL, 0));
+  TRY(usb_testutils_in_endpoint_setup(&usbdev, kStreamEndpoint,
+                                      kUsbTransferTypeBulk, NULL, frame_sent,
+                                      NULL, NULL));
+
+  ibex_timeout_t tmo = ibex_timeout_init(kUsbConfigTimeoutUsec);
+  while (usbdev_control.device_state != kUsbTestutilsDeviceConfigured) {
+    TRY_CHECK(!ibex_timeout_check(&tmo), "USB device not configured in time");
+    TRY(usb_testutils_poll(&usbdev));
+  }
+  return OK_STATUS();
+}
+
+// Configure the entropy complex.
+static status_t entropy_config(
+    dif_entropy_src_single_bit_mode_t single_bit_mode) {
+  dif_edn_auto_params_t edn_params0 =
+      edn_testutils_auto_params_build(false, /*res_itval=*/0, /*glen_val=*/0);
+  dif_edn_auto_params_t edn_params1 =
+      edn_testutils_auto_params_build(false, /*res_itval=*/0, /*glen_val=*/0);
+  // Disable the entropy complex.
+  TRY(entropy_testutils_stop_all());
+  // Disable all health tests.
+  TRY(entropy_src_testutils_disable_health_tests(&entropy_src));
+
+  // Enable FW override.
+  TRY(dif_entropy_src_fw_override_configure(
+      &entropy_src,
+      (dif_entropy_src_fw_override_config_t){
+          .entropy_insert_enable = false,
+          .buffer_threshold = kEntropySrcFifoThreshold,
+      },
+      kDifToggleEnabled));
+  // Enable entropy_src.
+  TRY(dif_entropy_src_configure(
+      &entropy_src,
+      (dif_entropy_src_config_t){
+          .fips_enable = true,
+          .route_to_firmware = false,
+          .bypass_conditioner = false,
+          .single_bit_mode = single_bit_mode,
+          .health_test_threshold_scope = false,
+          .health_test_window_size = kEntropySrcHealthTestWindowSize,
+          .alert_threshold = UINT16_MAX},
+      kDifToggleEnabled));
+
+  // Enable CSRNG
+  TRY(dif_csrng_configure(&csrng));
+  // Enable EDNs in auto request mode
+  TRY(dif_edn_set_auto_mode(&edn0, edn_params0));
+  TRY(dif_edn_set_auto_mode(&edn1, edn_params1));
+  return OK_STATUS();
+}
+
+/**
+ * Determine whether the samples read so far are no longer contiguous with the
+ * ones the observe FIFO holds, i.e. whether the FIFO has overflowed or health
+ * tested bits have been dropped before the postht FIFO.
+ */
+static status_t samples_dropped(bool *dropped) {
+  bool overflowed;
+  TRY(dif_entropy_src_has_fifo_overflowed(&entropy_src, &overflowed));
+  uint32_t recov_alert_sts;
+  TRY(dif_entropy_src_get_recoverable_alerts(&entropy_src, &recov_alert_sts));
+  *dropped = overflowed ||
+             bitfield_bit32_read(
+                 recov_alert_sts,
+                 ENTROPY_SRC_RECOV_ALERT_STS_POSTHT_ENTROPY_DROP_ALERT_BIT);
+  return OK_STATUS();
+}
+
+/**
+ * Discard the samples read so far and restart from an empty observe FIFO.
+ */
+static status_t restart_samples(void) {
+  TRY(dif_entropy_src_clear_recoverable_alerts(
+      &entropy_src, ENTROPY_SRC_RECOV_ALERT_STS_POSTHT_ENTROPY_DROP_ALERT_BIT));
+  TRY(entropy_src_testutils_drain_observe_fifo(&entropy_src));
+  return OK_STATUS();
+}
+
+/**
+ * Read the samples available in the observe FIFO into `buffer`.
+ *
+ * @param buffer The frame buffer being filled.
+ * @param[out] discarded Whether contiguity was lost and the samples read into
+ * `buffer` so far had to be discarded.
+ * @return The result of the operation.
+ */
+static status_t fill_frame(stream_buffer_t *buffer, bool *discarded) {
+  *discarded = false;
+  bool dropped;
+  TRY(samples_dropped(&dropped));
+  if (dropped) {
+    TRY(restart_samples());
+    buffer->fill = 0;
+    *discarded = true;
+    return OK_STATUS();
+  }
+
+  uint32_t depth;
+  TRY(dif_entropy_src_get_fifo_depth(&entropy_src, &depth));
+  // Leave a word in a full FIFO, such that an overflow that happens while
+  // reading is still flagged on the next call.
+  if (depth == ENTROPY_SRC_PARAM_OBSERVE_FIFO_DEPTH) {
+    --depth;
+  }
+  size_t len = kFrameWords - buffer->fill;
+  if (len > depth) {
+    len = depth;
+  }
+  if (len > 0) {
+    TRY(dif_entropy_src_observe_fifo_nonblocking_read(
+        &entropy_src, &buffer->frame.data[buffer->fill], &len));
+    buffer->fill += len;
+  }
+  return OK_STATUS();
+}
+
+/**
+ * Run the monobit test on the next block of a frame, if any.
+ */
+static void check_block(stream_buffer_t *buffer,
+                        entropy_src_stream_summary_t *summary) {
+  if (buffer->check_offset >= sizeof(buffer->frame.data)) {
+    return;
+  }
+  uint8_t *block = (uint8_t *)buffer->frame.data + buffer->check_offset;
+  status_t res = randomness_quality_monobit_test(
+      block, kQualityBlockBytes, kRandomnessQualitySignificanceOnePercent);
+  ++summary->blocks_checked;
+  if (!status_ok(res)) {
+    ++summary->blocks_failed;
+  }
+  buffer->check_offset += kQualityBlockBytes;
+}
+
+/**
+ * Send a full frame over USB.
+ *
+ * @param buffer The frame buffer to send.
+ * @param seq Sequence number of the frame.
+ * @param[out] accepted Whether the transfer was accepted.
+ * @return The result of the operation.
+ */
+static status_t send_frame(stream_buffer_t *buffer, uint32_t seq,
+                           bool *accepted) {
+  buffer->frame.magic = kFrameMagic;
+  buffer->frame.seq = seq;
+  buffer->frame.words = (uint32_t)buffer->fill;
+  buffer->frame.reserved = 0;
+  frame_in_flight = true;
+  *accepted = TRY(usb_testutils_transfer_send(
+      &usbdev, kStreamEndpoint, (const uint8_t *)&buffer->frame,
+      sizeof(buffer->frame), kUsbTestutilsXfrDoubleBuffered));
+  if (!*accepted) {
+    frame_in_flight = false;
+  }
+  return OK_STATUS();
+}
+
+static status_t stream_samples(const entropy_src_stream_config_t *config,
+                               entropy_src_stream_summary_t *summary) {
+  TRY(entropy_config(
+      (dif_entropy_src_single_bit_mode_t)config->single_bit_mode));
+  TRY(restart_samples());
+
+  for (size_t i = 0; i < ARRAYSIZE(buffers); ++i) {
+    buffers[i].fill = 0;
+    buffers[i].check_offset = sizeof(buffers[i].frame.data);
+  }
+  stream_buffer_t *filling = &buffers[0];
+  stream_buffer_t *checking = &buffers[1];
+  uint32_t seq = 0;
+  ibex_timeout_t timer = ibex_timeout_init(0);
+
+  while (summary->frames_sent < config->frames) {
+    TRY(usb_testutils_poll(&usbdev));
+    if (filling->fill < kFrameWords) {
+      bool discarded;
+      TRY(fill_frame(filling, &discarded));
+      if (discarded) {
+        ++seq;
+        ++summary->frames_dropped;
+      }
+    } else if (!frame_in_flight) {
+      // The other frame has been sent, so its remaining blocks must be
+      // checked before it is refilled. While the FIFO is not read, it may
+      // overflow, which the next call to `fill_frame()` notices.
+      while (checking->check_offset < sizeof(checking->frame.data)) {
+        check_block(checking, summary);
+      }
+      bool accepted;
+      TRY(send_frame(filling, seq, &accepted));
+      if (accepted) {
+        ++seq;
+        ++summary->frames_sent;
+        if (config->quality_checks) {
+          filling->check_offset = 0;
+        }
+        stream_buffer_t *next = checking;
+        checking = filling;
+        filling = next;
+        filling->fill = 0;
+      }
+    }
+    // Check one block of the frame being sent per iteration, such that the
+    // observe FIFO is drained often enough.
+    check_block(checking, summary);
+  }
+
+  ibex_timeout_t tmo = ibex_timeout_init(kUsbSendTimeoutUsec);
+  while (frame_in_flight) {
+    TRY_CHECK(!ibex_timeout_check(&tmo), "last frame not sent in time");
+    TRY(usb_testutils_poll(&usbdev));
+  }
+  while (checking->check_offset < sizeof(checking->frame.data)) {
+    check_block(checking, summary);
+  }
+  summary->elapsed_us = ibex_timeout_elapsed(&timer);
+  return OK_STATUS();
+}
+
+static status_t command_processor(ujson_t *uj) {
+  entropy_src_stream_config_t config;
+  TRY(UJSON_WITH_CRC(ujson_deserialize_entropy_src_stream_config_t, uj,
+                     &config));
+  LOG_INFO("Streaming %u frames in mode %u", config.frames,
+           config.single_bit_mode);
+  TRY(usb_init());
+
+  entropy_src_stream_summary_t summary = {0};
+  TRY(stream_samples(&config, &summary));
+  LOG_INFO("Sent %u frames, dropped %u, %u/%u blocks failed monobit",
+           summary.frames_sent, summary.frames_dropped, summary.blocks_failed,
+           summary.blocks_checked);
+  return RESP_OK(ujson_serialize_entropy_src_stream_summary_t, uj, &summary);
+}
+
+bool test_main(void) {
+  CHECK_DIF_OK(dif_entropy_src_init(
+      mmio_region_from_addr(TOP_EARLGREY_ENTROPY_SRC_BASE_ADDR), &entropy_src));
+  CHECK_DIF_OK(dif_csrng_init(
+      mmio_region_from_addr(TOP_EARLGREY_CSRNG_BASE_ADDR), &csrng));
+  CHECK_DIF_OK(
+      dif_edn_init(mmio_region_from_addr(TOP_EARLGREY_EDN0_BASE_ADDR), &edn0));
+  CHECK_DIF_OK(
+      dif_edn_init(mmio_region_from_addr(TOP_EARLGREY_EDN1_BASE_ADDR), &edn1));
+
+  ujson_t uj = ujson_ottf_console();
+  status_t res = command_processor(&uj);
+  CHECK_STATUS_OK(res);
+  return status_ok(res);
+}
@@ -2,6 +2,7 @@
 // Licensed under the Apache License, Version 2.0, see LICENSE for details.
 // SPDX-License-Identifier: Apache-2.0
 
+#include "sw/device/lib/base/macros.h"
 #include "sw/device/lib/base/status.h"
 #include "sw/device/lib/runtime/log.h"
 #include "sw/device/lib/testing/json/command.h"
@@ -15,6 +16,8 @@
 OTTF_DEFINE_TEST_CONFIG(.enable_uart_flow_control = true);
 
 volatile uint8_t kTestBytes[256];
+// Spans several range chunks, with a partial one at the end.
+volatile uint8_t kTestRange[1300];
 volatile uint32_t kTestWord;
 volatile uint32_t kEndTest;
 
@@ -38,6 +41,9 @@ bool test_main(void) {
   for (size_t i = 0; i < 256; ++i) {
     kTestBytes[i] = (uint8_t)i;
   }
+  for (size_t i = 0; i < ARRAYSIZE(kTestRange); ++i) {
+    kTestRange[i] = (uint8_t)(i * 7);
+  }
   ujson_t uj = ujson_ottf_console();
 
   status_t result = OK_STATUS();
@@ -0,0 +1,211 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+// Measures the sustained throughput of the interrupt-driven I2C engine at each
+// supported bus speed. I2C0 is enabled as both host and target on the same
+// pads, so that its host streams data to and from its own target, with the
+// engine servicing both sides from the same ISR. The bus is considered to
+// keep up if it spends at least `kMinBusUtilizationPercent` of the transfer
+// time moving bits, i.e. if software never leaves the FIFOs empty (host) or
+// full (target) for long enough to stretch the clock significantly.
+
+#include "sw/device/lib/arch/device.h"
+#include "sw/device/lib/base/macros.h"
+#include "sw/device/lib/base/memory.h"
+#include "sw/device/lib/base/mmio.h"
+#include "sw/device/lib/dif/dif_i2c.h"
+#include "sw/device/lib/dif/dif_pinmux.h"
+#include "sw/device/lib/dif/dif_rv_plic.h"
+#include "sw/device/lib/runtime/ibex.h"
+#include "sw/device/lib/runtime/irq.h"
+#include "sw/device/lib/runtime/log.h"
+#include "sw/device/lib/testing/i2c_engine.h"
+#include "sw/device/lib/testing/i2c_testutils.h"
+#include "sw/device/lib/testing/pinmux_testutils.h"
+#include "sw/device/lib/testing/rv_plic_testutils.h"
+#include "sw/device/lib/testing/test_framework/check.h"
+#include "sw/device/lib/testing/test_framework/ottf_main.h"
+
+#include "hw/top_earlgrey/sw/autogen/top_earlgrey.h"
+
+OTTF_DEFINE_TEST_CONFIG();
+
+enum {
+  kHart = kTopEarlgreyPlicTargetIbex0,
+  kTargetAddress = 0x33,
+  kTransferLength = 1024,
+  kRingSize = 2048,
+  // Every byte takes 9 SCL cycles, including its ACK.
+  kBitsPerByte = 9,
+  kMinBusUtilizationPercent = 50,
+};
+
+static dif_i2c_t i2c;
+static dif_pinmux_t pinmux;
+static dif_rv_plic_t plic;
+static i2c_engine_t engine;
+static volatile status_t isr_result;
+static volatile status_t transfer_result;
+
+static i2c_engine_ring_t target_rx;
+static i2c_engine_ring_t target_tx;
+static uint8_t target_rx_buf[kRingSize];
+static uint8_t target_tx_buf[kRingSize];
+
+static uint8_t pattern[kTransferLength];
+static uint8_t received[kTransferLength];
+
+void ottf_external_isr(uint32_t *exc_info) {
+  dif_rv_plic_irq_id_t plic_irq_id;
+  CHECK_DIF_OK(dif_rv_plic_irq_claim(&plic, kHart, &plic_irq_id));
+  CHECK(plic_irq_id >= kTopEarlgreyPlicIrqIdI2c0FmtThreshold &&
+            plic_irq_id <= kTopEarlgreyPlicIrqIdI2c0HostTimeout,
+        "Unexpected IRQ: %d", plic_irq_id);
+
+  status_t result = i2c_engine_service(&engine);
+  if (status_ok(isr_result)) {
+    isr_result = result;
+  }
+  CHECK_DIF_OK(dif_rv_plic_irq_complete(&plic, kHart, plic_irq_id));
+}
+
+static void transfer_done(status_t result, void *ctx) {
+  transfer_result = result;
+}
+
+/**
+ * Sleeps until the host transfer in progress completes, and returns the number
+ * of cycles since `start`.
+ */
+static status_t wait_transfer(uint64_t start) {
+  while (true) {
+    irq_global_ctrl(false);
+    if (!i2c_engine_host_is_busy(&engine)) {
+      break;
+    }
+    wait_for_interrupt();
+    irq_global_ctrl(true);
+  }
+  irq_global_ctrl(true);
+  uint64_t cycles = ibex_mcycle_read() - start;
+  status_t result = isr_result;
+  TRY(result);
+  result = transfer_result;
+  TRY(result);
+  return OK_STATUS((int32_t)cycles);
+}
+
+/**
+ * Returns the percentage of `cycles` that the bus needs at `speed_hz` to move
+ * `kTransferLength` bytes.
+ */
+static uint32_t bus_utilization(uint32_t speed_hz, uint32_t cycles) {
+  uint64_t bus_cycles = (uint64_t)kTransferLength * kBitsPerByte *
+                        kClockFreqCpuHz / speed_hz;
+  return (uint32_t)(bus_cycles * 100 / cycles);
+}
+
+static status_t write_test(uint32_t speed_hz) {
+  uint64_t start = ibex_mcycle_read();
+  TRY(i2c_engine_host_write(&engine, kTargetAddress, pattern, kTransferLength,
+                            transfer_done, NULL));
+  uint32_t cycles = (uint32_t)TRY(wait_transfer(start));
+  uint32_t utilization = bus_utilization(speed_hz, cycles);
+  LOG_INFO("Write: %u bytes in %u cycles, %u%% bus utilization",
+           kTransferLength, cycles, utilization);
+
+  TRY_CHECK(engine.target_stops == 1);
+  TRY_CHECK(TRY(i2c_engine_target_read(&engine, received, kTransferLength)) ==
+            kTransferLength);
+  TRY_CHECK_ARRAYS_EQ(received, pattern, kTransferLength);
+  TRY_CHECK(utilization >= kMinBusUtilizationPercent);
+  return OK_STATUS();
+}
+
+static status_t read_test(uint32_t speed_hz) {
+  TRY_CHECK(TRY(i2c_engine_target_write(&engine, pattern, kTransferLength)) ==
+            kTransferLength);
+  memset(received, 0, sizeof(received));
+
+  uint64_t start = ibex_mcycle_read();
+  TRY(i2c_engine_host_read(&engine, kTargetAddress, received, kTransferLength,
+                           transfer_done, NULL));
+  uint32_t cycles = (uint32_t)TRY(wait_transfer(start));
+  uint32_t utilization = bus_utilization(speed_hz, cycles);
+  LOG_INFO("Read: %u bytes in %u cycles, %u%% bus utilization",
+           kTransferLength, cycles, utilization);
+
+  TRY_CHECK_ARRAYS_EQ(received, pattern, kTransferLength);
+  TRY_CHECK(utilization >= kMinBusUtilizationPercent);
+  return OK_STATUS();
+}
+
+static status_t throughput_test(dif_i2c_speed_t speed, uint32_t speed_hz) {
+  TRY(i2c_testutils_set_speed(&i2c, speed));
+  TRY(i2c_engine_target_start(&engine, &target_rx, &target_tx));
+  TRY(write_test(speed_hz));
+  TRY(read_test(speed_hz));
+  return OK_STATUS();
+}
+
+static status_t standard_test(void) {
+  return throughput_test(kDifI2cSpeedStandard, 100000);
+}
+
+static status_t fast_test(void) {
+  return throughput_test(kDifI2cSpeedFast, 400000);
+}
+
+static status_t fast_plus_test(void) {
+  return throughput_test(kDifI2cSpeedFastPlus, 1000000);
+}
+
+static status_t test_init(void) {
+  TRY(dif_i2c_init(mmio_region_from_addr(TOP_EARLGREY_I2C0_BASE_ADDR), &i2c));
+  TRY(dif_pinmux_init(
+      mmio_region_from_addr(TOP_EARLGREY_PINMUX_AON_BASE_ADDR), &pinmux));
+  TRY(i2c_testutils_select_pinmux(&pinmux, 0, I2cPinmuxPlatformIdHyper310));
+  // Keep the bus high when neither side of the block pulls it low.
+  const pinmux_pad_attributes_t pad_attrs[] = {
+      {.pad = kDtPadIoa7,
+       .flags = kDifPinmuxPadAttrPullResistorEnable |
+                kDifPinmuxPadAttrPullResistorUp},
+      {.pad = kDtPadIoa8,
+       .flags = kDifPinmuxPadAttrPullResistorEnable |
+                kDifPinmuxPadAttrPullResistorUp},
+  };
+  pinmux_testutils_configure_pads(&pinmux, pad_attrs, ARRAYSIZE(pad_attrs));
+
+  dif_i2c_id_t id = {.mask = 0x7f, .address = kTargetAddress};
+  TRY(dif_i2c_set_device_id(&i2c, &id, NULL));
+  TRY(dif_i2c_host_set_enabled(&i2c, kDifToggleEnabled));
+  TRY(dif_i2c_device_set_enabled(&i2c, kDifToggleEnabled));
+
+  TRY(i2c_engine_ring_init(&target_rx, target_rx_buf, sizeof(target_rx_buf)));
+  TRY(i2c_engine_ring_init(&target_tx, target_tx_buf, sizeof(target_tx_buf)));
+  TRY(i2c_engine_init(&engine, &i2c));
+  for (size_t i = 0; i < kTransferLength; ++i) {
+    pattern[i] = (uint8_t)(i * 7 + 3);
+  }
+
+  TRY(dif_rv_plic_init(mmio_region_from_addr(TOP_EARLGREY_RV_PLIC_BASE_ADDR),
+                       &plic));
+  rv_plic_testutils_irq_range_enable(&plic, kHart,
+                                     kTopEarlgreyPlicIrqIdI2c0FmtThreshold,
+                                     kTopEarlgreyPlicIrqIdI2c0HostTimeout);
+  irq_global_ctrl(true);
+  irq_external_ctrl(true);
+  return OK_STATUS();
+}
+
+bool test_main(void) {
+  isr_result = OK_STATUS();
+  CHECK_STATUS_OK(test_init());
+
+  status_t result = OK_STATUS();
+  EXECUTE_TEST(result, standard_test);
+  EXECUTE_TEST(result, fast_test);
+  EXECUTE_TEST(result, fast_plus_test);
+  return status_ok(result);
+}
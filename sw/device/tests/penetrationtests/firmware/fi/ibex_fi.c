@@ -12,10 +12,13 @@
 #include "sw/device/lib/dif/dif_otp_ctrl.h"
 #include "sw/device/lib/dif/dif_rv_core_ibex.h"
 #include "sw/device/lib/dif/dif_sram_ctrl.h"
+#include "sw/device/lib/runtime/hart.h"
+#include "sw/device/lib/runtime/ibex.h"
 #include "sw/device/lib/runtime/log.h"
 #include "sw/device/lib/testing/flash_ctrl_testutils.h"
 #include "sw/device/lib/testing/otp_ctrl_testutils.h"
 #include "sw/device/lib/testing/sram_ctrl_testutils.h"
+#include "sw/device/lib/testing/test_framework/ottf_isrs.h"
 #include "sw/device/lib/testing/test_framework/ottf_test_config.h"
 #include "sw/device/lib/testing/test_framework/ujson_ottf.h"
 #include "sw/device/lib/ujson/ujson.h"
@@ -341,6 +344,144 @@ void not_increment_counter(void) __attribute__((optnone)) {
   asm volatile(ADDI10);
 }
 
+enum {
+  /**
+   * Marks a valid `ibex_fi_crash_record_t` in the retention SRAM.
+   */
+  kIbexFiCrashRecordMagic = 0x46494352,
+  /**
+   * Value of `campaign_attempt` when no campaign is running.
+   */
+  kIbexFiNoAttempt = UINT32_MAX,
+  /**
+   * Words of the `exc_info` frame saved by `handler_exception` in
+   * `ottf_isrs.S` that hold MEPC and a0.
+   */
+  kExcInfoMepc = 0,
+  kExcInfoA0 = 7,
+  /**
+   * Words saved by `ibex_fi_context_save`: ra, sp and s0-s11.
+   */
+  kIbexFiContextWords = 14,
+};
+
+/**
+ * Crash record at the start of the owner area of the retention SRAM.
+ *
+ * The record survives a chip reset, so the host can also fetch the cause of a
+ * crash the campaign loop could not recover from.
+ */
+typedef struct ibex_fi_crash_record {
+  uint32_t magic;
+  uint32_t crashes;
+  uint32_t attempt;
+  uint32_t mcause;
+  uint32_t mepc;
+  uint32_t mtval;
+} ibex_fi_crash_record_t;
+
+extern uint32_t ibex_fi_context_save(uint32_t *ctx)
+    __attribute__((returns_twice));
+extern void ibex_fi_context_restore(uint32_t *ctx);
+
+// Re-entry point of the campaign loop after an exception.
+static uint32_t campaign_ctx[kIbexFiContextWords];
+// Whether an exception resumes at `campaign_ctx` instead of aborting.
+static volatile bool campaign_armed;
+// Attempt of the running campaign.
+static volatile uint32_t campaign_attempt = kIbexFiNoAttempt;
+// Result of the running campaign. Kept off the stack as it is updated on both
+// sides of `ibex_fi_context_save`.
+static ibex_fi_campaign_result_t campaign_result;
+
+static ibex_fi_crash_record_t *crash_record(void) {
+  return (ibex_fi_crash_record_t *)retention_sram_get()->owner.reserved;
+}
+
+/**
+ * Records every exception in the retention SRAM.
+ *
+ * During a campaign attempt, the exception handler returns into
+ * `ibex_fi_context_restore` instead of the faulting code, which resumes the
+ * campaign loop without a reset. Returning through `mret` rather than jumping
+ * there directly restores MSTATUS, so the UART flow control interrupts keep
+ * working. Outside of a campaign, exceptions are fatal as with the default
+ * OTTF handler.
+ */
+void ottf_exception_handler(uint32_t *exc_info) {
+  uint32_t mcause = ibex_mcause_read();
+  ibex_fi_crash_record_t *record = crash_record();
+  if (record->magic != kIbexFiCrashRecordMagic) {
+    record->magic = kIbexFiCrashRecordMagic;
+    record->crashes = 0;
+  }
+  record->crashes++;
+  record->attempt = campaign_attempt;
+  record->mcause = mcause;
+  record->mepc = ibex_mepc_read();
+  record->mtval = ibex_mtval_read();
+
+  if (!campaign_armed) {
+    ottf_generic_fault_print(exc_info, "Exception", mcause);
+    abort();
+  }
+  campaign_armed = false;
+  exc_info[kExcInfoMepc] = (uint32_t)ibex_fi_context_restore;
+  exc_info[kExcInfoA0] = (uint32_t)campaign_ctx;
+}
+
+/**
+ * FI target of a campaign with `kIbexFiCampaignTestCharUnrolledMemOpLoop`.
+ *
+ * Same code as `handle_ibex_fi_char_unrolled_mem_op_loop`.
+ *
+ * @return The loop counter, 10000 without a fault.
+ */
+static uint32_t campaign_char_unrolled_mem_op_loop(void) {
+  uint32_t loop_counter = 0;
+  pentest_set_trigger_high();
+  asm volatile(NOP100);
+  asm volatile(LWADDISW1000 : : "r"((uint32_t *)&loop_counter));
+  asm volatile(LWADDISW1000 : : "r"((uint32_t *)&loop_counter));
+  asm volatile(LWADDISW1000 : : "r"((uint32_t *)&loop_counter));
+  asm volatile(LWADDISW1000 : : "r"((uint32_t *)&loop_counter));
+  asm volatile(LWADDISW1000 : : "r"((uint32_t *)&loop_counter));
+  asm volatile(LWADDISW1000 : : "r"((uint32_t *)&loop_counter));
+  asm volatile(LWADDISW1000 : : "r"((uint32_t *)&loop_counter));
+  asm volatile(LWADDISW1000 : : "r"((uint32_t *)&loop_counter));
+  asm volatile(LWADDISW1000 : : "r"((uint32_t *)&loop_counter));
+  asm volatile(LWADDISW1000 : : "r"((uint32_t *)&loop_counter));
+  pentest_set_trigger_low();
+  return loop_counter;
+}
+
+/**
+ * FI target of a campaign with `kIbexFiCampaignTestCharUnrolledRegOpLoop`.
+ *
+ * Same code as `handle_ibex_fi_char_unrolled_reg_op_loop`.
+ *
+ * @return The loop counter, 10000 without a fault.
+ */
+static uint32_t campaign_char_unrolled_reg_op_loop(void) {
+  uint32_t loop_counter = 0;
+  pentest_set_trigger_high();
+  asm volatile(INITX5);
+  asm volatile(NOP100);
+  asm volatile(ADDI1000);
+  asm volatile(ADDI1000);
+  asm volatile(ADDI1000);
+  asm volatile(ADDI1000);
+  asm volatile(ADDI1000);
+  asm volatile(ADDI1000);
+  asm volatile(ADDI1000);
+  asm volatile(ADDI1000);
+  asm volatile(ADDI1000);
+  asm volatile(ADDI1000);
+  asm volatile("mv %0, x5" : "=r"(loop_counter));
+  pentest_set_trigger_low();
+  return loop_counter;
+}
+
 status_t handle_ibex_fi_address_translation(ujson_t *uj) {
   // Clear registered alerts in alert handler.
   pentest_registered_alerts_t reg_alerts = pentest_get_triggered_alerts();
@@ -493,6 +634,65 @@ status_t handle_ibex_fi_address_translation_config(ujson_t *uj) {
   return OK_STATUS();
 }
 
+status_t handle_ibex_fi_campaign(ujson_t *uj) {
+  ibex_fi_campaign_t uj_data;
+  TRY(ujson_deserialize_ibex_fi_campaign_t(uj, &uj_data));
+  if (uj_data.iterations == 0 ||
+      uj_data.iterations > ARRAYSIZE(campaign_result.results)) {
+    return INVALID_ARGUMENT();
+  }
+  uint32_t (*target)(void);
+  switch (uj_data.test) {
+    case kIbexFiCampaignTestCharUnrolledMemOpLoop:
+      target = campaign_char_unrolled_mem_op_loop;
+      break;
+    case kIbexFiCampaignTestCharUnrolledRegOpLoop:
+      target = campaign_char_unrolled_reg_op_loop;
+      break;
+    default:
+      return INVALID_ARGUMENT();
+  }
+
+  memset(&campaign_result, 0, sizeof(campaign_result));
+  campaign_result.iterations = uj_data.iterations;
+  // Clear registered alerts in alert handler.
+  pentest_get_triggered_alerts();
+
+  for (campaign_attempt = 0; campaign_attempt < uj_data.iterations;
+       campaign_attempt++) {
+    uint32_t attempt = campaign_attempt;
+    if (ibex_fi_context_save(campaign_ctx) == 0) {
+      campaign_armed = true;
+      campaign_result.results[attempt] = target();
+      campaign_armed = false;
+    } else {
+      // Resumed by `ottf_exception_handler`, which recorded the crash.
+      ibex_fi_crash_record_t *record = crash_record();
+      campaign_result.crashed[attempt / 32] |= 1u << (attempt % 32);
+      campaign_result.crashes++;
+      campaign_result.mcause = record->mcause;
+      campaign_result.mepc = record->mepc;
+      campaign_result.mtval = record->mtval;
+      pentest_set_trigger_low();
+    }
+    // Accumulate the alerts of all attempts.
+    pentest_registered_alerts_t reg_alerts = pentest_get_triggered_alerts();
+    for (size_t i = 0; i < ARRAYSIZE(reg_alerts.alerts); i++) {
+      campaign_result.alerts[i] |= reg_alerts.alerts[i];
+    }
+  }
+  campaign_attempt = kIbexFiNoAttempt;
+
+  // Read ERR_STATUS register.
+  dif_rv_core_ibex_error_status_t codes;
+  TRY(dif_rv_core_ibex_get_error_status(&rv_core_ibex, &codes));
+  campaign_result.err_status = codes;
+
+  // Send the results of all attempts to the host at once.
+  RESP_OK(ujson_serialize_ibex_fi_campaign_result_t, uj, &campaign_result);
+  return OK_STATUS();
+}
+
 status_t handle_ibex_fi_char_conditional_branch_beq(ujson_t *uj)
     __attribute__((optnone)) {
   // Clear registered alerts in alert handler.
@@ -2370,6 +2570,22 @@ status_t handle_ibex_fi_char_unrolled_reg_op_loop_chain(ujson_t *uj) {
   return OK_STATUS();
 }
 
+status_t handle_ibex_fi_crash_log(ujson_t *uj) {
+  ibex_fi_crash_record_t *record = crash_record();
+  ibex_fi_crash_log_t uj_output = {.attempt = kIbexFiNoAttempt};
+  if (record->magic == kIbexFiCrashRecordMagic) {
+    uj_output.crashes = record->crashes;
+    uj_output.attempt = record->attempt;
+    uj_output.mcause = record->mcause;
+    uj_output.mepc = record->mepc;
+    uj_output.mtval = record->mtval;
+  }
+  // Start a new log.
+  record->magic = 0;
+  RESP_OK(ujson_serialize_ibex_fi_crash_log_t, uj, &uj_output);
+  return OK_STATUS();
+}
+
 status_t handle_ibex_fi_init(ujson_t *uj) {
   penetrationtest_cpuctrl_t uj_data;
   TRY(ujson_deserialize_penetrationtest_cpuctrl_t(uj, &uj_data));
@@ -2478,6 +2694,8 @@ status_t handle_ibex_fi(ujson_t *uj) {
       return handle_ibex_fi_address_translation(uj);
     case kIbexFiSubcommandAddressTranslationCfg:
       return handle_ibex_fi_address_translation_config(uj);
+    case kIbexFiSubcommandCampaign:
+      return handle_ibex_fi_campaign(uj);
     case kIbexFiSubcommandCharCondBranchBeq:
       return handle_ibex_fi_char_conditional_branch_beq(uj);
     case kIbexFiSubcommandCharCondBranchBge:
@@ -2538,6 +2756,8 @@ status_t handle_ibex_fi(ujson_t *uj) {
       return handle_ibex_fi_char_unrolled_reg_op_loop(uj);
     case kIbexFiSubcommandCharUnrolledRegOpLoopChain:
       return handle_ibex_fi_char_unrolled_reg_op_loop_chain(uj);
+    case kIbexFiSubcommandCrashLog:
+      return handle_ibex_fi_crash_log(uj);
     case kIbexFiSubcommandInit:
       return handle_ibex_fi_init(uj);
     case kIbexFiSubcommandOtpDataRead:
@@ -51,6 +51,24 @@ status_t handle_ibex_fi_address_translation(ujson_t *uj);
  */
 status_t handle_ibex_fi_address_translation_config(ujson_t *uj);
 
+/**
+ * ibex.fi.campaign command handler.
+ *
+ * Runs the FI target of a characterization test for up to 64 attempts and
+ * returns the results of all attempts in a single response.
+ *
+ * An exception during an attempt is recorded in the retention SRAM and the
+ * campaign continues with the next attempt, without resetting the chip. The
+ * response marks the attempts that crashed and holds the cause of the last
+ * crash. Alerts are accumulated over all attempts.
+ *
+ * Faults are injected during the trigger_high & trigger_low of each attempt.
+ *
+ * @param uj An initialized uJSON context.
+ * @return OK or error.
+ */
+status_t handle_ibex_fi_campaign(ujson_t *uj);
+
 /**
  * ibex.fi.char.conditional_branch_beq command handler.
  *
@@ -579,6 +597,19 @@ status_t handle_ibex_fi_char_unrolled_reg_op_loop(ujson_t *uj);
  */
 status_t handle_ibex_fi_char_unrolled_reg_op_loop_chain(ujson_t *uj);
 
+/**
+ * ibex.fi.crash_log command handler.
+ *
+ * Returns the number of exceptions recorded in the retention SRAM and the
+ * cause of the last one, then clears the record. As the record survives a
+ * reset, this also reports crashes that the campaign loop could not recover
+ * from.
+ *
+ * @param uj An initialized uJSON context.
+ * @return OK or error.
+ */
+status_t handle_ibex_fi_crash_log(ujson_t *uj);
+
 /**
  * Initializes the trigger and configures the device for the Ibex FI test.
  *
@@ -6,6 +6,7 @@
 
 #include "sw/device/lib/base/memory.h"
 #include "sw/device/lib/base/status.h"
+#include "sw/device/lib/crypto/impl/integrity.h"
 #include "sw/device/lib/crypto/impl/keyblob.h"
 #include "sw/device/lib/crypto/include/datatypes.h"
 #include "sw/device/lib/crypto/include/mac.h"
@@ -64,6 +65,7 @@ static status_t trigger_hmac(uint8_t key_buf[], uint8_t mask_buf[],
       .keyblob_length = sizeof(keyblob),
       .keyblob = keyblob,
   };
+  key.checksum = integrity_blinded_checksum(&key);
 
   // Create input message.
   otcrypto_const_byte_buf_t input_message = {
@@ -14,6 +14,7 @@ extern "C" {
 #define IBEXFI_SUBCOMMAND(_, value) \
     value(_, AddressTranslation) \
     value(_, AddressTranslationCfg) \
+    value(_, Campaign) \
     value(_, CharCondBranchBeq) \
     value(_, CharCondBranchBge) \
     value(_, CharCondBranchBgeu) \
@@ -44,12 +45,43 @@ extern "C" {
     value(_, CharUnrolledMemOpLoop) \
     value(_, CharUnrolledRegOpLoop) \
     value(_, CharUnrolledRegOpLoopChain) \
+    value(_, CrashLog) \
     value(_, Init) \
     value(_, OtpDataRead) \
     value(_, OtpReadLock) \
     value(_, OtpWriteLock)
 UJSON_SERDE_ENUM(IbexFiSubcommand, ibex_fi_subcommand_t, IBEXFI_SUBCOMMAND);
 
+#define IBEXFI_CAMPAIGN_TEST(_, value) \
+    value(_, CharUnrolledMemOpLoop) \
+    value(_, CharUnrolledRegOpLoop)
+UJSON_SERDE_ENUM(IbexFiCampaignTest, ibex_fi_campaign_test_t, IBEXFI_CAMPAIGN_TEST);
+
+#define IBEXFI_CAMPAIGN(field, string) \
+    field(test, ibex_fi_campaign_test_t) \
+    field(iterations, uint32_t)
+UJSON_SERDE_STRUCT(IbexFiCampaign, ibex_fi_campaign_t, IBEXFI_CAMPAIGN);
+
+#define IBEXFI_CAMPAIGN_RESULT(field, string) \
+    field(iterations, uint32_t) \
+    field(results, uint32_t, 64) \
+    field(crashed, uint32_t, 2) \
+    field(crashes, uint32_t) \
+    field(mcause, uint32_t) \
+    field(mepc, uint32_t) \
+    field(mtval, uint32_t) \
+    field(err_status, uint32_t) \
+    field(alerts, uint32_t, 3)
+UJSON_SERDE_STRUCT(IbexFiCampaignResult, ibex_fi_campaign_result_t, IBEXFI_CAMPAIGN_RESULT);
+
+#define IBEXFI_CRASH_LOG(field, string) \
+    field(crashes, uint32_t) \
+    field(attempt, uint32_t) \
+    field(mcause, uint32_t) \
+    field(mepc, uint32_t) \
+    field(mtval, uint32_t)
+UJSON_SERDE_STRUCT(IbexFiCrashLog, ibex_fi_crash_log_t, IBEXFI_CRASH_LOG);
+
 #define IBEXFI_TEST_RESULT(field, string) \
     field(result, uint32_t) \
     field(err_status, uint32_t) \
@@ -1441,7 +1441,7 @@ static void check_otp_csr_configs(void) {
 
 bool test_main(void) {
   peripheral_clock_period_ns =
-      (uint32_t)udiv64_slow(1000000000, kClockFreqPeripheralHz, NULL);
+      (uint32_t)udiv64(1000000000, kClockFreqPeripheralHz, NULL);
   // Note: DO NOT change this message string without updating the DV testbench.
   LOG_INFO("Computed peripheral clock period.");
 
@@ -805,9 +805,9 @@ bool test_main(void) {
       prgm_alert_handler_round2();
 
       // Setup the aon_timer the wdog bark and bite timeouts.
-      uint32_t bark_cycles = (uint32_t)udiv64_slow(
+      uint32_t bark_cycles = (uint32_t)udiv64(
           kWdogBarkMicros * kClockFreqAonHz, 1000000, NULL);
-      uint32_t bite_cycles = (uint32_t)udiv64_slow(
+      uint32_t bite_cycles = (uint32_t)udiv64(
           kWdogBiteMicros * kClockFreqAonHz, 1000000, NULL);
       CHECK_STATUS_OK(aon_timer_testutils_watchdog_config(
           &aon_timer, bark_cycles, bite_cycles, false));
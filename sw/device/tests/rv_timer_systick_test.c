@@ -46,7 +46,7 @@ static status_t test_tick(uint32_t tick_hz) {
   TRY(dif_rv_timer_counter_set_enabled(&timer, kHart, kDifToggleDisabled));
 
   TRY(dif_rv_timer_counter_read(&timer, kHart, &counter));
-  const uint64_t elapsed_millis = udiv64_slow(counter * 1000, tick_hz, NULL);
+  const uint64_t elapsed_millis = udiv64(counter * 1000, tick_hz, NULL);
 
   // Verify that `n * T ~= 5 milliseconds` within 3% of tolerance.
   TRY_CHECK((elapsed_millis >= (uint64_t)(kReferenceTimeMillis * 0.97)) &&
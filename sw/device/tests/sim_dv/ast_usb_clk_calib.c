@@ -74,11 +74,11 @@ bool test_main(void) {
       mmio_region_from_addr(TOP_EARLGREY_PINMUX_AON_BASE_ADDR), &pinmux));
 
   aon_clk_period_us =
-      cast_safely(udiv64_slow(1000 * 1000, kClockFreqAonHz, NULL));
+      cast_safely(udiv64(1000 * 1000, kClockFreqAonHz, NULL));
   LOG_INFO("Each aon clock is %d us", aon_clk_period_us);
 
   device_usb_count =
-      cast_safely(udiv64_slow(kClockFreqUsbHz, kClockFreqAonHz, NULL));
+      cast_safely(udiv64(kClockFreqUsbHz, kClockFreqAonHz, NULL));
 
   usb_count_info.count = device_usb_count - 1;
   usb_count_info.variability =
@@ -116,7 +116,7 @@ static void wdog_bite_test(const dif_aon_timer_t *aon_timer,
   // precaution.
   uint64_t wait_us_u64 =
       bark_time_us +
-      udiv64_slow(5 * 1000000 + kClockFreqAonHz - 1, kClockFreqAonHz, NULL);
+      udiv64(5 * 1000000 + kClockFreqAonHz - 1, kClockFreqAonHz, NULL);
   CHECK(wait_us_u64 <= UINT32_MAX, "wait_us_u64 must fit in uint32_t");
   uint32_t wait_us = (uint32_t)wait_us_u64;
 
@@ -0,0 +1,186 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "sw/device/lib/arch/device.h"
+#include "sw/device/lib/base/bitfield.h"
+#include "sw/device/lib/base/memory.h"
+#include "sw/device/lib/base/mmio.h"
+#include "sw/device/lib/dif/dif_pinmux.h"
+#include "sw/device/lib/dif/dif_rv_plic.h"
+#include "sw/device/lib/dif/dif_spi_device.h"
+#include "sw/device/lib/runtime/irq.h"
+#include "sw/device/lib/runtime/log.h"
+#include "sw/device/lib/testing/profile.h"
+#include "sw/device/lib/testing/spi_device_testutils.h"
+#include "sw/device/lib/testing/spi_device_tpm_engine.h"
+#include "sw/device/lib/testing/test_framework/check.h"
+#include "sw/device/lib/testing/test_framework/ottf_main.h"
+
+#include "hw/top_earlgrey/sw/autogen/top_earlgrey.h"
+
+// Module ID for status codes.
+#define MODULE_ID MAKE_MODULE_ID('t', 's', 't')
+
+OTTF_DEFINE_TEST_CONFIG();
+
+enum {
+  /**
+   * Largest command and response, as accepted by the host TPM driver.
+   */
+  kBufLen = 4096,
+  /**
+   * TPM command and response headers: a 16-bit tag, a 32-bit size and a
+   * 32-bit command or response code, all big-endian.
+   */
+  kTpmHeaderLen = 10,
+  kTpmTagNoSessions = 0x8001,
+  kTpmSuccess = 0,
+  /**
+   * Command codes understood by the test, which must match the host harness.
+   * Both are in the vendor-specific range.
+   */
+  kEchoCommandCode = 0x20000001,
+  kEndCommandCode = 0x200000ff,
+};
+
+static dif_spi_device_handle_t spi_device;
+static dif_pinmux_t pinmux;
+static dif_rv_plic_t plic;
+
+static spi_device_tpm_engine_t engine;
+static uint8_t cmd_buf[kBufLen];
+static uint8_t resp_buf[kBufLen];
+
+/**
+ * Cycles spent in the ISR, and the number of interrupts.
+ */
+static uint64_t isr_cycles;
+static uint32_t isr_count;
+
+void ottf_external_isr(uint32_t *exc_info) {
+  uint64_t t_start = profile_start();
+  dif_rv_plic_irq_id_t irq_id;
+  CHECK_DIF_OK(
+      dif_rv_plic_irq_claim(&plic, kTopEarlgreyPlicTargetIbex0, &irq_id));
+  CHECK(irq_id == kTopEarlgreyPlicIrqIdSpiDeviceTpmHeaderNotEmpty ||
+            irq_id == kTopEarlgreyPlicIrqIdSpiDeviceTpmRdfifoCmdEnd,
+        "Unexpected interrupt: %d", irq_id);
+  CHECK_STATUS_OK(spi_device_tpm_engine_service(&engine));
+  CHECK_DIF_OK(
+      dif_rv_plic_irq_complete(&plic, kTopEarlgreyPlicTargetIbex0, irq_id));
+  isr_cycles += profile_end(t_start);
+  ++isr_count;
+}
+
+static void en_plic_irqs(dif_rv_plic_t *plic) {
+  const top_earlgrey_plic_irq_id_t kIrqs[] = {
+      kTopEarlgreyPlicIrqIdSpiDeviceTpmHeaderNotEmpty,
+      kTopEarlgreyPlicIrqIdSpiDeviceTpmRdfifoCmdEnd,
+  };
+  for (uint32_t i = 0; i < ARRAYSIZE(kIrqs); ++i) {
+    CHECK_DIF_OK(dif_rv_plic_irq_set_enabled(
+        plic, kIrqs[i], kTopEarlgreyPlicTargetIbex0, kDifToggleEnabled));
+    CHECK_DIF_OK(
+        dif_rv_plic_irq_set_priority(plic, kIrqs[i], kDifRvPlicMaxPriority));
+  }
+  irq_external_ctrl(true);
+}
+
+static uint32_t read_be32(const uint8_t *buf) {
+  return bitfield_byteswap32(read_32(buf));
+}
+
+static void write_be32(uint8_t *buf, uint32_t value) {
+  write_32(bitfield_byteswap32(value), buf);
+}
+
+/**
+ * Builds the response to `cmd` in `resp_buf`, and returns its length.
+ *
+ * The echo command is answered with its own payload.
+ */
+static status_t execute(const uint8_t *cmd, size_t cmd_len, size_t *resp_len,
+                        bool *end) {
+  TRY_CHECK(cmd_len >= kTpmHeaderLen);
+  TRY_CHECK(read_be32(&cmd[2]) == cmd_len);
+  uint32_t code = read_be32(&cmd[6]);
+  TRY_CHECK(code == kEchoCommandCode || code == kEndCommandCode);
+
+  size_t payload_len = code == kEchoCommandCode ? cmd_len - kTpmHeaderLen : 0;
+  *resp_len = kTpmHeaderLen + payload_len;
+  resp_buf[0] = kTpmTagNoSessions >> 8;
+  resp_buf[1] = kTpmTagNoSessions & 0xff;
+  write_be32(&resp_buf[2], (uint32_t)*resp_len);
+  write_be32(&resp_buf[6], kTpmSuccess);
+  memcpy(&resp_buf[kTpmHeaderLen], &cmd[kTpmHeaderLen], payload_len);
+  *end = code == kEndCommandCode;
+  return OK_STATUS();
+}
+
+static status_t tpm_engine_test(void) {
+  TRY(spi_device_tpm_engine_init(&engine, &spi_device, cmd_buf,
+                                 sizeof(cmd_buf)));
+  en_plic_irqs(&plic);
+  irq_global_ctrl(true);
+
+  // Sync message with the host to begin.
+  LOG_INFO("SYNC: Begin TPM Engine Test");
+
+  size_t bytes = 0;
+  bool end = false;
+  while (!end) {
+    const uint8_t *cmd;
+    size_t cmd_len;
+    ATOMIC_WAIT_FOR_INTERRUPT(
+        spi_device_tpm_engine_get_command(&engine, &cmd, &cmd_len));
+
+    size_t resp_len;
+    TRY(execute(cmd, cmd_len, &resp_len, &end));
+    bytes += cmd_len + resp_len;
+
+    irq_global_ctrl(false);
+    status_t result =
+        spi_device_tpm_engine_respond(&engine, resp_buf, resp_len);
+    irq_global_ctrl(true);
+    TRY(result);
+  }
+
+  // Let the host read the last response before the test ends.
+  ATOMIC_WAIT_FOR_INTERRUPT(engine.state == kSpiDeviceTpmEngineStateReady);
+
+  TRY_CHECK(engine.dropped == 0);
+  LOG_INFO("%d commands, %d bytes: %d interrupts, %d ISR cycles",
+           engine.commands, bytes, isr_count, (uint32_t)isr_cycles);
+  return OK_STATUS();
+}
+
+bool test_main(void) {
+  CHECK_DIF_OK(dif_pinmux_init(
+      mmio_region_from_addr(TOP_EARLGREY_PINMUX_AON_BASE_ADDR), &pinmux));
+  CHECK_DIF_OK(dif_spi_device_init_handle(
+      mmio_region_from_addr(TOP_EARLGREY_SPI_DEVICE_BASE_ADDR), &spi_device));
+  CHECK_DIF_OK(dif_rv_plic_init(
+      mmio_region_from_addr(TOP_EARLGREY_RV_PLIC_BASE_ADDR), &plic));
+
+  // Set IoA7 for tpm csb.
+  CHECK_DIF_OK(dif_pinmux_input_select(
+      &pinmux, kTopEarlgreyPinmuxPeripheralInSpiDeviceTpmCsb,
+      kTopEarlgreyPinmuxInselIoa7));
+  if (kDeviceType == kDeviceSimDV) {
+    dif_pinmux_pad_attr_t out_attr;
+    dif_pinmux_pad_attr_t in_attr = {
+        .slew_rate = 0,
+        .drive_strength = 0,
+        .flags = kDifPinmuxPadAttrPullResistorEnable |
+                 kDifPinmuxPadAttrPullResistorUp};
+    CHECK_DIF_OK(dif_pinmux_pad_write_attrs(&pinmux, kTopEarlgreyMuxedPadsIoa7,
+                                            kDifPinmuxPadKindMio, in_attr,
+                                            &out_attr));
+  }
+  CHECK_STATUS_OK(spi_device_testutils_configure_pad_attrs(&pinmux));
+
+  status_t result = OK_STATUS();
+  EXECUTE_TEST(result, tpm_engine_test);
+  return status_ok(result);
+}
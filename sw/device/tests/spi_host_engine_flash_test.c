@@ -0,0 +1,167 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+// Compares reading a large region of the external SPI flash with the blocking
+// `dif_spi_host_transaction()` against the interrupt-driven SPI host engine,
+// checking that both return the same data and reporting the cycles taken and
+// how much of that time the CPU was free while the engine was running.
+
+#include <assert.h>
+
+#include "sw/device/lib/arch/device.h"
+#include "sw/device/lib/base/macros.h"
+#include "sw/device/lib/base/memory.h"
+#include "sw/device/lib/base/mmio.h"
+#include "sw/device/lib/dif/dif_rv_plic.h"
+#include "sw/device/lib/dif/dif_spi_host.h"
+#include "sw/device/lib/runtime/ibex.h"
+#include "sw/device/lib/runtime/irq.h"
+#include "sw/device/lib/runtime/log.h"
+#include "sw/device/lib/testing/rv_plic_testutils.h"
+#include "sw/device/lib/testing/spi_device_testutils.h"
+#include "sw/device/lib/testing/spi_host_engine.h"
+#include "sw/device/lib/testing/test_framework/check.h"
+#include "sw/device/lib/testing/test_framework/ottf_main.h"
+
+#include "hw/top_earlgrey/sw/autogen/top_earlgrey.h"
+
+OTTF_DEFINE_TEST_CONFIG();
+
+enum {
+  kHart = kTopEarlgreyPlicTargetIbex0,
+  kSpiClockHz = 10000000,
+  kReadAddress = 0,
+  kReadLength = 16384,
+  kDummyCycles = 8,
+  kTxWatermark = 16,
+  kRxWatermark = 32,
+};
+
+static dif_spi_host_t spi_host;
+static dif_rv_plic_t plic;
+static spi_host_engine_t engine;
+static volatile status_t isr_result;
+
+static uint8_t expected[kReadLength];
+static uint8_t actual[kReadLength];
+
+void ottf_external_isr(uint32_t *exc_info) {
+  dif_rv_plic_irq_id_t plic_irq_id;
+  CHECK_DIF_OK(dif_rv_plic_irq_claim(&plic, kHart, &plic_irq_id));
+  CHECK(plic_irq_id == kTopEarlgreyPlicIrqIdSpiHost0SpiEvent,
+        "Unexpected IRQ: %d", plic_irq_id);
+
+  // The `spi_event` interrupt is a status interrupt: the engine clears it by
+  // disabling the events it is not waiting for.
+  status_t result = spi_host_engine_service(&engine);
+  if (status_ok(isr_result)) {
+    isr_result = result;
+  }
+  CHECK_DIF_OK(dif_rv_plic_irq_complete(&plic, kHart, plic_irq_id));
+}
+
+static void fast_read(dif_spi_host_segment_t *segments, void *buf) {
+  segments[0] = (dif_spi_host_segment_t){
+      .type = kDifSpiHostSegmentTypeOpcode,
+      .opcode = {.opcode = kSpiDeviceFlashOpReadFast,
+                 .width = kDifSpiHostWidthStandard},
+  };
+  segments[1] = (dif_spi_host_segment_t){
+      .type = kDifSpiHostSegmentTypeAddress,
+      .address = {.width = kDifSpiHostWidthStandard,
+                  .mode = kDifSpiHostAddrMode3b,
+                  .address = kReadAddress},
+  };
+  segments[2] = (dif_spi_host_segment_t){
+      .type = kDifSpiHostSegmentTypeDummy,
+      .dummy = {.width = kDifSpiHostWidthStandard, .length = kDummyCycles},
+  };
+  segments[3] = (dif_spi_host_segment_t){
+      .type = kDifSpiHostSegmentTypeRx,
+      .rx = {.width = kDifSpiHostWidthStandard,
+             .buf = buf,
+             .length = kReadLength},
+  };
+}
+
+static status_t read_blocking(void) {
+  dif_spi_host_segment_t segments[4];
+  fast_read(segments, expected);
+
+  uint64_t start = ibex_mcycle_read();
+  TRY(dif_spi_host_transaction(&spi_host, /*csid=*/0, segments,
+                               ARRAYSIZE(segments)));
+  uint64_t cycles = ibex_mcycle_read() - start;
+  LOG_INFO("Blocking read: %u bytes in %u cycles", kReadLength,
+           (uint32_t)cycles);
+  return OK_STATUS();
+}
+
+static status_t read_engine(void) {
+  dif_spi_host_segment_t segments[4];
+  fast_read(segments, actual);
+
+  // Count how often the CPU gets back control while the engine runs, as a
+  // measure of the time it is free for other work.
+  uint32_t wakeups = 0;
+  uint64_t start = ibex_mcycle_read();
+  TRY(spi_host_engine_start(&engine, /*csid=*/0, segments, ARRAYSIZE(segments),
+                            NULL, NULL));
+  while (true) {
+    irq_global_ctrl(false);
+    if (!spi_host_engine_is_busy(&engine)) {
+      break;
+    }
+    wait_for_interrupt();
+    irq_global_ctrl(true);
+    ++wakeups;
+  }
+  irq_global_ctrl(true);
+  uint64_t cycles = ibex_mcycle_read() - start;
+  status_t result = isr_result;
+  TRY(result);
+  LOG_INFO("Engine read: %u bytes in %u cycles, %u interrupts", kReadLength,
+           (uint32_t)cycles, wakeups);
+
+  TRY_CHECK_ARRAYS_EQ(actual, expected, kReadLength);
+  return OK_STATUS();
+}
+
+static status_t test_init(void) {
+  TRY(dif_spi_host_init(mmio_region_from_addr(TOP_EARLGREY_SPI_HOST0_BASE_ADDR),
+                        &spi_host));
+  CHECK(kClockFreqHiSpeedPeripheralHz <= UINT32_MAX,
+        "kClockFreqHiSpeedPeripheralHz must fit in uint32_t");
+  TRY(dif_spi_host_configure(
+      &spi_host,
+      (dif_spi_host_config_t){
+          .spi_clock = kSpiClockHz,
+          .peripheral_clock_freq_hz = (uint32_t)kClockFreqHiSpeedPeripheralHz,
+          .tx_watermark = kTxWatermark,
+          .rx_watermark = kRxWatermark,
+      }));
+  TRY(dif_spi_host_output_set_enabled(&spi_host, true));
+  TRY(spi_host_engine_init(&engine, &spi_host));
+
+  TRY(dif_rv_plic_init(mmio_region_from_addr(TOP_EARLGREY_RV_PLIC_BASE_ADDR),
+                       &plic));
+  rv_plic_testutils_irq_range_enable(&plic, kHart,
+                                     kTopEarlgreyPlicIrqIdSpiHost0SpiEvent,
+                                     kTopEarlgreyPlicIrqIdSpiHost0SpiEvent);
+  TRY(dif_spi_host_irq_set_enabled(&spi_host, kDifSpiHostIrqSpiEvent,
+                                   kDifToggleEnabled));
+  irq_global_ctrl(true);
+  irq_external_ctrl(true);
+  return OK_STATUS();
+}
+
+bool test_main(void) {
+  CHECK_STATUS_OK(test_init());
+  isr_result = OK_STATUS();
+
+  status_t result = OK_STATUS();
+  EXECUTE_TEST(result, read_blocking);
+  EXECUTE_TEST(result, read_engine);
+  return status_ok(result);
+}
@@ -0,0 +1,77 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+use byteorder::{LittleEndian, ReadBytesExt};
+use serde::Serialize;
+use serde_annotate::Annotate;
+use std::convert::TryFrom;
+
+use super::ChipDataError;
+use crate::with_unknown;
+
+with_unknown! {
+    pub enum BootTimingEvent: u32 [default = Self::Unknown] {
+        Unknown = 0,
+        RomInit = 1,
+        RomExtMeasure = 2,
+        RomExtSpxVerify = 3,
+        RomExtEcdsaVerify = 4,
+        RomExit = 5,
+        ImmSectionDice = 6,
+        RomExtStart = 7,
+        OwnershipInit = 8,
+        Bl0Measure = 9,
+        Bl0Verify = 10,
+        DiceCdi1 = 11,
+        DiceFlush = 12,
+        RomExtExit = 13,
+    }
+}
+
+/// A single entry of the boot timing trace.
+#[derive(Debug, Default, Serialize, Annotate)]
+pub struct BootTimingEntry {
+    /// The boot stage event that was recorded.
+    pub event: BootTimingEvent,
+    /// The low 32 bits of the `mcycle` counter when the event was recorded.
+    pub mcycle: u32,
+}
+
+/// The BootTiming trace records the cycle count at which the ROM and ROM_EXT
+/// reached each point of the boot.
+#[derive(Debug, Default, Serialize, Annotate)]
+pub struct BootTiming {
+    /// A tag that identifies this struct as the boot timing trace ('BTIM').
+    #[annotate(format=hex)]
+    pub identifier: u32,
+    /// The valid entries of the trace, in the order they were recorded.
+    pub entries: Vec<BootTimingEntry>,
+}
+
+impl TryFrom<&[u8]> for BootTiming {
+    type Error = ChipDataError;
+    fn try_from(buf: &[u8]) -> std::result::Result<Self, Self::Error> {
+        if buf.len() < Self::SIZE {
+            return Err(ChipDataError::BadSize(Self::SIZE, buf.len()));
+        }
+        let mut reader = std::io::Cursor::new(buf);
+        let mut val = BootTiming {
+            identifier: reader.read_u32::<LittleEndian>()?,
+            ..Default::default()
+        };
+        let count = reader.read_u32::<LittleEndian>()? as usize;
+        for _ in 0..count.min(Self::MAX_ENTRIES) {
+            val.entries.push(BootTimingEntry {
+                event: BootTimingEvent(reader.read_u32::<LittleEndian>()?),
+                mcycle: reader.read_u32::<LittleEndian>()?,
+            });
+        }
+        Ok(val)
+    }
+}
+
+impl BootTiming {
+    pub const SIZE: usize = 256;
+    const MAX_ENTRIES: usize = 31;
+}
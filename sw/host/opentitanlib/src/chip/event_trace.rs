@@ -0,0 +1,127 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+use byteorder::{LittleEndian, ReadBytesExt};
+use serde::Serialize;
+use serde_annotate::Annotate;
+use std::convert::TryFrom;
+
+use super::ChipDataError;
+
+/// A single entry of the event trace.
+#[derive(Debug, Default, Serialize, Annotate)]
+pub struct EventTraceEntry {
+    /// The sequence number of the event since the trace was initialized.
+    pub seq: u32,
+    /// The firmware-defined event ID.
+    #[annotate(format=hex)]
+    pub id: u32,
+    /// The low 32 bits of the `mcycle` counter when the event was recorded.
+    pub mcycle: u32,
+    /// The first event argument.
+    #[annotate(format=hex)]
+    pub arg0: u32,
+    /// The second event argument.
+    #[annotate(format=hex)]
+    pub arg1: u32,
+}
+
+/// The EventTrace is a ring of the most recent events recorded by the owner
+/// firmware. It is kept in retention SRAM across all resets except PoR.
+#[derive(Debug, Default, Serialize, Annotate)]
+pub struct EventTrace {
+    /// A tag that identifies this struct as the event trace ('ETRC').
+    #[annotate(format=hex)]
+    pub identifier: u32,
+    /// The number of events recorded since the trace was initialized.
+    pub count: u32,
+    /// The events still held in the ring, oldest first.
+    pub entries: Vec<EventTraceEntry>,
+}
+
+impl TryFrom<&[u8]> for EventTrace {
+    type Error = ChipDataError;
+    fn try_from(buf: &[u8]) -> std::result::Result<Self, Self::Error> {
+        if buf.len() < Self::SIZE {
+            return Err(ChipDataError::BadSize(Self::SIZE, buf.len()));
+        }
+        let mut reader = std::io::Cursor::new(buf);
+        let mut val = EventTrace {
+            identifier: reader.read_u32::<LittleEndian>()?,
+            count: reader.read_u32::<LittleEndian>()?,
+            ..Default::default()
+        };
+        let mut ring = Vec::with_capacity(Self::MAX_ENTRIES);
+        for _ in 0..Self::MAX_ENTRIES {
+            ring.push([
+                reader.read_u32::<LittleEndian>()?,
+                reader.read_u32::<LittleEndian>()?,
+                reader.read_u32::<LittleEndian>()?,
+                reader.read_u32::<LittleEndian>()?,
+            ]);
+        }
+        let len = val.count.min(Self::MAX_ENTRIES as u32);
+        for seq in val.count - len..val.count {
+            let [id, mcycle, arg0, arg1] = ring[seq as usize % Self::MAX_ENTRIES];
+            val.entries.push(EventTraceEntry {
+                seq,
+                id,
+                mcycle,
+                arg0,
+                arg1,
+            });
+        }
+        Ok(val)
+    }
+}
+
+impl EventTrace {
+    pub const SIZE: usize = 520;
+    const MAX_ENTRIES: usize = 32;
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use anyhow::Result;
+
+    fn trace_bytes(count: u32) -> Vec<u8> {
+        let mut buf = Vec::new();
+        buf.extend_from_slice(&0x43525445u32.to_le_bytes());
+        buf.extend_from_slice(&count.to_le_bytes());
+        for i in 0..EventTrace::MAX_ENTRIES as u32 {
+            for word in [i, 100 + i, 0, 0] {
+                buf.extend_from_slice(&word.to_le_bytes());
+            }
+        }
+        buf
+    }
+
+    #[test]
+    fn test_partial_ring() -> Result<()> {
+        let trace = EventTrace::try_from(trace_bytes(2).as_slice())?;
+        assert_eq!(trace.entries.len(), 2);
+        assert_eq!(trace.entries[0].seq, 0);
+        assert_eq!(trace.entries[1].id, 1);
+        Ok(())
+    }
+
+    #[test]
+    fn test_wrapped_ring() -> Result<()> {
+        let trace = EventTrace::try_from(trace_bytes(34).as_slice())?;
+        assert_eq!(trace.entries.len(), EventTrace::MAX_ENTRIES);
+        // The oldest entry still in the ring follows the two newest ones.
+        assert_eq!(trace.entries[0].seq, 2);
+        assert_eq!(trace.entries[0].id, 2);
+        assert_eq!(trace.entries[31].seq, 33);
+        assert_eq!(trace.entries[31].id, 1);
+        assert_eq!(trace.entries[31].mcycle, 101);
+        Ok(())
+    }
+
+    #[test]
+    fn test_short_buffer() {
+        assert!(EventTrace::try_from(&trace_bytes(0)[..16]).is_err());
+    }
+}
@@ -8,8 +8,10 @@ pub mod alert;
 pub mod autogen;
 pub mod boolean;
 pub mod boot_log;
+pub mod boot_timing;
 pub mod boot_svc;
 pub mod device_id;
+pub mod event_trace;
 pub mod helper;
 pub mod rom_error;
 
@@ -2,7 +2,8 @@
 // Licensed under the Apache License, Version 2.0, see LICENSE for details.
 // SPDX-License-Identifier: Apache-2.0
 
-use anyhow::Result;
+use anyhow::{bail, Result};
+use crc::Crc;
 use std::cell::{Cell, RefCell};
 use std::collections::VecDeque;
 use std::time::Duration;
@@ -18,6 +19,7 @@ pub struct SpiConsoleDevice<'a> {
     console_next_frame_number: Cell<u32>,
     rx_buf: RefCell<VecDeque<u8>>,
     next_read_address: Cell<u32>,
+    framed: bool,
 }
 
 impl<'a> SpiConsoleDevice<'a> {
@@ -25,11 +27,25 @@ impl<'a> SpiConsoleDevice<'a> {
     const SPI_FLASH_READ_BUFFER_SIZE: u32 = 2048;
     const SPI_MAX_DATA_LENGTH: usize = 2036;
     const SPI_FRAME_MAGIC_NUMBER: u32 = 0xa5a5beef;
+    const SPI_FRAME_CRC_MAGIC_NUMBER: u32 = 0xa5a5c3c3;
+    const SPI_FRAME_CRC_SIZE: usize = 4;
     const SPI_FLASH_PAYLOAD_BUFFER_SIZE: usize = 256;
     const SPI_TX_LAST_CHUNK_MAGIC_ADDRESS: u32 = 0x100;
     const SPI_BOOT_MAGIC_PATTERN: u32 = 0xcafeb002;
 
     pub fn new(spi: &'a dyn Target) -> Result<Self> {
+        Self::with_framing(spi, false)
+    }
+
+    /// Creates a console for a device whose OTTF console is configured with
+    /// `console.framed`. Each write is sent as a frame made of the payload
+    /// length, the payload and its CRC32, and the CRC32 trailer of every frame
+    /// read from the device is checked.
+    pub fn new_framed(spi: &'a dyn Target) -> Result<Self> {
+        Self::with_framing(spi, true)
+    }
+
+    fn with_framing(spi: &'a dyn Target, framed: bool) -> Result<Self> {
         let mut flash = SpiFlash {
             ..Default::default()
         };
@@ -40,9 +56,23 @@ impl<'a> SpiConsoleDevice<'a> {
             rx_buf: RefCell::new(VecDeque::new()),
             console_next_frame_number: Cell::new(0),
             next_read_address: Cell::new(0),
+            framed,
         })
     }
 
+    fn crc32(data: &[u8]) -> u32 {
+        Crc::<u32>::new(&crc::CRC_32_ISO_HDLC).checksum(data)
+    }
+
+    /// Wraps `payload` in a host-to-device frame.
+    fn encode_frame(payload: &[u8]) -> Vec<u8> {
+        let mut frame = Vec::with_capacity(payload.len() + 8);
+        frame.extend_from_slice(&u32::try_from(payload.len()).unwrap().to_le_bytes());
+        frame.extend_from_slice(payload);
+        frame.extend_from_slice(&Self::crc32(payload).to_le_bytes());
+        frame
+    }
+
     fn check_device_boot_up(&self, buf: &[u8]) -> Result<usize> {
         for i in (0..buf.len()).step_by(4) {
             let pattern: u32 = u32::from_le_bytes(buf[i..i + 4].try_into().unwrap());
@@ -66,7 +96,8 @@ impl<'a> SpiConsoleDevice<'a> {
         let magic_number: u32 = u32::from_le_bytes(header[0..4].try_into().unwrap());
         let frame_number: u32 = u32::from_le_bytes(header[4..8].try_into().unwrap());
         let data_len_bytes: usize = u32::from_le_bytes(header[8..12].try_into().unwrap()) as usize;
-        if magic_number != SpiConsoleDevice::SPI_FRAME_MAGIC_NUMBER
+        let has_crc = magic_number == SpiConsoleDevice::SPI_FRAME_CRC_MAGIC_NUMBER;
+        if (magic_number != SpiConsoleDevice::SPI_FRAME_MAGIC_NUMBER && !has_crc)
             || frame_number != self.console_next_frame_number.get()
             || data_len_bytes > SpiConsoleDevice::SPI_MAX_DATA_LENGTH
         {
@@ -78,17 +109,27 @@ impl<'a> SpiConsoleDevice<'a> {
 
         // Read the SPI console frame data.
         let data_len_bytes_w_pad = (data_len_bytes + 3) & !3;
-        let mut data = vec![0u8; data_len_bytes_w_pad];
+        let crc_len = if has_crc {
+            SpiConsoleDevice::SPI_FRAME_CRC_SIZE
+        } else {
+            0
+        };
+        let mut data = vec![0u8; data_len_bytes_w_pad + crc_len];
         let data_address: u32 = (read_address
             + u32::try_from(SpiConsoleDevice::SPI_FRAME_HEADER_SIZE).unwrap())
             % SpiConsoleDevice::SPI_FLASH_READ_BUFFER_SIZE;
         self.read_data(data_address, &mut data)?;
 
         let next_read_address: u32 = (read_address
-            + u32::try_from(SpiConsoleDevice::SPI_FRAME_HEADER_SIZE + data_len_bytes_w_pad)
-                .unwrap())
+            + u32::try_from(SpiConsoleDevice::SPI_FRAME_HEADER_SIZE + data.len()).unwrap())
             % SpiConsoleDevice::SPI_FLASH_READ_BUFFER_SIZE;
         self.next_read_address.set(next_read_address);
+        if has_crc {
+            let crc = u32::from_le_bytes(data[data_len_bytes_w_pad..].try_into().unwrap());
+            if crc != Self::crc32(&data[..data_len_bytes]) {
+                bail!("SPI console frame {frame_number} failed its CRC32 check");
+            }
+        }
         // Copy data to the internal data queue.
         self.rx_buf.borrow_mut().extend(&data[..data_len_bytes]);
         Ok(data_len_bytes)
@@ -132,6 +173,13 @@ impl<'a> ConsoleDevice for SpiConsoleDevice<'a> {
     }
 
     fn console_write(&self, buf: &[u8]) -> Result<()> {
+        let frame;
+        let buf = if self.framed {
+            frame = Self::encode_frame(buf);
+            &frame[..]
+        } else {
+            buf
+        };
         let buf_len: usize = buf.len();
         let mut written_data_len: usize = 0;
         while written_data_len < buf_len {
@@ -154,3 +202,17 @@ impl<'a> ConsoleDevice for SpiConsoleDevice<'a> {
         Ok(())
     }
 }
+
+#[cfg(test)]
+mod test {
+    use super::*;
+
+    #[test]
+    fn test_encode_frame() {
+        let frame = SpiConsoleDevice::encode_frame(b"123456789");
+        assert_eq!(&frame[0..4], &[9, 0, 0, 0]);
+        assert_eq!(&frame[4..13], b"123456789");
+        // The CRC32 check value of "123456789".
+        assert_eq!(&frame[13..], &0xcbf43926u32.to_le_bytes());
+    }
+}
@@ -18,6 +18,7 @@ with_unknown! {
     pub enum RescueType: u32 [default = Self::None] {
         None = 0,
         Xmodem = u32::from_le_bytes(*b"XMDM"),
+        SpiFlash = u32::from_le_bytes(*b"SPIF"),
     }
 
     pub enum CommandTag: u32 [default = Self::Unknown] {
@@ -33,6 +34,8 @@ with_unknown! {
         RescueB = u32::from_be_bytes(*b"RESB"),
         Reboot = u32::from_be_bytes(*b"REBO"),
         GetBootLog = u32::from_be_bytes(*b"BLOG"),
+        GetBootTiming = u32::from_be_bytes(*b"BTIM"),
+        GetEventTrace = u32::from_be_bytes(*b"ETRC"),
         BootSvcReq = u32::from_be_bytes(*b"BREQ"),
         BootSvcRsp = u32::from_be_bytes(*b"BRSP"),
         OwnerBlock = u32::from_be_bytes(*b"OWNR"),
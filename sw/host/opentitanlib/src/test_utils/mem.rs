@@ -2,7 +2,7 @@
 // Licensed under the Apache License, Version 2.0, see LICENSE for details.
 // SPDX-License-Identifier: Apache-2.0
 
-use anyhow::Result;
+use anyhow::{bail, Result};
 use arrayvec::ArrayVec;
 use std::time::Duration;
 
@@ -14,6 +14,10 @@ use crate::test_utils::status::Status;
 // Bring in the auto-generated sources.
 include!(env!("mem"));
 
+/// Largest chunk of a `MemRangeReq`, which must match `kMemRangeChunkBytes` in
+/// `sw/device/lib/testing/json/mem.h`.
+const MEM_RANGE_CHUNK_BYTES: usize = 512;
+
 impl MemRead32Req {
     pub fn execute<T>(device: &T, address: u32) -> Result<u32>
     where
@@ -92,3 +96,68 @@ impl MemWriteReq {
         Ok(())
     }
 }
+
+impl MemRangeReq {
+    /// Reads `data.len()` bytes starting at `address` with a single command.
+    ///
+    /// The device streams the range back as hex-encoded chunks of up to
+    /// `kMemRangeChunkBytes` bytes, each with its own CRC.
+    pub fn read<T>(device: &T, address: u32, data: &mut [u8]) -> Result<()>
+    where
+        T: ConsoleDevice + ?Sized,
+    {
+        if data.is_empty() {
+            return Ok(());
+        }
+        TestCommand::MemReadRange.send_with_crc(device)?;
+        let op = MemRangeReq {
+            address,
+            data_len: data.len().try_into()?,
+        };
+        op.send_with_crc(device)?;
+        let mut bytes_read = 0_usize;
+        while bytes_read < data.len() {
+            let chunk = MemHexChunk::recv(device, Duration::from_secs(300), true)?;
+            let bytes = hex::decode(&chunk.data)?;
+            if chunk.address != address + bytes_read as u32
+                || bytes.is_empty()
+                || bytes.len() > data.len() - bytes_read
+            {
+                bail!("Unexpected chunk at {:#x}", chunk.address);
+            }
+            data[bytes_read..bytes_read + bytes.len()].copy_from_slice(&bytes);
+            bytes_read += bytes.len();
+        }
+        Ok(())
+    }
+
+    /// Writes `data` starting at `address` with a single command.
+    ///
+    /// The data is sent as hex-encoded chunks, each of which the device
+    /// acknowledges once it has been written.
+    pub fn write<T>(device: &T, address: u32, data: &[u8]) -> Result<()>
+    where
+        T: ConsoleDevice + ?Sized,
+    {
+        if data.is_empty() {
+            return Ok(());
+        }
+        TestCommand::MemWriteRange.send_with_crc(device)?;
+        let op = MemRangeReq {
+            address,
+            data_len: data.len().try_into()?,
+        };
+        op.send_with_crc(device)?;
+        let mut bytes_written = 0_usize;
+        for chunk in data.chunks(MEM_RANGE_CHUNK_BYTES) {
+            let hex_chunk = MemHexChunk {
+                address: address + bytes_written as u32,
+                data: hex::encode(chunk),
+            };
+            hex_chunk.send_with_crc(device)?;
+            Status::recv(device, Duration::from_secs(300), true)?;
+            bytes_written += chunk.len();
+        }
+        Ok(())
+    }
+}
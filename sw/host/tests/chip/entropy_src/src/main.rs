@@ -0,0 +1,227 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+//! Host side of `entropy_src_fw_observe_stream_test`.
+//!
+//! Receives the raw entropy_src samples that the device streams over USB and
+//! writes them to a file for SP 800-90B characterization (e.g. with NIST's
+//! `ea_non_iid`). Frames that the device had to discard show up as gaps in the
+//! sequence numbers; each gap ends a run of contiguous samples.
+
+use anyhow::{bail, ensure, Context, Result};
+use clap::Parser;
+use std::fs::File;
+use std::io::{BufWriter, Write};
+use std::path::PathBuf;
+use std::time::{Duration, Instant};
+
+use opentitanlib::app::TransportWrapper;
+use opentitanlib::execute_test;
+use opentitanlib::test_utils::init::InitializeTest;
+use opentitanlib::test_utils::rpc::{ConsoleRecv, ConsoleSend};
+use opentitanlib::uart::console::UartConsole;
+
+use usb::UsbOpts;
+
+mod entropy_src_stream;
+use entropy_src_stream::{EntropySrcStreamConfig, EntropySrcStreamSummary};
+
+/// Frame header magic, "ESRW" in little endian.
+const FRAME_MAGIC: u32 = 0x5752_5345;
+/// Size of the frame header in bytes.
+const FRAME_HEADER_SIZE: usize = 16;
+/// Number of sample words in a frame.
+const FRAME_WORDS: usize = 1024;
+/// Size of a frame in bytes.
+const FRAME_SIZE: usize = FRAME_HEADER_SIZE + 4 * FRAME_WORDS;
+/// Bulk IN endpoint of the sample stream.
+const STREAM_ENDPOINT: u8 = 0x81;
+
+#[derive(Debug, Parser)]
+struct Opts {
+    #[command(flatten)]
+    init: InitializeTest,
+
+    /// Console/USB timeout.
+    #[arg(long, value_parser = humantime::parse_duration, default_value = "60s")]
+    timeout: Duration,
+
+    /// USB options.
+    #[command(flatten)]
+    usb: UsbOpts,
+
+    /// Number of frames of 4 KiB of samples to receive.
+    #[arg(long, default_value_t = 256)]
+    frames: u32,
+
+    /// Single bit mode of entropy_src: 0-3 to select an RNG bit, 4 to disable.
+    #[arg(long, default_value_t = 4)]
+    single_bit_mode: u32,
+
+    /// Run the monobit test on the samples on the device.
+    #[arg(long, default_value_t = false)]
+    quality_checks: bool,
+
+    /// Maximum number of discarded frames before the test fails.
+    #[arg(long, default_value_t = 0)]
+    max_gaps: u32,
+
+    /// File to write the samples to.
+    #[arg(long)]
+    output: Option<PathBuf>,
+
+    /// Write one sample per byte (as expected by the SP 800-90B tools) instead
+    /// of the packed observe FIFO words.
+    #[arg(long, default_value_t = false)]
+    one_sample_per_byte: bool,
+}
+
+impl Opts {
+    /// Number of bits per raw sample.
+    fn sample_bits(&self) -> u32 {
+        if self.single_bit_mode == 4 {
+            4
+        } else {
+            1
+        }
+    }
+}
+
+/// Returns the `idx`-th 32-bit word of a frame.
+fn frame_word(frame: &[u8], idx: usize) -> u32 {
+    u32::from_le_bytes(frame[4 * idx..4 * idx + 4].try_into().unwrap())
+}
+
+/// Writes the samples of a frame, unpacking them LSB first when requested.
+fn write_samples(opts: &Opts, out: &mut impl Write, data: &[u8]) -> Result<()> {
+    if !opts.one_sample_per_byte {
+        out.write_all(data)?;
+        return Ok(());
+    }
+    let bits = opts.sample_bits();
+    let mask = (1u8 << bits) - 1;
+    for byte in data {
+        for shift in (0..8).step_by(bits as usize) {
+            out.write_all(&[(byte >> shift) & mask])?;
+        }
+    }
+    Ok(())
+}
+
+fn test_entropy_src_stream(opts: &Opts, transport: &TransportWrapper) -> Result<()> {
+    let uart = transport.uart("console")?;
+    UartConsole::wait_for(&*uart, r"Running [^\r\n]*", opts.timeout)?;
+
+    // Enable VBUS sense on the board if necessary.
+    if opts.usb.vbus_control_available() {
+        opts.usb.enable_vbus(transport, true)?;
+    }
+    // Sense VBUS if available.
+    if opts.usb.vbus_sense_available() {
+        ensure!(
+            opts.usb.vbus_present(transport)?,
+            "OT USB does not appear to be connected to a host (VBUS not detected)"
+        );
+    }
+
+    let config = EntropySrcStreamConfig {
+        single_bit_mode: opts.single_bit_mode,
+        frames: opts.frames,
+        quality_checks: opts.quality_checks,
+    };
+    config.send_with_crc(&*uart)?;
+
+    log::info!("waiting for device...");
+    let mut devices = opts.usb.wait_for_device(opts.timeout)?;
+    if devices.len() != 1 {
+        bail!("expected exactly one USB device, found {}", devices.len());
+    }
+    let mut device = devices.remove(0);
+    device.claim_interface(0)?;
+
+    let mut out = match &opts.output {
+        Some(path) => Some(BufWriter::new(
+            File::create(path).with_context(|| format!("could not create {path:?}"))?,
+        )),
+        None => None,
+    };
+
+    let mut frame = vec![0u8; FRAME_SIZE];
+    let mut next_seq = 0u32;
+    let mut gaps = 0u32;
+    let start = Instant::now();
+    for _ in 0..opts.frames {
+        let len = device
+            .read_bulk(STREAM_ENDPOINT, &mut frame, opts.timeout)
+            .context("could not read frame")?;
+        ensure!(len == FRAME_SIZE, "short frame of {len} bytes");
+        let word = |idx| frame_word(&frame, idx);
+        ensure!(word(0) == FRAME_MAGIC, "bad frame magic {:#010x}", word(0));
+        ensure!(
+            word(2) as usize == FRAME_WORDS,
+            "bad frame length of {} words",
+            word(2)
+        );
+        let seq = word(1);
+        ensure!(
+            seq >= next_seq,
+            "frame {seq} received after frame {next_seq}"
+        );
+        if seq != next_seq {
+            log::warn!("frames {next_seq}..{seq} were discarded by the device");
+            gaps += seq - next_seq;
+        }
+        next_seq = seq + 1;
+        if let Some(out) = &mut out {
+            write_samples(opts, out, &frame[FRAME_HEADER_SIZE..])?;
+        }
+    }
+    let elapsed = start.elapsed();
+    if let Some(out) = &mut out {
+        out.flush()?;
+    }
+    log::info!(
+        "received {} frames in {:?} ({:.0} B/s)",
+        opts.frames,
+        elapsed,
+        (opts.frames as usize * 4 * FRAME_WORDS) as f64 / elapsed.as_secs_f64()
+    );
+
+    let summary = EntropySrcStreamSummary::recv(&*uart, opts.timeout, false)?;
+    log::info!("{:#?}", summary);
+    ensure!(
+        summary.frames_sent == opts.frames,
+        "device sent {} frames",
+        summary.frames_sent
+    );
+    ensure!(
+        summary.frames_dropped == gaps,
+        "device dropped {} frames, but {gaps} sequence numbers are missing",
+        summary.frames_dropped
+    );
+    ensure!(
+        gaps <= opts.max_gaps,
+        "{gaps} frames were discarded (max {})",
+        opts.max_gaps
+    );
+    if opts.quality_checks && summary.blocks_failed > 0 {
+        log::warn!(
+            "{} of {} blocks failed the monobit test",
+            summary.blocks_failed,
+            summary.blocks_checked
+        );
+    }
+
+    let _ = UartConsole::wait_for(&*uart, r"PASS[^\r\n]*", opts.timeout)?;
+    Ok(())
+}
+
+fn main() -> Result<()> {
+    let opts = Opts::parse();
+    opts.init.init_logging();
+
+    let transport = opts.init.init_target()?;
+    execute_test!(test_entropy_src_stream, &opts, &transport);
+    Ok(())
+}
@@ -13,7 +13,9 @@ use object::{Object, ObjectSymbol};
 use opentitanlib::app::TransportWrapper;
 use opentitanlib::execute_test;
 use opentitanlib::test_utils::init::InitializeTest;
-use opentitanlib::test_utils::mem::{MemRead32Req, MemReadReq, MemWrite32Req, MemWriteReq};
+use opentitanlib::test_utils::mem::{
+    MemRangeReq, MemRead32Req, MemReadReq, MemWrite32Req, MemWriteReq,
+};
 use opentitanlib::uart::console::UartConsole;
 
 #[derive(Debug, Parser)]
@@ -65,6 +67,24 @@ fn test_mem_array_commands(
     Ok(())
 }
 
+fn test_mem_range_commands(
+    _opts: &Opts,
+    test_range_address: u32,
+    transport: &TransportWrapper,
+) -> Result<()> {
+    let uart = transport.uart("console")?;
+    let mut data = vec![0_u8; 1300];
+    MemRangeReq::read(&*uart, test_range_address, data.as_mut_slice())?;
+    let mut expected_value: Vec<u8> = (0..data.len()).map(|i| (i * 7) as u8).collect();
+    assert!(data == expected_value);
+
+    expected_value.reverse();
+    MemRangeReq::write(&*uart, test_range_address, expected_value.as_slice())?;
+    MemRangeReq::read(&*uart, test_range_address, data.as_mut_slice())?;
+    assert!(data == expected_value);
+    Ok(())
+}
+
 fn test_end(opts: &Opts, end_test_address: u32, transport: &TransportWrapper) -> Result<()> {
     let uart = transport.uart("console")?;
     let end_test_value = MemRead32Req::execute(&*uart, end_test_address)?;
@@ -93,6 +113,9 @@ fn main() -> Result<()> {
     let test_bytes_address = symbols
         .get("kTestBytes")
         .expect("Provided ELF missing 'kTestBytes' symbol");
+    let test_range_address = symbols
+        .get("kTestRange")
+        .expect("Provided ELF missing 'kTestRange' symbol");
 
     let transport = opts.init.init_target()?;
     let uart = transport.uart("console")?;
@@ -112,6 +135,12 @@ fn main() -> Result<()> {
         *test_bytes_address,
         &transport
     );
+    execute_test!(
+        test_mem_range_commands,
+        &opts,
+        *test_range_address,
+        &transport
+    );
     execute_test!(test_end, &opts, *end_test_address, &transport);
     Ok(())
 }
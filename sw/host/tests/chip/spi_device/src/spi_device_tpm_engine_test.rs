@@ -0,0 +1,126 @@
+// Copyright lowRISC contributors (OpenTitan project).
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+use anyhow::{bail, ensure, Result};
+use clap::Parser;
+use regex::Regex;
+use std::path::PathBuf;
+use std::time::{Duration, Instant};
+
+use opentitanlib::app::TransportWrapper;
+use opentitanlib::execute_test;
+use opentitanlib::test_utils::init::InitializeTest;
+use opentitanlib::tpm::{self, Driver};
+use opentitanlib::uart::console::{ExitStatus, UartConsole};
+
+/// Command codes understood by `spi_device_tpm_engine_test.c`.
+const ECHO_COMMAND_CODE: u32 = 0x2000_0001;
+const END_COMMAND_CODE: u32 = 0x2000_00ff;
+const TAG_NO_SESSIONS: u16 = 0x8001;
+const HEADER_LEN: usize = 10;
+
+/// Command sizes to time, in bytes, including the header.
+const COMMAND_SIZES: [usize; 4] = [HEADER_LEN, 64, 1024, 4000];
+
+#[derive(Debug, Parser)]
+struct Opts {
+    #[command(flatten)]
+    init: InitializeTest,
+
+    /// Console receive timeout.
+    #[arg(long, value_parser = humantime::parse_duration, default_value = "600s")]
+    timeout: Duration,
+
+    /// Name of the SPI interface to connect to the OTTF console.
+    #[arg(long, default_value = "TPM")]
+    spi: String,
+
+    /// Number of commands to send for each size.
+    #[arg(long, default_value = "10")]
+    iterations: usize,
+
+    /// Path to the firmware's ELF file, for querying symbol addresses.
+    #[arg(value_name = "FIRMWARE_ELF")]
+    firmware_elf: PathBuf,
+}
+
+fn command(code: u32, size: usize) -> Vec<u8> {
+    let mut cmd = Vec::with_capacity(size);
+    cmd.extend_from_slice(&TAG_NO_SESSIONS.to_be_bytes());
+    cmd.extend_from_slice(&(size as u32).to_be_bytes());
+    cmd.extend_from_slice(&code.to_be_bytes());
+    cmd.extend((HEADER_LEN..size).map(|i| (i * 7) as u8));
+    cmd
+}
+
+fn check_response(cmd: &[u8], resp: &[u8], payload_len: usize) -> Result<()> {
+    ensure!(
+        resp.len() == HEADER_LEN + payload_len,
+        "bad response length"
+    );
+    ensure!(
+        resp[0..2] == TAG_NO_SESSIONS.to_be_bytes(),
+        "bad response tag"
+    );
+    ensure!(resp[6..10] == [0u8; 4], "bad response code");
+    ensure!(resp[HEADER_LEN..] == cmd[HEADER_LEN..HEADER_LEN + payload_len]);
+    Ok(())
+}
+
+fn tpm_engine_test(opts: &Opts, transport: &TransportWrapper) -> Result<()> {
+    let uart = transport.uart("console")?;
+    let spi = transport.spi(&opts.spi)?;
+    transport.pin_strapping("SPI_TPM")?.apply()?;
+
+    /* Wait sync message. */
+    let _ = UartConsole::wait_for(&*uart, r"SYNC: Begin TPM Engine Test\r\n", opts.timeout)?;
+    let tpm = tpm::SpiDriver::new(spi, false)?;
+    tpm.init()?;
+
+    for size in COMMAND_SIZES {
+        let cmd = command(ECHO_COMMAND_CODE, size);
+        let start = Instant::now();
+        for _ in 0..opts.iterations {
+            let resp = tpm.execute_command(&cmd)?;
+            check_response(&cmd, &resp, size - HEADER_LEN)?;
+        }
+        let elapsed = start.elapsed();
+        let bytes = 2 * size * opts.iterations;
+        log::info!(
+            "{} byte commands: {:?} per command, {:.0} bytes/s",
+            size,
+            elapsed / opts.iterations as u32,
+            bytes as f64 / elapsed.as_secs_f64()
+        );
+    }
+
+    let cmd = command(END_COMMAND_CODE, HEADER_LEN);
+    let resp = tpm.execute_command(&cmd)?;
+    check_response(&cmd, &resp, 0)?;
+    Ok(())
+}
+
+fn main() -> Result<()> {
+    let opts = Opts::parse();
+    opts.init.init_logging();
+
+    let transport = opts.init.init_target()?;
+    execute_test!(tpm_engine_test, &opts, &transport);
+
+    let uart = transport.uart("console")?;
+    let mut console = UartConsole {
+        timeout: Some(opts.timeout),
+        exit_success: Some(Regex::new(r"PASS!\r\n")?),
+        exit_failure: Some(Regex::new(r"FAIL:")?),
+        ..Default::default()
+    };
+
+    // Now watch the console for the exit conditions.
+    let result = console.interact(&*uart, None, Some(&mut std::io::stdout()))?;
+    if result != ExitStatus::ExitSuccess {
+        bail!("FAIL: {:?}", result);
+    };
+
+    Ok(())
+}
@@ -12,8 +12,8 @@ use serde::Deserialize;
 
 use cryptotest_commands::commands::CryptotestCommand;
 use cryptotest_commands::hash_commands::{
-    CryptotestHashAlgorithm, CryptotestHashMessage, CryptotestHashOutput,
-    CryptotestHashShakeDigestLength,
+    CryptotestHashAlgorithm, CryptotestHashBatch, CryptotestHashBatchOutput, CryptotestHashMessage,
+    CryptotestHashOutput, CryptotestHashShakeDigestLength,
 };
 
 use opentitanlib::app::TransportWrapper;
@@ -34,6 +34,11 @@ struct Opts {
 
     #[arg(long, num_args = 1..)]
     hash_json: Vec<String>,
+
+    // Maximum number of vectors per batched command. With 1, every vector is
+    // sent as its own command.
+    #[arg(long, default_value = "1")]
+    batch_size: usize,
 }
 
 #[derive(Debug, Deserialize)]
@@ -51,6 +56,40 @@ struct HashTestCase {
 
 const HASH_CMD_MAX_MESSAGE_BYTES: usize = 17068;
 const HASH_CMD_MAX_CUSTOMIZATION_STRING_BYTES: usize = 16;
+const HASH_CMD_MAX_DIGEST_BYTES: usize = 256;
+const HASH_CMD_BATCH_MAX_VECTORS: usize = 32;
+const HASH_CMD_BATCH_MAX_MESSAGE_BYTES: usize = 4096;
+const HASH_CMD_BATCH_MAX_DIGEST_BYTES: usize = 2048;
+
+fn hash_algorithm(algorithm: &str) -> CryptotestHashAlgorithm {
+    match algorithm {
+        "sha-256" => CryptotestHashAlgorithm::Sha256,
+        "sha-384" => CryptotestHashAlgorithm::Sha384,
+        "sha-512" => CryptotestHashAlgorithm::Sha512,
+        "sha3-224" => CryptotestHashAlgorithm::Sha3_224,
+        "sha3-256" => CryptotestHashAlgorithm::Sha3_256,
+        "sha3-384" => CryptotestHashAlgorithm::Sha3_384,
+        "sha3-512" => CryptotestHashAlgorithm::Sha3_512,
+        "shake-128" => CryptotestHashAlgorithm::Shake128,
+        "shake-256" => CryptotestHashAlgorithm::Shake256,
+        "cshake-128" => CryptotestHashAlgorithm::Cshake128,
+        "cshake-256" => CryptotestHashAlgorithm::Cshake256,
+        _ => panic!("Unsupported hash algorithm"),
+    }
+}
+
+fn digest_matches(test_case: &HashTestCase, digest: &[u8]) -> bool {
+    if test_case.digest.len() > digest.len() {
+        // If we got a shorter digest back then the test asks for, we
+        // can't accept the digest, even if the beginning bytes match.
+        false
+    } else {
+        // Some test cases only specify the beginning bytes of the
+        // expected digest, so we only check up to what the test
+        // specifies.
+        test_case.digest[..] == digest[..test_case.digest.len()]
+    }
+}
 
 fn run_hash_testcase(
     test_case: &HashTestCase,
@@ -80,21 +119,7 @@ fn run_hash_testcase(
     );
 
     // Send algorithm type
-    match test_case.algorithm.as_str() {
-        "sha-256" => CryptotestHashAlgorithm::Sha256,
-        "sha-384" => CryptotestHashAlgorithm::Sha384,
-        "sha-512" => CryptotestHashAlgorithm::Sha512,
-        "sha3-224" => CryptotestHashAlgorithm::Sha3_224,
-        "sha3-256" => CryptotestHashAlgorithm::Sha3_256,
-        "sha3-384" => CryptotestHashAlgorithm::Sha3_384,
-        "sha3-512" => CryptotestHashAlgorithm::Sha3_512,
-        "shake-128" => CryptotestHashAlgorithm::Shake128,
-        "shake-256" => CryptotestHashAlgorithm::Shake256,
-        "cshake-128" => CryptotestHashAlgorithm::Cshake128,
-        "cshake-256" => CryptotestHashAlgorithm::Cshake256,
-        _ => panic!("Unsupported hash algorithm"),
-    }
-    .send(spi_console)?;
+    hash_algorithm(test_case.algorithm.as_str()).send(spi_console)?;
 
     // Send required digest size for SHAKE tests (this value is
     // ignored for SHA2/3)
@@ -128,16 +153,7 @@ fn run_hash_testcase(
     }
     .into_iter()
     .for_each(|(mode, digest)| {
-        let success = if test_case.digest.len() > hash_output.digest_len {
-            // If we got a shorter digest back then the test asks for, we
-            // can't accept the digest, even if the beginning bytes match.
-            false
-        } else {
-            // Some test cases only specify the beginning bytes of the
-            // expected digest, so we only check up to what the test
-            // specifies.
-            test_case.digest[..] == digest[..test_case.digest.len()]
-        };
+        let success = digest_matches(test_case, &digest[..hash_output.digest_len]);
         if test_case.result != success {
             log::info!(
                 "FAILED {} test #{} in {} mode: expected = {}, actual = {}",
@@ -156,6 +172,65 @@ fn run_hash_testcase(
     Ok(())
 }
 
+// Whether a test case can go into a batch. The batched command has no cSHAKE
+// customization string and limits each digest like the single command does.
+fn batchable(test_case: &HashTestCase) -> bool {
+    !test_case.algorithm.starts_with("cshake")
+        && test_case.message.len() <= HASH_CMD_BATCH_MAX_MESSAGE_BYTES
+        && test_case.digest.len() <= HASH_CMD_MAX_DIGEST_BYTES
+}
+
+// Space a test case's digest takes in a batch response. SHA-2 and SHA-3
+// digests are at most 64 bytes; XOF output is rounded up to whole words.
+fn batch_digest_bytes(test_case: &HashTestCase) -> usize {
+    std::cmp::max(test_case.digest.len().div_ceil(4) * 4, 64)
+}
+
+// Runs test cases that share an algorithm with one batched command. Only the
+// oneshot API is tested in batches.
+fn run_hash_batch(
+    test_cases: &[&HashTestCase],
+    opts: &Opts,
+    spi_console: &SpiConsoleDevice,
+    fail_counter: &mut u32,
+) -> Result<()> {
+    log::info!(
+        "algorithm: {}, batch of {} test cases",
+        test_cases[0].algorithm,
+        test_cases.len()
+    );
+    CryptotestCommand::HashBatch.send(spi_console)?;
+    hash_algorithm(test_cases[0].algorithm.as_str()).send(spi_console)?;
+    CryptotestHashBatch {
+        count: test_cases.len(),
+        message_lens: test_cases.iter().map(|t| t.message.len() as u16).collect(),
+        digest_lens: test_cases.iter().map(|t| t.digest.len() as u16).collect(),
+        messages: test_cases.iter().map(|t| hex::encode(&t.message)).collect(),
+    }
+    .send(spi_console)?;
+
+    let output = CryptotestHashBatchOutput::recv(spi_console, opts.timeout, false)?;
+    assert_eq!(output.count, test_cases.len());
+    let digests = hex::decode(&output.digests)?;
+    let mut offset = 0;
+    for (test_case, &digest_len) in test_cases.iter().zip(output.digest_lens.iter()) {
+        let digest = &digests[offset..offset + digest_len as usize];
+        offset += digest_len as usize;
+        let success = digest_matches(test_case, digest);
+        if test_case.result != success {
+            log::info!(
+                "FAILED {} test #{}: expected = {}, actual = {}",
+                test_case.algorithm,
+                test_case.test_case_id,
+                test_case.result,
+                success
+            );
+            *fail_counter += 1;
+        }
+    }
+    Ok(())
+}
+
 fn test_hash(opts: &Opts, transport: &TransportWrapper) -> Result<()> {
     let spi = transport.spi("BOOTSTRAP")?;
     let spi_console_device = SpiConsoleDevice::new(&*spi)?;
@@ -168,10 +243,45 @@ fn test_hash(opts: &Opts, transport: &TransportWrapper) -> Result<()> {
         let raw_json = fs::read_to_string(file)?;
         let hash_tests: Vec<HashTestCase> = serde_json::from_str(&raw_json)?;
 
+        if opts.batch_size <= 1 {
+            for hash_test in &hash_tests {
+                test_counter += 1;
+                log::info!("Test counter: {}", test_counter);
+                run_hash_testcase(hash_test, opts, &spi_console_device, &mut fail_counter)?;
+            }
+            continue;
+        }
+
+        // Group consecutive test cases with the same algorithm into batches
+        // that fit the device buffers.
+        let batch_size = std::cmp::min(opts.batch_size, HASH_CMD_BATCH_MAX_VECTORS);
+        let mut batch: Vec<&HashTestCase> = Vec::new();
+        let mut message_bytes = 0;
+        let mut digest_bytes = 0;
         for hash_test in &hash_tests {
             test_counter += 1;
-            log::info!("Test counter: {}", test_counter);
-            run_hash_testcase(hash_test, opts, &spi_console_device, &mut fail_counter)?;
+            if !batchable(hash_test) {
+                run_hash_testcase(hash_test, opts, &spi_console_device, &mut fail_counter)?;
+                continue;
+            }
+            if !batch.is_empty()
+                && (batch.len() == batch_size
+                    || batch[0].algorithm != hash_test.algorithm
+                    || message_bytes + hash_test.message.len() > HASH_CMD_BATCH_MAX_MESSAGE_BYTES
+                    || digest_bytes + batch_digest_bytes(hash_test)
+                        > HASH_CMD_BATCH_MAX_DIGEST_BYTES)
+            {
+                run_hash_batch(&batch, opts, &spi_console_device, &mut fail_counter)?;
+                batch.clear();
+                message_bytes = 0;
+                digest_bytes = 0;
+            }
+            message_bytes += hash_test.message.len();
+            digest_bytes += batch_digest_bytes(hash_test);
+            batch.push(hash_test);
+        }
+        if !batch.is_empty() {
+            run_hash_batch(&batch, opts, &spi_console_device, &mut fail_counter)?;
         }
     }
     assert_eq!(
@@ -12,7 +12,8 @@ use serde::Deserialize;
 
 use cryptotest_commands::commands::CryptotestCommand;
 use cryptotest_commands::hmac_commands::{
-    CryptotestHmacHashAlg, CryptotestHmacKey, CryptotestHmacMessage, CryptotestHmacTag,
+    CryptotestHmacBatch, CryptotestHmacBatchOutput, CryptotestHmacHashAlg, CryptotestHmacKey,
+    CryptotestHmacMessage, CryptotestHmacTag,
 };
 
 use opentitanlib::app::TransportWrapper;
@@ -33,6 +34,11 @@ struct Opts {
 
     #[arg(long, num_args = 1..)]
     hmac_json: Vec<String>,
+
+    // Maximum number of vectors per batched command. With 1, every vector is
+    // sent as its own command.
+    #[arg(long, default_value = "1")]
+    batch_size: usize,
 }
 
 #[derive(Debug, Deserialize)]
@@ -49,6 +55,33 @@ struct HmacTestCase {
 
 const HMAC_CMD_MAX_MESSAGE_BYTES: usize = 256;
 const HMAC_CMD_MAX_KEY_BYTES: usize = 192;
+const HMAC_CMD_BATCH_MAX_VECTORS: usize = 32;
+const HMAC_CMD_BATCH_MAX_KEY_BYTES: usize = 2048;
+const HMAC_CMD_BATCH_MAX_MESSAGE_BYTES: usize = 4096;
+
+fn hmac_hash_alg(hash_alg: &str) -> CryptotestHmacHashAlg {
+    match hash_alg {
+        "sha-256" => CryptotestHmacHashAlg::Sha256,
+        "sha-384" => CryptotestHmacHashAlg::Sha384,
+        "sha-512" => CryptotestHmacHashAlg::Sha512,
+        "sha3-256" => CryptotestHmacHashAlg::Sha3_256,
+        "sha3-384" => CryptotestHmacHashAlg::Sha3_384,
+        "sha3-512" => CryptotestHmacHashAlg::Sha3_512,
+        _ => panic!("Unsupported HMAC hash mode"),
+    }
+}
+
+fn tag_matches(test_case: &HmacTestCase, tag: &[u8]) -> bool {
+    if test_case.tag.len() > tag.len() {
+        // If we got a shorter tag back then the test asks for, we can't accept the tag, even if
+        // the beginning bytes match.
+        false
+    } else {
+        // Some of the NIST test cases only specify the beginning bytes of the expected tag, so we
+        // only check up to what the test specifies.
+        test_case.tag[..] == tag[..test_case.tag.len()]
+    }
+}
 
 fn run_hmac_testcase(
     test_case: &HmacTestCase,
@@ -77,16 +110,7 @@ fn run_hmac_testcase(
         HMAC_CMD_MAX_MESSAGE_BYTES,
     );
 
-    match test_case.hash_alg.as_str() {
-        "sha-256" => CryptotestHmacHashAlg::Sha256,
-        "sha-384" => CryptotestHmacHashAlg::Sha384,
-        "sha-512" => CryptotestHmacHashAlg::Sha512,
-        "sha3-256" => CryptotestHmacHashAlg::Sha3_256,
-        "sha3-384" => CryptotestHmacHashAlg::Sha3_384,
-        "sha3-512" => CryptotestHmacHashAlg::Sha3_512,
-        _ => panic!("Unsupported HMAC hash mode"),
-    }
-    .send(spi_console)?;
+    hmac_hash_alg(test_case.hash_alg.as_str()).send(spi_console)?;
 
     CryptotestHmacKey {
         key: ArrayVec::try_from(test_case.key.as_slice()).unwrap(),
@@ -101,15 +125,7 @@ fn run_hmac_testcase(
     .send(spi_console)?;
 
     let hmac_tag = CryptotestHmacTag::recv(spi_console, opts.timeout, false)?;
-    let success = if test_case.tag.len() > hmac_tag.tag_len {
-        // If we got a shorter tag back then the test asks for, we can't accept the tag, even if
-        // the beginning bytes match.
-        false
-    } else {
-        // Some of the NIST test cases only specify the beginning bytes of the expected tag, so we
-        // only check up to what the test specifies.
-        test_case.tag[..] == hmac_tag.tag[..test_case.tag.len()]
-    };
+    let success = tag_matches(test_case, &hmac_tag.tag[..hmac_tag.tag_len]);
     if test_case.result != success {
         log::info!(
             "FAILED test #{}: expected = {}, actual = {}",
@@ -124,6 +140,47 @@ fn run_hmac_testcase(
     Ok(())
 }
 
+// Runs test cases that share a hash algorithm with one batched command.
+fn run_hmac_batch(
+    test_cases: &[&HmacTestCase],
+    opts: &Opts,
+    spi_console: &SpiConsoleDevice,
+    fail_counter: &mut u32,
+) -> Result<()> {
+    log::info!(
+        "hash: {}, batch of {} test cases",
+        test_cases[0].hash_alg,
+        test_cases.len()
+    );
+    CryptotestCommand::HmacBatch.send(spi_console)?;
+    hmac_hash_alg(test_cases[0].hash_alg.as_str()).send(spi_console)?;
+    CryptotestHmacBatch {
+        count: test_cases.len(),
+        key_lens: test_cases.iter().map(|t| t.key.len() as u16).collect(),
+        message_lens: test_cases.iter().map(|t| t.message.len() as u16).collect(),
+        keys: test_cases.iter().map(|t| hex::encode(&t.key)).collect(),
+        messages: test_cases.iter().map(|t| hex::encode(&t.message)).collect(),
+    }
+    .send(spi_console)?;
+
+    let output = CryptotestHmacBatchOutput::recv(spi_console, opts.timeout, false)?;
+    assert_eq!(output.count, test_cases.len());
+    let tags = hex::decode(&output.tags)?;
+    for (test_case, tag) in test_cases.iter().zip(tags.chunks(output.tag_len)) {
+        let success = tag_matches(test_case, tag);
+        if test_case.result != success {
+            log::info!(
+                "FAILED test #{}: expected = {}, actual = {}",
+                test_case.test_case_id,
+                test_case.result,
+                success
+            );
+            *fail_counter += 1;
+        }
+    }
+    Ok(())
+}
+
 fn test_hmac(opts: &Opts, transport: &TransportWrapper) -> Result<()> {
     let spi = transport.spi("BOOTSTRAP")?;
     let spi_console_device = SpiConsoleDevice::new(&*spi)?;
@@ -136,10 +193,51 @@ fn test_hmac(opts: &Opts, transport: &TransportWrapper) -> Result<()> {
         let raw_json = fs::read_to_string(file)?;
         let hmac_tests: Vec<HmacTestCase> = serde_json::from_str(&raw_json)?;
 
+        if opts.batch_size <= 1 {
+            for hmac_test in &hmac_tests {
+                test_counter += 1;
+                log::info!("Test counter: {}", test_counter);
+                run_hmac_testcase(hmac_test, opts, &spi_console_device, &mut fail_counter)?;
+            }
+            continue;
+        }
+
+        // Group consecutive test cases with the same hash algorithm into
+        // batches that fit the device buffers.
+        let batch_size = std::cmp::min(opts.batch_size, HMAC_CMD_BATCH_MAX_VECTORS);
+        let mut batch: Vec<&HmacTestCase> = Vec::new();
+        let mut key_bytes = 0;
+        let mut message_bytes = 0;
         for hmac_test in &hmac_tests {
             test_counter += 1;
-            log::info!("Test counter: {}", test_counter);
-            run_hmac_testcase(hmac_test, opts, &spi_console_device, &mut fail_counter)?;
+            assert_eq!(hmac_test.algorithm.as_str(), "hmac");
+            assert!(
+                hmac_test.key.len() <= HMAC_CMD_MAX_KEY_BYTES,
+                "Key too long for device firmware configuration (got = {}, max = {})",
+                hmac_test.key.len(),
+                HMAC_CMD_MAX_KEY_BYTES,
+            );
+            if hmac_test.message.len() > HMAC_CMD_BATCH_MAX_MESSAGE_BYTES {
+                run_hmac_testcase(hmac_test, opts, &spi_console_device, &mut fail_counter)?;
+                continue;
+            }
+            if !batch.is_empty()
+                && (batch.len() == batch_size
+                    || batch[0].hash_alg != hmac_test.hash_alg
+                    || key_bytes + hmac_test.key.len() > HMAC_CMD_BATCH_MAX_KEY_BYTES
+                    || message_bytes + hmac_test.message.len() > HMAC_CMD_BATCH_MAX_MESSAGE_BYTES)
+            {
+                run_hmac_batch(&batch, opts, &spi_console_device, &mut fail_counter)?;
+                batch.clear();
+                key_bytes = 0;
+                message_bytes = 0;
+            }
+            key_bytes += hmac_test.key.len();
+            message_bytes += hmac_test.message.len();
+            batch.push(hmac_test);
+        }
+        if !batch.is_empty() {
+            run_hmac_batch(&batch, opts, &spi_console_device, &mut fail_counter)?;
         }
     }
     assert_eq!(
@@ -25,7 +25,7 @@
 // overridden using command line parameters.
 //
 // Usage:
-//   stream [-v<bool>][-c<bool>][-r<bool>][-s<bool>]
+//   stream [-v<bool>][-c<bool>][-r<bool>][-s<bool>][-e<bool>][-q<depth>]
 //          [[-d<bus>:<address>] | [--device <bus>:<address>]]
 //          [<input port>[ <output port>]]
 //
@@ -34,6 +34,8 @@
 //
 //   -c   check any retrieved data against expectations
 //   -d   specify a particular USB device by bus number and device address
+//   -e   handle libusb events on a dedicated thread
+//   -q   number of libusb transfers to keep in flight on each endpoint
 //   -r   retrieve data from device
 //   -s   send data to device
 //   -t   use serial ports (ttyUSBx) in preference to libusb Bulk Transfer
@@ -154,6 +156,7 @@ void ReportSyntax(void) {
   fputs(
       "Usage:\n"
       "  stream [-n<streams>][-v<bool>][-c<bool>][-r<bool>][-s<bool>][-t][-z]\n"
+      "         [-e<bool>][-q<depth>]\n"
       "         [[-d<bus>:<address>] | [--device <bus>:<address>]]\n"
       "         [<input port>[ <output port>]]"
       "\n\n"
@@ -163,6 +166,9 @@ void ReportSyntax(void) {
       "  -c   check any retrieved data against expectations\n"
       "  -d   specify a particular USB device by bus number"
       " and device address\n"
+      "  -e   handle libusb events on a dedicated thread\n"
+      "  -q   number of libusb transfers to keep in flight on each endpoint\n"
+      "       (default 1)\n"
       "  -r   retrieve data from device\n"
       "  -s   send data to device\n"
       "  -t   use serial ports (ttyUSBx) in preference to libusb Bulk\n"
@@ -289,8 +295,8 @@ static int RunTest(USBDevice *dev, const char *in_port, const char *out_port) {
 #if STREAMTEST_LIBUSB
       case USBDevStream::StreamType_Isochronous: {
         USBDevIso *iso;
-        iso = new USBDevIso(dev, idx, transfer_bytes, cfg.retrieve, cfg.check,
-                            cfg.send, cfg.verbose);
+        iso = new USBDevIso(dev, idx, transfer_bytes, cfg.queue_depth,
+                            cfg.retrieve, cfg.check, cfg.send, cfg.verbose);
         if (iso) {
           opened = iso->Open(idx);
           if (opened) {
@@ -305,8 +311,9 @@ static int RunTest(USBDevice *dev, const char *in_port, const char *out_port) {
         // Transfers.
       case USBDevStream::StreamType_Bulk: {
         USBDevInt *interrupt;
-        interrupt = new USBDevInt(dev, bulk, idx, transfer_bytes, cfg.retrieve,
-                                  cfg.check, cfg.send, cfg.verbose);
+        interrupt =
+            new USBDevInt(dev, bulk, idx, transfer_bytes, cfg.queue_depth,
+                          cfg.retrieve, cfg.check, cfg.send, cfg.verbose);
         if (interrupt) {
           opened = interrupt->Open(idx);
           if (opened) {
@@ -332,6 +339,14 @@ static int RunTest(USBDevice *dev, const char *in_port, const char *out_port) {
     }
   }
 
+#if STREAMTEST_LIBUSB
+  // From here onwards, stream state is accessed only with the stream lock held
+  // if libusb events are handled on their own thread.
+  if (cfg.event_thread) {
+    dev->StartEventThread();
+  }
+#endif
+
   std::cout << "Streaming..." << std::endl;
 
   // Times are in microseconds.
@@ -342,6 +357,7 @@ static int RunTest(USBDevice *dev, const char *in_port, const char *out_port) {
   // over its duration, so there's little point trying to communicate sooner.
   constexpr uint32_t kResumeInterval = 30 * 1000;  // Resuming before traffic.
   uint64_t start_time = time_us();
+  uint64_t test_start = start_time;
   uint32_t prev_bytes = 0;
   bool done = false;
   do {
@@ -445,6 +461,9 @@ static int RunTest(USBDevice *dev, const char *in_port, const char *out_port) {
 
     // Tidy up if something went wrong.
     if (failed) {
+#if STREAMTEST_LIBUSB
+      dev->StopEventThread();
+#endif
       for (unsigned idx = 0U; idx < nstreams; idx++) {
         (void)streams[idx]->Stop();
       }
@@ -466,19 +485,26 @@ static int RunTest(USBDevice *dev, const char *in_port, const char *out_port) {
   } while (!done);
 
   uint64_t elapsed_time = time_us() - start_time;
+  uint64_t test_time = time_us() - test_start;
+
+#if STREAMTEST_LIBUSB
+  dev->StopEventThread();
+#endif
 
   // Report time elapsed from the start of data transfer.
   for (unsigned idx = 0U; idx < nstreams; idx++) {
     streams[idx]->Stop();
   }
 
-  // TODO: introduce a crude estimate of the performance being achieved,
-  // for profiling the performance of IN and OUT traffic; totals and individual
-  // endpoints?
   double elapsed_secs = elapsed_time / 1e6;
   printf("Test completed in %.2lf seconds (%" PRIu64 "us)\n", elapsed_secs,
          elapsed_time);
 
+  // Report the performance achieved by the individual streams.
+  for (unsigned idx = 0U; idx < nstreams; idx++) {
+    fputs(streams[idx]->PerfReport(test_time).c_str(), stdout);
+  }
+
   return 0;
 }
 
@@ -508,6 +534,20 @@ int main(int argc, char *argv[]) {
             return 7;
           }
           break;
+        case 'e':
+          cfg.event_thread = GetBool(&argv[i][2]);
+          break;
+        case 'q': {
+          const char *p = &argv[i][2];
+          uint8_t depth;
+          if (!GetByte(&p, depth) || !depth || *p != '\0') {
+            std::cerr << "ERROR: Invalid queue depth '" << argv[i] << "'"
+                      << std::endl;
+            ReportSyntax();
+            return 7;
+          }
+          cfg.queue_depth = depth;
+        } break;
         case 'r':
           cfg.retrieve = GetBool(&argv[i][2]);
           cfg.override_flags = true;
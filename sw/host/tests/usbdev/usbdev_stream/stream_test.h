@@ -30,7 +30,9 @@ struct TestConfig {
 #else
         serial(true),
 #endif
-        suspending(false) {
+        suspending(false),
+        queue_depth(1U),
+        event_thread(false) {
   }
   /**
    * Verbose logging/diagnostic reporting.
@@ -60,6 +62,14 @@ struct TestConfig {
    * Are we performing suspend-resume testing whilst streaming?
    */
   bool suspending;
+  /**
+   * Number of libusb transfers to keep in flight on each endpoint.
+   */
+  unsigned queue_depth;
+  /**
+   * Handle libusb events on a dedicated thread?
+   */
+  bool event_thread;
 };
 
 // Has any data yet been received from the device?
@@ -41,6 +41,9 @@ bool USBDevice::Init(uint16_t vendorID, uint16_t productID, uint8_t devAddress,
 
 // Finalize use of the device.
 bool USBDevice::Fin() {
+#if STREAMTEST_LIBUSB
+  StopEventThread();
+#endif
   (void)Close();
 #if STREAMTEST_LIBUSB
   if (parenth_) {
@@ -229,6 +232,17 @@ bool USBDevice::Close() {
 
 bool USBDevice::Service() {
 #if STREAMTEST_LIBUSB
+  if (eventThreaded_) {
+    if (eventsFailed_) {
+      return false;
+    }
+    // Let the event thread process any completed transfers.
+    streamLock_.unlock();
+    usleep(kServiceYield);
+    streamLock_.lock();
+    return true;
+  }
+
   struct timeval tv = {0};
   int rc = libusb_handle_events_timeout(ctx_, &tv);
   if (rc < 0) {
@@ -238,6 +252,42 @@ bool USBDevice::Service() {
   return true;
 }
 
+#if STREAMTEST_LIBUSB
+bool USBDevice::StartEventThread() {
+  if (!eventThreaded_) {
+    // The caller holds the stream lock until the thread is stopped, except
+    // whilst within Service().
+    streamLock_.lock();
+    eventsStop_ = false;
+    eventsFailed_ = false;
+    eventThread_ = std::thread(&USBDevice::EventThread, this);
+    eventThreaded_ = true;
+  }
+  return true;
+}
+
+void USBDevice::StopEventThread() {
+  if (eventThreaded_) {
+    streamLock_.unlock();
+    eventsStop_ = true;
+    eventThread_.join();
+    eventThreaded_ = false;
+  }
+}
+
+void USBDevice::EventThread() {
+  while (!eventsStop_) {
+    struct timeval tv = {0, kEventTimeout};
+    int rc = libusb_handle_events_timeout_completed(ctx_, &tv, nullptr);
+    if (rc < 0 && rc != LIBUSB_ERROR_INTERRUPTED) {
+      ErrorUSB("ERROR: Handling events", rc);
+      eventsFailed_ = true;
+      break;
+    }
+  }
+}
+#endif
+
 // Return the name of a test phase
 const char *USBDevice::PhaseName(usbdev_suspend_phase_t phase) {
   switch (phase) {
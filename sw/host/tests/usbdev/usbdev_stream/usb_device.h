@@ -9,7 +9,10 @@
 // not available; libusb is required to exercise Isochronous streams, Interrupt
 // streams and Control Transfers.
 #if STREAMTEST_LIBUSB
+#include <atomic>
 #include <libusb-1.0/libusb.h>
+#include <mutex>
+#include <thread>
 #endif
 
 class USBDevice {
@@ -20,7 +23,10 @@ class USBDevice {
         manual_(manual),
         state_(StateStreaming),
         ctx_(nullptr),
-        devh_(nullptr) {}
+        devh_(nullptr),
+        eventThreaded_(false),
+        eventsStop_(false),
+        eventsFailed_(false) {}
 #else
   USBDevice(bool verbose = false, bool manual = false)
       : verbose_(verbose),
@@ -130,9 +136,29 @@ class USBDevice {
   static constexpr unsigned kDevDataMaxPacketSize = 0x40U;
 
   // Our USB device has a maximum packet size of just 64 bytes even for
-  // Isochronous transfers; this may one day be increased.
+  // Isochronous transfers; this may one day be increased, so Isochronous
+  // streams use the size reported by the endpoint descriptor where available.
   static constexpr unsigned kDevIsoMaxPacketSize = 0x40U;
 
+#if STREAMTEST_LIBUSB
+  /**
+   * Transfer descriptor owned by a stream, with its own data buffer; this
+   * allows a stream to keep several transfers in flight on each endpoint.
+   */
+  struct StreamTransfer {
+    // libusb transfer descriptor.
+    struct libusb_transfer *xfr;
+    // Stream that owns this transfer.
+    void *stream;
+    // Data buffer.
+    uint8_t *buf;
+    // Is this transfer in flight?
+    bool active;
+    // Time at which the transfer was submitted, in microseconds.
+    uint64_t submitted;
+  };
+#endif
+
   /**
    * Initialize USB device before test; called once at startup.
    *
@@ -167,11 +193,49 @@ class USBDevice {
   /**
    * Service the device; keep libusb transfers being processed.
    *
+   * If the event thread is running, this instead releases the stream lock
+   * briefly so that the event thread may process transfer completions.
+   *
    * @return true iff the device is still operational.
    */
   bool Service();
 
 #if STREAMTEST_LIBUSB
+  /**
+   * Start a thread dedicated to handling libusb events, so that completed
+   * transfers are processed and further transfers submitted without waiting
+   * for the main loop to call Service().
+   *
+   * On return the calling thread holds the stream lock, which Service()
+   * releases only briefly. Synchronous Control Transfers must not be
+   * performed whilst streams have transfers in flight.
+   *
+   * @return true iff the thread was started, or was already running.
+   */
+  bool StartEventThread();
+  /**
+   * Stop the event handling thread, if running, releasing the stream lock.
+   */
+  void StopEventThread();
+  /**
+   * Return the lock that serializes access to stream state between
+   * transfer callbacks and the main loop.
+   *
+   * @return The stream lock.
+   */
+  std::recursive_mutex &StreamLock() { return streamLock_; }
+  /**
+   * Return the maximum packet size of an Isochronous endpoint, as reported by
+   * its endpoint descriptor.
+   *
+   * @param  ep      Endpoint address.
+   * @return The maximum packet size in bytes, or kDevIsoMaxPacketSize if it
+   *         could not be determined.
+   */
+  unsigned MaxIsoPacketSize(uint8_t ep) const {
+    int size = libusb_get_max_iso_packet_size(libusb_get_device(devh_), ep);
+    return (size > 0) ? (unsigned)size : kDevIsoMaxPacketSize;
+  }
   /**
    * Claim an interface on the device.
    *
@@ -426,6 +490,31 @@ class USBDevice {
 
   // Device descriptor.
   libusb_device_descriptor devDesc_;
+
+  // Body of the event handling thread.
+  void EventThread();
+
+  // Is the event handling thread running?
+  bool eventThreaded_;
+
+  // Event handling thread.
+  std::thread eventThread_;
+
+  // Request for the event handling thread to stop.
+  std::atomic<bool> eventsStop_;
+
+  // Has the event handling thread failed?
+  std::atomic<bool> eventsFailed_;
+
+  // Lock serializing access to stream state between transfer callbacks and
+  // the main loop; recursive because synchronous libusb calls may invoke
+  // callbacks on the calling thread.
+  std::recursive_mutex streamLock_;
+
+  // Maximum time that the event thread waits for an event, and the time for
+  // which Service() releases the stream lock, in microseconds.
+  static constexpr unsigned kEventTimeout = 100000u;
+  static constexpr unsigned kServiceYield = 100u;
 #else
   // Device handle; just retain whether open/closed.
   bool devh_;
@@ -5,18 +5,62 @@
 
 #include <cassert>
 #include <cstdio>
+#include <cstring>
 
 #include "usbdev_utils.h"
 
 // Stub callback function supplied to libusb.
 void LIBUSB_CALL USBDevInt::CbStubIN(struct libusb_transfer *xfr) {
-  USBDevInt *self = reinterpret_cast<USBDevInt *>(xfr->user_data);
-  self->CallbackIN(xfr);
+  USBDevice::StreamTransfer *t =
+      reinterpret_cast<USBDevice::StreamTransfer *>(xfr->user_data);
+  USBDevInt *self = reinterpret_cast<USBDevInt *>(t->stream);
+  std::lock_guard<std::recursive_mutex> lock(self->dev_->StreamLock());
+  self->CallbackIN(t);
 }
 
 void LIBUSB_CALL USBDevInt::CbStubOUT(struct libusb_transfer *xfr) {
-  USBDevInt *self = reinterpret_cast<USBDevInt *>(xfr->user_data);
-  self->CallbackOUT(xfr);
+  USBDevice::StreamTransfer *t =
+      reinterpret_cast<USBDevice::StreamTransfer *>(xfr->user_data);
+  USBDevInt *self = reinterpret_cast<USBDevInt *>(t->stream);
+  std::lock_guard<std::recursive_mutex> lock(self->dev_->StreamLock());
+  self->CallbackOUT(t);
+}
+
+USBDevInt::~USBDevInt() {
+  for (auto &t : xfrsIn_) {
+    dev_->FreeTransfer(t.xfr);
+    delete[] t.buf;
+  }
+  for (auto &t : xfrsOut_) {
+    dev_->FreeTransfer(t.xfr);
+    delete[] t.buf;
+  }
+}
+
+bool USBDevInt::AllocTransfers(std::vector<USBDevice::StreamTransfer> &xfrs,
+                               uint32_t len) {
+  xfrs.resize(depth_);
+  for (auto &t : xfrs) {
+    t.xfr = dev_->AllocTransfer(0U);
+    t.stream = this;
+    t.buf = new uint8_t[len];
+    t.active = false;
+    t.submitted = 0U;
+    if (!t.xfr) {
+      return false;
+    }
+  }
+  return true;
+}
+
+USBDevice::StreamTransfer *USBDevInt::IdleTransfer(
+    std::vector<USBDevice::StreamTransfer> &xfrs) {
+  for (auto &t : xfrs) {
+    if (!t.active) {
+      return &t;
+    }
+  }
+  return nullptr;
 }
 
 bool USBDevInt::Open(unsigned interface) {
@@ -32,13 +76,15 @@ bool USBDevInt::Open(unsigned interface) {
   epOut_ = interface + 1U;
   epIn_ = 0x80U | epOut_;
 
-  // No transfers in progress.
-  xfrIn_ = nullptr;
-
-  xfrOut_ = nullptr;
-
   maxPacketSize_ = USBDevice::kDevDataMaxPacketSize;
 
+  // Allocate the transfers; none is yet in progress.
+  if (!AllocTransfers(xfrsIn_, maxPacketSize_) ||
+      !AllocTransfers(xfrsOut_, kOutTransferSize)) {
+    std::cerr << PrefixID() << " Failed to allocate transfers" << std::endl;
+    return false;
+  }
+
   return true;
 }
 
@@ -57,7 +103,7 @@ void USBDevInt::Pause() {
   if (verbose_) {
     std::cout << PrefixID() << "waiting to close" << std::endl;
   }
-  while (inActive_ || outActive_) {
+  while (inFlight_ || outFlight_) {
     dev_->Service();
   }
   if (verbose_) {
@@ -92,38 +138,43 @@ void USBDevInt::DumpIntTransfer(struct libusb_transfer *xfr) const {
 
 // Retrieving of IN traffic from device.
 bool USBDevInt::ServiceIN() {
-  // Ensure that we have enough space available for a full packet; the device
-  // software decides upon the length of each packet.
-  uint8_t *space;
-  bool ok = ProvisionSpace(&space, maxPacketSize_);
-  if (ok) {
-    uint32_t to_fetch = maxPacketSize_;
-    if (to_fetch > transfer_bytes_ - bytes_recvd_) {
-      to_fetch = transfer_bytes_ - bytes_recvd_;
+  while (inFlight_ < depth_) {
+    // Ensure that we have enough space available for a full packet from each
+    // of the IN transfers in flight; the device software decides upon the
+    // length of each packet.
+    if (!ProvisionSpace(nullptr, (inFlight_ + 1U) * maxPacketSize_)) {
+      break;
     }
 
-    if (!xfrIn_) {
-      xfrIn_ = dev_->AllocTransfer(0U);
-      if (!xfrIn_) {
-        return false;
-      }
+    uint32_t to_fetch = maxPacketSize_;
+    uint32_t remaining = transfer_bytes_ - bytes_recvd_;
+    remaining = (remaining > inRequested_) ? (remaining - inRequested_) : 0U;
+    if (to_fetch > remaining) {
+      to_fetch = remaining;
+    }
+    if (!to_fetch) {
+      break;
     }
 
+    USBDevice::StreamTransfer *t = IdleTransfer(xfrsIn_);
+    assert(t);
+
     if (bulk_) {
-      dev_->FillBulkTransfer(xfrIn_, epIn_, space, to_fetch, CbStubIN, this,
+      dev_->FillBulkTransfer(t->xfr, epIn_, t->buf, to_fetch, CbStubIN, t,
                              kDataTimeout);
     } else {
-      dev_->FillIntTransfer(xfrIn_, epIn_, space, to_fetch, CbStubIN, this,
+      dev_->FillIntTransfer(t->xfr, epIn_, t->buf, to_fetch, CbStubIN, t,
                             kDataTimeout);
     }
 
-    int rc = dev_->SubmitTransfer(xfrIn_);
+    t->submitted = time_us();
+    int rc = dev_->SubmitTransfer(t->xfr);
     if (rc < 0) {
       return dev_->ErrorUSB("ERROR: Submitting IN transfer", rc);
     }
-    inActive_ = true;
-  } else {
-    inActive_ = false;
+    t->active = true;
+    inRequested_ += to_fetch;
+    inFlight_++;
   }
 
   return true;
@@ -131,35 +182,40 @@ bool USBDevInt::ServiceIN() {
 
 // Sending of OUT traffic to device.
 bool USBDevInt::ServiceOUT() {
-  // Do we have any data ready to send?
-  uint8_t *data;
-  uint32_t num_bytes = DataAvailable(&data);
-  if (num_bytes > 0U) {
-    // Supply details of the single OUT packet.
-    if (!xfrOut_) {
-      xfrOut_ = dev_->AllocTransfer(0U);
-      if (!xfrOut_) {
-        // Stream is not operational.
-        return false;
-      }
+  while (outFlight_ < depth_) {
+    // Do we have any data ready to send?
+    uint8_t *data;
+    uint32_t num_bytes = DataAvailable(&data);
+    if (!num_bytes) {
+      // Nothing to propagate at this time.
+      break;
+    }
+    if (num_bytes > kOutTransferSize) {
+      num_bytes = kOutTransferSize;
     }
 
+    // Each transfer in flight has its own copy of the data, so that the
+    // circular buffer is free to accept more IN data.
+    USBDevice::StreamTransfer *t = IdleTransfer(xfrsOut_);
+    assert(t);
+    memcpy(t->buf, data, num_bytes);
+    DiscardData(num_bytes);
+
     if (bulk_) {
-      dev_->FillBulkTransfer(xfrOut_, epOut_, data, num_bytes, CbStubOUT, this,
+      dev_->FillBulkTransfer(t->xfr, epOut_, t->buf, num_bytes, CbStubOUT, t,
                              kDataTimeout);
     } else {
-      dev_->FillIntTransfer(xfrOut_, epOut_, data, num_bytes, CbStubOUT, this,
+      dev_->FillIntTransfer(t->xfr, epOut_, t->buf, num_bytes, CbStubOUT, t,
                             kDataTimeout);
     }
 
-    int rc = dev_->SubmitTransfer(xfrOut_);
+    t->submitted = time_us();
+    int rc = dev_->SubmitTransfer(t->xfr);
     if (rc < 0) {
       return dev_->ErrorUSB("ERROR: Submitting OUT transfer", rc);
     }
-    outActive_ = true;
-  } else {
-    // Nothing to propagate at this time.
-    outActive_ = false;
+    t->active = true;
+    outFlight_++;
   }
   // Stream remains operational, even if it presently has no work on the OUT
   // side.
@@ -170,20 +226,26 @@ bool USBDevInt::Service() {
   if (failed_) {
     return false;
   }
-  // (Re)start IN traffic if not already in progress.
-  if (!inActive_ && !ServiceIN()) {
+  // Keep the IN transfers in flight.
+  if (CanSchedule() && !ServiceIN()) {
     return false;
   }
-  // (Re)start OUT traffic if not already in progress and there is
-  // data available to be transmitted.
-  if (!outActive_ && !ServiceOUT()) {
+  // Keep the OUT transfers in flight whilst there is data available to be
+  // transmitted.
+  if (CanSchedule() && !ServiceOUT()) {
     return false;
   }
   return true;
 }
 
 // Callback function supplied to libusb for IN transfers.
-void USBDevInt::CallbackIN(struct libusb_transfer *xfr) {
+void USBDevInt::CallbackIN(USBDevice::StreamTransfer *t) {
+  struct libusb_transfer *xfr = t->xfr;
+  t->active = false;
+  inRequested_ -= xfr->length;
+  inFlight_--;
+  RecordLatency(elapsed_time(t->submitted));
+
   if (xfr->status != LIBUSB_TRANSFER_COMPLETED) {
     std::cerr << PrefixID() << " Invalid/unexpected IN transfer status "
               << xfr->status << std::endl;
@@ -198,13 +260,22 @@ void USBDevInt::CallbackIN(struct libusb_transfer *xfr) {
     DumpIntTransfer(xfr);
   }
 
-  // Collect and parse signature bytes at the start of the IN stream.
-  uint8_t *dp = xfr->buffer;
+  // Transfers complete in order, so the received data may simply be appended
+  // to the circular buffer; space was provisioned before submission.
+  uint8_t *dp;
   int nrecvd = xfr->actual_length;
+  if (!ProvisionSpace(&dp, (uint32_t)nrecvd)) {
+    std::cerr << PrefixID() << " No space for IN data" << std::endl;
+    failed_ = true;
+    return;
+  }
+  memcpy(dp, xfr->buffer, nrecvd);
 
   // Update the circular buffer with the amount of data that we've received
   CommitData(nrecvd);
 
+  // Collect and parse signature bytes at the start of the IN stream.
+
   if (!SigReceived()) {
     if (nrecvd > 0 && !SigReceived()) {
       uint32_t dropped = SigDetect(&sig_, dp, (uint32_t)nrecvd);
@@ -236,10 +307,8 @@ void USBDevInt::CallbackIN(struct libusb_transfer *xfr) {
 
   if (ok) {
     if (CanSchedule()) {
-      // Attempt to set up another IN transfer.
-      failed_ = !ServiceIN();
-    } else {
-      inActive_ = false;
+      // Attempt to set up more IN transfers, and send the data onwards.
+      failed_ = !ServiceIN() || !ServiceOUT();
     }
   } else {
     failed_ = true;
@@ -247,7 +316,12 @@ void USBDevInt::CallbackIN(struct libusb_transfer *xfr) {
 }
 
 // Callback function supplied to libusb for OUT transfers.
-void USBDevInt::CallbackOUT(struct libusb_transfer *xfr) {
+void USBDevInt::CallbackOUT(USBDevice::StreamTransfer *t) {
+  struct libusb_transfer *xfr = t->xfr;
+  t->active = false;
+  outFlight_--;
+  RecordLatency(elapsed_time(t->submitted));
+
   if (xfr->status != LIBUSB_TRANSFER_COMPLETED) {
     std::cerr << PrefixID() << " Invalid/unexpected OUT transfer status "
               << xfr->status << std::endl;
@@ -262,14 +336,13 @@ void USBDevInt::CallbackOUT(struct libusb_transfer *xfr) {
     DumpIntTransfer(xfr);
   }
 
-  // Note: we're not expecting any truncation on OUT transfers.
+  // Note: we're not expecting any truncation on OUT transfers. The data was
+  // removed from the circular buffer when the transfer was submitted.
   assert(xfr->actual_length == xfr->length);
-  ConsumeData(xfr->actual_length);
+  bytes_sent_ += xfr->actual_length;
 
   if (CanSchedule()) {
-    // Attempt to set up another OUT transfer.
+    // Attempt to set up more OUT transfers.
     failed_ = !ServiceOUT();
-  } else {
-    outActive_ = false;
   }
 }
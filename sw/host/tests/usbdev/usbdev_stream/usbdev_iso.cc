@@ -5,18 +5,62 @@
 
 #include <cassert>
 #include <cstdio>
+#include <cstring>
 
 #include "usbdev_utils.h"
 
 // Stub callback function supplied to libusb.
 void LIBUSB_CALL USBDevIso::CbStubIN(struct libusb_transfer *xfr) {
-  USBDevIso *self = reinterpret_cast<USBDevIso *>(xfr->user_data);
-  self->CallbackIN(xfr);
+  USBDevice::StreamTransfer *t =
+      reinterpret_cast<USBDevice::StreamTransfer *>(xfr->user_data);
+  USBDevIso *self = reinterpret_cast<USBDevIso *>(t->stream);
+  std::lock_guard<std::recursive_mutex> lock(self->dev_->StreamLock());
+  self->CallbackIN(t);
 }
 
 void LIBUSB_CALL USBDevIso::CbStubOUT(struct libusb_transfer *xfr) {
-  USBDevIso *self = reinterpret_cast<USBDevIso *>(xfr->user_data);
-  self->CallbackOUT(xfr);
+  USBDevice::StreamTransfer *t =
+      reinterpret_cast<USBDevice::StreamTransfer *>(xfr->user_data);
+  USBDevIso *self = reinterpret_cast<USBDevIso *>(t->stream);
+  std::lock_guard<std::recursive_mutex> lock(self->dev_->StreamLock());
+  self->CallbackOUT(t);
+}
+
+USBDevIso::~USBDevIso() {
+  for (auto &t : xfrsIn_) {
+    dev_->FreeTransfer(t.xfr);
+    delete[] t.buf;
+  }
+  for (auto &t : xfrsOut_) {
+    dev_->FreeTransfer(t.xfr);
+    delete[] t.buf;
+  }
+}
+
+bool USBDevIso::AllocTransfers(std::vector<USBDevice::StreamTransfer> &xfrs,
+                               uint32_t len) {
+  xfrs.resize(depth_);
+  for (auto &t : xfrs) {
+    t.xfr = dev_->AllocTransfer(kNumIsoPackets);
+    t.stream = this;
+    t.buf = new uint8_t[len];
+    t.active = false;
+    t.submitted = 0U;
+    if (!t.xfr) {
+      return false;
+    }
+  }
+  return true;
+}
+
+USBDevice::StreamTransfer *USBDevIso::IdleTransfer(
+    std::vector<USBDevice::StreamTransfer> &xfrs) {
+  for (auto &t : xfrs) {
+    if (!t.active) {
+      return &t;
+    }
+  }
+  return nullptr;
 }
 
 bool USBDevIso::Open(unsigned interface) {
@@ -32,15 +76,18 @@ bool USBDevIso::Open(unsigned interface) {
   epOut_ = interface + 1U;
   epIn_ = 0x80U | epOut_;
 
-  // No transfers in progress.
-  xfrIn_ = nullptr;
-  xfrOut_ = nullptr;
-
   // Expected sequence number of first packet.
   tst_seq_ = 0U;
 
-  // Maximum size of a packet in bytes.
-  maxPacketSize_ = USBDevice::kDevIsoMaxPacketSize;
+  // Maximum size of a packet in bytes; OUT packets echo the IN packets.
+  maxPacketSize_ = dev_->MaxIsoPacketSize(epIn_);
+
+  // Allocate the transfers; none is yet in progress.
+  if (!AllocTransfers(xfrsIn_, maxPacketSize_) ||
+      !AllocTransfers(xfrsOut_, maxPacketSize_)) {
+    std::cerr << PrefixID() << " Failed to allocate transfers" << std::endl;
+    return false;
+  }
 
   return true;
 }
@@ -57,7 +104,7 @@ void USBDevIso::Stop() {
 void USBDevIso::Pause() {
   SetClosing(true);
 
-  while (inActive_ || outActive_) {
+  while (inFlight_ || outFlight_) {
     dev_->Service();
   }
 
@@ -93,7 +140,7 @@ std::string USBDevIso::Report(bool status, bool verbose) const { return ""; }
 
 void USBDevIso::DumpIsoTransfer(struct libusb_transfer *xfr) const {
   for (int idx = 0U; idx < xfr->num_iso_packets; idx++) {
-    struct libusb_iso_packet_descriptor *pack = &xfrIn_->iso_packet_desc[idx];
+    struct libusb_iso_packet_descriptor *pack = &xfr->iso_packet_desc[idx];
     std::cout << "Requested " << pack->length << " actual "
               << pack->actual_length << std::endl;
     // Buffer dumping works only because we have just a single Iso packet per
@@ -104,29 +151,28 @@ void USBDevIso::DumpIsoTransfer(struct libusb_transfer *xfr) const {
 
 // Retrieving of IN traffic from device.
 bool USBDevIso::ServiceIN() {
-  // Ensure that we have enough space available for a full packet; the device
-  // software decides upon the length of each packet.
-  uint8_t *space;
-  bool ok = ProvisionSpace(&space, maxPacketSize_);
-  if (ok) {
-    if (!xfrIn_) {
-      xfrIn_ = dev_->AllocTransfer(kNumIsoPackets);
-      if (!xfrIn_) {
-        return false;
-      }
+  while (inFlight_ < depth_) {
+    // Ensure that we have enough space available for a full packet from each
+    // of the IN transfers in flight; the device software decides upon the
+    // length of each packet.
+    if (!ProvisionSpace(nullptr, (inFlight_ + 1U) * maxPacketSize_)) {
+      break;
     }
 
-    dev_->FillIsoTransfer(xfrIn_, epIn_, space, maxPacketSize_, kNumIsoPackets,
-                          CbStubIN, this, kIsoTimeout);
-    dev_->SetIsoPacketLengths(xfrIn_, maxPacketSize_);
+    USBDevice::StreamTransfer *t = IdleTransfer(xfrsIn_);
+    assert(t);
 
-    int rc = dev_->SubmitTransfer(xfrIn_);
+    dev_->FillIsoTransfer(t->xfr, epIn_, t->buf, maxPacketSize_,
+                          kNumIsoPackets, CbStubIN, t, kIsoTimeout);
+    dev_->SetIsoPacketLengths(t->xfr, maxPacketSize_);
+
+    t->submitted = time_us();
+    int rc = dev_->SubmitTransfer(t->xfr);
     if (rc < 0) {
       return dev_->ErrorUSB("ERROR: Submitting IN transfer", rc);
     }
-    inActive_ = true;
-  } else {
-    inActive_ = false;
+    t->active = true;
+    inFlight_++;
   }
   return true;
 }
@@ -134,37 +180,36 @@ bool USBDevIso::ServiceIN() {
 // Sending of OUT traffic to device.
 bool USBDevIso::ServiceOUT() {
   // Do we have one or more packets ready for sending?
-  if (pktLen_.empty()) {
-    // Nothing to propagate at this time.
-    outActive_ = false;
-  } else {
+  while (outFlight_ < depth_ && !pktLen_.empty()) {
     uint32_t len = pktLen_.front();
     pktLen_.pop();
     // We should have propagated only valid packets to the OUT side ready for
     // transmission.
-    assert(len >= sizeof(usbdev_stream_sig_t));
+    assert(len >= sizeof(usbdev_stream_sig_t) && len <= maxPacketSize_);
 
     uint8_t *data;
     size_t num_bytes = DataAvailable(&data);
     assert(num_bytes >= len);
 
+    // Each transfer in flight has its own copy of the packet, so that the
+    // circular buffer is free to accept more IN data.
+    USBDevice::StreamTransfer *t = IdleTransfer(xfrsOut_);
+    assert(t);
+    memcpy(t->buf, data, len);
+    DiscardData(len);
+
     // Supply details of the single OUT packet.
-    if (!xfrOut_) {
-      xfrOut_ = dev_->AllocTransfer(kNumIsoPackets);
-      if (!xfrOut_) {
-        // Stream is not operational.
-        return false;
-      }
-    }
-    dev_->FillIsoTransfer(xfrOut_, epOut_, data, len, kNumIsoPackets, CbStubOUT,
-                          this, kIsoTimeout);
-    dev_->SetIsoPacketLengths(xfrOut_, len);
+    dev_->FillIsoTransfer(t->xfr, epOut_, t->buf, len, kNumIsoPackets,
+                          CbStubOUT, t, kIsoTimeout);
+    dev_->SetIsoPacketLengths(t->xfr, len);
 
-    int rc = dev_->SubmitTransfer(xfrOut_);
+    t->submitted = time_us();
+    int rc = dev_->SubmitTransfer(t->xfr);
     if (rc < 0) {
       return dev_->ErrorUSB("ERROR: Submitting OUT transfer", rc);
     }
-    outActive_ = true;
+    t->active = true;
+    outFlight_++;
   }
   // Stream remains operational, even if it presently has no work on the OUT
   // side.
@@ -175,20 +220,25 @@ bool USBDevIso::Service() {
   if (failed_) {
     return false;
   }
-  // (Re)start Isochronous IN traffic if not already in progress.
-  if (!inActive_ && !ServiceIN()) {
+  // Keep the Isochronous IN transfers in flight.
+  if (CanSchedule() && !ServiceIN()) {
     return false;
   }
-  // (Re)start Isochronous OUT traffic if not already in progress and there is
-  // data available to be transmitted.
-  if (!outActive_ && !ServiceOUT()) {
+  // Keep the Isochronous OUT transfers in flight whilst there is data
+  // available to be transmitted.
+  if (CanSchedule() && !ServiceOUT()) {
     return false;
   }
   return true;
 }
 
 // Callback function supplied to libusb for IN transfers.
-void USBDevIso::CallbackIN(struct libusb_transfer *xfr) {
+void USBDevIso::CallbackIN(USBDevice::StreamTransfer *t) {
+  struct libusb_transfer *xfr = t->xfr;
+  t->active = false;
+  inFlight_--;
+  RecordLatency(elapsed_time(t->submitted));
+
   if (xfr->status != LIBUSB_TRANSFER_COMPLETED) {
     std::cerr << PrefixID() << " Invalid/unexpected IN transfer status "
               << xfr->status << std::endl;
@@ -207,7 +257,6 @@ void USBDevIso::CallbackIN(struct libusb_transfer *xfr) {
     if (pack->status != LIBUSB_TRANSFER_COMPLETED) {
       std::cerr << "ERROR: pack " << idx << " status " << pack->status
                 << std::endl;
-      inActive_ = false;
       return;
     }
 
@@ -229,6 +278,13 @@ void USBDevIso::CallbackIN(struct libusb_transfer *xfr) {
         // Valid packet received; payload includes the signature which we
         // retain and propagate to the caller to permit synchronization.
         uint32_t payload = pack->actual_length - dropped;
+        uint8_t *dp;
+        if (!ProvisionSpace(&dp, payload)) {
+          std::cerr << PrefixID() << " No space for Iso packet" << std::endl;
+          failed_ = true;
+          return;
+        }
+        memcpy(dp, &xfr->buffer[dropped], payload);
         pktLen_.push(payload);
 
         // Since packets may have been dropped we must use the supplied values
@@ -239,14 +295,12 @@ void USBDevIso::CallbackIN(struct libusb_transfer *xfr) {
             std::cerr << "ERROR: Unexpected device-side LFSR value (expected 0x"
                       << std::hex << tst_lfsr_ << " received 0x"
                       << sig.init_lfsr << ")" << std::dec << std::endl;
-            inActive_ = false;
             return;
           }
         } else if (seq < tst_seq_) {
           std::cerr << "ERROR: Iso stream packets out of order (expected seq 0x"
                     << std::hex << tst_seq_ << " received 0x" << seq << ")"
                     << std::dec << std::endl;
-          inActive_ = false;
           return;
         } else {
           // One or more packets has disappeared; use the supplied LFSR to
@@ -260,7 +314,6 @@ void USBDevIso::CallbackIN(struct libusb_transfer *xfr) {
         // Supply the host-side LFSR value so that the device may check the
         // content of received OUT packets.
         const size_t sig_size = sizeof(usbdev_stream_sig_t);
-        uint8_t *dp = &xfr->buffer[dropped];
         dp[offsetof(usbdev_stream_sig_t, init_lfsr)] = dpi_lfsr_;
         ProcessData(dp + sig_size, payload - sig_size);
 
@@ -273,15 +326,18 @@ void USBDevIso::CallbackIN(struct libusb_transfer *xfr) {
   }
 
   if (CanSchedule()) {
-    // Attempt to set up another IN transfer.
-    failed_ = !ServiceIN();
-  } else {
-    inActive_ = false;
+    // Attempt to set up more IN transfers, and send the packets onwards.
+    failed_ = !ServiceIN() || !ServiceOUT();
   }
 }
 
 // Callback function supplied to libusb for OUT transfers.
-void USBDevIso::CallbackOUT(struct libusb_transfer *xfr) {
+void USBDevIso::CallbackOUT(USBDevice::StreamTransfer *t) {
+  struct libusb_transfer *xfr = t->xfr;
+  t->active = false;
+  outFlight_--;
+  RecordLatency(elapsed_time(t->submitted));
+
   if (xfr->status != LIBUSB_TRANSFER_COMPLETED) {
     std::cerr << PrefixID() << " Invalid/unexpected OUT transfer status "
               << xfr->status << std::endl;
@@ -301,20 +357,17 @@ void USBDevIso::CallbackOUT(struct libusb_transfer *xfr) {
     if (pack->status != LIBUSB_TRANSFER_COMPLETED) {
       std::cout << "ERROR: pack " << idx << " status " << pack->status
                 << std::endl;
-      outActive_ = false;
       exit(0);
       return;
     }
 
-    if (pack->actual_length) {
-      ConsumeData(pack->actual_length);
-    }
+    // The packet was removed from the circular buffer when the transfer was
+    // submitted.
+    bytes_sent_ += pack->actual_length;
   }
 
   if (CanSchedule()) {
-    // Attempt to set up another OUT transfer.
+    // Attempt to set up more OUT transfers.
     failed_ = !ServiceOUT();
-  } else {
-    outActive_ = false;
   }
 }
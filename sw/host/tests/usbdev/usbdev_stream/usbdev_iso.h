@@ -4,21 +4,22 @@
 #ifndef OPENTITAN_SW_HOST_TESTS_USBDEV_USBDEV_STREAM_USBDEV_ISO_H_
 #define OPENTITAN_SW_HOST_TESTS_USBDEV_USBDEV_STREAM_USBDEV_ISO_H_
 #include <queue>
+#include <vector>
 
 #include "usb_device.h"
 #include "usbdev_stream.h"
 
 class USBDevIso : public USBDevStream {
  public:
-  USBDevIso(USBDevice *dev, unsigned id, uint32_t transfer_bytes, bool retrieve,
-            bool check, bool send, bool verbose)
+  USBDevIso(USBDevice *dev, unsigned id, uint32_t transfer_bytes,
+            unsigned depth, bool retrieve, bool check, bool send, bool verbose)
       : USBDevStream(id, transfer_bytes, retrieve, check, send, verbose),
         dev_(dev),
         failed_(false),
-        inActive_(false),
-        outActive_(false),
-        xfrIn_(nullptr),
-        xfrOut_(nullptr) {}
+        depth_(depth ? depth : 1U),
+        inFlight_(0U),
+        outFlight_(0U) {}
+  virtual ~USBDevIso();
   /**
    * Open an Isochronous connection to specified device interface.
    *
@@ -78,20 +79,37 @@ class USBDevIso : public USBDevStream {
    * @return true iff the stream is still operational.
    */
   bool ServiceOUT();
+  /**
+   * Allocate the transfer descriptors and buffers for one direction.
+   *
+   * @param  xfrs    Receives the transfers.
+   * @param  len     Length of the buffer for each transfer.
+   * @return true iff the allocation was successful.
+   */
+  bool AllocTransfers(std::vector<USBDevice::StreamTransfer> &xfrs,
+                      uint32_t len);
+  /**
+   * Return a transfer that is not presently in flight.
+   *
+   * @param  xfrs    Transfers for one direction.
+   * @return The transfer, or nullptr if all are in flight.
+   */
+  static USBDevice::StreamTransfer *IdleTransfer(
+      std::vector<USBDevice::StreamTransfer> &xfrs);
   /**
    * Callback function supplied to libusb for IN transfers; transfer has
    * completed and requires attention.
    *
-   * @param  xfr     The transfer that has completed.
+   * @param  t       The transfer that has completed.
    */
-  void CallbackIN(struct libusb_transfer *xfr);
+  void CallbackIN(USBDevice::StreamTransfer *t);
   /**
    * Callback function supplied to libusb for OUT transfers; transfer has
    * completed and requires attention.
    *
-   * @param  xfr     The transfer that has completed.
+   * @param  t       The transfer that has completed.
    */
-  void CallbackOUT(struct libusb_transfer *xfr);
+  void CallbackOUT(USBDevice::StreamTransfer *t);
   /**
    * Stub callback function supplied to libusb for IN transfers.
    *
@@ -114,20 +132,20 @@ class USBDevIso : public USBDevStream {
   // Has this stream experienced a failure?
   bool failed_;
 
-  // Is an IN transfer in progress?
-  bool inActive_;
-
-  // Is an OUT transfer in progress?
-  bool outActive_;
+  // Number of transfers to keep in flight in each direction.
+  unsigned depth_;
 
-  // Do we currently have an IN transfer?
-  struct libusb_transfer *xfrIn_;
+  // Number of IN and OUT transfers in flight.
+  unsigned inFlight_;
+  unsigned outFlight_;
 
-  // Do we currently have an OUT transfer?
-  struct libusb_transfer *xfrOut_;
+  // IN and OUT transfers; libusb completes the transfers on each endpoint in
+  // the order in which they were submitted.
+  std::vector<USBDevice::StreamTransfer> xfrsIn_;
+  std::vector<USBDevice::StreamTransfer> xfrsOut_;
 
   // Maximum packet size for this stream.
-  uint8_t maxPacketSize_;
+  unsigned maxPacketSize_;
 
   // Endpoint numbers used by this stream.
   uint8_t epIn_;
@@ -4,6 +4,7 @@
 #include "usbdev_stream.h"
 
 #include <cassert>
+#include <cinttypes>
 #include <cstdio>
 #include <cstring>
 #include <iostream>
@@ -53,6 +54,12 @@ USBDevStream::USBDevStream(unsigned id, uint32_t transfer_bytes, bool retrieve,
   // Total counts of bytes received and sent.
   bytes_recvd_ = 0U;
   bytes_sent_ = 0U;
+
+  // No transfers completed.
+  xfr_count_ = 0U;
+  latency_total_ = 0U;
+  latency_max_ = 0U;
+  memset(latency_hist_, 0, sizeof(latency_hist_));
 }
 
 // Detect a stream signature within the byte stream;
@@ -389,3 +396,53 @@ bool USBDevStream::Service() {
   }
   return true;
 }
+
+void USBDevStream::RecordLatency(uint64_t latency) {
+  unsigned bucket = 0U;
+  while (bucket < kLatencyBuckets - 1U && (latency >> (bucket + 1U))) {
+    bucket++;
+  }
+  latency_hist_[bucket]++;
+  latency_total_ += latency;
+  if (latency > latency_max_) {
+    latency_max_ = latency;
+  }
+  xfr_count_++;
+}
+
+std::string USBDevStream::PerfReport(uint64_t elapsed) const {
+  char line[80];
+  std::string s("S");
+  s += std::to_string(id_);
+
+  // Throughput in each direction.
+  double secs = elapsed / 1e6;
+  if (secs <= 0.0) {
+    secs = 1.0;
+  }
+  snprintf(line, sizeof(line), ": IN %.1lf KiB/s OUT %.1lf KiB/s\n",
+           bytes_recvd_ / secs / 1024.0, bytes_sent_ / secs / 1024.0);
+  s += line;
+
+  if (xfr_count_) {
+    snprintf(line, sizeof(line),
+             "  %u transfers, latency mean %" PRIu64 "us max %" PRIu64
+             "us\n",
+             xfr_count_, latency_total_ / xfr_count_, latency_max_);
+    s += line;
+    // Report only the occupied buckets of the histogram.
+    for (unsigned bucket = 0U; bucket < kLatencyBuckets; bucket++) {
+      if (latency_hist_[bucket]) {
+        if (bucket < kLatencyBuckets - 1U) {
+          snprintf(line, sizeof(line), "    <%uus: %u\n", 2U << bucket,
+                   latency_hist_[bucket]);
+        } else {
+          snprintf(line, sizeof(line), "    >=%uus: %u\n", 1U << bucket,
+                   latency_hist_[bucket]);
+        }
+        s += line;
+      }
+    }
+  }
+  return s;
+}
@@ -153,6 +153,20 @@ class USBDevStream {
    * @return         Number of bytes sent.
    */
   uint32_t BytesSent() const { return bytes_sent_; }
+  /**
+   * Record the completion of a transfer, for performance reporting.
+   *
+   * @param  latency   Time from submission to completion, in microseconds.
+   */
+  void RecordLatency(uint64_t latency);
+  /**
+   * Return a report of the throughput achieved by this stream and, if any
+   * transfers were recorded, the distribution of their latencies.
+   *
+   * @param  elapsed   Duration of the test, in microseconds.
+   * @return Performance report.
+   */
+  std::string PerfReport(uint64_t elapsed) const;
   /**
    * Return the textual name of the given stream type.
    *
@@ -309,6 +323,12 @@ class USBDevStream {
    * Size of circular buffer used for streaming.
    */
   static constexpr uint32_t kBufferSize = 0x10000U;
+  /**
+   * Number of buckets in the latency histogram; bucket n counts latencies of
+   * [2^n, 2^(n+1)) microseconds, with the final bucket counting all longer
+   * latencies.
+   */
+  static constexpr unsigned kLatencyBuckets = 20U;
 
   // Utility function for collecting a byte from the stream signature, handling
   // wrap around at the end of the circular buffer.
@@ -398,6 +418,17 @@ class USBDevStream {
    * Number of bytes to be transferred.
    */
   uint32_t transfer_bytes_;
+  /**
+   * Number of transfers completed, and their total and maximum latencies in
+   * microseconds.
+   */
+  uint32_t xfr_count_;
+  uint64_t latency_total_;
+  uint64_t latency_max_;
+  /**
+   * Histogram of transfer latencies.
+   */
+  uint32_t latency_hist_[kLatencyBuckets];
   /**
    * Circular buffer of streamed data.
    */
@@ -11,6 +11,8 @@
  *   2. MODE_ATTESTATION_KEYGEN: Derive a new attestation keypair (ECDSA-P256).
  *   3. MODE_ATTESTATION_ENDORSE: Sign with a saved attestation signing key.
  *   4. MODE_ATTESTATION_KEY_SAVE: Save an attestation signing key.
+ *   5. MODE_SIGVERIFY_TABLE: ECDSA-P256 signature verification with a
+ *      precomputed public key table.
  *
  * Ibex will run `MODE_SEC_BOOT_MODEXP` as part of checking the code
  * signature of the next boot stage. This mode doesn't interact or interfere
@@ -60,6 +62,7 @@
 .equ MODE_ATTESTATION_KEYGEN, 0x2bf
 .equ MODE_ATTESTATION_ENDORSE, 0x5e8
 .equ MODE_ATTESTATION_KEY_SAVE, 0x64d
+.equ MODE_SIGVERIFY_TABLE, 0x176
 
 .section .text.start
 start:
@@ -79,6 +82,9 @@ start:
   addi  x3, x0, MODE_ATTESTATION_KEY_SAVE
   beq   x2, x3, attestation_key_save
 
+  addi  x3, x0, MODE_SIGVERIFY_TABLE
+  beq   x2, x3, sigverify_table
+
   /* Invalid mode; fail. */
   unimp
   unimp
@@ -113,6 +119,31 @@ sigverify:
 
   ecall
 
+/**
+ * ECDSA-P256 signature verification with a precomputed public key table.
+ *
+ * Same as `sigverify`, but uses the comb table for the public key in
+ * `q_table` (see `p256_verify_table`). The result is returned the same way.
+ *
+ * @param[in]  dmem[msg]: message to be verified (256 bits)
+ * @param[in]  dmem[r]:   r component of signature (256 bits)
+ * @param[in]  dmem[s]:   s component of signature (256 bits)
+ * @param[in]  dmem[x]:   affine x-coordinate of public key (256 bits)
+ * @param[in]  dmem[y]:   affine y-coordinate of public key (256 bits)
+ * @param[in]  dmem[q_table]: comb table for the public key (7 affine points)
+ * @param[out] dmem[ok]:  success/failure of basic checks (32 bits)
+ * @param[out] dmem[x_r]: dmem buffer for reduced affine x_r-coordinate (x_1)
+ */
+sigverify_table:
+  /* Validate the public key (ends the program on failure). */
+  jal      x1, p256_check_public_key
+
+  /* Verify the signature (compute x_r). */
+  la       x5, q_table
+  jal      x1, p256_verify_table
+
+  ecall
+
 /**
  * Generate an attestation keypair from a sideloaded seed.
  *
@@ -322,6 +353,12 @@ y:
 x_r:
   .zero 32
 
+/* Comb table for the ECDSA-P256 public key (MODE_SIGVERIFY_TABLE). */
+.globl q_table
+.balign 32
+q_table:
+.zero 448
+
 /* DRBG output to XOR with key manager seed. */
 .globl attestation_additional_seed
 .balign 32
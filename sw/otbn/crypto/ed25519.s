@@ -155,3 +155,582 @@ ext_add:
   bn.mov   w13, w22
 
   ret
+
+/**
+ * Double a point in extended twisted Edwards coordinates.
+ *
+ * Returns (X3, Y3, Z3, T3) = 2 * (X1, Y1, Z1, T1)
+ *
+ * Overwrites the operand with the result. `ext_add` also gives the right
+ * result for doubling, but this dedicated formula from RFC 8032, section
+ * 5.1.4, needs 4 squarings and 4 multiplications instead of 10
+ * multiplications:
+ *
+ *   A = X1^2
+ *   B = Y1^2
+ *   C = 2*Z1^2
+ *   H = A+B
+ *   E = H-(X1+Y1)^2
+ *   G = A-B
+ *   F = C+G
+ *   X3 = E*F
+ *   Y3 = G*H
+ *   T3 = E*H
+ *   Z3 = F*G
+ *
+ * T1 is not used.
+ *
+ * This routine runs in constant time.
+ *
+ * Flags: Flags have no meaning beyond the scope of this subroutine.
+ *
+ * @param[in]  w19: constant, w19 = 19
+ * @param[in]  MOD: p, modulus = 2^255 - 19
+ * @param[in]  w31: all-zero
+ * @param[in,out] w10: input X1 (X1 < p), output X3
+ * @param[in,out] w11: input Y1 (Y1 < p), output Y3
+ * @param[in,out] w12: input Z1 (Z1 < p), output Z3
+ * @param[out]    w13: output T3
+ *
+ * clobbered registers: w10 to w13, w17, w18, w20 to w27
+ * clobbered flag groups: FG0
+ */
+.globl ext_double
+ext_double:
+  /* w24 <= X1^2 = A */
+  bn.mov   w22, w10
+  jal      x1, fe_square
+  bn.mov   w24, w22
+
+  /* w25 <= Y1^2 = B */
+  bn.mov   w22, w11
+  jal      x1, fe_square
+  bn.mov   w25, w22
+
+  /* w26 <= 2*Z1^2 = C */
+  bn.mov   w22, w12
+  jal      x1, fe_square
+  bn.addm  w26, w22, w22
+
+  /* w27 <= A + B = H */
+  bn.addm  w27, w24, w25
+
+  /* w13 <= H - (X1 + Y1)^2 = E */
+  bn.addm  w22, w10, w11
+  jal      x1, fe_square
+  bn.subm  w13, w27, w22
+
+  /* w24 <= A - B = G */
+  bn.subm  w24, w24, w25
+  /* w25 <= C + G = F */
+  bn.addm  w25, w26, w24
+
+  /* w10 <= E * F = X3 */
+  bn.mov   w22, w13
+  bn.mov   w23, w25
+  jal      x1, fe_mul
+  bn.mov   w10, w22
+
+  /* w11 <= G * H = Y3 */
+  bn.mov   w22, w24
+  bn.mov   w23, w27
+  jal      x1, fe_mul
+  bn.mov   w11, w22
+
+  /* w12 <= F * G = Z3 */
+  bn.mov   w22, w25
+  bn.mov   w23, w24
+  jal      x1, fe_mul
+  bn.mov   w12, w22
+
+  /* w13 <= E * H = T3 */
+  bn.mov   w22, w13
+  bn.mov   w23, w27
+  jal      x1, fe_mul
+  bn.mov   w13, w22
+
+  ret
+
+/**
+ * Set up the constants used by the Ed25519 point arithmetic.
+ *
+ * This routine runs in constant time.
+ *
+ * @param[out] w19: constant, w19 = 19
+ * @param[out] w30: constant, w30 = (2*d) mod p, d = (-121665/121666) mod p
+ * @param[out] w31: all-zero
+ * @param[out] MOD: p, modulus = 2^255 - 19
+ *
+ * clobbered registers: x2, x3, w19, w30, w31, MOD
+ * clobbered flag groups: FG0
+ */
+.globl ed25519_init
+ed25519_init:
+  /* Prepare all-zero register. */
+  bn.xor   w31, w31, w31
+
+  /* w19 <= 19 */
+  bn.addi  w19, w31, 19
+
+  /* MOD <= 2^255 - 19 = p */
+  bn.not   w30, w31
+  bn.rshi  w30, w31, w30 >> 1
+  bn.subi  w30, w30, 18
+  bn.wsrw  MOD, w30
+
+  /* w30 <= dmem[ed25519_d2] = (2*d) mod p */
+  li       x2, 30
+  la       x3, ed25519_d2
+  bn.lid   x2, 0(x3)
+
+  ret
+
+/**
+ * Multiply the Ed25519 base point by a scalar.
+ *
+ * Returns P = [k]B, with B the base point from RFC 8032, section 5.1.
+ *
+ * Uses a double-and-add loop that always adds either B or the identity, so
+ * the sequence of operations and memory accesses does not depend on k.
+ *
+ * This routine runs in constant time.
+ *
+ * Flags: Flags have no meaning beyond the scope of this subroutine.
+ *
+ * @param[in]  w28: k, scalar (k < 2^255)
+ * @param[in]  w19: constant, w19 = 19
+ * @param[in]  MOD: p, modulus = 2^255 - 19
+ * @param[in]  w30: constant, w30 = (2*d) mod p, d = (-121665/121666) mod p
+ * @param[in]  w31: all-zero
+ * @param[out] w10: X coordinate of P
+ * @param[out] w11: Y coordinate of P
+ * @param[out] w12: Z coordinate of P
+ * @param[out] w13: T coordinate of P
+ *
+ * clobbered registers: x2, x20, w9 to w18, w20 to w28
+ * clobbered flag groups: FG0
+ */
+.globl ed25519_base_mult
+ed25519_base_mult:
+  /* [w13:w10] <= (0, 1, 1, 0), the identity. */
+  bn.addi  w9, w31, 1
+  bn.mov   w10, w31
+  bn.mov   w11, w9
+  bn.mov   w12, w9
+  bn.mov   w13, w31
+
+  /* x20 <= address of B */
+  la       x20, ed25519_b
+
+  /* Drop the (zero) top bit of the scalar.
+       w28 <= (k << 1) mod 2^256 */
+  bn.add   w28, w28, w28
+
+  /* Loop over the bits of k, from the most significant one.
+
+     Loop invariants at the start of iteration t:
+       [w13:w10] = [k >> (255 - t)]B
+       w28 = (k << (t + 1)) mod 2^256 */
+  loopi    255, 14
+    /* [w13:w10] <= 2 * [w13:w10] */
+    jal      x1, ext_double
+
+    /* FG0.C <= k[254 - t], w28 <= w28 << 1 */
+    bn.add   w28, w28, w28
+
+    /* [w17:w14] <= B */
+    li       x2, 14
+    bn.lid   x2, 0(x20)
+    li       x2, 15
+    bn.lid   x2, 32(x20)
+    li       x2, 17
+    bn.lid   x2, 64(x20)
+    bn.mov   w16, w9
+
+    /* [w17:w14] <= FG0.C ? B : (0, 1, 1, 0) */
+    bn.sel   w14, w14, w31, FG0.C
+    bn.sel   w15, w15, w9, FG0.C
+    bn.sel   w17, w17, w31, FG0.C
+
+    /* [w13:w10] <= [w13:w10] + [w17:w14] */
+    jal      x1, ext_add
+    nop
+
+  ret
+
+/**
+ * Compute [s]B + [k]Q for the Ed25519 base point B and a point Q.
+ *
+ * Uses Shamir's trick: a single double-and-add loop over the bits of both
+ * scalars, adding one of the precomputed points (identity, B, Q, B + Q) in
+ * each iteration.
+ *
+ * This routine is only meant for signature verification and is NOT constant
+ * time; the table lookups depend on the bits of s and k.
+ *
+ * Flags: Flags have no meaning beyond the scope of this subroutine.
+ *
+ * @param[in]  w28: s, first scalar (s < 2^253)
+ * @param[in]  w29: k, second scalar (k < 2^253)
+ * @param[in]  w19: constant, w19 = 19
+ * @param[in]  MOD: p, modulus = 2^255 - 19
+ * @param[in]  w30: constant, w30 = (2*d) mod p, d = (-121665/121666) mod p
+ * @param[in]  w31: all-zero
+ * @param[in,out] w10: input X coordinate of Q, output X of the result
+ * @param[in,out] w11: input Y coordinate of Q, output Y of the result
+ * @param[in,out] w12: input Z coordinate of Q, output Z of the result
+ * @param[in,out] w13: input T coordinate of Q, output T of the result
+ *
+ * clobbered registers: x2, x3, x20, w9 to w18, w20 to w29
+ * clobbered flag groups: FG0
+ */
+.globl ed25519_double_base_mult
+ed25519_double_base_mult:
+  /* x20 <= address of the table */
+  la       x20, ed25519_dsm_table
+
+  /* dmem[ed25519_dsm_table + 256] <= Q */
+  li       x2, 10
+  bn.sid   x2++, 256(x20)
+  bn.sid   x2++, 288(x20)
+  bn.sid   x2++, 320(x20)
+  bn.sid   x2, 352(x20)
+
+  /* [w17:w14] <= B */
+  la       x3, ed25519_b
+  li       x2, 14
+  bn.lid   x2, 0(x3)
+  li       x2, 15
+  bn.lid   x2, 32(x3)
+  li       x2, 17
+  bn.lid   x2, 64(x3)
+  bn.addi  w16, w31, 1
+
+  /* dmem[ed25519_dsm_table + 128] <= B */
+  li       x2, 14
+  bn.sid   x2++, 128(x20)
+  bn.sid   x2++, 160(x20)
+  bn.sid   x2++, 192(x20)
+  bn.sid   x2, 224(x20)
+
+  /* dmem[ed25519_dsm_table + 384] <= Q + B */
+  jal      x1, ext_add
+  li       x2, 10
+  bn.sid   x2++, 384(x20)
+  bn.sid   x2++, 416(x20)
+  bn.sid   x2++, 448(x20)
+  bn.sid   x2, 480(x20)
+
+  /* [w13:w10] <= (0, 1, 1, 0), the identity.
+     dmem[ed25519_dsm_table] <= (0, 1, 1, 0) */
+  bn.addi  w9, w31, 1
+  bn.mov   w10, w31
+  bn.mov   w11, w9
+  bn.mov   w12, w9
+  bn.mov   w13, w31
+  li       x2, 10
+  bn.sid   x2++, 0(x20)
+  bn.sid   x2++, 32(x20)
+  bn.sid   x2++, 64(x20)
+  bn.sid   x2, 96(x20)
+
+  /* Drop the (zero) top 3 bits of the scalars.
+       w28 <= (s << 3) mod 2^256
+       w29 <= (k << 3) mod 2^256 */
+  bn.rshi  w28, w28, w31 >> 253
+  bn.rshi  w29, w29, w31 >> 253
+
+  /* Loop over the bits of s and k, from the most significant one. */
+  loopi    253, 18
+    /* [w13:w10] <= 2 * [w13:w10] */
+    jal      x1, ext_double
+
+    /* x2 <= s[252 - t], w28 <= w28 << 1 */
+    bn.add   w28, w28, w28
+    csrrs    x2, FG0, x0
+    andi     x2, x2, 1
+
+    /* x3 <= k[252 - t], w29 <= w29 << 1 */
+    bn.add   w29, w29, w29
+    csrrs    x3, FG0, x0
+    andi     x3, x3, 1
+
+    /* x2 <= address of table entry s[252 - t] + 2 * k[252 - t] */
+    slli     x3, x3, 1
+    or       x2, x2, x3
+    slli     x2, x2, 7
+    add      x2, x2, x20
+
+    /* [w17:w14] <= table entry */
+    li       x3, 14
+    bn.lid   x3++, 0(x2)
+    bn.lid   x3++, 32(x2)
+    bn.lid   x3++, 64(x2)
+    bn.lid   x3, 96(x2)
+
+    /* [w13:w10] <= [w13:w10] + [w17:w14] */
+    jal      x1, ext_add
+    nop
+
+  ret
+
+/**
+ * Encode a point, as in RFC 8032, section 5.1.2.
+ *
+ * Returns the 256-bit encoding of P: the affine y-coordinate, with the least
+ * significant bit of the affine x-coordinate in bit 255.
+ *
+ * This routine runs in constant time.
+ *
+ * Flags: Flags have no meaning beyond the scope of this subroutine.
+ *
+ * @param[in]  w10: X coordinate of P
+ * @param[in]  w11: Y coordinate of P
+ * @param[in]  w12: Z coordinate of P (Z != 0)
+ * @param[in]  w19: constant, w19 = 19
+ * @param[in]  MOD: p, modulus = 2^255 - 19
+ * @param[in]  w31: all-zero
+ * @param[out] w22: enc(P)
+ *
+ * clobbered registers: w14 to w18, w20 to w25
+ * clobbered flag groups: FG0
+ */
+.globl ed25519_encode_point
+ed25519_encode_point:
+  /* w24 <= Z^-1 */
+  bn.mov   w16, w12
+  jal      x1, fe_inv
+  bn.mov   w24, w22
+
+  /* w25 <= X * Z^-1 = x */
+  bn.mov   w23, w10
+  jal      x1, fe_mul
+  bn.mov   w25, w22
+
+  /* w22 <= Y * Z^-1 = y */
+  bn.mov   w22, w24
+  bn.mov   w23, w11
+  jal      x1, fe_mul
+
+  /* w22 <= y | (x[0] << 255) */
+  bn.rshi  w25, w25, w31 >> 1
+  bn.or    w22, w22, w25
+
+  ret
+
+/**
+ * Decode a point, as in RFC 8032, section 5.1.3.
+ *
+ * Recovers the x-coordinate from the y-coordinate and the sign bit, and
+ * returns the point in extended coordinates with Z = 1. Rejects encodings of
+ * y that are not fully reduced, y-coordinates for which there is no x, and
+ * the encoding of x = 0 with the sign bit set.
+ *
+ * This routine is only meant for public values and is NOT constant time.
+ *
+ * Flags: Flags have no meaning beyond the scope of this subroutine.
+ *
+ * @param[in]  w29: enc(P), encoded point
+ * @param[in]  w19: constant, w19 = 19
+ * @param[in]  MOD: p, modulus = 2^255 - 19
+ * @param[in]  w31: all-zero
+ * @param[out] x2: 0 if the encoding is valid, 1 otherwise
+ * @param[out] w10: X coordinate of P
+ * @param[out] w11: Y coordinate of P
+ * @param[out] w12: Z coordinate of P
+ * @param[out] w13: T coordinate of P
+ *
+ * clobbered registers: x2, x3, w8, w10 to w18, w20 to w27
+ * clobbered flag groups: FG0
+ */
+.globl ed25519_decode_point
+ed25519_decode_point:
+  /* w8 <= enc(P) >> 255 = x_0 */
+  bn.rshi  w8, w31, w29 >> 255
+
+  /* w11 <= enc(P) mod 2^255 = y */
+  bn.rshi  w11, w29, w31 >> 255
+  bn.rshi  w11, w31, w11 >> 1
+
+  /* Fail if p <= y. */
+  bn.wsrr  w20, MOD
+  bn.cmp   w11, w20
+  csrrs    x2, FG0, x0
+  andi     x2, x2, 1
+  beq      x2, x0, _ed25519_decode_fail
+
+  /* w24 <= y^2 */
+  bn.mov   w22, w11
+  jal      x1, fe_square
+  bn.mov   w24, w22
+
+  /* w25 <= y^2 - 1 = u */
+  bn.addi  w23, w31, 1
+  bn.subm  w25, w24, w23
+
+  /* w26 <= d*y^2 + 1 = v */
+  li       x2, 23
+  la       x3, ed25519_d
+  bn.lid   x2, 0(x3)
+  bn.mov   w22, w24
+  jal      x1, fe_mul
+  bn.addi  w23, w31, 1
+  bn.addm  w26, w22, w23
+
+  /* w27 <= v^3 */
+  bn.mov   w22, w26
+  jal      x1, fe_square
+  bn.mov   w23, w26
+  jal      x1, fe_mul
+  bn.mov   w27, w22
+
+  /* w16 <= u * v^7 */
+  jal      x1, fe_square
+  bn.mov   w23, w26
+  jal      x1, fe_mul
+  bn.mov   w23, w25
+  jal      x1, fe_mul
+  bn.mov   w16, w22
+
+  /* w10 <= u * v^3 * (u * v^7)^((p-5)/8) = x, the candidate root */
+  jal      x1, fe_pow_2252m3
+  bn.mov   w23, w27
+  jal      x1, fe_mul
+  bn.mov   w23, w25
+  jal      x1, fe_mul
+  bn.mov   w10, w22
+
+  /* w22 <= v * x^2 */
+  jal      x1, fe_square
+  bn.mov   w23, w26
+  jal      x1, fe_mul
+
+  /* If v * x^2 = u, then x is a square root of u/v. */
+  bn.cmp   w22, w25
+  csrrs    x2, FG0, x0
+  andi     x2, x2, 8
+  bne      x2, x0, _ed25519_decode_root_ok
+
+  /* Otherwise, fail unless v * x^2 = -u. */
+  bn.addm  w22, w22, w25
+  bn.cmp   w22, w31
+  csrrs    x2, FG0, x0
+  andi     x2, x2, 8
+  beq      x2, x0, _ed25519_decode_fail
+
+  /* In that case, the square root is x * 2^((p-1)/4).
+       w10 <= x * sqrt(-1) */
+  li       x2, 23
+  la       x3, ed25519_sqrt_m1
+  bn.lid   x2, 0(x3)
+  bn.mov   w22, w10
+  jal      x1, fe_mul
+  bn.mov   w10, w22
+
+  _ed25519_decode_root_ok:
+  /* Fail if x = 0 and x_0 = 1. */
+  bn.cmp   w10, w31
+  csrrs    x2, FG0, x0
+  andi     x2, x2, 8
+  beq      x2, x0, _ed25519_decode_sign
+  bn.cmp   w8, w31
+  csrrs    x2, FG0, x0
+  andi     x2, x2, 8
+  beq      x2, x0, _ed25519_decode_fail
+
+  _ed25519_decode_sign:
+  /* If x[0] != x_0, then x <= p - x. The L flag is the LSB of the result. */
+  bn.xor   w20, w10, w8
+  csrrs    x2, FG0, x0
+  andi     x2, x2, 4
+  beq      x2, x0, _ed25519_decode_ext
+  bn.subm  w10, w31, w10
+
+  _ed25519_decode_ext:
+  /* Z <= 1, T <= x * y */
+  bn.addi  w12, w31, 1
+  bn.mov   w22, w10
+  bn.mov   w23, w11
+  jal      x1, fe_mul
+  bn.mov   w13, w22
+
+  li       x2, 0
+  ret
+
+  _ed25519_decode_fail:
+  li       x2, 1
+  ret
+
+.data
+
+/* Curve parameter d = (-121665/121666) mod p (see RFC 8032, section 5.1). */
+.balign 32
+ed25519_d:
+  .word 0x135978a3
+  .word 0x75eb4dca
+  .word 0x4141d8ab
+  .word 0x00700a4d
+  .word 0x7779e898
+  .word 0x8cc74079
+  .word 0x2b6ffe73
+  .word 0x52036cee
+
+/* Constant (2*d) mod p. */
+.balign 32
+ed25519_d2:
+  .word 0x26b2f159
+  .word 0xebd69b94
+  .word 0x8283b156
+  .word 0x00e0149a
+  .word 0xeef3d130
+  .word 0x198e80f2
+  .word 0x56dffce7
+  .word 0x2406d9dc
+
+/* Square root of -1 modulo p, 2^((p-1)/4) mod p. */
+.balign 32
+ed25519_sqrt_m1:
+  .word 0x4a0ea0b0
+  .word 0xc4ee1b27
+  .word 0xad2fe478
+  .word 0x2f431806
+  .word 0x3dfbd7a7
+  .word 0x2b4d0099
+  .word 0x4fc1df0b
+  .word 0x2b832480
+
+/* Base point B (see RFC 8032, section 5.1): affine x, y and x*y. */
+.balign 32
+ed25519_b:
+  .word 0x8f25d51a
+  .word 0xc9562d60
+  .word 0x9525a7b2
+  .word 0x692cc760
+  .word 0xfdd6dc5c
+  .word 0xc0a4e231
+  .word 0xcd6e53fe
+  .word 0x216936d3
+  .word 0x66666658
+  .word 0x66666666
+  .word 0x66666666
+  .word 0x66666666
+  .word 0x66666666
+  .word 0x66666666
+  .word 0x66666666
+  .word 0x66666666
+  .word 0xa5b7dda3
+  .word 0x6dde8ab3
+  .word 0x775152f5
+  .word 0x20f09f80
+  .word 0x64abe37d
+  .word 0x66ea4e8e
+  .word 0xd78b7665
+  .word 0x67875f0f
+
+.section .scratchpad
+
+/* Precomputed points (identity, B, Q, B + Q) for `ed25519_double_base_mult`,
+   in extended coordinates. */
+.balign 32
+ed25519_dsm_table:
+  .zero 512
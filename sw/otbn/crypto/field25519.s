@@ -220,7 +220,80 @@ fe_square:
  * squares and multiplies is modified from curve25519-donna
  * (https://github.com/agl/curve25519-donna/blob/f7837adf95a2c2dcc36233cb02a1fb34081c0c4a/curve25519-donna-c64.c#L403),
  * which is in turn a modified version of the (qhasm) reference implementation
- * published with the original paper.
+ * published with the original paper. The chain up to a^(2^250-1) is shared
+ * with `fe_pow_2252m3` and lives in `fe_pow_2250m1`.
+ *
+ * This routine runs in constant time.
+ *
+ * Flags: Flags have no meaning beyond the scope of this subroutine.
+ *
+ * @param[in]  w19: constant, w19 = 19
+ * @param[in]  w16: a, first operand, a < p
+ * @param[in]  MOD: p, modulus = 2^255 - 19
+ * @param[in]  w31: all-zero
+ * @param[out] w22: c, result
+ *
+ * clobbered registers: w14, w15, w17, w18, w20 to w23
+ * clobbered flag groups: FG0
+ */
+.globl fe_inv
+fe_inv:
+  /* w22 <= a^(2^250-1), w14 <= a^11 */
+  jal     x1, fe_pow_2250m1
+
+  /* w22 <= w22^(2^5) = a^(2^255-2^5) */
+  loopi   5,2
+    jal     x1, fe_square
+    nop
+
+  /* w22 <= w22 * w14 = a^(2^255 - 2^5 + 11) = a^(2^255 - 21) = a^(p-2) */
+  bn.mov  w23, w14
+  jal     x1, fe_mul
+
+  ret
+
+/**
+ * Raise an element of the finite field modulo (2^255-19) to (p-5)/8.
+ *
+ * Returns c = (a^(2^252-3)) mod p.
+ *
+ * This is the exponentiation needed to take square roots when decoding
+ * Ed25519 points (RFC 8032, section 5.1.3). It uses the same addition chain
+ * as `fe_inv` up to a^(2^250-1).
+ *
+ * This routine runs in constant time.
+ *
+ * Flags: Flags have no meaning beyond the scope of this subroutine.
+ *
+ * @param[in]  w19: constant, w19 = 19
+ * @param[in]  w16: a, first operand, a < p
+ * @param[in]  MOD: p, modulus = 2^255 - 19
+ * @param[in]  w31: all-zero
+ * @param[out] w22: c, result
+ *
+ * clobbered registers: w14, w15, w17, w18, w20 to w23
+ * clobbered flag groups: FG0
+ */
+.globl fe_pow_2252m3
+fe_pow_2252m3:
+  /* w22 <= a^(2^250-1) */
+  jal     x1, fe_pow_2250m1
+
+  /* w22 <= w22^4 = a^(2^252-4) */
+  jal     x1, fe_square
+  jal     x1, fe_square
+
+  /* w22 <= w22 * w16 = a^(2^252-3) */
+  bn.mov  w23, w16
+  jal     x1, fe_mul
+
+  ret
+
+/**
+ * Compute a^(2^250-1) in the finite field modulo (2^255-19).
+ *
+ * Shared first part of the addition chains of `fe_inv` and `fe_pow_2252m3`.
+ * Also returns a^11, which `fe_inv` needs for its last step.
  *
  * The main difference between this implementation and donna is that we attempt
  * to minimize bn.mov instructions by making sure multiplies/squares always use
@@ -234,13 +307,13 @@ fe_square:
  * @param[in]  w16: a, first operand, a < p
  * @param[in]  MOD: p, modulus = 2^255 - 19
  * @param[in]  w31: all-zero
- * @param[out] w22: c, result
+ * @param[out] w22: a^(2^250-1)
+ * @param[out] w14: a^11
  *
  * clobbered registers: w14, w15, w17, w18, w20 to w23
  * clobbered flag groups: FG0
  */
-.globl fe_inv
-fe_inv:
+fe_pow_2250m1:
   /* w22 <= w16^2 = a^2 */
   bn.mov  w22, w16
   jal     x1, fe_square
@@ -342,13 +415,4 @@ fe_inv:
   bn.mov  w23, w15
   jal     x1, fe_mul
 
-  /* w22 <= w22^(2^5) = a^(2^255-2^5) */
-  loopi   5,2
-    jal     x1, fe_square
-    nop
-
-  /* w22 <= w22 * w14 = a^(2^255 - 2^5 + 11) = a^(2^255 - 21) = a^(p-2) */
-  bn.mov  w23, w14
-  jal     x1, fe_mul
-
   ret
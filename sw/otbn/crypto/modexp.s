@@ -11,6 +11,7 @@
 .text
 .globl modexp_65537
 .globl modexp
+.globl modexp_var
 
 /**
  * Conditionally overwrite bigint in dmem
@@ -312,6 +313,143 @@ modexp_65537:
 
   ret
 
+/**
+ * Bigint modular exponentiation with a small public exponent
+ *
+ * Returns: C = modexp(A,E) = A^E mod M
+ *
+ * This implements left-to-right square and multiply for a 32-bit exponent E,
+ * skipping the leading zero bits and running the multiplication step only for
+ * bits set in the exponent. It is NOT constant-time with respect to E and
+ * must only be used with public exponents, e.g. for RSA signature
+ * verification or encryption with exponents other than 65537.
+ *
+ * The squared Montgomery modulus RR and the Montgomery constant m0' have to
+ * be precomputed and provided at the appropriate locations in dmem.
+ *
+ * Flags: The states of both FG0 and FG1 depend on intermediate values and are
+ *        not usable after return.
+ *
+ * The base bignum A is expected in the input buffer, the result C is written
+ * to the output buffer. Note, that the content of the input buffer is
+ * modified during execution.
+ *
+ * @param[in]   x2: dptr_c, dmem pointer to buffer for output C
+ * @param[in]  x14: dptr_a, dmem pointer to first linb of input A
+ * @param[in]  x15: E, exponent (non-zero)
+ * @param[in]  x16: dptr_M, dmem pointer to first limb of modulus M
+ * @param[in]  x17: dptr_m0d, dmem pointer to Mongtgomery constant m0'
+ * @param[in]  x18: dptr_RR, dmem pointer to Montgmery constant RR
+ * @param[in]  x30: N, number of limbs per bignum
+ * @param[in]  w31: all-zero
+ * @param[out] dmem[dptr_c:dptr_c+N*32] C, A^E mod M
+ *
+ * clobbered registers: x3 to x13, x15 to x31
+ *                      w0 to w3, w24 to w30
+ *                      w4 to w[4+N-1]
+ * clobbered Flag Groups: FG0, FG1
+ */
+modexp_var:
+  /* An exponent of zero is not supported; fail. */
+  bne       x15, x0, _modexp_var_e_ok
+  unimp
+  unimp
+  unimp
+
+  _modexp_var_e_ok:
+  /* prepare pointers to temp regs */
+  li         x8, 4
+  li         x9, 3
+  li        x10, 4
+  li        x11, 2
+
+  /* Compute (N-1).
+       x31 <= x30 - 1 = N - 1 */
+  addi      x31, x30, -1
+
+  /* convert to montgomery domain montmul(A,RR)
+  in = montmul(A,RR) montmul(A,RR) = C*R mod M */
+  addi      x19, x14, 0
+  addi      x20, x18, 0
+  addi      x21, x14, 0
+  jal       x1, montmul
+  /* Store result in dmem starting at dmem[dptr_a] */
+  loop      x30, 2
+    bn.sid    x8, 0(x21++)
+    addi      x8, x8, 1
+
+  /* pointer to out buffer */
+  addi      x21, x2, 0
+
+  /* zeroize w2 and reset flags */
+  bn.sub    w2, w2, w2
+
+  /* pointer to modulus */
+  addi      x3, x16, 0
+
+  /* this loop initializes the output buffer with -M, which is R mod M (one in
+     the Montgomery domain) */
+  loop      x30, 3
+    /* load limb from modulus */
+    bn.lid    x11, 0(x3++)
+
+    /* subtract limb from 0 */
+    bn.subb   w2, w31, w2
+
+    /* store limb in dmem */
+    bn.sid    x11, 0(x21++)
+
+  /* Shift the exponent left until its top bit is set.
+       x23 <= number of bits from the most significant set bit of E down */
+  li        x23, 32
+  _modexp_var_skip:
+  srli      x24, x15, 31
+  bne       x24, x0, _modexp_var_loop
+  slli      x15, x15, 1
+  addi      x23, x23, -1
+  jal       x0, _modexp_var_skip
+
+  /* Square and multiply, from the top bit of E down. */
+  _modexp_var_loop:
+    /* square: out = montmul(out, out) */
+    addi      x19, x2, 0
+    addi      x20, x2, 0
+    jal       x1, montmul
+    /* Store result in dmem starting at dmem[dptr_c] */
+    addi      x21, x2, 0
+    li        x8, 4
+    loop      x30, 2
+      bn.sid    x8, 0(x21++)
+      addi      x8, x8, 1
+
+    /* Skip the multiplication if the current bit of E is clear. */
+    srli      x24, x15, 31
+    beq       x24, x0, _modexp_var_next
+
+    /* multiply: out = montmul(in, out) */
+    addi      x19, x14, 0
+    addi      x20, x2, 0
+    jal       x1, montmul
+    /* Store result in dmem starting at dmem[dptr_c] */
+    addi      x21, x2, 0
+    li        x8, 4
+    loop      x30, 2
+      bn.sid    x8, 0(x21++)
+      addi      x8, x8, 1
+
+    _modexp_var_next:
+    slli      x15, x15, 1
+    addi      x23, x23, -1
+    bne       x23, x0, _modexp_var_loop
+
+  /* convert back from montgomery domain */
+  /* out = montmul(out,1) = out/R mod M  */
+  addi      x19, x2, 0
+  addi      x21, x2, 0
+  jal       x1, montmul_mul1
+
+  ret
+
 /**
  * Constant time conditional bigint subtraction
  *
@@ -21,7 +21,9 @@
 .globl mod_mul_256x256
 .globl mod_mul_320x128
 .globl scalar_mult_int
+.globl scalar_mult_base_int
 .globl proj_add
+.globl proj_double
 .globl proj_to_affine
 
 /* Exposed only for testing or SCA purposes. */
@@ -1281,6 +1283,248 @@ scalar_mult_int:
   bn.cmp    w10, w31
   jal       x0, trigger_fault_if_fg0_z
 
+/**
+ * Constant-time lookup of a P-256 fixed-base comb table entry.
+ *
+ * returns P = T[i] with random projective coordinates
+ *
+ * The table holds T[i] = i_0*G + i_1*2^107*G + i_2*2^214*G for 0 < i < 8,
+ * where i = i_0 + 2*i_1 + 4*i_2; T[0] is the point at infinity and is not
+ * stored. Every entry is read regardless of the index, and the selected
+ * point is scaled with a fresh random z-coordinate so that the coordinates
+ * passed on to the point addition are masked.
+ *
+ * @param[in]  w20: i, 3-bit table index (secret)
+ * @param[in]  w31: all-zero
+ * @param[in]  MOD: p, modulus of P-256 underlying finite field
+ * @param[in]  w28: r256, constant, 2^256 mod p = 2^256 - p
+ * @param[in]  w29: r448, constant, 2^448 mod p
+ * @param[out]  w8: x, projective x-coordinate of T[i]
+ * @param[out]  w9: y, projective y-coordinate of T[i]
+ * @param[out]  w10: z, random projective z-coordinate of T[i]
+ *
+ * Flags: Flags have no meaning beyond the scope of this subroutine.
+ *
+ * clobbered registers: x2, x3, x10, w8 to w10, w14 to w25
+ * clobbered flag groups: FG0
+ */
+p256_comb_lookup:
+  /* Start with the affine part of the point at infinity (0, 1). The
+     z-coordinate is selected separately at the end.
+     w14 <= 0, w15 <= 1 */
+  bn.mov    w14, w31
+  bn.addi   w15, w31, 1
+
+  /* w21 <= j = 0, running table index */
+  bn.mov    w21, w31
+
+  /* Scan the whole table, selecting the entry whose index matches. */
+  li        x2, 22
+  li        x10, 23
+  la        x3, p256_comb_table
+  loopi     7, 12
+    /* w21 <= j = j + 1 */
+    bn.addi   w21, w21, 1
+
+    /* w22, w23 <= T[j] = dmem[p256_comb_table + 64*(j-1)] */
+    bn.lid    x2, 0(x3++)
+    bn.lid    x10, 0(x3++)
+
+    /* FG0.Z <= (i == j) */
+    bn.cmp    w20, w21
+
+    /* N.B. The Z flag is secret here. As in scalar_mult_int, the
+       destinations of the selects must differ from both sources and are
+       overwritten with random values first, so the hamming distance to the
+       previous register value does not reveal whether the entry matched.
+
+       (w16, w17) <= (i == j) ? T[j] : (w14, w15) */
+    bn.wsrr   w16, URND
+    bn.wsrr   w17, URND
+    bn.sel    w16, w22, w14, FG0.Z
+    bn.sel    w17, w23, w15, FG0.Z
+    bn.wsrr   w14, URND
+    bn.wsrr   w15, URND
+    bn.mov    w14, w16
+    bn.mov    w15, w17
+
+  /* Select the z-coordinate: 0 for the point at infinity, 1 otherwise.
+     w16 <= (i == 0) ? 0 : 1 */
+  bn.addi   w17, w31, 1
+  bn.wsrr   w16, URND
+  bn.cmp    w20, w31
+  bn.sel    w16, w31, w17, FG0.Z
+
+  /* get random number from URND and reduce it
+     w17 <= URND mod p */
+  bn.wsrr   w17, URND
+  bn.addm   w17, w17, w31
+
+  /* w8 <= x = w14 * w17 */
+  bn.mov    w24, w14
+  bn.mov    w25, w17
+  jal       x1, mul_modp
+  bn.mov    w8, w19
+
+  /* w9 <= y = w15 * w17 */
+  bn.mov    w24, w15
+  bn.mov    w25, w17
+  jal       x1, mul_modp
+  bn.mov    w9, w19
+
+  /* w10 <= z = w16 * w17 */
+  bn.mov    w24, w16
+  bn.mov    w25, w17
+  jal       x1, mul_modp
+  bn.mov    w10, w19
+
+  ret
+
+
+/**
+ * P-256 scalar multiplication with the base point in projective space
+ *
+ * returns R = k*G
+ *         with R being a P-256 curve point in projective coordinates,
+ *              G being the base point of P-256,
+ *              k being a 320-bit scalar in two shares
+ *
+ * This routine computes the same result as scalar_mult_int with the base
+ * point, but uses the precomputed fixed-base comb table at p256_comb_table
+ * (3 teeth, spacing 107) instead of a generic double-and-add loop. Each
+ * share is split into three 107-bit chunks k_0, k_1, k_2 such that
+ *   k = k_0 + 2^107*k_1 + 2^214*k_2
+ * and the loop computes (k0 + k1) * G as follows:
+ *  Q = (0, 1, 0) # origin
+ *  for i in 106..0:
+ *    Q = 2 * Q
+ *    Q = Q + T[k0_0[i] + 2*k0_1[i] + 4*k0_2[i]]
+ *    Q = Q + T[k1_0[i] + 2*k1_1[i] + 4*k1_2[i]]
+ *
+ * This needs 107 doublings and 214 additions instead of the 320 doublings
+ * and 320 additions of scalar_mult_int. The shares are never combined, every
+ * table lookup scans the full table, and every selected entry is re-randomized
+ * before it is added. Since the point addition formulas are complete, no
+ * special handling is needed for the point at infinity (T[0]) or for adding a
+ * point to itself.
+ *
+ * Each share k0/k1 is 320 bits, even though it represents a 256-bit value.
+ * This is a side-channel protection measure.
+ *
+ * @param[in]  w0: lower 256 bits of k0, first share of scalar
+ * @param[in]  w1: upper 64 bits of k0, first share of scalar
+ * @param[in]  w2: lower 256 bits of k1, second share of scalar
+ * @param[in]  w3: upper 64 bits of k1, second share of scalar
+ * @param[in]  w31: all-zero
+ * @param[out]  w8: x, x-coordinate of curve point (projective)
+ * @param[out]  w9: y, y-coordinate of curve point (projective)
+ * @param[out]  w10: z, z-coordinate of curve point (projective)
+ *
+ * Flags: Flags have no meaning beyond the scope of this subroutine.
+ *
+ * clobbered registers: x2, x3, x10, w0 to w30
+ * clobbered flag groups: FG0
+ */
+scalar_mult_base_int:
+  /* Set up for coordinate arithmetic.
+       MOD <= p
+       w28 <= r256
+       w29 <= r448 */
+  jal       x1, setup_modp
+
+  /* load domain parameter b from dmem
+     w27 <= b = dmem[p256_b] */
+  li        x2, 27
+  la        x3, p256_b
+  bn.lid    x2, 0(x3)
+
+  /* Split the shares into 107-bit chunks, with the MSB of each chunk in the
+     most significant position of a word.
+       w0, w1, w4 <= k0[106:0] << 149, k0[213:107] << 149, k0[319:214] << 149
+       w2, w3, w5 <= k1[106:0] << 149, k1[213:107] << 149, k1[319:214] << 149 */
+  bn.rshi   w20, w1, w0 >> 107
+  bn.rshi   w21, w1, w0 >> 214
+  bn.rshi   w0, w0, w31 >> 107
+  bn.rshi   w1, w20, w31 >> 107
+  bn.rshi   w4, w21, w31 >> 107
+  bn.rshi   w20, w3, w2 >> 107
+  bn.rshi   w21, w3, w2 >> 214
+  bn.rshi   w2, w2, w31 >> 107
+  bn.rshi   w3, w20, w31 >> 107
+  bn.rshi   w5, w21, w31 >> 107
+
+  /* init comb loop with point in infinity
+     Q = (w8, w9, w10) <= (0, 1, 0) */
+  bn.mov    w8, w31
+  bn.addi   w9, w31, 1
+  bn.mov    w10, w31
+
+  /* comb loop with decreasing index */
+  loopi     107, 32
+
+    /* double point Q
+       Q = (w11, w12, w13) <= 2*(w8, w9, w10) = 2*Q */
+    jal       x1, proj_double
+
+    /* save Q to survive the table lookup
+       (w6, w7, w26) <= Q = (w11, w12, w13) */
+    bn.mov    w6, w11
+    bn.mov    w7, w12
+    bn.mov    w26, w13
+
+    /* Assemble the table index for the first share from the MSbs of its
+       chunks and shift the chunks left by one bit.
+       w20 <= k0_0[i] + 2*k0_1[i] + 4*k0_2[i] */
+    bn.rshi   w20, w31, w4 >> 255
+    bn.rshi   w20, w20, w1 >> 255
+    bn.rshi   w20, w20, w0 >> 255
+    bn.rshi   w0, w0, w31 >> 255
+    bn.rshi   w1, w1, w31 >> 255
+    bn.rshi   w4, w4, w31 >> 255
+
+    /* P = (w8, w9, w10) <= T[w20] */
+    jal       x1, p256_comb_lookup
+
+    /* Q = (w11, w12, w13) <= Q + P */
+    bn.mov    w11, w6
+    bn.mov    w12, w7
+    bn.mov    w13, w26
+    jal       x1, proj_add
+
+    /* (w6, w7, w26) <= Q = (w11, w12, w13) */
+    bn.mov    w6, w11
+    bn.mov    w7, w12
+    bn.mov    w26, w13
+
+    /* Same for the second share.
+       w20 <= k1_0[i] + 2*k1_1[i] + 4*k1_2[i] */
+    bn.rshi   w20, w31, w5 >> 255
+    bn.rshi   w20, w20, w3 >> 255
+    bn.rshi   w20, w20, w2 >> 255
+    bn.rshi   w2, w2, w31 >> 255
+    bn.rshi   w3, w3, w31 >> 255
+    bn.rshi   w5, w5, w31 >> 255
+
+    /* P = (w8, w9, w10) <= T[w20] */
+    jal       x1, p256_comb_lookup
+
+    /* Q = (w8, w9, w10) <= Q + P */
+    bn.mov    w11, w6
+    bn.mov    w12, w7
+    bn.mov    w13, w26
+    jal       x1, proj_add
+    bn.mov    w8, w11
+    bn.mov    w9, w12
+    bn.mov    w10, w13
+
+  /* Check if the z-coordinate of Q is 0. If so, fail; this represents the
+     point at infinity and means the scalar was zero mod n, which likely
+     indicates a fault attack. Tail-call.
+
+     FG0.Z <= if (w10 == 0) then 1 else 0 */
+  bn.cmp    w10, w31
+  jal       x0, trigger_fault_if_fg0_z
+
 /**
  * P-256 scalar multiplication with base point G
  *
@@ -1290,7 +1534,7 @@ scalar_mult_int:
  *              d being a 256 bit scalar
  *
  * Performs a scalar multiplication of a scalar with the base point G of curve
- * P-256.
+ * P-256, using the fixed-base comb table (see scalar_mult_base_int).
  *
  * This routine assumes that the scalar d is provided in two shares, d0 and d1,
  * where:
@@ -1331,11 +1575,9 @@ p256_base_mult:
   li        x2, 3
   bn.lid    x2, 0(x16)
 
-  /* call internal scalar multiplication routine
-     R = (x_p, y_p, z_p) = (w8, w9, w10) <= d*P = (w0 + w1)*P */
-  la        x21, p256_gx
-  la        x22, p256_gy
-  jal       x1, scalar_mult_int
+  /* call internal fixed-base scalar multiplication routine
+     R = (x_p, y_p, z_p) = (w8, w9, w10) <= d*G = (w0 + w1)*G */
+  jal       x1, scalar_mult_base_int
 
   /* Convert masked result back to affine coordinates.
      R = (x_a, y_a) = (w11, w12) */
@@ -1891,6 +2133,132 @@ p256_gy:
   .word 0xfe1a7f9b
   .word 0x4fe342e2
 
+/* Fixed-base comb table for P-256 (3 teeth, spacing 107), see
+   scalar_mult_base_int. Entry i holds the affine x- and y-coordinates of
+   i_0*G + i_1*2^107*G + i_2*2^214*G for i = i_0 + 2*i_1 + 4*i_2, 0 < i < 8. */
+.globl p256_comb_table
+.balign 32
+p256_comb_table:
+  /* T[1] = G */
+  .word 0xd898c296
+  .word 0xf4a13945
+  .word 0x2deb33a0
+  .word 0x77037d81
+  .word 0x63a440f2
+  .word 0xf8bce6e5
+  .word 0xe12c4247
+  .word 0x6b17d1f2
+  .word 0x37bf51f5
+  .word 0xcbb64068
+  .word 0x6b315ece
+  .word 0x2bce3357
+  .word 0x7c0f9e16
+  .word 0x8ee7eb4a
+  .word 0xfe1a7f9b
+  .word 0x4fe342e2
+  /* T[2] = 2^107*G */
+  .word 0x9ad780b2
+  .word 0xf9c18a46
+  .word 0xf68440e7
+  .word 0x8c3b0da6
+  .word 0x8f9ae751
+  .word 0x0e19d0c2
+  .word 0x945c7db2
+  .word 0x44dc4d9e
+  .word 0xab93b11e
+  .word 0x91437413
+  .word 0xc2cec39d
+  .word 0xb47775e1
+  .word 0x683f5f95
+  .word 0xf8fd19dc
+  .word 0x45c2f9c9
+  .word 0xdbeb9187
+  /* T[3] = G + 2^107*G */
+  .word 0x3e370b20
+  .word 0xc93ba7a4
+  .word 0x378cb333
+  .word 0x429605b8
+  .word 0x7865c075
+  .word 0xf48cfded
+  .word 0xc7950788
+  .word 0x7b915817
+  .word 0x5de4dbe0
+  .word 0x152473ae
+  .word 0xf75b0d64
+  .word 0xeb6ea539
+  .word 0xe60f1c47
+  .word 0xdc6ca026
+  .word 0x93cfd2c5
+  .word 0x83692e9a
+  /* T[4] = 2^214*G */
+  .word 0xf529b1cc
+  .word 0xb1f11f16
+  .word 0x89b84639
+  .word 0x5156b3fd
+  .word 0x3a0a9bbd
+  .word 0x2cbc4a51
+  .word 0x5ead72de
+  .word 0x87c1d99c
+  .word 0xd5a94d6c
+  .word 0xcf26978d
+  .word 0xc5b275e3
+  .word 0xbb0d0eb2
+  .word 0xa55ef683
+  .word 0xb8617a6c
+  .word 0x985d0bcd
+  .word 0x7e1654c6
+  /* T[5] = G + 2^214*G */
+  .word 0x35766951
+  .word 0x652e9d08
+  .word 0xc5b69665
+  .word 0x2902dd4a
+  .word 0xa7d20376
+  .word 0xbddf5248
+  .word 0x1635811a
+  .word 0x3c02a366
+  .word 0x0c35906b
+  .word 0x71cf0110
+  .word 0x40ba2e70
+  .word 0x31e3b003
+  .word 0x5e934458
+  .word 0x54bf49ad
+  .word 0x256f3b51
+  .word 0xfac06910
+  /* T[6] = 2^107*G + 2^214*G */
+  .word 0x0c71436c
+  .word 0xf9c8011b
+  .word 0xb70f0fcf
+  .word 0x45385ce7
+  .word 0x562b3ca5
+  .word 0x2dc6efd6
+  .word 0x850cf1b0
+  .word 0xe8ab8fbe
+  .word 0xba0b9845
+  .word 0x89132717
+  .word 0x93a5f63d
+  .word 0xe5bcb440
+  .word 0x998e1000
+  .word 0x9699dccb
+  .word 0x3bce2168
+  .word 0xbe0f629e
+  /* T[7] = G + 2^107*G + 2^214*G */
+  .word 0x95c44a4c
+  .word 0x3af66ed2
+  .word 0xa3b2e843
+  .word 0xae7c35d7
+  .word 0x657d6e72
+  .word 0xbc6525f2
+  .word 0xd9ea8fda
+  .word 0xc2326750
+  .word 0xff76efba
+  .word 0xb815de09
+  .word 0xa5df0028
+  .word 0xa343c058
+  .word 0x3b74bf14
+  .word 0x53c03642
+  .word 0x06138e8d
+  .word 0xd5523c33
+
 .section .bss
 
 /* random scalar k (in two 320b shares) */
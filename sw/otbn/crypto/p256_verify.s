@@ -19,7 +19,14 @@
 .equ HARDENED_BOOL_TRUE_XOR_COUNTER, 0x639
 .equ HARDENED_BOOL_FALSE, 0x1d4
 
+/**
+ * Hardened true XORed with 107, the expected loop counter of the comb in
+ * p256_verify_table.
+ */
+.equ HARDENED_BOOL_TRUE_XOR_TABLE_COUNTER, 0x752
+
 .globl p256_verify
+.globl p256_verify_table
 
 .text
 
@@ -57,83 +64,9 @@
  */
 p256_verify:
 
-  /* init all-zero register */
-  bn.xor    w31, w31, w31
-
-  /* load domain parameter b from dmem
-     w27 <= b = dmem[p256_b] */
-  li        x2, 27
-  la        x3, p256_b
-  bn.lid    x2, 0(x3)
-
-  /* setup modulus n (curve order) and Barrett constant
-     MOD <= w29 <= n = dmem[p256_n]; w28 <= u_n = dmem[p256_u_n]  */
-  li        x2, 29
-  la        x3, p256_n
-  bn.lid    x2, 0(x3)
-  bn.wsrw   MOD, w29
-  li        x2, 28
-  la        x3, p256_u_n
-  bn.lid    x2, 0(x3)
-
-  /* load s of signature from dmem: w0 = s = dmem[s] */
-  la        x20, s
-  bn.lid    x0, 0(x20)
-
-  /* Fail if w0 == w31 <=> s == 0 */
-  bn.cmp    w0, w31
-  csrrs     x2, FG0, x0
-  andi      x2, x2, 8
-  bne       x2, x0, p256_invalid_input
-
-  /* Fail if w0 >= w29 <=> s >= n */
-  bn.cmp    w0, w29
-  csrrs     x2, FG0, x0
-  andi      x2, x2, 1
-  beq       x2, x0, p256_invalid_input
-
-  /* w1 = s^-1  mod n */
-  jal       x1, mod_inv_var
-
-  /* load r of signature from dmem: w24 = r = dmem[r] */
-  la        x19, r
-  li        x2,  24
-  bn.lid    x2, 0(x19)
-
-  /* Fail if w24 == w31 <=> r == 0 */
-  bn.cmp    w24, w31
-  csrrs     x2, FG0, x0
-  andi      x2, x2, 8
-  bne       x2, x0, p256_invalid_input
-
-  /* Fail if w0 >= w29 <=> r >= n */
-  bn.cmp    w24, w29
-  csrrs     x2, FG0, x0
-  andi      x2, x2, 1
-  beq       x2, x0, p256_invalid_input
-
-  /* w25 = s^-1 = w1 */
-  bn.mov    w25, w1
-
-  /* u2 = w0 = w19 <= w24*w25 = r*s^-1 mod n */
-  jal       x1, mod_mul_256x256
-  bn.mov    w0, w19
-
-  /* load message, w24 = msg = dmem[msg] */
-  la        x18, msg
-  li        x2, 24
-  bn.lid    x2, 0(x18)
-
-  /* u1 = w1 = w19 <= w24*w25 = w24*w1 = msg*s^-1 mod n */
-  bn.mov    w25, w1
-  jal       x1, mod_mul_256x256
-  bn.mov    w1, w19
-
-  /* Set up for coordinate arithmetic.
-       MOD <= p
-       w28 <= r256
-       w29 <= r448 */
-  jal       x1, setup_modp
+  /* Check the signature and compute the scalars.
+       w0 <= u2, w1 <= u1 */
+  jal       x1, p256_verify_scalars
 
   /* load public key Q from dmem and use in projective form (set z to 1)
      Q = (w11, w12, w13) = (dmem[x], dmem[y], 1) */
@@ -256,6 +189,313 @@ p256_verify:
     /* increment counter */
     add      x12, x12, x11
 
+  /* Convert the result to affine and store it. Tail-call.
+       x14 <= expected hardened counter value */
+  addi      x14, x0, HARDENED_BOOL_TRUE_XOR_COUNTER
+  jal       x0, p256_verify_finish
+
+
+/**
+ * P-256 ECDSA signature verification with a precomputed public key table
+ *
+ * Computes the same result as p256_verify, but uses precomputed comb tables
+ * for both points: p256_comb_table for the base point G and the table at x5
+ * for the public key Q, both with 3 teeth and spacing 107 (see
+ * scalar_mult_base_int). The scalars are split into 107-bit chunks
+ *   u = u_0 + 2^107*u_1 + 2^214*u_2
+ * and the loop computes
+ *  C = (0, 1, 0) # origin
+ *  for i in 106..0:
+ *    C = 2 * C
+ *    C = C + T_G[u1_0[i] + 2*u1_1[i] + 4*u1_2[i]]
+ *    C = C + T_Q[u2_0[i] + 2*u2_1[i] + 4*u2_2[i]]
+ *
+ * This needs 107 doublings and at most 214 additions instead of the 256
+ * doublings and up to 256 additions of p256_verify. Additions with the point
+ * at infinity (index 0) are skipped.
+ *
+ * The first entry of the table must be Q; the routine fails otherwise, so a
+ * table for a different key is rejected. The other entries are not checked:
+ * the table must come from storage that is as trustworthy as the key.
+ *
+ * This routine runs in variable time.
+ *
+ * @param[in]  dmem[msg]: message to be verified (256 bits)
+ * @param[in]  dmem[r]:   r component of signature (256 bits)
+ * @param[in]  dmem[s]:   s component of signature (256 bits)
+ * @param[in]  dmem[x]:   affine x-coordinate of public key (256 bits)
+ * @param[in]  dmem[y]:   affine y-coordinate of public key (256 bits)
+ * @param[in]  x5: dmem pointer to the comb table for the public key Q (7 affine
+ *                 points, 32-byte aligned)
+ * @param[out] dmem[ok]:  whether the signature passed basic checks (32 bits)
+ * @param[out] dmem[x_r]: dmem buffer for reduced affine x_r-coordinate (x_1)
+ *
+ * Flags: Flags have no meaning beyond the scope of this subroutine.
+ *
+ * clobbered registers: x2 to x5, x12 to x14, x17 to x20, w0 to w25
+ * clobbered flag groups: FG0
+ */
+p256_verify_table:
+  /* Check the signature and compute the scalars.
+       w0 <= u2, w1 <= u1 */
+  jal       x1, p256_verify_scalars
+
+  /* Fail if the first table entry is not the public key.
+       w6, w7 <= Q = (dmem[x], dmem[y])
+       w11, w12 <= T_Q[1] */
+  li        x2, 6
+  la        x3, x
+  bn.lid    x2++, 0(x3)
+  la        x3, y
+  bn.lid    x2, 0(x3)
+  li        x2, 11
+  bn.lid    x2++, 0(x5)
+  bn.lid    x2, 32(x5)
+  bn.cmp    w6, w11
+  csrrs     x2, FG0, x0
+  andi      x2, x2, 8
+  beq       x2, x0, p256_invalid_input
+  bn.cmp    w7, w12
+  csrrs     x2, FG0, x0
+  andi      x2, x2, 8
+  beq       x2, x0, p256_invalid_input
+
+  /* Split the scalars into 107-bit chunks, with the MSB of each chunk in the
+     most significant position of a word.
+       w1, w2, w3 <= u1[106:0] << 149, u1[213:107] << 149, u1[255:214] << 149
+       w0, w4, w5 <= u2[106:0] << 149, u2[213:107] << 149, u2[255:214] << 149 */
+  bn.rshi   w6, w31, w1 >> 107
+  bn.rshi   w7, w31, w1 >> 214
+  bn.rshi   w1, w1, w31 >> 107
+  bn.rshi   w2, w6, w31 >> 107
+  bn.rshi   w3, w7, w31 >> 107
+  bn.rshi   w6, w31, w0 >> 107
+  bn.rshi   w7, w31, w0 >> 214
+  bn.rshi   w0, w0, w31 >> 107
+  bn.rshi   w4, w6, w31 >> 107
+  bn.rshi   w5, w7, w31 >> 107
+
+  /* init comb loop with point in infinity
+     C = (w8, w9, w10) <= (0, 1, 0) */
+  bn.mov    w8, w31
+  bn.addi   w9, w31, 1
+  bn.mov    w10, w31
+
+  /* x13, x14 <= 11, 12 (register indices for table entries)
+     x4 <= p256_comb_table - 64, x5 <= T_Q - 64
+     x12 <= 0, loop counter */
+  li        x13, 11
+  li        x14, 12
+  la        x4, p256_comb_table
+  addi      x4, x4, -64
+  addi      x5, x5, -64
+  li        x12, 0
+
+  /* comb loop with decreasing index */
+  loopi     107, 51
+
+    /* C = (w8, w9, w10) <= 2*C */
+    jal       x1, proj_double
+    bn.mov    w8, w11
+    bn.mov    w9, w12
+    bn.mov    w10, w13
+
+    /* Assemble the index for G from the MSbs of the chunks of u1 and shift
+       the chunks left by one bit.
+       x2 <= u1_0[i] + 2*u1_1[i] + 4*u1_2[i] */
+    bn.add    w3, w3, w3
+    csrrs     x2, FG0, x0
+    andi      x2, x2, 1
+    bn.add    w2, w2, w2
+    csrrs     x3, FG0, x0
+    andi      x3, x3, 1
+    slli      x2, x2, 1
+    or        x2, x2, x3
+    bn.add    w1, w1, w1
+    csrrs     x3, FG0, x0
+    andi      x3, x3, 1
+    slli      x2, x2, 1
+    or        x2, x2, x3
+
+    /* Skip the addition of the point at infinity. */
+    beq       x2, x0, no_g_table
+
+    /* C = (w8, w9, w10) <= C + T_G[x2] */
+    slli      x2, x2, 6
+    add       x3, x4, x2
+    bn.lid    x13, 0(x3)
+    bn.lid    x14, 32(x3)
+    bn.addi   w13, w31, 1
+    jal       x1, proj_add
+    bn.mov    w8, w11
+    bn.mov    w9, w12
+    bn.mov    w10, w13
+
+    no_g_table:
+    /* Same for Q and u2.
+       x2 <= u2_0[i] + 2*u2_1[i] + 4*u2_2[i] */
+    bn.add    w5, w5, w5
+    csrrs     x2, FG0, x0
+    andi      x2, x2, 1
+    bn.add    w4, w4, w4
+    csrrs     x3, FG0, x0
+    andi      x3, x3, 1
+    slli      x2, x2, 1
+    or        x2, x2, x3
+    bn.add    w0, w0, w0
+    csrrs     x3, FG0, x0
+    andi      x3, x3, 1
+    slli      x2, x2, 1
+    or        x2, x2, x3
+    beq       x2, x0, no_q_table
+
+    /* C = (w8, w9, w10) <= C + T_Q[x2] */
+    slli      x2, x2, 6
+    add       x3, x5, x2
+    bn.lid    x13, 0(x3)
+    bn.lid    x14, 32(x3)
+    bn.addi   w13, w31, 1
+    jal       x1, proj_add
+    bn.mov    w8, w11
+    bn.mov    w9, w12
+    bn.mov    w10, w13
+
+    no_q_table:
+    /* increment counter */
+    addi      x12, x12, 1
+
+  /* Convert the result to affine and store it. Tail-call.
+       (w11, w13) <= (x_c, z_c)
+       x14 <= expected hardened counter value */
+  bn.mov    w11, w8
+  bn.mov    w13, w10
+  addi      x14, x0, HARDENED_BOOL_TRUE_XOR_TABLE_COUNTER
+  jal       x0, p256_verify_finish
+
+/**
+ * Check an ECDSA signature and compute the scalars for verification.
+ *
+ * Fails (see p256_invalid_input) if r or s is not in [1, n-1]. On success,
+ * computes u1 = msg*s^-1 mod n and u2 = r*s^-1 mod n and sets up the
+ * registers for coordinate arithmetic.
+ *
+ * @param[in]  dmem[msg]: message to be verified (256 bits)
+ * @param[in]  dmem[r]:   r component of signature (256 bits)
+ * @param[in]  dmem[s]:   s component of signature (256 bits)
+ * @param[out] w0: u2 = r*s^-1 mod n
+ * @param[out] w1: u1 = msg*s^-1 mod n
+ * @param[out] w27: b, curve domain parameter
+ * @param[out] w28: r256, constant, 2^256 mod p = 2^256 - p
+ * @param[out] w29: r448, constant, 2^448 mod p
+ * @param[out] w31: all-zero
+ * @param[out] MOD: p, modulus of P-256 underlying finite field
+ *
+ * Flags: Flags have no meaning beyond the scope of this subroutine.
+ *
+ * clobbered registers: x2, x3, x18 to x20, w0 to w7, w19 to w29
+ * clobbered flag groups: FG0
+ */
+p256_verify_scalars:
+  /* init all-zero register */
+  bn.xor    w31, w31, w31
+
+  /* load domain parameter b from dmem
+     w27 <= b = dmem[p256_b] */
+  li        x2, 27
+  la        x3, p256_b
+  bn.lid    x2, 0(x3)
+
+  /* setup modulus n (curve order) and Barrett constant
+     MOD <= w29 <= n = dmem[p256_n]; w28 <= u_n = dmem[p256_u_n]  */
+  li        x2, 29
+  la        x3, p256_n
+  bn.lid    x2, 0(x3)
+  bn.wsrw   MOD, w29
+  li        x2, 28
+  la        x3, p256_u_n
+  bn.lid    x2, 0(x3)
+
+  /* load s of signature from dmem: w0 = s = dmem[s] */
+  la        x20, s
+  bn.lid    x0, 0(x20)
+
+  /* Fail if w0 == w31 <=> s == 0 */
+  bn.cmp    w0, w31
+  csrrs     x2, FG0, x0
+  andi      x2, x2, 8
+  bne       x2, x0, p256_invalid_input
+
+  /* Fail if w0 >= w29 <=> s >= n */
+  bn.cmp    w0, w29
+  csrrs     x2, FG0, x0
+  andi      x2, x2, 1
+  beq       x2, x0, p256_invalid_input
+
+  /* w1 = s^-1  mod n */
+  jal       x1, mod_inv_var
+
+  /* load r of signature from dmem: w24 = r = dmem[r] */
+  la        x19, r
+  li        x2,  24
+  bn.lid    x2, 0(x19)
+
+  /* Fail if w24 == w31 <=> r == 0 */
+  bn.cmp    w24, w31
+  csrrs     x2, FG0, x0
+  andi      x2, x2, 8
+  bne       x2, x0, p256_invalid_input
+
+  /* Fail if w0 >= w29 <=> r >= n */
+  bn.cmp    w24, w29
+  csrrs     x2, FG0, x0
+  andi      x2, x2, 1
+  beq       x2, x0, p256_invalid_input
+
+  /* w25 = s^-1 = w1 */
+  bn.mov    w25, w1
+
+  /* u2 = w0 = w19 <= w24*w25 = r*s^-1 mod n */
+  jal       x1, mod_mul_256x256
+  bn.mov    w0, w19
+
+  /* load message, w24 = msg = dmem[msg] */
+  la        x18, msg
+  li        x2, 24
+  bn.lid    x2, 0(x18)
+
+  /* u1 = w1 = w19 <= w24*w25 = w24*w1 = msg*s^-1 mod n */
+  bn.mov    w25, w1
+  jal       x1, mod_mul_256x256
+  bn.mov    w1, w19
+
+  /* Set up for coordinate arithmetic.
+       MOD <= p
+       w28 <= r256
+       w29 <= r448
+     Tail-call. */
+  jal       x0, setup_modp
+
+/**
+ * Convert the verification result to affine and store it.
+ *
+ * Computes x1 = (x_c / z_c mod p) mod n. `ok` is set to x14 XORed with the
+ * loop counter, which is hardened true only if the loop ran as often as
+ * expected.
+ *
+ * @param[in]  w11: x_c, projective x-coordinate of u1*G + u2*Q
+ * @param[in]  w13: z_c, projective z-coordinate of u1*G + u2*Q
+ * @param[in]  x12: loop counter
+ * @param[in]  x14: hardened true XORed with the expected loop counter
+ * @param[in]  MOD: p, modulus of P-256 underlying finite field
+ * @param[out] dmem[ok]:  hardened true if x12 has the expected value
+ * @param[out] dmem[x_r]: reduced affine x-coordinate (x_1)
+ *
+ * Flags: Flags have no meaning beyond the scope of this subroutine.
+ *
+ * clobbered registers: x2, x3, x17, w0 to w7, w19, w24, w25
+ * clobbered flag groups: FG0
+ */
+p256_verify_finish:
   /* compute inverse of z-coordinate: w1 = z_c^-1  mod p */
   bn.mov    w0, w13
   jal       x1, mod_inv_var
@@ -273,8 +513,7 @@ p256_verify:
 
   /* If we got here the basic validity checks passed, so set `ok` to true. */
   la       x2, ok
-  addi     x3, x0, HARDENED_BOOL_TRUE_XOR_COUNTER
-  xor      x3, x3, x12
+  xor      x3, x14, x12
   sw       x3, 0(x2)
 
   /* store affine x-coordinate in dmem: dmem[x_r] = w24 = x_r */
@@ -5,6 +5,8 @@
 /* Public interface. */
 .globl rsa_keygen
 .globl rsa_key_from_cofactor
+.globl rsa_keygen_prime
+.globl rsa_key_from_primes
 
 /* Exposed for testing purposes only. */
 .globl relprime_f4
@@ -270,6 +272,166 @@ rsa_key_from_cofactor:
   /* Derive the private exponent d from p and q (tail-call). */
   jal      x0, derive_d
 
+/**
+ * Generate a single random RSA prime, masked with fresh randomness.
+ *
+ * The prime satisfies the same conditions as p in `rsa_keygen`. It is returned
+ * as two boolean shares so that it is never visible unmasked outside OTBN.
+ * Primes from this routine can be combined into a key pair with
+ * `rsa_key_from_primes`.
+ *
+ * Flags: Flags have no meaning beyond the scope of this subroutine.
+ *
+ * @param[in]  x30: plen, number of 256-bit limbs for the prime
+ * @param[in]  w31: all-zero
+ * @param[out] dmem[rsa_cofactor..rsa_cofactor+(plen*32)]: first share
+ * @param[out] dmem[rsa_cofactor+256..rsa_cofactor+256+(plen*32)]: second share
+ *
+ * clobbered registers: x2 to x13, x16 to x26, x31,
+ *                      w2, w3, w4..w[4+(plen-1)], w20 to w30
+ * clobbered flag groups: FG0, FG1
+ */
+rsa_keygen_prime:
+  /* Compute (<# of limbs> - 1), a helpful constant for later computations.
+       x31 <= x30 - 1 */
+  addi     x2, x0, 1
+  sub      x31, x30, x2
+
+  /* Initialize wide-register pointers.
+       x20 <= 20
+       x21 <= 21 */
+  li       x20, 20
+  li       x21, 21
+
+  /* Generate a prime.
+       dmem[rsa_p..rsa_p+(plen*32)] <= p */
+  jal      x1, generate_p
+
+  /* Split the prime into shares.
+       dmem[rsa_cofactor..rsa_cofactor+(plen*32)] <= p ^ r
+       dmem[rsa_cofactor+256..rsa_cofactor+256+(plen*32)] <= r */
+  la       x2, rsa_p
+  la       x3, rsa_cofactor
+  addi     x4, x3, 256
+  loop     x30, 5
+    /* w20 <= p[i] */
+    bn.lid   x20, 0(x2++)
+    /* w21 <= URND() */
+    bn.wsrr  w21, URND
+    /* w20 <= p[i] ^ w21 */
+    bn.xor   w20, w20, w21
+    bn.sid   x20, 0(x3++)
+    bn.sid   x21, 0(x4++)
+
+  ret
+
+/**
+ * Construct an RSA key pair from two masked primes.
+ *
+ * The primes are expected to come from `rsa_keygen_prime`; this routine does
+ * not test them for primality. It does run the checks on the pair that
+ * `rsa_keygen` runs: |p-q| must be at least 2^(nlen/2 - 100) and d must be
+ * greater than 2^(nlen/2). If either check fails, the routine returns a
+ * nonzero value in x2 and the caller should discard the pair.
+ *
+ * Flags: Flags have no meaning beyond the scope of this subroutine.
+ *
+ * @param[in]  x30: plen, number of 256-bit limbs for p and q
+ * @param[in]  w31: all-zero
+ * @param[in]  dmem[rsa_cofactor..rsa_cofactor+512]: shares of p, as for
+ *                                                   `rsa_keygen_prime`
+ * @param[in]  dmem[rsa_d..rsa_d+512]: shares of q, as for `rsa_keygen_prime`
+ * @param[out] dmem[rsa_n..rsa_n+(plen*2*32)] RSA public key modulus (n)
+ * @param[out] dmem[rsa_d..rsa_d+(plen*2*32)] RSA private exponent (d)
+ * @param[out] x2: zero if the key pair is OK, otherwise nonzero
+ *
+ * clobbered registers: x2 to x8, x10 to x15, x20 to x26, x31, w20 to w28
+ * clobbered flag groups: FG0, FG1
+ */
+rsa_key_from_primes:
+  /* Initialize wide-register pointers.
+       x20 <= 20
+       x21 <= 21 */
+  li       x20, 20
+  li       x21, 21
+
+  /* Unmask p and q into the scratchpad.
+       dmem[rsa_p..rsa_p+(plen*32)] <= p
+       dmem[rsa_q..rsa_q+(plen*32)] <= q */
+  la       x10, rsa_cofactor
+  la       x11, rsa_p
+  jal      x1, unmask_prime
+  la       x10, rsa_d
+  la       x11, rsa_q
+  jal      x1, unmask_prime
+
+  /* Check that p and q are far enough apart.
+       x2 <= zero if |p-q| is large enough, otherwise nonzero */
+  jal      x1, check_pq_distance
+  bne      x2, x0, _rsa_key_from_primes_done
+
+  /* Multiply p and q to get the public modulus n.
+       dmem[rsa_n..rsa_n+(plen*2*32)] <= p * q */
+  la       x10, rsa_p
+  la       x11, rsa_q
+  la       x12, rsa_n
+  jal      x1, bignum_mul
+
+  /* Derive the private exponent d from p and q.
+       dmem[rsa_d..rsa_d+(plen*2*32)] <= d */
+  jal      x1, derive_d
+
+  /* Get a pointer to the second half of d.
+       x3 <= rsa_d + plen*32 */
+  slli     x2, x30, 5
+  la       x3, rsa_d
+  add      x3, x3, x2
+
+  /* Check that d > 2^(plen*256) by ORing the plen highest limbs, as in
+     `check_d`.
+       FG0.Z <= (d >> (plen*256)) == 0 */
+  bn.mov   w23, w31
+  loop     x30, 2
+    /* w20 <= d[n+i] */
+    bn.lid  x20, 0(x3++)
+    /* w23 <= w23 | w20 */
+    bn.or   w23, w23, w20
+
+  /* x2 <= CSRs[FG0] & 8 = FG0.Z << 3 */
+  csrrs    x2, FG0, x0
+  andi     x2, x2, 8
+
+_rsa_key_from_primes_done:
+  ret
+
+/**
+ * Unmask a prime from `rsa_keygen_prime`.
+ *
+ * Flags: Flags have no meaning beyond the scope of this subroutine.
+ *
+ * @param[in]  x10: dptr_shares, pointer to the two 256-byte shares in DMEM
+ * @param[in]  x11: dptr_result, pointer to the result buffer in DMEM
+ * @param[in]  x20: 20, constant
+ * @param[in]  x21: 21, constant
+ * @param[in]  x30: plen, number of 256-bit limbs for the prime
+ * @param[out] dmem[dptr_result..dptr_result+(plen*32)]: unmasked prime
+ *
+ * clobbered registers: x2, x10, x11, w20, w21
+ * clobbered flag groups: none
+ */
+unmask_prime:
+  addi     x2, x10, 256
+  loop     x30, 4
+    /* w20 <= share0[i] */
+    bn.lid   x20, 0(x10++)
+    /* w21 <= share1[i] */
+    bn.lid   x21, 0(x2++)
+    /* w20 <= share0[i] ^ share1[i] */
+    bn.xor   w20, w20, w21
+    bn.sid   x20, 0(x11++)
+
+  ret
+
 /**
  * Compute the inverse of 65537 modulo a given number.
  *
@@ -1115,6 +1277,37 @@ _check_prime_fail:
  * clobbered flag groups: FG0, FG1
  */
 check_q:
+  /* Check that q is not too close to p.
+       x2 <= zero if |p-q| is large enough, otherwise nonzero */
+  jal      x1, check_pq_distance
+
+  /* If the check failed, we can skip the remaining checks. */
+  bne      x2, x0, _check_prime_fail
+
+  /* Remaining checks are the same as for p; tail call `check_p`. */
+  la   x16, rsa_q
+  jal  x0, check_p
+
+/**
+ * Check that p and q are not too close together.
+ *
+ * Returns zero if |p-q| >= 2^(nlen/2 - 100), where `nlen` is the size of the
+ * RSA public key, and nonzero otherwise (see FIPS 186-5 section A.1.3).
+ *
+ * Flags: Flags have no meaning beyond the scope of this subroutine.
+ *
+ * @param[in]  x20: 20, constant
+ * @param[in]  x21: 21, constant
+ * @param[in]  x30: plen, number of 256-bit limbs in p and q
+ * @param[in]  w31: all-zero
+ * @param[in]  dmem[rsa_p..rsa_p+(plen*32)]: value for p
+ * @param[in]  dmem[rsa_q..rsa_q+(plen*32)]: value for q
+ * @param[out] x2: zero if the check passed, otherwise nonzero
+ *
+ * clobbered registers: x2, x7, x8, w20 to w23
+ * clobbered flag groups: FG0, FG1
+ */
+check_pq_distance:
   /* Clear flags for both groups. */
   bn.sub   w31, w31, w31, FG0
   bn.sub   w31, w31, w31, FG1
@@ -1152,13 +1345,7 @@ check_q:
   csrrs    x2, FG0, x0
   andi     x2, x2, 8
 
-  /* If the flag is set, then the check failed and we can skip the remaining
-     checks. */
-  bne      x2, x0, _check_prime_fail
-
-  /* Remaining checks are the same as for p; tail call `check_p`. */
-  la   x16, rsa_q
-  jal  x0, check_p
+  ret
 
 /**
  * Generate a candidate prime (can be used for either p or q).
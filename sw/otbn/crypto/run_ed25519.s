@@ -0,0 +1,564 @@
+/* Copyright lowRISC contributors (OpenTitan project). */
+/* Licensed under the Apache License, Version 2.0, see LICENSE for details. */
+/* SPDX-License-Identifier: Apache-2.0 */
+
+/**
+ * Entrypoint for Ed25519 operations (RFC 8032).
+ *
+ * The SHA-512 computations of Ed25519 run on Ibex with the HMAC block; this
+ * binary does the curve and scalar arithmetic. It has the following modes of
+ * operation:
+ * 1. MODE_GEN_SEED: generate a fresh, random secret seed
+ * 2. MODE_KEYGEN: compute the public key from the hashed seed
+ * 3. MODE_SIGN_COMMIT: compute the public key and the commitment R
+ * 4. MODE_SIGN_FINISH: compute the signature scalar S
+ * 5. MODE_VERIFY: verify a signature
+ * 6. MODE_VERIFY_BATCH: verify a batch of signatures
+ *
+ * A signature takes two runs: MODE_SIGN_COMMIT, then MODE_SIGN_FINISH once
+ * Ibex has hashed R. The second run expects the DMEM contents left by the
+ * first one.
+ */
+
+/**
+ * Mode magic values.
+ *
+ * These were picked at random among 11-bit values so that they have a
+ * minimum HD of 6 to each other.
+ *
+ * TODO(#17727): in some places the OTBN assembler support for .equ directives
+ * is lacking, so they cannot be used in bignum instructions or pseudo-ops such
+ * as `li`. If support is added, we could use 32-bit values here instead of
+ * 11-bit.
+ */
+.equ MODE_GEN_SEED, 0x3f5
+.equ MODE_KEYGEN, 0x2ae
+.equ MODE_SIGN_COMMIT, 0x612
+.equ MODE_SIGN_FINISH, 0x50f
+.equ MODE_VERIFY, 0x5a0
+.equ MODE_VERIFY_BATCH, 0x669
+
+/**
+ * Make the mode constants visible to Ibex.
+ */
+.globl MODE_GEN_SEED
+.globl MODE_KEYGEN
+.globl MODE_SIGN_COMMIT
+.globl MODE_SIGN_FINISH
+.globl MODE_VERIFY
+.globl MODE_VERIFY_BATCH
+
+/**
+ * Maximum number of signatures in a batch, and the size in bytes of one item
+ * (enc_a, sig_s, h_k) of the batch input.
+ *
+ * Should match the values in `ed25519.h`.
+ */
+.equ BATCH_MAX_ITEMS, 8
+.equ BATCH_ITEM_BYTES, 128
+
+/**
+ * Hardened boolean values.
+ *
+ * Should match the values in `hardened_asm.h`.
+ */
+.equ HARDENED_BOOL_TRUE, 0x739
+.equ HARDENED_BOOL_FALSE, 0x1d4
+
+.section .text.start
+.globl start
+start:
+  /* Read the mode and tail-call the requested operation. */
+  la    x2, mode
+  lw    x2, 0(x2)
+
+  addi  x3, x0, MODE_GEN_SEED
+  beq   x2, x3, gen_seed
+
+  addi  x3, x0, MODE_KEYGEN
+  beq   x2, x3, keygen
+
+  addi  x3, x0, MODE_SIGN_COMMIT
+  beq   x2, x3, sign_commit
+
+  addi  x3, x0, MODE_SIGN_FINISH
+  beq   x2, x3, sign_finish
+
+  addi  x3, x0, MODE_VERIFY
+  beq   x2, x3, verify
+
+  addi  x3, x0, MODE_VERIFY_BATCH
+  beq   x2, x3, verify_batch
+
+  /* Invalid mode; fail. */
+  unimp
+  unimp
+  unimp
+
+/**
+ * Generate a fresh, random secret seed.
+ *
+ * The seed is expressed in boolean shares seed0, seed1 such that the seed is
+ * (seed0 ^ seed1) mod 2^256. The top 64 bits of each share are zero.
+ *
+ * @param[out] dmem[seed0]: First share of the seed (320 bits).
+ * @param[out] dmem[seed1]: Second share of the seed (320 bits).
+ */
+gen_seed:
+  bn.xor   w31, w31, w31
+
+  /* w0 <= RND, w1 <= URND */
+  bn.wsrr  w0, RND
+  bn.wsrr  w1, URND
+
+  /* dmem[seed0] <= w0
+     dmem[seed1] <= w1 */
+  li       x2, 0
+  la       x3, seed0
+  bn.sid   x2, 0(x3)
+  li       x2, 31
+  bn.sid   x2, 32(x3)
+  li       x2, 1
+  la       x3, seed1
+  bn.sid   x2, 0(x3)
+  li       x2, 31
+  bn.sid   x2, 32(x3)
+
+  ecall
+
+/**
+ * Compute the public key.
+ *
+ * The seed shares are not used, but are left in DMEM for the caller to read
+ * back with the public key.
+ *
+ * @param[in]  dmem[h_a]: lower half of SHA-512(seed) (256 bits)
+ * @param[out] dmem[enc_a]: encoded public key A (256 bits)
+ */
+keygen:
+  jal      x1, ed25519_init
+  jal      x1, public_key
+  ecall
+
+/**
+ * Compute the public key and the commitment R of a signature.
+ *
+ * @param[in]  dmem[h_a]: lower half of SHA-512(seed) (256 bits)
+ * @param[in]  dmem[h_r]: SHA-512(dom2 || prefix || M) (512 bits)
+ * @param[out] dmem[enc_a]: encoded public key A (256 bits)
+ * @param[out] dmem[enc_r]: encoded commitment R (256 bits)
+ */
+sign_commit:
+  jal      x1, ed25519_init
+  jal      x1, public_key
+
+  /* w28 <= h_r mod L = r */
+  la       x3, h_r
+  jal      x1, load_scalar_mod_l
+  bn.mov   w28, w18
+
+  /* dmem[enc_r] <= enc([r]B) */
+  jal      x1, ed25519_init
+  jal      x1, ed25519_base_mult
+  jal      x1, ed25519_encode_point
+  li       x2, 22
+  la       x3, enc_r
+  bn.sid   x2, 0(x3)
+
+  ecall
+
+/**
+ * Compute the signature scalar S = (r + k * a) mod L.
+ *
+ * @param[in]  dmem[h_a]: lower half of SHA-512(seed) (256 bits)
+ * @param[in]  dmem[h_r]: SHA-512(dom2 || prefix || M) (512 bits)
+ * @param[in]  dmem[h_k]: SHA-512(dom2 || R || A || M) (512 bits)
+ * @param[out] dmem[sig_s]: signature scalar S (256 bits)
+ */
+sign_finish:
+  bn.xor   w31, w31, w31
+
+  /* w0 <= h_r mod L = r */
+  la       x3, h_r
+  jal      x1, load_scalar_mod_l
+  bn.mov   w0, w18
+
+  /* w21 <= h_k mod L = k */
+  la       x3, h_k
+  jal      x1, load_scalar_mod_l
+  bn.mov   w21, w18
+
+  /* w22 <= a */
+  jal      x1, secret_scalar
+  bn.mov   w22, w28
+
+  /* w18 <= (k * a + r) mod L = S */
+  jal      x1, sc_mul
+  bn.addm  w18, w18, w0
+
+  /* dmem[sig_s] <= S */
+  li       x2, 18
+  la       x3, sig_s
+  bn.sid   x2, 0(x3)
+
+  ecall
+
+/**
+ * Verify a signature.
+ *
+ * The result of the verification is returned in two variables: `ok`
+ * indicates whether the signature passed basic validity checks, and
+ * `enc_result` is the encoding of [S]B - [k]A. A signature passes
+ * verification only if BOTH:
+ * - `ok` is true, and
+ * - `enc_result` is equal to the encoded R of the signature.
+ *
+ * @param[in]  dmem[enc_a]: encoded public key A (256 bits)
+ * @param[in]  dmem[sig_s]: signature scalar S (256 bits)
+ * @param[in]  dmem[h_k]: SHA-512(dom2 || R || A || M) (512 bits)
+ * @param[out] dmem[ok]: success/failure of basic checks (32 bits)
+ * @param[out] dmem[enc_result]: encoding of [S]B - [k]A (256 bits)
+ */
+verify:
+  /* Verify the signature (ends the program on failure). */
+  jal      x1, verify_item
+
+  /* If we got here the basic validity checks passed, so set `ok` to true. */
+  la       x2, ok
+  addi     x3, x0, HARDENED_BOOL_TRUE
+  sw       x3, 0(x2)
+
+  ecall
+
+/**
+ * Verify a batch of signatures.
+ *
+ * Runs the checks and computation of `verify` on each item of the batch from
+ * `batch_idx` up to `batch_n`, storing the result of item i in `batch_result`
+ * at offset 32*i. `batch_idx` always holds the index of the item being
+ * verified, so if an item fails the basic validity checks the program ends
+ * (with `ok` false) and `batch_idx` tells the caller which one it was. The
+ * caller can then restart the program at the next item.
+ *
+ * Each batch input item holds enc_a, sig_s and h_k, in this order, as in
+ * `verify`.
+ *
+ * @param[in]      dmem[batch_n]: number of items in the batch (32 bits)
+ * @param[in,out]  dmem[batch_idx]: index of the first item to verify, and
+ *                                  then of the current item (32 bits)
+ * @param[in]      dmem[batch_in]: the batch input items
+ * @param[out]     dmem[ok]: success/failure of basic checks (32 bits)
+ * @param[out]     dmem[batch_result]: encodings of [S]B - [k]A
+ */
+verify_batch:
+  /* Load the batch bounds.
+       x26 <= dmem[batch_idx]
+       x27 <= dmem[batch_n] */
+  la       x25, batch_idx
+  lw       x26, 0(x25)
+  la       x2, batch_n
+  lw       x27, 0(x2)
+
+  /* Point at the first item's input and output.
+       x28 <= batch_in + BATCH_ITEM_BYTES * x26
+       x29 <= batch_result + 32 * x26 */
+  slli     x28, x26, 7
+  la       x3, batch_in
+  add      x28, x28, x3
+  slli     x2, x26, 5
+  la       x29, batch_result
+  add      x29, x29, x2
+
+  /* Stop once the index reaches the end of the batch. */
+  beq      x26, x27, _verify_batch_done
+
+  _verify_batch_loop:
+  /* Record the index of the current item. */
+  sw       x26, 0(x25)
+
+  /* Copy the item into the single-signature buffers.
+       dmem[enc_a], dmem[sig_s], dmem[h_k] <= dmem[x28] */
+  li       x2, 0
+  la       x3, enc_a
+  bn.lid   x2, 0(x28)
+  bn.sid   x2, 0(x3)
+  la       x3, sig_s
+  bn.lid   x2, 32(x28)
+  bn.sid   x2, 0(x3)
+  la       x3, h_k
+  bn.lid   x2, 64(x28)
+  bn.sid   x2, 0(x3)
+  bn.lid   x2, 96(x28)
+  bn.sid   x2, 32(x3)
+
+  /* Verify the signature (ends the program on failure). */
+  jal      x1, verify_item
+
+  /* The basic validity checks passed. */
+  la       x2, ok
+  addi     x3, x0, HARDENED_BOOL_TRUE
+  sw       x3, 0(x2)
+
+  /* Copy the result out.
+       dmem[x29] <= w22 = dmem[enc_result] */
+  li       x2, 22
+  bn.sid   x2, 0(x29)
+
+  /* Advance to the next item. */
+  addi     x26, x26, 1
+  addi     x28, x28, BATCH_ITEM_BYTES
+  addi     x29, x29, 32
+  bne      x26, x27, _verify_batch_loop
+
+  _verify_batch_done:
+  sw       x26, 0(x25)
+  ecall
+
+/**
+ * Compute and store the public key.
+ *
+ * @param[in]  dmem[h_a]: lower half of SHA-512(seed) (256 bits)
+ * @param[in]  w19: constant, w19 = 19
+ * @param[in]  MOD: p, modulus = 2^255 - 19
+ * @param[in]  w30: constant, w30 = (2*d) mod p, d = (-121665/121666) mod p
+ * @param[in]  w31: all-zero
+ * @param[out] dmem[enc_a]: encoded public key A (256 bits)
+ *
+ * clobbered registers: x2, x3, x20, w9 to w18, w20 to w28
+ * clobbered flag groups: FG0
+ */
+public_key:
+  /* w28 <= a */
+  jal      x1, secret_scalar
+
+  /* dmem[enc_a] <= enc([a]B) */
+  jal      x1, ed25519_base_mult
+  jal      x1, ed25519_encode_point
+  li       x2, 22
+  la       x3, enc_a
+  bn.sid   x2, 0(x3)
+
+  ret
+
+/**
+ * Load the secret scalar a.
+ *
+ * Prunes the lower half of the hashed seed as in RFC 8032, section 5.1.5: the
+ * lowest three bits and the highest bit are cleared, and the second highest
+ * bit is set.
+ *
+ * This routine runs in constant time.
+ *
+ * @param[in]  dmem[h_a]: lower half of SHA-512(seed) (256 bits)
+ * @param[in]  w31: all-zero
+ * @param[out] w28: a, the secret scalar
+ *
+ * clobbered registers: x2, x3, w9, w28
+ * clobbered flag groups: none
+ */
+secret_scalar:
+  /* w28 <= dmem[h_a] */
+  li       x2, 28
+  la       x3, h_a
+  bn.lid   x2, 0(x3)
+
+  /* w28 <= ((w28 >> 3) << 5) mod 2^256 */
+  bn.rshi  w28, w31, w28 >> 3
+  bn.rshi  w28, w28, w31 >> 251
+  /* w28 <= 2^254 + (w28 >> 2) = a */
+  bn.addi  w9, w31, 1
+  bn.rshi  w28, w9, w28 >> 2
+
+  ret
+
+/**
+ * Load a 512-bit hash and reduce it modulo L.
+ *
+ * Sets MOD to L; callers doing curve arithmetic afterwards need to call
+ * `ed25519_init` again.
+ *
+ * This routine runs in constant time.
+ *
+ * @param[in]  x3: DMEM address of the hash
+ * @param[in]  w31: all-zero
+ * @param[out] w18: hash mod L
+ * @param[out] [w15:w14]: mu = floor(2^512 / L) (precomputed constant)
+ * @param[out] MOD: L, modulus
+ *
+ * clobbered registers: x2, x3, w10 to w18
+ * clobbered flag groups: FG0
+ */
+load_scalar_mod_l:
+  /* [w17:w16] <= dmem[x3] */
+  li       x2, 16
+  bn.lid   x2++, 0(x3)
+  bn.lid   x2, 32(x3)
+
+  /* MOD <= L, [w15:w14] <= mu */
+  jal      x1, sc_init
+
+  /* w18 <= [w17:w16] mod L */
+  jal      x1, sc_reduce
+
+  ret
+
+/**
+ * Check a signature and compute [S]B - [k]A.
+ *
+ * Ends the program with `ok` set to false if S is not below L or if A is not
+ * a valid point encoding.
+ *
+ * @param[in]  dmem[enc_a]: encoded public key A (256 bits)
+ * @param[in]  dmem[sig_s]: signature scalar S (256 bits)
+ * @param[in]  dmem[h_k]: SHA-512(dom2 || R || A || M) (512 bits)
+ * @param[out] dmem[enc_result]: encoding of [S]B - [k]A (256 bits)
+ * @param[out] w22: encoding of [S]B - [k]A
+ *
+ * clobbered registers: x2, x3, x20, w6 to w30, MOD
+ * clobbered flag groups: FG0
+ */
+verify_item:
+  jal      x1, ed25519_init
+
+  /* w7 <= h_k mod L = k */
+  la       x3, h_k
+  jal      x1, load_scalar_mod_l
+  bn.mov   w7, w18
+
+  /* w6 <= dmem[sig_s] = S */
+  li       x2, 6
+  la       x3, sig_s
+  bn.lid   x2, 0(x3)
+
+  /* Fail if L <= S. */
+  bn.wsrr  w20, MOD
+  bn.cmp   w6, w20
+  csrrs    x2, FG0, x0
+  andi     x2, x2, 1
+  beq      x2, x0, invalid_input
+
+  /* [w13:w10] <= A (fails if A is not a valid encoding) */
+  jal      x1, ed25519_init
+  li       x2, 29
+  la       x3, enc_a
+  bn.lid   x2, 0(x3)
+  jal      x1, ed25519_decode_point
+  bne      x2, x0, invalid_input
+
+  /* [w13:w10] <= -A */
+  bn.subm  w10, w31, w10
+  bn.subm  w13, w31, w13
+
+  /* w22 <= enc([S]B + [k](-A)) */
+  bn.mov   w28, w6
+  bn.mov   w29, w7
+  jal      x1, ed25519_double_base_mult
+  jal      x1, ed25519_encode_point
+
+  /* dmem[enc_result] <= w22 */
+  li       x2, 22
+  la       x3, enc_result
+  bn.sid   x2, 0(x3)
+
+  ret
+
+/**
+ * Set `ok` to false and end the program.
+ *
+ * @param[out] dmem[ok]: HARDENED_BOOL_FALSE
+ */
+invalid_input:
+  la       x2, ok
+  addi     x3, x0, HARDENED_BOOL_FALSE
+  sw       x3, 0(x2)
+  ecall
+
+.bss
+
+/* Operation mode. */
+.globl mode
+.balign 4
+mode:
+  .zero 4
+
+/* Success code for basic validity checks on the public key and signature. */
+.globl ok
+.balign 4
+ok:
+  .zero 4
+
+/* Number of items in a batch verification. */
+.globl batch_n
+.balign 4
+batch_n:
+  .zero 4
+
+/* Index of the current item of a batch verification. */
+.globl batch_idx
+.balign 4
+batch_idx:
+  .zero 4
+
+/* Secret seed in two shares: seed = (seed0 ^ seed1) mod 2^256. */
+.globl seed0
+.balign 32
+seed0:
+  .zero 64
+.globl seed1
+.balign 32
+seed1:
+  .zero 64
+
+/* Lower half of SHA-512(seed), from which the secret scalar a is derived. */
+.globl h_a
+.balign 32
+h_a:
+  .zero 32
+
+/* Hash from which the secret nonce r is derived. */
+.globl h_r
+.balign 32
+h_r:
+  .zero 64
+
+/* Hash from which the challenge k is derived. */
+.globl h_k
+.balign 32
+h_k:
+  .zero 64
+
+/* Encoded public key A. */
+.globl enc_a
+.balign 32
+enc_a:
+  .zero 32
+
+/* Encoded signature commitment R. */
+.globl enc_r
+.balign 32
+enc_r:
+  .zero 32
+
+/* Signature scalar S. */
+.globl sig_s
+.balign 32
+sig_s:
+  .zero 32
+
+/* Verification result, the encoding of [S]B - [k]A. */
+.globl enc_result
+.balign 32
+enc_result:
+  .zero 32
+
+/* Batch verification input: enc_a, sig_s, h_k for each item. */
+.globl batch_in
+.balign 32
+batch_in:
+  .zero 1024
+
+/* Batch verification results. */
+.globl batch_result
+.balign 32
+batch_result:
+  .zero 256
@@ -13,6 +13,8 @@
  * 5. MODE_SIDELOAD_KEYGEN: generate a keypair from a sideloaded seed
  * 6. MODE_SIDELOAD_SIGN: generate an ECDSA signature using sideloaded secret key/seed
  * 7. MODE_SIDELOAD_ECDH: ECDH key exchange using a secret key from a sideloaded seed
+ * 8. MODE_VERIFY_BATCH: verify a batch of ECDSA signatures
+ * 9. MODE_ECDH_EPHEMERAL: ECDH key exchange using a fresh ephemeral keypair
  */
 
 /**
@@ -36,6 +38,13 @@
 .equ MODE_SIDELOAD_SIGN, 0x45e
 .equ MODE_SIDELOAD_ECDH, 0x72c
 
+/**
+ * The encoder has no free value at this distance with the seed above, so this
+ * one was picked by hand to keep a minimum HD of 6 to all the others.
+ */
+.equ MODE_VERIFY_BATCH, 0x690
+.equ MODE_ECDH_EPHEMERAL, 0x0a6
+
 /**
  * Make the mode constants visible to Ibex.
  */
@@ -46,6 +55,17 @@
 .globl MODE_SIDELOAD_KEYGEN
 .globl MODE_SIDELOAD_SIGN
 .globl MODE_SIDELOAD_ECDH
+.globl MODE_VERIFY_BATCH
+.globl MODE_ECDH_EPHEMERAL
+
+/**
+ * Maximum number of signatures in a batch, and the size in bytes of one item
+ * (msg, r, s, x, y) of the batch input.
+ *
+ * Should match the values in `p256.h`.
+ */
+.equ BATCH_MAX_ITEMS, 8
+.equ BATCH_ITEM_BYTES, 160
 
 /**
  * Hardened boolean values.
@@ -83,6 +103,12 @@ start:
   addi  x3, x0, MODE_SIDELOAD_ECDH
   beq   x2, x3, shared_key_from_seed
 
+  addi  x3, x0, MODE_VERIFY_BATCH
+  beq   x2, x3, ecdsa_verify_batch
+
+  addi  x3, x0, MODE_ECDH_EPHEMERAL
+  beq   x2, x3, ephemeral_shared_key
+
   /* Invalid mode; fail. */
   unimp
   unimp
@@ -158,6 +184,95 @@ ecdsa_verify:
 
   ecall
 
+/**
+ * Verify a batch of signatures.
+ *
+ * Runs the checks and computation of `ecdsa_verify` on each item of the batch
+ * from `batch_idx` up to `batch_n`, storing the recovered x_r of item i in
+ * `batch_x_r` at offset 32*i. `batch_idx` always holds the index of the item
+ * being verified, so if an item fails the basic validity checks the program
+ * ends (with `ok` false) and `batch_idx` tells the caller which one it was.
+ * The caller can then restart the program at the next item.
+ *
+ * Each batch input item holds msg, r, s, x and y, in this order, as in
+ * `ecdsa_verify`.
+ *
+ * @param[in]      dmem[batch_n]: number of items in the batch (32 bits)
+ * @param[in,out]  dmem[batch_idx]: index of the first item to verify, and
+ *                                  then of the current item (32 bits)
+ * @param[in]      dmem[batch_in]: the batch input items
+ * @param[out]     dmem[ok]: success/failure of basic checks (32 bits)
+ * @param[out]     dmem[batch_x_r]: reduced affine x_r-coordinates
+ */
+ecdsa_verify_batch:
+  /* Load the batch bounds.
+       x26 <= dmem[batch_idx]
+       x27 <= dmem[batch_n] */
+  la       x25, batch_idx
+  lw       x26, 0(x25)
+  la       x2, batch_n
+  lw       x27, 0(x2)
+
+  /* Point at the first item's input and output.
+       x28 <= batch_in + BATCH_ITEM_BYTES * x26
+       x29 <= batch_x_r + 32 * x26 */
+  slli     x28, x26, 7
+  slli     x2, x26, 5
+  add      x28, x28, x2
+  la       x3, batch_in
+  add      x28, x28, x3
+  la       x29, batch_x_r
+  add      x29, x29, x2
+
+  /* Stop once the index reaches the end of the batch. */
+  beq      x26, x27, _batch_done
+
+  _batch_loop:
+  /* Record the index of the current item. */
+  sw       x26, 0(x25)
+
+  /* Copy the item into the single-signature buffers.
+       dmem[msg], dmem[r], dmem[s], dmem[x], dmem[y] <= dmem[x28] */
+  li       x2, 0
+  la       x3, msg
+  bn.lid   x2, 0(x28)
+  bn.sid   x2, 0(x3)
+  la       x3, r
+  bn.lid   x2, 32(x28)
+  bn.sid   x2, 0(x3)
+  la       x3, s
+  bn.lid   x2, 64(x28)
+  bn.sid   x2, 0(x3)
+  la       x3, x
+  bn.lid   x2, 96(x28)
+  bn.sid   x2, 0(x3)
+  la       x3, y
+  bn.lid   x2, 128(x28)
+  bn.sid   x2, 0(x3)
+
+  /* Validate the public key (ends the program on failure). */
+  jal      x1, p256_check_public_key
+
+  /* Verify the signature (ends the program on failure). */
+  jal      x1, p256_verify
+
+  /* Copy the result out.
+       dmem[x29] <= dmem[x_r] */
+  li       x2, 0
+  la       x3, x_r
+  bn.lid   x2, 0(x3)
+  bn.sid   x2, 0(x29)
+
+  /* Advance to the next item. */
+  addi     x26, x26, 1
+  addi     x28, x28, BATCH_ITEM_BYTES
+  addi     x29, x29, 32
+  bne      x26, x27, _batch_loop
+
+  _batch_done:
+  sw       x26, 0(x25)
+  ecall
+
 /**
  * Generate a shared key from a secret and public key (ECDH).
  *
@@ -196,6 +311,133 @@ shared_key:
 
   ecall
 
+/**
+ * Generate an ephemeral keypair and a shared key with the peer's public key.
+ *
+ * Combines MODE_KEYGEN and MODE_ECDH in one run, so that the ephemeral secret
+ * key never leaves OTBN: its shares are wiped from DMEM before the program
+ * ends. Returns the ephemeral public key (d*G) and the shared key, which is
+ * the affine x-coordinate of (d*Q) in boolean shares x0, x1 such that the key
+ * is (x0 ^ x1).
+ *
+ * The peer's public key is validated before the keypair is generated. If `ok`
+ * is false, the public key is invalid and all outputs are meaningless.
+ *
+ * This routine runs in constant time (except potentially waiting for entropy
+ * from RND).
+ *
+ * @param[in]            dmem[x]: Peer public key (Q) x-coordinate.
+ * @param[in]            dmem[y]: Peer public key (Q) y-coordinate.
+ * @param[out]          dmem[ok]: Whether the public key is valid.
+ * @param[out]           dmem[x]: x0, first share of shared key.
+ * @param[out]           dmem[y]: x1, second share of shared key.
+ * @param[out] dmem[ephemeral_x]: Ephemeral public key x-coordinate.
+ * @param[out] dmem[ephemeral_y]: Ephemeral public key y-coordinate.
+ */
+ephemeral_shared_key:
+  /* Init all-zero register. */
+  bn.xor   w31, w31, w31
+
+  /* Validate the public key (ends the program on failure). */
+  jal      x1, p256_check_public_key
+
+  /* If we got here the basic validity checks passed, so set `ok` to true. */
+  la       x2, ok
+  addi     x3, x0, HARDENED_BOOL_TRUE
+  sw       x3, 0(x2)
+
+  /* Move the peer public key out of the way of key generation.
+       dmem[ephemeral_x] <= Q.x
+       dmem[ephemeral_y] <= Q.y */
+  li       x2, 0
+  la       x3, x
+  bn.lid   x2, 0(x3)
+  la       x3, ephemeral_x
+  bn.sid   x2, 0(x3)
+  la       x3, y
+  bn.lid   x2, 0(x3)
+  la       x3, ephemeral_y
+  bn.sid   x2, 0(x3)
+
+  /* Generate secret key d in shares.
+       dmem[d0] <= d0
+       dmem[d1] <= d1 */
+  jal      x1, p256_generate_random_key
+
+  /* Generate public key d*G.
+       dmem[x] <= (d*G).x
+       dmem[y] <= (d*G).y */
+  jal      x1, p256_base_mult
+
+  /* Put the peer public key back in place for shared-key generation.
+       dmem[x] <= Q.x, dmem[ephemeral_x] <= (d*G).x
+       dmem[y] <= Q.y, dmem[ephemeral_y] <= (d*G).y */
+  jal      x1, swap_ephemeral_public_key
+
+  /* Generate boolean-masked shared key (d*Q).x.
+       dmem[x] <= x0
+       dmem[y] <= x1 */
+  bn.xor   w31, w31, w31
+  jal      x1, p256_shared_key
+
+  /* Wipe the secret key shares.
+       dmem[d0] <= 0
+       dmem[d1] <= 0 */
+  bn.xor   w31, w31, w31
+  li       x2, 31
+  la       x3, d0
+  bn.sid   x2, 0(x3)
+  bn.sid   x2, 32(x3)
+  la       x3, d1
+  bn.sid   x2, 0(x3)
+  bn.sid   x2, 32(x3)
+
+  ecall
+
+/**
+ * Swap the public key in (x, y) with the one in (ephemeral_x, ephemeral_y).
+ *
+ * @param[in,out]           dmem[x]: x-coordinate of a public key.
+ * @param[in,out]           dmem[y]: y-coordinate of a public key.
+ * @param[in,out] dmem[ephemeral_x]: x-coordinate of a public key.
+ * @param[in,out] dmem[ephemeral_y]: y-coordinate of a public key.
+ *
+ * clobbered registers: x2, x3, w0 to w3
+ * clobbered flag groups: none
+ */
+swap_ephemeral_public_key:
+  /* Load both public keys.
+       w0 <= dmem[x]
+       w1 <= dmem[y]
+       w2 <= dmem[ephemeral_x]
+       w3 <= dmem[ephemeral_y] */
+  li       x2, 0
+  la       x3, x
+  bn.lid   x2++, 0(x3)
+  la       x3, y
+  bn.lid   x2++, 0(x3)
+  la       x3, ephemeral_x
+  bn.lid   x2++, 0(x3)
+  la       x3, ephemeral_y
+  bn.lid   x2, 0(x3)
+
+  /* Store them swapped.
+       dmem[x] <= w2
+       dmem[y] <= w3
+       dmem[ephemeral_x] <= w0
+       dmem[ephemeral_y] <= w1 */
+  li       x2, 0
+  la       x3, ephemeral_x
+  bn.sid   x2++, 0(x3)
+  la       x3, ephemeral_y
+  bn.sid   x2++, 0(x3)
+  la       x3, x
+  bn.sid   x2++, 0(x3)
+  la       x3, y
+  bn.sid   x2, 0(x3)
+
+  ret
+
 /**
  * Generate a keypair from a sideloaded seed.
  *
@@ -344,6 +586,18 @@ x:
 y:
   .zero 32
 
+/* Ephemeral public key x-coordinate. */
+.globl ephemeral_x
+.balign 32
+ephemeral_x:
+  .zero 32
+
+/* Ephemeral public key y-coordinate. */
+.globl ephemeral_y
+.balign 32
+ephemeral_y:
+  .zero 32
+
 /* Private key (d) in two shares: d = (d0 + d1) mod n. */
 .globl d0
 .balign 32
@@ -360,6 +614,30 @@ d1:
 x_r:
   .zero 32
 
+/* Number of items in a batch verification. */
+.globl batch_n
+.balign 4
+batch_n:
+  .zero 4
+
+/* Index of the current item of a batch verification. */
+.globl batch_idx
+.balign 4
+batch_idx:
+  .zero 4
+
+/* Batch verification input: msg, r, s, x, y for each item. */
+.globl batch_in
+.balign 32
+batch_in:
+  .zero 1280
+
+/* Batch verification results x_r. */
+.globl batch_x_r
+.balign 32
+batch_x_r:
+  .zero 256
+
 .section .scratchpad
 
 /* Secret scalar (k) in two shares: k = (k0 + k1) mod n */
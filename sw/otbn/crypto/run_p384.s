@@ -13,6 +13,7 @@
  * 5. MODE_SIDELOAD_KEYGEN: generate a keypair from a sideloaded seed
  * 6. MODE_SIDELOAD_SIGN: generate an ECDSA signature using sideloaded secret key/seed
  * 7. MODE_SIDELOAD_ECDH: ECDH key exchange using a secret key from a sideloaded seed
+ * 8. MODE_ECDH_EPHEMERAL: ECDH key exchange using a fresh ephemeral keypair
  */
 
  /**
@@ -35,6 +36,11 @@
 .equ MODE_SIDELOAD_SIGN, 0x786
 .equ MODE_SIDELOAD_ECDH, 0x36a
 
+/**
+ * Picked by hand to keep a minimum HD of 6 to all the values above.
+ */
+.equ MODE_ECDH_EPHEMERAL, 0x254
+
 /**
  * Make the mode constants visible to Ibex.
  */
@@ -45,6 +51,7 @@
 .globl MODE_SIDELOAD_KEYGEN
 .globl MODE_SIDELOAD_SIGN
 .globl MODE_SIDELOAD_ECDH
+.globl MODE_ECDH_EPHEMERAL
 
 /**
  * Hardened boolean values.
@@ -82,6 +89,9 @@ start:
   addi  x3, x0, MODE_SIDELOAD_ECDH
   beq   x2, x3, shared_key_from_seed
 
+  addi  x3, x0, MODE_ECDH_EPHEMERAL
+  beq   x2, x3, ephemeral_shared_key
+
   /* Invalid mode; fail. */
   unimp
   unimp
@@ -221,6 +231,33 @@ shared_key:
   addi     x3, x0, HARDENED_BOOL_TRUE
   sw       x3, 0(x2)
 
+  /* Generate boolean-masked shared key (d*Q).x.
+       dmem[x] <= x0
+       dmem[y] <= x1 */
+  jal       x1, shared_key_masked
+
+  ecall
+
+/**
+ * Compute the shared key from a secret key and a validated public key.
+ *
+ * Returns the shared key, which is the affine x-coordinate of (d*Q), in
+ * boolean shares x0, x1 such that the key is (x0 ^ x1).
+ *
+ * This routine runs in constant time.
+ *
+ * @param[in]        w31: all-zero
+ * @param[in]   dmem[d0]: 1st private key share d0
+ * @param[in]   dmem[d1]: 2nd private key share d1
+ * @param[in]    dmem[x]: x-coordinate of public key
+ * @param[in]    dmem[y]: y-coordinate of public key
+ * @param[out]   dmem[x]: x0, first share of shared key.
+ * @param[out]   dmem[y]: x1, second share of shared key.
+ *
+ * clobbered registers: x2 to x4, x9 to x13, x17 to x21, x26 to x30, w0 to w30
+ * clobbered flag groups: FG0
+ */
+shared_key_masked:
   /* Generate arithmetically masked shared key d*Q.
      dmem[x] <= (d*Q).x - m mod p
      dmem[y] <= m */
@@ -256,8 +293,152 @@ shared_key:
   bn.sid    x2++, 0(x3)
   bn.sid    x2++, 32(x3)
 
+  ret
+
+/**
+ * Generate an ephemeral keypair and a shared key with the peer's public key.
+ *
+ * Combines MODE_KEYGEN and MODE_ECDH in one run, so that the ephemeral secret
+ * key never leaves OTBN: its shares are wiped from DMEM before the program
+ * ends. Returns the ephemeral public key (d*G) and the shared key, which is
+ * the affine x-coordinate of (d*Q) in boolean shares x0, x1 such that the key
+ * is (x0 ^ x1).
+ *
+ * The peer's public key is validated before the keypair is generated. If `ok`
+ * is false, the public key is invalid and all outputs are meaningless.
+ *
+ * This routine runs in constant time (except potentially waiting for entropy
+ * from RND).
+ *
+ * @param[in]            dmem[x]: Peer public key (Q) x-coordinate.
+ * @param[in]            dmem[y]: Peer public key (Q) y-coordinate.
+ * @param[out]          dmem[ok]: Whether the public key is valid.
+ * @param[out]           dmem[x]: x0, first share of shared key.
+ * @param[out]           dmem[y]: x1, second share of shared key.
+ * @param[out] dmem[ephemeral_x]: Ephemeral public key x-coordinate.
+ * @param[out] dmem[ephemeral_y]: Ephemeral public key y-coordinate.
+ *
+ * clobbered registers: x2 to x4, x9 to x13, x17 to x21, x26 to x30, w0 to w31
+ * clobbered flag groups: FG0
+ */
+ephemeral_shared_key:
+  /* Init all-zero register. */
+  bn.xor    w31, w31, w31
+
+  /* Validate the public key (ends the program on failure). */
+  jal       x1, p384_check_public_key
+
+  /* If we got here the basic validity checks passed, so set `ok` to true. */
+  la        x2, ok
+  addi      x3, x0, HARDENED_BOOL_TRUE
+  sw        x3, 0(x2)
+
+  /* Move the peer public key out of the way of key generation.
+       dmem[ephemeral_x] <= Q.x
+       dmem[ephemeral_y] <= Q.y */
+  li        x2, 0
+  la        x3, x
+  bn.lid    x2++, 0(x3)
+  bn.lid    x2++, 32(x3)
+  la        x3, y
+  bn.lid    x2++, 0(x3)
+  bn.lid    x2, 32(x3)
+  li        x2, 0
+  la        x3, ephemeral_x
+  bn.sid    x2++, 0(x3)
+  bn.sid    x2++, 32(x3)
+  la        x3, ephemeral_y
+  bn.sid    x2++, 0(x3)
+  bn.sid    x2, 32(x3)
+
+  /* Generate secret key d in shares.
+       dmem[d0] <= d0
+       dmem[d1] <= d1 */
+  bn.xor    w31, w31, w31
+  jal       x1, p384_generate_random_key
+
+  /* Generate public key d*G.
+       dmem[x] <= (d*G).x
+       dmem[y] <= (d*G).y */
+  jal       x1, p384_base_mult
+
+  /* Put the peer public key back in place for shared-key generation.
+       dmem[x] <= Q.x, dmem[ephemeral_x] <= (d*G).x
+       dmem[y] <= Q.y, dmem[ephemeral_y] <= (d*G).y */
+  jal       x1, swap_ephemeral_public_key
+
+  /* Generate boolean-masked shared key (d*Q).x.
+       dmem[x] <= x0
+       dmem[y] <= x1 */
+  bn.xor    w31, w31, w31
+  jal       x1, shared_key_masked
+
+  /* Wipe the secret key shares.
+       dmem[d0] <= 0
+       dmem[d1] <= 0 */
+  bn.xor    w31, w31, w31
+  li        x2, 31
+  la        x3, d0
+  bn.sid    x2, 0(x3)
+  bn.sid    x2, 32(x3)
+  la        x3, d1
+  bn.sid    x2, 0(x3)
+  bn.sid    x2, 32(x3)
+
   ecall
 
+/**
+ * Swap the public key in (x, y) with the one in (ephemeral_x, ephemeral_y).
+ *
+ * @param[in,out]           dmem[x]: x-coordinate of a public key.
+ * @param[in,out]           dmem[y]: y-coordinate of a public key.
+ * @param[in,out] dmem[ephemeral_x]: x-coordinate of a public key.
+ * @param[in,out] dmem[ephemeral_y]: y-coordinate of a public key.
+ *
+ * clobbered registers: x2, x3, w0 to w7
+ * clobbered flag groups: none
+ */
+swap_ephemeral_public_key:
+  /* Load both public keys.
+       [w1,w0] <= dmem[x]
+       [w3,w2] <= dmem[y]
+       [w5,w4] <= dmem[ephemeral_x]
+       [w7,w6] <= dmem[ephemeral_y] */
+  li        x2, 0
+  la        x3, x
+  bn.lid    x2++, 0(x3)
+  bn.lid    x2++, 32(x3)
+  la        x3, y
+  bn.lid    x2++, 0(x3)
+  bn.lid    x2++, 32(x3)
+  la        x3, ephemeral_x
+  bn.lid    x2++, 0(x3)
+  bn.lid    x2++, 32(x3)
+  la        x3, ephemeral_y
+  bn.lid    x2++, 0(x3)
+  bn.lid    x2, 32(x3)
+
+  /* Store them swapped.
+       dmem[ephemeral_x] <= [w1,w0]
+       dmem[ephemeral_y] <= [w3,w2]
+       dmem[x] <= [w5,w4]
+       dmem[y] <= [w7,w6] */
+  li        x2, 0
+  la        x3, ephemeral_x
+  bn.sid    x2++, 0(x3)
+  bn.sid    x2++, 32(x3)
+  la        x3, ephemeral_y
+  bn.sid    x2++, 0(x3)
+  bn.sid    x2++, 32(x3)
+  la        x3, x
+  bn.sid    x2++, 0(x3)
+  bn.sid    x2++, 32(x3)
+  la        x3, y
+  bn.sid    x2++, 0(x3)
+  bn.sid    x2, 32(x3)
+
+  ret
+
 /**
  * Generate a fresh random keypair from a sideloaded seed.
  *
@@ -378,6 +559,18 @@ x:
 y:
   .zero 64
 
+/* Ephemeral public key x-coordinate. */
+.globl ephemeral_x
+.balign 32
+ephemeral_x:
+  .zero 64
+
+/* Ephemeral public key y-coordinate. */
+.globl ephemeral_y
+.balign 32
+ephemeral_y:
+  .zero 64
+
 /* Private key (d) in two shares: d = (d0 + d1) mod n. */
 .globl d0
 .balign 32
@@ -5,11 +5,13 @@
 /**
  * RSA key generation.
  *
- * This binary can be called in two different modes:
+ * This binary can be called in four different modes:
  * - `GEN` mode generates a new, random keypair
  * - `COFACTOR` mode constructs a keypair from n, e, d, and either p or q.
+ * - `GEN_PRIME` mode generates a single masked prime for a prime pool
+ * - `FROM_PRIMES` mode constructs a keypair from two masked primes.
  *
- * Both modes support three sizes: RSA-2048, RSA-3072, and RSA-4096.
+ * All modes support three sizes: RSA-2048, RSA-3072, and RSA-4096.
  */
 
 /**
@@ -32,6 +34,22 @@
 .equ MODE_COFACTOR_RSA_3072, 0x0db
 .equ MODE_COFACTOR_RSA_4096, 0x794
 
+/**
+ * Prime pool modes. There is no room for six more 11-bit values at HD 6 from
+ * the ones above, so these were chosen to have a minimum HD of 5 from every
+ * other mode.
+ */
+.equ MODE_GEN_PRIME_RSA_2048, 0x07c
+.equ MODE_GEN_PRIME_RSA_3072, 0x18d
+.equ MODE_GEN_PRIME_RSA_4096, 0x1e2
+.equ MODE_FROM_PRIMES_RSA_2048, 0x2b1
+.equ MODE_FROM_PRIMES_RSA_3072, 0x551
+.equ MODE_FROM_PRIMES_RSA_4096, 0x607
+
+/* Hardened boolean values for the `FROM_PRIMES` result. */
+.equ HARDENED_BOOL_TRUE, 0x739
+.equ HARDENED_BOOL_FALSE, 0x1d4
+
 /**
  * Make the mode constants visible to Ibex.
  */
@@ -41,6 +59,12 @@
 .globl MODE_COFACTOR_RSA_3072
 .globl MODE_GEN_RSA_4096
 .globl MODE_COFACTOR_RSA_4096
+.globl MODE_GEN_PRIME_RSA_2048
+.globl MODE_FROM_PRIMES_RSA_2048
+.globl MODE_GEN_PRIME_RSA_3072
+.globl MODE_FROM_PRIMES_RSA_3072
+.globl MODE_GEN_PRIME_RSA_4096
+.globl MODE_FROM_PRIMES_RSA_4096
 
 .section .text.start
 start:
@@ -69,6 +93,24 @@ start:
   addi    x3, x0, MODE_COFACTOR_RSA_4096
   beq     x2, x3, rsa_key_from_cofactor_4096
 
+  addi    x3, x0, MODE_GEN_PRIME_RSA_2048
+  beq     x2, x3, rsa_keygen_prime_2048
+
+  addi    x3, x0, MODE_GEN_PRIME_RSA_3072
+  beq     x2, x3, rsa_keygen_prime_3072
+
+  addi    x3, x0, MODE_GEN_PRIME_RSA_4096
+  beq     x2, x3, rsa_keygen_prime_4096
+
+  addi    x3, x0, MODE_FROM_PRIMES_RSA_2048
+  beq     x2, x3, rsa_key_from_primes_2048
+
+  addi    x3, x0, MODE_FROM_PRIMES_RSA_3072
+  beq     x2, x3, rsa_key_from_primes_3072
+
+  addi    x3, x0, MODE_FROM_PRIMES_RSA_4096
+  beq     x2, x3, rsa_key_from_primes_4096
+
   /* Unsupported mode; fail. */
   unimp
   unimp
@@ -122,6 +164,70 @@ rsa_key_from_cofactor_4096:
   jal     x1, rsa_key_from_cofactor
   ecall
 
+rsa_keygen_prime_2048:
+  /* Set the number of limbs for the prime (2048 / 2 / 256). */
+  li      x30, 4
+
+  /* Generate a masked prime (result in dmem[rsa_cofactor]). */
+  jal     x1, rsa_keygen_prime
+  ecall
+
+rsa_keygen_prime_3072:
+  /* Set the number of limbs for the prime (3072 / 2 / 256). */
+  li      x30, 6
+
+  /* Generate a masked prime (result in dmem[rsa_cofactor]). */
+  jal     x1, rsa_keygen_prime
+  ecall
+
+rsa_keygen_prime_4096:
+  /* Set the number of limbs for the prime (4096 / 2 / 256). */
+  li      x30, 8
+
+  /* Generate a masked prime (result in dmem[rsa_cofactor]). */
+  jal     x1, rsa_keygen_prime
+  ecall
+
+rsa_key_from_primes_2048:
+  /* Set the number of limbs for the primes (2048 / 2 / 256). */
+  li      x30, 4
+
+  /* Construct a key (results in dmem[rsa_n] and dmem[rsa_d]). */
+  jal     x1, rsa_key_from_primes
+  jal     x0, write_ok
+
+rsa_key_from_primes_3072:
+  /* Set the number of limbs for the primes (3072 / 2 / 256). */
+  li      x30, 6
+
+  /* Construct a key (results in dmem[rsa_n] and dmem[rsa_d]). */
+  jal     x1, rsa_key_from_primes
+  jal     x0, write_ok
+
+rsa_key_from_primes_4096:
+  /* Set the number of limbs for the primes (4096 / 2 / 256). */
+  li      x30, 8
+
+  /* Construct a key (results in dmem[rsa_n] and dmem[rsa_d]). */
+  jal     x1, rsa_key_from_primes
+  jal     x0, write_ok
+
+/**
+ * Write the result of `rsa_key_from_primes` to DMEM and end the program.
+ *
+ * @param[in]  x2: zero if the key pair is OK, otherwise nonzero
+ * @param[out] dmem[ok]: HARDENED_BOOL_TRUE if x2 is zero, otherwise
+ *                       HARDENED_BOOL_FALSE
+ */
+write_ok:
+  addi    x3, x0, HARDENED_BOOL_TRUE
+  beq     x2, x0, _write_ok_store
+  addi    x3, x0, HARDENED_BOOL_FALSE
+_write_ok_store:
+  la      x4, ok
+  sw      x3, 0(x4)
+  ecall
+
 .bss
 
 /* Operational mode. */
@@ -129,3 +235,9 @@ rsa_key_from_cofactor_4096:
 .balign 4
 mode:
 .zero 4
+
+/* Result of the `FROM_PRIMES` pair checks (hardened boolean). */
+.globl ok
+.balign 4
+ok:
+.zero 4
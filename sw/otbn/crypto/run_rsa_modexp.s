@@ -10,8 +10,11 @@
  * `mode` parameter, the caller indicates the modulus size and selects either:
  *   (a) `modexp` mode: computes a^d mod n for a caller-provided exponent d
  *   (b) `modexp_f4` mode: computes a^65537 mod n
+ *   (c) `modexp_var` mode: computes a^e mod n for a caller-provided public
+ *       exponent e of at most 32 bits, in variable time
  *
- * In `modexp_f4` mode, the caller does not need to provide an exponent.
+ * In `modexp_f4` mode, the caller does not need to provide an exponent. In
+ * `modexp_var` mode, the exponent goes in `e` rather than `d`.
  *
  * The base `a` and exponent `d` (if provided) should be the same size as the
  * modulus; additional bits will be ignored.
@@ -40,6 +43,14 @@
 .equ MODE_RSA_4096_MODEXP, 0x70b
 .equ MODE_RSA_4096_MODEXP_F4, 0x0ee
 
+/**
+ * The encoder has no further values at this distance with the seed above, so
+ * these were picked by hand to keep a minimum HD of 6 to all the others.
+ */
+.equ MODE_RSA_2048_MODEXP_VAR, 0x017
+.equ MODE_RSA_3072_MODEXP_VAR, 0x384
+.equ MODE_RSA_4096_MODEXP_VAR, 0x5b2
+
 /**
  * Make the mode constants visible to Ibex.
  */
@@ -49,6 +60,9 @@
 .globl MODE_RSA_3072_MODEXP_F4
 .globl MODE_RSA_4096_MODEXP
 .globl MODE_RSA_4096_MODEXP_F4
+.globl MODE_RSA_2048_MODEXP_VAR
+.globl MODE_RSA_3072_MODEXP_VAR
+.globl MODE_RSA_4096_MODEXP_VAR
 
 .section .text.start
 start:
@@ -77,6 +91,15 @@ start:
   addi    x3, x0, MODE_RSA_4096_MODEXP_F4
   beq     x2, x3, rsa_4096_modexp_f4
 
+  addi    x3, x0, MODE_RSA_2048_MODEXP_VAR
+  beq     x2, x3, rsa_2048_modexp_var
+
+  addi    x3, x0, MODE_RSA_3072_MODEXP_VAR
+  beq     x2, x3, rsa_3072_modexp_var
+
+  addi    x3, x0, MODE_RSA_4096_MODEXP_VAR
+  beq     x2, x3, rsa_4096_modexp_var
+
   /* Unsupported mode; fail. */
   unimp
   unimp
@@ -124,6 +147,27 @@ rsa_4096_modexp_f4:
   /* Tail-call modexp_f4. */
   jal     x0, do_modexp_f4
 
+rsa_2048_modexp_var:
+  /* Set the number of limbs for the modulus (2048 / 256 = 8). */
+  li      x30, 8
+
+  /* Tail-call modexp_var. */
+  jal     x0, do_modexp_var
+
+rsa_3072_modexp_var:
+  /* Set the number of limbs for the modulus (3072 / 256 = 12). */
+  li      x30, 12
+
+  /* Tail-call modexp_var. */
+  jal     x0, do_modexp_var
+
+rsa_4096_modexp_var:
+  /* Set the number of limbs for the modulus (4096 / 256 = 16). */
+  li      x30, 16
+
+  /* Tail-call modexp_var. */
+  jal     x0, do_modexp_var
+
 /**
  * Precompute constants and call modular exponentiation.
  *
@@ -196,6 +240,44 @@ do_modexp_f4:
 
   ecall
 
+/**
+ * Precompute constants and call variable-time modular exponentiation.
+ *
+ * Calls `ecall` when done; should be tail-called by mode-specific routines
+ * after the number of limbs is set.
+ *
+ * @param[in]          x30: number of limbs for modulus
+ * @param[in]      dmem[n]: n, modulus
+ * @param[in]      dmem[e]: e, public exponent (32 bits, non-zero)
+ * @param[in]  dmem[inout]: a, base for exponentiation
+ * @param[out] dmem[inout]: result, a^e mod n
+ */
+do_modexp_var:
+  /* Load pointers to modulus and Montgomery constant buffers. */
+  la    x16, n
+  la    x17, m0d
+  la    x18, RR
+
+  /* Compute Montgomery constants. */
+  jal      x1, modload
+
+  /* Run exponentiation.
+       dmem[work_buf] = dmem[inout]^dmem[e] mod dmem[n] */
+  la       x14, inout
+  la       x15, e
+  lw       x15, 0(x15)
+  la       x2, work_buf
+  jal      x1, modexp_var
+
+  /* Copy final result to the output buffer. */
+  la    x3, work_buf
+  la    x4, inout
+  loop  x30, 2
+    bn.lid x0, 0(x3++)
+    bn.sid x0, 0(x4++)
+
+  ecall
+
 .bss
 
 /* Operational mode. */
@@ -204,6 +286,12 @@ do_modexp_f4:
 mode:
 .zero 4
 
+/* Public exponent (e) for the variable-time modes. */
+.globl e
+.balign 4
+e:
+.zero 4
+
 /* RSA modulus (n), up to 4096 bits. */
 .globl n
 .balign 32
@@ -0,0 +1,275 @@
+/* Copyright lowRISC contributors (OpenTitan project). */
+/* Licensed under the Apache License, Version 2.0, see LICENSE for details. */
+/* SPDX-License-Identifier: Apache-2.0 */
+
+/**
+ * Entrypoint for X25519 operations (RFC 7748).
+ *
+ * This binary has the following modes of operation:
+ * 1. MODE_KEYGEN: generate a new keypair
+ * 2. MODE_X25519: compute a shared key using a caller-provided secret key
+ * 3. MODE_SIDELOAD_KEYGEN: compute the public key for a sideloaded secret key
+ * 4. MODE_SIDELOAD_X25519: compute a shared key using a sideloaded secret key
+ *
+ * Secret keys are expressed in boolean shares k0, k1 of 320 bits, such that
+ * enc(k) = (k0 ^ k1) mod 2^256. As in `x25519_sideload.s`, a sideloaded
+ * secret key is enc(k) = KEY_S0_L ^ KEY_S1_L.
+ */
+
+/**
+ * Mode magic values.
+ *
+ * These were picked at random among 11-bit values so that they have a
+ * minimum HD of 6 to each other.
+ *
+ * TODO(#17727): in some places the OTBN assembler support for .equ directives
+ * is lacking, so they cannot be used in bignum instructions or pseudo-ops such
+ * as `li`. If support is added, we could use 32-bit values here instead of
+ * 11-bit.
+ */
+.equ MODE_KEYGEN, 0x0ca
+.equ MODE_X25519, 0x754
+.equ MODE_SIDELOAD_KEYGEN, 0x7bb
+.equ MODE_SIDELOAD_X25519, 0x185
+
+/**
+ * Make the mode constants visible to Ibex.
+ */
+.globl MODE_KEYGEN
+.globl MODE_X25519
+.globl MODE_SIDELOAD_KEYGEN
+.globl MODE_SIDELOAD_X25519
+
+/**
+ * Hardened boolean values.
+ *
+ * Should match the values in `hardened_asm.h`.
+ */
+.equ HARDENED_BOOL_TRUE, 0x739
+.equ HARDENED_BOOL_FALSE, 0x1d4
+
+.section .text.start
+.globl start
+start:
+  /* Read the mode and tail-call the requested operation. */
+  la    x2, mode
+  lw    x2, 0(x2)
+
+  addi  x3, x0, MODE_KEYGEN
+  beq   x2, x3, random_keygen
+
+  addi  x3, x0, MODE_X25519
+  beq   x2, x3, shared_key
+
+  addi  x3, x0, MODE_SIDELOAD_KEYGEN
+  beq   x2, x3, sideload_keygen
+
+  addi  x3, x0, MODE_SIDELOAD_X25519
+  beq   x2, x3, sideload_shared_key
+
+  /* Invalid mode; fail. */
+  unimp
+  unimp
+  unimp
+
+/**
+ * Generate a fresh, random keypair.
+ *
+ * The top 64 bits of each secret key share are zero.
+ *
+ * @param[out] dmem[k0]: First share of secret key (320 bits).
+ * @param[out] dmem[k1]: Second share of secret key (320 bits).
+ * @param[out] dmem[enc_x0]: Encoded public key X25519(k, 9) (256 bits).
+ */
+random_keygen:
+  bn.xor   w31, w31, w31
+
+  /* w0 <= RND, w1 <= URND */
+  bn.wsrr  w0, RND
+  bn.wsrr  w1, URND
+
+  /* dmem[k0] <= w0
+     dmem[k1] <= w1 */
+  li       x2, 0
+  la       x3, k0
+  bn.sid   x2, 0(x3)
+  li       x2, 31
+  bn.sid   x2, 32(x3)
+  li       x2, 1
+  la       x3, k1
+  bn.sid   x2, 0(x3)
+  li       x2, 31
+  bn.sid   x2, 32(x3)
+
+  /* w8 <= w0 ^ w1 = enc(k) */
+  bn.xor   w8, w0, w1
+
+  /* Tail-call public key computation. */
+  jal      x0, public_key
+
+/**
+ * Compute the public key for a sideloaded secret key.
+ *
+ * @param[out] dmem[enc_x0]: Encoded public key X25519(k, 9) (256 bits).
+ */
+sideload_keygen:
+  /* w8 <= KEY_S0_L ^ KEY_S1_L = enc(k) */
+  bn.wsrr  w7, KEY_S0_L
+  bn.wsrr  w8, KEY_S1_L
+  bn.xor   w8, w7, w8
+
+  /* Tail-call public key computation. */
+  jal      x0, public_key
+
+/**
+ * Compute a shared key.
+ *
+ * Returns the shared key X25519(k, u), expressed in boolean shares x0, x1
+ * such that the key is (x0 ^ x1).
+ *
+ * If `ok` is false, the shared key is all-zero (the peer's public key is a
+ * point of small order, see RFC 7748, section 6.1) and the shares are
+ * meaningless.
+ *
+ * @param[in]  dmem[k0]: First share of secret key (320 bits).
+ * @param[in]  dmem[k1]: Second share of secret key (320 bits).
+ * @param[in]  dmem[enc_u]: Encoded peer public key u (256 bits).
+ * @param[out] dmem[ok]: Whether the shared key is non-zero.
+ * @param[out] dmem[enc_x0]: First share of encoded shared key (256 bits).
+ * @param[out] dmem[enc_x1]: Second share of encoded shared key (256 bits).
+ */
+shared_key:
+  /* w8 <= dmem[k0] ^ dmem[k1] = enc(k) */
+  li       x2, 7
+  la       x3, k0
+  bn.lid   x2, 0(x3)
+  li       x2, 8
+  la       x3, k1
+  bn.lid   x2, 0(x3)
+  bn.xor   w8, w7, w8
+
+  /* Tail-call shared key computation. */
+  jal      x0, masked_shared_key
+
+/**
+ * Compute a shared key using a sideloaded secret key.
+ *
+ * See `shared_key` for the outputs.
+ *
+ * @param[in]  dmem[enc_u]: Encoded peer public key u (256 bits).
+ */
+sideload_shared_key:
+  /* w8 <= KEY_S0_L ^ KEY_S1_L = enc(k) */
+  bn.wsrr  w7, KEY_S0_L
+  bn.wsrr  w8, KEY_S1_L
+  bn.xor   w8, w7, w8
+
+  /* Tail-call shared key computation. */
+  jal      x0, masked_shared_key
+
+/**
+ * Compute and store X25519(k, 9).
+ *
+ * @param[in]  w8: enc(k), encoded secret key
+ * @param[out] dmem[enc_x0]: Encoded public key X25519(k, 9) (256 bits).
+ */
+public_key:
+  /* w9 <= 9, the u-coordinate of the base point */
+  bn.xor   w31, w31, w31
+  bn.addi  w9, w31, 9
+
+  /* w22 <= X25519(k, 9) */
+  jal      x1, X25519
+
+  /* dmem[enc_x0] <= w22 */
+  li       x2, 22
+  la       x3, enc_x0
+  bn.sid   x2, 0(x3)
+
+  ecall
+
+/**
+ * Compute and store X25519(k, u) in boolean shares.
+ *
+ * @param[in]  w8: enc(k), encoded secret key
+ * @param[in]  dmem[enc_u]: Encoded peer public key u (256 bits).
+ * @param[out] dmem[ok]: Whether the shared key is non-zero.
+ * @param[out] dmem[enc_x0]: First share of encoded shared key (256 bits).
+ * @param[out] dmem[enc_x1]: Second share of encoded shared key (256 bits).
+ */
+masked_shared_key:
+  /* w9 <= dmem[enc_u] = enc(u) */
+  li       x2, 9
+  la       x3, enc_u
+  bn.lid   x2, 0(x3)
+
+  /* w22 <= X25519(k, u) */
+  jal      x1, X25519
+
+  /* dmem[ok] <= (w22 != 0) ? HARDENED_BOOL_TRUE : HARDENED_BOOL_FALSE */
+  addi     x4, x0, HARDENED_BOOL_TRUE
+  bn.cmp   w22, w31
+  csrrs    x2, FG0, x0
+  andi     x2, x2, 8
+  beq      x2, x0, _x25519_nonzero
+  addi     x4, x0, HARDENED_BOOL_FALSE
+  _x25519_nonzero:
+  la       x2, ok
+  sw       x4, 0(x2)
+
+  /* w0 <= URND, w1 <= w22 ^ w0 */
+  bn.wsrr  w0, URND
+  bn.xor   w1, w22, w0
+
+  /* dmem[enc_x0] <= w1
+     dmem[enc_x1] <= w0 */
+  li       x2, 1
+  la       x3, enc_x0
+  bn.sid   x2, 0(x3)
+  li       x2, 0
+  la       x3, enc_x1
+  bn.sid   x2, 0(x3)
+
+  ecall
+
+.bss
+
+/* Operation mode. */
+.globl mode
+.balign 4
+mode:
+  .zero 4
+
+/* Whether the shared key is non-zero. */
+.globl ok
+.balign 4
+ok:
+  .zero 4
+
+/* Secret key in two shares: enc(k) = (k0 ^ k1) mod 2^256. */
+.globl k0
+.balign 32
+k0:
+  .zero 64
+.globl k1
+.balign 32
+k1:
+  .zero 64
+
+/* Encoded peer public key u. */
+.globl enc_u
+.balign 32
+enc_u:
+  .zero 32
+
+/* Encoded public key, or first share of the encoded shared key. */
+.globl enc_x0
+.balign 32
+enc_x0:
+  .zero 32
+
+/* Second share of the encoded shared key. */
+.globl enc_x1
+.balign 32
+enc_x1:
+  .zero 32
@@ -0,0 +1,230 @@
+/* Copyright lowRISC contributors (OpenTitan project). */
+/* Licensed under the Apache License, Version 2.0, see LICENSE for details. */
+/* SPDX-License-Identifier: Apache-2.0 */
+
+/**
+ * Standalone elliptic curve P-256 ECDSA signature verification test with a
+ * precomputed public key table
+ *
+ * Same as p256_ecdsa_verify_test, but uses p256_verify_table. The comb table
+ * for the public key (generated with
+ * sw/device/silicon_creator/lib/sigverify/ecdsa_p256_table_gen.py) is
+ * provided in the .data section below, along with the coordinates of the
+ * public key, the message digest and R and S of the signature.
+ *
+ * The signature verification was successful if the return value in x_r and R
+ * are identical.
+ */
+
+.section .text.start
+
+ecdsa_verify_test:
+
+  /* call ECDSA signature verification subroutine with the table */
+  la       x5, q_table
+  jal      x1, p256_verify_table
+
+  /* load results to wregs for comparison with reference */
+  li        x2, 0
+  la        x3, x_r
+  bn.lid    x2, 0(x3)
+  la        x3, ok
+  lw        x2, 0(x3)
+
+  ecall
+
+
+.data
+
+.globl msg
+.balign 32
+msg:
+  .word 0x4456fd21
+  .word 0x400bdd7d
+  .word 0xb54d7452
+  .word 0x17d015f1
+  .word 0x90d4d90b
+  .word 0xb028ad8a
+  .word 0x6ce90fef
+  .word 0x06d71207
+
+/* signature R */
+.globl r
+.balign 32
+r:
+  .word 0x80a9674a
+  .word 0x1147ea56
+  .word 0x0c7d87dd
+  .word 0x99504edd
+  .word 0xbe064de2
+  .word 0x6b35843c
+  .word 0x7dd27f33
+  .word 0x815215ad
+
+/* signature S */
+.globl s
+.balign 32
+s:
+  .word 0xc93fd605
+  .word 0xd0b1051e
+  .word 0xe90a6d17
+  .word 0x4dad9404
+  .word 0x99e589ad
+  .word 0x86e30cd9
+  .word 0xc4440420
+  .word 0xa3991e01
+
+/* public key x-coordinate */
+.globl x
+.balign 32
+x:
+  .word 0xbfa8c334
+  .word 0x9773b7b3
+  .word 0xf36b0689
+  .word 0x6ec0c0b2
+  .word 0xdb6c8bf3
+  .word 0x1628ce58
+  .word 0xfacdc546
+  .word 0xb5511a6a
+
+/* public key y-coordinate */
+.globl y
+.balign 32
+y:
+  .word 0x9e008c2e
+  .word 0xa8707058
+  .word 0xab9c6924
+  .word 0x7f7a11d0
+  .word 0xb53a17fa
+  .word 0x43dd09ea
+  .word 0x1f31c143
+  .word 0x42a1c697
+
+/* comb table for the public key */
+.balign 32
+q_table:
+  /* T[1] */
+  .word 0xbfa8c334
+  .word 0x9773b7b3
+  .word 0xf36b0689
+  .word 0x6ec0c0b2
+  .word 0xdb6c8bf3
+  .word 0x1628ce58
+  .word 0xfacdc546
+  .word 0xb5511a6a
+  .word 0x9e008c2e
+  .word 0xa8707058
+  .word 0xab9c6924
+  .word 0x7f7a11d0
+  .word 0xb53a17fa
+  .word 0x43dd09ea
+  .word 0x1f31c143
+  .word 0x42a1c697
+  /* T[2] */
+  .word 0x55d49e88
+  .word 0x050d511c
+  .word 0x8210a8e8
+  .word 0xbc52e66c
+  .word 0xee83a233
+  .word 0x1512443f
+  .word 0x844a9b6f
+  .word 0x41283ee4
+  .word 0xea301824
+  .word 0x9bcd3bd7
+  .word 0x97daf41d
+  .word 0x92f06b05
+  .word 0x5044d019
+  .word 0x4093f407
+  .word 0xf53dd7c2
+  .word 0x2816eb04
+  /* T[3] */
+  .word 0xa2dee752
+  .word 0x8ef1f8dc
+  .word 0x02c8b14b
+  .word 0x926a7bb5
+  .word 0x29bbcacc
+  .word 0x16153980
+  .word 0xe706c081
+  .word 0xebb910f9
+  .word 0xf6f15eb0
+  .word 0xac2d74b9
+  .word 0x54c07032
+  .word 0x1ca9b2d1
+  .word 0xd2b2890e
+  .word 0x60a5438c
+  .word 0xac64b9c7
+  .word 0xf6a241b3
+  /* T[4] */
+  .word 0xdffce469
+  .word 0x4259102c
+  .word 0xe61669db
+  .word 0x27d39169
+  .word 0x4abc53bd
+  .word 0xb48f706d
+  .word 0x9ab3244f
+  .word 0x92fdc150
+  .word 0x302a3333
+  .word 0x723b719c
+  .word 0x7995d052
+  .word 0xd56a40ee
+  .word 0x47c29233
+  .word 0x7440774e
+  .word 0x5dac0b27
+  .word 0x19e1bf5f
+  /* T[5] */
+  .word 0xac4cb03d
+  .word 0x8192e47b
+  .word 0x35d67f5e
+  .word 0x427c2c6e
+  .word 0xd9aac06d
+  .word 0xa83231ff
+  .word 0xfa5acfd3
+  .word 0xa015262b
+  .word 0xc45e1671
+  .word 0xce69a2e9
+  .word 0x78fcdd4c
+  .word 0xc3dd2597
+  .word 0x3c2e2b30
+  .word 0xe8d93438
+  .word 0x2bdeb178
+  .word 0xa63faf13
+  /* T[6] */
+  .word 0x682acfc3
+  .word 0x458636ca
+  .word 0x0dfd7e50
+  .word 0x35617626
+  .word 0xf8e88ab8
+  .word 0x976c521b
+  .word 0x920d8f6b
+  .word 0x317ae329
+  .word 0xe3d6ba5f
+  .word 0xdf461217
+  .word 0xbb3fe346
+  .word 0x21bf8ef9
+  .word 0x6656dacf
+  .word 0x9b040367
+  .word 0x66251fd2
+  .word 0xde129302
+  /* T[7] */
+  .word 0x8269a8d7
+  .word 0xfe70c630
+  .word 0xf2eb6798
+  .word 0x5deac708
+  .word 0x61076830
+  .word 0xbcfa9a2e
+  .word 0x9a015579
+  .word 0x14203640
+  .word 0x72b7c916
+  .word 0x42224040
+  .word 0x26a27d28
+  .word 0x6b80b0e6
+  .word 0x87c5481c
+  .word 0x4c2073e5
+  .word 0x3d1739b4
+  .word 0x292c0f9a
+
+/* signature verification result x_r */
+.globl x_r
+.balign 32
+x_r:
+  .zero 32
@@ -14,16 +14,47 @@ Typical usage:
     llvm-cov show OBJECT_FILE -instr-profile=foo.profdata
 """
 import argparse
+import base64
 import zlib
 import re
 import sys
 
 
+def decompress_rle(data):
+    """Decompress profile data compressed by `coverage_llvm.c`.
+
+    The data is a sequence of tokens. A byte `t < 0x80` is followed by `t + 1`
+    literal bytes and a byte `t >= 0x80` stands for `t - 0x7f` zero bytes.
+
+    Args:
+        data: Compressed data.
+    Returns:
+        Decompressed data.
+    Raises:
+        ValueError: If a literal run is truncated.
+    """
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        token = data[i]
+        i += 1
+        if token >= 0x80:
+            out += bytes(token - 0x7f)
+            continue
+        if i + token + 1 > len(data):
+            raise ValueError('Truncated literal run in compressed data.')
+        out += data[i:i + token + 1]
+        i += token + 1
+    return bytes(out)
+
+
 def extract_profile_data(device_output):
     """Parse device output to extract LLVM profile data.
 
     This function returns the LLVM profile data as a byte array after
-    verifying its length and checksum.
+    verifying its length and checksum. The data may be either a single hex
+    number, with the last byte first, or run-length compressed and base64
+    encoded (marked `rle64` in the header).
 
     Args:
         device_output: Device output.
@@ -41,8 +72,14 @@ def extract_profile_data(device_output):
         device_output.maketrans('', '', '\r\n'))
     match = re.search(
         r"""
-            LLVM\ profile\ data\ \(length:\ (?P<len>\d+)\ bytes,\ CRC32:\ (?P<crc>0x[0-9a-f]*)\):
-            (?P<data> 0x [0-9a-f]+)
+            LLVM\ profile\ data\ \(length:\ (?P<len>\d+)\ bytes,\ CRC32:\ (?P<crc>0x[0-9a-f]*)
+            (?:
+                \):
+                (?P<data> 0x [0-9a-f]+)
+            |
+                ,\ rle64\):
+                (?P<rle64> [A-Za-z0-9+/=]*)
+            )
             \x04
         """, device_output, re.VERBOSE)
     if not match:
@@ -50,9 +87,16 @@ def extract_profile_data(device_output):
             'Could not detect LLVM profile data in device output.')
     exp_length = int(match.group('len'))
     exp_checksum = int(match.group('crc'), 0)
-    byte_array = int(match.group('data'), 0).to_bytes(len(match.group('data')) // 2 - 1,
-                                                      byteorder='little',
-                                                      signed=False)
+    if match.group('rle64') is not None:
+        try:
+            compressed = base64.b64decode(match.group('rle64'), validate=True)
+        except ValueError as e:
+            raise ValueError(f'Bad base64 in LLVM profile data: {e}.')
+        byte_array = decompress_rle(compressed)
+    else:
+        byte_array = int(match.group('data'), 0).to_bytes(len(match.group('data')) // 2 - 1,
+                                                          byteorder='little',
+                                                          signed=False)
     # Check length
     act_length = len(byte_array)
     if act_length != exp_length:
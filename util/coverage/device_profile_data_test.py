@@ -191,6 +191,55 @@ I00034 status.c:28] PASS!\r
         self.assertEqual(len(raw_profile_data), 1184)
         self.assertEqual(zlib.crc32(raw_profile_data), 0x79a3fcf1)
 
+    def test_good_rle64_data(self):
+        # Same profile data as `test_good_data`, compressed.
+        DEVICE_OUTPUT = """
+I00001 coverage_test.c:37] Collecting coverage data.\r
+I00002 ottf_main.c:100] Finished sw/device/tests/coverage_test.c\r
+I00003 coverage_llvm.c:142] LLVM profile data (length: 1184 bytes, CRC32: 0x79a3fcf1, rle64):\r
+CIFSZm9ycGz/B44ACo4ADY4BSgKFA1ggABCDAxRMACCDAAGGCNtB61DIS0ieGIYDWCAAEIcAAYoH\r
+C16eOJtIROKHA2AgABCHAAGKCzX87Z47cGu3kSZEAoMDaCAAEIcAA4oI8FT/Fa85hPYYhgOAIAAQ\r
+hwABigj0xy9V3dqwVRiGA4ggABCHAAGKCawSInWzsy9DWCSFA5AgABCHAAKKCNEwhqhbeGYoGIYD\r
+oCAAEIcAAYoI6odEdQqhOgMYhgOoIAAQhwABigdp/DAPjJhvHocDsCAAEIcAAYoHBNBK7zURyeWH\r
+A7ggABCHAAHyf+YIzAJ42n1Sy3KEIBAsfyiH5LKVn5liATdTi2BgCNGvzyjqLkj2gk1P97wkCk+A\r
+FqmLjN7k5/IBr4PODIyR5JfwRZh+oY/G1Bwqo7MpeaQNBrT37orUozYK1vPjnQsIdWaz7aAZMElu\r
+j9eRMknmmimkG6fnanY5fODmND2nlS5afwLDadHeYNbe6XCOkxdo2oLRjaum4AS3NBXdT6RDEuMz\r
+h4HNSXtwPVByHBoGdDziDZ2F3rsBhFK+YJf5Lyemsq4LuTQoCF9CcUl1jrVS8BqbhqUkDCLcK9NN\r
+U95+wVpnBbkBJUhes28ZHxL+Oy3B2g44a6b/FGWK/fW8yNGS1K2+fxomNIetimSBEdEq7R8odVfh\r
+Pa7UhlIn+W0ampnKKG5If88HykAO7ueQzbszpl2+g7SLUyeuAbY+lwd0XLenUt0fv73wcc1S2CAO\r
+6x8D4qnGjAX2AXjabZBdcoMwDISHG/XnpbfRCFskmjHYlQVuOH0FhACBF8/60+5awDX9QZNufwgD\r
+SebYVTwR9F5AqMUEH5BJT/RzplhnaFuOBtH/bNcirHS6Q76jj4X8Mff99Wa8AFu0ICs0UYA7JZE+\r
+2W4O3Z0MDBjYo1JVszZMwcN8Wnx650zn8g2bMKhxnb9PjiULu6xwMT32r3XTIVmnf7avdbHvFILV\r
+cneDkSRSPs9VkMO1SSHFNHsODG2lx2H7h1IumPaMs4ULCcQGtEQbBew7T7KpUtUowjN6qlI5+4ig\r
+o6FF9U9Fv+NLLcK1cXjZxjXZl9W+irKayz8BlPMhhQ==\r
+
+\x04\r
+I00004 status.c:28] PASS!\r
+"""  # noqa: E501
+        raw_profile_data = extract_profile_data(DEVICE_OUTPUT)
+        self.assertEqual(len(raw_profile_data), 1184)
+        self.assertEqual(zlib.crc32(raw_profile_data), 0x79a3fcf1)
+
+    def test_truncated_rle64_data(self):
+        # The last literal run is cut short.
+        DEVICE_OUTPUT = """
+I00003 coverage_llvm.c:142] LLVM profile data (length: 5 bytes, CRC32: 0x00000000, rle64):\r
+BAECAw==\r
+\x04\r
+"""  # noqa: E501
+        with self.assertRaisesRegex(ValueError, "Truncated.*"):
+            extract_profile_data(DEVICE_OUTPUT)
+
+    def test_rle64_zero_runs(self):
+        # 0x41 followed by 200 zeros: a literal run and two zero runs.
+        DEVICE_OUTPUT = """
+I00003 coverage_llvm.c:142] LLVM profile data (length: 201 bytes, CRC32: 0xccefab2e, rle64):\r
+AEH/xw==\r
+\x04\r
+"""  # noqa: E501
+        raw_profile_data = extract_profile_data(DEVICE_OUTPUT)
+        self.assertEqual(raw_profile_data, b"\x41" + bytes(200))
+
 
 if __name__ == '__main__':
     unittest.main()
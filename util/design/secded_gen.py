@@ -32,21 +32,22 @@ C_SRC_TOP = """
 #include "secded_enc.h"
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 // Calculates even parity for a 64-bit word
-static uint8_t calc_parity(uint64_t word, bool invert) {
-  bool parity = false;
-
-  while (word) {
-    if (word & 1) {
-      parity = !parity;
-    }
-
-    word >>= 1;
-  }
-
-  return parity ^ invert;
+static inline uint8_t calc_parity(uint64_t word, bool invert) {
+#ifdef __GNUC__
+  return __builtin_parityll(word) ^ invert;
+#else
+  word ^= word >> 32;
+  word ^= word >> 16;
+  word ^= word >> 8;
+  word ^= word >> 4;
+  word ^= word >> 2;
+  word ^= word >> 1;
+  return (word & 1) ^ invert;
+#endif
 }
 """
 
@@ -54,6 +55,7 @@ C_H_TOP = """
 #ifndef OPENTITAN_HW_IP_PRIM_DV_PRIM_SECDED_SECDED_ENC_H_
 #define OPENTITAN_HW_IP_PRIM_DV_PRIM_SECDED_SECDED_ENC_H_
 
+#include <stddef.h>
 #include <stdint.h>
 
 #ifdef __cplusplus
@@ -63,6 +65,10 @@ extern "C" {
 // Integrity encode functions for varying bit widths matching the functionality
 // of the RTL modules of the same name. Each takes an array of bytes in
 // little-endian order and returns the calculated integrity bits.
+//
+// The `_buf` variants encode `n` consecutive words, reading each word's bytes
+// from `src` in turn and writing its integrity bits to the matching element of
+// `out`. Use them to encode whole memory images.
 
 """
 
@@ -673,10 +679,20 @@ def write_c_files(n, k, m, codes, suffix, c_src_filename, c_h_filename,
 
         f.write(";\n}\n")
 
+        # Write out the bulk version, which the compiler can inline the
+        # single word version into
+        f.write(f"\nvoid enc_secded{suffix}_{n}_{k}_buf"
+                f"(const uint8_t *src, size_t n, {out_type} *out) {{\n")
+        f.write("for (size_t i = 0; i < n; ++i) {\n")
+        f.write(f"out[i] = enc_secded{suffix}_{n}_{k}(src + {in_bytes} * i);\n")
+        f.write("}\n}\n")
+
     with open(c_h_filename, "a") as f:
-        # Write out function declaration in header
+        # Write out function declarations in header
         f.write(f"{out_type} enc_secded{suffix}_{n}_{k}"
                 f"(const uint8_t bytes[{in_bytes}]);\n")
+        f.write(f"void enc_secded{suffix}_{n}_{k}_buf"
+                f"(const uint8_t *src, size_t n, {out_type} *out);\n")
 
 
 def format_c_files(c_src_filename, c_h_filename):
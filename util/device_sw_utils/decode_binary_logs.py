@@ -0,0 +1,267 @@
+#!/usr/bin/env python3
+# Copyright lowRISC contributors (OpenTitan project).
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+"""Script to decode the binary log records in a device console capture.
+
+When binary logging is enabled (see `base_log_set_binary()` in
+sw/device/lib/runtime/log.h), informational logs are not formatted on the
+device. Instead, each log is written to the console as a record:
+
+marker (byte), 1 byte:      0xfe, which cannot occur in UTF-8 text.
+fields (int, ptr), 4 bytes: Address of the log's log_fields_t struct.
+counter (int), 2 bytes:     The device's log counter.
+args:                       The values of the format arguments, encoded by
+                            `base_vfprintf_binary()` in print.c.
+
+The log_fields_t struct and the strings it points to are read from the ELF
+file of the device program, and the log line is formatted as the device would
+have. Everything outside of the records is passed through unchanged.
+"""
+
+import argparse
+import os
+import struct
+import sys
+
+from elftools.elf import elffile
+
+LOG_RECORD_MARKER = 0xfe
+LOG_RECORD_HEADER = struct.Struct('<BIH')
+# severity, file_name, line, nargs, format; see log_fields_t in log.h.
+LOG_FIELDS = struct.Struct('<IIIII')
+SEVERITIES = ['I', 'W', 'E', 'F']
+
+STATUS_CODES = [
+    "Ok", "Cancelled", "Unknown", "InvalidArgument", "DeadlineExceeded",
+    "NotFound", "AlreadyExists", "PermissionDenied", "ResourceExhausted",
+    "FailedPrecondition", "Aborted", "OutOfRange", "Unimplemented",
+    "Internal", "Unavailable", "DataLoss", "Unauthenticated"
+] + ["Undefined{}".format(i) for i in range(17, 32)] + ["ErrorError"]
+
+ERROR_NUL = "%<unexpected nul>"
+UNKNOWN_SPEC = "%<unknown spec>"
+ERROR_TOO_WIDE = "%<bad width>"
+
+
+class Image:
+    '''The loaded contents of a device ELF file.'''
+
+    def __init__(self, elf_file):
+        self.regions = []
+        with open(elf_file, 'rb') as f:
+            elf = elffile.ELFFile(f)
+            for section in elf.iter_sections():
+                if section.header['sh_type'] != "SHT_PROGBITS":
+                    continue
+                if not section.header['sh_flags'] & 0x2:  # SHF_ALLOC
+                    continue
+                self.regions.append(
+                    (int(section.header['sh_addr']), section.data()))
+
+    def read(self, addr, size):
+        for base, data in self.regions:
+            if base <= addr and addr + size <= base + len(data):
+                return data[addr - base:addr - base + size]
+        raise KeyError("address {:#x} is not in the image".format(addr))
+
+    def read_str(self, addr):
+        for base, data in self.regions:
+            if base <= addr < base + len(data):
+                end = data.find(b'\0', addr - base)
+                if end == -1:
+                    break
+                return data[addr - base:end].decode('utf-8', errors='replace')
+        raise KeyError("string at {:#x} is not in the image".format(addr))
+
+
+class Reader:
+    '''Reads the values of a binary log record from the console stream.'''
+
+    def __init__(self, data, pos):
+        self.data = data
+        self.pos = pos
+
+    def bytes(self, size):
+        if self.pos + size > len(self.data):
+            raise EOFError("truncated log record")
+        value = self.data[self.pos:self.pos + size]
+        self.pos += size
+        return value
+
+    def word(self):
+        value, = struct.unpack('<I', self.bytes(4))
+        return value
+
+    def buffer(self):
+        return self.bytes(self.word())
+
+
+def digits(value, base, width, padding, upper=False):
+    glyphs = "0123456789ABCDEF" if upper else "0123456789abcdef"
+    result = ""
+    while True:
+        result = glyphs[value % base] + result
+        value //= base
+        if value == 0:
+            break
+    return result.rjust(max(1, min(width, 32)), padding)
+
+
+def hex_dump(buf, width, padding, big_endian, upper):
+    result = padding * (width - len(buf)) if len(buf) < width else ""
+    data = buf[::-1] if big_endian else buf
+    return result + (data.hex().upper() if upper else data.hex())
+
+
+def status(value, as_json):
+    value &= 0xffffffff
+    signed = value - (1 << 32) if value & 0x80000000 else value
+    code = value & 0x1f
+    if signed < 0 and code == 0:
+        code = len(STATUS_CODES) - 1
+    name = '"{}"'.format(STATUS_CODES[code]) if as_json else STATUS_CODES[code]
+    if code:
+        arg = (value >> 5) & 0x7ff
+        mod_id = (value >> 16) & 0x7fff
+        mod = "".join(chr(0x40 + ((mod_id >> s) & 0x1f)) for s in (0, 5, 10))
+        result = '{}:["{}",{}]'.format(name, mod, arg)
+    else:
+        result = '{}:{}'.format(name, signed & 0xffffffff)
+    return "{" + result + "}" if as_json else result
+
+
+def format_spec(spec_type, nonstd, width, padding, reader):
+    '''Formats one specifier as `process_specifier()` in print.c does.'''
+    if spec_type == '%':
+        return UNKNOWN_SPEC if nonstd else '%'
+    if spec_type in 'cdiopu' and nonstd:
+        return UNKNOWN_SPEC
+    if spec_type in 'yY' and not nonstd:
+        return UNKNOWN_SPEC
+    if spec_type == 'c':
+        return chr(reader.word() & 0xff)
+    if spec_type == 'C':
+        result = ""
+        for ch in struct.pack('<I', reader.word()):
+            result += chr(ch) if 32 <= ch < 127 else "\\x{:02x}".format(ch)
+        return result
+    if spec_type == 's':
+        return reader.buffer().decode('utf-8', errors='replace')
+    if spec_type in 'di':
+        value = reader.word()
+        sign = ""
+        if value & 0x80000000:
+            sign = "-"
+            value = (1 << 32) - value
+        return sign + digits(value, 10, width, padding)
+    if spec_type == 'o':
+        return digits(reader.word(), 8, width, padding)
+    if spec_type == 'u':
+        return digits(reader.word(), 10, width, padding)
+    if spec_type == 'p':
+        return "0x" + digits(reader.word(), 16, 8, '0')
+    if spec_type in 'xX' and nonstd:
+        return hex_dump(reader.buffer(), width, padding, True, spec_type == 'X')
+    if spec_type in 'yY':
+        return hex_dump(reader.buffer(), width, padding, False,
+                        spec_type == 'Y')
+    if spec_type in 'xh':
+        return digits(reader.word(), 16, width, padding)
+    if spec_type in 'XH':
+        return digits(reader.word(), 16, width, padding, upper=True)
+    if spec_type == 'b':
+        if nonstd:
+            return "true" if reader.word() != 0 else "false"
+        return digits(reader.word(), 2, width, padding)
+    if spec_type == 'r':
+        return status(reader.word(), nonstd)
+    return UNKNOWN_SPEC
+
+
+def format_message(fmt, reader):
+    '''Formats `fmt` as `base_vfprintf()` in print.c does.'''
+    result = ""
+    i = 0
+    while i < len(fmt):
+        pct = fmt.find('%', i)
+        if pct == -1:
+            result += fmt[i:]
+            break
+        result += fmt[i:pct]
+        i = pct + 1
+        nonstd = i < len(fmt) and fmt[i] == '!'
+        if nonstd:
+            i += 1
+        width = 0
+        padding = ''
+        while i < len(fmt) and fmt[i].isdigit():
+            if not padding:
+                padding = '0' if fmt[i] == '0' else ' '
+            if padding != '0' or fmt[i] != '0' or width:
+                width = width * 10 + int(fmt[i])
+            i += 1
+        if i >= len(fmt):
+            return result + ERROR_NUL
+        if (width == 0 and padding) or width > 32:
+            return result + ERROR_TOO_WIDE
+        result += format_spec(fmt[i], nonstd, width, padding or ' ', reader)
+        i += 1
+    return result
+
+
+def decode_record(image, data, pos):
+    '''Decodes the record at `data[pos]`, returning the line and end.'''
+    _, fields_addr, counter = LOG_RECORD_HEADER.unpack_from(data, pos)
+    severity, file_addr, line, _, format_addr = LOG_FIELDS.unpack(
+        image.read(fields_addr, LOG_FIELDS.size))
+    file_name = os.path.basename(image.read_str(file_addr))
+    fmt = image.read_str(format_addr)
+    reader = Reader(data, pos + LOG_RECORD_HEADER.size)
+    message = format_message(fmt, reader)
+    severity = SEVERITIES[severity] if severity < len(SEVERITIES) else "?"
+    text = "{}{:05d} {}:{}] {}\r\n".format(severity, counter, file_name, line,
+                                          message)
+    return text.encode('utf-8'), reader.pos
+
+
+def decode_binary_logs(image, data):
+    '''Replaces the binary log records in `data` with formatted lines.'''
+    result = bytearray()
+    pos = 0
+    while pos < len(data):
+        marker = data.find(bytes([LOG_RECORD_MARKER]), pos)
+        if marker == -1 or marker + LOG_RECORD_HEADER.size > len(data):
+            result += data[pos:]
+            break
+        result += data[pos:marker]
+        try:
+            text, pos = decode_record(image, data, marker)
+        except (KeyError, EOFError, struct.error) as e:
+            # Not a valid record; pass the marker byte through.
+            print("warning: {} at offset {}".format(e, marker),
+                  file=sys.stderr)
+            text, pos = data[marker:marker + 1], marker + 1
+        result += text
+    return bytes(result)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('--elf-file', '-e', required=True, help="Elf file")
+    parser.add_argument('input',
+                        nargs='?',
+                        help="Console capture to decode (default: stdin).")
+    args = parser.parse_args()
+
+    image = Image(args.elf_file)
+    if args.input:
+        with open(args.input, 'rb') as f:
+            data = f.read()
+    else:
+        data = sys.stdin.buffer.read()
+    sys.stdout.buffer.write(decode_binary_logs(image, data))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,142 @@
+#!/usr/bin/env python3
+# Copyright lowRISC contributors (OpenTitan project).
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+"""Generates a linker script fragment that places hot functions first.
+
+The device linker scripts include `hot_text.ld` at the start of `.text`. Since
+device code is built with `-ffunction-sections`, each function has its own
+`.text.<name>` input section, and listing those sections in the fragment
+places the functions contiguously, in order, ahead of the rest of the code.
+
+Each input is either a list of function names (one per line, `#` starts a
+comment) or a profile in folded stack format, such as the one written by the
+Verilator simulation with `--pc-profile`. Listed functions are kept in the
+given order. Profiled functions are ranked by their self cost, summed over all
+stacks, and taken until the requested share of the total cost is covered.
+"""
+
+import argparse
+import logging as log
+import re
+import sys
+from pathlib import Path
+from typing import Dict, Iterable, List
+
+# A folded stack line: frames separated by ';', then a space and a count.
+_FOLDED_RE = re.compile(r'^(\S.*) (\d+)$')
+# A leaf frame resolved to a symbol, with an optional offset into it.
+_FRAME_RE = re.compile(r'^([A-Za-z_.$][A-Za-z0-9_.$]*)(\+0x[0-9a-fA-F]+)?$')
+_NAME_RE = re.compile(r'^[A-Za-z_.$][A-Za-z0-9_.$]*$')
+
+
+def is_folded(lines: List[str]) -> bool:
+    """Return whether every non-blank line looks like a folded stack."""
+    lines = [line for line in lines if line.strip()]
+    return bool(lines) and all(_FOLDED_RE.match(line) for line in lines)
+
+
+def parse_list(lines: Iterable[str]) -> List[str]:
+    """Return the function names in a hot function list."""
+    names = []
+    for lineno, line in enumerate(lines, 1):
+        name = line.split('#', 1)[0].strip()
+        if not name:
+            continue
+        if not _NAME_RE.match(name):
+            raise ValueError(f'line {lineno}: bad function name: {name!r}')
+        names.append(name)
+    return names
+
+
+def parse_folded(lines: Iterable[str], coverage: float) -> List[str]:
+    """Return the hottest functions of a folded stack profile.
+
+    Functions are ranked by the cost of the stacks whose leaf frame is in the
+    function. Leaf frames that are plain addresses are ignored. Functions are
+    returned until they account for `coverage` percent of the total cost.
+    """
+    costs: Dict[str, int] = {}
+    total = 0
+    for line in lines:
+        match = _FOLDED_RE.match(line.strip())
+        if not match:
+            continue
+        cost = int(match.group(2))
+        total += cost
+        frame = _FRAME_RE.match(match.group(1).split(';')[-1])
+        if not frame:
+            continue
+        costs[frame.group(1)] = costs.get(frame.group(1), 0) + cost
+
+    names = []
+    covered = 0
+    for name, cost in sorted(costs.items(), key=lambda kv: (-kv[1], kv[0])):
+        if covered * 100 >= coverage * total:
+            break
+        names.append(name)
+        covered += cost
+    return names
+
+
+def generate_fragment(names: Iterable[str], limit: int) -> str:
+    """Return the linker script fragment for the given functions.
+
+    Duplicates are dropped and at most `limit` functions are placed (all of
+    them if `limit` is 0).
+    """
+    unique = list(dict.fromkeys(names))
+    if limit:
+        unique = unique[:limit]
+
+    lines = [
+        '/* Generated by util/hot_text_ld.py. Do not edit. */',
+    ]
+    for name in unique:
+        # Static functions get the same section name in every object file, and
+        # some compiler passes add a suffix (e.g. `.text.foo.part.0`).
+        lines.append(f'*(.text.{name} .text.{name}.*)')
+    return '\n'.join(lines) + '\n'
+
+
+def main() -> int:
+    log.basicConfig(format="%(levelname)s: %(message)s")
+
+    parser = argparse.ArgumentParser(prog="hot_text_ld")
+    parser.add_argument('inputs',
+                        nargs='+',
+                        type=Path,
+                        help='Hot function lists or folded stack profiles')
+    parser.add_argument('--output',
+                        '-o',
+                        required=True,
+                        type=Path,
+                        help='Output linker script fragment')
+    parser.add_argument('--coverage',
+                        type=float,
+                        default=90.0,
+                        help='Percentage of profiled cost to cover')
+    parser.add_argument('--limit',
+                        type=int,
+                        default=0,
+                        help='Maximum number of functions to place (0: all)')
+    args = parser.parse_args()
+
+    names = []
+    for path in args.inputs:
+        lines = path.read_text().splitlines()
+        try:
+            if is_folded(lines):
+                names += parse_folded(lines, args.coverage)
+            else:
+                names += parse_list(lines)
+        except ValueError as err:
+            log.error(f'{path}: {err}')
+            return 1
+
+    args.output.write_text(generate_fragment(names, args.limit))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,61 @@
+# Copyright lowRISC contributors (OpenTitan project).
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+
+import unittest
+
+import hot_text_ld
+
+
+class TestParse(unittest.TestCase):
+    def test_list(self):
+        lines = [
+            '# Verify path',
+            'rom_ext_verify',
+            '',
+            'hmac_sha256_update  # hashing',
+        ]
+        self.assertFalse(hot_text_ld.is_folded(lines))
+        self.assertEqual(hot_text_ld.parse_list(lines),
+                         ['rom_ext_verify', 'hmac_sha256_update'])
+
+    def test_list_bad_name(self):
+        with self.assertRaises(ValueError):
+            hot_text_ld.parse_list(['foo bar'])
+
+    def test_folded(self):
+        lines = [
+            'main+0x4 10',
+            'main;hmac_sha256_update+0x1c 50',
+            'main;rom_ext_verify;hmac_sha256_update 20',
+            'main;rom_ext_verify 15',
+            'main;0x20001234 100',
+            'main;memset+0x8 5',
+        ]
+        self.assertTrue(hot_text_ld.is_folded(lines))
+        # 200 in total, of which hmac_sha256_update covers 35%.
+        self.assertEqual(hot_text_ld.parse_folded(lines, 35),
+                         ['hmac_sha256_update'])
+        self.assertEqual(hot_text_ld.parse_folded(lines, 36),
+                         ['hmac_sha256_update', 'rom_ext_verify'])
+        self.assertEqual(
+            hot_text_ld.parse_folded(lines, 100),
+            ['hmac_sha256_update', 'rom_ext_verify', 'main', 'memset'])
+
+
+class TestGenerateFragment(unittest.TestCase):
+    def test_fragment(self):
+        fragment = hot_text_ld.generate_fragment(['a', 'b', 'a', 'c'], 2)
+        self.assertEqual(
+            fragment, '/* Generated by util/hot_text_ld.py. Do not edit. */\n'
+            '*(.text.a .text.a.*)\n'
+            '*(.text.b .text.b.*)\n')
+
+    def test_empty(self):
+        self.assertEqual(
+            hot_text_ld.generate_fragment([], 0),
+            '/* Generated by util/hot_text_ld.py. Do not edit. */\n')
+
+
+if __name__ == '__main__':
+    unittest.main()